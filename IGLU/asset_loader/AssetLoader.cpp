@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "AssetLoader.h"
+
+#include <algorithm>
+#include <igl/WorkerPool.h>
+#include <thread>
+
+namespace iglu {
+namespace assetloader {
+
+AssetLoader::AssetLoader(AssetLoaderConfig config) : config_(std::move(config)) {
+  ioPool_ = std::make_shared<igl::WorkerPool>(std::max(config_.numIoThreads, 1u),
+                                              "AssetLoader I/O");
+  decodePool_ = config_.decodePool;
+  if (!decodePool_) {
+    const uint32_t numCores = std::thread::hardware_concurrency();
+    decodePool_ = std::make_shared<igl::WorkerPool>(numCores > 1 ? numCores - 1 : 1,
+                                                    "AssetLoader decode");
+  }
+}
+
+AssetLoader::~AssetLoader() {
+  JobQueue dropped;
+  {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->stopped = true;
+    dropped.swap(state_->readQueue);
+    dropped.insert(dropped.end(), state_->decodeQueue.begin(), state_->decodeQueue.end());
+    dropped.insert(dropped.end(), state_->uploadQueue.begin(), state_->uploadQueue.end());
+    state_->decodeQueue.clear();
+    state_->uploadQueue.clear();
+    state_->cv.wait(lock, [this]() { return state_->numRunning == 0; });
+  }
+  for (const auto& job : dropped) {
+    job->handle->state_.store(AssetState::Cancelled, std::memory_order_release);
+  }
+}
+
+std::shared_ptr<AssetHandle> AssetLoader::submit(std::shared_ptr<Job> job) {
+  std::shared_ptr<AssetHandle> handle = job->handle;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->readQueue.push_back(std::move(job));
+    state_->numPending++;
+  }
+  // every task takes the job with the highest priority at the time it runs
+  ioPool_->enqueue([state = state_, decodePool = decodePool_]() { read(state, decodePool); });
+  return handle;
+}
+
+std::shared_ptr<AssetLoader::Job> AssetLoader::popHighestPriority(JobQueue& queue) {
+  if (queue.empty()) {
+    return nullptr;
+  }
+  auto it = std::max_element(queue.begin(), queue.end(), [](const auto& a, const auto& b) {
+    return a->handle->getPriority() < b->handle->getPriority();
+  });
+  std::shared_ptr<Job> job = std::move(*it);
+  *it = std::move(queue.back());
+  queue.pop_back();
+  return job;
+}
+
+void AssetLoader::read(const std::shared_ptr<State>& state,
+                       const std::shared_ptr<igl::WorkerPool>& decodePool) {
+  std::shared_ptr<Job> job;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->stopped || !(job = popHighestPriority(state->readQueue))) {
+      return;
+    }
+    state->numRunning++;
+  }
+
+  if (!job->handle->isCancelled() && job->read) {
+    job->failed = !job->read(job->bytes);
+  }
+  const bool needsDecode = !job->failed && !job->handle->isCancelled() && job->decode;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    (needsDecode ? state->decodeQueue : state->uploadQueue).push_back(std::move(job));
+    state->numRunning--;
+    state->cv.notify_all();
+  }
+  if (needsDecode) {
+    decodePool->enqueue([state]() { decode(state); });
+  }
+}
+
+void AssetLoader::decode(const std::shared_ptr<State>& state) {
+  std::shared_ptr<Job> job;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->stopped || !(job = popHighestPriority(state->decodeQueue))) {
+      return;
+    }
+    state->numRunning++;
+  }
+
+  if (!job->handle->isCancelled()) {
+    job->failed = !job->decode(std::move(job->bytes));
+  }
+  job->bytes = {};
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->uploadQueue.push_back(std::move(job));
+    state->numRunning--;
+    state->cv.notify_all();
+  }
+}
+
+void AssetLoader::update() {
+  JobQueue ready;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    uint32_t numUploads = 0;
+    while (numUploads < config_.maxUploadsPerUpdate) {
+      std::shared_ptr<Job> job = popHighestPriority(state_->uploadQueue);
+      if (!job) {
+        break;
+      }
+      if (!job->failed && !job->handle->isCancelled()) {
+        numUploads++;
+      }
+      ready.push_back(std::move(job));
+    }
+  }
+
+  for (const auto& job : ready) {
+    AssetState assetState = AssetState::Loaded;
+    if (job->handle->isCancelled()) {
+      assetState = AssetState::Cancelled;
+    } else if (job->failed || !job->upload()) {
+      assetState = AssetState::Failed;
+    }
+    job->handle->state_.store(assetState, std::memory_order_release);
+    if (job->onComplete) {
+      job->onComplete(assetState);
+    }
+  }
+
+  if (!ready.empty()) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->numPending -= ready.size();
+  }
+}
+
+size_t AssetLoader::getNumPending() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->numPending;
+}
+
+} // namespace assetloader
+} // namespace iglu
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace igl {
+class WorkerPool;
+} // namespace igl
+
+namespace iglu {
+namespace assetloader {
+
+enum class AssetState : uint8_t {
+  Pending,
+  Loaded,
+  Failed,
+  Cancelled,
+};
+
+/// Tracks an asset submitted to AssetLoader. Can be used from any thread.
+class AssetHandle final {
+ public:
+  [[nodiscard]] AssetState getState() const {
+    return state_.load(std::memory_order_acquire);
+  }
+  /// Stages which have not started yet are skipped; the completion callback still runs with
+  /// AssetState::Cancelled unless the asset finished loading before.
+  void cancel() {
+    cancelled_.store(true, std::memory_order_relaxed);
+  }
+  [[nodiscard]] bool isCancelled() const {
+    return cancelled_.load(std::memory_order_relaxed);
+  }
+  /// Higher priorities are read, decoded and uploaded first. Takes effect for the stages which
+  /// have not started yet.
+  void setPriority(float priority) {
+    priority_.store(priority, std::memory_order_relaxed);
+  }
+  [[nodiscard]] float getPriority() const {
+    return priority_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  friend class AssetLoader;
+
+  std::atomic<AssetState> state_ = AssetState::Pending;
+  std::atomic<bool> cancelled_ = false;
+  std::atomic<float> priority_ = 0.0f;
+};
+
+/// The stages of loading an asset of type T. All of them are optional.
+template<typename T>
+struct AssetDesc {
+  /// I/O thread: reads the raw bytes of the asset. Returns false on failure.
+  std::function<bool(std::vector<uint8_t>& outBytes)> read;
+  /// Decode thread: decodes or transcodes the raw bytes. Returns false on failure.
+  std::function<bool(std::vector<uint8_t>&& bytes, T& outAsset)> decode;
+  /// Render thread: creates and uploads the GPU resources of the asset. Returns false on failure.
+  std::function<bool(T& asset)> upload;
+  /// Render thread: called once with the final state of the asset.
+  std::function<void(AssetState state)> onComplete;
+  float priority = 0.0f;
+};
+
+struct AssetLoaderConfig {
+  /// Threads reading assets, so decodes never wait for I/O
+  uint32_t numIoThreads = 2;
+  /// Pool decoding the assets, which can be shared with other systems. Without one, the loader
+  /// creates a pool with one thread per core but one.
+  std::shared_ptr<igl::WorkerPool> decodePool;
+  /// Assets uploaded per update() at most, bounding the time spent on the render thread
+  uint32_t maxUploadsPerUpdate = 4;
+};
+
+/**
+ * @brief Loads assets through a pipeline of read, decode and upload stages.
+ *
+ * Reads run on a small pool of I/O threads and decodes on a pool sized for the CPU, so reading
+ * the next assets overlaps with decoding the previous ones. Each stage picks the pending asset
+ * with the highest priority when a thread frees up. Uploads and completion callbacks run on the
+ * render thread in update(), where backends stage the copies to the GPU.
+ *
+ * Destroying the loader cancels the pending assets and waits for the running stages, without
+ * calling the completion callbacks.
+ */
+class AssetLoader final {
+ public:
+  explicit AssetLoader(AssetLoaderConfig config = {});
+  ~AssetLoader();
+
+  AssetLoader(const AssetLoader&) = delete;
+  AssetLoader& operator=(const AssetLoader&) = delete;
+
+  template<typename T>
+  std::shared_ptr<AssetHandle> load(AssetDesc<T> desc) {
+    auto asset = std::make_shared<T>();
+    auto job = std::make_shared<Job>();
+    job->read = std::move(desc.read);
+    if (desc.decode) {
+      job->decode = [decode = std::move(desc.decode), asset](std::vector<uint8_t>&& bytes) {
+        return decode(std::move(bytes), *asset);
+      };
+    }
+    job->upload = [upload = std::move(desc.upload), asset]() {
+      const bool result = upload ? upload(*asset) : true;
+      // release the CPU copy once it is on the GPU
+      *asset = T();
+      return result;
+    };
+    job->onComplete = std::move(desc.onComplete);
+    job->handle->setPriority(desc.priority);
+    return submit(std::move(job));
+  }
+
+  /// Uploads decoded assets and calls the completion callbacks. Call once per frame on the
+  /// render thread.
+  void update();
+
+  /// Assets whose completion callback has not been called yet
+  [[nodiscard]] size_t getNumPending() const;
+
+ private:
+  struct Job {
+    std::shared_ptr<AssetHandle> handle = std::make_shared<AssetHandle>();
+    std::function<bool(std::vector<uint8_t>&)> read;
+    std::function<bool(std::vector<uint8_t>&&)> decode;
+    std::function<bool()> upload;
+    std::function<void(AssetState)> onComplete;
+    std::vector<uint8_t> bytes;
+    bool failed = false;
+  };
+  using JobQueue = std::vector<std::shared_ptr<Job>>;
+
+  // shared with the tasks of the pools, which may outlive the loader
+  struct State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    JobQueue readQueue;
+    JobQueue decodeQueue;
+    JobQueue uploadQueue; // decoded, failed or cancelled
+    size_t numPending = 0;
+    uint32_t numRunning = 0;
+    bool stopped = false;
+  };
+
+  std::shared_ptr<AssetHandle> submit(std::shared_ptr<Job> job);
+  // removes and returns the job with the highest priority if there is one
+  static std::shared_ptr<Job> popHighestPriority(JobQueue& queue);
+  static void read(const std::shared_ptr<State>& state,
+                   const std::shared_ptr<igl::WorkerPool>& decodePool);
+  static void decode(const std::shared_ptr<State>& state);
+
+ private:
+  AssetLoaderConfig config_;
+  std::shared_ptr<State> state_ = std::make_shared<State>();
+  std::shared_ptr<igl::WorkerPool> ioPool_;
+  std::shared_ptr<igl::WorkerPool> decodePool_;
+};
+
+} // namespace assetloader
+} // namespace iglu
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "AssetLoader.h"
+
+#include <igl/IGL.h>
+#include <shell/shared/fileLoader/FileLoader.h>
+#include <shell/shared/imageLoader/ImageLoader.h>
+#include <string>
+
+// Stages reading assets through the loaders of shell/shared. The loaders are used from the
+// threads of AssetLoader, so they must be thread safe and outlive the assets.
+
+namespace iglu {
+namespace assetloader {
+
+/// A read stage loading 'fileName' with 'fileLoader'
+inline std::function<bool(std::vector<uint8_t>&)> readFile(igl::shell::FileLoader& fileLoader,
+                                                           std::string fileName) {
+  return [&fileLoader, fileName = std::move(fileName)](std::vector<uint8_t>& outBytes) {
+    outBytes = fileLoader.loadBinaryData(fileName);
+    return !outBytes.empty();
+  };
+}
+
+/// Loads and decodes 'imageName' with 'imageLoader' on a decode thread and uploads it into a new
+/// RGBA8 texture passed to 'onLoaded' on the render thread.
+inline std::shared_ptr<AssetHandle> loadTexture(
+    AssetLoader& assetLoader,
+    igl::IDevice& device,
+    igl::shell::ImageLoader& imageLoader,
+    std::string imageName,
+    std::function<void(std::shared_ptr<igl::ITexture> texture)> onLoaded,
+    float priority = 0.0f) {
+  auto texture = std::make_shared<std::shared_ptr<igl::ITexture>>();
+  AssetDesc<igl::shell::ImageData> desc;
+  // the image loaders read and decode in one call
+  desc.decode = [&imageLoader, imageName = std::move(imageName)](std::vector<uint8_t>&& /*bytes*/,
+                                                                 igl::shell::ImageData& outImage) {
+    outImage = imageLoader.loadImageData(imageName);
+    return outImage.width && outImage.height && outImage.bitsPerComponent == 8 &&
+           outImage.bytesPerRow >= outImage.width * 4 &&
+           outImage.buffer.size() >= outImage.bytesPerRow * outImage.height;
+  };
+  desc.upload = [&device, texture](igl::shell::ImageData& image) {
+    const auto texDesc = igl::TextureDesc::new2D(igl::TextureFormat::RGBA_UNorm8,
+                                                 image.width,
+                                                 image.height,
+                                                 igl::TextureDesc::TextureUsageBits::Sampled);
+    igl::Result result;
+    *texture = device.createTexture(texDesc, &result);
+    if (!result.isOk()) {
+      return false;
+    }
+    result = (*texture)->upload(igl::TextureRangeDesc::new2D(0, 0, image.width, image.height),
+                                image.buffer.data(),
+                                image.bytesPerRow);
+    return result.isOk();
+  };
+  desc.onComplete = [texture, onLoaded = std::move(onLoaded)](AssetState state) {
+    if (onLoaded) {
+      onLoaded(state == AssetState::Loaded ? *texture : nullptr);
+    }
+  };
+  desc.priority = priority;
+  return assetLoader.load(std::move(desc));
+}
+
+} // namespace assetloader
+} // namespace iglu
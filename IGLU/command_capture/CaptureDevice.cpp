@@ -0,0 +1,1386 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/command_capture/CaptureDevice.h>
+
+#include <IGLU/command_capture/CaptureSerialization.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace iglu {
+namespace capture {
+
+/// State shared by the capture device and all the objects it creates
+class Recorder final {
+ public:
+  uint32_t newId() {
+    return nextId_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void append(Op op, const RecordWriter& record) {
+    const std::lock_guard<std::mutex> lock(streamMutex_);
+    stream_.append(op, record);
+  }
+
+  [[nodiscard]] CaptureStream getStream() const {
+    const std::lock_guard<std::mutex> lock(streamMutex_);
+    return stream_;
+  }
+
+  std::atomic<bool> recordingCommands{true};
+
+  /// Objects with shared ownership are tracked through `owner`, so that a new object allocated at
+  /// the address of a destroyed one is not mistaken for it
+  void registerObject(const void* object, uint32_t id, std::weak_ptr<const void> owner) {
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    objects_[object] = {id, std::move(owner), true};
+  }
+
+  /// Wrappers unregister themselves when they are destroyed
+  void registerWrapper(const void* wrapper, uint32_t id) {
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    objects_[wrapper] = {id, {}, false};
+  }
+
+  void unregister(const void* object) {
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    objects_.erase(object);
+  }
+
+  /// 0 if `object` is null or unknown
+  uint32_t findId(const void* object) const {
+    if (!object) {
+      return 0;
+    }
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    const auto it = objects_.find(object);
+    if (it == objects_.end() || (it->second.hasOwner && it->second.owner.expired())) {
+      return 0;
+    }
+    return it->second.id;
+  }
+
+  /// Records textures IGL did not create the first time they are seen
+  uint32_t getTextureId(const igl::ITexture* texture, std::weak_ptr<const void> owner) {
+    if (!texture) {
+      return 0;
+    }
+    uint32_t id = findId(texture);
+    if (id == 0) {
+      id = newId();
+      const igl::Dimensions dimensions = texture->getDimensions();
+      igl::TextureDesc desc = igl::TextureDesc::new2D(
+          texture->getFormat(), dimensions.width, dimensions.height, texture->getUsage());
+      desc.type = texture->getType();
+      desc.depth = dimensions.depth;
+      desc.numLayers = texture->getNumLayers();
+      desc.numSamples = texture->getSamples();
+      desc.numMipLevels = texture->getNumMipLevels();
+      desc.storage = igl::ResourceStorage::Private;
+      RecordWriter record;
+      record.write(id);
+      writeTextureDesc(record, desc);
+      append(Op::CreateExternalTexture, record);
+      if (owner.expired()) {
+        registerWrapper(texture, id);
+      } else {
+        registerObject(texture, id, std::move(owner));
+      }
+    }
+    return id;
+  }
+
+  uint32_t getTextureId(const std::shared_ptr<igl::ITexture>& texture) {
+    return getTextureId(texture.get(), texture);
+  }
+
+  uint32_t getTextureId(const igl::ITexture* texture) {
+    return getTextureId(texture, {});
+  }
+
+  void registerTextureWrapper(const igl::ITexture* wrapper,
+                              std::shared_ptr<igl::ITexture> texture) {
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    textureWrappers_[wrapper] = std::move(texture);
+  }
+  void unregisterTextureWrapper(const igl::ITexture* wrapper) {
+    unregister(wrapper);
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    textureWrappers_.erase(wrapper);
+  }
+  void registerBufferWrapper(const igl::IBuffer* wrapper, std::shared_ptr<igl::IBuffer> buffer) {
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    bufferWrappers_[wrapper] = std::move(buffer);
+  }
+  void unregisterBufferWrapper(const igl::IBuffer* wrapper) {
+    unregister(wrapper);
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    bufferWrappers_.erase(wrapper);
+  }
+
+  /// Returns the wrapped texture if `texture` is a wrapper, `texture` otherwise
+  std::shared_ptr<igl::ITexture> unwrap(const std::shared_ptr<igl::ITexture>& texture) const {
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    const auto it = textureWrappers_.find(texture.get());
+    return it != textureWrappers_.end() ? it->second : texture;
+  }
+  igl::ITexture* unwrap(igl::ITexture* texture) const {
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    const auto it = textureWrappers_.find(texture);
+    return it != textureWrappers_.end() ? it->second.get() : texture;
+  }
+  std::shared_ptr<igl::IBuffer> unwrap(const std::shared_ptr<igl::IBuffer>& buffer) const {
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    const auto it = bufferWrappers_.find(buffer.get());
+    return it != bufferWrappers_.end() ? it->second : buffer;
+  }
+  igl::IBuffer& unwrap(igl::IBuffer& buffer) const {
+    const std::lock_guard<std::mutex> lock(objectsMutex_);
+    const auto it = bufferWrappers_.find(&buffer);
+    return it != bufferWrappers_.end() ? *it->second : buffer;
+  }
+
+ private:
+  struct Entry {
+    uint32_t id = 0;
+    std::weak_ptr<const void> owner;
+    bool hasOwner = false;
+  };
+
+  std::atomic<uint32_t> nextId_{1};
+
+  mutable std::mutex streamMutex_;
+  CaptureStream stream_;
+
+  mutable std::mutex objectsMutex_;
+  std::unordered_map<const void*, Entry> objects_;
+  std::unordered_map<const igl::ITexture*, std::shared_ptr<igl::ITexture>> textureWrappers_;
+  std::unordered_map<const igl::IBuffer*, std::shared_ptr<igl::IBuffer>> bufferWrappers_;
+};
+
+namespace {
+
+void recordBufferUpload(Recorder& recorder,
+                        uint32_t id,
+                        const void* data,
+                        const igl::BufferRange& range) {
+  if (!data || range.size == 0) {
+    return;
+  }
+  RecordWriter record;
+  record.write(id);
+  record.writeSize(range.offset);
+  record.writeBlob(data, range.size);
+  recorder.append(Op::UploadBuffer, record);
+}
+
+class CaptureBuffer final : public igl::IBuffer {
+ public:
+  CaptureBuffer(std::shared_ptr<Recorder> recorder,
+                std::shared_ptr<igl::IBuffer> buffer,
+                uint32_t id) :
+    recorder_(std::move(recorder)), buffer_(std::move(buffer)), id_(id) {
+    recorder_->registerWrapper(this, id_);
+    recorder_->registerBufferWrapper(this, buffer_);
+  }
+  ~CaptureBuffer() override {
+    recorder_->unregisterBufferWrapper(this);
+  }
+
+  igl::Result upload(const void* data, const igl::BufferRange& range) override {
+    recordBufferUpload(*recorder_, id_, data, range);
+    return buffer_->upload(data, range);
+  }
+
+  void* map(const igl::BufferRange& range, igl::Result* outResult) override {
+    mappedData_ = buffer_->map(range, outResult);
+    mappedRange_ = range;
+    return mappedData_;
+  }
+
+  void unmap() override {
+    // what was written through the mapping is only known now
+    recordBufferUpload(*recorder_, id_, mappedData_, mappedRange_);
+    mappedData_ = nullptr;
+    buffer_->unmap();
+  }
+
+  [[nodiscard]] igl::BufferDesc::BufferAPIHint requestedApiHints() const noexcept override {
+    return buffer_->requestedApiHints();
+  }
+  [[nodiscard]] igl::BufferDesc::BufferAPIHint acceptedApiHints() const noexcept override {
+    return buffer_->acceptedApiHints();
+  }
+  [[nodiscard]] igl::ResourceStorage storage() const noexcept override {
+    return buffer_->storage();
+  }
+  [[nodiscard]] size_t getSizeInBytes() const override {
+    return buffer_->getSizeInBytes();
+  }
+  [[nodiscard]] uint64_t gpuAddress(size_t offset) const override {
+    return buffer_->gpuAddress(offset);
+  }
+  std::shared_ptr<igl::IReadback> readAsync(igl::ICommandQueue& cmdQueue,
+                                            const igl::BufferRange& range,
+                                            igl::Result* outResult) override;
+
+ private:
+  std::shared_ptr<Recorder> recorder_;
+  std::shared_ptr<igl::IBuffer> buffer_;
+  uint32_t id_;
+  void* mappedData_ = nullptr;
+  igl::BufferRange mappedRange_;
+};
+
+class CaptureCommandQueue;
+class CaptureCommandBuffer;
+
+class CaptureTexture final : public igl::ITexture {
+ public:
+  CaptureTexture(std::shared_ptr<Recorder> recorder,
+                 std::shared_ptr<igl::ITexture> texture,
+                 uint32_t id) :
+    ITexture(texture->getFormat()),
+    recorder_(std::move(recorder)),
+    texture_(std::move(texture)),
+    id_(id) {
+    recorder_->registerWrapper(this, id_);
+    recorder_->registerTextureWrapper(this, texture_);
+  }
+  ~CaptureTexture() override {
+    recorder_->unregisterTextureWrapper(this);
+  }
+
+  igl::Result upload(const igl::TextureRangeDesc& range,
+                     const void* data,
+                     size_t bytesPerRow) const override {
+    recordUpload(range, false, igl::TextureCubeFace::PosX, data, bytesPerRow);
+    return texture_->upload(range, data, bytesPerRow);
+  }
+
+  igl::Result uploadCube(const igl::TextureRangeDesc& range,
+                         igl::TextureCubeFace face,
+                         const void* data,
+                         size_t bytesPerRow) const override {
+    recordUpload(range, true, face, data, bytesPerRow);
+    return texture_->uploadCube(range, face, data, bytesPerRow);
+  }
+
+  [[nodiscard]] igl::Dimensions getDimensions() const override {
+    return texture_->getDimensions();
+  }
+  [[nodiscard]] size_t getNumLayers() const override {
+    return texture_->getNumLayers();
+  }
+  [[nodiscard]] igl::TextureType getType() const override {
+    return texture_->getType();
+  }
+  [[nodiscard]] igl::TextureDesc::TextureUsage getUsage() const override {
+    return texture_->getUsage();
+  }
+  [[nodiscard]] uint32_t getSamples() const override {
+    return texture_->getSamples();
+  }
+  void generateMipmap(igl::ICommandQueue& cmdQueue) const override;
+  void generateMipmap(igl::ICommandBuffer& cmdBuffer) const override;
+  [[nodiscard]] uint32_t getNumMipLevels() const override {
+    return texture_->getNumMipLevels();
+  }
+  [[nodiscard]] bool isRequiredGenerateMipmap() const override {
+    return texture_->isRequiredGenerateMipmap();
+  }
+  [[nodiscard]] uint64_t getTextureId() const override {
+    return texture_->getTextureId();
+  }
+  std::shared_ptr<igl::IReadback> readAsync(igl::ICommandQueue& cmdQueue,
+                                            const igl::TextureRangeDesc& range,
+                                            igl::Result* outResult) const override;
+
+ private:
+  void recordUpload(const igl::TextureRangeDesc& range,
+                    bool isCube,
+                    igl::TextureCubeFace face,
+                    const void* data,
+                    size_t bytesPerRow) const {
+    if (!data) {
+      return;
+    }
+    const igl::TextureFormatProperties properties = getProperties();
+    // bytesPerRow only applies to uploads of a single mip level
+    const size_t numBytes = bytesPerRow == 0 || range.numMipLevels > 1
+                                ? properties.getBytesPerRange(range)
+                                : bytesPerRow * properties.getRows(range) *
+                                      std::max(range.depth, size_t(1)) * range.numLayers;
+    RecordWriter record;
+    record.write(id_);
+    record.write(isCube);
+    record.write(face);
+    writeTextureRangeDesc(record, range);
+    record.writeSize(bytesPerRow);
+    record.writeBlob(data, numBytes);
+    recorder_->append(Op::UploadTexture, record);
+  }
+
+  std::shared_ptr<Recorder> recorder_;
+  std::shared_ptr<igl::ITexture> texture_;
+  uint32_t id_;
+};
+
+class CaptureFramebuffer final : public igl::IFramebuffer {
+ public:
+  CaptureFramebuffer(std::shared_ptr<Recorder> recorder,
+                     std::shared_ptr<igl::IFramebuffer> framebuffer,
+                     igl::FramebufferMode mode,
+                     uint32_t densityMapId) :
+    recorder_(std::move(recorder)),
+    framebuffer_(std::move(framebuffer)),
+    mode_(mode),
+    densityMapId_(densityMapId) {}
+
+  [[nodiscard]] std::vector<size_t> getColorAttachmentIndices() const override {
+    return framebuffer_->getColorAttachmentIndices();
+  }
+  [[nodiscard]] std::shared_ptr<igl::ITexture> getColorAttachment(size_t index) const override {
+    return framebuffer_->getColorAttachment(index);
+  }
+  [[nodiscard]] std::shared_ptr<igl::ITexture> getResolveColorAttachment(
+      size_t index) const override {
+    return framebuffer_->getResolveColorAttachment(index);
+  }
+  [[nodiscard]] std::shared_ptr<igl::ITexture> getDepthAttachment() const override {
+    return framebuffer_->getDepthAttachment();
+  }
+  [[nodiscard]] std::shared_ptr<igl::ITexture> getResolveDepthAttachment() const override {
+    return framebuffer_->getResolveDepthAttachment();
+  }
+  [[nodiscard]] std::shared_ptr<igl::ITexture> getStencilAttachment() const override {
+    return framebuffer_->getStencilAttachment();
+  }
+
+  void copyBytesColorAttachment(igl::ICommandQueue& cmdQueue,
+                                size_t index,
+                                void* pixelBytes,
+                                const igl::TextureRangeDesc& range,
+                                size_t bytesPerRow) const override;
+  void copyBytesDepthAttachment(igl::ICommandQueue& cmdQueue,
+                                void* pixelBytes,
+                                const igl::TextureRangeDesc& range,
+                                size_t bytesPerRow) const override;
+  void copyBytesStencilAttachment(igl::ICommandQueue& cmdQueue,
+                                  void* pixelBytes,
+                                  const igl::TextureRangeDesc& range,
+                                  size_t bytesPerRow) const override;
+  void copyTextureColorAttachment(igl::ICommandQueue& cmdQueue,
+                                  size_t index,
+                                  std::shared_ptr<igl::ITexture> destTexture,
+                                  const igl::TextureRangeDesc& range) const override;
+
+  std::shared_ptr<igl::ITexture> updateDrawable(std::shared_ptr<igl::ITexture> texture) override {
+    return framebuffer_->updateDrawable(recorder_->unwrap(texture));
+  }
+
+  [[nodiscard]] const std::shared_ptr<igl::IFramebuffer>& getWrapped() const {
+    return framebuffer_;
+  }
+
+  /// Writes the attachments the framebuffer has now; drawables can change between render passes
+  void writeAttachments(RecordWriter& record) const {
+    record.write(mode_);
+    record.write(densityMapId_);
+    const std::vector<size_t> indices = framebuffer_->getColorAttachmentIndices();
+    record.writeSize(indices.size());
+    for (const size_t index : indices) {
+      record.writeSize(index);
+      record.write(recorder_->getTextureId(framebuffer_->getColorAttachment(index)));
+      record.write(recorder_->getTextureId(framebuffer_->getResolveColorAttachment(index)));
+    }
+    record.write(recorder_->getTextureId(framebuffer_->getDepthAttachment()));
+    record.write(recorder_->getTextureId(framebuffer_->getResolveDepthAttachment()));
+    record.write(recorder_->getTextureId(framebuffer_->getStencilAttachment()));
+  }
+
+ private:
+  std::shared_ptr<Recorder> recorder_;
+  std::shared_ptr<igl::IFramebuffer> framebuffer_;
+  igl::FramebufferMode mode_;
+  uint32_t densityMapId_;
+};
+
+class CaptureCommandBuffer final : public igl::ICommandBuffer,
+                                   public std::enable_shared_from_this<CaptureCommandBuffer> {
+ public:
+  CaptureCommandBuffer(std::shared_ptr<Recorder> recorder,
+                       std::shared_ptr<igl::ICommandBuffer> commandBuffer,
+                       uint32_t id) :
+    recorder_(std::move(recorder)),
+    commandBuffer_(std::move(commandBuffer)),
+    id_(id),
+    // a command buffer is either recorded in whole or not at all
+    recording_(recorder_->recordingCommands.load()) {
+    record(Op::BeginCommandBuffer, [](RecordWriter& /*record*/) {});
+  }
+
+  std::unique_ptr<igl::IRenderCommandEncoder> createRenderCommandEncoder(
+      const igl::RenderPassDesc& renderPass,
+      std::shared_ptr<igl::IFramebuffer> framebuffer,
+      igl::Result* outResult) override;
+
+  std::unique_ptr<igl::IComputeCommandEncoder> createComputeCommandEncoder() override;
+
+  void present(std::shared_ptr<igl::ITexture> surface) const override {
+    const uint32_t surfaceId = recorder_->getTextureId(surface);
+    record(Op::Present, [&](RecordWriter& record) { record.write(surfaceId); });
+    commandBuffer_->present(recorder_->unwrap(surface));
+  }
+
+  void waitUntilScheduled() override {
+    commandBuffer_->waitUntilScheduled();
+  }
+  void waitUntilCompleted() override {
+    commandBuffer_->waitUntilCompleted();
+  }
+  void addCompletedHandler(std::function<void()> handler) override {
+    commandBuffer_->addCompletedHandler(std::move(handler));
+  }
+  [[nodiscard]] bool isCompleted() const override {
+    return commandBuffer_->isCompleted();
+  }
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override {
+    commandBuffer_->pushDebugGroupLabel(label, color);
+  }
+  void popDebugGroupLabel() const override {
+    commandBuffer_->popDebugGroupLabel();
+  }
+  void writeTimestamp(igl::ITimestampQueryPool& pool, uint32_t queryIndex) override {
+    commandBuffer_->writeTimestamp(pool, queryIndex);
+  }
+
+  /// Records a command of this command buffer, or of one of its encoders, with the id of the
+  /// recording object followed by the payload written by `writePayload`
+  template<typename F>
+  void record(Op op, uint32_t id, F&& writePayload) const {
+    if (recording_) {
+      RecordWriter record;
+      record.write(id);
+      writePayload(record);
+      recorder_->append(op, record);
+    }
+  }
+  template<typename F>
+  void record(Op op, F&& writePayload) const {
+    record(op, id_, std::forward<F>(writePayload));
+  }
+
+  [[nodiscard]] Recorder& getRecorder() const {
+    return *recorder_;
+  }
+  [[nodiscard]] igl::ICommandBuffer& getWrapped() const {
+    return *commandBuffer_;
+  }
+  [[nodiscard]] uint32_t getId() const {
+    return id_;
+  }
+
+ private:
+  std::shared_ptr<Recorder> recorder_;
+  std::shared_ptr<igl::ICommandBuffer> commandBuffer_;
+  uint32_t id_;
+  bool recording_;
+};
+
+class CaptureCommandQueue final : public igl::ICommandQueue {
+ public:
+  CaptureCommandQueue(std::shared_ptr<Recorder> recorder,
+                      std::shared_ptr<igl::ICommandQueue> commandQueue) :
+    recorder_(std::move(recorder)), commandQueue_(std::move(commandQueue)) {}
+
+  std::shared_ptr<igl::ICommandBuffer> createCommandBuffer(const igl::CommandBufferDesc& desc,
+                                                           igl::Result* outResult) override {
+    auto commandBuffer = commandQueue_->createCommandBuffer(desc, outResult);
+    if (!commandBuffer) {
+      return nullptr;
+    }
+    return std::make_shared<CaptureCommandBuffer>(
+        recorder_, std::move(commandBuffer), recorder_->newId());
+  }
+
+  igl::SubmitHandle submit(const igl::ICommandBuffer& commandBuffer, bool endOfFrame) override {
+    const auto& captureCommandBuffer = static_cast<const CaptureCommandBuffer&>(commandBuffer);
+    captureCommandBuffer.record(Op::Submit,
+                                [&](RecordWriter& record) { record.write(endOfFrame); });
+    incrementDrawCount(commandBuffer.getCurrentDrawCount());
+    return commandQueue_->submit(captureCommandBuffer.getWrapped(), endOfFrame);
+  }
+
+  // fences are not recorded: a replay runs on its own timeline
+  std::shared_ptr<igl::IFence> signalFence(igl::Result* outResult) override {
+    return commandQueue_->signalFence(outResult);
+  }
+  igl::Result waitFence(const igl::IFence& fence) override {
+    return commandQueue_->waitFence(fence);
+  }
+  std::shared_ptr<igl::IFence> importFence(const igl::FenceNativeHandle& handle,
+                                           igl::Result* outResult) override {
+    return commandQueue_->importFence(handle, outResult);
+  }
+
+  [[nodiscard]] igl::ICommandQueue& getWrapped() const {
+    return *commandQueue_;
+  }
+
+ private:
+  std::shared_ptr<Recorder> recorder_;
+  std::shared_ptr<igl::ICommandQueue> commandQueue_;
+};
+
+igl::ICommandQueue& unwrap(igl::ICommandQueue& cmdQueue) {
+  return static_cast<CaptureCommandQueue&>(cmdQueue).getWrapped();
+}
+
+// readbacks do not change resources, so they are not recorded
+std::shared_ptr<igl::IReadback> CaptureBuffer::readAsync(igl::ICommandQueue& cmdQueue,
+                                                         const igl::BufferRange& range,
+                                                         igl::Result* outResult) {
+  return buffer_->readAsync(unwrap(cmdQueue), range, outResult);
+}
+
+std::shared_ptr<igl::IReadback> CaptureTexture::readAsync(igl::ICommandQueue& cmdQueue,
+                                                          const igl::TextureRangeDesc& range,
+                                                          igl::Result* outResult) const {
+  return texture_->readAsync(unwrap(cmdQueue), range, outResult);
+}
+
+void CaptureTexture::generateMipmap(igl::ICommandQueue& cmdQueue) const {
+  RecordWriter record;
+  record.write(id_);
+  record.write(uint32_t(0)); // no command buffer
+  recorder_->append(Op::GenerateMipmap, record);
+  texture_->generateMipmap(unwrap(cmdQueue));
+}
+
+void CaptureTexture::generateMipmap(igl::ICommandBuffer& cmdBuffer) const {
+  auto& captureCommandBuffer = static_cast<CaptureCommandBuffer&>(cmdBuffer);
+  captureCommandBuffer.record(Op::GenerateMipmap, id_, [&](RecordWriter& record) {
+    record.write(captureCommandBuffer.getId());
+  });
+  texture_->generateMipmap(captureCommandBuffer.getWrapped());
+}
+
+void CaptureFramebuffer::copyBytesColorAttachment(igl::ICommandQueue& cmdQueue,
+                                                  size_t index,
+                                                  void* pixelBytes,
+                                                  const igl::TextureRangeDesc& range,
+                                                  size_t bytesPerRow) const {
+  framebuffer_->copyBytesColorAttachment(unwrap(cmdQueue), index, pixelBytes, range, bytesPerRow);
+}
+
+void CaptureFramebuffer::copyBytesDepthAttachment(igl::ICommandQueue& cmdQueue,
+                                                  void* pixelBytes,
+                                                  const igl::TextureRangeDesc& range,
+                                                  size_t bytesPerRow) const {
+  framebuffer_->copyBytesDepthAttachment(unwrap(cmdQueue), pixelBytes, range, bytesPerRow);
+}
+
+void CaptureFramebuffer::copyBytesStencilAttachment(igl::ICommandQueue& cmdQueue,
+                                                    void* pixelBytes,
+                                                    const igl::TextureRangeDesc& range,
+                                                    size_t bytesPerRow) const {
+  framebuffer_->copyBytesStencilAttachment(unwrap(cmdQueue), pixelBytes, range, bytesPerRow);
+}
+
+void CaptureFramebuffer::copyTextureColorAttachment(igl::ICommandQueue& cmdQueue,
+                                                    size_t index,
+                                                    std::shared_ptr<igl::ITexture> destTexture,
+                                                    const igl::TextureRangeDesc& range) const {
+  framebuffer_->copyTextureColorAttachment(
+      unwrap(cmdQueue), index, recorder_->unwrap(destTexture), range);
+}
+
+class CaptureRenderCommandEncoder final : public igl::IRenderCommandEncoder {
+ public:
+  CaptureRenderCommandEncoder(std::shared_ptr<CaptureCommandBuffer> commandBuffer,
+                              std::unique_ptr<igl::IRenderCommandEncoder> encoder,
+                              uint32_t id) :
+    IRenderCommandEncoder(commandBuffer),
+    commandBuffer_(std::move(commandBuffer)),
+    encoder_(std::move(encoder)),
+    id_(id) {}
+
+  void endEncoding() override {
+    record(Op::EndRenderPass, [](RecordWriter& /*record*/) {});
+    encoder_->endEncoding();
+  }
+
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override {
+    encoder_->pushDebugGroupLabel(label, color);
+  }
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override {
+    encoder_->insertDebugEventLabel(label, color);
+  }
+  void popDebugGroupLabel() const override {
+    encoder_->popDebugGroupLabel();
+  }
+
+  void bindViewport(const igl::Viewport& viewport) override {
+    record(Op::BindViewport, [&](RecordWriter& record) { record.write(viewport); });
+    encoder_->bindViewport(viewport);
+  }
+
+  void bindScissorRect(const igl::ScissorRect& rect) override {
+    record(Op::BindScissorRect, [&](RecordWriter& record) { record.write(rect); });
+    encoder_->bindScissorRect(rect);
+  }
+
+  void bindRenderPipelineState(
+      const std::shared_ptr<igl::IRenderPipelineState>& pipelineState) override {
+    const uint32_t pipelineId = recorder().findId(pipelineState.get());
+    record(Op::BindRenderPipelineState, [&](RecordWriter& record) { record.write(pipelineId); });
+    encoder_->bindRenderPipelineState(pipelineState);
+  }
+
+  void bindDepthStencilState(
+      const std::shared_ptr<igl::IDepthStencilState>& depthStencilState) override {
+    const uint32_t stateId = recorder().findId(depthStencilState.get());
+    record(Op::BindDepthStencilState, [&](RecordWriter& record) { record.write(stateId); });
+    encoder_->bindDepthStencilState(depthStencilState);
+  }
+
+  void bindRenderPipelineState(igl::IRenderPipelineState& pipelineState) override {
+    const uint32_t pipelineId = recorder().findId(&pipelineState);
+    record(Op::BindRenderPipelineState, [&](RecordWriter& record) { record.write(pipelineId); });
+    encoder_->bindRenderPipelineState(pipelineState);
+  }
+
+  void bindDepthStencilState(igl::IDepthStencilState& depthStencilState) override {
+    const uint32_t stateId = recorder().findId(&depthStencilState);
+    record(Op::BindDepthStencilState, [&](RecordWriter& record) { record.write(stateId); });
+    encoder_->bindDepthStencilState(depthStencilState);
+  }
+
+  void bindBuffer(int index,
+                  uint8_t target,
+                  const std::shared_ptr<igl::IBuffer>& buffer,
+                  size_t bufferOffset) override {
+    const uint32_t bufferId = recorder().findId(buffer.get());
+    record(Op::BindBuffer, [&](RecordWriter& record) {
+      record.write(static_cast<int32_t>(index));
+      record.write(target);
+      record.write(bufferId);
+      record.writeSize(bufferOffset);
+    });
+    encoder_->bindBuffer(index, target, recorder().unwrap(buffer), bufferOffset);
+  }
+
+  void bindBuffer(int index, uint8_t target, igl::IBuffer& buffer, size_t bufferOffset) override {
+    const uint32_t bufferId = recorder().findId(&buffer);
+    record(Op::BindBuffer, [&](RecordWriter& record) {
+      record.write(static_cast<int32_t>(index));
+      record.write(target);
+      record.write(bufferId);
+      record.writeSize(bufferOffset);
+    });
+    encoder_->bindBuffer(index, target, recorder().unwrap(buffer), bufferOffset);
+  }
+
+  void bindBytes(size_t index, uint8_t target, const void* data, size_t length) override {
+    record(Op::BindBytes, [&](RecordWriter& record) {
+      record.writeSize(index);
+      record.write(target);
+      record.writeBlob(data, length);
+    });
+    encoder_->bindBytes(index, target, data, length);
+  }
+
+  void bindPushConstants(const void* data, size_t length, size_t offset) override {
+    record(Op::BindPushConstants, [&](RecordWriter& record) {
+      record.writeSize(offset);
+      record.writeBlob(data, length);
+    });
+    encoder_->bindPushConstants(data, length, offset);
+  }
+
+  void bindBufferAddress(size_t offset, igl::IBuffer& buffer, size_t bufferOffset) override {
+    // addresses differ between runs: the replayer asks its own buffer for the address
+    const uint32_t bufferId = recorder().findId(&buffer);
+    record(Op::BindBufferAddress, [&](RecordWriter& record) {
+      record.writeSize(offset);
+      record.write(bufferId);
+      record.writeSize(bufferOffset);
+    });
+    encoder_->bindBufferAddress(offset, recorder().unwrap(buffer), bufferOffset);
+  }
+
+  void bindSamplerState(size_t index, uint8_t target, igl::ISamplerState* samplerState) override {
+    const uint32_t samplerId = recorder().findId(samplerState);
+    record(Op::BindSamplerState, [&](RecordWriter& record) {
+      record.writeSize(index);
+      record.write(target);
+      record.write(samplerId);
+    });
+    encoder_->bindSamplerState(index, target, samplerState);
+  }
+
+  void bindTexture(size_t index, uint8_t target, igl::ITexture* texture) override {
+    const uint32_t textureId = recorder().getTextureId(texture);
+    record(Op::BindTexture, [&](RecordWriter& record) {
+      record.writeSize(index);
+      record.write(target);
+      record.write(textureId);
+    });
+    encoder_->bindTexture(index, target, recorder().unwrap(texture));
+  }
+
+  void bindUniform(const igl::UniformDesc& uniformDesc, const void* data) override {
+    record(Op::BindUniform, [&](RecordWriter& record) {
+      writeUniformDesc(record, uniformDesc);
+      record.writeBlob(static_cast<const uint8_t*>(data) + uniformDesc.offset,
+                       getUniformDataSize(uniformDesc));
+    });
+    encoder_->bindUniform(uniformDesc, data);
+  }
+
+  void draw(igl::PrimitiveType primitiveType,
+            size_t vertexStart,
+            size_t vertexCount,
+            uint32_t instanceCount,
+            uint32_t baseInstance) override {
+    record(Op::Draw, [&](RecordWriter& record) {
+      record.write(primitiveType);
+      record.writeSize(vertexStart);
+      record.writeSize(vertexCount);
+      record.write(instanceCount);
+      record.write(baseInstance);
+    });
+    getCommandBuffer().incrementCurrentDrawCount();
+    encoder_->draw(primitiveType, vertexStart, vertexCount, instanceCount, baseInstance);
+  }
+
+  void drawIndexed(igl::PrimitiveType primitiveType,
+                   size_t indexCount,
+                   igl::IndexFormat indexFormat,
+                   igl::IBuffer& indexBuffer,
+                   size_t indexBufferOffset,
+                   uint32_t instanceCount,
+                   int32_t baseVertex,
+                   uint32_t baseInstance) override {
+    const uint32_t indexBufferId = recorder().findId(&indexBuffer);
+    record(Op::DrawIndexed, [&](RecordWriter& record) {
+      record.write(primitiveType);
+      record.writeSize(indexCount);
+      record.write(indexFormat);
+      record.write(indexBufferId);
+      record.writeSize(indexBufferOffset);
+      record.write(instanceCount);
+      record.write(baseVertex);
+      record.write(baseInstance);
+    });
+    getCommandBuffer().incrementCurrentDrawCount();
+    encoder_->drawIndexed(primitiveType,
+                          indexCount,
+                          indexFormat,
+                          recorder().unwrap(indexBuffer),
+                          indexBufferOffset,
+                          instanceCount,
+                          baseVertex,
+                          baseInstance);
+  }
+
+  void drawIndexedIndirect(igl::PrimitiveType primitiveType,
+                           igl::IndexFormat indexFormat,
+                           igl::IBuffer& indexBuffer,
+                           igl::IBuffer& indirectBuffer,
+                           size_t indirectBufferOffset) override {
+    const uint32_t indexBufferId = recorder().findId(&indexBuffer);
+    const uint32_t indirectBufferId = recorder().findId(&indirectBuffer);
+    record(Op::DrawIndexedIndirect, [&](RecordWriter& record) {
+      record.write(primitiveType);
+      record.write(indexFormat);
+      record.write(indexBufferId);
+      record.write(indirectBufferId);
+      record.writeSize(indirectBufferOffset);
+    });
+    getCommandBuffer().incrementCurrentDrawCount();
+    encoder_->drawIndexedIndirect(primitiveType,
+                                  indexFormat,
+                                  recorder().unwrap(indexBuffer),
+                                  recorder().unwrap(indirectBuffer),
+                                  indirectBufferOffset);
+  }
+
+  void multiDrawIndirect(igl::PrimitiveType primitiveType,
+                         igl::IBuffer& indirectBuffer,
+                         size_t indirectBufferOffset,
+                         uint32_t drawCount,
+                         uint32_t stride) override {
+    const uint32_t indirectBufferId = recorder().findId(&indirectBuffer);
+    record(Op::MultiDrawIndirect, [&](RecordWriter& record) {
+      record.write(primitiveType);
+      record.write(indirectBufferId);
+      record.writeSize(indirectBufferOffset);
+      record.write(drawCount);
+      record.write(stride);
+    });
+    getCommandBuffer().incrementCurrentDrawCount();
+    encoder_->multiDrawIndirect(primitiveType,
+                                recorder().unwrap(indirectBuffer),
+                                indirectBufferOffset,
+                                drawCount,
+                                stride);
+  }
+
+  void multiDrawIndexedIndirect(igl::PrimitiveType primitiveType,
+                                igl::IndexFormat indexFormat,
+                                igl::IBuffer& indexBuffer,
+                                igl::IBuffer& indirectBuffer,
+                                size_t indirectBufferOffset,
+                                uint32_t drawCount,
+                                uint32_t stride) override {
+    const uint32_t indexBufferId = recorder().findId(&indexBuffer);
+    const uint32_t indirectBufferId = recorder().findId(&indirectBuffer);
+    record(Op::MultiDrawIndexedIndirect, [&](RecordWriter& record) {
+      record.write(primitiveType);
+      record.write(indexFormat);
+      record.write(indexBufferId);
+      record.write(indirectBufferId);
+      record.writeSize(indirectBufferOffset);
+      record.write(drawCount);
+      record.write(stride);
+    });
+    getCommandBuffer().incrementCurrentDrawCount();
+    encoder_->multiDrawIndexedIndirect(primitiveType,
+                                       indexFormat,
+                                       recorder().unwrap(indexBuffer),
+                                       recorder().unwrap(indirectBuffer),
+                                       indirectBufferOffset,
+                                       drawCount,
+                                       stride);
+  }
+
+  void setStencilReferenceValue(uint32_t value) override {
+    setStencilReferenceValues(value, value);
+  }
+
+  void setStencilReferenceValues(uint32_t frontValue, uint32_t backValue) override {
+    record(Op::SetStencilReferenceValues, [&](RecordWriter& record) {
+      record.write(frontValue);
+      record.write(backValue);
+    });
+    encoder_->setStencilReferenceValues(frontValue, backValue);
+  }
+
+  void setBlendColor(igl::Color color) override {
+    record(Op::SetBlendColor, [&](RecordWriter& record) {
+      record.writeBytes(color.toFloatPtr(), 4 * sizeof(float));
+    });
+    encoder_->setBlendColor(color);
+  }
+
+  void setDepthBias(float depthBias, float slopeScale, float clamp) override {
+    record(Op::SetDepthBias, [&](RecordWriter& record) {
+      record.write(depthBias);
+      record.write(slopeScale);
+      record.write(clamp);
+    });
+    encoder_->setDepthBias(depthBias, slopeScale, clamp);
+  }
+
+  void beginOcclusionQuery(uint32_t queryIndex) override {
+    encoder_->beginOcclusionQuery(queryIndex);
+  }
+  void endOcclusionQuery() override {
+    encoder_->endOcclusionQuery();
+  }
+
+  void nextSubpass() override {
+    encoder_->nextSubpass();
+  }
+
+ private:
+  template<typename F>
+  void record(Op op, F&& writePayload) const {
+    commandBuffer_->record(op, id_, std::forward<F>(writePayload));
+  }
+  [[nodiscard]] Recorder& recorder() const {
+    return commandBuffer_->getRecorder();
+  }
+
+  std::shared_ptr<CaptureCommandBuffer> commandBuffer_;
+  std::unique_ptr<igl::IRenderCommandEncoder> encoder_;
+  uint32_t id_;
+};
+
+class CaptureComputeCommandEncoder final : public igl::IComputeCommandEncoder {
+ public:
+  CaptureComputeCommandEncoder(std::shared_ptr<CaptureCommandBuffer> commandBuffer,
+                               std::unique_ptr<igl::IComputeCommandEncoder> encoder,
+                               uint32_t id) :
+    commandBuffer_(std::move(commandBuffer)), encoder_(std::move(encoder)), id_(id) {}
+
+  void endEncoding() override {
+    record(Op::EndComputePass, [](RecordWriter& /*record*/) {});
+    encoder_->endEncoding();
+  }
+
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override {
+    encoder_->pushDebugGroupLabel(label, color);
+  }
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override {
+    encoder_->insertDebugEventLabel(label, color);
+  }
+  void popDebugGroupLabel() const override {
+    encoder_->popDebugGroupLabel();
+  }
+
+  void bindUniform(const igl::UniformDesc& uniformDesc, const void* data) override {
+    record(Op::ComputeBindUniform, [&](RecordWriter& record) {
+      writeUniformDesc(record, uniformDesc);
+      record.writeBlob(static_cast<const uint8_t*>(data) + uniformDesc.offset,
+                       getUniformDataSize(uniformDesc));
+    });
+    encoder_->bindUniform(uniformDesc, data);
+  }
+
+  void bindTexture(size_t index, igl::ITexture* texture) override {
+    const uint32_t textureId = recorder().getTextureId(texture);
+    record(Op::ComputeBindTexture, [&](RecordWriter& record) {
+      record.writeSize(index);
+      record.write(textureId);
+    });
+    encoder_->bindTexture(index, recorder().unwrap(texture));
+  }
+
+  void bindBuffer(size_t index,
+                  const std::shared_ptr<igl::IBuffer>& buffer,
+                  size_t offset) override {
+    const uint32_t bufferId = recorder().findId(buffer.get());
+    record(Op::ComputeBindBuffer, [&](RecordWriter& record) {
+      record.writeSize(index);
+      record.write(bufferId);
+      record.writeSize(offset);
+    });
+    encoder_->bindBuffer(index, recorder().unwrap(buffer), offset);
+  }
+
+  void bindBytes(size_t index, const void* data, size_t length) override {
+    record(Op::ComputeBindBytes, [&](RecordWriter& record) {
+      record.writeSize(index);
+      record.writeBlob(data, length);
+    });
+    encoder_->bindBytes(index, data, length);
+  }
+
+  void bindPushConstants(const void* data, size_t length, size_t offset) override {
+    record(Op::ComputeBindPushConstants, [&](RecordWriter& record) {
+      record.writeSize(offset);
+      record.writeBlob(data, length);
+    });
+    encoder_->bindPushConstants(data, length, offset);
+  }
+
+  void bindBufferAddress(size_t offset, igl::IBuffer& buffer, size_t bufferOffset) override {
+    const uint32_t bufferId = recorder().findId(&buffer);
+    record(Op::ComputeBindBufferAddress, [&](RecordWriter& record) {
+      record.writeSize(offset);
+      record.write(bufferId);
+      record.writeSize(bufferOffset);
+    });
+    encoder_->bindBufferAddress(offset, recorder().unwrap(buffer), bufferOffset);
+  }
+
+  void bindComputePipelineState(
+      const std::shared_ptr<igl::IComputePipelineState>& pipelineState) override {
+    const uint32_t pipelineId = recorder().findId(pipelineState.get());
+    record(Op::BindComputePipelineState, [&](RecordWriter& record) { record.write(pipelineId); });
+    encoder_->bindComputePipelineState(pipelineState);
+  }
+
+  void dispatchThreadGroups(const igl::Dimensions& threadgroupCount,
+                            const igl::Dimensions& threadgroupSize) override {
+    record(Op::DispatchThreadGroups, [&](RecordWriter& record) {
+      writeDimensions(record, threadgroupCount);
+      writeDimensions(record, threadgroupSize);
+    });
+    encoder_->dispatchThreadGroups(threadgroupCount, threadgroupSize);
+  }
+
+  void dispatchThreadGroupsIndirect(igl::IBuffer& indirectBuffer,
+                                    size_t indirectBufferOffset,
+                                    const igl::Dimensions& threadgroupSize) override {
+    const uint32_t indirectBufferId = recorder().findId(&indirectBuffer);
+    record(Op::DispatchThreadGroupsIndirect, [&](RecordWriter& record) {
+      record.write(indirectBufferId);
+      record.writeSize(indirectBufferOffset);
+      writeDimensions(record, threadgroupSize);
+    });
+    encoder_->dispatchThreadGroupsIndirect(
+        recorder().unwrap(indirectBuffer), indirectBufferOffset, threadgroupSize);
+  }
+
+  // groups are hints which do not change the results, so they are not recorded
+  void beginDispatchGroup() override {
+    encoder_->beginDispatchGroup();
+  }
+  void endDispatchGroup() override {
+    encoder_->endDispatchGroup();
+  }
+
+ private:
+  template<typename F>
+  void record(Op op, F&& writePayload) const {
+    commandBuffer_->record(op, id_, std::forward<F>(writePayload));
+  }
+  [[nodiscard]] Recorder& recorder() const {
+    return commandBuffer_->getRecorder();
+  }
+
+  std::shared_ptr<CaptureCommandBuffer> commandBuffer_;
+  std::unique_ptr<igl::IComputeCommandEncoder> encoder_;
+  uint32_t id_;
+};
+
+std::unique_ptr<igl::IRenderCommandEncoder> CaptureCommandBuffer::createRenderCommandEncoder(
+    const igl::RenderPassDesc& renderPass,
+    std::shared_ptr<igl::IFramebuffer> framebuffer,
+    igl::Result* outResult) {
+  if (!framebuffer) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentNull, "framebuffer is null");
+    return nullptr;
+  }
+  const auto& captureFramebuffer = static_cast<const CaptureFramebuffer&>(*framebuffer);
+  auto encoder = commandBuffer_->createRenderCommandEncoder(
+      renderPass, captureFramebuffer.getWrapped(), outResult);
+  if (!encoder) {
+    return nullptr;
+  }
+  const uint32_t encoderId = recorder_->newId();
+  record(Op::BeginRenderPass, encoderId, [&](RecordWriter& record) {
+    record.write(id_);
+    writeRenderPassDesc(record, renderPass);
+    captureFramebuffer.writeAttachments(record);
+  });
+  return std::make_unique<CaptureRenderCommandEncoder>(
+      shared_from_this(), std::move(encoder), encoderId);
+}
+
+std::unique_ptr<igl::IComputeCommandEncoder> CaptureCommandBuffer::createComputeCommandEncoder() {
+  auto encoder = commandBuffer_->createComputeCommandEncoder();
+  if (!encoder) {
+    return nullptr;
+  }
+  const uint32_t encoderId = recorder_->newId();
+  record(Op::BeginComputePass, encoderId, [&](RecordWriter& record) { record.write(id_); });
+  return std::make_unique<CaptureComputeCommandEncoder>(
+      shared_from_this(), std::move(encoder), encoderId);
+}
+
+std::shared_ptr<igl::ITexture> unwrapAttachment(const Recorder& recorder,
+                                                const std::shared_ptr<igl::ITexture>& texture) {
+  return texture ? recorder.unwrap(texture) : nullptr;
+}
+
+} // namespace
+
+CaptureDevice::CaptureDevice(std::shared_ptr<igl::IDevice> device) :
+  device_(std::move(device)), recorder_(std::make_shared<Recorder>()) {
+  IGL_ASSERT(device_);
+}
+
+CaptureDevice::~CaptureDevice() = default;
+
+void CaptureDevice::setRecordingCommands(bool enabled) {
+  recorder_->recordingCommands = enabled;
+}
+
+bool CaptureDevice::isRecordingCommands() const {
+  return recorder_->recordingCommands;
+}
+
+CaptureStream CaptureDevice::getStream() const {
+  return recorder_->getStream();
+}
+
+bool CaptureDevice::saveStream(const std::string& path, igl::Result* outResult) const {
+  return getStream().save(path, outResult);
+}
+
+bool CaptureDevice::hasFeature(igl::DeviceFeatures feature) const {
+  switch (feature) {
+  case igl::DeviceFeatures::TimestampQueries:
+  case igl::DeviceFeatures::OcclusionQueries:
+    return false;
+  default:
+    return device_->hasFeature(feature);
+  }
+}
+
+bool CaptureDevice::hasRequirement(igl::DeviceRequirement requirement) const {
+  return device_->hasRequirement(requirement);
+}
+
+igl::ICapabilities::TextureFormatCapabilities CaptureDevice::getTextureFormatCapabilities(
+    igl::TextureFormat format) const {
+  return device_->getTextureFormatCapabilities(format);
+}
+
+bool CaptureDevice::getFeatureLimits(igl::DeviceFeatureLimits featureLimits,
+                                     size_t& result) const {
+  return device_->getFeatureLimits(featureLimits, result);
+}
+
+igl::ShaderVersion CaptureDevice::getShaderVersion() const {
+  return device_->getShaderVersion();
+}
+
+std::shared_ptr<igl::ICommandQueue> CaptureDevice::createCommandQueue(
+    const igl::CommandQueueDesc& desc,
+    igl::Result* outResult) {
+  auto commandQueue = device_->createCommandQueue(desc, outResult);
+  if (!commandQueue) {
+    return nullptr;
+  }
+  return std::make_shared<CaptureCommandQueue>(recorder_, std::move(commandQueue));
+}
+
+std::unique_ptr<igl::IBuffer> CaptureDevice::createBuffer(const igl::BufferDesc& desc,
+                                                          igl::Result* outResult) const noexcept {
+  std::shared_ptr<igl::IBuffer> buffer = device_->createBuffer(desc, outResult);
+  if (!buffer) {
+    return nullptr;
+  }
+  const uint32_t id = recorder_->newId();
+  RecordWriter record;
+  record.write(id);
+  record.write(desc.type);
+  record.write(desc.hint);
+  record.write(desc.storage);
+  record.writeSize(desc.length);
+  record.writeString(desc.debugName);
+  record.writeBlob(desc.data, desc.data ? desc.length : 0);
+  recorder_->append(Op::CreateBuffer, record);
+  return std::make_unique<CaptureBuffer>(recorder_, std::move(buffer), id);
+}
+
+std::shared_ptr<igl::IDepthStencilState> CaptureDevice::createDepthStencilState(
+    const igl::DepthStencilStateDesc& desc,
+    igl::Result* outResult) const {
+  auto state = device_->createDepthStencilState(desc, outResult);
+  if (state) {
+    const uint32_t id = recorder_->newId();
+    RecordWriter record;
+    record.write(id);
+    writeDepthStencilStateDesc(record, desc);
+    recorder_->append(Op::CreateDepthStencilState, record);
+    recorder_->registerObject(state.get(), id, state);
+  }
+  return state;
+}
+
+std::shared_ptr<igl::ISamplerState> CaptureDevice::createSamplerState(
+    const igl::SamplerStateDesc& desc,
+    igl::Result* outResult) const {
+  auto sampler = device_->createSamplerState(desc, outResult);
+  if (sampler) {
+    // devices may return the same sampler for equal descriptors; record it once
+    if (recorder_->findId(sampler.get()) == 0) {
+      const uint32_t id = recorder_->newId();
+      RecordWriter record;
+      record.write(id);
+      writeSamplerStateDesc(record, desc);
+      recorder_->append(Op::CreateSamplerState, record);
+      recorder_->registerObject(sampler.get(), id, sampler);
+    }
+  }
+  return sampler;
+}
+
+std::shared_ptr<igl::ITexture> CaptureDevice::createTexture(const igl::TextureDesc& desc,
+                                                            igl::Result* outResult) const noexcept {
+  auto texture = device_->createTexture(desc, outResult);
+  if (!texture) {
+    return nullptr;
+  }
+  const uint32_t id = recorder_->newId();
+  RecordWriter record;
+  record.write(id);
+  writeTextureDesc(record, desc);
+  recorder_->append(Op::CreateTexture, record);
+  recorder_->registerObject(texture.get(), id, texture);
+  return std::make_shared<CaptureTexture>(recorder_, std::move(texture), id);
+}
+
+std::shared_ptr<igl::IVertexInputState> CaptureDevice::createVertexInputState(
+    const igl::VertexInputStateDesc& desc,
+    igl::Result* outResult) const {
+  auto state = device_->createVertexInputState(desc, outResult);
+  if (state) {
+    const uint32_t id = recorder_->newId();
+    RecordWriter record;
+    record.write(id);
+    writeVertexInputStateDesc(record, desc);
+    recorder_->append(Op::CreateVertexInputState, record);
+    recorder_->registerObject(state.get(), id, state);
+  }
+  return state;
+}
+
+std::shared_ptr<igl::IComputePipelineState> CaptureDevice::createComputePipeline(
+    const igl::ComputePipelineDesc& desc,
+    igl::Result* outResult) const {
+  auto pipeline = device_->createComputePipeline(desc, outResult);
+  if (pipeline) {
+    const uint32_t id = recorder_->newId();
+    RecordWriter record;
+    record.write(id);
+    record.write(recorder_->findId(desc.shaderStages.get()));
+    writeComputePipelineDesc(record, desc);
+    recorder_->append(Op::CreateComputePipeline, record);
+    recorder_->registerObject(pipeline.get(), id, pipeline);
+  }
+  return pipeline;
+}
+
+std::shared_ptr<igl::IRenderPipelineState> CaptureDevice::createRenderPipeline(
+    const igl::RenderPipelineDesc& desc,
+    igl::Result* outResult) const {
+  auto pipeline = device_->createRenderPipeline(desc, outResult);
+  if (pipeline) {
+    const uint32_t id = recorder_->newId();
+    RecordWriter record;
+    record.write(id);
+    record.write(recorder_->findId(desc.vertexInputState.get()));
+    record.write(recorder_->findId(desc.shaderStages.get()));
+    writeRenderPipelineDesc(record, desc);
+    recorder_->append(Op::CreateRenderPipeline, record);
+    recorder_->registerObject(pipeline.get(), id, pipeline);
+  }
+  return pipeline;
+}
+
+std::shared_ptr<igl::IShaderModule> CaptureDevice::createShaderModule(
+    const igl::ShaderModuleDesc& desc,
+    igl::Result* outResult) const {
+  auto module = device_->createShaderModule(desc, outResult);
+  if (module) {
+    const uint32_t id = recorder_->newId();
+    RecordWriter record;
+    record.write(id);
+    writeShaderModuleInfo(record, desc.info);
+    writeShaderInput(record, desc.input);
+    record.writeString(desc.debugName);
+    recorder_->append(Op::CreateShaderModule, record);
+    recorder_->registerObject(module.get(), id, module);
+  }
+  return module;
+}
+
+std::shared_ptr<igl::IFramebuffer> CaptureDevice::createFramebuffer(
+    const igl::FramebufferDesc& desc,
+    igl::Result* outResult) {
+  igl::FramebufferDesc unwrappedDesc = desc;
+  for (auto& [index, attachment] : unwrappedDesc.colorAttachments) {
+    attachment.texture = unwrapAttachment(*recorder_, attachment.texture);
+    attachment.resolveTexture = unwrapAttachment(*recorder_, attachment.resolveTexture);
+  }
+  for (auto* attachment : {&unwrappedDesc.depthAttachment,
+                           &unwrappedDesc.stencilAttachment,
+                           &unwrappedDesc.densityMapAttachment}) {
+    attachment->texture = unwrapAttachment(*recorder_, attachment->texture);
+    attachment->resolveTexture = unwrapAttachment(*recorder_, attachment->resolveTexture);
+  }
+  auto framebuffer = device_->createFramebuffer(unwrappedDesc, outResult);
+  if (!framebuffer) {
+    return nullptr;
+  }
+  return std::make_shared<CaptureFramebuffer>(
+      recorder_,
+      std::move(framebuffer),
+      desc.mode,
+      recorder_->getTextureId(unwrappedDesc.densityMapAttachment.texture));
+}
+
+std::unique_ptr<igl::IShaderLibrary> CaptureDevice::createShaderLibrary(
+    const igl::ShaderLibraryDesc& desc,
+    igl::Result* outResult) const {
+  auto library = device_->createShaderLibrary(desc, outResult);
+  if (library) {
+    RecordWriter record;
+    record.writeSize(desc.moduleInfo.size());
+    for (const auto& info : desc.moduleInfo) {
+      auto module = library->getShaderModule(info.stage, info.entryPoint);
+      const uint32_t id = module ? recorder_->newId() : 0;
+      if (module) {
+        recorder_->registerObject(module.get(), id, module);
+      }
+      record.write(id);
+      writeShaderModuleInfo(record, info);
+    }
+    writeShaderInput(record, desc.input);
+    record.writeString(desc.debugName);
+    recorder_->append(Op::CreateShaderLibrary, record);
+  }
+  return library;
+}
+
+std::unique_ptr<igl::IShaderStages> CaptureDevice::createShaderStages(
+    const igl::ShaderStagesDesc& desc,
+    igl::Result* outResult) const {
+  auto stages = device_->createShaderStages(desc, outResult);
+  if (stages) {
+    const uint32_t id = recorder_->newId();
+    RecordWriter record;
+    record.write(id);
+    record.write(desc.type);
+    record.write(recorder_->findId(desc.vertexModule.get()));
+    record.write(recorder_->findId(desc.fragmentModule.get()));
+    record.write(recorder_->findId(desc.computeModule.get()));
+    recorder_->append(Op::CreateShaderStages, record);
+    // pipelines hold shader stages through shared pointers created by the caller from this one
+    recorder_->registerWrapper(stages.get(), id);
+  }
+  return stages;
+}
+
+const igl::IPlatformDevice& CaptureDevice::getPlatformDevice() const noexcept {
+  return device_->getPlatformDevice();
+}
+
+bool CaptureDevice::verifyScope() {
+  return device_->verifyScope();
+}
+
+igl::BackendType CaptureDevice::getBackendType() const {
+  return device_->getBackendType();
+}
+
+igl::NormalizedZRange CaptureDevice::getNormalizedZRange() const {
+  return device_->getNormalizedZRange();
+}
+
+size_t CaptureDevice::getCurrentDrawCount() const {
+  return device_->getCurrentDrawCount();
+}
+
+igl::FrameStatistics CaptureDevice::getFrameStatistics() const {
+  return device_->getFrameStatistics();
+}
+
+std::vector<igl::FrameStatistics> CaptureDevice::getFrameStatisticsHistory() const {
+  return device_->getFrameStatisticsHistory();
+}
+
+bool CaptureDevice::getDeviceMemoryUsage(igl::DeviceMemoryUsage& outUsage) const {
+  return device_->getDeviceMemoryUsage(outUsage);
+}
+
+void CaptureDevice::updateSurface(void* nativeWindowType) {
+  device_->updateSurface(nativeWindowType);
+}
+
+} // namespace capture
+} // namespace iglu
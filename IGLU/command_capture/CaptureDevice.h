@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/command_capture/CaptureStream.h>
+#include <igl/Device.h>
+#include <memory>
+#include <string>
+
+namespace iglu {
+namespace capture {
+
+class Recorder;
+
+/**
+ * @brief An igl::IDevice which records every call made through it, and the objects it creates,
+ * into a CaptureStream while forwarding them to the wrapped device.
+ *
+ * Resource creation and uploads (including the bytes written through IBuffer::map()/unmap()) are
+ * always recorded, so that a capture of commands started mid-session can still be played back.
+ * Commands of command buffers, render and compute passes are recorded while
+ * isRecordingCommands(). Textures IGL did not create, such as swapchain images, are recorded with
+ * their description the first time they are used and replaced by offscreen textures on playback.
+ *
+ * Command queues, buffers, textures and framebuffers returned by the device are wrappers: they can
+ * only be passed to the objects of this device, not to backend-specific code. Parallel render
+ * command encoders, timestamp and occlusion queries are not recorded; the capture device reports
+ * them as unsupported. Buffer GPU addresses and bindless texture ids differ on playback.
+ */
+class CaptureDevice final : public igl::IDevice {
+ public:
+  explicit CaptureDevice(std::shared_ptr<igl::IDevice> device);
+  ~CaptureDevice() override;
+
+  /// Commands are recorded while enabled (the default); resources are always recorded
+  void setRecordingCommands(bool enabled);
+  [[nodiscard]] bool isRecordingCommands() const;
+
+  /// Returns a copy of everything recorded so far
+  [[nodiscard]] CaptureStream getStream() const;
+  bool saveStream(const std::string& path, igl::Result* IGL_NULLABLE outResult) const;
+
+  [[nodiscard]] igl::IDevice& getWrappedDevice() const {
+    return *device_;
+  }
+
+  // ICapabilities
+  [[nodiscard]] bool hasFeature(igl::DeviceFeatures feature) const override;
+  [[nodiscard]] bool hasRequirement(igl::DeviceRequirement requirement) const override;
+  [[nodiscard]] TextureFormatCapabilities getTextureFormatCapabilities(
+      igl::TextureFormat format) const override;
+  bool getFeatureLimits(igl::DeviceFeatureLimits featureLimits, size_t& result) const override;
+  [[nodiscard]] igl::ShaderVersion getShaderVersion() const override;
+
+  // IDevice
+  std::shared_ptr<igl::ICommandQueue> createCommandQueue(
+      const igl::CommandQueueDesc& desc,
+      igl::Result* IGL_NULLABLE outResult) override;
+  std::unique_ptr<igl::IBuffer> createBuffer(const igl::BufferDesc& desc,
+                                             igl::Result* IGL_NULLABLE
+                                                 outResult) const noexcept override;
+  std::shared_ptr<igl::IDepthStencilState> createDepthStencilState(
+      const igl::DepthStencilStateDesc& desc,
+      igl::Result* IGL_NULLABLE outResult) const override;
+  std::shared_ptr<igl::ISamplerState> createSamplerState(
+      const igl::SamplerStateDesc& desc,
+      igl::Result* IGL_NULLABLE outResult) const override;
+  std::shared_ptr<igl::ITexture> createTexture(const igl::TextureDesc& desc,
+                                               igl::Result* IGL_NULLABLE
+                                                   outResult) const noexcept override;
+  std::shared_ptr<igl::IVertexInputState> createVertexInputState(
+      const igl::VertexInputStateDesc& desc,
+      igl::Result* IGL_NULLABLE outResult) const override;
+  std::shared_ptr<igl::IComputePipelineState> createComputePipeline(
+      const igl::ComputePipelineDesc& desc,
+      igl::Result* IGL_NULLABLE outResult) const override;
+  std::shared_ptr<igl::IRenderPipelineState> createRenderPipeline(
+      const igl::RenderPipelineDesc& desc,
+      igl::Result* IGL_NULLABLE outResult) const override;
+  std::shared_ptr<igl::IShaderModule> createShaderModule(
+      const igl::ShaderModuleDesc& desc,
+      igl::Result* IGL_NULLABLE outResult) const override;
+  std::shared_ptr<igl::IFramebuffer> createFramebuffer(
+      const igl::FramebufferDesc& desc,
+      igl::Result* IGL_NULLABLE outResult) override;
+  std::unique_ptr<igl::IShaderLibrary> createShaderLibrary(
+      const igl::ShaderLibraryDesc& desc,
+      igl::Result* IGL_NULLABLE outResult) const override;
+  std::unique_ptr<igl::IShaderStages> createShaderStages(
+      const igl::ShaderStagesDesc& desc,
+      igl::Result* IGL_NULLABLE outResult) const override;
+
+  [[nodiscard]] const igl::IPlatformDevice& getPlatformDevice() const noexcept override;
+  bool verifyScope() override;
+  [[nodiscard]] igl::BackendType getBackendType() const override;
+  [[nodiscard]] igl::NormalizedZRange getNormalizedZRange() const override;
+  [[nodiscard]] size_t getCurrentDrawCount() const override;
+  [[nodiscard]] igl::FrameStatistics getFrameStatistics() const override;
+  [[nodiscard]] std::vector<igl::FrameStatistics> getFrameStatisticsHistory() const override;
+  bool getDeviceMemoryUsage(igl::DeviceMemoryUsage& outUsage) const override;
+  void updateSurface(void* IGL_NONNULL nativeWindowType) override;
+
+ private:
+  std::shared_ptr<igl::IDevice> device_;
+  std::shared_ptr<Recorder> recorder_;
+};
+
+} // namespace capture
+} // namespace iglu
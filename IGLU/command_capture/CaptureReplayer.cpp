@@ -0,0 +1,786 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/command_capture/CaptureReplayer.h>
+
+#include <IGLU/command_capture/CaptureSerialization.h>
+#include <chrono>
+#include <map>
+#include <numeric>
+#include <unordered_map>
+
+namespace iglu {
+namespace capture {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+bool isCreateOp(Op op) {
+  return op <= Op::CreateComputePipeline && op != Op::UploadBuffer && op != Op::UploadTexture;
+}
+
+bool isUploadOp(Op op) {
+  return op == Op::UploadBuffer || op == Op::UploadTexture;
+}
+
+template<typename T>
+using ObjectMap = std::unordered_map<uint32_t, std::shared_ptr<T>>;
+
+/// Returns the object with `id`, or null for id 0 and for objects which failed to replay
+template<typename T>
+std::shared_ptr<T> find(const ObjectMap<T>& objects, uint32_t id) {
+  const auto it = objects.find(id);
+  return it != objects.end() ? it->second : nullptr;
+}
+
+class Replay final {
+ public:
+  Replay(igl::IDevice& device,
+         std::shared_ptr<igl::ICommandQueue> commandQueue,
+         ReplayStats& stats) :
+    device_(device), commandQueue_(std::move(commandQueue)), stats_(stats) {}
+
+  /// Returns false if the record is malformed
+  bool execute(const Record& record);
+
+  /// Waits for the last command buffer submitted and drops the ones left unsubmitted
+  void finishIteration() {
+    if (lastCommandBuffer_) {
+      lastCommandBuffer_->waitUntilCompleted();
+      lastCommandBuffer_ = nullptr;
+    }
+    renderEncoders_.clear();
+    computeEncoders_.clear();
+    commandBuffers_.clear();
+  }
+
+ private:
+  void createBuffer(RecordReader& reader);
+  void uploadBuffer(RecordReader& reader);
+  void createTexture(RecordReader& reader, bool isExternal);
+  void uploadTexture(RecordReader& reader);
+  void createShaderModule(RecordReader& reader);
+  void createShaderLibrary(RecordReader& reader);
+  void createShaderStages(RecordReader& reader);
+  void createRenderPipeline(RecordReader& reader);
+  void createComputePipeline(RecordReader& reader);
+  void generateMipmap(RecordReader& reader);
+  void beginRenderPass(RecordReader& reader, uint32_t encoderId);
+  void executeRenderCommand(Op op, RecordReader& reader, igl::IRenderCommandEncoder& encoder);
+  void executeComputeCommand(Op op, RecordReader& reader, igl::IComputeCommandEncoder& encoder);
+
+  std::shared_ptr<igl::IFramebuffer> getFramebuffer(const std::vector<uint32_t>& key,
+                                                    const igl::FramebufferDesc& desc);
+
+  igl::IDevice& device_;
+  std::shared_ptr<igl::ICommandQueue> commandQueue_;
+  ReplayStats& stats_;
+
+  ObjectMap<igl::IBuffer> buffers_;
+  ObjectMap<igl::ITexture> textures_;
+  ObjectMap<igl::ISamplerState> samplers_;
+  ObjectMap<igl::IDepthStencilState> depthStencilStates_;
+  ObjectMap<igl::IVertexInputState> vertexInputStates_;
+  ObjectMap<igl::IShaderModule> shaderModules_;
+  ObjectMap<igl::IShaderStages> shaderStages_;
+  ObjectMap<igl::IRenderPipelineState> renderPipelines_;
+  ObjectMap<igl::IComputePipelineState> computePipelines_;
+  std::vector<std::shared_ptr<igl::IShaderLibrary>> shaderLibraries_;
+  /// Framebuffers by the ids of their attachments
+  std::map<std::vector<uint32_t>, std::shared_ptr<igl::IFramebuffer>> framebuffers_;
+
+  ObjectMap<igl::ICommandBuffer> commandBuffers_;
+  std::unordered_map<uint32_t, std::unique_ptr<igl::IRenderCommandEncoder>> renderEncoders_;
+  std::unordered_map<uint32_t, std::unique_ptr<igl::IComputeCommandEncoder>> computeEncoders_;
+  std::shared_ptr<igl::ICommandBuffer> lastCommandBuffer_;
+};
+
+bool Replay::execute(const Record& record) {
+  RecordReader reader(record.data, record.size);
+  switch (record.op) {
+  case Op::CreateBuffer:
+    createBuffer(reader);
+    break;
+  case Op::UploadBuffer:
+    uploadBuffer(reader);
+    break;
+  case Op::CreateTexture:
+    createTexture(reader, false);
+    break;
+  case Op::CreateExternalTexture:
+    createTexture(reader, true);
+    break;
+  case Op::UploadTexture:
+    uploadTexture(reader);
+    break;
+  case Op::CreateSamplerState: {
+    const auto id = reader.read<uint32_t>();
+    const igl::SamplerStateDesc desc = readSamplerStateDesc(reader);
+    if (!reader.failed()) {
+      samplers_[id] = device_.createSamplerState(desc, nullptr);
+    }
+    break;
+  }
+  case Op::CreateDepthStencilState: {
+    const auto id = reader.read<uint32_t>();
+    const igl::DepthStencilStateDesc desc = readDepthStencilStateDesc(reader);
+    if (!reader.failed()) {
+      depthStencilStates_[id] = device_.createDepthStencilState(desc, nullptr);
+    }
+    break;
+  }
+  case Op::CreateVertexInputState: {
+    const auto id = reader.read<uint32_t>();
+    const igl::VertexInputStateDesc desc = readVertexInputStateDesc(reader);
+    if (!reader.failed()) {
+      vertexInputStates_[id] = device_.createVertexInputState(desc, nullptr);
+    }
+    break;
+  }
+  case Op::CreateShaderModule:
+    createShaderModule(reader);
+    break;
+  case Op::CreateShaderLibrary:
+    createShaderLibrary(reader);
+    break;
+  case Op::CreateShaderStages:
+    createShaderStages(reader);
+    break;
+  case Op::CreateRenderPipeline:
+    createRenderPipeline(reader);
+    break;
+  case Op::CreateComputePipeline:
+    createComputePipeline(reader);
+    break;
+  case Op::BeginCommandBuffer: {
+    const auto id = reader.read<uint32_t>();
+    if (!reader.failed()) {
+      commandBuffers_[id] = commandQueue_->createCommandBuffer({}, nullptr);
+    }
+    break;
+  }
+  case Op::Present:
+    // the presented surfaces are offscreen textures
+    break;
+  case Op::Submit: {
+    const auto id = reader.read<uint32_t>();
+    const auto endOfFrame = reader.read<bool>();
+    const auto it = commandBuffers_.find(id);
+    if (!reader.failed() && it != commandBuffers_.end() && it->second) {
+      commandQueue_->submit(*it->second, endOfFrame);
+      lastCommandBuffer_ = it->second;
+      commandBuffers_.erase(it);
+      stats_.submits++;
+      stats_.frames += endOfFrame ? 1 : 0;
+    }
+    break;
+  }
+  case Op::GenerateMipmap:
+    generateMipmap(reader);
+    break;
+  case Op::BeginRenderPass:
+    beginRenderPass(reader, reader.read<uint32_t>());
+    break;
+  case Op::BeginComputePass: {
+    const auto encoderId = reader.read<uint32_t>();
+    const auto commandBuffer = find(commandBuffers_, reader.read<uint32_t>());
+    if (!reader.failed() && commandBuffer) {
+      computeEncoders_[encoderId] = commandBuffer->createComputeCommandEncoder();
+    }
+    break;
+  }
+  default: {
+    // commands of an encoder
+    const auto encoderId = reader.read<uint32_t>();
+    if (record.op < Op::BeginComputePass) {
+      const auto it = renderEncoders_.find(encoderId);
+      if (it != renderEncoders_.end() && it->second) {
+        executeRenderCommand(record.op, reader, *it->second);
+        if (record.op == Op::EndRenderPass) {
+          renderEncoders_.erase(it);
+        }
+      }
+    } else {
+      const auto it = computeEncoders_.find(encoderId);
+      if (it != computeEncoders_.end() && it->second) {
+        executeComputeCommand(record.op, reader, *it->second);
+        if (record.op == Op::EndComputePass) {
+          computeEncoders_.erase(it);
+        }
+      }
+    }
+    break;
+  }
+  }
+  return !reader.failed();
+}
+
+void Replay::createBuffer(RecordReader& reader) {
+  const auto id = reader.read<uint32_t>();
+  const auto type = reader.read<igl::BufferDesc::BufferType>();
+  const auto hint = reader.read<igl::BufferDesc::BufferAPIHint>();
+  const auto storage = reader.read<igl::ResourceStorage>();
+  const size_t length = reader.readSize();
+  const std::string debugName = reader.readString();
+  size_t dataLength = 0;
+  const uint8_t* data = reader.readBlob(dataLength);
+  if (!reader.failed()) {
+    const igl::BufferDesc desc(type, dataLength ? data : nullptr, length, storage, hint, debugName);
+    buffers_[id] = device_.createBuffer(desc, nullptr);
+  }
+}
+
+void Replay::uploadBuffer(RecordReader& reader) {
+  const auto buffer = find(buffers_, reader.read<uint32_t>());
+  const size_t offset = reader.readSize();
+  size_t length = 0;
+  const uint8_t* data = reader.readBlob(length);
+  if (!reader.failed() && buffer) {
+    buffer->upload(data, igl::BufferRange(length, offset));
+  }
+}
+
+void Replay::createTexture(RecordReader& reader, bool isExternal) {
+  const auto id = reader.read<uint32_t>();
+  igl::TextureDesc desc = readTextureDesc(reader);
+  if (reader.failed()) {
+    return;
+  }
+  if (isExternal) {
+    if (desc.type == igl::TextureType::ExternalImage || desc.type == igl::TextureType::Invalid) {
+      desc.type = igl::TextureType::TwoD;
+    }
+    desc.usage |= igl::TextureDesc::TextureUsageBits::Attachment;
+    desc.storage = igl::ResourceStorage::Private;
+  }
+  textures_[id] = device_.createTexture(desc, nullptr);
+}
+
+void Replay::uploadTexture(RecordReader& reader) {
+  const auto texture = find(textures_, reader.read<uint32_t>());
+  const auto isCube = reader.read<bool>();
+  const auto face = reader.read<igl::TextureCubeFace>();
+  const igl::TextureRangeDesc range = readTextureRangeDesc(reader);
+  const size_t bytesPerRow = reader.readSize();
+  size_t length = 0;
+  const uint8_t* data = reader.readBlob(length);
+  if (reader.failed() || !texture) {
+    return;
+  }
+  if (isCube) {
+    texture->uploadCube(range, face, data, bytesPerRow);
+  } else {
+    texture->upload(range, data, bytesPerRow);
+  }
+}
+
+void Replay::createShaderModule(RecordReader& reader) {
+  const auto id = reader.read<uint32_t>();
+  igl::ShaderModuleDesc desc;
+  desc.info = readShaderModuleInfo(reader);
+  desc.input = readShaderInput(reader);
+  desc.debugName = reader.readString();
+  if (!reader.failed()) {
+    shaderModules_[id] = device_.createShaderModule(desc, nullptr);
+  }
+}
+
+void Replay::createShaderLibrary(RecordReader& reader) {
+  igl::ShaderLibraryDesc desc;
+  std::vector<uint32_t> ids(reader.readSize());
+  for (uint32_t& id : ids) {
+    id = reader.read<uint32_t>();
+    desc.moduleInfo.push_back(readShaderModuleInfo(reader));
+    if (reader.failed()) {
+      return;
+    }
+  }
+  desc.input = readShaderInput(reader);
+  desc.debugName = reader.readString();
+  if (reader.failed()) {
+    return;
+  }
+  std::shared_ptr<igl::IShaderLibrary> library = device_.createShaderLibrary(desc, nullptr);
+  if (!library) {
+    return;
+  }
+  for (size_t i = 0; i != ids.size(); i++) {
+    if (ids[i] != 0) {
+      shaderModules_[ids[i]] =
+          library->getShaderModule(desc.moduleInfo[i].stage, desc.moduleInfo[i].entryPoint);
+    }
+  }
+  shaderLibraries_.push_back(std::move(library));
+}
+
+void Replay::createShaderStages(RecordReader& reader) {
+  const auto id = reader.read<uint32_t>();
+  igl::ShaderStagesDesc desc;
+  desc.type = reader.read<igl::ShaderStagesType>();
+  desc.vertexModule = find(shaderModules_, reader.read<uint32_t>());
+  desc.fragmentModule = find(shaderModules_, reader.read<uint32_t>());
+  desc.computeModule = find(shaderModules_, reader.read<uint32_t>());
+  if (!reader.failed()) {
+    shaderStages_[id] = device_.createShaderStages(desc, nullptr);
+  }
+}
+
+void Replay::createRenderPipeline(RecordReader& reader) {
+  const auto id = reader.read<uint32_t>();
+  igl::RenderPipelineDesc desc;
+  desc.vertexInputState = find(vertexInputStates_, reader.read<uint32_t>());
+  desc.shaderStages = find(shaderStages_, reader.read<uint32_t>());
+  readRenderPipelineDesc(reader, desc);
+  if (!reader.failed() && desc.shaderStages) {
+    renderPipelines_[id] = device_.createRenderPipeline(desc, nullptr);
+  }
+}
+
+void Replay::createComputePipeline(RecordReader& reader) {
+  const auto id = reader.read<uint32_t>();
+  igl::ComputePipelineDesc desc;
+  desc.shaderStages = find(shaderStages_, reader.read<uint32_t>());
+  readComputePipelineDesc(reader, desc);
+  if (!reader.failed() && desc.shaderStages) {
+    computePipelines_[id] = device_.createComputePipeline(desc, nullptr);
+  }
+}
+
+void Replay::generateMipmap(RecordReader& reader) {
+  const auto texture = find(textures_, reader.read<uint32_t>());
+  const auto commandBufferId = reader.read<uint32_t>();
+  if (reader.failed() || !texture) {
+    return;
+  }
+  if (commandBufferId == 0) {
+    texture->generateMipmap(*commandQueue_);
+  } else if (const auto commandBuffer = find(commandBuffers_, commandBufferId)) {
+    texture->generateMipmap(*commandBuffer);
+  }
+}
+
+void Replay::beginRenderPass(RecordReader& reader, uint32_t encoderId) {
+  const auto commandBuffer = find(commandBuffers_, reader.read<uint32_t>());
+  const igl::RenderPassDesc renderPass = readRenderPassDesc(reader);
+
+  igl::FramebufferDesc desc;
+  desc.mode = reader.read<igl::FramebufferMode>();
+  std::vector<uint32_t> key = {static_cast<uint32_t>(desc.mode)};
+  auto readAttachment = [&](igl::FramebufferDesc::AttachmentDesc& attachment) {
+    const auto textureId = reader.read<uint32_t>();
+    const auto resolveTextureId = reader.read<uint32_t>();
+    attachment.texture = find(textures_, textureId);
+    attachment.resolveTexture = find(textures_, resolveTextureId);
+    key.push_back(textureId);
+    key.push_back(resolveTextureId);
+  };
+  const auto densityMapId = reader.read<uint32_t>();
+  desc.densityMapAttachment.texture = find(textures_, densityMapId);
+  key.push_back(densityMapId);
+  const size_t numColorAttachments = reader.readSize();
+  for (size_t i = 0; i != numColorAttachments && !reader.failed(); i++) {
+    const size_t index = reader.readSize();
+    key.push_back(static_cast<uint32_t>(index));
+    readAttachment(desc.colorAttachments[index]);
+  }
+  readAttachment(desc.depthAttachment);
+  const auto stencilId = reader.read<uint32_t>();
+  desc.stencilAttachment.texture = find(textures_, stencilId);
+  key.push_back(stencilId);
+
+  if (reader.failed() || !commandBuffer) {
+    return;
+  }
+  const auto framebuffer = getFramebuffer(key, desc);
+  if (framebuffer) {
+    renderEncoders_[encoderId] =
+        commandBuffer->createRenderCommandEncoder(renderPass, framebuffer, nullptr);
+  }
+}
+
+std::shared_ptr<igl::IFramebuffer> Replay::getFramebuffer(const std::vector<uint32_t>& key,
+                                                          const igl::FramebufferDesc& desc) {
+  auto& framebuffer = framebuffers_[key];
+  if (!framebuffer) {
+    framebuffer = device_.createFramebuffer(desc, nullptr);
+  }
+  return framebuffer;
+}
+
+void Replay::executeRenderCommand(Op op,
+                                  RecordReader& reader,
+                                  igl::IRenderCommandEncoder& encoder) {
+  switch (op) {
+  case Op::EndRenderPass:
+    encoder.endEncoding();
+    break;
+  case Op::BindViewport: {
+    const auto viewport = reader.read<igl::Viewport>();
+    if (!reader.failed()) {
+      encoder.bindViewport(viewport);
+    }
+    break;
+  }
+  case Op::BindScissorRect: {
+    const auto rect = reader.read<igl::ScissorRect>();
+    if (!reader.failed()) {
+      encoder.bindScissorRect(rect);
+    }
+    break;
+  }
+  case Op::BindRenderPipelineState: {
+    const auto pipeline = find(renderPipelines_, reader.read<uint32_t>());
+    if (pipeline) {
+      encoder.bindRenderPipelineState(pipeline);
+    }
+    break;
+  }
+  case Op::BindDepthStencilState: {
+    const auto state = find(depthStencilStates_, reader.read<uint32_t>());
+    if (state) {
+      encoder.bindDepthStencilState(state);
+    }
+    break;
+  }
+  case Op::BindBuffer: {
+    const auto index = reader.read<int32_t>();
+    const auto target = reader.read<uint8_t>();
+    const auto buffer = find(buffers_, reader.read<uint32_t>());
+    const size_t offset = reader.readSize();
+    if (!reader.failed() && buffer) {
+      encoder.bindBuffer(index, target, buffer, offset);
+    }
+    break;
+  }
+  case Op::BindBytes: {
+    const size_t index = reader.readSize();
+    const auto target = reader.read<uint8_t>();
+    size_t length = 0;
+    const uint8_t* data = reader.readBlob(length);
+    if (!reader.failed()) {
+      encoder.bindBytes(index, target, data, length);
+    }
+    break;
+  }
+  case Op::BindPushConstants: {
+    const size_t offset = reader.readSize();
+    size_t length = 0;
+    const uint8_t* data = reader.readBlob(length);
+    if (!reader.failed()) {
+      encoder.bindPushConstants(data, length, offset);
+    }
+    break;
+  }
+  case Op::BindBufferAddress: {
+    const size_t offset = reader.readSize();
+    const auto buffer = find(buffers_, reader.read<uint32_t>());
+    const size_t bufferOffset = reader.readSize();
+    if (!reader.failed() && buffer) {
+      encoder.bindBufferAddress(offset, *buffer, bufferOffset);
+    }
+    break;
+  }
+  case Op::BindSamplerState: {
+    const size_t index = reader.readSize();
+    const auto target = reader.read<uint8_t>();
+    const auto sampler = find(samplers_, reader.read<uint32_t>());
+    if (!reader.failed()) {
+      encoder.bindSamplerState(index, target, sampler.get());
+    }
+    break;
+  }
+  case Op::BindTexture: {
+    const size_t index = reader.readSize();
+    const auto target = reader.read<uint8_t>();
+    const auto texture = find(textures_, reader.read<uint32_t>());
+    if (!reader.failed()) {
+      encoder.bindTexture(index, target, texture.get());
+    }
+    break;
+  }
+  case Op::BindUniform: {
+    const igl::UniformDesc desc = readUniformDesc(reader);
+    size_t length = 0;
+    const uint8_t* data = reader.readBlob(length);
+    if (!reader.failed() && length == getUniformDataSize(desc)) {
+      encoder.bindUniform(desc, data);
+    }
+    break;
+  }
+  case Op::Draw: {
+    const auto primitiveType = reader.read<igl::PrimitiveType>();
+    const size_t vertexStart = reader.readSize();
+    const size_t vertexCount = reader.readSize();
+    const auto instanceCount = reader.read<uint32_t>();
+    const auto baseInstance = reader.read<uint32_t>();
+    if (!reader.failed()) {
+      encoder.draw(primitiveType, vertexStart, vertexCount, instanceCount, baseInstance);
+      stats_.draws++;
+    }
+    break;
+  }
+  case Op::DrawIndexed: {
+    const auto primitiveType = reader.read<igl::PrimitiveType>();
+    const size_t indexCount = reader.readSize();
+    const auto indexFormat = reader.read<igl::IndexFormat>();
+    const auto indexBuffer = find(buffers_, reader.read<uint32_t>());
+    const size_t indexBufferOffset = reader.readSize();
+    const auto instanceCount = reader.read<uint32_t>();
+    const auto baseVertex = reader.read<int32_t>();
+    const auto baseInstance = reader.read<uint32_t>();
+    if (!reader.failed() && indexBuffer) {
+      encoder.drawIndexed(primitiveType,
+                          indexCount,
+                          indexFormat,
+                          *indexBuffer,
+                          indexBufferOffset,
+                          instanceCount,
+                          baseVertex,
+                          baseInstance);
+      stats_.draws++;
+    }
+    break;
+  }
+  case Op::DrawIndexedIndirect: {
+    const auto primitiveType = reader.read<igl::PrimitiveType>();
+    const auto indexFormat = reader.read<igl::IndexFormat>();
+    const auto indexBuffer = find(buffers_, reader.read<uint32_t>());
+    const auto indirectBuffer = find(buffers_, reader.read<uint32_t>());
+    const size_t indirectBufferOffset = reader.readSize();
+    if (!reader.failed() && indexBuffer && indirectBuffer) {
+      encoder.drawIndexedIndirect(
+          primitiveType, indexFormat, *indexBuffer, *indirectBuffer, indirectBufferOffset);
+      stats_.draws++;
+    }
+    break;
+  }
+  case Op::MultiDrawIndirect: {
+    const auto primitiveType = reader.read<igl::PrimitiveType>();
+    const auto indirectBuffer = find(buffers_, reader.read<uint32_t>());
+    const size_t indirectBufferOffset = reader.readSize();
+    const auto drawCount = reader.read<uint32_t>();
+    const auto stride = reader.read<uint32_t>();
+    if (!reader.failed() && indirectBuffer) {
+      encoder.multiDrawIndirect(
+          primitiveType, *indirectBuffer, indirectBufferOffset, drawCount, stride);
+      stats_.draws++;
+    }
+    break;
+  }
+  case Op::MultiDrawIndexedIndirect: {
+    const auto primitiveType = reader.read<igl::PrimitiveType>();
+    const auto indexFormat = reader.read<igl::IndexFormat>();
+    const auto indexBuffer = find(buffers_, reader.read<uint32_t>());
+    const auto indirectBuffer = find(buffers_, reader.read<uint32_t>());
+    const size_t indirectBufferOffset = reader.readSize();
+    const auto drawCount = reader.read<uint32_t>();
+    const auto stride = reader.read<uint32_t>();
+    if (!reader.failed() && indexBuffer && indirectBuffer) {
+      encoder.multiDrawIndexedIndirect(primitiveType,
+                                       indexFormat,
+                                       *indexBuffer,
+                                       *indirectBuffer,
+                                       indirectBufferOffset,
+                                       drawCount,
+                                       stride);
+      stats_.draws++;
+    }
+    break;
+  }
+  case Op::SetStencilReferenceValues: {
+    const auto frontValue = reader.read<uint32_t>();
+    const auto backValue = reader.read<uint32_t>();
+    if (!reader.failed()) {
+      encoder.setStencilReferenceValues(frontValue, backValue);
+    }
+    break;
+  }
+  case Op::SetBlendColor: {
+    const auto r = reader.read<float>();
+    const auto g = reader.read<float>();
+    const auto b = reader.read<float>();
+    const auto a = reader.read<float>();
+    if (!reader.failed()) {
+      encoder.setBlendColor(igl::Color(r, g, b, a));
+    }
+    break;
+  }
+  case Op::SetDepthBias: {
+    const auto depthBias = reader.read<float>();
+    const auto slopeScale = reader.read<float>();
+    const auto clamp = reader.read<float>();
+    if (!reader.failed()) {
+      encoder.setDepthBias(depthBias, slopeScale, clamp);
+    }
+    break;
+  }
+  default:
+    IGL_ASSERT_NOT_REACHED();
+    break;
+  }
+}
+
+void Replay::executeComputeCommand(Op op,
+                                   RecordReader& reader,
+                                   igl::IComputeCommandEncoder& encoder) {
+  switch (op) {
+  case Op::EndComputePass:
+    encoder.endEncoding();
+    break;
+  case Op::BindComputePipelineState: {
+    const auto pipeline = find(computePipelines_, reader.read<uint32_t>());
+    if (pipeline) {
+      encoder.bindComputePipelineState(pipeline);
+    }
+    break;
+  }
+  case Op::ComputeBindTexture: {
+    const size_t index = reader.readSize();
+    const auto texture = find(textures_, reader.read<uint32_t>());
+    if (!reader.failed()) {
+      encoder.bindTexture(index, texture.get());
+    }
+    break;
+  }
+  case Op::ComputeBindBuffer: {
+    const size_t index = reader.readSize();
+    const auto buffer = find(buffers_, reader.read<uint32_t>());
+    const size_t offset = reader.readSize();
+    if (!reader.failed() && buffer) {
+      encoder.bindBuffer(index, buffer, offset);
+    }
+    break;
+  }
+  case Op::ComputeBindBytes: {
+    const size_t index = reader.readSize();
+    size_t length = 0;
+    const uint8_t* data = reader.readBlob(length);
+    if (!reader.failed()) {
+      encoder.bindBytes(index, data, length);
+    }
+    break;
+  }
+  case Op::ComputeBindPushConstants: {
+    const size_t offset = reader.readSize();
+    size_t length = 0;
+    const uint8_t* data = reader.readBlob(length);
+    if (!reader.failed()) {
+      encoder.bindPushConstants(data, length, offset);
+    }
+    break;
+  }
+  case Op::ComputeBindBufferAddress: {
+    const size_t offset = reader.readSize();
+    const auto buffer = find(buffers_, reader.read<uint32_t>());
+    const size_t bufferOffset = reader.readSize();
+    if (!reader.failed() && buffer) {
+      encoder.bindBufferAddress(offset, *buffer, bufferOffset);
+    }
+    break;
+  }
+  case Op::ComputeBindUniform: {
+    const igl::UniformDesc desc = readUniformDesc(reader);
+    size_t length = 0;
+    const uint8_t* data = reader.readBlob(length);
+    if (!reader.failed() && length == getUniformDataSize(desc)) {
+      encoder.bindUniform(desc, data);
+    }
+    break;
+  }
+  case Op::DispatchThreadGroups: {
+    const igl::Dimensions threadgroupCount = readDimensions(reader);
+    const igl::Dimensions threadgroupSize = readDimensions(reader);
+    if (!reader.failed()) {
+      encoder.dispatchThreadGroups(threadgroupCount, threadgroupSize);
+      stats_.dispatches++;
+    }
+    break;
+  }
+  case Op::DispatchThreadGroupsIndirect: {
+    const auto indirectBuffer = find(buffers_, reader.read<uint32_t>());
+    const size_t indirectBufferOffset = reader.readSize();
+    const igl::Dimensions threadgroupSize = readDimensions(reader);
+    if (!reader.failed() && indirectBuffer) {
+      encoder.dispatchThreadGroupsIndirect(*indirectBuffer, indirectBufferOffset, threadgroupSize);
+      stats_.dispatches++;
+    }
+    break;
+  }
+  default:
+    IGL_ASSERT_NOT_REACHED();
+    break;
+  }
+}
+
+} // namespace
+
+double ReplayStats::getAverageIterationSeconds() const {
+  if (totalSeconds.empty()) {
+    return 0.0;
+  }
+  const auto begin = totalSeconds.size() > 1 ? totalSeconds.begin() + 1 : totalSeconds.begin();
+  return std::accumulate(begin, totalSeconds.end(), 0.0) /
+         static_cast<double>(totalSeconds.end() - begin);
+}
+
+CaptureReplayer::CaptureReplayer(igl::IDevice& device) : device_(device) {}
+
+bool CaptureReplayer::replay(const CaptureStream& stream,
+                             const ReplayOptions& options,
+                             ReplayStats& outStats,
+                             igl::Result* outResult) {
+  outStats = {};
+  igl::Result result;
+  const std::vector<Record> records = stream.parse(&result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return false;
+  }
+
+  auto commandQueue = device_.createCommandQueue({igl::CommandQueueType::Graphics}, &result);
+  if (!commandQueue) {
+    igl::Result::setResult(outResult, std::move(result));
+    return false;
+  }
+
+  Replay replay(device_, std::move(commandQueue), outStats);
+  for (uint32_t iteration = 0; iteration != options.iterations; iteration++) {
+    const auto start = Clock::now();
+    for (const Record& record : records) {
+      const bool skip = iteration != 0 && (isCreateOp(record.op) ||
+                                           (options.skipUploads && isUploadOp(record.op)));
+      if (skip) {
+        continue;
+      }
+      const auto recordStart = Clock::now();
+      if (!replay.execute(record)) {
+        replay.finishIteration();
+        igl::Result::setResult(
+            outResult, igl::Result::Code::ArgumentInvalid, "Capture has a malformed record");
+        return false;
+      }
+      if (iteration == 0 && isCreateOp(record.op)) {
+        outStats.setupSeconds += secondsSince(recordStart);
+      }
+    }
+    outStats.cpuSeconds.push_back(secondsSince(start));
+    replay.finishIteration();
+    outStats.totalSeconds.push_back(secondsSince(start));
+    outStats.iterations++;
+  }
+
+  igl::Result::setOk(outResult);
+  return true;
+}
+
+} // namespace capture
+} // namespace iglu
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/command_capture/CaptureStream.h>
+#include <igl/Device.h>
+#include <vector>
+
+namespace iglu {
+namespace capture {
+
+struct ReplayOptions {
+  /// Number of times the stream is played back. Resources are created by the first iteration
+  /// only; later iterations reuse them.
+  uint32_t iterations = 1;
+  /// Skip buffer and texture uploads after the first iteration, so that the timings of the later
+  /// iterations only cover the commands
+  bool skipUploads = false;
+};
+
+struct ReplayStats {
+  uint32_t iterations = 0;
+  /// Totals over all iterations
+  uint32_t frames = 0;
+  uint32_t submits = 0;
+  uint32_t draws = 0;
+  uint32_t dispatches = 0;
+  /// Time the first iteration spent creating resources
+  double setupSeconds = 0.0;
+  /// Time spent encoding and submitting the commands of each iteration
+  std::vector<double> cpuSeconds;
+  /// Time each iteration took until the GPU completed its last command buffer
+  std::vector<double> totalSeconds;
+
+  /// Average of `totalSeconds`, excluding the first iteration when there are several
+  [[nodiscard]] double getAverageIterationSeconds() const;
+};
+
+/**
+ * @brief Plays a CaptureStream back on a device, which does not have to be of the backend the
+ * stream was captured on as long as it accepts the captured shaders.
+ *
+ * Textures recorded as external (e.g. swapchain images) are replaced by offscreen textures and
+ * presenting them is skipped. Each iteration waits for the GPU to complete its last command buffer
+ * before the next one starts.
+ */
+class CaptureReplayer final {
+ public:
+  explicit CaptureReplayer(igl::IDevice& device);
+
+  bool replay(const CaptureStream& stream,
+              const ReplayOptions& options,
+              ReplayStats& outStats,
+              igl::Result* IGL_NULLABLE outResult);
+
+ private:
+  igl::IDevice& device_;
+};
+
+} // namespace capture
+} // namespace iglu
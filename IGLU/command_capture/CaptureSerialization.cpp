@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/command_capture/CaptureSerialization.h>
+
+#include <algorithm>
+
+namespace iglu {
+namespace capture {
+
+namespace {
+
+void writeNameHandle(RecordWriter& writer, const igl::NameHandle& name) {
+  writer.writeString(name.toString());
+}
+
+igl::NameHandle readNameHandle(RecordReader& reader) {
+  return igl::genNameHandle(reader.readString());
+}
+
+void writeSamplerMap(RecordWriter& writer,
+                     const std::unordered_map<size_t, igl::NameHandle>& samplerMap) {
+  writer.writeSize(samplerMap.size());
+  for (const auto& [unit, name] : samplerMap) {
+    writer.writeSize(unit);
+    writeNameHandle(writer, name);
+  }
+}
+
+std::unordered_map<size_t, igl::NameHandle> readSamplerMap(RecordReader& reader) {
+  std::unordered_map<size_t, igl::NameHandle> samplerMap;
+  const size_t size = reader.readSize();
+  for (size_t i = 0; i != size && !reader.failed(); i++) {
+    const size_t unit = reader.readSize();
+    samplerMap[unit] = readNameHandle(reader);
+  }
+  return samplerMap;
+}
+
+void writeStencilStateDesc(RecordWriter& writer, const igl::StencilStateDesc& desc) {
+  writer.write(desc.stencilFailureOperation);
+  writer.write(desc.depthFailureOperation);
+  writer.write(desc.depthStencilPassOperation);
+  writer.write(desc.stencilCompareFunction);
+  writer.write(desc.readMask);
+  writer.write(desc.writeMask);
+}
+
+igl::StencilStateDesc readStencilStateDesc(RecordReader& reader) {
+  igl::StencilStateDesc desc;
+  desc.stencilFailureOperation = reader.read<igl::StencilOperation>();
+  desc.depthFailureOperation = reader.read<igl::StencilOperation>();
+  desc.depthStencilPassOperation = reader.read<igl::StencilOperation>();
+  desc.stencilCompareFunction = reader.read<igl::CompareFunction>();
+  desc.readMask = reader.read<uint32_t>();
+  desc.writeMask = reader.read<uint32_t>();
+  return desc;
+}
+
+template<typename T>
+void writeAttachmentDesc(RecordWriter& writer, const T& desc) {
+  writer.write(desc.loadAction);
+  writer.write(desc.storeAction);
+  writer.write(desc.face);
+  writer.write(desc.mipLevel);
+  writer.write(desc.layer);
+}
+
+template<typename T>
+void readAttachmentDesc(RecordReader& reader, T& outDesc) {
+  outDesc.loadAction = reader.read<igl::LoadAction>();
+  outDesc.storeAction = reader.read<igl::StoreAction>();
+  outDesc.face = reader.read<uint8_t>();
+  outDesc.mipLevel = reader.read<uint8_t>();
+  outDesc.layer = reader.read<uint8_t>();
+}
+
+} // namespace
+
+void writeTextureDesc(RecordWriter& writer, const igl::TextureDesc& desc) {
+  writer.writeSize(desc.width);
+  writer.writeSize(desc.height);
+  writer.writeSize(desc.depth);
+  writer.writeSize(desc.numLayers);
+  writer.write(desc.numSamples);
+  writer.write(desc.usage);
+  writer.write(desc.numMipLevels);
+  writer.write(desc.type);
+  writer.write(desc.format);
+  writer.write(desc.storage);
+  writer.writeString(desc.debugName);
+}
+
+igl::TextureDesc readTextureDesc(RecordReader& reader) {
+  igl::TextureDesc desc;
+  desc.width = reader.readSize();
+  desc.height = reader.readSize();
+  desc.depth = reader.readSize();
+  desc.numLayers = reader.readSize();
+  desc.numSamples = reader.read<uint32_t>();
+  desc.usage = reader.read<igl::TextureDesc::TextureUsage>();
+  desc.numMipLevels = reader.read<uint32_t>();
+  desc.type = reader.read<igl::TextureType>();
+  desc.format = reader.read<igl::TextureFormat>();
+  desc.storage = reader.read<igl::ResourceStorage>();
+  desc.debugName = reader.readString();
+  return desc;
+}
+
+void writeTextureRangeDesc(RecordWriter& writer, const igl::TextureRangeDesc& range) {
+  writer.writeSize(range.x);
+  writer.writeSize(range.y);
+  writer.writeSize(range.z);
+  writer.writeSize(range.width);
+  writer.writeSize(range.height);
+  writer.writeSize(range.depth);
+  writer.writeSize(range.layer);
+  writer.writeSize(range.numLayers);
+  writer.writeSize(range.mipLevel);
+  writer.writeSize(range.numMipLevels);
+}
+
+igl::TextureRangeDesc readTextureRangeDesc(RecordReader& reader) {
+  igl::TextureRangeDesc range;
+  range.x = reader.readSize();
+  range.y = reader.readSize();
+  range.z = reader.readSize();
+  range.width = reader.readSize();
+  range.height = reader.readSize();
+  range.depth = reader.readSize();
+  range.layer = reader.readSize();
+  range.numLayers = reader.readSize();
+  range.mipLevel = reader.readSize();
+  range.numMipLevels = reader.readSize();
+  return range;
+}
+
+void writeSamplerStateDesc(RecordWriter& writer, const igl::SamplerStateDesc& desc) {
+  writer.write(desc.minFilter);
+  writer.write(desc.magFilter);
+  writer.write(desc.mipFilter);
+  writer.write(desc.addressModeU);
+  writer.write(desc.addressModeV);
+  writer.write(desc.addressModeW);
+  writer.write(desc.depthCompareFunction);
+  writer.write(desc.mipLodMin);
+  writer.write(desc.mipLodMax);
+  writer.write(desc.maxAnisotropic);
+  writer.write(desc.depthCompareEnabled);
+  writer.writeString(desc.debugName);
+}
+
+igl::SamplerStateDesc readSamplerStateDesc(RecordReader& reader) {
+  igl::SamplerStateDesc desc;
+  desc.minFilter = reader.read<igl::SamplerMinMagFilter>();
+  desc.magFilter = reader.read<igl::SamplerMinMagFilter>();
+  desc.mipFilter = reader.read<igl::SamplerMipFilter>();
+  desc.addressModeU = reader.read<igl::SamplerAddressMode>();
+  desc.addressModeV = reader.read<igl::SamplerAddressMode>();
+  desc.addressModeW = reader.read<igl::SamplerAddressMode>();
+  desc.depthCompareFunction = reader.read<igl::CompareFunction>();
+  desc.mipLodMin = reader.read<uint8_t>();
+  desc.mipLodMax = reader.read<uint8_t>();
+  desc.maxAnisotropic = reader.read<uint8_t>();
+  desc.depthCompareEnabled = reader.read<bool>();
+  desc.debugName = reader.readString();
+  return desc;
+}
+
+void writeDepthStencilStateDesc(RecordWriter& writer, const igl::DepthStencilStateDesc& desc) {
+  writer.write(desc.compareFunction);
+  writer.write(desc.isDepthWriteEnabled);
+  writeStencilStateDesc(writer, desc.backFaceStencil);
+  writeStencilStateDesc(writer, desc.frontFaceStencil);
+}
+
+igl::DepthStencilStateDesc readDepthStencilStateDesc(RecordReader& reader) {
+  igl::DepthStencilStateDesc desc;
+  desc.compareFunction = reader.read<igl::CompareFunction>();
+  desc.isDepthWriteEnabled = reader.read<bool>();
+  desc.backFaceStencil = readStencilStateDesc(reader);
+  desc.frontFaceStencil = readStencilStateDesc(reader);
+  return desc;
+}
+
+void writeVertexInputStateDesc(RecordWriter& writer, const igl::VertexInputStateDesc& desc) {
+  writer.writeSize(desc.numAttributes);
+  for (size_t i = 0; i != desc.numAttributes; i++) {
+    const igl::VertexAttribute& attribute = desc.attributes[i];
+    writer.writeSize(attribute.bufferIndex);
+    writer.write(attribute.format);
+    writer.writeSize(attribute.offset);
+    writer.writeString(attribute.name);
+    writer.write(static_cast<int32_t>(attribute.location));
+  }
+  writer.writeSize(desc.numInputBindings);
+  for (size_t i = 0; i != desc.numInputBindings; i++) {
+    const igl::VertexInputBinding& binding = desc.inputBindings[i];
+    writer.writeSize(binding.stride);
+    writer.write(binding.sampleFunction);
+    writer.writeSize(binding.sampleRate);
+  }
+}
+
+igl::VertexInputStateDesc readVertexInputStateDesc(RecordReader& reader) {
+  igl::VertexInputStateDesc desc;
+  desc.numAttributes = std::min(reader.readSize(), size_t(igl::IGL_VERTEX_ATTRIBUTES_MAX));
+  for (size_t i = 0; i != desc.numAttributes; i++) {
+    igl::VertexAttribute& attribute = desc.attributes[i];
+    attribute.bufferIndex = reader.readSize();
+    attribute.format = reader.read<igl::VertexAttributeFormat>();
+    attribute.offset = reader.readSize();
+    attribute.name = reader.readString();
+    attribute.location = reader.read<int32_t>();
+  }
+  desc.numInputBindings = std::min(reader.readSize(), size_t(igl::IGL_VERTEX_BUFFER_MAX));
+  for (size_t i = 0; i != desc.numInputBindings; i++) {
+    igl::VertexInputBinding& binding = desc.inputBindings[i];
+    binding.stride = reader.readSize();
+    binding.sampleFunction = reader.read<igl::VertexSampleFunction>();
+    binding.sampleRate = reader.readSize();
+  }
+  return desc;
+}
+
+void writeShaderModuleInfo(RecordWriter& writer, const igl::ShaderModuleInfo& info) {
+  writer.write(info.stage);
+  writer.writeString(info.entryPoint);
+}
+
+igl::ShaderModuleInfo readShaderModuleInfo(RecordReader& reader) {
+  igl::ShaderModuleInfo info;
+  info.stage = reader.read<igl::ShaderStage>();
+  info.entryPoint = reader.readString();
+  return info;
+}
+
+void writeShaderInput(RecordWriter& writer, const igl::ShaderInput& input) {
+  writer.write(input.type);
+  writer.write(input.options.fastMathEnabled);
+  if (input.type == igl::ShaderInputType::String) {
+    writer.writeBlob(input.source, input.source ? strlen(input.source) + 1 : 0);
+  } else {
+    writer.writeBlob(input.data, input.length);
+  }
+}
+
+igl::ShaderInput readShaderInput(RecordReader& reader) {
+  igl::ShaderInput input;
+  input.type = reader.read<igl::ShaderInputType>();
+  input.options.fastMathEnabled = reader.read<bool>();
+  size_t length = 0;
+  const uint8_t* data = reader.readBlob(length);
+  if (input.type == igl::ShaderInputType::String) {
+    // the terminator is part of the blob
+    input.source = length && data[length - 1] == 0 ? reinterpret_cast<const char*>(data) : nullptr;
+  } else {
+    input.data = data;
+    input.length = length;
+  }
+  return input;
+}
+
+void writeRenderPipelineDesc(RecordWriter& writer, const igl::RenderPipelineDesc& desc) {
+  const auto& targetDesc = desc.targetDesc;
+  writer.writeSize(targetDesc.colorAttachments.size());
+  for (const auto& attachment : targetDesc.colorAttachments) {
+    writer.write(attachment.textureFormat);
+    writer.write(attachment.colorWriteBits);
+    writer.write(attachment.blendEnabled);
+    writer.write(attachment.rgbBlendOp);
+    writer.write(attachment.alphaBlendOp);
+    writer.write(attachment.srcRGBBlendFactor);
+    writer.write(attachment.srcAlphaBlendFactor);
+    writer.write(attachment.dstRGBBlendFactor);
+    writer.write(attachment.dstAlphaBlendFactor);
+  }
+  writer.write(targetDesc.depthAttachmentFormat);
+  writer.write(targetDesc.stencilAttachmentFormat);
+  writer.write(desc.cullMode);
+  writer.write(desc.frontFaceWinding);
+  writer.write(desc.polygonFillMode);
+  writeSamplerMap(writer, desc.vertexUnitSamplerMap);
+  writeSamplerMap(writer, desc.fragmentUnitSamplerMap);
+  writer.writeSize(desc.uniformBlockBindingMap.size());
+  for (const auto& [bindingIndex, names] : desc.uniformBlockBindingMap) {
+    writer.writeSize(bindingIndex);
+    writeNameHandle(writer, names.first);
+    writeNameHandle(writer, names.second);
+  }
+  writer.write(static_cast<int32_t>(desc.sampleCount));
+  writer.write(desc.supportIndirectCommandBuffers);
+  writeNameHandle(writer, desc.debugName);
+}
+
+void readRenderPipelineDesc(RecordReader& reader, igl::RenderPipelineDesc& outDesc) {
+  auto& targetDesc = outDesc.targetDesc;
+  const size_t numColorAttachments = reader.readSize();
+  for (size_t i = 0; i != numColorAttachments && !reader.failed(); i++) {
+    igl::RenderPipelineDesc::TargetDesc::ColorAttachment attachment;
+    attachment.textureFormat = reader.read<igl::TextureFormat>();
+    attachment.colorWriteBits = reader.read<igl::ColorWriteBits>();
+    attachment.blendEnabled = reader.read<bool>();
+    attachment.rgbBlendOp = reader.read<igl::BlendOp>();
+    attachment.alphaBlendOp = reader.read<igl::BlendOp>();
+    attachment.srcRGBBlendFactor = reader.read<igl::BlendFactor>();
+    attachment.srcAlphaBlendFactor = reader.read<igl::BlendFactor>();
+    attachment.dstRGBBlendFactor = reader.read<igl::BlendFactor>();
+    attachment.dstAlphaBlendFactor = reader.read<igl::BlendFactor>();
+    targetDesc.colorAttachments.push_back(attachment);
+  }
+  targetDesc.depthAttachmentFormat = reader.read<igl::TextureFormat>();
+  targetDesc.stencilAttachmentFormat = reader.read<igl::TextureFormat>();
+  outDesc.cullMode = reader.read<igl::CullMode>();
+  outDesc.frontFaceWinding = reader.read<igl::WindingMode>();
+  outDesc.polygonFillMode = reader.read<igl::PolygonFillMode>();
+  outDesc.vertexUnitSamplerMap = readSamplerMap(reader);
+  outDesc.fragmentUnitSamplerMap = readSamplerMap(reader);
+  const size_t numUniformBlocks = reader.readSize();
+  for (size_t i = 0; i != numUniformBlocks && !reader.failed(); i++) {
+    const size_t bindingIndex = reader.readSize();
+    igl::NameHandle blockName = readNameHandle(reader);
+    igl::NameHandle instanceName = readNameHandle(reader);
+    outDesc.uniformBlockBindingMap[bindingIndex] = {std::move(blockName), std::move(instanceName)};
+  }
+  outDesc.sampleCount = reader.read<int32_t>();
+  outDesc.supportIndirectCommandBuffers = reader.read<bool>();
+  outDesc.debugName = readNameHandle(reader);
+}
+
+void writeComputePipelineDesc(RecordWriter& writer, const igl::ComputePipelineDesc& desc) {
+  writeSamplerMap(writer, desc.imagesMap);
+  writeSamplerMap(writer, desc.buffersMap);
+  writer.writeString(desc.debugName);
+}
+
+void readComputePipelineDesc(RecordReader& reader, igl::ComputePipelineDesc& outDesc) {
+  outDesc.imagesMap = readSamplerMap(reader);
+  outDesc.buffersMap = readSamplerMap(reader);
+  outDesc.debugName = reader.readString();
+}
+
+void writeRenderPassDesc(RecordWriter& writer, const igl::RenderPassDesc& desc) {
+  writer.writeSize(desc.colorAttachments.size());
+  for (const auto& attachment : desc.colorAttachments) {
+    writeAttachmentDesc(writer, attachment);
+    writer.writeBytes(attachment.clearColor.toFloatPtr(), 4 * sizeof(float));
+  }
+  writeAttachmentDesc(writer, desc.depthAttachment);
+  writer.write(desc.depthAttachment.depthResolveFilter);
+  writer.write(desc.depthAttachment.clearDepth);
+  writeAttachmentDesc(writer, desc.stencilAttachment);
+  writer.write(desc.stencilAttachment.clearStencil);
+}
+
+igl::RenderPassDesc readRenderPassDesc(RecordReader& reader) {
+  igl::RenderPassDesc desc;
+  const size_t numColorAttachments = reader.readSize();
+  for (size_t i = 0; i != numColorAttachments && !reader.failed(); i++) {
+    igl::RenderPassDesc::ColorAttachmentDesc attachment;
+    readAttachmentDesc(reader, attachment);
+    const float r = reader.read<float>();
+    const float g = reader.read<float>();
+    const float b = reader.read<float>();
+    const float a = reader.read<float>();
+    attachment.clearColor = igl::Color(r, g, b, a);
+    desc.colorAttachments.push_back(attachment);
+  }
+  readAttachmentDesc(reader, desc.depthAttachment);
+  desc.depthAttachment.depthResolveFilter = reader.read<igl::MsaaDepthResolveFilter>();
+  desc.depthAttachment.clearDepth = reader.read<float>();
+  readAttachmentDesc(reader, desc.stencilAttachment);
+  desc.stencilAttachment.clearStencil = reader.read<uint32_t>();
+  return desc;
+}
+
+void writeUniformDesc(RecordWriter& writer, const igl::UniformDesc& desc) {
+  writer.writeString(desc.name);
+  writer.write(static_cast<int32_t>(desc.location));
+  writer.write(desc.type);
+  writer.writeSize(desc.numElements);
+  writer.writeSize(desc.elementStride);
+}
+
+igl::UniformDesc readUniformDesc(RecordReader& reader) {
+  igl::UniformDesc desc;
+  desc.name = reader.readString();
+  desc.location = reader.read<int32_t>();
+  desc.type = reader.read<igl::UniformType>();
+  desc.numElements = reader.readSize();
+  desc.elementStride = reader.readSize();
+  return desc;
+}
+
+void writeDimensions(RecordWriter& writer, const igl::Dimensions& dimensions) {
+  writer.writeSize(dimensions.width);
+  writer.writeSize(dimensions.height);
+  writer.writeSize(dimensions.depth);
+}
+
+igl::Dimensions readDimensions(RecordReader& reader) {
+  const size_t width = reader.readSize();
+  const size_t height = reader.readSize();
+  const size_t depth = reader.readSize();
+  return {width, height, depth};
+}
+
+size_t getUniformDataSize(const igl::UniformDesc& desc) {
+  const size_t stride =
+      desc.elementStride != 0 ? desc.elementStride : igl::sizeForUniformType(desc.type);
+  return stride * desc.numElements;
+}
+
+} // namespace capture
+} // namespace iglu
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/command_capture/CaptureStream.h>
+#include <igl/IGL.h>
+
+// Serialization of the IGL descriptors shared by CaptureDevice and CaptureReplayer. Members that
+// reference other objects (shader stages, vertex input states, textures...) are not part of the
+// payloads below; the records store their ids next to them.
+
+namespace iglu {
+namespace capture {
+
+void writeTextureDesc(RecordWriter& writer, const igl::TextureDesc& desc);
+igl::TextureDesc readTextureDesc(RecordReader& reader);
+
+void writeTextureRangeDesc(RecordWriter& writer, const igl::TextureRangeDesc& range);
+igl::TextureRangeDesc readTextureRangeDesc(RecordReader& reader);
+
+void writeSamplerStateDesc(RecordWriter& writer, const igl::SamplerStateDesc& desc);
+igl::SamplerStateDesc readSamplerStateDesc(RecordReader& reader);
+
+void writeDepthStencilStateDesc(RecordWriter& writer, const igl::DepthStencilStateDesc& desc);
+igl::DepthStencilStateDesc readDepthStencilStateDesc(RecordReader& reader);
+
+void writeVertexInputStateDesc(RecordWriter& writer, const igl::VertexInputStateDesc& desc);
+igl::VertexInputStateDesc readVertexInputStateDesc(RecordReader& reader);
+
+void writeShaderModuleInfo(RecordWriter& writer, const igl::ShaderModuleInfo& info);
+igl::ShaderModuleInfo readShaderModuleInfo(RecordReader& reader);
+
+/// String sources are stored with their terminator, so the ShaderInput returned by
+/// readShaderInput() points straight into the payload, which has to outlive it.
+void writeShaderInput(RecordWriter& writer, const igl::ShaderInput& input);
+igl::ShaderInput readShaderInput(RecordReader& reader);
+
+/// Everything but `vertexInputState` and `shaderStages`
+void writeRenderPipelineDesc(RecordWriter& writer, const igl::RenderPipelineDesc& desc);
+void readRenderPipelineDesc(RecordReader& reader, igl::RenderPipelineDesc& outDesc);
+
+/// Everything but `shaderStages`
+void writeComputePipelineDesc(RecordWriter& writer, const igl::ComputePipelineDesc& desc);
+void readComputePipelineDesc(RecordReader& reader, igl::ComputePipelineDesc& outDesc);
+
+/// Everything but `occlusionQueryPool`
+void writeRenderPassDesc(RecordWriter& writer, const igl::RenderPassDesc& desc);
+igl::RenderPassDesc readRenderPassDesc(RecordReader& reader);
+
+/// Everything but `offset`: records store the uniform data starting at the offset
+void writeUniformDesc(RecordWriter& writer, const igl::UniformDesc& desc);
+igl::UniformDesc readUniformDesc(RecordReader& reader);
+
+void writeDimensions(RecordWriter& writer, const igl::Dimensions& dimensions);
+igl::Dimensions readDimensions(RecordReader& reader);
+
+/// Number of bytes read by bindUniform() from `data + desc.offset`
+size_t getUniformDataSize(const igl::UniformDesc& desc);
+
+} // namespace capture
+} // namespace iglu
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/command_capture/CaptureStream.h>
+
+#include <cstdio>
+
+namespace iglu {
+namespace capture {
+
+namespace {
+
+struct StreamHeader {
+  uint32_t magic;
+  uint32_t version;
+};
+
+struct RecordHeader {
+  uint16_t op;
+  uint16_t reserved;
+  uint32_t size;
+};
+
+static_assert(sizeof(StreamHeader) == 8, "StreamHeader is part of the stream format");
+static_assert(sizeof(RecordHeader) == 8, "RecordHeader is part of the stream format");
+
+} // namespace
+
+CaptureStream::CaptureStream() {
+  const StreamHeader header = {kMagic, kVersion};
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&header);
+  data_.assign(bytes, bytes + sizeof(header));
+}
+
+CaptureStream::CaptureStream(std::vector<uint8_t> data) : data_(std::move(data)) {}
+
+void CaptureStream::append(Op op, const RecordWriter& record) {
+  const std::vector<uint8_t>& payload = record.data();
+  IGL_ASSERT(payload.size() <= UINT32_MAX);
+
+  const RecordHeader header = {static_cast<uint16_t>(op), 0, static_cast<uint32_t>(payload.size())};
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&header);
+  data_.insert(data_.end(), bytes, bytes + sizeof(header));
+  data_.insert(data_.end(), payload.begin(), payload.end());
+}
+
+std::vector<Record> CaptureStream::parse(igl::Result* outResult) const {
+  StreamHeader header = {};
+  if (data_.size() < sizeof(header)) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Capture is truncated");
+    return {};
+  }
+  std::memcpy(&header, data_.data(), sizeof(header));
+  if (header.magic != kMagic || header.version != kVersion) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::Unsupported, "Not a capture or unsupported capture version");
+    return {};
+  }
+
+  std::vector<Record> records;
+  size_t offset = sizeof(header);
+  while (offset != data_.size()) {
+    RecordHeader recordHeader = {};
+    if (data_.size() - offset < sizeof(recordHeader)) {
+      igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Capture is truncated");
+      return {};
+    }
+    std::memcpy(&recordHeader, data_.data() + offset, sizeof(recordHeader));
+    offset += sizeof(recordHeader);
+    if (recordHeader.op >= static_cast<uint16_t>(Op::NumOps) ||
+        data_.size() - offset < recordHeader.size) {
+      igl::Result::setResult(
+          outResult, igl::Result::Code::ArgumentInvalid, "Capture has a malformed record");
+      return {};
+    }
+    records.push_back({static_cast<Op>(recordHeader.op), data_.data() + offset, recordHeader.size});
+    offset += recordHeader.size;
+  }
+
+  igl::Result::setOk(outResult);
+  return records;
+}
+
+bool CaptureStream::save(const std::string& path, igl::Result* outResult) const {
+  FILE* file = fopen(path.c_str(), "wb");
+  if (!file) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot create " + path);
+    return false;
+  }
+  bool success = fwrite(data_.data(), 1, data_.size(), file) == data_.size();
+  success = fclose(file) == 0 && success;
+  if (!success) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot write " + path);
+    return false;
+  }
+  igl::Result::setOk(outResult);
+  return true;
+}
+
+bool CaptureStream::load(const std::string& path,
+                         CaptureStream& outStream,
+                         igl::Result* outResult) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot open " + path);
+    return false;
+  }
+  std::vector<uint8_t> data;
+  uint8_t chunk[64 * 1024];
+  size_t numRead = 0;
+  while ((numRead = fread(chunk, 1, sizeof(chunk), file)) != 0) {
+    data.insert(data.end(), chunk, chunk + numRead);
+  }
+  const bool success = ferror(file) == 0;
+  fclose(file);
+  if (!success) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot read " + path);
+    return false;
+  }
+  outStream = CaptureStream(std::move(data));
+  igl::Result::setOk(outResult);
+  return true;
+}
+
+} // namespace capture
+} // namespace iglu
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <igl/Common.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace iglu {
+namespace capture {
+
+/// Kinds of records of a capture stream. Resources and commands refer to resources by the ids
+/// assigned to them by their Create* record; id 0 stands for null.
+enum class Op : uint16_t {
+  // Resources
+  CreateBuffer,
+  UploadBuffer,
+  CreateTexture,
+  CreateExternalTexture, // a texture IGL did not create, e.g. a swapchain image
+  UploadTexture,
+  CreateSamplerState,
+  CreateDepthStencilState,
+  CreateVertexInputState,
+  CreateShaderModule,
+  CreateShaderLibrary,
+  CreateShaderStages,
+  CreateRenderPipeline,
+  CreateComputePipeline,
+
+  // Command buffers
+  BeginCommandBuffer,
+  Present,
+  Submit,
+  GenerateMipmap,
+
+  // Render passes
+  BeginRenderPass,
+  EndRenderPass,
+  BindViewport,
+  BindScissorRect,
+  BindRenderPipelineState,
+  BindDepthStencilState,
+  BindBuffer,
+  BindBytes,
+  BindPushConstants,
+  BindBufferAddress,
+  BindSamplerState,
+  BindTexture,
+  BindUniform,
+  Draw,
+  DrawIndexed,
+  DrawIndexedIndirect,
+  MultiDrawIndirect,
+  MultiDrawIndexedIndirect,
+  SetStencilReferenceValues,
+  SetBlendColor,
+  SetDepthBias,
+
+  // Compute passes
+  BeginComputePass,
+  EndComputePass,
+  BindComputePipelineState,
+  ComputeBindTexture,
+  ComputeBindBuffer,
+  ComputeBindBytes,
+  ComputeBindPushConstants,
+  ComputeBindBufferAddress,
+  ComputeBindUniform,
+  DispatchThreadGroups,
+  DispatchThreadGroupsIndirect,
+
+  NumOps,
+};
+
+/// Serializes the payload of one record. Values are stored in host byte order.
+class RecordWriter final {
+ public:
+  template<typename T>
+  void write(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Use writeBytes() or writeString()");
+    writeBytes(&value, sizeof(T));
+  }
+  void writeSize(size_t value) {
+    write(static_cast<uint64_t>(value));
+  }
+  void writeBytes(const void* IGL_NULLABLE data, size_t length) {
+    if (length) {
+      const auto* bytes = static_cast<const uint8_t*>(data);
+      data_.insert(data_.end(), bytes, bytes + length);
+    }
+  }
+  /// Writes the length of `data`, then `data`
+  void writeBlob(const void* IGL_NULLABLE data, size_t length) {
+    writeSize(length);
+    writeBytes(data, length);
+  }
+  void writeString(const std::string& str) {
+    writeBlob(str.data(), str.size());
+  }
+
+  [[nodiscard]] const std::vector<uint8_t>& data() const {
+    return data_;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+/// Deserializes the payload of one record. Reading past the end of the payload zero-fills the
+/// values and marks the reader as failed.
+class RecordReader final {
+ public:
+  RecordReader(const uint8_t* IGL_NULLABLE data, size_t size) : data_(data), size_(size) {}
+
+  template<typename T>
+  T read() {
+    static_assert(std::is_trivially_copyable<T>::value, "Use readBlob() or readString()");
+    T value{};
+    if (const uint8_t* bytes = readBytes(sizeof(T))) {
+      std::memcpy(&value, bytes, sizeof(T));
+    }
+    return value;
+  }
+  size_t readSize() {
+    return static_cast<size_t>(read<uint64_t>());
+  }
+  /// Returns a pointer to the next `length` bytes of the payload, or null if there are fewer
+  const uint8_t* IGL_NULLABLE readBytes(size_t length) {
+    if (failed_ || length > size_ - pos_) {
+      failed_ = true;
+      return nullptr;
+    }
+    const uint8_t* bytes = data_ + pos_;
+    pos_ += length;
+    return bytes;
+  }
+  /// Reads a blob written by RecordWriter::writeBlob(); `outLength` receives its length
+  const uint8_t* IGL_NULLABLE readBlob(size_t& outLength) {
+    outLength = readSize();
+    const uint8_t* bytes = readBytes(outLength);
+    if (!bytes) {
+      outLength = 0;
+    }
+    return bytes;
+  }
+  std::string readString() {
+    size_t length = 0;
+    const uint8_t* bytes = readBlob(length);
+    return bytes ? std::string(reinterpret_cast<const char*>(bytes), length) : std::string();
+  }
+
+  [[nodiscard]] bool failed() const {
+    return failed_;
+  }
+
+ private:
+  const uint8_t* IGL_NULLABLE data_;
+  size_t size_;
+  size_t pos_ = 0;
+  bool failed_ = false;
+};
+
+/// One record of a CaptureStream; `data` points into the stream
+struct Record {
+  Op op = Op::NumOps;
+  const uint8_t* IGL_NULLABLE data = nullptr;
+  uint32_t size = 0;
+};
+
+/**
+ * @brief A binary stream of IGL calls and the resource payloads they reference, as recorded by a
+ * CaptureDevice and played back by a CaptureReplayer.
+ *
+ * The stream starts with a header (magic, version) followed by records laid out as
+ * [Op : uint16][reserved : uint16][payload size : uint32][payload]. Values are stored in host byte
+ * order, so streams are portable between the backends and devices of one architecture.
+ */
+class CaptureStream final {
+ public:
+  static constexpr uint32_t kMagic = 0x43474749; // "IGGC"
+  static constexpr uint32_t kVersion = 4;
+
+  CaptureStream();
+  /// Adopts the bytes of a stream previously returned by data()
+  explicit CaptureStream(std::vector<uint8_t> data);
+
+  void append(Op op, const RecordWriter& record);
+
+  /// Splits the stream into records. Fails if the header or a record is malformed.
+  [[nodiscard]] std::vector<Record> parse(igl::Result* IGL_NULLABLE outResult) const;
+
+  [[nodiscard]] const std::vector<uint8_t>& data() const {
+    return data_;
+  }
+
+  bool save(const std::string& path, igl::Result* IGL_NULLABLE outResult) const;
+  static bool load(const std::string& path,
+                   CaptureStream& outStream,
+                   igl::Result* IGL_NULLABLE outResult);
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+} // namespace capture
+} // namespace iglu
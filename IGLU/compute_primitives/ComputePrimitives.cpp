@@ -0,0 +1,912 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "ComputePrimitives.h"
+
+#include <IGLU/glsl/StorageBuffers.h>
+#include <algorithm>
+#include <igl/ShaderCreator.h>
+#include <iterator>
+#include <string>
+
+namespace iglu {
+namespace computeprimitives {
+
+namespace {
+
+constexpr uint32_t kWorkgroupSize = 256;
+// 4-bit digits per radix sort pass
+constexpr uint32_t kRadixBits = 4;
+constexpr uint32_t kRadixSize = 1u << kRadixBits;
+constexpr uint32_t kMaxNumElements = 65535u * kWorkgroupSize;
+
+constexpr size_t kParamsIndex = 0;
+constexpr size_t kMaxNumBuffers = 5;
+
+// ScanMode bits of Params::mode
+constexpr uint32_t kScanInclusive = 1;
+// scans 1 for the non-zero elements and 0 for the others
+constexpr uint32_t kScanFlags = 2;
+
+uint32_t getNumBlocks(uint32_t numThreads) {
+  return (numThreads + kWorkgroupSize - 1) / kWorkgroupSize;
+}
+
+const char kGlslCommon[] = R"(
+#define WG_SIZE 256u
+#define RADIX_SIZE 16u
+#define SCAN_INCLUSIVE 1u
+#define SCAN_FLAGS 2u
+#define REDUCE_MIN 1u
+#define REDUCE_MAX 2u
+
+layout (local_size_x = 256) in;
+
+PARAMS Params {
+  uint numElements;
+  uint mode;
+  uint numBlocks;
+  uint outputIndex;
+  uint hasValues;
+  uint padding[3];
+} params;
+
+shared uint sharedData[WG_SIZE + 1u];
+
+void syncShared() {
+  memoryBarrierShared();
+  barrier();
+}
+
+// Returns the sum of the values of the invocations up to this one, and the sum of all of them
+// in `total`. Called by all the invocations of the workgroup.
+uint workgroupInclusiveAdd(uint value, out uint total) {
+  uint id = gl_LocalInvocationID.x;
+#if USE_SUBGROUPS
+  // the subgroups of a 1D workgroup are assumed to hold consecutive invocations
+  uint sum = subgroupInclusiveAdd(value);
+  uint subgroupSum = subgroupAdd(value);
+  if (subgroupElect()) {
+    sharedData[gl_SubgroupID] = subgroupSum;
+  }
+  syncShared();
+  if (id == 0u) {
+    uint running = 0u;
+    for (uint i = 0u; i < gl_NumSubgroups; i++) {
+      uint s = sharedData[i];
+      sharedData[i] = running;
+      running += s;
+    }
+    sharedData[WG_SIZE] = running;
+  }
+  syncShared();
+  sum += sharedData[gl_SubgroupID];
+  total = sharedData[WG_SIZE];
+#else
+  sharedData[id] = value;
+  syncShared();
+  for (uint offset = 1u; offset < WG_SIZE; offset <<= 1u) {
+    uint other = id >= offset ? sharedData[id - offset] : 0u;
+    syncShared();
+    sharedData[id] += other;
+    syncShared();
+  }
+  uint sum = sharedData[id];
+  total = sharedData[WG_SIZE - 1u];
+#endif
+  syncShared();
+  return sum;
+}
+
+uint combine(uint a, uint b) {
+  return params.mode == REDUCE_MIN ? min(a, b) : params.mode == REDUCE_MAX ? max(a, b) : a + b;
+}
+
+// Combines the values of all the invocations with the ReduceOp in params.mode. The result is only
+// valid in invocation 0.
+uint workgroupReduce(uint value) {
+  uint id = gl_LocalInvocationID.x;
+#if USE_SUBGROUPS
+  uint result = params.mode == REDUCE_MIN   ? subgroupMin(value)
+                : params.mode == REDUCE_MAX ? subgroupMax(value)
+                                            : subgroupAdd(value);
+  if (subgroupElect()) {
+    sharedData[gl_SubgroupID] = result;
+  }
+  syncShared();
+  if (id == 0u) {
+    for (uint i = 1u; i < gl_NumSubgroups; i++) {
+      result = combine(result, sharedData[i]);
+    }
+  }
+  return result;
+#else
+  sharedData[id] = value;
+  syncShared();
+  for (uint stride = WG_SIZE / 2u; stride > 0u; stride >>= 1u) {
+    if (id < stride) {
+      sharedData[id] = combine(sharedData[id], sharedData[id + stride]);
+    }
+    syncShared();
+  }
+  return sharedData[0];
+#endif
+}
+)";
+
+// The kernels, one GLSL module each. The storage buffers are bound at the same indices as the
+// buffers of the Metal kernels.
+const char kGlslScanBlocks[] = R"(
+BUFFER(1) readonly buffer Input {
+  uint inputData[];
+};
+BUFFER(2) buffer Output {
+  uint outputData[];
+};
+BUFFER(3) writeonly buffer BlockSums {
+  uint blockSums[];
+};
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  uint value = i < params.numElements ? inputData[i] : 0u;
+  if ((params.mode & SCAN_FLAGS) != 0u) {
+    value = value != 0u ? 1u : 0u;
+  }
+  uint total;
+  uint sum = workgroupInclusiveAdd(value, total);
+  if (i < params.numElements) {
+    outputData[i] = (params.mode & SCAN_INCLUSIVE) != 0u ? sum : sum - value;
+  }
+  if (gl_LocalInvocationID.x == 0u) {
+    blockSums[gl_WorkGroupID.x] = total;
+  }
+}
+)";
+
+const char kGlslAddBlockSums[] = R"(
+BUFFER(2) buffer Output {
+  uint outputData[];
+};
+BUFFER(3) readonly buffer BlockSums {
+  uint blockSums[];
+};
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  if (i < params.numElements) {
+    outputData[i] += blockSums[gl_WorkGroupID.x];
+  }
+}
+)";
+
+// `offsets` is the inclusive scan of the flags: the flag of an element is the difference with the
+// offset of the previous one
+const char kGlslScatterCompacted[] = R"(
+BUFFER(1) readonly buffer Input {
+  uint inputData[];
+};
+BUFFER(2) writeonly buffer Output {
+  uint outputData[];
+};
+BUFFER(3) readonly buffer Offsets {
+  uint offsets[];
+};
+BUFFER(4) writeonly buffer Count {
+  uint count[];
+};
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  uint n = params.numElements;
+  if (i < n) {
+    uint offset = offsets[i];
+    if (offset != (i > 0u ? offsets[i - 1u] : 0u)) {
+      outputData[offset - 1u] = inputData[i];
+    }
+  }
+  if (i == (n > 0u ? n - 1u : 0u)) {
+    count[params.outputIndex] = n > 0u ? offsets[n - 1u] : 0u;
+  }
+}
+)";
+
+// Counts the digits of each workgroup. The histogram is stored digit-major, so that its exclusive
+// scan is the first output index of the keys of each digit and workgroup.
+const char kGlslRadixHistogram[] = R"(
+BUFFER(1) readonly buffer KeysIn {
+  uint keysIn[];
+};
+BUFFER(3) writeonly buffer Histogram {
+  uint histogram[];
+};
+
+void main() {
+  uint id = gl_LocalInvocationID.x;
+  uint i = gl_GlobalInvocationID.x;
+  if (id < RADIX_SIZE) {
+    sharedData[id] = 0u;
+  }
+  syncShared();
+  if (i < params.numElements) {
+    atomicAdd(sharedData[(keysIn[i] >> params.mode) & (RADIX_SIZE - 1u)], 1u);
+  }
+  syncShared();
+  if (id < RADIX_SIZE) {
+    histogram[id * params.numBlocks + gl_WorkGroupID.x] = sharedData[id];
+  }
+}
+)";
+
+// Sorts the keys of each workgroup by digit with one stable split per bit of the digit, then
+// writes them at the offsets of the scanned histogram
+const char kGlslRadixScatter[] = R"(
+BUFFER(1) readonly buffer KeysIn {
+  uint keysIn[];
+};
+BUFFER(2) writeonly buffer KeysOut {
+  uint keysOut[];
+};
+BUFFER(3) readonly buffer Histogram {
+  uint histogram[];
+};
+BUFFER(4) readonly buffer ValuesIn {
+  uint valuesIn[];
+};
+BUFFER(5) writeonly buffer ValuesOut {
+  uint valuesOut[];
+};
+
+shared uint sharedKeys[WG_SIZE];
+shared uint sharedValues[WG_SIZE];
+shared uint sharedDigitStart[RADIX_SIZE];
+
+void main() {
+  uint id = gl_LocalInvocationID.x;
+  uint group = gl_WorkGroupID.x;
+  uint i = gl_GlobalInvocationID.x;
+  bool isValid = i < params.numElements;
+  // the padding keys end up after the valid keys of the last digit
+  uint key = isValid ? keysIn[i] : 0xffffffffu;
+  uint value = isValid && params.hasValues != 0u ? valuesIn[i] : 0u;
+  uint digit = (key >> params.mode) & (RADIX_SIZE - 1u);
+  for (uint bit = 0u; bit < 4u; bit++) {
+    uint isOne = (digit >> bit) & 1u;
+    uint numOnes;
+    uint ones = workgroupInclusiveAdd(isOne, numOnes);
+    uint dst = isOne != 0u ? WG_SIZE - numOnes + ones - 1u : id - ones;
+    sharedKeys[dst] = key;
+    sharedValues[dst] = value;
+    syncShared();
+    key = sharedKeys[id];
+    value = sharedValues[id];
+    digit = (key >> params.mode) & (RADIX_SIZE - 1u);
+    syncShared();
+  }
+  if (id == 0u || digit != ((sharedKeys[id - 1u] >> params.mode) & (RADIX_SIZE - 1u))) {
+    sharedDigitStart[digit] = id;
+  }
+  syncShared();
+  if (id < min(params.numElements - group * WG_SIZE, WG_SIZE)) {
+    uint dst = histogram[digit * params.numBlocks + group] + id - sharedDigitStart[digit];
+    keysOut[dst] = key;
+    if (params.hasValues != 0u) {
+      valuesOut[dst] = value;
+    }
+  }
+}
+)";
+
+const char kGlslReduceBlocks[] = R"(
+BUFFER(1) readonly buffer Input {
+  uint inputData[];
+};
+BUFFER(2) writeonly buffer Output {
+  uint outputData[];
+};
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  uint identity = params.mode == REDUCE_MIN ? 0xffffffffu : 0u;
+  uint result = workgroupReduce(i < params.numElements ? inputData[i] : identity);
+  if (gl_LocalInvocationID.x == 0u) {
+    outputData[params.outputIndex + gl_WorkGroupID.x] = result;
+  }
+}
+)";
+
+struct KernelInfo {
+  const char* glslBody;
+  const char* metalEntryPoint;
+  // the names of the GLSL storage blocks bound at the indices 1 to kMaxNumBuffers
+  const char* bufferNames[kMaxNumBuffers];
+};
+
+// indexed by ComputePrimitives::Kernel
+const KernelInfo kKernels[] = {
+    {kGlslScanBlocks, "scanBlocks", {"Input", "Output", "BlockSums"}},
+    {kGlslAddBlockSums, "addBlockSums", {nullptr, "Output", "BlockSums"}},
+    {kGlslScatterCompacted, "scatterCompacted", {"Input", "Output", "Offsets", "Count"}},
+    {kGlslRadixHistogram, "radixHistogram", {"KeysIn", nullptr, "Histogram"}},
+    {kGlslRadixScatter,
+     "radixScatter",
+     {"KeysIn", "KeysOut", "Histogram", "ValuesIn", "ValuesOut"}},
+    {kGlslReduceBlocks, "reduceBlocks", {"Input", "Output"}},
+};
+
+// The kernels declare their buffers with BUFFER(binding). Vulkan passes the parameters as push
+// constants; OpenGL reads them from a storage buffer.
+std::string getGlslSource(bool isVulkan, bool useSubgroups, const char* body) {
+  std::string source = glsl::computeShaderPrologue(isVulkan);
+  if (isVulkan) {
+    if (useSubgroups) {
+      source += "#extension GL_KHR_shader_subgroup_basic : require\n";
+      source += "#extension GL_KHR_shader_subgroup_arithmetic : require\n";
+    }
+    source += "#define PARAMS layout (push_constant) uniform\n";
+  } else {
+    source +=
+        "#define PARAMS " + glsl::storageBufferLayout(false, kParamsIndex) + " readonly buffer\n";
+  }
+  source += glsl::defineStorageBufferMacro("BUFFER", isVulkan);
+  source += std::string("#define USE_SUBGROUPS ") + (useSubgroups ? "1" : "0") + "\n";
+  return source + kGlslCommon + body;
+}
+
+const char kMetalSource[] = R"(
+#include <metal_stdlib>
+using namespace metal;
+
+#define WG_SIZE 256u
+#define RADIX_SIZE 16u
+#define SCAN_INCLUSIVE 1u
+#define SCAN_FLAGS 2u
+#define REDUCE_MIN 1u
+#define REDUCE_MAX 2u
+
+struct Params {
+  uint numElements;
+  uint mode;
+  uint numBlocks;
+  uint outputIndex;
+  uint hasValues;
+  uint padding[3];
+};
+
+struct ThreadInfo {
+  uint id;
+  uint simdIndex;
+  uint numSimdgroups;
+};
+
+#define THREAD_ARGS                                                \
+  uint i [[thread_position_in_grid]],                              \
+  uint id [[thread_position_in_threadgroup]],                      \
+  uint group [[threadgroup_position_in_grid]],                     \
+  uint simdIndex [[simdgroup_index_in_threadgroup]],               \
+  uint numSimdgroups [[simdgroups_per_threadgroup]]
+#define THREAD_INFO ThreadInfo{id, simdIndex, numSimdgroups}
+
+void syncShared() {
+  threadgroup_barrier(mem_flags::mem_threadgroup);
+}
+
+// Returns the sum of the values of the threads up to this one, and the sum of all of them in
+// `total`. `scratch` holds WG_SIZE + 1 elements.
+uint workgroupInclusiveAdd(uint value,
+                           thread uint& total,
+                           threadgroup uint* scratch,
+                           const ThreadInfo info) {
+#if USE_SIMDGROUPS
+  uint sum = simd_prefix_inclusive_sum(value);
+  const uint simdgroupSum = simd_sum(value);
+  if (simd_is_first()) {
+    scratch[info.simdIndex] = simdgroupSum;
+  }
+  syncShared();
+  if (info.id == 0) {
+    uint running = 0;
+    for (uint i = 0; i < info.numSimdgroups; i++) {
+      const uint s = scratch[i];
+      scratch[i] = running;
+      running += s;
+    }
+    scratch[WG_SIZE] = running;
+  }
+  syncShared();
+  sum += scratch[info.simdIndex];
+  total = scratch[WG_SIZE];
+#else
+  scratch[info.id] = value;
+  syncShared();
+  for (uint offset = 1; offset < WG_SIZE; offset <<= 1) {
+    const uint other = info.id >= offset ? scratch[info.id - offset] : 0;
+    syncShared();
+    scratch[info.id] += other;
+    syncShared();
+  }
+  const uint sum = scratch[info.id];
+  total = scratch[WG_SIZE - 1];
+#endif
+  syncShared();
+  return sum;
+}
+
+uint combine(uint mode, uint a, uint b) {
+  return mode == REDUCE_MIN ? min(a, b) : mode == REDUCE_MAX ? max(a, b) : a + b;
+}
+
+// The result is only valid in thread 0
+uint workgroupReduce(uint mode, uint value, threadgroup uint* scratch, const ThreadInfo info) {
+#if USE_SIMDGROUPS
+  uint result = mode == REDUCE_MIN   ? simd_min(value)
+                : mode == REDUCE_MAX ? simd_max(value)
+                                     : simd_sum(value);
+  if (simd_is_first()) {
+    scratch[info.simdIndex] = result;
+  }
+  syncShared();
+  if (info.id == 0) {
+    for (uint i = 1; i < info.numSimdgroups; i++) {
+      result = combine(mode, result, scratch[i]);
+    }
+  }
+  return result;
+#else
+  scratch[info.id] = value;
+  syncShared();
+  for (uint stride = WG_SIZE / 2; stride > 0; stride >>= 1) {
+    if (info.id < stride) {
+      scratch[info.id] = combine(mode, scratch[info.id], scratch[info.id + stride]);
+    }
+    syncShared();
+  }
+  return scratch[0];
+#endif
+}
+
+kernel void scanBlocks(constant Params& params [[buffer(0)]],
+                       const device uint* input [[buffer(1)]],
+                       device uint* output [[buffer(2)]],
+                       device uint* blockSums [[buffer(3)]],
+                       THREAD_ARGS) {
+  threadgroup uint scratch[WG_SIZE + 1];
+  uint value = i < params.numElements ? input[i] : 0;
+  if ((params.mode & SCAN_FLAGS) != 0) {
+    value = value != 0 ? 1 : 0;
+  }
+  uint total;
+  const uint sum = workgroupInclusiveAdd(value, total, scratch, THREAD_INFO);
+  if (i < params.numElements) {
+    output[i] = (params.mode & SCAN_INCLUSIVE) != 0 ? sum : sum - value;
+  }
+  if (id == 0) {
+    blockSums[group] = total;
+  }
+}
+
+kernel void addBlockSums(constant Params& params [[buffer(0)]],
+                         device uint* output [[buffer(2)]],
+                         const device uint* blockSums [[buffer(3)]],
+                         uint i [[thread_position_in_grid]],
+                         uint group [[threadgroup_position_in_grid]]) {
+  if (i < params.numElements) {
+    output[i] += blockSums[group];
+  }
+}
+
+kernel void scatterCompacted(constant Params& params [[buffer(0)]],
+                             const device uint* input [[buffer(1)]],
+                             device uint* output [[buffer(2)]],
+                             const device uint* offsets [[buffer(3)]],
+                             device uint* count [[buffer(4)]],
+                             uint i [[thread_position_in_grid]]) {
+  const uint n = params.numElements;
+  if (i < n) {
+    const uint offset = offsets[i];
+    if (offset != (i > 0 ? offsets[i - 1] : 0)) {
+      output[offset - 1] = input[i];
+    }
+  }
+  if (i == (n > 0 ? n - 1 : 0)) {
+    count[params.outputIndex] = n > 0 ? offsets[n - 1] : 0;
+  }
+}
+
+kernel void radixHistogram(constant Params& params [[buffer(0)]],
+                           const device uint* keysIn [[buffer(1)]],
+                           device uint* histogram [[buffer(3)]],
+                           uint i [[thread_position_in_grid]],
+                           uint id [[thread_position_in_threadgroup]],
+                           uint group [[threadgroup_position_in_grid]]) {
+  threadgroup atomic_uint counts[RADIX_SIZE];
+  if (id < RADIX_SIZE) {
+    atomic_store_explicit(&counts[id], 0, memory_order_relaxed);
+  }
+  syncShared();
+  if (i < params.numElements) {
+    const uint digit = (keysIn[i] >> params.mode) & (RADIX_SIZE - 1);
+    atomic_fetch_add_explicit(&counts[digit], 1, memory_order_relaxed);
+  }
+  syncShared();
+  if (id < RADIX_SIZE) {
+    histogram[id * params.numBlocks + group] =
+        atomic_load_explicit(&counts[id], memory_order_relaxed);
+  }
+}
+
+kernel void radixScatter(constant Params& params [[buffer(0)]],
+                         const device uint* keysIn [[buffer(1)]],
+                         device uint* keysOut [[buffer(2)]],
+                         const device uint* histogram [[buffer(3)]],
+                         const device uint* valuesIn [[buffer(4)]],
+                         device uint* valuesOut [[buffer(5)]],
+                         THREAD_ARGS) {
+  threadgroup uint scratch[WG_SIZE + 1];
+  threadgroup uint sharedKeys[WG_SIZE];
+  threadgroup uint sharedValues[WG_SIZE];
+  threadgroup uint sharedDigitStart[RADIX_SIZE];
+  const bool isValid = i < params.numElements;
+  // the padding keys end up after the valid keys of the last digit
+  uint key = isValid ? keysIn[i] : 0xffffffff;
+  uint value = isValid && params.hasValues != 0 ? valuesIn[i] : 0;
+  uint digit = (key >> params.mode) & (RADIX_SIZE - 1);
+  for (uint bit = 0; bit < 4; bit++) {
+    const uint isOne = (digit >> bit) & 1;
+    uint numOnes;
+    const uint ones = workgroupInclusiveAdd(isOne, numOnes, scratch, THREAD_INFO);
+    const uint dst = isOne != 0 ? WG_SIZE - numOnes + ones - 1 : id - ones;
+    sharedKeys[dst] = key;
+    sharedValues[dst] = value;
+    syncShared();
+    key = sharedKeys[id];
+    value = sharedValues[id];
+    digit = (key >> params.mode) & (RADIX_SIZE - 1);
+    syncShared();
+  }
+  if (id == 0 || digit != ((sharedKeys[id - 1] >> params.mode) & (RADIX_SIZE - 1))) {
+    sharedDigitStart[digit] = id;
+  }
+  syncShared();
+  if (id < min(params.numElements - group * WG_SIZE, WG_SIZE)) {
+    const uint dst = histogram[digit * params.numBlocks + group] + id - sharedDigitStart[digit];
+    keysOut[dst] = key;
+    if (params.hasValues != 0) {
+      valuesOut[dst] = value;
+    }
+  }
+}
+
+kernel void reduceBlocks(constant Params& params [[buffer(0)]],
+                         const device uint* input [[buffer(1)]],
+                         device uint* output [[buffer(2)]],
+                         THREAD_ARGS) {
+  threadgroup uint scratch[WG_SIZE + 1];
+  const uint identity = params.mode == REDUCE_MIN ? 0xffffffff : 0;
+  const uint result = workgroupReduce(
+      params.mode, i < params.numElements ? input[i] : identity, scratch, THREAD_INFO);
+  if (id == 0) {
+    output[params.outputIndex + group] = result;
+  }
+}
+)";
+
+std::shared_ptr<igl::IBuffer> createBuffer(igl::IDevice& device,
+                                           size_t length,
+                                           const char* debugName,
+                                           igl::Result* outResult) {
+  igl::BufferDesc desc(
+      igl::BufferDesc::BufferTypeBits::Storage, nullptr, length, igl::ResourceStorage::Shared);
+  desc.debugName = debugName;
+  return device.createBuffer(desc, outResult);
+}
+
+} // namespace
+
+ComputePrimitives::ComputePrimitives(igl::IDevice& device,
+                                     uint32_t maxNumElements,
+                                     igl::Result* outResult) :
+  backendType_(device.getBackendType()), maxNumElements_(maxNumElements) {
+  if (!device.hasFeature(igl::DeviceFeatures::Compute)) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::Unsupported, "Compute primitives require compute");
+    return;
+  }
+  if (maxNumElements == 0 || maxNumElements > kMaxNumElements) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::ArgumentOutOfRange,
+                           "The maximum number of elements must be in [1, 65535 * 256]");
+    return;
+  }
+  usesSubgroups_ = device.hasFeature(igl::DeviceFeatures::ShaderSubgroups);
+
+  igl::Result result;
+  // the histogram of a radix sort pass is scanned too
+  const uint32_t maxNumBlocks = getNumBlocks(maxNumElements);
+  for (uint32_t n = getNumBlocks(std::max(maxNumElements, kRadixSize * maxNumBlocks));
+       result.isOk();
+       n = getNumBlocks(n)) {
+    levelBuffers_.push_back(
+        createBuffer(device, n * sizeof(uint32_t), "ComputePrimitives level", &result));
+    if (n == 1) {
+      break;
+    }
+  }
+  if (result.isOk()) {
+    scratchKeys_ = createBuffer(
+        device, maxNumElements * sizeof(uint32_t), "ComputePrimitives scratch keys", &result);
+  }
+  if (result.isOk()) {
+    scratchValues_ = createBuffer(
+        device, maxNumElements * sizeof(uint32_t), "ComputePrimitives scratch values", &result);
+  }
+  if (result.isOk()) {
+    histogram_ = createBuffer(device,
+                              kRadixSize * maxNumBlocks * sizeof(uint32_t),
+                              "ComputePrimitives histogram",
+                              &result);
+  }
+  if (result.isOk() && backendType_ == igl::BackendType::OpenGL) {
+    paramsBuffer_ = createBuffer(device, sizeof(Params), "ComputePrimitives params", &result);
+  }
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  std::unique_ptr<igl::IShaderLibrary> metalLibrary;
+  if (backendType_ == igl::BackendType::Metal) {
+    std::vector<igl::ShaderModuleInfo> moduleInfo;
+    for (const KernelInfo& kernel : kKernels) {
+      moduleInfo.push_back({igl::ShaderStage::Compute, kernel.metalEntryPoint});
+    }
+    const std::string source = std::string("#define USE_SIMDGROUPS ") +
+                               (usesSubgroups_ ? "1" : "0") + "\n" + kMetalSource;
+    metalLibrary = igl::ShaderLibraryCreator::fromStringInput(
+        device, source.c_str(), std::move(moduleInfo), "ComputePrimitives", &result);
+    if (!result.isOk()) {
+      igl::Result::setResult(outResult, std::move(result));
+      return;
+    }
+  }
+
+  for (size_t k = 0; k != NumKernels; k++) {
+    const KernelInfo& kernel = kKernels[k];
+    std::unique_ptr<igl::IShaderStages> stages;
+    if (metalLibrary) {
+      stages = igl::ShaderStagesCreator::fromComputeModule(
+          device, metalLibrary->getShaderModule(kernel.metalEntryPoint), &result);
+    } else {
+      const std::string source = getGlslSource(
+          backendType_ == igl::BackendType::Vulkan, usesSubgroups_, kernel.glslBody);
+      stages = igl::ShaderStagesCreator::fromModuleStringInput(
+          device, source.c_str(), "main", kernel.metalEntryPoint, &result);
+    }
+    if (!result.isOk()) {
+      igl::Result::setResult(outResult, std::move(result));
+      return;
+    }
+
+    igl::ComputePipelineDesc desc;
+    desc.shaderStages = std::move(stages);
+    desc.buffersMap[kParamsIndex] = igl::genNameHandle("Params");
+    for (size_t i = 0; i != kMaxNumBuffers; i++) {
+      if (kernel.bufferNames[i]) {
+        desc.buffersMap[i + 1] = igl::genNameHandle(kernel.bufferNames[i]);
+      }
+    }
+    desc.debugName = std::string("ComputePrimitives::") + kernel.metalEntryPoint;
+    pipelines_[k] = device.createComputePipeline(desc, &result);
+    if (!result.isOk()) {
+      igl::Result::setResult(outResult, std::move(result));
+      return;
+    }
+  }
+  igl::Result::setOk(outResult);
+}
+
+void ComputePrimitives::exclusiveScan(igl::ICommandBuffer& commandBuffer,
+                                      const std::shared_ptr<igl::IBuffer>& input,
+                                      const std::shared_ptr<igl::IBuffer>& output,
+                                      uint32_t numElements) {
+  if (!IGL_VERIFY(numElements <= maxNumElements_ && checkBuffer(input, numElements) &&
+                  checkBuffer(output, numElements))) {
+    return;
+  }
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("ComputePrimitives::exclusiveScan()");
+  scan(*encoder, input, output, numElements, 0, 0);
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+void ComputePrimitives::inclusiveScan(igl::ICommandBuffer& commandBuffer,
+                                      const std::shared_ptr<igl::IBuffer>& input,
+                                      const std::shared_ptr<igl::IBuffer>& output,
+                                      uint32_t numElements) {
+  if (!IGL_VERIFY(numElements <= maxNumElements_ && checkBuffer(input, numElements) &&
+                  checkBuffer(output, numElements))) {
+    return;
+  }
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("ComputePrimitives::inclusiveScan()");
+  scan(*encoder, input, output, numElements, kScanInclusive, 0);
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+void ComputePrimitives::compact(igl::ICommandBuffer& commandBuffer,
+                                const std::shared_ptr<igl::IBuffer>& input,
+                                const std::shared_ptr<igl::IBuffer>& flags,
+                                const std::shared_ptr<igl::IBuffer>& output,
+                                const std::shared_ptr<igl::IBuffer>& count,
+                                uint32_t countIndex,
+                                uint32_t numElements) {
+  if (!IGL_VERIFY(numElements <= maxNumElements_ && checkBuffer(input, numElements) &&
+                  checkBuffer(flags, numElements) &&
+                  checkBuffer(output, numElements) && checkBuffer(count, countIndex + 1) &&
+                  input != output)) {
+    return;
+  }
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("ComputePrimitives::compact()");
+  // the inclusive scan of the flags is one past the output index of the flagged elements
+  scan(*encoder, flags, scratchKeys_, numElements, kScanInclusive | kScanFlags, 0);
+  const std::shared_ptr<igl::IBuffer> buffers[] = {input, output, scratchKeys_, count};
+  dispatch(*encoder,
+           ScatterCompacted,
+           {numElements, 0, getNumBlocks(numElements), countIndex, 0, {}},
+           numElements,
+           buffers,
+           std::size(buffers));
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+void ComputePrimitives::sort(igl::ICommandBuffer& commandBuffer,
+                             const std::shared_ptr<igl::IBuffer>& keys,
+                             const std::shared_ptr<igl::IBuffer>& values,
+                             uint32_t numElements,
+                             uint32_t numKeyBits) {
+  if (!IGL_VERIFY(numElements <= maxNumElements_ && checkBuffer(keys, numElements) &&
+                  (!values || checkBuffer(values, numElements)) && numKeyBits <= 32)) {
+    return;
+  }
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("ComputePrimitives::sort()");
+  const uint32_t numBlocks = getNumBlocks(numElements);
+  // an even number of passes, so that the sorted keys end up in `keys`
+  const uint32_t numPasses = (numKeyBits + 7) / 8 * (8 / kRadixBits);
+  for (uint32_t pass = 0; pass != numPasses; pass++) {
+    const bool isEven = pass % 2 == 0;
+    const auto& keysIn = isEven ? keys : scratchKeys_;
+    const auto& keysOut = isEven ? scratchKeys_ : keys;
+    // the keys stand in for the values, which are not accessed
+    const auto& valuesIn = !values ? keysIn : isEven ? values : scratchValues_;
+    const auto& valuesOut = !values ? keysOut : isEven ? scratchValues_ : values;
+    const Params params = {
+        numElements, pass * kRadixBits, numBlocks, 0, values ? 1u : 0u, {}};
+
+    const std::shared_ptr<igl::IBuffer> buffers[] = {
+        keysIn, keysOut, histogram_, valuesIn, valuesOut};
+    dispatch(*encoder, RadixHistogram, params, numElements, buffers, std::size(buffers));
+    scan(*encoder, histogram_, histogram_, kRadixSize * numBlocks, 0, 0);
+    dispatch(*encoder, RadixScatter, params, numElements, buffers, std::size(buffers));
+  }
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+void ComputePrimitives::reduce(igl::ICommandBuffer& commandBuffer,
+                               const std::shared_ptr<igl::IBuffer>& input,
+                               ReduceOp op,
+                               const std::shared_ptr<igl::IBuffer>& output,
+                               uint32_t outputIndex,
+                               uint32_t numElements) {
+  if (!IGL_VERIFY(numElements <= maxNumElements_ && checkBuffer(input, numElements) &&
+                  checkBuffer(output, outputIndex + 1))) {
+    return;
+  }
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("ComputePrimitives::reduce()");
+  // each level reduces the partial results of the previous one, until a single workgroup is left
+  std::shared_ptr<igl::IBuffer> levelInput = input;
+  size_t level = 0;
+  for (uint32_t n = numElements; true; n = getNumBlocks(n), level++) {
+    const uint32_t numBlocks = getNumBlocks(n);
+    const bool isLast = numBlocks <= 1;
+    const std::shared_ptr<igl::IBuffer> buffers[] = {levelInput,
+                                                     isLast ? output : levelBuffers_[level]};
+    dispatch(*encoder,
+             ReduceBlocks,
+             {n, static_cast<uint32_t>(op), numBlocks, isLast ? outputIndex : 0, 0, {}},
+             n,
+             buffers,
+             std::size(buffers));
+    if (isLast) {
+      break;
+    }
+    levelInput = levelBuffers_[level];
+  }
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+void ComputePrimitives::scan(igl::IComputeCommandEncoder& encoder,
+                             const std::shared_ptr<igl::IBuffer>& input,
+                             const std::shared_ptr<igl::IBuffer>& output,
+                             uint32_t numElements,
+                             uint32_t mode,
+                             size_t level) {
+  IGL_ASSERT(level < levelBuffers_.size());
+  const uint32_t numBlocks = getNumBlocks(numElements);
+  const Params params = {numElements, mode, numBlocks, 0, 0, {}};
+  {
+    const std::shared_ptr<igl::IBuffer> buffers[] = {input, output, levelBuffers_[level]};
+    dispatch(encoder, ScanBlocks, params, numElements, buffers, std::size(buffers));
+  }
+  if (numBlocks > 1) {
+    // the exclusive scan of the block sums is what each block adds to its elements
+    scan(encoder, levelBuffers_[level], levelBuffers_[level], numBlocks, 0, level + 1);
+    const std::shared_ptr<igl::IBuffer> buffers[] = {nullptr, output, levelBuffers_[level]};
+    dispatch(encoder, AddBlockSums, params, numElements, buffers, std::size(buffers));
+  }
+}
+
+void ComputePrimitives::dispatch(igl::IComputeCommandEncoder& encoder,
+                                 Kernel kernel,
+                                 const Params& params,
+                                 uint32_t numThreads,
+                                 const std::shared_ptr<igl::IBuffer>* buffers,
+                                 size_t numBuffers) {
+  IGL_ASSERT(numBuffers <= kMaxNumBuffers);
+  encoder.bindComputePipelineState(pipelines_[kernel]);
+  switch (backendType_) {
+  case igl::BackendType::Vulkan:
+    encoder.bindPushConstants(&params, sizeof(params));
+    break;
+  case igl::BackendType::Metal:
+    encoder.bindBytes(kParamsIndex, &params, sizeof(params));
+    break;
+  default:
+    // OpenGL runs the previous dispatches before uploading the parameters of this one
+    paramsBuffer_->upload(&params, {sizeof(params), 0});
+    encoder.bindBuffer(kParamsIndex, paramsBuffer_, 0);
+    break;
+  }
+  for (size_t i = 0; i != numBuffers; i++) {
+    if (buffers[i]) {
+      encoder.bindBuffer(i + 1, buffers[i], 0);
+    }
+  }
+  encoder.dispatchThreadGroups(igl::Dimensions(std::max(getNumBlocks(numThreads), 1u), 1, 1),
+                               igl::Dimensions(kWorkgroupSize, 1, 1));
+}
+
+bool ComputePrimitives::checkBuffer(const std::shared_ptr<igl::IBuffer>& buffer,
+                                    uint32_t numElements) const {
+  return pipelines_[ScanBlocks] && buffer &&
+         buffer->getSizeInBytes() >= size_t(numElements) * sizeof(uint32_t);
+}
+
+} // namespace computeprimitives
+} // namespace iglu
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace computeprimitives {
+
+enum class ReduceOp : uint8_t {
+  /// Wraps around on overflow
+  Sum = 0,
+  Min = 1,
+  Max = 2,
+};
+
+/**
+ * @brief Parallel building blocks for GPU-driven rendering: prefix scans, stream compaction, radix
+ * sort and reductions of 32-bit unsigned integers stored in storage buffers.
+ *
+ * Each operation records its dispatches into a compute encoder of the command buffer passed to
+ * it, so it is ordered with the work encoded before and after it like any other compute pass.
+ * The buffers are created with igl::BufferDesc::BufferTypeBits::Storage, hold at least
+ * `numElements` uint32_t values, and are bound without offset. The scratch memory is owned by
+ * this object: operations recorded into command buffers which run concurrently on the GPU need
+ * one object each.
+ *
+ * The workgroups of 256 invocations combine their values with subgroup (SIMD-group) arithmetic
+ * functions when the device has igl::DeviceFeatures::ShaderSubgroups, and with shared memory
+ * otherwise, which is always the case on OpenGL. Parameters are bound as push constants on
+ * Vulkan, with bindBytes() on Metal, and uploaded to a small storage buffer before each dispatch
+ * on OpenGL, which runs the dispatches as they are encoded.
+ *
+ * Requires igl::DeviceFeatures::Compute.
+ */
+class ComputePrimitives final {
+ public:
+  /// Creates the pipelines and the scratch buffers for operations on up to `maxNumElements`
+  /// elements, which is at most 65535 * 256.
+  ComputePrimitives(igl::IDevice& device, uint32_t maxNumElements, igl::Result* outResult);
+
+  /// output[i] = input[0] + ... + input[i - 1], and output[0] = 0. `output` can be `input`.
+  void exclusiveScan(igl::ICommandBuffer& commandBuffer,
+                     const std::shared_ptr<igl::IBuffer>& input,
+                     const std::shared_ptr<igl::IBuffer>& output,
+                     uint32_t numElements);
+  /// output[i] = input[0] + ... + input[i]. `output` can be `input`.
+  void inclusiveScan(igl::ICommandBuffer& commandBuffer,
+                     const std::shared_ptr<igl::IBuffer>& input,
+                     const std::shared_ptr<igl::IBuffer>& output,
+                     uint32_t numElements);
+
+  /// Copies the elements of `input` whose flag is not 0 to the start of `output`, in order, and
+  /// writes their number to the uint32_t `count[countIndex]`, which can be an element of an
+  /// indirect dispatch or draw command. `output` can't be `input`.
+  void compact(igl::ICommandBuffer& commandBuffer,
+               const std::shared_ptr<igl::IBuffer>& input,
+               const std::shared_ptr<igl::IBuffer>& flags,
+               const std::shared_ptr<igl::IBuffer>& output,
+               const std::shared_ptr<igl::IBuffer>& count,
+               uint32_t countIndex,
+               uint32_t numElements);
+
+  /// Sorts `keys` in place in increasing order with a stable least significant digit radix sort.
+  /// `values`, if not null, are reordered along with the keys. Only the `numKeyBits` lowest bits
+  /// of the keys are compared, rounded up to a multiple of 8: sorting 16-bit keys takes half the
+  /// time of sorting 32-bit ones.
+  void sort(igl::ICommandBuffer& commandBuffer,
+            const std::shared_ptr<igl::IBuffer>& keys,
+            const std::shared_ptr<igl::IBuffer>& values,
+            uint32_t numElements,
+            uint32_t numKeyBits = 32);
+
+  /// Combines all the elements of `input` with `op` and writes the result to the uint32_t
+  /// `output[outputIndex]`. The result for no elements is the identity of `op`: 0 for Sum and Max,
+  /// 0xffffffff for Min.
+  void reduce(igl::ICommandBuffer& commandBuffer,
+              const std::shared_ptr<igl::IBuffer>& input,
+              ReduceOp op,
+              const std::shared_ptr<igl::IBuffer>& output,
+              uint32_t outputIndex,
+              uint32_t numElements);
+
+  [[nodiscard]] uint32_t getMaxNumElements() const {
+    return maxNumElements_;
+  }
+  [[nodiscard]] bool usesSubgroups() const {
+    return usesSubgroups_;
+  }
+
+ private:
+  // matches the Params struct of the shaders
+  struct Params {
+    uint32_t numElements;
+    // ScanMode bits, the ReduceOp, or the shift of the radix digit
+    uint32_t mode;
+    uint32_t numBlocks;
+    // the index of the count or of the reduction in the output buffer
+    uint32_t outputIndex;
+    uint32_t hasValues;
+    uint32_t padding[3];
+  };
+
+  enum Kernel : uint8_t {
+    ScanBlocks = 0,
+    AddBlockSums,
+    ScatterCompacted,
+    RadixHistogram,
+    RadixScatter,
+    ReduceBlocks,
+    NumKernels,
+  };
+
+  void scan(igl::IComputeCommandEncoder& encoder,
+            const std::shared_ptr<igl::IBuffer>& input,
+            const std::shared_ptr<igl::IBuffer>& output,
+            uint32_t numElements,
+            uint32_t mode,
+            size_t level);
+  void dispatch(igl::IComputeCommandEncoder& encoder,
+                Kernel kernel,
+                const Params& params,
+                uint32_t numThreads,
+                const std::shared_ptr<igl::IBuffer>* buffers,
+                size_t numBuffers);
+  [[nodiscard]] bool checkBuffer(const std::shared_ptr<igl::IBuffer>& buffer,
+                                 uint32_t numElements) const;
+
+  igl::BackendType backendType_ = igl::BackendType::OpenGL;
+  uint32_t maxNumElements_ = 0;
+  bool usesSubgroups_ = false;
+  std::shared_ptr<igl::IComputePipelineState> pipelines_[NumKernels];
+  // OpenGL only: the parameters of the next dispatch
+  std::shared_ptr<igl::IBuffer> paramsBuffer_;
+  // the sums of the blocks of each level of a scan, and the partial reductions
+  std::vector<std::shared_ptr<igl::IBuffer>> levelBuffers_;
+  // the flag offsets of compact() and the ping-pong keys of sort()
+  std::shared_ptr<igl::IBuffer> scratchKeys_;
+  std::shared_ptr<igl::IBuffer> scratchValues_;
+  std::shared_ptr<igl::IBuffer> histogram_;
+};
+
+} // namespace computeprimitives
+} // namespace iglu
@@ -0,0 +1,446 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <igl/NameHandle.h>
+#include <igl/RenderPipelineState.h>
+#include <igl/SamplerState.h>
+#include <igl/ShaderCreator.h>
+#include <igl/VertexInputState.h>
+
+namespace iglu {
+namespace dynamicresolution {
+
+namespace {
+
+struct VertexPosUv {
+  float position[2];
+  float uv[2];
+  // the texture coordinates of the last rendered texel centers, so linear filtering never reads
+  // the texels outside of the rendered region
+  float uvMax[2];
+};
+
+constexpr size_t kTextureUnit = 0;
+constexpr int kVertexBufferIndex = 1;
+
+const char* getMetalShaderSource() {
+  return R"(
+    using namespace metal;
+
+    typedef struct {
+      float2 position;
+      float2 uv;
+      float2 uvMax;
+    } VertexIn;
+
+    typedef struct {
+      float4 position [[position]];
+      float2 uv;
+      float2 uvMax;
+    } VertexOut;
+
+    vertex VertexOut vertexShader(uint vid [[vertex_id]],
+                                  constant VertexIn* vertices [[buffer(1)]]) {
+      VertexOut out;
+      out.position = float4(vertices[vid].position, 0.0, 1.0);
+      out.uv = vertices[vid].uv;
+      out.uvMax = vertices[vid].uvMax;
+      return out;
+    }
+
+    fragment float4 fragmentShader(VertexOut IN [[stage_in]],
+                                   texture2d<float> inputImage [[texture(0)]],
+                                   sampler linearSampler [[sampler(0)]]) {
+      return inputImage.sample(linearSampler, min(IN.uv, IN.uvMax));
+    }
+  )";
+}
+
+const char* getOpenGLVertexShaderSource() {
+  return R"(#version 100
+    precision highp float;
+    attribute vec2 position;
+    attribute vec2 uv_in;
+    attribute vec2 uvMax_in;
+
+    varying vec2 uv;
+    varying vec2 uvMax;
+
+    void main() {
+      gl_Position = vec4(position, 0.0, 1.0);
+      uv = uv_in;
+      uvMax = uvMax_in;
+    })";
+}
+
+const char* getOpenGLFragmentShaderSource() {
+  return R"(#version 100
+    precision highp float;
+    uniform sampler2D inputImage;
+
+    varying vec2 uv;
+    varying vec2 uvMax;
+
+    void main() {
+      gl_FragColor = texture2D(inputImage, min(uv, uvMax));
+    })";
+}
+
+const char* getVulkanVertexShaderSource() {
+  return R"(
+    layout(location = 0) in vec2 position;
+    layout(location = 1) in vec2 uv_in;
+    layout(location = 2) in vec2 uvMax_in;
+    layout(location = 0) out vec2 uv;
+    layout(location = 1) out vec2 uvMax;
+
+    void main() {
+      gl_Position = vec4(position, 0.0, 1.0);
+      uv = uv_in;
+      uvMax = uvMax_in;
+    })";
+}
+
+const char* getVulkanFragmentShaderSource() {
+  return R"(
+    layout(location = 0) in vec2 uv;
+    layout(location = 1) in vec2 uvMax;
+    layout(location = 0) out vec4 out_FragColor;
+
+    layout(set = 0, binding = 0) uniform sampler2D in_texture;
+
+    void main() {
+      out_FragColor = texture(in_texture, min(uv, uvMax));
+    })";
+}
+
+std::unique_ptr<igl::IShaderStages> getShaderStagesForBackend(igl::IDevice& device,
+                                                              igl::Result* outResult) {
+  switch (device.getBackendType()) {
+  case igl::BackendType::Vulkan:
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device,
+        getVulkanVertexShaderSource(),
+        "main",
+        "Shader Module: dynamicresolution::vertex",
+        getVulkanFragmentShaderSource(),
+        "main",
+        "Shader Module: dynamicresolution::fragment",
+        outResult);
+  // @fb-only
+    // @fb-only
+  case igl::BackendType::Metal:
+    return igl::ShaderStagesCreator::fromLibraryStringInput(
+        device, getMetalShaderSource(), "vertexShader", "fragmentShader", "", outResult);
+  case igl::BackendType::OpenGL:
+    return igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                           getOpenGLVertexShaderSource(),
+                                                           "main",
+                                                           "",
+                                                           getOpenGLFragmentShaderSource(),
+                                                           "main",
+                                                           "",
+                                                           outResult);
+  }
+  IGL_UNREACHABLE_RETURN(nullptr);
+}
+
+size_t scaleSize(size_t size, float scale) {
+  return std::max<size_t>(static_cast<size_t>(std::lround(static_cast<float>(size) * scale)), 1);
+}
+
+} // namespace
+
+DynamicResolution::DynamicResolution(igl::IDevice& device, DynamicResolutionConfig config) :
+  device_(device), config_(std::move(config)), scale_(config_.maxScale) {
+  IGL_ASSERT(config_.minScale > 0.0f && config_.minScale <= config_.maxScale);
+  IGL_ASSERT(config_.numFramesInFlight > 0);
+
+  frameQueries_.resize(config_.numFramesInFlight);
+  upsampleVertices_.resize(config_.numFramesInFlight);
+
+  if (device_.hasFeature(igl::DeviceFeatures::TimestampQueries)) {
+    igl::TimestampQueryPoolDesc desc;
+    desc.count = 2 * config_.numFramesInFlight;
+    desc.debugName = "DynamicResolution";
+    igl::Result result;
+    queryPool_ = device_.createTimestampQueryPool(desc, &result);
+    if (!queryPool_) {
+      IGL_LOG_ERROR("Cannot create timestamp queries: %s\n", result.message.c_str());
+    }
+  } else {
+    IGL_LOG_INFO("Timestamp queries are not supported, the resolution stays fixed\n");
+  }
+
+  igl::VertexInputStateDesc inputDesc;
+  inputDesc.numAttributes = 3;
+  inputDesc.attributes[0] = igl::VertexAttribute(kVertexBufferIndex,
+                                                 igl::VertexAttributeFormat::Float2,
+                                                 offsetof(VertexPosUv, position),
+                                                 "position",
+                                                 0);
+  inputDesc.attributes[1] = igl::VertexAttribute(kVertexBufferIndex,
+                                                 igl::VertexAttributeFormat::Float2,
+                                                 offsetof(VertexPosUv, uv),
+                                                 "uv_in",
+                                                 1);
+  inputDesc.attributes[2] = igl::VertexAttribute(kVertexBufferIndex,
+                                                 igl::VertexAttributeFormat::Float2,
+                                                 offsetof(VertexPosUv, uvMax),
+                                                 "uvMax_in",
+                                                 2);
+  inputDesc.numInputBindings = 1;
+  inputDesc.inputBindings[kVertexBufferIndex].stride = sizeof(VertexPosUv);
+  vertexInput_ = device_.createVertexInputState(inputDesc, nullptr);
+  IGL_ASSERT(vertexInput_ != nullptr);
+
+  igl::SamplerStateDesc samplerDesc;
+  samplerDesc.minFilter = samplerDesc.magFilter = igl::SamplerMinMagFilter::Linear;
+  samplerDesc.addressModeU = samplerDesc.addressModeV = igl::SamplerAddressMode::Clamp;
+  samplerDesc.debugName = "DynamicResolution";
+  sampler_ = device_.createSamplerState(samplerDesc, nullptr);
+  IGL_ASSERT(sampler_ != nullptr);
+}
+
+DynamicResolution::~DynamicResolution() = default;
+
+float DynamicResolution::computeScale(float scale,
+                                      double gpuTimeMs,
+                                      const DynamicResolutionConfig& config) {
+  float newScale = scale;
+  const double budget = config.gpuBudgetMs;
+  if (gpuTimeMs > 0.0 && (gpuTimeMs > budget || gpuTimeMs < budget * config.increaseThreshold)) {
+    // aim for the middle of the band where the scale stays the same
+    const double targetMs = budget * (1.0 + config.increaseThreshold) / 2.0;
+    newScale = static_cast<float>(scale * std::sqrt(targetMs / gpuTimeMs));
+    newScale = std::clamp(newScale, scale - config.maxScaleStep, scale + config.maxScaleStep);
+  }
+  return std::clamp(newScale, config.minScale, config.maxScale);
+}
+
+void DynamicResolution::readTimestamps() {
+  if (!queryPool_) {
+    return;
+  }
+  // from the oldest frame to the most recent one
+  for (uint32_t i = 0; i != config_.numFramesInFlight; i++) {
+    const uint32_t frame = (currentFrame_ + i) % config_.numFramesInFlight;
+    FrameQueries& queries = frameQueries_[frame];
+    uint64_t timestampsNs[2] = {};
+    if (!queries.isPending || !queryPool_->getResults(2 * frame, 2, timestampsNs)) {
+      continue;
+    }
+    queries.isPending = false;
+    if (timestampsNs[1] < timestampsNs[0]) {
+      continue;
+    }
+    lastGpuTimeMs_ = static_cast<double>(timestampsNs[1] - timestampsNs[0]) / 1e6;
+    // the time the scene would take at the current scale
+    const float ratio = scale_ / queries.scale;
+    scale_ = computeScale(scale_, lastGpuTimeMs_ * ratio * ratio, config_);
+  }
+}
+
+bool DynamicResolution::createTarget(const igl::Dimensions& outputSize) {
+  const igl::Dimensions targetSize(scaleSize(outputSize.width, config_.maxScale),
+                                   scaleSize(outputSize.height, config_.maxScale),
+                                   1);
+
+  igl::Result result;
+  auto colorDesc = igl::TextureDesc::new2D(config_.colorFormat,
+                                           targetSize.width,
+                                           targetSize.height,
+                                           igl::TextureDesc::TextureUsageBits::Sampled |
+                                               igl::TextureDesc::TextureUsageBits::Attachment |
+                                               config_.extraColorUsage,
+                                           "DynamicResolution: color");
+  colorDesc.storage = igl::ResourceStorage::Private;
+  igl::FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = device_.createTexture(colorDesc, &result);
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("Cannot create the color target: %s\n", result.message.c_str());
+    return false;
+  }
+  if (config_.depthFormat != igl::TextureFormat::Invalid) {
+    auto depthDesc = igl::TextureDesc::new2D(config_.depthFormat,
+                                             targetSize.width,
+                                             targetSize.height,
+                                             igl::TextureDesc::TextureUsageBits::Attachment,
+                                             "DynamicResolution: depth");
+    depthDesc.storage = igl::ResourceStorage::Private;
+    framebufferDesc.depthAttachment.texture = device_.createTexture(depthDesc, &result);
+    if (!result.isOk()) {
+      IGL_LOG_ERROR("Cannot create the depth target: %s\n", result.message.c_str());
+      return false;
+    }
+  }
+  framebufferDesc.debugName = "DynamicResolution";
+  auto framebuffer = device_.createFramebuffer(framebufferDesc, &result);
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("Cannot create the framebuffer: %s\n", result.message.c_str());
+    return false;
+  }
+
+  framebuffer_ = std::move(framebuffer);
+  outputSize_ = outputSize;
+  targetSize_ = targetSize;
+  return true;
+}
+
+void DynamicResolution::beginScene(igl::ICommandBuffer& commandBuffer,
+                                   const igl::Dimensions& outputSize) {
+  currentFrame_ = frameIndex_++ % config_.numFramesInFlight;
+
+  readTimestamps();
+
+  if (!framebuffer_ || outputSize.width != outputSize_.width ||
+      outputSize.height != outputSize_.height) {
+    createTarget(outputSize);
+  }
+
+  // the queries of this frame are only reused once their results are read
+  FrameQueries& queries = frameQueries_[currentFrame_];
+  isTimingFrame_ = queryPool_ && !queries.isPending;
+  if (isTimingFrame_) {
+    queries.scale = scale_;
+    commandBuffer.writeTimestamp(*queryPool_, 2 * currentFrame_);
+  }
+}
+
+void DynamicResolution::endScene(igl::ICommandBuffer& commandBuffer) {
+  if (isTimingFrame_) {
+    commandBuffer.writeTimestamp(*queryPool_, 2 * currentFrame_ + 1);
+    frameQueries_[currentFrame_].isPending = true;
+    isTimingFrame_ = false;
+  }
+}
+
+igl::Dimensions DynamicResolution::getRenderSize() const {
+  return {std::min(scaleSize(outputSize_.width, scale_), targetSize_.width),
+          std::min(scaleSize(outputSize_.height, scale_), targetSize_.height),
+          1};
+}
+
+igl::Viewport DynamicResolution::getViewport() const {
+  const igl::Dimensions size = getRenderSize();
+  return {0.0f, 0.0f, static_cast<float>(size.width), static_cast<float>(size.height), 0.0f, 1.0f};
+}
+
+igl::ScissorRect DynamicResolution::getScissorRect() const {
+  const igl::Dimensions size = getRenderSize();
+  return {0, 0, static_cast<uint32_t>(size.width), static_cast<uint32_t>(size.height)};
+}
+
+bool DynamicResolution::createUpsamplePipeline(const igl::IFramebuffer& outputFramebuffer) {
+  const auto color = outputFramebuffer.getColorAttachment(0);
+  const auto depth = outputFramebuffer.getDepthAttachment();
+  const igl::TextureFormat colorFormat =
+      color ? color->getProperties().format : igl::TextureFormat::Invalid;
+  const igl::TextureFormat depthFormat =
+      depth ? depth->getProperties().format : igl::TextureFormat::Invalid;
+  if (upsamplePipeline_ && colorFormat == upsampleColorFormat_ &&
+      depthFormat == upsampleDepthFormat_) {
+    return true;
+  }
+
+  igl::Result result;
+  if (!shaderStages_) {
+    shaderStages_ = getShaderStagesForBackend(device_, &result);
+    if (!shaderStages_) {
+      IGL_LOG_ERROR("Cannot create the upsampling shaders: %s\n", result.message.c_str());
+      return false;
+    }
+  }
+
+  igl::RenderPipelineDesc desc;
+  desc.vertexInputState = vertexInput_;
+  desc.shaderStages = shaderStages_;
+  desc.targetDesc.colorAttachments.resize(1);
+  desc.targetDesc.colorAttachments[0].textureFormat = colorFormat;
+  desc.targetDesc.depthAttachmentFormat = depthFormat;
+  desc.fragmentUnitSamplerMap[kTextureUnit] = IGL_NAMEHANDLE("inputImage");
+  desc.cullMode = igl::CullMode::Disabled;
+  desc.debugName = igl::genNameHandle("DynamicResolution: upsample");
+  upsamplePipeline_ = device_.createRenderPipeline(desc, &result);
+  if (!upsamplePipeline_) {
+    IGL_LOG_ERROR("Cannot create the upsampling pipeline: %s\n", result.message.c_str());
+    return false;
+  }
+  upsampleColorFormat_ = colorFormat;
+  upsampleDepthFormat_ = depthFormat;
+  return true;
+}
+
+void DynamicResolution::upsample(igl::IRenderCommandEncoder& encoder,
+                                 const igl::IFramebuffer& outputFramebuffer) {
+  if (!framebuffer_ || !createUpsamplePipeline(outputFramebuffer)) {
+    return;
+  }
+
+  UpsampleVertices& vertices = upsampleVertices_[currentFrame_];
+  const igl::Dimensions renderSize = getRenderSize();
+  if (!vertices.buffer || vertices.renderSize != renderSize ||
+      vertices.targetSize != targetSize_) {
+    const float u = static_cast<float>(renderSize.width) / static_cast<float>(targetSize_.width);
+    const float v = static_cast<float>(renderSize.height) / static_cast<float>(targetSize_.height);
+    const float uMax = (static_cast<float>(renderSize.width) - 0.5f) /
+                       static_cast<float>(targetSize_.width);
+    const float vMax = (static_cast<float>(renderSize.height) - 0.5f) /
+                       static_cast<float>(targetSize_.height);
+    // the rendered region starts at the first row of the texture: the bottom one in OpenGL and
+    // the top one in the other backends
+    const bool isBottomUp = device_.getBackendType() == igl::BackendType::OpenGL;
+    const float vBottom = isBottomUp ? 0.0f : v;
+    const float vStep = isBottomUp ? v : -v;
+    // a triangle covering the output
+    const VertexPosUv data[] = {
+        {{-1.0f, -1.0f}, {0.0f, vBottom}, {uMax, vMax}},
+        {{3.0f, -1.0f}, {2.0f * u, vBottom}, {uMax, vMax}},
+        {{-1.0f, 3.0f}, {0.0f, vBottom + 2.0f * vStep}, {uMax, vMax}},
+    };
+    if (!vertices.buffer) {
+      const igl::BufferDesc bufferDesc(igl::BufferDesc::BufferTypeBits::Vertex,
+                                       data,
+                                       sizeof(data),
+                                       igl::ResourceStorage::Shared,
+                                       0,
+                                       "DynamicResolution: vertices");
+      vertices.buffer = device_.createBuffer(bufferDesc, nullptr);
+      if (!IGL_VERIFY(vertices.buffer)) {
+        return;
+      }
+    } else {
+      vertices.buffer->upload(data, igl::BufferRange(sizeof(data), 0));
+    }
+    vertices.renderSize = renderSize;
+    vertices.targetSize = targetSize_;
+  }
+
+  const auto output = outputFramebuffer.getColorAttachment(0);
+  const igl::Dimensions outputSize = output->getDimensions();
+  encoder.bindViewport({0.0f,
+                        0.0f,
+                        static_cast<float>(outputSize.width),
+                        static_cast<float>(outputSize.height),
+                        0.0f,
+                        1.0f});
+  encoder.bindScissorRect(
+      {0, 0, static_cast<uint32_t>(outputSize.width), static_cast<uint32_t>(outputSize.height)});
+  encoder.bindRenderPipelineState(upsamplePipeline_);
+  encoder.bindBuffer(kVertexBufferIndex, igl::BindTarget::kVertex, vertices.buffer, 0);
+  encoder.bindTexture(
+      kTextureUnit, igl::BindTarget::kFragment, framebuffer_->getColorAttachment(0).get());
+  encoder.bindSamplerState(kTextureUnit, igl::BindTarget::kFragment, sampler_.get());
+  encoder.draw(igl::PrimitiveType::Triangle, 0, 3);
+}
+
+} // namespace dynamicresolution
+} // namespace iglu
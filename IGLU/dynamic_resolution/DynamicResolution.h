@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/CommandBuffer.h>
+#include <igl/Device.h>
+#include <igl/Framebuffer.h>
+#include <igl/RenderCommandEncoder.h>
+#include <igl/TimestampQueryPool.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace dynamicresolution {
+
+struct DynamicResolutionConfig {
+  // GPU time of the scene, in milliseconds, the scale is adjusted to stay within
+  double gpuBudgetMs = 12.0;
+  // the scene is rendered at [minScale, maxScale] times the output size in each dimension
+  float minScale = 0.5f;
+  float maxScale = 1.0f;
+  // the largest change of the scale from one measurement to the next
+  float maxScaleStep = 0.1f;
+  // the scale only grows when the GPU time is below this fraction of the budget, so it does not
+  // oscillate around the budget
+  float increaseThreshold = 0.85f;
+  // no more than this number of frames can be in flight on the GPU
+  uint32_t numFramesInFlight = 3;
+  igl::TextureFormat colorFormat = igl::TextureFormat::RGBA_UNorm8;
+  // added to the usage of the color target, e.g. to upscale it with a compute shader
+  igl::TextureDesc::TextureUsage extraColorUsage = 0;
+  // igl::TextureFormat::Invalid if the scene is rendered without depth
+  igl::TextureFormat depthFormat = igl::TextureFormat::Z_UNorm24;
+};
+
+/// Keeps the GPU time of a scene within a budget by changing the resolution it is rendered at.
+///
+/// The scene is rendered into an offscreen target allocated at maxScale times the output size, and
+/// only its top-left getRenderSize() region is used, so changing the scale does not reallocate
+/// anything. The GPU time between beginScene() and endScene() is measured with timestamp queries
+/// and read back without stalling a few frames later; each measurement adjusts the scale for the
+/// next frames. upsample() then stretches the rendered region over the output.
+///
+/// Requires igl::DeviceFeatures::TimestampQueries to adjust the scale; without it, the scene is
+/// always rendered at maxScale.
+///
+/// Usage per frame:
+///   controller.beginScene(*commandBuffer, outputSize);
+///   ... render passes into getFramebuffer(), with getViewport() and getScissorRect() ...
+///   controller.endScene(*commandBuffer);
+///   ... begin a render pass into the output, then controller.upsample(*encoder, *output) ...
+class DynamicResolution final {
+ public:
+  DynamicResolution(igl::IDevice& device, DynamicResolutionConfig config);
+  ~DynamicResolution();
+
+  DynamicResolution(const DynamicResolution&) = delete;
+  DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+  /// Reads back the GPU time of earlier frames, updates the scale and resizes the target to
+  /// `outputSize` if needed. Must be called between encoders, before the scene is encoded.
+  void beginScene(igl::ICommandBuffer& commandBuffer, const igl::Dimensions& outputSize);
+  /// Must be called between encoders, after the scene is encoded.
+  void endScene(igl::ICommandBuffer& commandBuffer);
+  /// Draws the rendered region of the scene over the whole of `outputFramebuffer`, which is the
+  /// framebuffer `encoder` renders into.
+  void upsample(igl::IRenderCommandEncoder& encoder, const igl::IFramebuffer& outputFramebuffer);
+
+  /// The target of the scene, valid after beginScene()
+  [[nodiscard]] const std::shared_ptr<igl::IFramebuffer>& getFramebuffer() const {
+    return framebuffer_;
+  }
+  /// The region of getFramebuffer() the scene is rendered into this frame
+  [[nodiscard]] igl::Viewport getViewport() const;
+  [[nodiscard]] igl::ScissorRect getScissorRect() const;
+  [[nodiscard]] igl::Dimensions getRenderSize() const;
+  [[nodiscard]] float getScale() const {
+    return scale_;
+  }
+  /// The most recent GPU time of the scene in milliseconds, or 0 if none was measured yet
+  [[nodiscard]] double getLastGpuTimeMs() const {
+    return lastGpuTimeMs_;
+  }
+
+  /// Returns the scale which brings a scene taking `gpuTimeMs` at `scale` towards the budget. The
+  /// GPU time of a scene is assumed to be proportional to its number of pixels.
+  [[nodiscard]] static float computeScale(float scale,
+                                          double gpuTimeMs,
+                                          const DynamicResolutionConfig& config);
+
+ private:
+  void readTimestamps();
+  bool createTarget(const igl::Dimensions& outputSize);
+  bool createUpsamplePipeline(const igl::IFramebuffer& outputFramebuffer);
+
+ private:
+  igl::IDevice& device_;
+  const DynamicResolutionConfig config_;
+
+  float scale_;
+  double lastGpuTimeMs_ = 0.0;
+
+  igl::Dimensions outputSize_ = igl::Dimensions(0, 0, 0);
+  igl::Dimensions targetSize_ = igl::Dimensions(0, 0, 0);
+  std::shared_ptr<igl::IFramebuffer> framebuffer_;
+
+  // two timestamps per frame in flight
+  std::shared_ptr<igl::ITimestampQueryPool> queryPool_;
+  struct FrameQueries {
+    bool isPending = false;
+    float scale = 0.0f;
+  };
+  std::vector<FrameQueries> frameQueries_;
+  uint32_t frameIndex_ = 0;
+  // the index into frameQueries_ and upsampleVertices_ of the current frame
+  uint32_t currentFrame_ = 0;
+  bool isTimingFrame_ = false;
+
+  // one vertex buffer per frame in flight, since the texture coordinates depend on the scale
+  struct UpsampleVertices {
+    std::shared_ptr<igl::IBuffer> buffer;
+    igl::Dimensions renderSize = igl::Dimensions(0, 0, 0);
+    igl::Dimensions targetSize = igl::Dimensions(0, 0, 0);
+  };
+  std::vector<UpsampleVertices> upsampleVertices_;
+  std::shared_ptr<igl::IVertexInputState> vertexInput_;
+  std::shared_ptr<igl::IShaderStages> shaderStages_;
+  std::shared_ptr<igl::ISamplerState> sampler_;
+  std::shared_ptr<igl::IRenderPipelineState> upsamplePipeline_;
+  igl::TextureFormat upsampleColorFormat_ = igl::TextureFormat::Invalid;
+  igl::TextureFormat upsampleDepthFormat_ = igl::TextureFormat::Invalid;
+};
+
+} // namespace dynamicresolution
+} // namespace iglu
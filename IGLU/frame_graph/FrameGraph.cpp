@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "FrameGraph.h"
+
+#include <algorithm>
+#include <igl/Common.h>
+
+namespace iglu {
+namespace framegraph {
+
+namespace {
+// pooled textures are shared by transient textures with different names
+igl::TextureDesc getPoolKey(igl::TextureDesc desc) {
+  desc.debugName.clear();
+  return desc;
+}
+} // namespace
+
+TextureHandle PassBuilder::create(const std::string& name, const igl::TextureDesc& desc) {
+  graph_.textures_.push_back({name, desc, nullptr, false});
+  const TextureHandle texture{static_cast<uint32_t>(graph_.textures_.size() - 1)};
+  return write(texture);
+}
+
+TextureHandle PassBuilder::read(TextureHandle texture) {
+  IGL_ASSERT(texture.isValid() && texture.index < graph_.textures_.size());
+  graph_.passes_[passIndex_].reads.push_back(texture);
+  return texture;
+}
+
+TextureHandle PassBuilder::write(TextureHandle texture) {
+  IGL_ASSERT(texture.isValid() && texture.index < graph_.textures_.size());
+  graph_.passes_[passIndex_].writes.push_back(texture);
+  return texture;
+}
+
+void PassBuilder::setSideEffect() {
+  graph_.passes_[passIndex_].hasSideEffect = true;
+}
+
+const std::shared_ptr<igl::ITexture>& PassResources::getTexture(TextureHandle texture) const {
+  IGL_ASSERT_MSG(graph_.uses(passIndex_, texture),
+                 "The texture was not declared by the setup function of this pass");
+  return graph_.textures_[texture.index].texture;
+}
+
+TextureHandle FrameGraph::importTexture(const std::string& name,
+                                        std::shared_ptr<igl::ITexture> texture) {
+  IGL_ASSERT(texture != nullptr);
+  textures_.push_back({name, igl::TextureDesc{}, std::move(texture), true});
+  return {static_cast<uint32_t>(textures_.size() - 1)};
+}
+
+void FrameGraph::addPass(const std::string& name,
+                         const PassSetupFunc& setup,
+                         PassExecuteFunc execute) {
+  IGL_ASSERT_MSG(!isCompiled_, "Passes cannot be added after compile()");
+  passes_.push_back({name, std::move(execute), {}, {}, false, false});
+  PassBuilder builder(*this, static_cast<uint32_t>(passes_.size() - 1));
+  if (setup) {
+    setup(builder);
+  }
+}
+
+igl::Result FrameGraph::compile() {
+  // walk the passes backwards: a pass is needed if a later needed pass reads what it writes
+  std::vector<bool> isNeeded(textures_.size(), false);
+  for (size_t i = 0; i != textures_.size(); i++) {
+    isNeeded[i] = textures_[i].isImported;
+  }
+  for (auto pass = passes_.rbegin(); pass != passes_.rend(); ++pass) {
+    pass->isCulled = !pass->hasSideEffect &&
+                     std::none_of(pass->writes.begin(), pass->writes.end(), [&](TextureHandle t) {
+                       return isNeeded[t.index];
+                     });
+    if (!pass->isCulled) {
+      for (const TextureHandle texture : pass->reads) {
+        isNeeded[texture.index] = true;
+      }
+    }
+  }
+
+  // lifetimes of the transient textures over the kept passes
+  std::vector<bool> isUsed(textures_.size(), false);
+  for (uint32_t passIndex = 0; passIndex != passes_.size(); passIndex++) {
+    const Pass& pass = passes_[passIndex];
+    if (pass.isCulled) {
+      continue;
+    }
+    for (const auto* handles : {&pass.reads, &pass.writes}) {
+      for (const TextureHandle handle : *handles) {
+        Texture& texture = textures_[handle.index];
+        if (!isUsed[handle.index]) {
+          isUsed[handle.index] = true;
+          texture.firstPass = passIndex;
+          if (!texture.isImported && std::find_if(pass.writes.begin(),
+                                                  pass.writes.end(),
+                                                  [handle](TextureHandle t) {
+                                                    return t.index == handle.index;
+                                                  }) == pass.writes.end()) {
+            return igl::Result(igl::Result::Code::InvalidOperation,
+                               "Transient texture '" + texture.name +
+                                   "' is read by pass '" + pass.name + "' before it is written");
+          }
+        }
+        texture.lastPass = passIndex;
+      }
+    }
+  }
+
+  isCompiled_ = true;
+  return igl::Result();
+}
+
+igl::Result FrameGraph::execute(igl::ICommandQueue& commandQueue) {
+  if (!isCompiled_) {
+    const igl::Result result = compile();
+    if (!result.isOk()) {
+      return result;
+    }
+  }
+
+  igl::Result result;
+  auto commandBuffer = commandQueue.createCommandBuffer(igl::CommandBufferDesc{}, &result);
+  if (!result.isOk()) {
+    return result;
+  }
+
+  for (uint32_t passIndex = 0; passIndex != passes_.size(); passIndex++) {
+    Pass& pass = passes_[passIndex];
+    if (pass.isCulled) {
+      continue;
+    }
+    // transient textures start their lifetime at their first pass...
+    for (const TextureHandle handle : pass.writes) {
+      Texture& texture = textures_[handle.index];
+      if (!texture.isImported && texture.firstPass == passIndex && !texture.texture) {
+        texture.texture = acquireTexture(texture.desc, &result);
+        if (!result.isOk()) {
+          return result;
+        }
+      }
+    }
+
+    if (!pass.name.empty()) {
+      commandBuffer->pushDebugGroupLabel(pass.name);
+    }
+    if (pass.execute) {
+      pass.execute(PassResources(*this, passIndex), *commandBuffer);
+    }
+    if (!pass.name.empty()) {
+      commandBuffer->popDebugGroupLabel();
+    }
+
+    // ...and hand their texture over to other transient textures after their last pass
+    for (const auto* handles : {&pass.reads, &pass.writes}) {
+      for (const TextureHandle handle : *handles) {
+        Texture& texture = textures_[handle.index];
+        if (!texture.isImported && texture.lastPass == passIndex && texture.texture) {
+          releaseTexture(texture.texture);
+        }
+      }
+    }
+  }
+
+  commandQueue.submit(*commandBuffer);
+  return igl::Result();
+}
+
+void FrameGraph::reset() {
+  textures_.clear();
+  passes_.clear();
+  isCompiled_ = false;
+
+  pool_.erase(std::remove_if(pool_.begin(),
+                             pool_.end(),
+                             [](const PooledTexture& pooled) { return !pooled.wasUsed; }),
+              pool_.end());
+  for (auto& pooled : pool_) {
+    pooled.isInUse = false;
+    pooled.wasUsed = false;
+  }
+}
+
+uint32_t FrameGraph::getNumCulledPasses() const {
+  return static_cast<uint32_t>(std::count_if(
+      passes_.begin(), passes_.end(), [](const Pass& pass) { return pass.isCulled; }));
+}
+
+bool FrameGraph::uses(uint32_t passIndex, TextureHandle texture) const {
+  const Pass& pass = passes_[passIndex];
+  const auto matches = [texture](TextureHandle t) { return t.index == texture.index; };
+  return std::any_of(pass.reads.begin(), pass.reads.end(), matches) ||
+         std::any_of(pass.writes.begin(), pass.writes.end(), matches);
+}
+
+std::shared_ptr<igl::ITexture> FrameGraph::acquireTexture(const igl::TextureDesc& desc,
+                                                          igl::Result* outResult) {
+  const igl::TextureDesc key = getPoolKey(desc);
+  for (auto& pooled : pool_) {
+    if (!pooled.isInUse && pooled.desc == key) {
+      pooled.isInUse = true;
+      pooled.wasUsed = true;
+      igl::Result::setOk(outResult);
+      return pooled.texture;
+    }
+  }
+
+  auto texture = device_.createTexture(desc, outResult);
+  if (!texture) {
+    return nullptr;
+  }
+  pool_.push_back({texture, key, true, true});
+  return texture;
+}
+
+void FrameGraph::releaseTexture(const std::shared_ptr<igl::ITexture>& texture) {
+  for (auto& pooled : pool_) {
+    if (pooled.texture == texture) {
+      pooled.isInUse = false;
+      return;
+    }
+  }
+}
+
+} // namespace framegraph
+} // namespace iglu
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <functional>
+#include <igl/CommandBuffer.h>
+#include <igl/CommandQueue.h>
+#include <igl/Device.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace framegraph {
+
+/// A texture of a FrameGraph; only valid for the graph which created it until the next reset()
+struct TextureHandle {
+  static constexpr uint32_t kInvalid = 0xFFFFFFFF;
+  uint32_t index = kInvalid;
+
+  [[nodiscard]] bool isValid() const {
+    return index != kInvalid;
+  }
+};
+
+class FrameGraph;
+
+/// Declares the textures a pass uses while it is added to a FrameGraph
+class PassBuilder final {
+ public:
+  /// A transient texture which only lives within this frame. It is created when the first pass
+  /// using it executes and its memory may be reused by other transient textures afterwards.
+  TextureHandle create(const std::string& name, const igl::TextureDesc& desc);
+  /// The pass samples or loads `texture`
+  TextureHandle read(TextureHandle texture);
+  /// The pass renders into or stores to `texture`
+  TextureHandle write(TextureHandle texture);
+  /// The pass has effects outside of the graph (e.g. presenting or reading back) and is never
+  /// culled
+  void setSideEffect();
+
+ private:
+  friend class FrameGraph;
+  PassBuilder(FrameGraph& graph, uint32_t passIndex) : graph_(graph), passIndex_(passIndex) {}
+
+  FrameGraph& graph_;
+  uint32_t passIndex_;
+};
+
+/// Gives the execute function of a pass access to the textures it declared
+class PassResources final {
+ public:
+  [[nodiscard]] const std::shared_ptr<igl::ITexture>& getTexture(TextureHandle texture) const;
+
+ private:
+  friend class FrameGraph;
+  PassResources(const FrameGraph& graph, uint32_t passIndex) :
+    graph_(graph), passIndex_(passIndex) {}
+
+  const FrameGraph& graph_;
+  uint32_t passIndex_;
+};
+
+using PassSetupFunc = std::function<void(PassBuilder& builder)>;
+using PassExecuteFunc =
+    std::function<void(const PassResources& resources, igl::ICommandBuffer& commandBuffer)>;
+
+/**
+ * @brief Schedules the render and compute passes of a frame from the textures they read and write.
+ *
+ * Passes are added in submission order with a setup function declaring their textures and an
+ * execute function recording their commands through igl::ICommandBuffer, so the graph drives all
+ * backends. compile() culls the passes whose results are never used: a pass is kept if it has a
+ * side effect, writes an imported texture or writes a texture read by a kept pass. Transient
+ * textures are allocated for their lifetime only, so textures with the same description and
+ * disjoint lifetimes share one igl::ITexture, and the textures are pooled across frames.
+ *
+ * All passes are recorded into one command buffer in order. Layout transitions and barriers are
+ * left to the backends, which derive them from the encoders' attachments and bindings; a single
+ * command buffer lets them see every dependency between passes.
+ */
+class FrameGraph final {
+ public:
+  explicit FrameGraph(igl::IDevice& device) : device_(device) {}
+
+  /// A texture owned outside of the graph, e.g. the swapchain texture. Passes writing imported
+  /// textures are never culled.
+  TextureHandle importTexture(const std::string& name, std::shared_ptr<igl::ITexture> texture);
+
+  void addPass(const std::string& name, const PassSetupFunc& setup, PassExecuteFunc execute);
+
+  /// Culls unused passes and computes the lifetimes of the transient textures
+  igl::Result compile();
+
+  /// Allocates the transient textures, records all passes which were not culled and submits them
+  igl::Result execute(igl::ICommandQueue& commandQueue);
+
+  /// Removes all passes and textures while keeping the pooled transient textures for the next
+  /// frame. Pooled textures which were not used by this frame are released.
+  void reset();
+
+  [[nodiscard]] uint32_t getNumPasses() const {
+    return static_cast<uint32_t>(passes_.size());
+  }
+  [[nodiscard]] uint32_t getNumCulledPasses() const;
+  /// Number of textures in the pool, i.e. the textures backing all transient textures
+  [[nodiscard]] uint32_t getNumPooledTextures() const {
+    return static_cast<uint32_t>(pool_.size());
+  }
+
+ private:
+  friend class PassBuilder;
+  friend class PassResources;
+
+  struct Texture {
+    std::string name;
+    igl::TextureDesc desc;
+    std::shared_ptr<igl::ITexture> texture; // set for imported textures and while executing
+    bool isImported = false;
+    // the first and last kept pass using this texture
+    uint32_t firstPass = 0;
+    uint32_t lastPass = 0;
+  };
+
+  struct Pass {
+    std::string name;
+    PassExecuteFunc execute;
+    std::vector<TextureHandle> reads;
+    std::vector<TextureHandle> writes;
+    bool hasSideEffect = false;
+    bool isCulled = false;
+  };
+
+  struct PooledTexture {
+    std::shared_ptr<igl::ITexture> texture;
+    igl::TextureDesc desc;
+    bool isInUse = false;
+    bool wasUsed = false; // used by the current frame
+  };
+
+  [[nodiscard]] bool uses(uint32_t passIndex, TextureHandle texture) const;
+  std::shared_ptr<igl::ITexture> acquireTexture(const igl::TextureDesc& desc,
+                                                igl::Result* outResult);
+  void releaseTexture(const std::shared_ptr<igl::ITexture>& texture);
+
+ private:
+  igl::IDevice& device_;
+  std::vector<Texture> textures_;
+  std::vector<Pass> passes_;
+  std::vector<PooledTexture> pool_;
+  bool isCompiled_ = false;
+};
+
+} // namespace framegraph
+} // namespace iglu
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace iglu {
+namespace glsl {
+
+// Helpers for GLSL sources shared by Vulkan and OpenGL which use storage buffers
+
+// The layout qualifier of the storage buffer at `binding`, a number or a GLSL expression. Vulkan
+// puts storage buffers into descriptor set 2.
+inline std::string storageBufferLayout(bool isVulkan, const std::string& binding) {
+  return std::string("layout (") + (isVulkan ? "set = 2, " : "") + "binding = " + binding +
+         ", std430)";
+}
+
+inline std::string storageBufferLayout(bool isVulkan, size_t binding) {
+  return storageBufferLayout(isVulkan, std::to_string(binding));
+}
+
+// #define <name> <the layout qualifier of the storage buffer at `binding`>
+inline std::string defineStorageBuffer(const char* name, bool isVulkan, size_t binding) {
+  return std::string("#define ") + name + " " + storageBufferLayout(isVulkan, binding) + "\n";
+}
+
+// #define <name>(index) <the layout qualifier of the storage buffer at `index`>
+inline std::string defineStorageBufferMacro(const char* name, bool isVulkan) {
+  return std::string("#define ") + name + "(index) " + storageBufferLayout(isVulkan, "index") +
+         "\n";
+}
+
+// The first lines of a compute shader. Vulkan provides its own #version, OpenGL ES 3.1 needs it
+// and a default float precision. A non-zero `threadgroupSize` declares the workgroup size.
+inline std::string computeShaderPrologue(bool isVulkan, uint32_t threadgroupSize = 0) {
+  std::string prologue = isVulkan ? "" : "#version 310 es\nprecision highp float;\n";
+  if (threadgroupSize != 0) {
+    prologue += "layout (local_size_x = " + std::to_string(threadgroupSize) + ") in;\n";
+  }
+  return prologue;
+}
+
+} // namespace glsl
+} // namespace iglu
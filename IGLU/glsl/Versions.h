@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/DeviceFeatures.h>
+#include <string>
+
+namespace iglu {
+namespace glsl {
+
+// The first lines of an OpenGL render shader: its #version and, on OpenGL ES, the default
+// precisions. Shaders reading storage buffers need OpenGL 4.3 or OpenGL ES 3.1, the others OpenGL
+// 3.3 or OpenGL ES 3.0.
+inline std::string getOpenGLVersion(const igl::ShaderVersion& shaderVersion,
+                                    bool usesStorageBuffers = false) {
+  if (shaderVersion.family == igl::ShaderFamily::GlslEs) {
+    return std::string(usesStorageBuffers ? "#version 310 es\n" : "#version 300 es\n") +
+           "precision highp float;\nprecision highp int;\n";
+  }
+  return usesStorageBuffers ? "#version 430\n" : "#version 330\n";
+}
+
+} // namespace glsl
+} // namespace iglu
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "GpuCuller.h"
+
+#include <IGLU/glsl/StorageBuffers.h>
+#include <IGLU/simdtypes/SimdBatch.h>
+#include <igl/ShaderCreator.h>
+#include <string>
+
+namespace iglu {
+namespace gpuculling {
+
+namespace {
+
+constexpr uint32_t kThreadgroupSize = 64;
+
+constexpr size_t kParamsIndex = 0;
+constexpr size_t kInstancesIndex = 1;
+constexpr size_t kCommandsIndex = 2;
+constexpr size_t kVisibleIndex = 3;
+
+// matches the std430 and Metal layouts of the Instance struct in the shaders
+struct Instance {
+  simdtypes::float4 boundingSphere;
+  uint32_t meshIndex;
+  uint32_t padding[3];
+};
+static_assert(sizeof(Instance) == 32, "Instance must match the shader layout");
+
+const char kGlslBody[] = R"(
+struct Instance {
+  vec4 boundingSphere;
+  uint meshIndex;
+  uint padding[3];
+};
+
+struct DrawCommand {
+  uint count;
+  uint instanceCount;
+  uint firstIndex;
+  int baseVertex;
+  uint baseInstance;
+};
+
+PARAMS_BUFFER readonly buffer Params {
+  vec4 planes[6];
+  uint numInstances;
+} params;
+INSTANCES_BUFFER readonly buffer Instances {
+  Instance instances[];
+};
+COMMANDS_BUFFER buffer Commands {
+  DrawCommand commands[];
+};
+VISIBLE_BUFFER writeonly buffer Visible {
+  uint visible[];
+};
+
+void main() {
+  uint id = gl_GlobalInvocationID.x;
+  if (id >= params.numInstances) {
+    return;
+  }
+  vec4 sphere = instances[id].boundingSphere;
+  for (int i = 0; i < 6; i++) {
+    if (dot(params.planes[i].xyz, sphere.xyz) + params.planes[i].w < -sphere.w) {
+      return;
+    }
+  }
+  uint meshIndex = instances[id].meshIndex;
+  uint slot = atomicAdd(commands[meshIndex].instanceCount, 1u);
+  visible[commands[meshIndex].baseInstance + slot] = id;
+}
+)";
+
+std::string getGlslSource(bool isVulkan) {
+  return glsl::computeShaderPrologue(isVulkan, kThreadgroupSize) +
+         glsl::defineStorageBuffer("PARAMS_BUFFER", isVulkan, kParamsIndex) +
+         glsl::defineStorageBuffer("INSTANCES_BUFFER", isVulkan, kInstancesIndex) +
+         glsl::defineStorageBuffer("COMMANDS_BUFFER", isVulkan, kCommandsIndex) +
+         glsl::defineStorageBuffer("VISIBLE_BUFFER", isVulkan, kVisibleIndex) + kGlslBody;
+}
+
+const char kMetalSource[] = R"(
+#include <metal_stdlib>
+using namespace metal;
+
+struct Instance {
+  float4 boundingSphere;
+  uint meshIndex;
+  uint padding[3];
+};
+
+struct DrawCommand {
+  uint count;
+  atomic_uint instanceCount;
+  uint firstIndex;
+  int baseVertex;
+  uint baseInstance;
+};
+
+struct Params {
+  float4 planes[6];
+  uint numInstances;
+};
+
+kernel void cullInstances(constant Params& params [[buffer(0)]],
+                          const device Instance* instances [[buffer(1)]],
+                          device DrawCommand* commands [[buffer(2)]],
+                          device uint* visible [[buffer(3)]],
+                          uint id [[thread_position_in_grid]]) {
+  if (id >= params.numInstances) {
+    return;
+  }
+  const float4 sphere = instances[id].boundingSphere;
+  for (int i = 0; i < 6; i++) {
+    if (dot(params.planes[i].xyz, sphere.xyz) + params.planes[i].w < -sphere.w) {
+      return;
+    }
+  }
+  const uint meshIndex = instances[id].meshIndex;
+  const uint slot =
+      atomic_fetch_add_explicit(&commands[meshIndex].instanceCount, 1u, memory_order_relaxed);
+  visible[commands[meshIndex].baseInstance + slot] = id;
+}
+)";
+
+std::shared_ptr<igl::IBuffer> createBuffer(igl::IDevice& device,
+                                           igl::BufferDesc::BufferType type,
+                                           const void* data,
+                                           size_t length,
+                                           bool isPerFrame,
+                                           const char* debugName,
+                                           igl::Result* outResult) {
+  igl::BufferDesc desc(type, data, length, igl::ResourceStorage::Shared);
+  if (isPerFrame && device.hasFeature(igl::DeviceFeatures::BufferRing)) {
+    // cull() refills the params, commands and visible instances of each frame in flight
+    desc.hint |= igl::BufferDesc::BufferAPIHintBits::Ring;
+  }
+  desc.debugName = debugName;
+  return device.createBuffer(desc, outResult);
+}
+
+} // namespace
+
+GpuCuller::GpuCuller(igl::IDevice& device,
+                     const std::vector<MeshDesc>& meshes,
+                     const std::vector<InstanceDesc>& instances,
+                     igl::Result* outResult) :
+  numInstances_(static_cast<uint32_t>(instances.size())) {
+  if (!device.hasFeature(igl::DeviceFeatures::Compute) ||
+      !device.hasFeature(igl::DeviceFeatures::DrawIndexedIndirect)) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::Unsupported,
+                           "GPU culling requires compute and indirect draws");
+    return;
+  }
+  if (meshes.empty() || instances.empty()) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "No meshes or instances to cull");
+    return;
+  }
+
+  // each mesh owns the range of the visible instance buffer its instances may be written to
+  std::vector<Instance> instanceData(instances.size());
+  commands_.resize(meshes.size());
+  for (size_t i = 0; i != instances.size(); i++) {
+    if (!IGL_VERIFY(instances[i].meshIndex < meshes.size())) {
+      igl::Result::setResult(
+          outResult, igl::Result::Code::ArgumentOutOfRange, "Invalid mesh index of an instance");
+      return;
+    }
+    instanceData[i] = {instances[i].boundingSphere, instances[i].meshIndex, {}};
+    commands_[instances[i].meshIndex].baseInstance++;
+  }
+  uint32_t baseInstance = 0;
+  for (size_t i = 0; i != meshes.size(); i++) {
+    const uint32_t numMeshInstances = commands_[i].baseInstance;
+    commands_[i] = {meshes[i].numIndices, 0, meshes[i].firstIndex, meshes[i].baseVertex,
+                    baseInstance};
+    baseInstance += numMeshInstances;
+  }
+
+  igl::Result result;
+  instanceBuffer_ = createBuffer(device,
+                                 igl::BufferDesc::BufferTypeBits::Storage,
+                                 instanceData.data(),
+                                 instanceData.size() * sizeof(Instance),
+                                 false,
+                                 "GpuCuller instances",
+                                 &result);
+  if (result.isOk()) {
+    paramsBuffer_ = createBuffer(device,
+                                 igl::BufferDesc::BufferTypeBits::Storage,
+                                 nullptr,
+                                 sizeof(Params),
+                                 true,
+                                 "GpuCuller params",
+                                 &result);
+  }
+  if (result.isOk()) {
+    commandBuffer_ = createBuffer(device,
+                                  igl::BufferDesc::BufferTypeBits::Storage |
+                                      igl::BufferDesc::BufferTypeBits::Indirect,
+                                  commands_.data(),
+                                  commands_.size() * sizeof(DrawCommand),
+                                  true,
+                                  "GpuCuller commands",
+                                  &result);
+  }
+  if (result.isOk()) {
+    visibleBuffer_ = createBuffer(device,
+                                  igl::BufferDesc::BufferTypeBits::Storage |
+                                      igl::BufferDesc::BufferTypeBits::Vertex,
+                                  nullptr,
+                                  instances.size() * sizeof(uint32_t),
+                                  true,
+                                  "GpuCuller visible instances",
+                                  &result);
+  }
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  const auto backendType = device.getBackendType();
+  const std::string glslSource = getGlslSource(backendType == igl::BackendType::Vulkan);
+  const bool isMetal = backendType == igl::BackendType::Metal;
+  std::shared_ptr<igl::IShaderStages> stages =
+      igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                      isMetal ? kMetalSource : glslSource.c_str(),
+                                                      isMetal ? "cullInstances" : "main",
+                                                      "GpuCuller",
+                                                      &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  igl::ComputePipelineDesc desc;
+  desc.shaderStages = std::move(stages);
+  desc.buffersMap[kParamsIndex] = igl::genNameHandle("Params");
+  desc.buffersMap[kInstancesIndex] = igl::genNameHandle("Instances");
+  desc.buffersMap[kCommandsIndex] = igl::genNameHandle("Commands");
+  desc.buffersMap[kVisibleIndex] = igl::genNameHandle("Visible");
+  desc.debugName = "GpuCuller";
+  pipelineState_ = device.createComputePipeline(desc, outResult);
+}
+
+void GpuCuller::cull(igl::ICommandBuffer& commandBuffer,
+                     const simdtypes::float4x4& viewProjection,
+                     bool zeroToOneDepth) {
+  if (!IGL_VERIFY(pipelineState_)) {
+    return;
+  }
+
+  Params params = {};
+  simdtypes::getFrustumPlanes(viewProjection, zeroToOneDepth, params.planes);
+  params.numInstances = numInstances_;
+  paramsBuffer_->upload(&params, {sizeof(params), 0});
+  // the dispatch counts the visible instances of each command from 0
+  commandBuffer_->upload(commands_.data(), {commands_.size() * sizeof(DrawCommand), 0});
+
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("GpuCuller::cull()");
+  encoder->bindComputePipelineState(pipelineState_);
+  encoder->bindBuffer(kParamsIndex, paramsBuffer_, 0);
+  encoder->bindBuffer(kInstancesIndex, instanceBuffer_, 0);
+  encoder->bindBuffer(kCommandsIndex, commandBuffer_, 0);
+  encoder->bindBuffer(kVisibleIndex, visibleBuffer_, 0);
+  encoder->dispatchThreadGroups(
+      igl::Dimensions((numInstances_ + kThreadgroupSize - 1) / kThreadgroupSize, 1, 1),
+      igl::Dimensions(kThreadgroupSize, 1, 1));
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+void GpuCuller::draw(igl::IRenderCommandEncoder& commandEncoder,
+                     igl::PrimitiveType primitiveType,
+                     igl::IndexFormat indexFormat,
+                     igl::IBuffer& indexBuffer) const {
+  if (!IGL_VERIFY(commandBuffer_)) {
+    return;
+  }
+  commandEncoder.multiDrawIndexedIndirect(primitiveType,
+                                          indexFormat,
+                                          indexBuffer,
+                                          *commandBuffer_,
+                                          0,
+                                          static_cast<uint32_t>(commands_.size()),
+                                          sizeof(DrawCommand));
+}
+
+} // namespace gpuculling
+} // namespace iglu
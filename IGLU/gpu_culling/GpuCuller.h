@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace gpuculling {
+
+/// A range of the shared index buffer drawn by all instances of a mesh
+struct MeshDesc {
+  uint32_t numIndices = 0;
+  uint32_t firstIndex = 0;
+  int32_t baseVertex = 0;
+};
+
+/// An instance of a mesh with its world space bounding sphere (center, radius)
+struct InstanceDesc {
+  simdtypes::float4 boundingSphere = {};
+  uint32_t meshIndex = 0;
+};
+
+/**
+ * @brief Culls instances on the GPU and draws the visible ones with a single multi-draw.
+ *
+ * The instances are uploaded once. Every frame, cull() records a compute dispatch which tests
+ * each instance against the view frustum and appends the visible ones to the indirect draw
+ * command of their mesh: the instance count of the command grows and the index of the instance
+ * is written to the visible instance buffer at the command's base instance. draw() then issues
+ * one multiDrawIndexedIndirect() with one command per mesh, so the CPU cost of drawing does not
+ * depend on the number of instances. Meshes without visible instances are drawn with an instance
+ * count of 0. There is no indirect draw count in IGL, so empty commands are not compacted away.
+ *
+ * Vertex shaders find the instance they draw through the visible instance buffer. Bind it as a
+ * per-instance vertex buffer with one uint32_t per instance, which the base instance of each
+ * command offsets on all backends. On Vulkan and Metal the buffer can also be read as a storage
+ * buffer, indexed by the instance index, which includes the base instance.
+ *
+ * Requires igl::DeviceFeatures::Compute and igl::DeviceFeatures::DrawIndexedIndirect. On OpenGL,
+ * base instances need desktop OpenGL 4.3; OpenGL ES ignores them.
+ */
+class GpuCuller final {
+ public:
+  GpuCuller(igl::IDevice& device,
+            const std::vector<MeshDesc>& meshes,
+            const std::vector<InstanceDesc>& instances,
+            igl::Result* outResult);
+
+  /// Records the culling dispatch into 'commandBuffer'. Must be called outside of render passes
+  /// and before the render pass calling draw() in the same command buffer. 'zeroToOneDepth' is
+  /// true for clip spaces with a depth range of [0, 1] (Metal, Vulkan) and false for [-1, 1]
+  /// (OpenGL).
+  void cull(igl::ICommandBuffer& commandBuffer,
+            const simdtypes::float4x4& viewProjection,
+            bool zeroToOneDepth);
+
+  /// Draws the instances which passed the last cull() with the indices of 'indexBuffer'.
+  void draw(igl::IRenderCommandEncoder& commandEncoder,
+            igl::PrimitiveType primitiveType,
+            igl::IndexFormat indexFormat,
+            igl::IBuffer& indexBuffer) const;
+
+  /// One uint32_t per instance: the indices of the visible instances of each mesh, starting at
+  /// the base instance of the mesh's draw command.
+  [[nodiscard]] const std::shared_ptr<igl::IBuffer>& getVisibleInstanceBuffer() const {
+    return visibleBuffer_;
+  }
+
+  /// One draw command of igl::IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE bytes per mesh.
+  [[nodiscard]] const std::shared_ptr<igl::IBuffer>& getIndirectBuffer() const {
+    return commandBuffer_;
+  }
+
+  [[nodiscard]] uint32_t getNumMeshes() const {
+    return static_cast<uint32_t>(commands_.size());
+  }
+
+ private:
+  struct DrawCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+  };
+  static_assert(sizeof(DrawCommand) == igl::IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE,
+                "DrawCommand must match the indirect draw command layout");
+
+  struct Params {
+    simdtypes::float4 planes[6];
+    uint32_t numInstances;
+    uint32_t padding[3];
+  };
+
+  std::shared_ptr<igl::IComputePipelineState> pipelineState_;
+  std::shared_ptr<igl::IBuffer> paramsBuffer_;
+  std::shared_ptr<igl::IBuffer> instanceBuffer_;
+  std::shared_ptr<igl::IBuffer> commandBuffer_;
+  std::shared_ptr<igl::IBuffer> visibleBuffer_;
+  // the commands with an instance count of 0, uploaded before each dispatch
+  std::vector<DrawCommand> commands_;
+  uint32_t numInstances_ = 0;
+};
+
+} // namespace gpuculling
+} // namespace iglu
@@ -0,0 +1,646 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "GpuDecompression.h"
+
+#include <IGLU/glsl/StorageBuffers.h>
+#include <algorithm>
+#include <cstring>
+#include <igl/ShaderCreator.h>
+#include <string>
+
+namespace iglu {
+namespace gpudecompression {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x5a4c4749; // "IGLZ"
+constexpr uint32_t kVersion = 1;
+// set in the size of a chunk which is stored as is
+constexpr uint32_t kStoredBit = 0x80000000;
+
+// the constants of the LZ4 block format
+constexpr uint32_t kMinMatch = 4;
+constexpr uint32_t kLastLiterals = 5;
+// no match starts in the last 12 bytes of a block
+constexpr uint32_t kMatchSearchLimit = 12;
+constexpr uint32_t kMaxOffset = 65535;
+
+constexpr uint32_t kHashBits = 12;
+constexpr uint32_t kThreadgroupSize = 64;
+// the words of the staging buffer before the payload: the offset of the destination in words
+constexpr uint32_t kParamsWords = 4;
+
+// OpenGL binds the storage blocks of compute shaders by their resource index, which follows the
+// names of the blocks
+constexpr size_t kCompressedIndex = 0;
+constexpr size_t kDecompressedIndex = 1;
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t uncompressedSize;
+  uint32_t chunkSize;
+  uint32_t numChunks;
+};
+
+// followed by the chunks
+struct ChunkEntry {
+  // in bytes, from the start of the payload
+  uint32_t offset;
+  // the compressed bytes, with kStoredBit if the chunk is stored
+  uint32_t size;
+};
+
+// One thread decodes one chunk. The bytes are gathered into words which are written once
+// complete; the destination is only readable as words.
+const char kGlslBody[] = R"(
+COMPRESSED_BUFFER readonly buffer Compressed {
+  uint compressed[];
+};
+DECOMPRESSED_BUFFER buffer Decompressed {
+  uint decompressed[];
+};
+
+// byte 'i' of the payload
+uint readByte(uint i) {
+  i += PARAMS_BYTES;
+  return (compressed[i >> 2u] >> ((i & 3u) * 8u)) & 0xFFu;
+}
+
+uint firstWord = 0u;
+uint outPos = 0u;
+uint pending = 0u;
+
+void writeByte(uint value) {
+  pending |= value << ((outPos & 3u) * 8u);
+  outPos++;
+  if ((outPos & 3u) == 0u) {
+    decompressed[firstWord + (outPos >> 2u) - 1u] = pending;
+    pending = 0u;
+  }
+}
+
+// a byte of the chunk written before
+uint readOutputByte(uint i) {
+  uint word = (i >> 2u) == (outPos >> 2u) ? pending : decompressed[firstWord + (i >> 2u)];
+  return (word >> ((i & 3u) * 8u)) & 0xFFu;
+}
+
+// the extension bytes of a length
+uint readLength(inout uint inPos, uint inEnd) {
+  uint length = 0u;
+  uint value = 255u;
+  while (value == 255u && inPos < inEnd) {
+    value = readByte(inPos++);
+    length += value;
+  }
+  return length;
+}
+
+void main() {
+  uint chunk = gl_GlobalInvocationID.x;
+  // the header of the payload: magic, version, uncompressed size, chunk size, number of chunks
+  uint size = compressed[PARAMS_WORDS + 2u];
+  uint chunkSize = compressed[PARAMS_WORDS + 3u];
+  if (chunk >= compressed[PARAMS_WORDS + 4u]) {
+    return;
+  }
+  uint inPos = compressed[PARAMS_WORDS + 5u + 2u * chunk];
+  uint inSize = compressed[PARAMS_WORDS + 6u + 2u * chunk];
+  uint inEnd = inPos + (inSize & 0x7FFFFFFFu);
+  uint outEnd = min(chunkSize, size - chunk * chunkSize);
+  firstWord = compressed[0] + chunk * (chunkSize >> 2u);
+
+  if ((inSize & 0x80000000u) != 0u) {
+    while (outPos < outEnd) {
+      writeByte(readByte(inPos + outPos));
+    }
+  } else {
+    while (inPos < inEnd && outPos < outEnd) {
+      uint token = readByte(inPos++);
+      uint numLiterals = token >> 4u;
+      if (numLiterals == 15u) {
+        numLiterals += readLength(inPos, inEnd);
+      }
+      numLiterals = min(numLiterals, min(inEnd - inPos, outEnd - outPos));
+      for (uint i = 0u; i < numLiterals; i++) {
+        writeByte(readByte(inPos++));
+      }
+      // the last sequence has no match
+      if (inEnd - inPos < 2u) {
+        break;
+      }
+      uint offset = readByte(inPos) | (readByte(inPos + 1u) << 8u);
+      inPos += 2u;
+      uint matchLength = token & 15u;
+      if (matchLength == 15u) {
+        matchLength += readLength(inPos, inEnd);
+      }
+      if (offset == 0u || offset > outPos) {
+        break;
+      }
+      matchLength = min(matchLength + 4u, outEnd - outPos);
+      for (uint i = 0u; i < matchLength; i++) {
+        writeByte(readOutputByte(outPos - offset));
+      }
+    }
+  }
+  if ((outPos & 3u) != 0u) {
+    decompressed[firstWord + (outPos >> 2u)] = pending;
+  }
+}
+)";
+
+// the staging buffer holds PARAMS_WORDS words of parameters before the payload
+std::string getGlslSource(bool isVulkan) {
+  return glsl::computeShaderPrologue(isVulkan, kThreadgroupSize) +
+         glsl::defineStorageBuffer("COMPRESSED_BUFFER", isVulkan, kCompressedIndex) +
+         glsl::defineStorageBuffer("DECOMPRESSED_BUFFER", isVulkan, kDecompressedIndex) +
+         "#define PARAMS_WORDS " + std::to_string(kParamsWords) + "u\n" + "#define PARAMS_BYTES " +
+         std::to_string(kParamsWords * 4) + "u\n" + kGlslBody;
+}
+
+const char kMetalSource[] = R"(
+#include <metal_stdlib>
+using namespace metal;
+
+constant uint kParamsWords = 4;
+
+// the extension bytes of a length
+inline uint readLength(const device uchar* payload, thread uint& inPos, uint inEnd) {
+  uint length = 0;
+  uint value = 255;
+  while (value == 255 && inPos < inEnd) {
+    value = payload[inPos++];
+    length += value;
+  }
+  return length;
+}
+
+kernel void decompressChunks(const device uint* compressed [[buffer(0)]],
+                             device uchar* decompressed [[buffer(1)]],
+                             uint chunk [[thread_position_in_grid]]) {
+  // the header of the payload: magic, version, uncompressed size, chunk size, number of chunks
+  const uint size = compressed[kParamsWords + 2];
+  const uint chunkSize = compressed[kParamsWords + 3];
+  if (chunk >= compressed[kParamsWords + 4]) {
+    return;
+  }
+  const device uchar* payload = reinterpret_cast<const device uchar*>(compressed + kParamsWords);
+  uint inPos = compressed[kParamsWords + 5 + 2 * chunk];
+  const uint inSize = compressed[kParamsWords + 6 + 2 * chunk];
+  const uint inEnd = inPos + (inSize & 0x7FFFFFFF);
+  const uint outEnd = min(chunkSize, size - chunk * chunkSize);
+  device uchar* out = decompressed + 4 * compressed[0] + chunk * chunkSize;
+
+  if ((inSize & 0x80000000) != 0) {
+    for (uint i = 0; i < outEnd; i++) {
+      out[i] = payload[inPos + i];
+    }
+    return;
+  }
+  uint outPos = 0;
+  while (inPos < inEnd && outPos < outEnd) {
+    const uint token = payload[inPos++];
+    uint numLiterals = token >> 4;
+    if (numLiterals == 15) {
+      numLiterals += readLength(payload, inPos, inEnd);
+    }
+    numLiterals = min(numLiterals, min(inEnd - inPos, outEnd - outPos));
+    for (uint i = 0; i < numLiterals; i++) {
+      out[outPos++] = payload[inPos++];
+    }
+    // the last sequence has no match
+    if (inEnd - inPos < 2) {
+      break;
+    }
+    const uint offset = payload[inPos] | (uint(payload[inPos + 1]) << 8);
+    inPos += 2;
+    uint matchLength = token & 15;
+    if (matchLength == 15) {
+      matchLength += readLength(payload, inPos, inEnd);
+    }
+    if (offset == 0 || offset > outPos) {
+      break;
+    }
+    matchLength = min(matchLength + 4, outEnd - outPos);
+    for (uint i = 0; i < matchLength; i++, outPos++) {
+      out[outPos] = out[outPos - offset];
+    }
+  }
+}
+)";
+
+uint32_t read32(const uint8_t* data) {
+  uint32_t value = 0;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+// the extension bytes of a length of 15 or more, without the 15
+void writeLength(std::vector<uint8_t>& out, uint32_t length) {
+  for (; length >= 255; length -= 255) {
+    out.push_back(255);
+  }
+  out.push_back(static_cast<uint8_t>(length));
+}
+
+// a sequence of literals followed by a match, or by nothing if 'matchLength' is 0
+void writeSequence(std::vector<uint8_t>& out,
+                   const uint8_t* literals,
+                   uint32_t numLiterals,
+                   uint32_t offset,
+                   uint32_t matchLength) {
+  const uint32_t matchCode = matchLength ? matchLength - kMinMatch : 0;
+  out.push_back(static_cast<uint8_t>((std::min(numLiterals, 15u) << 4) | std::min(matchCode, 15u)));
+  if (numLiterals >= 15) {
+    writeLength(out, numLiterals - 15);
+  }
+  out.insert(out.end(), literals, literals + numLiterals);
+  if (matchLength == 0) {
+    return;
+  }
+  out.push_back(static_cast<uint8_t>(offset & 0xff));
+  out.push_back(static_cast<uint8_t>(offset >> 8));
+  if (matchCode >= 15) {
+    writeLength(out, matchCode - 15);
+  }
+}
+
+// A greedy LZ4 block encoder looking up the last position of each hashed 4-byte sequence
+void compressChunk(const uint8_t* data, uint32_t length, std::vector<uint8_t>& out) {
+  uint32_t anchor = 0;
+  if (length > kMatchSearchLimit) {
+    // the positions + 1, or 0
+    std::vector<uint32_t> table(1u << kHashBits, 0);
+    const uint32_t searchEnd = length - kMatchSearchLimit;
+    const uint32_t matchEnd = length - kLastLiterals;
+    uint32_t pos = 0;
+    while (pos < searchEnd) {
+      const uint32_t sequence = read32(data + pos);
+      const uint32_t hash = (sequence * 2654435761u) >> (32 - kHashBits);
+      const uint32_t candidate = table[hash];
+      table[hash] = pos + 1;
+      if (candidate == 0 || pos - (candidate - 1) > kMaxOffset ||
+          read32(data + candidate - 1) != sequence) {
+        pos++;
+        continue;
+      }
+      const uint32_t match = candidate - 1;
+      uint32_t matchLength = kMinMatch;
+      while (pos + matchLength < matchEnd && data[match + matchLength] == data[pos + matchLength]) {
+        matchLength++;
+      }
+      writeSequence(out, data + anchor, pos - anchor, pos - match, matchLength);
+      pos += matchLength;
+      anchor = pos;
+    }
+  }
+  writeSequence(out, data + anchor, length - anchor, 0, 0);
+}
+
+bool readLength(const uint8_t* data, uint32_t length, uint32_t& pos, uint32_t& outLength) {
+  uint8_t value = 0;
+  do {
+    if (pos >= length) {
+      return false;
+    }
+    value = data[pos++];
+    outLength += value;
+  } while (value == 255);
+  return true;
+}
+
+// Decodes an LZ4 block which must decode to exactly 'outLength' bytes
+bool decompressChunk(const uint8_t* data, uint32_t length, uint8_t* out, uint32_t outLength) {
+  uint32_t pos = 0;
+  uint32_t outPos = 0;
+  while (pos < length) {
+    const uint32_t token = data[pos++];
+    uint32_t numLiterals = token >> 4;
+    if (numLiterals == 15 && !readLength(data, length, pos, numLiterals)) {
+      return false;
+    }
+    if (numLiterals > length - pos || numLiterals > outLength - outPos) {
+      return false;
+    }
+    std::memcpy(out + outPos, data + pos, numLiterals);
+    pos += numLiterals;
+    outPos += numLiterals;
+    if (pos == length) {
+      // the last sequence
+      return outPos == outLength;
+    }
+    if (length - pos < 2) {
+      return false;
+    }
+    const uint32_t offset = data[pos] | (static_cast<uint32_t>(data[pos + 1]) << 8);
+    pos += 2;
+    uint32_t matchLength = token & 15;
+    if (matchLength == 15 && !readLength(data, length, pos, matchLength)) {
+      return false;
+    }
+    matchLength += kMinMatch;
+    if (offset == 0 || offset > outPos || matchLength > outLength - outPos) {
+      return false;
+    }
+    // the match can overlap the bytes it writes
+    for (uint32_t i = 0; i != matchLength; i++, outPos++) {
+      out[outPos] = out[outPos - offset];
+    }
+  }
+  return false;
+}
+
+ChunkEntry readChunkEntry(const uint8_t* data, uint32_t chunk) {
+  ChunkEntry entry = {};
+  std::memcpy(&entry, data + sizeof(Header) + chunk * sizeof(ChunkEntry), sizeof(entry));
+  return entry;
+}
+
+igl::Result decompressChecked(const uint8_t* data,
+                              const CompressedInfo& info,
+                              std::vector<uint8_t>& outData) {
+  outData.resize(info.uncompressedSize);
+  for (uint32_t i = 0; i != info.numChunks; i++) {
+    const ChunkEntry entry = readChunkEntry(data, i);
+    const uint32_t begin = i * info.chunkSize;
+    const uint32_t chunkLength = std::min(info.chunkSize, info.uncompressedSize - begin);
+    if (entry.size & kStoredBit) {
+      std::memcpy(outData.data() + begin, data + entry.offset, chunkLength);
+    } else if (!decompressChunk(
+                   data + entry.offset, entry.size, outData.data() + begin, chunkLength)) {
+      outData.clear();
+      return igl::Result(igl::Result::Code::ArgumentInvalid, "Corrupted compressed chunk");
+    }
+  }
+  return igl::Result();
+}
+
+} // namespace
+
+std::vector<uint8_t> compress(const uint8_t* data, size_t length, uint32_t chunkSize) {
+  if ((!data && length) || length > UINT32_MAX || chunkSize == 0 || chunkSize % 4 != 0 ||
+      chunkSize > kMaxChunkSize) {
+    return {};
+  }
+  const uint32_t numChunks = static_cast<uint32_t>((length + chunkSize - 1) / chunkSize);
+  const size_t tableEnd = sizeof(Header) + numChunks * sizeof(ChunkEntry);
+
+  std::vector<uint8_t> payload(tableEnd);
+  std::vector<uint8_t> chunk;
+  for (uint32_t i = 0; i != numChunks; i++) {
+    const size_t begin = static_cast<size_t>(i) * chunkSize;
+    const uint32_t chunkLength = static_cast<uint32_t>(std::min<size_t>(chunkSize, length - begin));
+    chunk.clear();
+    compressChunk(data + begin, chunkLength, chunk);
+
+    ChunkEntry entry = {static_cast<uint32_t>(payload.size()), 0};
+    if (chunk.size() < chunkLength) {
+      entry.size = static_cast<uint32_t>(chunk.size());
+      payload.insert(payload.end(), chunk.begin(), chunk.end());
+    } else {
+      entry.size = chunkLength | kStoredBit;
+      payload.insert(payload.end(), data + begin, data + begin + chunkLength);
+    }
+    if (payload.size() > UINT32_MAX) {
+      return {};
+    }
+    std::memcpy(payload.data() + sizeof(Header) + i * sizeof(ChunkEntry), &entry, sizeof(entry));
+  }
+
+  const Header header = {kMagic, kVersion, static_cast<uint32_t>(length), chunkSize, numChunks};
+  std::memcpy(payload.data(), &header, sizeof(header));
+  return payload;
+}
+
+igl::Result readCompressedInfo(const uint8_t* data, size_t length, CompressedInfo& outInfo) {
+  outInfo = CompressedInfo();
+
+  Header header = {};
+  if (!data || length < sizeof(header)) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid, "Not a compressed payload");
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kMagic || header.version != kVersion) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid, "Not a compressed payload");
+  }
+  if (header.chunkSize == 0 || header.chunkSize % 4 != 0 || header.chunkSize > kMaxChunkSize ||
+      header.numChunks !=
+          (static_cast<uint64_t>(header.uncompressedSize) + header.chunkSize - 1) /
+              header.chunkSize) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid, "Invalid compressed payload header");
+  }
+  const uint64_t tableEnd =
+      sizeof(Header) + static_cast<uint64_t>(header.numChunks) * sizeof(ChunkEntry);
+  if (length > UINT32_MAX || length < tableEnd) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid, "Truncated compressed payload");
+  }
+  for (uint32_t i = 0; i != header.numChunks; i++) {
+    const ChunkEntry entry = readChunkEntry(data, i);
+    const uint32_t size = entry.size & ~kStoredBit;
+    const uint32_t chunkLength =
+        std::min(header.chunkSize, header.uncompressedSize - i * header.chunkSize);
+    if (entry.offset < tableEnd || size == 0 || size > length - entry.offset ||
+        ((entry.size & kStoredBit) && size != chunkLength)) {
+      return igl::Result(igl::Result::Code::ArgumentInvalid, "Invalid compressed chunk");
+    }
+  }
+
+  outInfo.uncompressedSize = header.uncompressedSize;
+  outInfo.chunkSize = header.chunkSize;
+  outInfo.numChunks = header.numChunks;
+  return igl::Result();
+}
+
+igl::Result decompress(const uint8_t* data, size_t length, std::vector<uint8_t>& outData) {
+  outData.clear();
+  CompressedInfo info;
+  igl::Result result = readCompressedInfo(data, length, info);
+  if (!result.isOk()) {
+    return result;
+  }
+  return decompressChecked(data, info, outData);
+}
+
+GpuDecompressor::GpuDecompressor(igl::IDevice& device, igl::Result* outResult) : device_(device) {
+  usesCompute_ = device.hasFeature(igl::DeviceFeatures::Compute);
+  if (!usesCompute_) {
+    igl::Result::setOk(outResult);
+    return;
+  }
+
+  const auto backendType = device.getBackendType();
+  const std::string glslSource = getGlslSource(backendType == igl::BackendType::Vulkan);
+  const bool isMetal = backendType == igl::BackendType::Metal;
+  igl::Result result;
+  std::shared_ptr<igl::IShaderStages> stages =
+      igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                      isMetal ? kMetalSource : glslSource.c_str(),
+                                                      isMetal ? "decompressChunks" : "main",
+                                                      "GpuDecompressor",
+                                                      &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  igl::ComputePipelineDesc desc;
+  desc.shaderStages = std::move(stages);
+  desc.buffersMap[kCompressedIndex] = igl::genNameHandle("Compressed");
+  desc.buffersMap[kDecompressedIndex] = igl::genNameHandle("Decompressed");
+  desc.debugName = "GpuDecompressor";
+  pipelineState_ = device.createComputePipeline(desc, outResult);
+}
+
+void GpuDecompressor::decompress(igl::ICommandBuffer& commandBuffer,
+                                 const uint8_t* data,
+                                 size_t length,
+                                 const std::shared_ptr<igl::IBuffer>& destination,
+                                 size_t destinationOffset,
+                                 igl::Result* outResult) {
+  CompressedInfo info;
+  igl::Result result = readCompressedInfo(data, length, info);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+  const size_t alignedSize = (static_cast<size_t>(info.uncompressedSize) + 3) & ~size_t(3);
+  if (!IGL_VERIFY(destination) || destinationOffset % 4 != 0 ||
+      destinationOffset + alignedSize > destination->getSizeInBytes()) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::ArgumentOutOfRange,
+                           "The destination can't hold the decompressed data");
+    return;
+  }
+
+  if (!usesCompute_) {
+    std::vector<uint8_t> decompressed;
+    result = decompressChecked(data, info, decompressed);
+    if (result.isOk() && !decompressed.empty()) {
+      result = destination->upload(decompressed.data(),
+                                   igl::BufferRange(decompressed.size(), destinationOffset));
+    }
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+  dispatch(commandBuffer, data, length, info, destination, destinationOffset, outResult);
+}
+
+void GpuDecompressor::decompress(igl::ICommandBuffer& commandBuffer,
+                                 const uint8_t* data,
+                                 size_t length,
+                                 igl::ITexture& texture,
+                                 const igl::TextureRangeDesc& range,
+                                 igl::Result* outResult) {
+  CompressedInfo info;
+  igl::Result result = readCompressedInfo(data, length, info);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+  if (info.uncompressedSize != texture.getProperties().getBytesPerRange(range)) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::ArgumentInvalid,
+                           "The decompressed data does not match the texture range");
+    return;
+  }
+
+  if (!usesCompute_) {
+    std::vector<uint8_t> decompressed;
+    result = decompressChecked(data, info, decompressed);
+    if (result.isOk()) {
+      result = texture.upload(range, decompressed.data());
+    }
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  // the texels are decompressed into a scratch buffer and copied into the texture
+  igl::BufferDesc desc(igl::BufferDesc::BufferTypeBits::Storage,
+                       nullptr,
+                       (static_cast<size_t>(info.uncompressedSize) + 3) & ~size_t(3),
+                       igl::ResourceStorage::Private);
+  desc.debugName = "GpuDecompressor texels";
+  std::shared_ptr<igl::IBuffer> texels = device_.createBuffer(desc, &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+  dispatch(commandBuffer, data, length, info, texels, 0, &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+  commandBuffer.copyBufferToTexture(*texels, 0, texture, range);
+  // keeps the scratch buffer alive until the copy has run
+  commandBuffer.addCompletedHandler([texels]() {});
+  igl::Result::setOk(outResult);
+}
+
+void GpuDecompressor::dispatch(igl::ICommandBuffer& commandBuffer,
+                               const uint8_t* data,
+                               size_t length,
+                               const CompressedInfo& info,
+                               const std::shared_ptr<igl::IBuffer>& destination,
+                               size_t destinationOffset,
+                               igl::Result* outResult) {
+  const uint32_t numThreadgroups = (info.numChunks + kThreadgroupSize - 1) / kThreadgroupSize;
+  if (!IGL_VERIFY(pipelineState_)) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::InvalidOperation, "The decompression pipeline is missing");
+    return;
+  }
+  if (numThreadgroups > 65535) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentOutOfRange, "Too many chunks to decompress");
+    return;
+  }
+  if (info.numChunks == 0) {
+    igl::Result::setOk(outResult);
+    return;
+  }
+
+  std::vector<uint32_t> words(kParamsWords + (length + 3) / 4, 0);
+  words[0] = static_cast<uint32_t>(destinationOffset / 4);
+  std::memcpy(words.data() + kParamsWords, data, length);
+
+  igl::Result result;
+  igl::BufferDesc desc(igl::BufferDesc::BufferTypeBits::Storage,
+                       words.data(),
+                       words.size() * sizeof(uint32_t),
+                       igl::ResourceStorage::Shared);
+  desc.debugName = "GpuDecompressor staging";
+  std::shared_ptr<igl::IBuffer> staging = device_.createBuffer(desc, &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::RuntimeError, "Could not create a compute encoder");
+    return;
+  }
+  encoder->pushDebugGroupLabel("GpuDecompressor::decompress()");
+  encoder->bindComputePipelineState(pipelineState_);
+  encoder->bindBuffer(kCompressedIndex, staging, 0);
+  encoder->bindBuffer(kDecompressedIndex, destination, 0);
+  encoder->dispatchThreadGroups(igl::Dimensions(numThreadgroups, 1, 1),
+                                igl::Dimensions(kThreadgroupSize, 1, 1));
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+
+  // keeps the staging buffer alive until the GPU has read it
+  commandBuffer.addCompletedHandler([staging]() {});
+  igl::Result::setOk(outResult);
+}
+
+} // namespace gpudecompression
+} // namespace iglu
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace gpudecompression {
+
+/// The default number of uncompressed bytes of a chunk. Each chunk is decoded by one GPU thread,
+/// so smaller chunks decode with more parallelism and compress slightly worse.
+constexpr uint32_t kDefaultChunkSize = 16 * 1024;
+/// Chunks can't be larger than the 64 KiB window of the LZ4 matches
+constexpr uint32_t kMaxChunkSize = 64 * 1024;
+
+/// The properties of a compressed payload
+struct CompressedInfo {
+  uint32_t uncompressedSize = 0;
+  uint32_t chunkSize = 0;
+  uint32_t numChunks = 0;
+};
+
+/// Compresses 'length' bytes into a versioned, little endian payload of independent chunks of
+/// 'chunkSize' uncompressed bytes, a multiple of 4 of at most kMaxChunkSize. Each chunk is an LZ4
+/// block (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md), or is stored as is when
+/// it does not compress. Returns an empty payload if the arguments are invalid.
+std::vector<uint8_t> compress(const uint8_t* data,
+                              size_t length,
+                              uint32_t chunkSize = kDefaultChunkSize);
+
+/// Reads the header of a payload written by compress() and checks its chunk table
+igl::Result readCompressedInfo(const uint8_t* data, size_t length, CompressedInfo& outInfo);
+
+/// Decompresses a payload written by compress() on the CPU
+igl::Result decompress(const uint8_t* data, size_t length, std::vector<uint8_t>& outData);
+
+/**
+ * @brief Decompresses payloads written by compress() on the GPU, straight into their destination
+ * buffers and textures, so only the compressed bytes are uploaded and no CPU time is spent on
+ * decoding.
+ *
+ * decompress() uploads the payload into a staging buffer and records one compute dispatch, with
+ * one thread per chunk, which writes the decompressed bytes into the destination. The work
+ * encoded after it in the command buffer sees the decompressed data. The staging memory is
+ * released when the command buffer completes.
+ *
+ * The chunks of corrupted payloads decode to undefined bytes, but never read or write out of
+ * bounds.
+ *
+ * Without DeviceFeatures::Compute (OpenGL ES 3.0), the payloads are decompressed on the CPU and
+ * uploaded instead.
+ */
+class GpuDecompressor final {
+ public:
+  GpuDecompressor(igl::IDevice& device, igl::Result* outResult);
+
+  /// Decompresses into 'destination' at 'destinationOffset', a multiple of 4. The destination
+  /// needs BufferTypeBits::Storage and the uncompressed size rounded up to a multiple of 4 bytes;
+  /// the padding bytes can be overwritten.
+  void decompress(igl::ICommandBuffer& commandBuffer,
+                  const uint8_t* data,
+                  size_t length,
+                  const std::shared_ptr<igl::IBuffer>& destination,
+                  size_t destinationOffset,
+                  igl::Result* outResult);
+
+  /// Decompresses the tightly packed texels of 'range' of 'texture', as taken by
+  /// ICommandBuffer::copyBufferToTexture(), e.g. the blocks of a compressed texture format. Must
+  /// be called outside of encoders.
+  void decompress(igl::ICommandBuffer& commandBuffer,
+                  const uint8_t* data,
+                  size_t length,
+                  igl::ITexture& texture,
+                  const igl::TextureRangeDesc& range,
+                  igl::Result* outResult);
+
+ private:
+  void dispatch(igl::ICommandBuffer& commandBuffer,
+                const uint8_t* data,
+                size_t length,
+                const CompressedInfo& info,
+                const std::shared_ptr<igl::IBuffer>& destination,
+                size_t destinationOffset,
+                igl::Result* outResult);
+
+ private:
+  igl::IDevice& device_;
+  bool usesCompute_ = false;
+  std::shared_ptr<igl::IComputePipelineState> pipelineState_;
+};
+
+} // namespace gpudecompression
+} // namespace iglu
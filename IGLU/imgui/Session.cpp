@@ -9,6 +9,7 @@
 
 #include <IGLU/simple_renderer/Drawable.h>
 #include <IGLU/simple_renderer/Material.h>
+#include <algorithm>
 #include <igl/ShaderCreator.h>
 
 namespace iglu {
@@ -161,26 +162,56 @@ static std::unique_ptr<igl::IShaderStages> getShaderStagesForBackend(igl::IDevic
   IGL_UNREACHABLE_RETURN(nullptr);
 }
 
-struct DrawableData {
+// Vertex and index buffers holding all draw lists of a frame. They grow geometrically, so a frame
+// causes at most one recreation and the buffers quickly settle at the peak size of the UI.
+struct FrameBuffers {
   std::shared_ptr<iglu::vertexdata::VertexData> vertexData;
   std::shared_ptr<iglu::drawable::Drawable> drawable;
+  size_t vertexBufferSize = 0;
+  size_t indexBufferSize = 0;
 
-  DrawableData(igl::IDevice& device,
+  // Returns false if the buffers could not be created
+  bool reserve(igl::IDevice& device,
                const std::shared_ptr<igl::IVertexInputState>& inputState,
-               const std::shared_ptr<iglu::material::Material>& material) {
-    IGL_ASSERT_MSG(sizeof(ImDrawIdx) == 2, "The constants below may not work with the ImGui data.");
-    const size_t kMaxVertices = (1l << 16);
-    const size_t kMaxVertexBufferSize = kMaxVertices * sizeof(ImDrawVert);
-    const size_t kMaxIndexBufferSize = kMaxVertices * sizeof(ImDrawIdx);
-
-    const igl::BufferDesc vbDesc(igl::BufferDesc::BufferTypeBits::Vertex,
-                                 nullptr,
-                                 kMaxVertexBufferSize,
-                                 igl::ResourceStorage::Shared);
-    const igl::BufferDesc ibDesc(igl::BufferDesc::BufferTypeBits::Index,
-                                 nullptr,
-                                 kMaxIndexBufferSize,
-                                 igl::ResourceStorage::Shared);
+               const std::shared_ptr<iglu::material::Material>& material,
+               bool useRingBuffers,
+               size_t minVertexBufferSize,
+               size_t minIndexBufferSize) {
+    if (vertexData && minVertexBufferSize <= vertexBufferSize &&
+        minIndexBufferSize <= indexBufferSize) {
+      return true;
+    }
+    constexpr size_t kInitialVertices = 1 << 14;
+    vertexBufferSize = std::max({minVertexBufferSize,
+                                 2 * vertexBufferSize,
+                                 kInitialVertices * sizeof(ImDrawVert)});
+    indexBufferSize = std::max(
+        {minIndexBufferSize, 2 * indexBufferSize, 3 * kInitialVertices * sizeof(ImDrawIdx)});
+
+    igl::BufferDesc vbDesc(igl::BufferDesc::BufferTypeBits::Vertex,
+                           nullptr,
+                           vertexBufferSize,
+                           igl::ResourceStorage::Shared);
+    igl::BufferDesc ibDesc(igl::BufferDesc::BufferTypeBits::Index,
+                           nullptr,
+                           indexBufferSize,
+                           igl::ResourceStorage::Shared);
+    if (useRingBuffers) {
+      // the backend keeps one copy for each frame in flight, persistently mapped where possible
+      vbDesc.hint |= igl::BufferDesc::BufferAPIHintBits::Ring;
+      ibDesc.hint |= igl::BufferDesc::BufferAPIHintBits::Ring;
+    }
+    vbDesc.debugName = "ImGui vertices";
+    ibDesc.debugName = "ImGui indices";
+    std::shared_ptr<igl::IBuffer> vertexBuffer = device.createBuffer(vbDesc, nullptr);
+    std::shared_ptr<igl::IBuffer> indexBuffer = device.createBuffer(ibDesc, nullptr);
+    if (!IGL_VERIFY(vertexBuffer && indexBuffer)) {
+      vertexData = nullptr;
+      drawable = nullptr;
+      vertexBufferSize = 0;
+      indexBufferSize = 0;
+      return false;
+    }
 
     iglu::vertexdata::PrimitiveDesc primitiveDesc;
     primitiveDesc.numEntries = 0;
@@ -188,12 +219,13 @@ struct DrawableData {
 
     vertexData = std::make_shared<iglu::vertexdata::VertexData>(
         inputState,
-        device.createBuffer(vbDesc, nullptr),
-        device.createBuffer(ibDesc, nullptr),
+        std::move(vertexBuffer),
+        std::move(indexBuffer),
         sizeof(ImDrawIdx) == sizeof(uint16_t) ? igl::IndexFormat::UInt16 : igl::IndexFormat::UInt32,
         primitiveDesc);
 
     drawable = std::make_shared<iglu::drawable::Drawable>(vertexData, material);
+    return true;
   }
 };
 
@@ -210,15 +242,19 @@ class Session::Renderer {
  private:
   std::shared_ptr<igl::IVertexInputState> _vertexInputState;
   std::shared_ptr<iglu::material::Material> _material;
-  std::vector<DrawableData> _drawables[3]; // list of drawables to be reused every 3 frames
+  // With ring buffers, the backend already keeps the buffers of frames in flight apart and only
+  // the first entry is used. Otherwise, each entry is reused every 3 frames.
+  FrameBuffers _frameBuffers[3];
   size_t _nextBufferingIndex = 0;
+  bool _useRingBuffers = false;
 
   igl::RenderPipelineDesc _renderPipelineDesc;
   std::shared_ptr<igl::ITexture> _fontTexture;
   std::shared_ptr<igl::ISamplerState> _linearSampler;
 };
 
-Session::Renderer::Renderer(igl::IDevice& device) {
+Session::Renderer::Renderer(igl::IDevice& device) :
+  _useRingBuffers(device.hasFeature(igl::DeviceFeatures::BufferRing)) {
   ImGuiIO& io = ImGui::GetIO();
   io.BackendRendererName = "imgui_impl_igl";
 
@@ -326,8 +362,31 @@ void Session::Renderer::renderDrawData(igl::IDevice& device,
       drawData->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
 
   // Since vertex buffers are updated every frame, we must use triple buffering for Metal to work
-  std::vector<DrawableData>& curFrameDrawables = _drawables[_nextBufferingIndex];
+  FrameBuffers& frameBuffers = _frameBuffers[_useRingBuffers ? 0 : _nextBufferingIndex];
   _nextBufferingIndex = (_nextBufferingIndex + 1) % 3;
+  if (!frameBuffers.reserve(device,
+                            _vertexInputState,
+                            _material,
+                            _useRingBuffers,
+                            drawData->TotalVtxCount * sizeof(ImDrawVert),
+                            drawData->TotalIdxCount * sizeof(ImDrawIdx))) {
+    return;
+  }
+  iglu::vertexdata::VertexData& vertexData = *frameBuffers.vertexData;
+
+  // Upload all draw lists before the first draw: a ring buffer only streams into the memory of the
+  // current frame as long as no draw of this frame uses it yet
+  size_t vertexBufferOffset = 0;
+  size_t indexBufferOffset = 0;
+  for (int n = 0; n < drawData->CmdListsCount; n++) {
+    const ImDrawList* cmd_list = drawData->CmdLists[n];
+    const size_t vertexSize = cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+    const size_t indexSize = cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+    vertexData.vertexBuffer().upload(cmd_list->VtxBuffer.Data, {vertexSize, vertexBufferOffset});
+    vertexData.indexBuffer().upload(cmd_list->IdxBuffer.Data, {indexSize, indexBufferOffset});
+    vertexBufferOffset += vertexSize;
+    indexBufferOffset += indexSize;
+  }
 
   const bool isOpenGL = device.getBackendType() == igl::BackendType::OpenGL;
   const bool isVulkan = device.getBackendType() == igl::BackendType::Vulkan;
@@ -338,19 +397,13 @@ void Session::Renderer::renderDrawData(igl::IDevice& device,
 
   ImTextureID lastBoundTextureId = nullptr;
 
+  vertexBufferOffset = 0;
+  indexBufferOffset = 0;
   for (int n = 0; n < drawData->CmdListsCount; n++) {
     const ImDrawList* cmd_list = drawData->CmdLists[n];
 
-    if (n >= curFrameDrawables.size()) {
-      curFrameDrawables.emplace_back(device, _vertexInputState, _material);
-    }
-    DrawableData& drawableData = curFrameDrawables[n];
-
-    // Upload vertex/index buffers
-    drawableData.vertexData->vertexBuffer().upload(
-        cmd_list->VtxBuffer.Data, {cmd_list->VtxBuffer.Size * sizeof(ImDrawVert), 0});
-    drawableData.vertexData->indexBuffer().upload(
-        cmd_list->IdxBuffer.Data, {cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), 0});
+    // the indices of each draw list start at its first vertex
+    vertexData.primitiveDesc().vertexBufferOffset = vertexBufferOffset;
 
     for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++) {
       const ImDrawCmd cmd = cmd_list->CmdBuffer[cmd_i];
@@ -390,11 +443,14 @@ void Session::Renderer::renderDrawData(igl::IDevice& device,
         }
       }
 
-      drawableData.vertexData->primitiveDesc().numEntries = cmd.ElemCount;
-      drawableData.vertexData->primitiveDesc().offset = cmd.IdxOffset * sizeof(ImDrawIdx);
+      vertexData.primitiveDesc().numEntries = cmd.ElemCount;
+      vertexData.primitiveDesc().offset = indexBufferOffset + cmd.IdxOffset * sizeof(ImDrawIdx);
 
-      drawableData.drawable->draw(device, cmdEncoder, _renderPipelineDesc);
+      frameBuffers.drawable->draw(device, cmdEncoder, _renderPipelineDesc);
     }
+
+    vertexBufferOffset += cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+    indexBufferOffset += cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
   }
 
   if (isOpenGL) {
@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cstring>
+#include <igl/Common.h>
+
+#if IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+#include <cstdio>
+#include <sched.h>
+#elif IGL_PLATFORM_APPLE
+#include <pthread.h>
+#include <sys/qos.h>
+#include <sys/sysctl.h>
+#endif
+
+namespace iglu {
+namespace jobsystem {
+
+namespace {
+
+constexpr uint32_t kJobZoneColor = 0x00ffff;
+
+thread_local const JobSystem* tlsJobSystem = nullptr;
+thread_local uint32_t tlsWorkerIndex = 0;
+
+struct CpuTopology {
+  // 0 if the CPU has a single kind of core or its topology is unknown
+  uint32_t numPerformanceCores = 0;
+  // the indices of the cores, where the platform pins threads to cores
+  std::vector<uint32_t> performanceCores;
+  std::vector<uint32_t> efficiencyCores;
+};
+
+#if IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+CpuTopology getCpuTopology() {
+  const uint32_t numCores = std::thread::hardware_concurrency();
+  std::vector<uint32_t> maxFrequencies(numCores);
+  for (uint32_t i = 0; i != numCores; i++) {
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpufreq/cpuinfo_max_freq", i);
+    FILE* file = fopen(path, "r");
+    if (!file) {
+      // no cpufreq driver, or an offline core
+      return {};
+    }
+    const int numRead = fscanf(file, "%u", &maxFrequencies[i]);
+    fclose(file);
+    if (numRead != 1) {
+      return {};
+    }
+  }
+  if (maxFrequencies.empty()) {
+    return {};
+  }
+
+  // the cores of all the clusters faster than the slowest one are performance cores; the margin
+  // keeps the small frequency differences of the cores of desktop CPUs from splitting them
+  const uint32_t minFrequency = *std::min_element(maxFrequencies.begin(), maxFrequencies.end());
+  CpuTopology topology;
+  for (uint32_t i = 0; i != numCores; i++) {
+    const bool isPerformanceCore = uint64_t(maxFrequencies[i]) * 4 > uint64_t(minFrequency) * 5;
+    (isPerformanceCore ? topology.performanceCores : topology.efficiencyCores).push_back(i);
+  }
+  if (topology.performanceCores.empty()) {
+    return {};
+  }
+  topology.numPerformanceCores = static_cast<uint32_t>(topology.performanceCores.size());
+  return topology;
+}
+
+void placeThread(const CpuTopology& topology, CoreType coreType) {
+  const std::vector<uint32_t>& cores = coreType == CoreType::Performance
+                                           ? topology.performanceCores
+                                           : topology.efficiencyCores;
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (const uint32_t core : cores) {
+    CPU_SET(core, &cpuSet);
+  }
+  // fails when the cores are outside of the cpuset of the process, e.g. for background apps
+  if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+    IGL_LOG_INFO_ONCE("JobSystem: sched_setaffinity() failed, the workers are not placed\n");
+  }
+}
+#elif IGL_PLATFORM_APPLE
+CpuTopology getCpuTopology() {
+  int numLevels = 0;
+  size_t size = sizeof(numLevels);
+  if (sysctlbyname("hw.nperflevels", &numLevels, &size, nullptr, 0) != 0 || numLevels < 2) {
+    return {};
+  }
+  // perflevel0 is the fastest kind of core
+  int numPerformanceCores = 0;
+  size = sizeof(numPerformanceCores);
+  if (sysctlbyname("hw.perflevel0.logicalcpu", &numPerformanceCores, &size, nullptr, 0) != 0 ||
+      numPerformanceCores <= 0) {
+    return {};
+  }
+  CpuTopology topology;
+  topology.numPerformanceCores = static_cast<uint32_t>(numPerformanceCores);
+  return topology;
+}
+
+void placeThread(const CpuTopology& /*topology*/, CoreType coreType) {
+  // threads can't be pinned: the kernel runs the interactive ones on the performance cores
+  pthread_set_qos_class_self_np(
+      coreType == CoreType::Performance ? QOS_CLASS_USER_INTERACTIVE : QOS_CLASS_UTILITY, 0);
+}
+#else
+CpuTopology getCpuTopology() {
+  return {};
+}
+
+void placeThread(const CpuTopology& /*topology*/, CoreType /*coreType*/) {}
+#endif
+
+} // namespace
+
+JobSystem::JobSystem(const JobSystemConfig& config) {
+  const uint32_t numThreads = config.numThreads > 0
+                                  ? config.numThreads
+                                  : std::max(std::thread::hardware_concurrency(), 2u) - 1;
+  const CpuTopology topology = config.useCoreAffinity ? getCpuTopology() : CpuTopology{};
+  numPerformanceThreads_ = std::min(numThreads, topology.numPerformanceCores);
+
+  workers_.reserve(numThreads);
+  for (uint32_t i = 0; i != numThreads; i++) {
+    auto worker = std::make_unique<Worker>();
+    worker->index = i;
+    if (topology.numPerformanceCores > 0) {
+      worker->coreType = i < numPerformanceThreads_ ? CoreType::Performance : CoreType::Efficiency;
+    }
+    workers_.push_back(std::move(worker));
+  }
+
+  // the workers steal from each other: start them once they all exist
+  for (auto& worker : workers_) {
+    worker->thread = std::thread([this, index = worker->index, name = config.name, topology]() {
+      IGL_PROFILER_THREAD(name);
+      const CoreType coreType = workers_[index]->coreType;
+      if (coreType != CoreType::Any) {
+        placeThread(topology, coreType);
+      }
+      runWorker(index);
+    });
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stop_ = true;
+  }
+  workerCv_.notify_all();
+  efficiencyWorkerCv_.notify_all();
+
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+CoreType JobSystem::getCoreType(uint32_t workerIndex) const {
+  IGL_ASSERT(workerIndex < workers_.size());
+  return workers_[workerIndex]->coreType;
+}
+
+void JobSystem::run(std::function<void()>&& job, const JobDesc& desc) {
+  IGL_ASSERT(job);
+
+  if (desc.counter) {
+    desc.counter->pending_.fetch_add(1, std::memory_order_relaxed);
+    auto& lowestPriority = desc.counter->lowestPriority_;
+    const auto priority = static_cast<uint8_t>(desc.priority);
+    uint8_t current = lowestPriority.load(std::memory_order_relaxed);
+    while (current < priority &&
+           !lowestPriority.compare_exchange_weak(current, priority, std::memory_order_relaxed)) {
+    }
+  }
+
+  Worker* worker = getCurrentWorker();
+  push(worker ? worker->queue : sharedQueue_,
+       Job{std::move(job), desc.name, desc.counter},
+       desc.priority);
+  notify();
+}
+
+void JobSystem::parallelFor(size_t count,
+                            const std::function<void(size_t)>& job,
+                            const JobDesc& desc) {
+  if (count == 0) {
+    return;
+  }
+
+  std::atomic<size_t> nextIndex = 0;
+  const auto runJobs = [&nextIndex, count, &job]() {
+    for (size_t i = nextIndex++; i < count; i = nextIndex++) {
+      job(i);
+    }
+  };
+
+  JobCounter counter;
+  JobDesc helperDesc = desc;
+  helperDesc.counter = &counter;
+
+  // the calling thread takes part, so there is no point in spawning more helpers than needed
+  const size_t numHelpers = std::min(workers_.size(), count - 1);
+  for (size_t i = 0; i != numHelpers; i++) {
+    run(runJobs, helperDesc);
+  }
+
+  runJobs();
+
+  // the helpers reference locals of this function: wait for all of them, even idle ones
+  wait(counter);
+}
+
+void JobSystem::wait(JobCounter& counter) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+
+  Worker* worker = getCurrentWorker();
+
+  while (counter.pending_.load() != 0) {
+    const auto lowestPriority =
+        static_cast<JobPriority>(counter.lowestPriority_.load(std::memory_order_relaxed));
+    Job job;
+    if (pop(worker, JobPriority::High, lowestPriority, job)) {
+      execute(job);
+      continue;
+    }
+
+    // the remaining jobs of the counter are running on other threads
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    numWaiters_++;
+    while (counter.pending_.load() != 0 && !hasPendingJobs(JobPriority::High, lowestPriority)) {
+      waiterCv_.wait(lock);
+    }
+    numWaiters_--;
+  }
+}
+
+void JobSystem::runWorker(uint32_t workerIndex) {
+  tlsJobSystem = this;
+  tlsWorkerIndex = workerIndex;
+
+  Worker& worker = *workers_[workerIndex];
+  const JobPriority highestPriority = getHighestPriority(worker);
+  const bool isEfficiencyWorker = worker.coreType == CoreType::Efficiency;
+  std::condition_variable& cv = isEfficiencyWorker ? efficiencyWorkerCv_ : workerCv_;
+  std::atomic<uint32_t>& numSleeping =
+      isEfficiencyWorker ? numSleepingEfficiencyWorkers_ : numSleepingWorkers_;
+
+  for (;;) {
+    Job job;
+    if (pop(&worker, highestPriority, JobPriority::Low, job)) {
+      // the remaining jobs may need more workers than the ones awake
+      notify();
+      execute(job);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    for (;;) {
+      // counted before checking the jobs, so that a concurrent run() either sees this worker
+      // sleeping or its job is seen here
+      numSleeping++;
+      if (hasPendingJobs(highestPriority, JobPriority::Low)) {
+        numSleeping--;
+        break;
+      }
+      // drain the queues before stopping
+      if (stop_) {
+        numSleeping--;
+        return;
+      }
+      cv.wait(lock);
+      numSleeping--;
+    }
+  }
+}
+
+JobSystem::Worker* JobSystem::getCurrentWorker() const {
+  return tlsJobSystem == this ? workers_[tlsWorkerIndex].get() : nullptr;
+}
+
+void JobSystem::push(Queue& queue, Job&& job, JobPriority priority) {
+  const auto p = static_cast<size_t>(priority);
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  queue.jobs[p].push_back(std::move(job));
+  numPendingJobs_[p]++;
+}
+
+bool JobSystem::pop(Worker* worker,
+                    JobPriority highestPriority,
+                    JobPriority lowestPriority,
+                    Job& outJob) {
+  for (auto p = static_cast<size_t>(highestPriority); p <= static_cast<size_t>(lowestPriority);
+       p++) {
+    if (numPendingJobs_[p].load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+    // the owner of a queue takes its most recent job, whose data is most likely in its caches,
+    // and the other threads its oldest one
+    const auto popFrom = [this, p, &outJob](Queue& queue, bool isOwner) {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      std::deque<Job>& jobs = queue.jobs[p];
+      if (jobs.empty()) {
+        return false;
+      }
+      if (isOwner) {
+        outJob = std::move(jobs.back());
+        jobs.pop_back();
+      } else {
+        outJob = std::move(jobs.front());
+        jobs.pop_front();
+      }
+      numPendingJobs_[p]--;
+      return true;
+    };
+    if (worker && popFrom(worker->queue, true)) {
+      return true;
+    }
+    if (popFrom(sharedQueue_, false)) {
+      return true;
+    }
+    // start stealing after the current worker, so that the thieves spread over the victims
+    const size_t numWorkers = workers_.size();
+    const size_t first = worker ? worker->index + 1 : 0;
+    for (size_t i = 0; i != numWorkers; i++) {
+      Worker& victim = *workers_[(first + i) % numWorkers];
+      if (&victim != worker && popFrom(victim.queue, false)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void JobSystem::execute(Job& job) {
+  if (job.name) {
+    IGL_PROFILER_ZONE(job.name, kJobZoneColor);
+    job.func();
+    IGL_PROFILER_ZONE_END();
+  } else {
+    job.func();
+  }
+
+  // release the captures before the waiters can return
+  job.func = nullptr;
+
+  JobCounter* counter = job.counter;
+  if (counter && counter->pending_.fetch_sub(1) == 1 && numWaiters_.load() > 0) {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    waiterCv_.notify_all();
+  }
+}
+
+JobPriority JobSystem::getHighestPriority(const Worker& worker) const {
+  // keep the efficiency cores away from the latency-critical jobs
+  return worker.coreType == CoreType::Efficiency ? JobPriority::Normal : JobPriority::High;
+}
+
+bool JobSystem::hasPendingJobs(JobPriority highestPriority, JobPriority lowestPriority) const {
+  for (auto p = static_cast<size_t>(highestPriority); p <= static_cast<size_t>(lowestPriority);
+       p++) {
+    if (numPendingJobs_[p].load() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void JobSystem::notify() {
+  const bool hasHighPriorityJobs = numPendingJobs_[size_t(JobPriority::High)].load() > 0;
+  const bool hasOtherJobs = numPendingJobs_[size_t(JobPriority::Normal)].load() > 0 ||
+                            numPendingJobs_[size_t(JobPriority::Low)].load() > 0;
+  // the other jobs go to the efficiency workers first, to keep the performance ones available
+  const bool wakeEfficiencyWorker = hasOtherJobs && numSleepingEfficiencyWorkers_.load() > 0;
+  const bool wakeWorker = (hasHighPriorityJobs || (hasOtherJobs && !wakeEfficiencyWorker)) &&
+                          numSleepingWorkers_.load() > 0;
+  const bool wakeWaiters = (hasHighPriorityJobs || hasOtherJobs) && numWaiters_.load() > 0;
+  if (!wakeWorker && !wakeEfficiencyWorker && !wakeWaiters) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(sleepMutex_);
+  if (wakeWorker) {
+    workerCv_.notify_one();
+  }
+  if (wakeEfficiencyWorker) {
+    efficiencyWorkerCv_.notify_one();
+  }
+  if (wakeWaiters) {
+    waiterCv_.notify_all();
+  }
+}
+
+} // namespace jobsystem
+} // namespace iglu
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iglu {
+namespace jobsystem {
+
+/// Jobs of a higher priority run first. Within a priority, a worker runs the jobs it spawned
+/// itself in last-in first-out order, and steals the oldest jobs of the other workers.
+enum class JobPriority : uint8_t {
+  /// Latency-critical jobs, such as encoding the current frame. On CPUs with performance and
+  /// efficiency cores, only the workers placed on performance cores take them.
+  High = 0,
+  Normal = 1,
+  /// Background jobs, such as loading assets or compiling pipelines
+  Low = 2,
+};
+
+constexpr size_t kNumJobPriorities = 3;
+
+/// The kind of CPU core a worker is placed on
+enum class CoreType : uint8_t {
+  /// The CPU has a single kind of core, or its topology is unknown: the worker is not placed.
+  Any = 0,
+  Performance = 1,
+  Efficiency = 2,
+};
+
+/// Counts the unfinished jobs attached to it; see JobSystem::wait(). A counter must outlive its
+/// jobs, and can be reused once they have finished.
+class JobCounter final {
+ public:
+  [[nodiscard]] bool isDone() const {
+    return pending_.load(std::memory_order_acquire) == 0;
+  }
+
+ private:
+  friend class JobSystem;
+
+  std::atomic<uint32_t> pending_ = 0;
+  // the lowest priority of the jobs attached so far, which bounds the jobs wait() helps with
+  std::atomic<uint8_t> lowestPriority_ = 0;
+};
+
+struct JobDesc {
+  /// The name of the Tracy zone of the job, which must outlive the job. No zone when null.
+  const char* name = nullptr;
+  JobPriority priority = JobPriority::Normal;
+  /// Incremented when the job is submitted and decremented once it has run, if not null
+  JobCounter* counter = nullptr;
+};
+
+struct JobSystemConfig {
+  /// The number of worker threads. 0 uses one per core but one, which is left to the thread
+  /// submitting the jobs.
+  uint32_t numThreads = 0;
+  /// The name of the worker threads in Tracy
+  const char* name = "IGLU Job System";
+  /// On CPUs with performance and efficiency cores (ARM big.LITTLE and Apple silicon), places the
+  /// first workers on the performance cores, one per core, and the other workers on the efficiency
+  /// cores. Android and Linux pin the threads with sched_setaffinity(); Apple platforms set their
+  /// quality of service class, which the kernel uses to pick the cores. Other platforms leave the
+  /// threads to the scheduler.
+  bool useCoreAffinity = true;
+};
+
+/**
+ * @brief A work-stealing job system shared by the systems of an application.
+ *
+ * Jobs are lightweight tasks: std::function objects run to completion by the worker threads.
+ * Each worker owns one deque per priority. Jobs submitted by a worker go to its own deques, which
+ * keeps the data they share in its caches, and idle workers steal from the other deques. Jobs
+ * submitted by other threads go to a shared queue.
+ *
+ * A job waiting for other jobs with wait() runs pending jobs on its own thread meanwhile, so jobs
+ * can wait for the jobs they spawn without blocking a worker. Each job can be named to appear as a
+ * Tracy zone on its worker.
+ *
+ * The destructor runs all the pending jobs, including the ones they spawn, before joining the
+ * workers.
+ */
+class JobSystem final {
+ public:
+  explicit JobSystem(const JobSystemConfig& config = {});
+  ~JobSystem();
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  void run(std::function<void()>&& job, const JobDesc& desc = {});
+
+  /// Calls `job` with all the indices in [0, count) from the calling thread and the workers, and
+  /// returns once all the calls have returned. `desc.counter` is ignored.
+  void parallelFor(size_t count, const std::function<void(size_t)>& job, const JobDesc& desc = {});
+
+  /// Returns once all the jobs attached to `counter` have run. Meanwhile, the calling thread runs
+  /// pending jobs whose priority is at least the lowest priority of those jobs.
+  void wait(JobCounter& counter);
+
+  [[nodiscard]] uint32_t getNumThreads() const {
+    return static_cast<uint32_t>(workers_.size());
+  }
+  /// The number of workers placed on performance cores; 0 if the workers are not placed
+  [[nodiscard]] uint32_t getNumPerformanceThreads() const {
+    return numPerformanceThreads_;
+  }
+  [[nodiscard]] CoreType getCoreType(uint32_t workerIndex) const;
+
+ private:
+  struct Job {
+    std::function<void()> func;
+    const char* name = nullptr;
+    JobCounter* counter = nullptr;
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Job> jobs[kNumJobPriorities];
+  };
+
+  struct Worker {
+    uint32_t index = 0;
+    Queue queue;
+    CoreType coreType = CoreType::Any;
+    std::thread thread;
+  };
+
+  void runWorker(uint32_t workerIndex);
+  /// Returns null if the calling thread is not a worker of this job system
+  [[nodiscard]] Worker* getCurrentWorker() const;
+  void push(Queue& queue, Job&& job, JobPriority priority);
+  /// Pops the job of the highest priority in [highestPriority, lowestPriority] from the queue of
+  /// `worker` (which can be null), else from the shared queue, else steals it from another worker.
+  bool pop(Worker* worker, JobPriority highestPriority, JobPriority lowestPriority, Job& outJob);
+  void execute(Job& job);
+  /// The highest priority the worker takes outside of wait()
+  [[nodiscard]] JobPriority getHighestPriority(const Worker& worker) const;
+  [[nodiscard]] bool hasPendingJobs(JobPriority highestPriority, JobPriority lowestPriority) const;
+  /// Wakes up the sleeping workers which can take the pending jobs, and the sleeping waiters
+  void notify();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  uint32_t numPerformanceThreads_ = 0;
+  Queue sharedQueue_;
+  // the number of jobs in all the queues, per priority, updated under the mutex of their queue
+  std::atomic<uint32_t> numPendingJobs_[kNumJobPriorities] = {};
+
+  std::mutex sleepMutex_;
+  // the workers not on efficiency cores, and the workers on efficiency cores
+  std::condition_variable workerCv_;
+  std::condition_variable efficiencyWorkerCv_;
+  std::condition_variable waiterCv_;
+  // updated under sleepMutex_, and read without it to skip notifying nobody
+  std::atomic<uint32_t> numSleepingWorkers_ = 0;
+  std::atomic<uint32_t> numSleepingEfficiencyWorkers_ = 0;
+  std::atomic<uint32_t> numWaiters_ = 0;
+  bool stop_ = false;
+};
+
+} // namespace jobsystem
+} // namespace iglu
@@ -13,6 +13,9 @@
 
 #include <cstdlib>
 #include <igl/Macros.h>
+#if IGL_BACKEND_OPENGL && !IGL_PLATFORM_MACCATALYST
+#include <igl/opengl/RenderPipelineState.h>
+#endif
 
 #if defined(IGL_CMAKE_BUILD)
 #include <igl/IGLSafeC.h>
@@ -43,7 +46,7 @@ ManagedUniformBuffer::ManagedUniformBuffer(igl::IDevice& device,
 
   // Currently, the OpenGL code path always uses individual uniforms so no need to allocate a
   // buffer.
-  bool createBuffer = device.getBackendType() != igl::BackendType::OpenGL;
+  bool createBuffer = device.getBackendType() != igl::BackendType::OpenGL && !info.useFrameArena;
   // Allocate memory
   if (device.getBackendType() == igl::BackendType::Metal) {
 #if IGL_PLATFORM_APPLE
@@ -129,12 +132,19 @@ void ManagedUniformBuffer::bind(const igl::IDevice& device,
                                 uint8_t bindTarget) {
   if (device.getBackendType() == igl::BackendType::OpenGL) {
 #if IGL_BACKEND_OPENGL && !IGL_PLATFORM_MACCATALYST
+    // the locations stay valid until a different pipeline is bound; unresolved ones are looked up
+    // again, e.g. uniforms added to uniformInfo later
+    const uint64_t pipelineId =
+        static_cast<const igl::opengl::RenderPipelineState&>(pipelineState).getUniqueId();
+    const bool resolveLocations = glPipelineId_ != pipelineId;
+    glPipelineId_ = pipelineId;
     for (auto& uniform : uniformInfo.uniforms) {
-      // Since the backend is opengl, getIndexByName's igl::ShaderStage parameter is ignored and
-      // will work when binding vertex/fragment
-      // Might be optimized to use NameHandle
-      uniform.location = pipelineState.getIndexByName(igl::genNameHandle(uniform.name),
-                                                      igl::ShaderStage::Fragment);
+      if (resolveLocations || uniform.location < 0) {
+        // Since the backend is opengl, getIndexByName's igl::ShaderStage parameter is ignored and
+        // will work when binding vertex/fragment
+        uniform.location = pipelineState.getIndexByName(igl::genNameHandle(uniform.name),
+                                                        igl::ShaderStage::Fragment);
+      }
 
       if (uniform.location >= 0) {
         encoder.bindUniform(uniform, data_);
@@ -148,7 +158,7 @@ void ManagedUniformBuffer::bind(const igl::IDevice& device,
   } else {
     if (useBindBytes_) {
       encoder.bindBytes(uniformInfo.index, bindTarget, data_, length_);
-    } else {
+    } else if (IGL_VERIFY(buffer_)) {
       // Need to ensure the latest data is present in the buffer
       // TODO: Have callers handle this when data has changed.
       void* data = data_;
@@ -167,7 +177,7 @@ void ManagedUniformBuffer::bind(const igl::IDevice& device, igl::IComputeCommand
   } else {
     if (useBindBytes_) {
       encoder.bindBytes(uniformInfo.index, data_, length_);
-    } else {
+    } else if (IGL_VERIFY(buffer_)) {
       // Need to ensure the latest data is present in the buffer
       // TODO: Have callers handle this when data has changed.
       void* data = data_;
@@ -180,6 +190,41 @@ void ManagedUniformBuffer::bind(const igl::IDevice& device, igl::IComputeCommand
   }
 }
 
+void ManagedUniformBuffer::bind(const igl::IDevice& device,
+                                const igl::IRenderPipelineState& pipelineState,
+                                igl::IRenderCommandEncoder& encoder,
+                                UniformBufferArena& arena,
+                                uint8_t bindTarget) {
+  // individual uniforms and bind bytes don't need a buffer
+  if (device.getBackendType() == igl::BackendType::OpenGL || useBindBytes_) {
+    bind(device, pipelineState, encoder, bindTarget);
+    return;
+  }
+  const UniformBufferArena::Slice slice = arena.allocate(data_, uniformInfo.length);
+  if (slice.buffer) {
+    encoder.bindBuffer(uniformInfo.index, bindTarget, slice.buffer, slice.offset);
+  } else {
+    IGL_LOG_ERROR_ONCE("Failed to allocate %zu bytes from the uniform buffer arena\n",
+                       uniformInfo.length);
+  }
+}
+
+void ManagedUniformBuffer::bind(const igl::IDevice& device,
+                                igl::IComputeCommandEncoder& encoder,
+                                UniformBufferArena& arena) {
+  if (device.getBackendType() == igl::BackendType::OpenGL || useBindBytes_) {
+    bind(device, encoder);
+    return;
+  }
+  const UniformBufferArena::Slice slice = arena.allocate(data_, uniformInfo.length);
+  if (slice.buffer) {
+    encoder.bindBuffer(uniformInfo.index, slice.buffer, slice.offset);
+  } else {
+    IGL_LOG_ERROR_ONCE("Failed to allocate %zu bytes from the uniform buffer arena\n",
+                       uniformInfo.length);
+  }
+}
+
 void* ManagedUniformBuffer::getData() {
   return data_;
 }
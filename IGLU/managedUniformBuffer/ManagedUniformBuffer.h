@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <IGLU/managedUniformBuffer/UniformBufferArena.h>
 #include <igl/IGL.h>
 #include <vector>
 
@@ -19,6 +20,8 @@ struct ManagedUniformBufferInfo {
   int index = -1;
   size_t length = 0;
   std::vector<igl::UniformDesc> uniforms;
+  // The buffer is only bound with a UniformBufferArena, so no IBuffer is created for it
+  bool useFrameArena = false;
 };
 
 class ManagedUniformBuffer {
@@ -44,6 +47,16 @@ class ManagedUniformBuffer {
             uint8_t bindTarget); // see igl::BindTarget
   void bind(const igl::IDevice& device, igl::IComputeCommandEncoder& encoder);
 
+  // Same as bind() above, but copies the data to a slice of 'arena' and binds the slice
+  void bind(const igl::IDevice& device,
+            const igl::IRenderPipelineState& pipelineState,
+            igl::IRenderCommandEncoder& encoder,
+            UniformBufferArena& arena,
+            uint8_t bindTarget = igl::BindTarget::kVertex | igl::BindTarget::kFragment);
+  void bind(const igl::IDevice& device,
+            igl::IComputeCommandEncoder& encoder,
+            UniformBufferArena& arena);
+
   void* getData();
 
  private:
@@ -59,5 +72,7 @@ class ManagedUniformBuffer {
   size_t vmAllocLength_ = 0;
 #endif
   bool useBindBytes_ = false;
+  // OpenGL: the unique id of the pipeline the uniform locations were resolved for
+  uint64_t glPipelineId_ = 0;
 };
 } // namespace iglu
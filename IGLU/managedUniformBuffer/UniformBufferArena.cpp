@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#if defined(IGL_UWP_VS_FIX)
+#include <igl/IGLU/managedUniformBuffer/UniformBufferArena.h>
+#else
+#include <IGLU/managedUniformBuffer/UniformBufferArena.h>
+#endif
+
+#include <algorithm>
+
+namespace iglu {
+
+UniformBufferArena::UniformBufferArena(igl::IDevice& device, size_t bufferLength) :
+  device_(device), bufferLength_(bufferLength) {
+  size_t maxUniformBufferBytes = 0;
+  if (device.getFeatureLimits(igl::DeviceFeatureLimits::MaxUniformBufferBytes,
+                              maxUniformBufferBytes) &&
+      maxUniformBufferBytes != 0) {
+    // a slice is bound with the rest of its buffer, which must fit the limit
+    bufferLength_ = std::min(bufferLength_, maxUniformBufferBytes);
+  }
+  if (!device.getFeatureLimits(igl::DeviceFeatureLimits::UniformBufferOffsetAlignment,
+                               alignment_) ||
+      alignment_ == 0) {
+    alignment_ = 256;
+  }
+  if (!IGL_VERIFY(bufferLength_ != 0)) {
+    result.code = igl::Result::Code::ArgumentInvalid;
+  }
+}
+
+void UniformBufferArena::beginFrame() {
+  currentBuffer_ = 0;
+  currentOffset_ = 0;
+}
+
+UniformBufferArena::Slice UniformBufferArena::allocate(const void* data, size_t length) {
+  if (!IGL_VERIFY(length <= bufferLength_)) {
+    return {};
+  }
+
+  size_t offset = (currentOffset_ + alignment_ - 1) / alignment_ * alignment_;
+  if (currentBuffer_ < buffers_.size() && offset + length > bufferLength_) {
+    currentBuffer_++;
+    offset = 0;
+  }
+  if (currentBuffer_ == buffers_.size()) {
+    igl::BufferDesc desc(igl::BufferDesc::BufferTypeBits::Uniform,
+                         nullptr,
+                         bufferLength_,
+                         igl::ResourceStorage::Shared);
+    desc.hint = igl::BufferDesc::BufferAPIHintBits::UniformBlock;
+    if (device_.hasFeature(igl::DeviceFeatures::BufferRing)) {
+      desc.hint |= igl::BufferDesc::BufferAPIHintBits::Ring;
+    }
+    desc.debugName = "UniformBufferArena";
+    std::shared_ptr<igl::IBuffer> buffer = device_.createBuffer(desc, &result);
+    if (!buffer) {
+      return {};
+    }
+    buffers_.push_back(std::move(buffer));
+  }
+
+  const auto& buffer = buffers_[currentBuffer_];
+  buffer->upload(data, {length, offset});
+  currentOffset_ = offset + length;
+  return {buffer, offset};
+}
+
+} // namespace iglu
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace igl {
+class IDevice;
+} // namespace igl
+
+namespace iglu {
+
+/// Bump-allocates uniform data from a few large buffers, so objects whose uniforms are bound
+/// every frame don't need a buffer each (see ManagedUniformBufferInfo::useFrameArena).
+///
+/// Slices are aligned to DeviceFeatureLimits::UniformBufferOffsetAlignment and only valid until
+/// the next beginFrame(). The buffers are ring buffers on devices supporting
+/// DeviceFeatures::BufferRing, with memory for each frame in flight, so a frame's slices are
+/// overwritten only once the GPU is done with that frame. When a buffer is full, allocation
+/// continues in another buffer, which is kept for the following frames.
+class UniformBufferArena {
+ public:
+  struct Slice {
+    std::shared_ptr<igl::IBuffer> buffer;
+    size_t offset = 0;
+  };
+
+  igl::Result result;
+  UniformBufferArena(igl::IDevice& device, size_t bufferLength = 64 * 1024);
+  ~UniformBufferArena() = default;
+
+  /// Call once per frame before the first allocation. Reuses the memory of all slices.
+  void beginFrame();
+
+  /// Copies 'length' bytes of 'data' to a new slice. Returns a slice without buffer if 'length'
+  /// exceeds the buffer length or a buffer could not be created.
+  Slice allocate(const void* data, size_t length);
+
+  size_t getNumBuffers() const {
+    return buffers_.size();
+  }
+
+ private:
+  igl::IDevice& device_;
+  size_t bufferLength_ = 0;
+  size_t alignment_ = 1;
+  std::vector<std::shared_ptr<igl::IBuffer>> buffers_;
+  size_t currentBuffer_ = 0;
+  size_t currentOffset_ = 0;
+};
+
+} // namespace iglu
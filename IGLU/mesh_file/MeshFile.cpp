@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "MeshFile.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace iglu {
+namespace meshfile {
+
+namespace {
+
+constexpr char kMagic[8] = {'I', 'G', 'L', 'M', 'E', 'S', 'H', '\0'};
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t numSections;
+  uint64_t fileSize;
+};
+
+struct SectionEntry {
+  uint32_t type;
+  uint32_t elementSize;
+  uint64_t offset;
+  uint64_t size;
+};
+
+static_assert(sizeof(FileHeader) == 24, "FileHeader must be tightly packed");
+static_assert(sizeof(SectionEntry) == 24, "SectionEntry must be tightly packed");
+
+uint64_t align(uint64_t offset) {
+  return (offset + kSectionAlignment - 1) & ~uint64_t(kSectionAlignment - 1);
+}
+
+} // namespace
+
+void MeshFileWriter::addSection(SectionType type,
+                                const void* data,
+                                size_t size,
+                                uint32_t elementSize) {
+  IGL_ASSERT(data || size == 0);
+  IGL_ASSERT(elementSize != 0 && size % elementSize == 0);
+  sections_.push_back({type, elementSize, data, size});
+}
+
+void MeshFileWriter::addMeshlets(const meshlets::MeshletMesh& mesh) {
+  addSection(SectionType::Meshlets, mesh.meshlets);
+  addSection(SectionType::MeshletBounds, mesh.bounds);
+  addSection(SectionType::MeshletVertices, mesh.vertices);
+  addSection(SectionType::MeshletTriangles, mesh.triangles);
+}
+
+bool MeshFileWriter::write(const std::string& path, igl::Result* outResult) const {
+  std::vector<SectionEntry> entries(sections_.size());
+  uint64_t offset = align(sizeof(FileHeader) + entries.size() * sizeof(SectionEntry));
+  for (size_t i = 0; i != sections_.size(); i++) {
+    entries[i] = {static_cast<uint32_t>(sections_[i].type),
+                  sections_[i].elementSize,
+                  offset,
+                  sections_[i].size};
+    offset = align(offset + sections_[i].size);
+  }
+  FileHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.numSections = static_cast<uint32_t>(entries.size());
+  header.fileSize = offset;
+
+  FILE* file = fopen(path.c_str(), "wb");
+  if (!file) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot create " + path);
+    return false;
+  }
+  const char padding[kSectionAlignment] = {};
+  bool success = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 fwrite(entries.data(), sizeof(SectionEntry), entries.size(), file) ==
+                     entries.size();
+  uint64_t written = sizeof(FileHeader) + entries.size() * sizeof(SectionEntry);
+  for (size_t i = 0; success && i != sections_.size(); i++) {
+    const size_t numPadding = static_cast<size_t>(entries[i].offset - written);
+    success = fwrite(padding, 1, numPadding, file) == numPadding &&
+              fwrite(sections_[i].data, 1, sections_[i].size, file) == sections_[i].size;
+    written = entries[i].offset + sections_[i].size;
+  }
+  // pad the last section, so every section can be read in whole multiples of the alignment
+  const size_t numPadding = static_cast<size_t>(header.fileSize - written);
+  success = success && fwrite(padding, 1, numPadding, file) == numPadding;
+  success = fclose(file) == 0 && success;
+  if (!success) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot write " + path);
+    return false;
+  }
+  igl::Result::setOk(outResult);
+  return true;
+}
+
+std::unique_ptr<MeshFile> MeshFile::open(const std::string& path, igl::Result* outResult) {
+  std::unique_ptr<MeshFile> meshFile(new MeshFile());
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+  LARGE_INTEGER fileSize = {};
+  if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+    if (file != INVALID_HANDLE_VALUE) {
+      CloseHandle(file);
+    }
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot open " + path);
+    return nullptr;
+  }
+  meshFile->size_ = static_cast<size_t>(fileSize.QuadPart);
+  if (meshFile->size_ >= sizeof(FileHeader)) {
+    meshFile->mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (meshFile->mapping_) {
+      meshFile->data_ = static_cast<const uint8_t*>(
+          MapViewOfFile(meshFile->mapping_, FILE_MAP_READ, 0, 0, meshFile->size_));
+    }
+  }
+  CloseHandle(file);
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  struct stat st = {};
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot open " + path);
+    return nullptr;
+  }
+  meshFile->size_ = static_cast<size_t>(st.st_size);
+  if (meshFile->size_ >= sizeof(FileHeader)) {
+    void* data = mmap(nullptr, meshFile->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      meshFile->data_ = static_cast<const uint8_t*>(data);
+    }
+  }
+  // the mapping keeps the file alive
+  close(fd);
+#endif
+
+  if (meshFile->size_ < sizeof(FileHeader)) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, path + " is truncated");
+    return nullptr;
+  }
+  if (!meshFile->data_) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot map " + path);
+    return nullptr;
+  }
+
+  FileHeader header;
+  std::memcpy(&header, meshFile->data_, sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, path + " is not a compatible mesh file");
+    return nullptr;
+  }
+  const uint64_t tableEnd =
+      sizeof(FileHeader) + uint64_t(header.numSections) * sizeof(SectionEntry);
+  if (header.fileSize != meshFile->size_ || tableEnd > meshFile->size_) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, path + " is truncated");
+    return nullptr;
+  }
+
+  meshFile->sections_.resize(header.numSections);
+  const auto* entries = reinterpret_cast<const SectionEntry*>(meshFile->data_ + sizeof(header));
+  for (uint32_t i = 0; i != header.numSections; i++) {
+    const SectionEntry& entry = entries[i];
+    if (entry.offset % kSectionAlignment != 0 || entry.offset < tableEnd ||
+        entry.offset > meshFile->size_ || entry.size > meshFile->size_ - entry.offset ||
+        entry.elementSize == 0 || entry.size % entry.elementSize != 0) {
+      igl::Result::setResult(
+          outResult, igl::Result::Code::ArgumentInvalid, path + " has an invalid section");
+      return nullptr;
+    }
+    meshFile->sections_[i] = {static_cast<SectionType>(entry.type),
+                              entry.elementSize,
+                              meshFile->data_ + entry.offset,
+                              static_cast<size_t>(entry.size)};
+  }
+
+  igl::Result::setOk(outResult);
+  return meshFile;
+}
+
+MeshFile::~MeshFile() {
+#if defined(_WIN32)
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_) {
+    CloseHandle(mapping_);
+  }
+#else
+  if (data_) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+  }
+#endif
+}
+
+const Section* MeshFile::getSection(SectionType type) const {
+  for (const Section& section : sections_) {
+    if (section.type == type) {
+      return &section;
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<igl::IBuffer> MeshFile::createBuffer(igl::IDevice& device,
+                                                     SectionType type,
+                                                     igl::BufferDesc::BufferType bufferType,
+                                                     igl::ResourceStorage storage,
+                                                     igl::Result* outResult) const {
+  const Section* section = getSection(type);
+  if (!section || section->size == 0) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "The mesh file has no such section");
+    return nullptr;
+  }
+  return device.createBuffer(igl::BufferDesc(bufferType, section->data, section->size, storage),
+                             outResult);
+}
+
+bool MeshFile::readMeshlets(meshlets::MeshletMesh& outMesh) const {
+  outMesh = {};
+  const Section* meshletSection = getSection(SectionType::Meshlets);
+  const Section* boundsSection = getSection(SectionType::MeshletBounds);
+  const Section* vertexSection = getSection(SectionType::MeshletVertices);
+  const Section* triangleSection = getSection(SectionType::MeshletTriangles);
+  if (!meshletSection || !boundsSection || !vertexSection || !triangleSection ||
+      meshletSection->elementSize != sizeof(meshlets::Meshlet) ||
+      boundsSection->elementSize != sizeof(meshlets::MeshletBounds) ||
+      vertexSection->elementSize != sizeof(uint32_t) || triangleSection->elementSize != 1 ||
+      meshletSection->count() != boundsSection->count()) {
+    return false;
+  }
+
+  const auto* meshletData = static_cast<const meshlets::Meshlet*>(meshletSection->data);
+  const auto* boundsData = static_cast<const meshlets::MeshletBounds*>(boundsSection->data);
+  const auto* vertexData = static_cast<const uint32_t*>(vertexSection->data);
+  const auto* triangleData = static_cast<const uint8_t*>(triangleSection->data);
+  meshlets::MeshletMesh mesh;
+  mesh.meshlets.assign(meshletData, meshletData + meshletSection->count());
+  mesh.bounds.assign(boundsData, boundsData + boundsSection->count());
+  mesh.vertices.assign(vertexData, vertexData + vertexSection->count());
+  mesh.triangles.assign(triangleData, triangleData + triangleSection->count());
+  for (const meshlets::Meshlet& m : mesh.meshlets) {
+    if (uint64_t(m.vertexOffset) + m.vertexCount > mesh.vertices.size() ||
+        uint64_t(m.triangleOffset) + uint64_t(m.triangleCount) * 3 > mesh.triangles.size()) {
+      return false;
+    }
+  }
+  outMesh = std::move(mesh);
+  return true;
+}
+
+} // namespace meshfile
+} // namespace iglu
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/meshlets/Meshlets.h>
+#include <igl/IGL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace meshfile {
+
+/// Well-known sections of a mesh file. Applications can store their own data in sections from
+/// SectionType::User on.
+enum class SectionType : uint32_t {
+  Vertices = 1,
+  Indices = 2,
+  Materials = 3,
+  Meshlets = 4,
+  MeshletBounds = 5,
+  MeshletVertices = 6,
+  MeshletTriangles = 7,
+  User = 0x1000,
+};
+
+/// A section of a mesh file: 'size' bytes of elements of 'elementSize' bytes each.
+struct Section {
+  SectionType type = SectionType::User;
+  uint32_t elementSize = 1;
+  const void* data = nullptr;
+  size_t size = 0;
+
+  [[nodiscard]] size_t count() const {
+    return elementSize ? size / elementSize : 0;
+  }
+};
+
+/// The data of each section starts at a multiple of kSectionAlignment bytes, so sections can be
+/// uploaded as buffers or read as arrays of aligned structures straight from the mapped file.
+constexpr size_t kSectionAlignment = 256;
+
+/**
+ * @brief Writes a versioned mesh file made of typed sections.
+ *
+ * The writer only references the data of the sections, which must stay valid until write()
+ * returns. Files are written in the byte order of the host; all supported platforms are little
+ * endian.
+ */
+class MeshFileWriter final {
+ public:
+  void addSection(SectionType type, const void* data, size_t size, uint32_t elementSize = 1);
+
+  template<typename T>
+  void addSection(SectionType type, const std::vector<T>& data) {
+    addSection(type, data.data(), data.size() * sizeof(T), sizeof(T));
+  }
+
+  /// Adds the 4 meshlet sections of 'mesh'.
+  void addMeshlets(const meshlets::MeshletMesh& mesh);
+
+  bool write(const std::string& path, igl::Result* outResult) const;
+
+ private:
+  std::vector<Section> sections_;
+};
+
+/**
+ * @brief A memory-mapped mesh file written by MeshFileWriter.
+ *
+ * Opening a file only maps it and validates its section table; no section data is read or
+ * copied. Section data points into the mapping, which lives as long as the MeshFile, and can be
+ * passed directly to igl::IDevice::createBuffer() or igl::IBuffer::upload(). Pages are loaded
+ * by the OS as the GPU upload touches them.
+ */
+class MeshFile final {
+ public:
+  /// Returns nullptr if the file cannot be mapped or was not written by a compatible
+  /// MeshFileWriter.
+  static std::unique_ptr<MeshFile> open(const std::string& path, igl::Result* outResult);
+
+  ~MeshFile();
+  MeshFile(const MeshFile&) = delete;
+  MeshFile& operator=(const MeshFile&) = delete;
+
+  /// Returns the first section of 'type', or nullptr if there is none.
+  [[nodiscard]] const Section* getSection(SectionType type) const;
+
+  [[nodiscard]] const std::vector<Section>& getSections() const {
+    return sections_;
+  }
+
+  /// Creates a buffer initialized with the section of 'type' straight from the mapping.
+  std::shared_ptr<igl::IBuffer> createBuffer(igl::IDevice& device,
+                                             SectionType type,
+                                             igl::BufferDesc::BufferType bufferType,
+                                             igl::ResourceStorage storage,
+                                             igl::Result* outResult) const;
+
+  /// Copies the meshlet sections into 'outMesh'. Returns false if any of them is missing or
+  /// inconsistent. Meshlets are small compared to the vertex data, so a copy is cheap.
+  bool readMeshlets(meshlets::MeshletMesh& outMesh) const;
+
+ private:
+  MeshFile() = default;
+
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  // platform handle keeping the mapping alive, if any
+  void* mapping_ = nullptr;
+  std::vector<Section> sections_;
+};
+
+} // namespace meshfile
+} // namespace iglu
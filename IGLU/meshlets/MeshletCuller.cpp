@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "MeshletCuller.h"
+
+#include <IGLU/glsl/StorageBuffers.h>
+#include <IGLU/simdtypes/SimdBatch.h>
+#include <igl/ShaderCreator.h>
+#include <string>
+
+namespace iglu {
+namespace meshlets {
+
+namespace {
+
+constexpr uint32_t kThreadgroupSize = 64;
+
+constexpr size_t kParamsIndex = 0;
+constexpr size_t kBoundsIndex = 1;
+constexpr size_t kCommandsIndex = 2;
+
+const char kGlslBody[] = R"(
+struct Bounds {
+  vec4 sphere;
+  vec4 cone;
+};
+
+struct DrawCommand {
+  uint count;
+  uint instanceCount;
+  uint firstIndex;
+  int baseVertex;
+  uint baseInstance;
+};
+
+PARAMS_BUFFER readonly buffer Params {
+  vec4 planes[6];
+  vec4 cameraPosition;
+  uint numMeshlets;
+} params;
+BOUNDS_BUFFER readonly buffer Bounds {
+  Bounds bounds[];
+};
+COMMANDS_BUFFER buffer Commands {
+  DrawCommand commands[];
+};
+
+void main() {
+  uint id = gl_GlobalInvocationID.x;
+  if (id >= params.numMeshlets) {
+    return;
+  }
+  vec4 sphere = bounds[id].sphere;
+  for (int i = 0; i < 6; i++) {
+    if (dot(params.planes[i].xyz, sphere.xyz) + params.planes[i].w < -sphere.w) {
+      return;
+    }
+  }
+  vec4 cone = bounds[id].cone;
+  vec3 view = sphere.xyz - params.cameraPosition.xyz;
+  if (dot(view, cone.xyz) >= cone.w * length(view) + sphere.w) {
+    return;
+  }
+  commands[id].instanceCount = 1u;
+}
+)";
+
+std::string getGlslSource(bool isVulkan) {
+  return glsl::computeShaderPrologue(isVulkan, kThreadgroupSize) +
+         glsl::defineStorageBuffer("PARAMS_BUFFER", isVulkan, kParamsIndex) +
+         glsl::defineStorageBuffer("BOUNDS_BUFFER", isVulkan, kBoundsIndex) +
+         glsl::defineStorageBuffer("COMMANDS_BUFFER", isVulkan, kCommandsIndex) + kGlslBody;
+}
+
+const char kMetalSource[] = R"(
+#include <metal_stdlib>
+using namespace metal;
+
+struct Bounds {
+  float4 sphere;
+  float4 cone;
+};
+
+struct DrawCommand {
+  uint count;
+  uint instanceCount;
+  uint firstIndex;
+  int baseVertex;
+  uint baseInstance;
+};
+
+struct Params {
+  float4 planes[6];
+  float4 cameraPosition;
+  uint numMeshlets;
+};
+
+kernel void cullMeshlets(constant Params& params [[buffer(0)]],
+                         const device Bounds* bounds [[buffer(1)]],
+                         device DrawCommand* commands [[buffer(2)]],
+                         uint id [[thread_position_in_grid]]) {
+  if (id >= params.numMeshlets) {
+    return;
+  }
+  const float4 sphere = bounds[id].sphere;
+  for (int i = 0; i < 6; i++) {
+    if (dot(params.planes[i].xyz, sphere.xyz) + params.planes[i].w < -sphere.w) {
+      return;
+    }
+  }
+  const float4 cone = bounds[id].cone;
+  const float3 view = sphere.xyz - params.cameraPosition.xyz;
+  if (dot(view, cone.xyz) >= cone.w * length(view) + sphere.w) {
+    return;
+  }
+  commands[id].instanceCount = 1;
+}
+)";
+
+std::shared_ptr<igl::IBuffer> createBuffer(igl::IDevice& device,
+                                           igl::BufferDesc::BufferType type,
+                                           const void* data,
+                                           size_t length,
+                                           bool isPerFrame,
+                                           const char* debugName,
+                                           igl::Result* outResult) {
+  igl::BufferDesc desc(type, data, length, igl::ResourceStorage::Shared);
+  if (isPerFrame && device.hasFeature(igl::DeviceFeatures::BufferRing)) {
+    // cull() uploads the view parameters and resets the draw commands every frame
+    desc.hint |= igl::BufferDesc::BufferAPIHintBits::Ring;
+  }
+  desc.debugName = debugName;
+  return device.createBuffer(desc, outResult);
+}
+
+} // namespace
+
+MeshletCuller::MeshletCuller(igl::IDevice& device,
+                             const MeshletMesh& mesh,
+                             igl::Result* outResult) {
+  if (!device.hasFeature(igl::DeviceFeatures::Compute) ||
+      !device.hasFeature(igl::DeviceFeatures::DrawIndexedIndirect)) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::Unsupported,
+                           "Meshlet culling requires compute and indirect draws");
+    return;
+  }
+  if (mesh.meshlets.empty() || mesh.meshlets.size() != mesh.bounds.size()) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "No meshlets or bounds to cull");
+    return;
+  }
+
+  // the meshlets follow each other in the index buffer returned by buildIndexBuffer()
+  commands_.resize(mesh.meshlets.size());
+  uint32_t firstIndex = 0;
+  for (size_t i = 0; i != mesh.meshlets.size(); i++) {
+    const uint32_t count = mesh.meshlets[i].triangleCount * 3;
+    commands_[i] = {count, 0, firstIndex, 0, 0};
+    firstIndex += count;
+  }
+
+  igl::Result result;
+  boundsBuffer_ = createBuffer(device,
+                               igl::BufferDesc::BufferTypeBits::Storage,
+                               mesh.bounds.data(),
+                               mesh.bounds.size() * sizeof(MeshletBounds),
+                               false,
+                               "MeshletCuller bounds",
+                               &result);
+  if (result.isOk()) {
+    paramsBuffer_ = createBuffer(device,
+                                 igl::BufferDesc::BufferTypeBits::Storage,
+                                 nullptr,
+                                 sizeof(Params),
+                                 true,
+                                 "MeshletCuller params",
+                                 &result);
+  }
+  if (result.isOk()) {
+    commandBuffer_ = createBuffer(device,
+                                  igl::BufferDesc::BufferTypeBits::Storage |
+                                      igl::BufferDesc::BufferTypeBits::Indirect,
+                                  commands_.data(),
+                                  commands_.size() * sizeof(DrawCommand),
+                                  true,
+                                  "MeshletCuller commands",
+                                  &result);
+  }
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  const auto backendType = device.getBackendType();
+  const std::string glslSource = getGlslSource(backendType == igl::BackendType::Vulkan);
+  const bool isMetal = backendType == igl::BackendType::Metal;
+  std::shared_ptr<igl::IShaderStages> stages =
+      igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                      isMetal ? kMetalSource : glslSource.c_str(),
+                                                      isMetal ? "cullMeshlets" : "main",
+                                                      "MeshletCuller",
+                                                      &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  igl::ComputePipelineDesc desc;
+  desc.shaderStages = std::move(stages);
+  desc.buffersMap[kParamsIndex] = igl::genNameHandle("Params");
+  desc.buffersMap[kBoundsIndex] = igl::genNameHandle("Bounds");
+  desc.buffersMap[kCommandsIndex] = igl::genNameHandle("Commands");
+  desc.debugName = "MeshletCuller";
+  pipelineState_ = device.createComputePipeline(desc, outResult);
+}
+
+void MeshletCuller::cull(igl::ICommandBuffer& commandBuffer,
+                         const simdtypes::float4x4& modelViewProjection,
+                         const simdtypes::float3& cameraPosition,
+                         bool zeroToOneDepth) {
+  if (!IGL_VERIFY(pipelineState_)) {
+    return;
+  }
+
+  Params params = {};
+  simdtypes::getFrustumPlanes(modelViewProjection, zeroToOneDepth, params.planes);
+  params.cameraPosition =
+      simdtypes::float4{cameraPosition[0], cameraPosition[1], cameraPosition[2], 1.0f};
+  params.numMeshlets = getNumMeshlets();
+  paramsBuffer_->upload(&params, {sizeof(params), 0});
+  // the dispatch only marks the visible meshlets
+  commandBuffer_->upload(commands_.data(), {commands_.size() * sizeof(DrawCommand), 0});
+
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("MeshletCuller::cull()");
+  encoder->bindComputePipelineState(pipelineState_);
+  encoder->bindBuffer(kParamsIndex, paramsBuffer_, 0);
+  encoder->bindBuffer(kBoundsIndex, boundsBuffer_, 0);
+  encoder->bindBuffer(kCommandsIndex, commandBuffer_, 0);
+  encoder->dispatchThreadGroups(
+      igl::Dimensions((params.numMeshlets + kThreadgroupSize - 1) / kThreadgroupSize, 1, 1),
+      igl::Dimensions(kThreadgroupSize, 1, 1));
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+void MeshletCuller::draw(igl::IRenderCommandEncoder& commandEncoder,
+                         igl::PrimitiveType primitiveType,
+                         igl::IBuffer& indexBuffer) const {
+  if (!IGL_VERIFY(commandBuffer_)) {
+    return;
+  }
+  commandEncoder.multiDrawIndexedIndirect(primitiveType,
+                                          igl::IndexFormat::UInt32,
+                                          indexBuffer,
+                                          *commandBuffer_,
+                                          0,
+                                          getNumMeshlets(),
+                                          sizeof(DrawCommand));
+}
+
+} // namespace meshlets
+} // namespace iglu
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/meshlets/Meshlets.h>
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace meshlets {
+
+/**
+ * @brief Culls the meshlets of a mesh on the GPU and draws the visible ones with a single
+ * multi-draw.
+ *
+ * Every frame, cull() records a compute dispatch which tests the bounding sphere of each meshlet
+ * against the view frustum and its normal cone against the camera position. It writes one
+ * indexed indirect draw command per meshlet, with an instance count of 1 when the meshlet is
+ * visible and 0 otherwise. draw() issues them with one multiDrawIndexedIndirect() over the index
+ * buffer returned by buildIndexBuffer(). There is no indirect draw count in IGL, so culled
+ * meshlets are not compacted away; their commands just draw nothing.
+ *
+ * IGL has no mesh shader stages, so meshlets are rasterized through the regular vertex pipeline.
+ * The meshlet arrays keep the layout mesh shaders consume for when they are exposed.
+ *
+ * Requires igl::DeviceFeatures::Compute and igl::DeviceFeatures::DrawIndexedIndirect.
+ */
+class MeshletCuller final {
+ public:
+  MeshletCuller(igl::IDevice& device, const MeshletMesh& mesh, igl::Result* outResult);
+
+  /// Records the culling dispatch into 'commandBuffer'. Must be called outside of render passes
+  /// and before the render pass calling draw() in the same command buffer. 'cameraPosition' is
+  /// in the model space of the mesh. 'zeroToOneDepth' is true for clip spaces with a depth range
+  /// of [0, 1] (Metal, Vulkan) and false for [-1, 1] (OpenGL).
+  void cull(igl::ICommandBuffer& commandBuffer,
+            const simdtypes::float4x4& modelViewProjection,
+            const simdtypes::float3& cameraPosition,
+            bool zeroToOneDepth);
+
+  /// Draws the meshlets which passed the last cull(). 'indexBuffer' holds the uint32_t indices
+  /// returned by buildIndexBuffer() for the mesh.
+  void draw(igl::IRenderCommandEncoder& commandEncoder,
+            igl::PrimitiveType primitiveType,
+            igl::IBuffer& indexBuffer) const;
+
+  /// One draw command of igl::IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE bytes per meshlet.
+  [[nodiscard]] const std::shared_ptr<igl::IBuffer>& getIndirectBuffer() const {
+    return commandBuffer_;
+  }
+
+  [[nodiscard]] uint32_t getNumMeshlets() const {
+    return static_cast<uint32_t>(commands_.size());
+  }
+
+ private:
+  struct DrawCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+  };
+  static_assert(sizeof(DrawCommand) == igl::IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE,
+                "DrawCommand must match the indirect draw command layout");
+
+  struct Params {
+    simdtypes::float4 planes[6];
+    simdtypes::float4 cameraPosition;
+    uint32_t numMeshlets;
+    uint32_t padding[3];
+  };
+
+  std::shared_ptr<igl::IComputePipelineState> pipelineState_;
+  std::shared_ptr<igl::IBuffer> paramsBuffer_;
+  std::shared_ptr<igl::IBuffer> boundsBuffer_;
+  std::shared_ptr<igl::IBuffer> commandBuffer_;
+  // the commands with an instance count of 0, uploaded before each dispatch
+  std::vector<DrawCommand> commands_;
+};
+
+} // namespace meshlets
+} // namespace iglu
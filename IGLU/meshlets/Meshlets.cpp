@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Meshlets.h"
+
+#include <cstring>
+#include <igl/Core.h>
+#include <meshoptimizer.h>
+
+namespace iglu {
+namespace meshlets {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x4d4c4749; // "IGLM"
+constexpr uint32_t kVersion = 1;
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t numMeshlets;
+  uint32_t numVertices;
+  uint32_t numTriangleBytes;
+};
+
+static_assert(sizeof(Meshlet) == sizeof(meshopt_Meshlet), "Meshlet must match meshopt_Meshlet");
+static_assert(sizeof(MeshletBounds) == 32, "MeshletBounds must be tightly packed");
+
+template<typename T>
+void append(std::vector<uint8_t>& data, const T* values, size_t count) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(values);
+  data.insert(data.end(), bytes, bytes + count * sizeof(T));
+}
+
+template<typename T>
+bool read(const uint8_t*& data, const uint8_t* end, std::vector<T>& values, size_t count) {
+  if (static_cast<size_t>(end - data) / sizeof(T) < count) {
+    return false;
+  }
+  values.resize(count);
+  if (count) {
+    std::memcpy(values.data(), data, count * sizeof(T));
+  }
+  data += count * sizeof(T);
+  return true;
+}
+
+} // namespace
+
+MeshletMesh buildMeshlets(const uint32_t* indices,
+                          size_t indexCount,
+                          const float* positions,
+                          size_t vertexCount,
+                          size_t positionStride,
+                          const BuildOptions& options) {
+  MeshletMesh mesh;
+  if (!indices || !positions || indexCount < 3) {
+    return mesh;
+  }
+
+  const size_t maxMeshlets =
+      meshopt_buildMeshletsBound(indexCount, options.maxVertices, options.maxTriangles);
+  std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
+  mesh.vertices.resize(maxMeshlets * options.maxVertices);
+  mesh.triangles.resize(maxMeshlets * options.maxTriangles * 3);
+  const size_t numMeshlets = meshopt_buildMeshlets(meshlets.data(),
+                                                   mesh.vertices.data(),
+                                                   mesh.triangles.data(),
+                                                   indices,
+                                                   indexCount,
+                                                   positions,
+                                                   vertexCount,
+                                                   positionStride,
+                                                   options.maxVertices,
+                                                   options.maxTriangles,
+                                                   options.coneWeight);
+  if (numMeshlets == 0) {
+    return {};
+  }
+
+  // trim the worst case allocations: the triangles of each meshlet are padded to 4 bytes
+  const meshopt_Meshlet& last = meshlets[numMeshlets - 1];
+  mesh.vertices.resize(last.vertex_offset + last.vertex_count);
+  mesh.triangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3u));
+
+  mesh.meshlets.resize(numMeshlets);
+  mesh.bounds.resize(numMeshlets);
+  for (size_t i = 0; i != numMeshlets; i++) {
+    const meshopt_Meshlet& m = meshlets[i];
+    mesh.meshlets[i] = {m.vertex_offset, m.triangle_offset, m.vertex_count, m.triangle_count};
+    const meshopt_Bounds b = meshopt_computeMeshletBounds(&mesh.vertices[m.vertex_offset],
+                                                          &mesh.triangles[m.triangle_offset],
+                                                          m.triangle_count,
+                                                          positions,
+                                                          vertexCount,
+                                                          positionStride);
+    mesh.bounds[i].sphere = simdtypes::float4{b.center[0], b.center[1], b.center[2], b.radius};
+    mesh.bounds[i].cone =
+        simdtypes::float4{b.cone_axis[0], b.cone_axis[1], b.cone_axis[2], b.cone_cutoff};
+  }
+  return mesh;
+}
+
+std::vector<uint32_t> buildIndexBuffer(const MeshletMesh& mesh) {
+  std::vector<uint32_t> indices;
+  if (mesh.meshlets.empty()) {
+    return indices;
+  }
+  size_t numIndices = 0;
+  for (const Meshlet& m : mesh.meshlets) {
+    numIndices += size_t(m.triangleCount) * 3;
+  }
+  indices.reserve(numIndices);
+  for (const Meshlet& m : mesh.meshlets) {
+    const uint32_t* vertices = &mesh.vertices[m.vertexOffset];
+    const uint8_t* triangles = &mesh.triangles[m.triangleOffset];
+    for (uint32_t i = 0; i != m.triangleCount * 3; i++) {
+      indices.push_back(vertices[triangles[i]]);
+    }
+  }
+  return indices;
+}
+
+std::vector<uint8_t> serialize(const MeshletMesh& mesh) {
+  IGL_ASSERT(mesh.meshlets.size() == mesh.bounds.size());
+  const Header header = {kMagic,
+                         kVersion,
+                         static_cast<uint32_t>(mesh.meshlets.size()),
+                         static_cast<uint32_t>(mesh.vertices.size()),
+                         static_cast<uint32_t>(mesh.triangles.size())};
+  std::vector<uint8_t> data;
+  data.reserve(sizeof(Header) + mesh.meshlets.size() * (sizeof(Meshlet) + sizeof(MeshletBounds)) +
+               mesh.vertices.size() * sizeof(uint32_t) + mesh.triangles.size());
+  append(data, &header, 1);
+  append(data, mesh.meshlets.data(), mesh.meshlets.size());
+  append(data, mesh.bounds.data(), mesh.bounds.size());
+  append(data, mesh.vertices.data(), mesh.vertices.size());
+  append(data, mesh.triangles.data(), mesh.triangles.size());
+  return data;
+}
+
+bool deserialize(const uint8_t* data, size_t length, MeshletMesh& outMesh) {
+  outMesh = {};
+  if (!data || length < sizeof(Header)) {
+    return false;
+  }
+  Header header;
+  std::memcpy(&header, data, sizeof(Header));
+  if (header.magic != kMagic || header.version != kVersion) {
+    return false;
+  }
+
+  const uint8_t* cur = data + sizeof(Header);
+  const uint8_t* end = data + length;
+  MeshletMesh mesh;
+  if (!read(cur, end, mesh.meshlets, header.numMeshlets) ||
+      !read(cur, end, mesh.bounds, header.numMeshlets) ||
+      !read(cur, end, mesh.vertices, header.numVertices) ||
+      !read(cur, end, mesh.triangles, header.numTriangleBytes)) {
+    return false;
+  }
+  // reject meshlets pointing outside of the arrays
+  for (const Meshlet& m : mesh.meshlets) {
+    if (uint64_t(m.vertexOffset) + m.vertexCount > mesh.vertices.size() ||
+        uint64_t(m.triangleOffset) + uint64_t(m.triangleCount) * 3 > mesh.triangles.size()) {
+      return false;
+    }
+    for (uint32_t i = 0; i != m.triangleCount * 3; i++) {
+      if (mesh.triangles[m.triangleOffset + i] >= m.vertexCount) {
+        return false;
+      }
+    }
+  }
+  outMesh = std::move(mesh);
+  return true;
+}
+
+} // namespace meshlets
+} // namespace iglu
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace iglu {
+namespace meshlets {
+
+/// A cluster of up to BuildOptions::maxVertices vertices and BuildOptions::maxTriangles
+/// triangles. The vertices of a meshlet are indices into the vertex buffer of the mesh, stored
+/// in MeshletMesh::vertices at 'vertexOffset'. Its triangles are 3 bytes each, indexing the
+/// vertices of the meshlet, stored in MeshletMesh::triangles at the byte offset 'triangleOffset'.
+struct Meshlet {
+  uint32_t vertexOffset = 0;
+  uint32_t triangleOffset = 0;
+  uint32_t vertexCount = 0;
+  uint32_t triangleCount = 0;
+};
+
+/// Culling bounds of a meshlet in the model space of the mesh, laid out for GPU buffers.
+/// 'sphere' is the bounding sphere (center, radius). 'cone' is the normal cone (axis, cutoff):
+/// the meshlet is back facing, and can be culled, for camera positions where
+/// dot(center - camera, axis) >= cutoff * length(center - camera) + radius.
+struct MeshletBounds {
+  simdtypes::float4 sphere = {};
+  simdtypes::float4 cone = {};
+};
+
+struct BuildOptions {
+  /// Limits of a meshlet; 64 vertices and 124 triangles fit the recommended mesh shader
+  /// workgroup outputs on most GPUs.
+  size_t maxVertices = 64;
+  size_t maxTriangles = 124;
+  /// Between 0 and 1. Higher values produce meshlets with tighter normal cones, which are culled
+  /// more often, at the cost of looser bounding spheres.
+  float coneWeight = 0.25f;
+};
+
+struct MeshletMesh {
+  std::vector<Meshlet> meshlets;
+  std::vector<MeshletBounds> bounds;
+  std::vector<uint32_t> vertices;
+  std::vector<uint8_t> triangles;
+};
+
+/// Splits an indexed triangle list into meshlets with meshoptimizer and computes their bounds.
+/// 'positions' points to 'vertexCount' vertices of 'positionStride' bytes, each starting with 3
+/// floats. For the best results, optimize the vertex cache order of 'indices' first.
+MeshletMesh buildMeshlets(const uint32_t* indices,
+                          size_t indexCount,
+                          const float* positions,
+                          size_t vertexCount,
+                          size_t positionStride,
+                          const BuildOptions& options = {});
+
+/// Expands the meshlets back into a triangle list indexing the vertex buffer of the mesh, where
+/// the triangles of each meshlet follow the ones of the previous meshlet. The meshlets can then
+/// be drawn as ranges of this index buffer on GPUs without mesh shaders.
+std::vector<uint32_t> buildIndexBuffer(const MeshletMesh& mesh);
+
+/// Serializes the meshlets into a versioned, little endian binary blob, so they can be built
+/// offline and cached next to the mesh.
+std::vector<uint8_t> serialize(const MeshletMesh& mesh);
+
+/// Reads meshlets written by serialize(). Returns false if 'data' was not produced by a
+/// compatible version of serialize() or is truncated, in which case 'outMesh' is left empty.
+bool deserialize(const uint8_t* data, size_t length, MeshletMesh& outMesh);
+
+} // namespace meshlets
+} // namespace iglu
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "RenderTargetPool.h"
+
+#include <algorithm>
+#include <igl/Common.h>
+
+namespace iglu {
+namespace rendertargetpool {
+
+namespace {
+// pooled textures are shared by render targets with different names
+igl::TextureDesc getPoolKey(igl::TextureDesc desc) {
+  desc.debugName.clear();
+  return desc;
+}
+} // namespace
+
+void RenderTargetPool::updateCompletedFrames() {
+  // command buffers complete in submission order
+  while (!pendingFrames_.empty() && pendingFrames_.front().commandBuffer->isCompleted()) {
+    numCompletedFrames_ = pendingFrames_.front().frame + 1;
+    pendingFrames_.pop_front();
+  }
+  if (pendingFrames_.empty()) {
+    numCompletedFrames_ = frame_;
+  }
+}
+
+bool RenderTargetPool::isFree(const PooledTexture& pooled) const {
+  // textures released within the current frame can be reused by its later passes
+  return !pooled.isAcquired &&
+         (pooled.retireFrame < numCompletedFrames_ || pooled.retireFrame == frame_);
+}
+
+std::shared_ptr<igl::ITexture> RenderTargetPool::acquire(const igl::TextureDesc& desc,
+                                                         igl::Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  updateCompletedFrames();
+
+  const igl::TextureDesc key = getPoolKey(desc);
+  for (auto& pooled : textures_) {
+    if (isFree(pooled) && pooled.desc == key) {
+      pooled.isAcquired = true;
+      pooled.lastAcquiredFrame = frame_;
+      igl::Result::setOk(outResult);
+      return pooled.texture;
+    }
+  }
+
+  auto texture = device_.createTexture(desc, outResult);
+  if (!texture) {
+    return nullptr;
+  }
+  numAllocations_++;
+  textures_.push_back({texture, key, true, frame_, frame_});
+  return texture;
+}
+
+void RenderTargetPool::release(const std::shared_ptr<igl::ITexture>& texture) {
+  for (auto& pooled : textures_) {
+    if (pooled.texture == texture) {
+      IGL_ASSERT_MSG(pooled.isAcquired, "The texture was not acquired");
+      pooled.isAcquired = false;
+      pooled.retireFrame = frame_;
+      return;
+    }
+  }
+  IGL_ASSERT_MSG(false, "The texture does not belong to this pool");
+}
+
+void RenderTargetPool::endFrame(std::shared_ptr<igl::ICommandBuffer> commandBuffer) {
+  IGL_PROFILER_FUNCTION();
+
+  for (auto& pooled : textures_) {
+    if (pooled.isAcquired || pooled.retireFrame == frame_) {
+      pooled.isAcquired = false;
+      pooled.retireFrame = frame_;
+    }
+  }
+
+  if (commandBuffer) {
+    pendingFrames_.push_back({std::move(commandBuffer), frame_});
+  }
+  frame_++;
+
+  // the backends defer the destruction of textures which are still in use by the GPU
+  textures_.erase(std::remove_if(textures_.begin(),
+                                 textures_.end(),
+                                 [this](const PooledTexture& pooled) {
+                                   return pooled.lastAcquiredFrame + maxIdleFrames_ < frame_;
+                                 }),
+                  textures_.end());
+}
+
+void RenderTargetPool::clear() {
+  textures_.erase(
+      std::remove_if(textures_.begin(),
+                     textures_.end(),
+                     [](const PooledTexture& pooled) { return !pooled.isAcquired; }),
+      textures_.end());
+}
+
+} // namespace rendertargetpool
+} // namespace iglu
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace rendertargetpool {
+
+/**
+ * @brief Hands out render target textures for a frame and recycles them in later frames.
+ *
+ * Textures are keyed by their igl::TextureDesc (type, size, format, usage, samples, mips, storage;
+ * the debug name is ignored). A texture acquired in a frame is returned to the pool by endFrame()
+ * and is reused once the command buffer submitted last in that frame has completed, so steady-state
+ * frames do not allocate textures and the chains of post-processing passes share them. Textures
+ * which were not acquired for `maxIdleFrames` frames are released, e.g. the textures of the old
+ * size after a resize.
+ *
+ * Usage per frame:
+ *   auto target = pool.acquire(desc, &result); // as many times as needed
+ *   ... render into `target`, submit the command buffers of the frame ...
+ *   pool.endFrame(lastCommandBuffer);
+ *
+ * The pool is not thread-safe.
+ */
+class RenderTargetPool final {
+ public:
+  explicit RenderTargetPool(igl::IDevice& device, uint32_t maxIdleFrames = 8) :
+    device_(device), maxIdleFrames_(maxIdleFrames) {}
+
+  /// Returns a free texture matching `desc`, or creates one. The texture belongs to the caller
+  /// until release() or the end of the frame.
+  std::shared_ptr<igl::ITexture> acquire(const igl::TextureDesc& desc,
+                                         igl::Result* IGL_NULLABLE outResult);
+
+  /// Returns `texture` before the end of the frame, so that the remaining passes of the frame can
+  /// acquire it again. Commands are executed in submission order, so the earlier passes of the
+  /// frame are done with it by then.
+  void release(const std::shared_ptr<igl::ITexture>& texture);
+
+  /// Ends the frame: every texture acquired in it is reused once `commandBuffer`, the command
+  /// buffer submitted last in the frame, has completed. A null command buffer makes the textures
+  /// reusable right away, for callers which only use the pool on one queue.
+  void endFrame(std::shared_ptr<igl::ICommandBuffer> commandBuffer);
+
+  /// Releases all the textures which are not acquired
+  void clear();
+
+  /// Number of textures owned by the pool, acquired or not
+  [[nodiscard]] uint32_t getNumTextures() const {
+    return static_cast<uint32_t>(textures_.size());
+  }
+  /// Number of textures created by the pool since it was constructed
+  [[nodiscard]] uint32_t getNumAllocations() const {
+    return numAllocations_;
+  }
+
+ private:
+  struct PooledTexture {
+    std::shared_ptr<igl::ITexture> texture;
+    igl::TextureDesc desc;
+    bool isAcquired = false;
+    // the texture is free once this frame has completed
+    uint64_t retireFrame = 0;
+    uint64_t lastAcquiredFrame = 0;
+  };
+  struct PendingFrame {
+    std::shared_ptr<igl::ICommandBuffer> commandBuffer;
+    uint64_t frame = 0;
+  };
+
+  void updateCompletedFrames();
+  [[nodiscard]] bool isFree(const PooledTexture& pooled) const;
+
+ private:
+  igl::IDevice& device_;
+  uint32_t maxIdleFrames_;
+  std::vector<PooledTexture> textures_;
+  // the frames whose last command buffer has not completed yet, oldest first
+  std::deque<PendingFrame> pendingFrames_;
+  uint64_t frame_ = 0;
+  // all the frames before this one have completed
+  uint64_t numCompletedFrames_ = 0;
+  uint32_t numAllocations_ = 0;
+};
+
+} // namespace rendertargetpool
+} // namespace iglu
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "ShaderBundle.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace iglu {
+namespace shaderbundle {
+
+namespace {
+
+constexpr char kMagic[8] = {'I', 'G', 'L', 'S', 'H', 'D', 'R', '\0'};
+constexpr uint32_t kVersion = 1;
+
+struct BundleHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t numEntries;
+  uint64_t bundleSize;
+};
+
+// names and entry points are stored in the string table following the entries
+struct BundleEntry {
+  uint32_t nameOffset;
+  uint32_t nameLength;
+  uint32_t entryPointOffset;
+  uint32_t entryPointLength;
+  uint8_t format;
+  uint8_t stage;
+  uint8_t reserved[6];
+  uint64_t dataOffset;
+  uint64_t dataSize;
+};
+
+static_assert(sizeof(BundleHeader) == 24, "BundleHeader must be tightly packed");
+static_assert(sizeof(BundleEntry) == 40, "BundleEntry must be tightly packed");
+
+uint64_t align(uint64_t offset) {
+  return (offset + kDataAlignment - 1) & ~uint64_t(kDataAlignment - 1);
+}
+
+bool isValidFormat(uint8_t format) {
+  return format >= static_cast<uint8_t>(ShaderFormat::SpirV) &&
+         format <= static_cast<uint8_t>(ShaderFormat::Glsl);
+}
+
+bool isValidStage(uint8_t stage) {
+  return stage <= static_cast<uint8_t>(igl::ShaderStage::Compute);
+}
+
+} // namespace
+
+void ShaderBundleWriter::addShader(const std::string& name,
+                                   ShaderFormat format,
+                                   igl::ShaderStage stage,
+                                   const std::string& entryPoint,
+                                   const void* data,
+                                   size_t size) {
+  IGL_ASSERT(data && size != 0);
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  std::vector<uint8_t> blob(bytes, bytes + size);
+  if (format == ShaderFormat::Glsl && blob.back() != '\0') {
+    // sources are loaded in place, so they must be null-terminated
+    blob.push_back('\0');
+  }
+  size_t index = 0;
+  while (index != blobs_.size() && blobs_[index] != blob) {
+    index++;
+  }
+  if (index == blobs_.size()) {
+    blobs_.push_back(std::move(blob));
+  }
+  shaders_.push_back({name, format, stage, entryPoint, index});
+}
+
+std::vector<uint8_t> ShaderBundleWriter::serialize() const {
+  std::vector<BundleEntry> entries(shaders_.size());
+  std::string strings;
+  for (size_t i = 0; i != shaders_.size(); i++) {
+    const Shader& shader = shaders_[i];
+    BundleEntry& entry = entries[i];
+    entry = {};
+    entry.nameOffset = static_cast<uint32_t>(strings.size());
+    entry.nameLength = static_cast<uint32_t>(shader.name.size());
+    strings += shader.name;
+    entry.entryPointOffset = static_cast<uint32_t>(strings.size());
+    entry.entryPointLength = static_cast<uint32_t>(shader.entryPoint.size());
+    strings += shader.entryPoint;
+    entry.format = static_cast<uint8_t>(shader.format);
+    entry.stage = static_cast<uint8_t>(shader.stage);
+  }
+  const uint64_t stringsOffset = sizeof(BundleHeader) + entries.size() * sizeof(BundleEntry);
+
+  std::vector<uint64_t> blobOffsets(blobs_.size());
+  uint64_t offset = align(stringsOffset + strings.size());
+  for (size_t i = 0; i != blobs_.size(); i++) {
+    blobOffsets[i] = offset;
+    offset = align(offset + blobs_[i].size());
+  }
+  for (size_t i = 0; i != shaders_.size(); i++) {
+    entries[i].dataOffset = blobOffsets[shaders_[i].blob];
+    entries[i].dataSize = blobs_[shaders_[i].blob].size();
+  }
+
+  BundleHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.numEntries = static_cast<uint32_t>(entries.size());
+  header.bundleSize = offset;
+
+  std::vector<uint8_t> bundle(static_cast<size_t>(offset), 0);
+  std::memcpy(bundle.data(), &header, sizeof(header));
+  if (!entries.empty()) {
+    std::memcpy(
+        bundle.data() + sizeof(header), entries.data(), entries.size() * sizeof(BundleEntry));
+  }
+  if (!strings.empty()) {
+    std::memcpy(bundle.data() + stringsOffset, strings.data(), strings.size());
+  }
+  for (size_t i = 0; i != blobs_.size(); i++) {
+    std::memcpy(bundle.data() + blobOffsets[i], blobs_[i].data(), blobs_[i].size());
+  }
+  return bundle;
+}
+
+bool ShaderBundleWriter::write(const std::string& path, igl::Result* outResult) const {
+  const std::vector<uint8_t> bundle = serialize();
+  FILE* file = fopen(path.c_str(), "wb");
+  if (!file) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot create " + path);
+    return false;
+  }
+  bool success = fwrite(bundle.data(), 1, bundle.size(), file) == bundle.size();
+  success = fclose(file) == 0 && success;
+  if (!success) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot write " + path);
+    return false;
+  }
+  igl::Result::setOk(outResult);
+  return true;
+}
+
+std::unique_ptr<ShaderBundle> ShaderBundle::fromMemory(const void* data,
+                                                       size_t size,
+                                                       igl::Result* outResult) {
+  if (!data || size < sizeof(BundleHeader)) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "The shader bundle is truncated");
+    return nullptr;
+  }
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  if (reinterpret_cast<uintptr_t>(bytes) % alignof(BundleEntry) != 0) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "The shader bundle is not aligned");
+    return nullptr;
+  }
+
+  BundleHeader header;
+  std::memcpy(&header, bytes, sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::ArgumentInvalid,
+                           "The data is not a compatible shader bundle");
+    return nullptr;
+  }
+  const uint64_t stringsOffset =
+      sizeof(BundleHeader) + uint64_t(header.numEntries) * sizeof(BundleEntry);
+  if (header.bundleSize != size || stringsOffset > size) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "The shader bundle is truncated");
+    return nullptr;
+  }
+
+  std::unique_ptr<ShaderBundle> bundle(new ShaderBundle());
+  bundle->entries_.resize(header.numEntries);
+  const auto* entries = reinterpret_cast<const BundleEntry*>(bytes + sizeof(header));
+  const char* strings = reinterpret_cast<const char*>(bytes + stringsOffset);
+  const uint64_t stringsSize = size - stringsOffset;
+  for (uint32_t i = 0; i != header.numEntries; i++) {
+    const BundleEntry& entry = entries[i];
+    const bool isValid =
+        uint64_t(entry.nameOffset) + entry.nameLength <= stringsSize &&
+        uint64_t(entry.entryPointOffset) + entry.entryPointLength <= stringsSize &&
+        isValidFormat(entry.format) && isValidStage(entry.stage) &&
+        entry.dataOffset % kDataAlignment == 0 && entry.dataOffset >= stringsOffset &&
+        entry.dataOffset <= size && entry.dataSize != 0 &&
+        entry.dataSize <= size - entry.dataOffset &&
+        (entry.format != static_cast<uint8_t>(ShaderFormat::Glsl) ||
+         bytes[entry.dataOffset + entry.dataSize - 1] == '\0');
+    if (!isValid) {
+      igl::Result::setResult(
+          outResult, igl::Result::Code::ArgumentInvalid, "The shader bundle has an invalid entry");
+      return nullptr;
+    }
+    ShaderEntry& shader = bundle->entries_[i];
+    shader.name.assign(strings + entry.nameOffset, entry.nameLength);
+    shader.format = static_cast<ShaderFormat>(entry.format);
+    shader.stage = static_cast<igl::ShaderStage>(entry.stage);
+    shader.entryPoint.assign(strings + entry.entryPointOffset, entry.entryPointLength);
+    shader.data = bytes + entry.dataOffset;
+    shader.size = static_cast<size_t>(entry.dataSize);
+  }
+
+  igl::Result::setOk(outResult);
+  return bundle;
+}
+
+ShaderFormat ShaderBundle::getFormat(igl::BackendType backend) {
+  switch (backend) {
+  case igl::BackendType::Vulkan:
+    return ShaderFormat::SpirV;
+  case igl::BackendType::Metal:
+    return ShaderFormat::MetalLib;
+  case igl::BackendType::OpenGL:
+    return ShaderFormat::Glsl;
+  }
+  IGL_UNREACHABLE_RETURN(ShaderFormat::SpirV);
+}
+
+const ShaderEntry* ShaderBundle::find(const std::string& name,
+                                      ShaderFormat format,
+                                      igl::ShaderStage stage) const {
+  for (const ShaderEntry& entry : entries_) {
+    if (entry.format == format && entry.stage == stage && entry.name == name) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+std::unique_ptr<igl::IShaderStages> ShaderBundle::createRenderStages(
+    const igl::IDevice& device,
+    const std::string& name,
+    igl::Result* outResult) const {
+  const ShaderFormat format = getFormat(device.getBackendType());
+  const ShaderEntry* vertex = find(name, format, igl::ShaderStage::Vertex);
+  const ShaderEntry* fragment = find(name, format, igl::ShaderStage::Fragment);
+  if (!vertex || !fragment) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::ArgumentInvalid,
+                           "The shader bundle has no render stages for " + name);
+    return nullptr;
+  }
+
+  switch (format) {
+  case ShaderFormat::SpirV:
+    return igl::ShaderStagesCreator::fromModuleBinaryInput(device,
+                                                           vertex->data,
+                                                           vertex->size,
+                                                           vertex->entryPoint,
+                                                           name + ": vertex",
+                                                           fragment->data,
+                                                           fragment->size,
+                                                           fragment->entryPoint,
+                                                           name + ": fragment",
+                                                           outResult);
+  case ShaderFormat::MetalLib:
+    if (vertex->data != fragment->data) {
+      igl::Result::setResult(outResult,
+                             igl::Result::Code::ArgumentInvalid,
+                             "The render stages of " + name + " are in different Metal libraries");
+      return nullptr;
+    }
+    return igl::ShaderStagesCreator::fromLibraryBinaryInput(device,
+                                                            vertex->data,
+                                                            vertex->size,
+                                                            vertex->entryPoint,
+                                                            fragment->entryPoint,
+                                                            name,
+                                                            outResult);
+  case ShaderFormat::Glsl:
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device,
+        static_cast<const char*>(vertex->data),
+        vertex->entryPoint,
+        name + ": vertex",
+        static_cast<const char*>(fragment->data),
+        fragment->entryPoint,
+        name + ": fragment",
+        outResult);
+  }
+  IGL_UNREACHABLE_RETURN(nullptr);
+}
+
+std::unique_ptr<igl::IShaderStages> ShaderBundle::createComputeStages(
+    const igl::IDevice& device,
+    const std::string& name,
+    igl::Result* outResult) const {
+  const ShaderFormat format = getFormat(device.getBackendType());
+  const ShaderEntry* compute = find(name, format, igl::ShaderStage::Compute);
+  if (!compute) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::ArgumentInvalid,
+                           "The shader bundle has no compute stage for " + name);
+    return nullptr;
+  }
+
+  switch (format) {
+  case ShaderFormat::SpirV:
+    return igl::ShaderStagesCreator::fromModuleBinaryInput(
+        device, compute->data, compute->size, compute->entryPoint, name, outResult);
+  case ShaderFormat::MetalLib: {
+    igl::Result result;
+    auto library = igl::ShaderLibraryCreator::fromBinaryInput(
+        device,
+        compute->data,
+        compute->size,
+        {{igl::ShaderStage::Compute, compute->entryPoint}},
+        name,
+        &result);
+    if (!library) {
+      igl::Result::setResult(outResult, std::move(result));
+      return nullptr;
+    }
+    return igl::ShaderStagesCreator::fromComputeModule(
+        device, library->getShaderModule(compute->entryPoint), outResult);
+  }
+  case ShaderFormat::Glsl:
+    return igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                           static_cast<const char*>(compute->data),
+                                                           compute->entryPoint,
+                                                           name,
+                                                           outResult);
+  }
+  IGL_UNREACHABLE_RETURN(nullptr);
+}
+
+} // namespace shaderbundle
+} // namespace iglu
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/IGL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace shaderbundle {
+
+/// The representation of a shader in a bundle. Each backend loads one of them.
+enum class ShaderFormat : uint8_t {
+  /// SPIR-V for igl::BackendType::Vulkan
+  SpirV = 1,
+  /// A Metal library for igl::BackendType::Metal. All the stages of a shader share it.
+  MetalLib = 2,
+  /// Null-terminated GLSL source for igl::BackendType::OpenGL, validated when the bundle was built
+  Glsl = 3,
+};
+
+/// A shader stage stored in a bundle. The data points into the memory of the bundle.
+struct ShaderEntry {
+  std::string name;
+  ShaderFormat format = ShaderFormat::SpirV;
+  igl::ShaderStage stage = igl::ShaderStage::Vertex;
+  std::string entryPoint;
+  const void* data = nullptr;
+  size_t size = 0;
+};
+
+/// The data of each shader starts at a multiple of kDataAlignment bytes from the start of the
+/// bundle, so SPIR-V words can be read straight from the bundle memory.
+constexpr size_t kDataAlignment = 16;
+
+/**
+ * @brief Builds a versioned bundle of precompiled shaders, usually at build time with the
+ * IGLShaderBundler tool (see igl_add_shader_bundle() in cmake/helpers.cmake).
+ *
+ * The writer copies the data of the shaders. Stages which share identical data, such as the
+ * functions of one Metal library, are stored once.
+ */
+class ShaderBundleWriter final {
+ public:
+  void addShader(const std::string& name,
+                 ShaderFormat format,
+                 igl::ShaderStage stage,
+                 const std::string& entryPoint,
+                 const void* data,
+                 size_t size);
+
+  /// Returns the bundle in the byte order of the host; all supported platforms are little endian.
+  [[nodiscard]] std::vector<uint8_t> serialize() const;
+  bool write(const std::string& path, igl::Result* outResult) const;
+
+ private:
+  struct Shader {
+    std::string name;
+    ShaderFormat format;
+    igl::ShaderStage stage;
+    std::string entryPoint;
+    // index into blobs_
+    size_t blob;
+  };
+  std::vector<Shader> shaders_;
+  std::vector<std::vector<uint8_t>> blobs_;
+};
+
+/**
+ * @brief A bundle of precompiled shaders written by ShaderBundleWriter.
+ *
+ * The bundle does not copy the memory it is created from, which must outlive it. The memory can
+ * be a mapped file or an asset buffer: shaders are created from it without any parsing beyond the
+ * entry table, and no shader compiler runs for SPIR-V and Metal libraries.
+ */
+class ShaderBundle final {
+ public:
+  /// Returns nullptr if `data` was not written by a compatible ShaderBundleWriter. `data` must be
+  /// aligned to 8 bytes, like the memory returned by malloc() or a mapped file.
+  static std::unique_ptr<ShaderBundle> fromMemory(const void* data,
+                                                  size_t size,
+                                                  igl::Result* outResult);
+
+  /// The format the shaders of `backend` are loaded from
+  [[nodiscard]] static ShaderFormat getFormat(igl::BackendType backend);
+
+  /// Returns nullptr if the bundle has no such shader.
+  [[nodiscard]] const ShaderEntry* find(const std::string& name,
+                                        ShaderFormat format,
+                                        igl::ShaderStage stage) const;
+
+  [[nodiscard]] const std::vector<ShaderEntry>& getEntries() const {
+    return entries_;
+  }
+
+  /// Creates the vertex and fragment stages of the shader `name` in the format of the device.
+  [[nodiscard]] std::unique_ptr<igl::IShaderStages> createRenderStages(
+      const igl::IDevice& device,
+      const std::string& name,
+      igl::Result* outResult) const;
+  /// Creates the compute stage of the shader `name` in the format of the device.
+  [[nodiscard]] std::unique_ptr<igl::IShaderStages> createComputeStages(
+      const igl::IDevice& device,
+      const std::string& name,
+      igl::Result* outResult) const;
+
+ private:
+  ShaderBundle() = default;
+
+  std::vector<ShaderEntry> entries_;
+};
+
+} // namespace shaderbundle
+} // namespace iglu
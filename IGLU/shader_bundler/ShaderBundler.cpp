@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Host tool packing precompiled shaders into a bundle loaded by iglu::shaderbundle::ShaderBundle.
+//
+// Usage: IGLShaderBundler <bundle> (<name> <format> <stage> <entryPoint> <file>)...
+//   format: spirv    - <file> is Vulkan GLSL, compiled to SPIR-V
+//           glsl     - <file> is OpenGL GLSL, validated and stored as source
+//           metallib - <file> is a Metal library compiled by the Metal toolchain
+//   stage:  vertex | fragment | compute
+//
+// Vulkan GLSL without a #version directive gets "#version 460", like at runtime. The other
+// headers igl::vulkan::Device adds at runtime depend on the device, so sources compiled here
+// must declare the extensions and bindless arrays they use.
+
+#include <IGLU/shader_bundle/ShaderBundle.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <glslang/Include/glslang_c_interface.h>
+#include <glslang/Public/resource_limits_c.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using iglu::shaderbundle::ShaderBundleWriter;
+using iglu::shaderbundle::ShaderFormat;
+
+namespace {
+
+bool readFile(const std::string& path, std::vector<uint8_t>& outData) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  outData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return !file.bad();
+}
+
+bool parseStage(const std::string& text, igl::ShaderStage& outStage, glslang_stage_t& outGlslang) {
+  if (text == "vertex") {
+    outStage = igl::ShaderStage::Vertex;
+    outGlslang = GLSLANG_STAGE_VERTEX;
+  } else if (text == "fragment") {
+    outStage = igl::ShaderStage::Fragment;
+    outGlslang = GLSLANG_STAGE_FRAGMENT;
+  } else if (text == "compute") {
+    outStage = igl::ShaderStage::Compute;
+    outGlslang = GLSLANG_STAGE_COMPUTE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool parseFormat(const std::string& text, ShaderFormat& outFormat) {
+  if (text == "spirv") {
+    outFormat = ShaderFormat::SpirV;
+  } else if (text == "glsl") {
+    outFormat = ShaderFormat::Glsl;
+  } else if (text == "metallib") {
+    outFormat = ShaderFormat::MetalLib;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Compiles Vulkan GLSL to SPIR-V with the same targets as igl::vulkan::compileShaderToSPIRV(), or
+// only parses OpenGL GLSL to validate it when `outSPIRV` is null.
+bool compileGlsl(const std::string& path,
+                 const std::string& source,
+                 glslang_stage_t stage,
+                 std::vector<uint32_t>* outSPIRV) {
+  const bool isVulkan = outSPIRV != nullptr;
+  const glslang_input_t input = {
+      /* .language = */ GLSLANG_SOURCE_GLSL,
+      /* .stage = */ stage,
+      /* .client = */ isVulkan ? GLSLANG_CLIENT_VULKAN : GLSLANG_CLIENT_NONE,
+      // the client and target versions are ignored without a client
+      /* .client_version = */ GLSLANG_TARGET_VULKAN_1_1,
+      /* .target_language = */ isVulkan ? GLSLANG_TARGET_SPV : GLSLANG_TARGET_NONE,
+      /* .target_language_version = */ GLSLANG_TARGET_SPV_1_3,
+      /* .code = */ source.c_str(),
+      /* .default_version = */ 100,
+      /* .default_profile = */ GLSLANG_NO_PROFILE,
+      /* .force_default_version_and_profile = */ false,
+      /* .forward_compatible = */ false,
+      /* .messages = */ GLSLANG_MSG_DEFAULT_BIT,
+      /* .resource = */ glslang_default_resource(),
+  };
+
+  glslang_shader_t* shader = glslang_shader_create(&input);
+  bool success = glslang_shader_preprocess(shader, &input) && glslang_shader_parse(shader, &input);
+  if (!success) {
+    fprintf(stderr, "%s: %s\n", path.c_str(), glslang_shader_get_info_log(shader));
+    glslang_shader_delete(shader);
+    return false;
+  }
+  if (!isVulkan) {
+    glslang_shader_delete(shader);
+    return true;
+  }
+
+  glslang_program_t* program = glslang_program_create();
+  glslang_program_add_shader(program, shader);
+  success = glslang_program_link(program, GLSLANG_MSG_SPV_RULES_BIT | GLSLANG_MSG_VULKAN_RULES_BIT);
+  if (success) {
+    glslang_spv_options_t options = {};
+    options.strip_debug_info = true;
+    options.optimize_size = true;
+    options.validate = true;
+    glslang_program_SPIRV_generate_with_options(program, input.stage, &options);
+    if (glslang_program_SPIRV_get_messages(program)) {
+      fprintf(stderr, "%s: %s\n", path.c_str(), glslang_program_SPIRV_get_messages(program));
+    }
+    const uint32_t* words = glslang_program_SPIRV_get_ptr(program);
+    outSPIRV->assign(words, words + glslang_program_SPIRV_get_size(program));
+  } else {
+    fprintf(stderr, "%s: %s\n", path.c_str(), glslang_program_get_info_log(program));
+  }
+  glslang_program_delete(program);
+  glslang_shader_delete(shader);
+  return success;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  constexpr int kArgsPerShader = 5;
+  if (argc < 2 + kArgsPerShader || (argc - 2) % kArgsPerShader != 0) {
+    fprintf(stderr,
+            "Usage: %s <bundle> (<name> spirv|glsl|metallib vertex|fragment|compute "
+            "<entryPoint> <file>)...\n",
+            argv[0]);
+    return 1;
+  }
+
+  glslang_initialize_process();
+
+  ShaderBundleWriter writer;
+  bool success = true;
+  for (int i = 2; success && i != argc; i += kArgsPerShader) {
+    const std::string name = argv[i];
+    const std::string entryPoint = argv[i + 3];
+    const std::string path = argv[i + 4];
+    ShaderFormat format = ShaderFormat::SpirV;
+    igl::ShaderStage stage = igl::ShaderStage::Vertex;
+    glslang_stage_t glslangStage = GLSLANG_STAGE_VERTEX;
+    if (!parseFormat(argv[i + 1], format) || !parseStage(argv[i + 2], stage, glslangStage)) {
+      fprintf(stderr, "%s: unknown format or stage\n", name.c_str());
+      success = false;
+      break;
+    }
+    std::vector<uint8_t> data;
+    if (!readFile(path, data) || data.empty()) {
+      fprintf(stderr, "Cannot read %s\n", path.c_str());
+      success = false;
+      break;
+    }
+
+    switch (format) {
+    case ShaderFormat::SpirV: {
+      std::string source(data.begin(), data.end());
+      if (source.find("#version ") == std::string::npos) {
+        source = "#version 460\n" + source;
+      }
+      std::vector<uint32_t> spirv;
+      success = compileGlsl(path, source, glslangStage, &spirv);
+      if (success) {
+        writer.addShader(
+            name, format, stage, entryPoint, spirv.data(), spirv.size() * sizeof(uint32_t));
+      }
+      break;
+    }
+    case ShaderFormat::Glsl:
+      success = compileGlsl(path, std::string(data.begin(), data.end()), glslangStage, nullptr);
+      if (success) {
+        writer.addShader(name, format, stage, entryPoint, data.data(), data.size());
+      }
+      break;
+    case ShaderFormat::MetalLib:
+      writer.addShader(name, format, stage, entryPoint, data.data(), data.size());
+      break;
+    }
+  }
+
+  glslang_finalize_process();
+
+  igl::Result result;
+  if (!success || !writer.write(argv[1], &result)) {
+    if (!result.isOk()) {
+      fprintf(stderr, "%s\n", result.message.c_str());
+    }
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "ShadowCascades.h"
+
+#include <IGLU/glsl/Versions.h>
+#include <IGLU/simdtypes/SimdUtilities.h>
+#include <cmath>
+#include <cstdlib>
+#include <igl/ShaderCreator.h>
+#include <string>
+
+namespace iglu {
+namespace shadows {
+
+using namespace simdtypes;
+
+namespace {
+
+constexpr size_t kTextureUnit = 0;
+
+// Copies the static layer into the shadow map: a triangle covering the shadow map writes the depth
+// of the static layer texel at offset from each shadow map texel
+const char* getMetalShaderSource() {
+  return R"(
+    using namespace metal;
+
+    typedef struct {
+      float4 position [[position]];
+    } VertexOut;
+
+    typedef struct {
+      float depth [[depth(any)]];
+    } FragmentOut;
+
+    vertex VertexOut vertexShader(uint vid [[vertex_id]]) {
+      float2 uv = float2(float((vid << 1) & 2), float(vid & 2));
+      VertexOut out;
+      out.position = float4(uv * 2.0 - 1.0, 0.0, 1.0);
+      return out;
+    }
+
+    fragment FragmentOut fragmentShader(VertexOut IN [[stage_in]],
+                                        depth2d<float> staticLayer [[texture(0)]],
+                                        constant int2& offset [[buffer(0)]]) {
+      FragmentOut out;
+      out.depth = staticLayer.read(uint2(int2(IN.position.xy) + offset));
+      return out;
+    }
+  )";
+}
+
+const char* getOpenGLVertexShaderSource() {
+  return R"(
+    void main() {
+      vec2 uv = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+      gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+    })";
+}
+
+const char* getOpenGLFragmentShaderSource() {
+  return R"(
+    uniform sampler2D staticLayer;
+    uniform ivec2 offset;
+
+    void main() {
+      gl_FragDepth = texelFetch(staticLayer, ivec2(gl_FragCoord.xy) + offset, 0).r;
+    })";
+}
+
+const char* getVulkanVertexShaderSource() {
+  return R"(
+    void main() {
+      vec2 uv = vec2(float((gl_VertexIndex << 1) & 2), float(gl_VertexIndex & 2));
+      gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+    })";
+}
+
+const char* getVulkanFragmentShaderSource() {
+  return R"(
+    layout(set = 0, binding = 0) uniform sampler2D staticLayer;
+    layout(push_constant) uniform Params {
+      ivec2 offset;
+    } params;
+
+    void main() {
+      gl_FragDepth = texelFetch(staticLayer, ivec2(gl_FragCoord.xy) + params.offset, 0).r;
+    })";
+}
+
+std::unique_ptr<igl::IShaderStages> getShaderStagesForBackend(igl::IDevice& device,
+                                                              igl::Result* outResult) {
+  switch (device.getBackendType()) {
+  case igl::BackendType::Vulkan:
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device,
+        getVulkanVertexShaderSource(),
+        "main",
+        "Shader Module: shadows::composite (vert)",
+        getVulkanFragmentShaderSource(),
+        "main",
+        "Shader Module: shadows::composite (frag)",
+        outResult);
+  // @fb-only
+    // @fb-only
+  case igl::BackendType::Metal:
+    return igl::ShaderStagesCreator::fromLibraryStringInput(
+        device, getMetalShaderSource(), "vertexShader", "fragmentShader", "", outResult);
+  case igl::BackendType::OpenGL: {
+    const std::string version = glsl::getOpenGLVersion(device.getShaderVersion());
+    const std::string vertexSource = version + getOpenGLVertexShaderSource();
+    const std::string fragmentSource = version + getOpenGLFragmentShaderSource();
+    return igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                           vertexSource.c_str(),
+                                                           "main",
+                                                           "",
+                                                           fragmentSource.c_str(),
+                                                           "main",
+                                                           "",
+                                                           outResult);
+  }
+  }
+  IGL_UNREACHABLE_RETURN(nullptr);
+}
+
+float dot3(const float3& a, const float3& b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+float3 cross3(const float3& a, const float3& b) {
+  return float3{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+}
+
+float3 normalize3(const float3& v) {
+  const float length = std::sqrt(dot3(v, v));
+  return length > 0.0f ? float3{v[0] / length, v[1] / length, v[2] / length} : v;
+}
+
+// A right-handed basis of the light space which looks along the light direction
+struct LightBasis {
+  float3 x;
+  float3 y;
+  float3 z;
+};
+
+LightBasis getLightBasis(const float3& lightDirection) {
+  const float3 d = normalize3(lightDirection);
+  LightBasis basis;
+  basis.z = float3{-d[0], -d[1], -d[2]};
+  const float3 up = std::abs(d[1]) < 0.99f ? float3{0.0f, 1.0f, 0.0f} : float3{1.0f, 0.0f, 0.0f};
+  basis.x = normalize3(cross3(up, basis.z));
+  basis.y = cross3(basis.z, basis.x);
+  return basis;
+}
+
+// An orthographic projection of the light space box centered on (centerX, centerY) with a half
+// size of `halfSize`, and with depths from zTop (towards the light) down to zTop - depthRange
+float4x4 makeLightViewProjection(const LightBasis& basis,
+                                 float centerX,
+                                 float centerY,
+                                 float halfSize,
+                                 float zTop,
+                                 float depthRange,
+                                 bool zeroToOneDepth) {
+  float rows[3][4];
+  for (int c = 0; c != 3; c++) {
+    rows[0][c] = basis.x[c] / halfSize;
+    rows[1][c] = basis.y[c] / halfSize;
+    rows[2][c] = (zeroToOneDepth ? -1.0f : -2.0f) * basis.z[c] / depthRange;
+  }
+  rows[0][3] = -centerX / halfSize;
+  rows[1][3] = -centerY / halfSize;
+  rows[2][3] = zeroToOneDepth ? zTop / depthRange : 2.0f * zTop / depthRange - 1.0f;
+  return float4x4(float4{rows[0][0], rows[1][0], rows[2][0], 0.0f},
+                  float4{rows[0][1], rows[1][1], rows[2][1], 0.0f},
+                  float4{rows[0][2], rows[1][2], rows[2][2], 0.0f},
+                  float4{rows[0][3], rows[1][3], rows[2][3], 1.0f});
+}
+
+} // namespace
+
+void computeSplitDistances(float nearZ,
+                           float farZ,
+                           float lambda,
+                           uint32_t numCascades,
+                           float* outDistances) {
+  IGL_ASSERT(nearZ > 0.0f && nearZ < farZ);
+  outDistances[0] = nearZ;
+  for (uint32_t i = 1; i < numCascades; i++) {
+    const float f = static_cast<float>(i) / static_cast<float>(numCascades);
+    const float logSplit = nearZ * std::pow(farZ / nearZ, f);
+    const float uniformSplit = nearZ + (farZ - nearZ) * f;
+    outDistances[i] = lambda * logSplit + (1.0f - lambda) * uniformSplit;
+  }
+  outDistances[numCascades] = farZ;
+}
+
+float4 computeSliceBoundingSphere(const CameraDesc& camera, float splitNear, float splitFar) {
+  // the squared tangent of the half diagonal field of view
+  const float t = std::tan(0.5f * camera.fovY);
+  const float k2 = t * t * (1.0f + camera.aspectRatio * camera.aspectRatio);
+  const float n = splitNear;
+  const float f = splitFar;
+  // the center on the view axis which is as far from the near corners as from the far ones, or
+  // the center of the far plane for wide slices
+  const float c = k2 >= (f - n) / (f + n) ? f : 0.5f * (f + n) * (1.0f + k2);
+  const float radius = std::sqrt((f - c) * (f - c) + f * f * k2);
+
+  const float4 center = multiply(inverse(camera.view), float4{0.0f, 0.0f, -c, 1.0f});
+  return float4{center[0], center[1], center[2], radius};
+}
+
+bool fitCascade(const ShadowCascadesConfig& config,
+                const float3& lightDirection,
+                const float4& boundingSphere,
+                bool zeroToOneDepth,
+                Cascade& cascade) {
+  const float radius = boundingSphere[3];
+  const float texelSize = 2.0f * radius / static_cast<float>(config.resolution);
+  const auto guard = static_cast<int32_t>(config.guardBandTexels);
+  const float guardSize = static_cast<float>(guard) * texelSize;
+
+  const LightBasis basis = getLightBasis(lightDirection);
+  const float3 center = float3{boundingSphere[0], boundingSphere[1], boundingSphere[2]};
+  const float lightX = dot3(basis.x, center);
+  const float lightY = dot3(basis.y, center);
+  const float lightZ = dot3(basis.z, center);
+  // whole texels of the light space grid
+  const float texelX = std::round(lightX / texelSize);
+  const float texelY = std::round(lightY / texelSize);
+
+  const float3& anchor = cascade.anchor;
+  bool moveStatic = !cascade.isStaticValid || radius != cascade.radius ||
+                    lightDirection[0] != cascade.lightDirection[0] ||
+                    lightDirection[1] != cascade.lightDirection[1] ||
+                    lightDirection[2] != cascade.lightDirection[2];
+  auto dx = static_cast<int32_t>(texelX - std::round(anchor[0] / texelSize));
+  auto dy = static_cast<int32_t>(texelY - std::round(anchor[1] / texelSize));
+  if (!moveStatic) {
+    moveStatic = std::abs(dx) > guard || std::abs(dy) > guard ||
+                 std::abs(lightZ - anchor[2]) > guardSize;
+  }
+  if (moveStatic) {
+    cascade.anchor = float3{texelX * texelSize, texelY * texelSize, lightZ};
+    cascade.lightDirection = lightDirection;
+    cascade.radius = radius;
+    cascade.isStaticValid = true;
+    dx = dy = 0;
+  }
+
+  // both maps share the depth range of the static layer, which holds the sphere while the
+  // shadow map stays in the guard band
+  const float zTop = cascade.anchor[2] + radius + guardSize + config.casterDistance;
+  const float depthRange = 2.0f * (radius + guardSize) + config.casterDistance;
+  cascade.viewProjection = makeLightViewProjection(basis,
+                                                   texelX * texelSize,
+                                                   texelY * texelSize,
+                                                   radius,
+                                                   zTop,
+                                                   depthRange,
+                                                   zeroToOneDepth);
+  cascade.staticViewProjection = makeLightViewProjection(basis,
+                                                         cascade.anchor[0],
+                                                         cascade.anchor[1],
+                                                         radius + guardSize,
+                                                         zTop,
+                                                         depthRange,
+                                                         zeroToOneDepth);
+  cascade.boundingSphere = boundingSphere;
+  cascade.staticOffset[0] = guard + dx;
+  cascade.staticOffset[1] = guard + dy;
+  return moveStatic;
+}
+
+ShadowCascades::ShadowCascades(igl::IDevice& device,
+                               ShadowCascadesConfig config,
+                               igl::Result* outResult) :
+  device_(device),
+  config_(std::move(config)),
+  zeroToOneDepth_(device.getBackendType() != igl::BackendType::OpenGL) {
+  if (config_.numCascades == 0 || config_.numCascades > kMaxCascades) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::ArgumentOutOfRange,
+                           "The number of cascades must be in [1, kMaxCascades]");
+    return;
+  }
+  if (config_.resolution == 0) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "The resolution must not be 0");
+    return;
+  }
+
+  const auto usage = igl::TextureDesc::TextureUsageBits::Attachment |
+                     igl::TextureDesc::TextureUsageBits::Sampled;
+  const uint32_t staticResolution = config_.resolution + 2 * config_.guardBandTexels;
+  igl::Result result;
+  shadowMap_ = device_.createTexture(igl::TextureDesc::new2DArray(config_.depthFormat,
+                                                                  config_.resolution,
+                                                                  config_.resolution,
+                                                                  config_.numCascades,
+                                                                  usage,
+                                                                  "ShadowCascades: shadow map"),
+                                     &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+  staticLayers_ = device_.createTexture(igl::TextureDesc::new2DArray(config_.depthFormat,
+                                                                     staticResolution,
+                                                                     staticResolution,
+                                                                     config_.numCascades,
+                                                                     usage,
+                                                                     "ShadowCascades: static"),
+                                        &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  for (uint32_t i = 0; i != config_.numCascades; i++) {
+    igl::TextureViewDesc viewDesc;
+    viewDesc.type = igl::TextureType::TwoD;
+    viewDesc.layer = i;
+    for (const bool isStatic : {false, true}) {
+      viewDesc.debugName = std::string("ShadowCascades: ") + (isStatic ? "static " : "cascade ") +
+                           std::to_string(i);
+      auto view = device_.createTextureView(
+          isStatic ? *staticLayers_ : *shadowMap_, viewDesc, &result);
+      if (!result.isOk()) {
+        igl::Result::setResult(outResult, std::move(result));
+        return;
+      }
+      igl::FramebufferDesc framebufferDesc;
+      framebufferDesc.depthAttachment.texture = view;
+      framebufferDesc.debugName = viewDesc.debugName;
+      auto framebuffer = device_.createFramebuffer(framebufferDesc, &result);
+      if (!result.isOk()) {
+        igl::Result::setResult(outResult, std::move(result));
+        return;
+      }
+      (isStatic ? staticLayerViews_ : shadowMapViews_).push_back(std::move(view));
+      (isStatic ? staticLayerFramebuffers_ : shadowMapFramebuffers_)
+          .push_back(std::move(framebuffer));
+    }
+  }
+
+  igl::DepthStencilStateDesc depthDesc;
+  depthDesc.isDepthWriteEnabled = true;
+  depthDesc.compareFunction = igl::CompareFunction::AlwaysPass;
+  depthWriteAlways_ = device_.createDepthStencilState(depthDesc, &result);
+  depthDesc.compareFunction = igl::CompareFunction::Less;
+  depthWriteLess_ = device_.createDepthStencilState(depthDesc, &result);
+
+  igl::SamplerStateDesc samplerDesc;
+  samplerDesc.addressModeU = samplerDesc.addressModeV = igl::SamplerAddressMode::Clamp;
+  samplerDesc.debugName = "ShadowCascades";
+  sampler_ = device_.createSamplerState(samplerDesc, &result);
+
+  if (!createCompositePipeline()) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::RuntimeError,
+                           "Cannot create the ShadowCascades composite pipeline");
+    return;
+  }
+  igl::Result::setOk(outResult);
+}
+
+ShadowCascades::~ShadowCascades() = default;
+
+bool ShadowCascades::createCompositePipeline() {
+  igl::Result result;
+  igl::RenderPipelineDesc desc;
+  desc.shaderStages = getShaderStagesForBackend(device_, &result);
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("Cannot create the composite shaders: %s\n", result.message.c_str());
+    return false;
+  }
+  desc.targetDesc.depthAttachmentFormat = config_.depthFormat;
+  desc.fragmentUnitSamplerMap[kTextureUnit] = IGL_NAMEHANDLE("staticLayer");
+  desc.cullMode = igl::CullMode::Disabled;
+  desc.debugName = IGL_NAMEHANDLE("ShadowCascades: composite");
+  compositePipeline_ = device_.createRenderPipeline(desc, &result);
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("Cannot create the composite pipeline: %s\n", result.message.c_str());
+    return false;
+  }
+  return true;
+}
+
+void ShadowCascades::update(const CameraDesc& camera, const float3& lightDirection) {
+  computeSplitDistances(
+      camera.nearZ, camera.farZ, config_.splitLambda, config_.numCascades, splitDistances_);
+  for (uint32_t i = 0; i != config_.numCascades; i++) {
+    Cascade& cascade = cascades_[i];
+    cascade.splitNear = splitDistances_[i];
+    cascade.splitFar = splitDistances_[i + 1];
+    const float4 sphere = computeSliceBoundingSphere(camera, cascade.splitNear, cascade.splitFar);
+    if (fitCascade(config_, lightDirection, sphere, zeroToOneDepth_, cascade)) {
+      needsStaticRender_[i] = true;
+    }
+  }
+}
+
+void ShadowCascades::invalidateStatic() {
+  for (bool& needsStaticRender : needsStaticRender_) {
+    needsStaticRender = true;
+  }
+}
+
+void ShadowCascades::render(igl::ICommandBuffer& commandBuffer,
+                            const DrawCastersFunc& drawStatic,
+                            const DrawCastersFunc& drawDynamic) {
+  if (!IGL_VERIFY(compositePipeline_)) {
+    return;
+  }
+  const uint32_t staticResolution = config_.resolution + 2 * config_.guardBandTexels;
+  // the rows of the textures go down from the top of the clip space on Metal and Vulkan
+  const bool isBottomUp = device_.getBackendType() == igl::BackendType::OpenGL;
+
+  numStaticRenders_ = 0;
+  for (uint32_t i = 0; i != config_.numCascades; i++) {
+    Cascade& cascade = cascades_[i];
+    bool refresh = !isShadowMapValid_[i] || !isDynamicValid_ ||
+                   renderedOffsets_[i][0] != cascade.staticOffset[0] ||
+                   renderedOffsets_[i][1] != cascade.staticOffset[1];
+    if (needsStaticRender_[i]) {
+      renderLayer(commandBuffer,
+                  staticLayerFramebuffers_[i],
+                  staticResolution,
+                  cascade.staticViewProjection,
+                  i,
+                  drawStatic,
+                  nullptr);
+      needsStaticRender_[i] = false;
+      numStaticRenders_++;
+      refresh = true;
+    }
+    if (!refresh) {
+      continue;
+    }
+    const int32_t offset[2] = {
+        cascade.staticOffset[0],
+        isBottomUp ? cascade.staticOffset[1]
+                   : 2 * static_cast<int32_t>(config_.guardBandTexels) - cascade.staticOffset[1],
+    };
+    renderLayer(commandBuffer,
+                shadowMapFramebuffers_[i],
+                config_.resolution,
+                cascade.viewProjection,
+                i,
+                [this, i, &offset](igl::IRenderCommandEncoder& encoder,
+                                   const float4x4& /*viewProjection*/,
+                                   uint32_t /*cascadeIndex*/) {
+                  encoder.bindRenderPipelineState(compositePipeline_);
+                  encoder.bindDepthStencilState(depthWriteAlways_);
+                  encoder.bindTexture(
+                      kTextureUnit, igl::BindTarget::kFragment, staticLayerViews_[i].get());
+                  encoder.bindSamplerState(
+                      kTextureUnit, igl::BindTarget::kFragment, sampler_.get());
+                  switch (device_.getBackendType()) {
+                  case igl::BackendType::Vulkan:
+                    encoder.bindPushConstants(offset, sizeof(offset));
+                    break;
+                  case igl::BackendType::Metal:
+                    encoder.bindBytes(0, igl::BindTarget::kFragment, offset, sizeof(offset));
+                    break;
+                  default: {
+                    igl::UniformDesc uniform;
+                    uniform.location =
+                        compositePipeline_->getIndexByName("offset", igl::ShaderStage::Fragment);
+                    uniform.type = igl::UniformType::Int2;
+                    encoder.bindUniform(uniform, offset);
+                    break;
+                  }
+                  }
+                  encoder.draw(igl::PrimitiveType::Triangle, 0, 3);
+                  encoder.bindDepthStencilState(depthWriteLess_);
+                },
+                drawDynamic);
+    renderedOffsets_[i][0] = cascade.staticOffset[0];
+    renderedOffsets_[i][1] = cascade.staticOffset[1];
+    isShadowMapValid_[i] = true;
+  }
+  isDynamicValid_ = true;
+}
+
+void ShadowCascades::renderLayer(igl::ICommandBuffer& commandBuffer,
+                                 const std::shared_ptr<igl::IFramebuffer>& framebuffer,
+                                 uint32_t size,
+                                 const float4x4& viewProjection,
+                                 uint32_t cascadeIndex,
+                                 const DrawCastersFunc& drawStatic,
+                                 const DrawCastersFunc& drawDynamic) {
+  igl::RenderPassDesc renderPass;
+  renderPass.depthAttachment.loadAction = igl::LoadAction::Clear;
+  renderPass.depthAttachment.storeAction = igl::StoreAction::Store;
+  renderPass.depthAttachment.clearDepth = 1.0f;
+  auto encoder = commandBuffer.createRenderCommandEncoder(renderPass, framebuffer);
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("ShadowCascades " + std::to_string(cascadeIndex));
+  const auto s = static_cast<float>(size);
+  encoder->bindViewport({0.0f, 0.0f, s, s, 0.0f, 1.0f});
+  encoder->bindScissorRect({0, 0, size, size});
+  encoder->bindDepthStencilState(depthWriteLess_);
+  for (const DrawCastersFunc* draw : {&drawStatic, &drawDynamic}) {
+    if (*draw) {
+      (*draw)(*encoder, viewProjection, cascadeIndex);
+    }
+  }
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+} // namespace shadows
+} // namespace iglu
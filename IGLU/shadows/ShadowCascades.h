@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <functional>
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace shadows {
+
+constexpr uint32_t kMaxCascades = 4;
+
+struct ShadowCascadesConfig {
+  uint32_t numCascades = 4;
+  // width and height of each cascade's shadow map
+  uint32_t resolution = 2048;
+  // blends uniform (0) and logarithmic (1) split distances
+  float splitLambda = 0.75f;
+  // the static layers extend this number of texels past the shadow maps on each side, so the
+  // camera can move that far before the static casters are rendered again
+  uint32_t guardBandTexels = 128;
+  // casters up to this distance towards the light from a cascade's bounding sphere are included
+  float casterDistance = 100.0f;
+  // Z_UNorm16 is not available on iOS Metal
+  igl::TextureFormat depthFormat = igl::TextureFormat::Z_UNorm16;
+};
+
+/// The camera the cascades cover. The view space is right-handed and looks down -Z, as with
+/// glm::lookAt().
+struct CameraDesc {
+  simdtypes::float4x4 view = simdtypes::float4x4(1.0f);
+  // vertical field of view in radians
+  float fovY = 1.0f;
+  float aspectRatio = 1.0f;
+  float nearZ = 0.1f;
+  float farZ = 100.0f;
+};
+
+struct Cascade {
+  // world space to the clip space of the cascade's shadow map, for the shadow lookups
+  simdtypes::float4x4 viewProjection = simdtypes::float4x4(1.0f);
+  // world space to the clip space of the cascade's static layer
+  simdtypes::float4x4 staticViewProjection = simdtypes::float4x4(1.0f);
+  // the view space depth range of the camera covered by the cascade
+  float splitNear = 0.0f;
+  float splitFar = 0.0f;
+  // the bounding sphere (center, radius) of the camera frustum slice, in world space
+  simdtypes::float4 boundingSphere = {};
+
+  // the light space center of the static layer; the depth range is centered on its z
+  simdtypes::float3 anchor = {};
+  // the light direction and sphere radius the static layer was fitted for
+  simdtypes::float3 lightDirection = {};
+  float radius = 0.0f;
+  // the texel of the static layer, counted from its bottom-left corner in clip space, under the
+  // bottom-left texel of the shadow map
+  int32_t staticOffset[2] = {};
+  // false until the static layer is fitted; set it to false to fit it again
+  bool isStaticValid = false;
+};
+
+/// Computes numCascades + 1 view space depths splitting [nearZ, farZ] with the "practical split
+/// scheme": a blend of logarithmic and uniform splits weighted by `lambda`.
+void computeSplitDistances(float nearZ,
+                           float farZ,
+                           float lambda,
+                           uint32_t numCascades,
+                           float* outDistances);
+
+/// Returns the world space bounding sphere (center, radius) of the slice [splitNear, splitFar] of
+/// the camera frustum. The radius only depends on the projection and split distances, so it stays
+/// the same while the camera moves and rotates.
+simdtypes::float4 computeSliceBoundingSphere(const CameraDesc& camera,
+                                             float splitNear,
+                                             float splitFar);
+
+/// Fits `cascade` around `boundingSphere` for a directional light shining along
+/// `lightDirection`. The shadow map is snapped to whole texels in light space, so the shadows do
+/// not shimmer while the camera moves, and shares the depth range of the static layer, which only
+/// moves when the shadow map leaves its guard band, the light or the radius change, or
+/// `cascade.isStaticValid` is false. Returns true if the static layer moved and must be rendered
+/// again. `zeroToOneDepth` is true for clip spaces with a depth range of [0, 1] (Metal, Vulkan)
+/// and false for [-1, 1] (OpenGL).
+bool fitCascade(const ShadowCascadesConfig& config,
+                const simdtypes::float3& lightDirection,
+                const simdtypes::float4& boundingSphere,
+                bool zeroToOneDepth,
+                Cascade& cascade);
+
+/**
+ * @brief Cascaded shadow maps for a directional light which only re-render what moved.
+ *
+ * The camera frustum is split into up to kMaxCascades slices, each covered by one layer of a 2D
+ * array depth texture. Each cascade fits a bounding sphere around its slice and snaps the shadow
+ * map to whole texels, so the shadows are stable while the camera moves.
+ *
+ * Static casters are rendered into a separate, cached static layer per cascade, which is larger
+ * than the shadow map by a guard band. It is only rendered again when invalidateStatic() is
+ * called, the light direction changes, or the camera moves the cascade out of the guard band.
+ * While the static layer is valid, a cascade's shadow map is refreshed by copying its window of
+ * the static layer with a fullscreen draw which writes depth, and by rendering the dynamic casters
+ * on top. That only happens when the window moved, the static layer was rendered again, or
+ * invalidateDynamic() was called; otherwise the shadow map of the previous frame is kept.
+ *
+ * The casters are drawn by the application in callbacks, with pipelines which render depth only
+ * into getDepthFormat(). The lighting pass samples getShadowMap() as a 2D array with the
+ * viewProjection of each cascade and selects the cascade with getSplitDistances().
+ *
+ * Usage per frame:
+ *   cascades.update(camera, lightDirection);
+ *   cascades.render(*commandBuffer, drawStaticCasters, drawDynamicCasters);
+ *   ... lighting pass sampling getShadowMap() ...
+ */
+class ShadowCascades final {
+ public:
+  /// Draws casters into a cascade with `viewProjection`. The encoder has the viewport and a depth
+  /// stencil state comparing with Less and writing depth bound.
+  using DrawCastersFunc = std::function<void(igl::IRenderCommandEncoder& encoder,
+                                             const simdtypes::float4x4& viewProjection,
+                                             uint32_t cascadeIndex)>;
+
+  ShadowCascades(igl::IDevice& device, ShadowCascadesConfig config, igl::Result* outResult);
+  ~ShadowCascades();
+
+  ShadowCascades(const ShadowCascades&) = delete;
+  ShadowCascades& operator=(const ShadowCascades&) = delete;
+
+  /// Fits the cascades to the camera; `lightDirection` is the direction the light travels in
+  /// world space
+  void update(const CameraDesc& camera, const simdtypes::float3& lightDirection);
+  /// Renders the static layers and shadow maps which are out of date. Must be called outside of
+  /// render passes. `drawDynamic` may be empty if there are no dynamic casters.
+  void render(igl::ICommandBuffer& commandBuffer,
+              const DrawCastersFunc& drawStatic,
+              const DrawCastersFunc& drawDynamic);
+
+  /// The static casters changed: all static layers are rendered again
+  void invalidateStatic();
+  /// The dynamic casters moved: all shadow maps are refreshed
+  void invalidateDynamic() {
+    isDynamicValid_ = false;
+  }
+
+  /// A 2D array with one layer per cascade
+  [[nodiscard]] const std::shared_ptr<igl::ITexture>& getShadowMap() const {
+    return shadowMap_;
+  }
+  [[nodiscard]] const Cascade& getCascade(uint32_t index) const {
+    return cascades_[index];
+  }
+  [[nodiscard]] uint32_t getNumCascades() const {
+    return config_.numCascades;
+  }
+  /// numCascades + 1 view space depths; cascade i covers [distances[i], distances[i + 1]]
+  [[nodiscard]] const float* getSplitDistances() const {
+    return splitDistances_;
+  }
+  [[nodiscard]] igl::TextureFormat getDepthFormat() const {
+    return config_.depthFormat;
+  }
+  /// The number of static layers rendered by the last render()
+  [[nodiscard]] uint32_t getNumStaticRenders() const {
+    return numStaticRenders_;
+  }
+
+ private:
+  bool createCompositePipeline();
+  void renderLayer(igl::ICommandBuffer& commandBuffer,
+                   const std::shared_ptr<igl::IFramebuffer>& framebuffer,
+                   uint32_t size,
+                   const simdtypes::float4x4& viewProjection,
+                   uint32_t cascadeIndex,
+                   const DrawCastersFunc& drawStatic,
+                   const DrawCastersFunc& drawDynamic);
+
+ private:
+  igl::IDevice& device_;
+  const ShadowCascadesConfig config_;
+  const bool zeroToOneDepth_;
+
+  Cascade cascades_[kMaxCascades];
+  float splitDistances_[kMaxCascades + 1] = {};
+  // the shadow map offsets into the static layers when the shadow maps were last refreshed
+  int32_t renderedOffsets_[kMaxCascades][2] = {};
+  bool isShadowMapValid_[kMaxCascades] = {};
+  bool needsStaticRender_[kMaxCascades] = {};
+  bool isDynamicValid_ = false;
+  uint32_t numStaticRenders_ = 0;
+
+  std::shared_ptr<igl::ITexture> shadowMap_;
+  std::shared_ptr<igl::ITexture> staticLayers_;
+  // one view and framebuffer per cascade
+  std::vector<std::shared_ptr<igl::ITexture>> shadowMapViews_;
+  std::vector<std::shared_ptr<igl::ITexture>> staticLayerViews_;
+  std::vector<std::shared_ptr<igl::IFramebuffer>> shadowMapFramebuffers_;
+  std::vector<std::shared_ptr<igl::IFramebuffer>> staticLayerFramebuffers_;
+
+  std::shared_ptr<igl::IRenderPipelineState> compositePipeline_;
+  std::shared_ptr<igl::ISamplerState> sampler_;
+  std::shared_ptr<igl::IDepthStencilState> depthWriteAlways_;
+  std::shared_ptr<igl::IDepthStencilState> depthWriteLess_;
+};
+
+} // namespace shadows
+} // namespace iglu
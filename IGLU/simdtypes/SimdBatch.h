@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IGLU_SIMD_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define IGLU_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+/// Batch kernels working on arrays of simdtypes: scene-level CPU work such as transforming,
+/// culling and computing normal matrices for many objects at once. All matrix and vector types
+/// are 16 bytes per column on every platform, so the kernels process them as raw floats with
+/// SSE or NEON and fall back to scalar code on other targets.
+
+namespace iglu {
+namespace simdtypes {
+
+namespace detail {
+
+// float3 and float4 are both padded to 4 floats
+template<typename T>
+const float* floats(const T& v) {
+  static_assert(sizeof(T) == 4 * sizeof(float), "Only 4-float vectors are supported");
+  return reinterpret_cast<const float*>(&v);
+}
+
+template<typename T>
+float* floats(T& v) {
+  static_assert(sizeof(T) == 4 * sizeof(float), "Only 4-float vectors are supported");
+  return reinterpret_cast<float*>(&v);
+}
+
+inline float dot(const float* plane, const float* p) {
+  return plane[0] * p[0] + plane[1] * p[1] + plane[2] * p[2] + plane[3];
+}
+
+} // namespace detail
+
+/// outMatrices[i] = m * matrices[i]; outMatrices may be the same array as matrices
+inline void transformBatch(const float4x4& m,
+                           const float4x4* matrices,
+                           float4x4* outMatrices,
+                           size_t count) {
+#if IGLU_SIMD_SSE
+  const __m128 c0 = _mm_loadu_ps(detail::floats(m.columns[0]));
+  const __m128 c1 = _mm_loadu_ps(detail::floats(m.columns[1]));
+  const __m128 c2 = _mm_loadu_ps(detail::floats(m.columns[2]));
+  const __m128 c3 = _mm_loadu_ps(detail::floats(m.columns[3]));
+  for (size_t i = 0; i != count; i++) {
+    for (int j = 0; j != 4; j++) {
+      const float* v = detail::floats(matrices[i].columns[j]);
+      __m128 r = _mm_mul_ps(c0, _mm_set1_ps(v[0]));
+      r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(v[1])));
+      r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(v[2])));
+      r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_set1_ps(v[3])));
+      _mm_storeu_ps(detail::floats(outMatrices[i].columns[j]), r);
+    }
+  }
+#elif IGLU_SIMD_NEON
+  const float32x4_t c0 = vld1q_f32(detail::floats(m.columns[0]));
+  const float32x4_t c1 = vld1q_f32(detail::floats(m.columns[1]));
+  const float32x4_t c2 = vld1q_f32(detail::floats(m.columns[2]));
+  const float32x4_t c3 = vld1q_f32(detail::floats(m.columns[3]));
+  for (size_t i = 0; i != count; i++) {
+    for (int j = 0; j != 4; j++) {
+      const float32x4_t v = vld1q_f32(detail::floats(matrices[i].columns[j]));
+      float32x4_t r = vmulq_lane_f32(c0, vget_low_f32(v), 0);
+      r = vmlaq_lane_f32(r, c1, vget_low_f32(v), 1);
+      r = vmlaq_lane_f32(r, c2, vget_high_f32(v), 0);
+      r = vmlaq_lane_f32(r, c3, vget_high_f32(v), 1);
+      vst1q_f32(detail::floats(outMatrices[i].columns[j]), r);
+    }
+  }
+#else
+  for (size_t i = 0; i != count; i++) {
+    for (int j = 0; j != 4; j++) {
+      const float4 v = matrices[i].columns[j];
+      float* r = detail::floats(outMatrices[i].columns[j]);
+      for (int k = 0; k != 4; k++) {
+        r[k] = m.columns[0][k] * v[0] + m.columns[1][k] * v[1] + m.columns[2][k] * v[2] +
+               m.columns[3][k] * v[3];
+      }
+    }
+  }
+#endif
+}
+
+/// Extracts the normalized planes of the view frustum of `viewProjection` as (normal, distance)
+/// with the normals pointing inside. `zeroToOneDepth` is true for clip spaces with a depth range
+/// of [0, 1] (Metal, Vulkan) and false for [-1, 1] (OpenGL).
+inline void getFrustumPlanes(const float4x4& viewProjection,
+                             bool zeroToOneDepth,
+                             float4 outPlanes[6]) {
+  float rows[4][4];
+  for (int r = 0; r != 4; r++) {
+    for (int c = 0; c != 4; c++) {
+      rows[r][c] = viewProjection.columns[c][r];
+    }
+  }
+  float* planes[6];
+  for (int p = 0; p != 6; p++) {
+    planes[p] = detail::floats(outPlanes[p]);
+  }
+  for (int c = 0; c != 4; c++) {
+    planes[0][c] = rows[3][c] + rows[0][c]; // left
+    planes[1][c] = rows[3][c] - rows[0][c]; // right
+    planes[2][c] = rows[3][c] + rows[1][c]; // bottom
+    planes[3][c] = rows[3][c] - rows[1][c]; // top
+    planes[4][c] = zeroToOneDepth ? rows[2][c] : rows[3][c] + rows[2][c]; // near
+    planes[5][c] = rows[3][c] - rows[2][c]; // far
+  }
+  for (float* plane : planes) {
+    const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+    if (length > 0.0f) {
+      for (int c = 0; c != 4; c++) {
+        plane[c] /= length;
+      }
+    }
+  }
+}
+
+/// Tests `count` bounding spheres, given as (center, radius), against the 6 frustum planes.
+/// outVisible[i] is set to 1 if sphere i intersects the frustum and to 0 otherwise. Returns the
+/// number of visible spheres.
+inline size_t cullSpheresBatch(const float4 planes[6],
+                               const float4* spheres,
+                               uint8_t* outVisible,
+                               size_t count) {
+  size_t numVisible = 0;
+  size_t i = 0;
+#if IGLU_SIMD_SSE || IGLU_SIMD_NEON
+  // 4 spheres at a time: one lane per sphere
+  for (; i + 4 <= count; i += 4) {
+#if IGLU_SIMD_SSE
+    __m128 x = _mm_loadu_ps(detail::floats(spheres[i + 0]));
+    __m128 y = _mm_loadu_ps(detail::floats(spheres[i + 1]));
+    __m128 z = _mm_loadu_ps(detail::floats(spheres[i + 2]));
+    __m128 r = _mm_loadu_ps(detail::floats(spheres[i + 3]));
+    _MM_TRANSPOSE4_PS(x, y, z, r);
+    const __m128 negR = _mm_sub_ps(_mm_setzero_ps(), r);
+    __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int p = 0; p != 6; p++) {
+      const float* plane = detail::floats(planes[p]);
+      __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), x), _mm_set1_ps(plane[3]));
+      d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane[1]), y));
+      d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane[2]), z));
+      mask = _mm_and_ps(mask, _mm_cmpge_ps(d, negR));
+    }
+    const int bits = _mm_movemask_ps(mask);
+    for (int lane = 0; lane != 4; lane++) {
+      outVisible[i + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+    }
+#else
+    const float32x4x4_t s = vld4q_f32(detail::floats(spheres[i]));
+    const float32x4_t negR = vnegq_f32(s.val[3]);
+    uint32x4_t mask = vdupq_n_u32(0xFFFFFFFF);
+    for (int p = 0; p != 6; p++) {
+      const float* plane = detail::floats(planes[p]);
+      float32x4_t d = vmlaq_n_f32(vdupq_n_f32(plane[3]), s.val[0], plane[0]);
+      d = vmlaq_n_f32(d, s.val[1], plane[1]);
+      d = vmlaq_n_f32(d, s.val[2], plane[2]);
+      mask = vandq_u32(mask, vcgeq_f32(d, negR));
+    }
+    outVisible[i + 0] = static_cast<uint8_t>(vgetq_lane_u32(mask, 0) & 1);
+    outVisible[i + 1] = static_cast<uint8_t>(vgetq_lane_u32(mask, 1) & 1);
+    outVisible[i + 2] = static_cast<uint8_t>(vgetq_lane_u32(mask, 2) & 1);
+    outVisible[i + 3] = static_cast<uint8_t>(vgetq_lane_u32(mask, 3) & 1);
+#endif
+    numVisible += outVisible[i + 0] + outVisible[i + 1] + outVisible[i + 2] + outVisible[i + 3];
+  }
+#endif
+  for (; i != count; i++) {
+    const float* sphere = detail::floats(spheres[i]);
+    bool isVisible = true;
+    for (int p = 0; p != 6 && isVisible; p++) {
+      isVisible = detail::dot(detail::floats(planes[p]), sphere) >= -sphere[3];
+    }
+    outVisible[i] = isVisible ? 1 : 0;
+    numVisible += outVisible[i];
+  }
+  return numVisible;
+}
+
+/// Tests `count` axis-aligned bounding boxes, given by their minimum and maximum corners, against
+/// the 6 frustum planes. outVisible[i] is set to 1 if box i intersects the frustum (or cannot be
+/// proven outside of a single plane) and to 0 otherwise. Returns the number of visible boxes.
+inline size_t cullBoxesBatch(const float4 planes[6],
+                             const float4* mins,
+                             const float4* maxs,
+                             uint8_t* outVisible,
+                             size_t count) {
+  size_t numVisible = 0;
+  size_t i = 0;
+#if IGLU_SIMD_SSE
+  // 4 boxes at a time: one lane per box, tested through their centers and half extents
+  const __m128 half = _mm_set1_ps(0.5f);
+  for (; i + 4 <= count; i += 4) {
+    __m128 minX = _mm_loadu_ps(detail::floats(mins[i + 0]));
+    __m128 minY = _mm_loadu_ps(detail::floats(mins[i + 1]));
+    __m128 minZ = _mm_loadu_ps(detail::floats(mins[i + 2]));
+    __m128 minW = _mm_loadu_ps(detail::floats(mins[i + 3]));
+    _MM_TRANSPOSE4_PS(minX, minY, minZ, minW);
+    __m128 maxX = _mm_loadu_ps(detail::floats(maxs[i + 0]));
+    __m128 maxY = _mm_loadu_ps(detail::floats(maxs[i + 1]));
+    __m128 maxZ = _mm_loadu_ps(detail::floats(maxs[i + 2]));
+    __m128 maxW = _mm_loadu_ps(detail::floats(maxs[i + 3]));
+    _MM_TRANSPOSE4_PS(maxX, maxY, maxZ, maxW);
+    const __m128 cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+    const __m128 cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+    const __m128 cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+    const __m128 ex = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+    const __m128 ey = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+    const __m128 ez = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+    __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int p = 0; p != 6; p++) {
+      const float* plane = detail::floats(planes[p]);
+      __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), cx), _mm_set1_ps(plane[3]));
+      d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane[1]), cy));
+      d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane[2]), cz));
+      __m128 r = _mm_mul_ps(_mm_set1_ps(std::fabs(plane[0])), ex);
+      r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(std::fabs(plane[1])), ey));
+      r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(std::fabs(plane[2])), ez));
+      mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(d, r), _mm_setzero_ps()));
+    }
+    const int bits = _mm_movemask_ps(mask);
+    for (int lane = 0; lane != 4; lane++) {
+      outVisible[i + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+      numVisible += outVisible[i + lane];
+    }
+  }
+#elif IGLU_SIMD_NEON
+  for (; i + 4 <= count; i += 4) {
+    const float32x4x4_t lo = vld4q_f32(detail::floats(mins[i]));
+    const float32x4x4_t hi = vld4q_f32(detail::floats(maxs[i]));
+    float32x4_t c[3];
+    float32x4_t e[3];
+    for (int k = 0; k != 3; k++) {
+      c[k] = vmulq_n_f32(vaddq_f32(lo.val[k], hi.val[k]), 0.5f);
+      e[k] = vmulq_n_f32(vsubq_f32(hi.val[k], lo.val[k]), 0.5f);
+    }
+    uint32x4_t mask = vdupq_n_u32(0xFFFFFFFF);
+    for (int p = 0; p != 6; p++) {
+      const float* plane = detail::floats(planes[p]);
+      float32x4_t d = vdupq_n_f32(plane[3]);
+      for (int k = 0; k != 3; k++) {
+        d = vmlaq_n_f32(d, c[k], plane[k]);
+        d = vmlaq_n_f32(d, e[k], std::fabs(plane[k]));
+      }
+      mask = vandq_u32(mask, vcgeq_f32(d, vdupq_n_f32(0.0f)));
+    }
+    outVisible[i + 0] = static_cast<uint8_t>(vgetq_lane_u32(mask, 0) & 1);
+    outVisible[i + 1] = static_cast<uint8_t>(vgetq_lane_u32(mask, 1) & 1);
+    outVisible[i + 2] = static_cast<uint8_t>(vgetq_lane_u32(mask, 2) & 1);
+    outVisible[i + 3] = static_cast<uint8_t>(vgetq_lane_u32(mask, 3) & 1);
+    numVisible += outVisible[i + 0] + outVisible[i + 1] + outVisible[i + 2] + outVisible[i + 3];
+  }
+#endif
+  for (; i != count; i++) {
+    const float* lo = detail::floats(mins[i]);
+    const float* hi = detail::floats(maxs[i]);
+    bool isVisible = true;
+    for (int p = 0; p != 6 && isVisible; p++) {
+      const float* plane = detail::floats(planes[p]);
+      float d = plane[3];
+      for (int k = 0; k != 3; k++) {
+        // the corner furthest along the plane normal
+        d += plane[k] * (plane[k] >= 0.0f ? hi[k] : lo[k]);
+      }
+      isVisible = d >= 0.0f;
+    }
+    outVisible[i] = isVisible ? 1 : 0;
+    numVisible += outVisible[i];
+  }
+  return numVisible;
+}
+
+/// outNormalMatrices[i] = transpose(inverse(upper 3x3 of matrices[i])), computed from the cross
+/// products of the columns. Singular matrices produce an identity matrix.
+inline void normalMatricesBatch(const float4x4* matrices,
+                                float3x3* outNormalMatrices,
+                                size_t count) {
+  for (size_t i = 0; i != count; i++) {
+    const float* a = detail::floats(matrices[i].columns[0]);
+    const float* b = detail::floats(matrices[i].columns[1]);
+    const float* c = detail::floats(matrices[i].columns[2]);
+#if IGLU_SIMD_SSE
+    const __m128 va = _mm_loadu_ps(a);
+    const __m128 vb = _mm_loadu_ps(b);
+    const __m128 vc = _mm_loadu_ps(c);
+    const auto cross = [](__m128 u, __m128 v) {
+      const __m128 uYZX = _mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 0, 2, 1));
+      const __m128 vYZX = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+      const __m128 r = _mm_sub_ps(_mm_mul_ps(u, vYZX), _mm_mul_ps(uYZX, v));
+      return _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 0, 2, 1));
+    };
+    const __m128 bc = cross(vb, vc);
+    const __m128 ca = cross(vc, va);
+    const __m128 ab = cross(va, vb);
+    float det[4];
+    _mm_storeu_ps(det, _mm_mul_ps(va, bc));
+    const float d = det[0] + det[1] + det[2];
+    if (d == 0.0f) {
+      outNormalMatrices[i] = float3x3(1.0f);
+      continue;
+    }
+    const __m128 invDet = _mm_set1_ps(1.0f / d);
+    _mm_storeu_ps(detail::floats(outNormalMatrices[i].columns[0]), _mm_mul_ps(bc, invDet));
+    _mm_storeu_ps(detail::floats(outNormalMatrices[i].columns[1]), _mm_mul_ps(ca, invDet));
+    _mm_storeu_ps(detail::floats(outNormalMatrices[i].columns[2]), _mm_mul_ps(ab, invDet));
+#else
+    const float bc[3] = {
+        b[1] * c[2] - b[2] * c[1], b[2] * c[0] - b[0] * c[2], b[0] * c[1] - b[1] * c[0]};
+    const float ca[3] = {
+        c[1] * a[2] - c[2] * a[1], c[2] * a[0] - c[0] * a[2], c[0] * a[1] - c[1] * a[0]};
+    const float ab[3] = {
+        a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+    const float d = a[0] * bc[0] + a[1] * bc[1] + a[2] * bc[2];
+    if (d == 0.0f) {
+      outNormalMatrices[i] = float3x3(1.0f);
+      continue;
+    }
+    const float invDet = 1.0f / d;
+    float* out[3] = {detail::floats(outNormalMatrices[i].columns[0]),
+                     detail::floats(outNormalMatrices[i].columns[1]),
+                     detail::floats(outNormalMatrices[i].columns[2])};
+    for (int k = 0; k != 3; k++) {
+      out[0][k] = bc[k] * invDet;
+      out[1][k] = ca[k] * invDet;
+      out[2][k] = ab[k] * invDet;
+    }
+    out[0][3] = out[1][3] = out[2][3] = 0.0f;
+#endif
+  }
+}
+
+} // namespace simdtypes
+} // namespace iglu
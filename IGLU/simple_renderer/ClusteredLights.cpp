@@ -0,0 +1,646 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "ClusteredLights.h"
+
+#include "ShaderUniforms.h"
+
+#include <IGLU/glsl/StorageBuffers.h>
+#include <IGLU/simdtypes/SimdUtilities.h>
+#include <algorithm>
+#include <cmath>
+#include <igl/ShaderCreator.h>
+
+namespace iglu {
+namespace lighting {
+
+using namespace simdtypes;
+
+namespace {
+
+constexpr uint32_t kThreadgroupSize = 64;
+
+// Offsets of the buffers from the first buffer index. The compute shader uses them as its buffer
+// indices; they follow the names of the buffers, as OpenGL binds the storage blocks of compute
+// shaders by their resource index.
+constexpr int kCountsOffset = 0;
+constexpr int kIndicesOffset = 1;
+constexpr int kLightsOffset = 2;
+constexpr int kParamsOffset = 3;
+
+const char kLightsTextureName[] = "clusterLightsTexture";
+const char kGridTextureName[] = "clusterGridTexture";
+
+// matches ClusterParams and PointLight
+const char kGlslDeclarations[] = R"(
+struct PointLight {
+  vec4 positionRadius;
+  vec4 color;
+};
+
+COUNTS_BUFFER buffer ClusterCounts {
+  uint clusterCounts[];
+};
+INDICES_BUFFER buffer ClusterIndices {
+  uint clusterIndices[];
+};
+LIGHTS_BUFFER readonly buffer ClusterLights {
+  PointLight clusterLights[];
+};
+PARAMS_BUFFER readonly buffer ClusterParams {
+  mat4 view;
+  vec2 tileScale;
+  vec2 tileBias;
+  float sliceScale;
+  float sliceBias;
+  uint tilesX;
+  uint tilesY;
+  uint numSlices;
+  uint numLights;
+  uint maxLightsPerCluster;
+  float nearZ;
+  vec2 tanHalfFov;
+  float farZ;
+  uint padding;
+} clusterParams;
+)";
+
+// computeClusterBounds() and buildLightLists()
+const char kGlslCompute[] = R"(
+void main() {
+  uint id = gl_GlobalInvocationID.x;
+  uint tilesX = clusterParams.tilesX;
+  uint tilesY = clusterParams.tilesY;
+  if (id >= tilesX * tilesY * clusterParams.numSlices) {
+    return;
+  }
+  vec3 cell = vec3(uvec3(id % tilesX, (id / tilesX) % tilesY, id / (tilesX * tilesY)));
+  vec2 ndc0 = cell.xy * 2.0 / vec2(tilesX, tilesY) - 1.0;
+  vec2 ndc1 = (cell.xy + 1.0) * 2.0 / vec2(tilesX, tilesY) - 1.0;
+  float d0 = max(exp((cell.z - clusterParams.sliceBias) / clusterParams.sliceScale),
+                 clusterParams.nearZ);
+  float d1 = min(exp((cell.z + 1.0 - clusterParams.sliceBias) / clusterParams.sliceScale),
+                 clusterParams.farZ);
+  vec3 boxMin = vec3(min(ndc0 * d0, ndc0 * d1) * clusterParams.tanHalfFov, -d1);
+  vec3 boxMax = vec3(max(ndc1 * d0, ndc1 * d1) * clusterParams.tanHalfFov, -d0);
+
+  uint maxLights = clusterParams.maxLightsPerCluster;
+  uint count = 0u;
+  for (uint i = 0u; i < clusterParams.numLights && count < maxLights; i++) {
+    vec4 light = clusterLights[i].positionRadius;
+    vec3 center = (clusterParams.view * vec4(light.xyz, 1.0)).xyz;
+    vec3 d = max(max(boxMin - center, center - boxMax), vec3(0.0));
+    if (dot(d, d) <= light.w * light.w) {
+      clusterIndices[id * maxLights + count] = i;
+      count++;
+    }
+  }
+  clusterCounts[id] = count;
+}
+)";
+
+const char kGlslFragment[] = R"(
+uint getClusterIndex(vec2 fragCoord, float viewDepth) {
+  uvec2 tiles = uvec2(clusterParams.tilesX, clusterParams.tilesY);
+  vec2 tile = floor(fragCoord * clusterParams.tileScale + clusterParams.tileBias);
+  uvec2 xy = uvec2(clamp(tile, vec2(0.0), vec2(tiles - 1u)));
+  float slice = floor(log(viewDepth) * clusterParams.sliceScale + clusterParams.sliceBias);
+  uint z = uint(clamp(slice, 0.0, float(clusterParams.numSlices - 1u)));
+  return xy.x + tiles.x * (xy.y + tiles.y * z);
+}
+uint getClusterLightCount(uint cluster) {
+  return clusterCounts[cluster];
+}
+uint getClusterLightIndex(uint cluster, uint i) {
+  return clusterIndices[cluster * clusterParams.maxLightsPerCluster + i];
+}
+vec4 getLightPositionRadius(uint light) {
+  return clusterLights[light].positionRadius;
+}
+vec4 getLightColor(uint light) {
+  return clusterLights[light].color;
+}
+)";
+
+// OpenGL ES 3.0: row 0 of the lights texture holds (tileScale, tileBias) and (sliceScale,
+// sliceBias), row 1 + i holds the position and radius, then the color of light i. Each cluster
+// owns a row of 1 + maxLightsPerCluster texels of the grid texture: its light count, then its
+// light indices.
+const char kGlslFallback[] = R"(
+uniform highp sampler2D clusterLightsTexture;
+uniform highp usampler2D clusterGridTexture;
+
+uint getClusterIndex(vec2 fragCoord, float viewDepth) {
+  uvec2 tiles = uvec2(kClusterTilesX, kClusterTilesY);
+  vec4 tileScaleBias = texelFetch(clusterLightsTexture, ivec2(0, 0), 0);
+  vec4 sliceScaleBias = texelFetch(clusterLightsTexture, ivec2(1, 0), 0);
+  vec2 tile = floor(fragCoord * tileScaleBias.xy + tileScaleBias.zw);
+  uvec2 xy = uvec2(clamp(tile, vec2(0.0), vec2(tiles - 1u)));
+  float slice = floor(log(viewDepth) * sliceScaleBias.x + sliceScaleBias.y);
+  uint z = uint(clamp(slice, 0.0, float(kClusterNumSlices - 1u)));
+  return xy.x + tiles.x * (xy.y + tiles.y * z);
+}
+ivec2 getClusterTexel(uint cluster) {
+  return ivec2(int((cluster % kClusterTilesX) * (kClusterMaxLights + 1u)),
+               int(cluster / kClusterTilesX));
+}
+uint getClusterLightCount(uint cluster) {
+  return texelFetch(clusterGridTexture, getClusterTexel(cluster), 0).r;
+}
+uint getClusterLightIndex(uint cluster, uint i) {
+  return texelFetch(clusterGridTexture, getClusterTexel(cluster) + ivec2(1 + int(i), 0), 0).r;
+}
+vec4 getLightPositionRadius(uint light) {
+  return texelFetch(clusterLightsTexture, ivec2(0, int(light) + 1), 0);
+}
+vec4 getLightColor(uint light) {
+  return texelFetch(clusterLightsTexture, ivec2(1, int(light) + 1), 0);
+}
+)";
+
+const char kMetalDeclarations[] = R"(
+#include <metal_stdlib>
+
+struct PointLight {
+  float4 positionRadius;
+  float4 color;
+};
+
+struct ClusterParams {
+  float4x4 view;
+  float2 tileScale;
+  float2 tileBias;
+  float sliceScale;
+  float sliceBias;
+  uint tilesX;
+  uint tilesY;
+  uint numSlices;
+  uint numLights;
+  uint maxLightsPerCluster;
+  float nearZ;
+  float2 tanHalfFov;
+  float farZ;
+  uint padding;
+};
+)";
+
+const char kMetalCompute[] = R"(
+using namespace metal;
+
+kernel void buildLightLists(device uint* clusterCounts [[buffer(0)]],
+                            device uint* clusterIndices [[buffer(1)]],
+                            const device PointLight* clusterLights [[buffer(2)]],
+                            constant ClusterParams& params [[buffer(3)]],
+                            uint id [[thread_position_in_grid]]) {
+  const uint tilesX = params.tilesX;
+  const uint tilesY = params.tilesY;
+  if (id >= tilesX * tilesY * params.numSlices) {
+    return;
+  }
+  const float3 cell = float3(uint3(id % tilesX, (id / tilesX) % tilesY, id / (tilesX * tilesY)));
+  const float2 ndc0 = cell.xy * 2.0 / float2(tilesX, tilesY) - 1.0;
+  const float2 ndc1 = (cell.xy + 1.0) * 2.0 / float2(tilesX, tilesY) - 1.0;
+  const float d0 = max(exp((cell.z - params.sliceBias) / params.sliceScale), params.nearZ);
+  const float d1 = min(exp((cell.z + 1.0 - params.sliceBias) / params.sliceScale), params.farZ);
+  const float3 boxMin = float3(min(ndc0 * d0, ndc0 * d1) * params.tanHalfFov, -d1);
+  const float3 boxMax = float3(max(ndc1 * d0, ndc1 * d1) * params.tanHalfFov, -d0);
+
+  const uint maxLights = params.maxLightsPerCluster;
+  uint count = 0;
+  for (uint i = 0; i < params.numLights && count < maxLights; i++) {
+    const float4 light = clusterLights[i].positionRadius;
+    const float3 center = (params.view * float4(light.xyz, 1.0)).xyz;
+    const float3 d = max(max(boxMin - center, center - boxMax), float3(0.0));
+    if (dot(d, d) <= light.w * light.w) {
+      clusterIndices[id * maxLights + count] = i;
+      count++;
+    }
+  }
+  clusterCounts[id] = count;
+}
+)";
+
+const char kMetalFragment[] = R"(
+struct ClusteredLights {
+  constant ClusterParams* params;
+  const device PointLight* lights;
+  const device uint* counts;
+  const device uint* indices;
+};
+
+inline uint getClusterIndex(ClusteredLights c, float2 fragCoord, float viewDepth) {
+  const uint2 tiles = uint2(c.params->tilesX, c.params->tilesY);
+  const float2 tile = metal::floor(fragCoord * c.params->tileScale + c.params->tileBias);
+  const uint2 xy = uint2(metal::clamp(tile, float2(0.0f), float2(tiles - 1u)));
+  const float slice =
+      metal::floor(metal::log(viewDepth) * c.params->sliceScale + c.params->sliceBias);
+  const uint z = uint(metal::clamp(slice, 0.0f, float(c.params->numSlices - 1u)));
+  return xy.x + tiles.x * (xy.y + tiles.y * z);
+}
+inline uint getClusterLightCount(ClusteredLights c, uint cluster) {
+  return c.counts[cluster];
+}
+inline uint getClusterLightIndex(ClusteredLights c, uint cluster, uint i) {
+  return c.indices[cluster * c.params->maxLightsPerCluster + i];
+}
+inline float4 getLightPositionRadius(ClusteredLights c, uint light) {
+  return c.lights[light].positionRadius;
+}
+inline float4 getLightColor(ClusteredLights c, uint light) {
+  return c.lights[light].color;
+}
+
+#define CLUSTERED_LIGHTS_ARGS {&clusterParams, clusterLights, clusterCounts, clusterIndices}
+)";
+
+// The culling pass binds the buffers from 0, the fragment shaders from firstBufferIndex on
+std::string getGlslDeclarations(bool isVulkan, int firstIndex, bool isCompute) {
+  const auto layout = [isVulkan, firstIndex](int offset) {
+    return glsl::storageBufferLayout(isVulkan, firstIndex + offset);
+  };
+  // the fragment shaders only read the lists
+  const std::string listAccess = isCompute ? " writeonly" : " readonly";
+  return "#define COUNTS_BUFFER " + layout(kCountsOffset) + listAccess + "\n" +
+         "#define INDICES_BUFFER " + layout(kIndicesOffset) + listAccess + "\n" +
+         "#define LIGHTS_BUFFER " + layout(kLightsOffset) + "\n" +
+         "#define PARAMS_BUFFER " + layout(kParamsOffset) + "\n" + kGlslDeclarations;
+}
+
+std::shared_ptr<igl::IBuffer> createBuffer(igl::IDevice& device,
+                                           size_t length,
+                                           const char* debugName,
+                                           igl::Result* outResult) {
+  igl::BufferDesc desc(
+      igl::BufferDesc::BufferTypeBits::Storage, nullptr, length, igl::ResourceStorage::Shared);
+  if (device.hasFeature(igl::DeviceFeatures::BufferRing)) {
+    // cull() uploads the lights and rebuilds the clusters of every frame
+    desc.hint |= igl::BufferDesc::BufferAPIHintBits::Ring;
+  }
+  desc.debugName = debugName;
+  return device.createBuffer(desc, outResult);
+}
+
+} // namespace
+
+bool isClusteredLightsBuffer(const std::string& name) {
+  return name == "clusterParams" || name == "clusterLights" || name == "clusterCounts" ||
+         name == "clusterIndices";
+}
+
+ClusterParams computeClusterParams(const ClusteredLightsConfig& config,
+                                   const CameraDesc& camera,
+                                   const igl::Size& viewportSize,
+                                   uint32_t numLights,
+                                   bool bottomUpFragCoord) {
+  ClusterParams params = {};
+  params.view = camera.view;
+  const auto tilesX = static_cast<float>(config.tilesX);
+  const auto tilesY = static_cast<float>(config.tilesY);
+  params.tileScale[0] = tilesX / viewportSize.width;
+  params.tileBias[0] = 0.0f;
+  if (bottomUpFragCoord) {
+    params.tileScale[1] = tilesY / viewportSize.height;
+    params.tileBias[1] = 0.0f;
+  } else {
+    // the tiles are still counted from the bottom
+    params.tileScale[1] = -tilesY / viewportSize.height;
+    params.tileBias[1] = tilesY;
+  }
+  const float logDepthRange = std::log(camera.farZ / camera.nearZ);
+  const auto numSlices = static_cast<float>(config.numSlices);
+  params.sliceScale = numSlices / logDepthRange;
+  params.sliceBias = -numSlices * std::log(camera.nearZ) / logDepthRange;
+  params.tilesX = config.tilesX;
+  params.tilesY = config.tilesY;
+  params.numSlices = config.numSlices;
+  params.numLights = numLights;
+  params.maxLightsPerCluster = config.maxLightsPerCluster;
+  params.nearZ = camera.nearZ;
+  params.tanHalfFov[1] = std::tan(0.5f * camera.fovY);
+  params.tanHalfFov[0] = params.tanHalfFov[1] * camera.aspectRatio;
+  params.farZ = camera.farZ;
+  return params;
+}
+
+void computeClusterBounds(const ClusterParams& params,
+                          uint32_t cluster,
+                          float3& outMin,
+                          float3& outMax) {
+  const uint32_t x = cluster % params.tilesX;
+  const uint32_t y = (cluster / params.tilesX) % params.tilesY;
+  const uint32_t z = cluster / (params.tilesX * params.tilesY);
+  const auto tilesX = static_cast<float>(params.tilesX);
+  const auto tilesY = static_cast<float>(params.tilesY);
+  const float ndc0[2] = {static_cast<float>(x) * 2.0f / tilesX - 1.0f,
+                         static_cast<float>(y) * 2.0f / tilesY - 1.0f};
+  const float ndc1[2] = {static_cast<float>(x + 1) * 2.0f / tilesX - 1.0f,
+                         static_cast<float>(y + 1) * 2.0f / tilesY - 1.0f};
+  // the inverse of the slice mapping
+  const float d0 =
+      std::max(std::exp((static_cast<float>(z) - params.sliceBias) / params.sliceScale),
+               params.nearZ);
+  const float d1 =
+      std::min(std::exp((static_cast<float>(z + 1) - params.sliceBias) / params.sliceScale),
+               params.farZ);
+  outMin = float3{std::min(ndc0[0] * d0, ndc0[0] * d1) * params.tanHalfFov[0],
+                  std::min(ndc0[1] * d0, ndc0[1] * d1) * params.tanHalfFov[1],
+                  -d1,
+                  0.0f};
+  outMax = float3{std::max(ndc1[0] * d0, ndc1[0] * d1) * params.tanHalfFov[0],
+                  std::max(ndc1[1] * d0, ndc1[1] * d1) * params.tanHalfFov[1],
+                  -d0,
+                  0.0f};
+}
+
+void buildLightLists(const ClusterParams& params,
+                     const PointLight* lights,
+                     uint32_t* outCounts,
+                     uint32_t* outIndices) {
+  const uint32_t numClusters = params.tilesX * params.tilesY * params.numSlices;
+  const uint32_t maxLights = params.maxLightsPerCluster;
+  std::fill(outCounts, outCounts + numClusters, 0u);
+
+  const auto maxSlice = static_cast<float>(params.numSlices - 1);
+  const auto toSlice = [&params, maxSlice](float depth) {
+    const float slice = std::floor(std::log(depth) * params.sliceScale + params.sliceBias);
+    return static_cast<uint32_t>(std::clamp(slice, 0.0f, maxSlice));
+  };
+
+  // lights in increasing order, as in the compute shader; the exact test only runs for the slices
+  // the light's depth range overlaps, give or take one for rounding
+  for (uint32_t i = 0; i != params.numLights; i++) {
+    const float4& light = lights[i].positionRadius;
+    const float4 center = multiply(params.view, float4{light[0], light[1], light[2], 1.0f});
+    const float radius = light[3];
+    const float nearDepth = -center[2] - radius;
+    const float farDepth = -center[2] + radius;
+    if (farDepth < params.nearZ || nearDepth > params.farZ) {
+      continue;
+    }
+    const uint32_t firstSlice = toSlice(std::max(nearDepth, params.nearZ));
+    const uint32_t lastSlice =
+        std::min(toSlice(std::min(farDepth, params.farZ)) + 1, params.numSlices - 1);
+    const uint32_t tilesPerSlice = params.tilesX * params.tilesY;
+    for (uint32_t c = (firstSlice == 0 ? 0 : firstSlice - 1) * tilesPerSlice;
+         c != (lastSlice + 1) * tilesPerSlice;
+         c++) {
+      if (outCounts[c] == maxLights) {
+        continue;
+      }
+      float3 boxMin, boxMax;
+      computeClusterBounds(params, c, boxMin, boxMax);
+      float distanceSquared = 0.0f;
+      for (int axis = 0; axis != 3; axis++) {
+        const float d =
+            std::max(std::max(boxMin[axis] - center[axis], center[axis] - boxMax[axis]), 0.0f);
+        distanceSquared += d * d;
+      }
+      if (distanceSquared <= radius * radius) {
+        outIndices[c * maxLights + outCounts[c]++] = i;
+      }
+    }
+  }
+}
+
+ClusteredLights::ClusteredLights(igl::IDevice& device,
+                                 ClusteredLightsConfig config,
+                                 igl::Result* outResult) :
+  _device(device), _config(config), _backendType(device.getBackendType()) {
+  if (_config.tilesX == 0 || _config.tilesY == 0 || _config.numSlices == 0 ||
+      _config.maxLights == 0 || _config.maxLightsPerCluster == 0 || _config.maxLights > 65535) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentOutOfRange, "Invalid clustered lights config");
+    return;
+  }
+  _usesCompute = device.hasFeature(igl::DeviceFeatures::Compute);
+  if (!_usesCompute && _backendType != igl::BackendType::OpenGL) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::Unsupported,
+                           "Clustered lights require compute shaders or OpenGL");
+    return;
+  }
+  _lights.reserve(_config.maxLights);
+
+  const uint32_t numClusters = getNumClusters();
+  igl::Result result;
+  if (!_usesCompute) {
+    // the CPU fallback uploads the lists into textures each frame
+    const size_t gridWidth = static_cast<size_t>(_config.maxLightsPerCluster + 1) * _config.tilesX;
+    const size_t gridHeight = static_cast<size_t>(_config.tilesY) * _config.numSlices;
+    size_t maxDimension = 0;
+    device.getFeatureLimits(igl::DeviceFeatureLimits::MaxTextureDimension1D2D, maxDimension);
+    if (maxDimension != 0 && (gridWidth > maxDimension || gridHeight > maxDimension ||
+                              _config.maxLights + 1 > maxDimension)) {
+      igl::Result::setResult(outResult,
+                             igl::Result::Code::ArgumentOutOfRange,
+                             "The light list textures exceed the maximum texture size");
+      return;
+    }
+    _counts.resize(numClusters);
+    _indices.resize(static_cast<size_t>(numClusters) * _config.maxLightsPerCluster);
+    _lightTexels.resize(static_cast<size_t>(_config.maxLights + 1) * 8);
+    _gridTexels.resize(gridWidth * gridHeight);
+
+    auto desc = igl::TextureDesc::new2D(igl::TextureFormat::RGBA_F32,
+                                        2,
+                                        _config.maxLights + 1,
+                                        igl::TextureDesc::TextureUsageBits::Sampled,
+                                        "ClusteredLights lights");
+    _lightsTexture = device.createTexture(desc, &result);
+    if (result.isOk()) {
+      desc = igl::TextureDesc::new2D(igl::TextureFormat::R_UInt16,
+                                     gridWidth,
+                                     gridHeight,
+                                     igl::TextureDesc::TextureUsageBits::Sampled,
+                                     "ClusteredLights grid");
+      _gridTexture = device.createTexture(desc, &result);
+    }
+    if (result.isOk()) {
+      // neither texture is filterable
+      igl::SamplerStateDesc samplerDesc;
+      samplerDesc.minFilter = samplerDesc.magFilter = igl::SamplerMinMagFilter::Nearest;
+      samplerDesc.mipFilter = igl::SamplerMipFilter::Disabled;
+      samplerDesc.debugName = "ClusteredLights";
+      _sampler = device.createSamplerState(samplerDesc, &result);
+    }
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  _paramsBuffer = createBuffer(device, sizeof(ClusterParams), "ClusteredLights params", &result);
+  if (result.isOk()) {
+    _lightsBuffer = createBuffer(
+        device, _config.maxLights * sizeof(PointLight), "ClusteredLights lights", &result);
+  }
+  if (result.isOk()) {
+    _countsBuffer =
+        createBuffer(device, numClusters * sizeof(uint32_t), "ClusteredLights counts", &result);
+  }
+  if (result.isOk()) {
+    _indicesBuffer = createBuffer(device,
+                                  static_cast<size_t>(numClusters) *
+                                      _config.maxLightsPerCluster * sizeof(uint32_t),
+                                  "ClusteredLights indices",
+                                  &result);
+  }
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  const bool isMetal = _backendType == igl::BackendType::Metal;
+  const bool isVulkan = _backendType == igl::BackendType::Vulkan;
+  const std::string source =
+      isMetal ? std::string(kMetalDeclarations) + kMetalCompute
+              : std::string(isVulkan ? "" : "#version 310 es\nprecision highp float;\n") +
+                    "layout (local_size_x = " + std::to_string(kThreadgroupSize) + ") in;\n" +
+                    getGlslDeclarations(isVulkan, 0, true) + kGlslCompute;
+  std::shared_ptr<igl::IShaderStages> stages =
+      igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                      source.c_str(),
+                                                      isMetal ? "buildLightLists" : "main",
+                                                      "ClusteredLights",
+                                                      &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  igl::ComputePipelineDesc desc;
+  desc.shaderStages = std::move(stages);
+  desc.buffersMap[kCountsOffset] = igl::genNameHandle("ClusterCounts");
+  desc.buffersMap[kIndicesOffset] = igl::genNameHandle("ClusterIndices");
+  desc.buffersMap[kLightsOffset] = igl::genNameHandle("ClusterLights");
+  desc.buffersMap[kParamsOffset] = igl::genNameHandle("ClusterParams");
+  desc.debugName = "ClusteredLights";
+  _pipelineState = device.createComputePipeline(desc, outResult);
+}
+
+ClusteredLights::~ClusteredLights() = default;
+
+void ClusteredLights::setLights(const std::vector<PointLight>& lights,
+                                const CameraDesc& camera,
+                                const igl::Size& viewportSize) {
+  const size_t numLights = std::min(lights.size(), static_cast<size_t>(_config.maxLights));
+  _lights.assign(lights.begin(), lights.begin() + numLights);
+  _params = computeClusterParams(_config,
+                                 camera,
+                                 viewportSize,
+                                 static_cast<uint32_t>(numLights),
+                                 _backendType == igl::BackendType::OpenGL);
+}
+
+void ClusteredLights::cull(igl::ICommandBuffer& commandBuffer) {
+  if (!_usesCompute) {
+    if (!IGL_VERIFY(_lightsTexture && _gridTexture)) {
+      return;
+    }
+    buildLightLists(_params, _lights.data(), _counts.data(), _indices.data());
+
+    const uint32_t numLights = _params.numLights;
+    float* texel = _lightTexels.data();
+    texel[0] = _params.tileScale[0];
+    texel[1] = _params.tileScale[1];
+    texel[2] = _params.tileBias[0];
+    texel[3] = _params.tileBias[1];
+    texel[4] = _params.sliceScale;
+    texel[5] = _params.sliceBias;
+    for (uint32_t i = 0; i != numLights; i++) {
+      for (int c = 0; c != 4; c++) {
+        texel[8 * (i + 1) + c] = _lights[i].positionRadius[c];
+        texel[8 * (i + 1) + 4 + c] = _lights[i].color[c];
+      }
+    }
+    // each cluster row holds the count, then the indices; the rest of the row is never read
+    const uint32_t maxLights = _config.maxLightsPerCluster;
+    for (uint32_t c = 0; c != getNumClusters(); c++) {
+      uint16_t* row = _gridTexels.data() + static_cast<size_t>(c) * (maxLights + 1);
+      row[0] = static_cast<uint16_t>(_counts[c]);
+      for (uint32_t i = 0; i != _counts[c]; i++) {
+        row[1 + i] = static_cast<uint16_t>(_indices[c * maxLights + i]);
+      }
+    }
+    _lightsTexture->upload(igl::TextureRangeDesc::new2D(0, 0, 2, numLights + 1),
+                           _lightTexels.data());
+    _gridTexture->upload(_gridTexture->getFullRange(), _gridTexels.data());
+    return;
+  }
+
+  if (!IGL_VERIFY(_pipelineState)) {
+    return;
+  }
+  _paramsBuffer->upload(&_params, {sizeof(_params), 0});
+  if (!_lights.empty()) {
+    _lightsBuffer->upload(_lights.data(), {_lights.size() * sizeof(PointLight), 0});
+  }
+
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("ClusteredLights::cull()");
+  encoder->bindComputePipelineState(_pipelineState);
+  encoder->bindBuffer(kCountsOffset, _countsBuffer, 0);
+  encoder->bindBuffer(kIndicesOffset, _indicesBuffer, 0);
+  encoder->bindBuffer(kLightsOffset, _lightsBuffer, 0);
+  encoder->bindBuffer(kParamsOffset, _paramsBuffer, 0);
+  encoder->dispatchThreadGroups(
+      igl::Dimensions((getNumClusters() + kThreadgroupSize - 1) / kThreadgroupSize, 1, 1),
+      igl::Dimensions(kThreadgroupSize, 1, 1));
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+void ClusteredLights::bind(igl::IRenderCommandEncoder& encoder) const {
+  if (!_usesCompute || !IGL_VERIFY(_pipelineState)) {
+    return;
+  }
+  // storage buffers are visible to all graphics stages on Vulkan, and an OpenGL buffer bound for
+  // the vertex stage would be bound as a vertex buffer
+  const uint8_t target = _backendType == igl::BackendType::Vulkan ? igl::BindTarget::kAllGraphics
+                                                                   : igl::BindTarget::kFragment;
+  const int first = _config.firstBufferIndex;
+  encoder.bindBuffer(first + kCountsOffset, target, _countsBuffer, 0);
+  encoder.bindBuffer(first + kIndicesOffset, target, _indicesBuffer, 0);
+  encoder.bindBuffer(first + kLightsOffset, target, _lightsBuffer, 0);
+  encoder.bindBuffer(first + kParamsOffset, target, _paramsBuffer, 0);
+}
+
+void ClusteredLights::populateShaderUniforms(material::ShaderUniforms& uniforms) const {
+  if (_usesCompute) {
+    return;
+  }
+  uniforms.setTexture(kLightsTextureName, _lightsTexture, _sampler);
+  uniforms.setTexture(kGridTextureName, _gridTexture, _sampler);
+}
+
+std::string ClusteredLights::getShaderSource() const {
+  if (_backendType == igl::BackendType::Metal) {
+    const auto index = [this](int offset) {
+      return std::to_string(_config.firstBufferIndex + offset);
+    };
+    return std::string(kMetalDeclarations) + kMetalFragment +
+           "#define CLUSTERED_LIGHTS_PARAMS constant ClusterParams& clusterParams [[buffer(" +
+           index(kParamsOffset) + ")]], const device PointLight* clusterLights [[buffer(" +
+           index(kLightsOffset) + ")]], const device uint* clusterCounts [[buffer(" +
+           index(kCountsOffset) + ")]], const device uint* clusterIndices [[buffer(" +
+           index(kIndicesOffset) + ")]]\n";
+  }
+  if (_usesCompute) {
+    return getGlslDeclarations(
+               _backendType == igl::BackendType::Vulkan, _config.firstBufferIndex, false) +
+           kGlslFragment;
+  }
+  return "const uint kClusterTilesX = " + std::to_string(_config.tilesX) +
+         "u;\nconst uint kClusterTilesY = " + std::to_string(_config.tilesY) +
+         "u;\nconst uint kClusterNumSlices = " + std::to_string(_config.numSlices) +
+         "u;\nconst uint kClusterMaxLights = " + std::to_string(_config.maxLightsPerCluster) +
+         "u;\n" + kGlslFallback;
+}
+
+} // namespace lighting
+} // namespace iglu
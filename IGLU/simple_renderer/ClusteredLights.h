@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace material {
+class ShaderUniforms;
+} // namespace material
+
+namespace lighting {
+
+/// A point light in world space. The light has no effect beyond 'radius'.
+struct PointLight {
+  simdtypes::float4 positionRadius = {};
+  simdtypes::float4 color = {};
+};
+static_assert(sizeof(PointLight) == 32, "PointLight must match the shader layout");
+
+struct ClusteredLightsConfig {
+  // the froxel grid: screen space tiles times exponential depth slices
+  uint32_t tilesX = 16;
+  uint32_t tilesY = 9;
+  uint32_t numSlices = 24;
+  // lights beyond this number are ignored; at most 65535. Without compute shaders, the lights
+  // are stored in a texture with maxLights + 1 rows.
+  uint32_t maxLights = 1024;
+  // lights beyond this number in a cluster are dropped
+  uint32_t maxLightsPerCluster = 64;
+  // the first of the 4 buffer indices of the light lists in fragment shaders; on OpenGL, the
+  // first shader storage buffer binding point
+  int firstBufferIndex = 8;
+};
+
+/// The camera the froxel grid covers: a symmetric perspective projection. The view space is
+/// right-handed and looks down -Z, as with glm::lookAt().
+struct CameraDesc {
+  simdtypes::float4x4 view = simdtypes::float4x4(1.0f);
+  // vertical field of view in radians
+  float fovY = 1.0f;
+  float aspectRatio = 1.0f;
+  float nearZ = 0.1f;
+  float farZ = 100.0f;
+};
+
+/// Shared by the culling and the shaders reading the light lists; matches the std430 and Metal
+/// layouts of ClusterParams.
+struct ClusterParams {
+  simdtypes::float4x4 view;
+  // tile = floor(fragCoord * tileScale + tileBias), counted from the bottom-left tile
+  float tileScale[2];
+  float tileBias[2];
+  // slice = floor(log(viewDepth) * sliceScale + sliceBias)
+  float sliceScale;
+  float sliceBias;
+  uint32_t tilesX;
+  uint32_t tilesY;
+  uint32_t numSlices;
+  uint32_t numLights;
+  uint32_t maxLightsPerCluster;
+  float nearZ;
+  float tanHalfFov[2];
+  float farZ;
+  uint32_t padding;
+};
+static_assert(sizeof(ClusterParams) == 128, "ClusterParams must match the shader layout");
+
+/// Returns true for the names of the buffers the light lists are bound as in Metal fragment
+/// functions, which materials must not bind.
+bool isClusteredLightsBuffer(const std::string& name);
+
+/// The parameters of the grid covering a viewport of 'viewportSize' pixels. 'bottomUpFragCoord'
+/// is true if the fragment coordinates start at the bottom of the viewport (OpenGL).
+ClusterParams computeClusterParams(const ClusteredLightsConfig& config,
+                                   const CameraDesc& camera,
+                                   const igl::Size& viewportSize,
+                                   uint32_t numLights,
+                                   bool bottomUpFragCoord);
+
+/// The view space box of cluster 'cluster', which covers the view depths of its slice between
+/// nearZ and farZ.
+void computeClusterBounds(const ClusterParams& params,
+                          uint32_t cluster,
+                          simdtypes::float3& outMin,
+                          simdtypes::float3& outMax);
+
+/// Builds the light lists on the CPU, like the compute shader: cluster c holds outCounts[c]
+/// lights, whose indices in increasing order are outIndices[c * maxLightsPerCluster + i]. The
+/// clusters are ordered by tile x, then tile y, then slice.
+void buildLightLists(const ClusterParams& params,
+                     const PointLight* lights,
+                     uint32_t* outCounts,
+                     uint32_t* outIndices);
+
+/**
+ * @brief Clustered forward shading: per froxel lists of the point lights which touch it.
+ *
+ * The view frustum is split into a grid of screen space tiles and exponential depth slices. cull()
+ * tests each light's sphere against the box of each froxel and writes the lists of the lights
+ * touching it, so the fragment shaders of materials only shade the lights of their froxel.
+ *
+ * On Vulkan, Metal and OpenGL with DeviceFeatures::Compute (OpenGL 4.3, OpenGL ES 3.1), the lists
+ * are built by a compute dispatch into storage buffers, read by fragment shaders as storage
+ * buffers at config.firstBufferIndex. Without compute shaders (OpenGL ES 3.0), they are built on
+ * the CPU and uploaded into two textures, which are bound with the other textures of each material
+ * once populateShaderUniforms() set them.
+ *
+ * Fragment shaders include getShaderSource() after their #version and precision statements, and
+ * loop over the lights of their cluster:
+ *
+ *   uint cluster = getClusterIndex(gl_FragCoord.xy, viewDepth);
+ *   for (uint i = 0u; i < getClusterLightCount(cluster); i++) {
+ *     uint light = getClusterLightIndex(cluster, i);
+ *     ... getLightPositionRadius(light), getLightColor(light) ...
+ *   }
+ *
+ * where viewDepth is the positive distance of the fragment along the view direction and the lights
+ * are in world space. The GLSL
+ * requires #version 310 es or 430 with compute shaders and #version 300 es without. On Metal, the
+ * functions take a ClusteredLights argument first, created in the fragment function with
+ * CLUSTERED_LIGHTS_ARGS from the parameters declared by CLUSTERED_LIGHTS_PARAMS.
+ */
+class ClusteredLights final {
+ public:
+  ClusteredLights(igl::IDevice& device, ClusteredLightsConfig config, igl::Result* outResult);
+  ~ClusteredLights();
+
+  ClusteredLights(const ClusteredLights&) = delete;
+  ClusteredLights& operator=(const ClusteredLights&) = delete;
+
+  /// Sets the lights and the camera of the next cull(). Lights beyond maxLights are ignored.
+  void setLights(const std::vector<PointLight>& lights,
+                 const CameraDesc& camera,
+                 const igl::Size& viewportSize);
+
+  /// Builds the light lists. Must be called outside of render passes, before the render passes
+  /// reading them.
+  void cull(igl::ICommandBuffer& commandBuffer);
+
+  /// Binds the light lists for the fragment shaders of 'encoder'. The bindings are kept when
+  /// render pipeline states are bound.
+  void bind(igl::IRenderCommandEncoder& encoder) const;
+
+  /// Sets the light list textures of a material on OpenGL without compute shaders; does nothing
+  /// otherwise. The textures stay the same, so it is only needed once per material.
+  void populateShaderUniforms(material::ShaderUniforms& uniforms) const;
+
+  /// Declarations and functions for fragment shaders on this device
+  [[nodiscard]] std::string getShaderSource() const;
+
+  [[nodiscard]] bool usesCompute() const {
+    return _usesCompute;
+  }
+  [[nodiscard]] uint32_t getNumClusters() const {
+    return _config.tilesX * _config.tilesY * _config.numSlices;
+  }
+  /// The light counts and indices built by cull() with compute shaders, laid out as by
+  /// buildLightLists(); null without compute shaders
+  [[nodiscard]] const std::shared_ptr<igl::IBuffer>& getLightCountsBuffer() const {
+    return _countsBuffer;
+  }
+  [[nodiscard]] const std::shared_ptr<igl::IBuffer>& getLightIndicesBuffer() const {
+    return _indicesBuffer;
+  }
+
+ private:
+  igl::IDevice& _device;
+  const ClusteredLightsConfig _config;
+  igl::BackendType _backendType;
+  bool _usesCompute = false;
+
+  ClusterParams _params = {};
+  std::vector<PointLight> _lights;
+
+  // compute shaders
+  std::shared_ptr<igl::IComputePipelineState> _pipelineState;
+  std::shared_ptr<igl::IBuffer> _paramsBuffer;
+  std::shared_ptr<igl::IBuffer> _lightsBuffer;
+  std::shared_ptr<igl::IBuffer> _countsBuffer;
+  std::shared_ptr<igl::IBuffer> _indicesBuffer;
+
+  // CPU fallback
+  std::vector<uint32_t> _counts;
+  std::vector<uint32_t> _indices;
+  std::vector<float> _lightTexels;
+  std::vector<uint16_t> _gridTexels;
+  std::shared_ptr<igl::ITexture> _lightsTexture;
+  std::shared_ptr<igl::ITexture> _gridTexture;
+  std::shared_ptr<igl::ISamplerState> _sampler;
+};
+
+} // namespace lighting
+} // namespace iglu
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Culler.h"
+
+#include <IGLU/simdtypes/SimdBatch.h>
+#include <IGLU/simdtypes/SimdUtilities.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <igl/WorkerPool.h>
+#include <mutex>
+
+namespace iglu {
+namespace culling {
+
+namespace {
+// large enough to amortize the cost of a task, small enough to keep all workers busy
+constexpr size_t kChunkSize = 1024;
+
+void getCorners(const vertexdata::Bounds& bounds, simdtypes::float4 outCorners[8]) {
+  for (int i = 0; i != 8; i++) {
+    outCorners[i] = simdtypes::float4{(i & 1) ? bounds.max[0] : bounds.min[0],
+                                      (i & 2) ? bounds.max[1] : bounds.min[1],
+                                      (i & 4) ? bounds.max[2] : bounds.min[2],
+                                      1.0f};
+  }
+}
+} // namespace
+
+vertexdata::Bounds transformBounds(const vertexdata::Bounds& bounds,
+                                   const simdtypes::float4x4& model) {
+  if (!bounds.isValid) {
+    return bounds;
+  }
+  simdtypes::float4 corners[8];
+  getCorners(bounds, corners);
+  vertexdata::Bounds result;
+  for (const auto& corner : corners) {
+    const simdtypes::float4 p = simdtypes::multiply(model, corner);
+    const float position[3] = {p[0], p[1], p[2]};
+    result.extend(position);
+  }
+  return result;
+}
+
+void HiZBuffer::update(const float* depth,
+                       uint32_t width,
+                       uint32_t height,
+                       const simdtypes::float4x4& viewProjection,
+                       bool zeroToOneDepth) {
+  _viewProjection = viewProjection;
+  _zeroToOneDepth = zeroToOneDepth;
+  _levels.clear();
+  if (!depth || width == 0 || height == 0) {
+    return;
+  }
+
+  _levels.push_back({width, height, std::vector<float>(depth, depth + size_t(width) * height)});
+  while (_levels.back().width > 1 || _levels.back().height > 1) {
+    const Level& src = _levels.back();
+    Level dst;
+    dst.width = std::max(1u, (src.width + 1) / 2);
+    dst.height = std::max(1u, (src.height + 1) / 2);
+    dst.depth.resize(size_t(dst.width) * dst.height);
+    for (uint32_t y = 0; y != dst.height; y++) {
+      const uint32_t y0 = std::min(2 * y, src.height - 1);
+      const uint32_t y1 = std::min(2 * y + 1, src.height - 1);
+      for (uint32_t x = 0; x != dst.width; x++) {
+        const uint32_t x0 = std::min(2 * x, src.width - 1);
+        const uint32_t x1 = std::min(2 * x + 1, src.width - 1);
+        dst.depth[size_t(y) * dst.width + x] = std::max(std::max(src.depth[y0 * src.width + x0],
+                                                                 src.depth[y0 * src.width + x1]),
+                                                        std::max(src.depth[y1 * src.width + x0],
+                                                                 src.depth[y1 * src.width + x1]));
+      }
+    }
+    _levels.push_back(std::move(dst));
+  }
+}
+
+bool HiZBuffer::isOccluded(const vertexdata::Bounds& worldBounds) const {
+  if (_levels.empty() || !worldBounds.isValid) {
+    return false;
+  }
+
+  // screen space rectangle and closest depth of the box
+  simdtypes::float4 corners[8];
+  getCorners(worldBounds, corners);
+  float minX = 1.0f, minY = 1.0f, maxX = -1.0f, maxY = -1.0f;
+  float minDepth = 1.0f;
+  for (const auto& corner : corners) {
+    const simdtypes::float4 clip = simdtypes::multiply(_viewProjection, corner);
+    if (clip[3] <= 0.0f) {
+      return false;
+    }
+    const float x = clip[0] / clip[3];
+    const float y = clip[1] / clip[3];
+    const float z = clip[2] / clip[3];
+    minX = std::min(minX, x);
+    maxX = std::max(maxX, x);
+    minY = std::min(minY, y);
+    maxY = std::max(maxY, y);
+    minDepth = std::min(minDepth, _zeroToOneDepth ? z : z * 0.5f + 0.5f);
+  }
+  if (minDepth < 0.0f) {
+    return false;
+  }
+  minX = std::max(minX, -1.0f);
+  minY = std::max(minY, -1.0f);
+  maxX = std::min(maxX, 1.0f);
+  maxY = std::min(maxY, 1.0f);
+  if (minX > maxX || minY > maxY) {
+    // outside of the screen: left to the frustum test
+    return false;
+  }
+
+  // pick the level where the rectangle covers at most 2x2 texels
+  const Level& base = _levels.front();
+  const float x0 = (minX * 0.5f + 0.5f) * base.width;
+  const float x1 = (maxX * 0.5f + 0.5f) * base.width;
+  const float y0 = (minY * 0.5f + 0.5f) * base.height;
+  const float y1 = (maxY * 0.5f + 0.5f) * base.height;
+  const float size = std::max(std::max(x1 - x0, y1 - y0), 1.0f);
+  const auto levelIndex = std::min(static_cast<size_t>(std::ceil(std::log2(size))),
+                                   _levels.size() - 1);
+  const Level& level = _levels[levelIndex];
+  const float scale = 1.0f / static_cast<float>(1u << levelIndex);
+  const auto toTexel = [scale](float v, uint32_t extent) {
+    return std::min(static_cast<uint32_t>(std::max(v * scale, 0.0f)), extent - 1);
+  };
+
+  float maxDepth = 0.0f;
+  for (uint32_t y = toTexel(y0, level.height); y <= toTexel(y1, level.height); y++) {
+    for (uint32_t x = toTexel(x0, level.width); x <= toTexel(x1, level.width); x++) {
+      maxDepth = std::max(maxDepth, level.depth[size_t(y) * level.width + x]);
+    }
+  }
+  return minDepth > maxDepth;
+}
+
+void Culler::setViewProjection(const simdtypes::float4x4& viewProjection, bool zeroToOneDepth) {
+  simdtypes::getFrustumPlanes(viewProjection, zeroToOneDepth, _planes);
+  _hasPlanes = true;
+}
+
+size_t Culler::cull(const std::vector<vertexdata::Bounds>& worldBounds,
+                    std::vector<uint8_t>& outVisible) const {
+  const size_t count = worldBounds.size();
+  outVisible.resize(count);
+  if (!_workerPool || count <= kChunkSize) {
+    return cullRange(worldBounds, 0, count, outVisible.data());
+  }
+
+  const size_t numChunks = (count + kChunkSize - 1) / kChunkSize;
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t numPending = numChunks;
+  size_t numVisible = 0;
+  for (size_t chunk = 0; chunk != numChunks; chunk++) {
+    _workerPool->enqueue([&, chunk]() {
+      const size_t begin = chunk * kChunkSize;
+      const size_t end = std::min(begin + kChunkSize, count);
+      const size_t chunkVisible = cullRange(worldBounds, begin, end, outVisible.data());
+      std::lock_guard<std::mutex> lock(mutex);
+      numVisible += chunkVisible;
+      if (--numPending == 0) {
+        cv.notify_one();
+      }
+    });
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&numPending]() { return numPending == 0; });
+  return numVisible;
+}
+
+size_t Culler::cullRange(const std::vector<vertexdata::Bounds>& worldBounds,
+                         size_t begin,
+                         size_t end,
+                         uint8_t* outVisible) const {
+  const size_t count = end - begin;
+  if (_hasPlanes) {
+    std::vector<simdtypes::float4> mins(count);
+    std::vector<simdtypes::float4> maxs(count);
+    for (size_t i = 0; i != count; i++) {
+      mins[i] = worldBounds[begin + i].min;
+      maxs[i] = worldBounds[begin + i].max;
+    }
+    simdtypes::cullBoxesBatch(_planes, mins.data(), maxs.data(), outVisible + begin, count);
+  } else {
+    std::fill(outVisible + begin, outVisible + end, 1);
+  }
+
+  size_t numVisible = 0;
+  for (size_t i = begin; i != end; i++) {
+    const vertexdata::Bounds& bounds = worldBounds[i];
+    if (!bounds.isValid) {
+      outVisible[i] = 1;
+    } else if (outVisible[i] && _hiZBuffer.isOccluded(bounds)) {
+      outVisible[i] = 0;
+    }
+    numVisible += outVisible[i];
+  }
+  return numVisible;
+}
+
+} // namespace culling
+} // namespace iglu
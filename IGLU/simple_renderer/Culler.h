@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <IGLU/simple_renderer/VertexData.h>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace igl {
+class WorkerPool;
+} // namespace igl
+
+namespace iglu {
+namespace culling {
+
+/// Returns the world space box containing 'bounds' transformed by 'model'.
+vertexdata::Bounds transformBounds(const vertexdata::Bounds& bounds,
+                                   const simdtypes::float4x4& model);
+
+/// A CPU depth pyramid of a previous frame, where each texel holds the furthest depth of the
+/// texels it covers in the level below. Boxes entirely behind it were hidden in that frame.
+class HiZBuffer final {
+ public:
+  /// Builds the pyramid from 'depth', given as 'width' x 'height' floats from the bottom row to
+  /// the top row, e.g. read back from the depth attachment of the previous frame rendered with
+  /// 'viewProjection'. Smaller depth values are closer to the camera.
+  void update(const float* depth,
+              uint32_t width,
+              uint32_t height,
+              const simdtypes::float4x4& viewProjection,
+              bool zeroToOneDepth);
+
+  /// Returns true if the world space box is behind the depth of the previous frame. Boxes
+  /// crossing the camera plane are never occluded.
+  [[nodiscard]] bool isOccluded(const vertexdata::Bounds& worldBounds) const;
+
+  [[nodiscard]] bool isValid() const {
+    return !_levels.empty();
+  }
+
+ private:
+  struct Level {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<float> depth;
+  };
+  std::vector<Level> _levels;
+  simdtypes::float4x4 _viewProjection;
+  bool _zeroToOneDepth = true;
+};
+
+/**
+ * @brief Tests world space bounding boxes against a view frustum and, optionally, the depth of
+ * the previous frame.
+ *
+ * Frustum tests use the batch kernels of simdtypes. With a worker pool, large batches are split
+ * into chunks culled in parallel while the calling thread waits for the results.
+ */
+class Culler final {
+ public:
+  explicit Culler(std::shared_ptr<igl::WorkerPool> workerPool = nullptr) :
+    _workerPool(std::move(workerPool)) {}
+
+  /// 'zeroToOneDepth' is true for clip spaces with a depth range of [0, 1] (Metal, Vulkan) and
+  /// false for [-1, 1] (OpenGL).
+  void setViewProjection(const simdtypes::float4x4& viewProjection, bool zeroToOneDepth);
+
+  /// Depth of the previous frame for the occlusion test, which is enabled once the buffer was
+  /// updated.
+  HiZBuffer& occlusionBuffer() {
+    return _hiZBuffer;
+  }
+
+  /// Sets outVisible[i] to 1 if worldBounds[i] may be visible, and to 0 otherwise. Invalid
+  /// bounds are always visible. Returns the number of visible boxes.
+  size_t cull(const std::vector<vertexdata::Bounds>& worldBounds,
+              std::vector<uint8_t>& outVisible) const;
+
+ private:
+  size_t cullRange(const std::vector<vertexdata::Bounds>& worldBounds,
+                   size_t begin,
+                   size_t end,
+                   uint8_t* outVisible) const;
+
+  std::shared_ptr<igl::WorkerPool> _workerPool;
+  simdtypes::float4 _planes[6] = {};
+  bool _hasPlanes = false;
+  HiZBuffer _hiZBuffer;
+};
+
+} // namespace culling
+} // namespace iglu
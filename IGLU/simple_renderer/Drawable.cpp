@@ -19,22 +19,43 @@ Drawable::Drawable(std::shared_ptr<vertexdata::VertexData> vertexData,
 void Drawable::draw(igl::IDevice& device,
                     igl::IRenderCommandEncoder& commandEncoder,
                     const igl::RenderPipelineDesc& pipelineDesc) {
+  draw(device,
+       commandEncoder,
+       pipelineDesc,
+       std::hash<igl::RenderPipelineDesc>()(pipelineDesc),
+       nullptr);
+}
+
+void Drawable::draw(igl::IDevice& device,
+                    igl::IRenderCommandEncoder& commandEncoder,
+                    const igl::RenderPipelineDesc& pipelineDesc,
+                    size_t pipelineDescHash,
+                    pipelinecache::RenderPipelineCache* pipelineCache) {
+  const auto& state = pipelineState(device, pipelineDesc, pipelineDescHash, pipelineCache);
+
+  commandEncoder.bindRenderPipelineState(state);
+
+  _material->bind(device, *state, commandEncoder);
+
+  _vertexData->draw(commandEncoder);
+}
+
+const std::shared_ptr<igl::IRenderPipelineState>& Drawable::pipelineState(
+    igl::IDevice& device,
+    const igl::RenderPipelineDesc& pipelineDesc,
+    size_t pipelineDescHash,
+    pipelinecache::RenderPipelineCache* pipelineCache) {
   // Assumption: _vertexData and _material are immutable
-  size_t pipelineDescHash = std::hash<igl::RenderPipelineDesc>()(pipelineDesc);
   if (!_pipelineState || pipelineDescHash != _lastPipelineDescHash) {
     igl::RenderPipelineDesc mutablePipelineDesc = pipelineDesc;
     _vertexData->populatePipelineDescriptor(mutablePipelineDesc);
     _material->populatePipelineDescriptor(mutablePipelineDesc);
 
-    _pipelineState = device.createRenderPipeline(mutablePipelineDesc, nullptr);
+    _pipelineState = pipelineCache ? pipelineCache->getRenderPipeline(mutablePipelineDesc)
+                                   : device.createRenderPipeline(mutablePipelineDesc, nullptr);
     _lastPipelineDescHash = pipelineDescHash;
   }
-
-  commandEncoder.bindRenderPipelineState(_pipelineState);
-
-  _material->bind(device, *_pipelineState, commandEncoder);
-
-  _vertexData->draw(commandEncoder);
+  return _pipelineState;
 }
 
 } // namespace drawable
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <IGLU/simple_renderer/Material.h>
+#include <IGLU/simple_renderer/RenderPipelineCache.h>
 #include <IGLU/simple_renderer/VertexData.h>
 #include <memory>
 
@@ -26,6 +27,30 @@ class Drawable final {
             igl::IRenderCommandEncoder& commandEncoder,
             const igl::RenderPipelineDesc& pipelineDesc);
 
+  /// Same as above, with the hash of 'pipelineDesc' computed by the caller whenever the
+  /// descriptor changes, so drawing doesn't hash it again. Render pipeline states are shared
+  /// with other drawables through 'pipelineCache', if provided.
+  void draw(igl::IDevice& device,
+            igl::IRenderCommandEncoder& commandEncoder,
+            const igl::RenderPipelineDesc& pipelineDesc,
+            size_t pipelineDescHash,
+            pipelinecache::RenderPipelineCache* pipelineCache);
+
+  /// Returns the render pipeline state used to draw this drawable with 'pipelineDesc', creating
+  /// it when 'pipelineDescHash' changed since the last call. Used to sort drawables by state.
+  const std::shared_ptr<igl::IRenderPipelineState>& pipelineState(
+      igl::IDevice& device,
+      const igl::RenderPipelineDesc& pipelineDesc,
+      size_t pipelineDescHash,
+      pipelinecache::RenderPipelineCache* pipelineCache);
+
+  const std::shared_ptr<vertexdata::VertexData>& vertexData() const {
+    return _vertexData;
+  }
+  const std::shared_ptr<material::Material>& material() const {
+    return _material;
+  }
+
   /// A Drawable is "immutable" in that there's no API to modify its inputs after
   /// creation. They're lightweight objects and should be recreated instead of updated.
   Drawable(std::shared_ptr<vertexdata::VertexData> vertexData,
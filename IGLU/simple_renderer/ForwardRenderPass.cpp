@@ -7,12 +7,39 @@
 
 #include "ForwardRenderPass.h"
 
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
 namespace iglu {
 namespace renderpass {
 
-ForwardRenderPass::ForwardRenderPass(igl::IDevice& device) {
+namespace {
+// Sort key layout, from the most significant bit:
+//   opaque:      0 | pipeline (15 bits) | material (16 bits) | depth (32 bits, ascending)
+//   translucent: 1 | depth (32 bits, descending) | pipeline (15 bits) | material (16 bits)
+constexpr uint64_t kTranslucentBit = 1ull << 63;
+constexpr uint32_t kMaxSortId = (1u << 15) - 1;
+
+// maps a float to an unsigned integer with the same ordering
+uint32_t toSortableDepth(float depth) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &depth, sizeof(bits));
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+uint32_t getSortId(std::unordered_map<const void*, uint32_t>& sortIds, const void* object) {
+  const auto id = static_cast<uint32_t>(sortIds.size());
+  // ids beyond 15 bits only degrade the sorting
+  return sortIds.emplace(object, std::min(id, kMaxSortId)).first->second;
+}
+} // namespace
+
+ForwardRenderPass::ForwardRenderPass(
+    igl::IDevice& device,
+    std::shared_ptr<pipelinecache::RenderPipelineCache> pipelineCache) :
+  _pipelineCache(pipelineCache ? std::move(pipelineCache)
+                               : std::make_shared<pipelinecache::RenderPipelineCache>(device)) {
   igl::CommandQueueDesc desc;
   _commandQueue = device.createCommandQueue(desc, nullptr);
   _backendType = device.getBackendType();
@@ -30,6 +57,8 @@ void ForwardRenderPass::begin(std::shared_ptr<igl::IFramebuffer> target,
   auto depthAttachment = _framebuffer->getDepthAttachment();
   _renderPipelineDesc.targetDesc.depthAttachmentFormat =
       depthAttachment ? depthAttachment->getFormat() : igl::TextureFormat::Invalid;
+  // hashed once per render pass instead of once per drawable
+  _renderPipelineDescHash = std::hash<igl::RenderPipelineDesc>()(_renderPipelineDesc);
 
   igl::RenderPassDesc defaultRenderPassDesc;
   defaultRenderPassDesc.colorAttachments.resize(1);
@@ -42,17 +71,129 @@ void ForwardRenderPass::begin(std::shared_ptr<igl::IFramebuffer> target,
 
   igl::CommandBufferDesc cbDesc;
   _commandBuffer = _commandQueue->createCommandBuffer(cbDesc, nullptr);
+  if (_lights) {
+    // the light lists are built outside of the render pass
+    _lights->cull(*_commandBuffer);
+  }
   _commandEncoder = _commandBuffer->createRenderCommandEncoder(*finalDesc, _framebuffer);
+  if (_lights) {
+    _lights->bind(*_commandEncoder);
+  }
 }
 
 void ForwardRenderPass::draw(drawable::Drawable& drawable, igl::IDevice& device) const {
   IGL_ASSERT_MSG(isActive(), "Drawing not in progress");
-  drawable.draw(device, *_commandEncoder, _renderPipelineDesc);
+  drawable.draw(
+      device, *_commandEncoder, _renderPipelineDesc, _renderPipelineDescHash, _pipelineCache.get());
+}
+
+void ForwardRenderPass::enqueue(drawable::Drawable& drawable, igl::IDevice& device, float depth) {
+  IGL_ASSERT_MSG(isActive(), "Drawing not in progress");
+
+  const auto& pipelineState = drawable.pipelineState(
+      device, _renderPipelineDesc, _renderPipelineDescHash, _pipelineCache.get());
+  const material::Material& material = *drawable.material();
+  const uint64_t pipelineId = getSortId(_sortIds, pipelineState.get());
+  const uint64_t materialId = getSortId(_sortIds, &material);
+  const uint64_t sortableDepth = toSortableDepth(depth);
+
+  QueuedDrawable queued;
+  if (material.blendMode == material::BlendMode::Opaque()) {
+    queued.sortKey = (pipelineId << 48) | (materialId << 32) | sortableDepth;
+  } else {
+    queued.sortKey = kTranslucentBit | ((~sortableDepth & 0xFFFFFFFF) << 31) | (pipelineId << 16) |
+                     materialId;
+  }
+  queued.drawable = &drawable;
+  queued.device = &device;
+  _queue.push_back(queued);
+}
+
+void ForwardRenderPass::enqueue(drawable::Drawable& drawable,
+                                igl::IDevice& device,
+                                float depth,
+                                const simdtypes::float4x4& modelMatrix) {
+  enqueue(drawable, device, depth);
+  if (_culler) {
+    _queue.back().worldBounds =
+        culling::transformBounds(drawable.vertexData()->bounds(), modelMatrix);
+  }
+}
+
+void ForwardRenderPass::setCuller(std::shared_ptr<culling::Culler> culler) {
+  _culler = std::move(culler);
+}
+
+void ForwardRenderPass::setClusteredLights(std::shared_ptr<lighting::ClusteredLights> lights) {
+  _lights = std::move(lights);
+}
+
+void ForwardRenderPass::cullQueue() {
+  _cullBounds.clear();
+  _cullBounds.reserve(_queue.size());
+  for (const QueuedDrawable& queued : _queue) {
+    _cullBounds.push_back(queued.worldBounds);
+  }
+  const size_t numVisible = _culler->cull(_cullBounds, _cullVisibility);
+  _numCulledDrawables = _queue.size() - numVisible;
+  if (_numCulledDrawables == 0) {
+    return;
+  }
+
+  size_t numKept = 0;
+  for (size_t i = 0; i != _queue.size(); i++) {
+    if (_cullVisibility[i]) {
+      _queue[numKept++] = _queue[i];
+    }
+  }
+  _queue.resize(numKept);
+}
+
+void ForwardRenderPass::drawQueue() {
+  std::stable_sort(_queue.begin(),
+                   _queue.end(),
+                   [](const QueuedDrawable& a, const QueuedDrawable& b) {
+                     return a.sortKey < b.sortKey;
+                   });
+
+  const igl::IRenderPipelineState* lastPipelineState = nullptr;
+  const material::Material* lastMaterial = nullptr;
+  const vertexdata::VertexData* lastVertexData = nullptr;
+  for (const QueuedDrawable& queued : _queue) {
+    // the pipeline state was created by enqueue(), so this doesn't hash
+    const auto& pipelineState = queued.drawable->pipelineState(
+        *queued.device, _renderPipelineDesc, _renderPipelineDescHash, _pipelineCache.get());
+    auto& material = *queued.drawable->material();
+    auto& vertexData = *queued.drawable->vertexData();
+
+    if (pipelineState.get() != lastPipelineState) {
+      _commandEncoder->bindRenderPipelineState(pipelineState);
+      lastPipelineState = pipelineState.get();
+      lastMaterial = nullptr;
+    }
+    if (&material != lastMaterial) {
+      material.bind(*queued.device, *pipelineState, *_commandEncoder);
+      lastMaterial = &material;
+    }
+    vertexData.draw(*_commandEncoder, &vertexData != lastVertexData);
+    lastVertexData = &vertexData;
+  }
+
+  _queue.clear();
+  _sortIds.clear();
 }
 
 void ForwardRenderPass::end(bool shouldPresent) {
   IGL_ASSERT_MSG(isActive(), "Drawing not in progress");
 
+  _numCulledDrawables = 0;
+  if (!_queue.empty()) {
+    if (_culler) {
+      cullQueue();
+    }
+    drawQueue();
+  }
+
   _commandEncoder->endEncoding();
 
   if (shouldPresent) {
@@ -7,10 +7,15 @@
 
 #pragma once
 
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <IGLU/simple_renderer/ClusteredLights.h>
+#include <IGLU/simple_renderer/Culler.h>
 #include <IGLU/simple_renderer/Drawable.h>
+#include <IGLU/simple_renderer/RenderPipelineCache.h>
 #include <igl/IGL.h>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace iglu {
@@ -30,6 +35,34 @@ class ForwardRenderPass final {
   /// Call once per drawable.
   void draw(drawable::Drawable& drawable, igl::IDevice& device) const;
 
+  /// Alternative to draw(): queues 'drawable' to be drawn by end(). Queued drawables are sorted
+  /// by render pipeline state and material, and redundant binds between them are skipped. Opaque
+  /// drawables are drawn first, front-to-back for early depth rejection, followed by translucent
+  /// drawables back-to-front. 'depth' is the distance of the drawable from the camera.
+  ///
+  /// Drawables and their materials must stay alive and unchanged until end().
+  void enqueue(drawable::Drawable& drawable, igl::IDevice& device, float depth = 0.0f);
+
+  /// Same as above for a drawable placed in the world by 'modelMatrix'. Unlike drawables queued
+  /// without a model matrix, it is culled if its vertex data has bounds and a culler is set.
+  void enqueue(drawable::Drawable& drawable,
+               igl::IDevice& device,
+               float depth,
+               const simdtypes::float4x4& modelMatrix);
+
+  /// Optional. Queued drawables are culled by 'culler' in end() before they are sorted, so the
+  /// culled draws are never encoded.
+  void setCuller(std::shared_ptr<culling::Culler> culler);
+
+  /// Optional. begin() builds the light lists of 'lights' for the lights and camera last set on
+  /// them, before the render pass starts, and binds them for the fragment shaders of all drawables.
+  void setClusteredLights(std::shared_ptr<lighting::ClusteredLights> lights);
+
+  /// Number of queued drawables culled by the last end().
+  size_t getNumCulledDrawables() const {
+    return _numCulledDrawables;
+  }
+
   /// Call after all drawing within this render pass is finished. The 'present'
   /// parameter controls whether to present the target framebuffer and must be set
   /// to true exactly once per frame, when targeting the "onscreen" framebuffer.
@@ -45,7 +78,11 @@ class ForwardRenderPass final {
   bool isActive() const;
   std::shared_ptr<igl::IFramebuffer> activeTarget();
 
-  explicit ForwardRenderPass(igl::IDevice& device);
+  /// Drawables drawn by all render passes sharing 'pipelineCache' share their render pipeline
+  /// states. A render pass creates its own cache if none is provided.
+  explicit ForwardRenderPass(
+      igl::IDevice& device,
+      std::shared_ptr<pipelinecache::RenderPipelineCache> pipelineCache = nullptr);
   ~ForwardRenderPass() = default;
 
  private:
@@ -54,6 +91,30 @@ class ForwardRenderPass final {
   std::shared_ptr<igl::ICommandQueue> _commandQueue;
   std::shared_ptr<igl::IFramebuffer> _framebuffer;
   igl::RenderPipelineDesc _renderPipelineDesc;
+  size_t _renderPipelineDescHash = 0;
+  std::shared_ptr<pipelinecache::RenderPipelineCache> _pipelineCache;
+
+  struct QueuedDrawable {
+    uint64_t sortKey = 0;
+    drawable::Drawable* drawable = nullptr;
+    igl::IDevice* device = nullptr;
+    vertexdata::Bounds worldBounds; // invalid if the drawable is never culled
+  };
+  /// Removes the queued drawables rejected by the culler.
+  void cullQueue();
+  /// Draws all queued drawables in order of their sort keys.
+  void drawQueue();
+
+  std::vector<QueuedDrawable> _queue;
+  // small ids of the pipeline states and materials in the queue, to build the sort keys
+  std::unordered_map<const void*, uint32_t> _sortIds;
+
+  std::shared_ptr<culling::Culler> _culler;
+  std::vector<vertexdata::Bounds> _cullBounds;
+  std::vector<uint8_t> _cullVisibility;
+  size_t _numCulledDrawables = 0;
+
+  std::shared_ptr<lighting::ClusteredLights> _lights;
 
   std::shared_ptr<igl::ICommandBuffer> _commandBuffer;
   std::unique_ptr<igl::IRenderCommandEncoder> _commandEncoder;
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "InstanceBatcher.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace iglu {
+namespace instancing {
+
+namespace {
+std::shared_ptr<igl::IBuffer> createRingBuffer(igl::IDevice& device,
+                                               igl::BufferDesc::BufferType type,
+                                               size_t length) {
+  igl::BufferDesc desc(type, nullptr, length, igl::ResourceStorage::Shared);
+  if (device.hasFeature(igl::DeviceFeatures::BufferRing)) {
+    // one copy per frame in flight, so uploading doesn't wait for the previous frame
+    desc.hint = igl::BufferDesc::BufferAPIHintBits::Ring;
+  }
+  return device.createBuffer(desc, nullptr);
+}
+} // namespace
+
+size_t InstanceBatcher::BatchKeyHash::operator()(const BatchKey& key) const {
+  return std::hash<const void*>()(key.vertexData) ^
+         (std::hash<const void*>()(key.material) << 1);
+}
+
+InstanceBatcher::InstanceBatcher(igl::IDevice& device,
+                                 size_t instanceDataSize,
+                                 size_t instanceBufferIndex,
+                                 size_t initialMaxInstances) :
+  _instanceDataSize(instanceDataSize),
+  _instanceBufferIndex(instanceBufferIndex),
+  _hasIndirectDraws(device.hasFeature(igl::DeviceFeatures::DrawIndexedIndirect)) {
+  IGL_ASSERT(instanceDataSize > 0);
+  IGL_ASSERT_MSG(instanceBufferIndex != 0, "Buffer 0 is used by the vertex data");
+  reserve(device, initialMaxInstances, 16);
+}
+
+void InstanceBatcher::add(const std::shared_ptr<vertexdata::VertexData>& vertexData,
+                          const std::shared_ptr<material::Material>& material,
+                          const void* instanceData) {
+  Batch& batch = _batches[{vertexData.get(), material.get()}];
+  if (batch.instanceData.empty()) {
+    batch.vertexData = vertexData;
+    batch.material = material;
+    _batchOrder.push_back(&batch);
+  }
+  const auto* bytes = static_cast<const uint8_t*>(instanceData);
+  batch.instanceData.insert(batch.instanceData.end(), bytes, bytes + _instanceDataSize);
+}
+
+void InstanceBatcher::draw(igl::IDevice& device,
+                           igl::IRenderCommandEncoder& commandEncoder,
+                           const igl::RenderPipelineDesc& pipelineDesc,
+                           pipelinecache::RenderPipelineCache& pipelineCache) {
+  // batches which were not drawn by the previous frame are released
+  for (auto it = _batches.begin(); it != _batches.end();) {
+    it = it->second.instanceData.empty() ? _batches.erase(it) : std::next(it);
+  }
+  if (_batchOrder.empty()) {
+    return;
+  }
+
+  size_t numInstances = 0;
+  for (const Batch* batch : _batchOrder) {
+    numInstances += batch->instanceData.size() / _instanceDataSize;
+  }
+  reserve(device, numInstances, _batchOrder.size());
+
+  // upload the instance data of all batches with one copy
+  _stagingData.clear();
+  for (const Batch* batch : _batchOrder) {
+    _stagingData.insert(_stagingData.end(), batch->instanceData.begin(), batch->instanceData.end());
+  }
+  _instanceBuffer->upload(_stagingData.data(), {_stagingData.size(), 0});
+
+  if (_hasIndirectDraws) {
+    _stagingData.resize(_batchOrder.size() * vertexdata::VertexData::kIndirectCommandSize);
+    for (size_t i = 0; i != _batchOrder.size(); i++) {
+      const Batch& batch = *_batchOrder[i];
+      batch.vertexData->getIndirectCommand(
+          static_cast<uint32_t>(batch.instanceData.size() / _instanceDataSize),
+          _stagingData.data() + i * vertexdata::VertexData::kIndirectCommandSize);
+    }
+    _indirectBuffer->upload(_stagingData.data(), {_stagingData.size(), 0});
+  }
+
+  const size_t pipelineDescHash = std::hash<igl::RenderPipelineDesc>()(pipelineDesc);
+  const igl::IRenderPipelineState* lastPipelineState = nullptr;
+  size_t instanceOffset = 0;
+  for (size_t i = 0; i != _batchOrder.size(); i++) {
+    Batch& batch = *_batchOrder[i];
+    if (!batch.pipelineState || batch.pipelineDescHash != pipelineDescHash) {
+      igl::RenderPipelineDesc mutablePipelineDesc = pipelineDesc;
+      batch.vertexData->populatePipelineDescriptor(mutablePipelineDesc);
+      batch.material->populatePipelineDescriptor(mutablePipelineDesc);
+      batch.pipelineState = pipelineCache.getRenderPipeline(mutablePipelineDesc);
+      batch.pipelineDescHash = pipelineDescHash;
+    }
+    if (!batch.pipelineState) {
+      continue;
+    }
+    if (batch.pipelineState.get() != lastPipelineState) {
+      commandEncoder.bindRenderPipelineState(batch.pipelineState);
+      lastPipelineState = batch.pipelineState.get();
+    }
+    batch.material->bind(device, *batch.pipelineState, commandEncoder);
+
+    const size_t batchSize = batch.instanceData.size() / _instanceDataSize;
+    if (_hasIndirectDraws) {
+      // offsetting the instance buffer instead of using a base instance works on OpenGL ES too
+      commandEncoder.bindBuffer(_instanceBufferIndex,
+                                igl::BindTarget::kVertex,
+                                _instanceBuffer,
+                                instanceOffset * _instanceDataSize);
+      batch.vertexData->drawIndirect(
+          commandEncoder, *_indirectBuffer, i * vertexdata::VertexData::kIndirectCommandSize);
+    } else {
+      for (size_t instance = 0; instance != batchSize; instance++) {
+        commandEncoder.bindBuffer(_instanceBufferIndex,
+                                  igl::BindTarget::kVertex,
+                                  _instanceBuffer,
+                                  (instanceOffset + instance) * _instanceDataSize);
+        batch.vertexData->draw(commandEncoder, instance == 0);
+      }
+    }
+    instanceOffset += batchSize;
+    batch.instanceData.clear();
+  }
+  _batchOrder.clear();
+}
+
+void InstanceBatcher::reserve(igl::IDevice& device, size_t numInstances, size_t numBatches) {
+  if (numInstances > _maxInstances) {
+    _maxInstances = std::max(numInstances, 2 * _maxInstances);
+    _instanceBuffer = createRingBuffer(
+        device, igl::BufferDesc::BufferTypeBits::Vertex, _maxInstances * _instanceDataSize);
+  }
+  if (_hasIndirectDraws && numBatches > _maxBatches) {
+    _maxBatches = std::max(numBatches, 2 * _maxBatches);
+    _indirectBuffer =
+        createRingBuffer(device,
+                         igl::BufferDesc::BufferTypeBits::Indirect,
+                         _maxBatches * vertexdata::VertexData::kIndirectCommandSize);
+  }
+}
+
+} // namespace instancing
+} // namespace iglu
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simple_renderer/Material.h>
+#include <IGLU/simple_renderer/RenderPipelineCache.h>
+#include <IGLU/simple_renderer/VertexData.h>
+#include <igl/IGL.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace iglu {
+namespace instancing {
+
+/// Draws many instances of the same vertex data and material with a single draw call.
+///
+/// Instances added between two draw() calls are grouped by vertex data and material. The
+/// per-instance data (e.g. a model matrix followed by custom uniforms) of all instances is packed
+/// into one ring buffer, bound at 'instanceBufferIndex' at the offset of each batch. The vertex
+/// input state of the vertex data describes the per-instance attributes with
+/// igl::VertexSampleFunction::Instance and a stride of 'instanceDataSize', so the shader reads
+/// them like vertex attributes.
+///
+/// The draws are issued as indirect draws with an instance count; devices without
+/// igl::DeviceFeatures::DrawIndexedIndirect draw instances one by one instead.
+class InstanceBatcher final {
+ public:
+  InstanceBatcher(igl::IDevice& device,
+                  size_t instanceDataSize,
+                  size_t instanceBufferIndex,
+                  size_t initialMaxInstances = 256);
+  ~InstanceBatcher() = default;
+
+  /// Queues one instance. 'instanceData' points to 'instanceDataSize' bytes and is copied.
+  void add(const std::shared_ptr<vertexdata::VertexData>& vertexData,
+           const std::shared_ptr<material::Material>& material,
+           const void* instanceData);
+
+  /// Draws all queued instances with one draw per batch and empties the queue. 'pipelineDesc' is
+  /// expected to be populated with the framebuffer information, as for drawable::Drawable.
+  /// Call at most once per frame: the instance data of a frame is not copied by the GPU and
+  /// another draw() in the same frame would overwrite it.
+  void draw(igl::IDevice& device,
+            igl::IRenderCommandEncoder& commandEncoder,
+            const igl::RenderPipelineDesc& pipelineDesc,
+            pipelinecache::RenderPipelineCache& pipelineCache);
+
+  /// Number of batches queued since the last draw().
+  size_t numBatches() const {
+    return _batchOrder.size();
+  }
+
+ private:
+  struct BatchKey {
+    const vertexdata::VertexData* vertexData;
+    const material::Material* material;
+    bool operator==(const BatchKey& other) const {
+      return vertexData == other.vertexData && material == other.material;
+    }
+  };
+  struct BatchKeyHash {
+    size_t operator()(const BatchKey& key) const;
+  };
+  struct Batch {
+    std::shared_ptr<vertexdata::VertexData> vertexData;
+    std::shared_ptr<material::Material> material;
+    std::vector<uint8_t> instanceData;
+    // kept across frames while the batch is drawn every frame
+    std::shared_ptr<igl::IRenderPipelineState> pipelineState;
+    size_t pipelineDescHash = 0;
+  };
+
+  void reserve(igl::IDevice& device, size_t numInstances, size_t numBatches);
+
+  const size_t _instanceDataSize;
+  const size_t _instanceBufferIndex;
+  const bool _hasIndirectDraws;
+
+  std::unordered_map<BatchKey, Batch, BatchKeyHash> _batches;
+  std::vector<Batch*> _batchOrder; // batches with instances, in order of their first instance
+  std::vector<uint8_t> _stagingData;
+
+  std::shared_ptr<igl::IBuffer> _instanceBuffer;
+  std::shared_ptr<igl::IBuffer> _indirectBuffer;
+  size_t _maxInstances = 0;
+  size_t _maxBatches = 0;
+};
+
+} // namespace instancing
+} // namespace iglu
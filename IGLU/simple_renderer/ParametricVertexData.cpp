@@ -74,6 +74,11 @@ std::shared_ptr<VertexData> create(igl::IDevice& device,
                                    device.createBuffer(ibDesc, nullptr),
                                    igl::IndexFormat::UInt16,
                                    primitiveDesc);
+  Bounds bounds;
+  for (const VertexPosUv& vertex : vertexData) {
+    bounds.extend(reinterpret_cast<const float*>(&vertex.position));
+  }
+  vertData->setBounds(bounds);
   return vertData;
 }
 
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "RenderPipelineCache.h"
+
+namespace iglu {
+namespace pipelinecache {
+
+std::shared_ptr<igl::IRenderPipelineState> RenderPipelineCache::getRenderPipeline(
+    const igl::RenderPipelineDesc& desc,
+    igl::Result* outResult) {
+  const std::lock_guard<std::mutex> lock(_mutex);
+
+  auto it = _pipelines.find(desc);
+  if (it != _pipelines.end()) {
+    igl::Result::setOk(outResult);
+    return it->second;
+  }
+
+  auto pipelineState = _device.createRenderPipeline(desc, outResult);
+  if (pipelineState) {
+    _pipelines.emplace(desc, pipelineState);
+  }
+  return pipelineState;
+}
+
+size_t RenderPipelineCache::size() const {
+  const std::lock_guard<std::mutex> lock(_mutex);
+  return _pipelines.size();
+}
+
+void RenderPipelineCache::clear() {
+  const std::lock_guard<std::mutex> lock(_mutex);
+  _pipelines.clear();
+}
+
+} // namespace pipelinecache
+} // namespace iglu
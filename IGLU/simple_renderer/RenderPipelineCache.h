@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/IGL.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace iglu {
+namespace pipelinecache {
+
+/// Shares render pipeline states between all users of a device which request pipelines with the
+/// same descriptor, e.g. all drawables using the same materials and vertex layout.
+///
+/// Lookups hash the full descriptor, so callers are expected to keep the returned pipeline state
+/// and only look up again when their descriptor changes. Pipeline states are kept alive by the
+/// cache until clear() is called.
+class RenderPipelineCache final {
+ public:
+  explicit RenderPipelineCache(igl::IDevice& device) : _device(device) {}
+  ~RenderPipelineCache() = default;
+
+  /// Returns the pipeline state for 'desc', creating it on first use.
+  std::shared_ptr<igl::IRenderPipelineState> getRenderPipeline(const igl::RenderPipelineDesc& desc,
+                                                               igl::Result* outResult = nullptr);
+
+  /// Number of distinct pipeline states in the cache.
+  size_t size() const;
+
+  /// Releases all cached pipeline states; pipeline states in use stay valid.
+  void clear();
+
+ private:
+  igl::IDevice& _device;
+
+  mutable std::mutex _mutex;
+  std::unordered_map<igl::RenderPipelineDesc, std::shared_ptr<igl::IRenderPipelineState>>
+      _pipelines;
+};
+
+} // namespace pipelinecache
+} // namespace iglu
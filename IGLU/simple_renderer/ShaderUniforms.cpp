@@ -7,6 +7,8 @@
 
 #include "ShaderUniforms.h"
 
+#include "ClusteredLights.h"
+
 #include <igl/Buffer.h>
 #include <igl/Device.h>
 #include <igl/Log.h>
@@ -24,6 +26,7 @@
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -32,6 +35,11 @@ namespace {
 // For example, on the Quest 2 GPU, maxUniformBufferSize is 64k, so we are using it all.
 constexpr size_t MAX_SUBALLOCATED_BUFFER_SIZE_BYTES = 65536;
 
+// keeps every uniform buffer in the shadow data 16-byte aligned, as needed by vector types
+size_t alignShadowDataSize(size_t size) {
+  return (size + 15) & ~size_t(15);
+}
+
 uint8_t bindTargetForShaderStage(igl::ShaderStage stage) {
   switch (stage) {
   case igl::ShaderStage::Vertex:
@@ -62,20 +70,38 @@ ShaderUniforms::ShaderUniforms(igl::IDevice& device,
   device.getFeatureLimits(igl::DeviceFeatureLimits::MaxUniformBufferBytes, uniformBufferLimit);
 
   const bool isSuballocated = device_.getBackendType() == igl::BackendType::Vulkan;
+  auto getAllocationLength = [&](const igl::BufferArgDesc& iglDesc) {
+    return std::min(
+        isSuballocated ? MAX_SUBALLOCATED_BUFFER_SIZE_BYTES : iglDesc.bufferDataSize,
+        uniformBufferLimit != 0 ? uniformBufferLimit : std::numeric_limits<size_t>::max());
+  };
+
+  // All uniform updates will be made to one contiguous data block, which will later be uploaded
+  // to the buffers (if using buffers)
+  size_t shadowDataSize = 0;
+  for (const igl::BufferArgDesc& iglDesc : reflection.allUniformBuffers()) {
+    shadowDataSize += alignShadowDataSize(getAllocationLength(iglDesc));
+  }
+  _shadowData = std::make_unique<uint8_t[]>(shadowDataSize);
+  size_t shadowDataOffset = 0;
+
   for (const igl::BufferArgDesc& iglDesc : reflection.allUniformBuffers()) {
     size_t length = iglDesc.bufferDataSize;
     IGL_ASSERT_MSG(length > 0, "unexpected buffer with size 0");
     IGL_ASSERT_MSG(length <= MAX_SUBALLOCATED_BUFFER_SIZE_BYTES &&
                        (uniformBufferLimit == 0 || length <= uniformBufferLimit),
                    "buffer size exceeds limits");
-    const size_t bufferAllocationLength =
-        std::min(isSuballocated ? MAX_SUBALLOCATED_BUFFER_SIZE_BYTES : length,
-                 uniformBufferLimit != 0 ? uniformBufferLimit : std::numeric_limits<size_t>::max());
+    const size_t bufferAllocationLength = getAllocationLength(iglDesc);
     const std::string vertexBufferPrefix = "vertexBuffer.";
     if (device.getBackendType() == igl::BackendType::Metal &&
         iglDesc.name.toString().substr(0, vertexBufferPrefix.length()) == vertexBufferPrefix) {
       continue;
     }
+    // the light lists are bound by lighting::ClusteredLights for all materials
+    if (device.getBackendType() == igl::BackendType::Metal &&
+        lighting::isClusteredLightsBuffer(iglDesc.name.toString())) {
+      continue;
+    }
 
     bool createBuffer = false;
     if (device_.getBackendType() == igl::BackendType::OpenGL) {
@@ -105,12 +131,8 @@ ShaderUniforms::ShaderUniforms(igl::IDevice& device,
       buffer = nullptr;
     }
 
-    // All uniform updates will be made to this malloc'ed data block,
-    // which will later be uploaded to the buffer (if using buffer)
-    void* data = malloc(bufferAllocationLength);
-    if (data == nullptr) {
-      continue;
-    }
+    void* data = _shadowData.get() + shadowDataOffset;
+    shadowDataOffset += alignShadowDataSize(bufferAllocationLength);
     auto allocation = std::make_shared<BufferAllocation>(data, bufferAllocationLength, buffer);
     _allocations.push_back(allocation);
 
@@ -135,19 +157,17 @@ ShaderUniforms::ShaderUniforms(igl::IDevice& device,
   }
 
   for (const igl::TextureArgDesc& iglDesc : reflection.allTextures()) {
-    IGL_ASSERT_MSG(_allTexturesByName.find(iglDesc.name) == _allTexturesByName.end(),
+    IGL_ASSERT_MSG(_textureIndices.find(iglDesc.name) == _textureIndices.end(),
                    "Texture names must be unique across all shader stages: %s",
                    iglDesc.name.c_str());
+    _textureIndices[iglDesc.name] = static_cast<uint32_t>(_textureDescs.size());
     _textureDescs.push_back(iglDesc);
-    _allTexturesByName[iglDesc.name] = TextureSlot{nullptr, nullptr};
   }
+  _textureSlots.resize(_textureDescs.size());
+  _samplerSlots.resize(_textureDescs.size());
 }
 
-ShaderUniforms::~ShaderUniforms() {
-  for (auto& allocation : _allocations) {
-    free(allocation->ptr);
-  }
-}
+ShaderUniforms::~ShaderUniforms() = default;
 
 namespace {
 size_t getUniformExpectedSize(igl::UniformType uniformType, igl::BackendType backend) {
@@ -234,6 +254,21 @@ void ShaderUniforms::setUniformBytes(const UniformDesc& uniformDesc,
                                      size_t elementSize,
                                      size_t count,
                                      size_t arrayIndex) {
+  auto strongBuffer = uniformDesc.buffer.lock();
+  if (!strongBuffer) {
+    IGL_LOG_ERROR_ONCE("[IGL][Error] null uniform buffer %s!\n",
+                       uniformDesc.iglMemberDesc.name.toConstChar());
+    return;
+  }
+  setUniformBytes(*strongBuffer, uniformDesc, data, elementSize, count, arrayIndex);
+}
+
+void ShaderUniforms::setUniformBytes(BufferDesc& buffer,
+                                     const UniformDesc& uniformDesc,
+                                     const void* data,
+                                     size_t elementSize,
+                                     size_t count,
+                                     size_t arrayIndex) {
   if (device_.getBackendType() != igl::BackendType::Vulkan) {
     auto expectedSize =
         getUniformExpectedSize(uniformDesc.iglMemberDesc.type, device_.getBackendType());
@@ -253,22 +288,15 @@ void ShaderUniforms::setUniformBytes(const UniformDesc& uniformDesc,
                        uniformDesc.iglMemberDesc.arrayLength);
     return;
   }
-  auto strongBuffer = uniformDesc.buffer.lock();
-  if (!strongBuffer) {
-    IGL_LOG_ERROR_ONCE("[IGL][Error] null uniform buffer %s!\n",
-                       uniformDesc.iglMemberDesc.name.toConstChar());
-    return;
-  }
-
   uintptr_t subAllocatedOffset = 0;
-  if (strongBuffer->isSuballocated && strongBuffer->currentAllocation >= 0) {
-    subAllocatedOffset = strongBuffer->currentAllocation * strongBuffer->suballocationsSize;
+  if (buffer.isSuballocated && buffer.currentAllocation >= 0) {
+    subAllocatedOffset = buffer.currentAllocation * buffer.suballocationsSize;
   }
   uintptr_t offset =
       uniformDesc.iglMemberDesc.offset + elementSize * arrayIndex + subAllocatedOffset;
 
-  auto err = try_checked_memcpy((uint8_t*)strongBuffer->allocation->ptr + offset, // destination
-                                strongBuffer->allocation->size - offset, // max destination size
+  auto err = try_checked_memcpy((uint8_t*)buffer.allocation->ptr + offset, // destination
+                                buffer.allocation->size - offset, // max destination size
                                 data, // source
                                 elementSize * count // num bytes to copy
   );
@@ -453,17 +481,9 @@ void ShaderUniforms::setFloat3Array(const igl::NameHandle& uniformName,
   } else {
     // simdtypes::float3 is padded to have an extra float.
     // Remove it so we can send the packed version to OpenGL/Vulkan
-    auto* packedArray = new float[3 * count];
-    float* packedArrayPtr = packedArray;
-    auto paddedArrayPtr = reinterpret_cast<const float*>(value);
-    for (size_t i = 0; i < count; i++) {
-      for (int j = 0; j < 3; j++) {
-        *packedArrayPtr++ = *paddedArrayPtr++;
-      }
-      paddedArrayPtr++; // padded float
-    }
-    setUniformBytes(uniformName, packedArray, sizeof(float) * 3 * count, 1, arrayIndex);
-    delete[] packedArray;
+    auto packedArray = std::vector<float>(3 * count);
+    igl::packVec3Array(packedArray.data(), value, count);
+    setUniformBytes(uniformName, packedArray.data(), sizeof(float) * 3 * count, 1, arrayIndex);
   }
 }
 
@@ -561,14 +581,7 @@ void ShaderUniforms::setFloat3x3(const igl::NameHandle& uniformName,
     // simdtypes::float3x3 has an extra float per float-vector.
     // Remove it so we can send the packed version to OpenGL
     float packedMatrix[9] = {0.0f};
-    auto paddedMatrixPtr = reinterpret_cast<const float*>(&value);
-    float* packedMatrixPtr = packedMatrix;
-    for (int i = 0; i < 3; i++) {
-      for (int j = 0; j < 3; j++) {
-        *packedMatrixPtr++ = *paddedMatrixPtr++;
-      }
-      paddedMatrixPtr++; // padded float
-    }
+    igl::packVec3Array(packedMatrix, &value, 3);
     setUniformBytes(uniformName, &packedMatrix, sizeof(packedMatrix), 1, arrayIndex);
   }
 }
@@ -583,19 +596,9 @@ void ShaderUniforms::setFloat3x3Array(const igl::NameHandle& uniformName,
   } else {
     // simdtypes::float3x3 has an extra float per float-vector.
     // Remove it so we can send the packed version to OpenGL
-    auto paddedMatrixPtr = reinterpret_cast<const float*>(value);
-    auto packedMatrix = new float[9 * count];
-    auto packedMatrixPtr = packedMatrix;
-    for (int n = 0; n < count; n++) {
-      for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-          *packedMatrixPtr++ = *paddedMatrixPtr++;
-        }
-        paddedMatrixPtr++; // skip over padded float
-      }
-    }
-    setUniformBytes(uniformName, packedMatrix, sizeof(float) * 9, count, arrayIndex);
-    delete[] packedMatrix;
+    auto packedMatrix = std::vector<float>(9 * count);
+    igl::packVec3Array(packedMatrix.data(), value, 3 * count);
+    setUniformBytes(uniformName, packedMatrix.data(), sizeof(float) * 9, count, arrayIndex);
   }
 }
 
@@ -688,47 +691,284 @@ void ShaderUniforms::setTexture(const std::string& name,
                                 const std::shared_ptr<igl::ISamplerState>& sampler,
                                 IGL_MAYBE_UNUSED size_t arrayIndex) {
   IGL_ASSERT_MSG(arrayIndex == 0, "texture arrays not supported");
-  auto it = _allTexturesByName.find(name);
-  if (it == _allTexturesByName.end()) {
+  const TextureHandle handle = getTextureHandle(name);
+  if (!handle.isValid()) {
     IGL_LOG_ERROR_ONCE("[IGL][Error] Invalid texture name: %s\n", name.c_str());
     return;
   }
-  _allTexturesByName[name] = TextureSlot{value, value.get()};
-  _allSamplersByName[name] = SamplerSlot{sampler, sampler.get()};
+  setTexture(handle, value, sampler);
 }
 
 void ShaderUniforms::setTexture(const std::string& name,
                                 igl::ITexture* value,
                                 const std::shared_ptr<igl::ISamplerState>& sampler) {
-  auto it = _allTexturesByName.find(name);
-  if (it == _allTexturesByName.end()) {
+  const TextureHandle handle = getTextureHandle(name);
+  if (!handle.isValid()) {
     IGL_LOG_ERROR_ONCE("[IGL][Error] Invalid texture name: %s\n", name.c_str());
     return;
   }
-  _allTexturesByName[name] = TextureSlot{nullptr, value}; // non-owning
-  _allSamplersByName[name] = SamplerSlot{sampler, sampler.get()}; // owning
+  _textureSlots[handle.index] = TextureSlot{nullptr, value}; // non-owning
+  _samplerSlots[handle.index] = SamplerSlot{sampler, sampler.get()}; // owning
+  onTexturesChanged();
 }
 
 void ShaderUniforms::setTexture(const std::string& name,
                                 igl::ITexture* value,
                                 igl::ISamplerState* sampler) {
-  auto it = _allTexturesByName.find(name);
-  if (it == _allTexturesByName.end()) {
+  const TextureHandle handle = getTextureHandle(name);
+  if (!handle.isValid()) {
     IGL_LOG_ERROR_ONCE("[IGL][Error] Invalid texture name: %s\n", name.c_str());
     return;
   }
-  _allTexturesByName[name] = TextureSlot{nullptr, value}; // non-owning
-  _allSamplersByName[name] = SamplerSlot{nullptr, sampler}; // non-owning
+  setTexture(handle, value, sampler);
+}
+
+void ShaderUniforms::setUniformBlock(const igl::NameHandle& bufferName,
+                                     const void* data,
+                                     size_t length) {
+  auto range = _bufferDescs.equal_range(bufferName);
+  if (range.first == range.second) {
+    IGL_LOG_ERROR_ONCE("[IGL][Error] Invalid uniform buffer name: %s\n", bufferName.toConstChar());
+    return;
+  }
+  for (auto it = range.first; it != range.second; ++it) {
+    BufferDesc& buffer = *it->second;
+    if (length > buffer.iglBufferDesc.bufferDataSize) {
+      IGL_LOG_ERROR_ONCE("[IGL][Error] Uniform buffer %s size mismatch: expected %zu got %zu\n",
+                         bufferName.toConstChar(),
+                         buffer.iglBufferDesc.bufferDataSize,
+                         length);
+      continue;
+    }
+    uintptr_t offset = 0;
+    if (buffer.isSuballocated && buffer.currentAllocation >= 0) {
+      offset = buffer.currentAllocation * buffer.suballocationsSize;
+    }
+    auto err = try_checked_memcpy((uint8_t*)buffer.allocation->ptr + offset, // destination
+                                  buffer.allocation->size - offset, // max destination size
+                                  data, // source
+                                  length // num bytes to copy
+    );
+    if (err != 0) {
+      IGL_LOG_ERROR_ONCE("[IGL][Error] Failed to update uniform buffer\n");
+    }
+  }
+}
+
+ShaderUniforms::UniformHandle ShaderUniforms::addUniformHandle(
+    const igl::NameHandle& key,
+    const std::vector<ResolvedUniform>& uniforms) {
+  if (uniforms.empty()) {
+    return {};
+  }
+  const UniformHandle handle{static_cast<uint32_t>(_uniformHandles.size())};
+  _uniformHandles.push_back({static_cast<uint32_t>(_resolvedUniforms.size()),
+                             static_cast<uint32_t>(uniforms.size())});
+  _resolvedUniforms.insert(_resolvedUniforms.end(), uniforms.begin(), uniforms.end());
+  _uniformHandlesByName[key] = handle;
+  return handle;
+}
+
+ShaderUniforms::UniformHandle ShaderUniforms::getUniformHandle(
+    const igl::NameHandle& uniformName) {
+  auto handleIt = _uniformHandlesByName.find(uniformName);
+  if (handleIt != _uniformHandlesByName.end()) {
+    return handleIt->second;
+  }
+
+  std::vector<ResolvedUniform> uniforms;
+  auto range = _allUniformsByName.equal_range(uniformName);
+  for (auto it = range.first; it != range.second; ++it) {
+    // buffer descs are owned by _bufferDescs for the lifetime of this object
+    if (auto strongBuffer = it->second.buffer.lock()) {
+      uniforms.push_back({strongBuffer.get(), &it->second});
+    }
+  }
+  return addUniformHandle(uniformName, uniforms);
+}
+
+ShaderUniforms::UniformHandle ShaderUniforms::getUniformHandle(
+    const igl::NameHandle& blockTypeName,
+    const igl::NameHandle& blockInstanceName,
+    const igl::NameHandle& memberName) {
+  // block members are cached apart from individual uniforms with the same qualified name
+  const igl::NameHandle key = igl::genNameHandle(
+      blockTypeName.toString() + ":" +
+      getQualifiedMemberName(blockTypeName, blockInstanceName, memberName).toString());
+  auto handleIt = _uniformHandlesByName.find(key);
+  if (handleIt != _uniformHandlesByName.end()) {
+    return handleIt->second;
+  }
+
+  std::vector<ResolvedUniform> uniforms;
+  const auto bufferName = getBufferName(blockTypeName, blockInstanceName, memberName);
+  const auto bufferMemberName = getBufferMemberName(blockTypeName, blockInstanceName, memberName);
+  auto range = _bufferDescs.equal_range(bufferName);
+  for (auto it = range.first; it != range.second; ++it) {
+    BufferDesc& bufferDesc = *it->second;
+    auto memberIndexIt = bufferDesc.memberIndices.find(bufferMemberName);
+    if (memberIndexIt != bufferDesc.memberIndices.end()) {
+      uniforms.push_back({&bufferDesc, &bufferDesc.uniforms[memberIndexIt->second]});
+    }
+  }
+  return addUniformHandle(key, uniforms);
+}
+
+ShaderUniforms::TextureHandle ShaderUniforms::getTextureHandle(const std::string& name) const {
+  auto it = _textureIndices.find(name);
+  return it != _textureIndices.end() ? TextureHandle{it->second} : TextureHandle{};
+}
+
+void ShaderUniforms::setUniformBytes(UniformHandle handle,
+                                     const void* data,
+                                     size_t elementSize,
+                                     size_t count,
+                                     size_t arrayIndex) {
+  if (!IGL_VERIFY(handle.index < _uniformHandles.size())) {
+    return;
+  }
+  const ResolvedUniformRange& range = _uniformHandles[handle.index];
+  for (uint32_t i = range.first; i != range.first + range.count; i++) {
+    const ResolvedUniform& resolved = _resolvedUniforms[i];
+    setUniformBytes(*resolved.buffer, *resolved.uniform, data, elementSize, count, arrayIndex);
+  }
+}
+
+void ShaderUniforms::setBool(UniformHandle handle, const bool& value, size_t arrayIndex) {
+  setUniformBytes(handle, &value, sizeof(bool), 1, arrayIndex);
+}
+
+void ShaderUniforms::setFloat(UniformHandle handle,
+                              const iglu::simdtypes::float1& value,
+                              size_t arrayIndex) {
+  setUniformBytes(handle, &value, sizeof(iglu::simdtypes::float1), 1, arrayIndex);
+}
+
+void ShaderUniforms::setFloat2(UniformHandle handle,
+                               const iglu::simdtypes::float2& value,
+                               size_t arrayIndex) {
+  setUniformBytes(handle, &value, sizeof(iglu::simdtypes::float2), 1, arrayIndex);
+}
+
+void ShaderUniforms::setFloat3(UniformHandle handle,
+                               const iglu::simdtypes::float3& value,
+                               size_t arrayIndex) {
+  size_t length = device_.getBackendType() == igl::BackendType::Metal
+                      ? sizeof(iglu::simdtypes::float3)
+                      : sizeof(float[3]);
+  setUniformBytes(handle, &value, length, 1, arrayIndex);
+}
+
+void ShaderUniforms::setFloat4(UniformHandle handle,
+                               const iglu::simdtypes::float4& value,
+                               size_t arrayIndex) {
+  setUniformBytes(handle, &value, sizeof(iglu::simdtypes::float4), 1, arrayIndex);
+}
+
+void ShaderUniforms::setFloat4Array(UniformHandle handle,
+                                    const iglu::simdtypes::float4* value,
+                                    size_t count,
+                                    size_t arrayIndex) {
+  setUniformBytes(handle, value, sizeof(iglu::simdtypes::float4), count, arrayIndex);
+}
+
+void ShaderUniforms::setFloat2x2(UniformHandle handle,
+                                 const iglu::simdtypes::float2x2& value,
+                                 size_t arrayIndex) {
+  setUniformBytes(handle, &value, sizeof(iglu::simdtypes::float2x2), 1, arrayIndex);
+}
+
+void ShaderUniforms::setFloat3x3(UniformHandle handle,
+                                 const iglu::simdtypes::float3x3& value,
+                                 size_t arrayIndex) {
+  if (device_.getBackendType() == igl::BackendType::Metal ||
+      device_.getBackendType() == igl::BackendType::Vulkan) {
+    setUniformBytes(handle, &value, sizeof(iglu::simdtypes::float3x3), 1, arrayIndex);
+  } else {
+    // simdtypes::float3x3 has an extra float per float-vector.
+    // Remove it so we can send the packed version to OpenGL
+    float packedMatrix[9] = {0.0f};
+    igl::packVec3Array(packedMatrix, &value, 3);
+    setUniformBytes(handle, &packedMatrix, sizeof(packedMatrix), 1, arrayIndex);
+  }
+}
+
+void ShaderUniforms::setFloat4x4(UniformHandle handle,
+                                 const iglu::simdtypes::float4x4& value,
+                                 size_t arrayIndex) {
+  setUniformBytes(handle, &value, sizeof(iglu::simdtypes::float4x4), 1, arrayIndex);
+}
+
+void ShaderUniforms::setFloat4x4Array(UniformHandle handle,
+                                      const iglu::simdtypes::float4x4* value,
+                                      size_t count,
+                                      size_t arrayIndex) {
+  setUniformBytes(handle, value, sizeof(iglu::simdtypes::float4x4), count, arrayIndex);
+}
+
+void ShaderUniforms::setInt(UniformHandle handle,
+                            const iglu::simdtypes::int1& value,
+                            size_t arrayIndex) {
+  setUniformBytes(handle, &value, sizeof(iglu::simdtypes::int1), 1, arrayIndex);
+}
+
+void ShaderUniforms::setTexture(TextureHandle handle,
+                                const std::shared_ptr<igl::ITexture>& value,
+                                const std::shared_ptr<igl::ISamplerState>& sampler) {
+  if (!IGL_VERIFY(handle.index < _textureSlots.size())) {
+    return;
+  }
+  if (_textureSlots[handle.index].texture == value &&
+      _samplerSlots[handle.index].sampler == sampler) {
+    return;
+  }
+  _textureSlots[handle.index] = TextureSlot{value, value.get()};
+  _samplerSlots[handle.index] = SamplerSlot{sampler, sampler.get()};
+  onTexturesChanged();
+}
+
+void ShaderUniforms::setTexture(TextureHandle handle,
+                                igl::ITexture* value,
+                                igl::ISamplerState* sampler) {
+  if (!IGL_VERIFY(handle.index < _textureSlots.size())) {
+    return;
+  }
+  _textureSlots[handle.index] = TextureSlot{nullptr, value}; // non-owning
+  _samplerSlots[handle.index] = SamplerSlot{nullptr, sampler}; // non-owning
+  onTexturesChanged();
+}
+
+void ShaderUniforms::onTexturesChanged() {
+  _textureBindGroup = nullptr;
+  _numBindsWithSameTextures = 0;
+}
+
+std::shared_ptr<igl::IBindGroup> ShaderUniforms::createTextureBindGroup(
+    igl::IDevice& device) const {
+  igl::BindGroupDesc desc;
+  desc.target = 0;
+  for (size_t i = 0; i != _textureDescs.size(); i++) {
+    const size_t index = _textureDescs[i].textureIndex;
+    // non-owning slots cannot be retained by a bind group
+    if (index >= igl::IGL_TEXTURE_SAMPLERS_MAX || desc.textures[index] ||
+        !_textureSlots[i].texture || !_samplerSlots[i].sampler) {
+      return nullptr;
+    }
+    desc.textures[index] = _textureSlots[i].texture;
+    desc.samplers[index] = _samplerSlots[i].sampler;
+    desc.target |= bindTargetForShaderStage(_textureDescs[i].shaderStage);
+  }
+  return device.createBindGroup(desc, nullptr);
 }
 
 #if IGL_BACKEND_OPENGL
 void ShaderUniforms::bindUniformOpenGL(const igl::NameHandle& uniformName,
+                                       int location,
                                        const UniformDesc& uniformDesc,
-                                       const igl::IRenderPipelineState& pipelineState,
                                        igl::IRenderCommandEncoder& encoder) {
   const igl::BufferArgDesc::BufferMemberDesc& iglMemberDesc = uniformDesc.iglMemberDesc;
   igl::UniformDesc desc;
-  desc.location = pipelineState.getIndexByName(uniformName, igl::ShaderStage::Fragment);
+  desc.location = location;
   desc.type = iglMemberDesc.type;
   desc.offset = iglMemberDesc.offset;
   desc.numElements = iglMemberDesc.arrayLength;
@@ -757,13 +997,21 @@ void ShaderUniforms::bindBuffer(igl::IDevice& device,
   if (device.getBackendType() == igl::BackendType::OpenGL) {
 #if IGL_BACKEND_OPENGL
     const auto& uniformName = buffer->iglBufferDesc.name;
+    const auto& glPipelineState =
+        static_cast<const igl::opengl::RenderPipelineState&>(pipelineState);
+    if (buffer->glPipelineId != glPipelineState.getUniqueId()) {
+      // resolve the name once per pipeline instead of once per draw
+      buffer->glPipelineId = glPipelineState.getUniqueId();
+      buffer->glIndex =
+          buffer->iglBufferDesc.isUniformBlock
+              ? glPipelineState.getUniformBlockBindingPoint(uniformName)
+              : glPipelineState.getIndexByName(uniformName, igl::ShaderStage::Fragment);
+    }
     if (buffer->iglBufferDesc.isUniformBlock) {
       IGL_ASSERT(buffer->allocation->iglBuffer != nullptr);
       buffer->allocation->iglBuffer->upload(buffer->allocation->ptr,
                                             igl::BufferRange(buffer->allocation->size, 0));
-      const auto& glPipelineState =
-          static_cast<const igl::opengl::RenderPipelineState&>(pipelineState);
-      encoder.bindBuffer(glPipelineState.getUniformBlockBindingPoint(uniformName),
+      encoder.bindBuffer(buffer->glIndex,
                          bindTargetForShaderStage(buffer->iglBufferDesc.shaderStage),
                          buffer->allocation->iglBuffer,
                          0);
@@ -774,7 +1022,7 @@ void ShaderUniforms::bindBuffer(igl::IDevice& device,
       IGL_ASSERT(buffer->iglBufferDesc.name == buffer->uniforms[0].iglMemberDesc.name);
       auto& uniformDesc = buffer->uniforms[0];
 
-      bindUniformOpenGL(uniformName, uniformDesc, pipelineState, encoder);
+      bindUniformOpenGL(uniformName, buffer->glIndex, uniformDesc, encoder);
     }
 #endif
   } else {
@@ -831,24 +1079,34 @@ void ShaderUniforms::bind(igl::IDevice& device,
     bindBuffer(device, pipelineState, encoder, bufferDesc.get());
   }
 
-  for (auto& _textureDesc : _textureDescs) {
-    auto textureIt = _allTexturesByName.find(_textureDesc.name);
-    auto samplerIt = _allSamplersByName.find(_textureDesc.name);
-    if (textureIt == _allTexturesByName.end() || samplerIt == _allSamplersByName.end()) {
+  // textures which did not change since the previous bind are bound with one bind group
+  if (!_textureBindGroup && !_textureDescs.empty() && ++_numBindsWithSameTextures == 2) {
+    _textureBindGroup = createTextureBindGroup(device);
+  }
+  if (_textureBindGroup) {
+    encoder.bindBindGroup(*_textureBindGroup);
+    return;
+  }
+
+  for (size_t i = 0; i != _textureDescs.size(); i++) {
+    const igl::TextureArgDesc& textureDesc = _textureDescs[i];
+    const TextureSlot& textureSlot = _textureSlots[i];
+    const SamplerSlot& samplerSlot = _samplerSlots[i];
+    igl::ISamplerState* sampler = samplerSlot.rawSampler ? samplerSlot.rawSampler
+                                                         : samplerSlot.sampler.get();
+    if (!sampler) {
       IGL_LOG_ERROR_ONCE("[IGL][Warning] No texture set for sampler: %s\n",
-                         _textureDesc.name.c_str());
+                         textureDesc.name.c_str());
       continue;
     }
-    encoder.bindTexture(_textureDesc.textureIndex,
-                        bindTargetForShaderStage(_textureDesc.shaderStage),
-                        textureIt->second.rawTexture ? textureIt->second.rawTexture
-                                                     : textureIt->second.texture.get());
+    encoder.bindTexture(textureDesc.textureIndex,
+                        bindTargetForShaderStage(textureDesc.shaderStage),
+                        textureSlot.rawTexture ? textureSlot.rawTexture
+                                               : textureSlot.texture.get());
 
     // Assumption: each texture has an associated sampler at the same index in Metal
-    encoder.bindSamplerState(_textureDesc.textureIndex,
-                             bindTargetForShaderStage(_textureDesc.shaderStage),
-                             samplerIt->second.rawSampler ? samplerIt->second.rawSampler
-                                                          : samplerIt->second.sampler.get());
+    encoder.bindSamplerState(
+        textureDesc.textureIndex, bindTargetForShaderStage(textureDesc.shaderStage), sampler);
   }
 }
 
@@ -24,6 +24,70 @@ namespace material {
 /// information to generate the underlying data and provides a simple API to manipulate it.
 class ShaderUniforms final {
  public:
+  /// A uniform resolved by getUniformHandle(). Updating a uniform through its handle needs no
+  /// lookups or allocations. Handles are valid for the lifetime of the ShaderUniforms object.
+  struct UniformHandle {
+    static constexpr uint32_t kInvalid = 0xFFFFFFFF;
+    uint32_t index = kInvalid;
+
+    [[nodiscard]] bool isValid() const {
+      return index != kInvalid;
+    }
+  };
+
+  /// A texture resolved by getTextureHandle().
+  struct TextureHandle {
+    static constexpr uint32_t kInvalid = 0xFFFFFFFF;
+    uint32_t index = kInvalid;
+
+    [[nodiscard]] bool isValid() const {
+      return index != kInvalid;
+    }
+  };
+
+  /// Resolves a uniform once, e.g. when creating a material; returns an invalid handle if the
+  /// shader has no such uniform.
+  UniformHandle getUniformHandle(const igl::NameHandle& uniformName);
+  UniformHandle getUniformHandle(const igl::NameHandle& blockTypeName,
+                                 const igl::NameHandle& blockInstanceName,
+                                 const igl::NameHandle& memberName);
+  TextureHandle getTextureHandle(const std::string& name) const;
+
+  // Setters for resolved uniforms and textures.
+  void setBool(UniformHandle handle, const bool& value, size_t arrayIndex = 0);
+  void setFloat(UniformHandle handle, const iglu::simdtypes::float1& value, size_t arrayIndex = 0);
+  void setFloat2(UniformHandle handle,
+                 const iglu::simdtypes::float2& value,
+                 size_t arrayIndex = 0);
+  void setFloat3(UniformHandle handle,
+                 const iglu::simdtypes::float3& value,
+                 size_t arrayIndex = 0);
+  void setFloat4(UniformHandle handle,
+                 const iglu::simdtypes::float4& value,
+                 size_t arrayIndex = 0);
+  void setFloat4Array(UniformHandle handle,
+                      const iglu::simdtypes::float4* value,
+                      size_t count = 1,
+                      size_t arrayIndex = 0);
+  void setFloat2x2(UniformHandle handle,
+                   const iglu::simdtypes::float2x2& value,
+                   size_t arrayIndex = 0);
+  void setFloat3x3(UniformHandle handle,
+                   const iglu::simdtypes::float3x3& value,
+                   size_t arrayIndex = 0);
+  void setFloat4x4(UniformHandle handle,
+                   const iglu::simdtypes::float4x4& value,
+                   size_t arrayIndex = 0);
+  void setFloat4x4Array(UniformHandle handle,
+                        const iglu::simdtypes::float4x4* value,
+                        size_t count = 1,
+                        size_t arrayIndex = 0);
+  void setInt(UniformHandle handle, const iglu::simdtypes::int1& value, size_t arrayIndex = 0);
+  void setTexture(TextureHandle handle,
+                  const std::shared_ptr<igl::ITexture>& value,
+                  const std::shared_ptr<igl::ISamplerState>& sampler);
+  void setTexture(TextureHandle handle, igl::ITexture* value, igl::ISamplerState* sampler);
+
   // Setters: use these to update uniforms, individually or in bulk.
   void setBool(const igl::NameHandle& uniformName, const bool& value, size_t arrayIndex = 0);
   void setBool(const igl::NameHandle& blockTypeName,
@@ -183,6 +247,11 @@ class ShaderUniforms final {
 
   void setTexture(const std::string& name, igl::ITexture* value, igl::ISamplerState* sampler);
 
+  /// Replaces the contents of the uniform buffer `bufferName` in all shader stages with one copy
+  /// of `length` bytes, e.g. of an iglu::uniform::BlockLayout verified against the reflection of
+  /// the pipeline. Not available for the individual uniforms of OpenGL 2.
+  void setUniformBlock(const igl::NameHandle& bufferName, const void* data, size_t length);
+
   /// Binds all relevant states in 'encoder' in preparation for drawing.
   void bind(igl::IDevice& device,
             const igl::IRenderPipelineState& pipelineState,
@@ -224,7 +293,7 @@ class ShaderUniforms final {
 
  private:
   struct BufferAllocation {
-    void* ptr = nullptr;
+    void* ptr = nullptr; // points into _shadowData
     size_t size = 0;
     std::shared_ptr<igl::IBuffer> iglBuffer;
     bool dirty = false;
@@ -249,6 +318,11 @@ class ShaderUniforms final {
     size_t suballocationsSize = 0; // this is a fixed size
     int currentAllocation = -1; // Which allocation are we updating/binding?
     std::vector<int> suballocations;
+
+    // OpenGL: the uniform location, or the binding point of the uniform block, resolved for the
+    // pipeline with the unique id `glPipelineId`
+    uint64_t glPipelineId = 0;
+    int glIndex = -1;
   };
 
   igl::IDevice& device_;
@@ -269,9 +343,31 @@ class ShaderUniforms final {
     igl::ISamplerState* rawSampler = nullptr;
   };
 
+  // textures and samplers are stored in the order of their descriptors, so binding them needs
+  // no lookups
   std::vector<igl::TextureArgDesc> _textureDescs;
-  std::unordered_map<std::string, TextureSlot> _allTexturesByName;
-  std::unordered_map<std::string, SamplerSlot> _allSamplersByName;
+  std::vector<TextureSlot> _textureSlots;
+  std::vector<SamplerSlot> _samplerSlots;
+  std::unordered_map<std::string, uint32_t> _textureIndices;
+  // all the textures with their samplers, created once they stay the same for two binds in a row
+  std::shared_ptr<igl::IBindGroup> _textureBindGroup;
+  uint32_t _numBindsWithSameTextures = 0;
+
+  // a uniform name can refer to members of several buffers, e.g. one per shader stage
+  struct ResolvedUniform {
+    BufferDesc* buffer = nullptr;
+    const UniformDesc* uniform = nullptr;
+  };
+  struct ResolvedUniformRange {
+    uint32_t first = 0;
+    uint32_t count = 0;
+  };
+  std::vector<ResolvedUniform> _resolvedUniforms;
+  std::vector<ResolvedUniformRange> _uniformHandles;
+  std::unordered_map<igl::NameHandle, UniformHandle> _uniformHandlesByName;
+
+  // the CPU copies of all uniform buffers, in one block
+  std::unique_ptr<uint8_t[]> _shadowData;
 
   igl::NameHandle getBufferName(const igl::NameHandle& blockTypeName,
                                 const igl::NameHandle& blockInstanceName,
@@ -281,6 +377,22 @@ class ShaderUniforms final {
                                       const igl::NameHandle& blockInstanceName,
                                       const igl::NameHandle& memberName);
 
+  UniformHandle addUniformHandle(const igl::NameHandle& key,
+                                 const std::vector<ResolvedUniform>& uniforms);
+
+  void setUniformBytes(UniformHandle handle,
+                       const void* data,
+                       size_t elementSize,
+                       size_t count,
+                       size_t arrayIndex);
+
+  void setUniformBytes(BufferDesc& buffer,
+                       const UniformDesc& uniformDesc,
+                       const void* data,
+                       size_t elementSize,
+                       size_t count,
+                       size_t arrayIndex);
+
   void setUniformBytes(const UniformDesc& uniformDesc,
                        const void* data,
                        size_t elementSize,
@@ -302,10 +414,14 @@ class ShaderUniforms final {
                        size_t arrayIndex);
 
   void bindUniformOpenGL(const igl::NameHandle& uniformName,
+                         int location,
                          const UniformDesc& uniformDesc,
-                         const igl::IRenderPipelineState& pipelineState,
                          igl::IRenderCommandEncoder& encoder);
 
+  void onTexturesChanged();
+  // returns nullptr if a slot is non-owning or has no sampler, or if two stages share a slot
+  std::shared_ptr<igl::IBindGroup> createTextureBindGroup(igl::IDevice& device) const;
+
   void bindBuffer(igl::IDevice& device,
                   const igl::IRenderPipelineState& pipelineState,
                   igl::IRenderCommandEncoder& encoder,
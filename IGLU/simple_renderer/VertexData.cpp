@@ -7,11 +7,24 @@
 
 #include "VertexData.h"
 
+#include <cstring>
 #include <utility>
 
 namespace iglu {
 namespace vertexdata {
 
+void Bounds::extend(const float* position) {
+  for (int i = 0; i != 3; i++) {
+    if (!isValid || position[i] < min[i]) {
+      min[i] = position[i];
+    }
+    if (!isValid || position[i] > max[i]) {
+      max[i] = position[i];
+    }
+  }
+  isValid = true;
+}
+
 VertexData::VertexData(std::shared_ptr<igl::IVertexInputState> vis,
                        std::shared_ptr<igl::IBuffer> vertexBuffer,
                        std::shared_ptr<igl::IBuffer> indexBuffer,
@@ -58,19 +71,36 @@ bool VertexData::appendData(const void* data, size_t size, size_t numPrimitives)
 
   vb_->upload(data, {size, usedBytes_});
 
+  if (positionStride_ != 0) {
+    // the data starts on a vertex boundary
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t vertex = 0; vertex + positionOffset_ + 3 * sizeof(float) <= size;
+         vertex += positionStride_) {
+      float position[3];
+      std::memcpy(position, bytes + vertex + positionOffset_, sizeof(position));
+      bounds_.extend(position);
+    }
+  }
+
   primitiveDesc_.numEntries += numPrimitives;
   usedBytes_ += size;
 
   return true;
 }
 
-void VertexData::draw(igl::IRenderCommandEncoder& commandEncoder) {
+void VertexData::setPositionLayout(size_t offset, size_t stride) {
+  IGL_ASSERT(stride >= offset + 3 * sizeof(float));
+  positionOffset_ = offset;
+  positionStride_ = stride;
+}
+
+void VertexData::draw(igl::IRenderCommandEncoder& commandEncoder, bool bindVertexBuffer) {
   if (primitiveDesc_.numEntries == 0) {
     return;
   }
-  // Assumption: we don't need buffer offset
-  if (vb_) {
-    commandEncoder.bindBuffer(0, igl::BindTarget::kVertex, vb_, 0);
+  if (vb_ && bindVertexBuffer) {
+    commandEncoder.bindBuffer(
+        0, igl::BindTarget::kVertex, vb_, primitiveDesc_.vertexBufferOffset);
   }
 
   if (ib_) {
@@ -81,6 +111,41 @@ void VertexData::draw(igl::IRenderCommandEncoder& commandEncoder) {
   }
 }
 
+void VertexData::getIndirectCommand(uint32_t instanceCount, void* outCommand) const {
+  // DrawElementsIndirectCommand: count, instanceCount, firstIndex, baseVertex, baseInstance
+  // DrawArraysIndirectCommand: count, instanceCount, first, baseInstance
+  uint32_t command[kIndirectCommandSize / sizeof(uint32_t)] = {};
+  command[0] = static_cast<uint32_t>(primitiveDesc_.numEntries);
+  command[1] = instanceCount;
+  if (ib_) {
+    const size_t indexSize = ibFormat_ == igl::IndexFormat::UInt16 ? 2 : 4;
+    command[2] = static_cast<uint32_t>(primitiveDesc_.offset / indexSize);
+  } else {
+    command[2] = static_cast<uint32_t>(primitiveDesc_.offset);
+  }
+  std::memcpy(outCommand, command, sizeof(command));
+}
+
+void VertexData::drawIndirect(igl::IRenderCommandEncoder& commandEncoder,
+                              igl::IBuffer& indirectBuffer,
+                              size_t indirectBufferOffset,
+                              bool bindVertexBuffer) {
+  if (primitiveDesc_.numEntries == 0) {
+    return;
+  }
+  if (vb_ && bindVertexBuffer) {
+    commandEncoder.bindBuffer(
+        0, igl::BindTarget::kVertex, vb_, primitiveDesc_.vertexBufferOffset);
+  }
+
+  if (ib_) {
+    commandEncoder.multiDrawIndexedIndirect(
+        primitiveDesc_.type, ibFormat_, *ib_, indirectBuffer, indirectBufferOffset, 1);
+  } else {
+    commandEncoder.multiDrawIndirect(primitiveDesc_.type, indirectBuffer, indirectBufferOffset, 1);
+  }
+}
+
 PrimitiveDesc& VertexData::primitiveDesc() {
   return primitiveDesc_;
 }
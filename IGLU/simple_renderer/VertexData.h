@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <IGLU/simdtypes/SimdTypes.h>
 #include <igl/IGL.h>
 #include <memory>
 #include <vector>
@@ -20,6 +21,18 @@ struct PrimitiveDesc {
   size_t offset = 0;
   igl::PrimitiveType type = igl::PrimitiveType::Triangle;
   igl::WindingMode frontFaceWinding = igl::WindingMode::CounterClockwise;
+  /// Byte offset at which the vertex buffer is bound, e.g. to draw a range of a shared buffer.
+  size_t vertexBufferOffset = 0;
+};
+
+/// Axis-aligned bounding box of vertex positions. The w components are unused.
+struct Bounds {
+  simdtypes::float4 min = {};
+  simdtypes::float4 max = {};
+  bool isValid = false;
+
+  /// Grows the box to contain 'position' (x, y, z).
+  void extend(const float* position);
 };
 
 /// Consolidates all vertex data input in a single place. Also handles binding and drawing.
@@ -29,8 +42,23 @@ class VertexData final {
   /// before draw().
   void populatePipelineDescriptor(igl::RenderPipelineDesc& pipelineDesc) const;
 
-  /// Invokes the draw command of the lower level APIs.
-  void draw(igl::IRenderCommandEncoder& commandEncoder);
+  /// Invokes the draw command of the lower level APIs. 'bindVertexBuffer' can be false when the
+  /// vertex buffer of this vertex data is still bound by the previous draw.
+  void draw(igl::IRenderCommandEncoder& commandEncoder, bool bindVertexBuffer = true);
+
+  /// Size of the commands written by getIndirectCommand().
+  static constexpr size_t kIndirectCommandSize = igl::IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE;
+
+  /// Writes the indirect draw command drawing 'instanceCount' instances of this vertex data to
+  /// 'outCommand', which must hold kIndirectCommandSize bytes.
+  void getIndirectCommand(uint32_t instanceCount, void* outCommand) const;
+
+  /// Invokes the indirect draw command written to 'indirectBuffer' by getIndirectCommand().
+  /// Requires igl::DeviceFeatures::DrawIndexedIndirect.
+  void drawIndirect(igl::IRenderCommandEncoder& commandEncoder,
+                    igl::IBuffer& indirectBuffer,
+                    size_t indirectBufferOffset,
+                    bool bindVertexBuffer = true);
 
   PrimitiveDesc& primitiveDesc();
   std::shared_ptr<igl::IVertexInputState> vertexInputState();
@@ -59,6 +87,18 @@ class VertexData final {
   /// corresponds to. The internal PrimitiveDesc will be updated.
   bool appendData(const void* data, size_t size, size_t numPrimitives);
 
+  /// Makes appendData() extend bounds() with the positions it uploads. Each vertex is 'stride'
+  /// bytes and starts its position (3 floats) 'offset' bytes into the vertex.
+  void setPositionLayout(size_t offset, size_t stride);
+
+  /// Model space bounds of the vertices, used for culling. Invalid bounds are never culled.
+  const Bounds& bounds() const {
+    return bounds_;
+  }
+  void setBounds(const Bounds& bounds) {
+    bounds_ = bounds;
+  }
+
   igl::IBuffer& indexBuffer() {
     IGL_ASSERT(ib_);
     return *ib_.get();
@@ -76,6 +116,9 @@ class VertexData final {
   igl::IndexFormat ibFormat_ = igl::IndexFormat::UInt16;
   PrimitiveDesc primitiveDesc_;
   size_t usedBytes_ = 0;
+  Bounds bounds_;
+  size_t positionOffset_ = 0;
+  size_t positionStride_ = 0; // 0 when the position layout is unknown
 };
 
 } // namespace vertexdata
@@ -0,0 +1,1033 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "VisibilityBufferPass.h"
+
+#include <IGLU/glsl/StorageBuffers.h>
+#include <IGLU/glsl/Versions.h>
+#include <IGLU/simdtypes/SimdUtilities.h>
+#include <algorithm>
+#include <igl/ShaderCreator.h>
+
+namespace iglu {
+namespace renderpass {
+
+using namespace simdtypes;
+
+namespace {
+
+constexpr size_t kTextureUnit = 0;
+
+// Offsets of the storage buffers from the first buffer index
+constexpr int kParamsOffset = 0;
+constexpr int kInstancesOffset = 1;
+constexpr int kIndicesOffset = 2;
+constexpr int kVerticesOffset = 3;
+constexpr int kMaterialsOffset = 4;
+
+// the push constants of Metal and the bindless table of metal::BindlessTable
+const char kMetalPushConstantsIndex[] = "29";
+const char kMetalBindlessTableIndex[] = "30";
+
+constexpr uint32_t kFloatsPerVertex = sizeof(VisibilityVertex) / sizeof(float);
+
+// matches the GLSL and Metal VisibilityParams
+struct VisibilityParams {
+  float4x4 viewProjection;
+  // ndc = fragCoord * ndcScale + ndcBias
+  float ndcScale[2];
+  float ndcBias[2];
+  uint32_t numInstances;
+  uint32_t padding[3];
+};
+static_assert(sizeof(VisibilityParams) == 96, "VisibilityParams must match the shader layout");
+
+// the push constants of the geometry pass, one draw per instance
+struct GeometryConstants {
+  float4x4 modelViewProjection;
+  uint32_t firstIndex;
+  int32_t baseVertex;
+  // the visibility id of the first triangle of the instance; 0 is no triangle
+  uint32_t triangleBase;
+  uint32_t padding;
+};
+
+// matches VisibilityInstance
+const char kGlslDeclarations[] = R"(
+struct VisibilityInstance {
+  mat4 model;
+  vec4 normalMatrix[3];
+  uint firstIndex;
+  int baseVertex;
+  uint materialIndex;
+  uint firstTriangle;
+};
+
+VISIBILITY_INDICES_BUFFER readonly buffer VisibilityIndices {
+  uint visibilityIndices[];
+};
+VISIBILITY_VERTICES_BUFFER readonly buffer VisibilityVertices {
+  float visibilityVertices[];
+};
+
+vec3 loadVisibilityVec3(uint v, uint offset) {
+  uint i = v * VISIBILITY_FLOATS_PER_VERTEX + offset;
+  return vec3(visibilityVertices[i], visibilityVertices[i + 1u], visibilityVertices[i + 2u]);
+}
+vec2 loadVisibilityVec2(uint v, uint offset) {
+  uint i = v * VISIBILITY_FLOATS_PER_VERTEX + offset;
+  return vec2(visibilityVertices[i], visibilityVertices[i + 1u]);
+}
+)";
+
+const char kGlslGeometryVertex[] = R"(
+layout(push_constant) uniform VisibilityConstants {
+  mat4 modelViewProjection;
+  uint firstIndex;
+  int baseVertex;
+  uint triangleBase;
+} constants;
+
+layout(location = 0) flat out uint triangleId;
+
+void main() {
+  uint i = uint(VISIBILITY_VERTEX_INDEX);
+  uint v = uint(int(visibilityIndices[constants.firstIndex + i]) + constants.baseVertex);
+  // the 3 vertices of a triangle agree, whichever is the provoking vertex
+  triangleId = constants.triangleBase + i / 3u;
+  gl_Position = constants.modelViewProjection * vec4(loadVisibilityVec3(v, 0u), 1.0);
+}
+)";
+
+const char kGlslGeometryFragment[] = R"(
+layout(location = 0) flat in uint triangleId;
+layout(location = 0) out uvec2 outId;
+
+void main() {
+  outId = uvec2(triangleId & 0xFFFFu, triangleId >> 16u);
+}
+)";
+
+// computeVisibilityBarycentrics(), findVisibilityInstance() and the attribute interpolation of
+// the resolve pass
+const char kGlslResolve[] = R"(
+VISIBILITY_PARAMS_BUFFER readonly buffer VisibilityParams {
+  mat4 viewProjection;
+  vec2 ndcScale;
+  vec2 ndcBias;
+  uint numInstances;
+} visibilityParams;
+VISIBILITY_INSTANCES_BUFFER readonly buffer VisibilityInstances {
+  VisibilityInstance visibilityInstances[];
+};
+
+struct VisibilitySample {
+  uint instanceIndex;
+  // in the instance
+  uint triangleIndex;
+  uint materialIndex;
+  vec3 barycentrics;
+  // the change of the barycentrics to the next pixel along x and y
+  vec3 barycentricsDx;
+  vec3 barycentricsDy;
+  // world space
+  vec3 position;
+  vec3 normal;
+  vec2 uv;
+  vec2 uvDx;
+  vec2 uvDy;
+};
+
+void computeVisibilityBarycentrics(vec4 clip[3],
+                                   vec2 ndc,
+                                   vec2 ndcPerPixel,
+                                   out vec3 barycentrics,
+                                   out vec3 dx,
+                                   out vec3 dy) {
+  vec3 invW = 1.0 / vec3(clip[0].w, clip[1].w, clip[2].w);
+  vec2 n0 = clip[0].xy * invW.x;
+  vec2 n1 = clip[1].xy * invW.y;
+  vec2 n2 = clip[2].xy * invW.z;
+  float invDet = 1.0 / determinant(mat2(n2 - n1, n0 - n1));
+  vec3 dbdx = vec3(n1.y - n2.y, n2.y - n0.y, n0.y - n1.y) * invDet;
+  vec3 dbdy = vec3(n2.x - n1.x, n0.x - n2.x, n1.x - n0.x) * invDet;
+  vec2 d = ndc - n0;
+  vec3 b = vec3(1.0, 0.0, 0.0) + d.x * dbdx + d.y * dbdy;
+  vec3 q = b * invW;
+  barycentrics = q / (q.x + q.y + q.z);
+  vec3 qx = (b + ndcPerPixel.x * dbdx) * invW;
+  dx = qx / (qx.x + qx.y + qx.z) - barycentrics;
+  vec3 qy = (b + ndcPerPixel.y * dbdy) * invW;
+  dy = qy / (qy.x + qy.y + qy.z) - barycentrics;
+}
+
+uint findVisibilityInstance(uint triangle) {
+  uint first = 0u;
+  uint count = visibilityParams.numInstances;
+  while (count > 0u) {
+    uint halfCount = count / 2u;
+    if (visibilityInstances[first + halfCount].firstTriangle <= triangle) {
+      first += halfCount + 1u;
+      count -= halfCount + 1u;
+    } else {
+      count = halfCount;
+    }
+  }
+  return first - 1u;
+}
+
+bool loadVisibilitySample(vec2 fragCoord, out VisibilitySample s) {
+  uvec2 packedId = texelFetch(visibilityIds, ivec2(fragCoord), 0).rg;
+  uint id = packedId.x | (packedId.y << 16u);
+  if (id == 0u) {
+    return false;
+  }
+  uint triangle = id - 1u;
+  s.instanceIndex = findVisibilityInstance(triangle);
+  VisibilityInstance instance = visibilityInstances[s.instanceIndex];
+  s.triangleIndex = triangle - instance.firstTriangle;
+  s.materialIndex = instance.materialIndex;
+
+  uint first = instance.firstIndex + 3u * s.triangleIndex;
+  uint v[3];
+  vec3 world[3];
+  vec4 clip[3];
+  for (uint k = 0u; k < 3u; k++) {
+    v[k] = uint(int(visibilityIndices[first + k]) + instance.baseVertex);
+    world[k] = (instance.model * vec4(loadVisibilityVec3(v[k], 0u), 1.0)).xyz;
+    clip[k] = visibilityParams.viewProjection * vec4(world[k], 1.0);
+  }
+  computeVisibilityBarycentrics(clip,
+                                fragCoord * visibilityParams.ndcScale + visibilityParams.ndcBias,
+                                visibilityParams.ndcScale,
+                                s.barycentrics,
+                                s.barycentricsDx,
+                                s.barycentricsDy);
+  vec3 b = s.barycentrics;
+  s.position = world[0] * b.x + world[1] * b.y + world[2] * b.z;
+  vec3 normal = loadVisibilityVec3(v[0], 3u) * b.x + loadVisibilityVec3(v[1], 3u) * b.y +
+                loadVisibilityVec3(v[2], 3u) * b.z;
+  mat3 normalMatrix = mat3(instance.normalMatrix[0].xyz,
+                           instance.normalMatrix[1].xyz,
+                           instance.normalMatrix[2].xyz);
+  s.normal = normalize(normalMatrix * normal);
+  mat3x2 uvs = mat3x2(
+      loadVisibilityVec2(v[0], 6u), loadVisibilityVec2(v[1], 6u), loadVisibilityVec2(v[2], 6u));
+  s.uv = uvs * b;
+  s.uvDx = uvs * s.barycentricsDx;
+  s.uvDy = uvs * s.barycentricsDy;
+  return true;
+}
+)";
+
+const char kVulkanResolveVertex[] = R"(
+void main() {
+  vec2 uv = vec2(float((gl_VertexIndex << 1) & 2), float(gl_VertexIndex & 2));
+  gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+const char kOpenGLResolveVertex[] = R"(
+void main() {
+  vec2 uv = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+  gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+const char kMetalDeclarations[] = R"(
+#include <metal_stdlib>
+
+struct VisibilityInstance {
+  float4x4 model;
+  float4 normalMatrix[3];
+  uint firstIndex;
+  int baseVertex;
+  uint materialIndex;
+  uint firstTriangle;
+};
+
+struct VisibilityParams {
+  float4x4 viewProjection;
+  float2 ndcScale;
+  float2 ndcBias;
+  uint numInstances;
+};
+
+inline float3 loadVisibilityFloat3(const device float* vertices, uint v, uint offset) {
+  const uint i = v * VISIBILITY_FLOATS_PER_VERTEX + offset;
+  return float3(vertices[i], vertices[i + 1], vertices[i + 2]);
+}
+)";
+
+const char kMetalGeometry[] = R"(
+struct VisibilityConstants {
+  float4x4 modelViewProjection;
+  uint firstIndex;
+  int baseVertex;
+  uint triangleBase;
+  uint padding;
+};
+
+struct VisibilityGeometryOut {
+  float4 position [[position]];
+  uint triangleId [[flat]];
+};
+
+vertex VisibilityGeometryOut visibilityGeometryVertex(
+    uint vid [[vertex_id]],
+    constant VisibilityConstants& constants [[buffer(VISIBILITY_PUSH_CONSTANTS_INDEX)]],
+    const device uint* indices [[buffer(VISIBILITY_INDICES_INDEX)]],
+    const device float* vertices [[buffer(VISIBILITY_VERTICES_INDEX)]]) {
+  const uint v = uint(int(indices[constants.firstIndex + vid]) + constants.baseVertex);
+  VisibilityGeometryOut out;
+  out.position =
+      constants.modelViewProjection * float4(loadVisibilityFloat3(vertices, v, 0), 1.0);
+  out.triangleId = constants.triangleBase + vid / 3;
+  return out;
+}
+
+fragment uint4 visibilityGeometryFragment(VisibilityGeometryOut in [[stage_in]]) {
+  return uint4(in.triangleId & 0xFFFF, in.triangleId >> 16, 0, 0);
+}
+)";
+
+const char kMetalResolve[] = R"(
+struct VisibilitySample {
+  uint instanceIndex;
+  // in the instance
+  uint triangleIndex;
+  uint materialIndex;
+  float3 barycentrics;
+  // the change of the barycentrics to the next pixel along x and y
+  float3 barycentricsDx;
+  float3 barycentricsDy;
+  // world space
+  float3 position;
+  float3 normal;
+  float2 uv;
+  float2 uvDx;
+  float2 uvDy;
+};
+
+inline void computeVisibilityBarycentrics(const thread float4* clip,
+                                          float2 ndc,
+                                          float2 ndcPerPixel,
+                                          thread float3& barycentrics,
+                                          thread float3& dx,
+                                          thread float3& dy) {
+  const float3 invW = 1.0 / float3(clip[0].w, clip[1].w, clip[2].w);
+  const float2 n0 = clip[0].xy * invW.x;
+  const float2 n1 = clip[1].xy * invW.y;
+  const float2 n2 = clip[2].xy * invW.z;
+  const float invDet = 1.0 / metal::determinant(float2x2(n2 - n1, n0 - n1));
+  const float3 dbdx = float3(n1.y - n2.y, n2.y - n0.y, n0.y - n1.y) * invDet;
+  const float3 dbdy = float3(n2.x - n1.x, n0.x - n2.x, n1.x - n0.x) * invDet;
+  const float2 d = ndc - n0;
+  const float3 b = float3(1.0, 0.0, 0.0) + d.x * dbdx + d.y * dbdy;
+  const float3 q = b * invW;
+  barycentrics = q / (q.x + q.y + q.z);
+  const float3 qx = (b + ndcPerPixel.x * dbdx) * invW;
+  dx = qx / (qx.x + qx.y + qx.z) - barycentrics;
+  const float3 qy = (b + ndcPerPixel.y * dbdy) * invW;
+  dy = qy / (qy.x + qy.y + qy.z) - barycentrics;
+}
+
+inline uint findVisibilityInstance(VisibilityBuffer vb, uint triangle) {
+  uint first = 0;
+  uint count = vb.params->numInstances;
+  while (count > 0) {
+    const uint halfCount = count / 2;
+    if (vb.instances[first + halfCount].firstTriangle <= triangle) {
+      first += halfCount + 1;
+      count -= halfCount + 1;
+    } else {
+      count = halfCount;
+    }
+  }
+  return first - 1;
+}
+
+inline float2 loadVisibilityUv(VisibilityBuffer vb, uint v) {
+  const uint i = v * VISIBILITY_FLOATS_PER_VERTEX + 6;
+  return float2(vb.vertices[i], vb.vertices[i + 1]);
+}
+
+inline bool loadVisibilitySample(VisibilityBuffer vb,
+                                 metal::texture2d<uint> visibilityIds,
+                                 float2 fragCoord,
+                                 thread VisibilitySample& s) {
+  const uint2 packedId = visibilityIds.read(uint2(fragCoord)).rg;
+  const uint id = packedId.x | (packedId.y << 16);
+  if (id == 0) {
+    return false;
+  }
+  const uint triangle = id - 1;
+  s.instanceIndex = findVisibilityInstance(vb, triangle);
+  const VisibilityInstance instance = vb.instances[s.instanceIndex];
+  s.triangleIndex = triangle - instance.firstTriangle;
+  s.materialIndex = instance.materialIndex;
+
+  const uint first = instance.firstIndex + 3 * s.triangleIndex;
+  uint v[3];
+  float3 world[3];
+  float4 clip[3];
+  for (uint k = 0; k < 3; k++) {
+    v[k] = uint(int(vb.indices[first + k]) + instance.baseVertex);
+    world[k] = (instance.model * float4(loadVisibilityFloat3(vb.vertices, v[k], 0), 1.0)).xyz;
+    clip[k] = vb.params->viewProjection * float4(world[k], 1.0);
+  }
+  computeVisibilityBarycentrics(clip,
+                                fragCoord * vb.params->ndcScale + vb.params->ndcBias,
+                                vb.params->ndcScale,
+                                s.barycentrics,
+                                s.barycentricsDx,
+                                s.barycentricsDy);
+  const float3 b = s.barycentrics;
+  s.position = world[0] * b.x + world[1] * b.y + world[2] * b.z;
+  const float3 normal = loadVisibilityFloat3(vb.vertices, v[0], 3) * b.x +
+                        loadVisibilityFloat3(vb.vertices, v[1], 3) * b.y +
+                        loadVisibilityFloat3(vb.vertices, v[2], 3) * b.z;
+  const float3x3 normalMatrix = float3x3(instance.normalMatrix[0].xyz,
+                                         instance.normalMatrix[1].xyz,
+                                         instance.normalMatrix[2].xyz);
+  s.normal = metal::normalize(normalMatrix * normal);
+  const float2 uv0 = loadVisibilityUv(vb, v[0]);
+  const float2 uv1 = loadVisibilityUv(vb, v[1]);
+  const float2 uv2 = loadVisibilityUv(vb, v[2]);
+  s.uv = uv0 * b.x + uv1 * b.y + uv2 * b.z;
+  s.uvDx = uv0 * s.barycentricsDx.x + uv1 * s.barycentricsDx.y + uv2 * s.barycentricsDx.z;
+  s.uvDy = uv0 * s.barycentricsDy.x + uv1 * s.barycentricsDy.y + uv2 * s.barycentricsDy.z;
+  return true;
+}
+)";
+
+const char kMetalResolveVertex[] = R"(
+struct VisibilityResolveOut {
+  float4 position [[position]];
+};
+
+vertex VisibilityResolveOut visibilityResolveVertex(uint vid [[vertex_id]]) {
+  const float2 uv = float2(float((vid << 1) & 2), float(vid & 2));
+  VisibilityResolveOut out;
+  out.position = float4(uv * 2.0 - 1.0, 0.0, 1.0);
+  return out;
+}
+)";
+
+std::string define(const char* name, const std::string& value) {
+  return std::string("#define ") + name + " " + value + "\n";
+}
+
+// The geometry and resolve shaders bind the buffers from firstBufferIndex on
+std::string getGlslDeclarations(bool isVulkan, int firstIndex) {
+  const auto layout = [isVulkan, firstIndex](int offset) {
+    return glsl::storageBufferLayout(isVulkan, firstIndex + offset);
+  };
+  return define("VISIBILITY_FLOATS_PER_VERTEX", std::to_string(kFloatsPerVertex) + "u") +
+         define("VISIBILITY_PARAMS_BUFFER", layout(kParamsOffset)) +
+         define("VISIBILITY_INSTANCES_BUFFER", layout(kInstancesOffset)) +
+         define("VISIBILITY_INDICES_BUFFER", layout(kIndicesOffset)) +
+         define("VISIBILITY_VERTICES_BUFFER", layout(kVerticesOffset)) +
+         define("VISIBILITY_MATERIALS_BUFFER", layout(kMaterialsOffset)) + kGlslDeclarations;
+}
+
+std::string getMetalDeclarations(int firstIndex) {
+  return define("VISIBILITY_FLOATS_PER_VERTEX", std::to_string(kFloatsPerVertex)) +
+         define("VISIBILITY_PUSH_CONSTANTS_INDEX", kMetalPushConstantsIndex) +
+         define("VISIBILITY_PARAMS_INDEX", std::to_string(firstIndex + kParamsOffset)) +
+         define("VISIBILITY_INSTANCES_INDEX", std::to_string(firstIndex + kInstancesOffset)) +
+         define("VISIBILITY_INDICES_INDEX", std::to_string(firstIndex + kIndicesOffset)) +
+         define("VISIBILITY_VERTICES_INDEX", std::to_string(firstIndex + kVerticesOffset)) +
+         define("VISIBILITY_MATERIALS_INDEX", std::to_string(firstIndex + kMaterialsOffset)) +
+         kMetalDeclarations;
+}
+
+std::shared_ptr<igl::IBuffer> createBuffer(igl::IDevice& device,
+                                           size_t length,
+                                           const char* debugName,
+                                           igl::Result* outResult) {
+  igl::BufferDesc desc(
+      igl::BufferDesc::BufferTypeBits::Storage, nullptr, length, igl::ResourceStorage::Shared);
+  if (device.hasFeature(igl::DeviceFeatures::BufferRing)) {
+    // render() uploads the view and the instances of every frame
+    desc.hint |= igl::BufferDesc::BufferAPIHintBits::Ring;
+  }
+  desc.debugName = debugName;
+  return device.createBuffer(desc, outResult);
+}
+
+void setNormalMatrix(const float4x4& model, VisibilityInstance& outInstance) {
+  // the rows of the inverse are the columns of the inverse transpose
+  const float4x4 inv = inverse(model);
+  for (int j = 0; j != 3; j++) {
+    outInstance.normalMatrix[j] =
+        float4{inv.columns[0][j], inv.columns[1][j], inv.columns[2][j], 0.0f};
+  }
+}
+
+} // namespace
+
+uint64_t buildVisibilityInstances(const std::vector<VisibilityMeshInstance>& instances,
+                                  std::vector<VisibilityInstance>& outInstances) {
+  outInstances.resize(instances.size());
+  uint64_t numTriangles = 0;
+  for (size_t i = 0; i != instances.size(); i++) {
+    const VisibilityMeshInstance& mesh = instances[i];
+    VisibilityInstance& instance = outInstances[i];
+    instance.model = mesh.model;
+    setNormalMatrix(mesh.model, instance);
+    instance.firstIndex = mesh.firstIndex;
+    instance.baseVertex = mesh.baseVertex;
+    instance.materialIndex = mesh.materialIndex;
+    // truncated beyond 2^32 triangles, which setScene() rejects
+    instance.firstTriangle = static_cast<uint32_t>(numTriangles);
+    numTriangles += mesh.numIndices / 3;
+  }
+  return numTriangles;
+}
+
+uint32_t findVisibilityInstance(const VisibilityInstance* instances,
+                                uint32_t numInstances,
+                                uint32_t triangle) {
+  const VisibilityInstance* it =
+      std::upper_bound(instances,
+                       instances + numInstances,
+                       triangle,
+                       [](uint32_t value, const VisibilityInstance& instance) {
+                         return value < instance.firstTriangle;
+                       });
+  return static_cast<uint32_t>(it - instances) - 1;
+}
+
+void computeVisibilityBarycentrics(const float4 clip[3],
+                                   const float ndc[2],
+                                   const float ndcPerPixel[2],
+                                   float3& outBarycentrics,
+                                   float3& outDx,
+                                   float3& outDy) {
+  float invW[3];
+  float n[3][2];
+  for (int k = 0; k != 3; k++) {
+    invW[k] = 1.0f / clip[k][3];
+    n[k][0] = clip[k][0] * invW[k];
+    n[k][1] = clip[k][1] * invW[k];
+  }
+  // determinant(mat2(n2 - n1, n0 - n1))
+  const float invDet = 1.0f / ((n[2][0] - n[1][0]) * (n[0][1] - n[1][1]) -
+                               (n[0][0] - n[1][0]) * (n[2][1] - n[1][1]));
+  const float dbdx[3] = {(n[1][1] - n[2][1]) * invDet,
+                         (n[2][1] - n[0][1]) * invDet,
+                         (n[0][1] - n[1][1]) * invDet};
+  const float dbdy[3] = {(n[2][0] - n[1][0]) * invDet,
+                         (n[0][0] - n[2][0]) * invDet,
+                         (n[1][0] - n[0][0]) * invDet};
+  const float d[2] = {ndc[0] - n[0][0], ndc[1] - n[0][1]};
+  float b[3];
+  for (int k = 0; k != 3; k++) {
+    b[k] = (k == 0 ? 1.0f : 0.0f) + d[0] * dbdx[k] + d[1] * dbdy[k];
+  }
+  // the perspective correct barycentrics of the screen space ones shifted by (sx, sy) pixels
+  const auto correct = [&b, &invW, &dbdx, &dbdy](float sx, float sy) {
+    float q[3];
+    for (int k = 0; k != 3; k++) {
+      q[k] = (b[k] + sx * dbdx[k] + sy * dbdy[k]) * invW[k];
+    }
+    const float invSum = 1.0f / (q[0] + q[1] + q[2]);
+    return float3{q[0] * invSum, q[1] * invSum, q[2] * invSum};
+  };
+  outBarycentrics = correct(0.0f, 0.0f);
+  const float3 nextX = correct(ndcPerPixel[0], 0.0f);
+  const float3 nextY = correct(0.0f, ndcPerPixel[1]);
+  outDx = float3{nextX[0] - outBarycentrics[0],
+                 nextX[1] - outBarycentrics[1],
+                 nextX[2] - outBarycentrics[2]};
+  outDy = float3{nextY[0] - outBarycentrics[0],
+                 nextY[1] - outBarycentrics[1],
+                 nextY[2] - outBarycentrics[2]};
+}
+
+VisibilityBufferPass::VisibilityBufferPass(igl::IDevice& device,
+                                           VisibilityBufferConfig config,
+                                           igl::Result* outResult) :
+  _device(device), _config(config), _backendType(device.getBackendType()) {
+  if (_backendType == igl::BackendType::OpenGL &&
+      !device.hasFeature(igl::DeviceFeatures::Compute)) {
+    // storage buffers come with compute shaders
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::Unsupported,
+                           "The visibility buffer requires storage buffers");
+    return;
+  }
+  if (_config.firstBufferIndex < 0) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentOutOfRange, "Invalid visibility buffer config");
+    return;
+  }
+  _hasBindlessTextures = device.hasFeature(igl::DeviceFeatures::TextureBindless);
+
+  igl::Result result;
+  _paramsBuffer =
+      createBuffer(device, sizeof(VisibilityParams), "VisibilityBufferPass params", &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  const bool isVulkan = _backendType == igl::BackendType::Vulkan;
+  std::unique_ptr<igl::IShaderStages> stages;
+  switch (_backendType) {
+  case igl::BackendType::Vulkan:
+  case igl::BackendType::OpenGL: {
+    const std::string version =
+        isVulkan ? "" : glsl::getOpenGLVersion(device.getShaderVersion(), true);
+    const std::string declarations = getGlslDeclarations(isVulkan, _config.firstBufferIndex);
+    const std::string vertexSource =
+        version + define("VISIBILITY_VERTEX_INDEX", isVulkan ? "gl_VertexIndex" : "gl_VertexID") +
+        declarations + kGlslGeometryVertex;
+    const std::string fragmentSource = version + kGlslGeometryFragment;
+    stages = igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                             vertexSource.c_str(),
+                                                             "main",
+                                                             "VisibilityBufferPass geometry (vert)",
+                                                             fragmentSource.c_str(),
+                                                             "main",
+                                                             "VisibilityBufferPass geometry (frag)",
+                                                             &result);
+    break;
+  }
+  // @fb-only
+    // @fb-only
+  case igl::BackendType::Metal: {
+    const std::string source = getMetalDeclarations(_config.firstBufferIndex) + kMetalGeometry;
+    stages = igl::ShaderStagesCreator::fromLibraryStringInput(device,
+                                                              source.c_str(),
+                                                              "visibilityGeometryVertex",
+                                                              "visibilityGeometryFragment",
+                                                              "",
+                                                              &result);
+    break;
+  }
+  }
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  igl::RenderPipelineDesc desc;
+  desc.shaderStages = std::move(stages);
+  desc.targetDesc.colorAttachments.resize(1);
+  desc.targetDesc.colorAttachments[0].textureFormat = igl::TextureFormat::RG_UInt16;
+  desc.targetDesc.depthAttachmentFormat = _config.depthFormat;
+  desc.cullMode = _config.cullMode;
+  desc.debugName = IGL_NAMEHANDLE("VisibilityBufferPass: geometry");
+  _geometryPipeline = device.createRenderPipeline(desc, &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  igl::DepthStencilStateDesc depthDesc;
+  depthDesc.isDepthWriteEnabled = true;
+  depthDesc.compareFunction = igl::CompareFunction::Less;
+  _depthState = device.createDepthStencilState(depthDesc, &result);
+  depthDesc.isDepthWriteEnabled = false;
+  depthDesc.compareFunction = igl::CompareFunction::AlwaysPass;
+  _alwaysPassState = device.createDepthStencilState(depthDesc, &result);
+
+  // the ids are not filterable
+  igl::SamplerStateDesc samplerDesc;
+  samplerDesc.minFilter = samplerDesc.magFilter = igl::SamplerMinMagFilter::Nearest;
+  samplerDesc.mipFilter = igl::SamplerMipFilter::Disabled;
+  samplerDesc.debugName = "VisibilityBufferPass";
+  _sampler = device.createSamplerState(samplerDesc, &result);
+  igl::Result::setResult(outResult, std::move(result));
+}
+
+VisibilityBufferPass::~VisibilityBufferPass() = default;
+
+void VisibilityBufferPass::setScene(VisibilitySceneDesc scene, igl::Result* outResult) {
+  if (!scene.vertexBuffer || !scene.indexBuffer) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentNull, "The scene needs vertex and index buffers");
+    return;
+  }
+  for (const VisibilityMeshInstance& instance : scene.instances) {
+    if (instance.numIndices % 3 != 0) {
+      igl::Result::setResult(outResult,
+                             igl::Result::Code::ArgumentInvalid,
+                             "Instances must be lists of whole triangles");
+      return;
+    }
+  }
+  std::vector<VisibilityInstance> instances;
+  const uint64_t numTriangles = buildVisibilityInstances(scene.instances, instances);
+  // an id of 0 is no triangle
+  if (numTriangles >= UINT32_MAX) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::ArgumentOutOfRange,
+                           "The scene has too many triangles for 32-bit visibility ids");
+    return;
+  }
+
+  // the resolve pass binds the buffer even without instances
+  const size_t length = std::max<size_t>(instances.size(), 1) * sizeof(VisibilityInstance);
+  if (!_instancesBuffer || _instancesBuffer->getSizeInBytes() < length) {
+    igl::Result result;
+    auto buffer = createBuffer(_device, length, "VisibilityBufferPass instances", &result);
+    if (!result.isOk()) {
+      igl::Result::setResult(outResult, std::move(result));
+      return;
+    }
+    _instancesBuffer = std::move(buffer);
+  }
+  _scene = std::move(scene);
+  _instances = std::move(instances);
+  _numTriangles = numTriangles;
+  igl::Result::setOk(outResult);
+}
+
+void VisibilityBufferPass::setInstanceModel(size_t index, const float4x4& model) {
+  if (!IGL_VERIFY(index < _instances.size())) {
+    return;
+  }
+  _scene.instances[index].model = model;
+  _instances[index].model = model;
+  setNormalMatrix(model, _instances[index]);
+}
+
+std::string VisibilityBufferPass::getShaderSource() const {
+  if (_backendType == igl::BackendType::Metal) {
+    const auto index = [this](int offset) {
+      return std::to_string(_config.firstBufferIndex + offset);
+    };
+    std::string source = getMetalDeclarations(_config.firstBufferIndex);
+    if (_hasBindlessTextures) {
+      source += R"(
+struct BindlessTable {
+  metal::array<metal::texture2d<float>, 4096> textures;
+  metal::array<metal::sampler, 1024> samplers;
+};
+)";
+    }
+    source += std::string(R"(
+struct VisibilityBuffer {
+  constant VisibilityParams* params;
+  const device VisibilityInstance* instances;
+  const device uint* indices;
+  const device float* vertices;
+)") + (_hasBindlessTextures ? "  constant BindlessTable* table;\n" : "") +
+              "};\n" + kMetalResolve;
+    if (_hasBindlessTextures) {
+      source += R"(
+inline float4 textureBindless2DGrad(VisibilityBuffer vb,
+                                    uint textureId,
+                                    uint samplerId,
+                                    float2 uv,
+                                    float2 dx,
+                                    float2 dy) {
+  return vb.table->textures[textureId].sample(
+      vb.table->samplers[samplerId], uv, metal::gradient2d(dx, dy));
+}
+)";
+    }
+    return source +
+           "#define VISIBILITY_BUFFER_PARAMS constant VisibilityParams& visibilityParams "
+           "[[buffer(" +
+           index(kParamsOffset) +
+           ")]], const device VisibilityInstance* visibilityInstances [[buffer(" +
+           index(kInstancesOffset) + ")]], const device uint* visibilityIndices [[buffer(" +
+           index(kIndicesOffset) + ")]], const device float* visibilityVertices [[buffer(" +
+           index(kVerticesOffset) + ")]], metal::texture2d<uint> visibilityIds [[texture(" +
+           std::to_string(kTextureUnit) + ")]]" +
+           (_hasBindlessTextures ? std::string(", constant BindlessTable& visibilityBindlessTable "
+                                               "[[buffer(") +
+                                       kMetalBindlessTableIndex + ")]]"
+                                 : std::string()) +
+           "\n#define VISIBILITY_BUFFER_ARGS {&visibilityParams, visibilityInstances, "
+           "visibilityIndices, visibilityVertices" +
+           (_hasBindlessTextures ? ", &visibilityBindlessTable" : "") + "}\n";
+  }
+
+  const bool isVulkan = _backendType == igl::BackendType::Vulkan;
+  // extensions come before everything else
+  std::string source = !isVulkan && _hasBindlessTextures
+                           ? "#extension GL_ARB_bindless_texture : require\n"
+                           : "";
+  source += getGlslDeclarations(isVulkan, _config.firstBufferIndex);
+  source += isVulkan ? "layout(set = 0, binding = " + std::to_string(kTextureUnit) +
+                           ") uniform usampler2D visibilityIds;\n"
+                     : "uniform highp usampler2D visibilityIds;\n";
+  source += kGlslResolve;
+  if (_hasBindlessTextures) {
+    // the Vulkan tables are injected by the device, see enableDescriptorIndexing; OpenGL textures
+    // sample with their own sampler states, see opengl::BindlessTable
+    source += isVulkan ? R"(
+vec4 textureBindless2DGrad(uint textureId, uint samplerId, vec2 uv, vec2 dx, vec2 dy) {
+  return textureGrad(sampler2D(kTextures2D[nonuniformEXT(textureId)],
+                               kSamplers[nonuniformEXT(samplerId)]),
+                     uv,
+                     dx,
+                     dy);
+}
+)"
+                       : R"(
+layout(std430, binding = 7) readonly buffer BindlessTextures {
+  uvec2 kTextureHandles[];
+};
+vec4 textureBindless2DGrad(uint textureId, uint samplerId, vec2 uv, vec2 dx, vec2 dy) {
+  return textureGrad(sampler2D(kTextureHandles[textureId]), uv, dx, dy);
+}
+)";
+  }
+  return source;
+}
+
+void VisibilityBufferPass::setResolveShader(const std::string& source,
+                                            const std::string& fragmentEntryPoint,
+                                            igl::Result* outResult) {
+  std::unique_ptr<igl::IShaderStages> stages;
+  switch (_backendType) {
+  case igl::BackendType::Vulkan:
+    stages = igl::ShaderStagesCreator::fromModuleStringInput(_device,
+                                                             kVulkanResolveVertex,
+                                                             "main",
+                                                             "VisibilityBufferPass resolve (vert)",
+                                                             source.c_str(),
+                                                             fragmentEntryPoint.c_str(),
+                                                             "VisibilityBufferPass resolve (frag)",
+                                                             outResult);
+    break;
+  // @fb-only
+    // @fb-only
+  case igl::BackendType::Metal: {
+    // the fullscreen vertex function joins the library of the fragment function
+    const std::string library = source + kMetalResolveVertex;
+    stages = igl::ShaderStagesCreator::fromLibraryStringInput(_device,
+                                                              library.c_str(),
+                                                              "visibilityResolveVertex",
+                                                              fragmentEntryPoint.c_str(),
+                                                              "",
+                                                              outResult);
+    break;
+  }
+  case igl::BackendType::OpenGL: {
+    // OpenGL ES links stages of the same #version only
+    const std::string vertexSource =
+        glsl::getOpenGLVersion(_device.getShaderVersion(), true) + kOpenGLResolveVertex;
+    stages = igl::ShaderStagesCreator::fromModuleStringInput(_device,
+                                                             vertexSource.c_str(),
+                                                             "main",
+                                                             "",
+                                                             source.c_str(),
+                                                             fragmentEntryPoint.c_str(),
+                                                             "",
+                                                             outResult);
+    break;
+  }
+  }
+  _resolveStages = std::move(stages);
+  _resolvePipeline = nullptr;
+}
+
+bool VisibilityBufferPass::ensureTargets(const igl::Size& size) {
+  if (_visibilityTexture && _visibilityTexture->getSize().width == size.width &&
+      _visibilityTexture->getSize().height == size.height) {
+    return true;
+  }
+  const auto width = static_cast<size_t>(size.width);
+  const auto height = static_cast<size_t>(size.height);
+  igl::Result result;
+  auto desc = igl::TextureDesc::new2D(igl::TextureFormat::RG_UInt16,
+                                      width,
+                                      height,
+                                      igl::TextureDesc::TextureUsageBits::Attachment |
+                                          igl::TextureDesc::TextureUsageBits::Sampled,
+                                      "VisibilityBufferPass ids");
+  _visibilityTexture = _device.createTexture(desc, &result);
+  if (result.isOk()) {
+    desc = igl::TextureDesc::new2D(_config.depthFormat,
+                                   width,
+                                   height,
+                                   igl::TextureDesc::TextureUsageBits::Attachment |
+                                       igl::TextureDesc::TextureUsageBits::Sampled,
+                                   "VisibilityBufferPass depth");
+    desc.storage = igl::ResourceStorage::Private;
+    _depthTexture = _device.createTexture(desc, &result);
+  }
+  if (result.isOk()) {
+    igl::FramebufferDesc framebufferDesc;
+    framebufferDesc.colorAttachments[0].texture = _visibilityTexture;
+    framebufferDesc.depthAttachment.texture = _depthTexture;
+    framebufferDesc.debugName = "VisibilityBufferPass";
+    _visibilityFramebuffer = _device.createFramebuffer(framebufferDesc, &result);
+  }
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("Cannot create the visibility buffer: %s\n", result.message.c_str());
+    _visibilityTexture = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool VisibilityBufferPass::ensureResolvePipeline(const igl::IFramebuffer& target) {
+  const igl::TextureFormat colorFormat = target.getColorAttachment(0)->getFormat();
+  const auto depthAttachment = target.getDepthAttachment();
+  const igl::TextureFormat depthFormat =
+      depthAttachment ? depthAttachment->getFormat() : igl::TextureFormat::Invalid;
+  if (_resolvePipeline && _resolveColorFormat == colorFormat &&
+      _resolveDepthFormat == depthFormat) {
+    return true;
+  }
+  igl::RenderPipelineDesc desc;
+  desc.shaderStages = _resolveStages;
+  desc.targetDesc.colorAttachments.resize(1);
+  desc.targetDesc.colorAttachments[0].textureFormat = colorFormat;
+  desc.targetDesc.depthAttachmentFormat = depthFormat;
+  desc.fragmentUnitSamplerMap[kTextureUnit] = IGL_NAMEHANDLE("visibilityIds");
+  desc.cullMode = igl::CullMode::Disabled;
+  desc.debugName = IGL_NAMEHANDLE("VisibilityBufferPass: resolve");
+  igl::Result result;
+  _resolvePipeline = _device.createRenderPipeline(desc, &result);
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("Cannot create the resolve pipeline: %s\n", result.message.c_str());
+    _resolvePipeline = nullptr;
+    return false;
+  }
+  _resolveColorFormat = colorFormat;
+  _resolveDepthFormat = depthFormat;
+  return true;
+}
+
+void VisibilityBufferPass::bindSceneBuffers(igl::IRenderCommandEncoder& encoder,
+                                            uint8_t target) const {
+  const int first = _config.firstBufferIndex;
+  encoder.bindBuffer(first + kParamsOffset, target, _paramsBuffer, 0);
+  encoder.bindBuffer(first + kInstancesOffset, target, _instancesBuffer, 0);
+  encoder.bindBuffer(first + kIndicesOffset, target, _scene.indexBuffer, 0);
+  encoder.bindBuffer(first + kVerticesOffset, target, _scene.vertexBuffer, 0);
+  if (_scene.materialBuffer) {
+    encoder.bindBuffer(first + kMaterialsOffset, target, _scene.materialBuffer, 0);
+  }
+}
+
+void VisibilityBufferPass::render(igl::ICommandBuffer& commandBuffer,
+                                  const std::shared_ptr<igl::IFramebuffer>& target,
+                                  const float4x4& viewProjection,
+                                  const igl::RenderPassDesc* resolvePassDesc) {
+  if (!IGL_VERIFY(_geometryPipeline && target && _scene.vertexBuffer)) {
+    return;
+  }
+  IGL_ASSERT_MSG(_resolveStages, "setResolveShader() was not called");
+  const igl::Size size = target->getColorAttachment(0)->getSize();
+  if (!ensureTargets(size)) {
+    return;
+  }
+
+  // fragment coordinates start at the top of the viewport, except on OpenGL
+  const float flip = _backendType == igl::BackendType::OpenGL ? 1.0f : -1.0f;
+  VisibilityParams params = {};
+  params.viewProjection = viewProjection;
+  params.ndcScale[0] = 2.0f / size.width;
+  params.ndcScale[1] = flip * 2.0f / size.height;
+  params.ndcBias[0] = -1.0f;
+  params.ndcBias[1] = -flip;
+  params.numInstances = static_cast<uint32_t>(_instances.size());
+  _paramsBuffer->upload(&params, {sizeof(params), 0});
+  if (!_instances.empty()) {
+    _instancesBuffer->upload(_instances.data(),
+                             {_instances.size() * sizeof(VisibilityInstance), 0});
+  }
+
+  renderGeometry(commandBuffer, viewProjection);
+  renderResolve(commandBuffer, target, resolvePassDesc);
+}
+
+void VisibilityBufferPass::renderGeometry(igl::ICommandBuffer& commandBuffer,
+                                          const float4x4& viewProjection) {
+  igl::RenderPassDesc renderPass;
+  renderPass.colorAttachments.resize(1);
+  renderPass.colorAttachments[0].loadAction = igl::LoadAction::Clear;
+  renderPass.colorAttachments[0].storeAction = igl::StoreAction::Store;
+  renderPass.colorAttachments[0].clearColor = {0.0f, 0.0f, 0.0f, 0.0f};
+  renderPass.depthAttachment.loadAction = igl::LoadAction::Clear;
+  renderPass.depthAttachment.storeAction = igl::StoreAction::Store;
+  renderPass.depthAttachment.clearDepth = 1.0f;
+  auto encoder = commandBuffer.createRenderCommandEncoder(renderPass, _visibilityFramebuffer);
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("VisibilityBufferPass geometry");
+  const igl::Size size = _visibilityTexture->getSize();
+  encoder->bindViewport({0.0f, 0.0f, size.width, size.height, 0.0f, 1.0f});
+  encoder->bindScissorRect(
+      {0, 0, static_cast<uint32_t>(size.width), static_cast<uint32_t>(size.height)});
+  encoder->bindRenderPipelineState(_geometryPipeline);
+  encoder->bindDepthStencilState(_depthState);
+  // storage buffers are visible to all graphics stages on Vulkan, and an OpenGL buffer bound for
+  // the vertex stage would be bound as a vertex buffer
+  const int first = _config.firstBufferIndex;
+  const uint8_t target = _backendType == igl::BackendType::Vulkan ? igl::BindTarget::kAllGraphics
+                         : _backendType == igl::BackendType::Metal ? igl::BindTarget::kVertex
+                                                                   : igl::BindTarget::kFragment;
+  encoder->bindBuffer(first + kIndicesOffset, target, _scene.indexBuffer, 0);
+  encoder->bindBuffer(first + kVerticesOffset, target, _scene.vertexBuffer, 0);
+
+  for (size_t i = 0; i != _instances.size(); i++) {
+    const VisibilityMeshInstance& mesh = _scene.instances[i];
+    if (mesh.numIndices == 0) {
+      continue;
+    }
+    GeometryConstants constants = {};
+    constants.modelViewProjection = multiply(viewProjection, mesh.model);
+    constants.firstIndex = mesh.firstIndex;
+    constants.baseVertex = mesh.baseVertex;
+    constants.triangleBase = _instances[i].firstTriangle + 1;
+    encoder->bindPushConstants(&constants, sizeof(constants));
+    // the vertex shader fetches the indices itself
+    encoder->draw(igl::PrimitiveType::Triangle, 0, mesh.numIndices);
+  }
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+void VisibilityBufferPass::renderResolve(igl::ICommandBuffer& commandBuffer,
+                                         const std::shared_ptr<igl::IFramebuffer>& target,
+                                         const igl::RenderPassDesc* resolvePassDesc) {
+  if (!_resolveStages || !ensureResolvePipeline(*target)) {
+    return;
+  }
+  igl::RenderPassDesc defaultRenderPassDesc;
+  defaultRenderPassDesc.colorAttachments.resize(1);
+  defaultRenderPassDesc.colorAttachments[0].loadAction = igl::LoadAction::Clear;
+  defaultRenderPassDesc.colorAttachments[0].storeAction = igl::StoreAction::Store;
+  defaultRenderPassDesc.colorAttachments[0].clearColor = {0.0, 0.0, 0.0, 1.0};
+  defaultRenderPassDesc.depthAttachment.loadAction = igl::LoadAction::Clear;
+  defaultRenderPassDesc.depthAttachment.clearDepth = 1.0f;
+  auto encoder = commandBuffer.createRenderCommandEncoder(
+      resolvePassDesc ? *resolvePassDesc : defaultRenderPassDesc, target);
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("VisibilityBufferPass resolve");
+  const igl::Size size = _visibilityTexture->getSize();
+  encoder->bindViewport({0.0f, 0.0f, size.width, size.height, 0.0f, 1.0f});
+  encoder->bindScissorRect(
+      {0, 0, static_cast<uint32_t>(size.width), static_cast<uint32_t>(size.height)});
+  encoder->bindRenderPipelineState(_resolvePipeline);
+  encoder->bindDepthStencilState(_alwaysPassState);
+  encoder->bindTexture(kTextureUnit, igl::BindTarget::kFragment, _visibilityTexture.get());
+  encoder->bindSamplerState(kTextureUnit, igl::BindTarget::kFragment, _sampler.get());
+  bindSceneBuffers(*encoder,
+                   _backendType == igl::BackendType::Vulkan ? igl::BindTarget::kAllGraphics
+                                                            : igl::BindTarget::kFragment);
+  encoder->draw(igl::PrimitiveType::Triangle, 0, 3);
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+} // namespace renderpass
+} // namespace iglu
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace renderpass {
+
+/// The vertex layout of visibility buffer scenes. Both passes fetch the vertices from a storage
+/// buffer, so there is no vertex input state.
+struct VisibilityVertex {
+  float position[3];
+  float normal[3];
+  float uv[2];
+};
+static_assert(sizeof(VisibilityVertex) == 32, "VisibilityVertex must match the shader layout");
+
+/// A mesh of the scene buffers placed in the world.
+struct VisibilityMeshInstance {
+  simdtypes::float4x4 model = simdtypes::float4x4(1.0f);
+  // a range of triangles of the index buffer; the indices are offset by baseVertex
+  uint32_t firstIndex = 0;
+  uint32_t numIndices = 0;
+  int32_t baseVertex = 0;
+  // the index of the instance's material in the material buffer
+  uint32_t materialIndex = 0;
+};
+
+struct VisibilitySceneDesc {
+  // VisibilityVertex; needs BufferTypeBits::Storage
+  std::shared_ptr<igl::IBuffer> vertexBuffer;
+  // 32-bit indices of triangle lists; needs BufferTypeBits::Storage
+  std::shared_ptr<igl::IBuffer> indexBuffer;
+  // laid out by the application, read by its resolve shader; needs BufferTypeBits::Storage
+  std::shared_ptr<igl::IBuffer> materialBuffer;
+  std::vector<VisibilityMeshInstance> instances;
+};
+
+/// An instance as read by the resolve pass; matches the std430 and Metal layouts of
+/// VisibilityInstance.
+struct VisibilityInstance {
+  simdtypes::float4x4 model;
+  // the inverse transpose of the upper 3x3 of model, one column per element
+  simdtypes::float4 normalMatrix[3];
+  uint32_t firstIndex;
+  int32_t baseVertex;
+  uint32_t materialIndex;
+  // the sum of the triangles of the instances before this one
+  uint32_t firstTriangle;
+};
+static_assert(sizeof(VisibilityInstance) == 128, "VisibilityInstance must match the shader layout");
+
+struct VisibilityBufferConfig {
+  igl::TextureFormat depthFormat = igl::TextureFormat::Z_UNorm24;
+  // of the geometry pass; front faces wind counterclockwise
+  igl::CullMode cullMode = igl::CullMode::Back;
+  // the first of the 5 storage buffer indices of the resolve pass; on OpenGL, the first shader
+  // storage buffer binding point. The materials are at firstBufferIndex + 4.
+  int firstBufferIndex = 0;
+};
+
+/// Converts `instances` into the layout of the resolve pass. Returns the number of triangles of
+/// all instances.
+uint64_t buildVisibilityInstances(const std::vector<VisibilityMeshInstance>& instances,
+                                  std::vector<VisibilityInstance>& outInstances);
+
+/// Returns the instance holding scene triangle `triangle`, like the resolve pass: the last one
+/// whose firstTriangle is not above it.
+uint32_t findVisibilityInstance(const VisibilityInstance* instances,
+                                uint32_t numInstances,
+                                uint32_t triangle);
+
+/// Computes the perspective correct barycentrics of the point at `ndc` in the triangle with the
+/// clip space positions `clip`, like the resolve pass, together with their change from one pixel
+/// to the next along x and y. `ndcPerPixel` is the change of the normalized device coordinates
+/// from one pixel to the next.
+void computeVisibilityBarycentrics(const simdtypes::float4 clip[3],
+                                   const float ndc[2],
+                                   const float ndcPerPixel[2],
+                                   simdtypes::float3& outBarycentrics,
+                                   simdtypes::float3& outDx,
+                                   simdtypes::float3& outDy);
+
+/**
+ * @brief A deferred "visibility buffer" alternative to ForwardRenderPass for scenes with a lot of
+ * overdraw: the materials are shaded once per pixel.
+ *
+ * The geometry pass renders all instances of the scene with a trivial shader which writes the
+ * index of the visible scene triangle into a 32-bit visibility texture (RG_UInt16). It pulls the
+ * vertices from the storage buffers and derives the triangle from the vertex index, so it does not
+ * depend on gl_PrimitiveID, which Vulkan only has with geometry shaders. The resolve
+ * pass then draws a fullscreen triangle into the target: for each pixel, it finds the instance and
+ * triangle, fetches the vertices from the index and vertex buffers bound as storage buffers,
+ * computes the barycentrics and their screen space derivatives analytically and calls the
+ * application's material shading with the interpolated attributes. Materials are indexed in the
+ * application's material buffer and sample their textures through the bindless tables of the
+ * backends, so the whole scene resolves in one draw.
+ *
+ * The fragment shader of the resolve pass is written by the application. It includes
+ * getShaderSource() after its #version (OpenGL) and loads the visible triangle:
+ *
+ *   VISIBILITY_MATERIALS_BUFFER readonly buffer Materials {
+ *     Material materials[];
+ *   };
+ *   layout(location = 0) out vec4 outColor;
+ *   void main() {
+ *     VisibilitySample s;
+ *     if (!loadVisibilitySample(gl_FragCoord.xy, s)) {
+ *       discard;
+ *     }
+ *     Material m = materials[s.materialIndex];
+ *     outColor = textureBindless2DGrad(m.textureId, m.samplerId, s.uv, s.uvDx, s.uvDy);
+ *   }
+ *
+ * textureBindless2DGrad() is declared with DeviceFeatures::TextureBindless; on Vulkan, it needs
+ * VulkanContextConfig::enableDescriptorIndexing. On Metal, the functions take a VisibilityBuffer
+ * argument first, created in the fragment function with VISIBILITY_BUFFER_ARGS from the
+ * parameters declared by VISIBILITY_BUFFER_PARAMS, loadVisibilitySample() also takes the
+ * visibilityIds parameter, and the materials are a fragment function parameter at
+ * [[buffer(VISIBILITY_MATERIALS_INDEX)]]. The fragment function gets the position of the pixel
+ * from a float4 [[position]] parameter.
+ *
+ * Requires Vulkan, Metal, or OpenGL with DeviceFeatures::Compute; the GLSL requires #version 430
+ * or 310 es.
+ *
+ * Usage per frame:
+ *   pass.render(*commandBuffer, framebuffer, viewProjection);
+ */
+class VisibilityBufferPass final {
+ public:
+  VisibilityBufferPass(igl::IDevice& device, VisibilityBufferConfig config, igl::Result* outResult);
+  ~VisibilityBufferPass();
+
+  VisibilityBufferPass(const VisibilityBufferPass&) = delete;
+  VisibilityBufferPass& operator=(const VisibilityBufferPass&) = delete;
+
+  /// Replaces the scene. The buffers are retained and must not be changed while they are in use.
+  void setScene(VisibilitySceneDesc scene, igl::Result* outResult);
+  /// Moves an instance of the scene
+  void setInstanceModel(size_t index, const simdtypes::float4x4& model);
+
+  /// Declarations and functions for the resolve fragment shader on this device
+  [[nodiscard]] std::string getShaderSource() const;
+  /// Sets the fragment shader of the resolve pass: the GLSL source of the fragment shader, or on
+  /// Metal the library source holding the fragment function `fragmentEntryPoint`.
+  void setResolveShader(const std::string& source,
+                        const std::string& fragmentEntryPoint,
+                        igl::Result* outResult);
+
+  /// Renders the geometry pass, then resolves the materials into `target`, which is cleared
+  /// unless `resolvePassDesc` says otherwise. Must be called outside of render passes.
+  void render(igl::ICommandBuffer& commandBuffer,
+              const std::shared_ptr<igl::IFramebuffer>& target,
+              const simdtypes::float4x4& viewProjection,
+              const igl::RenderPassDesc* resolvePassDesc = nullptr);
+
+  /// The visibility texture and depth of the last render(), e.g. to draw translucent surfaces with
+  /// a ForwardRenderPass afterwards
+  [[nodiscard]] const std::shared_ptr<igl::ITexture>& getVisibilityTexture() const {
+    return _visibilityTexture;
+  }
+  [[nodiscard]] const std::shared_ptr<igl::ITexture>& getDepthTexture() const {
+    return _depthTexture;
+  }
+  [[nodiscard]] uint64_t getNumTriangles() const {
+    return _numTriangles;
+  }
+
+ private:
+  bool ensureTargets(const igl::Size& size);
+  bool ensureResolvePipeline(const igl::IFramebuffer& target);
+  void renderGeometry(igl::ICommandBuffer& commandBuffer,
+                      const simdtypes::float4x4& viewProjection);
+  void renderResolve(igl::ICommandBuffer& commandBuffer,
+                     const std::shared_ptr<igl::IFramebuffer>& target,
+                     const igl::RenderPassDesc* resolvePassDesc);
+  void bindSceneBuffers(igl::IRenderCommandEncoder& encoder, uint8_t target) const;
+
+ private:
+  igl::IDevice& _device;
+  const VisibilityBufferConfig _config;
+  igl::BackendType _backendType;
+  bool _hasBindlessTextures = false;
+
+  VisibilitySceneDesc _scene;
+  std::vector<VisibilityInstance> _instances;
+  uint64_t _numTriangles = 0;
+
+  std::shared_ptr<igl::IBuffer> _paramsBuffer;
+  std::shared_ptr<igl::IBuffer> _instancesBuffer;
+
+  std::shared_ptr<igl::IRenderPipelineState> _geometryPipeline;
+  std::shared_ptr<igl::IDepthStencilState> _depthState;
+  std::shared_ptr<igl::IDepthStencilState> _alwaysPassState;
+  std::shared_ptr<igl::ITexture> _visibilityTexture;
+  std::shared_ptr<igl::ITexture> _depthTexture;
+  std::shared_ptr<igl::IFramebuffer> _visibilityFramebuffer;
+  std::shared_ptr<igl::ISamplerState> _sampler;
+
+  std::shared_ptr<igl::IShaderStages> _resolveStages;
+  std::shared_ptr<igl::IRenderPipelineState> _resolvePipeline;
+  igl::TextureFormat _resolveColorFormat = igl::TextureFormat::Invalid;
+  igl::TextureFormat _resolveDepthFormat = igl::TextureFormat::Invalid;
+};
+
+} // namespace renderpass
+} // namespace iglu
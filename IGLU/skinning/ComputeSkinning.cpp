@@ -0,0 +1,571 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "ComputeSkinning.h"
+
+#include <IGLU/glsl/StorageBuffers.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <igl/ShaderCreator.h>
+#include <string>
+
+namespace iglu {
+namespace skinning {
+
+namespace {
+
+constexpr uint32_t kThreadgroupSize = 64;
+
+// OpenGL binds the storage blocks of compute shaders by their resource index, which follows the
+// names of the blocks
+constexpr size_t kFrameIndex = 0;
+constexpr size_t kMeshIndex = 1;
+constexpr size_t kVerticesIndex = 2;
+
+// A packed vertex: the position, the normal, 4 16-bit joint indices, 4 16-bit unorm weights, the
+// first word of its morph deltas and their number. A packed delta: the morph target, then the
+// position and normal offsets.
+const char kGlslBody[] = R"(
+FRAME_BUFFER readonly buffer FrameData {
+  uint frameData[];
+};
+MESH_BUFFER readonly buffer MeshData {
+  uint meshData[];
+};
+VERTICES_BUFFER writeonly buffer SkinnedVertices {
+  float skinnedVertices[];
+};
+
+vec3 loadMeshVec3(uint word) {
+  return uintBitsToFloat(uvec3(meshData[word], meshData[word + 1u], meshData[word + 2u]));
+}
+vec4 loadFrameVec4(uint word) {
+  return uintBitsToFloat(uvec4(
+      frameData[word], frameData[word + 1u], frameData[word + 2u], frameData[word + 3u]));
+}
+
+void main() {
+  uint id = gl_GlobalInvocationID.x;
+  if (id >= frameData[1]) {
+    return;
+  }
+  // the instance of the vertex: the last one starting at or before it
+  uint first = 0u;
+  uint count = frameData[0];
+  while (count > 0u) {
+    uint halfCount = count / 2u;
+    if (frameData[4u + 4u * (first + halfCount)] <= id) {
+      first += halfCount + 1u;
+      count -= halfCount + 1u;
+    } else {
+      count = halfCount;
+    }
+  }
+  uint record = 4u + 4u * (first - 1u);
+  uint v = (frameData[record + 1u] + id - frameData[record]) * 12u;
+  uint jointWord = frameData[record + 2u];
+  uint weightWord = frameData[record + 3u];
+
+  vec3 position = loadMeshVec3(v);
+  vec3 normal = loadMeshVec3(v + 3u);
+  uint firstDelta = meshData[v + 10u];
+  uint numDeltas = meshData[v + 11u];
+  for (uint i = 0u; i < numDeltas; i++) {
+    uint d = firstDelta + 7u * i;
+    float w = uintBitsToFloat(frameData[weightWord + meshData[d]]);
+    position += w * loadMeshVec3(d + 1u);
+    normal += w * loadMeshVec3(d + 4u);
+  }
+
+  uvec4 joints = uvec4(meshData[v + 6u] & 0xFFFFu,
+                       meshData[v + 6u] >> 16u,
+                       meshData[v + 7u] & 0xFFFFu,
+                       meshData[v + 7u] >> 16u);
+  vec4 weights = vec4(unpackUnorm2x16(meshData[v + 8u]), unpackUnorm2x16(meshData[v + 9u]));
+  vec3 skinnedPosition = vec3(0.0);
+  vec3 skinnedNormal = vec3(0.0);
+  for (int j = 0; j < 4; j++) {
+    if (weights[j] > 0.0) {
+      uint m = jointWord + 12u * joints[j];
+      vec4 r0 = loadFrameVec4(m);
+      vec4 r1 = loadFrameVec4(m + 4u);
+      vec4 r2 = loadFrameVec4(m + 8u);
+      vec4 p = vec4(position, 1.0);
+      skinnedPosition += weights[j] * vec3(dot(r0, p), dot(r1, p), dot(r2, p));
+      skinnedNormal +=
+          weights[j] * vec3(dot(r0.xyz, normal), dot(r1.xyz, normal), dot(r2.xyz, normal));
+    }
+  }
+  skinnedNormal = normalize(skinnedNormal);
+
+  uint o = id * 6u;
+  skinnedVertices[o] = skinnedPosition.x;
+  skinnedVertices[o + 1u] = skinnedPosition.y;
+  skinnedVertices[o + 2u] = skinnedPosition.z;
+  skinnedVertices[o + 3u] = skinnedNormal.x;
+  skinnedVertices[o + 4u] = skinnedNormal.y;
+  skinnedVertices[o + 5u] = skinnedNormal.z;
+}
+)";
+
+std::string getGlslSource(bool isVulkan) {
+  return glsl::computeShaderPrologue(isVulkan, kThreadgroupSize) +
+         glsl::defineStorageBuffer("FRAME_BUFFER", isVulkan, kFrameIndex) +
+         glsl::defineStorageBuffer("MESH_BUFFER", isVulkan, kMeshIndex) +
+         glsl::defineStorageBuffer("VERTICES_BUFFER", isVulkan, kVerticesIndex) + kGlslBody;
+}
+
+const char kMetalSource[] = R"(
+#include <metal_stdlib>
+using namespace metal;
+
+inline float3 loadMeshFloat3(const device uint* meshData, uint word) {
+  return as_type<float3>(uint3(meshData[word], meshData[word + 1], meshData[word + 2]));
+}
+inline float4 loadFrameFloat4(const device uint* frameData, uint word) {
+  return as_type<float4>(
+      uint4(frameData[word], frameData[word + 1], frameData[word + 2], frameData[word + 3]));
+}
+
+kernel void skinVertices(const device uint* frameData [[buffer(0)]],
+                         const device uint* meshData [[buffer(1)]],
+                         device float* skinnedVertices [[buffer(2)]],
+                         uint id [[thread_position_in_grid]]) {
+  if (id >= frameData[1]) {
+    return;
+  }
+  // the instance of the vertex: the last one starting at or before it
+  uint first = 0;
+  uint count = frameData[0];
+  while (count > 0) {
+    const uint halfCount = count / 2;
+    if (frameData[4 + 4 * (first + halfCount)] <= id) {
+      first += halfCount + 1;
+      count -= halfCount + 1;
+    } else {
+      count = halfCount;
+    }
+  }
+  const uint record = 4 + 4 * (first - 1);
+  const uint v = (frameData[record + 1] + id - frameData[record]) * 12;
+  const uint jointWord = frameData[record + 2];
+  const uint weightWord = frameData[record + 3];
+
+  float3 position = loadMeshFloat3(meshData, v);
+  float3 normal = loadMeshFloat3(meshData, v + 3);
+  const uint firstDelta = meshData[v + 10];
+  const uint numDeltas = meshData[v + 11];
+  for (uint i = 0; i < numDeltas; i++) {
+    const uint d = firstDelta + 7 * i;
+    const float w = as_type<float>(frameData[weightWord + meshData[d]]);
+    position += w * loadMeshFloat3(meshData, d + 1);
+    normal += w * loadMeshFloat3(meshData, d + 4);
+  }
+
+  const uint4 joints = uint4(meshData[v + 6] & 0xFFFF,
+                             meshData[v + 6] >> 16,
+                             meshData[v + 7] & 0xFFFF,
+                             meshData[v + 7] >> 16);
+  const float4 weights = float4(unpack_unorm2x16_to_float(meshData[v + 8]),
+                                unpack_unorm2x16_to_float(meshData[v + 9]));
+  float3 skinnedPosition = float3(0.0);
+  float3 skinnedNormal = float3(0.0);
+  for (int j = 0; j < 4; j++) {
+    if (weights[j] > 0.0) {
+      const uint m = jointWord + 12 * joints[j];
+      const float4 r0 = loadFrameFloat4(frameData, m);
+      const float4 r1 = loadFrameFloat4(frameData, m + 4);
+      const float4 r2 = loadFrameFloat4(frameData, m + 8);
+      const float4 p = float4(position, 1.0);
+      skinnedPosition += weights[j] * float3(dot(r0, p), dot(r1, p), dot(r2, p));
+      skinnedNormal +=
+          weights[j] * float3(dot(r0.xyz, normal), dot(r1.xyz, normal), dot(r2.xyz, normal));
+    }
+  }
+  skinnedNormal = normalize(skinnedNormal);
+
+  const uint o = id * 6;
+  skinnedVertices[o] = skinnedPosition.x;
+  skinnedVertices[o + 1] = skinnedPosition.y;
+  skinnedVertices[o + 2] = skinnedPosition.z;
+  skinnedVertices[o + 3] = skinnedNormal.x;
+  skinnedVertices[o + 4] = skinnedNormal.y;
+  skinnedVertices[o + 5] = skinnedNormal.z;
+}
+)";
+
+std::shared_ptr<igl::IBuffer> createBuffer(igl::IDevice& device,
+                                           igl::BufferDesc::BufferType type,
+                                           const void* data,
+                                           size_t length,
+                                           bool isPerFrame,
+                                           const char* debugName,
+                                           igl::Result* outResult) {
+  igl::BufferDesc desc(type, data, length, igl::ResourceStorage::Shared);
+  if (isPerFrame && device.hasFeature(igl::DeviceFeatures::BufferRing)) {
+    // skin() uploads the joint palettes and morph weights of every frame
+    desc.hint |= igl::BufferDesc::BufferAPIHintBits::Ring;
+  }
+  desc.debugName = debugName;
+  return device.createBuffer(desc, outResult);
+}
+
+uint32_t toWord(float value) {
+  uint32_t word = 0;
+  std::memcpy(&word, &value, sizeof(word));
+  return word;
+}
+
+float toFloat(uint32_t word) {
+  float value = 0.0f;
+  std::memcpy(&value, &word, sizeof(value));
+  return value;
+}
+
+// as packUnorm2x16() and unpackUnorm2x16()
+uint32_t packUnorm16(float value) {
+  return static_cast<uint32_t>(std::round(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+float unpackUnorm16(uint32_t bits) {
+  return static_cast<float>(bits & 0xFFFF) / 65535.0f;
+}
+
+} // namespace
+
+igl::Result packSkinnedMeshes(const std::vector<SkinnedMeshDesc>& meshes,
+                              std::vector<uint32_t>& outWords,
+                              std::vector<uint32_t>& outFirstVertices) {
+  size_t numVertices = 0;
+  size_t numDeltas = 0;
+  outFirstVertices.resize(meshes.size());
+  for (size_t i = 0; i != meshes.size(); i++) {
+    outFirstVertices[i] = static_cast<uint32_t>(numVertices);
+    numVertices += meshes[i].vertices.size();
+    for (const MorphTargetDesc& target : meshes[i].morphTargets) {
+      numDeltas += target.deltas.size();
+    }
+  }
+  const size_t numWords = numVertices * kWordsPerVertex + numDeltas * kWordsPerDelta;
+  if (numWords > UINT32_MAX) {
+    return igl::Result(igl::Result::Code::ArgumentOutOfRange, "The skinned meshes are too large");
+  }
+  outWords.assign(numWords, 0);
+
+  uint32_t deltaWord = static_cast<uint32_t>(numVertices * kWordsPerVertex);
+  std::vector<uint32_t> vertexDeltas;
+  for (size_t i = 0; i != meshes.size(); i++) {
+    const SkinnedMeshDesc& mesh = meshes[i];
+    // the deltas are grouped by vertex, so each vertex gathers its own
+    vertexDeltas.assign(mesh.vertices.size() + 1, 0);
+    for (const MorphTargetDesc& target : mesh.morphTargets) {
+      for (const MorphDelta& delta : target.deltas) {
+        if (delta.vertex >= mesh.vertices.size()) {
+          return igl::Result(igl::Result::Code::ArgumentOutOfRange,
+                             "Invalid vertex of a morph delta");
+        }
+        vertexDeltas[delta.vertex + 1]++;
+      }
+    }
+    for (size_t v = 0; v != mesh.vertices.size(); v++) {
+      vertexDeltas[v + 1] += vertexDeltas[v];
+    }
+
+    for (size_t v = 0; v != mesh.vertices.size(); v++) {
+      const SkinningVertex& vertex = mesh.vertices[v];
+      uint32_t* words = outWords.data() + (outFirstVertices[i] + v) * kWordsPerVertex;
+      for (int c = 0; c != 3; c++) {
+        words[c] = toWord(vertex.position[c]);
+        words[3 + c] = toWord(vertex.normal[c]);
+      }
+      float weightSum = 0.0f;
+      for (int j = 0; j != 4; j++) {
+        if (vertex.weights[j] > 0.0f && vertex.joints[j] >= mesh.numJoints) {
+          return igl::Result(igl::Result::Code::ArgumentOutOfRange,
+                             "Invalid joint index of a vertex");
+        }
+        weightSum += std::max(vertex.weights[j], 0.0f);
+      }
+      if (weightSum <= 0.0f) {
+        return igl::Result(igl::Result::Code::ArgumentInvalid, "A vertex has no joint weights");
+      }
+      uint32_t weights[4];
+      for (int j = 0; j != 4; j++) {
+        weights[j] = packUnorm16(std::max(vertex.weights[j], 0.0f) / weightSum);
+      }
+      words[6] = vertex.joints[0] | (static_cast<uint32_t>(vertex.joints[1]) << 16);
+      words[7] = vertex.joints[2] | (static_cast<uint32_t>(vertex.joints[3]) << 16);
+      words[8] = weights[0] | (weights[1] << 16);
+      words[9] = weights[2] | (weights[3] << 16);
+      words[10] = deltaWord + vertexDeltas[v] * kWordsPerDelta;
+      words[11] = vertexDeltas[v + 1] - vertexDeltas[v];
+    }
+
+    // in the order of the targets for each vertex
+    for (uint32_t t = 0; t != mesh.morphTargets.size(); t++) {
+      for (const MorphDelta& delta : mesh.morphTargets[t].deltas) {
+        uint32_t* words =
+            outWords.data() + deltaWord + vertexDeltas[delta.vertex]++ * kWordsPerDelta;
+        words[0] = t;
+        for (int c = 0; c != 3; c++) {
+          words[1 + c] = toWord(delta.position[c]);
+          words[4 + c] = toWord(delta.normal[c]);
+        }
+      }
+    }
+    deltaWord += vertexDeltas[mesh.vertices.size()] * kWordsPerDelta;
+  }
+  return igl::Result();
+}
+
+void packJointMatrix(const simdtypes::float4x4& matrix, float* outFloats) {
+  for (int row = 0; row != 3; row++) {
+    for (int column = 0; column != 4; column++) {
+      outFloats[4 * row + column] = matrix.columns[column][row];
+    }
+  }
+}
+
+void skinVertex(const uint32_t* meshWords,
+                uint32_t vertex,
+                const float* joints,
+                const float* morphWeights,
+                SkinnedVertex& outVertex) {
+  const uint32_t* words = meshWords + static_cast<size_t>(vertex) * kWordsPerVertex;
+  float position[3];
+  float normal[3];
+  for (int c = 0; c != 3; c++) {
+    position[c] = toFloat(words[c]);
+    normal[c] = toFloat(words[3 + c]);
+  }
+  for (uint32_t i = 0; i != words[11]; i++) {
+    const uint32_t* delta = meshWords + words[10] + i * kWordsPerDelta;
+    const float w = morphWeights[delta[0]];
+    for (int c = 0; c != 3; c++) {
+      position[c] += w * toFloat(delta[1 + c]);
+      normal[c] += w * toFloat(delta[4 + c]);
+    }
+  }
+
+  const uint32_t jointIndices[4] = {
+      words[6] & 0xFFFF, words[6] >> 16, words[7] & 0xFFFF, words[7] >> 16};
+  const float weights[4] = {unpackUnorm16(words[8]),
+                            unpackUnorm16(words[8] >> 16),
+                            unpackUnorm16(words[9]),
+                            unpackUnorm16(words[9] >> 16)};
+  float skinnedPosition[3] = {};
+  float skinnedNormal[3] = {};
+  for (int j = 0; j != 4; j++) {
+    if (weights[j] <= 0.0f) {
+      continue;
+    }
+    const float* m = joints + static_cast<size_t>(jointIndices[j]) * kFloatsPerJoint;
+    for (int row = 0; row != 3; row++) {
+      const float* r = m + 4 * row;
+      skinnedPosition[row] +=
+          weights[j] * (r[0] * position[0] + r[1] * position[1] + r[2] * position[2] + r[3]);
+      skinnedNormal[row] += weights[j] * (r[0] * normal[0] + r[1] * normal[1] + r[2] * normal[2]);
+    }
+  }
+  const float length = std::sqrt(skinnedNormal[0] * skinnedNormal[0] +
+                                 skinnedNormal[1] * skinnedNormal[1] +
+                                 skinnedNormal[2] * skinnedNormal[2]);
+  const float invLength = length > 0.0f ? 1.0f / length : 0.0f;
+  for (int c = 0; c != 3; c++) {
+    outVertex.position[c] = skinnedPosition[c];
+    outVertex.normal[c] = skinnedNormal[c] * invLength;
+  }
+}
+
+ComputeSkinning::ComputeSkinning(igl::IDevice& device,
+                                 const std::vector<SkinnedMeshDesc>& meshes,
+                                 const std::vector<uint32_t>& instanceMeshes,
+                                 igl::Result* outResult) :
+  frameWords_(kHeaderWords, 0) {
+  if (meshes.empty() || instanceMeshes.empty()) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "No meshes or instances to skin");
+    return;
+  }
+  usesCompute_ = device.hasFeature(igl::DeviceFeatures::Compute);
+
+  std::vector<uint32_t> meshWords;
+  std::vector<uint32_t> firstVertices;
+  igl::Result result = packSkinnedMeshes(meshes, meshWords, firstVertices);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  // the records, then the joint matrices and morph weights of each instance
+  const uint32_t numInstances = static_cast<uint32_t>(instanceMeshes.size());
+  size_t numWords = kHeaderWords + static_cast<size_t>(kWordsPerInstance) * numInstances;
+  size_t numVertices = 0;
+  instances_.resize(numInstances);
+  frameWords_.resize(numWords);
+  for (uint32_t i = 0; i != numInstances; i++) {
+    if (!IGL_VERIFY(instanceMeshes[i] < meshes.size())) {
+      igl::Result::setResult(
+          outResult, igl::Result::Code::ArgumentOutOfRange, "Invalid mesh index of an instance");
+      return;
+    }
+    const SkinnedMeshDesc& mesh = meshes[instanceMeshes[i]];
+    instances_[i] = {mesh.numJoints, static_cast<uint32_t>(mesh.morphTargets.size())};
+    uint32_t* record = frameWords_.data() + kHeaderWords + kWordsPerInstance * i;
+    record[0] = static_cast<uint32_t>(numVertices);
+    record[1] = firstVertices[instanceMeshes[i]];
+    record[2] = static_cast<uint32_t>(numWords);
+    record[3] = static_cast<uint32_t>(numWords + mesh.numJoints * kFloatsPerJoint);
+    numWords += mesh.numJoints * kFloatsPerJoint + mesh.morphTargets.size();
+    numVertices += mesh.vertices.size();
+  }
+  if (numWords > UINT32_MAX || numVertices * sizeof(SkinnedVertex) > UINT32_MAX) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentOutOfRange, "Too many instances to skin");
+    return;
+  }
+  frameWords_[0] = numInstances;
+  frameWords_[1] = static_cast<uint32_t>(numVertices);
+  frameWords_.resize(numWords, 0);
+  for (uint32_t i = 0; i != numInstances; i++) {
+    const std::vector<simdtypes::float4x4> identities(instances_[i].numJoints,
+                                                      simdtypes::float4x4(1.0f));
+    setJointMatrices(i, identities.data());
+  }
+
+  vertexBuffer_ = createBuffer(device,
+                               usesCompute_ ? igl::BufferDesc::BufferTypeBits::Vertex |
+                                                  igl::BufferDesc::BufferTypeBits::Storage
+                                            : igl::BufferDesc::BufferTypeBits::Vertex,
+                               nullptr,
+                               numVertices * sizeof(SkinnedVertex),
+                               false,
+                               "ComputeSkinning vertices",
+                               &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+  if (!usesCompute_) {
+    meshWords_ = std::move(meshWords);
+    vertices_.resize(numVertices);
+    igl::Result::setOk(outResult);
+    return;
+  }
+
+  meshBuffer_ = createBuffer(device,
+                             igl::BufferDesc::BufferTypeBits::Storage,
+                             meshWords.data(),
+                             meshWords.size() * sizeof(uint32_t),
+                             false,
+                             "ComputeSkinning meshes",
+                             &result);
+  if (result.isOk()) {
+    frameBuffer_ = createBuffer(device,
+                                igl::BufferDesc::BufferTypeBits::Storage,
+                                nullptr,
+                                frameWords_.size() * sizeof(uint32_t),
+                                true,
+                                "ComputeSkinning frame",
+                                &result);
+  }
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  const auto backendType = device.getBackendType();
+  const std::string glslSource = getGlslSource(backendType == igl::BackendType::Vulkan);
+  const bool isMetal = backendType == igl::BackendType::Metal;
+  std::shared_ptr<igl::IShaderStages> stages =
+      igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                      isMetal ? kMetalSource : glslSource.c_str(),
+                                                      isMetal ? "skinVertices" : "main",
+                                                      "ComputeSkinning",
+                                                      &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return;
+  }
+
+  igl::ComputePipelineDesc desc;
+  desc.shaderStages = std::move(stages);
+  desc.buffersMap[kFrameIndex] = igl::genNameHandle("FrameData");
+  desc.buffersMap[kMeshIndex] = igl::genNameHandle("MeshData");
+  desc.buffersMap[kVerticesIndex] = igl::genNameHandle("SkinnedVertices");
+  desc.debugName = "ComputeSkinning";
+  pipelineState_ = device.createComputePipeline(desc, outResult);
+}
+
+void ComputeSkinning::setJointMatrices(uint32_t instance, const simdtypes::float4x4* matrices) {
+  if (!IGL_VERIFY(instance < instances_.size())) {
+    return;
+  }
+  uint32_t* words =
+      frameWords_.data() + frameWords_[kHeaderWords + kWordsPerInstance * instance + 2];
+  float joint[kFloatsPerJoint];
+  for (uint32_t j = 0; j != instances_[instance].numJoints; j++) {
+    packJointMatrix(matrices[j], joint);
+    std::memcpy(words + j * kFloatsPerJoint, joint, sizeof(joint));
+  }
+}
+
+void ComputeSkinning::setMorphWeights(uint32_t instance, const float* weights) {
+  if (!IGL_VERIFY(instance < instances_.size())) {
+    return;
+  }
+  std::memcpy(frameWords_.data() + frameWords_[kHeaderWords + kWordsPerInstance * instance + 3],
+              weights,
+              instances_[instance].numMorphTargets * sizeof(float));
+}
+
+void ComputeSkinning::skin(igl::ICommandBuffer& commandBuffer) {
+  const uint32_t numVertices = getNumVertices();
+  if (!IGL_VERIFY(vertexBuffer_) || numVertices == 0) {
+    return;
+  }
+  if (!usesCompute_) {
+    const auto* frameFloats = reinterpret_cast<const float*>(frameWords_.data());
+    for (uint32_t i = 0; i != instances_.size(); i++) {
+      const uint32_t* record = frameWords_.data() + kHeaderWords + kWordsPerInstance * i;
+      const uint32_t end = i + 1 == instances_.size() ? numVertices : record[kWordsPerInstance];
+      for (uint32_t v = record[0]; v != end; v++) {
+        skinVertex(meshWords_.data(),
+                   record[1] + v - record[0],
+                   frameFloats + record[2],
+                   frameFloats + record[3],
+                   vertices_[v]);
+      }
+    }
+    vertexBuffer_->upload(vertices_.data(), {vertices_.size() * sizeof(SkinnedVertex), 0});
+    return;
+  }
+
+  if (!IGL_VERIFY(pipelineState_)) {
+    return;
+  }
+  frameBuffer_->upload(frameWords_.data(), {frameWords_.size() * sizeof(uint32_t), 0});
+
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("ComputeSkinning::skin()");
+  encoder->bindComputePipelineState(pipelineState_);
+  encoder->bindBuffer(kFrameIndex, frameBuffer_, 0);
+  encoder->bindBuffer(kMeshIndex, meshBuffer_, 0);
+  encoder->bindBuffer(kVerticesIndex, vertexBuffer_, 0);
+  encoder->dispatchThreadGroups(
+      igl::Dimensions((numVertices + kThreadgroupSize - 1) / kThreadgroupSize, 1, 1),
+      igl::Dimensions(kThreadgroupSize, 1, 1));
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+} // namespace skinning
+} // namespace iglu
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <cstdint>
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace skinning {
+
+/// A bind pose vertex influenced by up to 4 joints. The weights are normalized and stored with
+/// 16 bits each.
+struct SkinningVertex {
+  float position[3] = {};
+  float normal[3] = {};
+  uint16_t joints[4] = {};
+  float weights[4] = {};
+};
+
+/// The offset of a vertex of a morph target from the bind pose
+struct MorphDelta {
+  uint32_t vertex = 0;
+  float position[3] = {};
+  float normal[3] = {};
+};
+
+struct MorphTargetDesc {
+  // the vertices the target moves; the others are unaffected
+  std::vector<MorphDelta> deltas;
+};
+
+/// A mesh shared by all the instances skinned with it
+struct SkinnedMeshDesc {
+  std::vector<SkinningVertex> vertices;
+  std::vector<MorphTargetDesc> morphTargets;
+  // the size of the joint palette of each instance
+  uint32_t numJoints = 1;
+};
+
+/// A skinned vertex: igl::VertexAttributeFormat::Float3 positions at offset 0 and normals at
+/// offset 12
+struct SkinnedVertex {
+  float position[3];
+  float normal[3];
+};
+static_assert(sizeof(SkinnedVertex) == 24, "SkinnedVertex must match the shader layout");
+
+/// The number of 32-bit words of a packed vertex and a packed morph delta
+constexpr uint32_t kWordsPerVertex = 12;
+constexpr uint32_t kWordsPerDelta = 7;
+/// The number of floats of a joint matrix: the first 3 rows of the affine matrix
+constexpr uint32_t kFloatsPerJoint = 12;
+
+/// Packs the meshes into the words of the mesh buffer: kWordsPerVertex words per vertex of all
+/// meshes, then the morph deltas of each vertex. Mesh i starts at vertex outFirstVertices[i].
+igl::Result packSkinnedMeshes(const std::vector<SkinnedMeshDesc>& meshes,
+                              std::vector<uint32_t>& outWords,
+                              std::vector<uint32_t>& outFirstVertices);
+
+/// Writes the first 3 rows of 'matrix' into 'outFloats'
+void packJointMatrix(const simdtypes::float4x4& matrix, float* outFloats);
+
+/// Skins 'vertex' of the packed mesh words like the compute shader: the morph targets are applied
+/// to the bind pose, which is then blended between the joint matrices of 'joints'
+/// (kFloatsPerJoint floats per joint). The normals are transformed by the upper 3x3 of the joint
+/// matrices and normalized, which is exact for rotations and uniform scales.
+void skinVertex(const uint32_t* meshWords,
+                uint32_t vertex,
+                const float* joints,
+                const float* morphWeights,
+                SkinnedVertex& outVertex);
+
+/**
+ * @brief Skins the vertices of many instances of skinned meshes once per frame, for all the
+ * passes drawing them.
+ *
+ * The meshes are uploaded once into one buffer. Every frame, the application sets the joint
+ * matrices (model space, i.e. including the inverse bind matrices) and morph target weights of
+ * each instance, then skin() records one compute dispatch for the vertices of all instances. It
+ * writes the skinned vertices of all instances into one vertex buffer, so the main, shadow and
+ * depth passes draw them with trivial vertex shaders:
+ *
+ *   encoder.bindBuffer(0,
+ *                      igl::BindTarget::kVertex,
+ *                      skinning.getVertexBuffer(),
+ *                      skinning.getFirstVertex(instance) * sizeof(SkinnedVertex));
+ *
+ * or with the mesh's index buffer and getFirstVertex() as the base vertex.
+ *
+ * Without DeviceFeatures::Compute (OpenGL ES 3.0), skin() skins on the CPU and uploads the
+ * vertices instead.
+ */
+class ComputeSkinning final {
+ public:
+  /// Instance i is skinned with mesh 'instanceMeshes[i]'
+  ComputeSkinning(igl::IDevice& device,
+                  const std::vector<SkinnedMeshDesc>& meshes,
+                  const std::vector<uint32_t>& instanceMeshes,
+                  igl::Result* outResult);
+
+  /// Sets the numJoints joint matrices of an instance's mesh. They start as identity matrices.
+  void setJointMatrices(uint32_t instance, const simdtypes::float4x4* matrices);
+  /// Sets the weights of the morph targets of an instance's mesh. They start at 0.
+  void setMorphWeights(uint32_t instance, const float* weights);
+
+  /// Records the skinning of all instances into 'commandBuffer'. Must be called outside of render
+  /// passes and before the render passes drawing the instances.
+  void skin(igl::ICommandBuffer& commandBuffer);
+
+  /// SkinnedVertex vertices of all instances
+  [[nodiscard]] const std::shared_ptr<igl::IBuffer>& getVertexBuffer() const {
+    return vertexBuffer_;
+  }
+  /// The first vertex of an instance in the vertex buffer
+  [[nodiscard]] uint32_t getFirstVertex(uint32_t instance) const {
+    return frameWords_[kHeaderWords + kWordsPerInstance * instance];
+  }
+  [[nodiscard]] uint32_t getNumVertices() const {
+    return frameWords_[1];
+  }
+  [[nodiscard]] uint32_t getNumInstances() const {
+    return frameWords_[0];
+  }
+
+ private:
+  // the per-frame words: a header with the number of instances and vertices, 4 words per instance
+  // (its first vertex, the first bind pose vertex of its mesh, the first word of its joint
+  // matrices and of its morph weights), then the joint matrices and morph weights
+  static constexpr uint32_t kHeaderWords = 4;
+  static constexpr uint32_t kWordsPerInstance = 4;
+
+  struct InstanceInfo {
+    uint32_t numJoints;
+    uint32_t numMorphTargets;
+  };
+
+  bool usesCompute_ = false;
+  std::vector<InstanceInfo> instances_;
+  std::vector<uint32_t> frameWords_;
+  std::shared_ptr<igl::IComputePipelineState> pipelineState_;
+  std::shared_ptr<igl::IBuffer> meshBuffer_;
+  std::shared_ptr<igl::IBuffer> frameBuffer_;
+  std::shared_ptr<igl::IBuffer> vertexBuffer_;
+
+  // CPU fallback
+  std::vector<uint32_t> meshWords_;
+  std::vector<SkinnedVertex> vertices_;
+};
+
+} // namespace skinning
+} // namespace iglu
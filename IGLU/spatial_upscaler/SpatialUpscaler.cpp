@@ -0,0 +1,653 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "SpatialUpscaler.h"
+
+#include <IGLU/glsl/Versions.h>
+#include <cmath>
+#include <igl/ShaderCreator.h>
+#include <string>
+
+namespace iglu {
+namespace spatialupscaler {
+
+namespace {
+
+constexpr uint32_t kThreadgroupSize = 8;
+
+constexpr size_t kParamsIndex = 0;
+constexpr size_t kInputIndex = 0;
+constexpr size_t kOutputIndex = 1;
+
+// matches the std430 and Metal layouts of the Params struct in the compute shaders
+struct Params {
+  int32_t inputSize[2];
+  int32_t outputSize[2];
+  float sharpness;
+  // bindless ids of the textures on Vulkan
+  uint32_t inputId;
+  uint32_t outputId;
+  uint32_t padding;
+};
+static_assert(sizeof(Params) == 32, "Params must match the shader layout");
+
+// the uniforms of the fragment shaders
+struct FragmentParams {
+  float sizes[4]; // input size, output size
+  float sharpness;
+};
+
+// Shared by GLSL and MSL. Each prologue defines:
+//   INOUT(T)        an inout function parameter of type T
+//   INPUT_PARAMS    extra parameters of the functions which read the input, e.g. the texture in MSL
+//   INPUT_ARGS      the matching arguments
+//   INPUT_SIZE      ivec2 size of the region of the input which is read
+//   OUTPUT_SIZE     ivec2 size of the output
+//   SHARPNESS       the amount of sharpening, in [0, 1]
+//   LOAD_INPUT(p)   the vec4 texel of the input at ivec2 p
+const char kBody[] = R"(
+vec3 loadInput(ivec2 p INPUT_PARAMS) {
+  return LOAD_INPUT(clamp(p, ivec2(0, 0), INPUT_SIZE - 1)).rgb;
+}
+
+float easuLuma(vec3 c) {
+  return c.b * 0.5 + (c.r * 0.5 + c.g);
+}
+
+// Accumulates the gradient direction and the edge length around one of the 4 texels nearest to
+// the output pixel, weighted by its bilinear weight: lA is above the texel, lB left, lC the texel,
+// lD right and lE below.
+void easuSet(INOUT(vec2) dir,
+             INOUT(float) len,
+             float w,
+             float lA,
+             float lB,
+             float lC,
+             float lD,
+             float lE) {
+  float dc = lD - lC;
+  float cb = lC - lB;
+  float lenX = max(abs(dc), abs(cb));
+  lenX = lenX > 0.0 ? clamp(abs(dc - cb) / lenX, 0.0, 1.0) : 0.0;
+  dir.x += (lD - lB) * w;
+  len += lenX * lenX * w;
+
+  float ec = lE - lC;
+  float ca = lC - lA;
+  float lenY = max(abs(ec), abs(ca));
+  lenY = lenY > 0.0 ? clamp(abs(ec - ca) / lenY, 0.0, 1.0) : 0.0;
+  dir.y += (lE - lA) * w;
+  len += lenY * lenY * w;
+}
+
+// Accumulates one texel with the Lanczos-like kernel rotated along 'dir' and scaled by 'len2'
+void easuTap(INOUT(vec3) aC,
+             INOUT(float) aW,
+             vec2 off,
+             vec2 dir,
+             vec2 len2,
+             float lob,
+             float clp,
+             vec3 c) {
+  vec2 v = vec2(off.x * dir.x + off.y * dir.y, off.y * dir.x - off.x * dir.y) * len2;
+  float d2 = min(dot(v, v), clp);
+  float wB = 0.4 * d2 - 1.0;
+  float wA = lob * d2 - 1.0;
+  wB *= wB;
+  wA *= wA;
+  wB = 1.5625 * wB - 0.5625;
+  aC += c * (wB * wA);
+  aW += wB * wA;
+}
+
+// The color of the output pixel centered at 'pixel'
+vec3 easu(vec2 pixel INPUT_PARAMS) {
+  vec2 pp = pixel * vec2(INPUT_SIZE) / vec2(OUTPUT_SIZE) - vec2(0.5, 0.5);
+  vec2 fp = floor(pp);
+  pp -= fp;
+  ivec2 p = ivec2(fp);
+
+  // the 12 texels around the 4 nearest ones: f g j k
+  //     b c
+  //   e f g h
+  //   i j k l
+  //     n o
+  vec3 b = loadInput(p + ivec2(0, -1) INPUT_ARGS);
+  vec3 c = loadInput(p + ivec2(1, -1) INPUT_ARGS);
+  vec3 e = loadInput(p + ivec2(-1, 0) INPUT_ARGS);
+  vec3 f = loadInput(p INPUT_ARGS);
+  vec3 g = loadInput(p + ivec2(1, 0) INPUT_ARGS);
+  vec3 h = loadInput(p + ivec2(2, 0) INPUT_ARGS);
+  vec3 i = loadInput(p + ivec2(-1, 1) INPUT_ARGS);
+  vec3 j = loadInput(p + ivec2(0, 1) INPUT_ARGS);
+  vec3 k = loadInput(p + ivec2(1, 1) INPUT_ARGS);
+  vec3 l = loadInput(p + ivec2(2, 1) INPUT_ARGS);
+  vec3 n = loadInput(p + ivec2(0, 2) INPUT_ARGS);
+  vec3 o = loadInput(p + ivec2(1, 2) INPUT_ARGS);
+
+  float bL = easuLuma(b);
+  float cL = easuLuma(c);
+  float eL = easuLuma(e);
+  float fL = easuLuma(f);
+  float gL = easuLuma(g);
+  float hL = easuLuma(h);
+  float iL = easuLuma(i);
+  float jL = easuLuma(j);
+  float kL = easuLuma(k);
+  float lL = easuLuma(l);
+  float nL = easuLuma(n);
+  float oL = easuLuma(o);
+
+  vec2 dir = vec2(0.0, 0.0);
+  float len = 0.0;
+  easuSet(dir, len, (1.0 - pp.x) * (1.0 - pp.y), bL, eL, fL, gL, jL);
+  easuSet(dir, len, pp.x * (1.0 - pp.y), cL, fL, gL, hL, kL);
+  easuSet(dir, len, (1.0 - pp.x) * pp.y, fL, iL, jL, kL, nL);
+  easuSet(dir, len, pp.x * pp.y, gL, jL, kL, lL, oL);
+
+  // flat areas have no direction
+  float dirR = dot(dir, dir);
+  bool isFlat = dirR < 1.0 / 32768.0;
+  dir = isFlat ? vec2(1.0, 0.0) : dir * inversesqrt(max(dirR, 1.0 / 32768.0));
+
+  // the kernel is stretched along edges and shrunk across them; its negative lobe grows with the
+  // edge length
+  len = len * 0.5;
+  len *= len;
+  float stretch = dot(dir, dir) / max(abs(dir.x), abs(dir.y));
+  vec2 len2 = vec2(1.0 + (stretch - 1.0) * len, 1.0 - 0.5 * len);
+  float lob = 0.5 + ((1.0 / 4.0 - 0.04) - 0.5) * len;
+  float clp = 1.0 / lob;
+
+  vec3 aC = vec3(0.0, 0.0, 0.0);
+  float aW = 0.0;
+  easuTap(aC, aW, vec2(0.0, -1.0) - pp, dir, len2, lob, clp, b);
+  easuTap(aC, aW, vec2(1.0, -1.0) - pp, dir, len2, lob, clp, c);
+  easuTap(aC, aW, vec2(-1.0, 1.0) - pp, dir, len2, lob, clp, i);
+  easuTap(aC, aW, vec2(0.0, 1.0) - pp, dir, len2, lob, clp, j);
+  easuTap(aC, aW, vec2(0.0, 0.0) - pp, dir, len2, lob, clp, f);
+  easuTap(aC, aW, vec2(-1.0, 0.0) - pp, dir, len2, lob, clp, e);
+  easuTap(aC, aW, vec2(1.0, 1.0) - pp, dir, len2, lob, clp, k);
+  easuTap(aC, aW, vec2(2.0, 1.0) - pp, dir, len2, lob, clp, l);
+  easuTap(aC, aW, vec2(2.0, 0.0) - pp, dir, len2, lob, clp, h);
+  easuTap(aC, aW, vec2(1.0, 0.0) - pp, dir, len2, lob, clp, g);
+  easuTap(aC, aW, vec2(1.0, 2.0) - pp, dir, len2, lob, clp, o);
+  easuTap(aC, aW, vec2(0.0, 2.0) - pp, dir, len2, lob, clp, n);
+
+  // no ringing: stay within the 4 nearest texels
+  vec3 mn = min(min(f, g), min(j, k));
+  vec3 mx = max(max(f, g), max(j, k));
+  return min(mx, max(mn, aC / aW));
+}
+
+// Sharpens the texel 'p' with a negative lobe limited so that the result does not clip:
+//     b
+//   d e f
+//     h
+vec3 rcas(ivec2 p INPUT_PARAMS) {
+  vec3 b = loadInput(p + ivec2(0, -1) INPUT_ARGS);
+  vec3 d = loadInput(p + ivec2(-1, 0) INPUT_ARGS);
+  vec3 e = loadInput(p INPUT_ARGS);
+  vec3 f = loadInput(p + ivec2(1, 0) INPUT_ARGS);
+  vec3 h = loadInput(p + ivec2(0, 1) INPUT_ARGS);
+
+  vec3 mn4 = min(min(b, d), min(f, h));
+  vec3 mx4 = max(max(b, d), max(f, h));
+  vec3 hitMin = min(mn4, e) / max(4.0 * mx4, vec3(1.0 / 32768.0));
+  vec3 hitMax = (1.0 - max(mx4, e)) / min(4.0 * mn4 - 4.0, vec3(-1.0 / 32768.0));
+  vec3 lobeRGB = max(-hitMin, hitMax);
+  float lobe = max(-0.1875, min(max(lobeRGB.r, max(lobeRGB.g, lobeRGB.b)), 0.0)) * SHARPNESS;
+  return (lobe * (b + d + f + h) + e) / (4.0 * lobe + 1.0);
+}
+)";
+
+const char kGlslComputeMain[] = R"(
+void main() {
+  ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+  if (p.x >= OUTPUT_SIZE.x || p.y >= OUTPUT_SIZE.y) {
+    return;
+  }
+#ifdef EASU
+  vec3 color = easu(vec2(p) + vec2(0.5, 0.5));
+#else
+  vec3 color = rcas(p);
+#endif
+  STORE_OUTPUT(p, vec4(color, 1.0));
+}
+)";
+
+const char kGlslFragmentMain[] = R"(
+void main() {
+  ivec2 p = ivec2(gl_FragCoord.xy);
+#ifdef EASU
+  vec3 color = easu(vec2(p) + vec2(0.5, 0.5));
+#else
+  vec3 color = rcas(p);
+#endif
+  fragColor = vec4(color, 1.0);
+}
+)";
+
+const char kGlslVertexMain[] = R"(
+void main() {
+  // a triangle covering the output
+  vec2 uv = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+  gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+const char kGlslCommon[] = R"(
+#define INOUT(T) inout T
+#define INPUT_PARAMS
+#define INPUT_ARGS
+)";
+
+// Vulkan provides its own #version; storage images are only accessible through the bindless
+// descriptor set, and storage buffers are in descriptor set 2
+const char kVulkanComputePrologue[] = R"(
+// kBinding_StorageImages in VulkanContext.cpp
+layout (set = 3, binding = 6, rgba8) uniform readonly image2D kImagesIn[];
+layout (set = 3, binding = 6, rgba8) uniform writeonly image2D kImagesOut[];
+
+layout (set = 2, binding = 0, std430) readonly buffer Params {
+  ivec2 inputSize;
+  ivec2 outputSize;
+  float sharpness;
+  uint inputId;
+  uint outputId;
+} params;
+
+#define INPUT_SIZE params.inputSize
+#define OUTPUT_SIZE params.outputSize
+#define SHARPNESS params.sharpness
+#define LOAD_INPUT(p) imageLoad(kImagesIn[params.inputId], p)
+#define STORE_OUTPUT(p, c) imageStore(kImagesOut[params.outputId], p, c)
+)";
+
+const char kOpenGLComputePrologue[] = R"(#version 310 es
+precision highp float;
+precision highp int;
+precision highp image2D;
+
+layout (binding = 0, rgba8) uniform readonly image2D inputImage;
+layout (binding = 1, rgba8) uniform writeonly image2D outputImage;
+
+layout (binding = 0, std430) readonly buffer Params {
+  ivec2 inputSize;
+  ivec2 outputSize;
+  float sharpness;
+  uint inputId;
+  uint outputId;
+} params;
+
+#define INPUT_SIZE params.inputSize
+#define OUTPUT_SIZE params.outputSize
+#define SHARPNESS params.sharpness
+#define LOAD_INPUT(p) imageLoad(inputImage, p)
+#define STORE_OUTPUT(p, c) imageStore(outputImage, p, c)
+)";
+
+const char kOpenGLFragmentPrologue[] = R"(
+uniform sampler2D inputImage;
+uniform vec4 sizes;
+uniform float sharpness;
+
+out vec4 fragColor;
+
+#define INPUT_SIZE ivec2(sizes.xy)
+#define OUTPUT_SIZE ivec2(sizes.zw)
+#define SHARPNESS sharpness
+#define LOAD_INPUT(p) texelFetch(inputImage, p, 0)
+)";
+
+const char kMetalPrologue[] = R"(
+#include <metal_stdlib>
+using namespace metal;
+
+typedef float2 vec2;
+typedef float3 vec3;
+typedef float4 vec4;
+typedef int2 ivec2;
+
+struct Params {
+  int2 inputSize;
+  int2 outputSize;
+  float sharpness;
+  uint inputId;
+  uint outputId;
+  uint padding;
+};
+
+#define inversesqrt rsqrt
+#define INOUT(T) thread T&
+#define INPUT_PARAMS , texture2d<float, access::read> inputImage, constant Params& params
+#define INPUT_ARGS , inputImage, params
+#define INPUT_SIZE params.inputSize
+#define OUTPUT_SIZE params.outputSize
+#define SHARPNESS params.sharpness
+#define LOAD_INPUT(p) inputImage.read(uint2(p))
+)";
+
+const char kMetalKernels[] = R"(
+kernel void easuMain(texture2d<float, access::read> inputImage [[texture(0)]],
+                     texture2d<float, access::write> outputImage [[texture(1)]],
+                     constant Params& params [[buffer(0)]],
+                     uint2 gid [[thread_position_in_grid]]) {
+  if (int(gid.x) >= params.outputSize.x || int(gid.y) >= params.outputSize.y) {
+    return;
+  }
+  outputImage.write(float4(easu(float2(gid) + 0.5 INPUT_ARGS), 1.0), gid);
+}
+
+kernel void rcasMain(texture2d<float, access::read> inputImage [[texture(0)]],
+                     texture2d<float, access::write> outputImage [[texture(1)]],
+                     constant Params& params [[buffer(0)]],
+                     uint2 gid [[thread_position_in_grid]]) {
+  if (int(gid.x) >= params.outputSize.x || int(gid.y) >= params.outputSize.y) {
+    return;
+  }
+  outputImage.write(float4(rcas(int2(gid) INPUT_ARGS), 1.0), gid);
+}
+)";
+
+const char* getPassName(uint8_t pass) {
+  return pass == 0 ? "EASU" : "RCAS";
+}
+
+std::string getPassDefines(uint8_t pass) {
+  return pass == 0 ? "#define EASU 1\n" : "";
+}
+
+std::string getComputeSource(igl::BackendType backendType, uint8_t pass) {
+  if (backendType == igl::BackendType::Metal) {
+    return std::string(kMetalPrologue) + kBody + kMetalKernels;
+  }
+  const bool isVulkan = backendType == igl::BackendType::Vulkan;
+  const std::string localSize = std::to_string(kThreadgroupSize);
+  return std::string(isVulkan ? kVulkanComputePrologue : kOpenGLComputePrologue) +
+         "layout (local_size_x = " + localSize + ", local_size_y = " + localSize + ") in;\n" +
+         getPassDefines(pass) + kGlslCommon + kBody + kGlslComputeMain;
+}
+
+std::shared_ptr<igl::IBuffer> createParamsBuffer(igl::IDevice& device,
+                                                 uint8_t pass,
+                                                 igl::Result* outResult) {
+  igl::BufferDesc desc(igl::BufferDesc::BufferTypeBits::Storage,
+                       nullptr,
+                       sizeof(Params),
+                       igl::ResourceStorage::Shared);
+  if (device.hasFeature(igl::DeviceFeatures::BufferRing)) {
+    // dispatch() uploads the sizes and the sharpness of the pass for every frame
+    desc.hint |= igl::BufferDesc::BufferAPIHintBits::Ring;
+  }
+  desc.debugName = std::string("SpatialUpscaler params: ") + getPassName(pass);
+  return device.createBuffer(desc, outResult);
+}
+
+} // namespace
+
+SpatialUpscaler::SpatialUpscaler(igl::IDevice& device,
+                                 SpatialUpscalerConfig config,
+                                 igl::Result* outResult) :
+  device_(device), config_(std::move(config)) {
+  const auto backendType = device_.getBackendType();
+  if (backendType == igl::BackendType::Vulkan) {
+    usesCompute_ = device_.hasFeature(igl::DeviceFeatures::Compute) &&
+                   device_.hasFeature(igl::DeviceFeatures::TextureBindless);
+    if (!usesCompute_) {
+      igl::Result::setResult(outResult,
+                             igl::Result::Code::Unsupported,
+                             "The spatial upscaler requires bindless textures on Vulkan");
+      return;
+    }
+  } else {
+    usesCompute_ = device_.hasFeature(igl::DeviceFeatures::Compute);
+  }
+  if (usesCompute_ && config_.intermediateFormat != igl::TextureFormat::RGBA_UNorm8) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::ArgumentInvalid,
+                           "Compute shaders read and write RGBA_UNorm8 textures");
+    return;
+  }
+
+  igl::Result result;
+  for (uint8_t pass = 0; pass != NumPasses; pass++) {
+    PassState& state = passes_[pass];
+    if (!usesCompute_) {
+      // the render pipelines depend on the output format and are created on the first use
+      const std::string version = glsl::getOpenGLVersion(device_.getShaderVersion());
+      const std::string vertexSource = version + kGlslVertexMain;
+      const std::string fragmentSource = version + getPassDefines(pass) + kGlslCommon +
+                                         kOpenGLFragmentPrologue + kBody + kGlslFragmentMain;
+      state.renderStages = igl::ShaderStagesCreator::fromModuleStringInput(device_,
+                                                                           vertexSource.c_str(),
+                                                                           "main",
+                                                                           "",
+                                                                           fragmentSource.c_str(),
+                                                                           "main",
+                                                                           "",
+                                                                           &result);
+      if (!result.isOk()) {
+        igl::Result::setResult(outResult, std::move(result));
+        return;
+      }
+      continue;
+    }
+
+    state.paramsBuffer = createParamsBuffer(device_, pass, &result);
+    if (!result.isOk()) {
+      igl::Result::setResult(outResult, std::move(result));
+      return;
+    }
+
+    const std::string source = getComputeSource(backendType, pass);
+    const bool isMetal = backendType == igl::BackendType::Metal;
+    std::shared_ptr<igl::IShaderStages> stages = igl::ShaderStagesCreator::fromModuleStringInput(
+        device_,
+        source.c_str(),
+        isMetal ? (pass == Easu ? "easuMain" : "rcasMain") : "main",
+        std::string("SpatialUpscaler ") + getPassName(pass),
+        &result);
+    if (!result.isOk()) {
+      igl::Result::setResult(outResult, std::move(result));
+      return;
+    }
+
+    igl::ComputePipelineDesc desc;
+    desc.shaderStages = std::move(stages);
+    desc.imagesMap[kInputIndex] = igl::genNameHandle("inputImage");
+    desc.imagesMap[kOutputIndex] = igl::genNameHandle("outputImage");
+    desc.buffersMap[kParamsIndex] = igl::genNameHandle("Params");
+    desc.debugName = std::string("SpatialUpscaler ") + getPassName(pass);
+    state.computePipeline = device_.createComputePipeline(desc, &result);
+    if (!result.isOk()) {
+      igl::Result::setResult(outResult, std::move(result));
+      return;
+    }
+  }
+  igl::Result::setOk(outResult);
+}
+
+SpatialUpscaler::~SpatialUpscaler() = default;
+
+igl::TextureDesc::TextureUsage SpatialUpscaler::getTextureUsage() const {
+  return usesCompute_ ? igl::TextureDesc::TextureUsageBits::Storage
+                      : igl::TextureDesc::TextureUsageBits::Sampled |
+                            igl::TextureDesc::TextureUsageBits::Attachment;
+}
+
+bool SpatialUpscaler::createIntermediate(const igl::Dimensions& size) {
+  if (intermediate_) {
+    const igl::Dimensions dimensions = intermediate_->getDimensions();
+    if (dimensions.width == size.width && dimensions.height == size.height) {
+      return true;
+    }
+  }
+  auto desc = igl::TextureDesc::new2D(config_.intermediateFormat,
+                                      size.width,
+                                      size.height,
+                                      igl::TextureDesc::TextureUsageBits::Sampled |
+                                          getTextureUsage(),
+                                      "SpatialUpscaler: intermediate");
+  desc.storage = igl::ResourceStorage::Private;
+  igl::Result result;
+  intermediate_ = device_.createTexture(desc, &result);
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("Cannot create the intermediate texture: %s\n", result.message.c_str());
+    intermediate_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void SpatialUpscaler::upscale(igl::ICommandBuffer& commandBuffer,
+                              igl::ITexture& input,
+                              const igl::Dimensions& inputSize,
+                              const std::shared_ptr<igl::ITexture>& output) {
+  const bool isCreated = usesCompute_ ? passes_[Rcas].computePipeline != nullptr
+                                       : passes_[Rcas].renderStages != nullptr;
+  if (!IGL_VERIFY(isCreated) || !IGL_VERIFY(output)) {
+    return;
+  }
+  const igl::Dimensions outputSize = output->getDimensions();
+  if (!createIntermediate(outputSize)) {
+    return;
+  }
+
+  if (usesCompute_) {
+    dispatch(commandBuffer, Easu, input, inputSize, *intermediate_);
+    dispatch(commandBuffer, Rcas, *intermediate_, outputSize, *output);
+  } else {
+    draw(commandBuffer, Easu, input, inputSize, intermediate_);
+    draw(commandBuffer, Rcas, *intermediate_, outputSize, output);
+  }
+}
+
+void SpatialUpscaler::dispatch(igl::ICommandBuffer& commandBuffer,
+                               Pass pass,
+                               igl::ITexture& input,
+                               const igl::Dimensions& inputSize,
+                               igl::ITexture& output) {
+  PassState& state = passes_[pass];
+  const igl::Dimensions outputSize = output.getDimensions();
+
+  Params params = {};
+  params.inputSize[0] = static_cast<int32_t>(inputSize.width);
+  params.inputSize[1] = static_cast<int32_t>(inputSize.height);
+  params.outputSize[0] = static_cast<int32_t>(outputSize.width);
+  params.outputSize[1] = static_cast<int32_t>(outputSize.height);
+  params.sharpness = std::exp2(-config_.sharpnessStops);
+  if (device_.getBackendType() == igl::BackendType::Vulkan) {
+    params.inputId = static_cast<uint32_t>(input.getTextureId());
+    params.outputId = static_cast<uint32_t>(output.getTextureId());
+  }
+  state.paramsBuffer->upload(&params, {sizeof(params), 0});
+
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel(std::string("SpatialUpscaler ") + getPassName(pass));
+  encoder->bindComputePipelineState(state.computePipeline);
+  encoder->bindBuffer(kParamsIndex, state.paramsBuffer, 0);
+  encoder->bindTexture(kInputIndex, &input);
+  encoder->bindTexture(kOutputIndex, &output);
+  encoder->dispatchThreadGroups(
+      igl::Dimensions((outputSize.width + kThreadgroupSize - 1) / kThreadgroupSize,
+                      (outputSize.height + kThreadgroupSize - 1) / kThreadgroupSize,
+                      1),
+      igl::Dimensions(kThreadgroupSize, kThreadgroupSize, 1));
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+void SpatialUpscaler::draw(igl::ICommandBuffer& commandBuffer,
+                           Pass pass,
+                           igl::ITexture& input,
+                           const igl::Dimensions& inputSize,
+                           const std::shared_ptr<igl::ITexture>& output) {
+  PassState& state = passes_[pass];
+  igl::Result result;
+
+  const igl::TextureFormat format = output->getProperties().format;
+  if (!state.renderPipeline || state.renderFormat != format) {
+    igl::RenderPipelineDesc desc;
+    desc.shaderStages = state.renderStages;
+    desc.targetDesc.colorAttachments.resize(1);
+    desc.targetDesc.colorAttachments[0].textureFormat = format;
+    desc.fragmentUnitSamplerMap[kInputIndex] = IGL_NAMEHANDLE("inputImage");
+    desc.cullMode = igl::CullMode::Disabled;
+    desc.debugName = igl::genNameHandle(std::string("SpatialUpscaler ") + getPassName(pass));
+    state.renderPipeline = device_.createRenderPipeline(desc, &result);
+    if (!result.isOk()) {
+      IGL_LOG_ERROR(
+          "Cannot create the %s pipeline: %s\n", getPassName(pass), result.message.c_str());
+      return;
+    }
+    state.renderFormat = format;
+  }
+
+  if (!state.framebuffer || state.framebuffer->getColorAttachment(0) != output) {
+    igl::FramebufferDesc desc;
+    desc.colorAttachments[0].texture = output;
+    desc.debugName = std::string("SpatialUpscaler ") + getPassName(pass);
+    state.framebuffer = device_.createFramebuffer(desc, &result);
+    if (!result.isOk()) {
+      IGL_LOG_ERROR(
+          "Cannot create the %s framebuffer: %s\n", getPassName(pass), result.message.c_str());
+      return;
+    }
+  }
+
+  const igl::Dimensions outputSize = output->getDimensions();
+  FragmentParams params = {};
+  params.sizes[0] = static_cast<float>(inputSize.width);
+  params.sizes[1] = static_cast<float>(inputSize.height);
+  params.sizes[2] = static_cast<float>(outputSize.width);
+  params.sizes[3] = static_cast<float>(outputSize.height);
+  params.sharpness = std::exp2(-config_.sharpnessStops);
+
+  igl::RenderPassDesc renderPass;
+  renderPass.colorAttachments.resize(1);
+  renderPass.colorAttachments[0].loadAction = igl::LoadAction::DontCare;
+  renderPass.colorAttachments[0].storeAction = igl::StoreAction::Store;
+  auto encoder = commandBuffer.createRenderCommandEncoder(renderPass, state.framebuffer);
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel(std::string("SpatialUpscaler ") + getPassName(pass));
+  encoder->bindViewport({0.0f,
+                         0.0f,
+                         static_cast<float>(outputSize.width),
+                         static_cast<float>(outputSize.height),
+                         0.0f,
+                         1.0f});
+  encoder->bindRenderPipelineState(state.renderPipeline);
+  encoder->bindTexture(kInputIndex, igl::BindTarget::kFragment, &input);
+
+  igl::UniformDesc sizes;
+  sizes.location = state.renderPipeline->getIndexByName("sizes", igl::ShaderStage::Fragment);
+  sizes.type = igl::UniformType::Float4;
+  sizes.offset = offsetof(FragmentParams, sizes);
+  encoder->bindUniform(sizes, &params);
+  igl::UniformDesc sharpness;
+  sharpness.location =
+      state.renderPipeline->getIndexByName("sharpness", igl::ShaderStage::Fragment);
+  sharpness.type = igl::UniformType::Float;
+  sharpness.offset = offsetof(FragmentParams, sharpness);
+  // only RCAS uses it
+  if (sharpness.location >= 0) {
+    encoder->bindUniform(sharpness, &params);
+  }
+
+  encoder->draw(igl::PrimitiveType::Triangle, 0, 3);
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+} // namespace spatialupscaler
+} // namespace iglu
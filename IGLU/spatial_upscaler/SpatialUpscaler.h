@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/IGL.h>
+#include <memory>
+
+namespace iglu {
+namespace spatialupscaler {
+
+struct SpatialUpscalerConfig {
+  // the sharpening is reduced by half for every stop: 0 is the sharpest
+  float sharpnessStops = 0.2f;
+  // the format of the upscaled image before sharpening
+  igl::TextureFormat intermediateFormat = igl::TextureFormat::RGBA_UNorm8;
+};
+
+/**
+ * @brief Upscales an image with edge adaptive filtering and sharpens the result, in the style of
+ * AMD FidelityFX Super Resolution 1.
+ *
+ * The first pass (EASU) reconstructs each output pixel from the 12 nearest input texels with a
+ * Lanczos-like kernel which is stretched along the local edge direction, so edges stay sharp
+ * without the blur of bilinear upsampling. The result is clamped to the 4 nearest texels to avoid
+ * ringing. The second pass (RCAS) sharpens the upscaled image by an amount limited by the local
+ * contrast, so it does not clip.
+ *
+ * Both passes run as compute dispatches on Vulkan (requires DeviceFeatures::TextureBindless),
+ * Metal and OpenGL with DeviceFeatures::Compute; they then read and write RGBA_UNorm8 storage
+ * textures. On OpenGL without compute shaders (OpenGL ES 3.0), they run as fullscreen draws into
+ * render targets instead. Create the input and output textures with getTextureUsage().
+ *
+ * The input should be anti-aliased and in a perceptual space (e.g. sRGB encoded).
+ */
+class SpatialUpscaler final {
+ public:
+  SpatialUpscaler(igl::IDevice& device, SpatialUpscalerConfig config, igl::Result* outResult);
+  ~SpatialUpscaler();
+
+  SpatialUpscaler(const SpatialUpscaler&) = delete;
+  SpatialUpscaler& operator=(const SpatialUpscaler&) = delete;
+
+  /// Upscales the region [0, inputSize) of `input`, starting at its first texel row, to the whole
+  /// of `output`. Must be called outside of render passes.
+  void upscale(igl::ICommandBuffer& commandBuffer,
+               igl::ITexture& input,
+               const igl::Dimensions& inputSize,
+               const std::shared_ptr<igl::ITexture>& output);
+
+  /// The usage the input and output textures need besides what the application uses them for
+  [[nodiscard]] igl::TextureDesc::TextureUsage getTextureUsage() const;
+  [[nodiscard]] bool usesCompute() const {
+    return usesCompute_;
+  }
+
+ private:
+  enum Pass : uint8_t { Easu = 0, Rcas, NumPasses };
+
+  bool createIntermediate(const igl::Dimensions& size);
+  void dispatch(igl::ICommandBuffer& commandBuffer,
+                Pass pass,
+                igl::ITexture& input,
+                const igl::Dimensions& inputSize,
+                igl::ITexture& output);
+  void draw(igl::ICommandBuffer& commandBuffer,
+            Pass pass,
+            igl::ITexture& input,
+            const igl::Dimensions& inputSize,
+            const std::shared_ptr<igl::ITexture>& output);
+
+ private:
+  igl::IDevice& device_;
+  const SpatialUpscalerConfig config_;
+  bool usesCompute_ = false;
+
+  struct PassState {
+    std::shared_ptr<igl::IComputePipelineState> computePipeline;
+    std::shared_ptr<igl::IShaderStages> renderStages;
+    std::shared_ptr<igl::IRenderPipelineState> renderPipeline;
+    igl::TextureFormat renderFormat = igl::TextureFormat::Invalid;
+    std::shared_ptr<igl::IBuffer> paramsBuffer;
+    // the framebuffer of the last output, recreated when the output changes
+    std::shared_ptr<igl::IFramebuffer> framebuffer;
+  };
+  PassState passes_[NumPasses];
+
+  std::shared_ptr<igl::ITexture> intermediate_;
+};
+
+} // namespace spatialupscaler
+} // namespace iglu
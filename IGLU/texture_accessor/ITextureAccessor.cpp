@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "ITextureAccessor.h"
+
+#include <algorithm>
+
+namespace iglu {
+namespace textureaccessor {
+
+namespace {
+
+igl::TextureRangeDesc getReadRange(const igl::ITexture& texture) {
+  const auto dimensions = texture.getDimensions();
+  return igl::TextureRangeDesc::new2D(0, 0, dimensions.width, dimensions.height);
+}
+
+} // namespace
+
+size_t ITextureAccessor::getSizeInBytes() const {
+  return texture_ ? texture_->getProperties().getBytesPerRange(getReadRange(*texture_)) : 0;
+}
+
+RequestId ITextureAccessor::requestBytes(igl::ICommandQueue& commandQueue,
+                                         void* IGL_NONNULL outData,
+                                         size_t length,
+                                         std::shared_ptr<igl::ITexture> texture) {
+  PendingRequest request;
+  request.outData = outData;
+  return startRequest(commandQueue, std::move(request), length, std::move(texture));
+}
+
+RequestId ITextureAccessor::requestBytes(igl::ICommandQueue& commandQueue,
+                                         igl::IBuffer& buffer,
+                                         size_t offset,
+                                         std::shared_ptr<igl::ITexture> texture) {
+  PendingRequest request;
+  request.buffer = &buffer;
+  request.offset = offset;
+  const size_t length = offset < buffer.getSizeInBytes() ? buffer.getSizeInBytes() - offset : 0;
+  return startRequest(commandQueue, std::move(request), length, std::move(texture));
+}
+
+RequestId ITextureAccessor::startRequest(igl::ICommandQueue& commandQueue,
+                                         PendingRequest request,
+                                         size_t length,
+                                         std::shared_ptr<igl::ITexture> texture) {
+  if (texture) {
+    IGL_ASSERT(texture_->getDimensions().width == texture->getDimensions().width &&
+               texture_->getDimensions().height == texture->getDimensions().height);
+    texture_ = std::move(texture);
+  }
+  if (!IGL_VERIFY(length >= getSizeInBytes())) {
+    return 0;
+  }
+
+  igl::Result result;
+  request.readback = texture_->readAsync(commandQueue, getReadRange(*texture_), &result);
+  if (!request.readback) {
+    IGL_LOG_INFO_ONCE("Cannot read the texture asynchronously: %s\n", result.message.c_str());
+    return 0;
+  }
+
+  request.id = ++lastRequestId_;
+  pendingRequests_.push_back(std::move(request));
+  return lastRequestId_;
+}
+
+RequestStatus ITextureAccessor::getRequestStatus(RequestId requestId) {
+  auto it = std::find_if(pendingRequests_.begin(),
+                         pendingRequests_.end(),
+                         [requestId](const PendingRequest& r) { return r.id == requestId; });
+  if (it == pendingRequests_.end()) {
+    return RequestStatus::NotInitialized;
+  }
+  if (!it->readback->isReady()) {
+    return RequestStatus::InProgress;
+  }
+  const RequestStatus status = finishRequest(*it);
+  pendingRequests_.erase(it);
+  return status;
+}
+
+RequestStatus ITextureAccessor::waitForRequest(RequestId requestId) {
+  auto it = std::find_if(pendingRequests_.begin(),
+                         pendingRequests_.end(),
+                         [requestId](const PendingRequest& r) { return r.id == requestId; });
+  if (it == pendingRequests_.end()) {
+    return RequestStatus::NotInitialized;
+  }
+  // getData() waits for the GPU
+  const RequestStatus status = finishRequest(*it);
+  pendingRequests_.erase(it);
+  return status;
+}
+
+RequestStatus ITextureAccessor::finishRequest(const PendingRequest& request) {
+  if (request.outData) {
+    return request.readback->getData(request.outData).isOk() ? RequestStatus::Ready
+                                                              : RequestStatus::Failed;
+  }
+
+  // not every backend can write into mapped buffers
+  const size_t size = request.readback->getSizeInBytes();
+  scratch_.resize(size);
+  if (!request.readback->getData(scratch_.data()).isOk()) {
+    return RequestStatus::Failed;
+  }
+  const igl::Result result =
+      request.buffer->upload(scratch_.data(), igl::BufferRange(size, request.offset));
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("Cannot upload to the destination buffer: %s\n", result.message.c_str());
+    return RequestStatus::Failed;
+  }
+  return RequestStatus::Ready;
+}
+
+} // namespace textureaccessor
+} // namespace iglu
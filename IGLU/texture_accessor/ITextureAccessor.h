@@ -10,6 +10,7 @@
 #include <igl/CommandQueue.h>
 #include <igl/IGL.h>
 #include <igl/Texture.h>
+#include <vector>
 
 namespace iglu {
 namespace textureaccessor {
@@ -18,8 +19,13 @@ enum class RequestStatus : uint8_t {
   Ready = 0,
   NotInitialized,
   InProgress,
+  Failed,
 };
 
+/// Identifies a request started by ITextureAccessor::requestBytes() with a caller-provided
+/// destination; 0 stands for a request which could not be started
+using RequestId = uint64_t;
+
 /// Interface for getting CPU access to GPU texture data
 class ITextureAccessor {
  public:
@@ -52,8 +58,58 @@ class ITextureAccessor {
     return getBytes();
   }
 
+  // Size of the bytes written by the requests with a caller-provided destination
+  [[nodiscard]] size_t getSizeInBytes() const;
+
+  /**
+    Start reading the texture into `outData`, which has to hold at least getSizeInBytes() bytes
+    and stay valid until the request is no longer RequestStatus::InProgress. Several requests can
+    be in flight; none of them allocates memory for the texture bytes. Built on
+    igl::ITexture::readAsync(), so it returns 0 on devices without asynchronous readbacks.
+    Receive an optional texture an input. It MUST be the same size as previous texture
+  */
+  RequestId requestBytes(igl::ICommandQueue& commandQueue,
+                         void* IGL_NONNULL outData,
+                         size_t length,
+                         std::shared_ptr<igl::ITexture> texture = nullptr);
+
+  // Same as above, but uploads the bytes into `buffer` at `offset` once they are read, through a
+  // scratch copy reused by all requests. The buffer has to stay alive until the request is no
+  // longer InProgress.
+  RequestId requestBytes(igl::ICommandQueue& commandQueue,
+                         igl::IBuffer& buffer,
+                         size_t offset,
+                         std::shared_ptr<igl::ITexture> texture = nullptr);
+
+  // Poll a request with a caller-provided destination. Never blocks: the bytes are written into
+  // the destination once the GPU has finished the copy, and RequestStatus::Ready or
+  // RequestStatus::Failed is returned once. Unknown or finished requests are NotInitialized.
+  RequestStatus getRequestStatus(RequestId requestId);
+
+  // Wait for a request with a caller-provided destination to finish
+  RequestStatus waitForRequest(RequestId requestId);
+
  protected:
   std::shared_ptr<igl::ITexture> texture_;
+
+ private:
+  struct PendingRequest {
+    RequestId id = 0;
+    std::shared_ptr<igl::IReadback> readback;
+    void* outData = nullptr;
+    igl::IBuffer* buffer = nullptr;
+    size_t offset = 0;
+  };
+
+  RequestId startRequest(igl::ICommandQueue& commandQueue,
+                         PendingRequest request,
+                         size_t length,
+                         std::shared_ptr<igl::ITexture> texture);
+  RequestStatus finishRequest(const PendingRequest& request);
+
+  std::vector<PendingRequest> pendingRequests_;
+  std::vector<unsigned char> scratch_;
+  RequestId lastRequestId_ = 0;
 };
 
 } // namespace textureaccessor
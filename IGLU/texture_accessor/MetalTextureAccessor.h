@@ -20,6 +20,9 @@ class MetalTextureAccessor : public ITextureAccessor {
  public:
   MetalTextureAccessor(std::shared_ptr<igl::ITexture> texture, igl::IDevice& device);
 
+  using ITextureAccessor::getRequestStatus;
+  using ITextureAccessor::requestBytes;
+
   void requestBytes(igl::ICommandQueue& commandQueue,
                     std::shared_ptr<igl::ITexture> texture = nullptr) override;
   RequestStatus getRequestStatus() override;
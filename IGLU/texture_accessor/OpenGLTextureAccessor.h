@@ -21,6 +21,9 @@ class OpenGLTextureAccessor : public ITextureAccessor {
  public:
   OpenGLTextureAccessor(std::shared_ptr<igl::ITexture> texture, igl::IDevice& device);
 
+  using ITextureAccessor::getRequestStatus;
+  using ITextureAccessor::requestBytes;
+
   void requestBytes(igl::ICommandQueue& commandQueue,
                     std::shared_ptr<igl::ITexture> texture = nullptr) override;
   RequestStatus getRequestStatus() override;
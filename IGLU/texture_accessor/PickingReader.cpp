@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "PickingReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace iglu {
+namespace textureaccessor {
+
+namespace {
+
+// the bounding rectangle of two 2D regions of the same mip level and layer
+igl::TextureRangeDesc getUnion(const igl::TextureRangeDesc& a, const igl::TextureRangeDesc& b) {
+  const size_t x = std::min(a.x, b.x);
+  const size_t y = std::min(a.y, b.y);
+  const size_t width = std::max(a.x + a.width, b.x + b.width) - x;
+  const size_t height = std::max(a.y + a.height, b.y + b.height) - y;
+  return igl::TextureRangeDesc::new2DArray(x, y, width, height, a.layer, 1, a.mipLevel);
+}
+
+} // namespace
+
+PickingQueryId PickingReader::request(const std::shared_ptr<igl::ITexture>& texture,
+                                      const igl::TextureRangeDesc& range) {
+  if (!IGL_VERIFY(texture != nullptr)) {
+    return 0;
+  }
+  const igl::TextureFormatProperties properties = texture->getProperties();
+  if (properties.isCompressed() || properties.isDepthOrStencil()) {
+    IGL_LOG_INFO_ONCE("Compressed, depth and stencil textures cannot be picked\n");
+    return 0;
+  }
+  if (!IGL_VERIFY(range.depth == 1 && range.numLayers == 1 && range.numMipLevels == 1 &&
+                  range.width > 0 && range.height > 0 && texture->validateRange(range).isOk())) {
+    return 0;
+  }
+
+  const Query query = {++lastQueryId_, range};
+  for (Batch& batch : requestedBatches_) {
+    if (batch.texture != texture || batch.range.mipLevel != range.mipLevel ||
+        batch.range.layer != range.layer) {
+      continue;
+    }
+    const igl::TextureRangeDesc merged = getUnion(batch.range, range);
+    if (merged.width * merged.height <= maxMergedPixels_) {
+      batch.range = merged;
+      batch.queries.push_back(query);
+      return query.id;
+    }
+  }
+
+  Batch batch;
+  if (!freeBatches_.empty()) {
+    batch = std::move(freeBatches_.back());
+    freeBatches_.pop_back();
+  }
+  batch.texture = texture;
+  batch.range = range;
+  batch.bytesPerPixel = properties.bytesPerBlock;
+  batch.queries.push_back(query);
+  requestedBatches_.push_back(std::move(batch));
+  return query.id;
+}
+
+void PickingReader::submit(igl::ICommandQueue& commandQueue) {
+  for (Batch& batch : requestedBatches_) {
+    igl::Result result;
+    batch.readback = batch.texture->readAsync(commandQueue, batch.range, &result);
+    if (!batch.readback) {
+      IGL_LOG_INFO_ONCE("Cannot read the texture asynchronously: %s\n", result.message.c_str());
+    }
+    // the readback keeps what it needs of the texture
+    batch.texture = nullptr;
+    submittedBatches_.push_back(std::move(batch));
+  }
+  requestedBatches_.clear();
+}
+
+size_t PickingReader::poll(const std::function<void(const PickingResult&)>& callback) {
+  return deliver(false, callback);
+}
+
+size_t PickingReader::wait(const std::function<void(const PickingResult&)>& callback) {
+  return deliver(true, callback);
+}
+
+size_t PickingReader::getNumPendingQueries() const {
+  size_t numQueries = 0;
+  for (const auto* batches : {&requestedBatches_, &submittedBatches_}) {
+    for (const Batch& batch : *batches) {
+      numQueries += batch.queries.size();
+    }
+  }
+  return numQueries;
+}
+
+size_t PickingReader::deliver(bool waitForGPU,
+                              const std::function<void(const PickingResult&)>& callback) {
+  size_t numDelivered = 0;
+  // the copies finish in order: stop at the first one which is not ready
+  while (!submittedBatches_.empty()) {
+    if (!waitForGPU && submittedBatches_.front().readback &&
+        !submittedBatches_.front().readback->isReady()) {
+      break;
+    }
+    // the callback may request and submit queries
+    Batch batch = std::move(submittedBatches_.front());
+    submittedBatches_.erase(submittedBatches_.begin());
+
+    bool succeeded = false;
+    if (batch.readback) {
+      batchData_.resize(batch.readback->getSizeInBytes());
+      succeeded = batch.readback->getData(batchData_.data()).isOk();
+    }
+    const size_t batchRowBytes = batch.range.width * batch.bytesPerPixel;
+    for (const Query& query : batch.queries) {
+      PickingResult result;
+      result.id = query.id;
+      result.range = query.range;
+      if (succeeded) {
+        result.status = RequestStatus::Ready;
+        result.bytesPerPixel = batch.bytesPerPixel;
+        const size_t rowBytes = query.range.width * batch.bytesPerPixel;
+        if (rowBytes == batchRowBytes) {
+          // whole rows of the batch
+          result.data = batchData_.data() + (query.range.y - batch.range.y) * batchRowBytes;
+        } else {
+          queryData_.resize(rowBytes * query.range.height);
+          for (size_t row = 0; row != query.range.height; row++) {
+            const uint8_t* src = batchData_.data() +
+                                 (query.range.y - batch.range.y + row) * batchRowBytes +
+                                 (query.range.x - batch.range.x) * batch.bytesPerPixel;
+            std::memcpy(queryData_.data() + row * rowBytes, src, rowBytes);
+          }
+          result.data = queryData_.data();
+        }
+      }
+      callback(result);
+      numDelivered++;
+    }
+    batch.readback = nullptr;
+    batch.queries.clear();
+    freeBatches_.push_back(std::move(batch));
+  }
+  return numDelivered;
+}
+
+} // namespace textureaccessor
+} // namespace iglu
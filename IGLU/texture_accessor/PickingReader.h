@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/texture_accessor/ITextureAccessor.h>
+#include <functional>
+#include <igl/Readback.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace textureaccessor {
+
+/// Identifies a query started by PickingReader::request(); 0 stands for a query which could not
+/// be started
+using PickingQueryId = uint64_t;
+
+/// The outcome of a query, passed to the callback of PickingReader::poll()
+struct PickingResult {
+  PickingQueryId id = 0;
+  /// RequestStatus::Ready or RequestStatus::Failed
+  RequestStatus status = RequestStatus::Failed;
+  igl::TextureRangeDesc range;
+  /// The pixels of `range` with tightly packed rows, or null if the query failed. Only valid
+  /// during the callback.
+  const uint8_t* data = nullptr;
+  size_t bytesPerPixel = 0;
+
+  /// The pixel at (x, y) in texture coordinates, which has to be inside `range`
+  [[nodiscard]] const void* getPixel(size_t x, size_t y) const {
+    IGL_ASSERT(data != nullptr && x >= range.x && x < range.x + range.width && y >= range.y &&
+               y < range.y + range.height);
+    return data + ((y - range.y) * range.width + (x - range.x)) * bytesPerPixel;
+  }
+};
+
+/**
+ * @brief Reads single pixels or small regions of textures, e.g. of an object ID buffer for
+ * picking, without waiting for the GPU.
+ *
+ * Queries are collected with request() during a frame and started together by submit(), once the
+ * texture has been rendered: the queries on the same mip level and layer of a texture whose
+ * bounding rectangle covers at most `maxMergedPixels` pixels share one copy. Only the requested
+ * rectangles are copied, through igl::ITexture::readAsync() and the staging memory of the
+ * backend; poll() delivers the results once the GPU has finished them, typically a frame or two
+ * later. Nothing is allocated per query once the reader has warmed up.
+ *
+ * Queries fail on devices without asynchronous readbacks, and on depth, stencil and compressed
+ * textures.
+ */
+class PickingReader final {
+ public:
+  explicit PickingReader(size_t maxMergedPixels = 64 * 64) : maxMergedPixels_(maxMergedPixels) {}
+
+  /// Queues a read of one 2D region of one mip level and layer of `texture`
+  PickingQueryId request(const std::shared_ptr<igl::ITexture>& texture,
+                         const igl::TextureRangeDesc& range);
+  PickingQueryId requestPixel(const std::shared_ptr<igl::ITexture>& texture, size_t x, size_t y) {
+    return request(texture, igl::TextureRangeDesc::new2D(x, y, 1, 1));
+  }
+
+  /// Starts the copies of the queries requested since the last call. Call it once per frame,
+  /// after submitting the command buffers which render the textures.
+  void submit(igl::ICommandQueue& commandQueue);
+
+  /// Calls `callback` for every query whose copy has finished, in the order of the copies. Never
+  /// blocks. Returns the number of queries delivered. The callback can request new queries.
+  size_t poll(const std::function<void(const PickingResult&)>& callback);
+
+  /// Same as poll(), but waits for all the submitted queries
+  size_t wait(const std::function<void(const PickingResult&)>& callback);
+
+  /// The number of queries which poll() has not delivered yet, submitted or not
+  [[nodiscard]] size_t getNumPendingQueries() const;
+
+ private:
+  struct Query {
+    PickingQueryId id = 0;
+    igl::TextureRangeDesc range;
+  };
+  struct Batch {
+    std::shared_ptr<igl::ITexture> texture;
+    igl::TextureRangeDesc range;
+    size_t bytesPerPixel = 0;
+    // null if the copy could not be started
+    std::shared_ptr<igl::IReadback> readback;
+    std::vector<Query> queries;
+  };
+
+  size_t deliver(bool waitForGPU, const std::function<void(const PickingResult&)>& callback);
+
+  size_t maxMergedPixels_;
+  PickingQueryId lastQueryId_ = 0;
+  // the queries requested since the last submit(), merged
+  std::vector<Batch> requestedBatches_;
+  std::vector<Batch> submittedBatches_;
+  // emptied batches, whose query vectors are reused
+  std::vector<Batch> freeBatches_;
+  std::vector<uint8_t> batchData_;
+  std::vector<uint8_t> queryData_;
+};
+
+} // namespace textureaccessor
+} // namespace iglu
@@ -8,6 +8,7 @@
 #include "TextureAccessorFactory.h"
 #include "ITextureAccessor.h"
 #include "OpenGLTextureAccessor.h"
+#include "VulkanTextureAccessor.h"
 #include <memory>
 #if IGL_PLATFORM_APPLE
 #include "MetalTextureAccessor.h"
@@ -27,6 +28,8 @@ std::unique_ptr<ITextureAccessor> TextureAccessorFactory::createTextureAccessor(
   case igl::BackendType::Metal:
     return std::make_unique<MetalTextureAccessor>(texture, device);
 #endif
+  case igl::BackendType::Vulkan:
+    return std::make_unique<VulkanTextureAccessor>(texture, device);
   default:
     IGL_ASSERT_NOT_IMPLEMENTED();
     return nullptr;
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "VulkanTextureAccessor.h"
+
+namespace iglu {
+namespace textureaccessor {
+
+VulkanTextureAccessor::VulkanTextureAccessor(std::shared_ptr<igl::ITexture> texture,
+                                             igl::IDevice& /*device*/) :
+  ITextureAccessor(std::move(texture)) {
+  const auto dimensions = texture_->getDimensions();
+  textureWidth_ = dimensions.width;
+  textureHeight_ = dimensions.height;
+  latestBytesRead_.resize(getSizeInBytes());
+}
+
+void VulkanTextureAccessor::requestBytes(igl::ICommandQueue& commandQueue,
+                                         std::shared_ptr<igl::ITexture> texture) {
+  if (texture) {
+    IGL_ASSERT(textureWidth_ == texture->getDimensions().width &&
+               textureHeight_ == texture->getDimensions().height);
+    texture_ = std::move(texture);
+  }
+
+  igl::Result result;
+  const auto range = igl::TextureRangeDesc::new2D(0, 0, textureWidth_, textureHeight_);
+  readback_ = texture_->readAsync(commandQueue, range, &result);
+  if (!readback_) {
+    IGL_LOG_ERROR("Cannot read the texture: %s\n", result.message.c_str());
+    status_ = RequestStatus::Failed;
+    return;
+  }
+  status_ = RequestStatus::InProgress;
+}
+
+RequestStatus VulkanTextureAccessor::getRequestStatus() {
+  if (status_ == RequestStatus::InProgress && readback_->isReady()) {
+    // does not wait
+    getBytes();
+  }
+  return status_;
+}
+
+std::vector<unsigned char>& VulkanTextureAccessor::getBytes() {
+  if (status_ == RequestStatus::InProgress) {
+    status_ = readback_->getData(latestBytesRead_.data()).isOk() ? RequestStatus::Ready
+                                                                 : RequestStatus::Failed;
+    readback_ = nullptr;
+  }
+  return latestBytesRead_;
+}
+
+} // namespace textureaccessor
+} // namespace iglu
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "ITextureAccessor.h"
+#include <igl/CommandQueue.h>
+#include <igl/IGL.h>
+#include <igl/Texture.h>
+
+namespace iglu {
+namespace textureaccessor {
+
+// Reads textures with igl::ITexture::readAsync(), which copies them through the staging device's
+// readback buffers without stalling the queue
+class VulkanTextureAccessor : public ITextureAccessor {
+ public:
+  VulkanTextureAccessor(std::shared_ptr<igl::ITexture> texture, igl::IDevice& device);
+
+  using ITextureAccessor::getRequestStatus;
+  using ITextureAccessor::requestBytes;
+
+  void requestBytes(igl::ICommandQueue& commandQueue,
+                    std::shared_ptr<igl::ITexture> texture = nullptr) override;
+  RequestStatus getRequestStatus() override;
+  std::vector<unsigned char>& getBytes() override;
+
+ private:
+  std::vector<unsigned char> latestBytesRead_;
+  RequestStatus status_ = RequestStatus::NotInitialized;
+  size_t textureWidth_ = 0;
+  size_t textureHeight_ = 0;
+  std::shared_ptr<igl::IReadback> readback_;
+};
+
+} // namespace textureaccessor
+} // namespace iglu
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "SkylinePacker.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace iglu {
+namespace textureatlas {
+
+SkylinePacker::SkylinePacker(uint32_t width, uint32_t height) : width_(width), height_(height) {
+  reset();
+}
+
+void SkylinePacker::reset() {
+  segments_.clear();
+  segments_.push_back({0, 0, width_});
+}
+
+bool SkylinePacker::fit(size_t index, uint32_t width, uint32_t height, uint32_t& outY) const {
+  const uint32_t x = segments_[index].x;
+  if (width > width_ - x) {
+    return false;
+  }
+  // the rectangle rests on the highest segment below it
+  uint32_t y = 0;
+  uint32_t widthLeft = width;
+  for (size_t i = index; widthLeft > 0; i++) {
+    y = std::max(y, segments_[i].y);
+    widthLeft -= std::min(widthLeft, segments_[i].width);
+  }
+  if (height > height_ - y) {
+    return false;
+  }
+  outY = y;
+  return true;
+}
+
+bool SkylinePacker::pack(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY) {
+  if (width == 0 || height == 0) {
+    return false;
+  }
+
+  size_t bestIndex = segments_.size();
+  uint32_t bestTop = std::numeric_limits<uint32_t>::max();
+  uint32_t bestY = 0;
+  for (size_t i = 0; i != segments_.size(); i++) {
+    uint32_t y = 0;
+    if (fit(i, width, height, y) && y + height < bestTop) {
+      bestIndex = i;
+      bestTop = y + height;
+      bestY = y;
+    }
+  }
+  if (bestIndex == segments_.size()) {
+    return false;
+  }
+
+  outX = segments_[bestIndex].x;
+  outY = bestY;
+
+  // the new segment replaces the covered part of the skyline
+  const uint32_t right = outX + width;
+  segments_.insert(segments_.begin() + bestIndex, Segment{outX, bestTop, width});
+  size_t i = bestIndex + 1;
+  while (i < segments_.size() && segments_[i].x < right) {
+    const uint32_t segmentRight = segments_[i].x + segments_[i].width;
+    if (segmentRight <= right) {
+      segments_.erase(segments_.begin() + i);
+    } else {
+      segments_[i].width = segmentRight - right;
+      segments_[i].x = right;
+      break;
+    }
+  }
+
+  // merge neighbors of the same height
+  for (i = 0; i + 1 < segments_.size();) {
+    if (segments_[i].y == segments_[i + 1].y) {
+      segments_[i].width += segments_[i + 1].width;
+      segments_.erase(segments_.begin() + i + 1);
+    } else {
+      i++;
+    }
+  }
+
+  return true;
+}
+
+uint64_t SkylinePacker::getUsedArea() const {
+  uint64_t area = 0;
+  for (const auto& segment : segments_) {
+    area += static_cast<uint64_t>(segment.width) * segment.y;
+  }
+  return area;
+}
+
+} // namespace textureatlas
+} // namespace iglu
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace iglu {
+namespace textureatlas {
+
+/**
+ * @brief Packs rectangles into a fixed-size area with the skyline bottom-left heuristic.
+ *
+ * The skyline is the top edge of everything packed so far. A rectangle is placed where its top
+ * edge ends up lowest, leftmost on ties. Rectangles cannot be freed individually; reset() starts
+ * over with an empty area.
+ */
+class SkylinePacker final {
+ public:
+  SkylinePacker(uint32_t width, uint32_t height);
+
+  /// Returns false if the rectangle does not fit anymore
+  bool pack(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY);
+
+  void reset();
+
+  /// The area covered by the skyline, including the gaps below it which can no longer be used
+  [[nodiscard]] uint64_t getUsedArea() const;
+
+ private:
+  struct Segment {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t width = 0;
+  };
+
+  // the y of a rectangle of `width` placed at segments_[index], or false if it does not fit
+  bool fit(std::size_t index, uint32_t width, uint32_t height, uint32_t& outY) const;
+
+ private:
+  uint32_t width_ = 0;
+  uint32_t height_ = 0;
+  std::vector<Segment> segments_; // sorted by x, covering the whole width
+};
+
+} // namespace textureatlas
+} // namespace iglu
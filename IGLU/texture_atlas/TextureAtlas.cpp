@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <igl/Common.h>
+#include <igl/IGLSafeC.h>
+
+namespace iglu {
+namespace textureatlas {
+
+TextureAtlas::TextureAtlas(igl::IDevice& device,
+                           TextureAtlasConfig config,
+                           igl::Result* outResult) :
+  device_(device), config_(std::move(config)) {
+  config_.pageSize = std::max(config_.pageSize, 1u);
+  config_.numPages = std::max(config_.numPages, 1u);
+
+  const auto desc = igl::TextureDesc::new2DArray(config_.format,
+                                                 config_.pageSize,
+                                                 config_.pageSize,
+                                                 config_.numPages,
+                                                 igl::TextureDesc::TextureUsageBits::Sampled,
+                                                 "IGLU texture atlas");
+  texture_ = device_.createTexture(desc, outResult);
+
+  pages_.reserve(config_.numPages);
+  for (uint32_t i = 0; i != config_.numPages; i++) {
+    pages_.emplace_back(config_.pageSize);
+  }
+}
+
+std::shared_ptr<AtlasEntry> TextureAtlas::add(uint32_t width,
+                                              uint32_t height,
+                                              const void* data,
+                                              size_t bytesPerRow) {
+  if (!IGL_VERIFY(texture_ && data && width > 0 && height > 0)) {
+    return nullptr;
+  }
+  if (width > config_.pageSize || height > config_.pageSize) {
+    return nullptr;
+  }
+
+  // the padding may be dropped at the right and bottom edges of a page
+  const uint32_t paddedWidth = std::min(width + config_.padding, config_.pageSize);
+  const uint32_t paddedHeight = std::min(height + config_.padding, config_.pageSize);
+
+  AtlasRegion region;
+  bool packed = false;
+  for (uint32_t attempt = 0; !packed; attempt++) {
+    for (uint32_t i = 0; i != pages_.size() && !packed; i++) {
+      packed = packIntoPage(i, paddedWidth, paddedHeight, region);
+    }
+    if (!packed && !(attempt == 0 ? reclaimEmptyPages() || evictPage() : evictPage())) {
+      return nullptr;
+    }
+  }
+
+  region.width = width;
+  region.height = height;
+  const float invSize = 1.0f / static_cast<float>(config_.pageSize);
+  region.uvOffset[0] = static_cast<float>(region.x) * invSize;
+  region.uvOffset[1] = static_cast<float>(region.y) * invSize;
+  region.uvScale[0] = static_cast<float>(width) * invSize;
+  region.uvScale[1] = static_cast<float>(height) * invSize;
+
+  auto entry = std::make_shared<AtlasEntry>();
+  entry->region_ = region;
+  Page& page = pages_[region.page];
+  page.entries.push_back(entry);
+  page.lastUsedFrame = frame_;
+
+  // copy the data now, the caller does not have to keep it until update()
+  const auto properties = texture_->getProperties();
+  const auto range =
+      igl::TextureRangeDesc::new2DArray(region.x, region.y, width, height, region.page, 1);
+  const size_t rowSize = properties.getBytesPerRow(range);
+  const size_t srcBytesPerRow = bytesPerRow ? bytesPerRow : rowSize;
+  const size_t rows = properties.getRows(range);
+
+  PendingUpload upload;
+  upload.entry = entry;
+  upload.range = range;
+  upload.data.resize(rowSize * rows);
+  for (size_t row = 0; row != rows; row++) {
+    checked_memcpy(upload.data.data() + row * rowSize,
+                   upload.data.size() - row * rowSize,
+                   static_cast<const uint8_t*>(data) + row * srcBytesPerRow,
+                   rowSize);
+  }
+  pendingUploads_.push_back(std::move(upload));
+
+  return entry;
+}
+
+void TextureAtlas::touch(const AtlasEntry& entry) {
+  if (entry.resident_) {
+    pages_[entry.region_.page].lastUsedFrame = frame_;
+  }
+}
+
+igl::Result TextureAtlas::update() {
+  std::vector<igl::TextureUpload> uploads;
+  uploads.reserve(pendingUploads_.size());
+  for (const auto& upload : pendingUploads_) {
+    // released entries do not need their data anymore
+    if (!upload.entry.expired()) {
+      uploads.push_back({texture_.get(), {upload.range, upload.data.data(), 0}});
+    }
+  }
+
+  const igl::Result result =
+      uploads.empty() ? igl::Result() : device_.uploadTextureRegions(uploads);
+
+  pendingUploads_.clear();
+  frame_++;
+
+  return result;
+}
+
+bool TextureAtlas::packIntoPage(uint32_t pageIndex,
+                                uint32_t width,
+                                uint32_t height,
+                                AtlasRegion& outRegion) {
+  if (!pages_[pageIndex].packer.pack(width, height, outRegion.x, outRegion.y)) {
+    return false;
+  }
+  outRegion.page = pageIndex;
+  return true;
+}
+
+bool TextureAtlas::reclaimEmptyPages() {
+  bool reclaimed = false;
+  for (auto& page : pages_) {
+    page.entries.erase(std::remove_if(page.entries.begin(),
+                                      page.entries.end(),
+                                      [](const auto& entry) { return entry.expired(); }),
+                       page.entries.end());
+    if (page.entries.empty() && page.packer.getUsedArea() > 0) {
+      resetPage(page);
+      reclaimed = true;
+    }
+  }
+  return reclaimed;
+}
+
+bool TextureAtlas::evictPage() {
+  Page* oldest = nullptr;
+  for (auto& page : pages_) {
+    // images used in the current frame may still be drawn
+    if (page.lastUsedFrame < frame_ && page.packer.getUsedArea() > 0 &&
+        (!oldest || page.lastUsedFrame < oldest->lastUsedFrame)) {
+      oldest = &page;
+    }
+  }
+  if (!oldest) {
+    return false;
+  }
+
+  for (const auto& weakEntry : oldest->entries) {
+    if (auto entry = weakEntry.lock()) {
+      entry->resident_ = false;
+    }
+  }
+  resetPage(*oldest);
+  return true;
+}
+
+void TextureAtlas::resetPage(Page& page) {
+  const auto pageIndex = static_cast<size_t>(&page - pages_.data());
+
+  // a new image may take the place of an image which has not been uploaded yet
+  pendingUploads_.erase(std::remove_if(pendingUploads_.begin(),
+                                       pendingUploads_.end(),
+                                       [pageIndex](const PendingUpload& upload) {
+                                         return upload.range.layer == pageIndex;
+                                       }),
+                        pendingUploads_.end());
+
+  page.entries.clear();
+  page.packer.reset();
+}
+
+} // namespace textureatlas
+} // namespace iglu
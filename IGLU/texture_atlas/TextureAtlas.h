@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "SkylinePacker.h"
+
+#include <igl/Device.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace textureatlas {
+
+struct TextureAtlasConfig {
+  igl::TextureFormat format = igl::TextureFormat::RGBA_UNorm8;
+  /// Width and height of every page, i.e. of every layer of the texture array
+  uint32_t pageSize = 2048;
+  uint32_t numPages = 4;
+  /// Texels kept free right of and below every image, so linear filtering does not bleed
+  uint32_t padding = 1;
+};
+
+/// Where an image lives in the atlas. Texture coordinates of the image map to the atlas as
+/// `uv * uvScale + uvOffset` on layer `page`.
+struct AtlasRegion {
+  uint32_t page = 0;
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  float uvOffset[2] = {0.0f, 0.0f};
+  float uvScale[2] = {0.0f, 0.0f};
+};
+
+class TextureAtlas;
+
+/// An image in a TextureAtlas; its space is reclaimed once the handle is released
+class AtlasEntry final {
+ public:
+  /// false once the entry has been evicted to make room for new images; add it again to use it
+  [[nodiscard]] bool isResident() const {
+    return resident_;
+  }
+  [[nodiscard]] const AtlasRegion& getRegion() const {
+    return region_;
+  }
+
+ private:
+  friend class TextureAtlas;
+
+  AtlasRegion region_;
+  bool resident_ = true;
+};
+
+/**
+ * @brief Packs many small images (glyphs, icons, thumbnails) into the layers of one 2D texture
+ * array, so they share one texture binding.
+ *
+ * Every page (layer) is packed with a SkylinePacker. Images are copied when they are added and
+ * uploaded as sub-rectangles by the next update(), all of them with one
+ * igl::IDevice::uploadTextureRegions() call. A page is reused once all its entries are released.
+ * When no page has room, the least recently used page which was not used in the current frame is
+ * evicted as a whole: its entries stop being resident and have to be added again.
+ *
+ * All methods must be called from the render thread.
+ */
+class TextureAtlas final {
+ public:
+  TextureAtlas(igl::IDevice& device, TextureAtlasConfig config, igl::Result* outResult = nullptr);
+
+  /// Adds an image of `width` x `height` texels in the atlas format. `bytesPerRow` is 0 for
+  /// tightly packed data. Returns nullptr if the image is larger than a page or if every page is
+  /// in use in the current frame.
+  std::shared_ptr<AtlasEntry> add(uint32_t width,
+                                  uint32_t height,
+                                  const void* data,
+                                  size_t bytesPerRow = 0);
+
+  /// Marks `entry` as used in the current frame, so it is evicted last
+  void touch(const AtlasEntry& entry);
+
+  /// Uploads the images added since the last call and starts a new frame. Call once per frame
+  /// before rendering with the atlas.
+  igl::Result update();
+
+  [[nodiscard]] const std::shared_ptr<igl::ITexture>& getTexture() const {
+    return texture_;
+  }
+  [[nodiscard]] const TextureAtlasConfig& getConfig() const {
+    return config_;
+  }
+  /// Number of images waiting for update()
+  [[nodiscard]] size_t getNumPendingUploads() const {
+    return pendingUploads_.size();
+  }
+
+ private:
+  struct Page {
+    explicit Page(uint32_t size) : packer(size, size) {}
+
+    SkylinePacker packer;
+    std::vector<std::weak_ptr<AtlasEntry>> entries;
+    uint64_t lastUsedFrame = 0;
+  };
+
+  struct PendingUpload {
+    std::weak_ptr<AtlasEntry> entry;
+    igl::TextureRangeDesc range;
+    std::vector<uint8_t> data; // tightly packed
+  };
+
+  bool packIntoPage(uint32_t pageIndex, uint32_t width, uint32_t height, AtlasRegion& outRegion);
+  // resets pages without live entries; returns true if any page was reset
+  bool reclaimEmptyPages();
+  // evicts the least recently used page not used in the current frame
+  bool evictPage();
+  void resetPage(Page& page);
+
+ private:
+  igl::IDevice& device_;
+  TextureAtlasConfig config_;
+  std::shared_ptr<igl::ITexture> texture_;
+  std::vector<Page> pages_;
+  std::vector<PendingUpload> pendingUploads_;
+  uint64_t frame_ = 1;
+};
+
+} // namespace textureatlas
+} // namespace iglu
@@ -0,0 +1,797 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "TextureCompressor.h"
+
+#include <algorithm>
+#include <igl/ShaderCreator.h>
+#include <string>
+
+namespace iglu {
+namespace texturecompressor {
+
+namespace {
+
+constexpr uint32_t kThreadgroupSize = 8;
+
+constexpr size_t kParamsIndex = 0;
+constexpr size_t kBlocksIndex = 1;
+constexpr size_t kSourceIndex = 0;
+
+// matches the std430 and Metal layouts of the Params struct in the compute shaders
+struct Params {
+  uint32_t numBlocksX;
+  uint32_t numBlocksY;
+  int32_t sourceSize[2];
+  // bindless id of the source on Vulkan
+  uint32_t sourceId;
+  uint32_t padding[3];
+};
+static_assert(sizeof(Params) == 32, "Params must match the shader layout");
+
+enum class Encoding : uint8_t { None, Bc7, Etc2Rgb, Etc2Rgba, Astc };
+
+Encoding getEncoding(igl::TextureFormat format) {
+  switch (format) {
+  case igl::TextureFormat::RGBA_BC7_UNORM_4x4:
+  case igl::TextureFormat::RGBA_BC7_SRGB_4x4:
+    return Encoding::Bc7;
+  case igl::TextureFormat::RGB8_ETC2:
+  case igl::TextureFormat::SRGB8_ETC2:
+    return Encoding::Etc2Rgb;
+  case igl::TextureFormat::RGBA8_EAC_ETC2:
+  case igl::TextureFormat::SRGB8_A8_EAC_ETC2:
+    return Encoding::Etc2Rgba;
+  case igl::TextureFormat::RGBA_ASTC_4x4:
+  case igl::TextureFormat::SRGB8_A8_ASTC_4x4:
+    return Encoding::Astc;
+  default:
+    return Encoding::None;
+  }
+}
+
+const char* getEncodingDefine(Encoding encoding) {
+  switch (encoding) {
+  case Encoding::Bc7:
+    return "#define ENCODE_BC7 1\n";
+  case Encoding::Etc2Rgb:
+    return "#define ENCODE_ETC2_RGB 1\n";
+  case Encoding::Etc2Rgba:
+    return "#define ENCODE_ETC2_RGBA 1\n";
+  case Encoding::Astc:
+    return "#define ENCODE_ASTC 1\n";
+  case Encoding::None:
+    break;
+  }
+  IGL_UNREACHABLE_RETURN("");
+}
+
+// the GLSL image format qualifier of a source, or null if it cannot be a source
+const char* getSourceQualifier(igl::TextureFormat format) {
+  switch (format) {
+  case igl::TextureFormat::RGBA_UNorm8:
+    return "rgba8";
+  case igl::TextureFormat::RGBA_F16:
+    return "rgba16f";
+  default:
+    return nullptr;
+  }
+}
+
+// Shared by GLSL and MSL. Each prologue defines:
+//   INOUT(T)                 an inout function parameter of type T
+//   PIXELS_PARAM             the 16 pixels of a block, row by row, as a function parameter
+//   TABLE_BEGIN(T, name, N)  starts a constant array of N values of type T; TABLE_END ends it
+// and one of ENCODE_BC7, ENCODE_ETC2_RGB, ENCODE_ETC2_RGBA or ENCODE_ASTC. Pixels are in [0, 255].
+const char kBody[] = R"(
+float distance2(vec3 a, vec3 b) {
+  vec3 d = a - b;
+  return dot(d, d);
+}
+
+float distance2(vec4 a, vec4 b) {
+  vec4 d = a - b;
+  return dot(d, d);
+}
+
+// Appends the `numBits` low bits of `value` to the little-endian bit stream of a 128-bit block
+void putBits(INOUT(uvec4) block, INOUT(uint) pos, uint value, uint numBits) {
+  uint word = pos >> 5u;
+  uint shift = pos & 31u;
+  block[word] |= value << shift;
+  if (shift + numBits > 32u) {
+    block[word + 1u] |= value >> (32u - shift);
+  }
+  pos += numBits;
+}
+
+uint byteSwap(uint v) {
+  return (v >> 24u) | ((v >> 8u) & 0xff00u) | ((v << 8u) & 0xff0000u) | (v << 24u);
+}
+
+// Fits a line to the channels of the pixels selected by `mask`: through their mean, along the
+// principal axis of their covariance. e0 and e1 are the extreme projections of the pixels.
+void fitLine(PIXELS_PARAM, vec4 mask, INOUT(vec4) e0, INOUT(vec4) e1) {
+  vec4 mean = vec4(0.0);
+  vec4 lo = vec4(255.0);
+  vec4 hi = vec4(0.0);
+  for (int i = 0; i < 16; i++) {
+    mean += pixels[i] * mask;
+    lo = min(lo, pixels[i]);
+    hi = max(hi, pixels[i]);
+  }
+  mean /= 16.0;
+  // the columns of the covariance matrix
+  vec4 c0 = vec4(0.0);
+  vec4 c1 = vec4(0.0);
+  vec4 c2 = vec4(0.0);
+  vec4 c3 = vec4(0.0);
+  for (int i = 0; i < 16; i++) {
+    vec4 d = pixels[i] * mask - mean;
+    c0 += d * d.x;
+    c1 += d * d.y;
+    c2 += d * d.z;
+    c3 += d * d.w;
+  }
+  // power iteration, starting from the diagonal of the bounding box
+  vec4 axis = (hi - lo) * mask;
+  for (int k = 0; k < 4; k++) {
+    axis = c0 * axis.x + c1 * axis.y + c2 * axis.z + c3 * axis.w;
+    float len = max(max(abs(axis.x), abs(axis.y)), max(abs(axis.z), abs(axis.w)));
+    axis = len > 0.0 ? axis / len : axis;
+  }
+  float tMin = 0.0;
+  float tMax = 0.0;
+  float len2 = dot(axis, axis);
+  if (len2 > 0.0) {
+    for (int i = 0; i < 16; i++) {
+      float t = dot(pixels[i] * mask - mean, axis) / len2;
+      tMin = min(tMin, t);
+      tMax = max(tMax, t);
+    }
+  }
+  e0 = clamp(mean + axis * tMin, vec4(0.0), vec4(255.0));
+  e1 = clamp(mean + axis * tMax, vec4(0.0), vec4(255.0));
+}
+
+// BC7 mode 6: RGBA endpoints of 7 bits plus a p-bit each, and 4-bit indices
+
+// Quantizes an endpoint to 7 bits per channel and a p-bit: the decoded value is q * 2 + p
+void quantizeBc7(vec4 e, INOUT(uvec4) q, INOUT(uint) p) {
+  float bestError = 1e30;
+  for (uint bit = 0u; bit < 2u; bit++) {
+    vec4 candidate = clamp(round((e - float(bit)) * 0.5), vec4(0.0), vec4(127.0));
+    float error = distance2(candidate * 2.0 + float(bit), e);
+    if (error < bestError) {
+      bestError = error;
+      q = uvec4(candidate);
+      p = bit;
+    }
+  }
+}
+
+uvec4 encodeBc7(PIXELS_PARAM) {
+  vec4 e0 = vec4(0.0);
+  vec4 e1 = vec4(0.0);
+  fitLine(pixels, vec4(1.0), e0, e1);
+  uvec4 q0 = uvec4(0u);
+  uvec4 q1 = uvec4(0u);
+  uint p0 = 0u;
+  uint p1 = 0u;
+  quantizeBc7(e0, q0, p0);
+  quantizeBc7(e1, q1, p1);
+
+  vec4 d0 = vec4(q0 * 2u + p0);
+  vec4 dir = vec4(q1 * 2u + p1) - d0;
+  float len2 = dot(dir, dir);
+  uint indices[16];
+  for (int i = 0; i < 16; i++) {
+    float t = len2 > 0.0 ? dot(pixels[i] - d0, dir) / len2 : 0.0;
+    indices[i] = uint(clamp(round(t * 15.0), 0.0, 15.0));
+  }
+  // the most significant bit of the index of the first pixel is implicitly 0
+  if (indices[0] > 7u) {
+    uvec4 q = q0;
+    q0 = q1;
+    q1 = q;
+    uint p = p0;
+    p0 = p1;
+    p1 = p;
+    for (int i = 0; i < 16; i++) {
+      indices[i] = 15u - indices[i];
+    }
+  }
+
+  uvec4 block = uvec4(0u);
+  uint pos = 0u;
+  putBits(block, pos, 64u, 7u);
+  for (int c = 0; c < 4; c++) {
+    putBits(block, pos, q0[c], 7u);
+    putBits(block, pos, q1[c], 7u);
+  }
+  putBits(block, pos, p0, 1u);
+  putBits(block, pos, p1, 1u);
+  putBits(block, pos, indices[0], 3u);
+  for (int i = 1; i < 16; i++) {
+    putBits(block, pos, indices[i], 4u);
+  }
+  return block;
+}
+
+// ETC2 RGB in the ETC1 individual and differential modes. Bytes are big-endian and the pixels of
+// the index bits are ordered column by column.
+
+// the two positive modifiers of each intensity table
+TABLE_BEGIN(int, kEtcModifiers, 16)
+  2, 8, 5, 17, 9, 29, 13, 42, 18, 60, 24, 80, 33, 106, 47, 183
+TABLE_END;
+
+// Returns the error of the best intensity table for the pixels of one half of the block around
+// `base`, and that table and the index bits of the pixels
+float fitEtcHalf(PIXELS_PARAM, bool flip, uint side, vec3 base, INOUT(uint) table,
+                 INOUT(uint) bits) {
+  float bestError = 1e30;
+  for (uint t = 0u; t < 8u; t++) {
+    float error = 0.0;
+    uint tableBits = 0u;
+    for (uint i = 0u; i < 16u; i++) {
+      uint x = i & 3u;
+      uint y = i >> 2u;
+      if ((flip ? y >> 1u : x >> 1u) != side) {
+        continue;
+      }
+      float bestPixelError = 1e30;
+      uint bestIndex = 0u;
+      // indices 0 and 1 add the two modifiers, 2 and 3 subtract them
+      for (uint k = 0u; k < 4u; k++) {
+        float m = float(kEtcModifiers[t * 2u + (k & 1u)]) * ((k & 2u) != 0u ? -1.0 : 1.0);
+        float e = distance2(clamp(base + vec3(m), vec3(0.0), vec3(255.0)), pixels[i].rgb);
+        if (e < bestPixelError) {
+          bestPixelError = e;
+          bestIndex = k;
+        }
+      }
+      error += bestPixelError;
+      uint j = x * 4u + y;
+      tableBits |= ((bestIndex >> 1u) << (16u + j)) | ((bestIndex & 1u) << j);
+    }
+    if (error < bestError) {
+      bestError = error;
+      table = t;
+      bits = tableBits;
+    }
+  }
+  return bestError;
+}
+
+uvec2 encodeEtc(PIXELS_PARAM) {
+  float bestError = 1e30;
+  uvec2 bestBlock = uvec2(0u);
+  // the halves are side by side, or on top of each other if flipped
+  for (uint f = 0u; f < 2u; f++) {
+    bool flip = f == 1u;
+    vec3 avg0 = vec3(0.0);
+    vec3 avg1 = vec3(0.0);
+    for (uint i = 0u; i < 16u; i++) {
+      if ((flip ? i >> 3u : (i >> 1u) & 1u) == 0u) {
+        avg0 += pixels[i].rgb;
+      } else {
+        avg1 += pixels[i].rgb;
+      }
+    }
+    avg0 /= 8.0;
+    avg1 /= 8.0;
+
+    // differential mode: 5-bit colors, the second one within [-4, 3] of the first
+    ivec3 c0 = ivec3(round(avg0 * (31.0 / 255.0)));
+    ivec3 c1 = ivec3(round(avg1 * (31.0 / 255.0)));
+    ivec3 delta = c1 - c0;
+    bool isDifferential = min(delta.x, min(delta.y, delta.z)) >= -4 &&
+                          max(delta.x, max(delta.y, delta.z)) <= 3;
+    vec3 base0;
+    vec3 base1;
+    uint word0;
+    if (isDifferential) {
+      base0 = vec3((c0 << 3) | (c0 >> 2));
+      base1 = vec3((c1 << 3) | (c1 >> 2));
+      uvec3 c = (uvec3(c0) << 3u) | uvec3(delta & 7);
+      word0 = c.r | (c.g << 8u) | (c.b << 16u) | (2u << 24u);
+    } else {
+      c0 = ivec3(round(avg0 * (15.0 / 255.0)));
+      c1 = ivec3(round(avg1 * (15.0 / 255.0)));
+      base0 = vec3(c0 * 17);
+      base1 = vec3(c1 * 17);
+      uvec3 c = (uvec3(c0) << 4u) | uvec3(c1);
+      word0 = c.r | (c.g << 8u) | (c.b << 16u);
+    }
+
+    uint table0 = 0u;
+    uint table1 = 0u;
+    uint bits0 = 0u;
+    uint bits1 = 0u;
+    float error = fitEtcHalf(pixels, flip, 0u, base0, table0, bits0) +
+                  fitEtcHalf(pixels, flip, 1u, base1, table1, bits1);
+    if (error < bestError) {
+      bestError = error;
+      word0 |= ((table0 << 5u) | (table1 << 2u) | f) << 24u;
+      bestBlock = uvec2(word0, byteSwap(bits0 | bits1));
+    }
+  }
+  return bestBlock;
+}
+
+// EAC alpha, the first half of RGBA8_EAC_ETC2 blocks
+
+// the 8 modifiers of each table
+TABLE_BEGIN(int, kEacModifiers, 128)
+  -3, -6, -9, -15, 2, 5, 8, 14,
+  -3, -7, -10, -13, 2, 6, 9, 12,
+  -2, -5, -8, -13, 1, 4, 7, 12,
+  -2, -4, -6, -13, 1, 3, 5, 12,
+  -3, -6, -8, -12, 2, 5, 7, 11,
+  -3, -7, -9, -11, 2, 6, 8, 10,
+  -4, -7, -8, -11, 3, 6, 7, 10,
+  -3, -5, -8, -11, 2, 4, 7, 10,
+  -2, -6, -8, -10, 1, 5, 7, 9,
+  -2, -5, -8, -10, 1, 4, 7, 9,
+  -2, -4, -8, -10, 1, 3, 7, 9,
+  -2, -5, -7, -10, 1, 4, 6, 9,
+  -3, -4, -7, -10, 2, 3, 6, 9,
+  -1, -2, -3, -10, 0, 1, 2, 9,
+  -4, -6, -8, -9, 3, 5, 7, 8,
+  -3, -5, -7, -9, 2, 4, 6, 8
+TABLE_END;
+
+uvec2 encodeEacAlpha(PIXELS_PARAM) {
+  float lo = 255.0;
+  float hi = 0.0;
+  for (int i = 0; i < 16; i++) {
+    lo = min(lo, pixels[i].a);
+    hi = max(hi, pixels[i].a);
+  }
+  float base = round((lo + hi) * 0.5);
+  float bestError = 1e30;
+  uint bestTable = 0u;
+  uint bestMultiplier = 1u;
+  // the 3-bit indices of the first and last 8 pixels, first pixel in the most significant bits
+  uint bestHi = 0u;
+  uint bestLo = 0u;
+  for (uint t = 0u; t < 16u; t++) {
+    float range = float(kEacModifiers[t * 8u + 7u] - kEacModifiers[t * 8u + 3u]);
+    float multiplier = clamp(round((hi - lo) / range), 1.0, 15.0);
+    float error = 0.0;
+    uint bitsHi = 0u;
+    uint bitsLo = 0u;
+    for (uint i = 0u; i < 16u; i++) {
+      float bestPixelError = 1e30;
+      uint bestIndex = 0u;
+      for (uint k = 0u; k < 8u; k++) {
+        float v = clamp(base + float(kEacModifiers[t * 8u + k]) * multiplier, 0.0, 255.0);
+        float e = (v - pixels[i].a) * (v - pixels[i].a);
+        if (e < bestPixelError) {
+          bestPixelError = e;
+          bestIndex = k;
+        }
+      }
+      error += bestPixelError;
+      uint j = (i & 3u) * 4u + (i >> 2u);
+      if (j < 8u) {
+        bitsHi |= bestIndex << (21u - 3u * j);
+      } else {
+        bitsLo |= bestIndex << (21u - 3u * (j - 8u));
+      }
+    }
+    if (error < bestError) {
+      bestError = error;
+      bestTable = t;
+      bestMultiplier = uint(multiplier);
+      bestHi = bitsHi;
+      bestLo = bitsLo;
+    }
+  }
+  uint word0 = uint(base) | (((bestMultiplier << 4u) | bestTable) << 8u) |
+               (((bestHi >> 16u) & 0xffu) << 16u) | (((bestHi >> 8u) & 0xffu) << 24u);
+  uint word1 = (bestHi & 0xffu) | (((bestLo >> 16u) & 0xffu) << 8u) |
+               (((bestLo >> 8u) & 0xffu) << 16u) | ((bestLo & 0xffu) << 24u);
+  return uvec2(word0, word1);
+}
+
+// ASTC 4x4 with one partition and 8-bit endpoints: LDR RGB direct with 3-bit weights for opaque
+// blocks, LDR RGBA direct with 2-bit weights otherwise
+
+uvec4 encodeAstc(PIXELS_PARAM) {
+  bool isOpaque = true;
+  for (int i = 0; i < 16; i++) {
+    isOpaque = isOpaque && pixels[i].a >= 255.0;
+  }
+  vec4 mask = isOpaque ? vec4(1.0, 1.0, 1.0, 0.0) : vec4(1.0);
+  vec4 e0 = vec4(0.0);
+  vec4 e1 = vec4(0.0);
+  fitLine(pixels, mask, e0, e1);
+  vec4 d0 = round(e0);
+  vec4 d1 = round(e1);
+  // the decoder swaps the endpoints and contracts blue when the second one is darker
+  if (d1.r + d1.g + d1.b < d0.r + d0.g + d0.b) {
+    vec4 d = d0;
+    d0 = d1;
+    d1 = d;
+  }
+
+  uint weightBits = isOpaque ? 3u : 2u;
+  uint numChannels = isOpaque ? 3u : 4u;
+  uvec4 block = uvec4(0u);
+  uint pos = 0u;
+  // the block modes of a 4x4 weight grid with 8 (3 bits) or 4 (2 bits) weight values
+  putBits(block, pos, isOpaque ? 0x53u : 0x42u, 11u);
+  // one partition
+  putBits(block, pos, 0u, 2u);
+  // the endpoint mode
+  putBits(block, pos, isOpaque ? 8u : 12u, 4u);
+  for (uint c = 0u; c < numChannels; c++) {
+    putBits(block, pos, uint(d0[c]), 8u);
+    putBits(block, pos, uint(d1[c]), 8u);
+  }
+
+  // the weights are stored from the top of the block down
+  float maxWeight = float((1u << weightBits) - 1u);
+  vec4 dir = (d1 - d0) * mask;
+  float len2 = dot(dir, dir);
+  for (uint i = 0u; i < 16u; i++) {
+    float t = len2 > 0.0 ? dot((pixels[i] - d0) * mask, dir) / len2 : 0.0;
+    uint weight = uint(clamp(round(t * maxWeight), 0.0, maxWeight));
+    for (uint b = 0u; b < weightBits; b++) {
+      if (((weight >> b) & 1u) != 0u) {
+        uint bit = 127u - (i * weightBits + b);
+        block[bit >> 5u] |= 1u << (bit & 31u);
+      }
+    }
+  }
+  return block;
+}
+
+#if defined(ENCODE_BC7)
+#define BLOCK_WORDS 4u
+uvec4 encodeBlock(PIXELS_PARAM) {
+  return encodeBc7(pixels);
+}
+#elif defined(ENCODE_ETC2_RGB)
+#define BLOCK_WORDS 2u
+uvec4 encodeBlock(PIXELS_PARAM) {
+  return uvec4(encodeEtc(pixels), 0u, 0u);
+}
+#elif defined(ENCODE_ETC2_RGBA)
+#define BLOCK_WORDS 4u
+uvec4 encodeBlock(PIXELS_PARAM) {
+  return uvec4(encodeEacAlpha(pixels), encodeEtc(pixels));
+}
+#else
+#define BLOCK_WORDS 4u
+uvec4 encodeBlock(PIXELS_PARAM) {
+  return encodeAstc(pixels);
+}
+#endif
+)";
+
+const char kGlslPrologue[] = R"(
+#define INOUT(T) inout T
+#define PIXELS_PARAM vec4 pixels[16]
+#define TABLE_BEGIN(T, name, N) const T name[N] = T[N](
+#define TABLE_END )
+)";
+
+const char kGlslMain[] = R"(
+void main() {
+  uvec2 blockPos = gl_GlobalInvocationID.xy;
+  if (blockPos.x >= params.numBlocksX || blockPos.y >= params.numBlocksY) {
+    return;
+  }
+  vec4 pixels[16];
+  for (int i = 0; i < 16; i++) {
+    // blocks which extend past the source repeat its edges
+    ivec2 p = min(ivec2(blockPos * 4u) + ivec2(i & 3, i >> 2), params.sourceSize - 1);
+    pixels[i] = round(clamp(LOAD_SOURCE(p), vec4(0.0), vec4(1.0)) * 255.0);
+  }
+  uvec4 block = encodeBlock(pixels);
+  uint index = (blockPos.y * params.numBlocksX + blockPos.x) * BLOCK_WORDS;
+  for (uint w = 0u; w < BLOCK_WORDS; w++) {
+    blocks[index + w] = block[w];
+  }
+}
+)";
+
+const char kGlslParams[] = R"(
+  uint numBlocksX;
+  uint numBlocksY;
+  ivec2 sourceSize;
+  uint sourceId;
+} params;
+)";
+
+const char kGlslBlocks[] = R"(writeonly buffer Blocks {
+  uint blocks[];
+};
+)";
+
+const char kMetalSource[] = R"(
+#include <metal_stdlib>
+using namespace metal;
+
+typedef float3 vec3;
+typedef float4 vec4;
+typedef int2 ivec2;
+typedef int3 ivec3;
+typedef uint2 uvec2;
+typedef uint3 uvec3;
+typedef uint4 uvec4;
+
+struct Params {
+  uint numBlocksX;
+  uint numBlocksY;
+  int2 sourceSize;
+  uint sourceId;
+  uint padding[3];
+};
+
+#define INOUT(T) thread T&
+#define PIXELS_PARAM thread const float4* pixels
+#define TABLE_BEGIN(T, name, N) constant T name[N] = {
+#define TABLE_END }
+)";
+
+const char kMetalKernel[] = R"(
+kernel void compressMain(texture2d<float, access::read> sourceImage [[texture(0)]],
+                         constant Params& params [[buffer(0)]],
+                         device uint* blocks [[buffer(1)]],
+                         uint2 blockPos [[thread_position_in_grid]]) {
+  if (blockPos.x >= params.numBlocksX || blockPos.y >= params.numBlocksY) {
+    return;
+  }
+  float4 pixels[16];
+  for (int i = 0; i < 16; i++) {
+    const int2 p = min(int2(blockPos * 4u) + int2(i & 3, i >> 2), params.sourceSize - 1);
+    pixels[i] = round(clamp(sourceImage.read(uint2(p)), float4(0.0), float4(1.0)) * 255.0);
+  }
+  const uint4 block = encodeBlock(pixels);
+  const uint index = (blockPos.y * params.numBlocksX + blockPos.x) * BLOCK_WORDS;
+  for (uint w = 0; w < BLOCK_WORDS; w++) {
+    blocks[index + w] = block[w];
+  }
+}
+)";
+
+std::string getComputeSource(igl::BackendType backendType,
+                             Encoding encoding,
+                             igl::TextureFormat sourceFormat) {
+  const char* encodingDefine = getEncodingDefine(encoding);
+  if (backendType == igl::BackendType::Metal) {
+    return std::string(encodingDefine) + kMetalSource + kBody + kMetalKernel;
+  }
+  const std::string qualifier = getSourceQualifier(sourceFormat);
+  const std::string localSize = std::to_string(kThreadgroupSize);
+  std::string source;
+  if (backendType == igl::BackendType::Vulkan) {
+    // kBinding_StorageImages in VulkanContext.cpp
+    source += "layout (set = 3, binding = 6, " + qualifier +
+              ") uniform readonly image2D kImagesIn[];\n";
+    source += "layout (push_constant) uniform Params {";
+    source += kGlslParams;
+    source += "layout (set = 2, binding = " + std::to_string(kBlocksIndex) + ", std430) ";
+    source += kGlslBlocks;
+    source += "#define LOAD_SOURCE(p) imageLoad(kImagesIn[params.sourceId], p)\n";
+  } else {
+    source += "#version 310 es\nprecision highp float;\nprecision highp int;\n";
+    source += "precision highp image2D;\n";
+    source += "layout (binding = " + std::to_string(kSourceIndex) + ", " + qualifier +
+              ") uniform readonly image2D sourceImage;\n";
+    source += "layout (binding = " + std::to_string(kParamsIndex) +
+              ", std430) readonly buffer Params {";
+    source += kGlslParams;
+    source += "layout (binding = " + std::to_string(kBlocksIndex) + ", std430) ";
+    source += kGlslBlocks;
+    source += "#define LOAD_SOURCE(p) imageLoad(sourceImage, p)\n";
+  }
+  return source + "layout (local_size_x = " + localSize + ", local_size_y = " + localSize +
+         ") in;\n" + encodingDefine + kGlslPrologue + kBody + kGlslMain;
+}
+
+} // namespace
+
+TextureCompressor::TextureCompressor(igl::IDevice& device, igl::Result* outResult) :
+  device_(device) {
+  if (!device_.hasFeature(igl::DeviceFeatures::Compute)) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::Unsupported, "The texture compressor requires compute");
+    return;
+  }
+  if (device_.getBackendType() == igl::BackendType::Vulkan &&
+      !device_.hasFeature(igl::DeviceFeatures::TextureBindless)) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::Unsupported,
+                           "The texture compressor requires bindless textures on Vulkan");
+    return;
+  }
+  if (device_.getBackendType() == igl::BackendType::OpenGL) {
+    igl::BufferDesc desc(igl::BufferDesc::BufferTypeBits::Storage,
+                         nullptr,
+                         sizeof(Params),
+                         igl::ResourceStorage::Shared);
+    desc.debugName = "TextureCompressor params";
+    igl::Result result;
+    paramsBuffer_ = device_.createBuffer(desc, &result);
+    if (!result.isOk()) {
+      igl::Result::setResult(outResult, std::move(result));
+      return;
+    }
+  }
+  igl::Result::setOk(outResult);
+}
+
+TextureCompressor::~TextureCompressor() = default;
+
+bool TextureCompressor::canEncode(igl::TextureFormat format) {
+  return getEncoding(format) != Encoding::None;
+}
+
+bool TextureCompressor::isSupported(igl::TextureFormat format) const {
+  return canEncode(format) &&
+         (device_.getTextureFormatCapabilities(format) &
+          igl::ICapabilities::TextureFormatCapabilityBits::Sampled) != 0;
+}
+
+igl::TextureFormat TextureCompressor::chooseFormat(bool hasAlpha, bool isSrgb) const {
+  const igl::TextureFormat candidates[] = {
+      isSrgb ? igl::TextureFormat::RGBA_BC7_SRGB_4x4 : igl::TextureFormat::RGBA_BC7_UNORM_4x4,
+      isSrgb ? igl::TextureFormat::SRGB8_A8_ASTC_4x4 : igl::TextureFormat::RGBA_ASTC_4x4,
+      hasAlpha ? (isSrgb ? igl::TextureFormat::SRGB8_A8_EAC_ETC2
+                         : igl::TextureFormat::RGBA8_EAC_ETC2)
+               : (isSrgb ? igl::TextureFormat::SRGB8_ETC2 : igl::TextureFormat::RGB8_ETC2),
+  };
+  for (igl::TextureFormat format : candidates) {
+    if (isSupported(format)) {
+      return format;
+    }
+  }
+  return igl::TextureFormat::Invalid;
+}
+
+std::shared_ptr<igl::IComputePipelineState> TextureCompressor::getPipeline(
+    igl::TextureFormat format,
+    igl::TextureFormat sourceFormat,
+    igl::Result* outResult) {
+  // only the encoding and the source format change the shader
+  const Encoding encoding = getEncoding(format);
+  for (const Pipeline& pipeline : pipelines_) {
+    if (getEncoding(pipeline.format) == encoding && pipeline.sourceFormat == sourceFormat) {
+      igl::Result::setOk(outResult);
+      return pipeline.state;
+    }
+  }
+
+  const igl::BackendType backendType = device_.getBackendType();
+  const std::string source = getComputeSource(backendType, encoding, sourceFormat);
+  const std::string debugName = std::string("TextureCompressor ") +
+                                igl::TextureFormatProperties::fromTextureFormat(format).name;
+  igl::Result result;
+  std::shared_ptr<igl::IShaderStages> stages = igl::ShaderStagesCreator::fromModuleStringInput(
+      device_,
+      source.c_str(),
+      backendType == igl::BackendType::Metal ? "compressMain" : "main",
+      debugName,
+      &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+
+  igl::ComputePipelineDesc desc;
+  desc.shaderStages = std::move(stages);
+  desc.imagesMap[kSourceIndex] = igl::genNameHandle("sourceImage");
+  desc.buffersMap[kParamsIndex] = igl::genNameHandle("Params");
+  desc.buffersMap[kBlocksIndex] = igl::genNameHandle("Blocks");
+  desc.debugName = debugName;
+  std::shared_ptr<igl::IComputePipelineState> state =
+      device_.createComputePipeline(desc, &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  pipelines_.push_back({format, sourceFormat, state});
+  igl::Result::setOk(outResult);
+  return state;
+}
+
+igl::Result TextureCompressor::compress(igl::ICommandBuffer& commandBuffer,
+                                        igl::ITexture& source,
+                                        igl::ITexture& output,
+                                        size_t mipLevel) {
+  const igl::TextureFormat format = output.getFormat();
+  if (!isSupported(format)) {
+    return igl::Result(igl::Result::Code::Unsupported,
+                       "The device cannot sample the output format or it has no encoder");
+  }
+  const igl::TextureFormat sourceFormat = source.getFormat();
+  if (getSourceQualifier(sourceFormat) == nullptr) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid,
+                       "Sources must be RGBA_UNorm8 or RGBA_F16 textures");
+  }
+  if (output.getType() != igl::TextureType::TwoD || mipLevel >= output.getNumMipLevels()) {
+    return igl::Result(igl::Result::Code::ArgumentOutOfRange,
+                       "The output must be a 2D texture with the mip level");
+  }
+  const igl::Dimensions sourceSize = source.getDimensions();
+  const igl::Dimensions outputSize = output.getDimensions();
+  const size_t width = std::max<size_t>(outputSize.width >> mipLevel, 1);
+  const size_t height = std::max<size_t>(outputSize.height >> mipLevel, 1);
+  if (sourceSize.width != width || sourceSize.height != height) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid,
+                       "The source must have the size of the output mip level");
+  }
+
+  igl::Result result;
+  const std::shared_ptr<igl::IComputePipelineState> pipeline =
+      getPipeline(format, sourceFormat, &result);
+  if (!result.isOk()) {
+    return result;
+  }
+
+  const auto range = igl::TextureRangeDesc::new2D(0, 0, width, height, mipLevel);
+  const size_t numBytes = output.getProperties().getBytesPerRange(range);
+  if (!blocks_ || blocks_->getSizeInBytes() < numBytes) {
+    igl::BufferDesc desc(igl::BufferDesc::BufferTypeBits::Storage,
+                         nullptr,
+                         numBytes,
+                         igl::ResourceStorage::Private);
+    desc.debugName = "TextureCompressor blocks";
+    blocks_ = device_.createBuffer(desc, &result);
+    if (!result.isOk()) {
+      blocks_ = nullptr;
+      return result;
+    }
+  }
+
+  Params params = {};
+  params.numBlocksX = static_cast<uint32_t>((width + 3) / 4);
+  params.numBlocksY = static_cast<uint32_t>((height + 3) / 4);
+  params.sourceSize[0] = static_cast<int32_t>(width);
+  params.sourceSize[1] = static_cast<int32_t>(height);
+
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return igl::Result(igl::Result::Code::RuntimeError, "Cannot create a compute encoder");
+  }
+  encoder->pushDebugGroupLabel("TextureCompressor");
+  encoder->bindComputePipelineState(pipeline);
+  switch (device_.getBackendType()) {
+  case igl::BackendType::Vulkan:
+    params.sourceId = static_cast<uint32_t>(source.getTextureId());
+    encoder->bindPushConstants(&params, sizeof(params));
+    break;
+  case igl::BackendType::Metal:
+    encoder->bindBytes(kParamsIndex, &params, sizeof(params));
+    break;
+  default:
+    // OpenGL runs the previous dispatches before uploading the parameters of this one
+    paramsBuffer_->upload(&params, {sizeof(params), 0});
+    encoder->bindBuffer(kParamsIndex, paramsBuffer_, 0);
+    break;
+  }
+  encoder->bindBuffer(kBlocksIndex, blocks_, 0);
+  encoder->bindTexture(kSourceIndex, &source);
+  encoder->dispatchThreadGroups(
+      igl::Dimensions((params.numBlocksX + kThreadgroupSize - 1) / kThreadgroupSize,
+                      (params.numBlocksY + kThreadgroupSize - 1) / kThreadgroupSize,
+                      1),
+      igl::Dimensions(kThreadgroupSize, kThreadgroupSize, 1));
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+
+  commandBuffer.copyBufferToTexture(*blocks_, 0, output, range);
+  return igl::Result();
+}
+
+} // namespace texturecompressor
+} // namespace iglu
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/IGL.h>
+#include <memory>
+#include <vector>
+
+namespace iglu {
+namespace texturecompressor {
+
+/**
+ * @brief Compresses textures which are generated at run time, e.g. baked lightmaps, procedural
+ * terrain or render-to-texture results, into block compressed formats on the GPU.
+ *
+ * Each 4x4 block is encoded by one compute invocation: BC7 (mode 6, a single RGBA line with 4-bit
+ * indices), ETC2 (ETC1-compatible individual and differential modes, with EAC alpha for
+ * RGBA8_EAC_ETC2) and ASTC 4x4 (one partition, RGB or RGBA endpoints depending on the block's
+ * alpha). The encoders favor speed over quality: expect about the quality of a fast offline
+ * encoder, without the block modes the offline encoders search.
+ *
+ * The blocks are written into a storage buffer and copied into the output with
+ * igl::ICommandBuffer::copyBufferToTexture(), so the output only needs to be sampled. Sources are
+ * RGBA_UNorm8 or RGBA_F16 storage textures (see getSourceUsage()); RGBA_F16 is clamped to [0, 1].
+ *
+ * Requires DeviceFeatures::Compute, and DeviceFeatures::TextureBindless on Vulkan.
+ */
+class TextureCompressor final {
+ public:
+  TextureCompressor(igl::IDevice& device, igl::Result* outResult);
+  ~TextureCompressor();
+
+  TextureCompressor(const TextureCompressor&) = delete;
+  TextureCompressor& operator=(const TextureCompressor&) = delete;
+
+  /// True if `format` has an encoder, whether the device samples it or not
+  [[nodiscard]] static bool canEncode(igl::TextureFormat format);
+  /// True if `format` has an encoder and the device can sample it
+  [[nodiscard]] bool isSupported(igl::TextureFormat format) const;
+  /// The best supported format for the content: BC7, then ASTC 4x4, then ETC2. Invalid if the
+  /// device samples none of them.
+  [[nodiscard]] igl::TextureFormat chooseFormat(bool hasAlpha, bool isSrgb = false) const;
+
+  /// The usage sources need besides what the application uses them for
+  [[nodiscard]] static igl::TextureDesc::TextureUsage getSourceUsage() {
+    return igl::TextureDesc::TextureUsageBits::Storage;
+  }
+
+  /// Encodes mip level 0 of `source` into `mipLevel` of `output`, a 2D texture in a supported
+  /// format whose mip level has the size of the source. Must be called outside of render passes;
+  /// the output can be sampled by the following passes of the command buffer.
+  igl::Result compress(igl::ICommandBuffer& commandBuffer,
+                       igl::ITexture& source,
+                       igl::ITexture& output,
+                       size_t mipLevel = 0);
+
+ private:
+  std::shared_ptr<igl::IComputePipelineState> getPipeline(igl::TextureFormat format,
+                                                          igl::TextureFormat sourceFormat,
+                                                          igl::Result* outResult);
+
+  igl::IDevice& device_;
+
+  struct Pipeline {
+    igl::TextureFormat format = igl::TextureFormat::Invalid;
+    igl::TextureFormat sourceFormat = igl::TextureFormat::Invalid;
+    std::shared_ptr<igl::IComputePipelineState> state;
+  };
+  // created on first use, as the shaders depend on both formats
+  std::vector<Pipeline> pipelines_;
+
+  // the encoded blocks, grown as needed
+  std::shared_ptr<igl::IBuffer> blocks_;
+  // OpenGL only: the parameters of the last dispatch
+  std::shared_ptr<igl::IBuffer> paramsBuffer_;
+};
+
+} // namespace texturecompressor
+} // namespace iglu
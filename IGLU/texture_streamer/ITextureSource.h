@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/Texture.h>
+#include <vector>
+
+namespace iglu {
+namespace texturestreamer {
+
+/// Provides the mip levels of a streamed texture, i.e. by reading and decompressing them from disk
+class ITextureSource {
+ public:
+  virtual ~ITextureSource() = default;
+
+  /// A 2D texture including its full mip chain. Called once on the thread adding the texture.
+  [[nodiscard]] virtual igl::TextureDesc getDesc() const = 0;
+
+  /// Called on a worker thread. Reads mip level `mipLevel` of the full mip chain into `outData`,
+  /// tightly packed and ready for igl::ITexture::upload(). Returns false on failure.
+  virtual bool loadMipLevel(uint32_t mipLevel, std::vector<uint8_t>& outData) = 0;
+};
+
+} // namespace texturestreamer
+} // namespace iglu
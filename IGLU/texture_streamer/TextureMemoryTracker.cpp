@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "TextureMemoryTracker.h"
+
+#include <igl/Buffer.h>
+#include <igl/Texture.h>
+
+namespace iglu {
+namespace texturestreamer {
+
+namespace {
+size_t remove(std::unordered_map<const void*, size_t>& sizes, const void* resource) {
+  auto it = sizes.find(resource);
+  if (it == sizes.end()) {
+    return 0;
+  }
+  const size_t size = it->second;
+  sizes.erase(it);
+  return size;
+}
+} // namespace
+
+void TextureMemoryTracker::didCreate(const igl::ITexture& texture) noexcept {
+  const size_t size = texture.getEstimatedSizeInBytes();
+  std::lock_guard<std::mutex> lock(mutex_);
+  sizes_[&texture] = size;
+  textureMemory_ += size;
+}
+
+void TextureMemoryTracker::willDelete(const igl::ITexture& texture) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  textureMemory_ -= remove(sizes_, &texture);
+}
+
+void TextureMemoryTracker::didCreate(const igl::IBuffer& buffer) noexcept {
+  const size_t size = buffer.getSizeInBytes();
+  std::lock_guard<std::mutex> lock(mutex_);
+  sizes_[&buffer] = size;
+  bufferMemory_ += size;
+}
+
+void TextureMemoryTracker::willDelete(const igl::IBuffer& buffer) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  bufferMemory_ -= remove(sizes_, &buffer);
+}
+
+size_t TextureMemoryTracker::getTextureMemory() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return textureMemory_;
+}
+
+size_t TextureMemoryTracker::getBufferMemory() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bufferMemory_;
+}
+
+size_t TextureMemoryTracker::getTotalMemory() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return textureMemory_ + bufferMemory_;
+}
+
+} // namespace texturestreamer
+} // namespace iglu
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/IResourceTracker.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace iglu {
+namespace texturestreamer {
+
+/// An igl::IResourceTracker which adds up the estimated GPU memory of all textures and buffers
+/// created by a device, so TextureStreamer can keep the whole application within its budget.
+/// Install it with igl::IDevice::setResourceTracker() before creating resources.
+class TextureMemoryTracker final : public igl::IResourceTracker {
+ public:
+  void didCreate(const igl::ITexture& texture) noexcept override;
+  void willDelete(const igl::ITexture& texture) noexcept override;
+  void didCreate(const igl::IBuffer& buffer) noexcept override;
+  void willDelete(const igl::IBuffer& buffer) noexcept override;
+  void didCreate(const igl::IFramebuffer& /*framebuffer*/) noexcept override {}
+  void willDelete(const igl::IFramebuffer& /*framebuffer*/) noexcept override {}
+  void didCreate(const igl::ISamplerState& /*samplerState*/) noexcept override {}
+  void willDelete(const igl::ISamplerState& /*samplerState*/) noexcept override {}
+  void didCreate(const igl::IShaderLibrary& /*shaderLibrary*/) noexcept override {}
+  void willDelete(const igl::IShaderLibrary& /*shaderLibrary*/) noexcept override {}
+  void didCreate(const igl::IShaderModule& /*shaderModule*/) noexcept override {}
+  void willDelete(const igl::IShaderModule& /*shaderModule*/) noexcept override {}
+  void didCreate(const igl::IShaderStages& /*shaderStages*/) noexcept override {}
+  void willDelete(const igl::IShaderStages& /*shaderStages*/) noexcept override {}
+  void pushTag(const char* /*tag*/) noexcept override {}
+  void popTag() noexcept override {}
+
+  [[nodiscard]] size_t getTextureMemory() const noexcept;
+  [[nodiscard]] size_t getBufferMemory() const noexcept;
+  [[nodiscard]] size_t getTotalMemory() const noexcept;
+
+ private:
+  mutable std::mutex mutex_;
+  // sizes are recorded at creation since resources are partially destroyed in willDelete()
+  std::unordered_map<const void*, size_t> sizes_;
+  size_t textureMemory_ = 0;
+  size_t bufferMemory_ = 0;
+};
+
+} // namespace texturestreamer
+} // namespace iglu
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <igl/Common.h>
+
+namespace iglu {
+namespace texturestreamer {
+
+namespace {
+size_t getMipSize(size_t size, uint32_t mipLevel) {
+  return std::max<size_t>(size >> mipLevel, 1);
+}
+} // namespace
+
+TextureStreamer::TextureStreamer(igl::IDevice& device, TextureStreamerConfig config) :
+  device_(device),
+  config_(std::move(config)),
+  workers_(std::make_unique<igl::WorkerPool>(std::max(config_.numWorkerThreads, 1u),
+                                             "IGLU texture streamer")) {}
+
+TextureStreamer::~TextureStreamer() {
+  // waits for all pending loads
+  workers_.reset();
+}
+
+std::shared_ptr<StreamedTexture> TextureStreamer::add(std::shared_ptr<ITextureSource> source) {
+  if (!IGL_VERIFY(source != nullptr)) {
+    return nullptr;
+  }
+  auto texture = std::make_shared<StreamedTexture>();
+  texture->desc_ = source->getDesc();
+  texture->source_ = std::move(source);
+
+  const uint32_t numMipLevels = texture->desc_.numMipLevels;
+  if (!IGL_VERIFY(texture->desc_.type == igl::TextureType::TwoD && numMipLevels > 0)) {
+    return nullptr;
+  }
+  texture->residentMipLevel_ = numMipLevels;
+  texture->pendingMipLevel_ = numMipLevels;
+  texture->coarseMipLevel_ =
+      numMipLevels > config_.numResidentMipLevels ? numMipLevels - config_.numResidentMipLevels : 0;
+  texture->requestedMipLevel_ = texture->coarseMipLevel_;
+  textures_.push_back(texture);
+
+  // coarse mip levels first, regardless of maxPendingLoads
+  startLoad(texture, texture->coarseMipLevel_);
+
+  return texture;
+}
+
+void TextureStreamer::request(StreamedTexture& texture, uint32_t mipLevel, float priority) {
+  texture.requestedMipLevel_ = std::min(mipLevel, texture.coarseMipLevel_);
+  texture.priority_ = priority;
+}
+
+void TextureStreamer::update() {
+  // forget released textures
+  textures_.erase(std::remove_if(textures_.begin(),
+                                 textures_.end(),
+                                 [](const auto& texture) { return texture.expired(); }),
+                  textures_.end());
+  streamedMemory_ = 0;
+  for (const auto& texture : textures_) {
+    streamedMemory_ += texture.lock()->sizeInBytes_;
+  }
+
+  uploadLoadedMips();
+  enforceBudget();
+  startLoads();
+}
+
+size_t TextureStreamer::getUsedMemory() const {
+  return config_.memoryTracker ? config_.memoryTracker->getTotalMemory() : streamedMemory_;
+}
+
+size_t TextureStreamer::getSizeInBytes(const igl::TextureDesc& desc, uint32_t mipLevel) {
+  if (mipLevel >= desc.numMipLevels) {
+    return 0;
+  }
+  const auto range = igl::TextureRangeDesc::new2D(0,
+                                                  0,
+                                                  getMipSize(desc.width, mipLevel),
+                                                  getMipSize(desc.height, mipLevel),
+                                                  0,
+                                                  desc.numMipLevels - mipLevel);
+  return igl::TextureFormatProperties::fromTextureFormat(desc.format).getBytesPerRange(range);
+}
+
+void TextureStreamer::startLoad(const std::shared_ptr<StreamedTexture>& texture,
+                                uint32_t mipLevel) {
+  IGL_ASSERT(texture->pendingMipLevel_ == texture->desc_.numMipLevels);
+
+  // the always resident levels are kept on the CPU once they are loaded
+  const uint32_t endMipLevel =
+      texture->residentMips_.empty() ? texture->desc_.numMipLevels : texture->coarseMipLevel_;
+  texture->pendingMipLevel_ = mipLevel;
+  numPendingLoads_++;
+
+  workers_->enqueue([this,
+                     weakTexture = std::weak_ptr<StreamedTexture>(texture),
+                     source = texture->source_,
+                     mipLevel,
+                     endMipLevel]() {
+    LoadResult result;
+    result.texture = weakTexture;
+    result.mipLevel = mipLevel;
+    result.mips.resize(endMipLevel - mipLevel);
+    for (uint32_t i = 0; i != result.mips.size(); i++) {
+      if (!source->loadMipLevel(mipLevel + i, result.mips[i])) {
+        IGL_LOG_ERROR("TextureStreamer: failed to load mip level %u\n", mipLevel + i);
+        result.mips.clear();
+        break;
+      }
+      result.sizeInBytes += result.mips[i].size();
+    }
+    std::lock_guard<std::mutex> lock(loadedMutex_);
+    loaded_.push_back(std::move(result));
+  });
+}
+
+bool TextureStreamer::createTexture(StreamedTexture& texture,
+                                    uint32_t mipLevel,
+                                    const std::vector<std::vector<uint8_t>>& mips) {
+  auto desc = texture.desc_;
+  desc.width = getMipSize(desc.width, mipLevel);
+  desc.height = getMipSize(desc.height, mipLevel);
+  desc.numMipLevels = texture.desc_.numMipLevels - mipLevel;
+  IGL_ASSERT(mips.size() == desc.numMipLevels);
+
+  igl::Result result;
+  auto gpuTexture = device_.createTexture(desc, &result);
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("TextureStreamer: %s\n", result.message.c_str());
+    return false;
+  }
+  for (uint32_t level = 0; level != desc.numMipLevels; level++) {
+    const auto range = igl::TextureRangeDesc::new2D(
+        0, 0, getMipSize(desc.width, level), getMipSize(desc.height, level), level);
+    result = gpuTexture->upload(range, mips[level].data());
+    if (!result.isOk()) {
+      IGL_LOG_ERROR("TextureStreamer: %s\n", result.message.c_str());
+      return false;
+    }
+  }
+
+  const size_t sizeInBytes = getSizeInBytes(texture.desc_, mipLevel);
+  streamedMemory_ = streamedMemory_ - texture.sizeInBytes_ + sizeInBytes;
+  texture.sizeInBytes_ = sizeInBytes;
+  texture.texture_ = std::move(gpuTexture);
+  texture.residentMipLevel_ = mipLevel;
+  return true;
+}
+
+bool TextureStreamer::evict(StreamedTexture& texture) {
+  return createTexture(texture, texture.coarseMipLevel_, texture.residentMips_);
+}
+
+void TextureStreamer::uploadLoadedMips() {
+  size_t uploadedBytes = 0;
+  for (;;) {
+    LoadResult result;
+    {
+      std::lock_guard<std::mutex> lock(loadedMutex_);
+      if (loaded_.empty() || (uploadedBytes > 0 && uploadedBytes + loaded_.front().sizeInBytes >
+                                                       config_.maxUploadBytesPerUpdate)) {
+        return;
+      }
+      result = std::move(loaded_.front());
+      loaded_.pop_front();
+    }
+    numPendingLoads_--;
+
+    auto texture = result.texture.lock();
+    if (!texture) {
+      continue;
+    }
+    texture->pendingMipLevel_ = texture->desc_.numMipLevels;
+    if (result.mips.empty() || result.mipLevel >= texture->residentMipLevel_) {
+      continue;
+    }
+    uploadedBytes += result.sizeInBytes;
+
+    if (texture->residentMips_.empty()) {
+      // the first load contains the always resident levels
+      const auto first = result.mips.begin() + (texture->coarseMipLevel_ - result.mipLevel);
+      texture->residentMips_.assign(first, result.mips.end());
+    } else {
+      result.mips.insert(
+          result.mips.end(), texture->residentMips_.begin(), texture->residentMips_.end());
+    }
+    createTexture(*texture, result.mipLevel, result.mips);
+  }
+}
+
+size_t TextureStreamer::freeMemory(size_t bytesToFree, bool unneededOnly) {
+  std::vector<std::shared_ptr<StreamedTexture>> candidates;
+  for (const auto& weakTexture : textures_) {
+    auto texture = weakTexture.lock();
+    const bool unneeded = texture->residentMipLevel_ < texture->requestedMipLevel_;
+    if (texture->residentMipLevel_ < texture->coarseMipLevel_ && (unneeded || !unneededOnly)) {
+      candidates.push_back(std::move(texture));
+    }
+  }
+  // evict textures with more levels than requested first, then by ascending priority
+  std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+    const bool aUnneeded = a->residentMipLevel_ < a->requestedMipLevel_;
+    const bool bUnneeded = b->residentMipLevel_ < b->requestedMipLevel_;
+    if (aUnneeded != bUnneeded) {
+      return aUnneeded;
+    }
+    return a->priority_ < b->priority_;
+  });
+
+  size_t freedBytes = 0;
+  for (const auto& texture : candidates) {
+    if (freedBytes >= bytesToFree) {
+      break;
+    }
+    const size_t oldSize = texture->sizeInBytes_;
+    if (evict(*texture)) {
+      freedBytes += oldSize - texture->sizeInBytes_;
+    }
+  }
+  return freedBytes;
+}
+
+void TextureStreamer::enforceBudget() {
+  const size_t usedMemory = getUsedMemory();
+  if (usedMemory > config_.memoryBudget) {
+    freeMemory(usedMemory - config_.memoryBudget, false);
+  }
+}
+
+void TextureStreamer::startLoads() {
+  std::vector<std::shared_ptr<StreamedTexture>> candidates;
+  // memory the pending loads will need once they are uploaded
+  size_t reservedMemory = 0;
+  for (const auto& weakTexture : textures_) {
+    auto texture = weakTexture.lock();
+    const uint32_t numMipLevels = texture->desc_.numMipLevels;
+    if (texture->pendingMipLevel_ != numMipLevels) {
+      const size_t pendingSize = getSizeInBytes(texture->desc_, texture->pendingMipLevel_);
+      reservedMemory += pendingSize - std::min(texture->sizeInBytes_, pendingSize);
+    } else if (texture->requestedMipLevel_ < texture->residentMipLevel_ &&
+               texture->residentMipLevel_ != numMipLevels) {
+      candidates.push_back(std::move(texture));
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+    return a->priority_ > b->priority_;
+  });
+
+  // the tracker may still see textures referenced by in-flight frames, so evictions are estimated
+  size_t usedMemory = getUsedMemory() + reservedMemory;
+  for (const auto& texture : candidates) {
+    if (numPendingLoads_ >= config_.maxPendingLoads) {
+      break;
+    }
+    const size_t requestedSize =
+        getSizeInBytes(texture->desc_, texture->requestedMipLevel_) - texture->sizeInBytes_;
+    if (usedMemory + requestedSize > config_.memoryBudget) {
+      // make room by evicting levels which are no longer requested
+      const size_t freedBytes =
+          freeMemory(usedMemory + requestedSize - config_.memoryBudget, true);
+      usedMemory -= std::min(usedMemory, freedBytes);
+    }
+    // the finest requested level which fits into the budget
+    for (uint32_t level = texture->requestedMipLevel_; level < texture->residentMipLevel_;
+         level++) {
+      const size_t extraSize = getSizeInBytes(texture->desc_, level) - texture->sizeInBytes_;
+      if (usedMemory + extraSize <= config_.memoryBudget) {
+        startLoad(texture, level);
+        usedMemory += extraSize;
+        break;
+      }
+    }
+  }
+}
+
+} // namespace texturestreamer
+} // namespace iglu
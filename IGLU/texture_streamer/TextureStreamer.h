@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "ITextureSource.h"
+#include "TextureMemoryTracker.h"
+
+#include <deque>
+#include <igl/Device.h>
+#include <igl/WorkerPool.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace iglu {
+namespace texturestreamer {
+
+struct TextureStreamerConfig {
+  /// GPU memory budget in bytes. Applies to everything reported by `memoryTracker`, or to the
+  /// streamed textures alone without a tracker.
+  size_t memoryBudget = 256 * 1024 * 1024;
+  /// Bytes uploaded per update() at most; at least one texture is uploaded per update()
+  size_t maxUploadBytesPerUpdate = 8 * 1024 * 1024;
+  /// The coarsest mip levels which are loaded first and always stay resident
+  uint32_t numResidentMipLevels = 4;
+  uint32_t numWorkerThreads = 2;
+  /// Textures being loaded at the same time at most
+  uint32_t maxPendingLoads = 8;
+  std::shared_ptr<TextureMemoryTracker> memoryTracker;
+};
+
+class TextureStreamer;
+
+/// A texture managed by TextureStreamer; it is no longer streamed once the handle is released
+class StreamedTexture final {
+ public:
+  /// nullptr until the coarsest mip levels are loaded. Changes whenever mip levels are streamed
+  /// in or evicted, so fetch it every frame.
+  [[nodiscard]] const std::shared_ptr<igl::ITexture>& getTexture() const {
+    return texture_;
+  }
+  /// The finest resident level of the full mip chain, which is level 0 of getTexture()
+  [[nodiscard]] uint32_t getResidentMipLevel() const {
+    return residentMipLevel_;
+  }
+  [[nodiscard]] const igl::TextureDesc& getDesc() const {
+    return desc_;
+  }
+
+ private:
+  friend class TextureStreamer;
+
+  std::shared_ptr<ITextureSource> source_;
+  igl::TextureDesc desc_;
+  std::shared_ptr<igl::ITexture> texture_;
+  // CPU copy of the always resident mip levels, so evicting never waits for I/O
+  std::vector<std::vector<uint8_t>> residentMips_;
+  uint32_t residentMipLevel_ = 0; // desc_.numMipLevels while nothing is resident
+  uint32_t coarseMipLevel_ = 0; // the finest of the always resident levels
+  uint32_t requestedMipLevel_ = 0;
+  uint32_t pendingMipLevel_ = 0; // desc_.numMipLevels if no load is in flight
+  float priority_ = 0.0f;
+  size_t sizeInBytes_ = 0; // estimated size of texture_
+};
+
+/**
+ * @brief Streams the mip levels of textures based on a per-frame priority while keeping GPU memory
+ * within a budget.
+ *
+ * The coarsest mip levels of every texture are loaded first and stay resident. Finer levels are
+ * loaded on worker threads for the textures with the highest priorities as long as the budget
+ * allows. Levels which are no longer requested stay resident until their memory is needed, and
+ * the textures with the lowest priorities are evicted when the budget is exceeded. A texture
+ * with its finest resident level N is a texture of the size of level N with the remaining levels,
+ * so shaders need no changes; a new texture is created whenever the resident levels change.
+ *
+ * Uploads go through igl::ITexture::upload(), which is staged asynchronously by backends
+ * supporting it. All methods must be called from the render thread.
+ */
+class TextureStreamer final {
+ public:
+  TextureStreamer(igl::IDevice& device, TextureStreamerConfig config);
+  ~TextureStreamer();
+
+  /// Starts streaming a 2D texture provided by `source`
+  std::shared_ptr<StreamedTexture> add(std::shared_ptr<ITextureSource> source);
+
+  /// Requests `mipLevel` as the finest level of `texture`. Higher priorities are streamed first
+  /// and evicted last. Requests persist until they are changed.
+  void request(StreamedTexture& texture, uint32_t mipLevel, float priority);
+
+  /// Uploads loaded mip levels, enforces the budget and starts new loads. Call once per frame.
+  void update();
+
+  /// Estimated GPU memory used by the streamed textures
+  [[nodiscard]] size_t getStreamedMemory() const {
+    return streamedMemory_;
+  }
+  /// Number of loads which have not been uploaded yet
+  [[nodiscard]] uint32_t getNumPendingLoads() const {
+    return numPendingLoads_;
+  }
+
+ private:
+  struct LoadResult {
+    std::weak_ptr<StreamedTexture> texture;
+    uint32_t mipLevel = 0;
+    // levels mipLevel..coarseMipLevel-1 of the full mip chain, or all remaining levels when
+    // nothing is resident yet; empty on failure
+    std::vector<std::vector<uint8_t>> mips;
+    size_t sizeInBytes = 0; // CPU size of mips
+  };
+
+  size_t getUsedMemory() const;
+  // estimated GPU size of `desc` with `mipLevel` as its finest level
+  static size_t getSizeInBytes(const igl::TextureDesc& desc, uint32_t mipLevel);
+  void startLoad(const std::shared_ptr<StreamedTexture>& texture, uint32_t mipLevel);
+  // replaces the GPU texture with one holding the levels mipLevel..numMipLevels-1
+  bool createTexture(StreamedTexture& texture,
+                     uint32_t mipLevel,
+                     const std::vector<std::vector<uint8_t>>& mips);
+  // drops all levels finer than the always resident ones
+  bool evict(StreamedTexture& texture);
+  // evicts textures until about `bytesToFree` bytes are freed; returns the bytes freed
+  size_t freeMemory(size_t bytesToFree, bool unneededOnly);
+  void uploadLoadedMips();
+  void enforceBudget();
+  void startLoads();
+
+ private:
+  igl::IDevice& device_;
+  TextureStreamerConfig config_;
+  std::vector<std::weak_ptr<StreamedTexture>> textures_;
+  size_t streamedMemory_ = 0;
+  uint32_t numPendingLoads_ = 0;
+
+  mutable std::mutex loadedMutex_;
+  std::deque<LoadResult> loaded_; // written by the workers
+
+  // destroyed first so no worker touches the members above after the destructor
+  std::unique_ptr<igl::WorkerPool> workers_;
+};
+
+} // namespace texturestreamer
+} // namespace iglu
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "Ktx2.h"
+
+#include <cstdint>
+#include <igl/TextureFormat.h>
+#include <vector>
+
+namespace iglu {
+namespace texturetranscoder {
+
+/// Decodes KTX2 payloads which cannot be uploaded as they are, i.e. Basis Universal (ETC1S and
+/// UASTC) or supercompressed levels. Implementations typically wrap the Basis Universal transcoder
+/// and zstd. Called on the thread which transcodes the texture.
+class ITranscoder {
+ public:
+  virtual ~ITranscoder() = default;
+
+  /// Returns true if the levels of `file` can be decoded to `format`
+  [[nodiscard]] virtual bool canTranscode(const Ktx2File& file,
+                                          igl::TextureFormat format) const = 0;
+
+  /// Decodes all images of `mipLevel` of `file` to `format` into `outData`, tightly packed in the
+  /// order of the KTX2 level data. Returns false on failure.
+  virtual bool transcode(const Ktx2File& file,
+                         uint32_t mipLevel,
+                         igl::TextureFormat format,
+                         std::vector<uint8_t>& outData) const = 0;
+};
+
+} // namespace texturetranscoder
+} // namespace iglu
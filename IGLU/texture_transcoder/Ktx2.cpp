@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Ktx2.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace iglu {
+namespace texturetranscoder {
+
+namespace {
+
+constexpr uint8_t kIdentifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr size_t kHeaderSize = 80; // identifier, header and index
+constexpr size_t kLevelIndexEntrySize = 24;
+constexpr uint8_t kTransferFunctionSrgb = 2;
+
+template<typename T>
+T read(const uint8_t* data, size_t offset) {
+  T value;
+  memcpy(&value, data + offset, sizeof(T));
+  return value;
+}
+
+bool isInRange(size_t size, uint64_t offset, uint64_t length) {
+  return offset <= size && length <= size - offset;
+}
+
+struct VkFormatMapping {
+  uint32_t vkFormat;
+  igl::TextureFormat format;
+};
+
+// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkFormat.html
+constexpr VkFormatMapping kVkFormats[] = {
+    {9, igl::TextureFormat::R_UNorm8},
+    {16, igl::TextureFormat::RG_UNorm8},
+    {37, igl::TextureFormat::RGBA_UNorm8},
+    {43, igl::TextureFormat::RGBA_SRGB},
+    {44, igl::TextureFormat::BGRA_UNorm8},
+    {50, igl::TextureFormat::BGRA_SRGB},
+    {97, igl::TextureFormat::RGBA_F16},
+    {109, igl::TextureFormat::RGBA_F32},
+    {145, igl::TextureFormat::RGBA_BC7_UNORM_4x4},
+    {146, igl::TextureFormat::RGBA_BC7_SRGB_4x4},
+    {147, igl::TextureFormat::RGB8_ETC2},
+    {148, igl::TextureFormat::SRGB8_ETC2},
+    {149, igl::TextureFormat::RGB8_Punchthrough_A1_ETC2},
+    {150, igl::TextureFormat::SRGB8_Punchthrough_A1_ETC2},
+    {151, igl::TextureFormat::RGBA8_EAC_ETC2},
+    {152, igl::TextureFormat::SRGB8_A8_EAC_ETC2},
+    {153, igl::TextureFormat::R_EAC_UNorm},
+    {154, igl::TextureFormat::R_EAC_SNorm},
+    {155, igl::TextureFormat::RG_EAC_UNorm},
+    {156, igl::TextureFormat::RG_EAC_SNorm},
+    {157, igl::TextureFormat::RGBA_ASTC_4x4},
+    {158, igl::TextureFormat::SRGB8_A8_ASTC_4x4},
+    {159, igl::TextureFormat::RGBA_ASTC_5x4},
+    {160, igl::TextureFormat::SRGB8_A8_ASTC_5x4},
+    {161, igl::TextureFormat::RGBA_ASTC_5x5},
+    {162, igl::TextureFormat::SRGB8_A8_ASTC_5x5},
+    {163, igl::TextureFormat::RGBA_ASTC_6x5},
+    {164, igl::TextureFormat::SRGB8_A8_ASTC_6x5},
+    {165, igl::TextureFormat::RGBA_ASTC_6x6},
+    {166, igl::TextureFormat::SRGB8_A8_ASTC_6x6},
+    {167, igl::TextureFormat::RGBA_ASTC_8x5},
+    {168, igl::TextureFormat::SRGB8_A8_ASTC_8x5},
+    {169, igl::TextureFormat::RGBA_ASTC_8x6},
+    {170, igl::TextureFormat::SRGB8_A8_ASTC_8x6},
+    {171, igl::TextureFormat::RGBA_ASTC_8x8},
+    {172, igl::TextureFormat::SRGB8_A8_ASTC_8x8},
+    {173, igl::TextureFormat::RGBA_ASTC_10x5},
+    {174, igl::TextureFormat::SRGB8_A8_ASTC_10x5},
+    {175, igl::TextureFormat::RGBA_ASTC_10x6},
+    {176, igl::TextureFormat::SRGB8_A8_ASTC_10x6},
+    {177, igl::TextureFormat::RGBA_ASTC_10x8},
+    {178, igl::TextureFormat::SRGB8_A8_ASTC_10x8},
+    {179, igl::TextureFormat::RGBA_ASTC_10x10},
+    {180, igl::TextureFormat::SRGB8_A8_ASTC_10x10},
+    {181, igl::TextureFormat::RGBA_ASTC_12x10},
+    {182, igl::TextureFormat::SRGB8_A8_ASTC_12x10},
+    {183, igl::TextureFormat::RGBA_ASTC_12x12},
+    {184, igl::TextureFormat::SRGB8_A8_ASTC_12x12},
+};
+
+} // namespace
+
+igl::TextureFormat vkFormatToTextureFormat(uint32_t vkFormat) {
+  for (const auto& mapping : kVkFormats) {
+    if (mapping.vkFormat == vkFormat) {
+      return mapping.format;
+    }
+  }
+  return igl::TextureFormat::Invalid;
+}
+
+igl::TextureFormat Ktx2File::getFormat() const {
+  return vkFormatToTextureFormat(vkFormat);
+}
+
+igl::Result parseKtx2(const uint8_t* data, size_t size, Ktx2File& outFile) {
+  if (size < kHeaderSize || memcmp(data, kIdentifier, sizeof(kIdentifier)) != 0) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid, "Not a KTX2 file");
+  }
+
+  Ktx2File file;
+  file.vkFormat = read<uint32_t>(data, 12);
+  file.typeSize = read<uint32_t>(data, 16);
+  file.width = read<uint32_t>(data, 20);
+  file.height = read<uint32_t>(data, 24);
+  file.depth = read<uint32_t>(data, 28);
+  file.numLayers = read<uint32_t>(data, 32);
+  file.numFaces = read<uint32_t>(data, 36);
+  file.numMipLevels = read<uint32_t>(data, 40);
+  file.supercompression = static_cast<Ktx2Supercompression>(read<uint32_t>(data, 44));
+  const auto dfdByteOffset = read<uint32_t>(data, 48);
+  const auto dfdByteLength = read<uint32_t>(data, 52);
+  const auto sgdByteOffset = read<uint64_t>(data, 64);
+  const auto sgdByteLength = read<uint64_t>(data, 72);
+
+  if (file.width == 0 || (file.numFaces != 1 && file.numFaces != 6)) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid, "Invalid KTX2 header");
+  }
+
+  const uint32_t numLevels = std::max(file.numMipLevels, 1u);
+  if (!isInRange(size, kHeaderSize, uint64_t(numLevels) * kLevelIndexEntrySize)) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid, "Truncated KTX2 level index");
+  }
+  file.levels.resize(numLevels);
+  for (uint32_t i = 0; i != numLevels; i++) {
+    const size_t offset = kHeaderSize + i * kLevelIndexEntrySize;
+    auto& level = file.levels[i];
+    level.byteOffset = read<uint64_t>(data, offset);
+    level.byteLength = read<uint64_t>(data, offset + 8);
+    level.uncompressedByteLength = read<uint64_t>(data, offset + 16);
+    if (!isInRange(size, level.byteOffset, level.byteLength)) {
+      return igl::Result(igl::Result::Code::ArgumentInvalid, "Truncated KTX2 level data");
+    }
+  }
+
+  // the basic data format descriptor block follows the total size of all blocks
+  if (dfdByteLength >= 16 && isInRange(size, dfdByteOffset, dfdByteLength)) {
+    file.colorModel = static_cast<Ktx2ColorModel>(data[dfdByteOffset + 12]);
+    file.isSrgb = data[dfdByteOffset + 14] == kTransferFunctionSrgb;
+  }
+
+  if (sgdByteLength) {
+    if (!isInRange(size, sgdByteOffset, sgdByteLength)) {
+      return igl::Result(igl::Result::Code::ArgumentInvalid, "Truncated KTX2 global data");
+    }
+    file.supercompressionGlobalData.assign(data + sgdByteOffset,
+                                           data + sgdByteOffset + sgdByteLength);
+  }
+
+  file.externalData = data;
+  outFile = std::move(file);
+  return igl::Result();
+}
+
+igl::Result parseKtx2(std::vector<uint8_t> data, Ktx2File& outFile) {
+  igl::Result result = parseKtx2(data.data(), data.size(), outFile);
+  if (result.isOk()) {
+    outFile.externalData = nullptr;
+    outFile.data = std::move(data);
+  }
+  return result;
+}
+
+} // namespace texturetranscoder
+} // namespace iglu
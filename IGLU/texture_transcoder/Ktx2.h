@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/Common.h>
+#include <igl/TextureFormat.h>
+#include <vector>
+
+namespace iglu {
+namespace texturetranscoder {
+
+enum class Ktx2Supercompression : uint32_t {
+  None = 0,
+  BasisLZ = 1,
+  Zstandard = 2,
+  Zlib = 3,
+};
+
+/// Color models of the data format descriptor which need transcoding
+enum class Ktx2ColorModel : uint8_t {
+  Unspecified = 0,
+  Rgbsda = 1,
+  Etc1s = 163,
+  Uastc = 166,
+};
+
+struct Ktx2Level {
+  uint64_t byteOffset = 0;
+  uint64_t byteLength = 0;
+  uint64_t uncompressedByteLength = 0;
+};
+
+/**
+ * @brief A parsed KTX2 file: https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html
+ *
+ * Level 0 is the largest mip level. The data of each level contains all layers, all faces and
+ * all depth slices in this order, optionally supercompressed.
+ */
+struct Ktx2File {
+  uint32_t vkFormat = 0; // VK_FORMAT_UNDEFINED for Basis Universal
+  uint32_t typeSize = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t depth = 0;
+  uint32_t numLayers = 0;
+  uint32_t numFaces = 1;
+  uint32_t numMipLevels = 0; // 0 requests generating mip levels at load time
+  Ktx2Supercompression supercompression = Ktx2Supercompression::None;
+  Ktx2ColorModel colorModel = Ktx2ColorModel::Unspecified;
+  bool isSrgb = false;
+  std::vector<Ktx2Level> levels;
+  std::vector<uint8_t> supercompressionGlobalData;
+  std::vector<uint8_t> data; // the whole file, if owned
+  const uint8_t* externalData = nullptr; // the whole file, if owned by the caller
+
+  /// The IGL format of the payload; Invalid for Basis Universal or unknown formats
+  [[nodiscard]] igl::TextureFormat getFormat() const;
+  [[nodiscard]] const uint8_t* getLevelData(uint32_t mipLevel) const {
+    return (externalData ? externalData : data.data()) + levels[mipLevel].byteOffset;
+  }
+};
+
+/// Parses `data` into `outFile`, which takes ownership of it
+igl::Result parseKtx2(std::vector<uint8_t> data, Ktx2File& outFile);
+/// Parses the `size` bytes of `data`, e.g. a memory-mapped file, into `outFile`, which points into
+/// `data` without copying it: `data` has to outlive `outFile`
+igl::Result parseKtx2(const uint8_t* IGL_NONNULL data, size_t size, Ktx2File& outFile);
+
+/// Maps a VkFormat value to an IGL format; Invalid if it has no equivalent
+igl::TextureFormat vkFormatToTextureFormat(uint32_t vkFormat);
+
+} // namespace texturetranscoder
+} // namespace iglu
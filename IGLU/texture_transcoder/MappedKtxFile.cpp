@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "MappedKtxFile.h"
+
+#include "Ktx2.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace iglu {
+namespace texturetranscoder {
+
+namespace {
+
+constexpr uint8_t kKtxIdentifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr uint8_t kKtx2Identifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr size_t kKtxHeaderSize = 64;
+constexpr uint32_t kKtxEndianness = 0x04030201;
+
+struct GlFormatMapping {
+  uint32_t glInternalFormat;
+  igl::TextureFormat format;
+};
+
+// the glInternalFormat values of KTX files
+constexpr GlFormatMapping kGlFormats[] = {
+    {0x8229, igl::TextureFormat::R_UNorm8}, // GL_R8
+    {0x822B, igl::TextureFormat::RG_UNorm8}, // GL_RG8
+    {0x8058, igl::TextureFormat::RGBA_UNorm8}, // GL_RGBA8
+    {0x8C43, igl::TextureFormat::RGBA_SRGB}, // GL_SRGB8_ALPHA8
+    {0x822D, igl::TextureFormat::R_F16}, // GL_R16F
+    {0x822F, igl::TextureFormat::RG_F16}, // GL_RG16F
+    {0x881A, igl::TextureFormat::RGBA_F16}, // GL_RGBA16F
+    {0x822E, igl::TextureFormat::R_F32}, // GL_R32F
+    {0x8814, igl::TextureFormat::RGBA_F32}, // GL_RGBA32F
+    {0x8D64, igl::TextureFormat::RGB8_ETC1}, // GL_ETC1_RGB8_OES
+    {0x9274, igl::TextureFormat::RGB8_ETC2},
+    {0x9275, igl::TextureFormat::SRGB8_ETC2},
+    {0x9276, igl::TextureFormat::RGB8_Punchthrough_A1_ETC2},
+    {0x9277, igl::TextureFormat::SRGB8_Punchthrough_A1_ETC2},
+    {0x9278, igl::TextureFormat::RGBA8_EAC_ETC2},
+    {0x9279, igl::TextureFormat::SRGB8_A8_EAC_ETC2},
+    {0x9270, igl::TextureFormat::R_EAC_UNorm},
+    {0x9271, igl::TextureFormat::R_EAC_SNorm},
+    {0x9272, igl::TextureFormat::RG_EAC_UNorm},
+    {0x9273, igl::TextureFormat::RG_EAC_SNorm},
+    {0x8E8C, igl::TextureFormat::RGBA_BC7_UNORM_4x4}, // GL_COMPRESSED_RGBA_BPTC_UNORM
+    {0x8E8D, igl::TextureFormat::RGBA_BC7_SRGB_4x4}, // GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+    {0x93B0, igl::TextureFormat::RGBA_ASTC_4x4},
+    {0x93B1, igl::TextureFormat::RGBA_ASTC_5x4},
+    {0x93B2, igl::TextureFormat::RGBA_ASTC_5x5},
+    {0x93B3, igl::TextureFormat::RGBA_ASTC_6x5},
+    {0x93B4, igl::TextureFormat::RGBA_ASTC_6x6},
+    {0x93B5, igl::TextureFormat::RGBA_ASTC_8x5},
+    {0x93B6, igl::TextureFormat::RGBA_ASTC_8x6},
+    {0x93B7, igl::TextureFormat::RGBA_ASTC_8x8},
+    {0x93B8, igl::TextureFormat::RGBA_ASTC_10x5},
+    {0x93B9, igl::TextureFormat::RGBA_ASTC_10x6},
+    {0x93BA, igl::TextureFormat::RGBA_ASTC_10x8},
+    {0x93BB, igl::TextureFormat::RGBA_ASTC_10x10},
+    {0x93BC, igl::TextureFormat::RGBA_ASTC_12x10},
+    {0x93BD, igl::TextureFormat::RGBA_ASTC_12x12},
+    {0x93D0, igl::TextureFormat::SRGB8_A8_ASTC_4x4},
+    {0x93D1, igl::TextureFormat::SRGB8_A8_ASTC_5x4},
+    {0x93D2, igl::TextureFormat::SRGB8_A8_ASTC_5x5},
+    {0x93D3, igl::TextureFormat::SRGB8_A8_ASTC_6x5},
+    {0x93D4, igl::TextureFormat::SRGB8_A8_ASTC_6x6},
+    {0x93D5, igl::TextureFormat::SRGB8_A8_ASTC_8x5},
+    {0x93D6, igl::TextureFormat::SRGB8_A8_ASTC_8x6},
+    {0x93D7, igl::TextureFormat::SRGB8_A8_ASTC_8x8},
+    {0x93D8, igl::TextureFormat::SRGB8_A8_ASTC_10x5},
+    {0x93D9, igl::TextureFormat::SRGB8_A8_ASTC_10x6},
+    {0x93DA, igl::TextureFormat::SRGB8_A8_ASTC_10x8},
+    {0x93DB, igl::TextureFormat::SRGB8_A8_ASTC_10x10},
+    {0x93DC, igl::TextureFormat::SRGB8_A8_ASTC_12x10},
+    {0x93DD, igl::TextureFormat::SRGB8_A8_ASTC_12x12},
+};
+
+igl::TextureFormat glInternalFormatToTextureFormat(uint32_t glInternalFormat) {
+  for (const auto& mapping : kGlFormats) {
+    if (mapping.glInternalFormat == glInternalFormat) {
+      return mapping.format;
+    }
+  }
+  return igl::TextureFormat::Invalid;
+}
+
+uint32_t readUInt32(const uint8_t* data, size_t offset) {
+  uint32_t value;
+  memcpy(&value, data + offset, sizeof(value));
+  return value;
+}
+
+uint64_t align4(uint64_t value) {
+  return (value + 3) & ~uint64_t(3);
+}
+
+igl::TextureDesc makeTextureDesc(igl::TextureFormat format,
+                                 size_t width,
+                                 size_t height,
+                                 size_t depth,
+                                 size_t numLayers,
+                                 size_t numFaces,
+                                 size_t numMipLevels) {
+  const auto usage = igl::TextureDesc::TextureUsageBits::Sampled;
+  igl::TextureDesc desc;
+  if (depth > 1) {
+    desc = igl::TextureDesc::new3D(format, width, height, depth, usage);
+  } else if (numFaces == 6) {
+    desc = igl::TextureDesc::newCube(format, width, height, usage);
+  } else if (numLayers > 0) {
+    desc = igl::TextureDesc::new2DArray(format, width, height, numLayers, usage);
+  } else {
+    desc = igl::TextureDesc::new2D(format, width, height, usage);
+  }
+  desc.numMipLevels = numMipLevels;
+  return desc;
+}
+
+// the range of mip level `mipLevel` of all the layers of `desc`
+igl::TextureRangeDesc getLevelRange(const igl::TextureDesc& desc, size_t mipLevel) {
+  const size_t width = std::max(desc.width >> mipLevel, size_t(1));
+  const size_t height = std::max(desc.height >> mipLevel, size_t(1));
+  if (desc.type == igl::TextureType::ThreeD) {
+    const size_t depth = std::max(desc.depth >> mipLevel, size_t(1));
+    return igl::TextureRangeDesc::new3D(0, 0, 0, width, height, depth, mipLevel);
+  }
+  return igl::TextureRangeDesc::new2DArray(0, 0, width, height, 0, desc.numLayers, mipLevel);
+}
+
+} // namespace
+
+std::unique_ptr<MappedKtxFile> MappedKtxFile::open(const std::string& path,
+                                                   igl::Result* outResult) {
+  std::unique_ptr<MappedKtxFile> ktxFile(new MappedKtxFile());
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+  LARGE_INTEGER fileSize = {};
+  if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+    if (file != INVALID_HANDLE_VALUE) {
+      CloseHandle(file);
+    }
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot open " + path);
+    return nullptr;
+  }
+  ktxFile->size_ = static_cast<size_t>(fileSize.QuadPart);
+  if (ktxFile->size_ >= kKtxHeaderSize) {
+    ktxFile->mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (ktxFile->mapping_) {
+      ktxFile->data_ = static_cast<const uint8_t*>(
+          MapViewOfFile(ktxFile->mapping_, FILE_MAP_READ, 0, 0, ktxFile->size_));
+    }
+  }
+  CloseHandle(file);
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  struct stat st = {};
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot open " + path);
+    return nullptr;
+  }
+  ktxFile->size_ = static_cast<size_t>(st.st_size);
+  if (ktxFile->size_ >= kKtxHeaderSize) {
+    void* data = mmap(nullptr, ktxFile->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      ktxFile->data_ = static_cast<const uint8_t*>(data);
+    }
+  }
+  // the mapping keeps the file alive
+  close(fd);
+#endif
+
+  if (ktxFile->size_ < kKtxHeaderSize) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, path + " is truncated");
+    return nullptr;
+  }
+  if (!ktxFile->data_) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot map " + path);
+    return nullptr;
+  }
+
+  igl::Result result;
+  if (memcmp(ktxFile->data_, kKtxIdentifier, sizeof(kKtxIdentifier)) == 0) {
+    result = ktxFile->addKtxImages(path);
+  } else if (memcmp(ktxFile->data_, kKtx2Identifier, sizeof(kKtx2Identifier)) == 0) {
+    result = ktxFile->addKtx2Images(path);
+  } else {
+    result = igl::Result(igl::Result::Code::ArgumentInvalid, path + " is not a KTX file");
+  }
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+
+  igl::Result::setOk(outResult);
+  return ktxFile;
+}
+
+MappedKtxFile::~MappedKtxFile() {
+#if defined(_WIN32)
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_) {
+    CloseHandle(mapping_);
+  }
+#else
+  if (data_) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+  }
+#endif
+}
+
+igl::Result MappedKtxFile::addKtxImages(const std::string& path) {
+  if (readUInt32(data_, 12) != kKtxEndianness) {
+    return igl::Result(igl::Result::Code::Unsupported, path + " is big-endian");
+  }
+  const uint32_t glInternalFormat = readUInt32(data_, 28);
+  const uint32_t width = readUInt32(data_, 36);
+  const uint32_t height = std::max(readUInt32(data_, 40), 1u);
+  const uint32_t depth = std::max(readUInt32(data_, 44), 1u);
+  const uint32_t numLayers = readUInt32(data_, 48);
+  const uint32_t numFaces = readUInt32(data_, 52);
+  const uint32_t numMipLevels = std::max(readUInt32(data_, 56), 1u);
+  const uint32_t bytesOfKeyValueData = readUInt32(data_, 60);
+
+  const igl::TextureFormat format = glInternalFormatToTextureFormat(glInternalFormat);
+  if (format == igl::TextureFormat::Invalid) {
+    return igl::Result(igl::Result::Code::Unsupported, path + " has an unsupported format");
+  }
+  if (width == 0 || (numFaces != 1 && numFaces != 6) || (numFaces == 6 && numLayers > 0) ||
+      (depth > 1 && (numFaces != 1 || numLayers > 0))) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid, path + " has an invalid header");
+  }
+  desc_ = makeTextureDesc(format, width, height, depth, numLayers, numFaces, numMipLevels);
+  const auto properties = igl::TextureFormatProperties::fromTextureFormat(format);
+
+  uint64_t offset = kKtxHeaderSize + uint64_t(bytesOfKeyValueData);
+  for (uint32_t mipLevel = 0; mipLevel != numMipLevels; mipLevel++) {
+    if (offset + sizeof(uint32_t) > size_) {
+      return igl::Result(igl::Result::Code::ArgumentInvalid, path + " is truncated");
+    }
+    const uint32_t imageSize = readUInt32(data_, static_cast<size_t>(offset));
+    offset += sizeof(uint32_t);
+
+    const igl::TextureRangeDesc range = getLevelRange(desc_, mipLevel);
+    // the rows of uncompressed images are padded to 4 bytes
+    const size_t bytesPerRow =
+        properties.isCompressed() ? 0 : align4(properties.getBytesPerRow(range.width));
+    if (numFaces == 6) {
+      // imageSize is the size of one face, and each face is padded
+      for (uint32_t face = 0; face != 6; face++) {
+        const auto result = addImage(range, static_cast<int>(face), offset, bytesPerRow);
+        if (!result.isOk()) {
+          return result;
+        }
+        offset += align4(imageSize);
+      }
+    } else {
+      // imageSize covers all the layers; a padded layer cannot be uploaded with its neighbours
+      const uint32_t numImages = std::max(numLayers, 1u);
+      const uint64_t layerSize = imageSize / numImages;
+      for (uint32_t layer = 0; layer != numImages; layer++) {
+        const auto result =
+            addImage(range.atLayer(layer), -1, offset + layer * layerSize, bytesPerRow);
+        if (!result.isOk()) {
+          return result;
+        }
+      }
+      offset += align4(imageSize);
+    }
+  }
+  return igl::Result();
+}
+
+igl::Result MappedKtxFile::addKtx2Images(const std::string& path) {
+  Ktx2File file;
+  auto result = texturetranscoder::parseKtx2(data_, size_, file);
+  if (!result.isOk()) {
+    return result;
+  }
+  const igl::TextureFormat format = file.getFormat();
+  if (format == igl::TextureFormat::Invalid ||
+      file.supercompression != Ktx2Supercompression::None) {
+    return igl::Result(igl::Result::Code::Unsupported,
+                       path + " needs transcoding or has an unsupported format");
+  }
+  const uint32_t height = std::max(file.height, 1u);
+  const uint32_t depth = std::max(file.depth, 1u);
+  if ((file.numFaces == 6 && file.numLayers > 0) ||
+      (depth > 1 && (file.numFaces != 1 || file.numLayers > 0))) {
+    return igl::Result(igl::Result::Code::Unsupported, path + " has an unsupported texture type");
+  }
+  desc_ = makeTextureDesc(
+      format, file.width, height, depth, file.numLayers, file.numFaces, file.levels.size());
+  const auto properties = igl::TextureFormatProperties::fromTextureFormat(format);
+
+  for (uint32_t mipLevel = 0; mipLevel != file.levels.size(); mipLevel++) {
+    const uint64_t offset = file.levels[mipLevel].byteOffset;
+    const igl::TextureRangeDesc range = getLevelRange(desc_, mipLevel);
+    if (file.numFaces == 6) {
+      // the faces of a level are tightly packed
+      const uint64_t faceSize = properties.getBytesPerRange(range);
+      for (uint32_t face = 0; face != 6; face++) {
+        result = addImage(range, static_cast<int>(face), offset + face * faceSize, 0);
+        if (!result.isOk()) {
+          return result;
+        }
+      }
+    } else {
+      // and so are the layers: one region covers all of them
+      result = addImage(range, -1, offset, 0);
+      if (!result.isOk()) {
+        return result;
+      }
+    }
+  }
+  return igl::Result();
+}
+
+igl::Result MappedKtxFile::addImage(const igl::TextureRangeDesc& range,
+                                    int face,
+                                    uint64_t offset,
+                                    size_t bytesPerRow) {
+  const auto properties = igl::TextureFormatProperties::fromTextureFormat(desc_.format);
+  const uint64_t size = bytesPerRow ? uint64_t(bytesPerRow) * properties.getRows(range) *
+                                          range.depth * range.numLayers
+                                    : properties.getBytesPerRange(range);
+  if (offset > size_ || size > size_ - offset) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid, "Truncated KTX image data");
+  }
+  images_.push_back({range, face, data_ + offset, bytesPerRow});
+  return igl::Result();
+}
+
+igl::TextureDesc MappedKtxFile::getTextureDesc(igl::TextureDesc::TextureUsage usage) const {
+  igl::TextureDesc desc = desc_;
+  desc.usage = usage;
+  return desc;
+}
+
+igl::Result MappedKtxFile::upload(const igl::ITexture& texture) const {
+  // one batch of regions straight from the mapping; cube faces have their own entry point
+  std::vector<igl::TextureRegionUpload> regions;
+  regions.reserve(images_.size());
+  igl::Result firstFailure;
+  for (const Image& image : images_) {
+    if (image.face < 0) {
+      regions.push_back({image.range, image.data, image.bytesPerRow});
+      continue;
+    }
+    const auto result = texture.uploadCube(
+        image.range, static_cast<igl::TextureCubeFace>(image.face), image.data, image.bytesPerRow);
+    if (!result.isOk() && firstFailure.isOk()) {
+      firstFailure = result;
+    }
+  }
+  if (!regions.empty()) {
+    const auto result = texture.uploadRegions(regions);
+    if (!result.isOk() && firstFailure.isOk()) {
+      firstFailure = result;
+    }
+  }
+  return firstFailure;
+}
+
+std::shared_ptr<igl::ITexture> MappedKtxFile::createTexture(igl::IDevice& device,
+                                                            igl::Result* outResult,
+                                                            igl::TextureDesc::TextureUsage usage)
+    const {
+  auto texture = device.createTexture(getTextureDesc(usage), outResult);
+  if (!texture) {
+    return nullptr;
+  }
+  const igl::Result result = upload(*texture);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, result);
+    return nullptr;
+  }
+  igl::Result::setOk(outResult);
+  return texture;
+}
+
+} // namespace texturetranscoder
+} // namespace iglu
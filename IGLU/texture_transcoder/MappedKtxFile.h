@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/IGL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace texturetranscoder {
+
+/**
+ * @brief A memory-mapped KTX (1.1) or KTX2 file whose payload can be uploaded as is.
+ *
+ * Opening a file only maps it and validates its header and level index; no image data is read or
+ * copied. upload() passes pointers into the mapping to igl::ITexture::uploadRegions(), so each mip
+ * level is copied once, from the pages of the file to the staging memory of the backend, or
+ * directly into the image where the Vulkan backend uses VK_EXT_host_image_copy. Pages are loaded
+ * by the OS as the upload touches them, and the peak memory use is about the size of the file.
+ *
+ * 2D textures, 2D arrays, cube maps and 3D textures are supported. KTX2 files using Basis
+ * Universal or supercompression, and big-endian KTX files, have to go through TextureTranscoder.
+ * KTX2 files which request mip levels to be generated at load time are loaded with one level.
+ */
+class MappedKtxFile final {
+ public:
+  static std::unique_ptr<MappedKtxFile> open(const std::string& path, igl::Result* outResult);
+  ~MappedKtxFile();
+
+  MappedKtxFile(const MappedKtxFile&) = delete;
+  MappedKtxFile& operator=(const MappedKtxFile&) = delete;
+
+  /// The texture which holds all of the images of the file
+  [[nodiscard]] igl::TextureDesc getTextureDesc(
+      igl::TextureDesc::TextureUsage usage = igl::TextureDesc::TextureUsageBits::Sampled) const;
+
+  /// Uploads all the mip levels, layers and faces of the file from the mapping into `texture`,
+  /// which was created from getTextureDesc()
+  igl::Result upload(const igl::ITexture& texture) const;
+
+  /// Creates a texture from getTextureDesc() and uploads the file into it
+  std::shared_ptr<igl::ITexture> createTexture(
+      igl::IDevice& device,
+      igl::Result* outResult,
+      igl::TextureDesc::TextureUsage usage = igl::TextureDesc::TextureUsageBits::Sampled) const;
+
+ private:
+  MappedKtxFile() = default;
+
+  igl::Result addKtxImages(const std::string& path);
+  igl::Result addKtx2Images(const std::string& path);
+  igl::Result addImage(const igl::TextureRangeDesc& range,
+                       int face,
+                       uint64_t offset,
+                       size_t bytesPerRow);
+
+  // one region of one upload
+  struct Image {
+    igl::TextureRangeDesc range;
+    // -1, or the cube face
+    int face = -1;
+    const uint8_t* data = nullptr;
+    size_t bytesPerRow = 0;
+  };
+
+  igl::TextureDesc desc_;
+  std::vector<Image> images_;
+
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+#if defined(_WIN32)
+  void* mapping_ = nullptr;
+#endif
+};
+
+} // namespace texturetranscoder
+} // namespace iglu
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "TextureTranscoder.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace iglu {
+namespace texturetranscoder {
+
+namespace {
+
+constexpr uint32_t kCacheMagic = 0x43544749; // 'IGTC'
+constexpr uint32_t kCacheVersion = 1;
+
+struct CacheHeader {
+  uint32_t magic = kCacheMagic;
+  uint32_t version = kCacheVersion;
+  uint32_t format = 0;
+  uint32_t type = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t depth = 0;
+  uint32_t numLayers = 0;
+  uint32_t numMipLevels = 0;
+};
+
+igl::TextureFormat toSrgb(igl::TextureFormat format) {
+  switch (format) {
+  case igl::TextureFormat::RGBA_UNorm8:
+    return igl::TextureFormat::RGBA_SRGB;
+  case igl::TextureFormat::BGRA_UNorm8:
+    return igl::TextureFormat::BGRA_SRGB;
+  case igl::TextureFormat::RGBA_BC7_UNORM_4x4:
+    return igl::TextureFormat::RGBA_BC7_SRGB_4x4;
+  case igl::TextureFormat::RGBA_ASTC_4x4:
+    return igl::TextureFormat::SRGB8_A8_ASTC_4x4;
+  case igl::TextureFormat::RGB8_ETC2:
+    return igl::TextureFormat::SRGB8_ETC2;
+  case igl::TextureFormat::RGBA8_EAC_ETC2:
+    return igl::TextureFormat::SRGB8_A8_EAC_ETC2;
+  default:
+    return format;
+  }
+}
+
+bool isSampleable(const igl::ICapabilities& capabilities, igl::TextureFormat format) {
+  return format != igl::TextureFormat::Invalid &&
+         (capabilities.getTextureFormatCapabilities(format) &
+          igl::ICapabilities::TextureFormatCapabilityBits::Sampled) != 0;
+}
+
+uint64_t fnv1a(const std::vector<uint8_t>& data) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const uint8_t byte : data) {
+    hash = (hash ^ byte) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+bool readFile(const std::string& path, std::vector<uint8_t>& outData) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  outData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return !file.bad();
+}
+
+bool readCache(const std::string& path, TranscodedTexture& texture) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  CacheHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      header.magic != kCacheMagic || header.version != kCacheVersion ||
+      header.format != static_cast<uint32_t>(texture.desc.format) ||
+      header.type != static_cast<uint32_t>(texture.desc.type) ||
+      header.width != texture.desc.width || header.height != texture.desc.height ||
+      header.depth != texture.desc.depth || header.numLayers != texture.desc.numLayers ||
+      header.numMipLevels != texture.desc.numMipLevels) {
+    return false;
+  }
+  std::vector<uint64_t> sizes(header.numMipLevels);
+  if (!file.read(reinterpret_cast<char*>(sizes.data()), sizes.size() * sizeof(uint64_t))) {
+    return false;
+  }
+  texture.mipLevels.resize(header.numMipLevels);
+  for (uint32_t i = 0; i != header.numMipLevels; i++) {
+    texture.mipLevels[i].resize(sizes[i]);
+    if (!file.read(reinterpret_cast<char*>(texture.mipLevels[i].data()), sizes[i])) {
+      texture.mipLevels.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+void writeCache(const std::string& path, const TranscodedTexture& texture) {
+  CacheHeader header;
+  header.format = static_cast<uint32_t>(texture.desc.format);
+  header.type = static_cast<uint32_t>(texture.desc.type);
+  header.width = static_cast<uint32_t>(texture.desc.width);
+  header.height = static_cast<uint32_t>(texture.desc.height);
+  header.depth = static_cast<uint32_t>(texture.desc.depth);
+  header.numLayers = static_cast<uint32_t>(texture.desc.numLayers);
+  header.numMipLevels = texture.desc.numMipLevels;
+  std::vector<uint64_t> sizes;
+  sizes.reserve(texture.mipLevels.size());
+  for (const auto& mipLevel : texture.mipLevels) {
+    sizes.push_back(mipLevel.size());
+  }
+
+  // write to a temporary file first so concurrent readers never see partial files
+  const std::string tempPath = path + ".tmp";
+  {
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(sizes.data()), sizes.size() * sizeof(uint64_t));
+    for (const auto& mipLevel : texture.mipLevels) {
+      file.write(reinterpret_cast<const char*>(mipLevel.data()), mipLevel.size());
+    }
+    if (!file) {
+      IGL_LOG_ERROR("TextureTranscoder: failed to write %s\n", tempPath.c_str());
+      file.close();
+      std::remove(tempPath.c_str());
+      return;
+    }
+  }
+  if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+    std::remove(tempPath.c_str());
+  }
+}
+
+} // namespace
+
+TextureTranscoder::TextureTranscoder(TextureTranscoderConfig config,
+                                     std::shared_ptr<ITranscoder> transcoder) :
+  config_(std::move(config)), transcoder_(std::move(transcoder)) {}
+
+igl::TextureFormat TextureTranscoder::selectFormat(const igl::ICapabilities& capabilities,
+                                                   const Ktx2File& file) const {
+  const igl::TextureFormat nativeFormat = file.getFormat();
+  if (isSampleable(capabilities, nativeFormat)) {
+    if (file.supercompression == Ktx2Supercompression::None ||
+        (transcoder_ && transcoder_->canTranscode(file, nativeFormat))) {
+      return nativeFormat;
+    }
+  }
+  if (!transcoder_) {
+    return igl::TextureFormat::Invalid;
+  }
+  for (const auto targetFormat : config_.targetFormats) {
+    const auto format = file.isSrgb ? toSrgb(targetFormat) : targetFormat;
+    if (isSampleable(capabilities, format) && transcoder_->canTranscode(file, format)) {
+      return format;
+    }
+  }
+  return igl::TextureFormat::Invalid;
+}
+
+std::string TextureTranscoder::getCachePath(uint64_t hash, igl::TextureFormat format) const {
+  char name[64];
+  snprintf(
+      name, sizeof(name), "%016" PRIx64 "_%u.igltc", hash, static_cast<uint32_t>(format));
+  const char last = config_.cacheDirectory.back();
+  return config_.cacheDirectory + (last == '/' || last == '\\' ? "" : "/") + name;
+}
+
+igl::Result TextureTranscoder::transcode(const igl::ICapabilities& capabilities,
+                                         std::vector<uint8_t> ktx2Data,
+                                         TranscodedTexture& outTexture) const {
+  const uint64_t hash = config_.cacheDirectory.empty() ? 0 : fnv1a(ktx2Data);
+
+  Ktx2File file;
+  auto result = parseKtx2(std::move(ktx2Data), file);
+  if (!result.isOk()) {
+    return result;
+  }
+  if (file.numFaces == 6 && file.numLayers > 1) {
+    return igl::Result(igl::Result::Code::Unsupported, "Cube map arrays are not supported");
+  }
+
+  const igl::TextureFormat format = selectFormat(capabilities, file);
+  if (format == igl::TextureFormat::Invalid) {
+    return igl::Result(igl::Result::Code::Unsupported, "No sampleable format for KTX2 texture");
+  }
+
+  TranscodedTexture texture;
+  texture.desc =
+      igl::TextureDesc::new2D(format, file.width, std::max(file.height, 1u), config_.usage);
+  if (file.numFaces == 6) {
+    texture.desc.type = igl::TextureType::Cube;
+  } else if (file.numLayers > 0) {
+    texture.desc.type = igl::TextureType::TwoDArray;
+    texture.desc.numLayers = file.numLayers;
+  } else if (file.depth > 0) {
+    texture.desc.type = igl::TextureType::ThreeD;
+    texture.desc.depth = file.depth;
+  }
+  texture.desc.numMipLevels = static_cast<uint32_t>(file.levels.size());
+
+  if (format == file.getFormat() && file.supercompression == Ktx2Supercompression::None) {
+    // the device samples the data as it is
+    texture.mipLevels.reserve(file.levels.size());
+    for (uint32_t i = 0; i != file.levels.size(); i++) {
+      const uint8_t* data = file.getLevelData(i);
+      texture.mipLevels.emplace_back(data, data + file.levels[i].byteLength);
+    }
+    outTexture = std::move(texture);
+    return result;
+  }
+
+  const std::string cachePath =
+      config_.cacheDirectory.empty() ? std::string() : getCachePath(hash, format);
+  if (!cachePath.empty() && readCache(cachePath, texture)) {
+    outTexture = std::move(texture);
+    return result;
+  }
+
+  texture.mipLevels.resize(file.levels.size());
+  for (uint32_t i = 0; i != file.levels.size(); i++) {
+    if (!transcoder_->transcode(file, i, format, texture.mipLevels[i])) {
+      return igl::Result(igl::Result::Code::RuntimeError, "Failed to transcode KTX2 texture");
+    }
+  }
+  if (!cachePath.empty()) {
+    writeCache(cachePath, texture);
+  }
+  outTexture = std::move(texture);
+  return result;
+}
+
+std::shared_ptr<igl::ITexture> TextureTranscoder::createTexture(igl::IDevice& device,
+                                                                const TranscodedTexture& texture,
+                                                                igl::Result* IGL_NULLABLE
+                                                                    outResult) {
+  const auto& desc = texture.desc;
+  if (!IGL_VERIFY(texture.mipLevels.size() == desc.numMipLevels)) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid);
+    return nullptr;
+  }
+  auto gpuTexture = device.createTexture(desc, outResult);
+  if (!gpuTexture) {
+    return nullptr;
+  }
+
+  igl::Result result;
+  for (uint32_t level = 0; level != desc.numMipLevels && result.isOk(); level++) {
+    const size_t width = std::max<size_t>(desc.width >> level, 1);
+    const size_t height = std::max<size_t>(desc.height >> level, 1);
+    const uint8_t* data = texture.mipLevels[level].data();
+    switch (desc.type) {
+    case igl::TextureType::Cube: {
+      const size_t faceSize = texture.mipLevels[level].size() / 6;
+      for (uint8_t face = 0; face != 6 && result.isOk(); face++) {
+        result = gpuTexture->uploadCube(igl::TextureRangeDesc::new2D(0, 0, width, height, level),
+                                        static_cast<igl::TextureCubeFace>(face),
+                                        data + face * faceSize);
+      }
+      break;
+    }
+    case igl::TextureType::TwoDArray:
+      result = gpuTexture->upload(
+          igl::TextureRangeDesc::new2DArray(0, 0, width, height, 0, desc.numLayers, level),
+          data);
+      break;
+    case igl::TextureType::ThreeD:
+      result = gpuTexture->upload(
+          igl::TextureRangeDesc::new3D(
+              0, 0, 0, width, height, std::max<size_t>(desc.depth >> level, 1), level),
+          data);
+      break;
+    default:
+      result = gpuTexture->upload(igl::TextureRangeDesc::new2D(0, 0, width, height, level), data);
+      break;
+    }
+  }
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  return gpuTexture;
+}
+
+std::shared_ptr<igl::ITexture> TextureTranscoder::loadTexture(igl::IDevice& device,
+                                                              const std::string& path,
+                                                              igl::Result* IGL_NULLABLE
+                                                                  outResult) const {
+  std::vector<uint8_t> data;
+  if (!readFile(path, data)) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "Failed to read " + path);
+    return nullptr;
+  }
+  TranscodedTexture texture;
+  auto result = transcode(device, std::move(data), texture);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  return createTexture(device, texture, outResult);
+}
+
+} // namespace texturetranscoder
+} // namespace iglu
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "ITranscoder.h"
+#include "Ktx2.h"
+
+#include <igl/Device.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iglu {
+namespace texturetranscoder {
+
+struct TextureTranscoderConfig {
+  /// Targets for textures which need transcoding in order of preference. The first one which the
+  /// device can sample and the transcoder supports is used; sRGB textures use the sRGB variants.
+  std::vector<igl::TextureFormat> targetFormats = {
+      igl::TextureFormat::RGBA_BC7_UNORM_4x4,
+      igl::TextureFormat::RGBA_ASTC_4x4,
+      igl::TextureFormat::RGBA8_EAC_ETC2,
+      igl::TextureFormat::RGBA_UNorm8,
+  };
+  /// Directory the transcoded textures are cached in; empty disables the disk cache
+  std::string cacheDirectory;
+  igl::TextureDesc::TextureUsage usage = igl::TextureDesc::TextureUsageBits::Sampled;
+};
+
+/// Texture data in a format the device can sample, ready for upload
+struct TranscodedTexture {
+  igl::TextureDesc desc;
+  // all layers and faces of each mip level, tightly packed
+  std::vector<std::vector<uint8_t>> mipLevels;
+};
+
+/**
+ * @brief Loads KTX2 textures in a format the device can sample.
+ *
+ * Textures in a format the device supports are uploaded as they are. Basis Universal textures and
+ * textures the device cannot sample are decoded by the ITranscoder to the first format of
+ * TextureTranscoderConfig::targetFormats which the device can sample, so one set of assets serves
+ * BC7, ASTC and ETC2 devices. Transcoded textures are cached on disk, keyed by the contents of the
+ * KTX2 file and the target format.
+ */
+class TextureTranscoder final {
+ public:
+  explicit TextureTranscoder(TextureTranscoderConfig config,
+                             std::shared_ptr<ITranscoder> transcoder = nullptr);
+
+  /// The format `file` is uploaded as; Invalid if it cannot be sampled by `capabilities`
+  [[nodiscard]] igl::TextureFormat selectFormat(const igl::ICapabilities& capabilities,
+                                                const Ktx2File& file) const;
+
+  /// Decodes KTX2 data into a format sampleable by `capabilities`. Does not access the GPU and may
+  /// be called from any thread.
+  igl::Result transcode(const igl::ICapabilities& capabilities,
+                        std::vector<uint8_t> ktx2Data,
+                        TranscodedTexture& outTexture) const;
+
+  /// Creates a texture from transcoded data and uploads all mip levels
+  static std::shared_ptr<igl::ITexture> createTexture(igl::IDevice& device,
+                                                      const TranscodedTexture& texture,
+                                                      igl::Result* IGL_NULLABLE outResult);
+
+  /// Reads, transcodes and uploads the KTX2 file at `path`
+  std::shared_ptr<igl::ITexture> loadTexture(igl::IDevice& device,
+                                             const std::string& path,
+                                             igl::Result* IGL_NULLABLE outResult) const;
+
+ private:
+  [[nodiscard]] std::string getCachePath(uint64_t hash, igl::TextureFormat format) const;
+
+ private:
+  TextureTranscoderConfig config_;
+  std::shared_ptr<ITranscoder> transcoder_;
+};
+
+} // namespace texturetranscoder
+} // namespace iglu
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/uniform/BlockLayout.h>
+
+#include <string>
+
+namespace iglu {
+namespace uniform {
+
+igl::Result verifyBlockLayout(const igl::BufferArgDesc& desc,
+                              const BlockMemberLayout* members,
+                              const char* const* memberNames,
+                              size_t numMembers,
+                              size_t blockSize) {
+  const std::string bufferName = desc.name.toString();
+  if (desc.bufferDataSize < blockSize) {
+    return igl::Result(igl::Result::Code::ArgumentInvalid,
+                       "Uniform buffer " + bufferName + " holds " +
+                           std::to_string(desc.bufferDataSize) + " bytes, the block needs " +
+                           std::to_string(blockSize));
+  }
+  for (size_t i = 0; i != numMembers; i++) {
+    const BlockMemberLayout& member = members[i];
+    const igl::BufferArgDesc::BufferMemberDesc* reflected = nullptr;
+    for (const igl::BufferArgDesc::BufferMemberDesc& memberDesc : desc.members) {
+      if (memberDesc.name.toString() == memberNames[i]) {
+        reflected = &memberDesc;
+        break;
+      }
+    }
+    const std::string memberName = bufferName + "." + memberNames[i];
+    if (reflected == nullptr) {
+      return igl::Result(igl::Result::Code::ArgumentInvalid, "Member " + memberName + " not found");
+    }
+    // backends which do not reflect member types report Invalid
+    if (reflected->type != igl::UniformType::Invalid && reflected->type != member.type) {
+      return igl::Result(igl::Result::Code::ArgumentInvalid,
+                         "Member " + memberName + " has a different type");
+    }
+    if (reflected->offset != member.offset) {
+      return igl::Result(igl::Result::Code::ArgumentInvalid,
+                         "Member " + memberName + " is at offset " +
+                             std::to_string(reflected->offset) + " instead of " +
+                             std::to_string(member.offset));
+    }
+    if (reflected->arrayLength != member.arrayLength) {
+      return igl::Result(igl::Result::Code::ArgumentInvalid,
+                         "Member " + memberName + " has " +
+                             std::to_string(reflected->arrayLength) + " elements instead of " +
+                             std::to_string(member.arrayLength));
+    }
+  }
+  return igl::Result();
+}
+
+} // namespace uniform
+} // namespace iglu
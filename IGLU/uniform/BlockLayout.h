@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <igl/Common.h>
+#include <igl/RenderPipelineReflection.h>
+#include <igl/Uniform.h>
+#include <tuple>
+#include <type_traits>
+
+namespace iglu {
+namespace uniform {
+
+enum class LayoutRule : uint8_t {
+  /// Uniform blocks: array elements and matrix columns are 16 bytes apart
+  Std140,
+  /// Storage buffers and push constants: array elements and matrix columns are packed to the
+  /// alignment of their type
+  Std430,
+};
+
+// ----------------------------------------------------------------------------
+
+// LayoutTrait<T>
+//
+// The GLSL type of a C++ member type of a block. Each of the `kNumColumns` columns of a value is a
+// vector of `kNumComponents` 32-bit components. bool members are stored as 32-bit values.
+template<typename T>
+struct LayoutTrait {
+  static constexpr igl::UniformType kValue = igl::UniformType::Invalid;
+};
+
+namespace detail {
+template<igl::UniformType Type, size_t NumColumns, size_t NumComponents>
+struct LayoutTraitBase {
+  static constexpr igl::UniformType kValue = Type;
+  static constexpr size_t kNumColumns = NumColumns;
+  static constexpr size_t kNumComponents = NumComponents;
+  static constexpr size_t kColumnBytes = NumComponents * 4;
+};
+} // namespace detail
+
+template<>
+struct LayoutTrait<bool> : detail::LayoutTraitBase<igl::UniformType::Boolean, 1, 1> {};
+template<>
+struct LayoutTrait<int> : detail::LayoutTraitBase<igl::UniformType::Int, 1, 1> {};
+template<>
+struct LayoutTrait<glm::ivec2> : detail::LayoutTraitBase<igl::UniformType::Int2, 1, 2> {};
+template<>
+struct LayoutTrait<glm::ivec3> : detail::LayoutTraitBase<igl::UniformType::Int3, 1, 3> {};
+template<>
+struct LayoutTrait<glm::ivec4> : detail::LayoutTraitBase<igl::UniformType::Int4, 1, 4> {};
+template<>
+struct LayoutTrait<float> : detail::LayoutTraitBase<igl::UniformType::Float, 1, 1> {};
+template<>
+struct LayoutTrait<glm::vec2> : detail::LayoutTraitBase<igl::UniformType::Float2, 1, 2> {};
+template<>
+struct LayoutTrait<glm::vec3> : detail::LayoutTraitBase<igl::UniformType::Float3, 1, 3> {};
+template<>
+struct LayoutTrait<glm::vec4> : detail::LayoutTraitBase<igl::UniformType::Float4, 1, 4> {};
+template<>
+struct LayoutTrait<glm::mat2> : detail::LayoutTraitBase<igl::UniformType::Mat2x2, 2, 2> {};
+template<>
+struct LayoutTrait<glm::mat3> : detail::LayoutTraitBase<igl::UniformType::Mat3x3, 3, 3> {};
+template<>
+struct LayoutTrait<glm::mat4> : detail::LayoutTraitBase<igl::UniformType::Mat4x4, 4, 4> {};
+
+// ----------------------------------------------------------------------------
+
+/// The placement of one member of a block, as computed by BlockLayout
+struct BlockMemberLayout {
+  igl::UniformType type = igl::UniformType::Invalid;
+  size_t offset = 0;
+  size_t arrayLength = 1;
+  /// The distance between array elements
+  size_t stride = 0;
+  /// The distance between the columns of a matrix
+  size_t columnStride = 0;
+  /// The number of bytes the member covers, including the padding of its elements and columns
+  size_t size = 0;
+  size_t alignment = 0;
+};
+
+namespace detail {
+
+constexpr size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+template<LayoutRule Rule, typename Member>
+constexpr BlockMemberLayout getMemberLayout() {
+  using Element = std::remove_extent_t<Member>;
+  using Trait = LayoutTrait<Element>;
+  static_assert(std::rank_v<Member> <= 1, "Only one-dimensional arrays are supported");
+  static_assert(Trait::kValue != igl::UniformType::Invalid, "Unsupported block member type");
+
+  constexpr bool kIsArray = std::is_array_v<Member>;
+  // a vec3 is aligned like a vec4, scalars and vec2s to their size
+  constexpr size_t kVectorAlignment = Trait::kNumComponents == 3 ? 16 : Trait::kColumnBytes;
+
+  BlockMemberLayout layout;
+  layout.type = Trait::kValue;
+  layout.arrayLength = kIsArray ? std::extent_v<Member> : 1;
+  if (Trait::kNumColumns > 1) {
+    // matrices are arrays of column vectors
+    layout.columnStride =
+        Rule == LayoutRule::Std140 ? alignUp(kVectorAlignment, 16) : kVectorAlignment;
+    layout.alignment = layout.columnStride;
+    layout.stride = layout.columnStride * Trait::kNumColumns;
+  } else {
+    layout.alignment = kVectorAlignment;
+    layout.stride = kIsArray ? alignUp(kVectorAlignment, 4) : Trait::kColumnBytes;
+  }
+  if (kIsArray && Rule == LayoutRule::Std140) {
+    // std140 rounds the alignment and the stride of array elements up to those of a vec4
+    layout.alignment = alignUp(layout.alignment, 16);
+    layout.stride = alignUp(layout.stride, 16);
+  }
+  layout.size = layout.stride * layout.arrayLength;
+  return layout;
+}
+
+template<LayoutRule Rule, size_t N>
+constexpr std::array<BlockMemberLayout, N> placeMembers(std::array<BlockMemberLayout, N> members) {
+  size_t offset = 0;
+  for (size_t i = 0; i != N; i++) {
+    members[i].offset = alignUp(offset, members[i].alignment);
+    offset = members[i].offset + members[i].size;
+  }
+  return members;
+}
+
+template<LayoutRule Rule, size_t N>
+constexpr size_t getBlockAlignment(const std::array<BlockMemberLayout, N>& members) {
+  // std140 rounds the alignment of structures up to that of a vec4
+  size_t alignment = Rule == LayoutRule::Std140 ? 16 : 4;
+  for (const BlockMemberLayout& member : members) {
+    alignment = member.alignment > alignment ? member.alignment : alignment;
+  }
+  return alignment;
+}
+
+} // namespace detail
+
+/// Checks that the members of `desc` called `memberNames` have the types, the offsets and the
+/// array lengths of `members`, and that the buffer is large enough for `blockSize` bytes.
+igl::Result verifyBlockLayout(const igl::BufferArgDesc& desc,
+                              const BlockMemberLayout* members,
+                              const char* const* memberNames,
+                              size_t numMembers,
+                              size_t blockSize);
+
+// ----------------------------------------------------------------------------
+
+// BlockLayout<Rule, Members...>
+//
+// The byte image of a uniform block or a storage buffer struct, laid out at compile time by the
+// std140 or the std430 rules. The members are declared once, in the order of the shader block,
+// by their C++ types, with arrays as T[N]:
+//
+//   // layout(std140) uniform Lights { vec3 dir; float intensity; mat4 view; vec4 colors[4]; }
+//   using LightsBlock = BlockLayout<LayoutRule::Std140, glm::vec3, float, glm::mat4, glm::vec4[4]>;
+//   static_assert(LightsBlock::offset<1>() == 12 && LightsBlock::kSize == 144);
+//
+// Members are written at their constant offsets, with the padding of vec3s, matrix columns and
+// array elements applied on the fly, so the whole block is uploaded with a single copy of data():
+//
+//   LightsBlock lights;
+//   lights.set<0>(direction);
+//   lights.set<3>(color, 2);
+//   buffer->upload(lights.data(), igl::BufferRange(LightsBlock::kSize));
+//
+// Metal aligns float3 members, and OpenGL implementations may place the members of uniform
+// blocks without std140, so call verify() with the reflection of the pipeline once it is created.
+template<LayoutRule Rule, typename... Members>
+class BlockLayout final {
+  static_assert(sizeof...(Members) > 0, "A block needs at least one member");
+
+ public:
+  static constexpr size_t kNumMembers = sizeof...(Members);
+  static constexpr std::array<BlockMemberLayout, kNumMembers> kMembers =
+      detail::placeMembers<Rule>(std::array<BlockMemberLayout, kNumMembers>{
+          detail::getMemberLayout<Rule, Members>()...});
+  static constexpr size_t kAlignment = detail::getBlockAlignment<Rule>(kMembers);
+  static constexpr size_t kSize =
+      detail::alignUp(kMembers[kNumMembers - 1].offset + kMembers[kNumMembers - 1].size,
+                      kAlignment);
+
+  template<size_t I>
+  using Member = std::remove_extent_t<std::tuple_element_t<I, std::tuple<Members...>>>;
+
+  template<size_t I>
+  static constexpr size_t offset() {
+    static_assert(I < kNumMembers, "Invalid member index");
+    return kMembers[I].offset;
+  }
+
+  /// Writes element `arrayIndex` of member I
+  template<size_t I>
+  void set(const Member<I>& value, size_t arrayIndex = 0) noexcept {
+    setArray<I>(&value, 1, arrayIndex);
+  }
+
+  /// Writes `count` elements of member I starting at element `arrayIndex`
+  template<size_t I>
+  void setArray(const Member<I>* values, size_t count, size_t arrayIndex = 0) noexcept {
+    using Trait = LayoutTrait<Member<I>>;
+    constexpr BlockMemberLayout kMember = kMembers[I];
+    IGL_ASSERT_MSG(arrayIndex + count <= kMember.arrayLength, "Invalid range of array elements");
+    for (size_t i = 0; i != count; i++) {
+      uint8_t* dst = data_.data() + kMember.offset + kMember.stride * (arrayIndex + i);
+      if constexpr (std::is_same_v<Member<I>, bool>) {
+        const uint32_t value = values[i] ? 1u : 0u;
+        std::memcpy(dst, &value, sizeof(value));
+      } else if constexpr (Trait::kNumColumns == 1) {
+        std::memcpy(dst, &values[i], Trait::kColumnBytes);
+      } else {
+        for (size_t column = 0; column != Trait::kNumColumns; column++) {
+          std::memcpy(dst + kMember.columnStride * column, &values[i][column], Trait::kColumnBytes);
+        }
+      }
+    }
+  }
+
+  [[nodiscard]] const void* data() const noexcept {
+    return data_.data();
+  }
+
+  [[nodiscard]] static constexpr size_t size() noexcept {
+    return kSize;
+  }
+
+  /// Checks the layout against the reflected buffer `desc`, whose members are named `memberNames`
+  /// in the order of Members. Returns Result::Code::ArgumentInvalid on the first mismatch.
+  static igl::Result verify(const igl::BufferArgDesc& desc,
+                            const std::array<const char*, kNumMembers>& memberNames) {
+    return verifyBlockLayout(desc, kMembers.data(), memberNames.data(), kNumMembers, kSize);
+  }
+
+  /// Finds the uniform buffer `bufferName` in `reflection`, e.g. of a pipeline just created, and
+  /// checks the layout against it in every shader stage which uses it.
+  static igl::Result verify(const igl::IRenderPipelineReflection& reflection,
+                            const igl::NameHandle& bufferName,
+                            const std::array<const char*, kNumMembers>& memberNames) {
+    bool found = false;
+    for (const igl::BufferArgDesc& desc : reflection.allUniformBuffers()) {
+      if (desc.name == bufferName) {
+        found = true;
+        igl::Result result = verify(desc, memberNames);
+        if (!result.isOk()) {
+          return result;
+        }
+      }
+    }
+    if (!found) {
+      return igl::Result(igl::Result::Code::ArgumentInvalid, "Uniform buffer not found");
+    }
+    return igl::Result();
+  }
+
+ private:
+  alignas(16) std::array<uint8_t, kSize> data_{};
+};
+
+} // namespace uniform
+} // namespace iglu
@@ -8,7 +8,9 @@
 #include <IGLU/uniform/CollectionEncoder.h>
 
 #include <IGLU/uniform/Collection.h>
+#include <IGLU/uniform/Descriptor.h>
 #include <IGLU/uniform/Encoder.h>
+#include <igl/RenderCommandEncoder.h>
 
 namespace iglu {
 namespace uniform {
@@ -26,5 +28,39 @@ void CollectionEncoder::operator()(
   }
 }
 
+size_t CollectionEncoder::encodeChanges(const Collection& collection,
+                                        igl::IRenderCommandEncoder& commandEncoder,
+                                        uint8_t bindTarget,
+                                        const std::vector<igl::NameHandle>& uniformNames) noexcept {
+  if (cachedEncoder_ != &commandEncoder) {
+    invalidate();
+    cachedEncoder_ = &commandEncoder;
+  }
+
+  const igl::ShaderStage stage = bindTarget == igl::BindTarget::kVertex
+                                     ? igl::ShaderStage::Vertex
+                                     : igl::ShaderStage::Fragment;
+  Encoder uniformEncoder(backendType_);
+  size_t numEncoded = 0;
+  for (const auto& name : uniformNames) {
+    const Descriptor& uniform = collection.get(name);
+    const int index = uniform.getIndex(stage);
+    const uint64_t key = (static_cast<uint64_t>(bindTarget) << 32) | static_cast<uint32_t>(index);
+    auto it = cachedVersions_.find(key);
+    if (it != cachedVersions_.end() && it->second == uniform.getVersion()) {
+      continue;
+    }
+    uniformEncoder(commandEncoder, bindTarget, uniform);
+    cachedVersions_[key] = uniform.getVersion();
+    numEncoded++;
+  }
+  return numEncoded;
+}
+
+void CollectionEncoder::invalidate() noexcept {
+  cachedEncoder_ = nullptr;
+  cachedVersions_.clear();
+}
+
 } // namespace uniform
 } // namespace iglu
@@ -9,6 +9,7 @@
 
 #include <igl/Common.h>
 #include <igl/NameHandle.h>
+#include <unordered_map>
 #include <vector>
 
 namespace igl {
@@ -34,8 +35,24 @@ class CollectionEncoder {
                   uint8_t bindTarget,
                   const std::vector<igl::NameHandle>& uniformNames) const noexcept;
 
+  // Submits only the uniforms whose value or index changed since this CollectionEncoder last
+  // submitted them to the same encoder; submitted values persist across the draw calls of an
+  // encoder. Call invalidate() before using a new encoder and whenever the submitted values may
+  // have been replaced, e.g. by binding a pipeline state with a different shader program or by
+  // binding other data at the same indices. Returns the number of submitted uniforms.
+  size_t encodeChanges(const Collection& collection,
+                       igl::IRenderCommandEncoder& commandEncoder,
+                       uint8_t bindTarget,
+                       const std::vector<igl::NameHandle>& uniformNames) noexcept;
+
+  // Forgets all submitted uniforms, so the next encodeChanges() submits every uniform
+  void invalidate() noexcept;
+
  private:
   igl::BackendType backendType_;
+  const igl::IRenderCommandEncoder* cachedEncoder_ = nullptr;
+  // version of the descriptor last submitted to each bind target and index
+  std::unordered_map<uint64_t, uint64_t> cachedVersions_;
 };
 
 } // namespace uniform
@@ -7,6 +7,8 @@
 
 #include <IGLU/uniform/Descriptor.h>
 
+#include <atomic>
+
 #if IGL_BACKEND_OPENGL
 #include <igl/opengl/RenderCommandAdapter.h>
 #endif
@@ -14,7 +16,14 @@
 namespace iglu {
 namespace uniform {
 
-Descriptor::Descriptor(igl::UniformType type) : type_(type) {}
+namespace {
+uint64_t nextVersion() noexcept {
+  static std::atomic<uint64_t> version(0);
+  return ++version;
+}
+} // namespace
+
+Descriptor::Descriptor(igl::UniformType type) : type_(type), version_(nextVersion()) {}
 
 igl::UniformType Descriptor::getType() const noexcept {
   return type_;
@@ -28,6 +37,10 @@ void Descriptor::setIndex(igl::ShaderStage stage, int newValue) noexcept {
   indices_[EnumToValue(stage)] = newValue;
 }
 
+void Descriptor::markDirty() noexcept {
+  version_ = nextVersion();
+}
+
 #if IGL_BACKEND_OPENGL
 void Descriptor::toUniformDescriptor(int location, igl::UniformDesc& outDescriptor) const noexcept {
   outDescriptor.location = location;
@@ -159,9 +159,19 @@ struct Descriptor {
 
   void toUniformDescriptor(int location, igl::UniformDesc& outDescriptor) const noexcept;
 
+  // Changes whenever the value may have been modified, i.e. on every non-const access to the
+  // value. Versions are unique across all descriptors, so a version seen before identifies both
+  // the descriptor and its value.
+  [[nodiscard]] uint64_t getVersion() const noexcept {
+    return version_;
+  }
+  // Call after modifying the value through a reference obtained earlier
+  void markDirty() noexcept;
+
  private:
   igl::UniformType type_ = igl::UniformType::Invalid;
   Indices indices_ = {-1, -1}; // index for each shader stage
+  uint64_t version_;
 };
 
 // ----------------------------------------------------------------------------
@@ -208,6 +218,7 @@ class DescriptorValue : public Descriptor {
   }
 
   T& operator*() noexcept {
+    markDirty();
     return element_.value;
   }
 
@@ -321,6 +332,7 @@ class DescriptorVector : public Descriptor {
   }
 
   Vector& operator*() noexcept {
+    markDirty();
     return container_.values;
   }
 
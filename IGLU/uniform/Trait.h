@@ -99,13 +99,7 @@ struct Trait<glm::mat3> {
   using Aligned = std::array<glm::vec4, 3>; // each row of matrix is 16-byte aligned
   static_assert(sizeof(Aligned) == 3 * sizeof(glm::vec4), "Aligned is the wrong size!");
   static void toAligned(Aligned& outData, const glm::mat3& src) noexcept {
-    auto srcMatrix = static_cast<const float*>(glm::value_ptr(src));
-    for (int i = 0; i < 3; i++) {
-      auto outRow = static_cast<float*>(glm::value_ptr(outData[i]));
-      for (int j = 0; j < 3; j++) {
-        *outRow++ = *srcMatrix++;
-      }
-    }
+    igl::padVec3Array(outData.data(), glm::value_ptr(src), 3);
   }
 
   static constexpr igl::UniformType kValue = igl::UniformType::Mat3x3;
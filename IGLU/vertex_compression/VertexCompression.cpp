@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "VertexCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <igl/Core.h>
+#include <meshoptimizer.h>
+
+namespace iglu {
+namespace vertexcompression {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x56474c49; // "IGLV"
+constexpr uint32_t kVersion = 1;
+
+constexpr uint32_t kFlagNormals = 1u << 8;
+constexpr uint32_t kFlagUVs = 1u << 9;
+constexpr uint32_t kPositionFormatMask = 0xff;
+
+constexpr size_t kPositionSize = 4 * sizeof(uint16_t);
+constexpr size_t kNormalSize = 2 * sizeof(uint16_t);
+constexpr size_t kUVSize = 2 * sizeof(uint16_t);
+
+constexpr int kBits = 16;
+constexpr float kSnormMax = 32767.0f;
+constexpr float kUnormMax = 65535.0f;
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t flags;
+  uint32_t vertexCount;
+  uint32_t stride;
+  uint32_t encodedSize;
+  float positionScale[3];
+  float positionOffset[3];
+  float uvScale[2];
+  float uvOffset[2];
+};
+
+size_t getStride(bool hasNormals, bool hasUVs) {
+  return kPositionSize + (hasNormals ? kNormalSize : 0) + (hasUVs ? kUVSize : 0);
+}
+
+const float* at(const float* stream, size_t stride, size_t i) {
+  return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(stream) + i * stride);
+}
+
+uint16_t snorm(float v) {
+  return static_cast<uint16_t>(static_cast<int16_t>(meshopt_quantizeSnorm(v, kBits)));
+}
+
+uint16_t unorm(float v) {
+  return static_cast<uint16_t>(meshopt_quantizeUnorm(std::clamp(v, 0.0f, 1.0f), kBits));
+}
+
+// the GPU conversion of normalized signed integers: -32768 and -32767 both map to -1
+float fromSnorm(uint16_t v) {
+  return std::max(static_cast<float>(static_cast<int16_t>(v)) / kSnormMax, -1.0f);
+}
+
+float fromUnorm(uint16_t v) {
+  return static_cast<float>(v) / kUnormMax;
+}
+
+float fromHalf(uint16_t h) {
+  const uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+  const uint32_t exponent = (h >> 10) & 0x1f;
+  const uint32_t mantissa = h & 0x3ff;
+  float value = 0.0f;
+  if (exponent == 0) {
+    value = std::ldexp(static_cast<float>(mantissa), -24);
+  } else if (exponent == 0x1f) {
+    value = mantissa ? NAN : INFINITY;
+  } else {
+    value = std::ldexp(static_cast<float>(mantissa | 0x400), static_cast<int>(exponent) - 25);
+  }
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  bits |= sign;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Octahedral mapping: the unit sphere is projected onto the octahedron |x| + |y| + |z| = 1, whose
+// lower half is folded over the upper one into the [-1, 1] square.
+void encodeOctahedral(const float* n, float& outU, float& outV) {
+  const float l1 = std::fabs(n[0]) + std::fabs(n[1]) + std::fabs(n[2]);
+  if (l1 == 0.0f) {
+    outU = outV = 0.0f;
+    return;
+  }
+  const float u = n[0] / l1;
+  const float v = n[1] / l1;
+  if (n[2] >= 0.0f) {
+    outU = u;
+    outV = v;
+  } else {
+    outU = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+    outV = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+  }
+}
+
+void decodeOctahedral(float u, float v, float* outNormal) {
+  float n[3] = {u, v, 1.0f - std::fabs(u) - std::fabs(v)};
+  const float t = std::max(-n[2], 0.0f);
+  n[0] += n[0] >= 0.0f ? -t : t;
+  n[1] += n[1] >= 0.0f ? -t : t;
+  const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+  for (int i = 0; i != 3; i++) {
+    outNormal[i] = n[i] / length;
+  }
+}
+
+// a zero extent has nothing to quantize; any scale reproduces the offset
+float toScale(float extent) {
+  return extent > 0.0f ? extent : 1.0f;
+}
+
+const char* kDecodeGLSL = R"(
+vec3 iglDecodePosition(vec3 position, vec3 scale, vec3 offset) {
+  return position * scale + offset;
+}
+
+vec3 iglDecodeNormal(vec2 octahedral) {
+  vec3 n = vec3(octahedral, 1.0 - abs(octahedral.x) - abs(octahedral.y));
+  float t = max(-n.z, 0.0);
+  n.x += n.x >= 0.0 ? -t : t;
+  n.y += n.y >= 0.0 ? -t : t;
+  return normalize(n);
+}
+
+vec2 iglDecodeUV(vec2 uv, vec2 scale, vec2 offset) {
+  return uv * scale + offset;
+}
+)";
+
+const char* kDecodeMSL = R"(
+float3 iglDecodePosition(float3 position, float3 scale, float3 offset) {
+  return position * scale + offset;
+}
+
+float3 iglDecodeNormal(float2 octahedral) {
+  float3 n = float3(octahedral, 1.0 - abs(octahedral.x) - abs(octahedral.y));
+  float t = max(-n.z, 0.0);
+  n.x += n.x >= 0.0 ? -t : t;
+  n.y += n.y >= 0.0 ? -t : t;
+  return normalize(n);
+}
+
+float2 iglDecodeUV(float2 uv, float2 scale, float2 offset) {
+  return uv * scale + offset;
+}
+)";
+
+} // namespace
+
+size_t CompressedVertices::getNormalOffset() const {
+  return kPositionSize;
+}
+
+size_t CompressedVertices::getUVOffset() const {
+  return kPositionSize + (hasNormals ? kNormalSize : 0);
+}
+
+igl::VertexInputStateDesc CompressedVertices::getVertexInputStateDesc(size_t bufferIndex,
+                                                                      int firstLocation) const {
+  igl::VertexInputStateDesc desc;
+  auto addAttribute = [&desc, bufferIndex, firstLocation](
+                          igl::VertexAttributeFormat format, size_t offset, const char* name) {
+    const int location = firstLocation + static_cast<int>(desc.numAttributes);
+    desc.attributes[desc.numAttributes++] =
+        igl::VertexAttribute(bufferIndex, format, offset, name, location);
+  };
+  const igl::VertexAttributeFormat format = positionFormat == PositionFormat::HalfFloat
+                                                ? igl::VertexAttributeFormat::HalfFloat4
+                                                : igl::VertexAttributeFormat::Short4Norm;
+  addAttribute(format, 0, "position");
+  if (hasNormals) {
+    addAttribute(igl::VertexAttributeFormat::Short2Norm, getNormalOffset(), "normal");
+  }
+  if (hasUVs) {
+    addAttribute(igl::VertexAttributeFormat::UShort2Norm, getUVOffset(), "uv");
+  }
+  desc.numInputBindings = bufferIndex + 1;
+  desc.inputBindings[bufferIndex].stride = stride;
+  return desc;
+}
+
+CompressedVertices compress(const VertexStreams& streams, PositionFormat positionFormat) {
+  CompressedVertices result;
+  if (!streams.positions || !streams.vertexCount) {
+    return result;
+  }
+
+  result.positionFormat = positionFormat;
+  result.hasNormals = streams.normals != nullptr;
+  result.hasUVs = streams.uvs != nullptr;
+  result.vertexCount = streams.vertexCount;
+  result.stride = getStride(result.hasNormals, result.hasUVs);
+  result.data.resize(result.vertexCount * result.stride);
+
+  if (positionFormat == PositionFormat::Snorm16) {
+    // every axis gets the full precision across the bounding box
+    float minPos[3] = {INFINITY, INFINITY, INFINITY};
+    float maxPos[3] = {-INFINITY, -INFINITY, -INFINITY};
+    for (size_t i = 0; i != streams.vertexCount; i++) {
+      const float* p = at(streams.positions, streams.positionStride, i);
+      for (int c = 0; c != 3; c++) {
+        minPos[c] = std::min(minPos[c], p[c]);
+        maxPos[c] = std::max(maxPos[c], p[c]);
+      }
+    }
+    for (int c = 0; c != 3; c++) {
+      result.positionScale[c] = toScale(0.5f * (maxPos[c] - minPos[c]));
+      result.positionOffset[c] = 0.5f * (maxPos[c] + minPos[c]);
+    }
+  }
+  if (result.hasUVs) {
+    float minUV[2] = {INFINITY, INFINITY};
+    float maxUV[2] = {-INFINITY, -INFINITY};
+    for (size_t i = 0; i != streams.vertexCount; i++) {
+      const float* uv = at(streams.uvs, streams.uvStride, i);
+      for (int c = 0; c != 2; c++) {
+        minUV[c] = std::min(minUV[c], uv[c]);
+        maxUV[c] = std::max(maxUV[c], uv[c]);
+      }
+    }
+    for (int c = 0; c != 2; c++) {
+      result.uvScale[c] = toScale(maxUV[c] - minUV[c]);
+      result.uvOffset[c] = minUV[c];
+    }
+  }
+
+  for (size_t i = 0; i != streams.vertexCount; i++) {
+    uint8_t* vertex = result.data.data() + i * result.stride;
+
+    const float* p = at(streams.positions, streams.positionStride, i);
+    uint16_t position[4] = {};
+    for (int c = 0; c != 3; c++) {
+      position[c] = positionFormat == PositionFormat::HalfFloat
+                        ? meshopt_quantizeHalf(p[c])
+                        : snorm((p[c] - result.positionOffset[c]) / result.positionScale[c]);
+    }
+    // w = 1, so the position can be read as a homogeneous vec4
+    position[3] = positionFormat == PositionFormat::HalfFloat ? meshopt_quantizeHalf(1.0f)
+                                                              : snorm(1.0f);
+    std::memcpy(vertex, position, sizeof(position));
+
+    if (result.hasNormals) {
+      float u = 0.0f, v = 0.0f;
+      encodeOctahedral(at(streams.normals, streams.normalStride, i), u, v);
+      const uint16_t normal[2] = {snorm(u), snorm(v)};
+      std::memcpy(vertex + result.getNormalOffset(), normal, sizeof(normal));
+    }
+
+    if (result.hasUVs) {
+      const float* uv = at(streams.uvs, streams.uvStride, i);
+      const uint16_t quantized[2] = {
+          unorm((uv[0] - result.uvOffset[0]) / result.uvScale[0]),
+          unorm((uv[1] - result.uvOffset[1]) / result.uvScale[1]),
+      };
+      std::memcpy(vertex + result.getUVOffset(), quantized, sizeof(quantized));
+    }
+  }
+
+  return result;
+}
+
+void decompress(const CompressedVertices& vertices,
+                float* outPositions,
+                float* outNormals,
+                float* outUVs) {
+  for (size_t i = 0; i != vertices.vertexCount; i++) {
+    const uint8_t* vertex = vertices.data.data() + i * vertices.stride;
+
+    if (outPositions) {
+      uint16_t position[4] = {};
+      std::memcpy(position, vertex, sizeof(position));
+      for (int c = 0; c != 3; c++) {
+        const float value = vertices.positionFormat == PositionFormat::HalfFloat
+                                ? fromHalf(position[c])
+                                : fromSnorm(position[c]);
+        outPositions[3 * i + c] = value * vertices.positionScale[c] + vertices.positionOffset[c];
+      }
+    }
+    if (outNormals && vertices.hasNormals) {
+      uint16_t normal[2] = {};
+      std::memcpy(normal, vertex + vertices.getNormalOffset(), sizeof(normal));
+      decodeOctahedral(fromSnorm(normal[0]), fromSnorm(normal[1]), outNormals + 3 * i);
+    }
+    if (outUVs && vertices.hasUVs) {
+      uint16_t uv[2] = {};
+      std::memcpy(uv, vertex + vertices.getUVOffset(), sizeof(uv));
+      for (int c = 0; c != 2; c++) {
+        outUVs[2 * i + c] = fromUnorm(uv[c]) * vertices.uvScale[c] + vertices.uvOffset[c];
+      }
+    }
+  }
+}
+
+const char* getDecodeShaderSource(igl::BackendType backend) {
+  return backend == igl::BackendType::Metal ? kDecodeMSL : kDecodeGLSL;
+}
+
+std::vector<uint8_t> serialize(const CompressedVertices& vertices) {
+  IGL_ASSERT(vertices.data.size() == vertices.vertexCount * vertices.stride);
+
+  const size_t stride = getStride(vertices.hasNormals, vertices.hasUVs);
+
+  // meshopt_encodeVertexBuffer() needs a stride which is a multiple of 4, which all layouts are
+  std::vector<uint8_t> encoded;
+  if (vertices.vertexCount) {
+    encoded.resize(meshopt_encodeVertexBufferBound(vertices.vertexCount, stride));
+    encoded.resize(meshopt_encodeVertexBuffer(
+        encoded.data(), encoded.size(), vertices.data.data(), vertices.vertexCount, stride));
+  }
+
+  Header header = {};
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.flags = static_cast<uint32_t>(vertices.positionFormat) |
+                 (vertices.hasNormals ? kFlagNormals : 0) | (vertices.hasUVs ? kFlagUVs : 0);
+  header.vertexCount = static_cast<uint32_t>(vertices.vertexCount);
+  header.stride = static_cast<uint32_t>(stride);
+  header.encodedSize = static_cast<uint32_t>(encoded.size());
+  for (int c = 0; c != 3; c++) {
+    header.positionScale[c] = vertices.positionScale[c];
+    header.positionOffset[c] = vertices.positionOffset[c];
+  }
+  for (int c = 0; c != 2; c++) {
+    header.uvScale[c] = vertices.uvScale[c];
+    header.uvOffset[c] = vertices.uvOffset[c];
+  }
+
+  std::vector<uint8_t> data(sizeof(header) + encoded.size());
+  std::memcpy(data.data(), &header, sizeof(header));
+  if (!encoded.empty()) {
+    std::memcpy(data.data() + sizeof(header), encoded.data(), encoded.size());
+  }
+  return data;
+}
+
+bool deserialize(const uint8_t* data, size_t length, CompressedVertices& outVertices) {
+  outVertices = CompressedVertices();
+
+  Header header = {};
+  if (!data || length < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, data, sizeof(header));
+
+  const uint32_t positionFormat = header.flags & kPositionFormatMask;
+  const bool hasNormals = (header.flags & kFlagNormals) != 0;
+  const bool hasUVs = (header.flags & kFlagUVs) != 0;
+  if (header.magic != kMagic || header.version != kVersion ||
+      positionFormat > static_cast<uint32_t>(PositionFormat::HalfFloat) ||
+      header.stride != getStride(hasNormals, hasUVs) ||
+      header.encodedSize != length - sizeof(header)) {
+    return false;
+  }
+
+  CompressedVertices vertices;
+  vertices.positionFormat = static_cast<PositionFormat>(positionFormat);
+  vertices.hasNormals = hasNormals;
+  vertices.hasUVs = hasUVs;
+  vertices.vertexCount = header.vertexCount;
+  vertices.stride = header.stride;
+  vertices.data.resize(vertices.vertexCount * vertices.stride);
+  if (vertices.vertexCount) {
+    const int error = meshopt_decodeVertexBuffer(vertices.data.data(),
+                                                 vertices.vertexCount,
+                                                 vertices.stride,
+                                                 data + sizeof(header),
+                                                 header.encodedSize);
+    if (error != 0) {
+      return false;
+    }
+  }
+  for (int c = 0; c != 3; c++) {
+    vertices.positionScale[c] = header.positionScale[c];
+    vertices.positionOffset[c] = header.positionOffset[c];
+  }
+  for (int c = 0; c != 2; c++) {
+    vertices.uvScale[c] = header.uvScale[c];
+    vertices.uvOffset[c] = header.uvOffset[c];
+  }
+
+  outVertices = std::move(vertices);
+  return true;
+}
+
+} // namespace vertexcompression
+} // namespace iglu
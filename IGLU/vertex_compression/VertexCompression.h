@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+#include <cstddef>
+#include <cstdint>
+#include <igl/IGL.h>
+#include <vector>
+
+namespace iglu {
+namespace vertexcompression {
+
+enum class PositionFormat : uint8_t {
+  /// igl::VertexAttributeFormat::Short4Norm relative to the bounding box of the positions: 16 bits
+  /// of precision across the whole mesh, which suits meshes of any size.
+  Snorm16 = 0,
+  /// igl::VertexAttributeFormat::HalfFloat4 of the positions themselves: no dequantization in the
+  /// shader, but only 11 bits of precision, so the mesh should be centered around its origin.
+  HalfFloat = 1,
+};
+
+/// The streams of 'vertexCount' uncompressed vertices. The strides are in bytes; 'normals' and
+/// 'uvs' can be null, in which case the compressed vertices have no such attribute.
+struct VertexStreams {
+  size_t vertexCount = 0;
+  /// 3 floats per vertex
+  const float* positions = nullptr;
+  size_t positionStride = 3 * sizeof(float);
+  /// 3 floats per vertex, of unit length
+  const float* normals = nullptr;
+  size_t normalStride = 3 * sizeof(float);
+  /// 2 floats per vertex
+  const float* uvs = nullptr;
+  size_t uvStride = 2 * sizeof(float);
+};
+
+/// Interleaved compressed vertices. Each vertex holds, in this order:
+///   - the position: 8 bytes, see PositionFormat; the w component is 1;
+///   - the normal, if any: 4 bytes of octahedral coordinates (VertexAttributeFormat::Short2Norm);
+///   - the UV, if any: 4 bytes relative to the UV bounds (VertexAttributeFormat::UShort2Norm).
+/// The shader decodes them with the functions of getDecodeShaderSource():
+///   position = iglDecodePosition(attribute.xyz, positionScale, positionOffset)
+///   normal = iglDecodeNormal(attribute)
+///   uv = iglDecodeUV(attribute, uvScale, uvOffset)
+/// A vertex with a position, a normal and a UV takes 16 bytes instead of 32.
+struct CompressedVertices {
+  PositionFormat positionFormat = PositionFormat::Snorm16;
+  bool hasNormals = false;
+  bool hasUVs = false;
+  size_t vertexCount = 0;
+  size_t stride = 0;
+  std::vector<uint8_t> data;
+
+  /// The w components are unused.
+  simdtypes::float4 positionScale = {1.0f, 1.0f, 1.0f, 0.0f};
+  simdtypes::float4 positionOffset = {};
+  simdtypes::float2 uvScale = {1.0f, 1.0f};
+  simdtypes::float2 uvOffset = {};
+
+  /// Byte offsets of the attributes in a vertex
+  [[nodiscard]] size_t getNormalOffset() const;
+  [[nodiscard]] size_t getUVOffset() const;
+
+  /// Describes the vertices bound at 'bufferIndex'. The attributes are named "position", "normal"
+  /// and "uv", and use consecutive locations starting at 'firstLocation'.
+  [[nodiscard]] igl::VertexInputStateDesc getVertexInputStateDesc(size_t bufferIndex = 0,
+                                                                  int firstLocation = 0) const;
+};
+
+/// Quantizes the vertices with the meshoptimizer quantization helpers. Returns empty compressed
+/// vertices if 'streams' has no positions.
+CompressedVertices compress(const VertexStreams& streams,
+                            PositionFormat positionFormat = PositionFormat::Snorm16);
+
+/// Dequantizes the vertices into tightly packed floats (3 per position and normal, 2 per UV), for
+/// tools and tests. Null outputs are skipped.
+void decompress(const CompressedVertices& vertices,
+                float* outPositions,
+                float* outNormals,
+                float* outUVs);
+
+/// GLSL (igl::BackendType::OpenGL and Vulkan) or Metal Shading Language functions decoding the
+/// attributes of CompressedVertices, to be pasted into vertex shaders.
+[[nodiscard]] const char* getDecodeShaderSource(igl::BackendType backend);
+
+/// Serializes the compressed vertices into a versioned, little endian binary blob. The vertex data
+/// is additionally compressed with meshopt_encodeVertexBuffer(), which typically halves it again
+/// for meshes optimized for the vertex cache and vertex fetch.
+std::vector<uint8_t> serialize(const CompressedVertices& vertices);
+
+/// Reads compressed vertices written by serialize(). Returns false if 'data' was not produced by a
+/// compatible version of serialize() or is corrupted, in which case 'outVertices' is left empty.
+bool deserialize(const uint8_t* data, size_t length, CompressedVertices& outVertices);
+
+} // namespace vertexcompression
+} // namespace iglu
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "VideoRecorder.h"
+
+#include <igl/Common.h>
+#include <utility>
+
+namespace iglu {
+namespace videorecorder {
+
+VideoRecorder::VideoRecorder(std::unique_ptr<IVideoEncoder> encoder) :
+  encoder_(std::move(encoder)) {
+  IGL_ASSERT(encoder_);
+}
+
+VideoRecorder::~VideoRecorder() {
+  finish();
+}
+
+bool VideoRecorder::recordFrame(igl::ICommandQueue& cmdQueue,
+                                const igl::IFramebuffer& framebuffer,
+                                uint64_t timestampNs) {
+  update();
+
+  const auto texture = framebuffer.getColorAttachment(0);
+  if (!IGL_VERIFY(texture)) {
+    return false;
+  }
+  const igl::Dimensions size = texture->getDimensions();
+
+  auto cmdBuffer = cmdQueue.createCommandBuffer({}, nullptr);
+  if (!IGL_VERIFY(cmdBuffer)) {
+    return false;
+  }
+  auto inputTexture = encoder_->acquireInputTexture(size);
+  if (!inputTexture) {
+    numFramesDropped_++;
+    return false;
+  }
+
+  framebuffer.copyTextureColorAttachment(
+      cmdQueue, 0, inputTexture, igl::TextureRangeDesc::new2D(0, 0, size.width, size.height));
+  // queues execute in order: the copy has completed once this empty command buffer has
+  cmdQueue.submit(*cmdBuffer);
+
+  pendingFrames_.push_back({std::move(cmdBuffer), std::move(inputTexture), timestampNs});
+  numFramesRecorded_++;
+  return true;
+}
+
+void VideoRecorder::update() {
+  while (!pendingFrames_.empty() && pendingFrames_.front().cmdBuffer->isCompleted()) {
+    const PendingFrame& frame = pendingFrames_.front();
+    encoder_->encodeFrame(frame.inputTexture, frame.timestampNs);
+    pendingFrames_.pop_front();
+  }
+}
+
+void VideoRecorder::finish() {
+  while (!pendingFrames_.empty()) {
+    const PendingFrame& frame = pendingFrames_.front();
+    frame.cmdBuffer->waitUntilCompleted();
+    encoder_->encodeFrame(frame.inputTexture, frame.timestampNs);
+    pendingFrames_.pop_front();
+  }
+  encoder_->finish();
+}
+
+} // namespace videorecorder
+} // namespace iglu
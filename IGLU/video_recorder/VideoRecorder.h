@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <igl/CommandBuffer.h>
+#include <igl/CommandQueue.h>
+#include <igl/Framebuffer.h>
+#include <igl/Texture.h>
+#include <memory>
+
+namespace iglu {
+namespace videorecorder {
+
+/// A hardware video encoder reading its input straight from GPU memory, such as VideoToolbox with
+/// IOSurface-backed pixel buffers or MediaCodec with AHardwareBuffers.
+class IVideoEncoder {
+ public:
+  virtual ~IVideoEncoder() = default;
+
+  /// Returns a texture aliasing a free input surface of the encoder, usable as the destination of
+  /// a GPU copy, or nullptr if every surface is still being encoded. The surface stays reserved
+  /// until the texture is passed to encodeFrame().
+  virtual std::shared_ptr<igl::ITexture> acquireInputTexture(const igl::Dimensions& size) = 0;
+
+  /// Queues an acquired texture for encoding; the GPU has finished writing it
+  virtual void encodeFrame(const std::shared_ptr<igl::ITexture>& inputTexture,
+                           uint64_t timestampNs) = 0;
+
+  /// Waits until every queued frame is encoded
+  virtual void finish() = 0;
+};
+
+/**
+ * @brief Feeds rendered frames to an IVideoEncoder without any CPU readback.
+ *
+ * Every frame is copied on the GPU into an input surface of the encoder, and is handed over to
+ * the encoder once the copy has completed. Recording never stalls rendering: a frame is dropped
+ * when the encoder has no free input surface.
+ *
+ * Not thread-safe: call recordFrame(), update() and finish() from the render thread.
+ */
+class VideoRecorder final {
+ public:
+  explicit VideoRecorder(std::unique_ptr<IVideoEncoder> encoder);
+  /// Encodes all the recorded frames
+  ~VideoRecorder();
+
+  VideoRecorder(const VideoRecorder&) = delete;
+  VideoRecorder& operator=(const VideoRecorder&) = delete;
+
+  /// Records the first color attachment of `framebuffer`; call it after the frame is submitted to
+  /// `cmdQueue`. Returns false if the frame is dropped.
+  bool recordFrame(igl::ICommandQueue& cmdQueue,
+                   const igl::IFramebuffer& framebuffer,
+                   uint64_t timestampNs);
+
+  /// Hands the frames whose copies have completed over to the encoder. Never waits.
+  void update();
+
+  /// Waits until every recorded frame is encoded
+  void finish();
+
+  [[nodiscard]] uint64_t getNumFramesRecorded() const {
+    return numFramesRecorded_;
+  }
+  [[nodiscard]] uint64_t getNumFramesDropped() const {
+    return numFramesDropped_;
+  }
+
+ private:
+  struct PendingFrame {
+    std::shared_ptr<igl::ICommandBuffer> cmdBuffer; // completes after the copy
+    std::shared_ptr<igl::ITexture> inputTexture;
+    uint64_t timestampNs = 0;
+  };
+
+  std::unique_ptr<IVideoEncoder> encoder_;
+  std::deque<PendingFrame> pendingFrames_;
+  uint64_t numFramesRecorded_ = 0;
+  uint64_t numFramesDropped_ = 0;
+};
+
+} // namespace videorecorder
+} // namespace iglu
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "VideoRecorder.h"
+
+#include <VideoToolbox/VideoToolbox.h>
+#include <functional>
+#include <igl/Device.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace iglu {
+namespace videorecorder {
+
+/// Encodes frames with VideoToolbox. The input surfaces are IOSurface-backed pixel buffers which
+/// are rendered to through Metal textures aliasing them, without any copy.
+class VideoToolboxEncoder final : public IVideoEncoder {
+ public:
+  struct Config {
+    int32_t width = 0;
+    int32_t height = 0;
+    CMVideoCodecType codec = kCMVideoCodecType_H264;
+    /// Bits per second; 0 leaves the choice to the encoder
+    int32_t averageBitRate = 0;
+    /// Frames being copied or encoded at the same time at most
+    uint32_t maxFramesInFlight = 3;
+  };
+
+  /// Called from a VideoToolbox thread with every encoded frame, in decode order
+  using OutputHandler = std::function<void(CMSampleBufferRef sampleBuffer)>;
+
+  /// Requires a Metal device; the frames have to be BGRA_UNorm8 or BGRA_SRGB
+  static std::unique_ptr<VideoToolboxEncoder> create(igl::IDevice& device,
+                                                     const Config& config,
+                                                     OutputHandler outputHandler,
+                                                     igl::Result* outResult);
+  ~VideoToolboxEncoder() override;
+
+  std::shared_ptr<igl::ITexture> acquireInputTexture(const igl::Dimensions& size) override;
+  void encodeFrame(const std::shared_ptr<igl::ITexture>& inputTexture,
+                   uint64_t timestampNs) override;
+  void finish() override;
+
+ private:
+  VideoToolboxEncoder(igl::IDevice& device, const Config& config, OutputHandler outputHandler);
+
+  static void onFrameEncoded(void* encoder,
+                             void* sourceFrame,
+                             OSStatus status,
+                             VTEncodeInfoFlags infoFlags,
+                             CMSampleBufferRef sampleBuffer);
+
+  igl::IDevice& device_;
+  const Config config_;
+  OutputHandler outputHandler_;
+  VTCompressionSessionRef session_ = nullptr;
+
+  std::mutex mutex_;
+  uint32_t numFramesInFlight_ = 0; // guarded by mutex_, decremented by VideoToolbox threads
+  // the pixel buffers aliased by the acquired textures, retained until they are encoded
+  std::unordered_map<const igl::ITexture*, CVPixelBufferRef> pixelBuffers_;
+};
+
+} // namespace videorecorder
+} // namespace iglu
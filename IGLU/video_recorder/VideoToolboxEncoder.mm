@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "VideoToolboxEncoder.h"
+
+#import <Foundation/Foundation.h>
+#include <igl/metal/PlatformDevice.h>
+
+namespace iglu {
+namespace videorecorder {
+
+std::unique_ptr<VideoToolboxEncoder> VideoToolboxEncoder::create(igl::IDevice& device,
+                                                                 const Config& config,
+                                                                 OutputHandler outputHandler,
+                                                                 igl::Result* outResult) {
+  if (!device.getPlatformDevice<igl::metal::PlatformDevice>()) {
+    igl::Result::setResult(outResult, igl::Result::Code::Unsupported, "Requires a Metal device");
+    return nullptr;
+  }
+  if (config.width <= 0 || config.height <= 0 || config.maxFramesInFlight == 0) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Invalid config");
+    return nullptr;
+  }
+
+  std::unique_ptr<VideoToolboxEncoder> encoder(
+      new VideoToolboxEncoder(device, config, std::move(outputHandler)));
+
+  // the session's pool allocates IOSurface-backed buffers which Metal can render to
+  NSDictionary* sourceAttributes = @{
+    (id)kCVPixelBufferPixelFormatTypeKey : @(kCVPixelFormatType_32BGRA),
+    (id)kCVPixelBufferWidthKey : @(config.width),
+    (id)kCVPixelBufferHeightKey : @(config.height),
+    (id)kCVPixelBufferIOSurfacePropertiesKey : @{},
+    (id)kCVPixelBufferMetalCompatibilityKey : @YES,
+  };
+  const OSStatus status = VTCompressionSessionCreate(kCFAllocatorDefault,
+                                                     config.width,
+                                                     config.height,
+                                                     config.codec,
+                                                     nullptr,
+                                                     (__bridge CFDictionaryRef)sourceAttributes,
+                                                     kCFAllocatorDefault,
+                                                     &VideoToolboxEncoder::onFrameEncoded,
+                                                     encoder.get(),
+                                                     &encoder->session_);
+  if (status != noErr) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::RuntimeError, "VTCompressionSessionCreate() failed");
+    return nullptr;
+  }
+
+  VTSessionSetProperty(encoder->session_, kVTCompressionPropertyKey_RealTime, kCFBooleanTrue);
+  if (config.averageBitRate > 0) {
+    VTSessionSetProperty(encoder->session_,
+                         kVTCompressionPropertyKey_AverageBitRate,
+                         (__bridge CFNumberRef) @(config.averageBitRate));
+  }
+  VTCompressionSessionPrepareToEncodeFrames(encoder->session_);
+
+  igl::Result::setOk(outResult);
+  return encoder;
+}
+
+VideoToolboxEncoder::VideoToolboxEncoder(igl::IDevice& device,
+                                         const Config& config,
+                                         OutputHandler outputHandler) :
+  device_(device), config_(config), outputHandler_(std::move(outputHandler)) {}
+
+VideoToolboxEncoder::~VideoToolboxEncoder() {
+  if (session_) {
+    finish();
+    VTCompressionSessionInvalidate(session_);
+    CFRelease(session_);
+  }
+  for (const auto& it : pixelBuffers_) {
+    CVPixelBufferRelease(it.second);
+  }
+}
+
+std::shared_ptr<igl::ITexture> VideoToolboxEncoder::acquireInputTexture(
+    const igl::Dimensions& size) {
+  if (!IGL_VERIFY(size.width == static_cast<uint32_t>(config_.width) &&
+                  size.height == static_cast<uint32_t>(config_.height))) {
+    return nullptr;
+  }
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (numFramesInFlight_ >= config_.maxFramesInFlight) {
+      return nullptr;
+    }
+    numFramesInFlight_++;
+  }
+
+  CVPixelBufferRef pixelBuffer = nullptr;
+  CVPixelBufferPoolRef pool = VTCompressionSessionGetPixelBufferPool(session_);
+  if (!pool ||
+      CVPixelBufferPoolCreatePixelBuffer(kCFAllocatorDefault, pool, &pixelBuffer) !=
+          kCVReturnSuccess) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    numFramesInFlight_--;
+    return nullptr;
+  }
+
+  auto* platformDevice = device_.getPlatformDevice<igl::metal::PlatformDevice>();
+  std::shared_ptr<igl::ITexture> texture = platformDevice->createTextureFromNativeIOSurface(
+      CVPixelBufferGetIOSurface(pixelBuffer),
+      igl::TextureFormat::BGRA_UNorm8,
+      0,
+      igl::TextureDesc::TextureUsageBits::Sampled | igl::TextureDesc::TextureUsageBits::Attachment,
+      nullptr);
+  if (!IGL_VERIFY(texture)) {
+    CVPixelBufferRelease(pixelBuffer);
+    const std::lock_guard<std::mutex> lock(mutex_);
+    numFramesInFlight_--;
+    return nullptr;
+  }
+
+  pixelBuffers_[texture.get()] = pixelBuffer;
+  return texture;
+}
+
+void VideoToolboxEncoder::encodeFrame(const std::shared_ptr<igl::ITexture>& inputTexture,
+                                      uint64_t timestampNs) {
+  const auto it = pixelBuffers_.find(inputTexture.get());
+  if (!IGL_VERIFY(it != pixelBuffers_.end())) {
+    return;
+  }
+  CVPixelBufferRef pixelBuffer = it->second;
+  pixelBuffers_.erase(it);
+
+  // VideoToolbox retains the pixel buffer until it is encoded
+  const OSStatus status =
+      VTCompressionSessionEncodeFrame(session_,
+                                      pixelBuffer,
+                                      CMTimeMake(static_cast<int64_t>(timestampNs), 1000000000),
+                                      kCMTimeInvalid,
+                                      nullptr,
+                                      nullptr,
+                                      nullptr);
+  CVPixelBufferRelease(pixelBuffer);
+  if (status != noErr) {
+    IGLLog(IGLLogLevel::LOG_ERROR, "VTCompressionSessionEncodeFrame() failed: %d\n", status);
+    const std::lock_guard<std::mutex> lock(mutex_);
+    numFramesInFlight_--;
+  }
+}
+
+void VideoToolboxEncoder::finish() {
+  VTCompressionSessionCompleteFrames(session_, kCMTimeInvalid);
+}
+
+void VideoToolboxEncoder::onFrameEncoded(void* encoder,
+                                         void* /*sourceFrame*/,
+                                         OSStatus status,
+                                         VTEncodeInfoFlags infoFlags,
+                                         CMSampleBufferRef sampleBuffer) {
+  auto* self = static_cast<VideoToolboxEncoder*>(encoder);
+  {
+    const std::lock_guard<std::mutex> lock(self->mutex_);
+    self->numFramesInFlight_--;
+  }
+  if (status != noErr || (infoFlags & kVTEncodeInfo_FrameDropped) || !sampleBuffer) {
+    return;
+  }
+  if (self->outputHandler_) {
+    self->outputHandler_(sampleBuffer);
+  }
+}
+
+} // namespace videorecorder
+} // namespace iglu
@@ -12,3 +12,107 @@ function(igl_set_cxxstd target cpp_version)
   set_property(TARGET ${target} PROPERTY CXX_STANDARD ${cpp_version})
   set_property(TARGET ${target} PROPERTY CXX_STANDARD_REQUIRED ON)
 endfunction()
+
+# Compiles shaders at build time into a bundle loaded by iglu::shaderbundle::ShaderBundle, and
+# makes <target> depend on it:
+#
+#   igl_add_shader_bundle(<target> <bundle>
+#     [VULKAN <name>:<stage>:<file.glsl> ...]
+#     [OPENGL <name>:<stage>:<file.glsl> ...]
+#     [METAL  <name>:<stage>:<entryPoint>:<file.metal> ...])
+#
+# <stage> is vertex, fragment or compute. Vulkan GLSL is compiled to SPIR-V and OpenGL GLSL is
+# validated, both with the IGLShaderBundler host tool; set IGL_SHADER_BUNDLER to a host build of
+# it when cross-compiling. Metal shaders are compiled to one metallib per <name> with xcrun and are
+# skipped on other hosts.
+function(igl_add_shader_bundle target bundle)
+  cmake_parse_arguments(ARG "" "" "VULKAN;OPENGL;METAL" ${ARGN})
+  if(IGL_SHADER_BUNDLER)
+    set(bundler "${IGL_SHADER_BUNDLER}")
+  elseif(TARGET IGLShaderBundler)
+    set(bundler "$<TARGET_FILE:IGLShaderBundler>")
+  else()
+    message(FATAL_ERROR "igl_add_shader_bundle() needs IGL_SHADER_BUNDLER or IGL_WITH_VULKAN")
+  endif()
+
+  set(bundler_args "")
+  set(depends "")
+  foreach(format_name "VULKAN;spirv" "OPENGL;glsl")
+    list(GET format_name 0 backend)
+    list(GET format_name 1 format)
+    foreach(shader ${ARG_${backend}})
+      # the file is the last field, which may contain ':' on Windows
+      string(REPLACE ":" ";" fields "${shader}")
+      list(GET fields 0 name)
+      list(GET fields 1 stage)
+      list(SUBLIST fields 2 -1 file)
+      string(REPLACE ";" ":" file "${file}")
+      get_filename_component(file "${file}" ABSOLUTE)
+      list(APPEND bundler_args ${name} ${format} ${stage} main "${file}")
+      list(APPEND depends "${file}")
+    endforeach()
+  endforeach()
+
+  if(APPLE AND ARG_METAL)
+    if(IOS)
+      set(metal_sdk iphoneos)
+    else()
+      set(metal_sdk macosx)
+    endif()
+    set(metal_names "")
+    foreach(shader ${ARG_METAL})
+      string(REPLACE ":" ";" fields "${shader}")
+      list(GET fields 0 name)
+      list(APPEND metal_names ${name})
+    endforeach()
+    list(REMOVE_DUPLICATES metal_names)
+    foreach(name ${metal_names})
+      set(air_files "")
+      set(metal_entries "")
+      foreach(shader ${ARG_METAL})
+        string(REPLACE ":" ";" fields "${shader}")
+        list(GET fields 0 shader_name)
+        if(NOT shader_name STREQUAL name)
+          continue()
+        endif()
+        list(GET fields 1 stage)
+        list(GET fields 2 entry_point)
+        list(SUBLIST fields 3 -1 file)
+        string(REPLACE ";" ":" file "${file}")
+        get_filename_component(file "${file}" ABSOLUTE)
+        get_filename_component(file_name "${file}" NAME_WE)
+        set(air "${CMAKE_CURRENT_BINARY_DIR}/${target}_shaders/${name}_${file_name}.air")
+        if(NOT air IN_LIST air_files)
+          add_custom_command(OUTPUT "${air}"
+                             COMMAND xcrun -sdk ${metal_sdk} metal -c "${file}" -o "${air}"
+                             DEPENDS "${file}"
+                             COMMENT "Compiling Metal shader ${file}")
+          list(APPEND air_files "${air}")
+        endif()
+        list(APPEND metal_entries ${stage} ${entry_point})
+      endforeach()
+      set(metallib "${CMAKE_CURRENT_BINARY_DIR}/${target}_shaders/${name}.metallib")
+      add_custom_command(OUTPUT "${metallib}"
+                         COMMAND xcrun -sdk ${metal_sdk} metallib ${air_files} -o "${metallib}"
+                         DEPENDS ${air_files}
+                         COMMENT "Linking Metal library ${metallib}")
+      list(LENGTH metal_entries num_fields)
+      math(EXPR last "${num_fields} - 1")
+      foreach(i RANGE 0 ${last} 2)
+        math(EXPR j "${i} + 1")
+        list(GET metal_entries ${i} stage)
+        list(GET metal_entries ${j} entry_point)
+        list(APPEND bundler_args ${name} metallib ${stage} ${entry_point} "${metallib}")
+      endforeach()
+      list(APPEND depends "${metallib}")
+    endforeach()
+  endif()
+
+  get_filename_component(bundle "${bundle}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_BINARY_DIR}")
+  add_custom_command(OUTPUT "${bundle}"
+                     COMMAND "${bundler}" "${bundle}" ${bundler_args}
+                     DEPENDS ${depends} $<$<TARGET_EXISTS:IGLShaderBundler>:IGLShaderBundler>
+                     COMMENT "Building shader bundle ${bundle}")
+  add_custom_target(${target}_shader_bundle DEPENDS "${bundle}")
+  add_dependencies(${target} ${target}_shader_bundle)
+endfunction()
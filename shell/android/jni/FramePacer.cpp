@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <dlfcn.h>
+#include <igl/Core.h>
+#include <thread>
+#include <unistd.h>
+
+namespace igl::samples {
+
+namespace {
+
+// values of AThermalStatus from <android/thermal.h>
+constexpr int kThermalStatusModerate = 2;
+constexpr int kThermalStatusSevere = 3;
+
+using AThermalStatusCallback = void (*)(void* data, int status);
+
+// functions of libandroid.so which are not available on every API level the shell runs on
+struct AndroidFunctions {
+  // API 30
+  AThermalManager* (*thermalAcquireManager)() = nullptr;
+  void (*thermalReleaseManager)(AThermalManager*) = nullptr;
+  int (*thermalGetCurrentStatus)(AThermalManager*) = nullptr;
+  int (*thermalRegisterListener)(AThermalManager*, AThermalStatusCallback, void*) = nullptr;
+  int (*thermalUnregisterListener)(AThermalManager*, AThermalStatusCallback, void*) = nullptr;
+  // API 33
+  APerformanceHintManager* (*hintGetManager)() = nullptr;
+  APerformanceHintSession* (*hintCreateSession)(APerformanceHintManager*,
+                                                const int32_t*,
+                                                size_t,
+                                                int64_t) = nullptr;
+  int (*hintUpdateTargetWorkDuration)(APerformanceHintSession*, int64_t) = nullptr;
+  int (*hintReportActualWorkDuration)(APerformanceHintSession*, int64_t) = nullptr;
+  void (*hintCloseSession)(APerformanceHintSession*) = nullptr;
+
+  [[nodiscard]] bool hasThermal() const {
+    return thermalAcquireManager && thermalReleaseManager && thermalGetCurrentStatus &&
+           thermalRegisterListener && thermalUnregisterListener;
+  }
+  [[nodiscard]] bool hasPerformanceHint() const {
+    return hintGetManager && hintCreateSession && hintUpdateTargetWorkDuration &&
+           hintReportActualWorkDuration && hintCloseSession;
+  }
+};
+
+template<typename T>
+void loadFunction(void* lib, T& func, const char* name) {
+  func = reinterpret_cast<T>(dlsym(lib, name));
+}
+
+const AndroidFunctions& getAndroidFunctions() {
+  static const AndroidFunctions functions = []() {
+    AndroidFunctions f;
+    // libandroid.so is already loaded by the process, so the handle is never closed
+    void* lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+    if (!lib) {
+      return f;
+    }
+    loadFunction(lib, f.thermalAcquireManager, "AThermal_acquireManager");
+    loadFunction(lib, f.thermalReleaseManager, "AThermal_releaseManager");
+    loadFunction(lib, f.thermalGetCurrentStatus, "AThermal_getCurrentThermalStatus");
+    loadFunction(lib, f.thermalRegisterListener, "AThermal_registerThermalStatusListener");
+    loadFunction(lib, f.thermalUnregisterListener, "AThermal_unregisterThermalStatusListener");
+    loadFunction(lib, f.hintGetManager, "APerformanceHint_getManager");
+    loadFunction(lib, f.hintCreateSession, "APerformanceHint_createSession");
+    loadFunction(lib, f.hintUpdateTargetWorkDuration, "APerformanceHint_updateTargetWorkDuration");
+    loadFunction(lib, f.hintReportActualWorkDuration, "APerformanceHint_reportActualWorkDuration");
+    loadFunction(lib, f.hintCloseSession, "APerformanceHint_closeSession");
+    return f;
+  }();
+  return functions;
+}
+
+} // namespace
+
+FramePacer::FramePacer(int64_t targetFrameDurationNanos) :
+  baseFrameDurationNanos_(targetFrameDurationNanos),
+  targetFrameDurationNanos_(targetFrameDurationNanos) {
+  const AndroidFunctions& f = getAndroidFunctions();
+
+  if (f.hasThermal()) {
+    thermalManager_ = f.thermalAcquireManager();
+    if (thermalManager_) {
+      thermalStatus_ = f.thermalGetCurrentStatus(thermalManager_);
+      if (f.thermalRegisterListener(thermalManager_, onThermalStatusChanged, this) != 0) {
+        IGL_LOG_INFO("FramePacer: cannot listen to the thermal status\n");
+      }
+    }
+  }
+  if (f.hasPerformanceHint()) {
+    hintManager_ = f.hintGetManager();
+  }
+
+  updateTarget();
+}
+
+FramePacer::~FramePacer() {
+  const AndroidFunctions& f = getAndroidFunctions();
+
+  if (hintSession_) {
+    f.hintCloseSession(hintSession_);
+  }
+  if (thermalManager_) {
+    f.thermalUnregisterListener(thermalManager_, onThermalStatusChanged, this);
+    f.thermalReleaseManager(thermalManager_);
+  }
+}
+
+void FramePacer::onThermalStatusChanged(void* data, int status) {
+  IGL_LOG_INFO("FramePacer: thermal status %d\n", status);
+  static_cast<FramePacer*>(data)->thermalStatus_ = status;
+}
+
+void FramePacer::updateTarget() {
+  const int status = thermalStatus_;
+
+  // give the device room to cool down: 2/3 of the frame rate when the status is moderate and half
+  // of it when it is severe or worse
+  int64_t duration = baseFrameDurationNanos_;
+  if (status >= kThermalStatusSevere) {
+    duration = baseFrameDurationNanos_ * 2;
+  } else if (status >= kThermalStatusModerate) {
+    duration = baseFrameDurationNanos_ * 3 / 2;
+  }
+
+  if (duration == targetFrameDurationNanos_) {
+    return;
+  }
+  targetFrameDurationNanos_ = duration;
+  if (hintSession_) {
+    getAndroidFunctions().hintUpdateTargetWorkDuration(hintSession_, targetFrameDurationNanos_);
+  }
+}
+
+void FramePacer::beginFrame() {
+  // the session has to be created on the render thread, which is the one doing the work
+  if (hintManager_ && !isHintSessionCreated_) {
+    isHintSessionCreated_ = true;
+    const int32_t tid = gettid();
+    hintSession_ =
+        getAndroidFunctions().hintCreateSession(hintManager_, &tid, 1, targetFrameDurationNanos_);
+    if (!hintSession_) {
+      IGL_LOG_INFO("FramePacer: performance hint sessions are not supported\n");
+    }
+  }
+
+  updateTarget();
+
+  // frames start on vsync, so they only have to be delayed when throttled
+  if (targetFrameDurationNanos_ > baseFrameDurationNanos_ &&
+      lastFrameStart_ != Clock::time_point()) {
+    const Clock::time_point deadline =
+        lastFrameStart_ + std::chrono::nanoseconds(targetFrameDurationNanos_);
+    std::this_thread::sleep_until(deadline);
+  }
+
+  frameStart_ = Clock::now();
+  lastFrameStart_ = frameStart_;
+}
+
+void FramePacer::endFrame() {
+  if (!hintSession_) {
+    return;
+  }
+  const int64_t actualDurationNanos =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - frameStart_).count();
+  // zero or negative durations are rejected by the session
+  getAndroidFunctions().hintReportActualWorkDuration(hintSession_,
+                                                     std::max<int64_t>(actualDurationNanos, 1));
+}
+
+int64_t FramePacer::getTargetFrameDurationNanos() const {
+  return targetFrameDurationNanos_;
+}
+
+} // namespace igl::samples
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+struct AThermalManager;
+struct APerformanceHintManager;
+struct APerformanceHintSession;
+
+namespace igl::samples {
+
+/**
+ * @brief Keeps the frame rate sustainable on Android devices.
+ *
+ * Frames are started on vsync by Choreographer (Vulkan) or GLSurfaceView (OpenGL). The pacer
+ * reports the CPU work duration of every frame to an ADPF performance hint session (API 33+), so
+ * the system picks CPU clocks that meet the target frame duration instead of boosting and then
+ * throttling. It also listens to the thermal status (API 30+): once the device heats up, the
+ * target frame duration is increased and frames are delayed to meet it, which scales the workload
+ * back before the system throttles it.
+ *
+ * The NDK functions are resolved at runtime, so the pacer does nothing on older Android versions.
+ */
+class FramePacer final {
+ public:
+  explicit FramePacer(int64_t targetFrameDurationNanos = 16'666'667);
+  ~FramePacer();
+
+  FramePacer(const FramePacer&) = delete;
+  FramePacer& operator=(const FramePacer&) = delete;
+
+  // called on the render thread before and after the work of a frame
+  void beginFrame();
+  void endFrame();
+
+  // the frame duration the pacer currently aims for, depending on the thermal status
+  [[nodiscard]] int64_t getTargetFrameDurationNanos() const;
+
+ private:
+  static void onThermalStatusChanged(void* data, int status);
+  void updateTarget();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  const int64_t baseFrameDurationNanos_;
+  int64_t targetFrameDurationNanos_;
+
+  // written by the thermal listener on a binder thread
+  std::atomic<int> thermalStatus_ = 0;
+
+  AThermalManager* thermalManager_ = nullptr;
+  APerformanceHintManager* hintManager_ = nullptr;
+  APerformanceHintSession* hintSession_ = nullptr;
+  bool isHintSessionCreated_ = false;
+
+  Clock::time_point frameStart_;
+  Clock::time_point lastFrameStart_;
+};
+
+} // namespace igl::samples
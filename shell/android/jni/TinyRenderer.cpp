@@ -102,6 +102,7 @@ void TinyRenderer::init(AAssetManager* mgr,
 void TinyRenderer::render(float displayScale) {
   // process user input
   IGL_ASSERT(platform_ != nullptr);
+  framePacer_.beginFrame();
   platform_->getInputDispatcher().processEvents();
 
   // draw
@@ -136,6 +137,7 @@ void TinyRenderer::render(float displayScale) {
   IGL_REPORT_ERROR(result.isOk());
   session_->updateDisplayScale(displayScale);
   session_->update(std::move(surfaceTextures));
+  framePacer_.endFrame();
 }
 
 void TinyRenderer::onSurfacesChanged(ANativeWindow* surface, int width, int height) {
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "FramePacer.h"
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
 #include <android/native_window.h>
@@ -32,6 +33,7 @@ class TinyRenderer final {
   BackendTypeID backendTypeID_;
   std::shared_ptr<igl::shell::PlatformAndroid> platform_;
   std::unique_ptr<igl::shell::RenderSession> session_;
+  FramePacer framePacer_;
 
   uint32_t width_ = 0;
   uint32_t height_ = 0;
@@ -20,6 +20,10 @@ class XrAppImpl {
  public:
   virtual ~XrAppImpl() = default;
   virtual std::vector<const char*> getXrRequiredExtensions() const = 0;
+  // extensions needed on top of XR_FB_foveation to foveate the swapchains of this graphics API
+  virtual std::vector<const char*> getXrFoveationExtensions() const {
+    return {};
+  }
   virtual std::unique_ptr<igl::IDevice> initIGL(XrInstance instance, XrSystemId systemId) = 0;
   virtual XrSession initXrSession(XrInstance instance,
                                   XrSystemId systemId,
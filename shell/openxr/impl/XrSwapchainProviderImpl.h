@@ -21,6 +21,14 @@ class XrSwapchainProviderImpl {
   virtual ~XrSwapchainProviderImpl() = default;
   virtual int64_t preferredColorFormat() const = 0;
   virtual int64_t preferredDepthFormat() const = 0;
+  // Flags the color swapchain is created with when it is foveated, e.g. to get fragment density
+  // maps. With 0, the runtime foveates the swapchain images on its own (GLES).
+  virtual XrSwapchainCreateFoveationFlagsFB foveationFlags() const {
+    return 0;
+  }
+  void setFoveated(bool foveated) {
+    foveated_ = foveated;
+  }
   virtual void enumerateImages(igl::IDevice& device,
                                XrSwapchain colorSwapchain,
                                XrSwapchain depthSwapchain,
@@ -39,5 +47,7 @@ class XrSwapchainProviderImpl {
  protected:
   std::vector<std::shared_ptr<igl::ITexture>> colorTextures_;
   std::vector<std::shared_ptr<igl::ITexture>> depthTextures_;
+  // the color swapchain was created with XR_FB_foveation
+  bool foveated_ = false;
 };
 } // namespace igl::shell::openxr::impl
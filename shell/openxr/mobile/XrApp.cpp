@@ -28,6 +28,7 @@
 #include <shell/shared/renderSession/DefaultSession.h>
 #include <shell/shared/renderSession/ShellParams.h>
 
+#include <shell/openxr/XrFramePacer.h>
 #include <shell/openxr/XrLog.h>
 #include <shell/openxr/XrSwapchainProvider.h>
 #include <shell/openxr/impl/XrAppImpl.h>
@@ -48,6 +49,7 @@ XrApp::~XrApp() {
   if (!initialized_)
     return;
 
+  framePacer_.reset();
   swapchainProviders_.clear();
 
   xrDestroySpace(stageSpace_);
@@ -107,6 +109,28 @@ bool XrApp::checkExtensions() {
     }
   }
 
+  const auto isExtensionSupported = [this](const char* extensionName) {
+    return std::any_of(std::begin(extensions_),
+                       std::end(extensions_),
+                       [extensionName](const XrExtensionProperties& extension) {
+                         return strcmp(extension.extensionName, extensionName) == 0;
+                       });
+  };
+  auto foveationExtensionsImpl = impl_->getXrFoveationExtensions();
+  foveationExtensions_.insert(std::end(foveationExtensions_),
+                              std::begin(foveationExtensionsImpl),
+                              std::end(foveationExtensionsImpl));
+  foveationSupported_ = !foveationExtensions_.empty() &&
+                        std::all_of(std::begin(foveationExtensions_),
+                                    std::end(foveationExtensions_),
+                                    isExtensionSupported);
+  if (foveationSupported_) {
+    requiredExtensions_.insert(std::end(requiredExtensions_),
+                               std::begin(foveationExtensions_),
+                               std::end(foveationExtensions_));
+  }
+  IGL_LOG_INFO("Fixed foveation is %s", foveationSupported_ ? "supported" : "not supported");
+
   return true;
 }
 
@@ -269,7 +293,8 @@ void XrApp::createSwapchainProviders(const std::unique_ptr<igl::IDevice>& device
                                               platform_,
                                               session_,
                                               viewports_[i],
-                                              numViewsPerSwapchain));
+                                              numViewsPerSwapchain,
+                                              foveationSupported_ ? instance_ : XR_NULL_HANDLE));
     swapchainProviders_.back()->initialize();
   }
 }
@@ -449,31 +474,44 @@ void XrApp::handleSessionStateChanges(XrSessionState state) {
     XR_CHECK(result = xrBeginSession(session_, &sessionBeginInfo));
 
     sessionActive_ = (result == XR_SUCCESS);
+    if (sessionActive_) {
+      if (!framePacer_) {
+        framePacer_ = std::make_unique<XrFramePacer>(session_);
+      }
+      framePacer_->start();
+    }
     IGL_LOG_INFO("XR session active");
   } else if (state == XR_SESSION_STATE_STOPPING) {
     assert(resumed_ == false);
     assert(sessionActive_);
+    // no xrWaitFrame() may be pending after the session ended
+    framePacer_->stop();
     XR_CHECK(xrEndSession(session_));
     sessionActive_ = false;
     IGL_LOG_INFO("XR session inactive");
   }
 }
 
-XrFrameState XrApp::beginFrame() {
-  XrFrameWaitInfo waitFrameInfo = {XR_TYPE_FRAME_WAIT_INFO};
-
-  XrFrameState frameState = {XR_TYPE_FRAME_STATE};
-
-  XR_CHECK(xrWaitFrame(session_, &waitFrameInfo, &frameState));
+bool XrApp::beginFrame(XrFrameState& outFrameState) {
+  if (!framePacer_->acquireFrame(outFrameState)) {
+    return false;
+  }
 
   XrFrameBeginInfo beginFrameInfo = {XR_TYPE_FRAME_BEGIN_INFO};
 
   XR_CHECK(xrBeginFrame(session_, &beginFrameInfo));
+  framePacer_->frameBegun();
 
+  return true;
+}
+
+// Called as late as possible before the frame is recorded, so the poses are predicted over the
+// shortest possible interval.
+void XrApp::locateViews(XrTime displayTime) {
   XrSpaceLocation loc = {
       loc.type = XR_TYPE_SPACE_LOCATION,
   };
-  XR_CHECK(xrLocateSpace(headSpace_, stageSpace_, frameState.predictedDisplayTime, &loc));
+  XR_CHECK(xrLocateSpace(headSpace_, stageSpace_, displayTime, &loc));
   XrPosef headPose = loc.pose;
 
   XrViewState viewState = {XR_TYPE_VIEW_STATE};
@@ -482,7 +520,7 @@ XrFrameState XrApp::beginFrame() {
       XR_TYPE_VIEW_LOCATE_INFO,
       nullptr,
       viewConfigProps_.viewConfigurationType,
-      frameState.predictedDisplayTime,
+      displayTime,
       headSpace_,
   };
 
@@ -500,8 +538,6 @@ XrFrameState XrApp::beginFrame() {
     viewTransforms_[i] = glm::make_mat4(xrMat4.m);
     cameraPositions_[i] = glm::vec3(eyePose.position.x, eyePose.position.y, eyePose.position.z);
   }
-
-  return frameState;
 }
 
 namespace {
@@ -513,9 +549,11 @@ void copyFov(igl::shell::Fov& dst, const XrFovf& src) {
 }
 } // namespace
 
-void XrApp::render() {
+void XrApp::render(XrTime displayTime) {
   if (useSinglePassStereo_) {
+    // waiting for the swapchain images may block, so the views are located afterwards
     auto surfaceTextures = swapchainProviders_[0]->getSurfaceTextures();
+    locateViews(displayTime);
     for (size_t j = 0; j < shellParams_->viewParams.size(); j++) {
       shellParams_->viewParams[j].viewMatrix = viewTransforms_[j];
       shellParams_->viewParams[j].cameraPosition = cameraPositions_[j];
@@ -524,17 +562,21 @@ void XrApp::render() {
     renderSession_->update(std::move(surfaceTextures));
     swapchainProviders_[0]->releaseSwapchainImages();
   } else {
+    std::array<igl::SurfaceTextures, kNumViews> surfaceTextures;
+    for (size_t i = 0; i < kNumViews; i++) {
+      surfaceTextures[i] = swapchainProviders_[i]->getSurfaceTextures();
+    }
+    locateViews(displayTime);
     for (size_t i = 0; i < kNumViews; i++) {
       shellParams_->viewParams[0].viewMatrix = viewTransforms_[i];
       copyFov(shellParams_->viewParams[0].fov, views_[i].fov);
-      auto surfaceTextures = swapchainProviders_[i]->getSurfaceTextures();
-      renderSession_->update(surfaceTextures);
+      renderSession_->update(std::move(surfaceTextures[i]));
       swapchainProviders_[i]->releaseSwapchainImages();
     }
   }
 }
 
-void XrApp::endFrame(XrFrameState frameState) {
+void XrApp::endFrame(const XrFrameState& frameState) {
   std::array<XrCompositionLayerProjectionView, kNumViews> projectionViews;
   std::array<XrCompositionLayerDepthInfoKHR, kNumViews> depthInfos;
 
@@ -586,12 +628,13 @@ void XrApp::endFrame(XrFrameState frameState) {
   const XrCompositionLayerBaseHeader* const layers[] = {
       (const XrCompositionLayerBaseHeader*)&projection};
 
+  // frames the runtime does not display are ended without layers
   XrFrameEndInfo endFrameInfo = {
       XR_TYPE_FRAME_END_INFO,
       nullptr,
       frameState.predictedDisplayTime,
       XR_ENVIRONMENT_BLEND_MODE_OPAQUE,
-      1,
+      frameState.shouldRender == XR_TRUE ? 1u : 0u,
       layers,
   };
 
@@ -603,8 +646,13 @@ void XrApp::update() {
     return;
   }
 
-  auto frameState = beginFrame();
-  render();
+  XrFrameState frameState = {XR_TYPE_FRAME_STATE};
+  if (!beginFrame(frameState)) {
+    return;
+  }
+  if (frameState.shouldRender == XR_TRUE) {
+    render(frameState.predictedDisplayTime);
+  }
   endFrame(frameState);
 }
 } // namespace igl::shell::openxr
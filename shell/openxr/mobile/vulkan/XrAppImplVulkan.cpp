@@ -26,6 +26,13 @@ std::vector<const char*> XrAppImplVulkan::getXrRequiredExtensions() const {
   };
 }
 
+std::vector<const char*> XrAppImplVulkan::getXrFoveationExtensions() const {
+  // the runtime provides fragment density maps along with the swapchain images
+  return {
+      XR_FB_FOVEATION_VULKAN_EXTENSION_NAME,
+  };
+}
+
 std::unique_ptr<igl::IDevice> XrAppImplVulkan::initIGL(XrInstance instance, XrSystemId systemId) {
   // Get the API requirements.
   PFN_xrGetVulkanGraphicsRequirementsKHR pfnGetVulkanGraphicsRequirementsKHR = NULL;
@@ -25,7 +25,8 @@ void enumerateSwapchainImages(
     uint32_t numViews,
     VkImageUsageFlags usageFlags,
     VkImageAspectFlags aspectMask,
-    std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>>& outVulkanTextures) {
+    std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>>& outVulkanTextures,
+    std::vector<std::shared_ptr<igl::ITexture>>* outDensityMapTextures = nullptr) {
   uint32_t numImages = 0;
   XR_CHECK(xrEnumerateSwapchainImages(swapchain, 0, &numImages, NULL));
 
@@ -33,12 +34,22 @@ void enumerateSwapchainImages(
 
   std::vector<XrSwapchainImageVulkanKHR> images(
       numImages, {.type = XR_TYPE_SWAPCHAIN_IMAGE_VULKAN_KHR, .next = nullptr});
+  std::vector<XrSwapchainImageFoveationVulkanFB> densityMapImages;
+  if (outDensityMapTextures) {
+    densityMapImages.resize(numImages, {.type = XR_TYPE_SWAPCHAIN_IMAGE_FOVEATION_VULKAN_FB});
+    for (uint32_t i = 0; i < numImages; i++) {
+      images[i].next = &densityMapImages[i];
+    }
+  }
   XR_CHECK(xrEnumerateSwapchainImages(
       swapchain, numImages, &numImages, (XrSwapchainImageBaseHeader*)images.data()));
 
   const auto& actualDevice = static_cast<igl::vulkan::Device&>(device);
   const auto& ctx = actualDevice.getVulkanContext();
   outVulkanTextures.reserve(numImages);
+  if (outDensityMapTextures) {
+    outDensityMapTextures->reserve(numImages);
+  }
 
   for (uint32_t i = 0; i < numImages; i++) {
     auto image = std::make_shared<igl::vulkan::VulkanImage>(
@@ -65,6 +76,51 @@ void enumerateSwapchainImages(
                                fmt::format("Image View: swapchain #{}", i).c_str());
     outVulkanTextures.emplace_back(
         std::make_shared<igl::vulkan::VulkanTexture>(ctx, std::move(image), std::move(imageView)));
+
+    if (!outDensityMapTextures) {
+      continue;
+    }
+    // the runtime owns the density map and keeps it in the fragment density map layout
+    const auto& densityMapImage = densityMapImages[i];
+    auto densityMap = std::make_shared<igl::vulkan::VulkanImage>(
+        ctx,
+        ctx.device_->device_,
+        densityMapImage.image,
+        fmt::format("Image: swapchain density map #{}", i).c_str(),
+        VK_IMAGE_USAGE_FRAGMENT_DENSITY_MAP_BIT_EXT,
+        true,
+        VkExtent3D{densityMapImage.width, densityMapImage.height, 1},
+        VK_IMAGE_TYPE_2D,
+        VK_FORMAT_R8G8_UNORM,
+        1,
+        numViews);
+    densityMap->setLayout(VK_IMAGE_LAYOUT_FRAGMENT_DENSITY_MAP_OPTIMAL_EXT, 0);
+    auto densityMapView = densityMap->createImageView(
+        numViews > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D,
+        VK_FORMAT_R8G8_UNORM,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        0,
+        VK_REMAINING_MIP_LEVELS,
+        0,
+        numViews,
+        fmt::format("Image View: swapchain density map #{}", i).c_str());
+    const auto textureDesc =
+        numViews > 1 ? TextureDesc::new2DArray(TextureFormat::RG_UNorm8,
+                                               densityMapImage.width,
+                                               densityMapImage.height,
+                                               numViews,
+                                               TextureDesc::TextureUsageBits::Attachment,
+                                               "SwapChain Density Map")
+                     : TextureDesc::new2D(TextureFormat::RG_UNorm8,
+                                          densityMapImage.width,
+                                          densityMapImage.height,
+                                          TextureDesc::TextureUsageBits::Attachment,
+                                          "SwapChain Density Map");
+    outDensityMapTextures->emplace_back(std::make_shared<igl::vulkan::Texture>(
+        actualDevice,
+        std::make_shared<igl::vulkan::VulkanTexture>(
+            ctx, std::move(densityMap), std::move(densityMapView)),
+        textureDesc));
   }
 }
 
@@ -75,7 +131,8 @@ std::shared_ptr<igl::ITexture> getSurfaceTexture(
     uint32_t numViews,
     const std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>>& vulkanTextures,
     int64_t externalTextureFormat,
-    std::vector<std::shared_ptr<igl::ITexture>>& inOutTextures) {
+    std::vector<std::shared_ptr<igl::ITexture>>& inOutTextures,
+    uint32_t* outImageIndex = nullptr) {
   uint32_t imageIndex;
   XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
   XR_CHECK(xrAcquireSwapchainImage(swapchain, &acquireInfo, &imageIndex));
@@ -84,6 +141,10 @@ std::shared_ptr<igl::ITexture> getSurfaceTexture(
   waitInfo.timeout = XR_INFINITE_DURATION;
   XR_CHECK(xrWaitSwapchainImage(swapchain, &waitInfo));
 
+  if (outImageIndex) {
+    *outImageIndex = imageIndex;
+  }
+
   auto vulkanTexture = vulkanTextures[imageIndex];
 
   if (imageIndex >= inOutTextures.size()) {
@@ -136,7 +197,8 @@ void XrSwapchainProviderImplVulkan::enumerateImages(igl::IDevice& device,
                            numViews,
                            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
                            VK_IMAGE_ASPECT_COLOR_BIT,
-                           vulkanColorTextures_);
+                           vulkanColorTextures_,
+                           foveated_ ? &densityMapTextures_ : nullptr);
   auto vkDepthFormat = static_cast<VkFormat>(selectedDepthFormat);
   VkImageAspectFlags depthAspectFlags = 0;
   if (vulkan::VulkanImage::isDepthFormat(vkDepthFormat)) {
@@ -163,13 +225,15 @@ igl::SurfaceTextures XrSwapchainProviderImplVulkan::getSurfaceTextures(
     int64_t selectedDepthFormat,
     const XrViewConfigurationView& viewport,
     uint32_t numViews) {
+  uint32_t colorImageIndex = 0;
   auto colorTexture = getSurfaceTexture(device,
                                         colorSwapchain,
                                         viewport,
                                         numViews,
                                         vulkanColorTextures_,
                                         selectedColorFormat,
-                                        colorTextures_);
+                                        colorTextures_,
+                                        &colorImageIndex);
   auto depthTexture = getSurfaceTexture(device,
                                         depthSwapchain,
                                         viewport,
@@ -178,6 +242,9 @@ igl::SurfaceTextures XrSwapchainProviderImplVulkan::getSurfaceTextures(
                                         selectedDepthFormat,
                                         depthTextures_);
 
-  return {colorTexture, depthTexture};
+  auto densityMapTexture =
+      colorImageIndex < densityMapTextures_.size() ? densityMapTextures_[colorImageIndex] : nullptr;
+
+  return {colorTexture, depthTexture, densityMapTexture};
 }
 } // namespace igl::shell::openxr::mobile
@@ -29,6 +29,9 @@ class XrSwapchainProviderImplVulkan final : public impl::XrSwapchainProviderImpl
   int64_t preferredDepthFormat() const final {
     return VK_FORMAT_D24_UNORM_S8_UINT;
   }
+  XrSwapchainCreateFoveationFlagsFB foveationFlags() const final {
+    return XR_SWAPCHAIN_CREATE_FOVEATION_FRAGMENT_DENSITY_MAP_BIT_FB;
+  }
   void enumerateImages(igl::IDevice& device,
                        XrSwapchain colorSwapchain,
                        XrSwapchain depthSwapchain,
@@ -47,5 +50,7 @@ class XrSwapchainProviderImplVulkan final : public impl::XrSwapchainProviderImpl
  private:
   std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>> vulkanColorTextures_;
   std::vector<std::shared_ptr<igl::vulkan::VulkanTexture>> vulkanDepthTextures_;
+  // one fragment density map per color swapchain image, if the swapchain is foveated
+  std::vector<std::shared_ptr<igl::ITexture>> densityMapTextures_;
 };
 } // namespace igl::shell::openxr::mobile
@@ -24,6 +24,7 @@ class AAssetManager;
 
 // forward declarations
 namespace igl::shell::openxr {
+class XrFramePacer;
 class XrSwapchainProvider;
 namespace impl {
 class XrAppImpl;
@@ -78,9 +79,10 @@ class XrApp {
   void createShellSession(std::unique_ptr<igl::IDevice> device, AAssetManager* assetMgr);
 
   void createSpaces();
-  XrFrameState beginFrame();
-  void render();
-  void endFrame(XrFrameState frameState);
+  bool beginFrame(XrFrameState& outFrameState);
+  void locateViews(XrTime displayTime);
+  void render(XrTime displayTime);
+  void endFrame(const XrFrameState& frameState);
 
  private:
   void* nativeWindow_ = nullptr;
@@ -93,6 +95,14 @@ class XrApp {
       XR_FB_SWAPCHAIN_UPDATE_STATE_EXTENSION_NAME,
 #endif
   };
+  // enabled, together with the ones of the impl, if the runtime supports all of them
+  std::vector<const char*> foveationExtensions_ = {
+#ifndef XR_USE_PLATFORM_MACOS
+      XR_FB_FOVEATION_EXTENSION_NAME,
+      XR_FB_FOVEATION_CONFIGURATION_EXTENSION_NAME,
+#endif
+  };
+  bool foveationSupported_ = false;
 
   XrInstanceProperties instanceProps_ = {
       .type = XR_TYPE_INSTANCE_PROPERTIES,
@@ -121,6 +131,9 @@ class XrApp {
   // If useSinglePassStereo_ is true, only one XrSwapchainProvider will be created.
   std::vector<std::unique_ptr<XrSwapchainProvider>> swapchainProviders_;
 
+  // waits for the next frame while the current one is rendered
+  std::unique_ptr<XrFramePacer> framePacer_;
+
   XrSpace headSpace_ = XR_NULL_HANDLE;
   XrSpace localSpace_ = XR_NULL_HANDLE;
   XrSpace stageSpace_ = XR_NULL_HANDLE;
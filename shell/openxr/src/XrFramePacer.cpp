@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "XrFramePacer.h"
+
+#include <shell/openxr/XrLog.h>
+
+namespace igl::shell::openxr {
+
+XrFramePacer::XrFramePacer(XrSession session) : session_(session) {}
+
+XrFramePacer::~XrFramePacer() {
+  stop();
+}
+
+void XrFramePacer::start() {
+  if (thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = true;
+    hasFrame_ = false;
+    canWait_ = true;
+  }
+  thread_ = std::thread([this]() { waitFrames(); });
+}
+
+void XrFramePacer::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    // returns once a pending xrWaitFrame() does, which the runtime keeps pacing until the session
+    // ends
+    thread_.join();
+  }
+}
+
+bool XrFramePacer::acquireFrame(XrFrameState& outFrameState) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this]() { return hasFrame_ || !running_; });
+  if (!hasFrame_) {
+    return false;
+  }
+  outFrameState = frameState_;
+  hasFrame_ = false;
+  return true;
+}
+
+void XrFramePacer::frameBegun() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    canWait_ = true;
+  }
+  cv_.notify_all();
+}
+
+void XrFramePacer::waitFrames() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return (canWait_ && !hasFrame_) || !running_; });
+      if (!running_) {
+        return;
+      }
+      canWait_ = false;
+    }
+
+    const XrFrameWaitInfo waitFrameInfo = {XR_TYPE_FRAME_WAIT_INFO};
+    XrFrameState frameState = {XR_TYPE_FRAME_STATE};
+    XrResult result;
+    XR_CHECK(result = xrWaitFrame(session_, &waitFrameInfo, &frameState));
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (XR_FAILED(result)) {
+        running_ = false;
+      } else {
+        frameState_ = frameState;
+        hasFrame_ = true;
+      }
+    }
+    cv_.notify_all();
+    if (XR_FAILED(result)) {
+      return;
+    }
+  }
+}
+
+} // namespace igl::shell::openxr
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <openxr/openxr.h>
+
+namespace igl::shell::openxr {
+
+// Calls xrWaitFrame() on its own thread, so the render thread is not blocked by the runtime's
+// frame pacing while it still records and submits the previous frame. The wait for frame N+1
+// starts as soon as frame N has begun, which is the earliest point allowed by OpenXR.
+class XrFramePacer {
+ public:
+  explicit XrFramePacer(XrSession session);
+  ~XrFramePacer();
+
+  // to be called once the session is running and before it ends
+  void start();
+  void stop();
+
+  // Blocks until xrWaitFrame() returned for the next frame. Returns false if the pacer was
+  // stopped or xrWaitFrame() failed. Must be followed by xrBeginFrame() and frameBegun().
+  bool acquireFrame(XrFrameState& outFrameState);
+  // lets the pacer wait for the next frame
+  void frameBegun();
+
+ private:
+  void waitFrames();
+
+ private:
+  const XrSession session_;
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool running_ = false;
+  bool hasFrame_ = false;
+  // xrWaitFrame() may not be called again before the frame it returned has begun
+  bool canWait_ = true;
+  XrFrameState frameState_ = {XR_TYPE_FRAME_STATE};
+};
+
+} // namespace igl::shell::openxr
@@ -16,12 +16,14 @@ XrSwapchainProvider::XrSwapchainProvider(std::unique_ptr<impl::XrSwapchainProvid
                                          const std::shared_ptr<igl::shell::Platform>& platform,
                                          const XrSession& session,
                                          const XrViewConfigurationView& viewport,
-                                         uint32_t numViews) :
+                                         uint32_t numViews,
+                                         XrInstance foveationInstance) :
   impl_(std::move(impl)),
   platform_(platform),
   session_(session),
   viewport_(viewport),
-  numViews_(numViews) {}
+  numViews_(numViews),
+  foveationInstance_(foveationInstance) {}
 XrSwapchainProvider::~XrSwapchainProvider() {
   xrDestroySwapchain(colorSwapchain_);
 // @fb-only
@@ -47,8 +49,14 @@ bool XrSwapchainProvider::initialize() {
   selectedColorFormat_ = impl_->preferredColorFormat();
 #endif
 
-  colorSwapchain_ =
-      createXrSwapchain(XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT, selectedColorFormat_);
+  XrSwapchainCreateInfoFoveationFB foveationCreateInfo = {
+      XR_TYPE_SWAPCHAIN_CREATE_INFO_FOVEATION_FB};
+  foveationCreateInfo.flags = impl_->foveationFlags();
+  const bool foveated = foveationInstance_ != XR_NULL_HANDLE;
+  colorSwapchain_ = createXrSwapchain(XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT,
+                                      selectedColorFormat_,
+                                      foveated ? &foveationCreateInfo : nullptr);
+  impl_->setFoveated(foveated);
 
 // @fb-only
   auto depthFormat = impl_->preferredDepthFormat();
@@ -73,12 +81,56 @@ bool XrSwapchainProvider::initialize() {
                          viewport_,
                          numViews_);
 
+  if (foveated) {
+    applyFoveation();
+  }
+
   return true;
 }
 
+void XrSwapchainProvider::applyFoveation() {
+  PFN_xrCreateFoveationProfileFB xrCreateFoveationProfileFB = nullptr;
+  PFN_xrDestroyFoveationProfileFB xrDestroyFoveationProfileFB = nullptr;
+  PFN_xrUpdateSwapchainFB xrUpdateSwapchainFB = nullptr;
+  XR_CHECK(xrGetInstanceProcAddr(foveationInstance_,
+                                 "xrCreateFoveationProfileFB",
+                                 (PFN_xrVoidFunction*)&xrCreateFoveationProfileFB));
+  XR_CHECK(xrGetInstanceProcAddr(foveationInstance_,
+                                 "xrDestroyFoveationProfileFB",
+                                 (PFN_xrVoidFunction*)&xrDestroyFoveationProfileFB));
+  XR_CHECK(xrGetInstanceProcAddr(
+      foveationInstance_, "xrUpdateSwapchainFB", (PFN_xrVoidFunction*)&xrUpdateSwapchainFB));
+  if (!xrCreateFoveationProfileFB || !xrDestroyFoveationProfileFB || !xrUpdateSwapchainFB) {
+    IGL_LOG_ERROR("XR_FB_foveation functions are not available");
+    return;
+  }
+
+  // fixed foveation: the periphery of the swapchain images is shaded at a lower rate
+  XrFoveationLevelProfileCreateInfoFB levelProfileCreateInfo = {
+      XR_TYPE_FOVEATION_LEVEL_PROFILE_CREATE_INFO_FB};
+  levelProfileCreateInfo.level = XR_FOVEATION_LEVEL_HIGH_FB;
+  levelProfileCreateInfo.verticalOffset = 0.0f;
+  levelProfileCreateInfo.dynamic = XR_FOVEATION_DYNAMIC_DISABLED_FB;
+
+  XrFoveationProfileCreateInfoFB profileCreateInfo = {XR_TYPE_FOVEATION_PROFILE_CREATE_INFO_FB};
+  profileCreateInfo.next = &levelProfileCreateInfo;
+
+  XrFoveationProfileFB profile = XR_NULL_HANDLE;
+  XR_CHECK(xrCreateFoveationProfileFB(session_, &profileCreateInfo, &profile));
+
+  XrSwapchainStateFoveationFB foveationState = {XR_TYPE_SWAPCHAIN_STATE_FOVEATION_FB};
+  foveationState.profile = profile;
+  XR_CHECK(xrUpdateSwapchainFB(colorSwapchain_, (XrSwapchainStateBaseHeaderFB*)&foveationState));
+
+  // the swapchain keeps the state, so the profile is not needed anymore
+  XR_CHECK(xrDestroyFoveationProfileFB(profile));
+  IGL_LOG_INFO("XrSwapchain foveation enabled");
+}
+
 XrSwapchain XrSwapchainProvider::createXrSwapchain(XrSwapchainUsageFlags extraUsageFlags,
-                                                   int64_t format) {
-  XrSwapchainCreateInfo swapChainCreateInfo = {XR_TYPE_SWAPCHAIN_CREATE_INFO, nullptr};
+                                                   int64_t format,
+                                                   const void* next) {
+  XrSwapchainCreateInfo swapChainCreateInfo = {XR_TYPE_SWAPCHAIN_CREATE_INFO, next};
   swapChainCreateInfo.usageFlags = XR_SWAPCHAIN_USAGE_SAMPLED_BIT | extraUsageFlags;
   swapChainCreateInfo.format = format;
   swapChainCreateInfo.sampleCount = 1;
@@ -30,7 +30,8 @@ class XrSwapchainProvider {
                       const std::shared_ptr<igl::shell::Platform>& platform,
                       const XrSession& session,
                       const XrViewConfigurationView& viewport,
-                      uint32_t numViews);
+                      uint32_t numViews,
+                      XrInstance foveationInstance = XR_NULL_HANDLE);
   ~XrSwapchainProvider();
 
   bool initialize();
@@ -50,7 +51,10 @@ class XrSwapchainProvider {
   }
 
  private:
-  XrSwapchain createXrSwapchain(XrSwapchainUsageFlags extraUsageFlags, int64_t format);
+  XrSwapchain createXrSwapchain(XrSwapchainUsageFlags extraUsageFlags,
+                                int64_t format,
+                                const void* next = nullptr);
+  void applyFoveation();
 
  private:
   std::unique_ptr<impl::XrSwapchainProviderImpl> impl_;
@@ -65,5 +69,7 @@ class XrSwapchainProvider {
   uint32_t currentImageIndex_;
   const uint32_t numViews_ =
       1; // The number of layers of the underlying swapchain image would match numViews_.
+  // the color swapchain uses fixed foveation if the instance has XR_FB_foveation enabled
+  XrInstance foveationInstance_ = XR_NULL_HANDLE;
 };
 } // namespace igl::shell::openxr
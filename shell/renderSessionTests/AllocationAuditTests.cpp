@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <shell/renderSessions/ColorSession.h>
+#include <shell/renderSessions/DrawCallStressSession.h>
+#include <shell/renderSessions/EmptySession.h>
+#include <shell/renderSessions/MRTSession.h>
+#include <shell/renderSessions/TQMultiRenderPassSession.h>
+#include <shell/renderSessions/TQSession.h>
+#include <shell/renderSessions/Textured3DCubeSession.h>
+#include <shell/shared/testShell/TestShell.h>
+
+#include <string>
+
+// Steady-state frames of these sessions must not allocate inside IGL. Only built into a useful
+// test with IGL_ALLOCATION_AUDIT; a failure lists the profiler zones which allocated.
+class AllocationAuditTests : public igl::shell::TestShell {
+ protected:
+  static constexpr size_t kNumWarmupFrames = 8;
+  static constexpr size_t kNumFrames = 32;
+
+  void expectNoAllocations(igl::shell::RenderSession& session) {
+    std::vector<igl::AllocationAuditSite> sites;
+    const uint64_t numAllocations =
+        countSteadyStateAllocations(session, kNumWarmupFrames, kNumFrames, &sites);
+    std::string report;
+    for (const auto& site : sites) {
+      report += std::string("\n  ") + site.name + ": " + std::to_string(site.count);
+    }
+    EXPECT_EQ(numAllocations, 0u) << "heap allocations in " << kNumFrames << " frames:" << report;
+  }
+
+  void SetUp() override {
+    if (!igl::allocation_audit::isAvailable()) {
+      GTEST_SKIP() << "IGL is built without IGL_ALLOCATION_AUDIT";
+    }
+    igl::shell::TestShellBase::SetUp();
+  }
+};
+
+TEST_F(AllocationAuditTests, ColorSession) {
+  igl::shell::ColorSession test(platform_);
+  expectNoAllocations(test);
+}
+
+TEST_F(AllocationAuditTests, DrawCallStressSession) {
+  igl::shell::DrawCallStressSession::Config config;
+  config.numDraws = 64;
+  igl::shell::DrawCallStressSession test(platform_, config);
+  expectNoAllocations(test);
+}
+
+TEST_F(AllocationAuditTests, EmptySession) {
+  igl::shell::EmptySession test(platform_);
+  expectNoAllocations(test);
+}
+
+TEST_F(AllocationAuditTests, MRTSession) {
+  igl::shell::MRTSession test(platform_);
+  expectNoAllocations(test);
+}
+
+TEST_F(AllocationAuditTests, TQMultiRenderPassSession) {
+  igl::shell::TQMultiRenderPassSession test(platform_);
+  expectNoAllocations(test);
+}
+
+TEST_F(AllocationAuditTests, TQSession) {
+  igl::shell::TQSession test(platform_);
+  expectNoAllocations(test);
+}
+
+TEST_F(AllocationAuditTests, Textured3DCubeSession) {
+  igl::shell::Textured3DCubeSession test(platform_);
+  expectNoAllocations(test);
+}
@@ -7,6 +7,7 @@
 
 #include <shell/renderSessions/ColorSession.h>
 #include <shell/renderSessions/ComputeSession.h>
+#include <shell/renderSessions/DrawCallStressSession.h>
 #include <shell/renderSessions/EmptySession.h>
 #include <shell/renderSessions/GraphSampleSession.h>
 #include <shell/renderSessions/MRTSession.h>
@@ -30,6 +31,13 @@ TEST_F(IGLSampleTests, ColorSession) {
   run(test, 1);
 }
 
+TEST_F(IGLSampleTests, DrawCallStressSession) {
+  igl::shell::DrawCallStressSession::Config config;
+  config.numDraws = 64;
+  igl::shell::DrawCallStressSession test(platform_, config);
+  run(test, 1);
+}
+
 TEST_F(IGLSampleTests, EmptySession) {
   igl::shell::EmptySession test(platform_);
   run(test, 1);
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <shell/renderSessions/ColorSession.h>
+#include <shell/renderSessions/DrawCallStressSession.h>
+#include <shell/renderSessions/EmptySession.h>
+#include <shell/renderSessions/MRTSession.h>
+#include <shell/renderSessions/TQMultiRenderPassSession.h>
+#include <shell/renderSessions/TQSession.h>
+#include <shell/renderSessions/Textured3DCubeSession.h>
+#include <shell/shared/testShell/TestShell.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Headless performance runs of the sessions. The results of all the sessions are written as JSON
+// to the file named by IGL_SESSION_BENCHMARKS_OUTPUT, or to stdout, once the suite has finished.
+class SessionBenchmarks : public igl::shell::TestShell {
+ protected:
+  void measure(igl::shell::RenderSession& session, const char* name) {
+    const auto result = benchmark(session, name, igl::shell::SessionBenchmarkConfig{});
+    EXPECT_EQ(result.numFrames, igl::shell::SessionBenchmarkConfig{}.numFrames);
+    results().push_back(result);
+  }
+
+  static std::vector<igl::shell::SessionBenchmarkResult>& results() {
+    static std::vector<igl::shell::SessionBenchmarkResult> results;
+    return results;
+  }
+
+  static void TearDownTestSuite() {
+    const std::string json = igl::shell::sessionBenchmarksToJson(results());
+    const char* path = getenv("IGL_SESSION_BENCHMARKS_OUTPUT");
+    FILE* file = path ? fopen(path, "w") : stdout;
+    if (file) {
+      fputs(json.c_str(), file);
+      if (file != stdout) {
+        fclose(file);
+      }
+    }
+    results().clear();
+  }
+};
+
+TEST_F(SessionBenchmarks, ColorSession) {
+  igl::shell::ColorSession session(platform_);
+  measure(session, "ColorSession");
+}
+
+TEST_F(SessionBenchmarks, DrawCallStressSession) {
+  igl::shell::DrawCallStressSession session(platform_);
+  measure(session, "DrawCallStressSession");
+}
+
+TEST_F(SessionBenchmarks, EmptySession) {
+  igl::shell::EmptySession session(platform_);
+  measure(session, "EmptySession");
+}
+
+TEST_F(SessionBenchmarks, MRTSession) {
+  igl::shell::MRTSession session(platform_);
+  measure(session, "MRTSession");
+}
+
+TEST_F(SessionBenchmarks, TQMultiRenderPassSession) {
+  igl::shell::TQMultiRenderPassSession session(platform_);
+  measure(session, "TQMultiRenderPassSession");
+}
+
+TEST_F(SessionBenchmarks, TQSession) {
+  igl::shell::TQSession session(platform_);
+  measure(session, "TQSession");
+}
+
+TEST_F(SessionBenchmarks, Textured3DCubeSession) {
+  igl::shell::Textured3DCubeSession session(platform_);
+  measure(session, "Textured3DCubeSession");
+}
@@ -0,0 +1,458 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <igl/NameHandle.h>
+#include <igl/ShaderCreator.h>
+#include <shell/renderSessions/DrawCallStressSession.h>
+#include <shell/shared/renderSession/RenderSession.h>
+
+namespace igl {
+namespace shell {
+
+namespace {
+
+constexpr size_t kVertexBufferIndex = 1;
+constexpr size_t kPerDrawBufferIndex = 0;
+constexpr size_t kTextureUnit = 0;
+constexpr uint32_t kTextureSize = 4;
+
+const float kVertexData[] = {-1.f, 1.f, 1.f, 1.f, -1.f, -1.f, 1.f, -1.f};
+const uint16_t kIndexData[] = {0, 1, 2, 1, 3, 2};
+
+const char* getUniformModeName(DrawCallStressSession::UniformMode mode) {
+  switch (mode) {
+  case DrawCallStressSession::UniformMode::PushConstants:
+    return "push constants";
+  case DrawCallStressSession::UniformMode::BindBytes:
+    return "bindBytes";
+  case DrawCallStressSession::UniformMode::UniformBufferRing:
+    return "uniform buffer ring";
+  }
+  IGL_UNREACHABLE_RETURN("");
+}
+
+std::string getMetalShaderSource() {
+  return R"(
+              using namespace metal;
+
+              typedef struct {
+                float2 offset;
+                float2 scale;
+              } PerDraw;
+
+              typedef struct {
+                float2 position [[attribute(0)]];
+              } VertexIn;
+
+              typedef struct {
+                float4 position [[position]];
+                float2 uv;
+              } VertexOut;
+
+              vertex VertexOut vertexShader(VertexIn in [[stage_in]],
+                                            constant PerDraw& perDraw [[buffer(0)]]) {
+                VertexOut out;
+                out.position = float4(in.position * perDraw.scale + perDraw.offset, 0.0, 1.0);
+                out.uv = in.position * 0.5 + 0.5;
+                return out;
+              }
+
+              fragment float4 fragmentShader(VertexOut IN [[stage_in]],
+                                             texture2d<float> diffuseTex [[texture(0)]],
+                                             sampler linearSampler [[sampler(0)]]) {
+                return diffuseTex.sample(linearSampler, IN.uv);
+              }
+    )";
+}
+
+std::string getOpenGLVertexShaderSource() {
+  return R"(#version 100
+                precision highp float;
+                attribute vec2 position;
+                uniform vec4 transform;
+
+                varying vec2 uv;
+
+                void main() {
+                  gl_Position = vec4(position * transform.zw + transform.xy, 0.0, 1.0);
+                  uv = position * 0.5 + 0.5;
+                })";
+}
+
+std::string getOpenGLFragmentShaderSource() {
+  return R"(#version 100
+                precision highp float;
+                uniform sampler2D inputImage;
+
+                varying vec2 uv;
+
+                void main() {
+                  gl_FragColor = texture2D(inputImage, uv);
+                })";
+}
+
+std::string getVulkanVertexShaderSource(bool usePushConstants) {
+  return std::string(usePushConstants ? "layout(push_constant) uniform PerDraw {"
+                                      : "layout(set = 1, binding = 0, std140) uniform PerDraw {") +
+         R"(
+                  vec2 offset;
+                  vec2 scale;
+                } perDraw;
+
+                layout(location = 0) in vec2 position;
+                layout(location = 0) out vec2 uv;
+
+                void main() {
+                  gl_Position = vec4(position * perDraw.scale + perDraw.offset, 0.0, 1.0);
+                  uv = position * 0.5 + 0.5;
+                }
+                )";
+}
+
+std::string getVulkanFragmentShaderSource() {
+  return R"(
+                layout(location = 0) in vec2 uv;
+                layout(location = 0) out vec4 out_FragColor;
+
+                layout(set = 0, binding = 0) uniform sampler2D in_texture;
+
+                void main() {
+                  out_FragColor = texture(in_texture, uv);
+                }
+                )";
+}
+
+std::unique_ptr<IShaderStages> getShaderStagesForBackend(igl::IDevice& device,
+                                                         bool usePushConstants) {
+  switch (device.getBackendType()) {
+  case igl::BackendType::Vulkan:
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device,
+        getVulkanVertexShaderSource(usePushConstants).c_str(),
+        "main",
+        "",
+        getVulkanFragmentShaderSource().c_str(),
+        "main",
+        "",
+        nullptr);
+  case igl::BackendType::Metal:
+    return igl::ShaderStagesCreator::fromLibraryStringInput(
+        device, getMetalShaderSource().c_str(), "vertexShader", "fragmentShader", "", nullptr);
+  case igl::BackendType::OpenGL:
+    return igl::ShaderStagesCreator::fromModuleStringInput(device,
+                                                           getOpenGLVertexShaderSource().c_str(),
+                                                           "main",
+                                                           "",
+                                                           getOpenGLFragmentShaderSource().c_str(),
+                                                           "main",
+                                                           "",
+                                                           nullptr);
+  }
+  IGL_UNREACHABLE_RETURN(nullptr);
+}
+
+} // namespace
+
+DrawCallStressSession::DrawCallStressSession(std::shared_ptr<Platform> platform) :
+  DrawCallStressSession(std::move(platform), Config{}) {}
+
+DrawCallStressSession::DrawCallStressSession(std::shared_ptr<Platform> platform, Config config) :
+  RenderSession(std::move(platform)), config_(config) {
+  config_.numDraws = std::max(config_.numDraws, 1u);
+  config_.numPipelines = std::max(config_.numPipelines, 1u);
+  config_.numTextures = std::max(config_.numTextures, 1u);
+}
+
+void DrawCallStressSession::initialize() noexcept {
+  auto& device = getPlatform().getDevice();
+
+  if (device.getBackendType() != igl::BackendType::OpenGL) {
+    const bool supported =
+        (config_.uniformMode == UniformMode::PushConstants &&
+         device.hasFeature(DeviceFeatures::PushConstants)) ||
+        (config_.uniformMode == UniformMode::BindBytes &&
+         device.hasFeature(DeviceFeatures::BindBytes)) ||
+        config_.uniformMode == UniformMode::UniformBufferRing;
+    if (!supported) {
+      IGL_LOG_INFO("DrawCallStressSession: %s not supported, using a uniform buffer ring\n",
+                   getUniformModeName(config_.uniformMode));
+      config_.uniformMode = UniformMode::UniformBufferRing;
+    }
+  }
+
+  vb_ = device.createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Vertex, kVertexData, sizeof(kVertexData)), nullptr);
+  IGL_ASSERT(vb_ != nullptr);
+  ib_ = device.createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Index, kIndexData, sizeof(kIndexData)), nullptr);
+  IGL_ASSERT(ib_ != nullptr);
+
+  VertexInputStateDesc inputDesc;
+  inputDesc.numAttributes = 1;
+  inputDesc.attributes[0] =
+      VertexAttribute(kVertexBufferIndex, VertexAttributeFormat::Float2, 0, "position", 0);
+  inputDesc.numInputBindings = 1;
+  inputDesc.inputBindings[kVertexBufferIndex].stride = sizeof(float) * 2;
+  vertexInput_ = device.createVertexInputState(inputDesc, nullptr);
+  IGL_ASSERT(vertexInput_ != nullptr);
+
+  SamplerStateDesc samplerDesc;
+  samplerDesc.minFilter = samplerDesc.magFilter = SamplerMinMagFilter::Nearest;
+  sampler_ = device.createSamplerState(samplerDesc, nullptr);
+  IGL_ASSERT(sampler_ != nullptr);
+
+  // small solid color textures, so binding them costs the same as binding real ones
+  std::vector<uint32_t> pixels(kTextureSize * kTextureSize);
+  for (uint32_t i = 0; i != config_.numTextures; i++) {
+    auto texture = device.createTexture(TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                           kTextureSize,
+                                                           kTextureSize,
+                                                           TextureDesc::TextureUsageBits::Sampled),
+                                        nullptr);
+    IGL_ASSERT(texture != nullptr);
+    const uint32_t color = 0xff000000u | ((i * 97u) & 0xff) << 16 | ((i * 57u + 128u) & 0xff) << 8 |
+                           ((i * 31u + 64u) & 0xff);
+    std::fill(pixels.begin(), pixels.end(), color);
+    texture->upload(TextureRangeDesc::new2D(0, 0, kTextureSize, kTextureSize), pixels.data());
+    textures_.push_back(std::move(texture));
+  }
+
+  shaderStages_ =
+      getShaderStagesForBackend(device, config_.uniformMode == UniformMode::PushConstants);
+  IGL_ASSERT(shaderStages_ != nullptr);
+
+  // a square grid covering the screen, one quad per draw
+  const auto gridSize = static_cast<uint32_t>(std::ceil(std::sqrt(float(config_.numDraws))));
+  const float cellSize = 2.0f / float(gridSize);
+  baseTransforms_.resize(config_.numDraws);
+  for (uint32_t i = 0; i != config_.numDraws; i++) {
+    const float x = -1.0f + cellSize * (float(i % gridSize) + 0.5f);
+    const float y = -1.0f + cellSize * (float(i / gridSize) + 0.5f);
+    baseTransforms_[i] = {{x, y}, {cellSize * 0.4f, cellSize * 0.4f}};
+  }
+  transforms_ = baseTransforms_;
+
+  if (config_.uniformMode == UniformMode::UniformBufferRing &&
+      device.getBackendType() != igl::BackendType::OpenGL) {
+    size_t alignment = 0;
+    if (device.getFeatureLimits(DeviceFeatureLimits::BufferAlignment, alignment) &&
+        alignment > 0) {
+      transformStride_ = (sizeof(Transform) + alignment - 1) / alignment * alignment;
+    }
+    transformBufferData_.resize(transformStride_ * config_.numDraws);
+    BufferDesc desc(BufferDesc::BufferTypeBits::Uniform,
+                    nullptr,
+                    transformBufferData_.size(),
+                    ResourceStorage::Shared);
+    if (device.hasFeature(DeviceFeatures::BufferRing)) {
+      // every frame uploads the transforms of all the draws at once
+      desc.hint |= BufferDesc::BufferAPIHintBits::Ring;
+    }
+    desc.debugName = "DrawCallStressSession transforms";
+    transformBuffer_ = device.createBuffer(desc, nullptr);
+    IGL_ASSERT(transformBuffer_ != nullptr);
+  }
+
+  if (device.hasFeature(DeviceFeatures::TimestampQueries)) {
+    TimestampQueryPoolDesc poolDesc;
+    poolDesc.count = 2 * kNumTimestampFrames;
+    poolDesc.debugName = "DrawCallStressSession";
+    timestamps_ = device.createTimestampQueryPool(poolDesc, nullptr);
+  }
+
+  const CommandQueueDesc desc{igl::CommandQueueType::Graphics};
+  commandQueue_ = device.createCommandQueue(desc, nullptr);
+  IGL_ASSERT(commandQueue_ != nullptr);
+
+  renderPass_.colorAttachments.resize(1);
+  renderPass_.colorAttachments[0].loadAction = LoadAction::Clear;
+  renderPass_.colorAttachments[0].storeAction = StoreAction::Store;
+  renderPass_.colorAttachments[0].clearColor = device.backendDebugColor();
+
+  IGL_LOG_INFO("DrawCallStressSession: %u draws, %u pipelines, %u textures, %s\n",
+               config_.numDraws,
+               config_.numPipelines,
+               config_.numTextures,
+               device.getBackendType() == igl::BackendType::OpenGL
+                   ? "bindUniform"
+                   : getUniformModeName(config_.uniformMode));
+
+  startTime_ = lastFrameTime_ = lastLogTime_ = std::chrono::steady_clock::now();
+}
+
+void DrawCallStressSession::createPipelines() {
+  auto& device = getPlatform().getDevice();
+  const bool isOpenGL = device.getBackendType() == igl::BackendType::OpenGL;
+
+  // identical pipelines apart from their blending, so binding each one is a real state change
+  for (uint32_t i = 0; i != config_.numPipelines; i++) {
+    RenderPipelineDesc desc;
+    desc.vertexInputState = vertexInput_;
+    desc.shaderStages = shaderStages_;
+    desc.targetDesc.colorAttachments.resize(1);
+    desc.targetDesc.colorAttachments[0].textureFormat =
+        framebuffer_->getColorAttachment(0)->getProperties().format;
+    desc.fragmentUnitSamplerMap[kTextureUnit] = IGL_NAMEHANDLE("inputImage");
+    desc.cullMode = igl::CullMode::Disabled;
+    desc.debugName = igl::genNameHandle("DrawCallStressSession pipeline " + std::to_string(i));
+    auto& colorAttachment = desc.targetDesc.colorAttachments[0];
+    colorAttachment.blendEnabled = (i % 2) != 0;
+    colorAttachment.srcRGBBlendFactor = (i % 4) < 2 ? BlendFactor::SrcAlpha : BlendFactor::One;
+    colorAttachment.dstRGBBlendFactor = BlendFactor::OneMinusSrcAlpha;
+
+    auto pipelineState = device.createRenderPipeline(desc, nullptr);
+    IGL_ASSERT(pipelineState != nullptr);
+    if (isOpenGL) {
+      transformLocations_.push_back(
+          pipelineState->getIndexByName("transform", igl::ShaderStage::Vertex));
+    }
+    pipelineStates_.push_back(std::move(pipelineState));
+  }
+}
+
+void DrawCallStressSession::updateTransforms(float time) {
+  // a small wobble, so the per-draw uniforms change every frame
+  for (uint32_t i = 0; i != config_.numDraws; i++) {
+    const float s = 1.0f + 0.2f * std::sin(time * 2.0f + float(i) * 0.1f);
+    transforms_[i].scale[0] = baseTransforms_[i].scale[0] * s;
+    transforms_[i].scale[1] = baseTransforms_[i].scale[1] * s;
+  }
+  if (transformBuffer_) {
+    for (uint32_t i = 0; i != config_.numDraws; i++) {
+      memcpy(&transformBufferData_[i * transformStride_], &transforms_[i], sizeof(Transform));
+    }
+    transformBuffer_->upload(transformBufferData_.data(), {transformBufferData_.size(), 0});
+  }
+}
+
+void DrawCallStressSession::encodeDraws(IRenderCommandEncoder& commands) {
+  const bool isOpenGL = getPlatform().getDevice().getBackendType() == igl::BackendType::OpenGL;
+
+  UniformDesc transformDesc;
+  transformDesc.type = UniformType::Float4;
+
+  commands.bindBuffer(kVertexBufferIndex, BindTarget::kVertex, vb_, 0);
+  commands.bindSamplerState(kTextureUnit, BindTarget::kFragment, sampler_.get());
+
+  for (uint32_t i = 0; i != config_.numDraws; i++) {
+    const uint32_t pipelineIndex = i % config_.numPipelines;
+    // a new pipeline on every draw and a new texture as well unless both counts share a factor
+    commands.bindRenderPipelineState(pipelineStates_[pipelineIndex]);
+    commands.bindTexture(
+        kTextureUnit, BindTarget::kFragment, textures_[i % config_.numTextures].get());
+
+    if (isOpenGL) {
+      transformDesc.location = transformLocations_[pipelineIndex];
+      commands.bindUniform(transformDesc, &transforms_[i]);
+    } else if (config_.uniformMode == UniformMode::PushConstants) {
+      commands.bindPushConstants(&transforms_[i], sizeof(Transform));
+    } else if (config_.uniformMode == UniformMode::BindBytes) {
+      commands.bindBytes(
+          kPerDrawBufferIndex, BindTarget::kVertex, &transforms_[i], sizeof(Transform));
+    } else {
+      commands.bindBuffer(
+          kPerDrawBufferIndex, BindTarget::kVertex, transformBuffer_, i * transformStride_);
+    }
+    commands.drawIndexed(PrimitiveType::Triangle, 6, IndexFormat::UInt16, *ib_, 0);
+  }
+}
+
+void DrawCallStressSession::collectGpuTime(uint32_t frameSlot) {
+  // written kNumTimestampFrames frames ago, so usually available without waiting
+  uint64_t timestamps[2] = {};
+  if (timestamps_->getResults(2 * frameSlot, 2, timestamps) && timestamps[1] >= timestamps[0]) {
+    gpuTimeNs_ += timestamps[1] - timestamps[0];
+    gpuTimedFrames_++;
+  }
+}
+
+void DrawCallStressSession::logStats() {
+  const double usPerDraw =
+      encodedFrames_ ? encodeSeconds_ * 1e6 / (double(encodedFrames_) * config_.numDraws) : 0.0;
+  if (gpuTimedFrames_) {
+    IGL_LOG_INFO("DrawCallStressSession: %.1f FPS, CPU encode %.3f us/draw, GPU %.3f ms/frame\n",
+                 fpsCounter_.getAverageFPS(),
+                 usPerDraw,
+                 double(gpuTimeNs_) * 1e-6 / gpuTimedFrames_);
+  } else {
+    IGL_LOG_INFO("DrawCallStressSession: %.1f FPS, CPU encode %.3f us/draw\n",
+                 fpsCounter_.getAverageFPS(),
+                 usPerDraw);
+  }
+  encodeSeconds_ = 0.0;
+  encodedFrames_ = 0;
+  gpuTimeNs_ = 0;
+  gpuTimedFrames_ = 0;
+}
+
+void DrawCallStressSession::update(igl::SurfaceTextures surfaceTextures) noexcept {
+  using Clock = std::chrono::steady_clock;
+
+  const Clock::time_point now = Clock::now();
+  fpsCounter_.updateFPS(std::chrono::duration<double>(now - lastFrameTime_).count());
+  lastFrameTime_ = now;
+
+  igl::Result ret;
+  if (framebuffer_ == nullptr) {
+    igl::FramebufferDesc framebufferDesc;
+    framebufferDesc.colorAttachments[0].texture = surfaceTextures.color;
+    framebuffer_ = getPlatform().getDevice().createFramebuffer(framebufferDesc, &ret);
+    IGL_ASSERT(ret.isOk());
+    IGL_ASSERT(framebuffer_ != nullptr);
+  } else {
+    framebuffer_->updateDrawable(surfaceTextures.color);
+  }
+
+  if (pipelineStates_.empty()) {
+    createPipelines();
+  }
+
+  const auto frameSlot = static_cast<uint32_t>(frameIndex_ % kNumTimestampFrames);
+  if (timestamps_ && frameIndex_ >= kNumTimestampFrames) {
+    collectGpuTime(frameSlot);
+  }
+
+  updateTransforms(std::chrono::duration<float>(now - startTime_).count());
+
+  auto buffer = commandQueue_->createCommandBuffer(CommandBufferDesc{}, nullptr);
+  IGL_ASSERT(buffer != nullptr);
+
+  if (timestamps_) {
+    buffer->writeTimestamp(*timestamps_, 2 * frameSlot);
+  }
+
+  const Clock::time_point encodeStart = Clock::now();
+  auto commands = buffer->createRenderCommandEncoder(renderPass_, framebuffer_);
+  IGL_ASSERT(commands != nullptr);
+  if (commands) {
+    encodeDraws(*commands);
+    commands->endEncoding();
+  }
+  encodeSeconds_ += std::chrono::duration<double>(Clock::now() - encodeStart).count();
+  encodedFrames_++;
+
+  if (timestamps_) {
+    buffer->writeTimestamp(*timestamps_, 2 * frameSlot + 1);
+  }
+
+  buffer->present(surfaceTextures.color);
+  commandQueue_->submit(*buffer);
+  frameIndex_++;
+
+  if (now - lastLogTime_ >= std::chrono::seconds(1)) {
+    lastLogTime_ = now;
+    logStats();
+  }
+
+  RenderSession::update(surfaceTextures);
+}
+
+} // namespace shell
+} // namespace igl
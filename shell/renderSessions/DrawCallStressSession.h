@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <igl/FPSCounter.h>
+#include <igl/IGL.h>
+#include <shell/shared/platform/Platform.h>
+#include <shell/shared/renderSession/RenderSession.h>
+#include <vector>
+
+namespace igl {
+namespace shell {
+
+/**
+ * @brief Draws a grid of small textured quads, one draw call each, to measure the per-draw
+ * overhead of a backend.
+ *
+ * Consecutive draws cycle through `numPipelines` pipeline states and `numTextures` textures, and
+ * every draw gets its own transform through `uniformMode`. Once per second the session logs the
+ * frame rate, the CPU time spent encoding the render pass per draw and, if the device supports
+ * timestamp queries, the GPU time of the render pass.
+ */
+class DrawCallStressSession : public RenderSession {
+ public:
+  enum class UniformMode {
+    PushConstants, // bindPushConstants() per draw (Vulkan)
+    BindBytes, // bindBytes() per draw (Metal)
+    UniformBufferRing, // one buffer with all transforms, uploaded once, bound at an offset per draw
+  };
+
+  struct Config {
+    uint32_t numDraws = 4096;
+    uint32_t numPipelines = 4;
+    uint32_t numTextures = 16;
+    // falls back to UniformBufferRing if the device lacks the feature; OpenGL always binds
+    // uniforms with bindUniform()
+    UniformMode uniformMode = UniformMode::UniformBufferRing;
+  };
+
+  explicit DrawCallStressSession(std::shared_ptr<Platform> platform);
+  DrawCallStressSession(std::shared_ptr<Platform> platform, Config config);
+  void initialize() noexcept override;
+  void update(igl::SurfaceTextures surfaceTextures) noexcept override;
+
+ private:
+  static constexpr uint32_t kNumTimestampFrames = 4;
+
+  // matches `PerDraw` in the shaders
+  struct Transform {
+    float offset[2];
+    float scale[2];
+  };
+
+  void createPipelines();
+  void updateTransforms(float time);
+  void encodeDraws(IRenderCommandEncoder& commands);
+  void collectGpuTime(uint32_t frameSlot);
+  void logStats();
+
+  Config config_;
+  std::vector<std::shared_ptr<IRenderPipelineState>> pipelineStates_;
+  std::vector<std::shared_ptr<ITexture>> textures_;
+  std::shared_ptr<IVertexInputState> vertexInput_;
+  std::shared_ptr<ISamplerState> sampler_;
+  std::shared_ptr<IShaderStages> shaderStages_;
+  std::shared_ptr<IBuffer> vb_;
+  std::shared_ptr<IBuffer> ib_;
+  std::shared_ptr<IBuffer> transformBuffer_; // UniformBufferRing
+  std::shared_ptr<ITimestampQueryPool> timestamps_;
+  RenderPassDesc renderPass_;
+
+  std::vector<Transform> baseTransforms_;
+  std::vector<Transform> transforms_;
+  // transforms_ laid out with `transformStride_` bytes per draw for transformBuffer_
+  std::vector<uint8_t> transformBufferData_;
+  size_t transformStride_ = sizeof(Transform);
+  std::vector<int> transformLocations_; // bindUniform() location per pipeline (OpenGL)
+
+  FPSCounter fpsCounter_{false};
+  std::chrono::steady_clock::time_point startTime_;
+  std::chrono::steady_clock::time_point lastFrameTime_;
+  std::chrono::steady_clock::time_point lastLogTime_;
+  uint64_t frameIndex_ = 0;
+  // accumulated since the last log
+  double encodeSeconds_ = 0.0;
+  uint32_t encodedFrames_ = 0;
+  uint64_t gpuTimeNs_ = 0;
+  uint32_t gpuTimedFrames_ = 0;
+};
+
+} // namespace shell
+} // namespace igl
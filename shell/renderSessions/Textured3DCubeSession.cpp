@@ -17,6 +17,8 @@
 #else
 #include <shell/renderSessions/Textured3DCubeSession.h>
 #endif
+#include <cmath>
+#include <shell/shared/renderSession/ShellParams.h>
 
 namespace igl {
 namespace shell {
@@ -40,16 +42,18 @@ static VertexPosUvw vertexData0[] = {
 static uint16_t indexData[] = {0, 1, 2, 1, 3, 2, 1, 4, 3, 4, 6, 3, 4, 5, 6, 5, 7, 6,
                                5, 0, 7, 0, 2, 7, 5, 4, 0, 4, 1, 0, 2, 3, 7, 3, 6, 7};
 
-static std::string getProlog(igl::IDevice& device) {
+static std::string getProlog(igl::IDevice& device, const char* extensions = "") {
 #if IGL_BACKEND_OPENGL
   const auto shaderVersion = device.getShaderVersion();
   if (shaderVersion.majorVersion >= 3 || shaderVersion.minorVersion >= 30) {
     std::string prependVersionString = igl::opengl::getStringFromShaderVersion(shaderVersion);
-    prependVersionString += "\nprecision highp float;\n";
+    prependVersionString += "\n";
+    prependVersionString += extensions;
+    prependVersionString += "precision highp float;\n";
     return prependVersionString;
   }
 #endif // IGL_BACKEND_OPENGL
-  return "";
+  return extensions;
 };
 
 static std::string getMetalShaderSource() {
@@ -59,7 +63,7 @@ static std::string getMetalShaderSource() {
           using namespace metal;
 
           struct VertexUniformBlock {
-            float4x4 mvpMatrix;
+            float4x4 mvpMatrix[2];
             float scaleZ;
           };
 
@@ -76,7 +80,7 @@ static std::string getMetalShaderSource() {
           vertex VertexOut vertexShader(VertexIn in [[stage_in]],
                  constant VertexUniformBlock &vUniform[[buffer(1)]]) {
             VertexOut out;
-            out.position = vUniform.mvpMatrix * float4(in.position, 1.0);
+            out.position = vUniform.mvpMatrix[0] * float4(in.position, 1.0);
             out.uvw = in.uvw;
             out.uvw = float3(
                          out.uvw.x, out.uvw.y, (out.uvw.z - 0.5f)*vUniform.scaleZ + 0.5f);
@@ -108,17 +112,24 @@ static std::string getOpenGLFragmentShaderSource(igl::IDevice& device) {
                       })");
 }
 
-static std::string getOpenGLVertexShaderSource(igl::IDevice& device) {
-  return getProlog(device) + R"(
+// With single pass stereo, both views are rendered by one draw into the layers of the
+// framebuffer and the shader picks the matrix of the view it is invoked for.
+static std::string getOpenGLVertexShaderSource(igl::IDevice& device, bool singlePassStereo) {
+  return getProlog(device,
+                   singlePassStereo ? "#extension GL_OVR_multiview2 : require\n"
+                                      "layout(num_views = 2) in;\n"
+                                      "#define VIEW_ID int(gl_ViewID_OVR)\n"
+                                    : "#define VIEW_ID 0\n") +
+         R"(
                       precision highp float;
-                      uniform mat4 mvpMatrix;
+                      uniform mat4 mvpMatrix[2];
                       uniform float scaleZ;
                       in vec3 position;
                       in vec3 uvw_in;
                       out vec3 uvw;
 
                       void main() {
-                        gl_Position =  mvpMatrix * vec4(position, 1.0);
+                        gl_Position =  mvpMatrix[VIEW_ID] * vec4(position, 1.0);
                         uvw = vec3(uvw_in.x, uvw_in.y, (uvw_in.z-0.5)*scaleZ+0.5);
                       })";
 }
@@ -136,12 +147,15 @@ static const char* getVulkanFragmentShaderSource() {
                       })";
 }
 
-static const char* getVulkanVertexShaderSource() {
-  return R"(
+static std::string getVulkanVertexShaderSource(bool singlePassStereo) {
+  return std::string(singlePassStereo ? "#extension GL_EXT_multiview : require\n"
+                                        "#define VIEW_ID gl_ViewIndex\n"
+                                      : "#define VIEW_ID 0\n") +
+         R"(
                       precision highp float;
 
                       layout (set = 1, binding = 1, std140) uniform PerFrame {
-                        mat4 mvpMatrix;
+                        mat4 mvpMatrix[2];
                         float scaleZ;
                       } perFrame;
  
@@ -150,16 +164,19 @@ static const char* getVulkanVertexShaderSource() {
                       layout(location = 0) out vec3 uvw;
 
                       void main() {
-                        gl_Position =  perFrame.mvpMatrix * vec4(position, 1.0);
+                        gl_Position =  perFrame.mvpMatrix[VIEW_ID] * vec4(position, 1.0);
                         uvw = vec3(uvw_in.x, uvw_in.y, (uvw_in.z-0.5)*perFrame.scaleZ+0.5);
                       })";
 }
 
-static std::unique_ptr<IShaderStages> getShaderStagesForBackend(igl::IDevice& device) {
+static std::unique_ptr<IShaderStages> getShaderStagesForBackend(igl::IDevice& device,
+                                                                bool singlePassStereo) {
   switch (device.getBackendType()) {
   case igl::BackendType::Vulkan:
     return igl::ShaderStagesCreator::fromModuleStringInput(device,
-                                                           getVulkanVertexShaderSource(),
+                                                           getVulkanVertexShaderSource(
+                                                               singlePassStereo)
+                                                               .c_str(),
                                                            "main",
                                                            "",
                                                            getVulkanFragmentShaderSource(),
@@ -176,7 +193,7 @@ static std::unique_ptr<IShaderStages> getShaderStagesForBackend(igl::IDevice& de
   case igl::BackendType::OpenGL:
     return igl::ShaderStagesCreator::fromModuleStringInput(
         device,
-        getOpenGLVertexShaderSource(device).c_str(),
+        getOpenGLVertexShaderSource(device, singlePassStereo).c_str(),
         "main",
         "",
         getOpenGLFragmentShaderSource(device).c_str(),
@@ -301,8 +318,13 @@ void Textured3DCubeSession::initialize() noexcept {
   inputDesc.inputBindings[0].stride = sizeof(VertexPosUvw);
   vertexInput0_ = device.createVertexInputState(inputDesc, nullptr);
 
+  // the shell provides layered surface textures and one view per layer (OpenXR on Quest)
+  singlePassStereo_ = shellParams().renderMode == RenderMode::SinglePassStereo &&
+                      shellParams().viewParams.size() >= 2 &&
+                      device.hasFeature(DeviceFeatures::Multiview);
+
   createSamplerAndTextures(device);
-  shaderStages_ = getShaderStagesForBackend(device);
+  shaderStages_ = getShaderStagesForBackend(device, singlePassStereo_);
 
   // Command queue: backed by different types of GPU HW queues
   const CommandQueueDesc desc{igl::CommandQueueType::Graphics};
@@ -319,6 +341,16 @@ void Textured3DCubeSession::initialize() noexcept {
   renderPass_.depthAttachment.clearDepth = 1.0;
 }
 
+glm::mat4 Textured3DCubeSession::getProjection(const Fov& fov, float zNear, float zFar) {
+  // asymmetric frustum of the tangents of the view's half angles
+  return glm::frustum(zNear * std::tan(fov.angleLeft),
+                      zNear * std::tan(fov.angleRight),
+                      zNear * std::tan(fov.angleDown),
+                      zNear * std::tan(fov.angleUp),
+                      zNear,
+                      zFar);
+}
+
 void Textured3DCubeSession::setVertexParams(float aspectRatio) {
   // perspective projection
   float fov = 45.0f * (M_PI / 180.0f);
@@ -331,12 +363,28 @@ void Textured3DCubeSession::setVertexParams(float aspectRatio) {
   if (scaleZ <= 0.05f || scaleZ >= 1.0f) {
     ss *= -1.0f;
   }
-  glm::mat4 xform = projectionMat * glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.f, 8.0f)) *
-                    glm::rotate(glm::mat4(1.0f), -0.2f, glm::vec3(1.0f, 0.0f, 0.0f)) *
-                    glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 1.0f, 0.0f)) *
-                    glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 1.0f, scaleZ));
-
-  vertexParameters_.mvpMatrix = xform;
+  const glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.f, 8.0f)) *
+                          glm::rotate(glm::mat4(1.0f), -0.2f, glm::vec3(1.0f, 0.0f, 0.0f)) *
+                          glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 1.0f, 0.0f)) *
+                          glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 1.0f, scaleZ));
+
+  const auto& viewParams = shellParams().viewParams;
+  if (shellParams().shellControlsViewParams && !viewParams.empty()) {
+    // The shell's views are right-handed and look down -Z: mirror the left-handed model so the
+    // cube stays in front of the viewer with the same winding.
+    const glm::mat4 mirroredModel = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 1.0f, -1.0f)) *
+                                    model;
+    const size_t numViews = singlePassStereo_ ? 2 : 1;
+    for (size_t i = 0; i != numViews; i++) {
+      vertexParameters_.mvpMatrix[i] = getProjection(viewParams[i].fov, 0.1f, 100.0f) *
+                                       viewParams[i].viewMatrix * mirroredModel;
+    }
+  } else {
+    vertexParameters_.mvpMatrix[0] = projectionMat * model;
+  }
+  if (!singlePassStereo_) {
+    vertexParameters_.mvpMatrix[1] = vertexParameters_.mvpMatrix[0];
+  }
   vertexParameters_.scaleZ = scaleZ;
 }
 
@@ -352,8 +400,17 @@ void Textured3DCubeSession::update(igl::SurfaceTextures surfaceTextures) noexcep
   igl::Result ret;
   if (framebuffer_ == nullptr) {
     igl::FramebufferDesc framebufferDesc;
+    if (singlePassStereo_) {
+      // both layers of the surface textures are rendered by each draw
+      framebufferDesc.mode = FramebufferMode::Stereo;
+    }
     framebufferDesc.colorAttachments[0].texture = surfaceTextures.color;
     framebufferDesc.depthAttachment.texture = surfaceTextures.depth;
+    if (surfaceTextures.densityMap &&
+        getPlatform().getDevice().hasFeature(DeviceFeatures::FragmentDensityMap)) {
+      // fixed foveation: the density maps of all swapchain images are the same
+      framebufferDesc.densityMapAttachment.texture = surfaceTextures.densityMap;
+    }
 
     framebuffer_ = getPlatform().getDevice().createFramebuffer(framebufferDesc, &ret);
     IGL_ASSERT(ret.isOk());
@@ -393,7 +450,9 @@ void Textured3DCubeSession::update(igl::SurfaceTextures surfaceTextures) noexcep
   igl::UniformDesc e1;
   e1.name = "mvpMatrix";
   e1.type = igl::UniformType::Mat4x4;
+  e1.numElements = 2;
   e1.offset = offsetof(VertexFormat, mvpMatrix);
+  e1.elementStride = sizeof(glm::mat4);
 
   igl::UniformDesc e2;
   e2.name = "scaleZ";
@@ -412,8 +471,12 @@ void Textured3DCubeSession::update(igl::SurfaceTextures surfaceTextures) noexcep
   info.index = 1;
   info.length = sizeof(VertexFormat);
   info.uniforms = std::vector<igl::UniformDesc>{
-      igl::UniformDesc{
-          "mvpMatrix", -1, igl::UniformType::Mat4x4, 1, offsetof(VertexFormat, mvpMatrix), 0},
+      igl::UniformDesc{"mvpMatrix",
+                       -1,
+                       igl::UniformType::Mat4x4,
+                       2,
+                       offsetof(VertexFormat, mvpMatrix),
+                       sizeof(glm::mat4)},
       igl::UniformDesc{
           "scaleZ", -1, igl::UniformType::Float, 1, offsetof(VertexFormat, scaleZ), 0}};
 #endif
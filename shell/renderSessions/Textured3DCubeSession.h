@@ -13,12 +13,13 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <igl/IGL.h>
 #include <shell/shared/platform/Platform.h>
+#include <shell/shared/renderSession/Fov.h>
 
 namespace igl {
 namespace shell {
 
 struct VertexFormat {
-  glm::mat4 mvpMatrix;
+  glm::mat4 mvpMatrix[2]; // one per view; both are the same unless rendering single pass stereo
   float scaleZ;
 };
 
@@ -40,10 +41,12 @@ class Textured3DCubeSession : public RenderSession {
   std::shared_ptr<IFramebuffer> framebuffer_;
 
   VertexFormat vertexParameters_;
+  bool singlePassStereo_ = false;
 
   // utility fns
   void createSamplerAndTextures(const IDevice& /*device*/);
   void setVertexParams(float aspectRatio);
+  static glm::mat4 getProjection(const Fov& fov, float zNear, float zFar);
 };
 
 } // namespace shell
@@ -6,6 +6,10 @@
  */
 
 #pragma once
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <future>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -14,11 +18,36 @@ namespace igl::shell {
 
 class FileLoader {
  public:
+  /// Receives consecutive chunks of a file; returning false stops reading.
+  using ChunkHandler = std::function<bool(const uint8_t* data, size_t size)>;
+
   FileLoader() = default;
   virtual ~FileLoader() = default;
   virtual std::vector<uint8_t> loadBinaryData(const std::string& /* filename */) {
     return std::vector<uint8_t>();
   }
+  /// Loads the file on another thread, so the calling thread never blocks on I/O. The loader
+  /// must outlive the returned future.
+  virtual std::future<std::vector<uint8_t>> loadBinaryDataAsync(const std::string& fileName) {
+    return std::async(std::launch::async, [this, fileName]() { return loadBinaryData(fileName); });
+  }
+  /// Reads the file in chunks of at most 'chunkSize' bytes, so large files can be processed
+  /// without holding them in memory. Returns false if the file cannot be read or 'onChunk'
+  /// stopped reading. The default implementation loads the whole file first.
+  virtual bool loadBinaryDataChunked(const std::string& fileName,
+                                     size_t chunkSize,
+                                     const ChunkHandler& onChunk) {
+    const std::vector<uint8_t> data = loadBinaryData(fileName);
+    if (data.empty() || chunkSize == 0) {
+      return false;
+    }
+    for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+      if (!onChunk(data.data() + offset, std::min(chunkSize, data.size() - offset))) {
+        return false;
+      }
+    }
+    return true;
+  }
   virtual bool fileExists(const std::string& /* filename */) const {
     return false;
   }
@@ -28,6 +57,45 @@ class FileLoader {
   virtual std::string fullPath(const std::string& /* filename */) const {
     return "";
   }
+
+ protected:
+  /// Reads a file of the file system with a single read
+  static std::vector<uint8_t> readFile(const std::string& path) {
+    std::vector<uint8_t> data;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+      return data;
+    }
+    const std::streamoff size = file.tellg();
+    if (size <= 0) {
+      return data;
+    }
+    data.resize(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    if (!file.read(reinterpret_cast<char*>(data.data()), size)) {
+      data.clear();
+    }
+    return data;
+  }
+
+  /// Reads a file of the file system in chunks, reusing a single buffer
+  static bool readFileChunked(const std::string& path,
+                              size_t chunkSize,
+                              const ChunkHandler& onChunk) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file || chunkSize == 0) {
+      return false;
+    }
+    std::vector<uint8_t> chunk(chunkSize);
+    while (file) {
+      file.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunkSize));
+      const auto size = static_cast<size_t>(file.gcount());
+      if (size != 0 && !onChunk(chunk.data(), size)) {
+        return false;
+      }
+    }
+    return file.eof();
+  }
 };
 
 } // namespace igl::shell
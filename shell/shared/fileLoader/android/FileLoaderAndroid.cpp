@@ -42,6 +42,38 @@ std::vector<uint8_t> FileLoaderAndroid::loadBinaryData(const std::string& fileNa
   return data;
 }
 
+bool FileLoaderAndroid::loadBinaryDataChunked(const std::string& fileName,
+                                              size_t chunkSize,
+                                              const ChunkHandler& onChunk) {
+  if (fileName.empty() || chunkSize == 0) {
+    IGL_LOG_ERROR("Error in loadBinaryDataChunked(): empty fileName or chunkSize\n");
+    return false;
+  }
+
+  AAsset* asset = AAssetManager_open(assetManager_, fileName.c_str(), AASSET_MODE_STREAMING);
+  if (asset == nullptr) {
+    IGL_LOG_ERROR("Error in loadBinaryDataChunked(): failed to open file %s\n", fileName.c_str());
+    return false;
+  }
+
+  std::vector<uint8_t> chunk(chunkSize);
+  bool success = true;
+  for (;;) {
+    const int readSize = AAsset_read(asset, chunk.data(), chunk.size());
+    if (readSize <= 0) {
+      // 0 at the end of the asset, negative on errors
+      success = readSize == 0;
+      break;
+    }
+    if (!onChunk(chunk.data(), static_cast<size_t>(readSize))) {
+      success = false;
+      break;
+    }
+  }
+  AAsset_close(asset);
+  return success;
+}
+
 bool FileLoaderAndroid::fileExists(const std::string& fileName) const {
   std::vector<uint8_t> data;
   if (fileName.empty()) {
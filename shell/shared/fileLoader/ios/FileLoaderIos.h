@@ -16,6 +16,9 @@ class FileLoaderIos final : public FileLoader {
   FileLoaderIos() = default;
   ~FileLoaderIos() override = default;
   std::vector<uint8_t> loadBinaryData(const std::string& fileName) override;
+  bool loadBinaryDataChunked(const std::string& fileName,
+                             size_t chunkSize,
+                             const ChunkHandler& onChunk) override;
   bool fileExists(const std::string& fileName) const override;
   std::string basePath() const override;
   std::string fullPath(const std::string& fileName) const override;
@@ -8,7 +8,6 @@
 #include <shell/shared/fileLoader/mac/FileLoaderMac.h>
 
 #import <Foundation/Foundation.h>
-#include <fstream>
 #include <string>
 
 // returns the NSString version of the full path of fileName within the main bundle
@@ -36,27 +35,18 @@ static NSString* getBundleFilePath(const std::string& fileName) {
 namespace igl::shell {
 
 std::vector<uint8_t> FileLoaderMac::loadBinaryData(const std::string& fileName) {
-  std::vector<uint8_t> data;
   if (fileName.empty()) {
-    return data;
+    return {};
   }
 
-  const std::string path = fullPath(fileName);
-
-  std::ifstream file(path, std::ios::binary);
-  if ((file.rdstate() & std::ifstream::failbit) != 0) {
-    return data;
-  }
-  file.unsetf(std::ios::skipws);
-
-  std::streampos file_size;
-  file.seekg(0, std::ios::end);
-  file_size = file.tellg();
-  file.seekg(0, std::ios::beg);
+  return readFile(fullPath(fileName));
+}
 
-  data.reserve(file_size);
-  data.insert(data.begin(), std::istream_iterator<uint8_t>(file), std::istream_iterator<uint8_t>());
-  return (data);
+bool FileLoaderMac::loadBinaryDataChunked(const std::string& fileName,
+                                          size_t chunkSize,
+                                          const ChunkHandler& onChunk) {
+  const std::string path = fullPath(fileName);
+  return !path.empty() && readFileChunked(path, chunkSize, onChunk);
 }
 
 bool FileLoaderMac::fileExists(const std::string& fileName) const {
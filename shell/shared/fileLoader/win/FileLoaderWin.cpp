@@ -8,30 +8,18 @@
 #include <shell/shared/fileLoader/win/FileLoaderWin.h>
 
 #include <fstream>
-#include <iterator>
 #include <string>
 
 namespace igl::shell {
 
 std::vector<uint8_t> FileLoaderWin::loadBinaryData(const std::string& fileName) {
-  std::vector<uint8_t> data;
-  std::ifstream file(fileName, std::ios::binary);
-  if ((file.rdstate() & std::ifstream::failbit) != 0) {
-    file.close();
-    return data;
-  }
-  file.unsetf(std::ios::skipws);
-
-  std::streampos file_size;
-  file.seekg(0, std::ios::end);
-  file_size = file.tellg();
-  file.seekg(0, std::ios::beg);
-
-  data.reserve(file_size);
-  data.insert(data.begin(), std::istream_iterator<uint8_t>(file), std::istream_iterator<uint8_t>());
-  file.close();
+  return readFile(fileName);
+}
 
-  return (data);
+bool FileLoaderWin::loadBinaryDataChunked(const std::string& fileName,
+                                          size_t chunkSize,
+                                          const ChunkHandler& onChunk) {
+  return readFileChunked(fileName, chunkSize, onChunk);
 }
 
 bool FileLoaderWin::fileExists(const std::string& fileName) const {
@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <future>
 #include <igl/IGL.h>
 #include <memory>
 #include <string>
@@ -14,6 +18,50 @@
 
 namespace igl::shell {
 
+/// Pixels of an image. Either owned, or adopted from the allocation of a decoder so decoded
+/// pixels are never copied into a second buffer.
+class ImageBuffer {
+ public:
+  ImageBuffer() = default;
+  /// Adopts 'size' bytes at 'data', which are released with 'deleter'
+  ImageBuffer(uint8_t* data, size_t size, void (*deleter)(void*)) :
+    adopted_(data, deleter), adoptedSize_(size) {}
+
+  uint8_t* data() noexcept {
+    return adopted_ ? adopted_.get() : owned_.data();
+  }
+  const uint8_t* data() const noexcept {
+    return adopted_ ? adopted_.get() : owned_.data();
+  }
+  size_t size() const noexcept {
+    return adopted_ ? adoptedSize_ : owned_.size();
+  }
+  bool empty() const noexcept {
+    return size() == 0;
+  }
+  /// Switches to owned storage, keeping the current contents which fit
+  void resize(size_t size) {
+    if (adopted_) {
+      owned_.assign(adopted_.get(), adopted_.get() + std::min(size, adoptedSize_));
+      adopted_.reset();
+    }
+    owned_.resize(size);
+  }
+  void reserve(size_t size) {
+    owned_.reserve(size);
+  }
+  template<typename InputIt>
+  void assign(InputIt first, InputIt last) {
+    adopted_.reset();
+    owned_.assign(first, last);
+  }
+
+ private:
+  std::vector<uint8_t> owned_;
+  std::shared_ptr<uint8_t> adopted_;
+  size_t adoptedSize_ = 0;
+};
+
 struct ImageData {
   uint32_t width;
   uint32_t height;
@@ -21,16 +69,105 @@ struct ImageData {
       bitsPerComponent; // bits per color channel in a pixel (eg. 16 bit RGBA would be 4, see
                         // https://developer.apple.com/documentation/coregraphics/1454980-cgimagegetbitspercomponent)
   size_t bytesPerRow;
-  std::vector<uint8_t> buffer;
+  ImageBuffer buffer;
+};
+
+/// Receives the image properties with a tightly packed 'bytesPerRow', which may be increased
+/// to the row pitch of the destination. Returns at least height * bytesPerRow bytes to decode
+/// into, or nullptr to abort.
+using ImageDestinationProvider = std::function<uint8_t*(ImageData& inOutInfo)>;
+
+/// Decodes encoded images, e.g. PNG or JPEG files, into 8-bit RGBA pixels. A decoder is shared by
+/// all the threads loading images, so it must be thread safe.
+class IImageDecoder {
+ public:
+  virtual ~IImageDecoder() = default;
+  /// True if the decoder handles the encoding of 'data', usually from its first bytes
+  [[nodiscard]] virtual bool canDecode(const uint8_t* data, size_t size) const noexcept = 0;
+  /// Decodes straight into memory provided by 'getDestination'
+  virtual bool decodeInto(const uint8_t* data,
+                          size_t size,
+                          const ImageDestinationProvider& getDestination) const noexcept = 0;
+  /// Decodes into an image buffer. Decoders which allocate the pixels themselves can adopt them.
+  virtual ImageData decode(const uint8_t* data, size_t size) const noexcept {
+    auto ret = ImageData();
+    if (!decodeInto(data, size, [&ret](ImageData& info) {
+          ret = info;
+          ret.buffer.resize(ret.bytesPerRow * ret.height);
+          return ret.buffer.data();
+        })) {
+      return ImageData();
+    }
+    return ret;
+  }
 };
 
 class ImageLoader {
  public:
+  using DestinationProvider = ImageDestinationProvider;
+  /// Calls 'job' with every index in [0, count), possibly from several threads, and returns once
+  /// all the calls have returned, e.g. iglu::jobsystem::JobSystem::parallelFor()
+  using ParallelFor =
+      std::function<void(size_t count, const std::function<void(size_t index)>& job)>;
+
   ImageLoader() = default;
   virtual ~ImageLoader() = default;
   virtual ImageData loadImageData(std::string /*imageName*/) noexcept {
     return checkerboard();
   }
+  /// Decodes the image straight into memory provided by 'getDestination', e.g. a mapped staging
+  /// buffer, so the pixels are not copied again before the upload. The buffer of the ImageData
+  /// passed to 'getDestination' is empty. The default implementation copies the result of
+  /// loadImageData().
+  virtual bool loadImageDataInto(std::string imageName,
+                                 const DestinationProvider& getDestination) noexcept {
+    ImageData image = loadImageData(std::move(imageName));
+    const size_t srcBytesPerRow = image.bytesPerRow;
+    if (!image.width || !image.height || image.buffer.size() < srcBytesPerRow * image.height) {
+      return false;
+    }
+    ImageBuffer pixels = std::move(image.buffer);
+    image.buffer = {};
+    uint8_t* dst = getDestination(image);
+    if (!dst || image.bytesPerRow < srcBytesPerRow) {
+      return false;
+    }
+    for (uint32_t y = 0; y != image.height; y++) {
+      std::memcpy(
+          dst + y * image.bytesPerRow, pixels.data() + y * srcBytesPerRow, srcBytesPerRow);
+    }
+    return true;
+  }
+  /// Loads and decodes the image on another thread, so the calling thread never blocks. The
+  /// loader must outlive the returned future.
+  virtual std::future<ImageData> loadImageDataAsync(std::string imageName) {
+    return std::async(std::launch::async, [this, imageName = std::move(imageName)]() {
+      return loadImageData(imageName);
+    });
+  }
+  /// Loads several images, spread across threads by 'parallelFor', or one after the other
+  /// without it. Encoded images cannot be split: each one is decoded by a single thread.
+  std::vector<ImageData> loadImagesData(const std::vector<std::string>& imageNames,
+                                        const ParallelFor& parallelFor = {}) {
+    std::vector<ImageData> images(imageNames.size());
+    const auto load = [this, &imageNames, &images](size_t i) {
+      images[i] = loadImageData(imageNames[i]);
+    };
+    if (parallelFor) {
+      parallelFor(imageNames.size(), load);
+    } else {
+      for (size_t i = 0; i != imageNames.size(); i++) {
+        load(i);
+      }
+    }
+    return images;
+  }
+  /// Adds a decoder, tried before the ones added earlier, e.g. a SIMD PNG or JPEG decoder ahead
+  /// of the built-in ones. Only loaders which decode files themselves use decoders. Must not be
+  /// called while images are loading.
+  void addDecoder(std::shared_ptr<IImageDecoder> decoder) {
+    decoders_.insert(decoders_.begin(), std::move(decoder));
+  }
   void setHomePath(const std::string& homePath) {
     homePath_ = homePath;
   }
@@ -38,6 +175,17 @@ class ImageLoader {
     return homePath_;
   }
 
+ protected:
+  /// The first decoder which handles 'data', or null
+  const IImageDecoder* findDecoder(const uint8_t* data, size_t size) const noexcept {
+    for (const auto& decoder : decoders_) {
+      if (decoder->canDecode(data, size)) {
+        return decoder.get();
+      }
+    }
+    return nullptr;
+  }
+
  private:
   static constexpr size_t kWidth = 8, kHeight = 8;
   using Pixel = uint32_t;
@@ -71,6 +219,7 @@ class ImageLoader {
   }
 
   std::string homePath_;
+  std::vector<std::shared_ptr<IImageDecoder>> decoders_;
 };
 
 } // namespace igl::shell
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <shell/shared/imageLoader/android/ImageDecoderAndroid.h>
+
+#if __ANDROID_API__ >= 30
+
+#include <android/imagedecoder.h>
+
+namespace igl::shell {
+
+namespace {
+
+AImageDecoder* createDecoder(const uint8_t* data, size_t size) {
+  AImageDecoder* decoder = nullptr;
+  if (AImageDecoder_createFromBuffer(data, size, &decoder) != ANDROID_IMAGE_DECODER_SUCCESS) {
+    return nullptr;
+  }
+  return decoder;
+}
+
+} // namespace
+
+bool ImageDecoderAndroid::canDecode(const uint8_t* data, size_t size) const noexcept {
+  // creating the decoder only parses the header
+  AImageDecoder* decoder = createDecoder(data, size);
+  AImageDecoder_delete(decoder);
+  return decoder != nullptr;
+}
+
+bool ImageDecoderAndroid::decodeInto(
+    const uint8_t* data,
+    size_t size,
+    const ImageDestinationProvider& getDestination) const noexcept {
+  AImageDecoder* decoder = createDecoder(data, size);
+  if (!decoder) {
+    return false;
+  }
+  // unpremultiplied RGBA, like stb_image
+  bool succeeded =
+      AImageDecoder_setAndroidBitmapFormat(decoder, ANDROID_BITMAP_FORMAT_RGBA_8888) ==
+          ANDROID_IMAGE_DECODER_SUCCESS &&
+      AImageDecoder_setUnpremultipliedRequired(decoder, true) == ANDROID_IMAGE_DECODER_SUCCESS;
+  if (succeeded) {
+    const AImageDecoderHeaderInfo* header = AImageDecoder_getHeaderInfo(decoder);
+    auto info = ImageData();
+    info.width = static_cast<uint32_t>(AImageDecoderHeaderInfo_getWidth(header));
+    info.height = static_cast<uint32_t>(AImageDecoderHeaderInfo_getHeight(header));
+    info.bitsPerComponent = 8;
+    info.bytesPerRow = AImageDecoder_getMinimumStride(decoder);
+    uint8_t* dst = getDestination(info);
+    succeeded = dst != nullptr &&
+                AImageDecoder_decodeImage(decoder,
+                                          dst,
+                                          info.bytesPerRow,
+                                          info.bytesPerRow * info.height) ==
+                    ANDROID_IMAGE_DECODER_SUCCESS;
+  }
+  AImageDecoder_delete(decoder);
+  return succeeded;
+}
+
+} // namespace igl::shell
+
+#endif
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <shell/shared/imageLoader/ImageLoader.h>
+
+namespace igl::shell {
+
+/// Decodes PNG, JPEG, WebP and the other formats of the platform with AImageDecoder, straight
+/// into the destination. Requires Android 11 (API level 30); ImageLoaderAndroid only adds it when
+/// built for that level.
+class ImageDecoderAndroid final : public IImageDecoder {
+ public:
+  [[nodiscard]] bool canDecode(const uint8_t* data, size_t size) const noexcept override;
+  bool decodeInto(const uint8_t* data,
+                  size_t size,
+                  const ImageDestinationProvider& getDestination) const noexcept override;
+};
+
+} // namespace igl::shell
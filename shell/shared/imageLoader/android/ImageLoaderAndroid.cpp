@@ -9,42 +9,50 @@
 
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
-#include <stb/stb_image.h>
+#include <shell/shared/imageLoader/android/ImageDecoderAndroid.h>
+#include <shell/shared/imageLoader/stb/ImageDecoderStb.h>
 
 namespace igl::shell {
 
-ImageData ImageLoaderAndroid::loadImageData(std::string imageName) noexcept {
-  auto ret = ImageData();
+ImageLoaderAndroid::ImageLoaderAndroid() {
+  addDecoder(std::make_shared<ImageDecoderStb>());
+#if __ANDROID_API__ >= 30
+  // the platform decoder goes first
+  addDecoder(std::make_shared<ImageDecoderAndroid>());
+#endif
+}
 
+const IImageDecoder* ImageLoaderAndroid::readAsset(const std::string& imageName,
+                                                   std::vector<uint8_t>& outData) const noexcept {
   // Load file
-  std::vector<uint8_t> buffer;
   AAsset* asset = AAssetManager_open(assetManager_, imageName.c_str(), AASSET_MODE_BUFFER);
   IGL_ASSERT(asset != nullptr);
-  buffer.resize(AAsset_getLength(asset));
-  auto readSize = AAsset_read(asset, buffer.data(), buffer.size());
-  if (readSize != buffer.size()) {
-    IGL_ASSERT_NOT_REACHED();
-    return ret;
+  if (!asset) {
+    return nullptr;
   }
-
-  // Load image from file in RGBA format
-  int width, height;
-  unsigned char* data = stbi_load_from_memory(buffer.data(), buffer.size(), &width, &height, 0, 4);
-  if (!data) {
+  outData.resize(AAsset_getLength(asset));
+  auto readSize = AAsset_read(asset, outData.data(), outData.size());
+  AAsset_close(asset);
+  if (readSize != outData.size()) {
     IGL_ASSERT_NOT_REACHED();
-    return ret;
+    return nullptr;
   }
+  const IImageDecoder* decoder = findDecoder(outData.data(), outData.size());
+  IGL_ASSERT_MSG(decoder, "No decoder for image: %s", imageName.c_str());
+  return decoder;
+}
 
-  // Copy results into return value
-  ret.width = width;
-  ret.height = height;
-  ret.bitsPerComponent = 8;
-  ret.bytesPerRow = (ret.bitsPerComponent * 4 / 8) * ret.width;
-  ret.buffer.resize(ret.bytesPerRow * ret.height);
-  memcpy(ret.buffer.data(), data, ret.bytesPerRow * ret.height);
+ImageData ImageLoaderAndroid::loadImageData(std::string imageName) noexcept {
+  std::vector<uint8_t> data;
+  const IImageDecoder* decoder = readAsset(imageName, data);
+  return decoder ? decoder->decode(data.data(), data.size()) : ImageData();
+}
 
-  free(data);
-  return ret;
+bool ImageLoaderAndroid::loadImageDataInto(std::string imageName,
+                                           const DestinationProvider& getDestination) noexcept {
+  std::vector<uint8_t> data;
+  const IImageDecoder* decoder = readAsset(imageName, data);
+  return decoder && decoder->decodeInto(data.data(), data.size(), getDestination);
 }
 
 } // namespace igl::shell
@@ -10,6 +10,7 @@
 #include <android/log.h>
 #include <shell/shared/imageLoader/ImageLoader.h>
 #include <string>
+#include <vector>
 
 class AAssetManager;
 
@@ -17,9 +18,11 @@ namespace igl::shell {
 
 class ImageLoaderAndroid final : public ImageLoader {
  public:
-  ImageLoaderAndroid() = default;
+  ImageLoaderAndroid();
   ~ImageLoaderAndroid() override = default;
   ImageData loadImageData(std::string imageName) noexcept override;
+  bool loadImageDataInto(std::string imageName,
+                         const DestinationProvider& getDestination) noexcept override;
   void setAssetManager(AAssetManager* mgr) {
     assetManager_ = mgr;
   }
@@ -28,6 +31,10 @@ class ImageLoaderAndroid final : public ImageLoader {
   }
 
  private:
+  /// Reads the encoded image and returns the decoder which handles it, or null
+  const IImageDecoder* readAsset(const std::string& imageName,
+                                 std::vector<uint8_t>& outData) const noexcept;
+
   AAssetManager* assetManager_;
 };
 
@@ -17,6 +17,8 @@ class ImageLoaderIos final : public ImageLoader {
   ImageLoaderIos() = default;
   ~ImageLoaderIos() override = default;
   ImageData loadImageData(std::string imageName) noexcept override;
+  bool loadImageDataInto(std::string imageName,
+                         const DestinationProvider& getDestination) noexcept override;
 
  private:
 };
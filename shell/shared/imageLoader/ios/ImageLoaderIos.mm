@@ -15,36 +15,53 @@ namespace igl::shell {
 
 ImageData ImageLoaderIos::loadImageData(std::string imageName) noexcept {
   auto ret = ImageData();
+  loadImageDataInto(std::move(imageName), [&ret](ImageData& info) {
+    ret = info;
+    ret.buffer.resize(ret.bytesPerRow * ret.height);
+    return ret.buffer.data();
+  });
+  return ret;
+}
 
+bool ImageLoaderIos::loadImageDataInto(std::string imageName,
+                                       const DestinationProvider& getDestination) noexcept {
   NSString* name = [NSString stringWithUTF8String:imageName.c_str()];
   UIImage* uiImage = [UIImage imageNamed:name];
   if (!uiImage) {
     IGL_LOG_ERROR("Failed to load image: %s\n", imageName.c_str());
     IGL_ASSERT_NOT_REACHED();
-    return ret;
+    return false;
   }
 
   CGImageRef image = [uiImage CGImage];
-  ret.width = CGImageGetWidth(image);
-  ret.height = CGImageGetHeight(image);
-  ret.bitsPerComponent = CGImageGetBitsPerComponent(image);
-  ret.bytesPerRow = CGImageGetBytesPerRow(image);
-  IGL_ASSERT(ret.bytesPerRow == ret.width * (ret.bitsPerComponent * 4 / 8));
-  ret.buffer.resize(ret.bytesPerRow * ret.height);
+  auto info = ImageData();
+  info.width = CGImageGetWidth(image);
+  info.height = CGImageGetHeight(image);
+  info.bitsPerComponent = CGImageGetBitsPerComponent(image);
+  info.bytesPerRow = info.width * (info.bitsPerComponent * 4 / 8);
   if (CGImageGetColorSpace(image) != CGColorSpaceCreateWithName(kCGColorSpaceSRGB)) {
     IGL_ASSERT_NOT_IMPLEMENTED();
   }
-  CGContextRef context = CGBitmapContextCreate(ret.buffer.data(),
-                                               ret.width,
-                                               ret.height,
-                                               ret.bitsPerComponent,
-                                               ret.bytesPerRow,
+
+  // draw straight into the destination
+  uint8_t* dst = getDestination(info);
+  if (!dst) {
+    return false;
+  }
+  CGContextRef context = CGBitmapContextCreate(dst,
+                                               info.width,
+                                               info.height,
+                                               info.bitsPerComponent,
+                                               info.bytesPerRow,
                                                CGImageGetColorSpace(image),
                                                kCGImageAlphaPremultipliedLast);
-  CGContextDrawImage(context, CGRectMake(0, 0, ret.width, ret.height), image);
+  if (!context) {
+    return false;
+  }
+  CGContextDrawImage(context, CGRectMake(0, 0, info.width, info.height), image);
 
   CGContextRelease(context);
-  return ret;
+  return true;
 }
 
 } // namespace igl::shell
@@ -16,6 +16,8 @@ class ImageLoaderMac final : public ImageLoader {
   ImageLoaderMac() = default;
   ~ImageLoaderMac() override = default;
   ImageData loadImageData(std::string imageName) noexcept override;
+  bool loadImageDataInto(std::string imageName,
+                         const DestinationProvider& getDestination) noexcept override;
 
  private:
 };
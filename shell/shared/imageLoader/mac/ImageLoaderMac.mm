@@ -36,34 +36,56 @@ namespace igl::shell {
 
 ImageData ImageLoaderMac::loadImageData(std::string imageName) noexcept {
   auto ret = ImageData();
+  loadImageDataInto(std::move(imageName), [&ret](ImageData& info) {
+    ret = info;
+    ret.buffer.resize(ret.bytesPerRow * ret.height);
+    return ret.buffer.data();
+  });
+  return ret;
+}
+
+bool ImageLoaderMac::loadImageDataInto(std::string imageName,
+                                       const DestinationProvider& getDestination) noexcept {
   CGImage* image = [imageForFileName(imageName) CGImageForProposedRect:nil context:nil hints:nil];
   IGL_ASSERT_MSG(image, "Could not find image file: %s", imageName.c_str());
-  ret.width = CGImageGetWidth(image);
-  ret.height = CGImageGetHeight(image);
-  ret.bitsPerComponent = CGImageGetBitsPerComponent(image);
-  ret.bytesPerRow = CGImageGetBytesPerRow(image);
-  IGL_ASSERT(ret.bytesPerRow == ret.width * (ret.bitsPerComponent * 4 / 8));
-  ret.buffer.resize(ret.bytesPerRow * ret.height);
+  if (!image) {
+    return false;
+  }
+  auto info = ImageData();
+  info.width = CGImageGetWidth(image);
+  info.height = CGImageGetHeight(image);
+  info.bitsPerComponent = CGImageGetBitsPerComponent(image);
+  info.bytesPerRow = info.width * (info.bitsPerComponent * 4 / 8);
 
   CGColorSpaceRef imageColorSpace = CGImageGetColorSpace(image);
   CGColorSpaceModel imageColorModel = CGColorSpaceGetModel(imageColorSpace);
   CGColorSpaceRef srgbColorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
   CGColorSpaceModel srgbColorModel = CGColorSpaceGetModel(srgbColorSpace);
+  CGColorSpaceRelease(srgbColorSpace);
   // Test that this is an RGB testure
   if (imageColorModel != srgbColorModel) {
     IGL_ASSERT_NOT_IMPLEMENTED();
   }
-  CGContextRef context = CGBitmapContextCreate(ret.buffer.data(),
-                                               ret.width,
-                                               ret.height,
-                                               ret.bitsPerComponent,
-                                               ret.bytesPerRow,
-                                               CGImageGetColorSpace(image),
+
+  // draw straight into the destination
+  uint8_t* dst = getDestination(info);
+  if (!dst) {
+    return false;
+  }
+  CGContextRef context = CGBitmapContextCreate(dst,
+                                               info.width,
+                                               info.height,
+                                               info.bitsPerComponent,
+                                               info.bytesPerRow,
+                                               imageColorSpace,
                                                kCGImageAlphaPremultipliedLast);
-  CGContextDrawImage(context, CGRectMake(0, 0, ret.width, ret.height), image);
+  if (!context) {
+    return false;
+  }
+  CGContextDrawImage(context, CGRectMake(0, 0, info.width, info.height), image);
 
   CGContextRelease(context);
-  return ret;
+  return true;
 }
 
 } // namespace igl::shell
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "stb_image.h"
+#include <shell/shared/imageLoader/stb/ImageDecoderStb.h>
+
+namespace igl::shell {
+
+bool ImageDecoderStb::canDecode(const uint8_t* data, size_t size) const noexcept {
+  int width, height, components;
+  return stbi_info_from_memory(data, static_cast<int>(size), &width, &height, &components) != 0;
+}
+
+ImageData ImageDecoderStb::decode(const uint8_t* data, size_t size) const noexcept {
+  // Load image from memory in RGBA format
+  auto ret = ImageData();
+  int width, height;
+  unsigned char* pixels =
+      stbi_load_from_memory(data, static_cast<int>(size), &width, &height, nullptr, 4);
+  if (!pixels) {
+    return ret;
+  }
+
+  // Adopt the decoded pixels without a copy
+  ret.width = width;
+  ret.height = height;
+  ret.bitsPerComponent = 8;
+  ret.bytesPerRow = (ret.bitsPerComponent * 4 / 8) * ret.width;
+  ret.buffer = ImageBuffer(pixels, ret.bytesPerRow * ret.height, stbi_image_free);
+  return ret;
+}
+
+bool ImageDecoderStb::decodeInto(const uint8_t* data,
+                                 size_t size,
+                                 const ImageDestinationProvider& getDestination) const noexcept {
+  // stb_image allocates the pixels, which are copied into the destination
+  ImageData image = decode(data, size);
+  if (image.buffer.empty()) {
+    return false;
+  }
+  const size_t srcBytesPerRow = image.bytesPerRow;
+  const ImageBuffer pixels = std::move(image.buffer);
+  image.buffer = {};
+  uint8_t* dst = getDestination(image);
+  if (!dst || image.bytesPerRow < srcBytesPerRow) {
+    return false;
+  }
+  for (uint32_t y = 0; y != image.height; y++) {
+    std::memcpy(dst + y * image.bytesPerRow, pixels.data() + y * srcBytesPerRow, srcBytesPerRow);
+  }
+  return true;
+}
+
+} // namespace igl::shell
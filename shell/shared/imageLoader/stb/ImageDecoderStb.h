@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <shell/shared/imageLoader/ImageLoader.h>
+
+namespace igl::shell {
+
+/// Decodes every format stb_image knows. The fallback of the loaders which decode files
+/// themselves.
+class ImageDecoderStb final : public IImageDecoder {
+ public:
+  [[nodiscard]] bool canDecode(const uint8_t* data, size_t size) const noexcept override;
+  bool decodeInto(const uint8_t* data,
+                  size_t size,
+                  const ImageDestinationProvider& getDestination) const noexcept override;
+  /// Adopts the pixels stb_image allocates
+  ImageData decode(const uint8_t* data, size_t size) const noexcept override;
+};
+
+} // namespace igl::shell
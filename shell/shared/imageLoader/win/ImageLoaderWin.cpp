@@ -5,15 +5,16 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include "stb_image.h"
-#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <shell/shared/imageLoader/stb/ImageDecoderStb.h>
 #include <shell/shared/imageLoader/win/ImageLoaderWin.h>
 #include <stdint.h>
 
 namespace igl::shell {
 
 ImageLoaderWin::ImageLoaderWin() {
+  addDecoder(std::make_shared<ImageDecoderStb>());
 // @fb-only
   // @fb-only
   // @fb-only
@@ -25,10 +26,12 @@ ImageLoaderWin::ImageLoaderWin() {
 }
 
 ImageLoaderWin::ImageLoaderWin(const std::string& homePath) {
+  addDecoder(std::make_shared<ImageDecoderStb>());
   setHomePath(homePath);
 }
 
-ImageData ImageLoaderWin::loadImageData(std::string imageName) noexcept {
+const IImageDecoder* ImageLoaderWin::readImageFile(const std::string& imageName,
+                                                   std::vector<uint8_t>& outData) const noexcept {
   // Path from home directory
   std::string fullName = homePath() + imageName;
 
@@ -54,26 +57,34 @@ ImageData ImageLoaderWin::loadImageData(std::string imageName) noexcept {
     fullName = (dir / subdir / imageName).string();
   }
 
-  // Load image from file in RGBA format
-  auto ret = ImageData();
-  int width, height;
-  unsigned char* data = stbi_load(fullName.c_str(), &width, &height, 0, 4);
-  if (!data) {
-    IGL_ASSERT_MSG(data, "Could not find image file: %s", fullName.c_str());
-    return ret;
+  // Read the whole file: decoders work from memory
+  std::ifstream file(fullName, std::ios::binary | std::ios::ate);
+  if (!file) {
+    IGL_ASSERT_MSG(false, "Could not find image file: %s", fullName.c_str());
+    return nullptr;
   }
+  outData.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char*>(outData.data()), outData.size())) {
+    IGL_ASSERT_MSG(false, "Could not read image file: %s", fullName.c_str());
+    return nullptr;
+  }
+  const IImageDecoder* decoder = findDecoder(outData.data(), outData.size());
+  IGL_ASSERT_MSG(decoder, "No decoder for image file: %s", fullName.c_str());
+  return decoder;
+}
 
-  // Copy results into return value
-  ret.width = width;
-  ret.height = height;
-  ret.bitsPerComponent = 8;
-  ret.bytesPerRow = (ret.bitsPerComponent * 4 / 8) * ret.width;
-  ret.buffer.resize(ret.bytesPerRow * ret.height);
-  memcpy(ret.buffer.data(), data, ret.bytesPerRow * ret.height);
-
-  stbi_image_free(data);
+ImageData ImageLoaderWin::loadImageData(std::string imageName) noexcept {
+  std::vector<uint8_t> data;
+  const IImageDecoder* decoder = readImageFile(imageName, data);
+  return decoder ? decoder->decode(data.data(), data.size()) : ImageData();
+}
 
-  return ret;
+bool ImageLoaderWin::loadImageDataInto(std::string imageName,
+                                       const DestinationProvider& getDestination) noexcept {
+  std::vector<uint8_t> data;
+  const IImageDecoder* decoder = readImageFile(imageName, data);
+  return decoder && decoder->decodeInto(data.data(), data.size(), getDestination);
 }
 
 } // namespace igl::shell
@@ -9,6 +9,7 @@
 
 #include <shell/shared/imageLoader/ImageLoader.h>
 #include <string>
+#include <vector>
 
 namespace igl::shell {
 
@@ -18,6 +19,13 @@ class ImageLoaderWin final : public ImageLoader {
   ImageLoaderWin(const std::string& homePath);
   ~ImageLoaderWin() override = default;
   ImageData loadImageData(std::string imageName) noexcept override;
+  bool loadImageDataInto(std::string imageName,
+                         const DestinationProvider& getDestination) noexcept override;
+
+ private:
+  /// Reads the encoded image and returns the decoder which handles it, or null
+  const IImageDecoder* readImageFile(const std::string& imageName,
+                                     std::vector<uint8_t>& outData) const noexcept;
 };
 
 } // namespace igl::shell
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <shell/shared/netservice/FrameStream.h>
+
+#include <cstring>
+#include <igl/Common.h>
+
+namespace igl::shell::netservice {
+
+namespace {
+
+constexpr size_t kBytesPerPixel = 4;
+constexpr size_t kReadChunkSize = 64 * 1024;
+
+// A delta frame is a sequence of runs: the number of unchanged pixels to skip, the number of
+// changed pixels, and the changed pixels
+struct DeltaRun {
+  uint32_t numSkipped = 0;
+  uint32_t numChanged = 0;
+};
+
+uint32_t loadPixel(const uint8_t* ptr) noexcept {
+  uint32_t pixel = 0;
+  memcpy(&pixel, ptr, sizeof(pixel));
+  return pixel;
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+
+FrameStreamWriter::FrameStreamWriter(OutputStream& stream, bool deltaEncoding) noexcept :
+  stream_(stream), deltaEncoding_(deltaEncoding) {}
+
+bool FrameStreamWriter::writeFrame(const uint8_t* pixels,
+                                   uint32_t width,
+                                   uint32_t height) noexcept {
+  IGL_ASSERT(pixels);
+  if (!flush()) {
+    return false;
+  }
+
+  const size_t numPixels = static_cast<size_t>(width) * height;
+  const size_t rawSize = numPixels * kBytesPerPixel;
+  const bool isDelta = deltaEncoding_ && width == previousWidth_ && height == previousHeight_ &&
+                       encodeDelta(pixels, numPixels);
+
+  FrameHeader header;
+  header.encoding = isDelta ? FrameEncoding::Delta : FrameEncoding::Raw;
+  header.width = width;
+  header.height = height;
+  header.payloadSize = static_cast<uint32_t>(isDelta ? encoded_.size() : rawSize);
+  header.frameIndex = frameIndex_++;
+
+  const OutputStream::Buffer buffers[] = {
+      {reinterpret_cast<const uint8_t*>(&header), sizeof(header)},
+      {isDelta ? encoded_.data() : pixels, header.payloadSize},
+  };
+  if (!send(buffers, 2)) {
+    return false;
+  }
+
+  if (deltaEncoding_) {
+    previous_.assign(pixels, pixels + rawSize);
+    previousWidth_ = width;
+    previousHeight_ = height;
+  }
+  return true;
+}
+
+bool FrameStreamWriter::flush() noexcept {
+  while (hasPendingBytes()) {
+    const int written =
+        stream_.write(pending_.data() + pendingOffset_, pending_.size() - pendingOffset_);
+    if (written <= 0) {
+      return false;
+    }
+    pendingOffset_ += written;
+  }
+  pending_.clear();
+  pendingOffset_ = 0;
+  return true;
+}
+
+bool FrameStreamWriter::send(const OutputStream::Buffer* buffers, size_t count) noexcept {
+  const int result = stream_.writeBuffers(buffers, count);
+  if (result < 0) {
+    return false;
+  }
+
+  // keep the bytes which were not accepted, so the stream never holds a truncated frame
+  size_t written = result;
+  for (size_t i = 0; i != count; i++) {
+    const size_t skipped = written < buffers[i].length ? written : buffers[i].length;
+    written -= skipped;
+    pending_.insert(
+        pending_.end(), buffers[i].data + skipped, buffers[i].data + buffers[i].length);
+  }
+  pendingOffset_ = 0;
+  return true;
+}
+
+bool FrameStreamWriter::encodeDelta(const uint8_t* pixels, size_t numPixels) noexcept {
+  if (previous_.size() != numPixels * kBytesPerPixel) {
+    return false;
+  }
+  const size_t maxSize = numPixels * kBytesPerPixel;
+  encoded_.clear();
+
+  size_t i = 0;
+  while (i != numPixels) {
+    DeltaRun run;
+    const size_t start = i;
+    while (i != numPixels && loadPixel(pixels + i * kBytesPerPixel) ==
+                                 loadPixel(previous_.data() + i * kBytesPerPixel)) {
+      i++;
+    }
+    run.numSkipped = static_cast<uint32_t>(i - start);
+    const size_t changedStart = i;
+    while (i != numPixels && loadPixel(pixels + i * kBytesPerPixel) !=
+                                 loadPixel(previous_.data() + i * kBytesPerPixel)) {
+      i++;
+    }
+    run.numChanged = static_cast<uint32_t>(i - changedStart);
+
+    const size_t changedSize = run.numChanged * kBytesPerPixel;
+    if (encoded_.size() + sizeof(run) + changedSize >= maxSize) {
+      return false;
+    }
+    const uint8_t* runBytes = reinterpret_cast<const uint8_t*>(&run);
+    encoded_.insert(encoded_.end(), runBytes, runBytes + sizeof(run));
+    const uint8_t* changed = pixels + changedStart * kBytesPerPixel;
+    encoded_.insert(encoded_.end(), changed, changed + changedSize);
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool FrameStreamReader::update() noexcept {
+  if (hasError_) {
+    return false;
+  }
+
+  while (stream_.hasBytesAvailable()) {
+    const size_t size = received_.size();
+    received_.resize(size + kReadChunkSize);
+    const int numRead = stream_.read(received_.data() + size, kReadChunkSize);
+    received_.resize(size + (numRead > 0 ? numRead : 0));
+    if (numRead <= 0) {
+      break;
+    }
+  }
+
+  bool hasNewFrame = false;
+  size_t offset = 0;
+  while (received_.size() - offset >= sizeof(FrameHeader)) {
+    FrameHeader header;
+    memcpy(&header, received_.data() + offset, sizeof(header));
+    if (header.magic != FrameHeader::kMagic) {
+      IGLLog(IGLLogLevel::LOG_ERROR, "FrameStreamReader: invalid frame header\n");
+      hasError_ = true;
+      return hasNewFrame;
+    }
+    if (received_.size() - offset - sizeof(header) < header.payloadSize) {
+      break;
+    }
+    if (!decode(header, received_.data() + offset + sizeof(header))) {
+      IGLLog(IGLLogLevel::LOG_ERROR,
+             "FrameStreamReader: invalid frame %llu\n",
+             static_cast<unsigned long long>(header.frameIndex));
+      hasError_ = true;
+      return hasNewFrame;
+    }
+    hasNewFrame = true;
+    offset += sizeof(header) + header.payloadSize;
+  }
+  received_.erase(received_.begin(), received_.begin() + offset);
+  return hasNewFrame;
+}
+
+bool FrameStreamReader::decode(const FrameHeader& header, const uint8_t* payload) noexcept {
+  const size_t rawSize = static_cast<size_t>(header.width) * header.height * kBytesPerPixel;
+
+  if (header.encoding == FrameEncoding::Raw) {
+    if (header.payloadSize != rawSize) {
+      return false;
+    }
+    pixels_.assign(payload, payload + rawSize);
+  } else if (header.encoding == FrameEncoding::Delta) {
+    if (header.width != width_ || header.height != height_ || pixels_.size() != rawSize) {
+      return false;
+    }
+    size_t offset = 0;
+    size_t pixelOffset = 0;
+    while (offset != header.payloadSize) {
+      DeltaRun run;
+      if (header.payloadSize - offset < sizeof(run)) {
+        return false;
+      }
+      memcpy(&run, payload + offset, sizeof(run));
+      offset += sizeof(run);
+      const size_t changedSize = static_cast<size_t>(run.numChanged) * kBytesPerPixel;
+      pixelOffset += static_cast<size_t>(run.numSkipped) * kBytesPerPixel;
+      if (pixelOffset > rawSize || rawSize - pixelOffset < changedSize ||
+          header.payloadSize - offset < changedSize) {
+        return false;
+      }
+      memcpy(pixels_.data() + pixelOffset, payload + offset, changedSize);
+      offset += changedSize;
+      pixelOffset += changedSize;
+    }
+  } else {
+    return false;
+  }
+
+  width_ = header.width;
+  height_ = header.height;
+  frameIndex_ = header.frameIndex;
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace igl::shell::netservice
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <shell/shared/netservice/Stream.h>
+#include <vector>
+
+namespace igl::shell::netservice {
+
+// ----------------------------------------------------------------------------
+
+enum class FrameEncoding : uint8_t {
+  Raw, // the tightly packed 4-byte pixels
+  Delta, // runs of the pixels which differ from the previous frame
+};
+
+// Precedes every frame on the stream, in host byte order
+struct FrameHeader {
+  static constexpr uint32_t kMagic = 0x31474649; // "IFG1"
+
+  uint32_t magic = kMagic;
+  FrameEncoding encoding = FrameEncoding::Raw;
+  uint8_t reserved[3] = {};
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t payloadSize = 0;
+  uint64_t frameIndex = 0;
+};
+
+// ----------------------------------------------------------------------------
+
+// Sends rendered frames over an OutputStream. Raw frames are written straight from the caller's
+// pixels, e.g. a mapped readback buffer, with a single gather write and no copy. Delta frames
+// only carry the pixels which changed since the previous frame, and are sent whenever they are
+// smaller than the raw frame.
+//
+// A frame which the stream did not fully accept is kept and sent by flush(); writeFrame() skips
+// frames until then, so a slow client drops frames rather than stalling the sender.
+class FrameStreamWriter final {
+ public:
+  explicit FrameStreamWriter(OutputStream& stream, bool deltaEncoding = true) noexcept;
+
+  // Sends `width` x `height` tightly packed 4-byte pixels. Returns false if the frame was
+  // skipped because the previous one is still being sent, or if the stream failed.
+  bool writeFrame(const uint8_t* pixels, uint32_t width, uint32_t height) noexcept;
+
+  // Continues sending a partially written frame; call it on Event::HasSpaceAvailable.
+  // Returns true once nothing is pending.
+  bool flush() noexcept;
+
+  [[nodiscard]] bool hasPendingBytes() const noexcept {
+    return pendingOffset_ < pending_.size();
+  }
+
+ private:
+  // writes the buffers and keeps whatever the stream did not accept in pending_
+  bool send(const OutputStream::Buffer* buffers, size_t count) noexcept;
+  // encodes `pixels` against previous_ into encoded_; false if it is not smaller than raw
+  bool encodeDelta(const uint8_t* pixels, size_t numPixels) noexcept;
+
+  OutputStream& stream_;
+  const bool deltaEncoding_;
+  uint64_t frameIndex_ = 0;
+  uint32_t previousWidth_ = 0;
+  uint32_t previousHeight_ = 0;
+  std::vector<uint8_t> previous_;
+  std::vector<uint8_t> encoded_;
+  std::vector<uint8_t> pending_;
+  size_t pendingOffset_ = 0;
+};
+
+// ----------------------------------------------------------------------------
+
+// Receives the frames sent by FrameStreamWriter from an InputStream
+class FrameStreamReader final {
+ public:
+  explicit FrameStreamReader(InputStream& stream) noexcept : stream_(stream) {}
+
+  // Reads the available bytes; call it on Event::HasBytesAvailable. Returns true if at least one
+  // new frame was decoded, in which case getPixels() holds the latest one.
+  bool update() noexcept;
+
+  [[nodiscard]] const std::vector<uint8_t>& getPixels() const noexcept {
+    return pixels_;
+  }
+  [[nodiscard]] uint32_t getWidth() const noexcept {
+    return width_;
+  }
+  [[nodiscard]] uint32_t getHeight() const noexcept {
+    return height_;
+  }
+  [[nodiscard]] uint64_t getFrameIndex() const noexcept {
+    return frameIndex_;
+  }
+  // Set once the stream holds something other than frames; nothing is decoded afterwards
+  [[nodiscard]] bool hasError() const noexcept {
+    return hasError_;
+  }
+
+ private:
+  bool decode(const FrameHeader& header, const uint8_t* payload) noexcept;
+
+  InputStream& stream_;
+  std::vector<uint8_t> received_;
+  std::vector<uint8_t> pixels_;
+  uint32_t width_ = 0;
+  uint32_t height_ = 0;
+  uint64_t frameIndex_ = 0;
+  bool hasError_ = false;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace igl::shell::netservice
@@ -66,8 +66,31 @@ struct InputStream : Stream {
 // ----------------------------------------------------------------------------
 
 struct OutputStream : Stream {
+  struct Buffer {
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+  };
+
   virtual int write(const uint8_t* buffer, size_t maxLength) noexcept = 0;
   [[nodiscard]] virtual bool hasSpaceAvailable() const noexcept = 0;
+
+  // Writes `buffers` in order without concatenating them first. Returns the number of bytes
+  // written, which is less than the total on a partial write, or -1 if nothing could be written.
+  // Streams with a native gather write should override it.
+  virtual int writeBuffers(const Buffer* buffers, size_t count) noexcept {
+    int written = 0;
+    for (size_t i = 0; i != count; i++) {
+      const int result = write(buffers[i].data, buffers[i].length);
+      if (result < 0) {
+        return written > 0 ? written : -1;
+      }
+      written += result;
+      if (static_cast<size_t>(result) != buffers[i].length) {
+        break;
+      }
+    }
+    return written;
+  }
 };
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <shell/shared/renderSession/FrameDumper.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <shell/shared/imageWriter/ImageWriter.h>
+#include <utility>
+
+namespace igl::shell {
+
+FrameDumper::FrameDumper(const ImageWriter& imageWriter, Config config) :
+  imageWriter_(imageWriter),
+  config_(config),
+  workers_(std::max(config.numThreads, 1u), "FrameDumper") {
+  IGL_ASSERT(config_.maxFramesInFlight > 0);
+}
+
+FrameDumper::~FrameDumper() {
+  flush();
+}
+
+bool FrameDumper::captureFrame(ICommandQueue& cmdQueue,
+                               IFramebuffer& framebuffer,
+                               std::string absolutePath) {
+  const auto texture = framebuffer.getColorAttachment(0);
+  if (!IGL_VERIFY(texture)) {
+    return false;
+  }
+  const TextureFormat format = texture->getFormat();
+  if (format != TextureFormat::RGBA_UNorm8 && format != TextureFormat::RGBA_SRGB &&
+      format != TextureFormat::BGRA_UNorm8 && format != TextureFormat::BGRA_SRGB) {
+    IGLLog(IGLLogLevel::LOG_ERROR,
+           "FrameDumper: unsupported texture format %s\n",
+           TextureFormatProperties::fromTextureFormat(format).name);
+    return false;
+  }
+
+  const Dimensions size = texture->getDimensions();
+  auto frame = std::make_shared<Frame>();
+  frame->imageData.width = size.width;
+  frame->imageData.height = size.height;
+  frame->imageData.bitsPerComponent = 8;
+  frame->imageData.bytesPerRow = size.width * 4;
+  frame->swapRedBlue = isTextureFormatBGR(format);
+  frame->path = std::move(absolutePath);
+
+  const auto range = TextureRangeDesc::new2D(0, 0, size.width, size.height);
+  frame->readback = texture->readAsync(cmdQueue, range, nullptr);
+  if (!frame->readback) {
+    // no asynchronous readbacks: copy now, but still encode on the workers
+    frame->imageData.buffer.resize(frame->imageData.bytesPerRow * size.height);
+    framebuffer.copyBytesColorAttachment(cmdQueue, 0, frame->imageData.buffer.data(), range);
+    write(std::move(frame));
+    return true;
+  }
+
+  pendingReadbacks_.push_back(std::move(frame));
+  while (pendingReadbacks_.size() > config_.maxFramesInFlight) {
+    // waits for the GPU
+    write(std::move(pendingReadbacks_.front()));
+    pendingReadbacks_.pop_front();
+  }
+  update();
+  return true;
+}
+
+void FrameDumper::update() {
+  while (!pendingReadbacks_.empty() && pendingReadbacks_.front()->readback->isReady()) {
+    write(std::move(pendingReadbacks_.front()));
+    pendingReadbacks_.pop_front();
+  }
+}
+
+void FrameDumper::flush() {
+  while (!pendingReadbacks_.empty()) {
+    write(std::move(pendingReadbacks_.front()));
+    pendingReadbacks_.pop_front();
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  writeFinished_.wait(lock, [this] { return numWrites_ == 0; });
+}
+
+void FrameDumper::write(std::shared_ptr<Frame> frame) {
+  if (frame->readback) {
+    IGL_ASSERT(frame->readback->getSizeInBytes() ==
+               frame->imageData.bytesPerRow * frame->imageData.height);
+    frame->imageData.buffer.resize(frame->readback->getSizeInBytes());
+    const Result result = frame->readback->getData(frame->imageData.buffer.data());
+    frame->readback = nullptr;
+    if (!result.isOk()) {
+      IGLLog(IGLLogLevel::LOG_ERROR,
+             "FrameDumper: readback of %s failed: %s\n",
+             frame->path.c_str(),
+             result.message.c_str());
+      return;
+    }
+  }
+
+  {
+    // bounds the memory held by frames waiting for a worker
+    std::unique_lock<std::mutex> lock(mutex_);
+    writeFinished_.wait(lock, [this] { return numWrites_ < config_.maxFramesInFlight; });
+    numWrites_++;
+  }
+  workers_.enqueue([this, frame = std::move(frame)]() {
+    encode(*frame);
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      numWrites_--;
+    }
+    writeFinished_.notify_all();
+  });
+}
+
+void FrameDumper::encode(Frame& frame) const {
+  uint8_t* pixels = frame.imageData.buffer.data();
+  if (frame.swapRedBlue) {
+    const size_t size = frame.imageData.buffer.size();
+    for (size_t i = 0; i + 3 < size; i += 4) {
+      std::swap(pixels[i], pixels[i + 2]);
+    }
+  }
+
+  if (config_.format == Format::Png) {
+    imageWriter_.writeImage(frame.path, frame.imageData);
+    return;
+  }
+
+  FILE* file = fopen(frame.path.c_str(), "wb");
+  const size_t size = frame.imageData.buffer.size();
+  if (!file || fwrite(pixels, 1, size, file) != size) {
+    IGLLog(IGLLogLevel::LOG_ERROR, "FrameDumper: failed saving the file: %s", frame.path.c_str());
+  }
+  if (file) {
+    fclose(file);
+  }
+}
+
+} // namespace igl::shell
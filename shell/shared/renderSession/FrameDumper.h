@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/IGL.h>
+#include <igl/WorkerPool.h>
+#include <shell/shared/imageLoader/ImageLoader.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace igl::shell {
+
+class ImageWriter;
+
+/**
+ * @brief Saves rendered frames without stalling the render thread. Every frame is read back
+ * asynchronously (ITexture::readAsync()), and is then encoded and written by worker threads.
+ *
+ * At most Config::maxFramesInFlight frames are read back, and as many are encoded, at the same
+ * time; captureFrame() waits for the oldest frame beyond that, so no frame is ever dropped. Backends
+ * without asynchronous readbacks fall back to a synchronous copy, still encoded by the workers.
+ *
+ * Not thread-safe: call captureFrame(), update() and flush() from the render thread.
+ */
+class FrameDumper final {
+ public:
+  enum class Format : uint8_t {
+    Png, // written by ImageWriter
+    Raw, // the tightly packed RGBA8 pixels, with no header
+  };
+
+  struct Config {
+    Format format = Format::Png;
+    uint32_t maxFramesInFlight = 4;
+    uint32_t numThreads = 2;
+  };
+
+  /// `imageWriter` has to outlive the dumper; its writeImage() is called from the worker threads.
+  FrameDumper(const ImageWriter& imageWriter, Config config);
+  /// Writes all the captured frames
+  ~FrameDumper();
+
+  FrameDumper(const FrameDumper&) = delete;
+  FrameDumper& operator=(const FrameDumper&) = delete;
+
+  /// Queues the first color attachment of `framebuffer` to be saved to `absolutePath`. Call it
+  /// after the frame is submitted to `cmdQueue`. Only 8-bit RGBA and BGRA attachments are supported.
+  bool captureFrame(ICommandQueue& cmdQueue, IFramebuffer& framebuffer, std::string absolutePath);
+
+  /// Hands the readbacks which have completed over to the worker threads. Never waits.
+  void update();
+
+  /// Waits until every captured frame is written
+  void flush();
+
+ private:
+  struct Frame {
+    std::shared_ptr<IReadback> readback; // null once the pixels are in imageData
+    ImageData imageData = {};
+    bool swapRedBlue = false;
+    std::string path;
+  };
+
+  // retrieves the pixels of the frame if needed and queues the frame for encoding
+  void write(std::shared_ptr<Frame> frame);
+  void encode(Frame& frame) const;
+
+  const ImageWriter& imageWriter_;
+  const Config config_;
+  std::deque<std::shared_ptr<Frame>> pendingReadbacks_;
+
+  std::mutex mutex_;
+  std::condition_variable writeFinished_;
+  uint32_t numWrites_ = 0; // guarded by mutex_
+
+  // last, so it is destroyed (and finishes its tasks) before the members the tasks use
+  WorkerPool workers_;
+};
+
+} // namespace igl::shell
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <shell/shared/renderSession/FramePipeline.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace igl::shell {
+
+FramePipeline::FramePipeline(std::shared_ptr<ICommandQueue> commandQueue, Config config) :
+  commandQueue_(std::move(commandQueue)),
+  config_(config),
+  slotCommandBuffers_(std::max(config.maxFramesInFlight, 1u)) {
+  IGL_ASSERT(commandQueue_);
+  IGL_ASSERT(config_.maxFramesInFlight > 0);
+  if (config_.numEncodeThreads > 0) {
+    workers_ = std::make_unique<WorkerPool>(config_.numEncodeThreads, "FramePipeline");
+  }
+}
+
+FramePipeline::~FramePipeline() {
+  if (isInFrame_) {
+    endFrame();
+  }
+  waitIdle();
+}
+
+uint32_t FramePipeline::beginFrame() {
+  IGL_ASSERT_MSG(!isInFrame_, "endFrame() has to be called before the next beginFrame()");
+  isInFrame_ = true;
+  frameSlot_ = static_cast<uint32_t>(frameIndex_ % slotCommandBuffers_.size());
+  waitForSlot(frameSlot_);
+  return frameSlot_;
+}
+
+void FramePipeline::encode(EncodeTask task) {
+  IGL_ASSERT_MSG(isInFrame_, "encode() has to be called between beginFrame() and endFrame()");
+  encoded_.emplace_back();
+  std::shared_ptr<ICommandBuffer>& result = encoded_.back();
+
+  if (!workers_) {
+    result = task(frameSlot_);
+    return;
+  }
+
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    numPendingEncodes_++;
+  }
+  workers_->enqueue([this, &result, task = std::move(task), slot = frameSlot_]() {
+    result = task(slot);
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      numPendingEncodes_--;
+    }
+    encodeFinished_.notify_all();
+  });
+}
+
+void FramePipeline::endFrame() {
+  IGL_ASSERT_MSG(isInFrame_, "endFrame() has to follow beginFrame()");
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    encodeFinished_.wait(lock, [this] { return numPendingEncodes_ == 0; });
+  }
+
+  for (auto& cmdBuffer : encoded_) {
+    if (cmdBuffer) {
+      commandQueue_->submit(*cmdBuffer);
+      slotCommandBuffers_[frameSlot_] = std::move(cmdBuffer);
+    }
+  }
+  encoded_.clear();
+
+  isInFrame_ = false;
+  frameIndex_++;
+}
+
+void FramePipeline::waitIdle() {
+  for (uint32_t slot = 0; slot != slotCommandBuffers_.size(); slot++) {
+    waitForSlot(slot);
+  }
+}
+
+void FramePipeline::waitForSlot(uint32_t slot) {
+  // queues execute in order: the last command buffer of a frame completes after all the others
+  auto& cmdBuffer = slotCommandBuffers_[slot];
+  if (cmdBuffer) {
+    if (!cmdBuffer->isCompleted()) {
+      cmdBuffer->waitUntilCompleted();
+    }
+    cmdBuffer = nullptr;
+  }
+}
+
+} // namespace igl::shell
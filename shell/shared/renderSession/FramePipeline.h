@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/IGL.h>
+#include <igl/WorkerPool.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace igl::shell {
+
+/**
+ * @brief Lets a session prepare frame N+1 on the CPU while the GPU still renders frame N.
+ *
+ * Sessions keep Config::maxFramesInFlight copies of every resource the CPU writes each frame, such
+ * as uniform buffers, and index them with the slot returned by beginFrame(). beginFrame() only
+ * waits for the GPU to finish the frame which last used that slot, so up to maxFramesInFlight
+ * frames are rendered while the next one is prepared.
+ *
+ * Command buffers are encoded by encode() tasks, which run on Config::numEncodeThreads worker
+ * threads, or inline without workers, and are submitted in the order of the encode() calls by
+ * endFrame(). Only use workers with backends whose command buffers can be encoded from any thread
+ * (Metal and Vulkan, as long as the tasks use distinct resources); OpenGL must encode inline.
+ *
+ * Call beginFrame(), encode() and endFrame() from the render thread.
+ */
+class FramePipeline final {
+ public:
+  struct Config {
+    uint32_t maxFramesInFlight = 2;
+    uint32_t numEncodeThreads = 0;
+  };
+
+  /// Returns the command buffer it encoded for the frame slot, which is submitted by endFrame().
+  /// May return nullptr to submit nothing.
+  using EncodeTask = std::function<std::shared_ptr<ICommandBuffer>(uint32_t frameSlot)>;
+
+  FramePipeline(std::shared_ptr<ICommandQueue> commandQueue, Config config);
+  /// Waits until the GPU has finished all frames
+  ~FramePipeline();
+
+  FramePipeline(const FramePipeline&) = delete;
+  FramePipeline& operator=(const FramePipeline&) = delete;
+
+  /// Waits until the resources of the next frame slot are no longer used by the GPU and returns
+  /// the slot, in [0, Config::maxFramesInFlight).
+  uint32_t beginFrame();
+
+  /// Queues a task encoding a command buffer of the current frame
+  void encode(EncodeTask task);
+
+  /// Waits for the encode() tasks and submits their command buffers in order, the last one
+  /// completing the frame slot. Present drawables from the tasks, before the submit.
+  void endFrame();
+
+  /// Waits until the GPU has finished all submitted frames
+  void waitIdle();
+
+  [[nodiscard]] uint32_t getFrameSlot() const {
+    return frameSlot_;
+  }
+  [[nodiscard]] uint64_t getFrameIndex() const {
+    return frameIndex_;
+  }
+  [[nodiscard]] uint32_t getMaxFramesInFlight() const {
+    return config_.maxFramesInFlight;
+  }
+
+ private:
+  void waitForSlot(uint32_t slot);
+
+  std::shared_ptr<ICommandQueue> commandQueue_;
+  const Config config_;
+  // the last command buffer submitted by the frame using each slot
+  std::vector<std::shared_ptr<ICommandBuffer>> slotCommandBuffers_;
+  uint32_t frameSlot_ = 0;
+  uint64_t frameIndex_ = 0;
+  bool isInFrame_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable encodeFinished_;
+  uint32_t numPendingEncodes_ = 0; // guarded by mutex_
+  // written by the tasks; a deque so queuing never moves the elements they write
+  std::deque<std::shared_ptr<ICommandBuffer>> encoded_;
+
+  // last, so it is destroyed (and finishes its tasks) before the members the tasks use
+  std::unique_ptr<WorkerPool> workers_;
+};
+
+} // namespace igl::shell
@@ -7,9 +7,11 @@
 
 #include <shell/shared/renderSession/ScreenshotTestRenderSessionHelper.h>
 
+#include <cstdio>
 #include <cstdlib>
 #include <shell/shared/imageWriter/ImageWriter.h>
 #include <shell/shared/renderSession/AppParams.h>
+#include <shell/shared/renderSession/FrameDumper.h>
 #include <shell/shared/renderSession/ShellParams.h>
 
 namespace igl::shell {
@@ -37,8 +39,29 @@ void SaveFrameBufferToPng(const char* absoluteFilename,
   IGLLog(IGLLogLevel::LOG_INFO, "Writing screenshot to: %s", absoluteFilename);
   platform.getImageWriter().writeImage(absoluteFilename, imageData);
 }
+
+// "out/frame.png" -> "out/frame_00042.png"
+std::string getFrameFilename(const std::string& path, int frame) {
+  char suffix[16];
+  snprintf(suffix, sizeof(suffix), "_%05d", frame);
+  const size_t slash = path.find_last_of("/\\");
+  const size_t dot = path.find_last_of('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return path + suffix;
+  }
+  return path.substr(0, dot) + suffix + path.substr(dot);
+}
 } // namespace
 
+ScreenshotTestRenderSessionHelper::ScreenshotTestRenderSessionHelper() = default;
+
+ScreenshotTestRenderSessionHelper::~ScreenshotTestRenderSessionHelper() = default;
+
+void ScreenshotTestRenderSessionHelper::dispose() noexcept {
+  frameDumper_ = nullptr;
+  commandQueue_ = nullptr;
+}
+
 void ScreenshotTestRenderSessionHelper::initialize(AppParams& appParams) noexcept {
   const char* screenshotTestsOutPath = std::getenv("SCREENSHOT_TESTS_OUT");
   const char* screenshotTestsFrame = std::getenv("SCREENSHOT_TESTS_FRAME");
@@ -52,6 +75,39 @@ void ScreenshotTestRenderSessionHelper::initialize(AppParams& appParams) noexcep
     appParams.screenshotTestsParams.outputPath_ = screenshotTestsOutPath;
     appParams.screenshotTestsParams.frameToCapture_ = frameCount;
   }
+  // SCREENSHOT_TESTS_DUMP_FRAMES=N saves the first N frames to SCREENSHOT_TESTS_OUT_<frame>
+  const char* screenshotTestsDumpFrames = std::getenv("SCREENSHOT_TESTS_DUMP_FRAMES");
+  if (screenshotTestsOutPath && screenshotTestsDumpFrames) {
+    appParams.screenshotTestsParams.outputPath_ = screenshotTestsOutPath;
+    appParams.screenshotTestsParams.numFramesToDump_ = atoi(screenshotTestsDumpFrames);
+  }
+}
+
+bool ScreenshotTestRenderSessionHelper::dumpFrame(const AppParams& appParams,
+                                                  const igl::SurfaceTextures& surfaceTextures,
+                                                  Platform& platform) {
+  if (!frameDumper_) {
+    commandQueue_ = platform.getDevice().createCommandQueue(
+        CommandQueueDesc{igl::CommandQueueType::Graphics}, nullptr);
+    frameDumper_ = std::make_unique<FrameDumper>(platform.getImageWriter(), FrameDumper::Config{});
+  }
+  igl::FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = surfaceTextures.color;
+  auto framebuffer = platform.getDevice().createFramebuffer(framebufferDesc, nullptr);
+  if (framebuffer && commandQueue_) {
+    frameDumper_->captureFrame(
+        *commandQueue_,
+        *framebuffer,
+        getFrameFilename(appParams.screenshotTestsParams.outputPath_, frameTicked_));
+  }
+
+  ++frameTicked_;
+  if (frameTicked_ < appParams.screenshotTestsParams.numFramesToDump_) {
+    return false;
+  }
+  IGLLog(IGLLogLevel::LOG_INFO, "[screenshot test] Saved %d frames", frameTicked_);
+  frameDumper_->flush();
+  return true;
 }
 
 bool ScreenshotTestRenderSessionHelper::update(const AppParams& appParams,
@@ -59,6 +115,9 @@ bool ScreenshotTestRenderSessionHelper::update(const AppParams& appParams,
                                                const igl::SurfaceTextures& surfaceTextures,
                                                Platform& platform) {
   const std::string& screenshotTestsOutPath = appParams.screenshotTestsParams.outputPath_;
+  if (!screenshotTestsOutPath.empty() && appParams.screenshotTestsParams.numFramesToDump_ > 0) {
+    return dumpFrame(appParams, surfaceTextures, platform);
+  }
   if (!screenshotTestsOutPath.empty()) {
     int frameCount = appParams.screenshotTestsParams.frameToCapture_;
     if (frameTicked_ == frameCount) {
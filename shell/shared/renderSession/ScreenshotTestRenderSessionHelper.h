@@ -17,21 +17,29 @@ class ITexture;
 
 namespace igl::shell {
 struct AppParams;
+class FrameDumper;
 struct ShellParams;
 
 class ScreenshotTestRenderSessionHelper {
  public:
-  ScreenshotTestRenderSessionHelper() = default;
+  ScreenshotTestRenderSessionHelper();
+  ~ScreenshotTestRenderSessionHelper();
 
   void initialize(AppParams& appParams) noexcept;
   bool update(const AppParams& appParams,
               const ShellParams& shellParams,
               const igl::SurfaceTextures& surfaceTextures,
               Platform& platform);
-  void dispose() noexcept {}
+  void dispose() noexcept;
 
  private:
+  bool dumpFrame(const AppParams& appParams,
+                 const igl::SurfaceTextures& surfaceTextures,
+                 Platform& platform);
+
   int frameTicked_ = 0;
+  std::shared_ptr<ICommandQueue> commandQueue_;
+  std::unique_ptr<FrameDumper> frameDumper_;
 };
 
 } // namespace igl::shell
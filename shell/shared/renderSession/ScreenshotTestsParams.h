@@ -12,6 +12,8 @@ namespace igl::shell {
 struct ScreenshotTestsParams {
   std::string outputPath_;
   int frameToCapture_ = 0;
+  // if non-zero, the first numFramesToDump_ frames are saved, see FrameDumper
+  int numFramesToDump_ = 0;
   bool isScreenshotTestsEnabled() const {
     return !outputPath_.empty();
   }
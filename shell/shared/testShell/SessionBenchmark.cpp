@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <shell/shared/testShell/SessionBenchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <igl/AllocationAudit.h>
+#include <igl/IGL.h>
+#include <igl/TimestampQueryPool.h>
+#include <shell/shared/renderSession/ShellParams.h>
+#include <utility>
+#include <vector>
+
+namespace igl::shell {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+SessionBenchmarkResult::Timings computeTimings(std::vector<double> values) {
+  SessionBenchmarkResult::Timings timings;
+  if (values.empty()) {
+    return timings;
+  }
+  std::sort(values.begin(), values.end());
+  double sum = 0.0;
+  for (const double value : values) {
+    sum += value;
+  }
+  timings.mean = sum / static_cast<double>(values.size());
+  timings.min = values.front();
+  timings.median = values[values.size() / 2];
+  timings.p95 = values[std::min(values.size() - 1, values.size() * 95 / 100)];
+  timings.max = values.back();
+  return timings;
+}
+
+void accumulate(FrameStatistics& total, const FrameStatistics& frame) {
+  total.drawCalls += frame.drawCalls;
+  total.pipelineBinds += frame.pipelineBinds;
+  total.descriptorUpdates += frame.descriptorUpdates;
+  total.uploadedBytes += frame.uploadedBytes;
+  total.gpuWaits += frame.gpuWaits;
+  total.deferredTasks += frame.deferredTasks;
+  total.apiCalls += frame.apiCalls;
+}
+
+// Writes the timestamps bracketing the frames into their own command buffers
+class GpuTimer final {
+ public:
+  GpuTimer(IDevice& device, size_t numFrames) {
+    if (!device.hasFeature(DeviceFeatures::TimestampQueries)) {
+      return;
+    }
+    commandQueue_ = device.createCommandQueue({CommandQueueType::Graphics}, nullptr);
+    pool_ = device.createTimestampQueryPool(
+        {static_cast<uint32_t>(numFrames * 2), "SessionBenchmark"}, nullptr);
+    if (!commandQueue_ || !pool_) {
+      pool_ = nullptr;
+    }
+  }
+
+  void write(uint32_t query) {
+    if (!pool_) {
+      return;
+    }
+    lastCommandBuffer_ = commandQueue_->createCommandBuffer({}, nullptr);
+    if (lastCommandBuffer_) {
+      lastCommandBuffer_->writeTimestamp(*pool_, query);
+      commandQueue_->submit(*lastCommandBuffer_);
+    }
+  }
+
+  // Returns false if the GPU times are not available
+  bool getFrameTimes(size_t numFrames, std::vector<double>& outTimesMs) {
+    if (!pool_ || !lastCommandBuffer_) {
+      return false;
+    }
+    lastCommandBuffer_->waitUntilCompleted();
+    std::vector<uint64_t> timestamps(numFrames * 2);
+    if (!pool_->getResults(0, static_cast<uint32_t>(timestamps.size()), timestamps.data())) {
+      return false;
+    }
+    outTimesMs.clear();
+    for (size_t i = 0; i != numFrames; i++) {
+      const uint64_t begin = timestamps[2 * i];
+      const uint64_t end = timestamps[2 * i + 1];
+      outTimesMs.push_back(end > begin ? static_cast<double>(end - begin) * 1e-6 : 0.0);
+    }
+    return true;
+  }
+
+ private:
+  std::shared_ptr<ICommandQueue> commandQueue_;
+  std::shared_ptr<ITimestampQueryPool> pool_;
+  std::shared_ptr<ICommandBuffer> lastCommandBuffer_;
+};
+
+void appendTimings(std::string& json, const char* name, const SessionBenchmarkResult::Timings& t) {
+  char buffer[256];
+  snprintf(buffer,
+           sizeof(buffer),
+           "\"%s\": {\"mean\": %.4f, \"min\": %.4f, \"median\": %.4f, \"p95\": %.4f, "
+           "\"max\": %.4f}",
+           name,
+           t.mean,
+           t.min,
+           t.median,
+           t.p95,
+           t.max);
+  json += buffer;
+}
+
+std::string escapeJson(const std::string& str) {
+  std::string escaped;
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+} // namespace
+
+std::string SessionBenchmarkResult::toJson() const {
+  std::string json = "{\"session\": \"" + escapeJson(sessionName) + "\", \"backend\": \"" +
+                     escapeJson(backend) + "\", \"frames\": " + std::to_string(numFrames);
+
+  char buffer[512];
+  snprintf(buffer,
+           sizeof(buffer),
+           ", \"initializeMs\": %.4f, \"disposeMs\": %.4f, ",
+           initializeMs,
+           disposeMs);
+  json += buffer;
+  appendTimings(json, "updateMs", updateMs);
+  if (hasGpuTime) {
+    json += ", ";
+    appendTimings(json, "gpuMs", gpuMs);
+  }
+
+  snprintf(buffer,
+           sizeof(buffer),
+           ", \"allocations\": %" PRId64
+           ", \"statistics\": {\"drawCalls\": %u, \"pipelineBinds\": %u, "
+           "\"descriptorUpdates\": %u, \"uploadedBytes\": %" PRIu64
+           ", \"gpuWaits\": %u, \"deferredTasks\": %u, \"apiCalls\": %" PRIu64 "}",
+           allocations,
+           frameStatistics.drawCalls,
+           frameStatistics.pipelineBinds,
+           frameStatistics.descriptorUpdates,
+           frameStatistics.uploadedBytes,
+           frameStatistics.gpuWaits,
+           frameStatistics.deferredTasks,
+           frameStatistics.apiCalls);
+  json += buffer;
+
+  snprintf(buffer,
+           sizeof(buffer),
+           ", \"memory\": {\"textureBytes\": %zu, \"bufferBytes\": %zu, \"numTextures\": %u, "
+           "\"numBuffers\": %u, \"deviceUsedBytes\": %zu, \"deviceBudgetBytes\": %zu}}",
+           trackedMemory.textureBytes,
+           trackedMemory.bufferBytes,
+           trackedMemory.numTextures,
+           trackedMemory.numBuffers,
+           deviceMemory.usedBytes,
+           deviceMemory.budgetBytes);
+  json += buffer;
+  return json;
+}
+
+SessionBenchmarkResult runSessionBenchmark(Platform& platform,
+                                           RenderSession& session,
+                                           const SurfaceTextures& surfaceTextures,
+                                           std::string sessionName,
+                                           const SessionBenchmarkConfig& config) {
+  IDevice& device = platform.getDevice();
+
+  SessionBenchmarkResult result;
+  result.sessionName = std::move(sessionName);
+  result.backend = BackendTypeToString(device.getBackendType());
+  result.numFrames = config.numFrames;
+
+  auto memoryTracker = std::dynamic_pointer_cast<MemoryTracker>(device.getResourceTracker());
+  if (!device.getResourceTracker()) {
+    memoryTracker = std::make_shared<MemoryTracker>();
+    device.setResourceTracker(memoryTracker);
+  }
+
+  ShellParams shellParams;
+  session.setShellParams(shellParams);
+
+  auto start = Clock::now();
+  session.initialize();
+  result.initializeMs = elapsedMs(start);
+
+  for (size_t i = 0; i != config.numWarmupFrames; i++) {
+    session.update(surfaceTextures);
+  }
+
+  GpuTimer gpuTimer(device, config.numFrames);
+  std::vector<double> cpuTimesMs;
+  cpuTimesMs.reserve(config.numFrames);
+  const uint64_t firstFrameIndex = device.getFrameStatistics().frameIndex;
+
+  const bool auditAllocations = allocation_audit::isAvailable();
+  if (auditAllocations) {
+    allocation_audit::begin();
+  }
+  for (size_t i = 0; i != config.numFrames; i++) {
+    gpuTimer.write(static_cast<uint32_t>(2 * i));
+    start = Clock::now();
+    session.update(surfaceTextures);
+    cpuTimesMs.push_back(elapsedMs(start));
+    gpuTimer.write(static_cast<uint32_t>(2 * i + 1));
+  }
+  if (auditAllocations) {
+    result.allocations = static_cast<int64_t>(allocation_audit::end());
+  }
+  result.updateMs = computeTimings(std::move(cpuTimesMs));
+
+  std::vector<double> gpuTimesMs;
+  result.hasGpuTime = gpuTimer.getFrameTimes(config.numFrames, gpuTimesMs);
+  result.gpuMs = computeTimings(std::move(gpuTimesMs));
+
+  // the history only holds the last FrameStatisticsTracker::kHistorySize frames
+  for (const FrameStatistics& frame : device.getFrameStatisticsHistory()) {
+    if (frame.frameIndex >= firstFrameIndex) {
+      accumulate(result.frameStatistics, frame);
+    }
+  }
+  if (memoryTracker) {
+    result.trackedMemory = memoryTracker->getTotal();
+  }
+  device.getDeviceMemoryUsage(result.deviceMemory);
+
+  start = Clock::now();
+  session.dispose();
+  result.disposeMs = elapsedMs(start);
+  return result;
+}
+
+std::string sessionBenchmarksToJson(const std::vector<SessionBenchmarkResult>& results) {
+  std::string json = "[";
+  for (size_t i = 0; i != results.size(); i++) {
+    json += i ? ",\n  " : "\n  ";
+    json += results[i].toJson();
+  }
+  json += "\n]\n";
+  return json;
+}
+
+} // namespace igl::shell
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/FrameStatistics.h>
+#include <igl/MemoryTracker.h>
+#include <shell/shared/platform/Platform.h>
+#include <shell/shared/renderSession/RenderSession.h>
+#include <string>
+#include <vector>
+
+namespace igl::shell {
+
+struct SessionBenchmarkConfig {
+  size_t numWarmupFrames = 16;
+  size_t numFrames = 128;
+  /// Size of the offscreen surface created by TestShellBase::benchmark()
+  uint32_t width = 1280;
+  uint32_t height = 720;
+};
+
+/// CPU times are in milliseconds. GPU times are measured with timestamps written before and after
+/// each update(); they cover the session's work only when its queue shares one hardware queue with
+/// the device's other queues (Vulkan, OpenGL).
+struct SessionBenchmarkResult {
+  struct Timings {
+    double mean = 0.0;
+    double min = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    double max = 0.0;
+  };
+
+  std::string sessionName;
+  std::string backend;
+  size_t numFrames = 0;
+
+  double initializeMs = 0.0;
+  double disposeMs = 0.0;
+  Timings updateMs;
+  bool hasGpuTime = false;
+  Timings gpuMs;
+
+  /// Heap allocations inside IGL during the measured frames; -1 without IGL_ALLOCATION_AUDIT
+  int64_t allocations = -1;
+  /// Sum of the counters of the measured frames reported by the device
+  FrameStatistics frameStatistics;
+  /// Resources alive after the measured frames, as seen by a MemoryTracker
+  TrackedMemory trackedMemory;
+  /// Memory reported by the driver after the measured frames; zeros if it is not available
+  DeviceMemoryUsage deviceMemory;
+
+  [[nodiscard]] std::string toJson() const;
+};
+
+/// Runs `session` against `surfaceTextures`: initialize(), the warmup frames, the measured frames
+/// and dispose(). Installs a MemoryTracker on the device if it has no resource tracker.
+SessionBenchmarkResult runSessionBenchmark(Platform& platform,
+                                           RenderSession& session,
+                                           const SurfaceTextures& surfaceTextures,
+                                           std::string sessionName,
+                                           const SessionBenchmarkConfig& config);
+
+/// Formats `results` as a JSON array
+std::string sessionBenchmarksToJson(const std::vector<SessionBenchmarkResult>& results);
+
+} // namespace igl::shell
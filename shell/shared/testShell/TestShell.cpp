@@ -80,4 +80,44 @@ void TestShellBase::run(igl::shell::RenderSession& session, size_t numFrames) {
   session.dispose();
 }
 
+uint64_t TestShellBase::countSteadyStateAllocations(igl::shell::RenderSession& session,
+                                                    size_t numWarmupFrames,
+                                                    size_t numFrames,
+                                                    std::vector<igl::AllocationAuditSite>* outSites) {
+  ShellParams shellParams;
+  session.setShellParams(shellParams);
+  session.initialize();
+  for (size_t i = 0; i < numWarmupFrames; ++i) {
+    session.update({offscreenTexture_, offscreenDepthTexture_});
+  }
+  igl::allocation_audit::begin();
+  for (size_t i = 0; i < numFrames; ++i) {
+    session.update({offscreenTexture_, offscreenDepthTexture_});
+  }
+  const uint64_t numAllocations = igl::allocation_audit::end(outSites);
+  session.dispose();
+  return numAllocations;
+}
+
+SessionBenchmarkResult TestShellBase::benchmark(igl::shell::RenderSession& session,
+                                                std::string sessionName,
+                                                const SessionBenchmarkConfig& config) {
+  // the same surfaces as the other tests, at the size of the benchmark
+  igl::TextureDesc colorDesc = igl::TextureDesc::new2D(
+      offscreenTexture_->getFormat(),
+      config.width,
+      config.height,
+      igl::TextureDesc::TextureUsageBits::Sampled | igl::TextureDesc::TextureUsageBits::Attachment);
+  igl::TextureDesc depthDesc = colorDesc;
+  depthDesc.format = offscreenDepthTexture_->getFormat();
+  depthDesc.storage = igl::ResourceStorage::Private;
+  igl::SurfaceTextures surfaceTextures = {
+      platform_->getDevice().createTexture(colorDesc, nullptr),
+      platform_->getDevice().createTexture(depthDesc, nullptr),
+  };
+  IGL_ASSERT(surfaceTextures.color && surfaceTextures.depth);
+  return runSessionBenchmark(
+      *platform_, session, surfaceTextures, std::move(sessionName), config);
+}
+
 } // namespace igl::shell
@@ -6,11 +6,15 @@
  */
 
 #include <gtest/gtest.h>
+#include <igl/AllocationAudit.h>
 #include <igl/IGL.h>
 #include <iglu/device/MetalFactory.h>
 #include <iglu/device/OpenGLFactory.h>
 #include <memory>
 #include <shell/shared/renderSession/RenderSession.h>
+#include <shell/shared/testShell/SessionBenchmark.h>
+#include <string>
+#include <vector>
 #define OFFSCREEN_RT_WIDTH 1
 #define OFFSCREEN_RT_HEIGHT 1
 
@@ -27,6 +31,18 @@ class TestShellBase {
 
   void run(igl::shell::RenderSession& session, size_t numFrames);
 
+  // Renders `numWarmupFrames` frames, then returns the number of heap allocations made inside IGL
+  // on this thread during the next `numFrames` frames (see igl/AllocationAudit.h).
+  uint64_t countSteadyStateAllocations(igl::shell::RenderSession& session,
+                                       size_t numWarmupFrames,
+                                       size_t numFrames,
+                                       std::vector<igl::AllocationAuditSite>* outSites = nullptr);
+
+  // Renders `session` to the offscreen textures and measures its frames (see SessionBenchmark.h).
+  SessionBenchmarkResult benchmark(igl::shell::RenderSession& session,
+                                   std::string sessionName,
+                                   const SessionBenchmarkConfig& config);
+
   std::shared_ptr<igl::shell::Platform> platform_;
   std::shared_ptr<igl::ITexture> offscreenTexture_;
   std::shared_ptr<igl::ITexture> offscreenDepthTexture_;
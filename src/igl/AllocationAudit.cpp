@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/AllocationAudit.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// trivially constructible, so the hook below can touch it at any time without allocating
+struct ThreadState {
+  bool counting;
+  const char* zone;
+  uint64_t total;
+  size_t numSites;
+  igl::AllocationAuditSite sites[igl::allocation_audit::kMaxSites];
+};
+
+thread_local ThreadState tlsState;
+
+constexpr const char* kOtherZones = "<other zones>";
+
+#if IGL_ALLOCATION_AUDIT
+void onAllocation() noexcept {
+  ThreadState& state = tlsState;
+  if (!state.counting || !state.zone) {
+    return;
+  }
+  state.total++;
+  for (size_t i = 0; i != state.numSites; i++) {
+    if (state.sites[i].name == state.zone) {
+      state.sites[i].count++;
+      return;
+    }
+  }
+  // the last slot collects everything which does not fit
+  const bool isFull = state.numSites == igl::allocation_audit::kMaxSites - 1;
+  igl::AllocationAuditSite& site = state.sites[state.numSites];
+  if (isFull && site.name != kOtherZones) {
+    site.name = kOtherZones;
+  } else if (!isFull) {
+    site.name = state.zone;
+    state.numSites++;
+  }
+  site.count++;
+}
+
+void* allocate(std::size_t size) {
+  onAllocation();
+  if (void* ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+#if defined(__cpp_exceptions)
+  throw std::bad_alloc();
+#else
+  std::abort();
+#endif
+}
+#endif // IGL_ALLOCATION_AUDIT
+
+} // namespace
+
+#if IGL_ALLOCATION_AUDIT
+// The aligned overloads are not replaced: the default ones do not go through these.
+void* operator new(std::size_t size) {
+  return allocate(size);
+}
+void* operator new[](std::size_t size) {
+  return allocate(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t& /*tag*/) noexcept {
+  onAllocation();
+  return std::malloc(size ? size : 1);
+}
+void* operator new[](std::size_t size, const std::nothrow_t& /*tag*/) noexcept {
+  onAllocation();
+  return std::malloc(size ? size : 1);
+}
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t& /*tag*/) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t& /*tag*/) noexcept {
+  std::free(ptr);
+}
+#endif // IGL_ALLOCATION_AUDIT
+
+namespace igl {
+
+AllocationAuditZone::AllocationAuditZone(const char* name) noexcept : prevName_(tlsState.zone) {
+  tlsState.zone = name;
+}
+
+AllocationAuditZone::~AllocationAuditZone() {
+  tlsState.zone = prevName_;
+}
+
+namespace allocation_audit {
+
+bool isAvailable() {
+  return IGL_ALLOCATION_AUDIT != 0;
+}
+
+void begin() {
+  ThreadState& state = tlsState;
+  state.total = 0;
+  state.numSites = 0;
+  state.sites[kMaxSites - 1] = {};
+  state.counting = true;
+}
+
+uint64_t end(std::vector<AllocationAuditSite>* outSites) {
+  ThreadState& state = tlsState;
+  state.counting = false;
+
+  if (outSites) {
+    outSites->assign(state.sites, state.sites + state.numSites);
+    if (state.sites[kMaxSites - 1].count) {
+      outSites->push_back(state.sites[kMaxSites - 1]);
+    }
+    std::sort(outSites->begin(),
+              outSites->end(),
+              [](const AllocationAuditSite& a, const AllocationAuditSite& b) {
+                return a.count > b.count;
+              });
+  }
+
+  return state.total;
+}
+
+} // namespace allocation_audit
+
+} // namespace igl
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Build with IGL_ALLOCATION_AUDIT=1 (CMake option IGL_ALLOCATION_AUDIT) to count heap allocations
+// made inside IGL. This replaces the global operator new, so it is meant for test builds only.
+#if !defined(IGL_ALLOCATION_AUDIT)
+#define IGL_ALLOCATION_AUDIT 0
+#endif
+
+namespace igl {
+
+/// Allocations attributed to one IGL profiler zone
+struct AllocationAuditSite {
+  const char* name = nullptr;
+  uint64_t count = 0;
+};
+
+/**
+ * @brief Marks a scope as IGL code for the allocation audit. IGL_PROFILER_FUNCTION() and
+ * IGL_PROFILER_ZONE() open one of these when IGL_ALLOCATION_AUDIT is enabled.
+ *
+ * Allocations on the current thread are counted only inside such zones, and are attributed to the
+ * innermost one. `name` must outlive the audit (function names and string literals do).
+ */
+class AllocationAuditZone final {
+ public:
+  explicit AllocationAuditZone(const char* name) noexcept;
+  ~AllocationAuditZone();
+
+  AllocationAuditZone(const AllocationAuditZone&) = delete;
+  AllocationAuditZone& operator=(const AllocationAuditZone&) = delete;
+
+ private:
+  const char* prevName_;
+};
+
+namespace allocation_audit {
+
+/// Maximum number of distinct zones tracked; allocations in further zones go to "<other zones>"
+constexpr size_t kMaxSites = 64;
+
+/// True if IGL was built with IGL_ALLOCATION_AUDIT
+bool isAvailable();
+
+/// Clears the counters and starts counting allocations inside IGL on the calling thread
+void begin();
+
+/// Stops counting on the calling thread and returns the number of allocations since begin().
+/// The counts per zone are returned in `outSites`, if provided, the largest first.
+uint64_t end(std::vector<AllocationAuditSite>* outSites = nullptr);
+
+} // namespace allocation_audit
+
+} // namespace igl
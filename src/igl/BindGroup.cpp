@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/BindGroup.h>
+
+#include <igl/Buffer.h>
+
+namespace igl {
+
+static_assert(IGL_TEXTURE_SAMPLERS_MAX <= 32 && IGL_UNIFORM_BLOCKS_BINDING_MAX <= 32,
+              "The slot masks of IBindGroup hold 32 slots");
+
+IBindGroup::IBindGroup(BindGroupDesc desc) : desc_(std::move(desc)) {
+  for (uint32_t i = 0; i != IGL_TEXTURE_SAMPLERS_MAX; i++) {
+    if (desc_.textures[i]) {
+      textureMask_ |= 1u << i;
+    }
+  }
+  for (uint32_t i = 0; i != IGL_UNIFORM_BLOCKS_BINDING_MAX; i++) {
+    if (desc_.buffers[i]) {
+      bufferMask_ |= 1u << i;
+    }
+  }
+}
+
+Result IBindGroup::validate(const BindGroupDesc& desc) {
+  for (size_t i = 0; i != IGL_TEXTURE_SAMPLERS_MAX; i++) {
+    if (desc.textures[i] && !desc.samplers[i]) {
+      return Result(Result::Code::ArgumentInvalid,
+                    "Bind group texture " + std::to_string(i) + " has no sampler");
+    }
+  }
+  for (size_t i = 0; i != IGL_UNIFORM_BLOCKS_BINDING_MAX; i++) {
+    if (desc.buffers[i] && desc.bufferOffsets[i] >= desc.buffers[i]->getSizeInBytes()) {
+      return Result(Result::Code::ArgumentOutOfRange,
+                    "Bind group buffer " + std::to_string(i) + " offset is out of bounds");
+    }
+  }
+  return Result();
+}
+
+} // namespace igl
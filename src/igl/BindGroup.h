@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <igl/Common.h>
+#include <igl/RenderCommandEncoder.h>
+#include <memory>
+#include <string>
+
+namespace igl {
+
+/**
+ * @brief Describes the resources of a bind group.
+ *
+ * textures      : Textures bound to the texture slots of the same index; a slot can be empty.
+ * samplers      : Samplers bound to the sampler slots of the same index; every texture needs one.
+ * buffers       : Uniform or storage buffers bound to the buffer slots of the same index.
+ * bufferOffsets : Offsets into `buffers` where the data starts.
+ * target        : The igl::BindTarget stages the resources are bound to. Ignored by the backends
+ *                 whose slots are shared by all the stages.
+ * debugName     : Name of the bind group shown in debugging tools.
+ */
+struct BindGroupDesc {
+  std::array<std::shared_ptr<ITexture>, IGL_TEXTURE_SAMPLERS_MAX> textures;
+  std::array<std::shared_ptr<ISamplerState>, IGL_TEXTURE_SAMPLERS_MAX> samplers;
+  std::array<std::shared_ptr<IBuffer>, IGL_UNIFORM_BLOCKS_BINDING_MAX> buffers;
+  std::array<size_t, IGL_UNIFORM_BLOCKS_BINDING_MAX> bufferOffsets = {};
+  uint8_t target = BindTarget::kAllGraphics;
+  std::string debugName;
+};
+
+/**
+ * @brief An immutable set of textures, samplers and buffers, created once with
+ * IDevice::createBindGroup() and bound with a single IRenderCommandEncoder::bindBindGroup() call.
+ *
+ * Bind groups suit the resources which do not change between draws, such as those of static
+ * materials. The Vulkan backend writes the textures and samplers into a persistent descriptor set
+ * once, instead of writing a transient descriptor set whenever a texture binding changes; the
+ * other backends bind the occupied slots only, from lists computed when the group is created.
+ * The bind group retains its resources. Slots bound individually after a bind group replace its
+ * resources until the next bindBindGroup().
+ */
+class IBindGroup {
+ public:
+  virtual ~IBindGroup() = default;
+
+  [[nodiscard]] const BindGroupDesc& getDesc() const {
+    return desc_;
+  }
+  /// Bit i is set if the texture slot i holds a texture
+  [[nodiscard]] uint32_t getTextureMask() const {
+    return textureMask_;
+  }
+  /// Bit i is set if the buffer slot i holds a buffer
+  [[nodiscard]] uint32_t getBufferMask() const {
+    return bufferMask_;
+  }
+
+  /// Returns an error if `desc` has a texture without a sampler or a buffer offset out of bounds.
+  [[nodiscard]] static Result validate(const BindGroupDesc& desc);
+
+ protected:
+  explicit IBindGroup(BindGroupDesc desc);
+
+ private:
+  BindGroupDesc desc_;
+  uint32_t textureMask_ = 0;
+  uint32_t bufferMask_ = 0;
+};
+
+} // namespace igl
@@ -10,6 +10,8 @@
 #include <array>
 #include <igl/Common.h>
 #include <igl/ITrackedResource.h>
+#include <igl/Readback.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -17,6 +19,7 @@ namespace igl {
 
 // class forward declaration
 class ICommandBuffer;
+class ICommandQueue;
 
 enum class IndexFormat : uint8_t {
   UInt16,
@@ -57,7 +60,7 @@ struct BufferDesc {
     UniformBlock = 1 << 1, // Enforces UBO for OpenGL
     Query = 1 << 2,
     Bone = 1 << 3,
-    Ring = 1 << 4, // Metal: Ring buffers with memory for each swapchain image
+    Ring = 1 << 4, // Metal/OpenGL: Ring buffers with memory for each frame in flight
     NoCopy = 1 << 5, // Metal: The buffer should re-use previously allocated memory.
   };
 
@@ -87,6 +90,12 @@ struct BufferDesc {
   /** @brief Identifier used for debugging */
   std::string debugName;
 
+  /**
+   * @brief Vulkan only. Priority of the memory in [0, 1], used by the driver to decide what stays
+   * in device-local memory when it is oversubscribed (requires VK_EXT_memory_priority).
+   */
+  float memoryPriority = 0.5f;
+
   BufferDesc(BufferType type = 0,
              const void* IGL_NULLABLE data = nullptr,
              size_t length = 0,
@@ -171,6 +180,24 @@ class IBuffer : public ITrackedResource<IBuffer> {
    */
   virtual uint64_t gpuAddress(size_t offset = 0) const = 0;
 
+  /**
+   * @brief Copies a range of the buffer into host-visible memory without waiting for the GPU.
+   * The copy runs after all the work submitted to `cmdQueue` so far; see IReadback.
+   *
+   * @param cmdQueue The queue the buffer is written by
+   * @param range offset (in IBuffer) and size
+   * @param outResult result of the operation, Result::Code::Unsupported if the backend has no
+   * asynchronous readbacks
+   * @return the pending readback or nullptr
+   */
+  virtual std::shared_ptr<IReadback> readAsync(ICommandQueue& /*cmdQueue*/,
+                                               const BufferRange& /*range*/,
+                                               Result* IGL_NULLABLE outResult) {
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "Asynchronous readbacks are not supported");
+    return nullptr;
+  }
+
  protected:
   IBuffer() = default;
 };
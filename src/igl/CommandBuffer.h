@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <functional>
 #include <igl/Buffer.h>
 #include <igl/Common.h>
 #include <igl/Framebuffer.h>
@@ -17,7 +18,9 @@ namespace igl {
 class IComputeCommandEncoder;
 class ISamplerState;
 class ITexture;
+class ITimestampQueryPool;
 struct RenderPassDesc;
+struct TextureRangeDesc;
 
 /**
  * Currently a no-op structure.
@@ -70,6 +73,20 @@ class ICommandBuffer {
     return createRenderCommandEncoder(renderPass, std::move(framebuffer), nullptr);
   }
 
+  /**
+   * @brief Create a ParallelRenderCommandEncoder for encoding one render pass into this
+   * CommandBuffer from several threads simultaneously.
+   * @returns a pointer to the ParallelRenderCommandEncoder or nullptr if the backend does not
+   * support parallel encoding
+   */
+  virtual std::unique_ptr<IParallelRenderCommandEncoder> createParallelRenderCommandEncoder(
+      const RenderPassDesc& /*renderPass*/,
+      std::shared_ptr<IFramebuffer> /*framebuffer*/,
+      Result* IGL_NULLABLE outResult) {
+    Result::setResult(outResult, Result::Code::Unsupported);
+    return nullptr;
+  }
+
   /**
    * @brief Create a ComputeCommandEncoder for encoding compute commands into this CommandBuffer.
    * @returns a pointer to the ComputeCommandEncoder
@@ -97,6 +114,22 @@ class ICommandBuffer {
    */
   virtual void waitUntilCompleted() = 0;
 
+  /**
+   * @brief Registers `handler` to be called once the commands encoded in this CommandBuffer have
+   * been executed on the GPU. Must be called before the CommandBuffer is submitted.
+   *
+   * Handlers never block the calling thread, and run on an unspecified thread: Metal calls them
+   * from its completion thread, while Vulkan and OpenGL call them during a later submit once the
+   * completion has been observed.
+   */
+  virtual void addCompletedHandler(std::function<void()> handler) = 0;
+
+  /**
+   * @brief Returns true once the commands encoded in this submitted CommandBuffer have been
+   * executed on the GPU. Never blocks.
+   */
+  [[nodiscard]] virtual bool isCompleted() const = 0;
+
   /**
    * @brief Pushes a debug label onto a stack of debug string labels into the captured frame data.
    *
@@ -116,6 +149,33 @@ class ICommandBuffer {
    */
   virtual void popDebugGroupLabel() const = 0;
 
+  /**
+   * @brief Writes the GPU time at which all previously encoded commands have completed to
+   * `queryIndex` of `pool`. Must be called between encoders, not while one is encoding. The result
+   * can be read with ITimestampQueryPool::getResults() once the GPU has executed this point.
+   *
+   * Requires DeviceFeatures::TimestampQueries.
+   */
+  virtual void writeTimestamp(ITimestampQueryPool& /*pool*/, uint32_t /*queryIndex*/) {
+    IGL_ASSERT_NOT_IMPLEMENTED();
+  }
+
+  /**
+   * @brief Copies `range` of `texture` from `buffer`, starting at `bufferOffset`. The data has
+   * tightly packed rows, which are rows of blocks for compressed formats, and the layers or slices
+   * of the range follow each other. Must be called between encoders, not while one is encoding.
+   * The copy sees the writes of the compute dispatches encoded before it, so a compute shader can
+   * produce texels, e.g. compressed blocks, which no storage texture could hold.
+   *
+   * Supports one mip level of 2D, 2D array and 3D textures which are not depth or stencil.
+   */
+  virtual void copyBufferToTexture(IBuffer& /*buffer*/,
+                                   size_t /*bufferOffset*/,
+                                   ITexture& /*texture*/,
+                                   const TextureRangeDesc& /*range*/) {
+    IGL_ASSERT_NOT_IMPLEMENTED();
+  }
+
   /**
    * @returns the number of draw operations tracked by this CommandBuffer. This is tracked manually
    * via calls to incrementCurrentDrawCount().
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <igl/Common.h>
+#include <igl/Fence.h>
 
 namespace igl {
 
@@ -62,6 +63,30 @@ class ICommandQueue {
   virtual std::shared_ptr<ICommandBuffer> createCommandBuffer(const CommandBufferDesc& desc,
                                                               Result* IGL_NULLABLE outResult) = 0;
   virtual SubmitHandle submit(const ICommandBuffer& commandBuffer, bool endOfFrame = false) = 0;
+
+  /**
+   * @brief Returns a fence which is signaled once all the command buffers submitted so far are
+   * finished, e.g. to hand a buffer to a compositor without blocking the CPU.
+   */
+  virtual std::shared_ptr<IFence> signalFence(Result* IGL_NULLABLE outResult) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Fences are not supported");
+    return nullptr;
+  }
+  /**
+   * @brief Makes the GPU wait for `fence` before executing the command buffers submitted next.
+   */
+  virtual Result waitFence(const IFence& /*fence*/) {
+    return Result(Result::Code::Unsupported, "Fences are not supported");
+  }
+  /**
+   * @brief Wraps a fence signaled outside IGL, e.g. by a video decoder or another process.
+   */
+  virtual std::shared_ptr<IFence> importFence(const FenceNativeHandle& /*handle*/,
+                                              Result* IGL_NULLABLE outResult) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Fences are not supported");
+    return nullptr;
+  }
+
   uint32_t getLastFrameDrawCount() const {
     return statistics.lastFrameDrawCount;
   }
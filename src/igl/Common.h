@@ -235,6 +235,22 @@ constexpr typename std::underlying_type<E>::type EnumToValue(E enumerator) noexc
   return static_cast<typename std::underlying_type<E>::type>(enumerator);
 }
 
+///--------------------------------------
+/// MARK: - Hash utilities
+
+/// A 64-bit finalizer (splitmix64): every input bit affects every output bit
+constexpr uint64_t hashMix(uint64_t value) noexcept {
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+  return value ^ (value >> 31);
+}
+
+/// Mixes `value` into `seed`. Unlike XOR-ing hashes together, the result depends on the order of
+/// the values, and equal values do not cancel out.
+inline void hashCombine(size_t& seed, size_t value) noexcept {
+  seed = static_cast<size_t>(hashMix(uint64_t(seed) + 0x9e3779b97f4a7c15ull + uint64_t(value)));
+}
+
 ///--------------------------------------
 /// MARK: - ScopeGuard
 
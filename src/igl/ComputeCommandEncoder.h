@@ -87,6 +87,15 @@ class IComputeCommandEncoder : public ICommandEncoder {
    * @param offset An offset bytes into the push constants buffer.
    */
   virtual void bindPushConstants(const void* data, size_t length, size_t offset = 0) = 0;
+  /**
+   * @brief Writes the GPU address of a buffer into the push constants, so the compute function can
+   * access the buffer without binding it. Requires DeviceFeatures::BufferDeviceAddress.
+   *
+   * @param offset An offset in bytes into the push constants buffer; a multiple of 8.
+   * @param buffer The buffer whose address (IBuffer::gpuAddress()) is written as a uint64_t.
+   * @param bufferOffset Where the data begins in bytes from the start of the buffer.
+   */
+  virtual void bindBufferAddress(size_t offset, IBuffer& buffer, size_t bufferOffset) = 0;
   /**
    * @brief Sets the compute pipeline state object.
    *
@@ -107,6 +116,32 @@ class IComputeCommandEncoder : public ICommandEncoder {
    */
   virtual void dispatchThreadGroups(const Dimensions& threadgroupCount,
                                     const Dimensions& threadgroupSize) = 0;
+  /**
+   * @brief Encodes a compute command whose number of thread groups is read from a buffer when the
+   * command executes, so it can be computed by previous commands on the GPU. The buffer holds
+   * three uint32_t values: the number of thread groups in the grid in each dimension. Behaves like
+   * dispatchThreadGroups() otherwise.
+   *
+   * @param indirectBuffer A buffer created with BufferDesc::BufferTypeBits::Indirect.
+   * @param indirectBufferOffset Where the thread group counts begin in bytes from the start of the
+   * buffer; a multiple of 4.
+   * @param threadgroupSize The number of threads in one threadgroup, in each dimension.
+   */
+  virtual void dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                            size_t indirectBufferOffset,
+                                            const Dimensions& threadgroupSize) = 0;
+  /**
+   * @brief Starts a group of independent dispatches: no dispatch of the group accesses memory
+   * written by another dispatch of the same group. Backends which synchronize dispatches with
+   * barriers skip the barriers between them, so the dispatches can overlap on the GPU. The group
+   * still waits for the dispatches encoded before it, and the dispatches encoded after
+   * endDispatchGroup() wait for the group. Groups cannot be nested.
+   */
+  virtual void beginDispatchGroup() {}
+  /**
+   * @brief Ends the group of dispatches started by beginDispatchGroup().
+   */
+  virtual void endDispatchGroup() {}
 };
 
 } // namespace igl
@@ -28,7 +28,8 @@ struct ComputePipelineDesc {
  public:
   bool operator==(const ComputePipelineDesc& other) const {
     return shaderStages == other.shaderStages && imagesMap == other.imagesMap &&
-           buffersMap == other.buffersMap && debugName == other.debugName;
+           buffersMap == other.buffersMap && requiredSubgroupSize == other.requiredSubgroupSize &&
+           requireFullSubgroups == other.requireFullSubgroups && debugName == other.debugName;
   }
 
   /*
@@ -42,6 +43,19 @@ struct ComputePipelineDesc {
    */
   std::shared_ptr<IShaderStages> shaderStages;
 
+  /*
+   * @brief The number of invocations of each subgroup of the kernel: a power of two in
+   * [DeviceFeatureLimits::MinSubgroupSize, DeviceFeatureLimits::MaxSubgroupSize]. 0 lets the device
+   * pick it. Requires DeviceFeatures::SubgroupSizeControl.
+   */
+  uint32_t requiredSubgroupSize = 0;
+  /*
+   * @brief All the subgroups of the workgroups are full, which requires a workgroup size in X that
+   * is a multiple of the subgroup size. Vulkan requires DeviceFeatures::SubgroupSizeControl; Metal
+   * takes it as a promise about the threadgroup sizes of the dispatches, which it optimizes for.
+   */
+  bool requireFullSubgroups = false;
+
   std::string debugName;
 };
 
@@ -71,6 +85,8 @@ struct hash<igl::ComputePipelineDesc> {
   size_t operator()(const igl::ComputePipelineDesc& desc) const {
     size_t hash = std::hash<uintptr_t>()(reinterpret_cast<uintptr_t>(desc.shaderStages.get()));
     hash ^= std::hash<std::string>()(desc.debugName);
+    hash ^= std::hash<uint32_t>()(desc.requiredSubgroupSize);
+    hash ^= std::hash<bool>()(desc.requireFullSubgroups);
     for (const auto& p : desc.buffersMap) {
       hash ^= std::hash<size_t>()(p.first);
       hash ^= std::hash<std::string>()(p.second.toString());
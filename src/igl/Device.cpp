@@ -5,7 +5,11 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <igl/BindGroup.h>
+#include <igl/ComputePipelineState.h>
 #include <igl/Device.h>
+#include <igl/RenderBundle.h>
+#include <igl/RenderPipelineState.h>
 #include <igl/Shader.h>
 
 #include <algorithm>
@@ -27,6 +31,112 @@ bool IDevice::verifyScope() {
 
 void IDevice::updateSurface(void* nativeWindowType) {}
 
+Result IDevice::uploadTextureRegions(const std::vector<TextureUpload>& uploads) const {
+  Result firstFailure;
+  for (const auto& upload : uploads) {
+    if (!IGL_VERIFY(upload.texture)) {
+      if (firstFailure.isOk()) {
+        firstFailure = Result(Result::Code::ArgumentNull, "Texture is null");
+      }
+      continue;
+    }
+    const auto result = upload.texture->upload(
+        upload.region.range, upload.region.data, upload.region.bytesPerRow);
+    if (!result.isOk() && firstFailure.isOk()) {
+      firstFailure = result;
+    }
+  }
+  return firstFailure;
+}
+
+std::vector<std::shared_ptr<IRenderPipelineState>> IDevice::createRenderPipelines(
+    const std::vector<RenderPipelineDesc>& descs,
+    Result* outResult) const {
+  std::vector<std::shared_ptr<IRenderPipelineState>> pipelines(descs.size());
+  std::vector<Result> results(descs.size());
+  for (size_t i = 0; i != descs.size(); i++) {
+    pipelines[i] = createRenderPipeline(descs[i], &results[i]);
+  }
+  setFirstFailure(outResult, results);
+  return pipelines;
+}
+
+std::future<PipelineCreationResult<IRenderPipelineState>> IDevice::createRenderPipelineAsync(
+    const RenderPipelineDesc& desc) const {
+  std::promise<PipelineCreationResult<IRenderPipelineState>> promise;
+  PipelineCreationResult<IRenderPipelineState> creation;
+  creation.pipeline = createRenderPipeline(desc, &creation.result);
+  promise.set_value(std::move(creation));
+  return promise.get_future();
+}
+
+std::future<PipelineCreationResult<IComputePipelineState>> IDevice::createComputePipelineAsync(
+    const ComputePipelineDesc& desc) const {
+  std::promise<PipelineCreationResult<IComputePipelineState>> promise;
+  PipelineCreationResult<IComputePipelineState> creation;
+  creation.pipeline = createComputePipeline(desc, &creation.result);
+  promise.set_value(std::move(creation));
+  return promise.get_future();
+}
+
+std::vector<std::shared_ptr<IShaderModule>> IDevice::createShaderModules(
+    const std::vector<ShaderModuleDesc>& descs,
+    Result* outResult) const {
+  std::vector<std::shared_ptr<IShaderModule>> modules(descs.size());
+  std::vector<Result> results(descs.size());
+  for (size_t i = 0; i != descs.size(); i++) {
+    modules[i] = createShaderModule(descs[i], &results[i]);
+  }
+  setFirstFailure(outResult, results);
+  return modules;
+}
+
+namespace {
+class BindGroup final : public IBindGroup {
+ public:
+  explicit BindGroup(const BindGroupDesc& desc) : IBindGroup(desc) {}
+};
+
+class RenderBundle final : public IRenderBundle {
+ public:
+  explicit RenderBundle(const RenderBundleDesc& desc) : IRenderBundle(desc) {}
+};
+} // namespace
+
+std::shared_ptr<IBindGroup> IDevice::createBindGroup(const BindGroupDesc& desc,
+                                                     Result* outResult) const {
+  Result result = IBindGroup::validate(desc);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  Result::setOk(outResult);
+  return std::make_shared<BindGroup>(desc);
+}
+
+std::shared_ptr<ITexture> IDevice::createTextureView(const ITexture& /*texture*/,
+                                                     const TextureViewDesc& /*desc*/,
+                                                     Result* outResult) const {
+  Result::setResult(outResult, Result::Code::Unsupported, "Texture views are not supported");
+  return nullptr;
+}
+
+std::shared_ptr<IRenderBundle> IDevice::createRenderBundle(const RenderBundleDesc& desc,
+                                                           Result* outResult) const {
+  Result::setOk(outResult);
+  return std::make_shared<RenderBundle>(desc);
+}
+
+void IDevice::setFirstFailure(Result* outResult, const std::vector<Result>& results) {
+  const auto it =
+      std::find_if(results.begin(), results.end(), [](const Result& r) { return !r.isOk(); });
+  if (it != results.end()) {
+    Result::setResult(outResult, *it);
+  } else {
+    Result::setOk(outResult);
+  }
+}
+
 TextureDesc IDevice::sanitize(const TextureDesc& desc) const {
   TextureDesc sanitized = desc;
   if (desc.width == 0 || desc.height == 0 || desc.depth == 0 || desc.numLayers == 0 ||
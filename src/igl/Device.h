@@ -9,26 +9,34 @@
 
 #include <igl/Common.h>
 #include <igl/DeviceFeatures.h>
+#include <igl/FrameStatistics.h>
 #include <igl/IResourceTracker.h>
 #include <igl/PlatformDevice.h>
 #include <igl/Texture.h>
+#include <future>
+#include <memory>
 #include <utility>
 #include <vector>
 
 namespace igl {
 
+struct BindGroupDesc;
 struct BufferDesc;
 struct CommandQueueDesc;
 struct ComputePipelineDesc;
 struct DepthStencilStateDesc;
 struct FramebufferDesc;
+struct OcclusionQueryPoolDesc;
+struct RenderBundleDesc;
 struct RenderPipelineDesc;
 struct SamplerStateDesc;
 struct ShaderLibraryDesc;
 struct ShaderModuleDesc;
 struct ShaderStagesDesc;
 struct TextureDesc;
+struct TimestampQueryPoolDesc;
 struct VertexInputStateDesc;
+class IBindGroup;
 class IBuffer;
 class ICommandQueue;
 class ICommandBuffer;
@@ -36,14 +44,41 @@ class IComputePipelineState;
 class IDepthStencilState;
 class IDevice;
 class IFramebuffer;
+class IOcclusionQueryPool;
+class IRenderBundle;
 class IRenderPipelineState;
 class ISamplerState;
 class IShaderLibrary;
 class IShaderModule;
 class IShaderStages;
 class ITexture;
+class ITimestampQueryPool;
 class IVertexInputState;
 
+/**
+ * @brief The outcome of an asynchronous pipeline creation.
+ *
+ * pipeline : The created pipeline state, or nullptr on failure
+ * result   : The result of the creation
+ */
+template<typename T>
+struct PipelineCreationResult {
+  std::shared_ptr<T> pipeline;
+  Result result;
+};
+
+/**
+ * @brief GPU memory used by the process as reported by the driver, and how much it can use before
+ * allocations start failing or the process risks being killed.
+ *
+ * usedBytes   : Bytes allocated from device-local memory, including memory IGL did not allocate
+ * budgetBytes : Bytes the process can allocate in total, 0 if unknown
+ */
+struct DeviceMemoryUsage {
+  size_t usedBytes = 0;
+  size_t budgetBytes = 0;
+};
+
 /**
  * @brief Interface to a GPU that is used to draw graphics or do parallel computation.
  */
@@ -109,6 +144,32 @@ class IDevice : public ICapabilities {
                                                   Result* IGL_NULLABLE
                                                       outResult) const noexcept = 0;
 
+  /**
+   * @brief Creates a view of a texture: a texture sharing the memory of `texture`, which covers a
+   * subset of its mip levels and layers, or reinterprets it with another type or format, without
+   * copying it. The view keeps the memory of `texture` alive. Requires
+   * DeviceFeatures::TextureViews; the default implementation returns Result::Code::Unsupported.
+   * @see igl::TextureViewDesc
+   * @param texture The texture to view, created by this device.
+   * @param desc Description of the view.
+   * @param outResult Pointer to where the result (success, failure, etc) is written. Can be null if
+   * no reporting is desired.
+   * @return Shared pointer to the created view.
+   */
+  virtual std::shared_ptr<ITexture> createTextureView(const ITexture& texture,
+                                                      const TextureViewDesc& desc,
+                                                      Result* IGL_NULLABLE outResult) const;
+
+  /**
+   * @brief Uploads regions of several textures at once, e.g. all the pages of an atlas which
+   * changed this frame. Backends with explicit staging record all of them into one submission.
+   * The default implementation uploads the regions one by one.
+   * @param uploads The textures and regions in upload order.
+   * @return The first failure, if any. A failed region does not prevent the other regions from
+   * being uploaded.
+   */
+  virtual Result uploadTextureRegions(const std::vector<TextureUpload>& uploads) const;
+
   /**
    * @brief Creates a vertex input state.
    * @see igl::VertexInputStateDesc
@@ -145,6 +206,41 @@ class IDevice : public ICapabilities {
                                                                      Result* IGL_NULLABLE
                                                                          outResult) const = 0;
 
+  /**
+   * @brief Creates several render pipeline states at once, concurrently where the backend allows
+   * it. The default implementation creates them one by one.
+   * @see igl::RenderPipelineDesc
+   * @param descs Descriptions for the desired resources.
+   * @param outResult Pointer to where the result is written: the result of the first pipeline which
+   * failed, if any. Can be null if no reporting is desired.
+   * @return The render pipeline states in the order of `descs`; nullptr for the failed ones.
+   */
+  virtual std::vector<std::shared_ptr<IRenderPipelineState>> createRenderPipelines(
+      const std::vector<RenderPipelineDesc>& descs,
+      Result* IGL_NULLABLE outResult) const;
+
+  /**
+   * @brief Starts creating a render pipeline state without blocking the calling thread where the
+   * backend allows it, so that many pipelines can be compiled at once, e.g. behind a loading
+   * screen. `desc` does not have to outlive the call, but the device has to outlive the creation.
+   * The default implementation creates the pipeline synchronously and returns a ready future.
+   * @see igl::RenderPipelineDesc
+   * @param desc Description for the desired resource.
+   * @return A future of the render pipeline state and of the result of its creation.
+   */
+  virtual std::future<PipelineCreationResult<IRenderPipelineState>> createRenderPipelineAsync(
+      const RenderPipelineDesc& desc) const;
+
+  /**
+   * @brief Starts creating a compute pipeline state without blocking the calling thread where the
+   * backend allows it. Same rules as createRenderPipelineAsync().
+   * @see igl::ComputePipelineDesc
+   * @param desc Description for the desired resource.
+   * @return A future of the compute pipeline state and of the result of its creation.
+   */
+  virtual std::future<PipelineCreationResult<IComputePipelineState>> createComputePipelineAsync(
+      const ComputePipelineDesc& desc) const;
+
   /**
    * @brief Creates a shader module from either source code or pre-compiled data.
    * @see igl::ShaderModuleDesc
@@ -157,6 +253,19 @@ class IDevice : public ICapabilities {
                                                             Result* IGL_NULLABLE
                                                                 outResult) const = 0;
 
+  /**
+   * @brief Creates several shader modules at once, compiling them concurrently where the backend
+   * allows it. The default implementation creates them one by one.
+   * @see igl::ShaderModuleDesc
+   * @param descs Descriptions for the desired resources.
+   * @param outResult Pointer to where the result is written: the result of the first module which
+   * failed, if any. Can be null if no reporting is desired.
+   * @return The shader modules in the order of `descs`; nullptr for the failed ones.
+   */
+  virtual std::vector<std::shared_ptr<IShaderModule>> createShaderModules(
+      const std::vector<ShaderModuleDesc>& descs,
+      Result* IGL_NULLABLE outResult) const;
+
   /**
    * @brief Creates a frame buffer object.
    * @see igl::FramebufferDesc
@@ -168,6 +277,63 @@ class IDevice : public ICapabilities {
   virtual std::shared_ptr<IFramebuffer> createFramebuffer(const FramebufferDesc& desc,
                                                           Result* IGL_NULLABLE outResult) = 0;
 
+  /**
+   * @brief Creates an immutable bind group of textures, samplers and buffers, bound with
+   * IRenderCommandEncoder::bindBindGroup(). The default implementation precomputes the occupied
+   * slots; backends with persistent descriptor objects override it.
+   * @see igl::BindGroupDesc
+   * @param desc Description for the desired resource.
+   * @param outResult Pointer to where the result (success, failure, etc) is written. Can be null if
+   * no reporting is desired.
+   * @return Shared pointer to the created bind group.
+   */
+  virtual std::shared_ptr<IBindGroup> createBindGroup(const BindGroupDesc& desc,
+                                                      Result* IGL_NULLABLE outResult) const;
+
+  /**
+   * @brief Creates an empty render bundle, recorded with
+   * IRenderBundle::createRenderCommandEncoder() and executed with
+   * IRenderCommandEncoder::executeRenderBundle(). The default implementation replays the recorded
+   * commands; backends with reusable command buffers override it.
+   * @see igl::RenderBundleDesc
+   * @param desc Description for the desired resource.
+   * @param outResult Pointer to where the result (success, failure, etc) is written. Can be null if
+   * no reporting is desired.
+   * @return Shared pointer to the created render bundle.
+   */
+  virtual std::shared_ptr<IRenderBundle> createRenderBundle(const RenderBundleDesc& desc,
+                                                            Result* IGL_NULLABLE outResult) const;
+
+  /**
+   * @brief Creates a pool of occlusion queries. Requires DeviceFeatures::OcclusionQueries.
+   * @see igl::OcclusionQueryPoolDesc
+   * @param desc Description for the desired resource.
+   * @param outResult Pointer to where the result (success, failure, etc) is written. Can be null if
+   * no reporting is desired.
+   * @return Shared pointer to the created pool or nullptr if occlusion queries are not supported.
+   */
+  virtual std::shared_ptr<IOcclusionQueryPool> createOcclusionQueryPool(
+      const OcclusionQueryPoolDesc& /*desc*/,
+      Result* IGL_NULLABLE outResult) const {
+    Result::setResult(outResult, Result::Code::Unsupported);
+    return nullptr;
+  }
+
+  /**
+   * @brief Creates a pool of GPU timestamp queries. Requires DeviceFeatures::TimestampQueries.
+   * @see igl::TimestampQueryPoolDesc
+   * @param desc Description for the desired resource.
+   * @param outResult Pointer to where the result (success, failure, etc) is written. Can be null if
+   * no reporting is desired.
+   * @return Shared pointer to the created pool or nullptr if timestamp queries are not supported.
+   */
+  virtual std::shared_ptr<ITimestampQueryPool> createTimestampQueryPool(
+      const TimestampQueryPoolDesc& /*desc*/,
+      Result* IGL_NULLABLE outResult) const {
+    Result::setResult(outResult, Result::Code::Unsupported);
+    return nullptr;
+  }
+
   /**
    * @brief Returns a platform-specific device. If the requested device type does not match that of
    * the actual underlying device, then null is returned.
@@ -237,6 +403,34 @@ class IDevice : public ICapabilities {
    */
   virtual size_t getCurrentDrawCount() const = 0;
 
+  /**
+   * @brief Returns the counters accumulated so far by the current frame.
+   * @see igl::FrameStatistics
+   * @return The statistics of the current frame, all zeros if the backend does not track them.
+   */
+  virtual FrameStatistics getFrameStatistics() const {
+    return {};
+  }
+
+  /**
+   * @brief Returns the statistics of up to FrameStatisticsTracker::kHistorySize completed frames,
+   * oldest first.
+   * @return The statistics of the last frames, empty if the backend does not track them.
+   */
+  virtual std::vector<FrameStatistics> getFrameStatisticsHistory() const {
+    return {};
+  }
+
+  /**
+   * @brief Queries the device memory used by the process and its budget from the driver.
+   * @see igl::DeviceMemoryUsage
+   * @param outUsage Receives the memory usage.
+   * @return False if the backend cannot query the driver.
+   */
+  virtual bool getDeviceMemoryUsage(DeviceMemoryUsage& /*outUsage*/) const {
+    return false;
+  }
+
   /**
    * @brief Creates a shader library with one or more shader modules.
    * @see igl::ShaderCompileDesc
@@ -272,6 +466,8 @@ class IDevice : public ICapabilities {
   virtual void beginScope();
   virtual void endScope();
   TextureDesc sanitize(const TextureDesc& desc) const;
+  // Sets `outResult` to the first failure in `results`, or to Ok
+  static void setFirstFailure(Result* IGL_NULLABLE outResult, const std::vector<Result>& results);
   IDevice() = default;
 
  public:
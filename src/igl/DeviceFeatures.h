@@ -27,25 +27,33 @@ namespace igl {
  * Compute                    Supports compute
  * DepthCompare               Supports setting depth compare function
  * DepthShaderRead            Supports reading depth texture from a shader
+ * DrawBaseInstance           Supports draws with a non-zero base instance
+ * DrawBaseVertex             Supports indexed draws with a non-zero base vertex
  * DrawIndexedIndirect        Supports IRenderCommandEncoder::drawIndexedIndirect
+ * DrawInstanced              Supports draws of more than one instance
  * ExplicitBinding,           Supports uniforms block explicit binding in shaders
  * ExplicitBindingExt,        Supports uniforms block explicit binding in shaders via an extension
  * ExternalMemoryObjects,     Supports accessing external memory objects, including by POSIX file descriptor
+ * FragmentDensityMap         Supports fragment density map attachments in framebuffers
  * MapBufferRange             Supports mapping buffer data into client address space
  * MinMaxBlend                Supports Min and Max blend operations
  * MultipleRenderTargets      Supports MRT - Multiple Render Targets
  * MultiSample                Supports multisample textures
  * MultiSampleResolve         Supports GPU multisampled texture resolve
  * Multiview                  Supports multiview
+ * OcclusionQueries           Supports occlusion queries, see IDevice::createOcclusionQueryPool
  * PushConstants              Supports push constants(Vulkan)
  * ReadWriteFramebuffer       Supports separate FB reading/writing binding
  * SamplerMinMaxLod           Supports constraining the min and max texture LOD when sampling
  * ShaderLibrary              Supports shader libraries
+ * ShaderSubgroups            Supports subgroup (SIMD-group) arithmetic functions in compute shaders
  * ShaderTextureLod           Supports explicit control of Lod in the shader
  * ShaderTextureLodExt        Supports explicit control of Lod in the shader via an extension
  * SRGB                       Supports sRGB Textures and FrameBuffer
  * StandardDerivative         Supports Standard Derivative function in shader
  * StandardDerivativeExt      Supports Standard Derivative function in shader via an extension
+ * SubgroupSizeControl        Supports ComputePipelineDesc::requiredSubgroupSize
+ * Subpasses                  Supports RenderPassDesc::subpasses and input attachments
  * Texture2DArray             Supports 2D array textures
  * Texture3D                  Supports 3D textures
  * TextureArrayExt            Supports array textures via an extension
@@ -58,6 +66,8 @@ namespace igl {
  * TextureHalfFloat           Supports half float texture format
  * TextureNotPot              Supports non power-of-two textures
  * TexturePartialMipChain     Supports mip chains that do not go all the way to 1x1
+ * TextureViews               Supports IDevice::createTextureView
+ * TimestampQueries           Supports GPU timestamp queries, see IDevice::createTimestampQueryPool
  * UniformBlocks,             Supports uniform blocks
  * ValidationLayersEnabled,   Validation layers are enabled
  */
@@ -70,26 +80,34 @@ enum class DeviceFeatures {
   Compute,
   DepthCompare,
   DepthShaderRead,
+  DrawBaseInstance,
+  DrawBaseVertex,
   DrawIndexedIndirect,
+  DrawInstanced,
   ExplicitBinding,
   ExplicitBindingExt,
   ExternalMemoryObjects,
+  FragmentDensityMap,
   MapBufferRange,
   MinMaxBlend,
   MultipleRenderTargets,
   MultiSample,
   MultiSampleResolve,
   Multiview,
+  OcclusionQueries,
   PushConstants,
   ReadWriteFramebuffer,
   SamplerMinMaxLod,
   ShaderLibrary,
+  ShaderSubgroups,
   ShaderTextureLod,
   ShaderTextureLodExt,
   SRGB,
   SRGBWriteControl,
   StandardDerivative,
   StandardDerivativeExt,
+  SubgroupSizeControl,
+  Subpasses,
   Texture2DArray,
   TextureArrayExt,
   Texture3D,
@@ -102,6 +120,8 @@ enum class DeviceFeatures {
   TextureHalfFloat,
   TextureNotPot,
   TexturePartialMipChain,
+  TextureViews,
+  TimestampQueries,
   UniformBlocks,
   ValidationLayersEnabled,
 };
@@ -142,10 +162,18 @@ enum class DeviceRequirement {
  * MaxFragmentUniformVectors    Maximum fragment uniform vectors
  * MaxMultisampleCount          Maximum number of samples
  * MaxPushConstantBytes         Maximum number of bytes for Push Constants
+ * MaxSubgroupSize              Maximum number of invocations of a compute shader subgroup
  * MaxTextureDimension1D2D      Maximum texture dimensions
  * MaxUniformBufferBytes        Maximum number of bytes for a uniform buffer
  * MaxVertexUniformVectors      Maximum vertex uniform vectors
+ * MinSubgroupSize              Minimum number of invocations of a compute shader subgroup
  * PushConstantsAlignment       Required byte alignment for push constants data
+ * SubgroupOperations           ICapabilities::SubgroupOperationBits supported in compute shaders
+ * UniformBufferOffsetAlignment Required byte alignment for offsets of bound uniform buffers
+ *
+ * The subgroup limits are 0 on devices whose compute shaders have no subgroups. Unless the pipeline
+ * sets ComputePipelineDesc::requiredSubgroupSize, the device picks a subgroup size in
+ * [MinSubgroupSize, MaxSubgroupSize] for each pipeline.
  */
 enum class DeviceFeatureLimits {
   BufferAlignment = 0,
@@ -155,11 +183,15 @@ enum class DeviceFeatureLimits {
   MaxFragmentUniformVectors,
   MaxMultisampleCount,
   MaxPushConstantBytes,
+  MaxSubgroupSize,
   MaxTextureDimension1D2D,
   MaxUniformBufferBytes,
   MaxVertexUniformVectors,
+  MinSubgroupSize,
   PushConstantsAlignment,
   ShaderStorageBufferOffsetAlignment,
+  SubgroupOperations,
+  UniformBufferOffsetAlignment,
 };
 
 /**
@@ -224,6 +256,31 @@ class ICapabilities {
 
   using TextureFormatCapabilities = uint8_t;
 
+  /**
+   * @brief The classes of subgroup (SIMD-group) functions reported by
+   * DeviceFeatureLimits::SubgroupOperations, which match VkSubgroupFeatureFlagBits and the
+   * GL_KHR_shader_subgroup extensions
+   *
+   * Basic            subgroupElect() and subgroupBarrier(); simd_is_first() in Metal
+   * Vote             subgroupAll() and subgroupAny(); simd_all() and simd_any()
+   * Arithmetic       Reductions and prefix operations; simd_sum() and simd_prefix_inclusive_sum()
+   * Ballot           subgroupBallot() and subgroupBroadcast(); simd_ballot() and simd_broadcast()
+   * Shuffle          subgroupShuffle(); simd_shuffle()
+   * ShuffleRelative  subgroupShuffleUp() and subgroupShuffleDown(); simd_shuffle_up() and down()
+   * Clustered        Reductions over clusters of invocations
+   * Quad             Operations within quads of invocations; quad_broadcast() and quad_shuffle()
+   */
+  enum SubgroupOperationBits : uint32_t {
+    Basic = 1 << 0,
+    Vote = 1 << 1,
+    Arithmetic = 1 << 2,
+    Ballot = 1 << 3,
+    Shuffle = 1 << 4,
+    ShuffleRelative = 1 << 5,
+    Clustered = 1 << 6,
+    Quad = 1 << 7,
+  };
+
   /**
    * @brief This function indicates if a device feature is supported at all.
    *
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Common.h>
+
+namespace igl {
+
+/**
+ * @brief Native handles fences are shared with other APIs and processes through.
+ *
+ * SyncFd         : A Linux / Android sync file descriptor, e.g. shared with compositors, video
+ *                  decoders and AHardwareBuffer producers. Vulkan only.
+ * MTLSharedEvent : An id<MTLSharedEvent> and the value it reaches once the fence is signaled.
+ */
+enum class FenceHandleType : uint8_t {
+  SyncFd,
+  MTLSharedEvent,
+};
+
+/**
+ * @brief A native fence handle.
+ *
+ * type   : The kind of handle.
+ * fd     : SyncFd only; the file descriptor, or -1 for a fence which is already signaled.
+ * handle : MTLSharedEvent only; the bridged id<MTLSharedEvent>.
+ * value  : MTLSharedEvent only; the value of the event which signals the fence.
+ *
+ * Importing a sync file descriptor transfers its ownership to IGL, also on failure; exporting one
+ * returns a new file descriptor owned by the caller.
+ */
+struct FenceNativeHandle {
+  FenceHandleType type = FenceHandleType::SyncFd;
+  int fd = -1;
+  void* IGL_NULLABLE handle = nullptr;
+  uint64_t value = 0;
+};
+
+/**
+ * @brief A GPU fence which can be shared outside IGL.
+ *
+ * Fences are created by ICommandQueue::signalFence(), which signals them once all the work
+ * submitted to the queue so far is finished, or by ICommandQueue::importFence() from a native
+ * handle. ICommandQueue::waitFence() makes the GPU wait for a fence without blocking the CPU.
+ */
+class IFence {
+ public:
+  virtual ~IFence() = default;
+
+  /**
+   * @brief Returns true if the fence is signaled. Never blocks.
+   */
+  [[nodiscard]] virtual bool isSignaled() const = 0;
+
+  /**
+   * @brief Blocks the CPU until the fence is signaled or `timeoutNanoseconds` elapsed.
+   * @returns true if the fence is signaled
+   */
+  virtual bool waitUntilSignaled(uint64_t timeoutNanoseconds = UINT64_MAX) const = 0;
+
+  /**
+   * @brief Exports the fence as a native handle of the given type.
+   */
+  virtual Result exportNativeHandle(FenceHandleType type, FenceNativeHandle& outHandle) const = 0;
+
+ protected:
+  IFence() = default;
+};
+
+} // namespace igl
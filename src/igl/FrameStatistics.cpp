@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/FrameStatistics.h>
+
+namespace igl {
+
+namespace {
+
+FrameStatistics makeStatistics(uint64_t frameIndex, const uint64_t* values) noexcept {
+  using Counter = FrameStatisticsTracker::Counter;
+
+  FrameStatistics stats;
+  stats.frameIndex = frameIndex;
+  stats.drawCalls = static_cast<uint32_t>(values[Counter::DrawCalls]);
+  stats.pipelineBinds = static_cast<uint32_t>(values[Counter::PipelineBinds]);
+  stats.descriptorUpdates = static_cast<uint32_t>(values[Counter::DescriptorUpdates]);
+  stats.uploadedBytes = values[Counter::UploadedBytes];
+  stats.gpuWaits = static_cast<uint32_t>(values[Counter::GpuWaits]);
+  stats.deferredTasks = static_cast<uint32_t>(values[Counter::DeferredTasks]);
+  stats.apiCalls = values[Counter::ApiCalls];
+  stats.skippedCommands = static_cast<uint32_t>(values[Counter::SkippedCommands]);
+  return stats;
+}
+
+} // namespace
+
+void FrameStatisticsTracker::endFrame() noexcept {
+  uint64_t values[NumCounters] = {};
+  for (size_t i = 0; i != NumCounters; i++) {
+    values[i] = counters_[i].exchange(0, std::memory_order_relaxed);
+  }
+
+  const std::lock_guard<std::mutex> lock(mutex_);
+  history_[frameIndex_ % kHistorySize] = makeStatistics(frameIndex_, values);
+  frameIndex_++;
+}
+
+FrameStatistics FrameStatisticsTracker::getCurrent() const noexcept {
+  uint64_t values[NumCounters] = {};
+  for (size_t i = 0; i != NumCounters; i++) {
+    values[i] = counters_[i].load(std::memory_order_relaxed);
+  }
+
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return makeStatistics(frameIndex_, values);
+}
+
+std::vector<FrameStatistics> FrameStatisticsTracker::getHistory() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+
+  const uint64_t numFrames = frameIndex_ < kHistorySize ? frameIndex_ : kHistorySize;
+
+  std::vector<FrameStatistics> history;
+  history.reserve(numFrames);
+  for (uint64_t i = frameIndex_ - numFrames; i != frameIndex_; i++) {
+    history.push_back(history_[i % kHistorySize]);
+  }
+  return history;
+}
+
+} // namespace igl
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace igl {
+
+/**
+ * @brief Work done by a device during one frame. A frame ends when a command buffer that presents
+ * a surface, or that is submitted with `endOfFrame`, is submitted.
+ *
+ * Counters a backend does not track stay at zero.
+ *
+ * frameIndex        : Index of the frame, starting at 0 for the first frame of the device
+ * drawCalls         : Number of draw calls submitted
+ * pipelineBinds     : Number of render and compute pipeline state binds
+ * descriptorUpdates : Number of descriptor set updates (Vulkan) or resource binds (OpenGL)
+ * uploadedBytes     : Number of bytes uploaded to buffers and textures
+ * gpuWaits          : Number of times the CPU blocked waiting for the GPU
+ * deferredTasks     : Number of deferred tasks (e.g. destruction of resources) processed
+ * apiCalls          : Number of calls into the underlying graphics API (OpenGL)
+ * skippedCommands   : Number of state commands skipped because they set the state already
+ *                     recorded, e.g. the same viewport or pipeline (Vulkan)
+ */
+struct FrameStatistics {
+  uint64_t frameIndex = 0;
+  uint32_t drawCalls = 0;
+  uint32_t pipelineBinds = 0;
+  uint32_t descriptorUpdates = 0;
+  uint64_t uploadedBytes = 0;
+  uint32_t gpuWaits = 0;
+  uint32_t deferredTasks = 0;
+  uint64_t apiCalls = 0;
+  uint32_t skippedCommands = 0;
+};
+
+/**
+ * @brief Accumulates the counters of the current frame and keeps the last `kHistorySize` frames.
+ * Backends own one per device. `add()` can be called from any thread.
+ */
+class FrameStatisticsTracker final {
+ public:
+  static constexpr size_t kHistorySize = 64;
+
+  enum Counter : uint8_t {
+    DrawCalls,
+    PipelineBinds,
+    DescriptorUpdates,
+    UploadedBytes,
+    GpuWaits,
+    DeferredTasks,
+    ApiCalls,
+    SkippedCommands,
+    NumCounters,
+  };
+
+  void add(Counter counter, uint64_t value = 1) noexcept {
+    counters_[counter].fetch_add(value, std::memory_order_relaxed);
+  }
+
+  /// Moves the counters of the current frame into the history and starts a new frame.
+  void endFrame() noexcept;
+
+  /// Returns the counters accumulated so far by the current frame.
+  [[nodiscard]] FrameStatistics getCurrent() const noexcept;
+
+  /// Returns up to `kHistorySize` completed frames, oldest first.
+  [[nodiscard]] std::vector<FrameStatistics> getHistory() const;
+
+ private:
+  std::array<std::atomic<uint64_t>, NumCounters> counters_ = {};
+
+  mutable std::mutex mutex_;
+  std::array<FrameStatistics, kHistorySize> history_ = {};
+  uint64_t frameIndex_ = 0; // guarded by mutex_
+};
+
+} // namespace igl
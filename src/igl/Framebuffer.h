@@ -31,6 +31,13 @@ enum class FramebufferMode {
  * surfaces.
  */
 struct FramebufferDesc {
+  /**
+   * @brief An attachment and the single-sampled texture its multisampled contents are resolved
+   * into by StoreAction::MsaaResolve. The resolve is part of the render pass: Vulkan resolve
+   * attachments, Metal resolve textures and, with GL_EXT_multisampled_render_to_texture, OpenGL ES
+   * renders implicitly multisampled into the resolve texture. Other OpenGL contexts blit at the end
+   * of the render pass.
+   */
   struct AttachmentDesc {
     std::shared_ptr<ITexture> texture;
     std::shared_ptr<ITexture> resolveTexture;
@@ -42,6 +49,13 @@ struct FramebufferDesc {
   AttachmentDesc depthAttachment;
   /** @brief The stencil texture attachment */
   AttachmentDesc stencilAttachment;
+  /**
+   * @brief Optional fragment density map (RG_UNorm8) lowering the shading rate of the regions of
+   * the render pass where it holds low densities, e.g. in the periphery of XR views. It must have
+   * the layers of the other attachments in FramebufferMode::Stereo and is never written. Requires
+   * DeviceFeatures::FragmentDensityMap. The resolve texture is unused.
+   */
+  AttachmentDesc densityMapAttachment;
 
   std::string debugName;
 
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <igl/BindGroup.h>
 #include <igl/Buffer.h>
 #include <igl/CommandBuffer.h>
 #include <igl/CommandQueue.h>
@@ -15,8 +16,12 @@
 #include <igl/ComputePipelineState.h>
 #include <igl/DepthStencilState.h>
 #include <igl/Device.h>
+#include <igl/Fence.h>
 #include <igl/Framebuffer.h>
 #include <igl/HWDevice.h>
+#include <igl/OcclusionQueryPool.h>
+#include <igl/Readback.h>
+#include <igl/RenderBundle.h>
 #include <igl/RenderCommandEncoder.h>
 #include <igl/RenderPass.h>
 #include <igl/RenderPipelineState.h>
@@ -24,5 +29,6 @@
 #include <igl/Shader.h>
 #include <igl/ShaderCreator.h>
 #include <igl/Texture.h>
+#include <igl/TimestampQueryPool.h>
 #include <igl/Uniform.h>
 #include <igl/VertexInputState.h>
@@ -130,6 +130,21 @@ class IResourceTracker {
    */
   virtual void willDelete(const IShaderStages& shaderStages) noexcept = 0;
 
+  /**
+   * @brief Informs the tracker that a backend has allocated a memory heap which resources are
+   * sub-allocated from. Heap resources are still reported individually.
+   *
+   * @param sizeInBytes Size of the heap
+   */
+  virtual void didCreateHeap(size_t /*sizeInBytes*/) noexcept {}
+
+  /**
+   * @brief Informs the tracker that a memory heap will be deleted
+   *
+   * @param sizeInBytes Size of the heap
+   */
+  virtual void willDeleteHeap(size_t /*sizeInBytes*/) noexcept {}
+
   template<typename T>
   void didCreate(const ITrackedResource<T>& resource) noexcept {
     IGL_ASSERT_NOT_REACHED();
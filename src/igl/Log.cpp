@@ -7,13 +7,20 @@
 
 #define IGL_COMMON_SKIP_CHECK
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstdio>
+#include <cstdlib>
 #include <igl/Core.h>
 #include <igl/Log.h>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 #if IGL_PLATFORM_ANDROID
 #include <igl/android/LogDefault.h>
@@ -33,6 +40,172 @@ static IGLLogHandlerFunc* GetHandle() {
   return &sHandler;
 }
 
+static int callHandler(IGLLogLevel logLevel, const char* IGL_RESTRICT format, ...) {
+  va_list ap;
+  va_start(ap, format);
+  const int result = (*GetHandle())(logLevel, format, ap);
+  va_end(ap);
+  return result;
+}
+
+namespace {
+
+constexpr size_t kAsyncRecordLength = 512; // longer messages are truncated
+constexpr size_t kAsyncRingCapacity = 256; // records per thread
+
+struct AsyncRecord {
+  IGLLogLevel logLevel = IGLLogLevel::LOG_INFO;
+  char text[kAsyncRecordLength] = {};
+};
+
+// Written by one thread and drained by one thread at a time
+struct AsyncRing {
+  AsyncRecord records[kAsyncRingCapacity];
+  std::atomic<size_t> head{0}; // written by the producer
+  std::atomic<size_t> tail{0}; // written by the consumer
+  std::atomic<bool> abandoned{false}; // the producer thread has exited
+};
+
+struct ThreadRing {
+  ~ThreadRing() {
+    if (ring) {
+      ring->abandoned.store(true, std::memory_order_release);
+    }
+  }
+  std::shared_ptr<AsyncRing> ring;
+};
+
+class AsyncLogger {
+ public:
+  // never destroyed, so threads can log during static destruction
+  static AsyncLogger& get() {
+    static auto* logger = new AsyncLogger();
+    return *logger;
+  }
+
+  bool isRunning() const {
+    return running_.load(std::memory_order_acquire);
+  }
+
+  void start() {
+    const std::lock_guard<std::mutex> lock(threadMutex_);
+    if (thread_.joinable()) {
+      return;
+    }
+    if (!registeredAtExit_) {
+      registeredAtExit_ = true;
+      std::atexit([]() { AsyncLogger::get().stop(); });
+    }
+    stopRequested_ = false;
+    thread_ = std::thread([this]() { run(); });
+    running_.store(true, std::memory_order_release);
+  }
+
+  void stop() {
+    const std::lock_guard<std::mutex> lock(threadMutex_);
+    if (!thread_.joinable()) {
+      return;
+    }
+    running_.store(false, std::memory_order_release);
+    {
+      const std::lock_guard<std::mutex> cvLock(mutex_);
+      stopRequested_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+    // records pushed while stopping
+    drain();
+  }
+
+  void push(IGLLogLevel logLevel, const char* IGL_RESTRICT format, va_list ap) {
+    AsyncRing& ring = getThreadRing();
+    const size_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) == kAsyncRingCapacity) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    AsyncRecord& record = ring.records[head % kAsyncRingCapacity];
+    record.logLevel = logLevel;
+    FOLLY_PUSH_WARNING
+    FOLLY_GNU_DISABLE_WARNING("-Wformat-nonliteral")
+    vsnprintf(record.text, kAsyncRecordLength, format, ap);
+    FOLLY_POP_WARNING
+    ring.head.store(head + 1, std::memory_order_release);
+  }
+
+  // passes all pending records to the handler
+  void drain() {
+    const std::lock_guard<std::mutex> drainLock(drainMutex_);
+
+    std::vector<std::shared_ptr<AsyncRing>> rings;
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      rings = rings_;
+    }
+
+    for (const auto& ring : rings) {
+      // read before the records, so an abandoned ring is known to be complete
+      const bool abandoned = ring->abandoned.load(std::memory_order_acquire);
+      size_t tail = ring->tail.load(std::memory_order_relaxed);
+      const size_t head = ring->head.load(std::memory_order_acquire);
+      for (; tail != head; tail++) {
+        const AsyncRecord& record = ring->records[tail % kAsyncRingCapacity];
+        callHandler(record.logLevel, "%s", record.text);
+        // the producer may reuse the record from now on
+        ring->tail.store(tail + 1, std::memory_order_release);
+      }
+      if (abandoned) {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        rings_.erase(std::remove(rings_.begin(), rings_.end(), ring), rings_.end());
+      }
+    }
+
+    if (const uint32_t dropped = dropped_.exchange(0, std::memory_order_relaxed)) {
+      callHandler(IGLLogLevel::LOG_WARNING, "[IGL] %u log messages were dropped\n", dropped);
+    }
+  }
+
+ private:
+  AsyncRing& getThreadRing() {
+    static thread_local ThreadRing threadRing;
+    if (!threadRing.ring) {
+      threadRing.ring = std::make_shared<AsyncRing>();
+      const std::lock_guard<std::mutex> lock(mutex_);
+      rings_.push_back(threadRing.ring);
+    }
+    return *threadRing.ring;
+  }
+
+  void run() {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, std::chrono::milliseconds(10), [this]() { return stopRequested_; });
+        if (stopRequested_) {
+          break;
+        }
+      }
+      drain();
+    }
+  }
+
+ private:
+  std::mutex threadMutex_; // guards thread_ and registeredAtExit_
+  std::thread thread_;
+  bool registeredAtExit_ = false;
+  std::atomic<bool> running_{false};
+
+  std::mutex mutex_; // guards rings_ and stopRequested_
+  std::condition_variable cv_;
+  std::vector<std::shared_ptr<AsyncRing>> rings_;
+  bool stopRequested_ = false;
+
+  std::mutex drainMutex_; // one consumer at a time
+  std::atomic<uint32_t> dropped_{0};
+};
+
+} // namespace
+
 IGL_API int IGLLog(IGLLogLevel logLevel, const char* IGL_RESTRICT format, ...) {
   va_list ap;
   va_start(ap, format);
@@ -71,6 +244,11 @@ IGL_API int IGLLogOnce(IGLLogLevel logLevel, const char* IGL_RESTRICT format, ..
 }
 
 IGL_API int IGLLogV(IGLLogLevel logLevel, const char* IGL_RESTRICT format, va_list ap) {
+  AsyncLogger& asyncLogger = AsyncLogger::get();
+  if (asyncLogger.isRunning()) {
+    asyncLogger.push(logLevel, format, ap);
+    return 0;
+  }
   return (*GetHandle())(logLevel, format, ap);
 }
 
@@ -90,3 +268,43 @@ IGL_API void IGLLogSetHandler(IGLLogHandlerFunc handler) {
 IGL_API IGLLogHandlerFunc IGLLogGetHandler() {
   return *GetHandle();
 }
+
+IGL_API void IGLLogSetAsync(bool async) {
+  if (async) {
+    AsyncLogger::get().start();
+  } else {
+    AsyncLogger::get().stop();
+  }
+}
+
+IGL_API bool IGLLogIsAsync() {
+  return AsyncLogger::get().isRunning();
+}
+
+IGL_API void IGLLogFlush() {
+  AsyncLogger::get().drain();
+}
+
+IGL_API bool IGLLogRateLimitAcquire(IGLLogRateLimit& limit, uint32_t maxPerSecond) {
+  const int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+  int64_t windowStartMs = limit.windowStartMs.load(std::memory_order_relaxed);
+  // 0 is the initial value, so the first message always starts a window
+  if (windowStartMs == 0 || nowMs - windowStartMs >= 1000) {
+    if (limit.windowStartMs.compare_exchange_strong(
+            windowStartMs, nowMs, std::memory_order_relaxed)) {
+      limit.count.store(0, std::memory_order_relaxed);
+      if (const uint32_t suppressed = limit.suppressed.exchange(0, std::memory_order_relaxed)) {
+        IGLLog(IGLLogLevel::LOG_WARNING,
+               "[IGL] %u messages were suppressed by rate limiting\n",
+               suppressed);
+      }
+    }
+  }
+  if (limit.count.fetch_add(1, std::memory_order_relaxed) < maxPerSecond) {
+    return true;
+  }
+  limit.suppressed.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
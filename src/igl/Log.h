@@ -11,7 +11,9 @@
 #error "Please, include <igl/Common.h> instead"
 #endif
 
+#include <atomic>
 #include <cstdarg>
+#include <cstdint>
 #include <igl/Macros.h>
 
 enum class IGLLogLevel {
@@ -38,6 +40,32 @@ using IGLLogHandlerFunc = int (*)(IGLLogLevel logLevel,
 IGL_API void IGLLogSetHandler(IGLLogHandlerFunc handler);
 IGL_API IGLLogHandlerFunc IGLLogGetHandler(void);
 
+///--------------------------------------
+/// MARK: - Asynchronous logging
+
+// When enabled, messages are formatted on the calling thread into a per-thread ring buffer and
+// passed to the log handler by a background thread, so logging never waits for I/O. Messages
+// longer than 511 characters are truncated; messages are dropped (and counted) while the ring of
+// the calling thread is full. The handler has to be thread-safe. Disabled by default.
+IGL_API void IGLLogSetAsync(bool async);
+IGL_API bool IGLLogIsAsync(void);
+// Passes all pending asynchronous messages to the handler before returning
+IGL_API void IGLLogFlush(void);
+
+///--------------------------------------
+/// MARK: - Rate limiting
+
+// The state of one rate limited call site; see IGL_LOG_ERROR_RATE_LIMITED
+struct IGLLogRateLimit {
+  std::atomic<int64_t> windowStartMs{0};
+  std::atomic<uint32_t> count{0};
+  std::atomic<uint32_t> suppressed{0};
+};
+
+// Returns true if the call site may log: at most `maxPerSecond` messages per second. The number of
+// suppressed messages is logged once the next second starts.
+IGL_API bool IGLLogRateLimitAcquire(IGLLogRateLimit& limit, uint32_t maxPerSecond);
+
 ///--------------------------------------
 /// MARK: - Macros
 
@@ -51,10 +79,27 @@ IGL_API IGLLogHandlerFunc IGLLogGetHandler(void);
 #define IGL_LOG_INFO(format, ...) IGLLog(IGLLogLevel::LOG_INFO, (format), ##__VA_ARGS__)
 #define IGL_LOG_INFO_ONCE(format, ...) IGLLogOnce(IGLLogLevel::LOG_INFO, (format), ##__VA_ARGS__)
 #define IGL_DEBUG_LOG(format, ...) IGLLog(IGLLogLevel::LOG_INFO, (format), ##__VA_ARGS__)
+
+#define IGL_LOG_ERROR_RATE_LIMITED(maxPerSecond, format, ...)      \
+  do {                                                             \
+    static IGLLogRateLimit iglLogRateLimit;                        \
+    if (IGLLogRateLimitAcquire(iglLogRateLimit, (maxPerSecond))) { \
+      IGL_LOG_ERROR(format, ##__VA_ARGS__);                        \
+    }                                                              \
+  } while (false)
+#define IGL_LOG_INFO_RATE_LIMITED(maxPerSecond, format, ...)       \
+  do {                                                             \
+    static IGLLogRateLimit iglLogRateLimit;                        \
+    if (IGLLogRateLimitAcquire(iglLogRateLimit, (maxPerSecond))) { \
+      IGL_LOG_INFO(format, ##__VA_ARGS__);                         \
+    }                                                              \
+  } while (false)
 #else
 #define IGL_LOG_ERROR(format, ...) static_cast<void>(0)
 #define IGL_LOG_ERROR_ONCE(format, ...) static_cast<void>(0)
 #define IGL_LOG_INFO(format, ...) static_cast<void>(0)
 #define IGL_LOG_INFO_ONCE(format, ...) static_cast<void>(0)
 #define IGL_DEBUG_LOG(format, ...) static_cast<void>(0)
+#define IGL_LOG_ERROR_RATE_LIMITED(maxPerSecond, format, ...) static_cast<void>(0)
+#define IGL_LOG_INFO_RATE_LIMITED(maxPerSecond, format, ...) static_cast<void>(0)
 #endif
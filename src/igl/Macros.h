@@ -348,6 +348,15 @@
 ///--------------------------------------
 /// MARK: Integrated profiling
 
+// allocation audit zones (see igl/AllocationAudit.h) follow the profiler zones
+#if defined(IGL_ALLOCATION_AUDIT) && IGL_ALLOCATION_AUDIT && defined(__cplusplus)
+#include <igl/AllocationAudit.h>
+#define IGL_ALLOCATION_AUDIT_ZONE(name) \
+  const ::igl::AllocationAuditZone IGL_CONCAT(iglAllocationAuditZone, __LINE__)(name)
+#else
+#define IGL_ALLOCATION_AUDIT_ZONE(name) static_assert(true, "")
+#endif // IGL_ALLOCATION_AUDIT
+
 #if defined(IGL_WITH_TRACY) && defined(__cplusplus)
 #include "tracy/Tracy.hpp"
 // predefined 0xRGB colors for "heavy" point-of-interest operations
@@ -358,19 +367,26 @@
 #define IGL_PROFILER_COLOR_DESTROY 0xffa500
 #define IGL_PROFILER_COLOR_TRANSITION 0xffffff
 //
-#define IGL_PROFILER_FUNCTION() ZoneScoped
-#define IGL_PROFILER_FUNCTION_COLOR(color) ZoneScopedC(color)
+#define IGL_PROFILER_FUNCTION() \
+  ZoneScoped;                   \
+  IGL_ALLOCATION_AUDIT_ZONE(__FUNCTION__)
+#define IGL_PROFILER_FUNCTION_COLOR(color) \
+  ZoneScopedC(color);                      \
+  IGL_ALLOCATION_AUDIT_ZONE(__FUNCTION__)
 #define IGL_PROFILER_ZONE(name, color) \
   {                                    \
     ZoneScopedC(color);                \
-    ZoneName(name, strlen(name))
+    ZoneName(name, strlen(name));      \
+    IGL_ALLOCATION_AUDIT_ZONE(name)
 #define IGL_PROFILER_ZONE_END() }
 #define IGL_PROFILER_THREAD(name) tracy::SetThreadName(name)
 #define IGL_PROFILER_FRAME(name) FrameMarkNamed(name)
 #else
-#define IGL_PROFILER_FUNCTION()
-#define IGL_PROFILER_FUNCTION_COLOR(color)
-#define IGL_PROFILER_ZONE(name, color) {
+#define IGL_PROFILER_FUNCTION() IGL_ALLOCATION_AUDIT_ZONE(__FUNCTION__)
+#define IGL_PROFILER_FUNCTION_COLOR(color) IGL_ALLOCATION_AUDIT_ZONE(__FUNCTION__)
+#define IGL_PROFILER_ZONE(name, color) \
+  {                                    \
+    IGL_ALLOCATION_AUDIT_ZONE(name)
 #define IGL_PROFILER_ZONE_END() }
 #define IGL_PROFILER_THREAD(name)
 #define IGL_PROFILER_FRAME(name)
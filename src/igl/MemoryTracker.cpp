@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/MemoryTracker.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <igl/Buffer.h>
+#include <igl/Device.h>
+#include <igl/Texture.h>
+
+namespace igl {
+
+namespace {
+
+bool isOverThreshold(size_t usedBytes, size_t budgetBytes, float warningRatio) {
+  return budgetBytes != 0 &&
+         static_cast<double>(usedBytes) >= static_cast<double>(budgetBytes) * warningRatio;
+}
+
+} // namespace
+
+void MemoryTracker::setBudget(size_t budgetBytes, float warningRatio, BudgetCallback callback) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  budgetBytes_ = budgetBytes;
+  warningRatio_ = warningRatio;
+  callback_ = std::move(callback);
+  trackedWarningRaised_ = false;
+  deviceWarningRaised_ = false;
+}
+
+bool MemoryTracker::checkDeviceBudget(const IDevice& device) {
+  DeviceMemoryUsage usage;
+  if (!device.getDeviceMemoryUsage(usage)) {
+    return false;
+  }
+  MemoryBudgetWarning warning = {usage.usedBytes, usage.budgetBytes, true};
+  BudgetCallback callback;
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (warning.budgetBytes == 0) {
+      warning.budgetBytes = budgetBytes_;
+    }
+    const bool isOver = isOverThreshold(warning.usedBytes, warning.budgetBytes, warningRatio_);
+    if (isOver && !deviceWarningRaised_) {
+      callback = callback_;
+    }
+    deviceWarningRaised_ = isOver;
+  }
+  if (callback) {
+    callback(warning);
+  }
+  return true;
+}
+
+TrackedMemory MemoryTracker::getTotal() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return total_;
+}
+
+std::unordered_map<std::string, TrackedMemory> MemoryTracker::getUsageByTag() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return usageByTag_;
+}
+
+size_t MemoryTracker::getHeapBytes() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return heapBytes_;
+}
+
+std::string MemoryTracker::getReport() const {
+  std::vector<std::pair<std::string, TrackedMemory>> tags;
+  TrackedMemory total;
+  size_t heapBytes = 0;
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    tags.assign(usageByTag_.begin(), usageByTag_.end());
+    total = total_;
+    heapBytes = heapBytes_;
+  }
+  std::sort(tags.begin(), tags.end(), [](const auto& a, const auto& b) {
+    return a.second.getTotalBytes() > b.second.getTotalBytes();
+  });
+
+  std::string report;
+  char line[256];
+  auto append = [&](const char* name, const TrackedMemory& memory) {
+    snprintf(line,
+             sizeof(line),
+             "%-32s %10.2f MB  textures: %5u (%8.2f MB)  buffers: %5u (%8.2f MB)  "
+             "framebuffers: %4u\n",
+             name,
+             static_cast<double>(memory.getTotalBytes()) / (1024.0 * 1024.0),
+             memory.numTextures,
+             static_cast<double>(memory.textureBytes) / (1024.0 * 1024.0),
+             memory.numBuffers,
+             static_cast<double>(memory.bufferBytes) / (1024.0 * 1024.0),
+             memory.numFramebuffers);
+    report += line;
+  };
+  for (const auto& [tag, memory] : tags) {
+    append(tag.empty() ? "<untagged>" : tag.c_str(), memory);
+  }
+  append("Total", total);
+  if (heapBytes) {
+    snprintf(line,
+             sizeof(line),
+             "Heaps: %.2f MB\n",
+             static_cast<double>(heapBytes) / (1024.0 * 1024.0));
+    report += line;
+  }
+  return report;
+}
+
+void MemoryTracker::didCreate(const ITexture& texture) noexcept {
+  add(&texture, ResourceType::Texture, texture.getEstimatedSizeInBytes());
+}
+
+void MemoryTracker::willDelete(const ITexture& texture) noexcept {
+  remove(&texture);
+}
+
+void MemoryTracker::didCreate(const IBuffer& buffer) noexcept {
+  add(&buffer, ResourceType::Buffer, buffer.getSizeInBytes());
+}
+
+void MemoryTracker::willDelete(const IBuffer& buffer) noexcept {
+  remove(&buffer);
+}
+
+void MemoryTracker::didCreate(const IFramebuffer& framebuffer) noexcept {
+  add(&framebuffer, ResourceType::Framebuffer, 0);
+}
+
+void MemoryTracker::willDelete(const IFramebuffer& framebuffer) noexcept {
+  remove(&framebuffer);
+}
+
+void MemoryTracker::didCreateHeap(size_t sizeInBytes) noexcept {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  heapBytes_ += sizeInBytes;
+}
+
+void MemoryTracker::willDeleteHeap(size_t sizeInBytes) noexcept {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  IGL_ASSERT(heapBytes_ >= sizeInBytes);
+  heapBytes_ -= std::min(heapBytes_, sizeInBytes);
+}
+
+void MemoryTracker::pushTag(const char* tag) noexcept {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  tags_.emplace_back(tag ? tag : "");
+}
+
+void MemoryTracker::popTag() noexcept {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  if (IGL_VERIFY(!tags_.empty())) {
+    tags_.pop_back();
+  }
+}
+
+void MemoryTracker::update(TrackedMemory& memory, ResourceType type, size_t bytes, bool added) {
+  const auto apply = [added](auto& value, auto delta) {
+    value = added ? value + delta : value - delta;
+  };
+  switch (type) {
+  case ResourceType::Texture:
+    apply(memory.textureBytes, bytes);
+    apply(memory.numTextures, 1u);
+    break;
+  case ResourceType::Buffer:
+    apply(memory.bufferBytes, bytes);
+    apply(memory.numBuffers, 1u);
+    break;
+  case ResourceType::Framebuffer:
+    apply(memory.numFramebuffers, 1u);
+    break;
+  }
+}
+
+void MemoryTracker::add(const void* resource, ResourceType type, size_t bytes) noexcept {
+  MemoryBudgetWarning warning;
+  BudgetCallback callback;
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    TrackedMemory& tag = usageByTag_[tags_.empty() ? std::string() : tags_.back()];
+    const auto [it, inserted] = entries_.insert({resource, {type, bytes, &tag}});
+    if (!IGL_VERIFY(inserted)) {
+      return;
+    }
+    update(tag, type, bytes, true);
+    update(total_, type, bytes, true);
+
+    const bool isOver = isOverThreshold(total_.getTotalBytes(), budgetBytes_, warningRatio_);
+    if (isOver && !trackedWarningRaised_) {
+      warning = {total_.getTotalBytes(), budgetBytes_, false};
+      callback = callback_;
+    }
+    trackedWarningRaised_ = isOver;
+  }
+  if (callback) {
+    callback(warning);
+  }
+}
+
+void MemoryTracker::remove(const void* resource) noexcept {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = entries_.find(resource);
+  if (it == entries_.end()) {
+    return;
+  }
+  const Entry& entry = it->second;
+  update(*entry.tag, entry.type, entry.bytes, false);
+  update(total_, entry.type, entry.bytes, false);
+  entries_.erase(it);
+  trackedWarningRaised_ = isOverThreshold(total_.getTotalBytes(), budgetBytes_, warningRatio_);
+}
+
+} // namespace igl
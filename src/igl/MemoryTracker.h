@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <functional>
+#include <igl/IResourceTracker.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace igl {
+
+class IDevice;
+
+/**
+ * @brief Resources and bytes attributed to one tag, or to all tags, by a MemoryTracker.
+ * Framebuffers do not own memory: their attachments are counted as textures.
+ */
+struct TrackedMemory {
+  size_t textureBytes = 0;
+  size_t bufferBytes = 0;
+  uint32_t numTextures = 0;
+  uint32_t numBuffers = 0;
+  uint32_t numFramebuffers = 0;
+
+  [[nodiscard]] size_t getTotalBytes() const {
+    return textureBytes + bufferBytes;
+  }
+};
+
+/**
+ * @brief Raised by MemoryTracker when the memory usage reaches the warning threshold of a budget.
+ *
+ * usedBytes   : Bytes in use
+ * budgetBytes : Budget the usage was compared against
+ * fromDevice  : True if the usage was reported by the driver (see IDevice::getDeviceMemoryUsage()),
+ *               false if it is the sum of the resources seen by the tracker
+ */
+struct MemoryBudgetWarning {
+  size_t usedBytes = 0;
+  size_t budgetBytes = 0;
+  bool fromDevice = false;
+};
+
+/**
+ * @brief A resource tracker which attributes the bytes of textures and buffers to the tag active
+ * when they are created, and warns when the memory usage approaches a budget.
+ *
+ * Install it with IDevice::setResourceTracker() before creating resources: resources created before
+ * are not seen. Resources created outside of any tag are attributed to the empty tag.
+ *
+ * The warning callback is raised once when the usage crosses `warningRatio * budget`, and again
+ * only after the usage went back below it. It is called without holding the tracker's lock, on the
+ * thread creating the resource or calling checkDeviceBudget().
+ */
+class MemoryTracker final : public IResourceTracker {
+ public:
+  using BudgetCallback = std::function<void(const MemoryBudgetWarning& warning)>;
+
+  MemoryTracker() noexcept = default;
+
+  /**
+   * @brief Sets the budget the tracked bytes are compared against when resources are created, and
+   * the device usage is compared against when the driver does not report a budget.
+   *
+   * @param budgetBytes Budget in bytes. 0 disables the warnings on the tracked bytes.
+   * @param warningRatio Fraction of the budget which raises the warning
+   * @param callback Called with the usage when it reaches the warning threshold
+   */
+  void setBudget(size_t budgetBytes, float warningRatio, BudgetCallback callback);
+
+  /**
+   * @brief Compares the memory usage reported by `device` against its budget, e.g. once per frame.
+   * The driver sees all the allocations of the process, including those IGL does not track.
+   *
+   * @return False if the device cannot report its memory usage
+   */
+  bool checkDeviceBudget(const IDevice& device);
+
+  [[nodiscard]] TrackedMemory getTotal() const;
+  [[nodiscard]] std::unordered_map<std::string, TrackedMemory> getUsageByTag() const;
+  /// Bytes of the memory heaps backends sub-allocate resources from
+  [[nodiscard]] size_t getHeapBytes() const;
+
+  /// Formats the usage of each tag, largest first, for logging
+  [[nodiscard]] std::string getReport() const;
+
+  void didCreate(const ITexture& texture) noexcept override;
+  void willDelete(const ITexture& texture) noexcept override;
+  void didCreate(const IBuffer& buffer) noexcept override;
+  void willDelete(const IBuffer& buffer) noexcept override;
+  void didCreate(const IFramebuffer& framebuffer) noexcept override;
+  void willDelete(const IFramebuffer& framebuffer) noexcept override;
+  void didCreate(const ISamplerState& /*samplerState*/) noexcept override {}
+  void willDelete(const ISamplerState& /*samplerState*/) noexcept override {}
+  void didCreate(const IShaderLibrary& /*shaderLibrary*/) noexcept override {}
+  void willDelete(const IShaderLibrary& /*shaderLibrary*/) noexcept override {}
+  void didCreate(const IShaderModule& /*shaderModule*/) noexcept override {}
+  void willDelete(const IShaderModule& /*shaderModule*/) noexcept override {}
+  void didCreate(const IShaderStages& /*shaderStages*/) noexcept override {}
+  void willDelete(const IShaderStages& /*shaderStages*/) noexcept override {}
+  void didCreateHeap(size_t sizeInBytes) noexcept override;
+  void willDeleteHeap(size_t sizeInBytes) noexcept override;
+
+  void pushTag(const char* tag) noexcept override;
+  void popTag() noexcept override;
+
+ private:
+  enum class ResourceType : uint8_t { Texture, Buffer, Framebuffer };
+
+  struct Entry {
+    ResourceType type;
+    size_t bytes;
+    TrackedMemory* tag;
+  };
+
+  void add(const void* resource, ResourceType type, size_t bytes) noexcept;
+  void remove(const void* resource) noexcept;
+  static void update(TrackedMemory& memory, ResourceType type, size_t bytes, bool added);
+
+  mutable std::mutex mutex_;
+  std::vector<std::string> tags_;
+  // elements of unordered_map keep their address when rehashing
+  std::unordered_map<std::string, TrackedMemory> usageByTag_;
+  std::unordered_map<const void*, Entry> entries_;
+  TrackedMemory total_;
+  size_t heapBytes_ = 0;
+
+  size_t budgetBytes_ = 0;
+  float warningRatio_ = 1.0f;
+  BudgetCallback callback_;
+  bool trackedWarningRaised_ = false;
+  bool deviceWarningRaised_ = false;
+};
+
+} // namespace igl
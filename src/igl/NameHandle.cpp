@@ -8,6 +8,7 @@
 #include <igl/Macros.h>
 #include <igl/NameHandle.h>
 
+#include <atomic>
 #include <functional>
 #include <string>
 
@@ -95,12 +96,12 @@ uint32_t igl::iglCrc32(const char* data, size_t /*length*/) {
 #if IGL_DEBUG
 namespace igl {
 bool NameHandle::checkIsValidCrcCompare(const NameHandle& nh) const {
-  bool res = nh.crc32_ == crc32_ && nh.name_ != name_;
+  bool res = nh.crc32_ == crc32_ && nh.toString() != toString();
   IGL_ASSERT_MSG(!res,
                  "NameHandle CRC check fails: name1 (%s %x) name2 (%s %x)\n",
-                 name_.c_str(),
+                 toConstChar(),
                  crc32_,
-                 nh.name_.c_str(),
+                 nh.toConstChar(),
                  nh.crc32_);
 
   return res;
@@ -108,6 +109,57 @@ bool NameHandle::checkIsValidCrcCompare(const NameHandle& nh) const {
 } // namespace igl
 #endif // IGL_DEBUG
 
+#if IGL_NAMEHANDLE_INTERNED
+namespace {
+struct InternedName {
+  uint32_t crc32 = 0;
+  std::string name;
+  InternedName* next = nullptr;
+};
+
+constexpr size_t kNumInternBuckets = 4096;
+// every bucket is a list which only grows at its head, so lookups need no locks
+std::atomic<InternedName*> internBuckets[kNumInternBuckets] = {};
+} // namespace
+
+namespace igl {
+
+const std::string* detail::internName(std::string name, uint32_t crc32) {
+  std::atomic<InternedName*>& bucket = internBuckets[crc32 % kNumInternBuckets];
+
+  InternedName* head = bucket.load(std::memory_order_acquire);
+  InternedName* newNode = nullptr;
+
+  for (;;) {
+    const std::string& key = newNode ? newNode->name : name;
+    for (const InternedName* node = head; node; node = node->next) {
+      if (node->crc32 == crc32 && node->name == key) {
+        // another thread may have added the same name first
+        delete newNode;
+        return &node->name;
+      }
+    }
+    if (!newNode) {
+      newNode = new InternedName{crc32, std::move(name), head};
+    } else {
+      newNode->next = head;
+    }
+    // on failure, `head` is reloaded and the new entries of the bucket are checked again
+    if (bucket.compare_exchange_weak(
+            head, newNode, std::memory_order_release, std::memory_order_acquire)) {
+      return &newNode->name;
+    }
+  }
+}
+
+const std::string& NameHandle::getEmptyName() {
+  static const std::string empty;
+  return empty;
+}
+
+} // namespace igl
+#endif // IGL_NAMEHANDLE_INTERNED
+
 size_t std::hash<std::vector<igl::NameHandle>>::operator()(
     std::vector<igl::NameHandle> const& key) const {
   size_t hash = 0;
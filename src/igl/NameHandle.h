@@ -86,6 +86,23 @@ uint32_t iglCrc32(const char* data, size_t length);
 #define CHECK_VALID_CRC(a)
 #endif
 
+// With IGL_NAMEHANDLE_INTERNED, every name is stored once in a global string table and NameHandle
+// only holds its CRC32 and a pointer to the table entry, so copying a NameHandle never allocates.
+// Interned names are never freed; do not enable it if names are generated without bound.
+#if !defined(IGL_NAMEHANDLE_INTERNED)
+#define IGL_NAMEHANDLE_INTERNED 0
+#endif
+
+#if IGL_NAMEHANDLE_INTERNED
+namespace detail {
+/**
+ * @brief Returns the entry of the global string table for `name`, adding it if needed. Lock-free
+ * and thread-safe. The entry lives until the process exits.
+ */
+const std::string* IGL_NONNULL internName(std::string name, uint32_t crc32);
+} // namespace detail
+#endif // IGL_NAMEHANDLE_INTERNED
+
 /**
  * @brief Creates a mapping between a string and its equivalent CRC32 handle
  * This way when we need to check if a uniform exists or if it matches another
@@ -99,14 +116,19 @@ class NameHandle {
   NameHandle(const NameHandle& other) = default;
   NameHandle(NameHandle&& other) noexcept = default;
 
+#if IGL_NAMEHANDLE_INTERNED
+  NameHandle(std::string name, uint32_t crc32) :
+    crc32_(crc32), name_(detail::internName(std::move(name), crc32)) {}
+#else
   NameHandle(std::string name, uint32_t crc32) : crc32_(crc32), name_(std::move(name)) {}
+#endif // IGL_NAMEHANDLE_INTERNED
 
   /**
    * @brief Returns a null terminated character array version of the name
    * @returns null terminated character array
    */
   const char* toConstChar() const {
-    return name_.c_str();
+    return toString().c_str();
   }
 
   /**
@@ -114,7 +136,11 @@ class NameHandle {
    * @returns Reference to the actual name string
    */
   const std::string& toString() const {
+#if IGL_NAMEHANDLE_INTERNED
+    return name_ ? *name_ : getEmptyName();
+#else
     return name_;
+#endif // IGL_NAMEHANDLE_INTERNED
   }
 
   /**
@@ -138,15 +164,23 @@ class NameHandle {
   }
 
   operator const char*() const {
-    return name_.c_str();
+    return toConstChar();
   }
 
  private:
 #if IGL_DEBUG
   bool checkIsValidCrcCompare(const NameHandle& nh) const;
 #endif
+#if IGL_NAMEHANDLE_INTERNED
+  static const std::string& getEmptyName();
+#endif // IGL_NAMEHANDLE_INTERNED
+
   uint32_t crc32_ = 0;
+#if IGL_NAMEHANDLE_INTERNED
+  const std::string* IGL_NULLABLE name_ = nullptr; // null for the empty name
+#else
   std::string name_;
+#endif // IGL_NAMEHANDLE_INTERNED
 };
 
 /**
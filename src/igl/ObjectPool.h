@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace igl {
+
+/**
+ * @brief A thread-safe free list of memory blocks of one size and alignment.
+ *
+ * Freed blocks are kept for reuse (at most kMaxFreeBlocks of them), so objects which are created
+ * and destroyed every frame stop going to the heap once the pool is warm. The free list is
+ * intrusive and never allocates itself.
+ */
+template<size_t Size, size_t Alignment>
+class FixedSizeBlockPool final {
+ public:
+  static constexpr size_t kMaxFreeBlocks = 256;
+
+  static FixedSizeBlockPool& get() {
+    // never destroyed: blocks can still be returned while other static objects are destroyed
+    static auto* pool = new FixedSizeBlockPool(); // NOLINT(cppcoreguidelines-owning-memory)
+    return *pool;
+  }
+
+  FixedSizeBlockPool(const FixedSizeBlockPool&) = delete;
+  FixedSizeBlockPool& operator=(const FixedSizeBlockPool&) = delete;
+
+  void* allocate() {
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      if (freeList_) {
+        FreeBlock* block = freeList_;
+        freeList_ = block->next;
+        numFreeBlocks_--;
+        return block;
+      }
+    }
+    return ::operator new(kBlockSize, std::align_val_t(kAlignment));
+  }
+
+  void deallocate(void* ptr) noexcept {
+    if (!ptr) {
+      return;
+    }
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      if (numFreeBlocks_ < kMaxFreeBlocks) {
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next = freeList_;
+        freeList_ = block;
+        numFreeBlocks_++;
+        return;
+      }
+    }
+    ::operator delete(ptr, std::align_val_t(kAlignment));
+  }
+
+  [[nodiscard]] size_t getNumFreeBlocks() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return numFreeBlocks_;
+  }
+
+ private:
+  FixedSizeBlockPool() = default;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static constexpr size_t kBlockSize = Size < sizeof(FreeBlock) ? sizeof(FreeBlock) : Size;
+  static constexpr size_t kAlignment =
+      Alignment < alignof(FreeBlock) ? alignof(FreeBlock) : Alignment;
+
+  mutable std::mutex mutex_;
+  FreeBlock* freeList_ = nullptr;
+  size_t numFreeBlocks_ = 0;
+};
+
+/**
+ * @brief Base class which makes `new T` and `delete` recycle memory through FixedSizeBlockPool.
+ *
+ * Meant for objects like command encoders which are returned by std::unique_ptr and destroyed at
+ * the end of every pass. Classes derived from T with a different size fall back to the heap.
+ */
+template<typename T>
+class Pooled {
+ public:
+  static void* operator new(size_t size) {
+    if (size != sizeof(T)) {
+      return ::operator new(size);
+    }
+    return FixedSizeBlockPool<sizeof(T), alignof(T)>::get().allocate();
+  }
+
+  static void operator delete(void* ptr, size_t size) noexcept {
+    if (size != sizeof(T)) {
+      ::operator delete(ptr);
+      return;
+    }
+    FixedSizeBlockPool<sizeof(T), alignof(T)>::get().deallocate(ptr);
+  }
+};
+
+/**
+ * @brief An allocator over FixedSizeBlockPool for std::allocate_shared(), so objects returned by
+ * std::shared_ptr (e.g. command buffers) reuse their memory, control block included.
+ */
+template<typename T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  PoolAllocator() noexcept = default;
+  template<typename U>
+  PoolAllocator(const PoolAllocator<U>& /*other*/) noexcept {} // NOLINT(google-explicit-constructor)
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+    return static_cast<T*>(FixedSizeBlockPool<sizeof(T), alignof(T)>::get().allocate());
+  }
+
+  void deallocate(T* ptr, size_t n) noexcept {
+    if (n != 1) {
+      ::operator delete(ptr, std::align_val_t(alignof(T)));
+      return;
+    }
+    FixedSizeBlockPool<sizeof(T), alignof(T)>::get().deallocate(ptr);
+  }
+
+  template<typename U>
+  bool operator==(const PoolAllocator<U>& /*other*/) const noexcept {
+    return true;
+  }
+  template<typename U>
+  bool operator!=(const PoolAllocator<U>& /*other*/) const noexcept {
+    return false;
+  }
+};
+
+} // namespace igl
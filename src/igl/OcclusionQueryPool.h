@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Common.h>
+#include <string>
+
+namespace igl {
+
+/**
+ * @brief What an occlusion query reports.
+ *
+ * Binary      : 1 if any sample passed the depth and stencil tests, 0 otherwise.
+ * SampleCount : The number of samples that passed. Only exact on Metal and desktop OpenGL; other
+ *               backends only guarantee a non-zero value when any sample passed.
+ */
+enum class OcclusionQueryType : uint8_t {
+  Binary,
+  SampleCount,
+};
+
+/**
+ * @brief Describes a pool of occlusion queries.
+ *
+ * type      : What every query of the pool reports.
+ * count     : Number of queries the pool can hold.
+ * debugName : Name of the pool shown in debugging tools.
+ */
+struct OcclusionQueryPoolDesc {
+  OcclusionQueryType type = OcclusionQueryType::Binary;
+  uint32_t count = 0;
+  std::string debugName;
+};
+
+/**
+ * @brief A fixed number of occlusion queries, used by passing the pool in
+ * RenderPassDesc::occlusionQueryPool and surrounding draws with
+ * IRenderCommandEncoder::beginOcclusionQuery() / endOcclusionQuery().
+ *
+ * All queries of a pool are reset when a render pass using it begins, so a pool should only be
+ * reused once its previous results have been read. Keeping a ring of pools, one per frame in
+ * flight, lets results be read a few frames later without stalling.
+ */
+class IOcclusionQueryPool {
+ public:
+  virtual ~IOcclusionQueryPool() = default;
+
+  [[nodiscard]] virtual OcclusionQueryType getType() const = 0;
+
+  /**
+   * @returns the number of queries in the pool
+   */
+  [[nodiscard]] virtual uint32_t getCount() const = 0;
+
+  /**
+   * @brief Copies the results of the queries [firstQuery, firstQuery + queryCount) to outResults.
+   * Never blocks.
+   * @returns false, and leaves outResults in an unspecified state, if any of them is not
+   * available yet.
+   */
+  virtual bool getResults(uint32_t firstQuery,
+                          uint32_t queryCount,
+                          uint64_t* IGL_NONNULL outResults) = 0;
+
+ protected:
+  IOcclusionQueryPool() = default;
+};
+
+} // namespace igl
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Common.h>
+
+namespace igl {
+
+/**
+ * @brief The pending result of ITexture::readAsync() or IBuffer::readAsync().
+ *
+ * The GPU copies the data into host-visible memory after all the work submitted before the
+ * readback, while the CPU keeps recording frames. Poll isReady() a few frames later and call
+ * getData() once it returns true; getData() only waits if it is called too early.
+ *
+ * Backends keep a bounded number of readbacks in flight (e.g. VulkanContextConfig::
+ * maxAsyncReadbacks); if too many readbacks are pending, the oldest ones are dropped and their
+ * getData() fails. Releasing a readback without calling getData() discards it.
+ */
+class IReadback {
+ public:
+  virtual ~IReadback() = default;
+
+  /**
+   * @brief Returns true once the data can be retrieved without waiting. Never blocks.
+   */
+  [[nodiscard]] virtual bool isReady() const = 0;
+
+  /**
+   * @brief Returns the size of the data in bytes. Texture rows are tightly packed.
+   */
+  [[nodiscard]] virtual size_t getSizeInBytes() const = 0;
+
+  /**
+   * @brief Copies getSizeInBytes() bytes of data into `outData`, waiting for the GPU if needed.
+   * The data can only be retrieved once.
+   */
+  virtual Result getData(void* IGL_NONNULL outData) = 0;
+
+ protected:
+  IReadback() = default;
+};
+
+} // namespace igl
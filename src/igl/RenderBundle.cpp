@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/RenderBundle.h>
+
+#include <utility>
+
+namespace igl {
+
+IRenderBundle::IRenderBundle(RenderBundleDesc desc) :
+  desc_(std::move(desc)), stream_(std::make_shared<RenderCommandStream>()) {}
+
+bool IRenderBundle::isRecording() const {
+  // the recording encoder shares the stream until it ends
+  return stream_.use_count() > 1;
+}
+
+std::unique_ptr<IRenderCommandEncoder> IRenderBundle::createRenderCommandEncoder(
+    Result* outResult) {
+  if (!IGL_VERIFY(!isRecording())) {
+    Result::setResult(
+        outResult, Result::Code::InvalidOperation, "The render bundle is already recording");
+    return nullptr;
+  }
+
+  stream_->clear();
+  onContentsChanged();
+
+  Result::setOk(outResult);
+  return std::make_unique<RecordingRenderCommandEncoder>(nullptr, stream_);
+}
+
+} // namespace igl
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Common.h>
+#include <igl/RenderCommandEncoder.h>
+#include <igl/RenderCommandStream.h>
+#include <memory>
+#include <string>
+
+namespace igl {
+
+/**
+ * @brief Describes a render bundle.
+ *
+ * debugName : Name of the render bundle shown in debugging tools.
+ */
+struct RenderBundleDesc {
+  std::string debugName;
+};
+
+/**
+ * @brief A sequence of render commands recorded once and executed any number of times inside
+ * render passes with the same attachment formats and sample count, created with
+ * IDevice::createRenderBundle() and executed with IRenderCommandEncoder::executeRenderBundle() or
+ * IParallelRenderCommandEncoder::executeRenderBundle().
+ *
+ * Bundles suit content which is identical from frame to frame, such as static UI or background
+ * geometry. The commands are stored in a RenderCommandStream, with its lifetime rules: objects
+ * bound by std::shared_ptr are retained by the bundle, everything else has to stay alive as long
+ * as the bundle is executed. A bundle starts with no state bound: it has to bind its own pipeline,
+ * resources, viewport and scissor. The state of the executing encoder is undefined afterwards.
+ *
+ * The Vulkan backend runs bundles executed by a parallel render command encoder as secondary
+ * command buffers which are recorded once per compatible render pass and reused by every frame.
+ * The other backends, and regular render command encoders, replay the stream.
+ */
+class IRenderBundle {
+ public:
+  virtual ~IRenderBundle() = default;
+
+  /**
+   * @brief Drops the recorded commands and returns an encoder recording new ones. The bundle can't
+   * be executed until the encoder has ended, and can only be re-recorded once the command buffers
+   * executing it have been submitted.
+   */
+  std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder(Result* IGL_NULLABLE outResult);
+
+  [[nodiscard]] const RenderBundleDesc& getDesc() const {
+    return desc_;
+  }
+  [[nodiscard]] const RenderCommandStream& getCommandStream() const {
+    return *stream_;
+  }
+  /// Returns true while the encoder returned by createRenderCommandEncoder() has not ended
+  [[nodiscard]] bool isRecording() const;
+
+ protected:
+  explicit IRenderBundle(RenderBundleDesc desc);
+
+  /// Called when new commands are recorded, so backends can drop the objects they built from the
+  /// previous ones
+  virtual void onContentsChanged() {}
+
+ private:
+  RenderBundleDesc desc_;
+  std::shared_ptr<RenderCommandStream> stream_;
+};
+
+} // namespace igl
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/RenderCommandEncoder.h>
+
+#include <igl/BindGroup.h>
+#include <igl/RenderBundle.h>
+
+namespace igl {
+
+void IRenderCommandEncoder::bindBindGroup(const IBindGroup& bindGroup) {
+  IGL_PROFILER_FUNCTION();
+
+  const BindGroupDesc& desc = bindGroup.getDesc();
+  const uint32_t textureMask = bindGroup.getTextureMask();
+  for (uint32_t i = 0; i != IGL_TEXTURE_SAMPLERS_MAX; i++) {
+    if ((textureMask & (1u << i)) == 0) {
+      continue;
+    }
+    bindTexture(i, desc.target, desc.textures[i].get());
+    bindSamplerState(i, desc.target, desc.samplers[i].get());
+  }
+  const uint32_t bufferMask = bindGroup.getBufferMask();
+  for (uint32_t i = 0; i != IGL_UNIFORM_BLOCKS_BINDING_MAX; i++) {
+    if ((bufferMask & (1u << i)) == 0) {
+      continue;
+    }
+    bindBuffer(static_cast<int>(i), desc.target, *desc.buffers[i], desc.bufferOffsets[i]);
+  }
+}
+
+void IRenderCommandEncoder::executeRenderBundle(const IRenderBundle& bundle) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(!bundle.isRecording())) {
+    return;
+  }
+  bundle.getCommandStream().replay(*this);
+}
+
+void IParallelRenderCommandEncoder::executeRenderBundle(const IRenderBundle& bundle) {
+  IGL_PROFILER_FUNCTION();
+
+  std::unique_ptr<IRenderCommandEncoder> encoder = createRenderCommandEncoder(nullptr);
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->executeRenderBundle(bundle);
+  encoder->endEncoding();
+}
+
+} // namespace igl
@@ -15,8 +15,10 @@
 
 namespace igl {
 
+class IBindGroup;
 class IBuffer;
 class IDepthStencilState;
+class IRenderBundle;
 class IRenderPipelineState;
 class ISamplerState;
 class ITexture;
@@ -41,6 +43,11 @@ class IRenderCommandEncoder : public ICommandEncoder {
       const std::shared_ptr<IRenderPipelineState>& pipelineState) = 0;
   virtual void bindDepthStencilState(
       const std::shared_ptr<IDepthStencilState>& depthStencilState) = 0;
+  /// The overloads taking references do not retain the object, which saves the reference count
+  /// traffic of a bind. The object has to stay alive until endEncoding(); after that, the backend
+  /// keeps the GPU resources alive until the submitted commands complete, as for bindTexture().
+  virtual void bindRenderPipelineState(IRenderPipelineState& pipelineState) = 0;
+  virtual void bindDepthStencilState(IDepthStencilState& depthStencilState) = 0;
 
   // Binds the buffer to a shader
   //
@@ -55,10 +62,17 @@ class IRenderCommandEncoder : public ICommandEncoder {
                           uint8_t target,
                           const std::shared_ptr<IBuffer>& buffer,
                           size_t bufferOffset) = 0;
+  /// Same as above, without retaining the buffer (see bindRenderPipelineState())
+  virtual void bindBuffer(int index, uint8_t target, IBuffer& buffer, size_t bufferOffset) = 0;
   /// Creates and binds a temporary buffer to the specified buffer index.
   virtual void bindBytes(size_t index, uint8_t target, const void* data, size_t length) = 0;
   /// Binds push constant data to the current encoder.
   virtual void bindPushConstants(const void* data, size_t length, size_t offset = 0) = 0;
+  /// Writes `buffer.gpuAddress(bufferOffset)` as a uint64_t into the push constants at `offset`
+  /// and makes the buffer accessible to the following draws. Shaders read the buffer through the
+  /// pointer (GL_EXT_buffer_reference), so it needs neither a binding slot nor a descriptor update.
+  /// Requires DeviceFeatures::BufferDeviceAddress. `offset` has to be a multiple of 8.
+  virtual void bindBufferAddress(size_t offset, IBuffer& buffer, size_t bufferOffset) = 0;
   virtual void bindSamplerState(size_t index, uint8_t target, ISamplerState* samplerState) = 0;
 
   // For metal, the index parameter is the index in the texture argument table,
@@ -66,15 +80,41 @@ class IRenderCommandEncoder : public ICommandEncoder {
   // For OpenGL, 'index' is the texture unit
   virtual void bindTexture(size_t index, uint8_t target, ITexture* texture) = 0;
 
+  /// Binds all the resources of `bindGroup` (see IDevice::createBindGroup()). The default
+  /// implementation binds the occupied slots one by one. Like the reference overloads, the group
+  /// is not retained: it has to stay alive until endEncoding().
+  virtual void bindBindGroup(const IBindGroup& bindGroup);
+
+  /// Executes the commands of `bundle` (see IDevice::createRenderBundle()). The default
+  /// implementation replays its command stream on this encoder. The currently bound state is
+  /// undefined afterwards. The bundle has to stay alive until endEncoding().
+  virtual void executeRenderBundle(const IRenderBundle& bundle);
+
   /// Binds an individual uniform. Exclusively for use when uniform blocks are not supported.
   virtual void bindUniform(const UniformDesc& uniformDesc, const void* data) = 0;
 
-  virtual void draw(PrimitiveType primitiveType, size_t vertexStart, size_t vertexCount) = 0;
+  /// Draws `instanceCount` instances of `vertexCount` vertices. Instances are numbered from
+  /// `baseInstance`, which offsets the per-instance vertex attributes and the instance index seen
+  /// by the shader. Requires DeviceFeatures::DrawInstanced when `instanceCount` is not 1 and
+  /// DeviceFeatures::DrawBaseInstance when `baseInstance` is not 0.
+  virtual void draw(PrimitiveType primitiveType,
+                    size_t vertexStart,
+                    size_t vertexCount,
+                    uint32_t instanceCount = 1,
+                    uint32_t baseInstance = 0) = 0;
+  /// Draws `instanceCount` instances of `indexCount` indices starting `indexBufferOffset` bytes
+  /// into the index buffer, a multiple of the index size. `baseVertex` is added to every index
+  /// before it fetches the per-vertex attributes, so meshes sharing one vertex buffer can keep
+  /// their own zero-based indices. Requires DeviceFeatures::DrawBaseVertex when `baseVertex` is not
+  /// 0; see draw() for the instances.
   virtual void drawIndexed(PrimitiveType primitiveType,
                            size_t indexCount,
                            IndexFormat indexFormat,
                            IBuffer& indexBuffer,
-                           size_t indexBufferOffset) = 0;
+                           size_t indexBufferOffset,
+                           uint32_t instanceCount = 1,
+                           int32_t baseVertex = 0,
+                           uint32_t baseInstance = 0) = 0;
   // NOTE: indexBufferOffset parameter is supported in Metal but not OpenGL
   virtual void drawIndexedIndirect(PrimitiveType primitiveType,
                                    IndexFormat indexFormat,
@@ -98,6 +138,57 @@ class IRenderCommandEncoder : public ICommandEncoder {
   virtual void setStencilReferenceValues(uint32_t frontValue, uint32_t backValue) = 0;
   virtual void setBlendColor(Color color) = 0;
   virtual void setDepthBias(float depthBias, float slopeScale, float clamp) = 0;
+
+  /**
+   * @brief Starts counting the samples of the following draws into query `queryIndex` of
+   * RenderPassDesc::occlusionQueryPool. Queries can't be nested and each query can only be used
+   * once per render pass. Requires DeviceFeatures::OcclusionQueries.
+   */
+  virtual void beginOcclusionQuery(uint32_t queryIndex) = 0;
+  virtual void endOcclusionQuery() = 0;
+
+  /**
+   * @brief Ends the current subpass of RenderPassDesc::subpasses and begins the next one. The
+   * render pipeline and the resources have to be bound again. Requires DeviceFeatures::Subpasses.
+   */
+  virtual void nextSubpass() = 0;
+};
+
+/**
+ * @brief IParallelRenderCommandEncoder splits one render pass into several render command encoders
+ * which can be recorded on different threads simultaneously.
+ *
+ * Commands of the child encoders are executed in the order the child encoders were created,
+ * regardless of the order they are recorded in. A child encoder starts with no state bound: it has
+ * to bind its own pipeline, resources, viewport and scissor. Every child encoder has to be ended
+ * before endEncoding() is called on the parallel encoder, which ends the render pass.
+ */
+class IParallelRenderCommandEncoder : public ICommandEncoder {
+ public:
+  using ICommandEncoder::ICommandEncoder;
+
+  ~IParallelRenderCommandEncoder() override = default;
+
+  /**
+   * @brief Creates a child encoder for the render pass. This method is thread-safe.
+   * @returns a pointer to the RenderCommandEncoder
+   */
+  virtual std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder(
+      Result* IGL_NULLABLE outResult) = 0;
+
+  // Use an overload here instead of a default parameter in a pure virtual function.
+  std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder() {
+    return createRenderCommandEncoder(nullptr);
+  }
+
+  /**
+   * @brief Executes `bundle` after the commands of the child encoders created so far, as if it
+   * was recorded by a child encoder created now. This method is thread-safe. The default
+   * implementation replays the bundle on a new child encoder; the Vulkan backend executes a
+   * secondary command buffer recorded from the bundle once per compatible render pass. The bundle
+   * has to stay alive until endEncoding().
+   */
+  virtual void executeRenderBundle(const IRenderBundle& bundle);
 };
 
 } // namespace igl
@@ -0,0 +1,657 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/RenderCommandStream.h>
+
+#include <cstring>
+#include <type_traits>
+
+namespace igl {
+
+namespace {
+
+using Command = RenderCommandStream::Command;
+
+constexpr uint32_t kNotRetained = ~0u;
+
+// Packets are read and written with memcpy(), so they have no alignment requirements inside the
+// buffer. `size` covers the packet and its extra bytes.
+struct PacketHeader {
+  Command command;
+  uint32_t size;
+};
+
+struct LabelPacket {
+  uint32_t labelIndex;
+  float color[4];
+};
+
+struct PipelineStatePacket {
+  IRenderPipelineState* pipelineState;
+  uint32_t ownerIndex;
+};
+
+struct DepthStencilStatePacket {
+  IDepthStencilState* depthStencilState;
+  uint32_t ownerIndex;
+};
+
+struct BufferPacket {
+  int index;
+  uint8_t target;
+  uint32_t ownerIndex;
+  IBuffer* buffer;
+  size_t bufferOffset;
+};
+
+// followed by `length` bytes if `hasData`
+struct BytesPacket {
+  size_t index;
+  uint8_t target;
+  bool hasData;
+  size_t length;
+};
+
+// followed by `length` bytes if `hasData`
+struct PushConstantsPacket {
+  bool hasData;
+  size_t length;
+  size_t offset;
+};
+
+struct BufferAddressPacket {
+  size_t offset;
+  IBuffer* buffer;
+  size_t bufferOffset;
+};
+
+struct SamplerStatePacket {
+  size_t index;
+  uint8_t target;
+  ISamplerState* samplerState;
+};
+
+struct TexturePacket {
+  size_t index;
+  uint8_t target;
+  ITexture* texture;
+};
+
+// followed by the uniform data if `hasData`
+struct UniformPacket {
+  uint32_t descIndex;
+  bool hasData;
+};
+
+struct DrawPacket {
+  PrimitiveType primitiveType;
+  size_t vertexStart;
+  size_t vertexCount;
+  uint32_t instanceCount;
+  uint32_t baseInstance;
+};
+
+struct DrawIndexedPacket {
+  PrimitiveType primitiveType;
+  IndexFormat indexFormat;
+  size_t indexCount;
+  IBuffer* indexBuffer;
+  size_t indexBufferOffset;
+  uint32_t instanceCount;
+  int32_t baseVertex;
+  uint32_t baseInstance;
+};
+
+struct DrawIndexedIndirectPacket {
+  PrimitiveType primitiveType;
+  IndexFormat indexFormat;
+  IBuffer* indexBuffer;
+  IBuffer* indirectBuffer;
+  size_t indirectBufferOffset;
+};
+
+struct MultiDrawIndirectPacket {
+  PrimitiveType primitiveType;
+  IndexFormat indexFormat; // unused by multiDrawIndirect()
+  IBuffer* indexBuffer; // nullptr for multiDrawIndirect()
+  IBuffer* indirectBuffer;
+  size_t indirectBufferOffset;
+  uint32_t drawCount;
+  uint32_t stride;
+};
+
+struct StencilReferencePacket {
+  uint32_t frontValue;
+  uint32_t backValue;
+};
+
+struct ColorPacket {
+  float color[4];
+};
+
+struct DepthBiasPacket {
+  float depthBias;
+  float slopeScale;
+  float clamp;
+};
+
+struct QueryPacket {
+  uint32_t queryIndex;
+};
+
+template<typename T>
+T read(const uint8_t* ptr) {
+  static_assert(std::is_trivially_copyable<T>::value, "Packets have to be POD");
+  T packet;
+  memcpy(&packet, ptr, sizeof(T));
+  return packet;
+}
+
+const void* extraData(const uint8_t* payload, size_t packetSize, bool hasData) {
+  return hasData ? payload + packetSize : nullptr;
+}
+
+Color toColor(const float (&c)[4]) {
+  return {c[0], c[1], c[2], c[3]};
+}
+
+size_t getUniformDataSize(const UniformDesc& desc) {
+  return (desc.elementStride != 0 ? desc.elementStride : igl::sizeForUniformType(desc.type)) *
+         desc.numElements;
+}
+
+} // namespace
+
+template<typename T>
+void RenderCommandStream::append(Command command,
+                                 const T& packet,
+                                 const void* extraData,
+                                 size_t extraSize) {
+  static_assert(std::is_trivially_copyable<T>::value, "Packets have to be POD");
+  const PacketHeader header = {command, uint32_t(sizeof(T) + extraSize)};
+  const size_t offset = data_.size();
+  data_.resize(offset + sizeof(header) + header.size);
+  uint8_t* ptr = data_.data() + offset;
+  memcpy(ptr, &header, sizeof(header));
+  memcpy(ptr + sizeof(header), &packet, sizeof(T));
+  if (extraSize) {
+    memcpy(ptr + sizeof(header) + sizeof(T), extraData, extraSize);
+  }
+  numCommands_++;
+}
+
+void RenderCommandStream::append(Command command) {
+  const PacketHeader header = {command, 0};
+  const size_t offset = data_.size();
+  data_.resize(offset + sizeof(header));
+  memcpy(data_.data() + offset, &header, sizeof(header));
+  numCommands_++;
+}
+
+void RenderCommandStream::clear() {
+  data_.clear();
+  numCommands_ = 0;
+  labels_.clear();
+  uniformDescs_.clear();
+  pipelineStates_.clear();
+  depthStencilStates_.clear();
+  buffers_.clear();
+}
+
+void RenderCommandStream::replay(IRenderCommandEncoder& encoder) const {
+  const uint8_t* ptr = data_.data();
+  const uint8_t* end = ptr + data_.size();
+
+  while (ptr != end) {
+    const auto header = read<PacketHeader>(ptr);
+    const uint8_t* payload = ptr + sizeof(PacketHeader);
+    ptr = payload + header.size;
+
+    switch (header.command) {
+    case Command::PushDebugGroupLabel: {
+      const auto p = read<LabelPacket>(payload);
+      encoder.pushDebugGroupLabel(labels_[p.labelIndex], toColor(p.color));
+      break;
+    }
+    case Command::InsertDebugEventLabel: {
+      const auto p = read<LabelPacket>(payload);
+      encoder.insertDebugEventLabel(labels_[p.labelIndex], toColor(p.color));
+      break;
+    }
+    case Command::PopDebugGroupLabel:
+      encoder.popDebugGroupLabel();
+      break;
+    case Command::BindViewport:
+      encoder.bindViewport(read<Viewport>(payload));
+      break;
+    case Command::BindScissorRect:
+      encoder.bindScissorRect(read<ScissorRect>(payload));
+      break;
+    case Command::BindRenderPipelineState: {
+      const auto p = read<PipelineStatePacket>(payload);
+      if (p.ownerIndex != kNotRetained) {
+        encoder.bindRenderPipelineState(pipelineStates_[p.ownerIndex]);
+      } else {
+        encoder.bindRenderPipelineState(*p.pipelineState);
+      }
+      break;
+    }
+    case Command::BindDepthStencilState: {
+      const auto p = read<DepthStencilStatePacket>(payload);
+      if (p.ownerIndex != kNotRetained) {
+        encoder.bindDepthStencilState(depthStencilStates_[p.ownerIndex]);
+      } else {
+        encoder.bindDepthStencilState(*p.depthStencilState);
+      }
+      break;
+    }
+    case Command::BindBuffer: {
+      const auto p = read<BufferPacket>(payload);
+      if (p.ownerIndex != kNotRetained) {
+        encoder.bindBuffer(p.index, p.target, buffers_[p.ownerIndex], p.bufferOffset);
+      } else {
+        encoder.bindBuffer(p.index, p.target, *p.buffer, p.bufferOffset);
+      }
+      break;
+    }
+    case Command::BindBytes: {
+      const auto p = read<BytesPacket>(payload);
+      encoder.bindBytes(p.index, p.target, extraData(payload, sizeof(p), p.hasData), p.length);
+      break;
+    }
+    case Command::BindPushConstants: {
+      const auto p = read<PushConstantsPacket>(payload);
+      encoder.bindPushConstants(extraData(payload, sizeof(p), p.hasData), p.length, p.offset);
+      break;
+    }
+    case Command::BindBufferAddress: {
+      const auto p = read<BufferAddressPacket>(payload);
+      encoder.bindBufferAddress(p.offset, *p.buffer, p.bufferOffset);
+      break;
+    }
+    case Command::BindSamplerState: {
+      const auto p = read<SamplerStatePacket>(payload);
+      encoder.bindSamplerState(p.index, p.target, p.samplerState);
+      break;
+    }
+    case Command::BindTexture: {
+      const auto p = read<TexturePacket>(payload);
+      encoder.bindTexture(p.index, p.target, p.texture);
+      break;
+    }
+    case Command::BindUniform: {
+      const auto p = read<UniformPacket>(payload);
+      encoder.bindUniform(uniformDescs_[p.descIndex], extraData(payload, sizeof(p), p.hasData));
+      break;
+    }
+    case Command::Draw: {
+      const auto p = read<DrawPacket>(payload);
+      encoder.draw(p.primitiveType, p.vertexStart, p.vertexCount, p.instanceCount, p.baseInstance);
+      break;
+    }
+    case Command::DrawIndexed: {
+      const auto p = read<DrawIndexedPacket>(payload);
+      encoder.drawIndexed(p.primitiveType,
+                          p.indexCount,
+                          p.indexFormat,
+                          *p.indexBuffer,
+                          p.indexBufferOffset,
+                          p.instanceCount,
+                          p.baseVertex,
+                          p.baseInstance);
+      break;
+    }
+    case Command::DrawIndexedIndirect: {
+      const auto p = read<DrawIndexedIndirectPacket>(payload);
+      encoder.drawIndexedIndirect(p.primitiveType,
+                                  p.indexFormat,
+                                  *p.indexBuffer,
+                                  *p.indirectBuffer,
+                                  p.indirectBufferOffset);
+      break;
+    }
+    case Command::MultiDrawIndirect: {
+      const auto p = read<MultiDrawIndirectPacket>(payload);
+      encoder.multiDrawIndirect(
+          p.primitiveType, *p.indirectBuffer, p.indirectBufferOffset, p.drawCount, p.stride);
+      break;
+    }
+    case Command::MultiDrawIndexedIndirect: {
+      const auto p = read<MultiDrawIndirectPacket>(payload);
+      encoder.multiDrawIndexedIndirect(p.primitiveType,
+                                       p.indexFormat,
+                                       *p.indexBuffer,
+                                       *p.indirectBuffer,
+                                       p.indirectBufferOffset,
+                                       p.drawCount,
+                                       p.stride);
+      break;
+    }
+    case Command::SetStencilReferenceValue:
+      encoder.setStencilReferenceValue(read<StencilReferencePacket>(payload).frontValue);
+      break;
+    case Command::SetStencilReferenceValues: {
+      const auto p = read<StencilReferencePacket>(payload);
+      encoder.setStencilReferenceValues(p.frontValue, p.backValue);
+      break;
+    }
+    case Command::SetBlendColor:
+      encoder.setBlendColor(toColor(read<ColorPacket>(payload).color));
+      break;
+    case Command::SetDepthBias: {
+      const auto p = read<DepthBiasPacket>(payload);
+      encoder.setDepthBias(p.depthBias, p.slopeScale, p.clamp);
+      break;
+    }
+    case Command::BeginOcclusionQuery:
+      encoder.beginOcclusionQuery(read<QueryPacket>(payload).queryIndex);
+      break;
+    case Command::EndOcclusionQuery:
+      encoder.endOcclusionQuery();
+      break;
+    case Command::NextSubpass:
+      encoder.nextSubpass();
+      break;
+    }
+  }
+}
+
+RecordingRenderCommandEncoder::RecordingRenderCommandEncoder(
+    std::shared_ptr<ICommandBuffer> commandBuffer,
+    std::shared_ptr<RenderCommandStream> stream) :
+  IRenderCommandEncoder(std::move(commandBuffer)), stream_(std::move(stream)) {
+  IGL_ASSERT(stream_);
+}
+
+RenderCommandStream* RecordingRenderCommandEncoder::getStream() const {
+  // the encoder has ended
+  return IGL_VERIFY(stream_) ? stream_.get() : nullptr;
+}
+
+void RecordingRenderCommandEncoder::endEncoding() {
+  stream_ = nullptr;
+}
+
+void RecordingRenderCommandEncoder::pushDebugGroupLabel(const std::string& label,
+                                                        const igl::Color& color) const {
+  if (auto* s = getStream()) {
+    s->labels_.push_back(label);
+    s->append(Command::PushDebugGroupLabel,
+              LabelPacket{uint32_t(s->labels_.size() - 1), {color.r, color.g, color.b, color.a}});
+  }
+}
+
+void RecordingRenderCommandEncoder::insertDebugEventLabel(const std::string& label,
+                                                          const igl::Color& color) const {
+  if (auto* s = getStream()) {
+    s->labels_.push_back(label);
+    s->append(Command::InsertDebugEventLabel,
+              LabelPacket{uint32_t(s->labels_.size() - 1), {color.r, color.g, color.b, color.a}});
+  }
+}
+
+void RecordingRenderCommandEncoder::popDebugGroupLabel() const {
+  if (auto* s = getStream()) {
+    s->append(Command::PopDebugGroupLabel);
+  }
+}
+
+void RecordingRenderCommandEncoder::bindViewport(const Viewport& viewport) {
+  if (auto* s = getStream()) {
+    s->append(Command::BindViewport, viewport);
+  }
+}
+
+void RecordingRenderCommandEncoder::bindScissorRect(const ScissorRect& rect) {
+  if (auto* s = getStream()) {
+    s->append(Command::BindScissorRect, rect);
+  }
+}
+
+void RecordingRenderCommandEncoder::bindRenderPipelineState(
+    const std::shared_ptr<IRenderPipelineState>& pipelineState) {
+  if (auto* s = getStream()) {
+    s->pipelineStates_.push_back(pipelineState);
+    s->append(Command::BindRenderPipelineState,
+              PipelineStatePacket{pipelineState.get(), uint32_t(s->pipelineStates_.size() - 1)});
+  }
+}
+
+void RecordingRenderCommandEncoder::bindDepthStencilState(
+    const std::shared_ptr<IDepthStencilState>& depthStencilState) {
+  if (auto* s = getStream()) {
+    s->depthStencilStates_.push_back(depthStencilState);
+    s->append(Command::BindDepthStencilState,
+              DepthStencilStatePacket{depthStencilState.get(),
+                                      uint32_t(s->depthStencilStates_.size() - 1)});
+  }
+}
+
+void RecordingRenderCommandEncoder::bindRenderPipelineState(IRenderPipelineState& pipelineState) {
+  if (auto* s = getStream()) {
+    s->append(Command::BindRenderPipelineState, PipelineStatePacket{&pipelineState, kNotRetained});
+  }
+}
+
+void RecordingRenderCommandEncoder::bindDepthStencilState(IDepthStencilState& depthStencilState) {
+  if (auto* s = getStream()) {
+    s->append(Command::BindDepthStencilState,
+              DepthStencilStatePacket{&depthStencilState, kNotRetained});
+  }
+}
+
+void RecordingRenderCommandEncoder::bindBuffer(int index,
+                                               uint8_t target,
+                                               const std::shared_ptr<IBuffer>& buffer,
+                                               size_t bufferOffset) {
+  if (auto* s = getStream()) {
+    s->buffers_.push_back(buffer);
+    s->append(Command::BindBuffer,
+              BufferPacket{index,
+                           target,
+                           uint32_t(s->buffers_.size() - 1),
+                           buffer.get(),
+                           bufferOffset});
+  }
+}
+
+void RecordingRenderCommandEncoder::bindBuffer(int index,
+                                               uint8_t target,
+                                               IBuffer& buffer,
+                                               size_t bufferOffset) {
+  if (auto* s = getStream()) {
+    s->append(Command::BindBuffer,
+              BufferPacket{index, target, kNotRetained, &buffer, bufferOffset});
+  }
+}
+
+void RecordingRenderCommandEncoder::bindBytes(size_t index,
+                                              uint8_t target,
+                                              const void* data,
+                                              size_t length) {
+  if (auto* s = getStream()) {
+    const bool hasData = data && length;
+    s->append(Command::BindBytes,
+              BytesPacket{index, target, hasData, length},
+              data,
+              hasData ? length : 0);
+  }
+}
+
+void RecordingRenderCommandEncoder::bindPushConstants(const void* data,
+                                                      size_t length,
+                                                      size_t offset) {
+  if (auto* s = getStream()) {
+    const bool hasData = data && length;
+    s->append(Command::BindPushConstants,
+              PushConstantsPacket{hasData, length, offset},
+              data,
+              hasData ? length : 0);
+  }
+}
+
+void RecordingRenderCommandEncoder::bindBufferAddress(size_t offset,
+                                                      IBuffer& buffer,
+                                                      size_t bufferOffset) {
+  if (auto* s = getStream()) {
+    s->append(Command::BindBufferAddress, BufferAddressPacket{offset, &buffer, bufferOffset});
+  }
+}
+
+void RecordingRenderCommandEncoder::bindSamplerState(size_t index,
+                                                     uint8_t target,
+                                                     ISamplerState* samplerState) {
+  if (auto* s = getStream()) {
+    s->append(Command::BindSamplerState, SamplerStatePacket{index, target, samplerState});
+  }
+}
+
+void RecordingRenderCommandEncoder::bindTexture(size_t index, uint8_t target, ITexture* texture) {
+  if (auto* s = getStream()) {
+    s->append(Command::BindTexture, TexturePacket{index, target, texture});
+  }
+}
+
+void RecordingRenderCommandEncoder::bindUniform(const UniformDesc& uniformDesc,
+                                                const void* data) {
+  if (auto* s = getStream()) {
+    // the data only has to stay valid for the duration of this call
+    const size_t length = getUniformDataSize(uniformDesc);
+    const bool hasData = data && length;
+    s->uniformDescs_.push_back(uniformDesc);
+    s->uniformDescs_.back().offset = 0;
+    s->append(Command::BindUniform,
+              UniformPacket{uint32_t(s->uniformDescs_.size() - 1), hasData},
+              hasData ? static_cast<const uint8_t*>(data) + uniformDesc.offset : nullptr,
+              hasData ? length : 0);
+  }
+}
+
+void RecordingRenderCommandEncoder::draw(PrimitiveType primitiveType,
+                                         size_t vertexStart,
+                                         size_t vertexCount,
+                                         uint32_t instanceCount,
+                                         uint32_t baseInstance) {
+  if (auto* s = getStream()) {
+    s->append(Command::Draw,
+              DrawPacket{primitiveType, vertexStart, vertexCount, instanceCount, baseInstance});
+  }
+}
+
+void RecordingRenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
+                                                size_t indexCount,
+                                                IndexFormat indexFormat,
+                                                IBuffer& indexBuffer,
+                                                size_t indexBufferOffset,
+                                                uint32_t instanceCount,
+                                                int32_t baseVertex,
+                                                uint32_t baseInstance) {
+  if (auto* s = getStream()) {
+    s->append(Command::DrawIndexed,
+              DrawIndexedPacket{primitiveType,
+                                indexFormat,
+                                indexCount,
+                                &indexBuffer,
+                                indexBufferOffset,
+                                instanceCount,
+                                baseVertex,
+                                baseInstance});
+  }
+}
+
+void RecordingRenderCommandEncoder::drawIndexedIndirect(PrimitiveType primitiveType,
+                                                        IndexFormat indexFormat,
+                                                        IBuffer& indexBuffer,
+                                                        IBuffer& indirectBuffer,
+                                                        size_t indirectBufferOffset) {
+  if (auto* s = getStream()) {
+    s->append(Command::DrawIndexedIndirect,
+              DrawIndexedIndirectPacket{
+                  primitiveType, indexFormat, &indexBuffer, &indirectBuffer, indirectBufferOffset});
+  }
+}
+
+void RecordingRenderCommandEncoder::multiDrawIndirect(PrimitiveType primitiveType,
+                                                      IBuffer& indirectBuffer,
+                                                      size_t indirectBufferOffset,
+                                                      uint32_t drawCount,
+                                                      uint32_t stride) {
+  if (auto* s = getStream()) {
+    s->append(Command::MultiDrawIndirect,
+              MultiDrawIndirectPacket{primitiveType,
+                                      IndexFormat::UInt16,
+                                      nullptr,
+                                      &indirectBuffer,
+                                      indirectBufferOffset,
+                                      drawCount,
+                                      stride});
+  }
+}
+
+void RecordingRenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType primitiveType,
+                                                             IndexFormat indexFormat,
+                                                             IBuffer& indexBuffer,
+                                                             IBuffer& indirectBuffer,
+                                                             size_t indirectBufferOffset,
+                                                             uint32_t drawCount,
+                                                             uint32_t stride) {
+  if (auto* s = getStream()) {
+    s->append(Command::MultiDrawIndexedIndirect,
+              MultiDrawIndirectPacket{primitiveType,
+                                      indexFormat,
+                                      &indexBuffer,
+                                      &indirectBuffer,
+                                      indirectBufferOffset,
+                                      drawCount,
+                                      stride});
+  }
+}
+
+void RecordingRenderCommandEncoder::setStencilReferenceValue(uint32_t value) {
+  if (auto* s = getStream()) {
+    s->append(Command::SetStencilReferenceValue, StencilReferencePacket{value, value});
+  }
+}
+
+void RecordingRenderCommandEncoder::setStencilReferenceValues(uint32_t frontValue,
+                                                              uint32_t backValue) {
+  if (auto* s = getStream()) {
+    s->append(Command::SetStencilReferenceValues, StencilReferencePacket{frontValue, backValue});
+  }
+}
+
+void RecordingRenderCommandEncoder::setBlendColor(Color color) {
+  if (auto* s = getStream()) {
+    s->append(Command::SetBlendColor, ColorPacket{{color.r, color.g, color.b, color.a}});
+  }
+}
+
+void RecordingRenderCommandEncoder::setDepthBias(float depthBias, float slopeScale, float clamp) {
+  if (auto* s = getStream()) {
+    s->append(Command::SetDepthBias, DepthBiasPacket{depthBias, slopeScale, clamp});
+  }
+}
+
+void RecordingRenderCommandEncoder::beginOcclusionQuery(uint32_t queryIndex) {
+  if (auto* s = getStream()) {
+    s->append(Command::BeginOcclusionQuery, QueryPacket{queryIndex});
+  }
+}
+
+void RecordingRenderCommandEncoder::endOcclusionQuery() {
+  if (auto* s = getStream()) {
+    s->append(Command::EndOcclusionQuery);
+  }
+}
+
+void RecordingRenderCommandEncoder::nextSubpass() {
+  if (auto* s = getStream()) {
+    s->append(Command::NextSubpass);
+  }
+}
+
+} // namespace igl
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <igl/RenderCommandEncoder.h>
+
+namespace igl {
+
+/**
+ * @brief A CPU-side recording of render commands. Every command is stored as a small POD packet
+ * (a command type, its arguments, and the bytes of bindBytes()/bindPushConstants()/bindUniform())
+ * in one linear buffer, so recording does no per-command heap allocations once the buffer has
+ * grown, and replay() is a single loop over the buffer.
+ *
+ * Recorded with RecordingRenderCommandEncoder. A stream can be filled on one thread and replayed on
+ * another, but it is not thread-safe itself.
+ *
+ * Objects bound with the std::shared_ptr overloads are retained by the stream and re-bound with the
+ * same overloads on replay. Everything else (references, textures, sampler states) is recorded as
+ * a pointer and has to stay alive until the stream is replayed and the target encoder has ended.
+ */
+class RenderCommandStream final {
+ public:
+  enum class Command : uint8_t {
+    PushDebugGroupLabel,
+    InsertDebugEventLabel,
+    PopDebugGroupLabel,
+    BindViewport,
+    BindScissorRect,
+    BindRenderPipelineState,
+    BindDepthStencilState,
+    BindBuffer,
+    BindBytes,
+    BindPushConstants,
+    BindBufferAddress,
+    BindSamplerState,
+    BindTexture,
+    BindUniform,
+    Draw,
+    DrawIndexed,
+    DrawIndexedIndirect,
+    MultiDrawIndirect,
+    MultiDrawIndexedIndirect,
+    SetStencilReferenceValue,
+    SetStencilReferenceValues,
+    SetBlendColor,
+    SetDepthBias,
+    BeginOcclusionQuery,
+    EndOcclusionQuery,
+    NextSubpass,
+  };
+
+  /// Issues every recorded command, in order, on `encoder`. The stream is left unchanged.
+  void replay(IRenderCommandEncoder& encoder) const;
+
+  /// Drops all the commands and the retained objects, keeping the allocated memory for reuse
+  void clear();
+
+  [[nodiscard]] bool empty() const {
+    return numCommands_ == 0;
+  }
+  [[nodiscard]] size_t getNumCommands() const {
+    return numCommands_;
+  }
+  /// Size of the packet buffer in bytes
+  [[nodiscard]] size_t getSizeInBytes() const {
+    return data_.size();
+  }
+
+ private:
+  friend class RecordingRenderCommandEncoder;
+
+  template<typename T>
+  void append(Command command,
+              const T& packet,
+              const void* extraData = nullptr,
+              size_t extraSize = 0);
+  void append(Command command);
+
+  std::vector<uint8_t> data_;
+  size_t numCommands_ = 0;
+
+  // side tables for the arguments which are not POD; packets store indices into them
+  std::vector<std::string> labels_;
+  std::vector<UniformDesc> uniformDescs_;
+  std::vector<std::shared_ptr<IRenderPipelineState>> pipelineStates_;
+  std::vector<std::shared_ptr<IDepthStencilState>> depthStencilStates_;
+  std::vector<std::shared_ptr<IBuffer>> buffers_;
+};
+
+/**
+ * @brief A render command encoder which records its commands into a RenderCommandStream instead of
+ * executing them. endEncoding() only stops the recording; the stream is replayed separately.
+ */
+class RecordingRenderCommandEncoder final : public IRenderCommandEncoder {
+ public:
+  RecordingRenderCommandEncoder(std::shared_ptr<ICommandBuffer> commandBuffer,
+                                std::shared_ptr<RenderCommandStream> stream);
+
+  void endEncoding() override;
+
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
+  void popDebugGroupLabel() const override;
+
+  void bindViewport(const Viewport& viewport) override;
+  void bindScissorRect(const ScissorRect& rect) override;
+
+  void bindRenderPipelineState(const std::shared_ptr<IRenderPipelineState>& pipelineState) override;
+  void bindDepthStencilState(const std::shared_ptr<IDepthStencilState>& depthStencilState) override;
+  void bindRenderPipelineState(IRenderPipelineState& pipelineState) override;
+  void bindDepthStencilState(IDepthStencilState& depthStencilState) override;
+
+  void bindBuffer(int index,
+                  uint8_t target,
+                  const std::shared_ptr<IBuffer>& buffer,
+                  size_t bufferOffset) override;
+  void bindBuffer(int index, uint8_t target, IBuffer& buffer, size_t bufferOffset) override;
+  void bindBytes(size_t index, uint8_t target, const void* data, size_t length) override;
+  void bindPushConstants(const void* data, size_t length, size_t offset) override;
+  void bindBufferAddress(size_t offset, IBuffer& buffer, size_t bufferOffset) override;
+  void bindSamplerState(size_t index, uint8_t target, ISamplerState* samplerState) override;
+  void bindTexture(size_t index, uint8_t target, ITexture* texture) override;
+  void bindUniform(const UniformDesc& uniformDesc, const void* data) override;
+
+  void draw(PrimitiveType primitiveType,
+            size_t vertexStart,
+            size_t vertexCount,
+            uint32_t instanceCount = 1,
+            uint32_t baseInstance = 0) override;
+  void drawIndexed(PrimitiveType primitiveType,
+                   size_t indexCount,
+                   IndexFormat indexFormat,
+                   IBuffer& indexBuffer,
+                   size_t indexBufferOffset,
+                   uint32_t instanceCount = 1,
+                   int32_t baseVertex = 0,
+                   uint32_t baseInstance = 0) override;
+  void drawIndexedIndirect(PrimitiveType primitiveType,
+                           IndexFormat indexFormat,
+                           IBuffer& indexBuffer,
+                           IBuffer& indirectBuffer,
+                           size_t indirectBufferOffset) override;
+  void multiDrawIndirect(PrimitiveType primitiveType,
+                         IBuffer& indirectBuffer,
+                         size_t indirectBufferOffset,
+                         uint32_t drawCount,
+                         uint32_t stride) override;
+  void multiDrawIndexedIndirect(PrimitiveType primitiveType,
+                                IndexFormat indexFormat,
+                                IBuffer& indexBuffer,
+                                IBuffer& indirectBuffer,
+                                size_t indirectBufferOffset,
+                                uint32_t drawCount,
+                                uint32_t stride) override;
+
+  void setStencilReferenceValue(uint32_t value) override;
+  void setStencilReferenceValues(uint32_t frontValue, uint32_t backValue) override;
+  void setBlendColor(Color color) override;
+  void setDepthBias(float depthBias, float slopeScale, float clamp) override;
+
+  void beginOcclusionQuery(uint32_t queryIndex) override;
+  void endOcclusionQuery() override;
+
+  void nextSubpass() override;
+
+ private:
+  // returns nullptr once the encoder has ended
+  RenderCommandStream* getStream() const;
+
+  std::shared_ptr<RenderCommandStream> stream_;
+};
+
+} // namespace igl
@@ -8,11 +8,13 @@
 #pragma once
 
 #include <igl/Common.h>
+#include <memory>
 #include <vector>
 
 namespace igl {
 
 class IFramebuffer;
+class IOcclusionQueryPool;
 class ITexture;
 
 /**
@@ -31,18 +33,29 @@ enum class LoadAction : uint8_t {
 
 /**
  * @brief StoreAction determines the resolution action of the various components of a
- * RenderPassDesc. This can be DontCare, Store, or MsaaResolve.
+ * RenderPassDesc. This can be DontCare, Store, MsaaResolve or StoreAndMsaaResolve.
  *
  * DontCare : No specific operation required.
  * Store : Preserve render contents
- * MsaaResolve : Use MSAA to preserve render contents
+ * MsaaResolve : Resolve the multisampled contents into the resolve texture of the attachment and
+ *               discard them. The resolve happens on-tile on tiled GPUs, so the multisampled
+ *               texture can be ResourceStorage::Memoryless.
+ * StoreAndMsaaResolve : Resolve the multisampled contents and preserve them too
  */
 enum class StoreAction : uint8_t {
   DontCare,
   Store,
   MsaaResolve,
+  StoreAndMsaaResolve,
 };
 
+/**
+ * @brief Returns true if the store action resolves the multisampled contents of an attachment
+ */
+inline bool isMsaaResolve(StoreAction action) {
+  return action == StoreAction::MsaaResolve || action == StoreAction::StoreAndMsaaResolve;
+}
+
 /**
  * @brief MsaaDepthResolveFilter determines the MSAA algorithm used. This can be Sample0, Min, or
  * Max.
@@ -103,6 +116,20 @@ struct RenderPassDesc {
     uint32_t clearStencil = 0;
   };
 
+  /**
+   * @brief SubpassDesc describes one subpass of a render pass with several subpasses.
+   *
+   * colorAttachments : The indices of the color attachments the subpass renders to
+   * inputAttachments : The indices of color attachments rendered to by previous subpasses, which
+   *                    the fragment shaders of the subpass read at the current pixel
+   * usesDepthStencil : The subpass uses the depth and stencil attachments
+   */
+  struct SubpassDesc {
+    std::vector<uint8_t> colorAttachments;
+    std::vector<uint8_t> inputAttachments;
+    bool usesDepthStencil = true;
+  };
+
   /**
    * @brief colorAttachments properties which is empty by default.
    */
@@ -115,6 +142,28 @@ struct RenderPassDesc {
    * @brief stencilAttachment property which is clear to 0 by default
    */
   StencilAttachmentDesc stencilAttachment;
+  /**
+   * @brief Pool used by IRenderCommandEncoder::beginOcclusionQuery() in this render pass. All of
+   * its queries are reset when the render pass begins.
+   */
+  std::shared_ptr<IOcclusionQueryPool> occlusionQueryPool;
+  /**
+   * @brief The subpasses of the render pass; empty for a single subpass rendering to all the
+   * attachments. Requires DeviceFeatures::Subpasses. The render pass begins with the first subpass
+   * and IRenderCommandEncoder::nextSubpass() moves to the next one. Load actions apply when an
+   * attachment is first used, store and resolve actions after its last use, and the intermediate
+   * contents stay in tile memory on tiled GPUs.
+   *
+   * Input attachments are read by fragment shaders with:
+   *  - Vulkan: `layout(input_attachment_index = i, set = 4, binding = i) uniform subpassInput`,
+   *    where `i` is the position in SubpassDesc::inputAttachments;
+   *  - Metal: programmable blending, i.e. `[[color(n)]]` fragment inputs with the index of the
+   *    attachment. All the color attachments are bound in all the subpasses;
+   *  - OpenGL ES: GL_EXT_shader_framebuffer_fetch, i.e. `inout` color outputs. All the color
+   *    attachments are bound in all the subpasses.
+   * Render pipelines are created for one subpass, see RenderPipelineDesc::subpassIndex.
+   */
+  std::vector<SubpassDesc> subpasses;
 };
 
 } // namespace igl
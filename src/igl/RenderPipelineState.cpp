@@ -77,8 +77,15 @@ bool RenderPipelineDesc::operator==(const RenderPipelineDesc& other) const {
   if (uniformBlockBindingMap != other.uniformBlockBindingMap) {
     return false;
   }
+  if (immutableSamplers != other.immutableSamplers) {
+    return false;
+  }
 
-  if (sampleCount != other.sampleCount) {
+  if (sampleCount != other.sampleCount || subpassIndex != other.subpassIndex) {
+    return false;
+  }
+
+  if (supportIndirectCommandBuffers != other.supportIndirectCommandBuffers) {
     return false;
   }
 
@@ -89,6 +96,23 @@ bool RenderPipelineDesc::operator==(const RenderPipelineDesc& other) const {
   return true;
 }
 
+namespace {
+
+/// Hashes the pairs of an unordered map independently of its iteration order, which differs
+/// between equal maps with different insertion histories
+template<typename Map, typename HashPair>
+size_t hashUnorderedMap(const Map& map, HashPair&& hashPair) {
+  size_t hash = map.size();
+  size_t sum = 0;
+  for (const auto& p : map) {
+    sum += hashPair(p);
+  }
+  hashCombine(hash, sum);
+  return hash;
+}
+
+} // namespace
+
 /// The underlying assumption for this hash is all of the shared pointers in
 /// this structure can uniquely identify the object they are pointing to.
 /// It is the responsibility of the caller of this function to make sure
@@ -96,27 +120,37 @@ bool RenderPipelineDesc::operator==(const RenderPipelineDesc& other) const {
 size_t std::hash<RenderPipelineDesc>::operator()(RenderPipelineDesc const& key) const {
   size_t hash = std::hash<uintptr_t>()(reinterpret_cast<uintptr_t>(key.vertexInputState.get()));
 
-  hash ^= std::hash<uintptr_t>()(reinterpret_cast<uintptr_t>(key.shaderStages.get()));
-  hash ^= std::hash<RenderPipelineDesc::TargetDesc>()(key.targetDesc);
-  hash ^= std::hash<int>()(EnumToValue(key.cullMode));
-  hash ^= std::hash<int>()(key.sampleCount);
-  hash ^= std::hash<int>()(EnumToValue(key.frontFaceWinding));
-  hash ^= std::hash<int>()(EnumToValue(key.polygonFillMode));
-  hash ^= std::hash<igl::NameHandle>()(key.debugName);
-
-  for (const auto& i : key.vertexUnitSamplerMap) {
-    hash ^= std::hash<size_t>()(i.first);
-    hash ^= std::hash<igl::NameHandle>()(i.second);
-  }
-  for (const auto& i : key.fragmentUnitSamplerMap) {
-    hash ^= std::hash<size_t>()(i.first);
-    hash ^= std::hash<igl::NameHandle>()(i.second);
-  }
-  for (const auto& i : key.uniformBlockBindingMap) {
-    hash ^= std::hash<size_t>()(i.first);
-    hash ^= std::hash<igl::NameHandle>()(i.second.first);
-    hash ^= std::hash<igl::NameHandle>()(i.second.second);
-  }
+  hashCombine(hash, std::hash<uintptr_t>()(reinterpret_cast<uintptr_t>(key.shaderStages.get())));
+  hashCombine(hash, std::hash<RenderPipelineDesc::TargetDesc>()(key.targetDesc));
+  hashCombine(hash, EnumToValue(key.cullMode));
+  hashCombine(hash, std::hash<int>()(key.sampleCount));
+  hashCombine(hash, key.subpassIndex);
+  hashCombine(hash, key.supportIndirectCommandBuffers);
+  hashCombine(hash, EnumToValue(key.frontFaceWinding));
+  hashCombine(hash, EnumToValue(key.polygonFillMode));
+  hashCombine(hash, std::hash<igl::NameHandle>()(key.debugName));
+
+  auto hashSamplerPair = [](const std::pair<const size_t, igl::NameHandle>& p) {
+    size_t h = p.first;
+    hashCombine(h, std::hash<igl::NameHandle>()(p.second));
+    return h;
+  };
+  hashCombine(hash, hashUnorderedMap(key.vertexUnitSamplerMap, hashSamplerPair));
+  hashCombine(hash, hashUnorderedMap(key.fragmentUnitSamplerMap, hashSamplerPair));
+  hashCombine(hash,
+              hashUnorderedMap(key.uniformBlockBindingMap,
+                               [](const auto& p) {
+                                 size_t h = p.first;
+                                 hashCombine(h, std::hash<igl::NameHandle>()(p.second.first));
+                                 hashCombine(h, std::hash<igl::NameHandle>()(p.second.second));
+                                 return h;
+                               }));
+  hashCombine(hash,
+              hashUnorderedMap(key.immutableSamplers, [](const auto& p) {
+                size_t h = p.first;
+                hashCombine(h, std::hash<uintptr_t>()(reinterpret_cast<uintptr_t>(p.second.get())));
+                return h;
+              }));
 
   return hash;
 }
@@ -125,11 +159,11 @@ size_t std::hash<RenderPipelineDesc::TargetDesc>::operator()(
     RenderPipelineDesc::TargetDesc const& key) const {
   size_t hash = std::hash<int>()(EnumToValue(key.depthAttachmentFormat));
 
-  hash ^= std::hash<int>()(EnumToValue(key.stencilAttachmentFormat));
-  hash ^= std::hash<size_t>()(key.colorAttachments.size());
+  hashCombine(hash, std::hash<int>()(EnumToValue(key.stencilAttachmentFormat)));
+  hashCombine(hash, key.colorAttachments.size());
 
   for (const auto& ca : key.colorAttachments) {
-    hash ^= std::hash<RenderPipelineDesc::TargetDesc::ColorAttachment>()(ca);
+    hashCombine(hash, std::hash<RenderPipelineDesc::TargetDesc::ColorAttachment>()(ca));
   }
 
   return hash;
@@ -138,13 +172,13 @@ size_t std::hash<RenderPipelineDesc::TargetDesc>::operator()(
 size_t std::hash<RenderPipelineDesc::TargetDesc::ColorAttachment>::operator()(
     RenderPipelineDesc::TargetDesc::ColorAttachment const& key) const {
   size_t hash = std::hash<int>()(EnumToValue(key.textureFormat));
-  hash ^= std::hash<uint8_t>()(key.colorWriteBits);
-  hash ^= std::hash<bool>()(key.blendEnabled);
-  hash ^= std::hash<int>()(EnumToValue(key.rgbBlendOp));
-  hash ^= std::hash<int>()(EnumToValue(key.alphaBlendOp));
-  hash ^= std::hash<int>()(EnumToValue(key.srcRGBBlendFactor));
-  hash ^= std::hash<int>()(EnumToValue(key.srcAlphaBlendFactor));
-  hash ^= std::hash<int>()(EnumToValue(key.dstRGBBlendFactor));
-  hash ^= std::hash<int>()(EnumToValue(key.dstAlphaBlendFactor));
+  hashCombine(hash, key.colorWriteBits);
+  hashCombine(hash, key.blendEnabled);
+  hashCombine(hash, EnumToValue(key.rgbBlendOp));
+  hashCombine(hash, EnumToValue(key.alphaBlendOp));
+  hashCombine(hash, EnumToValue(key.srcRGBBlendFactor));
+  hashCombine(hash, EnumToValue(key.srcAlphaBlendFactor));
+  hashCombine(hash, EnumToValue(key.dstRGBBlendFactor));
+  hashCombine(hash, EnumToValue(key.dstAlphaBlendFactor));
   return hash;
 }
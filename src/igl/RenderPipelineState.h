@@ -17,6 +17,7 @@
 
 namespace igl {
 
+class ISamplerState;
 class IShaderModule;
 class IVertexInputState;
 
@@ -197,8 +198,27 @@ struct RenderPipelineDesc {
    */
   std::unordered_map<size_t, std::pair<igl::NameHandle, igl::NameHandle>> uniformBlockBindingMap;
 
+  /*
+   * Vulkan Only: Samplers baked into the pipeline layout, keyed by texture unit
+   * (< IGL_TEXTURE_SAMPLERS_MAX). The samplers bound to these units are ignored, so draws only
+   * update the textures. The fallback pipeline of a pipeline with immutable samplers should
+   * declare the same samplers.
+   */
+  std::unordered_map<size_t, std::shared_ptr<ISamplerState>> immutableSamplers;
+
   int sampleCount = 1;
 
+  /*
+   * @brief The subpass of RenderPassDesc::subpasses the pipeline is used in. `targetDesc` describes
+   * the attachments of that subpass on Vulkan and all the attachments on Metal and OpenGL.
+   */
+  uint8_t subpassIndex = 0;
+
+  /*
+   * Metal Only: The pipeline can be used by draws of a metal::IndirectCommandBuffer
+   */
+  bool supportIndirectCommandBuffers = false;
+
   igl::NameHandle debugName;
 
   bool operator==(const RenderPipelineDesc& other) const;
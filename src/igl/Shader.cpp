@@ -56,15 +56,62 @@ size_t safeCStrHash(const char* IGL_NULLABLE s) {
 namespace igl {
 
 bool ShaderCompilerOptions::operator==(const ShaderCompilerOptions& other) const {
-  return fastMathEnabled == other.fastMathEnabled;
+  return fastMathEnabled == other.fastMathEnabled &&
+         relaxedPrecisionEnabled == other.relaxedPrecisionEnabled;
 }
 
 bool ShaderCompilerOptions::operator!=(const ShaderCompilerOptions& other) const {
   return !(*this == other);
 }
 
+ShaderSpecializationConstant ShaderSpecializationConstant::fromBool(uint32_t id,
+                                                                    std::string name,
+                                                                    bool value) {
+  return ShaderSpecializationConstant{id, std::move(name), Type::Bool, value ? 1u : 0u};
+}
+
+ShaderSpecializationConstant ShaderSpecializationConstant::fromInt(uint32_t id,
+                                                                   std::string name,
+                                                                   int32_t value) {
+  return ShaderSpecializationConstant{id, std::move(name), Type::Int, static_cast<uint32_t>(value)};
+}
+
+ShaderSpecializationConstant ShaderSpecializationConstant::fromUInt(uint32_t id,
+                                                                    std::string name,
+                                                                    uint32_t value) {
+  return ShaderSpecializationConstant{id, std::move(name), Type::UInt, value};
+}
+
+ShaderSpecializationConstant ShaderSpecializationConstant::fromFloat(uint32_t id,
+                                                                     std::string name,
+                                                                     float value) {
+  static_assert(sizeof(float) == sizeof(uint32_t));
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  return ShaderSpecializationConstant{id, std::move(name), Type::Float, bits};
+}
+
+int32_t ShaderSpecializationConstant::asInt() const {
+  return static_cast<int32_t>(value);
+}
+
+float ShaderSpecializationConstant::asFloat() const {
+  float result = 0;
+  memcpy(&result, &value, sizeof(result));
+  return result;
+}
+
+bool ShaderSpecializationConstant::operator==(const ShaderSpecializationConstant& other) const {
+  return id == other.id && name == other.name && type == other.type && value == other.value;
+}
+
+bool ShaderSpecializationConstant::operator!=(const ShaderSpecializationConstant& other) const {
+  return !operator==(other);
+}
+
 bool ShaderModuleInfo::operator==(const ShaderModuleInfo& other) const {
-  return stage == other.stage && entryPoint == other.entryPoint;
+  return stage == other.stage && entryPoint == other.entryPoint &&
+         specializationConstants == other.specializationConstants;
 }
 
 bool ShaderModuleInfo::operator!=(const ShaderModuleInfo& other) const {
@@ -245,6 +292,16 @@ namespace std {
 size_t std::hash<igl::ShaderCompilerOptions>::operator()(
     igl::ShaderCompilerOptions const& key) const {
   size_t hash = std::hash<bool>()(key.fastMathEnabled);
+  igl::hashCombine(hash, std::hash<bool>()(key.relaxedPrecisionEnabled));
+  return hash;
+}
+
+size_t std::hash<igl::ShaderSpecializationConstant>::operator()(
+    igl::ShaderSpecializationConstant const& key) const {
+  size_t hash = std::hash<uint32_t>()(key.id);
+  igl::hashCombine(hash, std::hash<std::string>()(key.name));
+  igl::hashCombine(hash, static_cast<size_t>(key.type));
+  igl::hashCombine(hash, key.value);
   return hash;
 }
 
@@ -252,6 +309,9 @@ size_t std::hash<igl::ShaderModuleInfo>::operator()(igl::ShaderModuleInfo const&
   static_assert(std::is_same_v<uint8_t, std::underlying_type<igl::ShaderStage>::type>);
   size_t hash = std::hash<uint8_t>()(static_cast<uint8_t>(key.stage));
   hash ^= std::hash<std::string>()(key.entryPoint);
+  for (const auto& constant : key.specializationConstants) {
+    igl::hashCombine(hash, std::hash<igl::ShaderSpecializationConstant>()(constant));
+  }
   return hash;
 }
 
@@ -33,11 +33,51 @@ struct ShaderCompilerOptions {
   /** @brief Enable optimizations for floating-point arithmetic that may violate the IEEE 754
    * standard. */
   bool fastMathEnabled = true;
+  /** @brief Lower the color math of fragment shaders to 16-bit floats, which mobile GPUs run at
+   * twice the rate of 32-bit floats. Vulkan decorates the values computed only from the colors
+   * sampled from float textures with RelaxedPrecision; OpenGL ES declares the float samplers and
+   * fragment outputs without precision qualifiers mediump. Only for shaders whose textures and
+   * outputs hold values within the range and precision of 16-bit floats, e.g. 8-bit colors. Used
+   * by Vulkan and OpenGL ES; the decorated values are logged. */
+  bool relaxedPrecisionEnabled = false;
 
   bool operator==(const ShaderCompilerOptions& other) const;
   bool operator!=(const ShaderCompilerOptions& other) const;
 };
 
+/**
+ * @brief A constant whose value is chosen when a shader module is created, so the shader compiler
+ * can remove the code which depends on it. One shader source can be specialized into several
+ * modules without patching the source:
+ *   * Vulkan: a specialization constant, `layout (constant_id = id) const bool name = false;`.
+ *     The SPIR-V is compiled once and specialized when the pipeline is created.
+ *   * Metal: a function constant, `constant bool name [[function_constant(id)]];`. The library is
+ *     compiled once and specialized when the function is created.
+ *   * OpenGL: `#define name value` is inserted after the `#version` directive.
+ */
+struct ShaderSpecializationConstant {
+  enum class Type : uint8_t { Bool, Int, UInt, Float };
+
+  /** @brief The constant_id in Vulkan and the function constant index in Metal. */
+  uint32_t id = 0;
+  /** @brief The name of the constant. Only used by OpenGL, as the name of the macro. */
+  std::string name;
+  Type type = Type::Bool;
+  /** @brief The 32 bits of the value; a bool is 0 or 1. */
+  uint32_t value = 0;
+
+  static ShaderSpecializationConstant fromBool(uint32_t id, std::string name, bool value);
+  static ShaderSpecializationConstant fromInt(uint32_t id, std::string name, int32_t value);
+  static ShaderSpecializationConstant fromUInt(uint32_t id, std::string name, uint32_t value);
+  static ShaderSpecializationConstant fromFloat(uint32_t id, std::string name, float value);
+
+  int32_t asInt() const;
+  float asFloat() const;
+
+  bool operator==(const ShaderSpecializationConstant& other) const;
+  bool operator!=(const ShaderSpecializationConstant& other) const;
+};
+
 /**
  * @brief Metadata about a shader module.
  */
@@ -46,6 +86,8 @@ struct ShaderModuleInfo {
   ShaderStage stage = ShaderStage::Fragment;
   /** @brief The module's entry point. */
   std::string entryPoint;
+  /** @brief The values of the shader's specialization constants. */
+  std::vector<ShaderSpecializationConstant> specializationConstants = {};
 
   bool operator==(const ShaderModuleInfo& other) const;
   bool operator!=(const ShaderModuleInfo& other) const;
@@ -71,7 +113,7 @@ struct ShaderInput {
    */
   const char* IGL_NULLABLE source = nullptr;
   /**
-   * @brief Shader compiler configuration. Only used by Metal backends.
+   * @brief Shader compiler configuration. See ShaderCompilerOptions for the backends using it.
    * @remark Only used when type is ShaderInputType::String
    */
   ShaderCompilerOptions options;
@@ -318,6 +360,11 @@ struct hash<igl::ShaderCompilerOptions> {
   size_t operator()(igl::ShaderCompilerOptions const& /*key*/) const;
 };
 
+template<>
+struct hash<igl::ShaderSpecializationConstant> {
+  size_t operator()(igl::ShaderSpecializationConstant const& /*key*/) const;
+};
+
 template<>
 struct hash<igl::ShaderModuleInfo> {
   size_t operator()(igl::ShaderModuleInfo const& /*key*/) const;
@@ -121,6 +121,8 @@ TextureRangeDesc TextureRangeDesc::atLayer(size_t newLayer) const noexcept {
 #define DEPTH_STENCIL(fmt, cpp, bpb) \
   PROPERTIES(fmt, cpp, bpb, 1, 1, 1, 1, 1, 1, Flags::Depth | Flags::Stencil)
 #define STENCIL(fmt, cpp, bpb) PROPERTIES(fmt, cpp, bpb, 1, 1, 1, 1, 1, 1, Flags::Stencil)
+#define MULTIPLANAR(fmt, cpp, bpb) \
+  PROPERTIES(fmt, cpp, bpb, 2, 2, 1, 1, 1, 1, Flags::MultiPlanar)
 
 TextureFormatProperties TextureFormatProperties::fromTextureFormat(TextureFormat format) {
   switch (format) {
@@ -212,13 +214,15 @@ TextureFormatProperties TextureFormatProperties::fromTextureFormat(TextureFormat
     DEPTH(S8_UInt_Z32_UNorm, 2, 8)
 #endif
     DEPTH(S_UInt8, 1, 1)
+    MULTIPLANAR(YUV_NV12, 3, 6)
+    MULTIPLANAR(YUV_P010, 3, 12)
   }
   IGL_UNREACHABLE_RETURN(TextureFormatProperties{});
 }
 
 size_t TextureFormatProperties::getRows(TextureRangeDesc range) const noexcept {
   const auto texHeight = std::max(range.height, static_cast<size_t>(1));
-  if (isCompressed()) {
+  if (isCompressed() || isMultiPlanar()) {
     const size_t heightInBlocks =
         std::max((texHeight + blockHeight - 1) / blockHeight, static_cast<size_t>(minBlocksY));
     return heightInBlocks;
@@ -233,7 +237,7 @@ size_t TextureFormatProperties::getBytesPerRow(size_t texWidth) const noexcept {
 
 size_t TextureFormatProperties::getBytesPerRow(TextureRangeDesc range) const noexcept {
   const auto texWidth = std::max(range.width, static_cast<size_t>(1));
-  if (isCompressed()) {
+  if (isCompressed() || isMultiPlanar()) {
     const size_t widthInBlocks =
         std::max((texWidth + blockWidth - 1) / blockWidth, static_cast<size_t>(minBlocksX));
     return widthInBlocks * bytesPerBlock;
@@ -252,7 +256,7 @@ size_t TextureFormatProperties::getBytesPerLayer(TextureRangeDesc range) const n
   const auto texWidth = std::max(range.width, static_cast<size_t>(1));
   const auto texHeight = std::max(range.height, static_cast<size_t>(1));
   const auto texDepth = std::max(range.depth, static_cast<size_t>(1));
-  if (isCompressed()) {
+  if (isCompressed() || isMultiPlanar()) {
     const size_t widthInBlocks =
         std::max((texWidth + blockWidth - 1) / blockWidth, static_cast<size_t>(minBlocksX));
     const size_t heightInBlocks =
@@ -312,7 +316,8 @@ bool TextureDesc::operator==(const TextureDesc& rhs) const {
          (height == rhs.height) && (depth == rhs.depth) && (numLayers == rhs.numLayers) &&
          (numSamples == rhs.numSamples) && (usage == rhs.usage) &&
          (numMipLevels == rhs.numMipLevels) && (storage == rhs.storage) &&
-         (debugName == rhs.debugName);
+         (debugName == rhs.debugName) && (memoryPriority == rhs.memoryPriority) &&
+         (allowFormatViews == rhs.allowFormatViews);
 }
 
 bool TextureDesc::operator!=(const TextureDesc& rhs) const {
@@ -344,6 +349,17 @@ size_t ITexture::getEstimatedSizeInBytes() const {
   return totalBytes;
 }
 
+Result ITexture::uploadRegions(const std::vector<TextureRegionUpload>& regions) const {
+  Result firstFailure;
+  for (const auto& region : regions) {
+    const auto result = upload(region.range, region.data, region.bytesPerRow);
+    if (!result.isOk() && firstFailure.isOk()) {
+      firstFailure = result;
+    }
+  }
+  return firstFailure;
+}
+
 Result ITexture::validateRange(const igl::TextureRangeDesc& range) const noexcept {
   if (IGL_UNEXPECTED(range.width == 0 || range.height == 0 || range.depth == 0 ||
                      range.numLayers == 0 || range.numMipLevels == 0)) {
@@ -386,4 +402,64 @@ TextureRangeDesc ITexture::getFullRange(size_t mipLevel, size_t numMipLevels) co
   return desc;
 }
 
+Result ITexture::validateView(const TextureViewDesc& desc, TextureDesc& outViewDesc) const {
+  const TextureType type = getType();
+  const TextureType viewType = desc.type == TextureType::Invalid ? type : desc.type;
+  const TextureFormat viewFormat =
+      desc.format == TextureFormat::Invalid ? getFormat() : desc.format;
+
+  if (type == TextureType::ExternalImage) {
+    return Result{Result::Code::Unsupported, "External images can't be viewed"};
+  }
+  const bool isLayered2D =
+      type == TextureType::TwoD || type == TextureType::TwoDArray || type == TextureType::Cube;
+  if (viewType != type &&
+      !(isLayered2D && (viewType == TextureType::TwoD || viewType == TextureType::TwoDArray))) {
+    return Result{Result::Code::ArgumentInvalid, "The view type is incompatible with the texture"};
+  }
+  if (desc.numMipLevels == 0 || desc.numLayers == 0) {
+    return Result{Result::Code::ArgumentInvalid, "numMipLevels and numLayers must be at least 1"};
+  }
+
+  // the faces of cube textures are layers of the views
+  const size_t texLayers = type == TextureType::Cube ? 6 * getNumLayers() : getNumLayers();
+  const size_t texMipLevels = getNumMipLevels();
+  if (desc.numMipLevels > texMipLevels || desc.mipLevel > texMipLevels - desc.numMipLevels ||
+      desc.numLayers > texLayers || desc.layer > texLayers - desc.numLayers) {
+    return Result{Result::Code::ArgumentOutOfRange, "The view exceeds the texture"};
+  }
+  if ((viewType == TextureType::TwoD && desc.numLayers != 1) ||
+      (viewType == TextureType::Cube && (desc.numLayers != 6 || desc.layer % 6 != 0))) {
+    return Result{Result::Code::ArgumentInvalid, "Invalid number of layers for the view type"};
+  }
+
+  if (viewFormat != getFormat()) {
+    const auto viewProperties = TextureFormatProperties::fromTextureFormat(viewFormat);
+    if (!viewProperties.isValid() || viewProperties.isDepthOrStencil() ||
+        properties_.isDepthOrStencil() || viewProperties.isMultiPlanar() ||
+        properties_.isMultiPlanar() || viewProperties.bytesPerBlock != properties_.bytesPerBlock ||
+        viewProperties.blockWidth != properties_.blockWidth ||
+        viewProperties.blockHeight != properties_.blockHeight ||
+        viewProperties.blockDepth != properties_.blockDepth) {
+      return Result{Result::Code::ArgumentInvalid,
+                    "The view format is incompatible with the texture format"};
+    }
+  }
+
+  static constexpr size_t one = 1;
+  const auto dimensions = getDimensions();
+  outViewDesc.width = std::max(dimensions.width >> desc.mipLevel, one);
+  outViewDesc.height = std::max(dimensions.height >> desc.mipLevel, one);
+  outViewDesc.depth = std::max(dimensions.depth >> desc.mipLevel, one);
+  outViewDesc.numLayers = viewType == TextureType::Cube ? desc.numLayers / 6 : desc.numLayers;
+  outViewDesc.numSamples = getSamples();
+  outViewDesc.usage = getUsage();
+  outViewDesc.numMipLevels = desc.numMipLevels;
+  outViewDesc.type = viewType;
+  outViewDesc.format = viewFormat;
+  outViewDesc.debugName = desc.debugName;
+
+  return Result{};
+}
+
 } // namespace igl
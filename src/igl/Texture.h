@@ -12,7 +12,9 @@
 #include <igl/CommandQueue.h>
 #include <igl/Common.h>
 #include <igl/ITrackedResource.h>
+#include <igl/Readback.h>
 #include <igl/TextureFormat.h>
+#include <vector>
 
 namespace igl {
 
@@ -130,6 +132,8 @@ struct TextureRangeDesc {
  *                        - Stencil:    Stencil texture format
  *                        - Compressed: Compressed texture format
  *                        - sRGB:       sRGB texture format
+ *                        - MultiPlanar: Multi-planar YUV format; a 2x2 block holds the 4 luma and
+ *                                       the 2 chroma samples of both planes
  */
 struct TextureFormatProperties {
   static TextureFormatProperties fromTextureFormat(TextureFormat format);
@@ -139,6 +143,7 @@ struct TextureFormatProperties {
     Stencil = 1 << 1,
     Compressed = 1 << 2,
     sRGB = 1 << 3,
+    MultiPlanar = 1 << 4,
   };
 
   const char* IGL_NONNULL name = "Invalid";
@@ -171,6 +176,18 @@ struct TextureFormatProperties {
   [[nodiscard]] bool isSRGB() const noexcept {
     return (flags & Flags::sRGB) != 0;
   }
+  /**
+   * @brief true multi-planar YUV texture formats (e.g., TextureFormat::YUV_NV12).
+   */
+  [[nodiscard]] bool isMultiPlanar() const noexcept {
+    return (flags & Flags::MultiPlanar) != 0;
+  }
+  /**
+   * @brief Number of planes: 2 for multi-planar YUV formats, 1 otherwise.
+   */
+  [[nodiscard]] size_t getNumPlanes() const noexcept {
+    return isMultiPlanar() ? 2 : 1;
+  }
   /**
    * @brief true depth-only texture formats (e.g., TextureFormat::Z_UNorm24).
    */
@@ -301,6 +318,8 @@ enum class TextureCubeFace : uint8_t { PosX = 0, NegX, PosY, NegY, PosZ, NegZ };
  *  numMipLevels       - Number of mipmaps to generate
  *  format             - Internal texture format type
  *  storage            - Internal resource storage type
+ *  memoryPriority     - Priority of the memory of the texture (Vulkan only)
+ *  allowFormatViews   - Whether views of the texture can have a different format
  */
 struct TextureDesc {
   /**
@@ -331,6 +350,16 @@ struct TextureDesc {
 
   std::string debugName = "";
 
+  // Vulkan only. Priority of the memory in [0, 1], used by the driver to decide what stays in
+  // device-local memory when it is oversubscribed (requires VK_EXT_memory_priority)
+  float memoryPriority = 0.5f;
+
+  // Allows IDevice::createTextureView() to create views of the texture in other formats of the
+  // same block size, e.g. an sRGB view of an RGBA texture. Some drivers compress textures less
+  // aggressively when this is set. On OpenGL, it also allocates the texture with the immutable
+  // storage glTextureView needs for views of any kind.
+  bool allowFormatViews = false;
+
   bool operator==(const TextureDesc& rhs) const;
   bool operator!=(const TextureDesc& rhs) const;
 
@@ -489,6 +518,54 @@ struct TextureDesc {
   static uint32_t calcNumMipLevels(size_t width, size_t height);
 };
 
+/**
+ * @brief Descriptor of a texture view created with IDevice::createTextureView(): a texture which
+ * shares the memory of another texture and covers a subset of its mip levels and layers, possibly
+ * with another type or format. Nothing is copied, and writes through either texture are visible
+ * through the other one.
+ *
+ *  type               - Type of the view; TextureType::Invalid keeps the type of the texture. 2D
+ *                       textures can be viewed as 2D arrays, 2D arrays and cube textures as 2D
+ *                       textures (one layer) or 2D arrays
+ *  format             - Format of the view; TextureFormat::Invalid keeps the format of the
+ *                       texture. Another format needs the same block size and bytes per block, and
+ *                       a texture created with TextureDesc::allowFormatViews
+ *  mipLevel           - First mip level of the view
+ *  numMipLevels       - Number of mip levels of the view
+ *  layer              - First layer of the view; the faces of cube textures are layers
+ *  numLayers          - Number of layers of the view
+ *  debugName          - Name of the view shown in debugging tools
+ */
+struct TextureViewDesc {
+  TextureType type = TextureType::Invalid;
+  TextureFormat format = TextureFormat::Invalid;
+  uint32_t mipLevel = 0;
+  uint32_t numMipLevels = 1;
+  uint32_t layer = 0;
+  uint32_t numLayers = 1;
+  std::string debugName;
+};
+
+/**
+ * @brief One region of a batched upload; the fields have the same meaning as the parameters of
+ * ITexture::upload().
+ */
+struct TextureRegionUpload {
+  TextureRangeDesc range;
+  const void* IGL_NULLABLE data = nullptr;
+  size_t bytesPerRow = 0;
+};
+
+class ITexture;
+
+/**
+ * @brief One region of a batched upload into any texture; see IDevice::uploadTextureRegions().
+ */
+struct TextureUpload {
+  const ITexture* IGL_NULLABLE texture = nullptr;
+  TextureRegionUpload region;
+};
+
 /**
  * @brief Interface class for all textures.
  * This should only be used for the purpose of getting information about the texture using the
@@ -532,6 +609,17 @@ class ITexture : public ITrackedResource<ITexture> {
                             const void* IGL_NULLABLE data,
                             size_t bytesPerRow = 0) const = 0;
 
+  /**
+   * @brief Uploads several regions of the texture at once, e.g. the sub-rectangles of an atlas or
+   * the levels of a mip chain from separate allocations. Backends with explicit staging record all
+   * of them into one submission. The default implementation uploads the regions one by one.
+   *
+   * @param regions The regions in upload order; later regions overwrite earlier ones
+   * @return Result A flag for the result of operation: the first failure, if any. A failed region
+   * does not prevent the other regions from being uploaded.
+   */
+  virtual Result uploadRegions(const std::vector<TextureRegionUpload>& regions) const;
+
   // Texture Accessors Methods
   /**
    * @brief Returns the aspect ratio (width / height) of the texture.
@@ -626,13 +714,33 @@ class ITexture : public ITrackedResource<ITexture> {
    */
   [[nodiscard]] size_t getEstimatedSizeInBytes() const;
   /**
-   * @brief Returns a texture id suitable for bindless rendering (descriptor indexing on Vulkan and
-   * gpuResourceID on Metal)
+   * @brief Returns a texture id suitable for bindless rendering (descriptor indexing on Vulkan,
+   * the argument buffer based metal::BindlessTable on Metal and the ARB_bindless_texture based
+   * opengl::BindlessTable on OpenGL)
    *
    * @return uint64_t
    */
   [[nodiscard]] virtual uint64_t getTextureId() const = 0;
 
+  /**
+   * @brief Copies a 2D region of one mip level and layer of the texture into host-visible memory
+   * without waiting for the GPU. The copy runs after all the work submitted to `cmdQueue` so far;
+   * see IReadback. Rows are not flipped.
+   *
+   * @param cmdQueue The queue the texture is rendered by
+   * @param range The region to read; numLayers, numMipLevels and depth have to be 1
+   * @param outResult result of the operation, Result::Code::Unsupported if the backend has no
+   * asynchronous readbacks or the format cannot be read back
+   * @return the pending readback or nullptr
+   */
+  virtual std::shared_ptr<IReadback> readAsync(ICommandQueue& /*cmdQueue*/,
+                                               const TextureRangeDesc& /*range*/,
+                                               Result* IGL_NULLABLE outResult) const {
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "Asynchronous readbacks are not supported");
+    return nullptr;
+  }
+
   /**
    * @brief Validates the range against texture dimensions at the range's mip level.
    *
@@ -646,6 +754,15 @@ class ITexture : public ITrackedResource<ITexture> {
    */
   [[nodiscard]] TextureRangeDesc getFullRange(size_t mipLevel = 0,
                                               size_t numMipLevels = 1) const noexcept;
+  /**
+   * @brief Validates a view of the texture, without the format view requirements specific to each
+   * backend, and returns the descriptor of the texture the view behaves as: the dimensions of the
+   * first mip level of the view, its type, format and number of layers, and the usage and sample
+   * count of this texture.
+   *
+   * @return The returned Result indicates whether the view is valid or not.
+   */
+  [[nodiscard]] Result validateView(const TextureViewDesc& desc, TextureDesc& outViewDesc) const;
   /**
    * @brief A helper function to quickly access TextureFormat.
    *
@@ -667,6 +784,8 @@ struct SurfaceTextures {
   std::shared_ptr<igl::ITexture> color;
   /** @brief The surface's depth texture. */
   std::shared_ptr<igl::ITexture> depth;
+  /** @brief The fragment density map of the surface, if it is rendered with foveation. */
+  std::shared_ptr<igl::ITexture> densityMap = nullptr;
 };
 
 } // namespace igl
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/TextureConversion.h>
+
+#include <cstdint>
+#include <cstring>
+#include <igl/Common.h>
+#include <igl/Texture.h>
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define IGL_TEXEL_CONVERSION_SSSE3 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IGL_TEXEL_CONVERSION_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define IGL_TEXEL_CONVERSION_NEON 1
+#endif
+
+namespace igl {
+
+namespace {
+
+// the bit patterns of 1.0 in half and single precision
+constexpr uint16_t kOneF16 = 0x3c00;
+constexpr uint32_t kOneF32 = 0x3f800000;
+
+enum class Conversion : uint8_t {
+  None,
+  Copy,
+  ExpandRGB8,
+  ExpandSwapRGB8,
+  ExpandRGB16,
+  ExpandRGB32,
+};
+
+Conversion getConversion(TextureFormat srcFormat, TextureFormat dstFormat) {
+  if (srcFormat == dstFormat) {
+    return srcFormat == TextureFormat::Invalid ? Conversion::None : Conversion::Copy;
+  }
+  switch (srcFormat) {
+  case TextureFormat::RGBX_UNorm8:
+    return dstFormat == TextureFormat::RGBA_UNorm8   ? Conversion::ExpandRGB8
+           : dstFormat == TextureFormat::BGRA_UNorm8 ? Conversion::ExpandSwapRGB8
+                                                     : Conversion::None;
+  case TextureFormat::RGB_F16:
+    return dstFormat == TextureFormat::RGBA_F16 ? Conversion::ExpandRGB16 : Conversion::None;
+  case TextureFormat::RGB_F32:
+    return dstFormat == TextureFormat::RGBA_F32 ? Conversion::ExpandRGB32 : Conversion::None;
+  case TextureFormat::L_UNorm8:
+  case TextureFormat::A_UNorm8:
+    return dstFormat == TextureFormat::R_UNorm8 ? Conversion::Copy : Conversion::None;
+  case TextureFormat::LA_UNorm8:
+    return dstFormat == TextureFormat::RG_UNorm8 ? Conversion::Copy : Conversion::None;
+  default:
+    return Conversion::None;
+  }
+}
+
+void expandRGB8(const uint8_t* in, uint8_t* out, size_t count, bool swapRB) {
+  size_t i = 0;
+  const size_t r = swapRB ? 2 : 0;
+  const size_t b = swapRB ? 0 : 2;
+
+#if IGL_TEXEL_CONVERSION_SSSE3
+  // 16 texels are 3 registers in and 4 registers out; each output register takes 12 bytes
+  const char z = static_cast<char>(0x80); // zeroes the byte, which the alpha mask then fills
+  const char cr = static_cast<char>(r);
+  const char cb = static_cast<char>(b);
+  const __m128i shuffle = _mm_setr_epi8(
+      cr, 1, cb, z, cr + 3, 4, cb + 3, z, cr + 6, 7, cb + 6, z, cr + 9, 10, cb + 9, z);
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+  for (; i + 16 <= count; i += 16, in += 48, out += 64) {
+    const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16));
+    const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 32));
+    const __m128i t0 = v0;
+    const __m128i t1 = _mm_alignr_epi8(v1, v0, 12);
+    const __m128i t2 = _mm_alignr_epi8(v2, v1, 8);
+    const __m128i t3 = _mm_srli_si128(v2, 4);
+    auto* o = reinterpret_cast<__m128i*>(out);
+    _mm_storeu_si128(o + 0, _mm_or_si128(_mm_shuffle_epi8(t0, shuffle), alpha));
+    _mm_storeu_si128(o + 1, _mm_or_si128(_mm_shuffle_epi8(t1, shuffle), alpha));
+    _mm_storeu_si128(o + 2, _mm_or_si128(_mm_shuffle_epi8(t2, shuffle), alpha));
+    _mm_storeu_si128(o + 3, _mm_or_si128(_mm_shuffle_epi8(t3, shuffle), alpha));
+  }
+#elif IGL_TEXEL_CONVERSION_NEON
+  for (; i + 16 <= count; i += 16, in += 48, out += 64) {
+    const uint8x16x3_t rgb = vld3q_u8(in);
+    const uint8x16x4_t rgba = {{rgb.val[r], rgb.val[1], rgb.val[b], vdupq_n_u8(0xff)}};
+    vst4q_u8(out, rgba);
+  }
+#endif
+
+  for (; i < count; ++i, in += 3, out += 4) {
+    out[0] = in[r];
+    out[1] = in[1];
+    out[2] = in[b];
+    out[3] = 0xff;
+  }
+}
+
+void expandRGB16(const uint16_t* in, uint16_t* out, size_t count) {
+  size_t i = 0;
+
+#if IGL_TEXEL_CONVERSION_NEON
+  for (; i + 8 <= count; i += 8, in += 24, out += 32) {
+    const uint16x8x3_t rgb = vld3q_u16(in);
+    const uint16x8x4_t rgba = {{rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u16(kOneF16)}};
+    vst4q_u16(out, rgba);
+  }
+#endif
+
+  for (; i < count; ++i, in += 3, out += 4) {
+    memcpy(out, in, 3 * sizeof(uint16_t));
+    out[3] = kOneF16;
+  }
+}
+
+void expandRGB32(const uint32_t* in, uint32_t* out, size_t count) {
+  size_t i = 0;
+
+  // Only lanes are moved around, as in padVec3Array()
+#if IGL_TEXEL_CONVERSION_SSE2
+  const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  const __m128 alpha = _mm_castsi128_ps(_mm_set_epi32(static_cast<int>(kOneF32), 0, 0, 0));
+  for (; i + 4 <= count; i += 4, in += 12, out += 16) {
+    const auto* f = reinterpret_cast<const float*>(in);
+    auto* o = reinterpret_cast<float*>(out);
+    const __m128 v0 = _mm_loadu_ps(f); // a0 a1 a2 b0
+    const __m128 v1 = _mm_loadu_ps(f + 4); // b1 b2 c0 c1
+    const __m128 v2 = _mm_loadu_ps(f + 8); // c2 d0 d1 d2
+    _mm_storeu_ps(o, _mm_or_ps(_mm_and_ps(v0, mask), alpha));
+    // b0 b0 b1 b2 => b0 b1 b2 b0
+    const __m128 b = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 0, 3, 3));
+    const __m128 t1 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 2, 0));
+    _mm_storeu_ps(o + 4, _mm_or_ps(_mm_and_ps(t1, mask), alpha));
+    // c0 c1 c2 c2
+    const __m128 t2 = _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(0, 0, 3, 2));
+    _mm_storeu_ps(o + 8, _mm_or_ps(_mm_and_ps(t2, mask), alpha));
+    // d0 d1 d2 c2
+    const __m128 t3 = _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(0, 3, 2, 1));
+    _mm_storeu_ps(o + 12, _mm_or_ps(_mm_and_ps(t3, mask), alpha));
+  }
+#elif IGL_TEXEL_CONVERSION_NEON
+  for (; i + 4 <= count; i += 4, in += 12, out += 16) {
+    const uint32x4x3_t rgb = vld3q_u32(in);
+    const uint32x4x4_t rgba = {{rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u32(kOneF32)}};
+    vst4q_u32(out, rgba);
+  }
+#endif
+
+  for (; i < count; ++i, in += 3, out += 4) {
+    memcpy(out, in, 3 * sizeof(uint32_t));
+    out[3] = kOneF32;
+  }
+}
+
+} // namespace
+
+bool canConvertTexels(TextureFormat srcFormat, TextureFormat dstFormat) {
+  return getConversion(srcFormat, dstFormat) != Conversion::None;
+}
+
+void convertTexels(TextureFormat srcFormat,
+                   const void* src,
+                   size_t srcBytesPerRow,
+                   TextureFormat dstFormat,
+                   void* dst,
+                   size_t dstBytesPerRow,
+                   size_t width,
+                   size_t numRows) {
+  const Conversion conversion = getConversion(srcFormat, dstFormat);
+  if (!IGL_VERIFY(conversion != Conversion::None)) {
+    return;
+  }
+
+  const auto* in = static_cast<const uint8_t*>(src);
+  auto* out = static_cast<uint8_t*>(dst);
+  const size_t rowSize =
+      width * TextureFormatProperties::fromTextureFormat(srcFormat).bytesPerBlock;
+
+  for (size_t row = 0; row < numRows; ++row, in += srcBytesPerRow, out += dstBytesPerRow) {
+    switch (conversion) {
+    case Conversion::None:
+      break;
+    case Conversion::Copy:
+      memcpy(out, in, rowSize);
+      break;
+    case Conversion::ExpandRGB8:
+    case Conversion::ExpandSwapRGB8:
+      expandRGB8(in, out, width, conversion == Conversion::ExpandSwapRGB8);
+      break;
+    case Conversion::ExpandRGB16:
+      expandRGB16(reinterpret_cast<const uint16_t*>(in), reinterpret_cast<uint16_t*>(out), width);
+      break;
+    case Conversion::ExpandRGB32:
+      expandRGB32(reinterpret_cast<const uint32_t*>(in), reinterpret_cast<uint32_t*>(out), width);
+      break;
+    }
+  }
+}
+
+} // namespace igl
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <igl/TextureFormat.h>
+
+namespace igl {
+
+/// True if convertTexels() can convert texels of `srcFormat` into `dstFormat`. Backends use it to
+/// store formats the device cannot sample, e.g. 24-bit RGBX_UNorm8, in a format it can.
+bool canConvertTexels(TextureFormat srcFormat, TextureFormat dstFormat);
+
+/// Converts `numRows` rows of `width` texels of `srcFormat` into `dstFormat`:
+///  - RGBX_UNorm8 into RGBA_UNorm8 or BGRA_UNorm8; alpha is one
+///  - RGB_F16 into RGBA_F16 and RGB_F32 into RGBA_F32; alpha is one
+///  - L_UNorm8 and A_UNorm8 into R_UNorm8, LA_UNorm8 into RG_UNorm8, which are stored as they are:
+///    the backends swizzle the components back when sampling
+///  - any format into itself
+/// The 3 to 4 component expansions use SSSE3, SSE2 or NEON when available.
+void convertTexels(TextureFormat srcFormat,
+                   const void* src,
+                   size_t srcBytesPerRow,
+                   TextureFormat dstFormat,
+                   void* dst,
+                   size_t dstBytesPerRow,
+                   size_t width,
+                   size_t numRows);
+
+} // namespace igl
@@ -6,6 +6,7 @@
  */
 
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 namespace igl {
@@ -203,7 +204,12 @@ enum class TextureFormat : uint8_t {
   S8_UInt_Z24_UNorm, // NA on iOS
   S8_UInt_Z32_UNorm, // NA on iOS/GLES but works on iOS Metal. The client has to
                      // account for this!
-  S_UInt8
+  S_UInt8,
+
+  // Multi-planar YUV 4:2:0: a full resolution luma (Y) plane followed by a half resolution
+  // interleaved chroma (CbCr) plane
+  YUV_NV12, // 8 bits per sample
+  YUV_P010, // 10 bits per sample, stored in the high bits of 16-bit words
 };
 
 constexpr bool isTextureFormatsRGB(TextureFormat textureFormat) {
@@ -213,4 +219,22 @@ constexpr bool isTextureFormatsRGB(TextureFormat textureFormat) {
 constexpr bool isTextureFormatBGR(TextureFormat textureFormat) {
   return textureFormat == TextureFormat::BGRA_SRGB || textureFormat == TextureFormat::BGRA_UNorm8;
 }
+
+/// Returns the format of one plane of a multi-planar format, e.g. R_UNorm8 for the luma plane and
+/// RG_UNorm8 for the chroma plane of YUV_NV12. Returns the format itself for plane 0 of single
+/// plane formats and TextureFormat::Invalid for planes which do not exist.
+constexpr TextureFormat getTextureFormatOfPlane(TextureFormat textureFormat, size_t planeIndex) {
+  switch (textureFormat) {
+  case TextureFormat::YUV_NV12:
+    return planeIndex == 0   ? TextureFormat::R_UNorm8
+           : planeIndex == 1 ? TextureFormat::RG_UNorm8
+                             : TextureFormat::Invalid;
+  case TextureFormat::YUV_P010:
+    return planeIndex == 0   ? TextureFormat::R_UNorm16
+           : planeIndex == 1 ? TextureFormat::RG_UNorm16
+                             : TextureFormat::Invalid;
+  default:
+    return planeIndex == 0 ? textureFormat : TextureFormat::Invalid;
+  }
+}
 } // namespace igl
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Common.h>
+#include <string>
+
+namespace igl {
+
+/**
+ * @brief Describes a pool of GPU timestamp queries.
+ *
+ * count     : Number of timestamps the pool can hold.
+ * debugName : Name of the pool shown in debugging tools.
+ */
+struct TimestampQueryPoolDesc {
+  uint32_t count = 0;
+  std::string debugName;
+};
+
+/**
+ * @brief A fixed number of GPU timestamps, written with ICommandBuffer::writeTimestamp().
+ *
+ * Results are resolved asynchronously: getResults() never blocks and reports whether the GPU has
+ * written the requested timestamps yet. Timestamps are in nanoseconds on a GPU specific timeline,
+ * so only differences between timestamps of the same device are meaningful.
+ */
+class ITimestampQueryPool {
+ public:
+  virtual ~ITimestampQueryPool() = default;
+
+  /**
+   * @returns the number of timestamps in the pool
+   */
+  [[nodiscard]] virtual uint32_t getCount() const = 0;
+
+  /**
+   * @brief Copies the timestamps [firstQuery, firstQuery + queryCount) to outTimestampsNs.
+   * @returns false, and leaves outTimestampsNs in an unspecified state, if any of them is not
+   * available yet.
+   */
+  virtual bool getResults(uint32_t firstQuery,
+                          uint32_t queryCount,
+                          uint64_t* IGL_NONNULL outTimestampsNs) = 0;
+
+ protected:
+  ITimestampQueryPool() = default;
+};
+
+} // namespace igl
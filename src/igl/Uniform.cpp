@@ -7,8 +7,17 @@
 
 #include <igl/Uniform.h>
 
+#include <cstring>
 #include <igl/Common.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IGL_UNIFORM_PACKING_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define IGL_UNIFORM_PACKING_NEON 1
+#endif
+
 namespace igl {
 
 size_t sizeForUniformType(UniformType type) {
@@ -75,4 +84,72 @@ size_t sizeForUniformElementType(UniformType type) {
   }
 }
 
+void packVec3Array(void* dst, const void* src, size_t count) {
+  auto* out = static_cast<float*>(dst);
+  const auto* in = static_cast<const float*>(src);
+  size_t i = 0;
+
+  // Only lanes are moved around, so this works for any 32-bit type, not only floats
+#if IGL_UNIFORM_PACKING_SSE2
+  for (; i + 4 <= count; i += 4, in += 16, out += 12) {
+    const __m128 a = _mm_loadu_ps(in);
+    const __m128 b = _mm_loadu_ps(in + 4);
+    const __m128 c = _mm_loadu_ps(in + 8);
+    const __m128 d = _mm_loadu_ps(in + 12);
+    // a2 a2 b0 b0 => a0 a1 a2 b0
+    const __m128 ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 2, 2));
+    _mm_storeu_ps(out, _mm_shuffle_ps(a, ab, _MM_SHUFFLE(2, 0, 1, 0)));
+    // b1 b2 c0 c1
+    _mm_storeu_ps(out + 4, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 2, 1)));
+    // c2 c2 d0 d0 => c2 d0 d1 d2
+    const __m128 cd = _mm_shuffle_ps(c, d, _MM_SHUFFLE(0, 0, 2, 2));
+    _mm_storeu_ps(out + 8, _mm_shuffle_ps(cd, d, _MM_SHUFFLE(2, 1, 2, 0)));
+  }
+#elif IGL_UNIFORM_PACKING_NEON
+  for (; i + 4 <= count; i += 4, in += 16, out += 12) {
+    const float32x4x4_t v = vld4q_f32(in);
+    const float32x4x3_t xyz = {{v.val[0], v.val[1], v.val[2]}};
+    vst3q_f32(out, xyz);
+  }
+#endif
+
+  for (; i < count; ++i, in += 4, out += 3) {
+    memcpy(out, in, 3 * sizeof(float));
+  }
+}
+
+void padVec3Array(void* dst, const void* src, size_t count) {
+  auto* out = static_cast<float*>(dst);
+  const auto* in = static_cast<const float*>(src);
+  size_t i = 0;
+
+#if IGL_UNIFORM_PACKING_SSE2
+  const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  for (; i + 4 <= count; i += 4, in += 12, out += 16) {
+    const __m128 v0 = _mm_loadu_ps(in); // a0 a1 a2 b0
+    const __m128 v1 = _mm_loadu_ps(in + 4); // b1 b2 c0 c1
+    const __m128 v2 = _mm_loadu_ps(in + 8); // c2 d0 d1 d2
+    _mm_storeu_ps(out, _mm_and_ps(v0, mask));
+    // b0 b0 b1 b2 => b0 b1 b2 b0
+    const __m128 b = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 0, 3, 3));
+    _mm_storeu_ps(out + 4, _mm_and_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 2, 0)), mask));
+    // c0 c1 c2 c2
+    _mm_storeu_ps(out + 8, _mm_and_ps(_mm_shuffle_ps(v1, v2, _MM_SHUFFLE(0, 0, 3, 2)), mask));
+    // d0 d1 d2 c2
+    _mm_storeu_ps(out + 12, _mm_and_ps(_mm_shuffle_ps(v2, v2, _MM_SHUFFLE(0, 3, 2, 1)), mask));
+  }
+#elif IGL_UNIFORM_PACKING_NEON
+  for (; i + 4 <= count; i += 4, in += 12, out += 16) {
+    const float32x4x3_t xyz = vld3q_f32(in);
+    const float32x4x4_t v = {{xyz.val[0], xyz.val[1], xyz.val[2], vdupq_n_f32(0.0f)}};
+    vst4q_f32(out, v);
+  }
+#endif
+
+  for (; i < count; ++i, in += 3, out += 4) {
+    memcpy(out, in, 3 * sizeof(float));
+    out[3] = 0.0f;
+  }
+}
+
 } // namespace igl
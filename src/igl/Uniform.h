@@ -45,4 +45,13 @@ struct UniformDesc {
 size_t sizeForUniformType(UniformType type);
 size_t sizeForUniformElementType(UniformType type);
 
+/// Copies `count` 3-component vectors of 32-bit values stored 16 bytes apart (std140 and Metal
+/// layout, simd float3) to `dst`, where they are stored tightly packed 12 bytes apart. A mat3 is 3
+/// such vectors. Uses SSE2 or NEON when available.
+void packVec3Array(void* dst, const void* src, size_t count);
+
+/// The inverse of packVec3Array(): expands `count` tightly packed 3-component vectors to a 16 byte
+/// stride. The padding is zeroed.
+void padVec3Array(void* dst, const void* src, size_t count);
+
 } // namespace igl
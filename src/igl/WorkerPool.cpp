@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/WorkerPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <igl/Common.h>
+
+namespace igl {
+
+WorkerPool::WorkerPool(uint32_t numThreads, const char* name) {
+  IGL_ASSERT(numThreads > 0);
+
+  threads_.reserve(numThreads);
+
+  for (uint32_t i = 0; i != numThreads; i++) {
+    threads_.emplace_back([this, name]() {
+      IGL_PROFILER_THREAD(name);
+      run();
+    });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+
+  for (auto& t : threads_) {
+    t.join();
+  }
+}
+
+void WorkerPool::enqueue(std::function<void()>&& task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.emplace_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+
+  std::atomic<size_t> nextIndex = 0;
+  const auto runTasks = [&nextIndex, count, &task]() {
+    for (size_t i = nextIndex++; i < count; i = nextIndex++) {
+      task(i);
+    }
+  };
+
+  // the calling thread takes part, so there is no point in waking up more threads than needed
+  const size_t numHelpers = std::min(threads_.size(), count - 1);
+
+  std::mutex doneMutex;
+  std::condition_variable doneCv;
+  size_t numHelpersDone = 0;
+
+  for (size_t i = 0; i != numHelpers; i++) {
+    enqueue([&]() {
+      runTasks();
+      std::lock_guard<std::mutex> lock(doneMutex);
+      numHelpersDone++;
+      doneCv.notify_one();
+    });
+  }
+
+  runTasks();
+
+  // the helpers reference locals of this function: wait for all of them, even idle ones
+  std::unique_lock<std::mutex> lock(doneMutex);
+  doneCv.wait(lock, [&]() { return numHelpersDone == numHelpers; });
+}
+
+void WorkerPool::run() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+      // drain the queue before stopping
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+} // namespace igl
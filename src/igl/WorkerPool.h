@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace igl {
+
+/**
+ * @brief A minimalistic pool of worker threads executing tasks in FIFO order.
+ *
+ * Used to move expensive work (i.e. pipeline compilation or texture decoding) off the render
+ * thread. All pending tasks are executed before the pool is destroyed.
+ */
+class WorkerPool final {
+ public:
+  explicit WorkerPool(uint32_t numThreads, const char* name = "WorkerPool");
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  void enqueue(std::function<void()>&& task);
+
+  // Runs task(0) ... task(count - 1) on the worker threads and the calling thread, and returns once
+  // all of them are finished. Must not be called from a task of the same pool.
+  void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+  uint32_t getNumThreads() const {
+    return static_cast<uint32_t>(threads_.size());
+  }
+
+ private:
+  void run();
+
+ private:
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool stop_ = false;
+};
+
+} // namespace igl
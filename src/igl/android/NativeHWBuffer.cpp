@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/android/NativeHWBuffer.h>
+
+#if IGL_ANDROID_HWBUFFER_SUPPORTED
+
+#include <android/hardware_buffer.h>
+
+namespace igl::android {
+
+uint32_t getNativeHWFormat(TextureFormat format) {
+  // note that Native HW buffer has compute specific format but is not added here.
+  switch (format) {
+  case TextureFormat::RGBX_UNorm8:
+    return AHARDWAREBUFFER_FORMAT_R8G8B8_UNORM;
+
+  case TextureFormat::RGBA_UNorm8:
+    return AHARDWAREBUFFER_FORMAT_R8G8B8A8_UNORM;
+
+  case TextureFormat::B5G6R5_UNorm:
+    return AHARDWAREBUFFER_FORMAT_R5G6B5_UNORM;
+
+  case TextureFormat::RGBA_F16:
+    return AHARDWAREBUFFER_FORMAT_R16G16B16A16_FLOAT;
+
+  case TextureFormat::RGB10_A2_UNorm_Rev:
+    return AHARDWAREBUFFER_FORMAT_R10G10B10A2_UNORM;
+
+  case TextureFormat::Z_UNorm16:
+    return AHARDWAREBUFFER_FORMAT_D16_UNORM;
+
+  case TextureFormat::Z_UNorm24:
+    return AHARDWAREBUFFER_FORMAT_D24_UNORM;
+
+  case TextureFormat::Z_UNorm32:
+    return AHARDWAREBUFFER_FORMAT_D32_FLOAT;
+
+  case TextureFormat::S8_UInt_Z24_UNorm:
+    return AHARDWAREBUFFER_FORMAT_D24_UNORM_S8_UINT;
+
+    // format mismatch
+    //  case TextureFormat::S8_UInt_Z32_UNorm:
+    //    return AHARDWAREBUFFER_FORMAT_D32_FLOAT_S8_UINT;
+
+  case TextureFormat::S_UInt8:
+    return AHARDWAREBUFFER_FORMAT_S8_UINT;
+
+  case TextureFormat::YUV_NV12:
+    return AHARDWAREBUFFER_FORMAT_Y8Cb8Cr8_420;
+
+#if __ANDROID_API__ >= 31
+  case TextureFormat::YUV_P010:
+    return AHARDWAREBUFFER_FORMAT_YCbCr_P010;
+#endif
+
+  default:
+    return 0;
+  }
+  return 0;
+}
+
+TextureFormat getIglFormat(uint32_t nativeFormat) {
+  switch (nativeFormat) {
+  case AHARDWAREBUFFER_FORMAT_R8G8B8_UNORM:
+    return TextureFormat::RGBX_UNorm8;
+  case AHARDWAREBUFFER_FORMAT_R8G8B8A8_UNORM:
+    return TextureFormat::RGBA_UNorm8;
+  case AHARDWAREBUFFER_FORMAT_R5G6B5_UNORM:
+    return TextureFormat::B5G6R5_UNorm;
+  case AHARDWAREBUFFER_FORMAT_R16G16B16A16_FLOAT:
+    return TextureFormat::RGBA_F16;
+  case AHARDWAREBUFFER_FORMAT_R10G10B10A2_UNORM:
+    return TextureFormat::RGB10_A2_UNorm_Rev;
+  case AHARDWAREBUFFER_FORMAT_D16_UNORM:
+    return TextureFormat::Z_UNorm16;
+  case AHARDWAREBUFFER_FORMAT_D24_UNORM:
+    return TextureFormat::Z_UNorm24;
+  case AHARDWAREBUFFER_FORMAT_D32_FLOAT:
+    return TextureFormat::Z_UNorm32;
+  case AHARDWAREBUFFER_FORMAT_D24_UNORM_S8_UINT:
+    return TextureFormat::S8_UInt_Z24_UNorm;
+  case AHARDWAREBUFFER_FORMAT_S8_UINT:
+    return TextureFormat::S_UInt8;
+  case AHARDWAREBUFFER_FORMAT_Y8Cb8Cr8_420:
+    return TextureFormat::YUV_NV12;
+#if __ANDROID_API__ >= 31
+  case AHARDWAREBUFFER_FORMAT_YCbCr_P010:
+    return TextureFormat::YUV_P010;
+#endif
+  default:
+    return TextureFormat::Invalid;
+  }
+}
+
+uint64_t getNativeHWBufferUsage(TextureDesc::TextureUsage usage) {
+  uint64_t bufferUsage = 0;
+
+  if (usage & TextureDesc::TextureUsageBits::Sampled) {
+    bufferUsage |= AHARDWAREBUFFER_USAGE_GPU_SAMPLED_IMAGE;
+  }
+
+  if (usage & TextureDesc::TextureUsageBits::Storage) {
+    bufferUsage |= AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN | AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN;
+  }
+
+  if (usage & TextureDesc::TextureUsageBits::Attachment) {
+    bufferUsage |= AHARDWAREBUFFER_USAGE_GPU_COLOR_OUTPUT;
+  }
+  return bufferUsage;
+}
+
+Result allocateNativeHWBuffer(const TextureDesc& desc,
+                              AHardwareBuffer* _Nullable* _Nonnull buffer) {
+  *buffer = nullptr;
+
+  const uint32_t nativeHWFormat = getNativeHWFormat(desc.format);
+  // multi-planar buffers are sampled as external images
+  const TextureType type = TextureFormatProperties::fromTextureFormat(desc.format).isMultiPlanar()
+                               ? TextureType::ExternalImage
+                               : TextureType::TwoD;
+  if (nativeHWFormat == 0 || (desc.type != TextureType::TwoD && desc.type != type) ||
+      desc.numLayers != 1 || desc.numMipLevels != 1 || desc.numSamples != 1) {
+    return Result{Result::Code::Unsupported,
+                  "AHardwareBuffer textures have to be 2D with 1 layer, mip level and sample"};
+  }
+
+  AHardwareBuffer_Desc descHW = {};
+  descHW.format = nativeHWFormat;
+  descHW.width = static_cast<uint32_t>(desc.width);
+  descHW.height = static_cast<uint32_t>(desc.height);
+  descHW.layers = 1;
+  descHW.usage = getNativeHWBufferUsage(desc.usage);
+
+  if (AHardwareBuffer_allocate(&descHW, buffer) != 0) {
+    *buffer = nullptr;
+    return Result{Result::Code::RuntimeError, "AHardwareBuffer allocation failed"};
+  }
+  return Result{};
+}
+
+Result getNativeHWBufferTextureDesc(AHardwareBuffer* _Nonnull buffer,
+                                    TextureDesc::TextureUsage usage,
+                                    TextureDesc& outDesc) {
+  AHardwareBuffer_Desc descHW = {};
+  AHardwareBuffer_describe(buffer, &descHW);
+
+  const TextureFormat format = getIglFormat(descHW.format);
+  if (format == TextureFormat::Invalid) {
+    return Result{Result::Code::Unsupported, "AHardwareBuffer format has no IGL equivalent"};
+  }
+  if (descHW.layers != 1) {
+    return Result{Result::Code::Unsupported, "AHardwareBuffer arrays are not supported"};
+  }
+
+  if (TextureFormatProperties::fromTextureFormat(format).isMultiPlanar()) {
+    // YUV buffers are converted to RGB by the sampler
+    outDesc = TextureDesc::newExternalImage(format, descHW.width, descHW.height, usage);
+  } else {
+    outDesc = TextureDesc::new2D(format, descHW.width, descHW.height, usage);
+  }
+  outDesc.storage = ResourceStorage::Shared;
+  return Result{};
+}
+
+std::shared_ptr<ITexture> INativeHWBufferInterop::createNativeHWBufferTexture(
+    const TextureDesc& desc,
+    Result* _Nullable outResult) {
+  AHardwareBuffer* buffer = nullptr;
+  const Result result = allocateNativeHWBuffer(desc, &buffer);
+  if (!result.isOk()) {
+    Result::setResult(outResult, result);
+    return nullptr;
+  }
+
+  auto texture = createTextureFromNativeHWBuffer(buffer, desc.usage, -1, outResult);
+  // the texture holds its own reference
+  AHardwareBuffer_release(buffer);
+
+  return texture;
+}
+
+} // namespace igl::android
+
+#endif // IGL_ANDROID_HWBUFFER_SUPPORTED
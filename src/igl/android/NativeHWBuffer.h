@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Texture.h>
+
+#if defined(__ANDROID_API__) && __ANDROID_MIN_SDK_VERSION__ >= 26
+#define IGL_ANDROID_HWBUFFER_SUPPORTED 1
+#else
+#define IGL_ANDROID_HWBUFFER_SUPPORTED 0
+#endif
+
+#if IGL_ANDROID_HWBUFFER_SUPPORTED
+
+struct AHardwareBuffer;
+
+namespace igl::android {
+
+/// Returns the AHARDWAREBUFFER_FORMAT_* matching `format`, or 0 if there is none
+uint32_t getNativeHWFormat(TextureFormat format);
+
+/// Returns the IGL format matching an AHARDWAREBUFFER_FORMAT_*, or TextureFormat::Invalid
+TextureFormat getIglFormat(uint32_t nativeFormat);
+
+/// Returns the AHARDWAREBUFFER_USAGE_* flags required by `usage`
+uint64_t getNativeHWBufferUsage(TextureDesc::TextureUsage usage);
+
+/// Allocates an AHardwareBuffer for a 2D texture with one layer, mip level and sample. The caller
+/// owns the returned reference.
+Result allocateNativeHWBuffer(const TextureDesc& desc, AHardwareBuffer* _Nullable* _Nonnull buffer);
+
+/// Describes the texture which wraps `buffer`
+Result getNativeHWBufferTextureDesc(AHardwareBuffer* _Nonnull buffer,
+                                    TextureDesc::TextureUsage usage,
+                                    TextureDesc& outDesc);
+
+/**
+ * @brief Zero-copy AHardwareBuffer interop, implemented by the EGL and Vulkan platform devices.
+ *
+ * Textures created here alias the memory of an AHardwareBuffer, so camera frames, video decoder
+ * output and compositor buffers are sampled or rendered into without uploads or CPU copies. The
+ * textures hold a reference to their AHardwareBuffer.
+ *
+ * The GPU work of IGL and of the other users of a buffer is ordered with Android sync file
+ * descriptors, where -1 means "nothing to wait for":
+ *  - the acquire fence passed when importing a buffer is waited on by the GPU before the work
+ *    submitted next; IGL takes ownership of it in all cases;
+ *  - createReleaseFence() returns a fence which is signaled once all the work submitted so far is
+ *    finished; hand it to the next user of the buffer when it is released.
+ */
+class INativeHWBufferInterop {
+ public:
+  virtual ~INativeHWBufferInterop() = default;
+
+  /// Wraps an existing AHardwareBuffer, e.g. a camera or video decoder frame.
+  /// @param buffer The buffer to import; it has to be 2D with one layer and an IGL format
+  /// @param usage The way IGL is going to use the texture
+  /// @param acquireFenceFd A fence signaled when the producer is done writing to `buffer`, or -1
+  /// @param outResult optional result
+  /// @return pointer to the texture or nullptr
+  virtual std::shared_ptr<ITexture> createTextureFromNativeHWBuffer(
+      AHardwareBuffer* _Nonnull buffer,
+      TextureDesc::TextureUsage usage,
+      int acquireFenceFd,
+      Result* _Nullable outResult) = 0;
+
+  /// Allocates an AHardwareBuffer for `desc` and wraps it into a texture; use
+  /// getNativeHWBuffer() to pass the buffer to other APIs or processes.
+  std::shared_ptr<ITexture> createNativeHWBufferTexture(const TextureDesc& desc,
+                                                        Result* _Nullable outResult);
+
+  /// Returns the AHardwareBuffer backing `texture`, or nullptr if it does not have one. The buffer
+  /// lives as long as the texture; call AHardwareBuffer_acquire() to keep it longer.
+  virtual AHardwareBuffer* _Nullable getNativeHWBuffer(const ITexture& texture) const = 0;
+
+  /// Returns a fence signaled once all the work submitted so far is finished, or -1 on failure. The
+  /// caller owns the file descriptor.
+  virtual int createReleaseFence(Result* _Nullable outResult) = 0;
+};
+
+} // namespace igl::android
+
+#endif // IGL_ANDROID_HWBUFFER_SUPPORTED
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace igl {
+namespace metal {
+
+/**
+ * @brief The bindless resource table of a device (Metal 3 argument buffers), mirroring the bindless
+ * descriptor set of the Vulkan backend.
+ *
+ * Textures and samplers get a slot on the first call to ITexture::getTextureId() or
+ * SamplerState::getSamplerId(). The table is one buffer of MTLResourceIDs bound to every render
+ * command encoder at kBufferIndex for the fragment stage, so draws only push indices (i.e. with
+ * IRenderCommandEncoder::bindPushConstants()). Fragment shaders access it as:
+ *
+ *   struct BindlessTable {
+ *     array<texture2d<float>, igl::metal::BindlessTable::kMaxTextures> textures;
+ *     array<sampler, igl::metal::BindlessTable::kMaxSamplers> samplers;
+ *   };
+ *   fragment float4 main0(..., constant BindlessTable& table [[buffer(30)]])
+ *
+ * All handles have the same size, so other texture types use the same layout with a different
+ * element type. Slot 0 is never used. Slots of destroyed resources are reused only after the
+ * command buffers which could have accessed them have completed.
+ *
+ * Requires MTLGPUFamilyMetal3 (see DeviceFeatures::TextureBindless).
+ */
+class BindlessTable final {
+ public:
+  static constexpr uint32_t kMaxTextures = 4096;
+  static constexpr uint32_t kMaxSamplers = 1024;
+  static constexpr uint32_t kBufferIndex = 30;
+
+  explicit BindlessTable(id<MTLDevice> device);
+
+  static bool isSupported(id<MTLDevice> device);
+
+  // return 0 if the table is full
+  uint32_t acquireTextureSlot(id<MTLTexture> texture);
+  uint32_t acquireSamplerSlot(id<MTLSamplerState> sampler);
+  void releaseTextureSlot(uint32_t slot);
+  void releaseSamplerSlot(uint32_t slot);
+
+  // binds the table to `encoder` and makes all its textures resident
+  void bind(id<MTLRenderCommandEncoder> encoder, id<MTLCommandBuffer> commandBuffer);
+
+ private:
+  struct Slots {
+    Slots(uint32_t size, uint32_t firstEntry);
+    std::vector<id> resources; // retained until the slot is reused
+    std::vector<uint32_t> freeSlots;
+    // released slots and the epoch they were released in
+    std::vector<std::pair<uint32_t, uint64_t>> releasedSlots;
+    uint32_t firstEntry; // index of the first entry in the table buffer
+  };
+
+  // tracks which epochs still have command buffers in flight; shared with completion handlers
+  struct InFlightTracker {
+    std::mutex mutex;
+    std::map<uint64_t, uint32_t> numCommandBuffers; // per epoch
+  };
+
+  uint32_t acquireSlot(Slots& slots, id resource, uint64_t resourceId);
+  void releaseSlot(Slots& slots, uint32_t slot);
+  // moves released slots which are no longer accessed by the GPU to the free list
+  void recycleSlots(Slots& slots);
+
+ private:
+  id<MTLBuffer> buffer_;
+  std::mutex mutex_;
+  Slots textures_;
+  Slots samplers_;
+  // a new epoch begins whenever a slot is released
+  uint64_t epoch_ = 0;
+  std::shared_ptr<InFlightTracker> inFlight_;
+  // textures to make resident in bind(), rebuilt when textures are added or removed
+  std::vector<id<MTLResource>> residentTextures_;
+  bool residentTexturesDirty_ = false;
+};
+
+} // namespace metal
+} // namespace igl
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/BindlessTable.h>
+
+#include <cstring>
+#include <igl/Common.h>
+
+namespace igl {
+namespace metal {
+
+BindlessTable::Slots::Slots(uint32_t size, uint32_t firstEntry) :
+  resources(size, nil), firstEntry(firstEntry) {
+  freeSlots.reserve(size);
+  // slot 0 is reserved; hand out low slots first
+  for (uint32_t slot = size - 1; slot > 0; slot--) {
+    freeSlots.push_back(slot);
+  }
+}
+
+BindlessTable::BindlessTable(id<MTLDevice> device) :
+  textures_(kMaxTextures, 0),
+  samplers_(kMaxSamplers, kMaxTextures),
+  inFlight_(std::make_shared<InFlightTracker>()) {
+  // one MTLResourceID per entry
+  const NSUInteger length = (kMaxTextures + kMaxSamplers) * sizeof(uint64_t);
+  buffer_ = [device newBufferWithLength:length options:MTLResourceStorageModeShared];
+  buffer_.label = @"BindlessTable";
+  memset(buffer_.contents, 0, length);
+}
+
+bool BindlessTable::isSupported(id<MTLDevice> device) {
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    return [device supportsFamily:MTLGPUFamilyMetal3];
+  }
+  return false;
+}
+
+uint32_t BindlessTable::acquireTextureSlot(id<MTLTexture> texture) {
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t slot = acquireSlot(textures_, texture, texture.gpuResourceID._impl);
+    residentTexturesDirty_ |= slot != 0;
+    return slot;
+  }
+  return 0;
+}
+
+uint32_t BindlessTable::acquireSamplerSlot(id<MTLSamplerState> sampler) {
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return acquireSlot(samplers_, sampler, sampler.gpuResourceID._impl);
+  }
+  return 0;
+}
+
+void BindlessTable::releaseTextureSlot(uint32_t slot) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  releaseSlot(textures_, slot);
+}
+
+void BindlessTable::releaseSamplerSlot(uint32_t slot) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  releaseSlot(samplers_, slot);
+}
+
+uint32_t BindlessTable::acquireSlot(Slots& slots, id resource, uint64_t resourceId) {
+  if (slots.freeSlots.empty()) {
+    recycleSlots(slots);
+  }
+  if (slots.freeSlots.empty()) {
+    IGL_LOG_ERROR("The bindless table is full\n");
+    return 0;
+  }
+  const uint32_t slot = slots.freeSlots.back();
+  slots.freeSlots.pop_back();
+  slots.resources[slot] = resource;
+  static_cast<uint64_t*>(buffer_.contents)[slots.firstEntry + slot] = resourceId;
+  return slot;
+}
+
+void BindlessTable::releaseSlot(Slots& slots, uint32_t slot) {
+  if (!IGL_VERIFY(slot != 0 && slot < slots.resources.size())) {
+    return;
+  }
+  // the table entry and the resource stay valid for command buffers already using this slot
+  slots.releasedSlots.emplace_back(slot, epoch_++);
+}
+
+void BindlessTable::recycleSlots(Slots& slots) {
+  uint64_t oldestEpochInFlight = UINT64_MAX;
+  {
+    std::lock_guard<std::mutex> lock(inFlight_->mutex);
+    if (!inFlight_->numCommandBuffers.empty()) {
+      oldestEpochInFlight = inFlight_->numCommandBuffers.begin()->first;
+    }
+  }
+
+  auto it = slots.releasedSlots.begin();
+  for (; it != slots.releasedSlots.end() && it->second < oldestEpochInFlight; ++it) {
+    const uint32_t slot = it->first;
+    slots.resources[slot] = nil;
+    static_cast<uint64_t*>(buffer_.contents)[slots.firstEntry + slot] = 0;
+    slots.freeSlots.push_back(slot);
+    residentTexturesDirty_ |= &slots == &textures_;
+  }
+  slots.releasedSlots.erase(slots.releasedSlots.begin(), it);
+}
+
+void BindlessTable::bind(id<MTLRenderCommandEncoder> encoder, id<MTLCommandBuffer> commandBuffer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // reclaim slots regularly, so released textures are not kept alive for too long
+  recycleSlots(textures_);
+  recycleSlots(samplers_);
+
+  if (residentTexturesDirty_) {
+    residentTextures_.clear();
+    for (id resource : textures_.resources) {
+      if (resource != nil) {
+        residentTextures_.push_back(resource);
+      }
+    }
+    residentTexturesDirty_ = false;
+  }
+
+  auto inFlight = inFlight_;
+  const uint64_t epoch = epoch_;
+  {
+    std::lock_guard<std::mutex> inFlightLock(inFlight->mutex);
+    inFlight->numCommandBuffers[epoch]++;
+  }
+  [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> /*buffer*/) {
+    std::lock_guard<std::mutex> inFlightLock(inFlight->mutex);
+    auto entry = inFlight->numCommandBuffers.find(epoch);
+    if (--entry->second == 0) {
+      inFlight->numCommandBuffers.erase(entry);
+    }
+  }];
+
+  [encoder setFragmentBuffer:buffer_ offset:0 atIndex:kBufferIndex];
+  if (!residentTextures_.empty()) {
+    [encoder useResources:residentTextures_.data()
+                    count:residentTextures_.size()
+                    usage:MTLResourceUsageRead
+                   stages:MTLRenderStageFragment];
+  }
+}
+
+} // namespace metal
+} // namespace igl
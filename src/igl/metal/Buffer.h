@@ -34,14 +34,25 @@ class Buffer : public igl::IBuffer {
 
   size_t getSizeInBytes() const override;
   [[nodiscard]] uint64_t gpuAddress(size_t offset) const override;
+  std::shared_ptr<IReadback> readAsync(ICommandQueue& cmdQueue,
+                                       const BufferRange& range,
+                                       Result* outResult) override;
 
   IGL_INLINE virtual id<MTLBuffer> get() {
     return mtlBuffers_[0];
   }
 
+  // Offset of this buffer's contents in get(). Non-zero for sub-allocated ring buffers, so it has
+  // to be added to all offsets passed to Metal.
+  IGL_INLINE size_t getOffset() const {
+    return offset_;
+  }
+
  protected:
   MTLResourceOptions resourceOptions_;
   std::vector<id<MTLBuffer>> mtlBuffers_;
+  size_t offset_ = 0;
+  size_t length_ = 0;
   BufferDesc::BufferAPIHint requestedApiHints_;
   BufferDesc::BufferAPIHint acceptedApiHints_;
 };
@@ -49,12 +60,16 @@ class Buffer : public igl::IBuffer {
 // Manages a ring of buffers.
 // At a given time frame, all upload, map and get methods operate on the buffer
 // indexed by the current inFlight buffer index
+// A sub-allocated ring buffer occupies `length` bytes at `offset` of each MTLBuffer (see
+// RingBufferAllocator); by default it occupies the whole MTLBuffers.
 class RingBuffer final : public Buffer {
  public:
   RingBuffer(std::vector<id<MTLBuffer>> ringBuffers,
              MTLResourceOptions options,
              std::shared_ptr<const BufferSynchronizationManager> syncManager,
-             BufferDesc::BufferAPIHint requestedApiHints);
+             BufferDesc::BufferAPIHint requestedApiHints,
+             size_t offset = 0,
+             size_t length = 0);
 
   Result upload(const void* data, const BufferRange& range) override;
 
@@ -8,18 +8,22 @@
 #include <igl/IGLSafeC.h>
 #include <igl/metal/Buffer.h>
 #include <igl/metal/BufferSynchronizationManager.h>
+#include <igl/metal/CommandQueue.h>
+#include <igl/metal/Readback.h>
 
 namespace {
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+// `baseOffset` and `length` describe the part of the MTLBuffer used by the IGL buffer
 igl::Result upload(const std::vector<id<MTLBuffer>>& buffers,
                    size_t bufferIdx,
+                   size_t baseOffset,
+                   size_t length,
                    const void* data,
                    const igl::BufferRange& range,
                    MTLResourceOptions resourceOptions,
                    igl::BufferDesc::BufferAPIHint acceptedApiHints) {
   IGL_ASSERT(bufferIdx < buffers.size());
   const auto& buffer = buffers[bufferIdx];
-  auto length = [buffer length];
   if (!IGL_VERIFY(range.offset + range.size <= length)) {
     return igl::Result(igl::Result::Code::ArgumentOutOfRange);
   }
@@ -29,13 +33,13 @@ igl::Result upload(const std::vector<id<MTLBuffer>>& buffers,
       return igl::Result(igl::Result::Code::ArgumentInvalid);
     }
   } else {
-    void* contents = [buffer contents];
+    void* contents = static_cast<uint8_t*>([buffer contents]) + baseOffset;
     checked_memcpy_offset(contents, length, range.offset, data, range.size);
   }
 
 #if IGL_PLATFORM_MACOS
   if ((resourceOptions & MTLResourceStorageModeMask) == MTLResourceStorageModeManaged) {
-    [buffer didModifyRange:NSMakeRange(range.offset, range.size)];
+    [buffer didModifyRange:NSMakeRange(baseOffset + range.offset, range.size)];
   }
 #else
   (void)resourceOptions; // silence unused member warning
@@ -70,6 +74,8 @@ void* map(const std::vector<id<MTLBuffer>>& buffers,
 
 igl::Result copyFromPreviousBufferInstance(std::vector<id<MTLBuffer>>& buffers,
                                            size_t bufferIdx,
+                                           size_t baseOffset,
+                                           size_t length,
                                            MTLResourceOptions resourceOptions,
                                            igl::BufferDesc::BufferAPIHint acceptedApiHints) {
   if (buffers.size() <= 1) {
@@ -79,10 +85,11 @@ igl::Result copyFromPreviousBufferInstance(std::vector<id<MTLBuffer>>& buffers,
   size_t prevIdx = bufferIdx == 0 ? buffers.size() - 1 : bufferIdx - 1;
   IGL_ASSERT([buffers[bufferIdx] length] == [buffers[prevIdx] length]);
 
-  auto length = [buffers[bufferIdx] length];
-  auto srcContents = [buffers[prevIdx] contents];
+  auto srcContents = static_cast<uint8_t*>([buffers[prevIdx] contents]) + baseOffset;
   return ::upload(buffers,
                   bufferIdx,
+                  baseOffset,
+                  length,
                   srcContents,
                   igl::BufferRange(length, 0),
                   resourceOptions,
@@ -98,13 +105,15 @@ Buffer::Buffer(id<MTLBuffer> value,
                BufferDesc::BufferAPIHint requestedApiHints,
                BufferDesc::BufferAPIHint acceptedApiHints) :
   resourceOptions_(options),
+  length_([value length]),
   requestedApiHints_(requestedApiHints),
   acceptedApiHints_(acceptedApiHints) {
   mtlBuffers_.push_back(value);
 }
 
 Result Buffer::upload(const void* data, const BufferRange& range) {
-  return ::upload(mtlBuffers_, 0, data, range, resourceOptions_, acceptedApiHints_);
+  IGL_PROFILER_FUNCTION();
+  return ::upload(mtlBuffers_, 0, 0, length_, data, range, resourceOptions_, acceptedApiHints_);
 }
 
 void* Buffer::map(const BufferRange& range, Result* outResult) {
@@ -140,21 +149,45 @@ ResourceStorage Buffer::storage() const noexcept {
 }
 
 size_t Buffer::getSizeInBytes() const {
-  return [mtlBuffers_[0] length];
+  return length_;
 }
 
-uint64_t Buffer::gpuAddress(size_t) const {
-  // TODO: implement via gpuResourceID
-  IGL_ASSERT_NOT_IMPLEMENTED();
+uint64_t Buffer::gpuAddress(size_t offset) const {
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    // ring buffers return the address of the instance used by the current frame
+    return [const_cast<Buffer*>(this)->get() gpuAddress] + offset_ + offset;
+  }
+  IGL_ASSERT_MSG(false, "Buffer addresses require macOS 13.0 or iOS 16.0");
   return 0;
 }
 
+std::shared_ptr<IReadback> Buffer::readAsync(ICommandQueue& cmdQueue,
+                                             const BufferRange& range,
+                                             Result* outResult) {
+  if (range.size == 0 || range.size > getSizeInBytes() ||
+      range.offset > getSizeInBytes() - range.size) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Range exceeds buffer length");
+    return nullptr;
+  }
+  // ring buffers read the instance used by the current frame
+  return Readback::create(static_cast<CommandQueue&>(cmdQueue).get(),
+                          get(),
+                          offset_ + range.offset,
+                          range.size,
+                          outResult);
+}
+
 RingBuffer::RingBuffer(std::vector<id<MTLBuffer>> ringBuffers,
                        MTLResourceOptions options,
                        std::shared_ptr<const BufferSynchronizationManager> syncManager,
-                       BufferDesc::BufferAPIHint requestedApiHints) :
+                       BufferDesc::BufferAPIHint requestedApiHints,
+                       size_t offset,
+                       size_t length) :
   Buffer(nil, options, requestedApiHints, BufferDesc::BufferAPIHintBits::Ring),
   syncManager_(std::move(syncManager)) {
+  IGL_ASSERT(!ringBuffers.empty());
+  offset_ = offset;
+  length_ = length ? length : [ringBuffers[0] length] - offset;
   mtlBuffers_ = std::move(ringBuffers);
 }
 
@@ -162,21 +195,22 @@ RingBuffer::RingBuffer(std::vector<id<MTLBuffer>> ringBuffers,
  * To handle this case, we copy the previous instance of the buffer to this one
  */
 Result RingBuffer::upload(const void* data, const BufferRange& range) {
+  IGL_PROFILER_FUNCTION();
   auto bufferIdx = syncManager_->getCurrentInFlightBufferIndex();
 
   if (lastUpdatedBufferIdx_ != bufferIdx) {
-    auto length = [mtlBuffers_[bufferIdx] length];
-    if (range.offset != 0 || range.size != length) {
+    if (range.offset != 0 || range.size != length_) {
       // partial upload
       // Copy from the previous buffer first
       auto result = copyFromPreviousBufferInstance(
-          mtlBuffers_, bufferIdx, resourceOptions_, acceptedApiHints_);
+          mtlBuffers_, bufferIdx, offset_, length_, resourceOptions_, acceptedApiHints_);
       if (!result.isOk()) {
         return result;
       }
     }
   }
-  auto result = ::upload(mtlBuffers_, bufferIdx, data, range, resourceOptions_, acceptedApiHints_);
+  auto result = ::upload(
+      mtlBuffers_, bufferIdx, offset_, length_, data, range, resourceOptions_, acceptedApiHints_);
   if (result.isOk()) {
     lastUpdatedBufferIdx_ = bufferIdx;
   }
@@ -198,7 +232,8 @@ id<MTLBuffer> RingBuffer::get() {
   if (bufferIdx != lastUpdatedBufferIdx_) {
     // client hasn't updated the buffer at this idx; Update from the previous buffer instance
     auto result =
-        copyFromPreviousBufferInstance(mtlBuffers_, bufferIdx, resourceOptions_, acceptedApiHints_);
+        copyFromPreviousBufferInstance(
+            mtlBuffers_, bufferIdx, offset_, length_, resourceOptions_, acceptedApiHints_);
     if (!result.isOk()) {
       IGL_ASSERT_MSG(0, "Failed to copy buffer");
       return nullptr;
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <Metal/Metal.h>
+#include <atomic>
 #include <igl/Buffer.h>
 
 namespace igl::metal {
@@ -21,7 +22,7 @@ class BufferSynchronizationManager {
    * @return the current inFlight buffer index
    */
   size_t getCurrentInFlightBufferIndex() const noexcept {
-    return currentInFlightBufferIndex_;
+    return currentInFlightBufferIndex_.load(std::memory_order_acquire);
   }
 
   /**
@@ -36,6 +37,30 @@ class BufferSynchronizationManager {
     return maxInFlightBuffers_;
   }
 
+  /**
+   * @brief Returns the number of frames ended with manageEndOfFrameSync()
+   */
+  uint64_t getFrameCount() const noexcept {
+    return frameCount_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Returns how many frames the CPU may run ahead of the GPU, at most
+   * getMaxInflightBuffers()
+   */
+  size_t getInFlightFrameLimit() const noexcept {
+    return inFlightFrameLimit_;
+  }
+
+  /**
+   * @brief Changes how many frames may be in flight at once, i.e. 2 for lower latency or 3 for
+   * more throughput. Ring buffers keep getMaxInflightBuffers() instances, so they stay valid.
+   * Lowering the limit blocks until enough in-flight frames have completed. Must be called from
+   * the thread which ends frames.
+   * @param limit clamped to [1, getMaxInflightBuffers()]
+   */
+  void setInFlightFrameLimit(size_t limit);
+
   void manageEndOfFrameSync();
 
   // Upon completion of this command buffer's execution, trigger buffer synchronization.
@@ -43,7 +68,10 @@ class BufferSynchronizationManager {
 
  private:
   size_t maxInFlightBuffers_ = 1;
-  size_t currentInFlightBufferIndex_ = 0;
+  size_t inFlightFrameLimit_ = 1;
+  // read without locks by threads uploading to ring buffers
+  std::atomic<size_t> currentInFlightBufferIndex_{0};
+  std::atomic<uint64_t> frameCount_{0};
   dispatch_semaphore_t frameBoundarySemaphore_;
 };
 
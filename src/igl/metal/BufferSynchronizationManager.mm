@@ -7,12 +7,13 @@
 
 #include <igl/metal/BufferSynchronizationManager.h>
 
+#include <algorithm>
 #include <igl/metal/CommandBuffer.h>
 
 namespace igl::metal {
 
 BufferSynchronizationManager::BufferSynchronizationManager(size_t maxInFlightBuffers) :
-  maxInFlightBuffers_(maxInFlightBuffers) {
+  maxInFlightBuffers_(maxInFlightBuffers), inFlightFrameLimit_(maxInFlightBuffers) {
   // To manage the pool of buffers, we would normally initialize the semaphore with the pool size
   // (i.e. 'maxInFlightBuffers'). However, semaphore crashes at destruction time, if its current
   // value is less than its initial value. This seems to Apple's libdispatch's idiosyncrasy.
@@ -48,7 +49,23 @@ void BufferSynchronizationManager::manageEndOfFrameSync() {
   dispatch_semaphore_wait(frameBoundarySemaphore_, DISPATCH_TIME_FOREVER);
 
   // increment currentInFlightBufferIndex
-  currentInFlightBufferIndex_ = (currentInFlightBufferIndex_ + 1) % maxInFlightBuffers_;
+  currentInFlightBufferIndex_.store((currentInFlightBufferIndex_ + 1) % maxInFlightBuffers_,
+                                    std::memory_order_release);
+  frameCount_.fetch_add(1, std::memory_order_release);
+}
+
+void BufferSynchronizationManager::setInFlightFrameLimit(size_t limit) {
+  limit = std::clamp<size_t>(limit, 1, maxInFlightBuffers_);
+  // The semaphore holds one permit per frame which may still start. Ring buffers always rotate
+  // through all maxInFlightBuffers_ instances, so withholding permits is all that is needed.
+  while (inFlightFrameLimit_ > limit) {
+    dispatch_semaphore_wait(frameBoundarySemaphore_, DISPATCH_TIME_FOREVER);
+    inFlightFrameLimit_--;
+  }
+  while (inFlightFrameLimit_ < limit) {
+    dispatch_semaphore_signal(frameBoundarySemaphore_);
+    inFlightFrameLimit_++;
+  }
 }
 
 }
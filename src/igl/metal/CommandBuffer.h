@@ -13,10 +13,14 @@
 namespace igl {
 namespace metal {
 
+class BindlessTable;
+
 class CommandBuffer final : public ICommandBuffer,
                             public std::enable_shared_from_this<CommandBuffer> {
  public:
-  explicit CommandBuffer(id<MTLCommandBuffer> value);
+  explicit CommandBuffer(id<MTLCommandBuffer> value,
+                         std::shared_ptr<BindlessTable> bindlessTable = nullptr,
+                         id<MTLFence> passFence = nil);
   ~CommandBuffer() override = default;
 
   std::unique_ptr<IComputeCommandEncoder> createComputeCommandEncoder() override;
@@ -26,22 +30,55 @@ class CommandBuffer final : public ICommandBuffer,
       std::shared_ptr<IFramebuffer> framebuffer,
       Result* outResult) override;
 
+  std::unique_ptr<IParallelRenderCommandEncoder> createParallelRenderCommandEncoder(
+      const RenderPassDesc& renderPass,
+      std::shared_ptr<IFramebuffer> framebuffer,
+      Result* outResult) override;
+
   void present(std::shared_ptr<ITexture> surface) const override;
 
   void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
 
   void popDebugGroupLabel() const override;
 
+  void writeTimestamp(ITimestampQueryPool& pool, uint32_t queryIndex) override;
+
+  void copyBufferToTexture(IBuffer& buffer,
+                           size_t bufferOffset,
+                           ITexture& texture,
+                           const TextureRangeDesc& range) override;
+
   void waitUntilScheduled() override;
 
   void waitUntilCompleted() override;
 
+  void addCompletedHandler(std::function<void()> handler) override;
+
+  [[nodiscard]] bool isCompleted() const override;
+
   IGL_INLINE id<MTLCommandBuffer> get() const {
     return value_;
   }
 
+  // bound to every render command encoder of this command buffer; nullptr if not supported
+  IGL_INLINE BindlessTable* getBindlessTable() const {
+    return bindlessTable_.get();
+  }
+
+  IGL_INLINE bool hasPresented() const {
+    return hasPresented_;
+  }
+
+  // waited for and updated by every render and compute pass; nil when hazards are tracked
+  IGL_INLINE id<MTLFence> getPassFence() const {
+    return passFence_;
+  }
+
  private:
   id<MTLCommandBuffer> value_;
+  std::shared_ptr<BindlessTable> bindlessTable_;
+  id<MTLFence> passFence_;
+  mutable bool hasPresented_ = false;
 };
 
 } // namespace metal
@@ -10,17 +10,23 @@
 #import <Foundation/Foundation.h>
 
 #import <Metal/Metal.h>
+#include <igl/metal/Buffer.h>
 #include <igl/metal/ComputeCommandEncoder.h>
+#include <igl/metal/ParallelRenderCommandEncoder.h>
 #include <igl/metal/RenderCommandEncoder.h>
 #include <igl/metal/Texture.h>
+#include <igl/metal/TimestampQueryPool.h>
 
 namespace igl {
 namespace metal {
 
-CommandBuffer::CommandBuffer(id<MTLCommandBuffer> value) : value_(value) {}
+CommandBuffer::CommandBuffer(id<MTLCommandBuffer> value,
+                             std::shared_ptr<BindlessTable> bindlessTable,
+                             id<MTLFence> passFence) :
+  value_(value), bindlessTable_(std::move(bindlessTable)), passFence_(passFence) {}
 
 std::unique_ptr<IComputeCommandEncoder> CommandBuffer::createComputeCommandEncoder() {
-  return std::make_unique<ComputeCommandEncoder>(value_);
+  return std::make_unique<ComputeCommandEncoder>(value_, passFence_);
 }
 
 std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder(
@@ -30,6 +36,14 @@ std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder
   return RenderCommandEncoder::create(shared_from_this(), renderPass, framebuffer, outResult);
 }
 
+std::unique_ptr<IParallelRenderCommandEncoder> CommandBuffer::createParallelRenderCommandEncoder(
+    const RenderPassDesc& renderPass,
+    std::shared_ptr<IFramebuffer> framebuffer,
+    Result* outResult) {
+  return ParallelRenderCommandEncoder::create(
+      shared_from_this(), renderPass, framebuffer, outResult);
+}
+
 void CommandBuffer::present(std::shared_ptr<ITexture> surface) const {
   IGL_ASSERT(surface);
   if (!surface) {
@@ -38,6 +52,7 @@ void CommandBuffer::present(std::shared_ptr<ITexture> surface) const {
   const auto drawable = static_cast<Texture&>(*surface).getDrawable();
   if (drawable != nullptr) {
     [value_ presentDrawable:drawable];
+    hasPresented_ = true;
   }
 }
 
@@ -51,6 +66,49 @@ void CommandBuffer::popDebugGroupLabel() const {
   [value_ popDebugGroup];
 }
 
+void CommandBuffer::writeTimestamp(ITimestampQueryPool& pool, uint32_t queryIndex) {
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    static_cast<TimestampQueryPool&>(pool).writeTimestamp(value_, queryIndex);
+  }
+}
+
+void CommandBuffer::copyBufferToTexture(IBuffer& buffer,
+                                        size_t bufferOffset,
+                                        ITexture& texture,
+                                        const TextureRangeDesc& range) {
+  const TextureFormatProperties properties = texture.getProperties();
+  if (!IGL_VERIFY(!properties.isDepthOrStencil() && range.numMipLevels == 1 &&
+                  texture.getType() != TextureType::Cube && texture.validateRange(range).isOk())) {
+    return;
+  }
+  auto& mtlBuffer = static_cast<Buffer&>(buffer);
+  const bool is3D = texture.getType() == TextureType::ThreeD;
+  const size_t bytesPerRow = properties.getBytesPerRow(range.width);
+  // the size of one 2D slice of a 3D texture, or of one layer
+  const size_t bytesPerImage = properties.getBytesPerLayer(range.width, range.height, 1);
+
+  id<MTLBlitCommandEncoder> blit = [value_ blitCommandEncoder];
+  if (passFence_) {
+    [blit waitForFence:passFence_];
+  }
+  const size_t numSlices = is3D ? 1 : range.numLayers;
+  for (size_t i = 0; i != numSlices; i++) {
+    [blit copyFromBuffer:mtlBuffer.get()
+               sourceOffset:mtlBuffer.getOffset() + bufferOffset + i * bytesPerImage
+          sourceBytesPerRow:bytesPerRow
+        sourceBytesPerImage:bytesPerImage
+                 sourceSize:MTLSizeMake(range.width, range.height, is3D ? range.depth : 1)
+                  toTexture:static_cast<Texture&>(texture).get()
+           destinationSlice:is3D ? 0 : range.layer + i
+           destinationLevel:range.mipLevel
+          destinationOrigin:MTLOriginMake(range.x, range.y, is3D ? range.z : 0)];
+  }
+  if (passFence_) {
+    [blit updateFence:passFence_];
+  }
+  [blit endEncoding];
+}
+
 void CommandBuffer::waitUntilScheduled() {
   [value_ waitUntilScheduled];
 }
@@ -59,5 +117,18 @@ void CommandBuffer::waitUntilCompleted() {
   [value_ waitUntilCompleted];
 }
 
+void CommandBuffer::addCompletedHandler(std::function<void()> handler) {
+  IGL_ASSERT_MSG(value_.status == MTLCommandBufferStatusNotEnqueued,
+                 "Completed handlers have to be added before the submit");
+  [value_ addCompletedHandler:^(id<MTLCommandBuffer> /*buffer*/) {
+    handler();
+  }];
+}
+
+bool CommandBuffer::isCompleted() const {
+  const MTLCommandBufferStatus status = value_.status;
+  return status == MTLCommandBufferStatusCompleted || status == MTLCommandBufferStatusError;
+}
+
 } // namespace metal
 } // namespace igl
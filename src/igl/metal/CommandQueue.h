@@ -14,6 +14,7 @@
 namespace igl {
 namespace metal {
 
+class BindlessTable;
 class BufferSynchronizationManager;
 class DeviceStatistics;
 
@@ -21,11 +22,17 @@ class CommandQueue final : public ICommandQueue {
  public:
   CommandQueue(id<MTLCommandQueue> value,
                std::shared_ptr<BufferSynchronizationManager> syncManager,
-               DeviceStatistics& deviceStatistics) noexcept;
+               DeviceStatistics& deviceStatistics,
+               std::shared_ptr<BindlessTable> bindlessTable = nullptr,
+               id<MTLFence> passFence = nil) noexcept;
   std::shared_ptr<ICommandBuffer> createCommandBuffer(const CommandBufferDesc& desc,
                                                       Result* outResult) override;
   SubmitHandle submit(const igl::ICommandBuffer& commandBuffer, bool endOfFrame = false) override;
 
+  std::shared_ptr<IFence> signalFence(Result* outResult) override;
+  Result waitFence(const IFence& fence) override;
+  std::shared_ptr<IFence> importFence(const FenceNativeHandle& handle, Result* outResult) override;
+
   IGL_INLINE id<MTLCommandQueue> get() const {
     return value_;
   }
@@ -37,6 +44,13 @@ class CommandQueue final : public ICommandQueue {
   id<MTLCommandQueue> value_;
   std::shared_ptr<BufferSynchronizationManager> bufferSyncManager_;
   DeviceStatistics& deviceStatistics_;
+  std::shared_ptr<BindlessTable> bindlessTable_;
+  // every render and compute pass of the queue waits for this fence and updates it when it ends,
+  // so passes are ordered without hazard tracking; nil unless heaps use untracked hazards
+  id<MTLFence> passFence_ = nil;
+  // signalFence() signals increasing values of one event per queue; created on first use
+  id<MTLSharedEvent> sharedEvent_ = nil;
+  uint64_t sharedEventValue_ = 0;
 };
 
 } // namespace metal
@@ -12,6 +12,7 @@
 #include <igl/metal/BufferSynchronizationManager.h>
 #include <igl/metal/CommandBuffer.h>
 #include <igl/metal/DeviceStatistics.h>
+#include <igl/metal/Fence.h>
 
 // @brief Number of command buffers to be automatically captured for GPU debugging. Zero (0)
 // means no command buffers will be recorded and the capture code is deactivated.
@@ -28,8 +29,14 @@ namespace metal {
 
 CommandQueue::CommandQueue(id<MTLCommandQueue> value,
                            std::shared_ptr<BufferSynchronizationManager> syncManager,
-                           DeviceStatistics& deviceStatistics) noexcept :
-  value_(value), bufferSyncManager_(std::move(syncManager)), deviceStatistics_(deviceStatistics) {
+                           DeviceStatistics& deviceStatistics,
+                           std::shared_ptr<BindlessTable> bindlessTable,
+                           id<MTLFence> passFence) noexcept :
+  value_(value),
+  bufferSyncManager_(std::move(syncManager)),
+  deviceStatistics_(deviceStatistics),
+  bindlessTable_(std::move(bindlessTable)),
+  passFence_(passFence) {
   if constexpr (kIGLMetalNumberCommandBuffersToCapture > 0 &&
                 kIGLMetalBeginCommandBufferToCapture == 0) {
     startCapture(value_);
@@ -39,12 +46,13 @@ CommandQueue::CommandQueue(id<MTLCommandQueue> value,
 std::shared_ptr<ICommandBuffer> CommandQueue::createCommandBuffer(const CommandBufferDesc& /*desc*/,
                                                                   Result* outResult) {
   id<MTLCommandBuffer> metalObject = [value_ commandBuffer];
-  auto resource = std::make_shared<CommandBuffer>(metalObject);
+  auto resource = std::make_shared<CommandBuffer>(metalObject, bindlessTable_, passFence_);
   Result::setOk(outResult);
   return resource;
 }
 
 SubmitHandle CommandQueue::submit(const igl::ICommandBuffer& commandBuffer, bool endOfFrame) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_SUBMIT);
   incrementDrawCount(commandBuffer.getCurrentDrawCount());
   deviceStatistics_.incrementDrawCount(commandBuffer.getCurrentDrawCount());
 
@@ -52,12 +60,17 @@ SubmitHandle CommandQueue::submit(const igl::ICommandBuffer& commandBuffer, bool
     bufferSyncManager_->markCommandBufferAsEndOfFrame(commandBuffer);
   }
 
-  [static_cast<const CommandBuffer&>(commandBuffer).get() commit];
+  const auto& mtlCommandBuffer = static_cast<const CommandBuffer&>(commandBuffer);
+  [mtlCommandBuffer.get() commit];
 
   if (endOfFrame) {
     bufferSyncManager_->manageEndOfFrameSync();
   }
 
+  if (endOfFrame || mtlCommandBuffer.hasPresented()) {
+    deviceStatistics_.endFrame();
+  }
+
   if constexpr (kIGLMetalNumberCommandBuffersToCapture > 0) {
     static uint32_t currentCommandBuffer = 0;
     if ((currentCommandBuffer + 1) == kIGLMetalBeginCommandBufferToCapture) {
@@ -72,6 +85,50 @@ SubmitHandle CommandQueue::submit(const igl::ICommandBuffer& commandBuffer, bool
   return SubmitHandle{};
 }
 
+std::shared_ptr<IFence> CommandQueue::signalFence(Result* outResult) {
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    if (!sharedEvent_) {
+      sharedEvent_ = [value_.device newSharedEvent];
+    }
+    // command buffers of a queue run in order, so this one finishes after all the previous ones
+    id<MTLCommandBuffer> commandBuffer = [value_ commandBuffer];
+    [commandBuffer encodeSignalEvent:sharedEvent_ value:++sharedEventValue_];
+    [commandBuffer commit];
+    Result::setOk(outResult);
+    return std::make_shared<Fence>(sharedEvent_, sharedEventValue_);
+  }
+  Result::setResult(outResult, Result::Code::Unsupported, "MTLSharedEvent is not supported");
+  return nullptr;
+}
+
+Result CommandQueue::waitFence(const IFence& fence) {
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    const auto& mtlFence = static_cast<const Fence&>(fence);
+    if (mtlFence.isSignaled()) {
+      return Result();
+    }
+    id<MTLCommandBuffer> commandBuffer = [value_ commandBuffer];
+    [commandBuffer encodeWaitForEvent:mtlFence.getEvent() value:mtlFence.getValue()];
+    [commandBuffer commit];
+    return Result();
+  }
+  return Result(Result::Code::Unsupported, "MTLSharedEvent is not supported");
+}
+
+std::shared_ptr<IFence> CommandQueue::importFence(const FenceNativeHandle& handle,
+                                                  Result* outResult) {
+  if (handle.type != FenceHandleType::MTLSharedEvent || handle.handle == nullptr) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Metal imports MTLSharedEvents only");
+    return nullptr;
+  }
+  if (@available(macOS 10.14, iOS 12.0, *)) {
+    Result::setOk(outResult);
+    return std::make_shared<Fence>((__bridge id<MTLSharedEvent>)handle.handle, handle.value);
+  }
+  Result::setResult(outResult, Result::Code::Unsupported, "MTLSharedEvent is not supported");
+  return nullptr;
+}
+
 void CommandQueue::startCapture(id<MTLCommandQueue> queue) {
   MTLCaptureManager* captureManager = [MTLCaptureManager sharedCaptureManager];
   MTLCaptureDescriptor* captureDescriptor = [[MTLCaptureDescriptor alloc] init];
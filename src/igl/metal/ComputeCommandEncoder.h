@@ -8,15 +8,19 @@
 #pragma once
 
 #include <Metal/Metal.h>
+#include <array>
 #include <igl/ComputeCommandEncoder.h>
+#include <igl/metal/RenderCommandEncoder.h>
 
 namespace igl {
 namespace metal {
 class Buffer;
+class IndirectCommandBuffer;
 
 class ComputeCommandEncoder final : public IComputeCommandEncoder {
  public:
-  explicit ComputeCommandEncoder(id<MTLCommandBuffer> buffer);
+  // the encoder waits for `passFence`, if any, and updates it in endEncoding()
+  explicit ComputeCommandEncoder(id<MTLCommandBuffer> buffer, id<MTLFence> passFence = nil);
   ~ComputeCommandEncoder() override = default;
 
   void endEncoding() override;
@@ -28,6 +32,9 @@ class ComputeCommandEncoder final : public IComputeCommandEncoder {
   // total number of threads per grid is threadgroupCount * threadgroupSize
   void dispatchThreadGroups(const Dimensions& threadgroupCount,
                             const Dimensions& threadgroupSize) override;
+  void dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                    size_t indirectBufferOffset,
+                                    const Dimensions& threadgroupSize) override;
   void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
   void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
   void popDebugGroupLabel() const override;
@@ -36,9 +43,16 @@ class ComputeCommandEncoder final : public IComputeCommandEncoder {
   void bindBuffer(size_t index, const std::shared_ptr<IBuffer>& buffer, size_t offset) override;
   void bindBytes(size_t index, const void* data, size_t length) override;
   void bindPushConstants(const void* data, size_t length, size_t offset) override;
+  void bindBufferAddress(size_t offset, IBuffer& buffer, size_t bufferOffset) override;
+
+  // Binds the argument buffer of `commands` at buffer `index`, so the kernel can encode draws
+  void bindIndirectCommandBuffer(size_t index, const IndirectCommandBuffer& commands);
 
  private:
   id<MTLComputeCommandEncoder> encoder_ = nil;
+  id<MTLFence> passFence_ = nil;
+  std::array<uint8_t, RenderCommandEncoder::kMaxPushConstantsSize> pushConstants_{};
+  size_t pushConstantsSize_ = 0;
   // 4 KB - page aligned memory for metal managed resource
   static constexpr uint32_t MAX_RECOMMENDED_BYTES = 4 * 1024;
 };
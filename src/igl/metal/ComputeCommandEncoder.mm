@@ -7,25 +7,36 @@
 
 #include <igl/metal/ComputeCommandEncoder.h>
 
+#include <algorithm>
+#include <cstring>
+
 #import <Foundation/Foundation.h>
 
 #import <Metal/Metal.h>
 #include <igl/metal/Buffer.h>
 #include <igl/metal/ComputePipelineState.h>
 #include <igl/metal/Framebuffer.h>
+#include <igl/metal/IndirectCommandBuffer.h>
 #include <igl/metal/SamplerState.h>
 #include <igl/metal/Texture.h>
 
 namespace igl {
 namespace metal {
 
-ComputeCommandEncoder::ComputeCommandEncoder(id<MTLCommandBuffer> buffer) {
+ComputeCommandEncoder::ComputeCommandEncoder(id<MTLCommandBuffer> buffer, id<MTLFence> passFence) :
+  passFence_(passFence) {
   id<MTLComputeCommandEncoder> computeEncoder = [buffer computeCommandEncoder];
   encoder_ = computeEncoder;
+  if (passFence_) {
+    [encoder_ waitForFence:passFence_];
+  }
 }
 
 void ComputeCommandEncoder::endEncoding() {
   IGL_ASSERT(encoder_);
+  if (passFence_) {
+    [encoder_ updateFence:passFence_];
+  }
   [encoder_ endEncoding];
   encoder_ = nil;
 }
@@ -71,6 +82,22 @@ void ComputeCommandEncoder::dispatchThreadGroups(const Dimensions& threadgroupCo
   [encoder_ dispatchThreadgroups:tgc threadsPerThreadgroup:tgs];
 }
 
+void ComputeCommandEncoder::dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                                         size_t indirectBufferOffset,
+                                                         const Dimensions& threadgroupSize) {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT_MSG(indirectBufferOffset % 4 == 0, "The offset has to be a multiple of 4");
+  auto& buffer = static_cast<Buffer&>(indirectBuffer);
+
+  MTLSize tgs;
+  tgs.width = threadgroupSize.width;
+  tgs.height = threadgroupSize.height;
+  tgs.depth = threadgroupSize.depth;
+  [encoder_ dispatchThreadgroupsWithIndirectBuffer:buffer.get()
+                              indirectBufferOffset:buffer.getOffset() + indirectBufferOffset
+                             threadsPerThreadgroup:tgs];
+}
+
 void ComputeCommandEncoder::bindUniform(const UniformDesc& /*uniformDesc*/, const void* /*data*/) {
   // DO NOT IMPLEMENT!
   // This is only for backends that MUST use single uniforms in some situations.
@@ -92,10 +119,17 @@ void ComputeCommandEncoder::bindBuffer(size_t index,
   IGL_ASSERT(encoder_);
   if (buffer) {
     auto& iglBuffer = static_cast<Buffer&>(*buffer);
-    [encoder_ setBuffer:iglBuffer.get() offset:offset atIndex:index];
+    [encoder_ setBuffer:iglBuffer.get() offset:iglBuffer.getOffset() + offset atIndex:index];
   }
 }
 
+void ComputeCommandEncoder::bindIndirectCommandBuffer(size_t index,
+                                                      const IndirectCommandBuffer& commands) {
+  IGL_ASSERT(encoder_);
+  [encoder_ setBuffer:commands.getArgumentBuffer() offset:0 atIndex:index];
+  [encoder_ useResource:commands.get() usage:MTLResourceUsageWrite];
+}
+
 void ComputeCommandEncoder::bindBytes(size_t index, const void* data, size_t length) {
   IGL_ASSERT(encoder_);
   if (data) {
@@ -108,10 +142,32 @@ void ComputeCommandEncoder::bindBytes(size_t index, const void* data, size_t len
   }
 }
 
-void ComputeCommandEncoder::bindPushConstants(const void* /*data*/,
-                                              size_t /*length*/,
-                                              size_t /*offset*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+void ComputeCommandEncoder::bindPushConstants(const void* data, size_t length, size_t offset) {
+  IGL_ASSERT(encoder_);
+  if (!IGL_VERIFY(data != nullptr) ||
+      !IGL_VERIFY(offset + length <= RenderCommandEncoder::kMaxPushConstantsSize)) {
+    return;
+  }
+  // same layout as RenderCommandEncoder: the whole range is uploaded again
+  std::memcpy(pushConstants_.data() + offset, data, length);
+  pushConstantsSize_ = std::max(pushConstantsSize_, offset + length);
+  [encoder_ setBytes:pushConstants_.data()
+              length:pushConstantsSize_
+             atIndex:RenderCommandEncoder::kPushConstantsBufferIndex];
+}
+
+void ComputeCommandEncoder::bindBufferAddress(size_t offset,
+                                              IBuffer& buffer,
+                                              size_t bufferOffset) {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT_MSG((offset & 7) == 0, "Buffer addresses must be 8 bytes aligned in push constants");
+
+  auto& iglBuffer = static_cast<Buffer&>(buffer);
+  const uint64_t address = iglBuffer.gpuAddress(bufferOffset);
+  bindPushConstants(&address, sizeof(address), offset);
+
+  // Metal does not track resources which are only accessed through their addresses
+  [encoder_ useResource:iglBuffer.get() usage:MTLResourceUsageRead | MTLResourceUsageWrite];
 }
 
 } // namespace metal
@@ -11,12 +11,19 @@
 #include <igl/Device.h>
 #include <igl/metal/DeviceFeatureSet.h>
 #include <igl/metal/DeviceStatistics.h>
+#include <igl/metal/HeapAllocator.h>
+#include <igl/metal/IndirectCommandBuffer.h>
 #include <igl/metal/PlatformDevice.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 namespace igl {
 namespace metal {
 
+class BindlessTable;
 class BufferSynchronizationManager;
+class RingBufferAllocator;
 
 class Device : public IDevice {
   friend class HWDevice;
@@ -38,14 +45,58 @@ class Device : public IDevice {
                                                     Result* outResult) const override;
   std::shared_ptr<ITexture> createTexture(const TextureDesc& desc,
                                           Result* outResult) const noexcept override;
+  std::shared_ptr<ITexture> createTextureView(const ITexture& texture,
+                                              const TextureViewDesc& desc,
+                                              Result* outResult) const override;
   std::shared_ptr<IVertexInputState> createVertexInputState(const VertexInputStateDesc& desc,
                                                             Result* outResult) const override;
 
+  // Opt-in: sub-allocate buffers and textures created from now on from MTLHeaps. Returns false if
+  // heaps are not supported. With HeapAllocatorConfig::untrackedHazards, call it before creating
+  // the command queues, which then fence their passes.
+  bool enableHeapAllocation(const HeapAllocatorConfig& config = {});
+  // nullptr unless enableHeapAllocation() succeeded
+  const HeapAllocator* getHeapAllocator() const {
+    return heapAllocator_.get();
+  }
+  // Opt-in: look render pipelines up in an MTLBinaryArchive stored at `path`, so their GPU code is
+  // not compiled again on the next launches. Pipelines missing from the archive are added to it;
+  // call serializeBinaryArchive() to write it back, e.g. when the app goes to the background.
+  // Returns false if binary archives are not supported (macOS 11 / iOS 14) or cannot be created.
+  bool enableBinaryArchive(const std::string& path);
+  // Writes the binary archive back to its path if pipelines were added to it since the last call
+  Result serializeBinaryArchive() const;
+  // Libraries compiled from source are kept in memory and reused for identical source and
+  // compile options; drops them all
+  void clearShaderLibraryCache();
+  [[nodiscard]] size_t getShaderLibraryCacheSize() const;
+  // Opt-in: place ring buffers of at most `maxBufferSize` bytes side by side into shared pages of
+  // `pageSize` bytes instead of creating separate MTLBuffers for each of them
+  void enableRingBufferSubAllocation(size_t maxBufferSize = 4 * 1024,
+                                     size_t pageSize = 256 * 1024);
+  // How many frames may be in flight at once, between 1 and IGL_METAL_MAX_IN_FLIGHT_BUFFERS (see
+  // BufferSynchronizationManager::setInFlightFrameLimit()). Call from the thread ending frames.
+  void setInFlightFrameLimit(size_t limit);
+  size_t getInFlightFrameLimit() const;
+
+  // A render target which is only valid until the end of the current frame (see
+  // ICommandQueue::submit() with endOfFrame). Its memory is aliased by transient textures of later
+  // frames. Falls back to createTexture() if heap allocation is disabled or its heap is full.
+  std::shared_ptr<ITexture> createTransientTexture(const TextureDesc& desc,
+                                                   Result* outResult) const noexcept;
+
   // Pipelines
   std::shared_ptr<IComputePipelineState> createComputePipeline(const ComputePipelineDesc& desc,
                                                                Result* outResult) const override;
   std::shared_ptr<IRenderPipelineState> createRenderPipeline(const RenderPipelineDesc& desc,
                                                              Result* outResult) const override;
+  std::future<PipelineCreationResult<IComputePipelineState>> createComputePipelineAsync(
+      const ComputePipelineDesc& desc) const override;
+  std::future<PipelineCreationResult<IRenderPipelineState>> createRenderPipelineAsync(
+      const RenderPipelineDesc& desc) const override;
+  std::vector<std::shared_ptr<IRenderPipelineState>> createRenderPipelines(
+      const std::vector<RenderPipelineDesc>& descs,
+      Result* outResult) const override;
 
   // Shaders
   std::unique_ptr<IShaderLibrary> createShaderLibrary(const ShaderLibraryDesc& desc,
@@ -54,9 +105,26 @@ class Device : public IDevice {
   std::shared_ptr<IShaderModule> createShaderModule(const ShaderModuleDesc& desc,
                                                     Result* outResult) const override;
 
+  std::vector<std::shared_ptr<IShaderModule>> createShaderModules(
+      const std::vector<ShaderModuleDesc>& descs,
+      Result* outResult) const override;
+
   std::unique_ptr<IShaderStages> createShaderStages(const ShaderStagesDesc& desc,
                                                     Result* outResult) const override;
 
+  std::shared_ptr<IOcclusionQueryPool> createOcclusionQueryPool(
+      const OcclusionQueryPoolDesc& desc,
+      Result* outResult) const override;
+
+  std::shared_ptr<ITimestampQueryPool> createTimestampQueryPool(
+      const TimestampQueryPoolDesc& desc,
+      Result* outResult) const override;
+
+  // Metal only: draws encoded on the CPU or by compute shaders (see IndirectCommandBuffer)
+  std::shared_ptr<IndirectCommandBuffer> createIndirectCommandBuffer(
+      const IndirectCommandBufferDesc& desc,
+      Result* outResult) const;
+
   // Platform-specific extensions
   const PlatformDevice& getPlatformDevice() const noexcept override;
 
@@ -64,6 +132,11 @@ class Device : public IDevice {
     return device_;
   }
 
+  // nullptr if DeviceFeatures::TextureBindless is not supported
+  const std::shared_ptr<BindlessTable>& getBindlessTable() const {
+    return bindlessTable_;
+  }
+
   // ICapabilities
   bool hasFeature(DeviceFeatures feature) const override;
   bool hasRequirement(DeviceRequirement requirement) const override;
@@ -73,6 +146,9 @@ class Device : public IDevice {
 
   // Device Statistics
   size_t getCurrentDrawCount() const override;
+  FrameStatistics getFrameStatistics() const override;
+  std::vector<FrameStatistics> getFrameStatisticsHistory() const override;
+  bool getDeviceMemoryUsage(DeviceMemoryUsage& outUsage) const override;
 
   BackendType getBackendType() const override {
     return BackendType::Metal;
@@ -91,12 +167,33 @@ class Device : public IDevice {
 
   std::unique_ptr<IBuffer> createBufferNoCopy(const BufferDesc& desc, Result* outResult) const;
 
+  std::shared_ptr<ITexture> createTextureImpl(const TextureDesc& desc,
+                                              bool transient,
+                                              Result* outResult) const noexcept;
+
+  id<MTLRenderPipelineState> newRenderPipelineState(MTLRenderPipelineDescriptor* metalDesc,
+                                                    MTLRenderPipelineReflection** reflection,
+                                                    NSError** error) const;
+
   id<MTLDevice> device_;
   PlatformDevice platformDevice_;
 
   DeviceFeatureSet deviceFeatureSet_;
   std::shared_ptr<BufferSynchronizationManager> bufferSyncManager_;
   DeviceStatistics deviceStatistics_;
+  std::shared_ptr<BindlessTable> bindlessTable_;
+  std::unique_ptr<HeapAllocator> heapAllocator_;
+  std::unique_ptr<RingBufferAllocator> ringBufferAllocator_;
+
+  // compiled MSL libraries keyed by the hash of their source and compile options
+  mutable std::mutex shaderLibraryCacheMutex_;
+  mutable std::unordered_map<size_t, id<MTLLibrary>> shaderLibraryCache_;
+
+  // id<MTLBinaryArchive>, nil unless enableBinaryArchive() succeeded
+  mutable std::mutex binaryArchiveMutex_;
+  id binaryArchive_ = nil;
+  std::string binaryArchivePath_;
+  mutable bool binaryArchiveDirty_ = false;
 };
 
 } // namespace metal
@@ -8,20 +8,28 @@
 #include <igl/metal/Device.h>
 
 #import <Foundation/Foundation.h>
+#include <igl/metal/BindlessTable.h>
 #include <igl/metal/Buffer.h>
 #include <igl/metal/BufferSynchronizationManager.h>
 #include <igl/metal/CommandQueue.h>
 #include <igl/metal/ComputePipelineState.h>
 #include <igl/metal/DepthStencilState.h>
 #include <igl/metal/Framebuffer.h>
+#include <igl/metal/IndirectCommandBuffer.h>
+#include <igl/metal/OcclusionQueryPool.h>
 #include <igl/metal/PlatformDevice.h>
 #include <igl/metal/RenderPipelineState.h>
+#include <igl/metal/RingBufferAllocator.h>
 #include <igl/metal/Result.h>
 #include <igl/metal/SamplerState.h>
 #include <igl/metal/Shader.h>
 #include <igl/metal/Texture.h>
+#include <igl/metal/TimestampQueryPool.h>
 #include <igl/metal/VertexInputState.h>
+#include <cstdio>
+#include <cstring>
 #include <sstream>
+#include <string_view>
 #include <unordered_set>
 
 namespace igl {
@@ -35,6 +43,9 @@ Device::Device(id<MTLDevice> device) :
   device_(device), platformDevice_(*this), deviceFeatureSet_(device) {
   bufferSyncManager_ =
       std::make_shared<BufferSynchronizationManager>(IGL_METAL_MAX_IN_FLIGHT_BUFFERS);
+  if (deviceFeatureSet_.hasFeature(DeviceFeatures::TextureBindless)) {
+    bindlessTable_ = std::make_shared<BindlessTable>(device_);
+  }
 }
 
 Device::~Device() = default;
@@ -42,8 +53,11 @@ Device::~Device() = default;
 std::shared_ptr<ICommandQueue> Device::createCommandQueue(const CommandQueueDesc& /*desc*/,
                                                           Result* outResult) {
   id<MTLCommandQueue> metalObject = [device_ newCommandQueue];
-  auto resource =
-      std::make_shared<CommandQueue>(metalObject, bufferSyncManager_, deviceStatistics_);
+  // Metal does not order the passes accessing untracked heap resources
+  id<MTLFence> passFence =
+      heapAllocator_ && heapAllocator_->hasUntrackedHazards() ? [device_ newFence] : nil;
+  auto resource = std::make_shared<CommandQueue>(
+      metalObject, bufferSyncManager_, deviceStatistics_, bindlessTable_, passFence);
   Result::setOk(outResult);
   return resource;
 }
@@ -60,10 +74,45 @@ id<MTLBuffer> createMetalBuffer(id<MTLDevice> device,
   }
   return metalObject;
 }
+
+bool supportsMemorylessTextures(id<MTLDevice> device) {
+#if IGL_PLATFORM_MACOS || IGL_PLATFORM_MACCATALYST
+  if (@available(macOS 11.0, macCatalyst 14.0, *)) {
+    return [device supportsFamily:MTLGPUFamilyApple1];
+  }
+  return false;
+#elif TARGET_OS_SIMULATOR
+  return false;
+#else
+  return true;
+#endif
 }
 
+void setFunctionConstantValue(MTLFunctionConstantValues* constantValues,
+                              const ShaderSpecializationConstant& constant) {
+  const NSUInteger index = constant.id;
+  switch (constant.type) {
+  case ShaderSpecializationConstant::Type::Bool: {
+    const bool value = constant.value != 0;
+    [constantValues setConstantValue:&value type:MTLDataTypeBool atIndex:index];
+    break;
+  }
+  case ShaderSpecializationConstant::Type::Int:
+    [constantValues setConstantValue:&constant.value type:MTLDataTypeInt atIndex:index];
+    break;
+  case ShaderSpecializationConstant::Type::UInt:
+    [constantValues setConstantValue:&constant.value type:MTLDataTypeUInt atIndex:index];
+    break;
+  case ShaderSpecializationConstant::Type::Float:
+    [constantValues setConstantValue:&constant.value type:MTLDataTypeFloat atIndex:index];
+    break;
+  }
+}
+} // namespace
+
 std::unique_ptr<IBuffer> Device::createBuffer(const BufferDesc& desc,
                                               Result* outResult) const noexcept {
+  IGL_PROFILER_FUNCTION();
   if (desc.hint & BufferDesc::BufferAPIHintBits::Ring) {
     return createRingBuffer(desc, outResult);
   }
@@ -73,7 +122,17 @@ std::unique_ptr<IBuffer> Device::createBuffer(const BufferDesc& desc,
   MTLStorageMode storage = toMTLStorageMode(desc.storage);
   MTLResourceOptions options = MTLResourceOptionCPUCacheModeDefault | storage;
 
-  id<MTLBuffer> metalObject = createMetalBuffer(device_, desc, options);
+  id<MTLBuffer> metalObject = nil;
+  // private buffers with initial data are uploaded by Metal, so only heap-allocate the others
+  if (heapAllocator_ && (desc.data == nullptr || desc.storage != ResourceStorage::Private)) {
+    metalObject = heapAllocator_->newBuffer(desc.length, options, getResourceTracker());
+    if (metalObject && desc.data != nullptr) {
+      memcpy(metalObject.contents, desc.data, desc.length);
+    }
+  }
+  if (!metalObject) {
+    metalObject = createMetalBuffer(device_, desc, options);
+  }
   std::unique_ptr<IBuffer> resource = std::make_unique<Buffer>(
       std::move(metalObject), options, desc.hint, 0 /* No accepted hints */);
   if (getResourceTracker()) {
@@ -88,6 +147,32 @@ std::unique_ptr<IBuffer> Device::createRingBuffer(const BufferDesc& desc,
   MTLStorageMode storage = toMTLStorageMode(desc.storage);
   MTLResourceOptions options = MTLResourceOptionCPUCacheModeDefault | storage;
 
+  RingBufferAllocator::Allocation allocation;
+  if (ringBufferAllocator_ && ringBufferAllocator_->allocate(desc.length, options, allocation)) {
+    if (desc.data != nullptr) {
+      // fill all instances of the ring
+      for (id<MTLBuffer> page : allocation.buffers) {
+        memcpy(static_cast<uint8_t*>(page.contents) + allocation.offset, desc.data, desc.length);
+#if IGL_PLATFORM_MACOS
+        if (storage == MTLStorageModeManaged) {
+          [page didModifyRange:NSMakeRange(allocation.offset, desc.length)];
+        }
+#endif
+      }
+    }
+    std::unique_ptr<IBuffer> resource = std::make_unique<RingBuffer>(std::move(allocation.buffers),
+                                                                     options,
+                                                                     bufferSyncManager_,
+                                                                     desc.hint,
+                                                                     allocation.offset,
+                                                                     desc.length);
+    if (getResourceTracker()) {
+      resource->initResourceTracker(getResourceTracker());
+    }
+    Result::setOk(outResult);
+    return resource;
+  }
+
   // Create a ring of buffers
   std::vector<id<MTLBuffer>> bufferRing;
   for (size_t i = 0; i < bufferSyncManager_->getMaxInflightBuffers(); i++) {
@@ -127,12 +212,51 @@ std::unique_ptr<IBuffer> Device::createBufferNoCopy(const BufferDesc& desc,
 
 std::shared_ptr<ISamplerState> Device::createSamplerState(const SamplerStateDesc& desc,
                                                           Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   return platformDevice_.createSamplerState(desc, outResult);
 }
 
 std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
                                                 Result* outResult) const noexcept {
-  const auto sanitized = sanitize(desc);
+  IGL_PROFILER_FUNCTION();
+  return createTextureImpl(desc, false, outResult);
+}
+
+std::shared_ptr<ITexture> Device::createTransientTexture(const TextureDesc& desc,
+                                                         Result* outResult) const noexcept {
+  return createTextureImpl(desc, true, outResult);
+}
+
+void Device::enableRingBufferSubAllocation(size_t maxBufferSize, size_t pageSize) {
+  ringBufferAllocator_ = std::make_unique<RingBufferAllocator>(
+      device_, bufferSyncManager_->getMaxInflightBuffers(), maxBufferSize, pageSize);
+}
+
+void Device::setInFlightFrameLimit(size_t limit) {
+  bufferSyncManager_->setInFlightFrameLimit(limit);
+}
+
+size_t Device::getInFlightFrameLimit() const {
+  return bufferSyncManager_->getInFlightFrameLimit();
+}
+
+bool Device::enableHeapAllocation(const HeapAllocatorConfig& config) {
+  if (!HeapAllocator::isSupported()) {
+    return false;
+  }
+  heapAllocator_ = std::make_unique<HeapAllocator>(
+      device_, config, bufferSyncManager_->getMaxInflightBuffers());
+  return true;
+}
+
+std::shared_ptr<ITexture> Device::createTextureImpl(const TextureDesc& desc,
+                                                    bool transient,
+                                                    Result* outResult) const noexcept {
+  auto sanitized = sanitize(desc);
+  if (sanitized.storage == ResourceStorage::Memoryless && !supportsMemorylessTextures(device_)) {
+    // GPUs without tile memory back transient attachments with regular memory
+    sanitized.storage = ResourceStorage::Private;
+  }
   if (desc.numLayers > 1 && desc.type != TextureType::TwoDArray) {
     Result::setResult(outResult,
                       Result::Code::Unsupported,
@@ -140,9 +264,31 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
     return nullptr;
   }
 
+  // formats Metal has no equivalent for are stored in another format and converted on upload
+  const TextureFormat uploadFormat = Texture::getUploadConversionFormat(sanitized.format);
+  if (uploadFormat != TextureFormat::Invalid &&
+      (sanitized.usage != TextureDesc::TextureUsageBits::Sampled || sanitized.allowFormatViews)) {
+    Result::setResult(outResult,
+                      Result::Code::Unsupported,
+                      "Textures whose format is converted on upload can only be sampled");
+    return nullptr;
+  }
+
   MTLTextureDescriptor* metalDesc = [MTLTextureDescriptor new];
   metalDesc.textureType = Texture::convertType(sanitized.type, sanitized.numSamples);
-  metalDesc.pixelFormat = Texture::textureFormatToMTLPixelFormat(sanitized.format);
+  metalDesc.pixelFormat = Texture::textureFormatToMTLPixelFormat(
+      uploadFormat != TextureFormat::Invalid ? uploadFormat : sanitized.format);
+  if (sanitized.format == TextureFormat::L_UNorm8 || sanitized.format == TextureFormat::LA_UNorm8) {
+    // getUploadConversionFormat() only converts them when swizzles are available
+    if (@available(macOS 10.15, iOS 13.0, *)) {
+      const bool isLuminance = sanitized.format == TextureFormat::L_UNorm8;
+      metalDesc.swizzle = MTLTextureSwizzleChannelsMake(MTLTextureSwizzleRed,
+                                                        MTLTextureSwizzleRed,
+                                                        MTLTextureSwizzleRed,
+                                                        isLuminance ? MTLTextureSwizzleOne
+                                                                    : MTLTextureSwizzleGreen);
+    }
+  }
   if (metalDesc.pixelFormat == MTLPixelFormatInvalid) {
     Result::setResult(
         outResult,
@@ -180,18 +326,33 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
   }
 #endif
   metalDesc.usage = Texture::toMTLTextureUsage(sanitized.usage);
+  if (sanitized.allowFormatViews) {
+    metalDesc.usage |= MTLTextureUsagePixelFormatView;
+  }
   metalDesc.storageMode = toMTLStorageMode(sanitized.storage);
 
   metalDesc.resourceOptions =
       MTLResourceCPUCacheModeDefaultCache | toMTLResourceStorageMode(sanitized.storage);
 
-  id<MTLTexture> metalObject = [device_ newTextureWithDescriptor:metalDesc];
+  id<MTLTexture> metalObject = nil;
+  if (heapAllocator_) {
+    const auto tracker = getResourceTracker();
+    metalObject = transient ? heapAllocator_->newTransientTexture(
+                                  metalDesc, bufferSyncManager_->getFrameCount(), tracker)
+                            : heapAllocator_->newTexture(metalDesc, tracker);
+  }
+  if (!metalObject) {
+    metalObject = [device_ newTextureWithDescriptor:metalDesc];
+  }
   if (!metalObject) {
     Result::setResult(outResult, Result::Code::RuntimeError, "Failed to create Metal texture");
     IGL_ASSERT_MSG(0, outResult->message.c_str());
     return nullptr;
   }
-  auto iglObject = std::make_shared<Texture>(metalObject, *this);
+  auto iglObject = uploadFormat != TextureFormat::Invalid
+                       ? std::make_shared<Texture>(metalObject, *this, sanitized.format)
+                       : std::make_shared<Texture>(metalObject, *this);
+  iglObject->bindlessTable_ = bindlessTable_;
   if (getResourceTracker()) {
     iglObject->initResourceTracker(getResourceTracker());
   }
@@ -204,6 +365,53 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
   return iglObject;
 }
 
+std::shared_ptr<ITexture> Device::createTextureView(const ITexture& texture,
+                                                    const TextureViewDesc& desc,
+                                                    Result* outResult) const {
+  TextureDesc viewDesc;
+  Result result = texture.validateView(desc, viewDesc);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+
+  id<MTLTexture> metalTexture = static_cast<const Texture&>(texture).get();
+  MTLPixelFormat pixelFormat = metalTexture.pixelFormat;
+  if (viewDesc.format != texture.getFormat()) {
+    if (!(metalTexture.usage & MTLTextureUsagePixelFormatView)) {
+      Result::setResult(outResult,
+                        Result::Code::ArgumentInvalid,
+                        "Format views need textures created with TextureDesc::allowFormatViews");
+      return nullptr;
+    }
+    pixelFormat = Texture::textureFormatToMTLPixelFormat(viewDesc.format);
+  }
+
+  id<MTLTexture> metalObject =
+      [metalTexture newTextureViewWithPixelFormat:pixelFormat
+                                      textureType:Texture::convertType(viewDesc.type,
+                                                                       viewDesc.numSamples)
+                                           levels:NSMakeRange(desc.mipLevel, desc.numMipLevels)
+                                           slices:NSMakeRange(desc.layer, desc.numLayers)];
+  if (!metalObject) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Failed to create Metal texture view");
+    return nullptr;
+  }
+  if (!desc.debugName.empty()) {
+    metalObject.label = [NSString stringWithUTF8String:desc.debugName.c_str()];
+  }
+
+  auto iglObject = static_cast<const Texture&>(texture).uploadFormat_ != TextureFormat::Invalid
+                       ? std::make_shared<Texture>(metalObject, *this, viewDesc.format)
+                       : std::make_shared<Texture>(metalObject, *this);
+  iglObject->bindlessTable_ = bindlessTable_;
+  if (getResourceTracker()) {
+    iglObject->initResourceTracker(getResourceTracker());
+  }
+  Result::setOk(outResult);
+  return iglObject;
+}
+
 std::shared_ptr<igl::IVertexInputState> Device::createVertexInputState(
     const VertexInputStateDesc& desc,
     Result* outResult) const {
@@ -317,56 +525,50 @@ std::shared_ptr<igl::IDepthStencilState> Device::createDepthStencilState(
   return iglObject;
 }
 
-std::shared_ptr<igl::IComputePipelineState> Device::createComputePipeline(
-    const ComputePipelineDesc& desc,
-    Result* outResult) const {
-  NSError* error = nil;
+namespace {
+
+constexpr MTLPipelineOption kRenderPipelineOptions = MTLPipelineOptionArgumentInfo |
+                                                     MTLPipelineOptionBufferTypeInfo;
 
+MTLComputePipelineDescriptor* newComputePipelineDescriptor(const ComputePipelineDesc& desc,
+                                                           Result* outResult) {
   if (IGL_UNEXPECTED(desc.shaderStages == nullptr)) {
     Result::setResult(outResult, Result::Code::ArgumentInvalid, "Missing shader stages");
-    return nullptr;
+    return nil;
   }
   if (!IGL_VERIFY(desc.shaderStages->getType() == ShaderStagesType::Compute)) {
     Result::setResult(outResult, Result::Code::ArgumentInvalid, "Shader stages not for compute");
-    return nullptr;
+    return nil;
   }
   if (!IGL_VERIFY(desc.shaderStages->getComputeModule())) {
     Result::setResult(outResult, Result::Code::ArgumentInvalid, "Missing compute shader");
-    return nullptr;
+    return nil;
+  }
+
+  if (desc.requiredSubgroupSize != 0) {
+    Result::setResult(outResult, Result::Code::Unsupported, "SIMD-group sizes cannot be required");
+    return nil;
   }
 
   MTLComputePipelineDescriptor* descriptor = [[MTLComputePipelineDescriptor alloc] init];
   descriptor.computeFunction =
       static_cast<ShaderModule*>(desc.shaderStages->getComputeModule().get())->get();
-  MTLComputePipelineReflection* reflection = nil;
-  id<MTLComputePipelineState> metalObject =
-      [device_ newComputePipelineStateWithDescriptor:descriptor
-                                             options:MTLPipelineOptionNone
-                                          reflection:&reflection
-                                               error:&error];
-  setResultFrom(outResult, error);
-  if (error != nil) {
-    return nullptr;
-  }
-  std::shared_ptr<ComputePipelineState> computePipelineState =
-      std::make_shared<ComputePipelineState>(metalObject, reflection);
-
-  return computePipelineState;
+  descriptor.threadGroupSizeIsMultipleOfThreadExecutionWidth = desc.requireFullSubgroups ? YES : NO;
+  return descriptor;
 }
 
-std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
-    const RenderPipelineDesc& desc,
-    Result* outResult) const {
+MTLRenderPipelineDescriptor* newRenderPipelineDescriptor(const RenderPipelineDesc& desc,
+                                                         Result* outResult) {
   // TODO
   //  Size drawableSize = IGLNativeDrawableSize(layer_);
   //  graphicsDesc.viewportState.viewportCount = 1;
   //  graphicsDesc.viewportState.viewports[0] = (Viewport){0.0, 0.0, drawableSize.width,
   //  drawableSize.height, 0.0, 1.0};
 
-  NSError* error = nil;
   MTLRenderPipelineDescriptor* metalDesc = [MTLRenderPipelineDescriptor new];
 
   metalDesc.sampleCount = desc.sampleCount;
+  metalDesc.supportIndirectCommandBuffers = desc.supportIndirectCommandBuffers;
 
   // (optional, can be null) Vertex input
   auto vertexInput = desc.vertexInputState;
@@ -378,11 +580,11 @@ std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
   if (!IGL_VERIFY(desc.shaderStages)) {
     Result::setResult(
         outResult, Result::Code::RuntimeError, "RenderPipeline requires shader stages");
-    return nullptr;
+    return nil;
   }
   if (!IGL_VERIFY(desc.shaderStages->getType() == ShaderStagesType::Render)) {
     Result::setResult(outResult, Result::Code::ArgumentInvalid, "Shader stages not for render");
-    return nullptr;
+    return nil;
   }
 
   // Vertex shader is required
@@ -390,7 +592,7 @@ std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
   if (!IGL_VERIFY(vertexModule)) {
     Result::setResult(
         outResult, Result::Code::RuntimeError, "RenderPipeline requires vertex module");
-    return nullptr;
+    return nil;
   }
 
   auto vertexFunc = static_cast<ShaderModule*>(vertexModule.get());
@@ -399,7 +601,7 @@ std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
   if (!IGL_VERIFY(metalDesc.vertexFunction)) {
     Result::setResult(
         outResult, Result::Code::RuntimeError, "RenderPipeline requires non-null vertex function");
-    return nullptr;
+    return nil;
   }
 
   // Fragment shader is optional
@@ -430,15 +632,102 @@ std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
   metalDesc.stencilAttachmentPixelFormat =
       Texture::textureFormatToMTLPixelFormat(desc.targetDesc.stencilAttachmentFormat);
 
+  return metalDesc;
+}
+
+PipelineCreationResult<IRenderPipelineState> makeRenderPipelineCreation(
+    id<MTLRenderPipelineState> metalObject,
+    MTLRenderPipelineReflection* reflection,
+    NSError* error,
+    CullMode cullMode,
+    WindingMode frontFaceWinding,
+    PolygonFillMode polygonFillMode) {
+  PipelineCreationResult<IRenderPipelineState> creation;
+  setResultFrom(&creation.result, error);
+  if (error != nil) {
+    IGL_LOG_ERROR("%s\n", [error.localizedDescription UTF8String]);
+    return creation;
+  }
+  creation.pipeline = std::make_shared<RenderPipelineState>(
+      metalObject, reflection, cullMode, frontFaceWinding, polygonFillMode);
+  return creation;
+}
+
+} // namespace
+
+std::shared_ptr<igl::IComputePipelineState> Device::createComputePipeline(
+    const ComputePipelineDesc& desc,
+    Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
+  NSError* error = nil;
+
+  MTLComputePipelineDescriptor* descriptor = newComputePipelineDescriptor(desc, outResult);
+  if (descriptor == nil) {
+    return nullptr;
+  }
+
+  MTLComputePipelineReflection* reflection = nil;
+  id<MTLComputePipelineState> metalObject =
+      [device_ newComputePipelineStateWithDescriptor:descriptor
+                                             options:MTLPipelineOptionNone
+                                          reflection:&reflection
+                                               error:&error];
+  setResultFrom(outResult, error);
+  if (error != nil) {
+    return nullptr;
+  }
+  std::shared_ptr<ComputePipelineState> computePipelineState =
+      std::make_shared<ComputePipelineState>(metalObject, reflection);
+
+  return computePipelineState;
+}
+
+std::future<PipelineCreationResult<IComputePipelineState>> Device::createComputePipelineAsync(
+    const ComputePipelineDesc& desc) const {
+  IGL_PROFILER_FUNCTION();
+  // blocks copy captured C++ objects and a promise cannot be copied
+  auto promise = std::make_shared<std::promise<PipelineCreationResult<IComputePipelineState>>>();
+  auto future = promise->get_future();
+
+  PipelineCreationResult<IComputePipelineState> creation;
+  MTLComputePipelineDescriptor* descriptor = newComputePipelineDescriptor(desc, &creation.result);
+  if (descriptor == nil) {
+    promise->set_value(std::move(creation));
+    return future;
+  }
+
+  // the compiler service calls the handler on one of its own threads
+  [device_ newComputePipelineStateWithDescriptor:descriptor
+                                         options:MTLPipelineOptionNone
+                               completionHandler:^(id<MTLComputePipelineState> metalObject,
+                                                   MTLComputePipelineReflection* reflection,
+                                                   NSError* error) {
+                                 PipelineCreationResult<IComputePipelineState> result;
+                                 setResultFrom(&result.result, error);
+                                 if (error == nil) {
+                                   result.pipeline = std::make_shared<ComputePipelineState>(
+                                       metalObject, reflection);
+                                 }
+                                 promise->set_value(std::move(result));
+                               }];
+  return future;
+}
+
+std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
+    const RenderPipelineDesc& desc,
+    Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
+  NSError* error = nil;
+
+  MTLRenderPipelineDescriptor* metalDesc = newRenderPipelineDescriptor(desc, outResult);
+  if (metalDesc == nil) {
+    return nullptr;
+  }
+
   MTLRenderPipelineReflection* reflection = nil;
 
   // Create reflection for use later in binding, etc.
-  id<MTLRenderPipelineState> metalObject =
-      [device_ newRenderPipelineStateWithDescriptor:metalDesc
-                                            options:MTLPipelineOptionArgumentInfo |
-                                                    MTLPipelineOptionBufferTypeInfo
-                                         reflection:&reflection
-                                              error:&error];
+  id<MTLRenderPipelineState> metalObject = newRenderPipelineState(metalDesc, &reflection, &error);
   setResultFrom(outResult, error);
   if (error != nil) {
     IGL_LOG_ERROR("%s\n", [error.localizedDescription UTF8String]);
@@ -449,6 +738,226 @@ std::shared_ptr<igl::IRenderPipelineState> Device::createRenderPipeline(
       metalObject, reflection, desc.cullMode, desc.frontFaceWinding, desc.polygonFillMode);
 }
 
+std::future<PipelineCreationResult<IRenderPipelineState>> Device::createRenderPipelineAsync(
+    const RenderPipelineDesc& desc) const {
+  IGL_PROFILER_FUNCTION();
+  // blocks copy captured C++ objects and a promise cannot be copied
+  auto promise = std::make_shared<std::promise<PipelineCreationResult<IRenderPipelineState>>>();
+  auto future = promise->get_future();
+
+  PipelineCreationResult<IRenderPipelineState> creation;
+  MTLRenderPipelineDescriptor* metalDesc = newRenderPipelineDescriptor(desc, &creation.result);
+  if (metalDesc == nil) {
+    promise->set_value(std::move(creation));
+    return future;
+  }
+
+  const CullMode cullMode = desc.cullMode;
+  const WindingMode frontFaceWinding = desc.frontFaceWinding;
+  const PolygonFillMode polygonFillMode = desc.polygonFillMode;
+
+  if (binaryArchive_ != nil) {
+    // binary archives are looked up and extended synchronously: do it off the calling thread
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+      @autoreleasepool {
+        MTLRenderPipelineReflection* reflection = nil;
+        NSError* error = nil;
+        id<MTLRenderPipelineState> metalObject =
+            newRenderPipelineState(metalDesc, &reflection, &error);
+        promise->set_value(makeRenderPipelineCreation(
+            metalObject, reflection, error, cullMode, frontFaceWinding, polygonFillMode));
+      }
+    });
+    return future;
+  }
+
+  // the compiler service calls the handler on one of its own threads
+  [device_ newRenderPipelineStateWithDescriptor:metalDesc
+                                        options:kRenderPipelineOptions
+                              completionHandler:^(id<MTLRenderPipelineState> metalObject,
+                                                  MTLRenderPipelineReflection* reflection,
+                                                  NSError* error) {
+                                promise->set_value(makeRenderPipelineCreation(metalObject,
+                                                                              reflection,
+                                                                              error,
+                                                                              cullMode,
+                                                                              frontFaceWinding,
+                                                                              polygonFillMode));
+                              }];
+  return future;
+}
+
+id<MTLRenderPipelineState> Device::newRenderPipelineState(MTLRenderPipelineDescriptor* metalDesc,
+                                                          MTLRenderPipelineReflection** reflection,
+                                                          NSError** error) const {
+  const MTLPipelineOption options = kRenderPipelineOptions;
+
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    id<MTLBinaryArchive> archive = binaryArchive_;
+    if (archive != nil) {
+      metalDesc.binaryArchives = @[ archive ];
+      // a hit loads the GPU code from the archive instead of compiling it
+      id<MTLRenderPipelineState> pipeline =
+          [device_ newRenderPipelineStateWithDescriptor:metalDesc
+                                                options:options |
+                                                        MTLPipelineOptionFailOnBinaryArchiveMiss
+                                             reflection:reflection
+                                                  error:nil];
+      if (pipeline != nil) {
+        return pipeline;
+      }
+      NSError* archiveError = nil;
+      const std::lock_guard<std::mutex> lock(binaryArchiveMutex_);
+      if ([archive addRenderPipelineFunctionsWithDescriptor:metalDesc error:&archiveError]) {
+        binaryArchiveDirty_ = true;
+      } else {
+        IGL_LOG_INFO("Cannot add a render pipeline to the binary archive: %s\n",
+                     [archiveError.localizedDescription UTF8String]);
+      }
+    }
+  }
+
+  return [device_ newRenderPipelineStateWithDescriptor:metalDesc
+                                               options:options
+                                            reflection:reflection
+                                                 error:error];
+}
+
+bool Device::enableBinaryArchive(const std::string& path) {
+  if (path.empty()) {
+    return false;
+  }
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    NSString* archivePath = [NSString stringWithUTF8String:path.c_str()];
+    MTLBinaryArchiveDescriptor* archiveDesc = [MTLBinaryArchiveDescriptor new];
+    if ([[NSFileManager defaultManager] fileExistsAtPath:archivePath]) {
+      archiveDesc.url = [NSURL fileURLWithPath:archivePath];
+    }
+    NSError* error = nil;
+    id<MTLBinaryArchive> archive = [device_ newBinaryArchiveWithDescriptor:archiveDesc
+                                                                     error:&error];
+    if (archive == nil && archiveDesc.url != nil) {
+      // e.g. written by another OS version or GPU: start over with an empty archive
+      IGL_LOG_INFO("Discarding the binary archive %s: %s\n",
+                   path.c_str(),
+                   [error.localizedDescription UTF8String]);
+      archiveDesc.url = nil;
+      error = nil;
+      archive = [device_ newBinaryArchiveWithDescriptor:archiveDesc error:&error];
+    }
+    if (archive == nil) {
+      IGL_LOG_ERROR("Cannot create a binary archive: %s\n",
+                    [error.localizedDescription UTF8String]);
+      return false;
+    }
+    const std::lock_guard<std::mutex> lock(binaryArchiveMutex_);
+    binaryArchive_ = archive;
+    binaryArchivePath_ = path;
+    binaryArchiveDirty_ = false;
+    return true;
+  }
+  return false;
+}
+
+Result Device::serializeBinaryArchive() const {
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    const std::lock_guard<std::mutex> lock(binaryArchiveMutex_);
+    id<MTLBinaryArchive> archive = binaryArchive_;
+    if (archive == nil) {
+      return Result(Result::Code::InvalidOperation, "Binary archives are not enabled");
+    }
+    if (!binaryArchiveDirty_) {
+      return Result();
+    }
+
+    // the archive may still read from its file: write a new one and replace the old one
+    const std::string tmpPath = binaryArchivePath_ + ".tmp";
+    NSError* error = nil;
+    if (![archive serializeToURL:[NSURL fileURLWithPath:[NSString
+                                                            stringWithUTF8String:tmpPath.c_str()]]
+                           error:&error]) {
+      Result result;
+      setResultFrom(&result, error);
+      return result;
+    }
+    if (std::rename(tmpPath.c_str(), binaryArchivePath_.c_str()) != 0) {
+      return Result(Result::Code::RuntimeError, "Cannot rename the binary archive file");
+    }
+    binaryArchiveDirty_ = false;
+    return Result();
+  }
+  return Result(Result::Code::Unsupported, "Binary archives are not supported");
+}
+
+std::vector<std::shared_ptr<IRenderPipelineState>> Device::createRenderPipelines(
+    const std::vector<RenderPipelineDesc>& descs,
+    Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
+  std::vector<std::shared_ptr<IRenderPipelineState>> pipelines(descs.size());
+  std::vector<Result> results(descs.size());
+
+  // MTLDevice is thread-safe; blocks copy captured C++ objects, so capture pointers
+  const RenderPipelineDesc* descsData = descs.data();
+  std::shared_ptr<IRenderPipelineState>* pipelinesData = pipelines.data();
+  Result* resultsData = results.data();
+  dispatch_apply(descs.size(), DISPATCH_APPLY_AUTO, ^(size_t i) {
+    @autoreleasepool {
+      pipelinesData[i] = createRenderPipeline(descsData[i], &resultsData[i]);
+    }
+  });
+
+  setFirstFailure(outResult, results);
+  return pipelines;
+}
+
+std::shared_ptr<IndirectCommandBuffer> Device::createIndirectCommandBuffer(
+    const IndirectCommandBufferDesc& desc,
+    Result* outResult) const {
+  if (IGL_UNEXPECTED(desc.maxCommandCount == 0)) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "maxCommandCount must be > 0");
+    return nullptr;
+  }
+  if (@available(macOS 10.15, iOS 13.0, *)) {
+    if ([device_ supportsFamily:MTLGPUFamilyApple3] || [device_ supportsFamily:MTLGPUFamilyMac2]) {
+      MTLIndirectCommandBufferDescriptor* metalDesc = [MTLIndirectCommandBufferDescriptor new];
+      metalDesc.commandTypes = MTLIndirectCommandTypeDraw;
+      if (desc.indexed) {
+        metalDesc.commandTypes |= MTLIndirectCommandTypeDrawIndexed;
+      }
+      metalDesc.inheritPipelineState = YES;
+      metalDesc.inheritBuffers = YES;
+      id<MTLIndirectCommandBuffer> metalObject =
+          [device_ newIndirectCommandBufferWithDescriptor:metalDesc
+                                          maxCommandCount:desc.maxCommandCount
+                                                  options:MTLResourceStorageModeShared];
+      if (!metalObject) {
+        Result::setResult(
+            outResult, Result::Code::RuntimeError, "Failed to create indirect command buffer");
+        return nullptr;
+      }
+      [metalObject resetWithRange:NSMakeRange(0, desc.maxCommandCount)];
+
+      // argument buffer for compute shaders encoding draws
+      MTLArgumentDescriptor* argumentDesc = [MTLArgumentDescriptor argumentDescriptor];
+      argumentDesc.dataType = MTLDataTypeIndirectCommandBuffer;
+      argumentDesc.index = 0;
+      argumentDesc.access = MTLArgumentAccessReadWrite;
+      id<MTLArgumentEncoder> argumentEncoder =
+          [device_ newArgumentEncoderWithArguments:@[ argumentDesc ]];
+      id<MTLBuffer> argumentBuffer = [device_ newBufferWithLength:argumentEncoder.encodedLength
+                                                          options:MTLResourceStorageModeShared];
+      [argumentEncoder setArgumentBuffer:argumentBuffer offset:0];
+      [argumentEncoder setIndirectCommandBuffer:metalObject atIndex:0];
+
+      Result::setOk(outResult);
+      return std::make_shared<IndirectCommandBuffer>(metalObject, argumentBuffer, desc);
+    }
+  }
+  Result::setResult(
+      outResult, Result::Code::Unsupported, "Indirect command buffers are not supported");
+  return nullptr;
+}
+
 std::unique_ptr<IShaderLibrary> Device::createShaderLibrary(const ShaderLibraryDesc& desc,
                                                             Result* outResult) const {
   if (IGL_UNEXPECTED(desc.moduleInfo.empty())) {
@@ -477,11 +986,28 @@ std::unique_ptr<IShaderLibrary> Device::createShaderLibrary(const ShaderLibraryD
       Result::setResult(outResult, Result::Code::ArgumentNull);
       return nullptr;
     }
-    MTLCompileOptions* compileOpts = [MTLCompileOptions new];
-    compileOpts.fastMathEnabled = desc.input.options.fastMathEnabled;
+    size_t cacheKey = std::hash<std::string_view>()(desc.input.source);
+    cacheKey ^= std::hash<bool>()(desc.input.options.fastMathEnabled) + 0x9e3779b9 +
+                (cacheKey << 6) + (cacheKey >> 2);
+    {
+      const std::lock_guard<std::mutex> lock(shaderLibraryCacheMutex_);
+      const auto it = shaderLibraryCache_.find(cacheKey);
+      if (it != shaderLibraryCache_.end()) {
+        metalLibrary = it->second;
+      }
+    }
 
-    NSString* shaderSource = [NSString stringWithUTF8String:desc.input.source];
-    metalLibrary = [device_ newLibraryWithSource:shaderSource options:compileOpts error:&error];
+    if (!metalLibrary) {
+      MTLCompileOptions* compileOpts = [MTLCompileOptions new];
+      compileOpts.fastMathEnabled = desc.input.options.fastMathEnabled;
+
+      NSString* shaderSource = [NSString stringWithUTF8String:desc.input.source];
+      metalLibrary = [device_ newLibraryWithSource:shaderSource options:compileOpts error:&error];
+      if (metalLibrary) {
+        const std::lock_guard<std::mutex> lock(shaderLibraryCacheMutex_);
+        shaderLibraryCache_.emplace(cacheKey, metalLibrary);
+      }
+    }
   }
 
   if (!metalLibrary) {
@@ -502,7 +1028,27 @@ std::unique_ptr<IShaderLibrary> Device::createShaderLibrary(const ShaderLibraryD
       return nullptr;
     }
 
-    auto metalFunction = [metalLibrary newFunctionWithName:shaderEntrypoint];
+    id<MTLFunction> metalFunction = nil;
+    if (info.specializationConstants.empty()) {
+      metalFunction = [metalLibrary newFunctionWithName:shaderEntrypoint];
+    } else {
+      // the library is compiled once; only the function is specialized
+      MTLFunctionConstantValues* constantValues = [MTLFunctionConstantValues new];
+      for (const auto& constant : info.specializationConstants) {
+        setFunctionConstantValue(constantValues, constant);
+      }
+      NSError* functionError = nil;
+      metalFunction = [metalLibrary newFunctionWithName:shaderEntrypoint
+                                         constantValues:constantValues
+                                                  error:&functionError];
+      if (!metalFunction) {
+        IGL_LOG_ERROR("Could not specialize function '%s': %s\n",
+                      info.entryPoint.c_str(),
+                      [functionError.localizedDescription UTF8String]);
+        setResultFrom(outResult, functionError);
+        return nullptr;
+      }
+    }
     if (!metalFunction) {
       IGL_ASSERT_MSG(0, "Could not find function '%s' in library\n", info.entryPoint.c_str());
       Result::setResult(
@@ -523,6 +1069,7 @@ std::unique_ptr<IShaderLibrary> Device::createShaderLibrary(const ShaderLibraryD
 
 std::shared_ptr<IShaderModule> Device::createShaderModule(const ShaderModuleDesc& desc,
                                                           Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   auto libraryDesc =
       desc.input.type == ShaderInputType::String
           ? ShaderLibraryDesc::fromStringInput(desc.input.source, {desc.info}, desc.debugName)
@@ -535,8 +1082,44 @@ std::shared_ptr<IShaderModule> Device::createShaderModule(const ShaderModuleDesc
   return nullptr;
 }
 
+std::vector<std::shared_ptr<IShaderModule>> Device::createShaderModules(
+    const std::vector<ShaderModuleDesc>& descs,
+    Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
+  if (getResourceTracker()) {
+    // resource trackers are not required to be thread-safe
+    return IDevice::createShaderModules(descs, outResult);
+  }
+  std::vector<std::shared_ptr<IShaderModule>> modules(descs.size());
+  std::vector<Result> results(descs.size());
+
+  // the Metal shader compiler runs concurrently for different libraries
+  const ShaderModuleDesc* descsData = descs.data();
+  std::shared_ptr<IShaderModule>* modulesData = modules.data();
+  Result* resultsData = results.data();
+  dispatch_apply(descs.size(), DISPATCH_APPLY_AUTO, ^(size_t i) {
+    @autoreleasepool {
+      modulesData[i] = createShaderModule(descsData[i], &resultsData[i]);
+    }
+  });
+
+  setFirstFailure(outResult, results);
+  return modules;
+}
+
+void Device::clearShaderLibraryCache() {
+  const std::lock_guard<std::mutex> lock(shaderLibraryCacheMutex_);
+  shaderLibraryCache_.clear();
+}
+
+size_t Device::getShaderLibraryCacheSize() const {
+  const std::lock_guard<std::mutex> lock(shaderLibraryCacheMutex_);
+  return shaderLibraryCache_.size();
+}
+
 std::unique_ptr<IShaderStages> Device::createShaderStages(const ShaderStagesDesc& desc,
                                                           Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   Result result;
   auto stages = std::make_unique<ShaderStages>(desc);
   if (auto resourceTracker = getResourceTracker()) {
@@ -550,6 +1133,58 @@ std::unique_ptr<IShaderStages> Device::createShaderStages(const ShaderStagesDesc
   return std::move(stages);
 }
 
+std::shared_ptr<IOcclusionQueryPool> Device::createOcclusionQueryPool(
+    const OcclusionQueryPoolDesc& desc,
+    Result* outResult) const {
+  if (IGL_UNEXPECTED(desc.count == 0)) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "Query pools can't be empty");
+    return nullptr;
+  }
+  id<MTLBuffer> buffer = [device_ newBufferWithLength:desc.count * sizeof(uint64_t)
+                                              options:MTLResourceStorageModeShared];
+  if (buffer == nil) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Could not create visibility buffer");
+    return nullptr;
+  }
+  buffer.label = [NSString stringWithUTF8String:desc.debugName.c_str()];
+  Result::setOk(outResult);
+  return std::make_shared<OcclusionQueryPool>(buffer, desc);
+}
+
+std::shared_ptr<ITimestampQueryPool> Device::createTimestampQueryPool(
+    const TimestampQueryPoolDesc& desc,
+    Result* outResult) const {
+  if (@available(macOS 11.0, iOS 14.0, *)) {
+    if (deviceFeatureSet_.hasFeature(DeviceFeatures::TimestampQueries) && desc.count > 0) {
+      id<MTLCounterSet> timestampCounterSet = nil;
+      for (id<MTLCounterSet> counterSet in device_.counterSets) {
+        if ([counterSet.name isEqualToString:MTLCommonCounterSetTimestamp]) {
+          timestampCounterSet = counterSet;
+          break;
+        }
+      }
+      MTLCounterSampleBufferDescriptor* bufferDesc = [MTLCounterSampleBufferDescriptor new];
+      bufferDesc.counterSet = timestampCounterSet;
+      bufferDesc.storageMode = MTLStorageModeShared;
+      bufferDesc.sampleCount = desc.count;
+      bufferDesc.label = [NSString stringWithUTF8String:desc.debugName.c_str()];
+
+      NSError* error = nil;
+      id<MTLCounterSampleBuffer> sampleBuffer =
+          [device_ newCounterSampleBufferWithDescriptor:bufferDesc error:&error];
+      if (sampleBuffer == nil) {
+        Result::setResult(
+            outResult, Result::Code::RuntimeError, [error.localizedDescription UTF8String]);
+        return nullptr;
+      }
+      Result::setOk(outResult);
+      return std::make_shared<TimestampQueryPool>(device_, sampleBuffer, desc.count);
+    }
+  }
+  Result::setResult(outResult, Result::Code::Unsupported, "Timestamp queries are not supported");
+  return nullptr;
+}
+
 const PlatformDevice& Device::getPlatformDevice() const noexcept {
   return platformDevice_;
 }
@@ -629,6 +1264,26 @@ size_t Device::getCurrentDrawCount() const {
   return deviceStatistics_.getDrawCount();
 }
 
+FrameStatistics Device::getFrameStatistics() const {
+  return deviceStatistics_.getFrameStatistics();
+}
+
+std::vector<FrameStatistics> Device::getFrameStatisticsHistory() const {
+  return deviceStatistics_.getFrameStatisticsHistory();
+}
+
+bool Device::getDeviceMemoryUsage(DeviceMemoryUsage& outUsage) const {
+  if (@available(macOS 10.13, iOS 11.0, *)) {
+    outUsage = {};
+    outUsage.usedBytes = static_cast<size_t>(device_.currentAllocatedSize);
+    if (@available(macOS 10.12, iOS 16.0, *)) {
+      outUsage.budgetBytes = static_cast<size_t>(device_.recommendedMaxWorkingSetSize);
+    }
+    return true;
+  }
+  return false;
+}
+
 MTLStorageMode Device::toMTLStorageMode(ResourceStorage storage) {
   switch (storage) {
   case ResourceStorage::Private:
@@ -636,6 +1291,11 @@ MTLStorageMode Device::toMTLStorageMode(ResourceStorage storage) {
   case ResourceStorage::Shared:
     return MTLStorageModeShared;
 #if IGL_PLATFORM_MACOS || IGL_PLATFORM_MACCATALYST
+  case ResourceStorage::Memoryless:
+    if (@available(macOS 11.0, macCatalyst 14.0, *)) {
+      return MTLStorageModeMemoryless;
+    }
+    return MTLStorageModePrivate;
   case ResourceStorage::Managed:
   default:
     return MTLStorageModeManaged;
@@ -655,6 +1315,11 @@ MTLResourceOptions Device::toMTLResourceStorageMode(ResourceStorage storage) {
   case ResourceStorage::Shared:
     return MTLResourceStorageModeShared;
 #if IGL_PLATFORM_MACOS || IGL_PLATFORM_MACCATALYST
+  case ResourceStorage::Memoryless:
+    if (@available(macOS 11.0, macCatalyst 14.0, *)) {
+      return MTLResourceStorageModeMemoryless;
+    }
+    return MTLResourceStorageModePrivate;
   case ResourceStorage::Managed:
   default:
     return MTLResourceStorageModeManaged;
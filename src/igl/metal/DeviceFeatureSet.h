@@ -50,6 +50,13 @@ class DeviceFeatureSet final {
   size_t maxMultisampleCount_;
   size_t maxBufferLength_;
   bool supports32BitFloatFiltering_ = false;
+  bool supportsTimestampQueries_ = false;
+  bool supportsBindless_ = false;
+  bool supportsProgrammableBlending_ = false;
+  // ICapabilities::SubgroupOperationBits
+  uint32_t subgroupOperations_ = 0;
+  uint32_t minSimdGroupSize_ = 0;
+  uint32_t maxSimdGroupSize_ = 0;
 };
 
 } // namespace metal
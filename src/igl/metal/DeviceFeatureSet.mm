@@ -7,6 +7,9 @@
 
 #include <igl/metal/DeviceFeatureSet.h>
 
+#include <igl/metal/BindlessTable.h>
+#include <igl/metal/Texture.h>
+
 #include <vector>
 
 namespace igl {
@@ -95,9 +98,49 @@ void DeviceFeatureSet::getFeatureSet(id<MTLDevice> device) {
   // get max buffer length
   maxBufferLength_ = [device maxBufferLength];
 
+  supportsBindless_ = BindlessTable::isSupported(device);
+
+  if (@available(macOS 10.15, iOS 13.0, *)) {
+    // Apple GPUs read color attachments at the current pixel from tile memory
+    supportsProgrammableBlending_ = [device supportsFamily:MTLGPUFamilyApple1];
+  }
+
+  if (@available(macOS 10.15, iOS 14.0, *)) {
+    const bool isMac2 = [device supportsFamily:MTLGPUFamilyMac2];
+    if ([device supportsFamily:MTLGPUFamilyApple4] || isMac2) {
+      subgroupOperations_ |= ICapabilities::SubgroupOperationBits::Quad;
+    }
+    // SIMD-scoped permute functions
+    if ([device supportsFamily:MTLGPUFamilyApple6] || isMac2) {
+      subgroupOperations_ |= ICapabilities::SubgroupOperationBits::Basic |
+                             ICapabilities::SubgroupOperationBits::Vote |
+                             ICapabilities::SubgroupOperationBits::Ballot |
+                             ICapabilities::SubgroupOperationBits::Shuffle |
+                             ICapabilities::SubgroupOperationBits::ShuffleRelative;
+    }
+    // SIMD-scoped reduction and prefix functions
+    if ([device supportsFamily:MTLGPUFamilyApple7] || isMac2) {
+      subgroupOperations_ |= ICapabilities::SubgroupOperationBits::Arithmetic;
+    }
+    // the SIMD-groups of Apple GPUs have 32 threads. Other GPUs pick the width of each pipeline,
+    // which its threadExecutionWidth reports
+    const bool isAppleGpu = [device supportsFamily:MTLGPUFamilyApple1];
+    minSimdGroupSize_ = isAppleGpu ? 32 : 8;
+    maxSimdGroupSize_ = isAppleGpu ? 32 : 64;
+  }
+
   if (@available(macOS 11.0, iOS 14.0, *)) {
     // this API became available as of iOS 14 and macOS 11
     supports32BitFloatFiltering_ = device.supports32BitFloatFiltering;
+
+    // Timestamps are sampled at encoder boundaries, see metal::TimestampQueryPool
+    if ([device supportsCounterSampling:MTLCounterSamplingPointAtStageBoundary]) {
+      for (id<MTLCounterSet> counterSet in device.counterSets) {
+        if ([counterSet.name isEqualToString:MTLCommonCounterSetTimestamp]) {
+          supportsTimestampQueries_ = true;
+        }
+      }
+    }
   }
 }
 
@@ -127,7 +170,16 @@ bool DeviceFeatureSet::hasFeature(DeviceFeatures feature) const {
   case DeviceFeatures::Texture3D:
   case DeviceFeatures::SRGB:
   case DeviceFeatures::DrawIndexedIndirect:
+  case DeviceFeatures::DrawInstanced:
     return true;
+  case DeviceFeatures::DrawBaseInstance:
+  case DeviceFeatures::DrawBaseVertex:
+    // the baseVertex:baseInstance: draw calls need MTLGPUFamilyApple3 on iOS
+#if IGL_PLATFORM_IOS
+    return deviceFeatureDesc_.gpuFamily >= 3;
+#else
+    return true;
+#endif
   // on Metal and Vulkan, the framebuffer pixel format dictates sRGB control.
   case DeviceFeatures::SRGBWriteControl:
     return false;
@@ -137,7 +189,11 @@ bool DeviceFeatureSet::hasFeature(DeviceFeatures feature) const {
   case DeviceFeatures::ExplicitBindingExt:
   case DeviceFeatures::StandardDerivativeExt:
   case DeviceFeatures::ShaderTextureLodExt:
+  case DeviceFeatures::SubgroupSizeControl:
     return false;
+  case DeviceFeatures::Subpasses:
+    // subpasses read their input attachments with programmable blending
+    return supportsProgrammableBlending_;
   case DeviceFeatures::DepthCompare:
     /// docs say:
     ///  The MTLFeatureSet_iOS_GPUFamily3_v1 and MTLFeatureSet_OSX_GPUFamily1_v1 feature sets allow
@@ -154,21 +210,28 @@ bool DeviceFeatureSet::hasFeature(DeviceFeatures feature) const {
   case DeviceFeatures::Compute:
     return true;
   case DeviceFeatures::TextureBindless:
-    return false;
+    return supportsBindless_;
   case DeviceFeatures::BufferDeviceAddress:
-    return false;
+    // MTLBuffer.gpuAddress is part of Metal 3, just like the bindless table
+    return supportsBindless_;
   case DeviceFeatures::Multiview:
     return false;
+  case DeviceFeatures::FragmentDensityMap:
+    return false;
   case DeviceFeatures::BindUniform:
     return false;
   case DeviceFeatures::TexturePartialMipChain:
     return true;
+  case DeviceFeatures::TextureViews:
+    return true;
   case DeviceFeatures::BufferRing:
     return true;
   case DeviceFeatures::BufferNoCopy:
     return true;
   case DeviceFeatures::ShaderLibrary:
     return true;
+  case DeviceFeatures::ShaderSubgroups:
+    return (subgroupOperations_ & ICapabilities::SubgroupOperationBits::Arithmetic) != 0;
   case DeviceFeatures::BindBytes:
     return true;
   case DeviceFeatures::TextureArrayExt:
@@ -177,6 +240,10 @@ bool DeviceFeatureSet::hasFeature(DeviceFeatures feature) const {
     return true;
   case DeviceFeatures::ValidationLayersEnabled:
     return false;
+  case DeviceFeatures::OcclusionQueries:
+    return true;
+  case DeviceFeatures::TimestampQueries:
+    return supportsTimestampQueries_;
   case DeviceFeatures::ExternalMemoryObjects:
     return false;
   }
@@ -250,6 +317,14 @@ bool DeviceFeatureSet::getFeatureLimits(DeviceFeatureLimits featureLimits, size_
   case DeviceFeatureLimits::BufferAlignment:
     result = 16;
     return true;
+  case DeviceFeatureLimits::UniformBufferOffsetAlignment:
+#if IGL_PLATFORM_MACOS
+    // constant buffer offsets are 256-byte aligned on macOS and 4-byte aligned on Apple GPUs
+    result = 256;
+#else
+    result = 16;
+#endif
+    return true;
   case DeviceFeatureLimits::BufferNoCopyAlignment: {
     IGL_ASSERT(getpagesize() > 0);
     result = static_cast<size_t>(getpagesize());
@@ -258,6 +333,15 @@ bool DeviceFeatureSet::getFeatureLimits(DeviceFeatureLimits featureLimits, size_
   case DeviceFeatureLimits::MaxBindBytesBytes:
     result = 4096;
     return true;
+  case DeviceFeatureLimits::MinSubgroupSize:
+    result = minSimdGroupSize_;
+    return true;
+  case DeviceFeatureLimits::MaxSubgroupSize:
+    result = maxSimdGroupSize_;
+    return true;
+  case DeviceFeatureLimits::SubgroupOperations:
+    result = subgroupOperations_;
+    return true;
   default:
     IGL_ASSERT_MSG(
         0,
@@ -345,7 +429,8 @@ ICapabilities::TextureFormatCapabilities DeviceFeatureSet::getTextureFormatCapab
 
     // 96 bpp
   case TextureFormat::RGB_F32:
-    return unsupported;
+    // stored as RGBA_F32, see Texture::getUploadConversionFormat()
+    return sampled | (supports32BitFloatFiltering_ ? sampledFiltered : 0);
   // 128 bps
   case TextureFormat::RGBA_UInt32:
     return sampled | storage | attachment | sampledAttachment;
@@ -451,13 +536,18 @@ ICapabilities::TextureFormatCapabilities DeviceFeatureSet::getTextureFormatCapab
   case TextureFormat::S_UInt8:
     return sampled | attachment | sampledAttachment;
 
-  // Formats with no support in IGL Metal
+  // Formats converted on upload, see Texture::getUploadConversionFormat()
   case TextureFormat::L_UNorm8:
   case TextureFormat::LA_UNorm8:
-  case TextureFormat::R5G5B5A1_UNorm:
   case TextureFormat::RGBX_UNorm8:
-  case TextureFormat::BGRA_UNorm8_Rev:
   case TextureFormat::RGB_F16:
+    return Texture::getUploadConversionFormat(format) != TextureFormat::Invalid
+               ? sampled | sampledFiltered
+               : unsupported;
+
+  // Formats with no support in IGL Metal
+  case TextureFormat::R5G5B5A1_UNorm:
+  case TextureFormat::BGRA_UNorm8_Rev:
   case TextureFormat::RGB8_ETC1:
   case TextureFormat::RGB8_Punchthrough_A1_ETC2:
   case TextureFormat::SRGB8_ETC2:
@@ -467,6 +557,9 @@ ICapabilities::TextureFormatCapabilities DeviceFeatureSet::getTextureFormatCapab
   case TextureFormat::RG_EAC_SNorm:
   case TextureFormat::R_EAC_UNorm:
   case TextureFormat::R_EAC_SNorm:
+  // Multi-planar formats are sampled through per-plane textures
+  case TextureFormat::YUV_NV12:
+  case TextureFormat::YUV_P010:
     return unsupported;
   }
 }
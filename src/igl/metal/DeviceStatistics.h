@@ -8,7 +8,9 @@
 #pragma once
 
 #include <cstdint>
+#include <igl/FrameStatistics.h>
 #include <stddef.h>
+#include <vector>
 
 namespace igl::metal {
 
@@ -17,12 +19,16 @@ class CommandQueue;
 class DeviceStatistics {
  public:
   [[nodiscard]] size_t getDrawCount() const noexcept;
+  [[nodiscard]] FrameStatistics getFrameStatistics() const noexcept;
+  [[nodiscard]] std::vector<FrameStatistics> getFrameStatisticsHistory() const;
 
  private:
   friend class CommandQueue;
   void incrementDrawCount(uint32_t newDrawCount) noexcept;
+  void endFrame() noexcept;
 
   size_t currentDrawCount_ = 0;
+  FrameStatisticsTracker frameStatistics_;
 };
 
 } // namespace igl::metal
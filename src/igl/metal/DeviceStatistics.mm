@@ -11,10 +11,23 @@ namespace igl::metal {
 
 void DeviceStatistics::incrementDrawCount(uint32_t newDrawCount) noexcept {
   currentDrawCount_ += newDrawCount;
+  frameStatistics_.add(FrameStatisticsTracker::DrawCalls, newDrawCount);
+}
+
+void DeviceStatistics::endFrame() noexcept {
+  frameStatistics_.endFrame();
 }
 
 size_t DeviceStatistics::getDrawCount() const noexcept {
   return currentDrawCount_;
 }
 
+FrameStatistics DeviceStatistics::getFrameStatistics() const noexcept {
+  return frameStatistics_.getCurrent();
+}
+
+std::vector<FrameStatistics> DeviceStatistics::getFrameStatisticsHistory() const {
+  return frameStatistics_.getHistory();
+}
+
 } // namespace igl::metal
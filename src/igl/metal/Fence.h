@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <igl/Fence.h>
+
+namespace igl {
+namespace metal {
+
+// A value of an MTLSharedEvent; the fence is signaled once the event reaches it. Exported handles
+// are not retained and stay valid as long as the fence.
+class API_AVAILABLE(macos(10.14), ios(12.0)) Fence final : public IFence {
+ public:
+  Fence(id<MTLSharedEvent> event, uint64_t value);
+  ~Fence() override = default;
+
+  [[nodiscard]] bool isSignaled() const override;
+  bool waitUntilSignaled(uint64_t timeoutNanoseconds = UINT64_MAX) const override;
+  Result exportNativeHandle(FenceHandleType type, FenceNativeHandle& outHandle) const override;
+
+  [[nodiscard]] id<MTLSharedEvent> getEvent() const {
+    return event_;
+  }
+  [[nodiscard]] uint64_t getValue() const {
+    return value_;
+  }
+
+ private:
+  id<MTLSharedEvent> event_;
+  uint64_t value_;
+};
+
+} // namespace metal
+} // namespace igl
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/Fence.h>
+
+#include <chrono>
+#include <thread>
+
+namespace igl {
+namespace metal {
+
+Fence::Fence(id<MTLSharedEvent> event, uint64_t value) : event_(event), value_(value) {}
+
+bool Fence::isSignaled() const {
+  return event_.signaledValue >= value_;
+}
+
+bool Fence::waitUntilSignaled(uint64_t timeoutNanoseconds) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+
+  if (@available(macOS 12.0, iOS 15.0, *)) {
+    const uint64_t timeoutMs = timeoutNanoseconds == UINT64_MAX
+                                   ? UINT64_MAX
+                                   : (timeoutNanoseconds + 999999) / 1000000;
+    return [event_ waitUntilSignaledValue:value_ timeoutMS:timeoutMs];
+  }
+
+  const auto deadline = timeoutNanoseconds == UINT64_MAX
+                            ? std::chrono::steady_clock::time_point::max()
+                            : std::chrono::steady_clock::now() +
+                                  std::chrono::nanoseconds(timeoutNanoseconds);
+  while (!isSignaled()) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+Result Fence::exportNativeHandle(FenceHandleType type, FenceNativeHandle& outHandle) const {
+  if (type != FenceHandleType::MTLSharedEvent) {
+    return Result(Result::Code::Unsupported, "Metal fences are exported as MTLSharedEvents");
+  }
+  outHandle = {};
+  outHandle.type = FenceHandleType::MTLSharedEvent;
+  outHandle.handle = (__bridge void*)event_;
+  outHandle.value = value_;
+  return Result();
+}
+
+} // namespace metal
+} // namespace igl
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace igl {
+class IResourceTracker;
+
+namespace metal {
+
+struct HeapAllocatorConfig {
+  // size of each heap buffers and textures are sub-allocated from
+  size_t heapSize = 64 * 1024 * 1024;
+  // larger resources are allocated directly from the MTLDevice
+  size_t maxSubAllocationSize = 8 * 1024 * 1024;
+  // size of each per-frame heap for transient textures; 0 disables transient heaps
+  size_t transientHeapSize = 32 * 1024 * 1024;
+  // Create the heaps with MTLHazardTrackingModeUntracked, which removes the CPU cost of Metal
+  // tracking every heap resource bound to an encoder. Command queues created afterwards order their
+  // render and compute passes with an MTLFence instead (see CommandQueue), so a pass sees the
+  // writes of the previous passes. Blits, such as mipmap generation and readbacks, are not fenced:
+  // wait for the command buffer which wrote a heap resource before reading it back.
+  bool untrackedHazards = false;
+};
+
+/**
+ * @brief Sub-allocates buffers and textures from MTLHeaps instead of creating every resource from
+ * the MTLDevice, which is considerably cheaper when many small resources are created at once.
+ *
+ * Persistent resources come from automatic heaps which reclaim the memory of released resources.
+ * Transient textures (i.e. render targets which are only used within one frame) are placed
+ * linearly into one placement heap per in-flight frame. Once the same heap is used again, the
+ * frame which last used it has completed on the GPU and its memory is aliased by the new textures,
+ * exactly like the buffers of a RingBuffer are reused.
+ *
+ * Heaps use tracked hazards by default, so heap resources behave like resources created from the
+ * device (see HeapAllocatorConfig::untrackedHazards). Every heap is reported to the
+ * IResourceTracker it was created with.
+ *
+ * Requires macOS 10.15 / iOS 13 (see isSupported()).
+ */
+class HeapAllocator final {
+ public:
+  HeapAllocator(id<MTLDevice> device, const HeapAllocatorConfig& config, size_t numFrames);
+  ~HeapAllocator();
+
+  static bool isSupported();
+
+  // return nil if the resource should be allocated directly from the device
+  id<MTLBuffer> newBuffer(size_t length,
+                          MTLResourceOptions options,
+                          const std::shared_ptr<IResourceTracker>& tracker);
+  id<MTLTexture> newTexture(MTLTextureDescriptor* desc,
+                            const std::shared_ptr<IResourceTracker>& tracker);
+  // `frameCount` is the number of completed frames; the texture is valid until the end of the frame
+  id<MTLTexture> newTransientTexture(MTLTextureDescriptor* desc,
+                                     uint64_t frameCount,
+                                     const std::shared_ptr<IResourceTracker>& tracker);
+
+  // total size of all heaps in bytes
+  size_t getAllocatedSize() const;
+
+  bool hasUntrackedHazards() const {
+    return config_.untrackedHazards;
+  }
+
+ private:
+  struct Heap {
+    id<MTLHeap> heap = nil;
+    std::shared_ptr<IResourceTracker> tracker;
+  };
+  struct TransientHeap {
+    Heap heap;
+    size_t offset = 0;
+    uint64_t frameCount = 0;
+  };
+
+  bool canSubAllocate(MTLStorageMode storageMode, NSUInteger size) const;
+  Heap createHeap(MTLHeapType type,
+                  size_t size,
+                  MTLStorageMode storageMode,
+                  MTLCPUCacheMode cpuCacheMode,
+                  const std::shared_ptr<IResourceTracker>& tracker);
+  void destroyHeap(Heap& heap);
+  // returns a heap of heaps_ with at least `size` bytes available at `align`
+  id<MTLHeap> findHeap(NSUInteger size,
+                       NSUInteger align,
+                       MTLStorageMode storageMode,
+                       MTLCPUCacheMode cpuCacheMode,
+                       const std::shared_ptr<IResourceTracker>& tracker);
+
+ private:
+  id<MTLDevice> device_;
+  HeapAllocatorConfig config_;
+  mutable std::mutex mutex_;
+  std::vector<Heap> heaps_;
+  std::vector<TransientHeap> transientHeaps_; // one per in-flight frame
+  size_t allocatedSize_ = 0;
+};
+
+} // namespace metal
+} // namespace igl
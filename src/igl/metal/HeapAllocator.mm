@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/HeapAllocator.h>
+
+#include <algorithm>
+#include <igl/Common.h>
+#include <igl/IResourceTracker.h>
+
+namespace igl {
+namespace metal {
+
+namespace {
+NSUInteger alignUp(NSUInteger value, NSUInteger alignment) {
+  return alignment ? (value + alignment - 1) / alignment * alignment : value;
+}
+} // namespace
+
+HeapAllocator::HeapAllocator(id<MTLDevice> device,
+                             const HeapAllocatorConfig& config,
+                             size_t numFrames) :
+  device_(device), config_(config) {
+  IGL_ASSERT(isSupported());
+  IGL_ASSERT(numFrames > 0);
+  // an empty heap must fit every sub-allocation
+  config_.maxSubAllocationSize = std::min(config_.maxSubAllocationSize, config_.heapSize);
+  if (config_.transientHeapSize) {
+    transientHeaps_.resize(numFrames);
+  }
+}
+
+HeapAllocator::~HeapAllocator() {
+  for (auto& heap : heaps_) {
+    destroyHeap(heap);
+  }
+  for (auto& transientHeap : transientHeaps_) {
+    destroyHeap(transientHeap.heap);
+  }
+}
+
+bool HeapAllocator::isSupported() {
+  if (@available(macOS 10.15, iOS 13.0, *)) {
+    return true;
+  }
+  return false;
+}
+
+bool HeapAllocator::canSubAllocate(MTLStorageMode storageMode, NSUInteger size) const {
+  if (size > config_.maxSubAllocationSize) {
+    return false;
+  }
+#if TARGET_OS_OSX
+  // heaps on macOS only support private storage
+  return storageMode == MTLStorageModePrivate;
+#else
+  return storageMode == MTLStorageModePrivate || storageMode == MTLStorageModeShared;
+#endif
+}
+
+HeapAllocator::Heap HeapAllocator::createHeap(MTLHeapType type,
+                                              size_t size,
+                                              MTLStorageMode storageMode,
+                                              MTLCPUCacheMode cpuCacheMode,
+                                              const std::shared_ptr<IResourceTracker>& tracker) {
+  Heap result;
+  if (@available(macOS 10.15, iOS 13.0, *)) {
+    MTLHeapDescriptor* desc = [MTLHeapDescriptor new];
+    desc.type = type;
+    desc.size = size;
+    desc.storageMode = storageMode;
+    desc.cpuCacheMode = cpuCacheMode;
+    // tracked hazards match the behavior of resources created from the device
+    desc.hazardTrackingMode = config_.untrackedHazards ? MTLHazardTrackingModeUntracked
+                                                       : MTLHazardTrackingModeTracked;
+    result.heap = [device_ newHeapWithDescriptor:desc];
+  }
+  if (!result.heap) {
+    IGL_LOG_ERROR("HeapAllocator: failed to create a heap of %zu bytes\n", size);
+    return result;
+  }
+  result.heap.label = type == MTLHeapTypePlacement ? @"IGL transient heap" : @"IGL heap";
+  result.tracker = tracker;
+  allocatedSize_ += result.heap.size;
+  if (tracker) {
+    tracker->didCreateHeap(result.heap.size);
+  }
+  return result;
+}
+
+void HeapAllocator::destroyHeap(Heap& heap) {
+  if (!heap.heap) {
+    return;
+  }
+  allocatedSize_ -= heap.heap.size;
+  if (heap.tracker) {
+    heap.tracker->willDeleteHeap(heap.heap.size);
+  }
+  heap = {};
+}
+
+id<MTLHeap> HeapAllocator::findHeap(NSUInteger size,
+                                    NSUInteger align,
+                                    MTLStorageMode storageMode,
+                                    MTLCPUCacheMode cpuCacheMode,
+                                    const std::shared_ptr<IResourceTracker>& tracker) {
+  id<MTLHeap> result = nil;
+  for (auto it = heaps_.begin(); it != heaps_.end();) {
+    id<MTLHeap> heap = it->heap;
+    if (heap.storageMode != storageMode || heap.cpuCacheMode != cpuCacheMode) {
+      ++it;
+      continue;
+    }
+    if (!result && [heap maxAvailableSizeWithAlignment:align] >= size) {
+      result = heap;
+      ++it;
+      continue;
+    }
+    // keep at most one empty heap around
+    if (heap.usedSize == 0 && result) {
+      destroyHeap(*it);
+      it = heaps_.erase(it);
+      continue;
+    }
+    ++it;
+  }
+  if (result) {
+    return result;
+  }
+  Heap heap =
+      createHeap(MTLHeapTypeAutomatic, config_.heapSize, storageMode, cpuCacheMode, tracker);
+  if (heap.heap) {
+    heaps_.push_back(heap);
+  }
+  return heap.heap;
+}
+
+id<MTLBuffer> HeapAllocator::newBuffer(size_t length,
+                                       MTLResourceOptions options,
+                                       const std::shared_ptr<IResourceTracker>& tracker) {
+  const auto storageMode =
+      static_cast<MTLStorageMode>((options & MTLResourceStorageModeMask) >>
+                                  MTLResourceStorageModeShift);
+  const auto cpuCacheMode =
+      static_cast<MTLCPUCacheMode>((options & MTLResourceCPUCacheModeMask) >>
+                                   MTLResourceCPUCacheModeShift);
+  const MTLSizeAndAlign sizeAndAlign = [device_ heapBufferSizeAndAlignWithLength:length
+                                                                         options:options];
+  if (!canSubAllocate(storageMode, sizeAndAlign.size)) {
+    return nil;
+  }
+
+  const std::lock_guard<std::mutex> lock(mutex_);
+
+  id<MTLHeap> heap =
+      findHeap(sizeAndAlign.size, sizeAndAlign.align, storageMode, cpuCacheMode, tracker);
+  return [heap newBufferWithLength:length options:options];
+}
+
+id<MTLTexture> HeapAllocator::newTexture(MTLTextureDescriptor* desc,
+                                         const std::shared_ptr<IResourceTracker>& tracker) {
+  const MTLSizeAndAlign sizeAndAlign = [device_ heapTextureSizeAndAlignWithDescriptor:desc];
+  if (!canSubAllocate(desc.storageMode, sizeAndAlign.size)) {
+    return nil;
+  }
+
+  const std::lock_guard<std::mutex> lock(mutex_);
+
+  id<MTLHeap> heap = findHeap(
+      sizeAndAlign.size, sizeAndAlign.align, desc.storageMode, desc.cpuCacheMode, tracker);
+  return [heap newTextureWithDescriptor:desc];
+}
+
+id<MTLTexture> HeapAllocator::newTransientTexture(
+    MTLTextureDescriptor* desc,
+    uint64_t frameCount,
+    const std::shared_ptr<IResourceTracker>& tracker) {
+  if (transientHeaps_.empty() || desc.storageMode != MTLStorageModePrivate) {
+    return nil;
+  }
+  const MTLSizeAndAlign sizeAndAlign = [device_ heapTextureSizeAndAlignWithDescriptor:desc];
+
+  const std::lock_guard<std::mutex> lock(mutex_);
+
+  auto& transientHeap = transientHeaps_[frameCount % transientHeaps_.size()];
+  if (!transientHeap.heap.heap) {
+    transientHeap.heap = createHeap(MTLHeapTypePlacement,
+                                    config_.transientHeapSize,
+                                    MTLStorageModePrivate,
+                                    MTLCPUCacheModeDefaultCache,
+                                    tracker);
+    if (!transientHeap.heap.heap) {
+      return nil;
+    }
+  }
+  if (transientHeap.frameCount != frameCount) {
+    // the previous frame which used this heap has completed; alias its memory
+    transientHeap.frameCount = frameCount;
+    transientHeap.offset = 0;
+  }
+
+  const NSUInteger offset = alignUp(transientHeap.offset, sizeAndAlign.align);
+  if (offset + sizeAndAlign.size > transientHeap.heap.heap.size) {
+    IGL_LOG_INFO("HeapAllocator: transient heap is full, consider a larger transientHeapSize\n");
+    return nil;
+  }
+  id<MTLTexture> texture = nil;
+  if (@available(macOS 10.15, iOS 13.0, *)) {
+    texture = [transientHeap.heap.heap newTextureWithDescriptor:desc offset:offset];
+  }
+  if (texture) {
+    transientHeap.offset = offset + sizeAndAlign.size;
+  }
+  return texture;
+}
+
+size_t HeapAllocator::getAllocatedSize() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return allocatedSize_;
+}
+
+} // namespace metal
+} // namespace igl
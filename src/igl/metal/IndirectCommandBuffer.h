@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <igl/Buffer.h>
+#include <vector>
+
+namespace igl {
+namespace metal {
+
+struct IndirectCommandBufferDesc {
+  uint32_t maxCommandCount = 0;
+  // allow drawIndexedPrimitives commands next to drawPrimitives commands
+  bool indexed = false;
+};
+
+/**
+ * @brief A MTLIndirectCommandBuffer of draws, encoded either on the CPU with encodeDraw*() or on
+ * the GPU by a compute shader (i.e. GPU culling), and executed with
+ * RenderCommandEncoder::executeIndirectCommands().
+ *
+ * The draws inherit the render pipeline state and all vertex and fragment buffer bindings of the
+ * render command encoder executing them. Render pipelines used with it must be created with
+ * RenderPipelineDesc::supportIndirectCommandBuffers.
+ *
+ * To encode draws on the GPU, bind it with ComputeCommandEncoder::bindIndirectCommandBuffer(); the
+ * kernel sees it as:
+ *
+ *   struct IndirectCommandBuffer {
+ *     command_buffer commands [[id(0)]];
+ *   };
+ *   kernel void cull(device IndirectCommandBuffer& icb [[buffer(N)]], ...) {
+ *     render_command cmd(icb.commands, index);
+ *     cmd.draw_primitives(...);
+ *   }
+ *
+ * Index buffers referenced by GPU-encoded draws must be registered with useIndexBuffer(), so they
+ * are resident when the commands execute.
+ */
+class IndirectCommandBuffer final {
+ public:
+  IndirectCommandBuffer(id<MTLIndirectCommandBuffer> value,
+                        id<MTLBuffer> argumentBuffer,
+                        const IndirectCommandBufferDesc& desc);
+
+  void encodeDraw(uint32_t commandIndex,
+                  PrimitiveType primitiveType,
+                  uint32_t vertexStart,
+                  uint32_t vertexCount,
+                  uint32_t instanceCount = 1,
+                  uint32_t baseInstance = 0);
+  void encodeDrawIndexed(uint32_t commandIndex,
+                         PrimitiveType primitiveType,
+                         IndexFormat indexFormat,
+                         uint32_t indexCount,
+                         IBuffer& indexBuffer,
+                         size_t indexBufferOffset,
+                         uint32_t instanceCount = 1,
+                         int32_t baseVertex = 0,
+                         uint32_t baseInstance = 0);
+  // turns all commands into no-ops and forgets the index buffers in use
+  void reset();
+
+  void useIndexBuffer(IBuffer& indexBuffer);
+
+  uint32_t getMaxCommandCount() const {
+    return desc_.maxCommandCount;
+  }
+
+  IGL_INLINE id<MTLIndirectCommandBuffer> get() const {
+    return value_;
+  }
+  // argument buffer referencing the command buffer at [[id(0)]]
+  IGL_INLINE id<MTLBuffer> getArgumentBuffer() const {
+    return argumentBuffer_;
+  }
+  const std::vector<id<MTLBuffer>>& getIndexBuffers() const {
+    return indexBuffers_;
+  }
+
+ private:
+  id<MTLIndirectCommandBuffer> value_;
+  id<MTLBuffer> argumentBuffer_;
+  IndirectCommandBufferDesc desc_;
+  std::vector<id<MTLBuffer>> indexBuffers_;
+};
+
+} // namespace metal
+} // namespace igl
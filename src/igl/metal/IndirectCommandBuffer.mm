@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/IndirectCommandBuffer.h>
+
+#include <algorithm>
+#include <igl/metal/Buffer.h>
+#include <igl/metal/RenderCommandEncoder.h>
+
+namespace igl {
+namespace metal {
+
+IndirectCommandBuffer::IndirectCommandBuffer(id<MTLIndirectCommandBuffer> value,
+                                             id<MTLBuffer> argumentBuffer,
+                                             const IndirectCommandBufferDesc& desc) :
+  value_(value), argumentBuffer_(argumentBuffer), desc_(desc) {}
+
+void IndirectCommandBuffer::encodeDraw(uint32_t commandIndex,
+                                       PrimitiveType primitiveType,
+                                       uint32_t vertexStart,
+                                       uint32_t vertexCount,
+                                       uint32_t instanceCount,
+                                       uint32_t baseInstance) {
+  IGL_ASSERT(commandIndex < desc_.maxCommandCount);
+  id<MTLIndirectRenderCommand> command = [value_ indirectRenderCommandAtIndex:commandIndex];
+  [command drawPrimitives:RenderCommandEncoder::convertPrimitiveType(primitiveType)
+              vertexStart:vertexStart
+              vertexCount:vertexCount
+            instanceCount:instanceCount
+             baseInstance:baseInstance];
+}
+
+void IndirectCommandBuffer::encodeDrawIndexed(uint32_t commandIndex,
+                                              PrimitiveType primitiveType,
+                                              IndexFormat indexFormat,
+                                              uint32_t indexCount,
+                                              IBuffer& indexBuffer,
+                                              size_t indexBufferOffset,
+                                              uint32_t instanceCount,
+                                              int32_t baseVertex,
+                                              uint32_t baseInstance) {
+  IGL_ASSERT(commandIndex < desc_.maxCommandCount);
+  IGL_ASSERT_MSG(desc_.indexed, "IndirectCommandBufferDesc::indexed is not set");
+  auto& buffer = static_cast<Buffer&>(indexBuffer);
+  id<MTLIndirectRenderCommand> command = [value_ indirectRenderCommandAtIndex:commandIndex];
+  [command drawIndexedPrimitives:RenderCommandEncoder::convertPrimitiveType(primitiveType)
+                      indexCount:indexCount
+                       indexType:RenderCommandEncoder::convertIndexType(indexFormat)
+                     indexBuffer:buffer.get()
+               indexBufferOffset:buffer.getOffset() + indexBufferOffset
+                   instanceCount:instanceCount
+                      baseVertex:baseVertex
+                    baseInstance:baseInstance];
+  useIndexBuffer(indexBuffer);
+}
+
+void IndirectCommandBuffer::reset() {
+  [value_ resetWithRange:NSMakeRange(0, desc_.maxCommandCount)];
+  indexBuffers_.clear();
+}
+
+void IndirectCommandBuffer::useIndexBuffer(IBuffer& indexBuffer) {
+  id<MTLBuffer> buffer = static_cast<Buffer&>(indexBuffer).get();
+  if (std::find(indexBuffers_.begin(), indexBuffers_.end(), buffer) == indexBuffers_.end()) {
+    indexBuffers_.push_back(buffer);
+  }
+}
+
+} // namespace metal
+} // namespace igl
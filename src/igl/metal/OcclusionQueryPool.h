@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <atomic>
+#include <igl/OcclusionQueryPool.h>
+#include <memory>
+
+namespace igl {
+namespace metal {
+
+// Query results are written by the GPU into a visibility result buffer, one uint64_t per query.
+class OcclusionQueryPool final : public IOcclusionQueryPool {
+ public:
+  OcclusionQueryPool(id<MTLBuffer> buffer, const OcclusionQueryPoolDesc& desc);
+  ~OcclusionQueryPool() override = default;
+
+  [[nodiscard]] OcclusionQueryType getType() const override {
+    return type_;
+  }
+  [[nodiscard]] uint32_t getCount() const override {
+    return count_;
+  }
+  bool getResults(uint32_t firstQuery, uint32_t queryCount, uint64_t* outResults) override;
+
+  // Makes `renderPassDesc` write into this pool and resets it. Results become available once
+  // `commandBuffer` has completed.
+  void attach(MTLRenderPassDescriptor* renderPassDesc, id<MTLCommandBuffer> commandBuffer);
+
+  [[nodiscard]] MTLVisibilityResultMode getVisibilityResultMode() const {
+    return type_ == OcclusionQueryType::Binary ? MTLVisibilityResultModeBoolean
+                                               : MTLVisibilityResultModeCounting;
+  }
+
+ private:
+  id<MTLBuffer> buffer_;
+  OcclusionQueryType type_;
+  uint32_t count_;
+  // Number of command buffers writing into the pool which have not completed yet. Shared with
+  // their completion handlers.
+  std::shared_ptr<std::atomic<uint32_t>> pendingCommandBuffers_;
+};
+
+} // namespace metal
+} // namespace igl
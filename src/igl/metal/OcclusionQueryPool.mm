@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/OcclusionQueryPool.h>
+
+#include <cstring>
+
+namespace igl {
+namespace metal {
+
+OcclusionQueryPool::OcclusionQueryPool(id<MTLBuffer> buffer, const OcclusionQueryPoolDesc& desc) :
+  buffer_(buffer),
+  type_(desc.type),
+  count_(desc.count),
+  pendingCommandBuffers_(std::make_shared<std::atomic<uint32_t>>(0)) {}
+
+void OcclusionQueryPool::attach(MTLRenderPassDescriptor* renderPassDesc,
+                                id<MTLCommandBuffer> commandBuffer) {
+  // Metal doesn't clear the visibility result buffer between render passes
+  memset(buffer_.contents, 0, buffer_.length);
+  renderPassDesc.visibilityResultBuffer = buffer_;
+
+  ++(*pendingCommandBuffers_);
+  auto pending = pendingCommandBuffers_;
+  [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> /*buffer*/) {
+    --(*pending);
+  }];
+}
+
+bool OcclusionQueryPool::getResults(uint32_t firstQuery,
+                                    uint32_t queryCount,
+                                    uint64_t* outResults) {
+  if (!IGL_VERIFY(static_cast<uint64_t>(firstQuery) + queryCount <= count_) ||
+      !IGL_VERIFY(outResults != nullptr)) {
+    return false;
+  }
+  if (pendingCommandBuffers_->load() != 0) {
+    return false;
+  }
+
+  const auto* results = static_cast<const uint64_t*>(buffer_.contents) + firstQuery;
+  for (uint32_t i = 0; i < queryCount; ++i) {
+    outResults[i] = type_ == OcclusionQueryType::Binary ? (results[i] != 0 ? 1 : 0) : results[i];
+  }
+  return true;
+}
+
+} // namespace metal
+} // namespace igl
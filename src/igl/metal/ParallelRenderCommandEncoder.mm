@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/ParallelRenderCommandEncoder.h>
+
+#import <Foundation/Foundation.h>
+#import <Metal/Metal.h>
+#include <igl/metal/BindlessTable.h>
+#include <igl/metal/RenderCommandEncoder.h>
+
+namespace igl {
+namespace metal {
+
+ParallelRenderCommandEncoder::ParallelRenderCommandEncoder(
+    const std::shared_ptr<CommandBuffer>& commandBuffer) :
+  IParallelRenderCommandEncoder::IParallelRenderCommandEncoder(commandBuffer),
+  commandBuffer_(commandBuffer) {}
+
+std::unique_ptr<ParallelRenderCommandEncoder> ParallelRenderCommandEncoder::create(
+    const std::shared_ptr<CommandBuffer>& commandBuffer,
+    const RenderPassDesc& renderPass,
+    const std::shared_ptr<IFramebuffer>& framebuffer,
+    Result* outResult) {
+  MTLRenderPassDescriptor* metalRenderPassDesc =
+      RenderCommandEncoder::createRenderPassDescriptor(renderPass, framebuffer, outResult);
+  if (!metalRenderPassDesc) {
+    return nullptr;
+  }
+
+  std::unique_ptr<ParallelRenderCommandEncoder> encoder(
+      new ParallelRenderCommandEncoder(commandBuffer));
+  encoder->occlusionQueryMode_ = RenderCommandEncoder::attachOcclusionQueryPool(
+      renderPass, metalRenderPassDesc, commandBuffer->get());
+  encoder->encoder_ =
+      [commandBuffer->get() parallelRenderCommandEncoderWithDescriptor:metalRenderPassDesc];
+  return encoder;
+}
+
+std::unique_ptr<IRenderCommandEncoder> ParallelRenderCommandEncoder::createRenderCommandEncoder(
+    Result* outResult) {
+  if (!IGL_VERIFY(encoder_)) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "The render pass has ended");
+    return nullptr;
+  }
+  // MTLParallelRenderCommandEncoder is thread-safe and keeps the creation order of its children
+  id<MTLRenderCommandEncoder> child = [encoder_ renderCommandEncoder];
+  if (auto* bindlessTable = commandBuffer_->getBindlessTable()) {
+    bindlessTable->bind(child, commandBuffer_->get());
+  }
+  Result::setOk(outResult);
+  return RenderCommandEncoder::create(commandBuffer_, child, occlusionQueryMode_);
+}
+
+void ParallelRenderCommandEncoder::endEncoding() {
+  [encoder_ endEncoding];
+  encoder_ = nil;
+}
+
+void ParallelRenderCommandEncoder::pushDebugGroupLabel(const std::string& label,
+                                                       const igl::Color& /*color*/) const {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT(!label.empty());
+  [encoder_ pushDebugGroup:[NSString stringWithUTF8String:label.c_str()] ?: @""];
+}
+
+void ParallelRenderCommandEncoder::insertDebugEventLabel(const std::string& label,
+                                                         const igl::Color& /*color*/) const {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT(!label.empty());
+  [encoder_ insertDebugSignpost:[NSString stringWithUTF8String:label.c_str()] ?: @""];
+}
+
+void ParallelRenderCommandEncoder::popDebugGroupLabel() const {
+  IGL_ASSERT(encoder_);
+  [encoder_ popDebugGroup];
+}
+
+} // namespace metal
+} // namespace igl
@@ -9,6 +9,7 @@
 
 #import <CoreVideo/CVMetalTextureCache.h>
 #import <CoreVideo/CVPixelBuffer.h>
+#import <IOSurface/IOSurfaceRef.h>
 #import <Metal/Metal.h>
 #import <QuartzCore/CALayer.h>
 #import <QuartzCore/CAMetalLayer.h>
@@ -81,7 +82,8 @@ class PlatformDevice final : public IPlatformDevice {
 
   /// Creates a texture from a native PixelBuffer
   /// @param sourceImage source image
-  /// @param format the format of the source texture
+  /// @param format the format of the source texture; multi-planar formats such as YUV_NV12 create
+  /// a texture of the format of one plane, see getTextureFormatOfPlane()
   /// @param width the width of the texture
   /// @param height the height of the texture
   /// @param outResult optional result
@@ -93,6 +95,21 @@ class PlatformDevice final : public IPlatformDevice {
                                                                        size_t planeIndex,
                                                                        Result* outResult);
 
+  /// Creates a texture which aliases one plane of an IOSurface, without any copy. Bi-planar YUV
+  /// surfaces are imported as one texture per plane, e.g. R_UNorm8 luma and RG_UNorm8 chroma.
+  /// @param surface source surface
+  /// @param format the format of the plane, or a multi-planar format such as YUV_NV12 to derive it
+  /// from `planeIndex`
+  /// @param planeIndex the plane index to generate the texture
+  /// @param usage the way the texture is going to be used
+  /// @param outResult optional result
+  /// @return pointer to generated Texture or nullptr
+  std::unique_ptr<ITexture> createTextureFromNativeIOSurface(IOSurfaceRef surface,
+                                                             TextureFormat format,
+                                                             size_t planeIndex,
+                                                             TextureDesc::TextureUsage usage,
+                                                             Result* outResult);
+
   /// Get a size of a given native drawable surface.
   /// @param nativeDrawable drawable surface. For Metal is MUST be CAMetalLayer
   /// @param outResult Optional result.
@@ -13,6 +13,7 @@
 
 #import <QuartzCore/QuartzCore.h>
 
+#include <algorithm>
 #include <igl/metal/DepthStencilState.h>
 #include <igl/metal/Device.h>
 #include <igl/metal/Framebuffer.h>
@@ -47,9 +48,12 @@ std::shared_ptr<SamplerState> PlatformDevice::createSamplerState(const SamplerSt
     metalDesc.compareFunction =
         DepthStencilState::convertCompareFunction(desc.depthCompareFunction);
   }
+  // samplers can only be put into argument buffers (the bindless table) if created this way
+  metalDesc.supportArgumentBuffers = device_.getBindlessTable() != nullptr;
 
   id<MTLSamplerState> metalObject = [device_.get() newSamplerStateWithDescriptor:metalDesc];
   auto resource = std::make_shared<SamplerState>(metalObject);
+  resource->bindlessTable_ = device_.getBindlessTable();
   if (device_.getResourceTracker()) {
     resource->initResourceTracker(device_.getResourceTracker());
   }
@@ -146,6 +150,11 @@ std::unique_ptr<ITexture> PlatformDevice::createTextureFromNativePixelBufferWith
     Result* outResult) {
   std::unique_ptr<Texture> resultTexture = nullptr;
 
+  if (TextureFormatProperties::fromTextureFormat(format).isMultiPlanar()) {
+    // YUV pixel buffers are sampled through one texture per plane
+    format = getTextureFormatOfPlane(format, planeIndex);
+  }
+
 #if (!TARGET_OS_SIMULATOR || __IPHONE_OS_VERSION_MAX_ALLOWED >= 130000)
   CVMetalTextureCacheRef textureCache = getTextureCache();
   if (textureCache) {
@@ -174,6 +183,9 @@ std::unique_ptr<ITexture> PlatformDevice::createTextureFromNativePixelBufferWith
 
     if (result != kCVReturnSuccess) {
       NSLog(@"Failed to created Metal texture from PixelBuffer");
+      Result::setResult(outResult,
+                        Result::Code::RuntimeError,
+                        "Failed to created Metal texture from PixelBuffer");
       return nullptr;
     }
 
@@ -192,6 +204,61 @@ std::unique_ptr<ITexture> PlatformDevice::createTextureFromNativePixelBufferWith
   return resultTexture;
 }
 
+std::unique_ptr<ITexture> PlatformDevice::createTextureFromNativeIOSurface(
+    IOSurfaceRef surface,
+    TextureFormat format,
+    size_t planeIndex,
+    TextureDesc::TextureUsage usage,
+    Result* outResult) {
+  if (surface == nullptr) {
+    Result::setResult(outResult, Result::Code::ArgumentNull, "IOSurface is NULL");
+    return nullptr;
+  }
+  if (TextureFormatProperties::fromTextureFormat(format).isMultiPlanar()) {
+    format = getTextureFormatOfPlane(format, planeIndex);
+  }
+  MTLPixelFormat const metalFormat = Texture::textureFormatToMTLPixelFormat(format);
+  if (metalFormat == MTLPixelFormatInvalid) {
+    Result::setResult(outResult,
+                      Result::Code::Unsupported,
+                      "Invalid Texture Format : " +
+                          std::string(TextureFormatProperties::fromTextureFormat(format).name));
+    return nullptr;
+  }
+  // non-planar surfaces report 0 planes
+  const size_t planeCount = IOSurfaceGetPlaneCount(surface);
+  if (planeIndex >= std::max<size_t>(planeCount, 1)) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Invalid IOSurface plane index");
+    return nullptr;
+  }
+  const size_t width =
+      planeCount ? IOSurfaceGetWidthOfPlane(surface, planeIndex) : IOSurfaceGetWidth(surface);
+  const size_t height =
+      planeCount ? IOSurfaceGetHeightOfPlane(surface, planeIndex) : IOSurfaceGetHeight(surface);
+
+  MTLTextureDescriptor* metalDesc =
+      [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:metalFormat
+                                                         width:width
+                                                        height:height
+                                                     mipmapped:NO];
+  metalDesc.usage = Texture::toMTLTextureUsage(usage);
+  id<MTLTexture> metalTexture = [device_.get() newTextureWithDescriptor:metalDesc
+                                                              iosurface:surface
+                                                                  plane:planeIndex];
+  if (metalTexture == nil) {
+    Result::setResult(
+        outResult, Result::Code::RuntimeError, "Failed to create Metal texture from IOSurface");
+    return nullptr;
+  }
+
+  auto resultTexture = std::make_unique<Texture>(metalTexture, device_);
+  if (auto resourceTracker = device_.getResourceTracker()) {
+    resultTexture->initResourceTracker(resourceTracker);
+  }
+  Result::setOk(outResult);
+  return resultTexture;
+}
+
 Size PlatformDevice::getNativeDrawableSize(CALayer* nativeDrawable, Result* outResult) {
 #if (!TARGET_OS_SIMULATOR || __IPHONE_OS_VERSION_MAX_ALLOWED >= 130000)
   Result::setOk(outResult);
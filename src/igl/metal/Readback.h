@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <igl/Readback.h>
+#include <igl/Texture.h>
+#include <memory>
+
+namespace igl {
+namespace metal {
+
+// A blit into a shared MTLBuffer, committed in its own command buffer
+class Readback final : public IReadback {
+ public:
+  Readback(id<MTLCommandBuffer> commandBuffer, id<MTLBuffer> buffer, size_t size);
+  ~Readback() override = default;
+
+  [[nodiscard]] bool isReady() const override;
+  [[nodiscard]] size_t getSizeInBytes() const override {
+    return size_;
+  }
+  Result getData(void* outData) override;
+
+  // Blits `range` of `texture` or `buffer` into a new readback, committed on `queue`
+  static std::shared_ptr<Readback> create(id<MTLCommandQueue> queue,
+                                          id<MTLTexture> texture,
+                                          const TextureRangeDesc& range,
+                                          size_t bytesPerRow,
+                                          size_t size,
+                                          Result* outResult);
+  static std::shared_ptr<Readback> create(id<MTLCommandQueue> queue,
+                                          id<MTLBuffer> buffer,
+                                          size_t offset,
+                                          size_t size,
+                                          Result* outResult);
+
+ private:
+  id<MTLCommandBuffer> commandBuffer_;
+  id<MTLBuffer> buffer_;
+  size_t size_;
+  bool isCollected_ = false;
+};
+
+} // namespace metal
+} // namespace igl
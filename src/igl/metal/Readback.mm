@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/Readback.h>
+
+#include <cstring>
+
+namespace igl {
+namespace metal {
+
+namespace {
+id<MTLBuffer> createReadbackBuffer(id<MTLCommandQueue> queue, size_t size) {
+  return [queue.device newBufferWithLength:size options:MTLResourceStorageModeShared];
+}
+
+void commit(id<MTLCommandBuffer> commandBuffer, id<MTLBlitCommandEncoder> blit) {
+  [blit endEncoding];
+  [commandBuffer commit];
+}
+} // namespace
+
+Readback::Readback(id<MTLCommandBuffer> commandBuffer, id<MTLBuffer> buffer, size_t size) :
+  commandBuffer_(commandBuffer), buffer_(buffer), size_(size) {}
+
+std::shared_ptr<Readback> Readback::create(id<MTLCommandQueue> queue,
+                                           id<MTLTexture> texture,
+                                           const TextureRangeDesc& range,
+                                           size_t bytesPerRow,
+                                           size_t size,
+                                           Result* outResult) {
+  id<MTLBuffer> buffer = createReadbackBuffer(queue, size);
+  id<MTLCommandBuffer> commandBuffer = [queue commandBuffer];
+  if (!buffer || !commandBuffer) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot allocate a readback buffer");
+    return nullptr;
+  }
+
+  // command buffers of a queue run in order, so the blit runs after all the submitted work
+  id<MTLBlitCommandEncoder> blit = [commandBuffer blitCommandEncoder];
+  [blit copyFromTexture:texture
+               sourceSlice:range.layer
+               sourceLevel:range.mipLevel
+              sourceOrigin:MTLOriginMake(range.x, range.y, 0)
+                sourceSize:MTLSizeMake(range.width, range.height, 1)
+                  toBuffer:buffer
+         destinationOffset:0
+    destinationBytesPerRow:bytesPerRow
+  destinationBytesPerImage:size];
+  commit(commandBuffer, blit);
+
+  Result::setOk(outResult);
+  return std::make_shared<Readback>(commandBuffer, buffer, size);
+}
+
+std::shared_ptr<Readback> Readback::create(id<MTLCommandQueue> queue,
+                                           id<MTLBuffer> buffer,
+                                           size_t offset,
+                                           size_t size,
+                                           Result* outResult) {
+  id<MTLBuffer> readbackBuffer = createReadbackBuffer(queue, size);
+  id<MTLCommandBuffer> commandBuffer = [queue commandBuffer];
+  if (!readbackBuffer || !commandBuffer) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot allocate a readback buffer");
+    return nullptr;
+  }
+
+  // a copy, so later writes into `buffer` do not change the data
+  id<MTLBlitCommandEncoder> blit = [commandBuffer blitCommandEncoder];
+  [blit copyFromBuffer:buffer
+           sourceOffset:offset
+               toBuffer:readbackBuffer
+      destinationOffset:0
+                   size:size];
+  commit(commandBuffer, blit);
+
+  Result::setOk(outResult);
+  return std::make_shared<Readback>(commandBuffer, readbackBuffer, size);
+}
+
+bool Readback::isReady() const {
+  return !isCollected_ && commandBuffer_.status == MTLCommandBufferStatusCompleted;
+}
+
+Result Readback::getData(void* outData) {
+  if (!IGL_VERIFY(outData)) {
+    return Result(Result::Code::ArgumentNull, "outData is null");
+  }
+  if (isCollected_) {
+    return Result(Result::Code::InvalidOperation, "The data has already been retrieved");
+  }
+  isCollected_ = true;
+
+  [commandBuffer_ waitUntilCompleted];
+  if (commandBuffer_.status != MTLCommandBufferStatusCompleted) {
+    return Result(Result::Code::RuntimeError, "The readback blit failed");
+  }
+  memcpy(outData, buffer_.contents, size_);
+  // the buffer is not needed anymore
+  buffer_ = nil;
+  return Result();
+}
+
+} // namespace metal
+} // namespace igl
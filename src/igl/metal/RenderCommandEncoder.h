@@ -8,6 +8,7 @@
 #pragma once
 
 #include <Metal/Metal.h>
+#include <array>
 #include <igl/CommandBuffer.h>
 #include <igl/RenderCommandEncoder.h>
 #include <igl/RenderPass.h>
@@ -17,14 +18,25 @@
 namespace igl {
 namespace metal {
 class Buffer;
+class IndirectCommandBuffer;
 
 class RenderCommandEncoder final : public IRenderCommandEncoder {
  public:
+  // push constants are bound as bytes at this buffer index for the vertex and fragment stages
+  static constexpr size_t kPushConstantsBufferIndex = 29;
+  // the minimum push constants size guaranteed by Vulkan
+  static constexpr size_t kMaxPushConstantsSize = 128;
+
   static std::unique_ptr<RenderCommandEncoder> create(
       const std::shared_ptr<CommandBuffer>& commandBuffer,
       const RenderPassDesc& renderPass,
       const std::shared_ptr<IFramebuffer>& framebuffer,
       Result* outResult);
+  // wraps an encoder created elsewhere, e.g. by a MTLParallelRenderCommandEncoder
+  static std::unique_ptr<RenderCommandEncoder> create(
+      const std::shared_ptr<CommandBuffer>& commandBuffer,
+      id<MTLRenderCommandEncoder> encoder,
+      MTLVisibilityResultMode occlusionQueryMode = MTLVisibilityResultModeDisabled);
 
   ~RenderCommandEncoder() override = default;
 
@@ -39,23 +51,34 @@ class RenderCommandEncoder final : public IRenderCommandEncoder {
 
   void bindRenderPipelineState(const std::shared_ptr<IRenderPipelineState>& pipelineState) override;
   void bindDepthStencilState(const std::shared_ptr<IDepthStencilState>& depthStencilState) override;
+  void bindRenderPipelineState(IRenderPipelineState& pipelineState) override;
+  void bindDepthStencilState(IDepthStencilState& depthStencilState) override;
 
   void bindBuffer(int index,
                   uint8_t target,
                   const std::shared_ptr<IBuffer>& buffer,
                   size_t bufferOffset) override;
+  void bindBuffer(int index, uint8_t target, IBuffer& buffer, size_t bufferOffset) override;
   void bindBytes(size_t index, uint8_t bindTarget, const void* data, size_t length) override;
   void bindPushConstants(const void* data, size_t length, size_t offset) override;
+  void bindBufferAddress(size_t offset, IBuffer& buffer, size_t bufferOffset) override;
   void bindSamplerState(size_t index, uint8_t target, ISamplerState* samplerState) override;
   void bindTexture(size_t index, uint8_t target, ITexture* texture) override;
   void bindUniform(const UniformDesc& uniformDesc, const void* data) override;
 
-  void draw(PrimitiveType primitiveType, size_t vertexStart, size_t vertexCount) override;
+  void draw(PrimitiveType primitiveType,
+            size_t vertexStart,
+            size_t vertexCount,
+            uint32_t instanceCount = 1,
+            uint32_t baseInstance = 0) override;
   void drawIndexed(PrimitiveType primitiveType,
                    size_t indexCount,
                    IndexFormat indexFormat,
                    IBuffer& indexBuffer,
-                   size_t indexBufferOffset) override;
+                   size_t indexBufferOffset,
+                   uint32_t instanceCount = 1,
+                   int32_t baseVertex = 0,
+                   uint32_t baseInstance = 0) override;
   void drawIndexedIndirect(PrimitiveType primitiveType,
                            IndexFormat indexFormat,
                            IBuffer& indexBuffer,
@@ -79,11 +102,44 @@ class RenderCommandEncoder final : public IRenderCommandEncoder {
   void setBlendColor(Color color) override;
   void setDepthBias(float depthBias, float slopeScale, float clamp) override;
 
+  void beginOcclusionQuery(uint32_t queryIndex) override;
+  void endOcclusionQuery() override;
+
+  void nextSubpass() override;
+
+  // Executes `commandCount` draws of `commands` starting at `firstCommand`, with the currently
+  // bound pipeline state and buffers
+  void executeIndirectCommands(const IndirectCommandBuffer& commands,
+                               uint32_t firstCommand,
+                               uint32_t commandCount);
+  // Reads the range of draws to execute from a MTLIndirectCommandBufferExecutionRange in
+  // `rangeBuffer`, i.e. written by the compute shader which encoded the draws
+  void executeIndirectCommands(const IndirectCommandBuffer& commands,
+                               IBuffer& rangeBuffer,
+                               size_t rangeBufferOffset);
+
+  // the number of binds which were skipped because they would not change the encoder state
+  [[nodiscard]] uint32_t getNumRedundantBindsSkipped() const {
+    return numRedundantBindsSkipped_;
+  }
+
   static MTLPrimitiveType convertPrimitiveType(PrimitiveType value);
   static MTLIndexType convertIndexType(IndexFormat value);
   static MTLLoadAction convertLoadAction(LoadAction value);
   static MTLStoreAction convertStoreAction(StoreAction value);
+  static MTLMultisampleDepthResolveFilter convertDepthResolveFilter(MsaaDepthResolveFilter value);
   static MTLClearColor convertClearColor(Color value);
+  // returns nil on failure
+  static MTLRenderPassDescriptor* createRenderPassDescriptor(
+      const RenderPassDesc& renderPass,
+      const std::shared_ptr<IFramebuffer>& framebuffer,
+      Result* outResult);
+  // Attaches RenderPassDesc::occlusionQueryPool, if any, to `metalRenderPassDesc` and returns the
+  // visibility result mode to use for it. Disabled if there is no pool.
+  static MTLVisibilityResultMode attachOcclusionQueryPool(
+      const RenderPassDesc& renderPass,
+      MTLRenderPassDescriptor* metalRenderPassDesc,
+      id<MTLCommandBuffer> commandBuffer);
 
  private:
   explicit RenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer);
@@ -95,8 +151,51 @@ class RenderCommandEncoder final : public IRenderCommandEncoder {
   void bindCullMode(const CullMode& cullMode);
   void bindFrontFacingWinding(const WindingMode& frontFaceWinding);
   void bindPolygonFillMode(const PolygonFillMode& polygonFillMode);
+  void useIndexBuffers(const IndirectCommandBuffer& commands);
+
+  enum Stage : uint8_t { kStageVertex = 0, kStageFragment = 1, kNumStages = 2 };
+  void setBuffer(Stage stage, size_t index, id<MTLBuffer> buffer, NSUInteger offset);
+  void setTexture(Stage stage, size_t index, id<MTLTexture> texture);
+  void setSamplerState(Stage stage, size_t index, id<MTLSamplerState> samplerState);
+  // bytes are copied into the encoder, so they never match a cached buffer
+  void invalidateBuffer(Stage stage, size_t index);
+  void invalidateStateCache();
 
   id<MTLRenderCommandEncoder> encoder_ = nil;
+  // waited for when the encoder is created and updated in endEncoding(); see CommandBuffer
+  id<MTLFence> passFence_ = nil;
+
+  // The Metal state set through this encoder. Binds which would not change it are skipped. Only
+  // slots with the corresponding `valid` bit set are known; the rest were never set or were set
+  // outside of the cache, like the bindless table and the commands of indirect command buffers.
+  static constexpr size_t kMaxCachedBuffers = 31;
+  struct BufferBinding {
+    id<MTLBuffer> buffer = nil;
+    NSUInteger offset = 0;
+  };
+  struct StageState {
+    std::array<BufferBinding, kMaxCachedBuffers> buffers;
+    std::array<id<MTLTexture>, IGL_TEXTURE_SAMPLERS_MAX> textures;
+    std::array<id<MTLSamplerState>, IGL_TEXTURE_SAMPLERS_MAX> samplers;
+    uint32_t validBuffers = 0;
+    uint32_t validTextures = 0;
+    uint32_t validSamplers = 0;
+  };
+  std::array<StageState, kNumStages> stageState_;
+  id<MTLRenderPipelineState> pipelineState_ = nil;
+  id<MTLDepthStencilState> depthStencilState_ = nil;
+  MTLCullMode cullMode_ = MTLCullModeNone;
+  MTLWinding frontFacingWinding_ = MTLWindingClockwise;
+  MTLTriangleFillMode triangleFillMode_ = MTLTriangleFillModeFill;
+  // the rasterizer states above are set by the first pipeline bind
+  bool isRasterStateValid_ = false;
+  uint32_t numRedundantBindsSkipped_ = 0;
+
+  // Disabled when the render pass has no occlusion query pool
+  MTLVisibilityResultMode occlusionQueryMode_ = MTLVisibilityResultModeDisabled;
+  bool isOcclusionQueryActive_ = false;
+  std::array<uint8_t, kMaxPushConstantsSize> pushConstants_{};
+  size_t pushConstantsSize_ = 0;
   // 4 KB - page aligned memory for metal managed resource
   static constexpr uint32_t MAX_RECOMMENDED_BYTES = 4 * 1024;
 };
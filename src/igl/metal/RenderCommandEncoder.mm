@@ -9,10 +9,15 @@
 
 #import <Foundation/Foundation.h>
 #import <Metal/Metal.h>
+#include <algorithm>
+#include <cstring>
 #include <igl/RenderPass.h>
+#include <igl/metal/BindlessTable.h>
 #include <igl/metal/Buffer.h>
 #include <igl/metal/DepthStencilState.h>
 #include <igl/metal/Framebuffer.h>
+#include <igl/metal/IndirectCommandBuffer.h>
+#include <igl/metal/OcclusionQueryPool.h>
 #include <igl/metal/RenderPipelineState.h>
 #include <igl/metal/SamplerState.h>
 #include <igl/metal/Texture.h>
@@ -36,10 +41,45 @@ void RenderCommandEncoder::initialize(const std::shared_ptr<CommandBuffer>& comm
                                       const RenderPassDesc& renderPass,
                                       const std::shared_ptr<IFramebuffer>& framebuffer,
                                       Result* outResult) {
+  MTLRenderPassDescriptor* metalRenderPassDesc =
+      createRenderPassDescriptor(renderPass, framebuffer, outResult);
+  if (!metalRenderPassDesc) {
+    return;
+  }
+
+  occlusionQueryMode_ =
+      attachOcclusionQueryPool(renderPass, metalRenderPassDesc, commandBuffer->get());
+  encoder_ = [commandBuffer->get() renderCommandEncoderWithDescriptor:metalRenderPassDesc];
+  passFence_ = commandBuffer->getPassFence();
+  if (passFence_) {
+    [encoder_ waitForFence:passFence_ beforeStages:MTLRenderStageVertex];
+  }
+
+  if (auto* bindlessTable = commandBuffer->getBindlessTable()) {
+    bindlessTable->bind(encoder_, commandBuffer->get());
+  }
+}
+
+MTLVisibilityResultMode RenderCommandEncoder::attachOcclusionQueryPool(
+    const RenderPassDesc& renderPass,
+    MTLRenderPassDescriptor* metalRenderPassDesc,
+    id<MTLCommandBuffer> commandBuffer) {
+  if (!renderPass.occlusionQueryPool) {
+    return MTLVisibilityResultModeDisabled;
+  }
+  auto& pool = static_cast<OcclusionQueryPool&>(*renderPass.occlusionQueryPool);
+  pool.attach(metalRenderPassDesc, commandBuffer);
+  return pool.getVisibilityResultMode();
+}
+
+MTLRenderPassDescriptor* RenderCommandEncoder::createRenderPassDescriptor(
+    const RenderPassDesc& renderPass,
+    const std::shared_ptr<IFramebuffer>& framebuffer,
+    Result* outResult) {
   Result::setOk(outResult);
   if (!IGL_VERIFY(framebuffer)) {
     Result::setResult(outResult, Result::Code::ArgumentNull);
-    return;
+    return nil;
   }
   MTLRenderPassDescriptor* metalRenderPassDesc = [MTLRenderPassDescriptor renderPassDescriptor];
   const FramebufferDesc& desc = static_cast<const Framebuffer&>(*framebuffer).get();
@@ -70,8 +110,7 @@ void RenderCommandEncoder::initialize(const std::shared_ptr<CommandBuffer>& comm
     }
 
     auto& iglResolveTexture = attachment.second.resolveTexture;
-    if (iglResolveTexture &&
-        renderPass.colorAttachments[index].storeAction == igl::StoreAction::MsaaResolve) {
+    if (iglResolveTexture && isMsaaResolve(renderPass.colorAttachments[index].storeAction)) {
       metalColorAttachment.resolveTexture = static_cast<Texture&>(*iglResolveTexture).get();
     }
 
@@ -94,9 +133,11 @@ void RenderCommandEncoder::initialize(const std::shared_ptr<CommandBuffer>& comm
     metalRenderPassDesc.depthAttachment.clearDepth = renderPass.depthAttachment.clearDepth;
 
     if (desc.depthAttachment.resolveTexture &&
-        renderPass.depthAttachment.storeAction == igl::StoreAction::MsaaResolve) {
+        isMsaaResolve(renderPass.depthAttachment.storeAction)) {
       metalRenderPassDesc.depthAttachment.resolveTexture =
           static_cast<Texture&>(*desc.depthAttachment.resolveTexture).get();
+      metalRenderPassDesc.depthAttachment.depthResolveFilter =
+          convertDepthResolveFilter(renderPass.depthAttachment.depthResolveFilter);
     }
   }
 
@@ -111,13 +152,24 @@ void RenderCommandEncoder::initialize(const std::shared_ptr<CommandBuffer>& comm
     metalRenderPassDesc.stencilAttachment.clearStencil = renderPass.stencilAttachment.clearStencil;
 
     if (desc.stencilAttachment.resolveTexture &&
-        renderPass.stencilAttachment.storeAction == igl::StoreAction::MsaaResolve) {
+        isMsaaResolve(renderPass.stencilAttachment.storeAction)) {
       metalRenderPassDesc.stencilAttachment.resolveTexture =
           static_cast<Texture&>(*desc.stencilAttachment.resolveTexture).get();
     }
   }
 
-  encoder_ = [commandBuffer->get() renderCommandEncoderWithDescriptor:metalRenderPassDesc];
+  return metalRenderPassDesc;
+}
+
+std::unique_ptr<RenderCommandEncoder> RenderCommandEncoder::create(
+    const std::shared_ptr<CommandBuffer>& commandBuffer,
+    id<MTLRenderCommandEncoder> encoder,
+    MTLVisibilityResultMode occlusionQueryMode) {
+  IGL_ASSERT(encoder);
+  std::unique_ptr<RenderCommandEncoder> result(new RenderCommandEncoder(commandBuffer));
+  result->encoder_ = encoder;
+  result->occlusionQueryMode_ = occlusionQueryMode;
+  return result;
 }
 
 std::unique_ptr<RenderCommandEncoder> RenderCommandEncoder::create(
@@ -133,6 +185,10 @@ std::unique_ptr<RenderCommandEncoder> RenderCommandEncoder::create(
 void RenderCommandEncoder::endEncoding() {
   // @fb-only
   // @fb-only
+  IGL_ASSERT_MSG(!isOcclusionQueryActive_, "endOcclusionQuery() was not called");
+  if (passFence_) {
+    [encoder_ updateFence:passFence_ afterStages:MTLRenderStageFragment];
+  }
   [encoder_ endEncoding];
   encoder_ = nil;
 }
@@ -187,6 +243,11 @@ void RenderCommandEncoder::bindCullMode(const CullMode& cullMode) {
     mode = MTLCullModeBack;
     break;
   }
+  if (isRasterStateValid_ && mode == cullMode_) {
+    numRedundantBindsSkipped_++;
+    return;
+  }
+  cullMode_ = mode;
   [encoder_ setCullMode:mode];
 }
 
@@ -194,44 +255,73 @@ void RenderCommandEncoder::bindFrontFacingWinding(const WindingMode& frontFaceWi
   IGL_ASSERT(encoder_);
   MTLWinding mode = (frontFaceWinding == WindingMode::Clockwise) ? MTLWindingClockwise
                                                                  : MTLWindingCounterClockwise;
-
+  if (isRasterStateValid_ && mode == frontFacingWinding_) {
+    numRedundantBindsSkipped_++;
+    return;
+  }
+  frontFacingWinding_ = mode;
   [encoder_ setFrontFacingWinding:mode];
 }
 
 void RenderCommandEncoder::bindPolygonFillMode(const PolygonFillMode& polygonFillMode) {
   IGL_ASSERT(encoder_);
 
-  if (polygonFillMode == PolygonFillMode::Fill) {
+  const MTLTriangleFillMode mode = polygonFillMode == PolygonFillMode::Fill
+                                       ? MTLTriangleFillModeFill
+                                       : MTLTriangleFillModeLines;
+  if (isRasterStateValid_ && mode == triangleFillMode_) {
+    numRedundantBindsSkipped_++;
     return;
   }
-
-  [encoder_ setTriangleFillMode:MTLTriangleFillModeLines];
+  triangleFillMode_ = mode;
+  [encoder_ setTriangleFillMode:mode];
 }
 
 void RenderCommandEncoder::bindRenderPipelineState(
     const std::shared_ptr<IRenderPipelineState>& pipelineState) {
   IGL_ASSERT(encoder_);
   IGL_ASSERT(pipelineState);
-  if (!pipelineState) {
-    return;
+  if (pipelineState) {
+    bindRenderPipelineState(*pipelineState);
   }
-  auto& metalPipelineState = static_cast<RenderPipelineState&>(*pipelineState);
+}
+
+void RenderCommandEncoder::bindRenderPipelineState(IRenderPipelineState& pipelineState) {
+  IGL_ASSERT(encoder_);
+  auto& metalPipelineState = static_cast<RenderPipelineState&>(pipelineState);
 
-  [encoder_ setRenderPipelineState:metalPipelineState.get()];
+  if (pipelineState_ == metalPipelineState.get()) {
+    numRedundantBindsSkipped_++;
+  } else {
+    pipelineState_ = metalPipelineState.get();
+    [encoder_ setRenderPipelineState:pipelineState_];
+  }
 
   bindCullMode(metalPipelineState.getCullMode());
   bindFrontFacingWinding(metalPipelineState.getWindingMode());
   bindPolygonFillMode(metalPipelineState.getPolygonFillMode());
+  isRasterStateValid_ = true;
 }
 
 void RenderCommandEncoder::bindDepthStencilState(
     const std::shared_ptr<IDepthStencilState>& depthStencilState) {
   IGL_ASSERT(encoder_);
   if (depthStencilState) {
-    [encoder_ setDepthStencilState:static_cast<DepthStencilState&>(*depthStencilState).get()];
+    bindDepthStencilState(*depthStencilState);
   }
 }
 
+void RenderCommandEncoder::bindDepthStencilState(IDepthStencilState& depthStencilState) {
+  IGL_ASSERT(encoder_);
+  id<MTLDepthStencilState> state = static_cast<DepthStencilState&>(depthStencilState).get();
+  if (state == depthStencilState_) {
+    numRedundantBindsSkipped_++;
+    return;
+  }
+  depthStencilState_ = state;
+  [encoder_ setDepthStencilState:state];
+}
+
 void RenderCommandEncoder::setBlendColor(Color color) {
   [encoder_ setBlendColorRed:color.r green:color.g blue:color.b alpha:color.a];
 }
@@ -241,6 +331,31 @@ void RenderCommandEncoder::setDepthBias(float depthBias, float slopeScale, float
   [encoder_ setDepthBias:depthBias slopeScale:slopeScale clamp:clamp];
 }
 
+void RenderCommandEncoder::beginOcclusionQuery(uint32_t queryIndex) {
+  IGL_ASSERT(encoder_);
+  if (!IGL_VERIFY(occlusionQueryMode_ != MTLVisibilityResultModeDisabled) ||
+      !IGL_VERIFY(!isOcclusionQueryActive_)) {
+    return;
+  }
+  [encoder_ setVisibilityResultMode:occlusionQueryMode_ offset:queryIndex * sizeof(uint64_t)];
+  isOcclusionQueryActive_ = true;
+}
+
+void RenderCommandEncoder::endOcclusionQuery() {
+  IGL_ASSERT(encoder_);
+  if (!IGL_VERIFY(isOcclusionQueryActive_)) {
+    return;
+  }
+  [encoder_ setVisibilityResultMode:MTLVisibilityResultModeDisabled offset:0];
+  isOcclusionQueryActive_ = false;
+}
+
+void RenderCommandEncoder::nextSubpass() {
+  IGL_ASSERT(encoder_);
+  // programmable blending reads the tile memory written by the previous draws, so all the color
+  // attachments stay bound and nothing has to be done between subpasses
+}
+
 void RenderCommandEncoder::setStencilReferenceValue(uint32_t value) {
   IGL_ASSERT(encoder_);
   [encoder_ setStencilReferenceValue:value];
@@ -255,22 +370,116 @@ void RenderCommandEncoder::bindBuffer(int index,
                                       uint8_t bindTarget,
                                       const std::shared_ptr<IBuffer>& buffer,
                                       size_t offset) {
+  if (buffer) {
+    bindBuffer(index, bindTarget, *buffer, offset);
+  }
+}
+
+void RenderCommandEncoder::bindBuffer(int index,
+                                      uint8_t bindTarget,
+                                      IBuffer& buffer,
+                                      size_t offset) {
   IGL_ASSERT(encoder_);
   IGL_ASSERT_MSG(bindTarget == BindTarget::kVertex || bindTarget == BindTarget::kFragment ||
                      bindTarget == BindTarget::kAllGraphics,
                  "Bind target is not valid: %d",
                  bindTarget);
-  if (buffer) {
-    auto& metalBuffer = static_cast<Buffer&>(*buffer);
-    if ((bindTarget & BindTarget::kVertex) != 0) {
-      [encoder_ setVertexBuffer:metalBuffer.get() offset:offset atIndex:index];
+  auto& metalBuffer = static_cast<Buffer&>(buffer);
+  if ((bindTarget & BindTarget::kVertex) != 0) {
+    setBuffer(kStageVertex, index, metalBuffer.get(), metalBuffer.getOffset() + offset);
+  }
+  if ((bindTarget & BindTarget::kFragment) != 0) {
+    setBuffer(kStageFragment, index, metalBuffer.get(), metalBuffer.getOffset() + offset);
+  }
+}
+
+void RenderCommandEncoder::setBuffer(Stage stage,
+                                     size_t index,
+                                     id<MTLBuffer> buffer,
+                                     NSUInteger offset) {
+  StageState& state = stageState_[stage];
+  const bool isCached = index < kMaxCachedBuffers;
+  const uint32_t bit = isCached ? 1u << index : 0;
+  if ((state.validBuffers & bit) != 0 && state.buffers[index].buffer == buffer) {
+    if (state.buffers[index].offset == offset) {
+      numRedundantBindsSkipped_++;
+      return;
     }
-    if ((bindTarget & BindTarget::kFragment) != 0) {
-      [encoder_ setFragmentBuffer:metalBuffer.get() offset:offset atIndex:index];
+    // rebinding only the offset is cheaper, e.g. when drawing from a ring buffer
+    state.buffers[index].offset = offset;
+    if (stage == kStageVertex) {
+      [encoder_ setVertexBufferOffset:offset atIndex:index];
+    } else {
+      [encoder_ setFragmentBufferOffset:offset atIndex:index];
     }
+    return;
+  }
+  if (isCached) {
+    state.buffers[index] = {buffer, offset};
+    state.validBuffers |= bit;
+  }
+  if (stage == kStageVertex) {
+    [encoder_ setVertexBuffer:buffer offset:offset atIndex:index];
+  } else {
+    [encoder_ setFragmentBuffer:buffer offset:offset atIndex:index];
+  }
+}
+
+void RenderCommandEncoder::setTexture(Stage stage, size_t index, id<MTLTexture> texture) {
+  StageState& state = stageState_[stage];
+  const bool isCached = index < state.textures.size();
+  const uint32_t bit = isCached ? 1u << index : 0;
+  if ((state.validTextures & bit) != 0 && state.textures[index] == texture) {
+    numRedundantBindsSkipped_++;
+    return;
+  }
+  if (isCached) {
+    state.textures[index] = texture;
+    state.validTextures |= bit;
+  }
+  if (stage == kStageVertex) {
+    [encoder_ setVertexTexture:texture atIndex:index];
+  } else {
+    [encoder_ setFragmentTexture:texture atIndex:index];
+  }
+}
+
+void RenderCommandEncoder::setSamplerState(Stage stage,
+                                           size_t index,
+                                           id<MTLSamplerState> samplerState) {
+  StageState& state = stageState_[stage];
+  const bool isCached = index < state.samplers.size();
+  const uint32_t bit = isCached ? 1u << index : 0;
+  if ((state.validSamplers & bit) != 0 && state.samplers[index] == samplerState) {
+    numRedundantBindsSkipped_++;
+    return;
+  }
+  if (isCached) {
+    state.samplers[index] = samplerState;
+    state.validSamplers |= bit;
+  }
+  if (stage == kStageVertex) {
+    [encoder_ setVertexSamplerState:samplerState atIndex:index];
+  } else {
+    [encoder_ setFragmentSamplerState:samplerState atIndex:index];
   }
 }
 
+void RenderCommandEncoder::invalidateBuffer(Stage stage, size_t index) {
+  if (index < kMaxCachedBuffers) {
+    StageState& state = stageState_[stage];
+    state.validBuffers &= ~(1u << index);
+    state.buffers[index] = {};
+  }
+}
+
+void RenderCommandEncoder::invalidateStateCache() {
+  stageState_ = {};
+  pipelineState_ = nil;
+  depthStencilState_ = nil;
+  isRasterStateValid_ = false;
+}
+
 void RenderCommandEncoder::bindBytes(size_t index,
                                      uint8_t bindTarget,
                                      const void* data,
@@ -287,18 +496,50 @@ void RenderCommandEncoder::bindBytes(size_t index,
           length);
     }
     if ((bindTarget & BindTarget::kVertex) != 0) {
+      invalidateBuffer(kStageVertex, index);
       [encoder_ setVertexBytes:data length:length atIndex:index];
     }
     if ((bindTarget & BindTarget::kFragment) != 0) {
+      invalidateBuffer(kStageFragment, index);
       [encoder_ setFragmentBytes:data length:length atIndex:index];
     }
   }
 }
 
-void RenderCommandEncoder::bindPushConstants(const void* /*data*/,
-                                             size_t /*length*/,
-                                             size_t /*offset*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+void RenderCommandEncoder::bindPushConstants(const void* data, size_t length, size_t offset) {
+  IGL_ASSERT(encoder_);
+  if (!IGL_VERIFY(data != nullptr) || !IGL_VERIFY(offset + length <= kMaxPushConstantsSize)) {
+    return;
+  }
+  // the whole range is uploaded again, so updating a part of it keeps the rest
+  std::memcpy(pushConstants_.data() + offset, data, length);
+  pushConstantsSize_ = std::max(pushConstantsSize_, offset + length);
+  invalidateBuffer(kStageVertex, kPushConstantsBufferIndex);
+  invalidateBuffer(kStageFragment, kPushConstantsBufferIndex);
+  [encoder_ setVertexBytes:pushConstants_.data()
+                    length:pushConstantsSize_
+                   atIndex:kPushConstantsBufferIndex];
+  [encoder_ setFragmentBytes:pushConstants_.data()
+                      length:pushConstantsSize_
+                     atIndex:kPushConstantsBufferIndex];
+}
+
+void RenderCommandEncoder::bindBufferAddress(size_t offset,
+                                             IBuffer& buffer,
+                                             size_t bufferOffset) {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT_MSG((offset & 7) == 0, "Buffer addresses must be 8 bytes aligned in push constants");
+
+  auto& iglBuffer = static_cast<Buffer&>(buffer);
+  const uint64_t address = iglBuffer.gpuAddress(bufferOffset);
+  bindPushConstants(&address, sizeof(address), offset);
+
+  // Metal does not track resources which are only accessed through their addresses
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    [encoder_ useResource:iglBuffer.get()
+                    usage:MTLResourceUsageRead | MTLResourceUsageWrite
+                   stages:MTLRenderStageVertex | MTLRenderStageFragment];
+  }
 }
 
 void RenderCommandEncoder::bindTexture(size_t index, uint8_t bindTarget, ITexture* texture) {
@@ -312,10 +553,10 @@ void RenderCommandEncoder::bindTexture(size_t index, uint8_t bindTarget, ITextur
   auto metalTexture = iglTexture ? iglTexture->get() : nil;
 
   if ((bindTarget & BindTarget::kVertex) != 0) {
-    [encoder_ setVertexTexture:metalTexture atIndex:index];
+    setTexture(kStageVertex, index, metalTexture);
   }
   if ((bindTarget & BindTarget::kFragment) != 0) {
-    [encoder_ setFragmentTexture:metalTexture atIndex:index];
+    setTexture(kStageFragment, index, metalTexture);
   }
 }
 
@@ -337,38 +578,76 @@ void RenderCommandEncoder::bindSamplerState(size_t index,
   auto* metalSamplerState = static_cast<SamplerState*>(samplerState);
 
   if ((bindTarget & BindTarget::kVertex) != 0) {
-    [encoder_ setVertexSamplerState:metalSamplerState->get() atIndex:index];
+    setSamplerState(kStageVertex, index, metalSamplerState->get());
   }
   if ((bindTarget & BindTarget::kFragment) != 0) {
-    [encoder_ setFragmentSamplerState:metalSamplerState->get() atIndex:index];
+    setSamplerState(kStageFragment, index, metalSamplerState->get());
   }
 }
 
 void RenderCommandEncoder::draw(PrimitiveType primitiveType,
                                 size_t vertexStart,
-                                size_t vertexCount) {
+                                size_t vertexCount,
+                                uint32_t instanceCount,
+                                uint32_t baseInstance) {
+  IGL_PROFILER_FUNCTION();
   getCommandBuffer().incrementCurrentDrawCount();
   IGL_ASSERT(encoder_);
   MTLPrimitiveType metalPrimitive = convertPrimitiveType(primitiveType);
-  [encoder_ drawPrimitives:metalPrimitive vertexStart:vertexStart vertexCount:vertexCount];
+  if (baseInstance != 0) {
+    [encoder_ drawPrimitives:metalPrimitive
+                 vertexStart:vertexStart
+                 vertexCount:vertexCount
+               instanceCount:instanceCount
+                baseInstance:baseInstance];
+  } else if (instanceCount != 1) {
+    [encoder_ drawPrimitives:metalPrimitive
+                 vertexStart:vertexStart
+                 vertexCount:vertexCount
+               instanceCount:instanceCount];
+  } else {
+    [encoder_ drawPrimitives:metalPrimitive vertexStart:vertexStart vertexCount:vertexCount];
+  }
 }
 
 void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
                                        size_t indexCount,
                                        IndexFormat indexFormat,
                                        IBuffer& indexBuffer,
-                                       size_t indexBufferOffset) {
+                                       size_t indexBufferOffset,
+                                       uint32_t instanceCount,
+                                       int32_t baseVertex,
+                                       uint32_t baseInstance) {
+  IGL_PROFILER_FUNCTION();
   getCommandBuffer().incrementCurrentDrawCount();
   IGL_ASSERT(encoder_);
   auto& buffer = (Buffer&)(indexBuffer);
   MTLPrimitiveType metalPrimitive = convertPrimitiveType(primitiveType);
   MTLIndexType indexType = convertIndexType(indexFormat);
 
-  [encoder_ drawIndexedPrimitives:metalPrimitive
-                       indexCount:indexCount
-                        indexType:indexType
-                      indexBuffer:buffer.get()
-                indexBufferOffset:indexBufferOffset];
+  if (baseVertex != 0 || baseInstance != 0) {
+    [encoder_ drawIndexedPrimitives:metalPrimitive
+                         indexCount:indexCount
+                          indexType:indexType
+                        indexBuffer:buffer.get()
+                  indexBufferOffset:buffer.getOffset() + indexBufferOffset
+                      instanceCount:instanceCount
+                         baseVertex:baseVertex
+                       baseInstance:baseInstance];
+  } else if (instanceCount != 1) {
+    [encoder_ drawIndexedPrimitives:metalPrimitive
+                         indexCount:indexCount
+                          indexType:indexType
+                        indexBuffer:buffer.get()
+                  indexBufferOffset:buffer.getOffset() + indexBufferOffset
+                      instanceCount:instanceCount];
+  } else {
+    [encoder_ drawIndexedPrimitives:metalPrimitive
+                         indexCount:indexCount
+                          indexType:indexType
+                        indexBuffer:buffer.get()
+                  indexBufferOffset:buffer.getOffset() + indexBufferOffset];
+  }
 }
 
 void RenderCommandEncoder::drawIndexedIndirect(PrimitiveType primitiveType,
@@ -376,6 +655,7 @@ void RenderCommandEncoder::drawIndexedIndirect(PrimitiveType primitiveType,
                                                IBuffer& indexBuffer,
                                                IBuffer& indirectBuffer,
                                                size_t indirectBufferOffset) {
+  IGL_PROFILER_FUNCTION();
   getCommandBuffer().incrementCurrentDrawCount();
   IGL_ASSERT(encoder_);
   auto& indexBufferRef = (Buffer&)(indexBuffer);
@@ -386,9 +666,9 @@ void RenderCommandEncoder::drawIndexedIndirect(PrimitiveType primitiveType,
   [encoder_ drawIndexedPrimitives:metalPrimitive
                         indexType:indexType
                       indexBuffer:indexBufferRef.get()
-                indexBufferOffset:0
+                indexBufferOffset:indexBufferRef.getOffset()
                    indirectBuffer:indirectBufferRef.get()
-             indirectBufferOffset:indirectBufferOffset];
+             indirectBufferOffset:indirectBufferRef.getOffset() + indirectBufferOffset];
 }
 
 void RenderCommandEncoder::multiDrawIndirect(PrimitiveType primitiveType,
@@ -398,6 +678,7 @@ void RenderCommandEncoder::multiDrawIndirect(PrimitiveType primitiveType,
                                              size_t indirectBufferOffset,
                                              uint32_t drawCount,
                                              uint32_t stride) {
+  IGL_PROFILER_FUNCTION();
   IGL_ASSERT(encoder_);
   stride = stride ? stride : sizeof(MTLDrawPrimitivesIndirectArguments);
   auto& indirectBufferRef = (Buffer&)(indirectBuffer);
@@ -407,7 +688,8 @@ void RenderCommandEncoder::multiDrawIndirect(PrimitiveType primitiveType,
     getCommandBuffer().incrementCurrentDrawCount();
     [encoder_ drawPrimitives:metalPrimitive
               indirectBuffer:indirectBufferRef.get()
-        indirectBufferOffset:indirectBufferOffset + static_cast<size_t>(stride) * drawIndex];
+        indirectBufferOffset:indirectBufferRef.getOffset() + indirectBufferOffset +
+                             static_cast<size_t>(stride) * drawIndex];
   }
 }
 
@@ -422,6 +704,7 @@ void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType primitiveType,
                                                     size_t indirectBufferOffset,
                                                     uint32_t drawCount,
                                                     uint32_t stride) {
+  IGL_PROFILER_FUNCTION();
   IGL_ASSERT(encoder_);
   stride = stride ? stride : sizeof(MTLDrawIndexedPrimitivesIndirectArguments);
   auto& indexBufferRef = (Buffer&)(indexBuffer);
@@ -434,12 +717,62 @@ void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType primitiveType,
     [encoder_ drawIndexedPrimitives:metalPrimitive
                           indexType:indexType
                         indexBuffer:indexBufferRef.get()
-                  indexBufferOffset:0
+                  indexBufferOffset:indexBufferRef.getOffset()
                      indirectBuffer:indirectBufferRef.get()
-               indirectBufferOffset:indirectBufferOffset + static_cast<size_t>(stride) * drawIndex];
+               indirectBufferOffset:indirectBufferRef.getOffset() + indirectBufferOffset +
+                                    static_cast<size_t>(stride) * drawIndex];
+  }
+}
+
+void RenderCommandEncoder::useIndexBuffers(const IndirectCommandBuffer& commands) {
+  const auto& indexBuffers = commands.getIndexBuffers();
+  if (indexBuffers.empty()) {
+    return;
+  }
+  if (@available(macOS 13.0, iOS 16.0, *)) {
+    [encoder_ useResources:indexBuffers.data()
+                     count:indexBuffers.size()
+                     usage:MTLResourceUsageRead
+                    stages:MTLRenderStageVertex];
+  } else {
+    [encoder_ useResources:indexBuffers.data()
+                     count:indexBuffers.size()
+                     usage:MTLResourceUsageRead];
   }
 }
 
+void RenderCommandEncoder::executeIndirectCommands(const IndirectCommandBuffer& commands,
+                                                   uint32_t firstCommand,
+                                                   uint32_t commandCount) {
+  IGL_ASSERT(encoder_);
+  IGL_ASSERT(firstCommand + commandCount <= commands.getMaxCommandCount());
+  for (uint32_t i = 0; i < commandCount; i++) {
+    getCommandBuffer().incrementCurrentDrawCount();
+  }
+  useIndexBuffers(commands);
+  [encoder_ executeCommandsInBuffer:commands.get()
+                          withRange:NSMakeRange(firstCommand, commandCount)];
+  // the commands may set their own pipeline state and buffers
+  invalidateStateCache();
+}
+
+void RenderCommandEncoder::executeIndirectCommands(const IndirectCommandBuffer& commands,
+                                                   IBuffer& rangeBuffer,
+                                                   size_t rangeBufferOffset) {
+  IGL_ASSERT(encoder_);
+  getCommandBuffer().incrementCurrentDrawCount();
+  auto& rangeBufferRef = static_cast<Buffer&>(rangeBuffer);
+  useIndexBuffers(commands);
+  if (@available(macOS 10.14, iOS 13.0, *)) {
+    [encoder_ executeCommandsInBuffer:commands.get()
+                       indirectBuffer:rangeBufferRef.get()
+                 indirectBufferOffset:rangeBufferRef.getOffset() + rangeBufferOffset];
+  } else {
+    IGL_ASSERT_NOT_IMPLEMENTED();
+  }
+  invalidateStateCache();
+}
+
 MTLPrimitiveType RenderCommandEncoder::convertPrimitiveType(PrimitiveType value) {
   switch (value) {
   case PrimitiveType::Point:
@@ -483,6 +816,20 @@ MTLStoreAction RenderCommandEncoder::convertStoreAction(StoreAction value) {
     return MTLStoreActionStore;
   case StoreAction::MsaaResolve:
     return MTLStoreActionMultisampleResolve;
+  case StoreAction::StoreAndMsaaResolve:
+    return MTLStoreActionStoreAndMultisampleResolve;
+  }
+}
+
+MTLMultisampleDepthResolveFilter RenderCommandEncoder::convertDepthResolveFilter(
+    MsaaDepthResolveFilter value) {
+  switch (value) {
+  case MsaaDepthResolveFilter::Sample0:
+    return MTLMultisampleDepthResolveFilterSample0;
+  case MsaaDepthResolveFilter::Min:
+    return MTLMultisampleDepthResolveFilterMin;
+  case MsaaDepthResolveFilter::Max:
+    return MTLMultisampleDepthResolveFilterMax;
   }
 }
 
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace igl {
+namespace metal {
+
+/**
+ * @brief Places small ring buffers (i.e. per-draw constants) side by side into shared pages, so N
+ * ring buffers need one MTLBuffer per in-flight frame and page instead of N per in-flight frame.
+ *
+ * A ring buffer occupies the same range in the MTLBuffers of all frames of its page. Pages are
+ * filled linearly and never reused; the memory of a page is released once every ring buffer
+ * placed into it has been destroyed (they retain the page's MTLBuffers).
+ */
+class RingBufferAllocator final {
+ public:
+  // offsets satisfy the buffer offset alignment of the constant address space on all GPUs
+  static constexpr size_t kAlignment = 256;
+
+  struct Allocation {
+    std::vector<id<MTLBuffer>> buffers; // one per in-flight frame
+    size_t offset = 0;
+  };
+
+  RingBufferAllocator(id<MTLDevice> device,
+                      size_t numFrames,
+                      size_t maxBufferSize,
+                      size_t pageSize);
+
+  // returns false if the buffer is too large or its storage mode cannot be sub-allocated
+  bool allocate(size_t length, MTLResourceOptions options, Allocation& outAllocation);
+
+  size_t getMaxBufferSize() const {
+    return maxBufferSize_;
+  }
+
+ private:
+  struct Page {
+    std::vector<id<MTLBuffer>> buffers;
+    MTLResourceOptions options = 0;
+    size_t offset = 0;
+  };
+
+ private:
+  id<MTLDevice> device_;
+  size_t numFrames_;
+  size_t maxBufferSize_;
+  size_t pageSize_;
+  std::mutex mutex_;
+  std::vector<Page> pages_; // the page currently filled, per resource options
+};
+
+} // namespace metal
+} // namespace igl
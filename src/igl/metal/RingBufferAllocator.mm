@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/RingBufferAllocator.h>
+
+#include <algorithm>
+#include <igl/Common.h>
+
+namespace igl {
+namespace metal {
+
+RingBufferAllocator::RingBufferAllocator(id<MTLDevice> device,
+                                         size_t numFrames,
+                                         size_t maxBufferSize,
+                                         size_t pageSize) :
+  device_(device),
+  numFrames_(numFrames),
+  maxBufferSize_(std::min(maxBufferSize, pageSize)),
+  pageSize_(pageSize) {
+  IGL_ASSERT(numFrames_ > 0);
+}
+
+bool RingBufferAllocator::allocate(size_t length,
+                                   MTLResourceOptions options,
+                                   Allocation& outAllocation) {
+  const MTLResourceOptions storageMode = options & MTLResourceStorageModeMask;
+  // ring buffers are written by the CPU every frame
+  if (length == 0 || length > maxBufferSize_ ||
+      (storageMode != MTLResourceStorageModeShared
+#if IGL_PLATFORM_MACOS
+       && storageMode != MTLResourceStorageModeManaged
+#endif
+       )) {
+    return false;
+  }
+
+  const std::lock_guard<std::mutex> lock(mutex_);
+
+  auto page = std::find_if(
+      pages_.begin(), pages_.end(), [options](const Page& p) { return p.options == options; });
+  if (page == pages_.end()) {
+    page = pages_.insert(pages_.end(), Page{{}, options, 0});
+  }
+  const size_t offset = (page->offset + kAlignment - 1) / kAlignment * kAlignment;
+  if (page->buffers.empty() || offset + length > pageSize_) {
+    // start a new page; the old one lives on in the ring buffers placed into it
+    std::vector<id<MTLBuffer>> buffers;
+    buffers.reserve(numFrames_);
+    for (size_t i = 0; i != numFrames_; i++) {
+      id<MTLBuffer> buffer = [device_ newBufferWithLength:pageSize_ options:options];
+      if (!buffer) {
+        return false;
+      }
+      buffer.label = @"IGL ring buffer page";
+      buffers.push_back(buffer);
+    }
+    page->buffers = std::move(buffers);
+    page->offset = 0;
+  }
+
+  outAllocation.buffers = page->buffers;
+  outAllocation.offset = page->offset == 0 ? 0 : offset;
+  page->offset = outAllocation.offset + length;
+  return true;
+}
+
+} // namespace metal
+} // namespace igl
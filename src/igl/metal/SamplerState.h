@@ -9,23 +9,39 @@
 
 #include <Metal/Metal.h>
 #include <igl/SamplerState.h>
+#include <memory>
+#include <mutex>
 
 namespace igl {
 namespace metal {
 
+class BindlessTable;
+
 class SamplerState final : public ISamplerState {
+  friend class PlatformDevice;
+
  public:
   explicit SamplerState(id<MTLSamplerState> value);
+  ~SamplerState() override;
   IGL_INLINE id<MTLSamplerState> get() const {
     return value_;
   }
 
+  /**
+   * @brief The index of this sampler in the bindless table of the device (see BindlessTable), or
+   * 0 if bindless rendering is not supported.
+   */
+  uint32_t getSamplerId() const;
+
   static MTLSamplerMinMagFilter convertMinMagFilter(SamplerMinMagFilter value);
   static MTLSamplerMipFilter convertMipFilter(SamplerMipFilter value);
   static MTLSamplerAddressMode convertAddressMode(SamplerAddressMode value);
 
  private:
   id<MTLSamplerState> value_;
+  std::shared_ptr<BindlessTable> bindlessTable_;
+  mutable std::once_flag bindlessSlotOnce_;
+  mutable uint32_t bindlessSlot_ = 0;
 };
 
 } // namespace metal
@@ -7,6 +7,8 @@
 
 #include <igl/metal/SamplerState.h>
 
+#include <igl/metal/BindlessTable.h>
+
 using namespace igl;
 
 namespace igl {
@@ -14,6 +16,21 @@ namespace metal {
 
 SamplerState::SamplerState(id<MTLSamplerState> value) : value_(value) {}
 
+SamplerState::~SamplerState() {
+  if (bindlessSlot_) {
+    bindlessTable_->releaseSamplerSlot(bindlessSlot_);
+  }
+}
+
+uint32_t SamplerState::getSamplerId() const {
+  if (!bindlessTable_) {
+    return 0;
+  }
+  std::call_once(bindlessSlotOnce_,
+                 [this]() { bindlessSlot_ = bindlessTable_->acquireSamplerSlot(value_); });
+  return bindlessSlot_;
+}
+
 MTLSamplerMinMagFilter SamplerState::convertMinMagFilter(SamplerMinMagFilter value) {
   switch (value) {
   case SamplerMinMagFilter::Nearest:
@@ -12,6 +12,9 @@
 #include <igl/Macros.h>
 #include <igl/Texture.h>
 #include <igl/metal/CommandQueue.h>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #if IGL_PLATFORM_APPLE
 NS_ASSUME_NONNULL_BEGIN
@@ -19,6 +22,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 namespace igl {
 namespace metal {
+class BindlessTable;
 class PlatformDevice;
 
 class Texture final : public ITexture {
@@ -27,6 +31,8 @@ class Texture final : public ITexture {
 
  public:
   Texture(id<MTLTexture> texture, const ICapabilities& capabilities);
+  // for textures whose uploads are converted from `format`, see getUploadConversionFormat()
+  Texture(id<MTLTexture> texture, const ICapabilities& capabilities, TextureFormat format);
   Texture(id<CAMetalDrawable> drawable, const ICapabilities& capabilities);
   ~Texture() override;
 
@@ -51,6 +57,9 @@ class Texture final : public ITexture {
   void generateMipmap(ICommandBuffer& cmdBuffer) const override;
   bool isRequiredGenerateMipmap() const override;
   uint64_t getTextureId() const override;
+  std::shared_ptr<IReadback> readAsync(ICommandQueue& cmdQueue,
+                                       const TextureRangeDesc& range,
+                                       Result* outResult) const override;
 
   IGL_INLINE id<MTLTexture> _Nullable get() const {
     return (drawable_) ? drawable_.texture : value_;
@@ -63,6 +72,10 @@ class Texture final : public ITexture {
   static MTLTextureUsage toMTLTextureUsage(TextureDesc::TextureUsage usage);
 
   static MTLPixelFormat textureFormatToMTLPixelFormat(TextureFormat value);
+  // The format textures of `format` are stored in when Metal has no equivalent, e.g. RGBA_UNorm8
+  // for 24-bit RGBX_UNorm8. Uploads are converted with igl::convertTexels(); luminance formats are
+  // rebuilt by the swizzle of the texture. Invalid when `format` is stored as it is.
+  static TextureFormat getUploadConversionFormat(TextureFormat format);
   static TextureFormat mtlPixelFormatToTextureFormat(MTLPixelFormat value);
   static MTLTextureType convertType(TextureType value, size_t numSamples);
   static TextureType convertType(MTLTextureType value);
@@ -73,10 +86,23 @@ class Texture final : public ITexture {
   // Given bytes per row of an input texture, return bytesPerRow value
   // accepted by Texture::upload and MTL replaceRegion.
   size_t toMetalBytesPerRow(size_t bytesPerRow) const;
+  // Converts `numRows` rows of `width` texels into `uploadFormat_`. Returns the converted rows and
+  // sets `bytesPerRow` to their size.
+  const void* convertUpload(const void* data,
+                            size_t& bytesPerRow,
+                            size_t width,
+                            size_t numRows,
+                            std::vector<uint8_t>& outData) const;
 
   id<MTLTexture> _Nullable value_;
   id<CAMetalDrawable> _Nullable drawable_;
   const ICapabilities& capabilities_;
+  // the slot in the bindless table is acquired on the first getTextureId() call
+  std::shared_ptr<BindlessTable> bindlessTable_;
+  mutable std::once_flag bindlessSlotOnce_;
+  mutable uint32_t bindlessSlot_ = 0;
+  // the format the texture stores when it differs from getFormat()
+  TextureFormat uploadFormat_ = TextureFormat::Invalid;
 };
 
 } // namespace metal
@@ -7,19 +7,14 @@
 
 #include <igl/metal/Texture.h>
 
+#include <igl/TextureConversion.h>
+#include <igl/metal/BindlessTable.h>
 #include <igl/metal/CommandBuffer.h>
+#include <igl/metal/Readback.h>
 #include <vector>
 
 namespace {
 
-/// Metal textures are up-side down compared to OGL textures. IGL follows
-/// the OGL convention and this function flips the texture vertically
-void flipBMP(unsigned char* dstImg, unsigned char* srcImg, size_t height, size_t bytesPerRow) {
-  for (size_t h = 0; h < height; h++) {
-    memcpy(dstImg + h * bytesPerRow, srcImg + bytesPerRow * (height - 1 - h), bytesPerRow);
-  }
-}
-
 void bgrToRgb(unsigned char* dstImg, size_t width, size_t height, size_t bytesPerPixel) {
   for (int i = 0; i < height; ++i) {
     for (int j = 0; j < width; ++j) {
@@ -39,6 +34,15 @@ Texture::Texture(id<MTLTexture> texture, const ICapabilities& capabilities) :
   drawable_(nullptr),
   capabilities_(capabilities) {}
 
+Texture::Texture(id<MTLTexture> texture,
+                 const ICapabilities& capabilities,
+                 TextureFormat format) :
+  ITexture(format),
+  value_(texture),
+  drawable_(nullptr),
+  capabilities_(capabilities),
+  uploadFormat_(mtlPixelFormatToTextureFormat([texture pixelFormat])) {}
+
 Texture::Texture(id<CAMetalDrawable> drawable, const ICapabilities& capabilities) :
   ITexture(mtlPixelFormatToTextureFormat([drawable.texture pixelFormat])),
   value_(nullptr),
@@ -46,10 +50,14 @@ Texture::Texture(id<CAMetalDrawable> drawable, const ICapabilities& capabilities
   capabilities_(capabilities) {}
 
 Texture::~Texture() {
+  if (bindlessSlot_) {
+    bindlessTable_->releaseTextureSlot(bindlessSlot_);
+  }
   value_ = nil;
 }
 
 Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t bytesPerRow) const {
+  IGL_PROFILER_FUNCTION();
   if (range.numMipLevels > 1) {
     IGL_ASSERT_NOT_IMPLEMENTED();
     return Result(Result::Code::Unimplemented,
@@ -67,7 +75,14 @@ Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t b
   }
   const auto numLayers = std::max(range.numLayers, static_cast<size_t>(1));
   const auto byteIncrement = numLayers > 1 ? getProperties().getBytesPerLayer(range.atLayer(0)) : 0;
+  std::vector<uint8_t> convertedData;
   for (auto i = 0; i < numLayers; ++i) {
+    size_t uploadBytesPerRow = bytesPerRow;
+    const void* uploadData =
+        uploadFormat_ != TextureFormat::Invalid
+            ? convertUpload(
+                  data, uploadBytesPerRow, range.width, range.height * range.depth, convertedData)
+            : data;
     MTLRegion region;
     switch (getType()) {
     case TextureType::TwoD:
@@ -76,8 +91,8 @@ Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t b
       [get() replaceRegion:region
                mipmapLevel:range.mipLevel
                      slice:range.layer + i
-                 withBytes:data
-               bytesPerRow:toMetalBytesPerRow(bytesPerRow)
+                 withBytes:uploadData
+               bytesPerRow:toMetalBytesPerRow(uploadBytesPerRow)
              bytesPerImage:0];
       break;
     case TextureType::ThreeD:
@@ -85,9 +100,9 @@ Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t b
       [get() replaceRegion:region
                mipmapLevel:range.mipLevel
                      slice:0 /* 3D array textures not supported */
-                 withBytes:data
-               bytesPerRow:toMetalBytesPerRow(bytesPerRow)
-             bytesPerImage:toMetalBytesPerRow(bytesPerRow * range.height)];
+                 withBytes:uploadData
+               bytesPerRow:toMetalBytesPerRow(uploadBytesPerRow)
+             bytesPerImage:toMetalBytesPerRow(uploadBytesPerRow * range.height)];
       break;
     default:
       IGL_ASSERT(false && "Unknown texture type");
@@ -109,18 +124,22 @@ Result Texture::getBytes(const TextureRangeDesc& range, void* outData, size_t by
         "Can't retrieve the data from private memory; use a blit command encoder instead");
   }
 
-  size_t bytesPerImage = getProperties().getBytesPerRange(range);
-  MTLRegion region = {{range.x, range.y, 0}, {range.width, range.height, 1}};
-  auto tmpBuffer = std::vector<uint8_t>(bytesPerImage);
-
-  [get() getBytes:tmpBuffer.data()
-        bytesPerRow:bytesPerRow
-      bytesPerImage:bytesPerImage
-         fromRegion:region
-        mipmapLevel:range.mipLevel
-              slice:range.layer];
+  if (bytesPerRow == 0) {
+    bytesPerRow = getProperties().getBytesPerRow(range);
+  }
 
-  flipBMP(static_cast<unsigned char*>(outData), tmpBuffer.data(), range.height, bytesPerRow);
+  // Metal textures are up-side down compared to OGL textures. IGL follows the OGL convention:
+  // read the rows bottom-up straight into `outData` instead of flipping a temporary copy
+  auto* dst = static_cast<unsigned char*>(outData);
+  for (size_t h = 0; h < range.height; h++) {
+    const MTLRegion row = {{range.x, range.y + h, 0}, {range.width, 1, 1}};
+    [get() getBytes:dst + bytesPerRow * (range.height - 1 - h)
+          bytesPerRow:bytesPerRow
+        bytesPerImage:bytesPerRow
+           fromRegion:row
+          mipmapLevel:range.mipLevel
+                slice:range.layer];
+  }
 
   igl::TextureFormat f = getFormat();
   TextureFormatProperties props = TextureFormatProperties::fromTextureFormat(f);
@@ -131,6 +150,27 @@ Result Texture::getBytes(const TextureRangeDesc& range, void* outData, size_t by
   return Result(Result::Code::Ok);
 }
 
+const void* Texture::convertUpload(const void* data,
+                                   size_t& bytesPerRow,
+                                   size_t width,
+                                   size_t numRows,
+                                   std::vector<uint8_t>& outData) const {
+  // replaceRegion copies from CPU memory, so the rows are converted into a temporary buffer
+  const size_t convertedBytesPerRow =
+      TextureFormatProperties::fromTextureFormat(uploadFormat_).getBytesPerRow(width);
+  outData.resize(convertedBytesPerRow * numRows);
+  convertTexels(getFormat(),
+                data,
+                bytesPerRow,
+                uploadFormat_,
+                outData.data(),
+                convertedBytesPerRow,
+                width,
+                numRows);
+  bytesPerRow = convertedBytesPerRow;
+  return outData.data();
+}
+
 size_t Texture::toMetalBytesPerRow(size_t bytesPerRow) const {
   switch (getFormat()) {
   case TextureFormat::RGBA_PVRTC_2BPPV1:
@@ -147,6 +187,7 @@ Result Texture::uploadCube(const TextureRangeDesc& range,
                            TextureCubeFace face,
                            const void* data,
                            size_t bytesPerRow) const {
+  IGL_PROFILER_FUNCTION();
   if (getType() != TextureType::Cube) {
     IGL_ASSERT_NOT_IMPLEMENTED();
     return Result(Result::Code::Unsupported);
@@ -164,6 +205,10 @@ Result Texture::uploadCube(const TextureRangeDesc& range,
     bytesPerRow = getProperties().getBytesPerRow(range);
   }
   if (data) {
+    std::vector<uint8_t> convertedData;
+    if (uploadFormat_ != TextureFormat::Invalid) {
+      data = convertUpload(data, bytesPerRow, range.width, range.height, convertedData);
+    }
     MTLRegion region = MTLRegionMake2D(range.x, range.y, range.width, range.height);
     int layer = static_cast<int>(face);
     [get() replaceRegion:region
@@ -240,9 +285,42 @@ bool Texture::isRequiredGenerateMipmap() const {
 }
 
 uint64_t Texture::getTextureId() const {
-  // TODO: implement via gpuResourceID
-  IGL_ASSERT_NOT_IMPLEMENTED();
-  return 0;
+  // drawables change every frame and are not put into the bindless table
+  if (!bindlessTable_ || !value_) {
+    return 0;
+  }
+  std::call_once(bindlessSlotOnce_,
+                 [this]() { bindlessSlot_ = bindlessTable_->acquireTextureSlot(value_); });
+  return bindlessSlot_;
+}
+
+std::shared_ptr<IReadback> Texture::readAsync(ICommandQueue& cmdQueue,
+                                              const TextureRangeDesc& range,
+                                              Result* outResult) const {
+  const auto rangeResult = validateRange(range);
+  if (!rangeResult.isOk()) {
+    Result::setResult(outResult, rangeResult);
+    return nullptr;
+  }
+  if (range.numLayers != 1 || range.numMipLevels != 1 || range.depth != 1) {
+    Result::setResult(outResult,
+                      Result::Code::ArgumentInvalid,
+                      "Readbacks cover one 2D region of one layer and mip level");
+    return nullptr;
+  }
+  id<MTLTexture> texture = get();
+  if (!texture || getProperties().isDepthOrStencil() || getProperties().isCompressed() ||
+      texture.storageMode == MTLStorageModeMemoryless || texture.framebufferOnly) {
+    Result::setResult(outResult, Result::Code::Unsupported, "The texture cannot be read back");
+    return nullptr;
+  }
+
+  return Readback::create(static_cast<CommandQueue&>(cmdQueue).get(),
+                          texture,
+                          range,
+                          getProperties().getBytesPerRow(range),
+                          getProperties().getBytesPerRange(range),
+                          outResult);
 }
 
 TextureDesc::TextureUsage Texture::toTextureUsage(MTLTextureUsage usage) {
@@ -308,6 +386,26 @@ TextureType Texture::convertType(MTLTextureType value) {
   }
 }
 
+TextureFormat Texture::getUploadConversionFormat(TextureFormat format) {
+  switch (format) {
+  case TextureFormat::RGBX_UNorm8:
+    return TextureFormat::RGBA_UNorm8;
+  case TextureFormat::RGB_F16:
+    return TextureFormat::RGBA_F16;
+  case TextureFormat::RGB_F32:
+    return TextureFormat::RGBA_F32;
+  case TextureFormat::L_UNorm8:
+  case TextureFormat::LA_UNorm8:
+    if (@available(macOS 10.15, iOS 13.0, *)) {
+      return format == TextureFormat::L_UNorm8 ? TextureFormat::R_UNorm8
+                                               : TextureFormat::RG_UNorm8;
+    }
+    return TextureFormat::Invalid;
+  default:
+    return TextureFormat::Invalid;
+  }
+}
+
 MTLPixelFormat Texture::textureFormatToMTLPixelFormat(TextureFormat value) {
   switch (value) {
   case TextureFormat::Invalid:
@@ -712,6 +810,11 @@ MTLPixelFormat Texture::textureFormatToMTLPixelFormat(TextureFormat value) {
     return MTLPixelFormatDepth32Float_Stencil8;
   case TextureFormat::S_UInt8:
     return MTLPixelFormatStencil8;
+
+  // Multi-planar formats are sampled through per-plane textures
+  case TextureFormat::YUV_NV12:
+  case TextureFormat::YUV_P010:
+    return MTLPixelFormatInvalid;
   }
 }
 
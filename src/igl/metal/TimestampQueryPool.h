@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <Metal/Metal.h>
+#include <atomic>
+#include <igl/TimestampQueryPool.h>
+#include <memory>
+#include <vector>
+
+namespace igl {
+namespace metal {
+
+// Timestamps are sampled into an MTLCounterSampleBuffer of the MTLCommonCounterSetTimestamp set at
+// the end of an empty compute pass. GPU ticks are converted to nanoseconds on the CPU timeline by
+// correlating them with pairs of CPU/GPU timestamps taken through -[MTLDevice sampleTimestamps:].
+class API_AVAILABLE(macos(11.0), ios(14.0)) TimestampQueryPool final : public ITimestampQueryPool {
+ public:
+  TimestampQueryPool(id<MTLDevice> device, id<MTLCounterSampleBuffer> sampleBuffer, uint32_t count);
+  ~TimestampQueryPool() override = default;
+
+  [[nodiscard]] uint32_t getCount() const override {
+    return count_;
+  }
+  bool getResults(uint32_t firstQuery, uint32_t queryCount, uint64_t* outTimestampsNs) override;
+
+  void writeTimestamp(id<MTLCommandBuffer> commandBuffer, uint32_t queryIndex);
+
+ private:
+  // Shared with the completion handlers of the command buffers writing the timestamps
+  struct State {
+    explicit State(uint32_t count) : available(count) {}
+    std::vector<std::atomic<bool>> available;
+  };
+
+  id<MTLDevice> device_;
+  id<MTLCounterSampleBuffer> sampleBuffer_;
+  uint32_t count_ = 0;
+  std::shared_ptr<State> state_;
+
+  MTLTimestamp cpuStart_ = 0;
+  MTLTimestamp gpuStart_ = 0;
+};
+
+} // namespace metal
+} // namespace igl
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/metal/TimestampQueryPool.h>
+
+namespace igl {
+namespace metal {
+
+TimestampQueryPool::TimestampQueryPool(id<MTLDevice> device,
+                                       id<MTLCounterSampleBuffer> sampleBuffer,
+                                       uint32_t count) :
+  device_(device),
+  sampleBuffer_(sampleBuffer),
+  count_(count),
+  state_(std::make_shared<State>(count)) {
+  [device_ sampleTimestamps:&cpuStart_ gpuTimestamp:&gpuStart_];
+}
+
+void TimestampQueryPool::writeTimestamp(id<MTLCommandBuffer> commandBuffer, uint32_t queryIndex) {
+  IGL_ASSERT(queryIndex < count_);
+
+  state_->available[queryIndex] = false;
+
+  MTLComputePassDescriptor* passDesc = [MTLComputePassDescriptor computePassDescriptor];
+  passDesc.sampleBufferAttachments[0].sampleBuffer = sampleBuffer_;
+  passDesc.sampleBufferAttachments[0].startOfEncoderSampleIndex = MTLCounterDontSample;
+  passDesc.sampleBufferAttachments[0].endOfEncoderSampleIndex = queryIndex;
+  id<MTLComputeCommandEncoder> encoder =
+      [commandBuffer computeCommandEncoderWithDescriptor:passDesc];
+  [encoder endEncoding];
+
+  auto state = state_;
+  [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> /*buffer*/) {
+    state->available[queryIndex] = true;
+  }];
+}
+
+bool TimestampQueryPool::getResults(uint32_t firstQuery,
+                                    uint32_t queryCount,
+                                    uint64_t* outTimestampsNs) {
+  if (!IGL_VERIFY(static_cast<uint64_t>(firstQuery) + queryCount <= count_) ||
+      !IGL_VERIFY(outTimestampsNs != nullptr)) {
+    return false;
+  }
+  if (queryCount == 0) {
+    return true;
+  }
+  for (uint32_t i = 0; i < queryCount; ++i) {
+    if (!state_->available[firstQuery + i]) {
+      return false;
+    }
+  }
+
+  NSData* data = [sampleBuffer_ resolveCounterRange:NSMakeRange(firstQuery, queryCount)];
+  if (data == nil || data.length < queryCount * sizeof(MTLCounterResultTimestamp)) {
+    return false;
+  }
+
+  MTLTimestamp cpuNow = 0;
+  MTLTimestamp gpuNow = 0;
+  [device_ sampleTimestamps:&cpuNow gpuTimestamp:&gpuNow];
+  const double nsPerTick = gpuNow > gpuStart_
+                               ? static_cast<double>(cpuNow - cpuStart_) / (gpuNow - gpuStart_)
+                               : 1.0;
+
+  const auto* results = static_cast<const MTLCounterResultTimestamp*>(data.bytes);
+  for (uint32_t i = 0; i < queryCount; ++i) {
+    const uint64_t gpuTimestamp = results[i].timestamp;
+    if (gpuTimestamp == MTLCounterErrorValue) {
+      return false;
+    }
+    const double ticks = static_cast<double>(gpuTimestamp) - static_cast<double>(gpuStart_);
+    outTimestampsNs[i] = static_cast<uint64_t>(static_cast<double>(cpuStart_) + ticks * nsPerTick);
+  }
+  return true;
+}
+
+} // namespace metal
+} // namespace igl
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/AsyncUploader.h>
+
+#include <igl/opengl/Fence.h>
+#include <igl/opengl/IContext.h>
+#include <igl/opengl/WithContext.h>
+
+namespace igl::opengl {
+
+AsyncUploader::AsyncUploader(std::unique_ptr<IContext> uploadContext) :
+  uploadContext_(std::move(uploadContext)),
+  worker_(std::make_unique<WorkerPool>(1, "IGL GL upload")) {
+  IGL_ASSERT(uploadContext_);
+  worker_->enqueue([this]() { uploadContext_->setCurrent(); });
+}
+
+AsyncUploader::~AsyncUploader() {
+  // the remaining uploads still run, then the worker is joined
+  worker_->enqueue([this]() { uploadContext_->clearCurrentContext(); });
+  worker_.reset();
+}
+
+std::future<Result> AsyncUploader::upload(std::shared_ptr<ITexture> texture,
+                                          const TextureRangeDesc& range,
+                                          const void* IGL_NULLABLE data,
+                                          size_t bytesPerRow) {
+  if (!texture) {
+    std::promise<Result> promise;
+    promise.set_value(Result(Result::Code::ArgumentNull, "texture is null"));
+    return promise.get_future();
+  }
+  if (bytesPerRow != 0 && range.numMipLevels > 1) {
+    std::promise<Result> promise;
+    promise.set_value(Result(Result::Code::ArgumentInvalid,
+                             "bytesPerRow is only supported for a single mip level"));
+    return promise.get_future();
+  }
+
+  std::vector<uint8_t> copy;
+  if (data) {
+    const auto properties = texture->getProperties();
+    const size_t size =
+        bytesPerRow == 0
+            ? properties.getBytesPerRange(range)
+            : bytesPerRow * properties.getRows(range) * range.depth * range.numLayers;
+    copy.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+  }
+
+  return enqueue(
+      [texture = std::move(texture), range, copy = std::move(copy), data, bytesPerRow]() {
+        return texture->upload(range, data ? copy.data() : nullptr, bytesPerRow);
+      });
+}
+
+std::future<Result> AsyncUploader::upload(std::shared_ptr<IBuffer> buffer,
+                                          const void* IGL_NULLABLE data,
+                                          const BufferRange& range) {
+  if (!buffer || !data) {
+    std::promise<Result> promise;
+    promise.set_value(Result(Result::Code::ArgumentNull, "buffer or data is null"));
+    return promise.get_future();
+  }
+
+  std::vector<uint8_t> copy(static_cast<const uint8_t*>(data),
+                            static_cast<const uint8_t*>(data) + range.size);
+
+  return enqueue([buffer = std::move(buffer), range, copy = std::move(copy)]() {
+    return buffer->upload(copy.data(), range);
+  });
+}
+
+std::future<Result> AsyncUploader::enqueue(std::function<Result()> upload) {
+  auto promise = std::make_shared<std::promise<Result>>();
+  auto future = promise->get_future();
+
+  numPending_.fetch_add(1, std::memory_order_relaxed);
+  numQueued_.fetch_add(1, std::memory_order_acq_rel);
+  worker_->enqueue([this, promise = std::move(promise), upload = std::move(upload)]() {
+    Result result;
+    {
+      const WithContext::ScopedContextOverride scope(*uploadContext_);
+      result = upload();
+    }
+    unfenced_.emplace_back(promise, std::move(result));
+    // one fence for everything which was queued back to back
+    if (numQueued_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      fenceAndResolve();
+    }
+  });
+
+  return future;
+}
+
+void AsyncUploader::fenceAndResolve() {
+  IContext& context = *uploadContext_;
+  const auto& features = context.deviceFeatures();
+  const bool hasSync = features.hasInternalRequirement(InternalRequirement::SyncExtReq)
+                           ? features.hasExtension(Extensions::Sync)
+                           : features.hasInternalFeature(InternalFeatures::Sync);
+
+  GLsync sync = hasSync ? context.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) : nullptr;
+  if (sync) {
+    const Fence fence(context, sync);
+    fence.waitUntilSignaled();
+  } else {
+    context.finish();
+  }
+
+  for (auto& [promise, result] : unfenced_) {
+    numPending_.fetch_sub(1, std::memory_order_relaxed);
+    promise->set_value(std::move(result));
+  }
+  unfenced_.clear();
+}
+
+} // namespace igl::opengl
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <future>
+#include <igl/Buffer.h>
+#include <igl/Texture.h>
+#include <igl/WorkerPool.h>
+#include <memory>
+#include <vector>
+
+namespace igl::opengl {
+class IContext;
+
+/**
+ * @brief Uploads texture and buffer data on a worker thread which owns its own context in the
+ * sharegroup of the render context, so loading resources does not stall rendering on GL-only
+ * devices.
+ *
+ * Uploads run the regular ITexture::upload() and IBuffer::upload() code with the worker context
+ * (see WithContext::ScopedContextOverride). Once the queue runs empty, the worker inserts a
+ * glFenceSync() and waits for it, then fulfills the futures of all uploads since the previous
+ * fence. A ready future therefore means the data is in GPU memory and visible to every context of
+ * the sharegroup. Without sync objects the worker falls back to glFinish().
+ *
+ * The uploaded resource must not be used by the render thread until its future is ready, and must
+ * not be destroyed before then either (the uploader keeps a reference to it).
+ */
+class AsyncUploader final {
+ public:
+  /// `uploadContext` must share objects with the contexts of the uploaded resources and must not
+  /// be current on any thread, e.g. a context created with egl::Context::createShareContext() or
+  /// macos::Context::createShareContext() whose creating thread made its own context current again.
+  explicit AsyncUploader(std::unique_ptr<IContext> uploadContext);
+  ~AsyncUploader();
+
+  AsyncUploader(const AsyncUploader&) = delete;
+  AsyncUploader& operator=(const AsyncUploader&) = delete;
+
+  /// Same as ITexture::upload(). `data` is copied before this returns. `bytesPerRow` other than 0
+  /// is only supported for a single mip level.
+  std::future<Result> upload(std::shared_ptr<ITexture> texture,
+                             const TextureRangeDesc& range,
+                             const void* IGL_NULLABLE data,
+                             size_t bytesPerRow = 0);
+
+  /// Same as IBuffer::upload(). `data` is copied before this returns.
+  std::future<Result> upload(std::shared_ptr<IBuffer> buffer,
+                             const void* IGL_NULLABLE data,
+                             const BufferRange& range);
+
+  /// Number of uploads whose futures are not ready yet
+  [[nodiscard]] uint32_t getNumPendingUploads() const {
+    return numPending_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  using Promise = std::shared_ptr<std::promise<Result>>;
+
+  std::future<Result> enqueue(std::function<Result()> upload);
+  // runs on the worker thread
+  void fenceAndResolve();
+
+ private:
+  std::unique_ptr<IContext> uploadContext_;
+  std::unique_ptr<WorkerPool> worker_;
+  std::atomic<uint32_t> numPending_ = 0;
+  std::atomic<uint32_t> numQueued_ = 0;
+  // uploads which ran since the last fence; only accessed on the worker thread
+  std::vector<std::pair<Promise, Result>> unfenced_;
+};
+
+} // namespace igl::opengl
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/BindlessTable.h>
+
+#include <igl/opengl/IContext.h>
+
+namespace igl::opengl {
+
+uint32_t BindlessTable::acquireTextureSlot(IContext& context, GLuint64 handle) {
+  if (buffer_ == 0) {
+    context.genBuffers(1, &buffer_);
+    if (!IGL_VERIFY(buffer_ != 0)) {
+      return 0;
+    }
+    // unused slots hold null handles
+    const std::vector<GLuint64> handles(kMaxTextures, 0);
+    context.bindBuffer(GL_SHADER_STORAGE_BUFFER, buffer_);
+    context.bufferData(GL_SHADER_STORAGE_BUFFER,
+                       sizeof(GLuint64) * kMaxTextures,
+                       handles.data(),
+                       GL_DYNAMIC_DRAW);
+  }
+
+  uint32_t slot = 0;
+  if (!freeSlots_.empty()) {
+    slot = freeSlots_.back();
+    freeSlots_.pop_back();
+  } else if (nextSlot_ < kMaxTextures) {
+    slot = nextSlot_++;
+  } else {
+    IGL_LOG_ERROR_ONCE("The bindless texture table is full (%u textures)\n", kMaxTextures);
+    return 0;
+  }
+  write(context, slot, handle);
+  return slot;
+}
+
+void BindlessTable::releaseTextureSlot(IContext& context, uint32_t slot) {
+  if (slot == 0 || !IGL_VERIFY(slot < nextSlot_)) {
+    return;
+  }
+  // commands issued before this point still see the old handle
+  write(context, slot, 0);
+  freeSlots_.push_back(slot);
+}
+
+void BindlessTable::write(IContext& context, uint32_t slot, GLuint64 handle) {
+  const auto offset = static_cast<GLintptr>(sizeof(GLuint64) * slot);
+  if (context.deviceFeatures().hasInternalFeature(InternalFeatures::DirectStateAccess)) {
+    context.namedBufferSubData(buffer_, offset, sizeof(handle), &handle);
+  } else {
+    context.bindBuffer(GL_SHADER_STORAGE_BUFFER, buffer_);
+    context.bufferSubData(GL_SHADER_STORAGE_BUFFER, offset, sizeof(handle), &handle);
+  }
+}
+
+void BindlessTable::bind(IContext& context) {
+  if (buffer_ != 0) {
+    context.bindBufferBase(GL_SHADER_STORAGE_BUFFER, kBufferIndex, buffer_);
+  }
+}
+
+void BindlessTable::clear(IContext& context) {
+  if (buffer_ != 0) {
+    context.deleteBuffers(1, &buffer_);
+  }
+  buffer_ = 0;
+  nextSlot_ = 1;
+  freeSlots_.clear();
+}
+
+} // namespace igl::opengl
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/opengl/GLIncludes.h>
+#include <vector>
+
+namespace igl::opengl {
+class IContext;
+
+/// The bindless texture table of a context (ARB_bindless_texture), mirroring the bindless
+/// descriptor set of the Vulkan backend and metal::BindlessTable.
+///
+/// Textures get a slot on the first call to ITexture::getTextureId(): their handle is made resident
+/// and written into a GL_SHADER_STORAGE_BUFFER which every render command encoder binds at
+/// kBufferIndex, so draws only pass indices. Fragment shaders access the table as:
+///
+///   #extension GL_ARB_bindless_texture : require
+///   layout(std430, binding = 7) readonly buffer BindlessTextures {
+///     uvec2 kTextureHandles[];
+///   };
+///   vec4 textureBindless2D(uint textureId, vec2 uv) {
+///     return texture(sampler2D(kTextureHandles[textureId]), uv);
+///   }
+///
+/// Slot 0 is never used. OpenGL executes commands in order, so slots are reused right away.
+///
+/// Buffers are not shared between contexts, so each IContext owns one table.
+class BindlessTable final {
+ public:
+  static constexpr uint32_t kMaxTextures = 4096;
+  static constexpr GLuint kBufferIndex = 7;
+
+  /// Returns 0 if the table is full
+  uint32_t acquireTextureSlot(IContext& context, GLuint64 handle);
+  void releaseTextureSlot(IContext& context, uint32_t slot);
+
+  /// Binds the table at kBufferIndex. Does nothing until a slot has been acquired.
+  void bind(IContext& context);
+  void clear(IContext& context);
+
+ private:
+  void write(IContext& context, uint32_t slot, GLuint64 handle);
+
+  GLuint buffer_ = 0;
+  uint32_t nextSlot_ = 1;
+  std::vector<uint32_t> freeSlots_;
+};
+
+} // namespace igl::opengl
@@ -11,9 +11,18 @@
 #include <igl/Device.h>
 #include <igl/opengl/Errors.h>
 
+#include <cstring>
+
 namespace igl {
 namespace opengl {
 
+namespace {
+constexpr GLbitfield kRingBufferMapFlags =
+    GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+// glClientWaitSync() timeout in nanoseconds; waiting is retried until the fence is signaled
+constexpr GLuint64 kRingBufferWaitTimeout = 1000000000ull;
+} // namespace
+
 // ********************************
 // ****  ArrayBuffer
 // ********************************
@@ -26,6 +35,17 @@ ArrayBuffer::ArrayBuffer(IContext& context, BufferDesc::BufferAPIHint requestedA
 }
 
 ArrayBuffer::~ArrayBuffer() {
+  for (GLsync fence : ringFences_) {
+    if (fence != nullptr) {
+      getContext().deleteSync(fence);
+    }
+  }
+  if (!ringIds_.empty()) {
+    // deleting a buffer implicitly unmaps it
+    getContext().deleteBuffers(static_cast<GLsizei>(ringIds_.size()), ringIds_.data());
+    getContext().unbindBuffer(target_);
+    iD_ = 0;
+  }
   if (iD_ != 0) {
     getContext().deleteBuffers(1, &iD_);
     getContext().unbindBuffer(target_);
@@ -63,8 +83,6 @@ void ArrayBuffer::initialize(const BufferDesc& desc, Result* outResult) {
     return;
   }
 
-  getContext().genBuffers(1, &iD_);
-
   if (desc.type & BufferDesc::BufferTypeBits::Storage) {
     if (getContext().deviceFeatures().hasFeature(DeviceFeatures::Compute)) {
       target_ = GL_SHADER_STORAGE_BUFFER;
@@ -83,6 +101,20 @@ void ArrayBuffer::initialize(const BufferDesc& desc, Result* outResult) {
 
   size_ = desc.length;
 
+  // only dynamic buffers are ever uploaded to, so static ones have nothing to stream
+  isRingBuffer_ = isDynamic_ && (requestedApiHints() & BufferDesc::BufferAPIHintBits::Ring) != 0;
+
+  if (isRingBuffer_) {
+    initializeRingBuffer(desc);
+    if (!ringIds_.empty()) {
+      Result::setOk(outResult);
+      return;
+    }
+    // no persistent mapping available: orphan a single buffer on each upload instead
+    usage = GL_STREAM_DRAW;
+  }
+
+  getContext().genBuffers(1, &iD_);
   getContext().bindBuffer(target_, iD_);
   getContext().bufferData(target_, size_, desc.data, usage);
 
@@ -102,23 +134,139 @@ void ArrayBuffer::initialize(const BufferDesc& desc, Result* outResult) {
   Result::setOk(outResult);
 }
 
+// creates kNumRingRegions persistently mapped regions; leaves ringIds_ empty if not supported
+void ArrayBuffer::initializeRingBuffer(const BufferDesc& desc) {
+  const auto& features = getContext().deviceFeatures();
+  if (size_ == 0 || !features.hasInternalFeature(InternalFeatures::BufferStorage) ||
+      !features.hasInternalFeature(InternalFeatures::Sync) ||
+      !features.hasFeature(DeviceFeatures::MapBufferRange)) {
+    return;
+  }
+
+  ringIds_.resize(kNumRingRegions, 0);
+  ringFences_.resize(kNumRingRegions, nullptr);
+  ringMappings_.resize(kNumRingRegions, nullptr);
+
+  getContext().genBuffers(static_cast<GLsizei>(ringIds_.size()), ringIds_.data());
+
+  for (size_t i = 0; i != kNumRingRegions; i++) {
+    getContext().bindBuffer(target_, ringIds_[i]);
+    getContext().bufferStorage(target_, size_, desc.data, kRingBufferMapFlags);
+    ringMappings_[i] = static_cast<uint8_t*>(
+        getContext().mapBufferRange(target_, 0, size_, kRingBufferMapFlags));
+    if (ringMappings_[i] == nullptr) {
+      IGL_LOG_INFO("Persistent buffer mapping failed, falling back to buffer orphaning\n");
+      getContext().bindBuffer(target_, 0);
+      getContext().deleteBuffers(static_cast<GLsizei>(ringIds_.size()), ringIds_.data());
+      ringIds_.clear();
+      ringFences_.clear();
+      ringMappings_.clear();
+      return;
+    }
+  }
+
+  getContext().bindBuffer(target_, 0);
+
+  ringShadow_.resize(size_, 0);
+  if (desc.data != nullptr) {
+    memcpy(ringShadow_.data(), desc.data, size_);
+  }
+
+  ringIndex_ = 0;
+  iD_ = ringIds_[ringIndex_];
+}
+
 // upload data to the buffer at the given offset with the given size
 Result ArrayBuffer::upload(const void* data, const BufferRange& range) {
+  IGL_PROFILER_FUNCTION();
   // static buffers can only upload data once during creation
   if (!isDynamic_) {
     return Result(Result::Code::InvalidOperation, "Can't upload to static buffers");
   }
 
+  if (!ringIds_.empty()) {
+    if ((range.size + range.offset) > getSizeInBytes()) {
+      return Result(Result::Code::ArgumentOutOfRange,
+                    "upload() size + offset must be <= buffer size");
+    }
+    return uploadToRingBuffer(data, range);
+  }
+
+  const bool orphan = isRingRegionInUse_ && range.offset == 0 && range.size == size_;
+  if (!orphan && getContext().deviceFeatures().hasInternalFeature(
+                     InternalFeatures::DirectStateAccess)) {
+    // no bind-to-edit, so the buffer bound to target_ stays bound
+    getContext().namedBufferSubData(iD_, range.offset, range.size, data);
+    isRingRegionInUse_ = false;
+    return Result();
+  }
+
   getContext().bindBuffer(target_, iD_);
 
-  getContext().bufferSubData(target_, range.offset, range.size, data);
+  if (orphan) {
+    // orphan the storage the GPU may still be reading from instead of waiting for it
+    getContext().bufferData(target_, size_, data, GL_STREAM_DRAW);
+  } else {
+    getContext().bufferSubData(target_, range.offset, range.size, data);
+  }
+  isRingRegionInUse_ = false;
 
   getContext().bindBuffer(target_, 0);
 
   return Result();
 }
 
+Result ArrayBuffer::uploadToRingBuffer(const void* data, const BufferRange& range) {
+  memcpy(ringShadow_.data() + range.offset, data, range.size);
+
+  if (!isRingRegionInUse_) {
+    // nothing has been recorded against the current region since the last upload
+    memcpy(ringMappings_[ringIndex_] + range.offset, data, range.size);
+    return Result();
+  }
+
+  // commands reading the current region have all been issued by now
+  ringFences_[ringIndex_] = getContext().fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  ringIndex_ = (ringIndex_ + 1) % ringIds_.size();
+  waitForRingRegion(ringIndex_);
+
+  if (range.offset == 0 && range.size == size_) {
+    memcpy(ringMappings_[ringIndex_], data, range.size);
+  } else {
+    // partial upload: the rest of the region has to carry the latest contents too
+    memcpy(ringMappings_[ringIndex_], ringShadow_.data(), size_);
+  }
+
+  iD_ = ringIds_[ringIndex_];
+  isRingRegionInUse_ = false;
+
+  return Result();
+}
+
+void ArrayBuffer::waitForRingRegion(size_t index) {
+  GLsync& fence = ringFences_[index];
+  if (fence == nullptr) {
+    return;
+  }
+  for (;;) {
+    const GLenum status =
+        getContext().clientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kRingBufferWaitTimeout);
+    if (status != GL_TIMEOUT_EXPIRED) {
+      IGL_ASSERT(status != GL_WAIT_FAILED);
+      break;
+    }
+  }
+  getContext().deleteSync(fence);
+  fence = nullptr;
+}
+
 void* ArrayBuffer::map(const BufferRange& range, Result* outResult) {
+  if (!ringIds_.empty()) {
+    IGL_ASSERT_MSG(0, "map() operation not supported for persistently mapped ring buffers");
+    Result::setResult(outResult, Result::Code::Unsupported);
+    return nullptr;
+  }
+
   if ((range.size + range.offset) > getSizeInBytes()) {
     Result::setResult(
         outResult, Result::Code::ArgumentOutOfRange, "map() size + offset must be <= buffer size");
@@ -140,12 +288,16 @@ void* ArrayBuffer::map(const BufferRange& range, Result* outResult) {
 }
 
 void ArrayBuffer::unmap() {
+  if (!ringIds_.empty()) {
+    return;
+  }
   bind();
   getContext().unmapBuffer(target_);
 }
 
 // bind the buffer for access by the GPU
 void ArrayBuffer::bind() {
+  markRingRegionInUse();
   getContext().bindBuffer(target_, iD_);
 }
 
@@ -160,12 +312,14 @@ void ArrayBuffer::bindBase(IGL_MAYBE_UNUSED size_t index, Result* outResult) {
     Result::setResult(outResult, Result::Code::InvalidOperation, kErrorMsg);
     return;
   }
+  markRingRegionInUse();
   getContext().bindBuffer(target_, iD_);
   getContext().bindBufferBase(target_, (GLuint)index, iD_);
   Result::setOk(outResult);
 }
 
 void ArrayBuffer::bindForTarget(GLenum target) {
+  markRingRegionInUse();
   getContext().bindBuffer(target, iD_);
 }
 
@@ -181,6 +335,7 @@ void UniformBlockBuffer::bindBase(size_t index, Result* outResult) {
       Result::setResult(outResult, Result::Code::InvalidOperation, kErrorMsg);
       return;
     }
+    markRingRegionInUse();
     getContext().bindBufferBase(target_, (GLuint)index, iD_);
     Result::setOk(outResult);
   } else {
@@ -198,6 +353,7 @@ void UniformBlockBuffer::bindRange(size_t index, size_t offset, Result* outResul
       Result::setResult(outResult, Result::Code::InvalidOperation, kErrorMsg);
       return;
     }
+    markRingRegionInUse();
     getContext().bindBuffer(target_, iD_);
     IGL_ASSERT_MSG(
         offset < getSizeInBytes(), "Offset is invalid! (%d %d)", offset, getSizeInBytes());
@@ -211,5 +367,17 @@ void UniformBlockBuffer::bindRange(size_t index, size_t offset, Result* outResul
   }
 }
 
+GLuint UniformBlockBuffer::getBindingRange(size_t offset,
+                                           GLintptr& outOffset,
+                                           GLsizeiptr& outSize) {
+  IGL_ASSERT(target_ == GL_UNIFORM_BUFFER);
+  IGL_ASSERT_MSG(
+      offset < getSizeInBytes(), "Offset is invalid! (%d %d)", offset, getSizeInBytes());
+  markRingRegionInUse();
+  outOffset = (GLintptr)offset;
+  outSize = (GLsizeiptr)(getSizeInBytes() - offset);
+  return iD_;
+}
+
 } // namespace opengl
 } // namespace igl
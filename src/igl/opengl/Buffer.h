@@ -12,6 +12,7 @@
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
 #include <igl/opengl/WithContext.h>
+#include <vector>
 
 namespace igl {
 class ICommandBuffer;
@@ -50,7 +51,7 @@ class ArrayBuffer : public Buffer {
   void unmap() override;
 
   BufferDesc::BufferAPIHint acceptedApiHints() const noexcept override {
-    return 0;
+    return isRingBuffer_ ? BufferDesc::BufferAPIHintBits::Ring : 0;
   }
 
   ResourceStorage storage() const noexcept override {
@@ -83,6 +84,11 @@ class ArrayBuffer : public Buffer {
   }
 
  protected:
+  // ring buffers switch to a new region on the next upload once the current one has been bound
+  void markRingRegionInUse() noexcept {
+    isRingRegionInUse_ = isRingBuffer_;
+  }
+
   // the GL ID for this texture
   GLuint iD_;
 
@@ -90,10 +96,28 @@ class ArrayBuffer : public Buffer {
   // this must be set by each derived object during construction
   GLenum target_;
 
+ private:
+  void initializeRingBuffer(const BufferDesc& desc);
+  Result uploadToRingBuffer(const void* data, const BufferRange& range);
+  void waitForRingRegion(size_t index);
+
  private:
   size_t size_;
 
   bool isDynamic_;
+
+  // Ring buffers (BufferDesc::BufferAPIHintBits::Ring) cycle through kNumRingRegions GL buffers
+  // which stay persistently mapped; each region is guarded by a fence inserted when the buffer
+  // moves on to the next region. Without glBufferStorage a single buffer is orphaned instead.
+  static constexpr size_t kNumRingRegions = 3;
+  bool isRingBuffer_ = false;
+  bool isRingRegionInUse_ = false;
+  size_t ringIndex_ = 0;
+  std::vector<GLuint> ringIds_;
+  std::vector<GLsync> ringFences_;
+  std::vector<uint8_t*> ringMappings_;
+  // CPU copy of the latest contents used to fill a new region on partial uploads
+  std::vector<uint8_t> ringShadow_;
 };
 
 class UniformBlockBuffer : public ArrayBuffer {
@@ -108,9 +132,12 @@ class UniformBlockBuffer : public ArrayBuffer {
   void setBlockBinding(GLuint pid, GLuint blockIndex, GLuint bindingPoint);
   void bindBase(size_t index, Result* outResult);
   void bindRange(size_t index, size_t offset, Result* outResult);
+  // Returns the buffer object and the range bindRange() would bind, for binding several uniform
+  // blocks with one glBindBuffersRange
+  GLuint getBindingRange(size_t offset, GLintptr& outOffset, GLsizeiptr& outSize);
 
   BufferDesc::BufferAPIHint acceptedApiHints() const noexcept override {
-    return BufferDesc::BufferAPIHintBits::UniformBlock;
+    return BufferDesc::BufferAPIHintBits::UniformBlock | ArrayBuffer::acceptedApiHints();
   }
 };
 
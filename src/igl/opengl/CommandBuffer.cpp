@@ -7,10 +7,14 @@
 
 #include <igl/opengl/CommandBuffer.h>
 
+#include <igl/opengl/Buffer.h>
 #include <igl/opengl/ComputeCommandEncoder.h>
 #include <igl/opengl/Errors.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/ParallelRenderCommandEncoder.h>
 #include <igl/opengl/RenderCommandEncoder.h>
+#include <igl/opengl/Texture.h>
+#include <igl/opengl/TimestampQueryPool.h>
 
 namespace igl {
 namespace opengl {
@@ -26,12 +30,26 @@ std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder
   return RenderCommandEncoder::create(shared_from_this(), renderPass, framebuffer, outResult);
 }
 
+std::unique_ptr<IParallelRenderCommandEncoder> CommandBuffer::createParallelRenderCommandEncoder(
+    const RenderPassDesc& renderPass,
+    std::shared_ptr<IFramebuffer> framebuffer,
+    Result* outResult) {
+  if (!IGL_VERIFY(framebuffer)) {
+    Result::setResult(outResult, Result::Code::ArgumentNull);
+    return nullptr;
+  }
+  Result::setOk(outResult);
+  return std::make_unique<ParallelRenderCommandEncoder>(
+      shared_from_this(), renderPass, std::move(framebuffer));
+}
+
 std::unique_ptr<IComputeCommandEncoder> CommandBuffer::createComputeCommandEncoder() {
   return std::make_unique<ComputeCommandEncoder>(shared_from_this()->getContext());
 }
 
 void CommandBuffer::present(std::shared_ptr<ITexture> surface) const {
   context_->present(surface);
+  hasPresented_ = true;
 }
 
 void CommandBuffer::waitUntilScheduled() {
@@ -39,9 +57,28 @@ void CommandBuffer::waitUntilScheduled() {
 }
 
 void CommandBuffer::waitUntilCompleted() {
+  if (completionFence_) {
+    // only waits for this command buffer, not for the work submitted after it
+    completionFence_->waitUntilSignaled();
+    return;
+  }
   context_->finish();
 }
 
+void CommandBuffer::addCompletedHandler(std::function<void()> handler) {
+  IGL_ASSERT_MSG(!isSubmitted_, "Completed handlers have to be added before the submit");
+  completedHandlers_.push_back(std::move(handler));
+}
+
+bool CommandBuffer::isCompleted() const {
+  if (!isSubmitted_) {
+    return false;
+  }
+  // without sync objects, the implicit synchronization of OpenGL already makes it safe to reuse
+  // the resources of a submitted command buffer
+  return completionFence_ == nullptr || completionFence_->isSignaled();
+}
+
 void CommandBuffer::pushDebugGroupLabel(const std::string& label,
                                         const igl::Color& /*color*/) const {
   IGL_ASSERT(!label.empty());
@@ -52,6 +89,30 @@ void CommandBuffer::popDebugGroupLabel() const {
   getContext().popDebugGroup();
 }
 
+void CommandBuffer::writeTimestamp(ITimestampQueryPool& pool, uint32_t queryIndex) {
+  // OpenGL commands execute in order, so the timestamp is taken after all previous commands
+  auto& glPool = static_cast<TimestampQueryPool&>(pool);
+  getContext().queryCounter(glPool.getId(queryIndex), GL_TIMESTAMP);
+}
+
+void CommandBuffer::copyBufferToTexture(IBuffer& buffer,
+                                        size_t bufferOffset,
+                                        ITexture& texture,
+                                        const TextureRangeDesc& range) {
+  if (!IGL_VERIFY(!texture.getProperties().isDepthOrStencil())) {
+    return;
+  }
+  if (getContext().deviceFeatures().hasFeature(DeviceFeatures::Compute)) {
+    // the data may have been written by compute shaders
+    getContext().memoryBarrier(GL_PIXEL_BUFFER_BARRIER_BIT);
+  }
+  const Result result = static_cast<Texture&>(texture).uploadFromBuffer(
+      range, static_cast<ArrayBuffer&>(buffer).getId(), bufferOffset);
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("copyBufferToTexture() failed: %s\n", result.message.c_str());
+  }
+}
+
 IContext& CommandBuffer::getContext() const {
   return *context_;
 }
@@ -7,7 +7,10 @@
 
 #pragma once
 
+#include <vector>
+
 #include <igl/CommandBuffer.h>
+#include <igl/Fence.h>
 
 namespace igl {
 namespace opengl {
@@ -28,6 +31,11 @@ class CommandBuffer final : public ICommandBuffer,
       std::shared_ptr<IFramebuffer> framebuffer,
       Result* outResult) override;
 
+  std::unique_ptr<IParallelRenderCommandEncoder> createParallelRenderCommandEncoder(
+      const RenderPassDesc& renderPass,
+      std::shared_ptr<IFramebuffer> framebuffer,
+      Result* outResult) override;
+
   std::unique_ptr<IComputeCommandEncoder> createComputeCommandEncoder() override;
 
   void present(std::shared_ptr<ITexture> surface) const override;
@@ -36,14 +44,37 @@ class CommandBuffer final : public ICommandBuffer,
 
   void waitUntilCompleted() override;
 
+  void addCompletedHandler(std::function<void()> handler) override;
+
+  [[nodiscard]] bool isCompleted() const override;
+
   void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
 
   void popDebugGroupLabel() const override;
 
+  void writeTimestamp(ITimestampQueryPool& pool, uint32_t queryIndex) override;
+
+  void copyBufferToTexture(IBuffer& buffer,
+                           size_t bufferOffset,
+                           ITexture& texture,
+                           const TextureRangeDesc& range) override;
+
   IContext& getContext() const;
 
+  bool hasPresented() const {
+    return hasPresented_;
+  }
+
  private:
+  friend class CommandQueue;
+
   std::shared_ptr<IContext> context_;
+  mutable bool hasPresented_ = false;
+  bool isSubmitted_ = false;
+  // signaled once this command buffer is completed; nullptr without sync objects
+  std::shared_ptr<IFence> completionFence_;
+  // moved to CommandQueue by the submit
+  std::vector<std::function<void()>> completedHandlers_;
 };
 
 } // namespace opengl
@@ -7,10 +7,15 @@
 
 #include <igl/opengl/CommandQueue.h>
 
+#include <algorithm>
+#include <iterator>
+
+#include <igl/ObjectPool.h>
 #include <igl/Texture.h>
 #include <igl/opengl/CommandBuffer.h>
 #include <igl/opengl/Device.h>
 #include <igl/opengl/Errors.h>
+#include <igl/opengl/Fence.h>
 #include <igl/opengl/IContext.h>
 #include <igl/opengl/RenderPipelineState.h>
 
@@ -31,21 +36,98 @@ std::shared_ptr<ICommandBuffer> CommandQueue::createCommandBuffer(const CommandB
     return nullptr;
   }
 
-  auto commandBuffer = std::make_shared<CommandBuffer>(context_);
+  auto commandBuffer = std::allocate_shared<CommandBuffer>(PoolAllocator<CommandBuffer>(), context_);
   activeCommandBuffers_++;
   Result::setOk(outResult);
 
   return commandBuffer;
 }
 
-SubmitHandle CommandQueue::submit(const ICommandBuffer& commandBuffer, bool /* endOfFrame */) {
+SubmitHandle CommandQueue::submit(const ICommandBuffer& commandBuffer, bool endOfFrame) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_SUBMIT);
   const auto& cb = static_cast<const CommandBuffer&>(commandBuffer);
   incrementDrawCount(cb.getCurrentDrawCount());
 
+  IContext& context = cb.getContext();
+  context.getFrameStatisticsTracker().add(FrameStatisticsTracker::DrawCalls,
+                                          cb.getCurrentDrawCount());
+  if (endOfFrame || cb.hasPresented()) {
+    context.endFrameStatistics();
+    if (context.isDeferredDeletionEnabled()) {
+      context.processDeferredDeletions();
+    }
+    IGL_PROFILER_GPU_COLLECT_OGL();
+  }
+
   activeCommandBuffers_--;
 
+  auto& mutableCb = const_cast<CommandBuffer&>(cb);
+  mutableCb.isSubmitted_ = true;
+  // nullptr without sync objects
+  mutableCb.completionFence_ = signalFence(nullptr);
+  if (!mutableCb.completedHandlers_.empty()) {
+    if (mutableCb.completionFence_) {
+      pendingHandlers_.push_back(
+          {mutableCb.completionFence_, std::move(mutableCb.completedHandlers_)});
+    } else {
+      // there is nothing to poll without sync objects
+      context.finish();
+      for (const auto& handler : mutableCb.completedHandlers_) {
+        handler();
+      }
+    }
+    mutableCb.completedHandlers_.clear();
+  }
+  processCompletedHandlers();
+
   return SubmitHandle{};
 }
 
+void CommandQueue::processCompletedHandlers() {
+  const auto end = std::find_if(pendingHandlers_.begin(),
+                                pendingHandlers_.end(),
+                                [](const PendingHandlers& p) { return !p.fence->isSignaled(); });
+  // handlers can submit more command buffers
+  std::vector<PendingHandlers> completed(std::make_move_iterator(pendingHandlers_.begin()),
+                                         std::make_move_iterator(end));
+  pendingHandlers_.erase(pendingHandlers_.begin(), end);
+  for (const auto& pending : completed) {
+    for (const auto& handler : pending.handlers) {
+      handler();
+    }
+  }
+}
+
+std::shared_ptr<IFence> CommandQueue::signalFence(Result* outResult) {
+  if (context_ == nullptr) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "There is no context set");
+    return nullptr;
+  }
+  const auto& features = context_->deviceFeatures();
+  const bool hasSync = features.hasInternalRequirement(InternalRequirement::SyncExtReq)
+                           ? features.hasExtension(Extensions::Sync)
+                           : features.hasInternalFeature(InternalFeatures::Sync);
+  if (!hasSync) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Sync objects are not supported");
+    return nullptr;
+  }
+
+  GLsync sync = context_->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  if (sync == nullptr) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "glFenceSync() failed");
+    return nullptr;
+  }
+  // other contexts can only wait for a fence which has been flushed
+  context_->flush();
+
+  Result::setOk(outResult);
+  return std::make_shared<Fence>(*context_, sync);
+}
+
+Result CommandQueue::waitFence(const IFence& /*fence*/) {
+  // commands of a context execute in order, so the work submitted next runs after the fence
+  return Result();
+}
+
 } // namespace opengl
 } // namespace igl
@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include <igl/CommandQueue.h>
 
 namespace igl {
@@ -20,11 +23,25 @@ class CommandQueue final : public ICommandQueue {
                                                       Result* outResult) override;
   SubmitHandle submit(const ICommandBuffer& commandBuffer, bool endOfFrame = false) override;
 
+  std::shared_ptr<IFence> signalFence(Result* outResult) override;
+  Result waitFence(const IFence& fence) override;
+
   void setInitialContext(std::shared_ptr<IContext> context);
 
  private:
+  // runs the completed handlers of the command buffers whose fences are signaled
+  void processCompletedHandlers();
+
+ private:
+  struct PendingHandlers {
+    std::shared_ptr<IFence> fence;
+    std::vector<std::function<void()>> handlers;
+  };
+
   std::shared_ptr<IContext> context_;
   uint32_t activeCommandBuffers_ = 0;
+  // in submit order, so the first one which is not signaled ends the search
+  std::vector<PendingHandlers> pendingHandlers_;
 };
 
 } // namespace opengl
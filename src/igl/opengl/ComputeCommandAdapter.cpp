@@ -84,6 +84,16 @@ void ComputeCommandAdapter::dispatchThreadGroups(const Dimensions& threadgroupCo
   didDispatch();
 }
 
+void ComputeCommandAdapter::dispatchThreadGroupsIndirect(Buffer& indirectBuffer,
+                                                         size_t indirectBufferOffset,
+                                                         const Dimensions& /*threadgroupSize*/) {
+  willDispatch();
+  // didDispatch() of the dispatch writing the counts has issued GL_COMMAND_BARRIER_BIT
+  static_cast<ArrayBuffer&>(indirectBuffer).bindForTarget(GL_DISPATCH_INDIRECT_BUFFER);
+  getContext().dispatchComputeIndirect(static_cast<GLintptr>(indirectBufferOffset));
+  didDispatch();
+}
+
 void ComputeCommandAdapter::setPipelineState(
     const std::shared_ptr<IComputePipelineState>& newValue) {
   if (pipelineState_) {
@@ -124,7 +134,7 @@ void ComputeCommandAdapter::willDispatch() {
   }
 
   // Bind uniforms to be used for compute
-  uniformAdapter_.bindToPipeline(getContext());
+  uniformAdapter_.bindToPipeline(getContext(), pipelineState->uniformValueCache());
 
   for (size_t index = 0; index < textureStates_.size(); index++) {
     if (!IS_DIRTY(textureStatesDirty_, index)) {
@@ -143,7 +153,8 @@ void ComputeCommandAdapter::willDispatch() {
 }
 
 void ComputeCommandAdapter::didDispatch() {
-  getContext().memoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+  // images written by compute shaders can be sampled or loaded by the next dispatches
+  getContext().memoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 
   if (pipelineState_ == nullptr) {
     return;
@@ -154,8 +165,10 @@ void ComputeCommandAdapter::didDispatch() {
     return;
   }
   if (pipelineState->getIsUsingShaderStorageBuffers()) {
+    // storage buffers written by compute shaders can be read as indirect draw commands
     getContext().memoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT |
-                               GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+                               GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT |
+                               GL_COMMAND_BARRIER_BIT);
   }
 }
 
@@ -58,6 +58,9 @@ class ComputeCommandAdapter final : public WithContext {
   void setPipelineState(const std::shared_ptr<IComputePipelineState>& newValue);
   void dispatchThreadGroups(const Dimensions& threadgroupCount,
                             const Dimensions& /*threadgroupSize*/);
+  void dispatchThreadGroupsIndirect(Buffer& indirectBuffer,
+                                    size_t indirectBufferOffset,
+                                    const Dimensions& /*threadgroupSize*/);
 
   void endEncoding();
 
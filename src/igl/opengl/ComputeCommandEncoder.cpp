@@ -26,6 +26,9 @@ namespace opengl {
 /// MARK: - ComputeCommandEncoder
 
 ComputeCommandEncoder::ComputeCommandEncoder(IContext& context) : WithContext(context) {
+  IGL_PROFILER_FUNCTION();
+  IGL_PROFILER_ZONE_GPU_BEGIN_OGL(tracyGpuZone_, "ComputePass");
+
   auto& oglContext = getContext();
 
   auto& pool = oglContext.getComputeAdapterPool();
@@ -40,26 +43,44 @@ ComputeCommandEncoder::ComputeCommandEncoder(IContext& context) : WithContext(co
 ComputeCommandEncoder::~ComputeCommandEncoder() = default;
 
 void ComputeCommandEncoder::endEncoding() {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
     adapter_->endEncoding();
     getContext().getComputeAdapterPool().push_back(std::move(adapter_));
   }
+#if IGL_WITH_TRACY_GPU_OGL
+  tracyGpuZone_.reset();
+#endif // IGL_WITH_TRACY_GPU_OGL
 }
 
 void ComputeCommandEncoder::bindComputePipelineState(
     const std::shared_ptr<IComputePipelineState>& pipelineState) {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
     adapter_->setPipelineState(pipelineState);
+    getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::PipelineBinds);
   }
 }
 
 void ComputeCommandEncoder::dispatchThreadGroups(const Dimensions& threadgroupCount,
                                                  const Dimensions& threadgroupSize) {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
     adapter_->dispatchThreadGroups(threadgroupCount, threadgroupSize);
   }
 }
 
+void ComputeCommandEncoder::dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                                         size_t indirectBufferOffset,
+                                                         const Dimensions& threadgroupSize) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT_MSG(indirectBufferOffset % 4 == 0, "The offset has to be a multiple of 4");
+  if (IGL_VERIFY(adapter_)) {
+    adapter_->dispatchThreadGroupsIndirect(
+        static_cast<Buffer&>(indirectBuffer), indirectBufferOffset, threadgroupSize);
+  }
+}
+
 void ComputeCommandEncoder::pushDebugGroupLabel(const std::string& label,
                                                 const igl::Color& /*color*/) const {
   IGL_ASSERT(!label.empty());
@@ -82,27 +103,33 @@ void ComputeCommandEncoder::popDebugGroupLabel() const {
 }
 
 void ComputeCommandEncoder::bindUniform(const UniformDesc& uniformDesc, const void* data) {
+  IGL_PROFILER_FUNCTION();
   IGL_ASSERT_MSG(uniformDesc.location >= 0,
                  "Invalid location passed to bindUniformBuffer: %d",
                  uniformDesc.location);
   IGL_ASSERT_MSG(data != nullptr, "Data cannot be null");
   if (IGL_VERIFY(adapter_) && data) {
     adapter_->setUniform(uniformDesc, data);
+    getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::DescriptorUpdates);
   }
 }
 
 void ComputeCommandEncoder::bindTexture(size_t index, ITexture* texture) {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
     adapter_->setTexture(texture, index);
+    getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::DescriptorUpdates);
   }
 }
 
 void ComputeCommandEncoder::bindBuffer(size_t index,
                                        const std::shared_ptr<IBuffer>& buffer,
                                        size_t offset) {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_) && buffer) {
     auto glBuffer = std::static_pointer_cast<Buffer>(buffer);
     adapter_->setBuffer(glBuffer, offset, static_cast<int>(index));
+    getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::DescriptorUpdates);
   }
 }
 
@@ -116,5 +143,11 @@ void ComputeCommandEncoder::bindPushConstants(const void* /*data*/,
   IGL_ASSERT_NOT_IMPLEMENTED();
 }
 
+void ComputeCommandEncoder::bindBufferAddress(size_t /*offset*/,
+                                              IBuffer& /*buffer*/,
+                                              size_t /*bufferOffset*/) {
+  IGL_ASSERT_NOT_IMPLEMENTED();
+}
+
 } // namespace opengl
 } // namespace igl
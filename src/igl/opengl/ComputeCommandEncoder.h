@@ -9,6 +9,7 @@
 
 #include <igl/Common.h>
 #include <igl/ComputeCommandEncoder.h>
+#include <igl/ObjectPool.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
 #include <igl/opengl/UniformAdapter.h>
@@ -25,7 +26,9 @@ class Buffer;
 class UniformBuffer;
 class ComputeCommandAdapter;
 
-class ComputeCommandEncoder final : public IComputeCommandEncoder, public WithContext {
+class ComputeCommandEncoder final : public IComputeCommandEncoder,
+                                    public WithContext,
+                                    public Pooled<ComputeCommandEncoder> {
  public:
   explicit ComputeCommandEncoder(IContext& context);
   ~ComputeCommandEncoder() override;
@@ -36,6 +39,9 @@ class ComputeCommandEncoder final : public IComputeCommandEncoder, public WithCo
   // total number of threads per grid is threadgroupCount * threadgroupSize
   void dispatchThreadGroups(const Dimensions& threadgroupCount,
                             const Dimensions& threadgroupSize) override;
+  void dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                    size_t indirectBufferOffset,
+                                    const Dimensions& threadgroupSize) override;
   void endEncoding() override;
 
   void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
@@ -46,9 +52,13 @@ class ComputeCommandEncoder final : public IComputeCommandEncoder, public WithCo
   void bindBuffer(size_t index, const std::shared_ptr<IBuffer>& buffer, size_t offset) override;
   void bindBytes(size_t index, const void* data, size_t length) override;
   void bindPushConstants(const void* data, size_t length, size_t offset) override;
+  void bindBufferAddress(size_t offset, IBuffer& buffer, size_t bufferOffset) override;
 
  private:
   std::unique_ptr<ComputeCommandAdapter> adapter_;
+#if IGL_WITH_TRACY_GPU_OGL
+  std::unique_ptr<tracy::GpuCtxScope> tracyGpuZone_; // the compute pass
+#endif // IGL_WITH_TRACY_GPU_OGL
 };
 
 } // namespace opengl
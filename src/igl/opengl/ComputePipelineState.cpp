@@ -29,6 +29,10 @@ Result ComputePipelineState::create(const ComputePipelineDesc& desc) {
     Result::setResult(&result, Result::Code::ArgumentInvalid, "Missing compute shader");
     return result;
   }
+  if (desc.requiredSubgroupSize != 0 || desc.requireFullSubgroups) {
+    Result::setResult(&result, Result::Code::Unsupported, "Subgroup size control is not supported");
+    return result;
+  }
   shaderStages_ = std::static_pointer_cast<ShaderStages>(desc.shaderStages);
   reflection_ = std::make_shared<ComputePipelineReflection>(getContext(), *shaderStages_);
 
@@ -148,5 +152,9 @@ Result ComputePipelineState::bindBuffer(const size_t unit, Buffer* buffer) {
 int ComputePipelineState::getIndexByName(const NameHandle& name) const {
   return reflection_ ? reflection_->getIndexByName(name) : -1;
 }
+
+UniformValueCache* ComputePipelineState::uniformValueCache() {
+  return shaderStages_ ? &shaderStages_->uniformValueCache() : nullptr;
+}
 } // namespace opengl
 } // namespace igl
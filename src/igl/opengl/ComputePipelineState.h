@@ -43,6 +43,9 @@ class ComputePipelineState final : public WithContext, public IComputePipelineSt
     return usingShaderStorageBuffers_;
   }
 
+  // null if the pipeline has no shader program
+  UniformValueCache* uniformValueCache();
+
  private:
   using ComputePipelineReflection = RenderPipelineReflection;
 
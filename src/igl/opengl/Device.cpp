@@ -18,11 +18,13 @@
 #include <igl/opengl/Errors.h>
 #include <igl/opengl/Framebuffer.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/OcclusionQueryPool.h>
 #include <igl/opengl/RenderPipelineState.h>
 #include <igl/opengl/SamplerState.h>
 #include <igl/opengl/Shader.h>
 #include <igl/opengl/TextureBuffer.h>
 #include <igl/opengl/TextureTarget.h>
+#include <igl/opengl/TimestampQueryPool.h>
 #include <igl/opengl/UniformBuffer.h>
 #include <igl/opengl/VertexInputState.h>
 
@@ -119,6 +121,7 @@ std::shared_ptr<ICommandQueue> Device::createCommandQueue(const CommandQueueDesc
 // Resources
 std::unique_ptr<IBuffer> Device::createBuffer(const BufferDesc& desc,
                                               Result* outResult) const noexcept {
+  IGL_PROFILER_FUNCTION();
   std::unique_ptr<Buffer> resource = allocateBuffer(desc.type, desc.hint, getContext());
 
   if (resource) {
@@ -141,6 +144,7 @@ std::shared_ptr<IDepthStencilState> Device::createDepthStencilState(
 
 std::shared_ptr<ISamplerState> Device::createSamplerState(const SamplerStateDesc& desc,
                                                           Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   auto resource = std::make_shared<SamplerState>(getContext(), desc);
   if (getResourceTracker()) {
     resource->initResourceTracker(getResourceTracker());
@@ -151,6 +155,7 @@ std::shared_ptr<ISamplerState> Device::createSamplerState(const SamplerStateDesc
 
 std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
                                                 Result* outResult) const noexcept {
+  IGL_PROFILER_FUNCTION();
   const auto sanitized = sanitize(desc);
 
   std::unique_ptr<Texture> texture;
@@ -201,6 +206,41 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
   return texture;
 }
 
+std::shared_ptr<ITexture> Device::createTextureView(const ITexture& texture,
+                                                    const TextureViewDesc& desc,
+                                                    Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
+  if (!hasFeature(DeviceFeatures::TextureViews)) {
+    // without glTextureView, textures can't share their storage
+    Result::setResult(outResult, Result::Code::Unsupported, "glTextureView is not supported");
+    return nullptr;
+  }
+  // renderbuffers (TextureTarget) have no texture storage to view
+  const auto* textureBuffer = dynamic_cast<const TextureBuffer*>(&texture);
+  if (textureBuffer == nullptr) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Only textures can be viewed");
+    return nullptr;
+  }
+  TextureDesc viewDesc;
+  Result result = texture.validateView(desc, viewDesc);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+
+  auto view = std::make_shared<TextureBuffer>(getContext(), viewDesc.format);
+  result = view->createView(*textureBuffer, desc, viewDesc);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  if (getResourceTracker()) {
+    view->initResourceTracker(getResourceTracker());
+  }
+  Result::setOk(outResult);
+  return view;
+}
+
 std::shared_ptr<IVertexInputState> Device::createVertexInputState(const VertexInputStateDesc& desc,
                                                                   Result* outResult) const {
   return createSharedResource<VertexInputState>(desc, outResult);
@@ -209,12 +249,14 @@ std::shared_ptr<IVertexInputState> Device::createVertexInputState(const VertexIn
 // Pipelines
 std::shared_ptr<IRenderPipelineState> Device::createRenderPipeline(const RenderPipelineDesc& desc,
                                                                    Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   return createSharedResource<RenderPipelineState>(desc, outResult, getContext());
 }
 
 std::shared_ptr<IComputePipelineState> Device::createComputePipeline(
     const ComputePipelineDesc& desc,
     Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   return createSharedResource<ComputePipelineState>(desc, outResult, getContext());
 }
 
@@ -229,6 +271,7 @@ std::unique_ptr<igl::IShaderLibrary> Device::createShaderLibrary(const ShaderLib
 
 std::shared_ptr<IShaderModule> Device::createShaderModule(const ShaderModuleDesc& desc,
                                                           Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   auto module = createSharedResource<ShaderModule>(desc, outResult, getContext(), desc.info);
   if (auto resourceTracker = getResourceTracker(); module && resourceTracker) {
     module->initResourceTracker(resourceTracker);
@@ -236,8 +279,46 @@ std::shared_ptr<IShaderModule> Device::createShaderModule(const ShaderModuleDesc
   return module;
 }
 
+std::vector<std::shared_ptr<IShaderModule>> Device::createShaderModules(
+    const std::vector<ShaderModuleDesc>& descs,
+    Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
+  if (getContext().deviceFeatures().hasExtension(Extensions::ParallelShaderCompile)) {
+    // let the driver pick the number of threads
+    getContext().maxShaderCompilerThreads(0xFFFFFFFF);
+  }
+
+  // issue all the compilations before checking any of them, so the driver can compile them in the
+  // background while the next ones are submitted
+  std::vector<std::shared_ptr<ShaderModule>> pending(descs.size());
+  std::vector<Result> results(descs.size());
+  for (size_t i = 0; i != descs.size(); i++) {
+    pending[i] = std::make_shared<ShaderModule>(getContext(), descs[i].info);
+    results[i] = pending[i]->compile(descs[i]);
+  }
+
+  std::vector<std::shared_ptr<IShaderModule>> modules(descs.size());
+  const auto resourceTracker = getResourceTracker();
+  for (size_t i = 0; i != descs.size(); i++) {
+    if (results[i].isOk()) {
+      results[i] = pending[i]->finishCompile();
+    }
+    if (!results[i].isOk()) {
+      continue;
+    }
+    if (resourceTracker) {
+      pending[i]->initResourceTracker(resourceTracker);
+    }
+    modules[i] = std::move(pending[i]);
+  }
+
+  setFirstFailure(outResult, results);
+  return modules;
+}
+
 std::unique_ptr<IShaderStages> Device::createShaderStages(const ShaderStagesDesc& desc,
                                                           Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   // Need to pass desc twice.
   // The first instance is for the createUniqueResource pattern.
   // The second instance is so it also gets passed to the ShaderStages constructor.
@@ -250,10 +331,35 @@ std::unique_ptr<IShaderStages> Device::createShaderStages(const ShaderStagesDesc
 
 std::shared_ptr<IFramebuffer> Device::createFramebuffer(const FramebufferDesc& desc,
                                                         Result* outResult) {
+  IGL_PROFILER_FUNCTION();
   IGL_ASSERT(deviceFeatureSet_.hasInternalFeature(InternalFeatures::FramebufferObject));
   return getPlatformDevice().createFramebuffer(desc, outResult);
 }
 
+std::shared_ptr<IOcclusionQueryPool> Device::createOcclusionQueryPool(
+    const OcclusionQueryPoolDesc& desc,
+    Result* outResult) const {
+  if (!deviceFeatureSet_.hasFeature(DeviceFeatures::OcclusionQueries)) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Occlusion queries are not supported");
+    return nullptr;
+  }
+  auto resource = std::make_shared<OcclusionQueryPool>(getContext(), desc);
+  Result::setOk(outResult);
+  return resource;
+}
+
+std::shared_ptr<ITimestampQueryPool> Device::createTimestampQueryPool(
+    const TimestampQueryPoolDesc& desc,
+    Result* outResult) const {
+  if (!deviceFeatureSet_.hasFeature(DeviceFeatures::TimestampQueries)) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Timestamp queries are not supported");
+    return nullptr;
+  }
+  auto resource = std::make_shared<TimestampQueryPool>(getContext(), desc);
+  Result::setOk(outResult);
+  return resource;
+}
+
 bool Device::hasFeature(DeviceFeatures capability) const {
   return deviceFeatureSet_.hasFeature(capability);
 }
@@ -316,5 +422,13 @@ size_t Device::getCurrentDrawCount() const {
   return context_->getCurrentDrawCount();
 }
 
+FrameStatistics Device::getFrameStatistics() const {
+  return context_->getFrameStatistics();
+}
+
+std::vector<FrameStatistics> Device::getFrameStatisticsHistory() const {
+  return context_->getFrameStatisticsTracker().getHistory();
+}
+
 } // namespace opengl
 } // namespace igl
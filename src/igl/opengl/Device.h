@@ -47,6 +47,9 @@ class Device : public IDevice {
                                                     Result* outResult) const override;
   std::shared_ptr<ITexture> createTexture(const TextureDesc& desc,
                                           Result* outResult) const noexcept override;
+  std::shared_ptr<ITexture> createTextureView(const ITexture& texture,
+                                              const TextureViewDesc& desc,
+                                              Result* outResult) const override;
 
   std::shared_ptr<IVertexInputState> createVertexInputState(const VertexInputStateDesc& desc,
                                                             Result* outResult) const override;
@@ -64,12 +67,24 @@ class Device : public IDevice {
   std::shared_ptr<IShaderModule> createShaderModule(const ShaderModuleDesc& desc,
                                                     Result* outResult) const override;
 
+  std::vector<std::shared_ptr<IShaderModule>> createShaderModules(
+      const std::vector<ShaderModuleDesc>& descs,
+      Result* outResult) const override;
+
   std::unique_ptr<IShaderStages> createShaderStages(const ShaderStagesDesc& desc,
                                                     Result* outResult) const override;
 
   std::shared_ptr<IFramebuffer> createFramebuffer(const FramebufferDesc& desc,
                                                   Result* outResult) override;
 
+  std::shared_ptr<IOcclusionQueryPool> createOcclusionQueryPool(
+      const OcclusionQueryPoolDesc& desc,
+      Result* outResult) const override;
+
+  std::shared_ptr<ITimestampQueryPool> createTimestampQueryPool(
+      const TimestampQueryPoolDesc& desc,
+      Result* outResult) const override;
+
   // debug markers useful in GPU captures
   void pushMarker(int len, const char* name);
   void popMarker();
@@ -89,6 +104,8 @@ class Device : public IDevice {
 
   // Device Statistics
   size_t getCurrentDrawCount() const override;
+  FrameStatistics getFrameStatistics() const override;
+  std::vector<FrameStatistics> getFrameStatisticsHistory() const override;
 
   bool verifyScope() override;
 
@@ -11,6 +11,7 @@
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
 #include <igl/opengl/Texture.h>
+#include <igl/opengl/UniformAdapter.h>
 
 namespace igl::opengl {
 namespace {
@@ -134,6 +135,8 @@ bool DeviceFeatureSet::isExtensionSupported(Extensions extension) const {
     return hasDesktopExtension(*this, "GL_ARB_bindless_texture");
   case Extensions::BindlessTextureNv:
     return hasDesktopOrESExtension(*this, "GL_NV_bindless_texture");
+  case Extensions::BufferStorage:
+    return hasESExtension(*this, "GL_EXT_buffer_storage");
   case Extensions::Debug:
     return hasDesktopOrESExtension(*this, "GL_KHR_debug");
   case Extensions::DebugMarker:
@@ -146,6 +149,8 @@ bool DeviceFeatureSet::isExtensionSupported(Extensions extension) const {
     return hasESExtension(*this, "GL_OES_depth_texture");
   case Extensions::DiscardFramebuffer:
     return hasESExtension(*this, "GL_EXT_discard_framebuffer");
+  case Extensions::DisjointTimerQuery:
+    return hasESExtension(*this, "GL_EXT_disjoint_timer_query");
   case Extensions::DrawBuffers:
     return hasESExtension(*this, "GL_EXT_draw_buffers");
   case Extensions::Es2Compatibility:
@@ -160,14 +165,20 @@ bool DeviceFeatureSet::isExtensionSupported(Extensions extension) const {
     return hasESExtension(*this, "GL_OES_mapbuffer");
   case Extensions::MapBufferRange:
     return hasESExtension(*this, "GL_EXT_map_buffer_range");
+  case Extensions::MultiDrawIndirect:
+    return hasESExtension(*this, "GL_EXT_multi_draw_indirect");
   case Extensions::MultiSampleApple:
     return hasESExtension(*this, "GL_APPLE_framebuffer_multisample");
   case Extensions::MultiSampleExt:
     return hasESExtension(*this, "GL_EXT_multisampled_render_to_texture");
   case Extensions::MultiSampleImg:
     return hasESExtension(*this, "GL_IMG_multisampled_render_to_texture");
+  case Extensions::ParallelShaderCompile:
+    return isSupported("GL_KHR_parallel_shader_compile");
   case Extensions::RequiredInternalFormat:
     return hasESExtension(*this, "GL_OES_required_internalformat");
+  case Extensions::ShaderFramebufferFetch:
+    return hasESExtension(*this, "GL_EXT_shader_framebuffer_fetch");
   case Extensions::ShaderImageLoadStore:
     return hasESExtension(*this, "GL_EXT_shader_image_load_store");
   case Extensions::Srgb:
@@ -197,6 +208,8 @@ bool DeviceFeatureSet::isExtensionSupported(Extensions extension) const {
     return hasDesktopExtension(*this, "GL_EXT_texture_sRGB");
   case Extensions::TextureType2_10_10_10_Rev:
     return hasESExtension(*this, "GL_EXT_texture_type_2_10_10_10_REV");
+  case Extensions::TextureView:
+    return hasESExtension(*this, "GL_EXT_texture_view");
   case Extensions::VertexArrayObject:
     return hasESExtension(*this, "GL_OES_vertex_array_object");
   case Extensions::VertexAttribDivisor:
@@ -237,6 +250,13 @@ bool DeviceFeatureSet::isFeatureSupported(DeviceFeatures feature) const {
   case DeviceFeatures::StandardDerivativeExt:
     return hasESExtension(*this, "GL_OES_standard_derivatives");
 
+  case DeviceFeatures::SubgroupSizeControl:
+    return false;
+
+  case DeviceFeatures::Subpasses:
+    // input attachments are read with coherent framebuffer fetch, so subpasses need no barriers
+    return hasExtension(Extensions::ShaderFramebufferFetch);
+
   case DeviceFeatures::TextureFormatRG:
     return hasDesktopOrESVersion(*this, GLVersion::v3_0, GLVersion::v3_0_ES) ||
            hasExtension(Extensions::TextureRgArb) || hasExtension(Extensions::TextureRgExt);
@@ -325,11 +345,15 @@ bool DeviceFeatureSet::isFeatureSupported(DeviceFeatures feature) const {
            hasDesktopOrESExtension(*this, "GL_EXT_memory_object_fd");
 
   case DeviceFeatures::PushConstants:
-    return false;
+    // emulated with a uniform block, see kPushConstantsBindingIndex
+    return hasFeature(DeviceFeatures::UniformBlocks);
 
   case DeviceFeatures::BufferDeviceAddress:
     return false;
 
+  case DeviceFeatures::FragmentDensityMap:
+    return false;
+
   case DeviceFeatures::Multiview:
     return hasDesktopOrESVersion(*this, GLVersion::v3_0, GLVersion::v3_0_ES) &&
            isSupported("GL_OVR_multiview2");
@@ -338,6 +362,9 @@ bool DeviceFeatureSet::isFeatureSupported(DeviceFeatures feature) const {
     return hasDesktopOrESVersion(*this, GLVersion::v2_0, GLVersion::v3_0_ES) ||
            hasESExtension(*this, "GL_APPLE_texture_max_level");
 
+  case DeviceFeatures::TextureViews:
+    return hasInternalFeature(InternalFeatures::TextureView);
+
   case DeviceFeatures::BindUniform:
     return true;
   case DeviceFeatures::BufferRing:
@@ -346,6 +373,8 @@ bool DeviceFeatureSet::isFeatureSupported(DeviceFeatures feature) const {
     return false;
   case DeviceFeatures::ShaderLibrary:
     return false;
+  case DeviceFeatures::ShaderSubgroups:
+    return false;
   case DeviceFeatures::BindBytes:
     return false;
   case DeviceFeatures::SRGB:
@@ -364,8 +393,23 @@ bool DeviceFeatureSet::isFeatureSupported(DeviceFeatures feature) const {
     return hasDesktopOrESVersionOrExtension(
         *this, GLVersion::v4_0, GLVersion::v3_1_ES, "GL_ARB_draw_indirect");
 
+  case DeviceFeatures::DrawInstanced:
+    return hasInternalFeature(InternalFeatures::DrawInstanced);
+
+  case DeviceFeatures::DrawBaseVertex:
+    return hasInternalFeature(InternalFeatures::DrawBaseVertex);
+
+  case DeviceFeatures::DrawBaseInstance:
+    return hasInternalFeature(InternalFeatures::DrawBaseInstance);
+
   case DeviceFeatures::ValidationLayersEnabled:
     return false;
+
+  case DeviceFeatures::OcclusionQueries:
+    return hasInternalFeature(InternalFeatures::QueryObjects);
+
+  case DeviceFeatures::TimestampQueries:
+    return hasInternalFeature(InternalFeatures::TimerQuery);
   }
 
   return false;
@@ -373,6 +417,11 @@ bool DeviceFeatureSet::isFeatureSupported(DeviceFeatures feature) const {
 
 bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) const {
   switch (feature) {
+  case InternalFeatures::BufferStorage:
+    return hasDesktopVersion(*this, GLVersion::v4_4) ||
+           hasDesktopExtension(*this, "GL_ARB_buffer_storage") ||
+           hasExtension(Extensions::BufferStorage);
+
   case InternalFeatures::ClearDepthf:
     return hasDesktopOrESVersion(*this, GLVersion::v4_1, GLVersion::v2_0_ES);
 
@@ -380,6 +429,21 @@ bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) cons
     return hasDesktopOrESVersion(*this, GLVersion::v4_3, GLVersion::v3_2_ES) ||
            hasExtension(Extensions::Debug) || hasExtension(Extensions::DebugMarker);
 
+  case InternalFeatures::DirectStateAccess:
+    return hasDesktopVersion(*this, GLVersion::v4_5) ||
+           hasDesktopExtension(*this, "GL_ARB_direct_state_access");
+
+  case InternalFeatures::DrawBaseInstance:
+    return hasDesktopVersion(*this, GLVersion::v4_2) ||
+           hasDesktopExtension(*this, "GL_ARB_base_instance");
+
+  case InternalFeatures::DrawBaseVertex:
+    return hasDesktopOrESVersion(*this, GLVersion::v3_2, GLVersion::v3_2_ES) ||
+           hasDesktopExtension(*this, "GL_ARB_draw_elements_base_vertex");
+
+  case InternalFeatures::DrawInstanced:
+    return hasDesktopOrESVersion(*this, GLVersion::v3_1, GLVersion::v3_0_ES);
+
   case InternalFeatures::FramebufferBlit:
     // TODO: Add support for GL_ANGLE_framebuffer_blit
     return hasDesktopOrESVersionOrExtension(
@@ -401,6 +465,15 @@ bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) cons
   case InternalFeatures::MapBuffer:
     return hasDesktopVersion(*this, GLVersion::v2_0) || hasExtension(Extensions::MapBuffer);
 
+  case InternalFeatures::MultiBind:
+    return hasDesktopVersion(*this, GLVersion::v4_4) ||
+           hasDesktopExtension(*this, "GL_ARB_multi_bind");
+
+  case InternalFeatures::MultiDrawIndirect:
+    return hasDesktopVersion(*this, GLVersion::v4_3) ||
+           hasDesktopExtension(*this, "GL_ARB_multi_draw_indirect") ||
+           hasExtension(Extensions::MultiDrawIndirect);
+
   case InternalFeatures::PixelBufferObject:
     return hasDesktopOrESVersionOrExtension(*this,
                                             GLVersion::v2_1,
@@ -411,10 +484,19 @@ bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) cons
   case InternalFeatures::PolygonFillMode:
     return hasDesktopVersion(*this, GLVersion::v2_0);
 
+  case InternalFeatures::ProgramBinary:
+    // WebGL has no program binaries
+    return !IGL_PLATFORM_EMSCRIPTEN &&
+           (hasDesktopOrESVersion(*this, GLVersion::v4_1, GLVersion::v3_0_ES) ||
+            hasDesktopExtension(*this, "GL_ARB_get_program_binary"));
+
   case InternalFeatures::ProgramInterfaceQuery:
     return hasDesktopOrESVersion(*this, GLVersion::v4_3, GLVersion::v3_1_ES) ||
            hasDesktopExtension(*this, "GL_ARB_program_interface_query");
 
+  case InternalFeatures::QueryObjects:
+    return hasDesktopOrESVersion(*this, GLVersion::v2_0, GLVersion::v3_0_ES);
+
   case InternalFeatures::SeamlessCubeMap:
     return hasDesktopVersionOrExtension(*this, GLVersion::v3_2, "GL_ARB_seamless_cube_map");
 
@@ -436,6 +518,14 @@ bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) cons
     return hasDesktopOrESVersion(*this, GLVersion::v2_0, GLVersion::v3_0_ES) ||
            hasESExtension(*this, "GL_EXT_shadow_samplers");
 
+  case InternalFeatures::TextureView:
+    return hasDesktopVersionOrExtension(*this, GLVersion::v4_3, "GL_ARB_texture_view") ||
+           hasExtension(Extensions::TextureView);
+
+  case InternalFeatures::TimerQuery:
+    return hasDesktopVersionOrExtension(*this, GLVersion::v3_3, "GL_ARB_timer_query") ||
+           hasExtension(Extensions::DisjointTimerQuery);
+
   case InternalFeatures::UnmapBuffer:
     return hasDesktopVersion(*this, GLVersion::v2_0) || hasExtension(Extensions::MapBuffer) ||
            hasExtension(Extensions::MapBufferRange);
@@ -868,6 +958,10 @@ bool DeviceFeatureSet::hasInternalRequirement(InternalRequirement requirement) c
   case InternalRequirement::ColorTexImageRgbApple422Unsized:
     return usesOpenGLES() && !hasESVersion(*this, GLVersion::v3_0_ES);
 
+  case InternalRequirement::BufferStorageExtReq:
+    // glBufferStorage is only available on OpenGL ES through GL_EXT_buffer_storage
+    return usesOpenGLES();
+
   case InternalRequirement::DebugExtReq:
     return !hasDesktopOrESVersion(*this, GLVersion::v4_3, GLVersion::v3_2_ES);
 
@@ -898,6 +992,10 @@ bool DeviceFeatureSet::hasInternalRequirement(InternalRequirement requirement) c
     // OpenGL ES 2 does not include MapBufferRange
     return usesOpenGLES() && !hasESVersion(*this, GLVersion::v3_0_ES);
 
+  case InternalRequirement::MultiDrawIndirectExtReq:
+    // glMultiDraw*Indirect is only available on OpenGL ES through GL_EXT_multi_draw_indirect
+    return usesOpenGLES();
+
   case InternalRequirement::MultiSampleExtReq:
     // OpenGL ES has various extensions before 3.0 that are required, and
     // GL_IMG_multisampled_render_to_texture uses different enum values than later standard
@@ -928,6 +1026,14 @@ bool DeviceFeatureSet::hasInternalRequirement(InternalRequirement requirement) c
     // GL_HALF_FLOAT.
     return usesOpenGLES() && !hasESVersion(*this, GLVersion::v3_0_ES);
 
+  case InternalRequirement::TextureViewExtReq:
+    // glTextureView is only available on OpenGL ES through GL_EXT_texture_view
+    return usesOpenGLES();
+
+  case InternalRequirement::TimerQueryExtReq:
+    // Timestamp queries are only available on OpenGL ES through GL_EXT_disjoint_timer_query
+    return usesOpenGLES();
+
   case InternalRequirement::UnmapBufferExtReq:
     // OpenGL ES 2 does not include UnmapBuffer
     return usesOpenGLES() && !hasESVersion(*this, GLVersion::v3_0_ES);
@@ -976,7 +1082,7 @@ bool DeviceFeatureSet::getFeatureLimits(DeviceFeatureLimits featureLimits, size_
     result = (size_t)tsize;
     return true;
   case DeviceFeatureLimits::MaxPushConstantBytes:
-    result = 0;
+    result = hasFeature(DeviceFeatures::PushConstants) ? kMaxPushConstantBytes : 0;
     return true;
   case DeviceFeatureLimits::MaxUniformBufferBytes:
     tsize = 0;
@@ -986,7 +1092,7 @@ bool DeviceFeatureSet::getFeatureLimits(DeviceFeatureLimits featureLimits, size_
     result = (size_t)tsize;
     return true;
   case DeviceFeatureLimits::PushConstantsAlignment:
-    result = 0;
+    result = hasFeature(DeviceFeatures::PushConstants) ? 4 : 0;
     return true;
   case DeviceFeatureLimits::ShaderStorageBufferOffsetAlignment:
     tsize = 256;
@@ -997,6 +1103,13 @@ bool DeviceFeatureSet::getFeatureLimits(DeviceFeatureLimits featureLimits, size_
 #endif
     result = (size_t)tsize;
     return true;
+  case DeviceFeatureLimits::UniformBufferOffsetAlignment:
+    tsize = 256;
+    if (hasFeature(DeviceFeatures::UniformBlocks)) {
+      glContext_.getIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &tsize);
+    }
+    result = (size_t)tsize;
+    return true;
   case DeviceFeatureLimits::BufferAlignment:
     result = 16;
     return true;
@@ -1004,6 +1117,12 @@ bool DeviceFeatureSet::getFeatureLimits(DeviceFeatureLimits featureLimits, size_
     result = 0;
     return true;
   case DeviceFeatureLimits::MaxBindBytesBytes:
+    result = hasFeature(DeviceFeatures::UniformBlocks) ? UniformArena::kMaxAllocationSize : 0;
+    return true;
+  case DeviceFeatureLimits::MinSubgroupSize:
+  case DeviceFeatureLimits::MaxSubgroupSize:
+  case DeviceFeatureLimits::SubgroupOperations:
+    // GL_KHR_shader_subgroup is not used
     result = 0;
     return true;
   default:
@@ -1444,6 +1563,13 @@ ICapabilities::TextureFormatCapabilities DeviceFeatureSet::getTextureFormatCapab
       capabilities |= compressed;
     }
     break;
+  case TextureFormat::YUV_NV12:
+  case TextureFormat::YUV_P010:
+    // Sampled through GL_TEXTURE_EXTERNAL_OES, which converts to RGB in the sampler
+    if (hasFeature(DeviceFeatures::TextureExternalImage)) {
+      capabilities |= sampled | sampledFiltered;
+    }
+    break;
   default:
     // We are relying on the fact that TextureFormatCapabilities::Unsupported is 0
     return textureCapabilityCache_[format];
@@ -23,12 +23,14 @@ enum class Extensions {
   AppleRgb422,                // GL_APPLE_rgb_422 is supported
   BindlessTextureArb,         // GL_ARB_bindless_texture is supported
   BindlessTextureNv,          // GL_NV_bindless_texture is supported
+  BufferStorage,              // GL_EXT_buffer_storage is supported
   Debug,                      // GL_KHR_debug is supported
   DebugMarker,                // GL_EXT_debug_marker is supported
   Depth24,                    // GL_OES_depth24 is supported
   Depth32,                    // GL_OES_depth32 is supported
   DepthTexture,               // GL_OES_depth_texture is supported
   DiscardFramebuffer,         // GL_EXT_discard_framebuffer is supported
+  DisjointTimerQuery,         // GL_EXT_disjoint_timer_query is supported
   Es2Compatibility,           // GL_ARB_ES2_compatibility is supported
   DrawBuffers,                // GL_EXT_draw_buffers is supported
   FramebufferBlit,            // GL_EXT_framebuffer_blit is supported
@@ -36,10 +38,13 @@ enum class Extensions {
   InvalidateSubdata,          // GL_ARB_invalidate_subdata is supported
   MapBuffer,                  // GL_OES_mapbuffer is supported
   MapBufferRange,             // GL_EXT_map_buffer_range is supported
+  MultiDrawIndirect,          // GL_EXT_multi_draw_indirect is supported
   MultiSampleApple,           // GL_APPLE_framebuffer_multisample is supported
   MultiSampleExt,             // GL_EXT_multisampled_render_to_texture is supported
   MultiSampleImg,             // GL_IMG_multisampled_render_to_texture is supported
+  ParallelShaderCompile,      // GL_KHR_parallel_shader_compile is supported
   RequiredInternalFormat,     // GL_OES_required_internalformat is supported
+  ShaderFramebufferFetch,     // GL_EXT_shader_framebuffer_fetch is supported
   ShaderImageLoadStore,       // GL_EXT_shader_image_load_store is supported
   Srgb,                       // GL_EXT_sRGB is supported
   SrgbWriteControl,           // GL_EXT_sRGB_write_control is supported
@@ -54,6 +59,7 @@ enum class Extensions {
   TextureRgExt,               // GL_EXT_texture_rg is supported
   TextureSrgb,                // GL_EXT_texture_sRGB is supported
   TextureType2_10_10_10_Rev,  // GL_EXT_texture_type_2_10_10_10_REV is supporteds
+  TextureView,                // GL_EXT_texture_view is supported
   VertexArrayObject,          // GL_OES_vertex_array_object is supported
   VertexAttribDivisor,        // GL_NV_instanced_arrays is supported
 };
@@ -61,21 +67,32 @@ enum class Extensions {
 
 // clang-format off
 enum class InternalFeatures {
+  BufferStorage,             // glBufferStorage is supported
   ClearDepthf,               // glClearDepthf is supported
   Debug,                     // Debug messages and group markers are supported
+  DirectStateAccess,         // glNamedBufferSubData and glTextureParameteri are supported
+  DrawBaseInstance,          // glDraw*InstancedBaseInstance are supported
+  DrawBaseVertex,            // glDrawElementsInstancedBaseVertex is supported
+  DrawInstanced,             // glDrawArraysInstanced and glDrawElementsInstanced are supported
   FramebufferBlit,           // BlitFramebuffer is supported
   FramebufferObject,         // Framebuffer objects are supported
   GetStringi,                // GetStringi is supported
   InvalidateFramebuffer,     // glInvalidateFramebuffer is supported
   MapBuffer,                 // glMapBuffer is supported
+  MultiBind,                 // glBindTextures and glBindBuffersRange are supported
+  MultiDrawIndirect,         // glMultiDraw*Indirect is supported
   PixelBufferObject,         // PBOs are available
   PolygonFillMode,           // glPolygonFillMode is supported
+  ProgramBinary,             // glGetProgramBinary and glProgramBinary are supported
   ProgramInterfaceQuery,     // Querying info about shader program interfaces is supported
+  QueryObjects,              // glGenQueries, glBeginQuery and glEndQuery are supported
   SeamlessCubeMap,           // GL_TEXTURE_CUBE_MAP_SEAMLESS is supported
   ShaderImageLoadStore,      // Shader image load/store is supported
   Sync,                      // Sync objects are supported
   TexStorage,                // glTexStorage* is available
   TextureCompare,            // GL_TEXTURE_COMPARE_MODE and GL_TEXTURE_COMPARE_FUNC are supported
+  TextureView,               // glTextureView is supported
+  TimerQuery,                // glQueryCounter with GL_TIMESTAMP is supported
   UnmapBuffer,               // glUnmapBuffer is supported
   VertexArrayObject,         // VAOS are available
   VertexAttribDivisor,       // glVertexAttribDivisor is supported
@@ -148,6 +165,7 @@ enum class TextureFeatures {
 // clang-format on
 
 enum class InternalRequirement {
+  BufferStorageExtReq,
   ColorTexImageRgb10A2Unsized,
   ColorTexImageRgb5A1Unsized,
   ColorTexImageRgba4Unsized,
@@ -160,6 +178,7 @@ enum class InternalRequirement {
   InvalidateFramebufferExtReq,
   MapBufferExtReq,
   MapBufferRangeExtReq,
+  MultiDrawIndirectExtReq,
   MultiSampleExtReq,
   ShaderImageLoadStoreExtReq,
   SyncExtReq,
@@ -167,6 +186,8 @@ enum class InternalRequirement {
   TexStorageExtReq,
   Texture3DExtReq,
   TextureHalfFloatExtReq,
+  TextureViewExtReq,
+  TimerQueryExtReq,
   UnmapBufferExtReq,
   VertexArrayObjectExtReq,
   VertexAttribDivisorExtReq,
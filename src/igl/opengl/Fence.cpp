@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/Fence.h>
+
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+Fence::Fence(IContext& context, GLsync sync) : WithContext(context), sync_(sync) {}
+
+Fence::~Fence() {
+  getContext().deleteSync(sync_);
+}
+
+bool Fence::isSignaled() const {
+  GLint status = GL_UNSIGNALED;
+  getContext().getSynciv(sync_, GL_SYNC_STATUS, 1, nullptr, &status);
+  return status == GL_SIGNALED;
+}
+
+bool Fence::waitUntilSignaled(uint64_t timeoutNanoseconds) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+
+  // glClientWaitSync() has no infinite timeout, so the wait is retried until the fence is signaled
+  GLenum status = GL_TIMEOUT_EXPIRED;
+  do {
+    status = getContext().clientWaitSync(sync_, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNanoseconds);
+  } while (status == GL_TIMEOUT_EXPIRED && timeoutNanoseconds == UINT64_MAX);
+  IGL_ASSERT(status != GL_WAIT_FAILED);
+  return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+Result Fence::exportNativeHandle(FenceHandleType /*type*/,
+                                 FenceNativeHandle& /*outHandle*/) const {
+  return Result(Result::Code::Unsupported, "OpenGL fences cannot be exported");
+}
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Fence.h>
+#include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/WithContext.h>
+
+namespace igl {
+namespace opengl {
+
+/// A GLsync inserted into the command stream of the context. Sync fds are not exported here; on
+/// Android, EGL native fences are available through INativeHWBufferInterop::createReleaseFence().
+class Fence final : public WithContext, public IFence {
+ public:
+  Fence(IContext& context, GLsync sync);
+  ~Fence() override;
+
+  [[nodiscard]] bool isSignaled() const override;
+  bool waitUntilSignaled(uint64_t timeoutNanoseconds = UINT64_MAX) const override;
+  Result exportNativeHandle(FenceHandleType type, FenceNativeHandle& outHandle) const override;
+
+ private:
+  GLsync sync_;
+};
+
+} // namespace opengl
+} // namespace igl
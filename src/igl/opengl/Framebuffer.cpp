@@ -244,9 +244,12 @@ void Framebuffer::copyBytesColorAttachment(ICommandQueue& /* unused */,
                               GL_UNSIGNED_BYTE,
                               pixelBytes);
     }
+#if IGL_DEBUG
+    // glGetError() is a synchronous round trip on some platforms (WebGL), keep it out of release
     getContext().checkForErrors(nullptr, 0);
     auto error = getContext().getLastError();
     IGL_ASSERT_MSG(error.isOk(), error.message.c_str());
+#endif // IGL_DEBUG
   } else {
     IGL_ASSERT_NOT_IMPLEMENTED();
   }
@@ -355,14 +358,17 @@ std::shared_ptr<ITexture> CustomFramebuffer::updateDrawable(std::shared_ptr<ITex
     bindBuffer();
     curAttachment.detachAsColor(0, true);
     renderTarget_.colorAttachments.erase(0);
+    implicitResolve_ = false;
   }
 
   if (texture != nullptr && getColorAttachment(0) != texture) {
     FramebufferBindingGuard guard(getContext());
     bindBuffer();
-    attachAsColor(*texture, 0, defaultWriteAttachmentParams(renderTarget_.mode));
-
     renderTarget_.colorAttachments[0].texture = texture;
+
+    auto params = defaultWriteAttachmentParams(renderTarget_.mode);
+    params.implicitResolveSamples = getImplicitResolveSamples(0);
+    attachAsColor(*getAttachedColorTexture(0), 0, params);
   }
 
   return texture;
@@ -412,13 +418,16 @@ void CustomFramebuffer::prepareResource(Result* outResult) {
 
   std::vector<GLenum> drawBuffers;
 
+  implicitResolve_ = canResolveImplicitly();
+
   const auto attachmentParams = defaultWriteAttachmentParams(renderTarget_.mode);
   // attach the textures and render buffers to the frame buffer
   for (const auto& colorAttachment : renderTarget_.colorAttachments) {
-    auto const colorAttachmentTexture = colorAttachment.second.texture;
-    if (colorAttachmentTexture != nullptr) {
+    if (colorAttachment.second.texture != nullptr) {
       size_t index = colorAttachment.first;
-      attachAsColor(*colorAttachmentTexture, static_cast<uint32_t>(index), attachmentParams);
+      auto colorParams = attachmentParams;
+      colorParams.implicitResolveSamples = getImplicitResolveSamples(index);
+      attachAsColor(*getAttachedColorTexture(index), static_cast<uint32_t>(index), colorParams);
       drawBuffers.push_back(static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + index));
     }
   }
@@ -450,7 +459,7 @@ void CustomFramebuffer::prepareResource(Result* outResult) {
   FramebufferDesc resolveDesc;
   auto createResolveFramebuffer = false;
   for (const auto& colorAttachment : renderTarget_.colorAttachments) {
-    if (colorAttachment.second.resolveTexture) {
+    if (colorAttachment.second.resolveTexture && !implicitResolve_) {
       createResolveFramebuffer = true;
       FramebufferDesc::AttachmentDesc attachment;
       attachment.texture = colorAttachment.second.resolveTexture;
@@ -487,6 +496,41 @@ void CustomFramebuffer::prepareResource(Result* outResult) {
   }
 }
 
+bool CustomFramebuffer::canResolveImplicitly() const {
+  const auto& features = getContext().deviceFeatures();
+  if (!features.hasExtension(Extensions::MultiSampleExt) &&
+      !features.hasExtension(Extensions::MultiSampleImg)) {
+    return false;
+  }
+  // the extensions only support color attachment 0; depth and stencil resolves are blitted
+  if (renderTarget_.colorAttachments.size() != 1 || renderTarget_.depthAttachment.resolveTexture ||
+      renderTarget_.stencilAttachment.resolveTexture) {
+    return false;
+  }
+  const auto it = renderTarget_.colorAttachments.find(0);
+  if (it == renderTarget_.colorAttachments.end() || !it->second.texture ||
+      !it->second.resolveTexture) {
+    return false;
+  }
+  const auto& texture = *it->second.texture;
+  const auto& resolveTexture = *it->second.resolveTexture;
+  // renderbuffers cannot be attached with glFramebufferTexture2DMultisampleEXT()
+  return texture.getSamples() > 1 && resolveTexture.getSamples() == 1 &&
+         resolveTexture.getType() == TextureType::TwoD &&
+         (resolveTexture.getUsage() & TextureDesc::TextureUsageBits::Sampled) != 0;
+}
+
+std::shared_ptr<ITexture> CustomFramebuffer::getAttachedColorTexture(size_t index) const {
+  const auto& attachment = renderTarget_.colorAttachments.at(index);
+  return implicitResolve_ && index == 0 ? attachment.resolveTexture : attachment.texture;
+}
+
+uint32_t CustomFramebuffer::getImplicitResolveSamples(size_t index) const {
+  return implicitResolve_ && index == 0
+             ? renderTarget_.colorAttachments.at(0).texture->getSamples()
+             : 0;
+}
+
 Viewport CustomFramebuffer::getViewport() const {
   auto texture = getColorAttachment(0);
 
@@ -535,11 +579,14 @@ void CustomFramebuffer::bind(const RenderPassDesc& renderPass) const {
         renderPassAttachment.face > 0 || renderPassAttachment.mipLevel > 0;
 
     if (needsToBeReattached) {
-      attachAsColor(*colorAttachmentTexture,
-                    static_cast<uint32_t>(index),
-                    toAttachmentParams(renderPassAttachment, renderTarget_.mode));
+      auto params = toAttachmentParams(renderPassAttachment, renderTarget_.mode);
+      params.implicitResolveSamples = getImplicitResolveSamples(index);
+      attachAsColor(*getAttachedColorTexture(index), static_cast<uint32_t>(index), params);
     }
   }
+  // tell tile-based GPUs not to reload attachments whose contents are not needed
+  invalidateAttachments(false);
+
   // clear the buffers if we're not loading previous contents
   GLbitfield clearMask = 0;
   auto colorAttachment0 = renderTarget_.colorAttachments.find(0);
@@ -574,33 +621,73 @@ void CustomFramebuffer::bind(const RenderPassDesc& renderPass) const {
 }
 
 void CustomFramebuffer::unbind() const {
-  // discard the depthStencil if we don't need to store its contents
-  GLenum attachments[3];
-  GLsizei numAttachments = 0;
-  auto colorAttachment0 = renderTarget_.colorAttachments.find(0);
-
-  if (colorAttachment0 != renderTarget_.colorAttachments.end() &&
-      colorAttachment0->second.texture != nullptr &&
-      renderPass_.colorAttachments[0].storeAction != StoreAction::Store) {
-    attachments[numAttachments++] = GL_COLOR_ATTACHMENT0;
-  }
-  if (renderTarget_.depthAttachment.texture != nullptr) {
-    if (renderPass_.depthAttachment.storeAction != StoreAction::Store) {
-      attachments[numAttachments++] = GL_DEPTH_ATTACHMENT;
-    }
-  }
   if (renderTarget_.stencilAttachment.texture != nullptr) {
     getContext().disable(GL_STENCIL_TEST);
-    if (renderPass_.stencilAttachment.storeAction != StoreAction::Store) {
-      attachments[numAttachments++] = GL_STENCIL_ATTACHMENT;
-    }
   }
+  // the framebuffer may no longer be bound after an MSAA resolve
+  bindBuffer();
+  invalidateAttachments(true);
+}
+
+void CustomFramebuffer::invalidateAttachments(bool endOfRenderPass) const {
+  std::vector<GLenum> attachments;
+  // contents are not needed before a render pass unless they are loaded, and after it unless they
+  // are stored. Memoryless attachments are always discarded at the end
+  const auto isDiscarded = [endOfRenderPass](const std::shared_ptr<ITexture>& texture,
+                                             LoadAction loadAction,
+                                             StoreAction storeAction,
+                                             GLenum attachment) {
+    auto& glTexture = static_cast<Texture&>(*texture);
+    if (!endOfRenderPass) {
+      if (loadAction == LoadAction::Load && glTexture.areContentsDiscarded()) {
+        IGL_LOG_INFO_ONCE(
+            "Framebuffer attachment 0x%x is loaded after its contents were discarded; use "
+            "LoadAction::Clear or LoadAction::DontCare to avoid a tile reload\n",
+            attachment);
+      }
+      return loadAction == LoadAction::DontCare;
+    }
+    const bool discarded =
+        (storeAction != StoreAction::Store && storeAction != StoreAction::StoreAndMsaaResolve) ||
+        glTexture.isMemoryless();
+    glTexture.setContentsDiscarded(discarded);
+    return discarded;
+  };
 
-  if (numAttachments > 0) {
-    auto& features = getContext().deviceFeatures();
-    if (features.hasInternalFeature(InternalFeatures::InvalidateFramebuffer)) {
-      getContext().invalidateFramebuffer(GL_FRAMEBUFFER, numAttachments, attachments);
+  for (const auto& colorAttachment : renderTarget_.colorAttachments) {
+    const size_t index = colorAttachment.first;
+    if (colorAttachment.second.texture == nullptr ||
+        index >= renderPass_.colorAttachments.size()) {
+      continue;
     }
+    const GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(index);
+    const auto& desc = renderPass_.colorAttachments[index];
+    // implicitly resolved samples are only written to the resolve texture, which keeps them
+    const StoreAction storeAction =
+        implicitResolve_ && isMsaaResolve(desc.storeAction) ? StoreAction::Store : desc.storeAction;
+    if (isDiscarded(getAttachedColorTexture(index), desc.loadAction, storeAction, attachment)) {
+      attachments.push_back(attachment);
+    }
+  }
+  if (renderTarget_.depthAttachment.texture != nullptr &&
+      isDiscarded(renderTarget_.depthAttachment.texture,
+                  renderPass_.depthAttachment.loadAction,
+                  renderPass_.depthAttachment.storeAction,
+                  GL_DEPTH_ATTACHMENT)) {
+    attachments.push_back(GL_DEPTH_ATTACHMENT);
+  }
+  if (renderTarget_.stencilAttachment.texture != nullptr &&
+      isDiscarded(renderTarget_.stencilAttachment.texture,
+                  renderPass_.stencilAttachment.loadAction,
+                  renderPass_.stencilAttachment.storeAction,
+                  GL_STENCIL_ATTACHMENT)) {
+    attachments.push_back(GL_STENCIL_ATTACHMENT);
+  }
+
+  if (!attachments.empty() &&
+      getContext().deviceFeatures().hasInternalFeature(InternalFeatures::InvalidateFramebuffer)) {
+    getContext().invalidateFramebuffer(
+        GL_FRAMEBUFFER, static_cast<GLsizei>(attachments.size()), attachments.data());
   }
 }
 
@@ -674,20 +761,34 @@ void CurrentFramebuffer::bind(const RenderPassDesc& renderPass) const {
   }
 #endif
 
+  renderPass_ = renderPass;
+
+  // DontCare attachments are invalidated if possible, otherwise cleared, so tile-based GPUs never
+  // reload their contents
+  const bool canInvalidate =
+      getContext().deviceFeatures().hasInternalFeature(InternalFeatures::InvalidateFramebuffer);
+  const auto needsClear = [canInvalidate](LoadAction loadAction) {
+    return loadAction == LoadAction::Clear ||
+           (loadAction == LoadAction::DontCare && !canInvalidate);
+  };
+  if (canInvalidate) {
+    invalidateAttachments(false);
+  }
+
   // clear the buffers if we're not loading previous contents
   GLbitfield clearMask = 0;
-  if (renderPass.colorAttachments[0].loadAction != LoadAction::Load) {
+  if (needsClear(renderPass.colorAttachments[0].loadAction)) {
     clearMask |= GL_COLOR_BUFFER_BIT;
     auto clearColor = renderPass.colorAttachments[0].clearColor;
     getContext().colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
     getContext().clearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
   }
-  if (renderPass.depthAttachment.loadAction != LoadAction::Load) {
+  if (needsClear(renderPass.depthAttachment.loadAction)) {
     clearMask |= GL_DEPTH_BUFFER_BIT;
     getContext().depthMask(GL_TRUE);
     getContext().clearDepthf(renderPass.depthAttachment.clearDepth);
   }
-  if (renderPass.stencilAttachment.loadAction != LoadAction::Load) {
+  if (needsClear(renderPass.stencilAttachment.loadAction)) {
     clearMask |= GL_STENCIL_BUFFER_BIT;
     getContext().stencilMask(0xFF);
     getContext().clearStencil(renderPass.stencilAttachment.clearStencil);
@@ -699,7 +800,39 @@ void CurrentFramebuffer::bind(const RenderPassDesc& renderPass) const {
 }
 
 void CurrentFramebuffer::unbind() const {
-  // no-op
+  if (!getContext().deviceFeatures().hasInternalFeature(InternalFeatures::InvalidateFramebuffer)) {
+    return;
+  }
+  bindBuffer();
+  invalidateAttachments(true);
+}
+
+void CurrentFramebuffer::invalidateAttachments(bool endOfRenderPass) const {
+  const auto isDiscarded = [endOfRenderPass](LoadAction loadAction, StoreAction storeAction) {
+    return endOfRenderPass ? storeAction != StoreAction::Store &&
+                                 storeAction != StoreAction::StoreAndMsaaResolve
+                           : loadAction == LoadAction::DontCare;
+  };
+  // the default framebuffer uses different attachment names
+  const bool isDefault = frameBufferID_ == 0;
+  std::vector<GLenum> attachments;
+  if (!renderPass_.colorAttachments.empty() &&
+      isDiscarded(renderPass_.colorAttachments[0].loadAction,
+                  renderPass_.colorAttachments[0].storeAction)) {
+    attachments.push_back(isDefault ? GL_COLOR : GL_COLOR_ATTACHMENT0);
+  }
+  if (isDiscarded(renderPass_.depthAttachment.loadAction,
+                  renderPass_.depthAttachment.storeAction)) {
+    attachments.push_back(isDefault ? GL_DEPTH : GL_DEPTH_ATTACHMENT);
+  }
+  if (isDiscarded(renderPass_.stencilAttachment.loadAction,
+                  renderPass_.stencilAttachment.storeAction)) {
+    attachments.push_back(isDefault ? GL_STENCIL : GL_STENCIL_ATTACHMENT);
+  }
+  if (!attachments.empty()) {
+    getContext().invalidateFramebuffer(
+        GL_FRAMEBUFFER, static_cast<GLsizei>(attachments.size()), attachments.data());
+  }
 }
 
 } // namespace opengl
@@ -120,8 +120,22 @@ class CustomFramebuffer final : public Framebuffer {
 
  private:
   void prepareResource(Result* outResult);
+  // true if GL_EXT_multisampled_render_to_texture (or the IMG variant) renders the multisampled
+  // color attachment 0 directly into its resolve texture
+  bool canResolveImplicitly() const;
+  // the texture attached to the GL attachment point of the color attachment `index`
+  std::shared_ptr<ITexture> getAttachedColorTexture(size_t index) const;
+  // the samples the texture attached for the color attachment `index` is rendered with implicitly,
+  // or 0
+  uint32_t getImplicitResolveSamples(size_t index) const;
+  // invalidates the attachments whose contents are not loaded (at the start of a render pass) or
+  // not stored (at its end)
+  void invalidateAttachments(bool endOfRenderPass) const;
 
   bool initialized_ = false;
+  // canResolveImplicitly(): the resolve texture of color attachment 0 is attached instead of the
+  // multisampled texture, which is never used, and there is no color resolve framebuffer
+  bool implicitResolve_ = false;
 
   friend class Framebuffer; // Needed to enable copyBytesColorAttachment
   FramebufferDesc renderTarget_; // attachments
@@ -148,8 +162,13 @@ class CurrentFramebuffer final : public Framebuffer {
   void unbind() const override;
 
  private:
+  // invalidates the attachments which are not loaded (at the start of a render pass) or not stored
+  // (at its end)
+  void invalidateAttachments(bool endOfRenderPass) const;
+
   Viewport viewport_;
   std::shared_ptr<ITexture> colorAttachment_;
+  mutable RenderPassDesc renderPass_;
 };
 
 } // namespace opengl
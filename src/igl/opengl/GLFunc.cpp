@@ -138,9 +138,19 @@ IGL_EXTERN_BEGIN
 #define CAN_CALL_glMapBuffer 0
 #endif
 #if IGL_OPENGL || defined(GL_ES_VERSION_3_0)
+#define CAN_CALL_glBeginQuery OPENGL_OR_CAN_CALL
 #define CAN_CALL_glDrawBuffers OPENGL_OR_CAN_CALL
+#define CAN_CALL_glEndQuery OPENGL_OR_CAN_CALL
+#define CAN_CALL_glDeleteQueries OPENGL_OR_CAN_CALL
+#define CAN_CALL_glGenQueries OPENGL_OR_CAN_CALL
+#define CAN_CALL_glGetQueryObjectuiv OPENGL_OR_CAN_CALL
 #else
+#define CAN_CALL_glBeginQuery 0
 #define CAN_CALL_glDrawBuffers 0
+#define CAN_CALL_glEndQuery 0
+#define CAN_CALL_glDeleteQueries 0
+#define CAN_CALL_glGenQueries 0
+#define CAN_CALL_glGetQueryObjectuiv 0
 #endif
 #if IGL_OPENGL || defined(GL_ES_VERSION_3_0)
 #define CAN_CALL_glCompressedTexImage3D OPENGL_OR_CAN_CALL
@@ -174,6 +184,26 @@ IGL_EXTERN_BEGIN
 #else
 #define CAN_CALL_glVertexAttribDivisor 0
 #endif
+#if defined(GL_VERSION_3_1) || defined(GL_ES_VERSION_3_0)
+#define CAN_CALL_glDrawArraysInstanced CAN_CALL
+#define CAN_CALL_glDrawElementsInstanced CAN_CALL
+#else
+#define CAN_CALL_glDrawArraysInstanced 0
+#define CAN_CALL_glDrawElementsInstanced 0
+#endif
+#if defined(GL_VERSION_3_2) || defined(GL_ES_VERSION_3_2) || \
+    defined(GL_ARB_draw_elements_base_vertex)
+#define CAN_CALL_glDrawElementsInstancedBaseVertex CAN_CALL
+#else
+#define CAN_CALL_glDrawElementsInstancedBaseVertex 0
+#endif
+#if defined(GL_VERSION_4_2) || defined(GL_ARB_base_instance)
+#define CAN_CALL_glDrawArraysInstancedBaseInstance CAN_CALL_OPENGL
+#define CAN_CALL_glDrawElementsInstancedBaseVertexBaseInstance CAN_CALL_OPENGL
+#else
+#define CAN_CALL_glDrawArraysInstancedBaseInstance 0
+#define CAN_CALL_glDrawElementsInstancedBaseVertexBaseInstance 0
+#endif
 
 void iglDebugMessageInsert(GLenum source,
                            GLenum type,
@@ -246,10 +276,36 @@ void iglCompressedTexSubImage3D(GLenum target,
                           data);
 }
 
+void iglBeginQuery(GLenum target, GLuint id) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glBeginQuery, glBeginQuery, PFNIGLBEGINQUERYPROC, target, id);
+}
+
+void iglDeleteQueries(GLsizei n, const GLuint* ids) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glDeleteQueries, glDeleteQueries, PFNIGLDELETEQUERIESPROC, n, ids);
+}
+
 void iglDrawBuffers(GLsizei n, const GLenum* bufs) {
   GLEXTENSION_METHOD_BODY(CAN_CALL_glDrawBuffers, glDrawBuffers, PFNIGLDRAWBUFFERSPROC, n, bufs);
 }
 
+void iglEndQuery(GLenum target) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glEndQuery, glEndQuery, PFNIGLENDQUERYPROC, target);
+}
+
+void iglGenQueries(GLsizei n, GLuint* ids) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGenQueries, glGenQueries, PFNIGLGENQUERIESPROC, n, ids);
+}
+
+void iglGetQueryObjectuiv(GLuint id, GLenum pname, GLuint* params) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetQueryObjectuiv,
+                          glGetQueryObjectuiv,
+                          PFNIGLGETQUERYOBJECTUIVPROC,
+                          id,
+                          pname,
+                          params);
+}
+
 const GLubyte* iglGetStringi(GLenum name, GLint index) {
   GLEXTENSION_METHOD_BODY_WITH_RETURN(
       CAN_CALL_glGetStringi, glGetStringi, PFNIGLGETSTRINGIPROC, nullptr, name, index);
@@ -326,6 +382,82 @@ void iglTexSubImage3D(GLenum target,
                           pixels);
 }
 
+void iglDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glDrawArraysInstanced,
+                          glDrawArraysInstanced,
+                          PFNIGLDRAWARRAYSINSTANCEDPROC,
+                          mode,
+                          first,
+                          count,
+                          instancecount);
+}
+
+void iglDrawArraysInstancedBaseInstance(GLenum mode,
+                                        GLint first,
+                                        GLsizei count,
+                                        GLsizei instancecount,
+                                        GLuint baseinstance) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glDrawArraysInstancedBaseInstance,
+                          glDrawArraysInstancedBaseInstance,
+                          PFNIGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC,
+                          mode,
+                          first,
+                          count,
+                          instancecount,
+                          baseinstance);
+}
+
+void iglDrawElementsInstanced(GLenum mode,
+                              GLsizei count,
+                              GLenum type,
+                              const GLvoid* indices,
+                              GLsizei instancecount) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glDrawElementsInstanced,
+                          glDrawElementsInstanced,
+                          PFNIGLDRAWELEMENTSINSTANCEDPROC,
+                          mode,
+                          count,
+                          type,
+                          indices,
+                          instancecount);
+}
+
+void iglDrawElementsInstancedBaseVertex(GLenum mode,
+                                        GLsizei count,
+                                        GLenum type,
+                                        const GLvoid* indices,
+                                        GLsizei instancecount,
+                                        GLint basevertex) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glDrawElementsInstancedBaseVertex,
+                          glDrawElementsInstancedBaseVertex,
+                          PFNIGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC,
+                          mode,
+                          count,
+                          type,
+                          indices,
+                          instancecount,
+                          basevertex);
+}
+
+void iglDrawElementsInstancedBaseVertexBaseInstance(GLenum mode,
+                                                    GLsizei count,
+                                                    GLenum type,
+                                                    const GLvoid* indices,
+                                                    GLsizei instancecount,
+                                                    GLint basevertex,
+                                                    GLuint baseinstance) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glDrawElementsInstancedBaseVertexBaseInstance,
+                          glDrawElementsInstancedBaseVertexBaseInstance,
+                          PFNIGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC,
+                          mode,
+                          count,
+                          type,
+                          indices,
+                          instancecount,
+                          basevertex,
+                          baseinstance);
+}
+
 void iglUnmapBuffer(GLenum target) {
   GLEXTENSION_METHOD_BODY(CAN_CALL_glUnmapBuffer, glUnmapBuffer, PFNIGLUNMAPBUFFERPROC, target);
 }
@@ -366,15 +498,27 @@ void iglRenderbufferStorageMultisampleAPPLE(GLenum target,
 /// MARK: - GL_APPLE_sync
 
 #if defined(GL_APPLE_sync)
+#define CAN_CALL_glClientWaitSyncAPPLE CAN_CALL_OPENGL_ES
 #define CAN_CALL_glDeleteSyncAPPLE CAN_CALL_OPENGL_ES
 #define CAN_CALL_glFenceSyncAPPLE CAN_CALL_OPENGL_ES
 #define CAN_CALL_glGetSyncivAPPLE CAN_CALL_OPENGL_ES
 #else
+#define CAN_CALL_glClientWaitSyncAPPLE 0
 #define CAN_CALL_glDeleteSyncAPPLE 0
 #define CAN_CALL_glFenceSyncAPPLE 0
 #define CAN_CALL_glGetSyncivAPPLE 0
 #endif
 
+GLenum iglClientWaitSyncAPPLE(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  GLEXTENSION_METHOD_BODY_WITH_RETURN(CAN_CALL_glClientWaitSyncAPPLE,
+                                      glClientWaitSyncAPPLE,
+                                      PFNIGLCLIENTWAITSYNCPROC,
+                                      GL_WAIT_FAILED,
+                                      sync,
+                                      flags,
+                                      timeout);
+}
+
 void iglDeleteSyncAPPLE(GLsync sync) {
   GLEXTENSION_METHOD_BODY(
       CAN_CALL_glDeleteSyncAPPLE, glDeleteSyncAPPLE, PFNIGLDELETESYNCPROC, sync);
@@ -431,13 +575,34 @@ void iglMakeTextureHandleNonResidentARB(GLuint64 handle) {
                           handle);
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_buffer_storage
+
+#if defined(GL_VERSION_4_4) || defined(GL_ARB_buffer_storage)
+#define CAN_CALL_glBufferStorage CAN_CALL_OPENGL
+#else
+#define CAN_CALL_glBufferStorage 0
+#endif
+
+void iglBufferStorage(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glBufferStorage,
+                          glBufferStorage,
+                          PFNIGLBUFFERSTORAGEPROC,
+                          target,
+                          size,
+                          data,
+                          flags);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_compute_shader
 
 #if defined(GL_VERSION_4_3) || defined(GL_ES_VERSION_3_1) || defined(GL_ARB_compute_shader)
 #define CAN_CALL_glDispatchCompute CAN_CALL
+#define CAN_CALL_glDispatchComputeIndirect CAN_CALL
 #else
 #define CAN_CALL_glDispatchCompute 0
+#define CAN_CALL_glDispatchComputeIndirect 0
 #endif
 
 void iglDispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z) {
@@ -449,15 +614,62 @@ void iglDispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_gro
                           num_groups_z);
 }
 
+void iglDispatchComputeIndirect(GLintptr indirect) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glDispatchComputeIndirect,
+                          glDispatchComputeIndirect,
+                          PFNIGLDISPATCHCOMPUTEINDIRECTPROC,
+                          indirect);
+}
+
+///--------------------------------------
+/// MARK: - GL_ARB_direct_state_access
+
+#if defined(GL_VERSION_4_5) || defined(GL_ARB_direct_state_access)
+#define CAN_CALL_glNamedBufferSubData CAN_CALL_OPENGL
+#define CAN_CALL_glTextureParameteri CAN_CALL_OPENGL
+#else
+#define CAN_CALL_glNamedBufferSubData 0
+#define CAN_CALL_glTextureParameteri 0
+#endif
+
+void iglNamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const GLvoid* data) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glNamedBufferSubData,
+                          glNamedBufferSubData,
+                          PFNIGLNAMEDBUFFERSUBDATAPROC,
+                          buffer,
+                          offset,
+                          size,
+                          data);
+}
+
+void iglTextureParameteri(GLuint texture, GLenum pname, GLint param) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glTextureParameteri,
+                          glTextureParameteri,
+                          PFNIGLTEXTUREPARAMETERIPROC,
+                          texture,
+                          pname,
+                          param);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_draw_indirect
 
 #if defined(GL_VERSION_4_0) || defined(GL_ES_VERSION_3_1) || defined(GL_ARB_draw_indirect)
+#define CAN_CALL_glDrawArraysIndirect CAN_CALL
 #define CAN_CALL_glDrawElementsIndirect CAN_CALL
 #else
+#define CAN_CALL_glDrawArraysIndirect 0
 #define CAN_CALL_glDrawElementsIndirect 0
 #endif
 
+void iglDrawArraysIndirect(GLenum mode, const GLvoid* indirect) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glDrawArraysIndirect,
+                          glDrawArraysIndirect,
+                          PFNIGLDRAWARRAYSINDIRECTPROC,
+                          mode,
+                          indirect);
+}
+
 void iglDrawElementsIndirect(GLenum mode, GLenum type, const GLvoid* indirect) {
   GLEXTENSION_METHOD_BODY(CAN_CALL_glDrawElementsIndirect,
                           glDrawElementsIndirect,
@@ -714,6 +926,53 @@ void iglRenderbufferStorageMultisample(GLenum target,
                           height)
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_get_program_binary
+
+#if defined(GL_VERSION_4_1) || defined(GL_ES_VERSION_3_0) || defined(GL_ARB_get_program_binary)
+#define CAN_CALL_glGetProgramBinary CAN_CALL
+#define CAN_CALL_glProgramBinary CAN_CALL
+#define CAN_CALL_glProgramParameteri CAN_CALL
+#else
+#define CAN_CALL_glGetProgramBinary 0
+#define CAN_CALL_glProgramBinary 0
+#define CAN_CALL_glProgramParameteri 0
+#endif
+
+void iglGetProgramBinary(GLuint program,
+                         GLsizei bufSize,
+                         GLsizei* length,
+                         GLenum* binaryFormat,
+                         void* binary) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetProgramBinary,
+                          glGetProgramBinary,
+                          PFNIGLGETPROGRAMBINARYPROC,
+                          program,
+                          bufSize,
+                          length,
+                          binaryFormat,
+                          binary);
+}
+
+void iglProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glProgramBinary,
+                          glProgramBinary,
+                          PFNIGLPROGRAMBINARYPROC,
+                          program,
+                          binaryFormat,
+                          binary,
+                          length);
+}
+
+void iglProgramParameteri(GLuint program, GLenum pname, GLint value) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glProgramParameteri,
+                          glProgramParameteri,
+                          PFNIGLPROGRAMPARAMETERIPROC,
+                          program,
+                          pname,
+                          value);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_invalidate_subdata
 
@@ -752,6 +1011,82 @@ void* iglMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbit
                                       access);
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_multi_bind
+
+#if defined(GL_VERSION_4_4) || defined(GL_ARB_multi_bind)
+#define CAN_CALL_glBindBuffersRange CAN_CALL_OPENGL
+#define CAN_CALL_glBindTextures CAN_CALL_OPENGL
+#else
+#define CAN_CALL_glBindBuffersRange 0
+#define CAN_CALL_glBindTextures 0
+#endif
+
+void iglBindBuffersRange(GLenum target,
+                         GLuint first,
+                         GLsizei count,
+                         const GLuint* buffers,
+                         const GLintptr* offsets,
+                         const GLsizeiptr* sizes) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glBindBuffersRange,
+                          glBindBuffersRange,
+                          PFNIGLBINDBUFFERSRANGEPROC,
+                          target,
+                          first,
+                          count,
+                          buffers,
+                          offsets,
+                          sizes);
+}
+
+void iglBindTextures(GLuint first, GLsizei count, const GLuint* textures) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glBindTextures,
+                          glBindTextures,
+                          PFNIGLBINDTEXTURESPROC,
+                          first,
+                          count,
+                          textures);
+}
+
+///--------------------------------------
+/// MARK: - GL_ARB_multi_draw_indirect
+
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_multi_draw_indirect)
+#define CAN_CALL_glMultiDrawArraysIndirect CAN_CALL_OPENGL
+#define CAN_CALL_glMultiDrawElementsIndirect CAN_CALL_OPENGL
+#else
+#define CAN_CALL_glMultiDrawArraysIndirect 0
+#define CAN_CALL_glMultiDrawElementsIndirect 0
+#endif
+
+void iglMultiDrawArraysIndirect(GLenum mode,
+                                const GLvoid* indirect,
+                                GLsizei drawcount,
+                                GLsizei stride) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glMultiDrawArraysIndirect,
+                          glMultiDrawArraysIndirect,
+                          PFNIGLMULTIDRAWARRAYSINDIRECTPROC,
+                          mode,
+                          indirect,
+                          drawcount,
+                          stride);
+}
+
+void iglMultiDrawElementsIndirect(GLenum mode,
+                                  GLenum type,
+                                  const GLvoid* indirect,
+                                  GLsizei drawcount,
+                                  GLsizei stride) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glMultiDrawElementsIndirect,
+                          glMultiDrawElementsIndirect,
+                          PFNIGLMULTIDRAWELEMENTSINDIRECTPROC,
+                          mode,
+                          type,
+                          indirect,
+                          drawcount,
+                          stride);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_program_interface_query
 
@@ -867,15 +1202,27 @@ void iglMemoryBarrier(GLbitfield barriers) {
 /// MARK: - GL_ARB_sync
 
 #if defined(GL_VERSION_3_2) || defined(GL_ES_VERSION_3_0) || defined(GL_ARB_sync)
+#define CAN_CALL_glClientWaitSync CAN_CALL
 #define CAN_CALL_glDeleteSync CAN_CALL
 #define CAN_CALL_glFenceSync CAN_CALL
 #define CAN_CALL_glGetSynciv CAN_CALL
 #else
+#define CAN_CALL_glClientWaitSync 0
 #define CAN_CALL_glDeleteSync 0
 #define CAN_CALL_glFenceSync 0
 #define CAN_CALL_glGetSynciv 0
 #endif
 
+GLenum iglClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  GLEXTENSION_METHOD_BODY_WITH_RETURN(CAN_CALL_glClientWaitSync,
+                                      glClientWaitSync,
+                                      PFNIGLCLIENTWAITSYNCPROC,
+                                      GL_WAIT_FAILED,
+                                      sync,
+                                      flags,
+                                      timeout);
+}
+
 void iglDeleteSync(GLsync sync) {
   GLEXTENSION_METHOD_BODY(CAN_CALL_glDeleteSync, glDeleteSync, PFNIGLDELETESYNCPROC, sync);
 }
@@ -890,6 +1237,31 @@ void iglGetSynciv(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei* length, G
       CAN_CALL_glGetSynciv, glGetSynciv, PFNIGLGETSYNCIVPROC, sync, pname, bufSize, length, values);
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_timer_query
+
+#if defined(GL_VERSION_3_3) || defined(GL_ARB_timer_query)
+#define CAN_CALL_glGetQueryObjectui64v CAN_CALL_OPENGL
+#define CAN_CALL_glQueryCounter CAN_CALL_OPENGL
+#else
+#define CAN_CALL_glGetQueryObjectui64v 0
+#define CAN_CALL_glQueryCounter 0
+#endif
+
+void iglGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetQueryObjectui64v,
+                          glGetQueryObjectui64v,
+                          PFNIGLGETQUERYOBJECTUI64VPROC,
+                          id,
+                          pname,
+                          params);
+}
+
+void iglQueryCounter(GLuint id, GLenum target) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glQueryCounter, glQueryCounter, PFNIGLQUERYCOUNTERPROC, id, target);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_texture_storage
 
@@ -949,6 +1321,36 @@ void iglTexStorage3D(GLenum target,
                           depth);
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_texture_view
+
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_texture_view)
+#define CAN_CALL_glTextureView CAN_CALL_OPENGL
+#else
+#define CAN_CALL_glTextureView 0
+#endif
+
+void iglTextureView(GLuint texture,
+                    GLenum target,
+                    GLuint origtexture,
+                    GLenum internalformat,
+                    GLuint minlevel,
+                    GLuint numlevels,
+                    GLuint minlayer,
+                    GLuint numlayers) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glTextureView,
+                          glTextureView,
+                          PFNIGLTEXTUREVIEWPROC,
+                          texture,
+                          target,
+                          origtexture,
+                          internalformat,
+                          minlevel,
+                          numlevels,
+                          minlayer,
+                          numlayers);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_uniform_buffer_object
 
@@ -1079,6 +1481,25 @@ void iglGenVertexArrays(GLsizei n, GLuint* vertexArrays) {
       CAN_CALL_glGenVertexArrays, glGenVertexArrays, PFNIGLGENVERTEXARRAYSPROC, n, vertexArrays);
 }
 
+///--------------------------------------
+/// MARK: - GL_EXT_buffer_storage
+
+#if defined(GL_EXT_buffer_storage)
+#define CAN_CALL_glBufferStorageEXT CAN_CALL_OPENGL_ES
+#else
+#define CAN_CALL_glBufferStorageEXT 0
+#endif
+
+void iglBufferStorageEXT(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glBufferStorageEXT,
+                          glBufferStorageEXT,
+                          PFNIGLBUFFERSTORAGEPROC,
+                          target,
+                          size,
+                          data,
+                          flags);
+}
+
 ///--------------------------------------
 /// MARK: - GL_EXT_debug_marker
 
@@ -1121,6 +1542,55 @@ void iglPushGroupMarkerEXT(GLenum /*source*/,
                           message);
 }
 
+///--------------------------------------
+/// MARK: - GL_EXT_disjoint_timer_query
+
+#if defined(GL_EXT_disjoint_timer_query)
+#define CAN_CALL_glDeleteQueriesEXT CAN_CALL_OPENGL_ES
+#define CAN_CALL_glGenQueriesEXT CAN_CALL_OPENGL_ES
+#define CAN_CALL_glGetQueryObjectui64vEXT CAN_CALL_OPENGL_ES
+#define CAN_CALL_glGetQueryObjectuivEXT CAN_CALL_OPENGL_ES
+#define CAN_CALL_glQueryCounterEXT CAN_CALL_OPENGL_ES
+#else
+#define CAN_CALL_glDeleteQueriesEXT 0
+#define CAN_CALL_glGenQueriesEXT 0
+#define CAN_CALL_glGetQueryObjectui64vEXT 0
+#define CAN_CALL_glGetQueryObjectuivEXT 0
+#define CAN_CALL_glQueryCounterEXT 0
+#endif
+
+void iglDeleteQueriesEXT(GLsizei n, const GLuint* ids) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glDeleteQueriesEXT, glDeleteQueriesEXT, PFNIGLDELETEQUERIESPROC, n, ids);
+}
+
+void iglGenQueriesEXT(GLsizei n, GLuint* ids) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGenQueriesEXT, glGenQueriesEXT, PFNIGLGENQUERIESPROC, n, ids);
+}
+
+void iglGetQueryObjectui64vEXT(GLuint id, GLenum pname, GLuint64* params) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetQueryObjectui64vEXT,
+                          glGetQueryObjectui64vEXT,
+                          PFNIGLGETQUERYOBJECTUI64VPROC,
+                          id,
+                          pname,
+                          params);
+}
+
+void iglGetQueryObjectuivEXT(GLuint id, GLenum pname, GLuint* params) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetQueryObjectuivEXT,
+                          glGetQueryObjectuivEXT,
+                          PFNIGLGETQUERYOBJECTUIVPROC,
+                          id,
+                          pname,
+                          params);
+}
+
+void iglQueryCounterEXT(GLuint id, GLenum target) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glQueryCounterEXT, glQueryCounterEXT, PFNIGLQUERYCOUNTERPROC, id, target);
+}
+
 ///--------------------------------------
 /// MARK: - GL_EXT_discard_framebuffer
 
@@ -1297,6 +1767,45 @@ void iglImportMemoryFdEXT(GLuint memory, GLuint64 size, GLenum handleType, GLint
                           fd);
 }
 
+///--------------------------------------
+/// MARK: - GL_EXT_multi_draw_indirect
+
+#if defined(GL_EXT_multi_draw_indirect)
+#define CAN_CALL_glMultiDrawArraysIndirectEXT CAN_CALL_OPENGL_ES
+#define CAN_CALL_glMultiDrawElementsIndirectEXT CAN_CALL_OPENGL_ES
+#else
+#define CAN_CALL_glMultiDrawArraysIndirectEXT 0
+#define CAN_CALL_glMultiDrawElementsIndirectEXT 0
+#endif
+
+void iglMultiDrawArraysIndirectEXT(GLenum mode,
+                                   const GLvoid* indirect,
+                                   GLsizei drawcount,
+                                   GLsizei stride) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glMultiDrawArraysIndirectEXT,
+                          glMultiDrawArraysIndirectEXT,
+                          PFNIGLMULTIDRAWARRAYSINDIRECTPROC,
+                          mode,
+                          indirect,
+                          drawcount,
+                          stride);
+}
+
+void iglMultiDrawElementsIndirectEXT(GLenum mode,
+                                     GLenum type,
+                                     const GLvoid* indirect,
+                                     GLsizei drawcount,
+                                     GLsizei stride) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glMultiDrawElementsIndirectEXT,
+                          glMultiDrawElementsIndirectEXT,
+                          PFNIGLMULTIDRAWELEMENTSINDIRECTPROC,
+                          mode,
+                          type,
+                          indirect,
+                          drawcount,
+                          stride);
+}
+
 ///--------------------------------------
 /// MARK: - GL_EXT_multisampled_render_to_texture
 
@@ -1434,6 +1943,36 @@ void iglTexStorage3DEXT(GLenum target,
                           depth)
 }
 
+///--------------------------------------
+/// MARK: - GL_EXT_texture_view
+
+#if defined(GL_EXT_texture_view)
+#define CAN_CALL_glTextureViewEXT CAN_CALL_OPENGL_ES
+#else
+#define CAN_CALL_glTextureViewEXT 0
+#endif
+
+void iglTextureViewEXT(GLuint texture,
+                       GLenum target,
+                       GLuint origtexture,
+                       GLenum internalformat,
+                       GLuint minlevel,
+                       GLuint numlevels,
+                       GLuint minlayer,
+                       GLuint numlayers) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glTextureViewEXT,
+                          glTextureViewEXT,
+                          PFNIGLTEXTUREVIEWPROC,
+                          texture,
+                          target,
+                          origtexture,
+                          internalformat,
+                          minlevel,
+                          numlevels,
+                          minlayer,
+                          numlayers);
+}
+
 ///--------------------------------------
 /// MARK: - GL_IMG_multisampled_render_to_texture
 
@@ -1530,6 +2069,22 @@ void iglPushDebugGroupKHR(GLenum source, GLuint id, GLsizei length, const GLchar
                           message);
 }
 
+///--------------------------------------
+/// MARK: - GL_KHR_parallel_shader_compile
+
+#if defined(GL_KHR_parallel_shader_compile)
+#define CAN_CALL_glMaxShaderCompilerThreadsKHR CAN_CALL
+#else
+#define CAN_CALL_glMaxShaderCompilerThreadsKHR 0
+#endif
+
+void iglMaxShaderCompilerThreadsKHR(GLuint count) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glMaxShaderCompilerThreadsKHR,
+                          glMaxShaderCompilerThreadsKHR,
+                          PFNIGLMAXSHADERCOMPILERTHREADSPROC,
+                          count);
+}
+
 ///--------------------------------------
 /// MARK: - GL_NV_bindless_texture
 
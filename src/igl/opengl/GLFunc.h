@@ -31,9 +31,16 @@ IGL_EXTERN_BEGIN
 // definitions use a PFNIGL prefix to ensure they don't collide with function pointer types
 // defined by other OpenGL loaders. These definitions also omit any extension-specific suffix (e.g.,
 // EXT) unless it is needed to disambiguate them.
+using PFNIGLBEGINQUERYPROC = void (*)(GLenum target, GLuint id);
 using PFNIGLBINDBUFFERBASEPROC = void (*)(GLenum target, GLuint index, GLuint buffer);
 using PFNIGLBINDBUFFERRANGEPROC =
     void (*)(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+using PFNIGLBINDBUFFERSRANGEPROC = void (*)(GLenum target,
+                                            GLuint first,
+                                            GLsizei count,
+                                            const GLuint* buffers,
+                                            const GLintptr* offsets,
+                                            const GLsizeiptr* sizes);
 using PFNIGLBINDFRAMEBUFFERPROC = void (*)(GLenum target, GLuint framebuffer);
 using PFNIGLBINDIMAGETEXTUREPROC = void (*)(GLuint unit,
                                             GLuint texture,
@@ -43,6 +50,7 @@ using PFNIGLBINDIMAGETEXTUREPROC = void (*)(GLuint unit,
                                             GLenum access,
                                             GLenum format);
 using PFNIGLBINDRENDERBUFFERPROC = void (*)(GLenum target, GLuint renderbuffer);
+using PFNIGLBINDTEXTURESPROC = void (*)(GLuint first, GLsizei count, const GLuint* textures);
 using PFNIGLBINDVERTEXARRAYPROC = void (*)(GLuint vao);
 using PFNIGLBLITFRAMEBUFFERPROC = void (*)(GLint srcX0,
                                            GLint srcY0,
@@ -54,9 +62,14 @@ using PFNIGLBLITFRAMEBUFFERPROC = void (*)(GLint srcX0,
                                            GLint dstY1,
                                            GLbitfield mask,
                                            GLenum filter);
+using PFNIGLBUFFERSTORAGEPROC = void (*)(GLenum target,
+                                         GLsizeiptr size,
+                                         const GLvoid* data,
+                                         GLbitfield flags);
 using PFNIGLCHECKFRAMEBUFFERSTATUSPROC = GLenum (*)(GLenum target);
 using PFNIGLCLEARDEPTHPROC = void (*)(GLdouble depth);
 using PFNIGLCLEARDEPTHFPROC = void (*)(GLfloat depth);
+using PFNIGLCLIENTWAITSYNCPROC = GLenum (*)(GLsync sync, GLbitfield flags, GLuint64 timeout);
 using PFNIGLCOMPRESSEDTEXIMAGE3DPROC = void (*)(GLenum target,
                                                 GLint level,
                                                 GLenum internalformat,
@@ -86,6 +99,7 @@ using PFNIGLDEBUGMESSAGEINSERTPROC = void (*)(GLenum source,
                                               const GLchar* buf);
 using PFNIGLDELETEFRAMEBUFFERSPROC = void (*)(GLsizei n, const GLuint* framebuffers);
 using PFNIGLDELETEMEMORYOBJECTSPROC = void (*)(GLsizei n, const GLuint* memoryObjects);
+using PFNIGLDELETEQUERIESPROC = void (*)(GLsizei n, const GLuint* ids);
 using PFNIGLDELETERENDERBUFFERSPROC = void (*)(GLsizei n, const GLuint* renderbuffers);
 using PFNIGLDELETESYNCPROC = void (*)(GLsync sync);
 using PFNIGLDELETEVERTEXARRAYSPROC = void (*)(GLsizei n, const GLuint* vertexArrays);
@@ -95,8 +109,38 @@ using PFNIGLDISCARDFRAMEBUFFERPROC = void (*)(GLenum target,
 using PFNIGLDISPATCHCOMPUTEPROC = void (*)(GLuint num_groups_x,
                                            GLuint num_groups_y,
                                            GLuint num_groups_z);
+using PFNIGLDISPATCHCOMPUTEINDIRECTPROC = void (*)(GLintptr indirect);
+using PFNIGLDRAWARRAYSINDIRECTPROC = void (*)(GLenum mode, const GLvoid* indirect);
+using PFNIGLDRAWARRAYSINSTANCEDPROC = void (*)(GLenum mode,
+                                               GLint first,
+                                               GLsizei count,
+                                               GLsizei instancecount);
+using PFNIGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC = void (*)(GLenum mode,
+                                                           GLint first,
+                                                           GLsizei count,
+                                                           GLsizei instancecount,
+                                                           GLuint baseinstance);
 using PFNIGLDRAWBUFFERSPROC = void (*)(GLsizei, const GLenum*);
 using PFNIGLDRAWELEMENTSINDIRECTPROC = void (*)(GLenum mode, GLenum type, const GLvoid* indirect);
+using PFNIGLDRAWELEMENTSINSTANCEDPROC = void (*)(GLenum mode,
+                                                 GLsizei count,
+                                                 GLenum type,
+                                                 const GLvoid* indices,
+                                                 GLsizei instancecount);
+using PFNIGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC = void (*)(GLenum mode,
+                                                           GLsizei count,
+                                                           GLenum type,
+                                                           const GLvoid* indices,
+                                                           GLsizei instancecount,
+                                                           GLint basevertex);
+using PFNIGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC = void (*)(GLenum mode,
+                                                                       GLsizei count,
+                                                                       GLenum type,
+                                                                       const GLvoid* indices,
+                                                                       GLsizei instancecount,
+                                                                       GLint basevertex,
+                                                                       GLuint baseinstance);
+using PFNIGLENDQUERYPROC = void (*)(GLenum target);
 using PFNIGLFENCESYNCPROC = GLsync (*)(GLenum condition, GLbitfield flags);
 using PFNIGLFRAMEBUFFERRENDERBUFFERPROC = void (*)(GLenum target,
                                                    GLenum attachment,
@@ -127,6 +171,7 @@ using PFNIGLFRAMEBUFFERTEXTUREMULTIVIEWPROC = void (*)(GLenum target,
                                                        GLsizei numViews);
 using PFNIGLGENERATEMIPMAPPROC = void (*)(GLenum target);
 using PFNIGLGENFRAMEBUFFERSPROC = void (*)(GLsizei n, GLuint* framebuffers);
+using PFNIGLGENQUERIESPROC = void (*)(GLsizei n, GLuint* ids);
 using PFNIGLGENRENDERBUFFERSPROC = void (*)(GLsizei n, GLuint* renderbuffers);
 using PFNIGLGENVERTEXARRAYSPROC = void (*)(GLsizei n, GLuint* vertexArrays);
 using PFNIGLGETACTIVEUNIFORMSIVPROC = void (*)(GLuint program,
@@ -147,6 +192,11 @@ using PFNIGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC = void (*)(GLenum target,
                                                                GLenum attachment,
                                                                GLenum pname,
                                                                GLint* params);
+using PFNIGLGETPROGRAMBINARYPROC = void (*)(GLuint program,
+                                            GLsizei bufSize,
+                                            GLsizei* length,
+                                            GLenum* binaryFormat,
+                                            void* binary);
 using PFNIGLGETPROGRAMINTERFACEIVPROC = void (*)(GLuint program,
                                                  GLenum programInterface,
                                                  GLenum pname,
@@ -168,6 +218,8 @@ using PFNIGLGETPROGRAMRESOURCENAMEPROC = void (*)(GLuint program,
                                                   GLsizei bufSize,
                                                   GLsizei* length,
                                                   char* name);
+using PFNIGLGETQUERYOBJECTUI64VPROC = void (*)(GLuint id, GLenum pname, GLuint64* params);
+using PFNIGLGETQUERYOBJECTUIVPROC = void (*)(GLuint id, GLenum pname, GLuint* params);
 using PFNIGLGETRENDERBUFFERPARAMETERIVPROC = void (*)(GLenum target, GLenum pname, GLint* params);
 using PFNIGLGETSTRINGIPROC = const GLubyte* (*)(GLenum name, GLint index);
 using PFNIGLGETSYNCIVPROC =
@@ -191,14 +243,34 @@ using PFNIGLMAPBUFFERRANGEPROC = void* (*)(GLenum target,
                                            GLintptr offset,
                                            GLsizeiptr length,
                                            GLbitfield access);
+using PFNIGLMAXSHADERCOMPILERTHREADSPROC = void (*)(GLuint count);
 using PFNIGLMEMORYBARRIERPROC = void (*)(GLbitfield barriers);
+using PFNIGLMULTIDRAWARRAYSINDIRECTPROC = void (*)(GLenum mode,
+                                                  const GLvoid* indirect,
+                                                  GLsizei drawcount,
+                                                  GLsizei stride);
+using PFNIGLMULTIDRAWELEMENTSINDIRECTPROC = void (*)(GLenum mode,
+                                                    GLenum type,
+                                                    const GLvoid* indirect,
+                                                    GLsizei drawcount,
+                                                    GLsizei stride);
+using PFNIGLNAMEDBUFFERSUBDATAPROC = void (*)(GLuint buffer,
+                                              GLintptr offset,
+                                              GLsizeiptr size,
+                                              const GLvoid* data);
 using PFNIGLPOPDEBUGGROUPPROC = void (*)();
+using PFNIGLPROGRAMBINARYPROC = void (*)(GLuint program,
+                                         GLenum binaryFormat,
+                                         const void* binary,
+                                         GLsizei length);
+using PFNIGLPROGRAMPARAMETERIPROC = void (*)(GLuint program, GLenum pname, GLint value);
 using PFNIGLPOPGROUPMARKERPROC = void (*)();
 using PFNIGLPUSHDEBUGGROUPPROC = void (*)(GLenum source,
                                           GLuint id,
                                           GLsizei length,
                                           const GLchar* message);
 using PFNIGLPUSHGROUPMARKERPROC = void (*)(GLsizei length, const GLchar* marker);
+using PFNIGLQUERYCOUNTERPROC = void (*)(GLuint id, GLenum target);
 using PFNIGLRENDERBUFFERSTORAGEPROC = void (*)(GLenum target,
                                                GLenum internalformat,
                                                GLsizei width,
@@ -238,6 +310,14 @@ using PFNIGLTEXSTORAGE3DPROC = void (*)(GLenum target,
                                         GLsizei width,
                                         GLsizei height,
                                         GLsizei depth);
+using PFNIGLTEXTUREVIEWPROC = void (*)(GLuint texture,
+                                       GLenum target,
+                                       GLuint origtexture,
+                                       GLenum internalformat,
+                                       GLuint minlevel,
+                                       GLuint numlevels,
+                                       GLuint minlayer,
+                                       GLuint numlayers);
 using PFNIGLTEXSTORAGEMEM2DPROC = void (*)(GLenum target,
                                            GLsizei levels,
                                            GLenum internalFormat,
@@ -253,6 +333,7 @@ using PFNIGLTEXSTORAGEMEM3DPROC = void (*)(GLenum target,
                                            GLsizei depth,
                                            GLuint memory,
                                            GLuint64 offset);
+using PFNIGLTEXTUREPARAMETERIPROC = void (*)(GLuint texture, GLenum pname, GLint param);
 using PFNIGLUNIFORMBLOCKBINDINGPROC = void (*)(GLuint pid,
                                                GLuint uniformBlockIndex,
                                                GLuint uniformBlockBinding);
@@ -291,7 +372,36 @@ void iglDebugMessageInsert(GLenum source,
                            GLenum severity,
                            GLsizei length,
                            const GLchar* buf);
+void iglBeginQuery(GLenum target, GLuint id);
+void iglDeleteQueries(GLsizei n, const GLuint* ids);
+void iglDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+void iglDrawArraysInstancedBaseInstance(GLenum mode,
+                                        GLint first,
+                                        GLsizei count,
+                                        GLsizei instancecount,
+                                        GLuint baseinstance);
 void iglDrawBuffers(GLsizei n, const GLenum* bufs);
+void iglDrawElementsInstanced(GLenum mode,
+                              GLsizei count,
+                              GLenum type,
+                              const GLvoid* indices,
+                              GLsizei instancecount);
+void iglDrawElementsInstancedBaseVertex(GLenum mode,
+                                        GLsizei count,
+                                        GLenum type,
+                                        const GLvoid* indices,
+                                        GLsizei instancecount,
+                                        GLint basevertex);
+void iglDrawElementsInstancedBaseVertexBaseInstance(GLenum mode,
+                                                    GLsizei count,
+                                                    GLenum type,
+                                                    const GLvoid* indices,
+                                                    GLsizei instancecount,
+                                                    GLint basevertex,
+                                                    GLuint baseinstance);
+void iglEndQuery(GLenum target);
+void iglGenQueries(GLsizei n, GLuint* ids);
+void iglGetQueryObjectuiv(GLuint id, GLenum pname, GLuint* params);
 const GLubyte* iglGetStringi(GLenum name, GLint index);
 void* iglMapBuffer(GLenum target, GLbitfield access);
 void iglPopDebugGroup();
@@ -331,6 +441,7 @@ void iglRenderbufferStorageMultisampleAPPLE(GLenum target,
 ///--------------------------------------
 /// MARK: - GL_APPLE_sync
 
+GLenum iglClientWaitSyncAPPLE(GLsync sync, GLbitfield flags, GLuint64 timeout);
 void iglDeleteSyncAPPLE(GLsync sync);
 GLsync iglFenceSyncAPPLE(GLenum condition, GLbitfield flags);
 void iglGetSyncivAPPLE(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei* length, GLint* values);
@@ -342,14 +453,27 @@ GLuint64 iglGetTextureHandleARB(GLuint texture);
 void iglMakeTextureHandleResidentARB(GLuint64 handle);
 void iglMakeTextureHandleNonResidentARB(GLuint64 handle);
 
+///--------------------------------------
+/// MARK: - GL_ARB_buffer_storage
+
+void iglBufferStorage(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_compute_shader
 
 void iglDispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+void iglDispatchComputeIndirect(GLintptr indirect);
+
+///--------------------------------------
+/// MARK: - GL_ARB_direct_state_access
+
+void iglNamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+void iglTextureParameteri(GLuint texture, GLenum pname, GLint param);
 
 ///--------------------------------------
 /// MARK: - GL_ARB_draw_indirect
 
+void iglDrawArraysIndirect(GLenum mode, const GLvoid* indirect);
 void iglDrawElementsIndirect(GLenum mode, GLenum type, const GLvoid* indirect);
 
 ///--------------------------------------
@@ -406,6 +530,17 @@ void iglRenderbufferStorageMultisample(GLenum target,
                                        GLsizei width,
                                        GLsizei height);
 
+///--------------------------------------
+/// MARK: - GL_ARB_get_program_binary
+
+void iglGetProgramBinary(GLuint program,
+                         GLsizei bufSize,
+                         GLsizei* length,
+                         GLenum* binaryFormat,
+                         void* binary);
+void iglProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+void iglProgramParameteri(GLuint program, GLenum pname, GLint value);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_invalidate_subdata
 
@@ -416,6 +551,30 @@ void iglInvalidateFramebuffer(GLenum target, GLsizei numAttachments, const GLenu
 
 void* iglMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
 
+///--------------------------------------
+/// MARK: - GL_ARB_multi_bind
+
+void iglBindBuffersRange(GLenum target,
+                         GLuint first,
+                         GLsizei count,
+                         const GLuint* buffers,
+                         const GLintptr* offsets,
+                         const GLsizeiptr* sizes);
+void iglBindTextures(GLuint first, GLsizei count, const GLuint* textures);
+
+///--------------------------------------
+/// MARK: - GL_ARB_multi_draw_indirect
+
+void iglMultiDrawArraysIndirect(GLenum mode,
+                                const GLvoid* indirect,
+                                GLsizei drawcount,
+                                GLsizei stride);
+void iglMultiDrawElementsIndirect(GLenum mode,
+                                  GLenum type,
+                                  const GLvoid* indirect,
+                                  GLsizei drawcount,
+                                  GLsizei stride);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_program_interface_query
 
@@ -451,10 +610,17 @@ void iglMemoryBarrier(GLbitfield barriers);
 ///--------------------------------------
 /// MARK: - GL_ARB_sync
 
+GLenum iglClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
 void iglDeleteSync(GLsync sync);
 GLsync iglFenceSync(GLenum condition, GLbitfield flags);
 void iglGetSynciv(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei* length, GLint* values);
 
+///--------------------------------------
+/// MARK: - GL_ARB_timer_query
+
+void iglGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params);
+void iglQueryCounter(GLuint id, GLenum target);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_texture_storage
 
@@ -471,6 +637,18 @@ void iglTexStorage3D(GLenum target,
                      GLsizei height,
                      GLsizei depth);
 
+///--------------------------------------
+/// MARK: - GL_ARB_texture_view
+
+void iglTextureView(GLuint texture,
+                    GLenum target,
+                    GLuint origtexture,
+                    GLenum internalformat,
+                    GLuint minlevel,
+                    GLuint numlevels,
+                    GLuint minlayer,
+                    GLuint numlayers);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_uniform_buffer_object
 
@@ -501,6 +679,11 @@ void iglBindVertexArray(GLuint vao);
 void iglDeleteVertexArrays(GLsizei n, const GLuint* vertexArrays);
 void iglGenVertexArrays(GLsizei n, GLuint* vertexArrays);
 
+///--------------------------------------
+/// MARK: - GL_EXT_buffer_storage
+
+void iglBufferStorageEXT(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags);
+
 ///--------------------------------------
 /// MARK: - GL_EXT_debug_marker
 
@@ -516,6 +699,15 @@ void iglInsertEventMarkerEXT(GLenum source,
 void iglPopGroupMarkerEXT();
 void iglPushGroupMarkerEXT(GLenum source, GLuint id, GLsizei length, const GLchar* message);
 
+///--------------------------------------
+/// MARK: - GL_EXT_disjoint_timer_query
+
+void iglDeleteQueriesEXT(GLsizei n, const GLuint* ids);
+void iglGenQueriesEXT(GLsizei n, GLuint* ids);
+void iglGetQueryObjectui64vEXT(GLuint id, GLenum pname, GLuint64* params);
+void iglGetQueryObjectuivEXT(GLuint id, GLenum pname, GLuint* params);
+void iglQueryCounterEXT(GLuint id, GLenum target);
+
 ///--------------------------------------
 /// MARK: - GL_EXT_discard_framebuffer
 
@@ -571,6 +763,19 @@ void iglTexStorageMem3DEXT(GLenum target,
 
 void iglImportMemoryFdEXT(GLuint memory, GLuint64 size, GLenum handleType, GLint fd);
 
+///--------------------------------------
+/// MARK: - GL_EXT_multi_draw_indirect
+
+void iglMultiDrawArraysIndirectEXT(GLenum mode,
+                                   const GLvoid* indirect,
+                                   GLsizei drawcount,
+                                   GLsizei stride);
+void iglMultiDrawElementsIndirectEXT(GLenum mode,
+                                     GLenum type,
+                                     const GLvoid* indirect,
+                                     GLsizei drawcount,
+                                     GLsizei stride);
+
 ///--------------------------------------
 /// MARK: - GL_EXT_multisampled_render_to_texture
 
@@ -614,6 +819,18 @@ void iglTexStorage3DEXT(GLenum target,
                         GLsizei height,
                         GLsizei depth);
 
+///--------------------------------------
+/// MARK: - GL_EXT_texture_view
+
+void iglTextureViewEXT(GLuint texture,
+                       GLenum target,
+                       GLuint origtexture,
+                       GLenum internalformat,
+                       GLuint minlevel,
+                       GLuint numlevels,
+                       GLuint minlayer,
+                       GLuint numlayers);
+
 ///--------------------------------------
 /// MARK: - GL_IMG_multisampled_render_to_texture
 
@@ -641,6 +858,11 @@ void iglDebugMessageInsertKHR(GLenum source,
 void iglPopDebugGroupKHR();
 void iglPushDebugGroupKHR(GLenum source, GLuint id, GLsizei length, const GLchar* message);
 
+///--------------------------------------
+/// MARK: - GL_KHR_parallel_shader_compile
+
+void iglMaxShaderCompilerThreadsKHR(GLuint count);
+
 ///--------------------------------------
 /// MARK: - GL_NV_bindless_texture
 
@@ -79,6 +79,9 @@
     #include <GLES3/gl3.h>
     #include <GLES2/gl2ext.h>
   #else
+    #if defined(IGL_WITH_TRACY_GPU)
+      #define GL_GLEXT_PROTOTYPES // TracyOpenGL.hpp calls glQueryCounter() and friends directly
+    #endif
     #include <GL/gl.h>
     #include <GL/glcorearb.h>
   #endif
@@ -97,12 +100,21 @@
 #ifndef GL_ACTIVE_RESOURCES
 #define GL_ACTIVE_RESOURCES 0x92f5
 #endif
+#ifndef GL_ANY_SAMPLES_PASSED
+#define GL_ANY_SAMPLES_PASSED 0x8C2F
+#endif
+#ifndef GL_ANY_SAMPLES_PASSED_CONSERVATIVE
+#define GL_ANY_SAMPLES_PASSED_CONSERVATIVE 0x8D6A
+#endif
 #ifndef GL_ALPHA_BITS
 #define GL_ALPHA_BITS 0xd55
 #endif
 #ifndef GL_ALPHA8
 #define GL_ALPHA8 0x803C
 #endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED 0x911A
+#endif
 #ifndef GL_BLUE
 #define GL_BLUE 0x1905
 #endif
@@ -124,9 +136,15 @@
 #ifndef GL_BUFFER_UPDATE_BARRIER_BIT
 #define GL_BUFFER_UPDATE_BARRIER_BIT 0x200
 #endif
+#ifndef GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT
+#define GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT 0x4000
+#endif
 #ifndef GL_COLOR_ATTACHMENT1
 #define GL_COLOR_ATTACHMENT1 0x8ce1
 #endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x40
+#endif
 #ifndef GL_COMPARE_REF_TO_TEXTURE
 #define GL_COMPARE_REF_TO_TEXTURE 0x884e
 #endif
@@ -265,6 +283,9 @@
 #ifndef GL_COMPUTE_SHADER
 #define GL_COMPUTE_SHADER 0x91B9
 #endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED 0x911C
+#endif
 #ifndef GL_COPY_READ_BUFFER
 #define GL_COPY_READ_BUFFER 0x8f36
 #endif
@@ -280,6 +301,9 @@
 #ifndef GL_DEBUG_TYPE_MARKER
 #define GL_DEBUG_TYPE_MARKER 0x8268
 #endif
+#ifndef GL_COLOR
+#define GL_COLOR 0x1800
+#endif
 #ifndef GL_DEPTH
 #define GL_DEPTH 0x1801
 #endif
@@ -298,6 +322,9 @@
 #ifndef GL_DEPTH32F_STENCIL8
 #define GL_DEPTH32F_STENCIL8 0x8CAD
 #endif
+#ifndef GL_DISPATCH_INDIRECT_BUFFER
+#define GL_DISPATCH_INDIRECT_BUFFER 0x90EE
+#endif
 #ifndef GL_DRAW_FRAMEBUFFER
 #define GL_DRAW_FRAMEBUFFER 0x8CA9
 #endif
@@ -313,6 +340,9 @@
 #ifndef GL_DYNAMIC_READ
 #define GL_DYNAMIC_READ 0x88e9
 #endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
 #ifndef GL_ELEMENT_ARRAY_BARRIER_BIT
 #define GL_ELEMENT_ARRAY_BARRIER_BIT 0x2
 #endif
@@ -367,6 +397,9 @@
 #ifndef GL_GENERATE_MIPMAP_HINT
 #define GL_GENERATE_MIPMAP_HINT 0x8192
 #endif
+#ifndef GL_GPU_DISJOINT_EXT
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
 #ifndef GL_GREEN
 #define GL_GREEN 0x1904
 #endif
@@ -430,9 +463,18 @@
 #ifndef GL_LUMINANCE8_ALPHA8
 #define GL_LUMINANCE8_ALPHA8 0x8045
 #endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
 #ifndef GL_MAP_READ_BIT
 #define GL_MAP_READ_BIT 0x1
 #endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
 #ifndef GL_MAX
 #define GL_MAX 0x8008
 #endif
@@ -469,12 +511,30 @@
 #ifndef GL_NUM_EXTENSIONS
 #define GL_NUM_EXTENSIONS 0x821d
 #endif
+#ifndef GL_PIXEL_BUFFER_BARRIER_BIT
+#define GL_PIXEL_BUFFER_BARRIER_BIT 0x80
+#endif
 #ifndef GL_PIXEL_PACK_BUFFER
 #define GL_PIXEL_PACK_BUFFER 0x88eb
 #endif
 #ifndef GL_PIXEL_UNPACK_BUFFER
 #define GL_PIXEL_UNPACK_BUFFER 0x88ec
 #endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87fe
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
 #ifndef GL_R16
 #define GL_R16 0x822A
 #endif
@@ -562,6 +622,9 @@
 #ifndef GL_RGBA8
 #define GL_RGBA8 0x8058
 #endif
+#ifndef GL_SAMPLES_PASSED
+#define GL_SAMPLES_PASSED 0x8914
+#endif
 #ifndef GL_SAMPLER_1D
 #define GL_SAMPLER_1D 0x8B5D
 #endif
@@ -577,6 +640,9 @@
 #ifndef GL_SAMPLER_EXTERNAL_OES
 #define GL_SAMPLER_EXTERNAL_OES 0x8D66
 #endif
+#ifndef GL_SHADER_IMAGE_ACCESS_BARRIER_BIT
+#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT 0x20
+#endif
 #ifndef GL_SHADER_STORAGE_BARRIER_BIT
 #define GL_SHADER_STORAGE_BARRIER_BIT 0x2000
 #endif
@@ -622,6 +688,9 @@
 #ifndef GL_STREAM_READ
 #define GL_STREAM_READ 0x88e1
 #endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
 #ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
 #define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
 #endif
@@ -682,6 +751,12 @@
 #ifndef GL_TEXTURE_WRAP_R
 #define GL_TEXTURE_WRAP_R 0x8072
 #endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP 0x8E28
+#endif
 #ifndef GL_TRANSFORM_FEEDBACK_BUFFER
 #define GL_TRANSFORM_FEEDBACK_BUFFER 0x8c8e
 #endif
@@ -700,6 +775,9 @@
 #ifndef GL_UNIFORM_BUFFER
 #define GL_UNIFORM_BUFFER 0x8a11
 #endif
+#ifndef GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8a34
+#endif
 #ifndef GL_UNIFORM_OFFSET
 #define GL_UNIFORM_OFFSET 0x8a3b
 #endif
@@ -739,3 +817,38 @@
 #ifndef GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
 #define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x1
 #endif
+#ifndef GL_WAIT_FAILED
+#define GL_WAIT_FAILED 0x911D
+#endif
+
+// Tracy GPU zones use GL_TIMESTAMP queries, which are only available on desktop OpenGL;
+// TracyOpenGL.hpp does not support Apple platforms
+#if defined(IGL_WITH_TRACY_GPU) && IGL_OPENGL && !IGL_PLATFORM_APPLE
+#include "tracy/TracyOpenGL.hpp"
+#define IGL_WITH_TRACY_GPU_OGL 1
+// GPU zones are recorded into the GL command stream of the calling thread; they are inactive on
+// threads without a Tracy GPU context (see IContext::initialize())
+#define IGL_PROFILER_ZONE_GPU_OGL(name) \
+  TracyGpuNamedZone(iglGpuZone, name, tracy::GetGpuCtx().ptr != nullptr)
+#define IGL_PROFILER_ZONE_GPU_COLOR_OGL(name, color) \
+  TracyGpuNamedZoneC(iglGpuZone, name, color, tracy::GetGpuCtx().ptr != nullptr)
+// begins a GPU zone which lasts until `scope` (std::unique_ptr<tracy::GpuCtxScope>) is reset
+#define IGL_PROFILER_ZONE_GPU_BEGIN_OGL(scope, name)                                       \
+  {                                                                                       \
+    static constexpr tracy::SourceLocationData kIglGpuZoneLocation{                       \
+        name, TracyFunction, TracyFile, (uint32_t)TracyLine, 0};                          \
+    scope = std::make_unique<tracy::GpuCtxScope>(&kIglGpuZoneLocation,                    \
+                                                 tracy::GetGpuCtx().ptr != nullptr);      \
+  }
+// reads back the timestamps of finished GPU zones
+#define IGL_PROFILER_GPU_COLLECT_OGL()    \
+  if (tracy::GetGpuCtx().ptr != nullptr) { \
+    TracyGpuCollect;                       \
+  }
+#else
+#define IGL_WITH_TRACY_GPU_OGL 0
+#define IGL_PROFILER_ZONE_GPU_OGL(name)
+#define IGL_PROFILER_ZONE_GPU_COLOR_OGL(name, color)
+#define IGL_PROFILER_ZONE_GPU_BEGIN_OGL(scope, name)
+#define IGL_PROFILER_GPU_COLLECT_OGL()
+#endif // IGL_WITH_TRACY_GPU
@@ -8,6 +8,8 @@
 #include <igl/DeviceFeatures.h>
 #include <igl/opengl/IContext.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <igl/Assert.h>
 #include <igl/opengl/Errors.h>
@@ -35,35 +37,55 @@
 #define APILOG(format, ...) static_cast<void>(0)
 #endif // defined(IGL_API_LOG) && (IGL_DEBUG || defined(IGL_FORCE_ENABLE_LOGS))
 
+// IGL_GL_CONTEXT_CHECK_INTERVAL controls how often the GL call wrappers validate that this context
+// (or one in its sharegroup) is current: 1 before every call, N > 1 before every Nth call and 0
+// never. The check is compiled out as well when error reporting is disabled.
+#ifndef IGL_GL_CONTEXT_CHECK_INTERVAL
+#define IGL_GL_CONTEXT_CHECK_INTERVAL 1
+#endif
+
+#if IGL_GL_CONTEXT_CHECK_INTERVAL == 0
+#define GLCHECK_CURRENT_CONTEXT() static_cast<void>(0)
+#elif IGL_GL_CONTEXT_CHECK_INTERVAL == 1
+#define GLCHECK_CURRENT_CONTEXT() IGL_REPORT_ERROR(isCurrentContextOrSharegroup())
+#else
+#define GLCHECK_CURRENT_CONTEXT()                            \
+  do {                                                       \
+    if (callCounter_ % IGL_GL_CONTEXT_CHECK_INTERVAL == 0) { \
+      IGL_REPORT_ERROR(isCurrentContextOrSharegroup());      \
+    }                                                        \
+  } while (false)
+#endif // IGL_GL_CONTEXT_CHECK_INTERVAL
+
 #define GLCALL(funcName)                                         \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
+  GLCHECK_CURRENT_CONTEXT();                                     \
   callCounter_++;                                                \
   gl##funcName
 
 #define IGLCALL(funcName)                                        \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
+  GLCHECK_CURRENT_CONTEXT();                                     \
   callCounter_++;                                                \
   igl##funcName
 
 #define GLCALL_WITH_RETURN(ret, funcName)                        \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
+  GLCHECK_CURRENT_CONTEXT();                                     \
   callCounter_++;                                                \
   ret = gl##funcName
 
 #define IGLCALL_WITH_RETURN(ret, funcName)                       \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
+  GLCHECK_CURRENT_CONTEXT();                                     \
   callCounter_++;                                                \
   ret = igl##funcName
 
 #define GLCALL_PROC(funcPtr, ...)                                \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
+  GLCHECK_CURRENT_CONTEXT();                                     \
   if (funcPtr) {                                                 \
     callCounter_++;                                              \
     (*funcPtr)(__VA_ARGS__);                                     \
   }
 
 #define GLCALL_PROC_WITH_RETURN(ret, funcPtr, returnOnError, ...) \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup());  \
+  GLCHECK_CURRENT_CONTEXT();                                      \
   if (funcPtr) {                                                  \
     callCounter_++;                                               \
     ret = (*funcPtr)(__VA_ARGS__);                                \
@@ -200,6 +222,7 @@ std::string GLenumToString(GLenum code) {
     RESULT_CASE(GL_DEPTH24_STENCIL8)
     RESULT_CASE(GL_DEPTH32F_STENCIL8)
     RESULT_CASE(GL_DEPTH_TEST)
+    RESULT_CASE(GL_DISPATCH_INDIRECT_BUFFER)
     RESULT_CASE(GL_DITHER)
     RESULT_CASE(GL_DONT_CARE)
     RESULT_CASE(GL_DRAW_FRAMEBUFFER)
@@ -538,6 +561,55 @@ Result::Code GLerrorToCode(GLenum error) {
 
 #define GL_ERROR_TO_STRING(error) GLerrorToString(error)
 #define GL_ERROR_TO_RESULT(error) Result(GLerrorToCode(error), GLerrorToString(error))
+
+// Returns an index into StateCache::textures or -1 if bindings of `target` are not cached
+int getCachedTextureTargetIndex(GLenum target) {
+  switch (target) {
+  case GL_TEXTURE_2D:
+    return 0;
+  case GL_TEXTURE_CUBE_MAP:
+    return 1;
+  case GL_TEXTURE_3D:
+    return 2;
+  case GL_TEXTURE_2D_ARRAY:
+    return 3;
+  case GL_TEXTURE_EXTERNAL_OES:
+    return 4;
+  case GL_TEXTURE_2D_MULTISAMPLE:
+    return 5;
+  case GL_TEXTURE_RECTANGLE:
+    return 6;
+  default:
+    return -1;
+  }
+}
+
+// Returns an index into StateCache::capabilities or -1 if `cap` is not cached
+int getCachedCapabilityIndex(GLenum cap) {
+  switch (cap) {
+  case GL_BLEND:
+    return 0;
+  case GL_CULL_FACE:
+    return 1;
+  case GL_DEPTH_TEST:
+    return 2;
+  case GL_DITHER:
+    return 3;
+  case GL_POLYGON_OFFSET_FILL:
+    return 4;
+  case GL_SAMPLE_ALPHA_TO_COVERAGE:
+    return 5;
+  case GL_SCISSOR_TEST:
+    return 6;
+  case GL_STENCIL_TEST:
+    return 7;
+  default:
+    return -1;
+  }
+}
+
+// The context most recently made current through IGL on this thread
+thread_local const IContext* tlsCurrentContext = nullptr;
 } // namespace
 
 // NOLINTNEXTLINE(modernize-use-equals-default)
@@ -553,10 +625,27 @@ IContext::~IContext() {
                        "Dangling IContext reference left behind."
                        // @fb-only
   );
+  didClearCurrent();
   // Clear the zombie guard explicitly so our "secret" stays secret.
   zombieGuard_ = 0;
 }
 
+void IContext::didMakeCurrent() const {
+  tlsCurrentContext = this;
+}
+
+void IContext::didClearCurrent() const {
+  if (tlsCurrentContext == this) {
+    tlsCurrentContext = nullptr;
+  }
+}
+
+bool IContext::isCurrentContextOrSharegroup() const {
+  // The thread-local is only a shortcut: contexts made current behind IGL's back are still found by
+  // asking the platform
+  return tlsCurrentContext == this || isCurrentContext() || isCurrentSharegroup();
+}
+
 // Creates a global map to ensure multiple IContexts are not created for a single glContext
 std::unordered_map<void*, IContext*>& IContext::getExistingContexts() {
   static auto& map = *(new std::unordered_map<void*, IContext*>());
@@ -597,6 +686,13 @@ bool IContext::shouldQueueAPI() const {
 }
 
 void IContext::activeTexture(GLenum texture) {
+  if (stateCache_.enabled) {
+    if (stateCache_.activeTexture == texture) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    stateCache_.activeTexture = texture;
+  }
   GLCALL(ActiveTexture)(texture);
   APILOG("glActiveTexture(%s)\n", GL_ENUM_TO_STRING(texture));
   GLCHECK_ERRORS();
@@ -614,7 +710,30 @@ void IContext::bindAttribLocation(GLuint program, GLuint index, const GLchar* na
   GLCHECK_ERRORS();
 }
 
+void IContext::beginQuery(GLenum target, GLuint query) {
+  if (beginQueryProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::QueryObjects)) {
+      beginQueryProc_ = iglBeginQuery;
+    }
+  }
+  GLCALL_PROC(beginQueryProc_, target, query);
+  APILOG("glBeginQuery(%s, %u)\n", GL_ENUM_TO_STRING(target), query);
+  GLCHECK_ERRORS();
+}
+
 void IContext::bindBuffer(GLenum target, GLuint buffer) {
+  if (stateCache_.enabled) {
+    GLuint* cached = target == GL_ARRAY_BUFFER           ? &stateCache_.arrayBuffer
+                     : target == GL_ELEMENT_ARRAY_BUFFER ? &stateCache_.elementArrayBuffer
+                                                         : nullptr;
+    if (cached) {
+      if (*cached == buffer) {
+        stateCacheSavedCallCounter_++;
+        return;
+      }
+      *cached = buffer;
+    }
+  }
   GLCALL(BindBuffer)(target, buffer);
   APILOG("glBindBuffer(%s, %u)\n", GL_ENUM_TO_STRING(target), buffer);
   GLCHECK_ERRORS();
@@ -636,7 +755,39 @@ void IContext::bindBufferRange(GLenum target,
   GLCHECK_ERRORS();
 }
 
+void IContext::bindBuffersRange(GLenum target,
+                                GLuint first,
+                                GLsizei count,
+                                const GLuint* buffers,
+                                const GLintptr* offsets,
+                                const GLsizeiptr* sizes) {
+  IGLCALL(BindBuffersRange)(target, first, count, buffers, offsets, sizes);
+  APILOG("glBindBuffersRange(%s, %u, %d, %p, %p, %p)\n",
+         GL_ENUM_TO_STRING(target),
+         first,
+         count,
+         buffers,
+         offsets,
+         sizes);
+  GLCHECK_ERRORS();
+}
+
 void IContext::bindFramebuffer(GLenum target, GLuint framebuffer) {
+  if (stateCache_.enabled) {
+    const bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+    const bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+    if ((!draw || stateCache_.drawFramebuffer == framebuffer) &&
+        (!read || stateCache_.readFramebuffer == framebuffer)) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    if (draw) {
+      stateCache_.drawFramebuffer = framebuffer;
+    }
+    if (read) {
+      stateCache_.readFramebuffer = framebuffer;
+    }
+  }
   IGLCALL(BindFramebuffer)(target, framebuffer);
   APILOG("glBindFramebuffer(%s, %u)\n", GL_ENUM_TO_STRING(target), framebuffer);
   GLCHECK_ERRORS();
@@ -649,11 +800,40 @@ void IContext::bindRenderbuffer(GLenum target, GLuint renderbuffer) {
 }
 
 void IContext::bindTexture(GLenum target, GLuint texture) {
+  if (stateCache_.enabled) {
+    const int targetIndex = getCachedTextureTargetIndex(target);
+    const GLuint unit = stateCache_.activeTexture - GL_TEXTURE0;
+    // the active texture unit has to be known too
+    if (targetIndex >= 0 && stateCache_.activeTexture != StateCache::kUnknown &&
+        unit < StateCache::kMaxTextureUnits) {
+      GLuint& cached = stateCache_.textures[unit][targetIndex];
+      if (cached == texture) {
+        stateCacheSavedCallCounter_++;
+        return;
+      }
+      cached = texture;
+    }
+  }
   GLCALL(BindTexture)(target, texture);
   APILOG("glBindTexture(%s, %u)\n", GL_ENUM_TO_STRING(target), texture);
   GLCHECK_ERRORS();
 }
 
+void IContext::bindTextures(GLuint first, GLsizei count, const GLuint* textures) {
+  if (stateCache_.enabled) {
+    // the targets the textures end up bound to are not known here
+    for (GLuint unit = first; unit < first + count && unit < StateCache::kMaxTextureUnits;
+         unit++) {
+      for (auto& cached : stateCache_.textures[unit]) {
+        cached = StateCache::kUnknown;
+      }
+    }
+  }
+  IGLCALL(BindTextures)(first, count, textures);
+  APILOG("glBindTextures(%u, %d, %p)\n", first, count, textures);
+  GLCHECK_ERRORS();
+}
+
 void IContext::bindImageTexture(GLuint unit,
                                 GLuint texture,
                                 GLint level,
@@ -692,6 +872,15 @@ void IContext::bindVertexArray(GLuint vao) {
       bindVertexArrayProc_ = iglBindVertexArray;
     }
   }
+  if (stateCache_.enabled && bindVertexArrayProc_) {
+    if (stateCache_.vertexArray == vao) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    stateCache_.vertexArray = vao;
+    // GL_ELEMENT_ARRAY_BUFFER binding belongs to the vertex array object
+    stateCache_.elementArrayBuffer = StateCache::kUnknown;
+  }
   GLCALL_PROC(bindVertexArrayProc_, vao);
   APILOG("glBindVertexArray(%u)\n", vao);
   GLCHECK_ERRORS();
@@ -704,12 +893,27 @@ void IContext::blendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alph
 }
 
 void IContext::blendEquation(GLenum mode) {
+  if (stateCache_.enabled) {
+    if (stateCache_.blendEquation[0] == mode && stateCache_.blendEquation[1] == mode) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    stateCache_.blendEquation[0] = stateCache_.blendEquation[1] = mode;
+  }
   GLCALL(BlendEquation)(mode);
   APILOG("glBlendEquation(%s)\n", GL_ENUM_TO_STRING(mode));
   GLCHECK_ERRORS();
 }
 
 void IContext::blendEquationSeparate(GLenum modeRGB, GLenum modeAlpha) {
+  if (stateCache_.enabled) {
+    if (stateCache_.blendEquation[0] == modeRGB && stateCache_.blendEquation[1] == modeAlpha) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    stateCache_.blendEquation[0] = modeRGB;
+    stateCache_.blendEquation[1] = modeAlpha;
+  }
   GLCALL(BlendEquationSeparate)(modeRGB, modeAlpha);
   APILOG("glBlendEquationSeparate(%s, %s)\n",
          GL_ENUM_TO_STRING(modeRGB),
@@ -718,12 +922,34 @@ void IContext::blendEquationSeparate(GLenum modeRGB, GLenum modeAlpha) {
 }
 
 void IContext::blendFunc(GLenum sfactor, GLenum dfactor) {
+  if (stateCache_.enabled) {
+    GLenum* cached = stateCache_.blendFunc;
+    if (cached[0] == sfactor && cached[1] == dfactor && cached[2] == sfactor &&
+        cached[3] == dfactor) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    cached[0] = cached[2] = sfactor;
+    cached[1] = cached[3] = dfactor;
+  }
   GLCALL(BlendFunc)(sfactor, dfactor);
   APILOG("glBlendFunc(%s, %s)\n", GL_ENUM_TO_STRING(sfactor), GL_ENUM_TO_STRING(dfactor));
   GLCHECK_ERRORS();
 }
 
 void IContext::blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) {
+  if (stateCache_.enabled) {
+    GLenum* cached = stateCache_.blendFunc;
+    if (cached[0] == srcRGB && cached[1] == dstRGB && cached[2] == srcAlpha &&
+        cached[3] == dstAlpha) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    cached[0] = srcRGB;
+    cached[1] = dstRGB;
+    cached[2] = srcAlpha;
+    cached[3] = dstAlpha;
+  }
   GLCALL(BlendFuncSeparate)(srcRGB, dstRGB, srcAlpha, dstAlpha);
   APILOG("glBlendFuncSeparate(%s, %s, %s, %s)\n",
          GL_ENUM_TO_STRING(srcRGB),
@@ -769,6 +995,7 @@ void IContext::blitFramebuffer(GLint srcX0,
 }
 
 void IContext::bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage) {
+  IGL_PROFILER_FUNCTION();
   GLCALL(BufferData)(target, size, data, usage);
   APILOG("glBufferData(%s, %zu, %p, %s)\n",
          GL_ENUM_TO_STRING(target),
@@ -776,12 +1003,44 @@ void IContext::bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GL
          data,
          GL_ENUM_TO_STRING(usage));
   GLCHECK_ERRORS();
+  if (data) {
+    frameStatistics_.add(FrameStatisticsTracker::UploadedBytes, size);
+  }
+}
+
+void IContext::bufferStorage(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags) {
+  if (bufferStorageProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::BufferStorageExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::BufferStorage)) {
+        bufferStorageProc_ = iglBufferStorageEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::BufferStorage)) {
+      bufferStorageProc_ = iglBufferStorage;
+    }
+  }
+
+  GLCALL_PROC(bufferStorageProc_, target, size, data, flags);
+  APILOG("glBufferStorage(%s, %zu, %p, 0x%x)\n", GL_ENUM_TO_STRING(target), size, data, flags);
+  GLCHECK_ERRORS();
 }
 
 void IContext::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data) {
+  IGL_PROFILER_FUNCTION();
   GLCALL(BufferSubData)(target, offset, size, data);
   APILOG("glBufferSubData(%s, %zu, %zu, %p)\n", GL_ENUM_TO_STRING(target), offset, size, data);
   GLCHECK_ERRORS();
+  frameStatistics_.add(FrameStatisticsTracker::UploadedBytes, size);
+}
+
+void IContext::namedBufferSubData(GLuint buffer,
+                                  GLintptr offset,
+                                  GLsizeiptr size,
+                                  const GLvoid* data) {
+  IGL_PROFILER_FUNCTION();
+  IGLCALL(NamedBufferSubData)(buffer, offset, size, data);
+  APILOG("glNamedBufferSubData(%u, %zu, %zu, %p)\n", buffer, offset, size, data);
+  GLCHECK_ERRORS();
+  frameStatistics_.add(FrameStatisticsTracker::UploadedBytes, size);
 }
 
 GLenum IContext::checkFramebufferStatus(GLenum target) {
@@ -828,7 +1087,43 @@ void IContext::clearStencil(GLint s) {
   GLCHECK_ERRORS();
 }
 
+GLenum IContext::clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+  if (clientWaitSyncProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::SyncExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::Sync)) {
+        clientWaitSyncProc_ = iglClientWaitSyncAPPLE;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::Sync)) {
+      clientWaitSyncProc_ = iglClientWaitSync;
+    }
+  }
+
+  GLenum ret;
+
+  if (timeout) {
+    frameStatistics_.add(FrameStatisticsTracker::GpuWaits);
+  }
+  GLCALL_PROC_WITH_RETURN(ret, clientWaitSyncProc_, GL_WAIT_FAILED, sync, flags, timeout);
+  APILOG("glClientWaitSync(%p, 0x%x, %llu) = %s\n",
+         sync,
+         flags,
+         static_cast<unsigned long long>(timeout),
+         GL_ENUM_TO_STRING(ret));
+  GLCHECK_ERRORS();
+
+  return ret;
+}
+
 void IContext::colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
+  if (stateCache_.enabled) {
+    const GLuint mask = (red ? 1u : 0u) | (green ? 2u : 0u) | (blue ? 4u : 0u) | (alpha ? 8u : 0u);
+    if (stateCache_.colorMask == mask) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    stateCache_.colorMask = mask;
+  }
   GLCALL(ColorMask)(red, green, blue, alpha);
   APILOG("glColorMask(%s, %s, %s, %s)\n",
          GL_BOOL_TO_STRING(red),
@@ -839,6 +1134,7 @@ void IContext::colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboole
 }
 
 void IContext::compileShader(GLuint shader) {
+  IGL_PROFILER_FUNCTION();
   GLCALL(CompileShader)(shader);
   APILOG("glCompileShader(%u)\n", shader);
   GLCHECK_ERRORS();
@@ -1097,6 +1393,13 @@ GLuint IContext::createShader(GLenum shaderType) {
 }
 
 void IContext::cullFace(GLint mode) {
+  if (stateCache_.enabled) {
+    if (stateCache_.cullFace == static_cast<GLenum>(mode)) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    stateCache_.cullFace = static_cast<GLenum>(mode);
+  }
   GLCALL(CullFace)(mode);
   APILOG("glCullFace(%s)\n", GL_ENUM_TO_STRING(mode));
   GLCHECK_ERRORS();
@@ -1137,7 +1440,12 @@ void IContext::deleteBuffers(GLsizei n, const GLuint* buffers) {
   if (isDestructionAllowed() && IGL_VERIFY(buffers != nullptr)) {
     if (shouldQueueAPI()) {
       deletionQueues_.queueDeleteBuffers(n, buffers);
+    } else if (shouldDeferDeletion()) {
+      frameDeletions_.buffers.insert(frameDeletions_.buffers.end(), buffers, buffers + n);
     } else {
+      stateCache_.onBuffersDeleted(n, buffers);
+      // cached VAOs would keep the deleted buffers alive and clash with reused names
+      vertexArrayCache_.onBuffersDeleted(*this, n, buffers);
       GLCALL(DeleteBuffers)(n, buffers);
       APILOG("glDeleteBuffers(%u, %p)\n", n, buffers);
       GLCHECK_ERRORS();
@@ -1163,7 +1471,11 @@ void IContext::deleteFramebuffers(GLsizei n, const GLuint* framebuffers) {
   if (isDestructionAllowed() && IGL_VERIFY(framebuffers != nullptr)) {
     if (shouldQueueAPI()) {
       deletionQueues_.queueDeleteFramebuffers(n, framebuffers);
+    } else if (shouldDeferDeletion()) {
+      frameDeletions_.framebuffers.insert(
+          frameDeletions_.framebuffers.end(), framebuffers, framebuffers + n);
     } else {
+      stateCache_.onFramebuffersDeleted(n, framebuffers);
       IGLCALL(DeleteFramebuffers)(n, framebuffers);
       APILOG("glDeleteFramebuffers(%u, %p)\n", n, framebuffers);
       GLCHECK_ERRORS();
@@ -1187,6 +1499,9 @@ void IContext::deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {
   if (isDestructionAllowed() && IGL_VERIFY(renderbuffers != nullptr)) {
     if (shouldQueueAPI()) {
       deletionQueues_.queueDeleteRenderbuffers(n, renderbuffers);
+    } else if (shouldDeferDeletion()) {
+      frameDeletions_.renderbuffers.insert(
+          frameDeletions_.renderbuffers.end(), renderbuffers, renderbuffers + n);
     } else {
       IGLCALL(DeleteRenderbuffers)(n, renderbuffers);
       APILOG("glDeleteRenderbuffers(%u, %p)\n", n, renderbuffers);
@@ -1209,6 +1524,7 @@ void IContext::deleteVertexArrays(GLsizei n, const GLuint* vertexArrays) {
     if (shouldQueueAPI()) {
       deletionQueues_.queueDeleteVertexArrays(n, vertexArrays);
     } else {
+      stateCache_.onVertexArraysDeleted(n, vertexArrays);
       GLCALL_PROC(deleteVertexArraysProc_, n, vertexArrays);
       APILOG("glDeleteVertexArrays(%u, %p)\n", n, vertexArrays);
       GLCHECK_ERRORS();
@@ -1216,6 +1532,26 @@ void IContext::deleteVertexArrays(GLsizei n, const GLuint* vertexArrays) {
   }
 }
 
+void IContext::deleteQueries(GLsizei n, const GLuint* queries) {
+  if (deleteQueriesProc_ == nullptr) {
+    // Query objects are core in OpenGL ES 3.0, GL_EXT_disjoint_timer_query adds them to ES 2.0
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::QueryObjects)) {
+      deleteQueriesProc_ = iglDeleteQueries;
+    } else if (deviceFeatureSet_.hasExtension(Extensions::DisjointTimerQuery)) {
+      deleteQueriesProc_ = iglDeleteQueriesEXT;
+    }
+  }
+  if (isDestructionAllowed() && IGL_VERIFY(queries != nullptr)) {
+    if (shouldQueueAPI()) {
+      deletionQueues_.queueDeleteQueries(n, queries);
+    } else {
+      GLCALL_PROC(deleteQueriesProc_, n, queries);
+      APILOG("glDeleteQueries(%u, %p)\n", n, queries);
+      GLCHECK_ERRORS();
+    }
+  }
+}
+
 void IContext::deleteShader(GLuint shaderId) {
   if (isDestructionAllowed()) {
     if (shouldQueueAPI()) {
@@ -1248,7 +1584,11 @@ void IContext::deleteTextures(const std::vector<GLuint>& textures) {
   if (isDestructionAllowed() && !textures.empty()) {
     if (shouldQueueAPI()) {
       deletionQueues_.queueDeleteTextures(textures);
+    } else if (shouldDeferDeletion()) {
+      frameDeletions_.textures.insert(
+          frameDeletions_.textures.end(), textures.begin(), textures.end());
     } else {
+      stateCache_.onTexturesDeleted(static_cast<GLsizei>(textures.size()), textures.data());
       GLCALL(DeleteTextures)(static_cast<GLsizei>(textures.size()), textures.data());
       APILOG("glDeleteTextures(%u, %p)\n", textures.size(), textures.data());
       GLCHECK_ERRORS();
@@ -1257,12 +1597,26 @@ void IContext::deleteTextures(const std::vector<GLuint>& textures) {
 }
 
 void IContext::depthFunc(GLenum func) {
+  if (stateCache_.enabled) {
+    if (stateCache_.depthFunc == func) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    stateCache_.depthFunc = func;
+  }
   GLCALL(DepthFunc)(func);
   APILOG("glDepthFunc(%s)\n", GL_ENUM_TO_STRING(func));
   GLCHECK_ERRORS();
 }
 
 void IContext::depthMask(GLboolean flag) {
+  if (stateCache_.enabled) {
+    if (stateCache_.depthMask == flag) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    stateCache_.depthMask = flag;
+  }
   GLCALL(DepthMask)(flag);
   APILOG("glDepthMask(%s)\n", GL_BOOL_TO_STRING(flag));
   GLCHECK_ERRORS();
@@ -1281,6 +1635,16 @@ void IContext::detachShader(GLuint program, GLuint shader) {
 }
 
 void IContext::disable(GLenum cap) {
+  if (stateCache_.enabled) {
+    const int index = getCachedCapabilityIndex(cap);
+    if (index >= 0) {
+      if (stateCache_.capabilities[index] == GL_FALSE) {
+        stateCacheSavedCallCounter_++;
+        return;
+      }
+      stateCache_.capabilities[index] = GL_FALSE;
+    }
+  }
   GLCALL(Disable)(cap);
   APILOG("glDisable(%s)\n", GL_ENUM_TO_STRING(cap));
   GLCHECK_ERRORS();
@@ -1301,6 +1665,46 @@ void IContext::drawArrays(GLenum mode, GLint first, GLsizei count) {
   APILOG_DEC_DRAW_COUNT();
 }
 
+void IContext::drawArraysIndirect(GLenum mode, const GLvoid* indirect) {
+  drawCallCount_++;
+  IGLCALL(DrawArraysIndirect)(mode, indirect);
+  APILOG("glDrawArraysIndirect(%s, %p)\n", GL_ENUM_TO_STRING(mode), indirect);
+  GLCHECK_ERRORS();
+  APILOG_DEC_DRAW_COUNT();
+}
+
+void IContext::drawArraysInstanced(GLenum mode,
+                                   GLint first,
+                                   GLsizei count,
+                                   GLsizei instancecount) {
+  drawCallCount_++;
+  IGLCALL(DrawArraysInstanced)(mode, first, count, instancecount);
+  APILOG("glDrawArraysInstanced(%s, %d, %u, %u)\n",
+         GL_ENUM_TO_STRING(mode),
+         first,
+         count,
+         instancecount);
+  GLCHECK_ERRORS();
+  APILOG_DEC_DRAW_COUNT();
+}
+
+void IContext::drawArraysInstancedBaseInstance(GLenum mode,
+                                               GLint first,
+                                               GLsizei count,
+                                               GLsizei instancecount,
+                                               GLuint baseinstance) {
+  drawCallCount_++;
+  IGLCALL(DrawArraysInstancedBaseInstance)(mode, first, count, instancecount, baseinstance);
+  APILOG("glDrawArraysInstancedBaseInstance(%s, %d, %u, %u, %u)\n",
+         GL_ENUM_TO_STRING(mode),
+         first,
+         count,
+         instancecount,
+         baseinstance);
+  GLCHECK_ERRORS();
+  APILOG_DEC_DRAW_COUNT();
+}
+
 void IContext::drawBuffers(GLsizei n, GLenum* buffers) {
   if (drawBuffersProc_ == nullptr) {
     if (deviceFeatureSet_.hasFeature(DeviceFeatures::MultipleRenderTargets)) {
@@ -1343,7 +1747,75 @@ void IContext::drawElementsIndirect(GLenum mode, GLenum type, const GLvoid* indi
   APILOG_DEC_DRAW_COUNT();
 }
 
+void IContext::drawElementsInstanced(GLenum mode,
+                                     GLsizei count,
+                                     GLenum type,
+                                     const GLvoid* indices,
+                                     GLsizei instancecount) {
+  drawCallCount_++;
+  IGLCALL(DrawElementsInstanced)(mode, count, type, indices, instancecount);
+  APILOG("glDrawElementsInstanced(%s, %u, %s, %p, %u)\n",
+         GL_ENUM_TO_STRING(mode),
+         count,
+         GL_ENUM_TO_STRING(type),
+         indices,
+         instancecount);
+  GLCHECK_ERRORS();
+  APILOG_DEC_DRAW_COUNT();
+}
+
+void IContext::drawElementsInstancedBaseVertex(GLenum mode,
+                                               GLsizei count,
+                                               GLenum type,
+                                               const GLvoid* indices,
+                                               GLsizei instancecount,
+                                               GLint basevertex) {
+  drawCallCount_++;
+  IGLCALL(DrawElementsInstancedBaseVertex)(mode, count, type, indices, instancecount, basevertex);
+  APILOG("glDrawElementsInstancedBaseVertex(%s, %u, %s, %p, %u, %d)\n",
+         GL_ENUM_TO_STRING(mode),
+         count,
+         GL_ENUM_TO_STRING(type),
+         indices,
+         instancecount,
+         basevertex);
+  GLCHECK_ERRORS();
+  APILOG_DEC_DRAW_COUNT();
+}
+
+void IContext::drawElementsInstancedBaseVertexBaseInstance(GLenum mode,
+                                                           GLsizei count,
+                                                           GLenum type,
+                                                           const GLvoid* indices,
+                                                           GLsizei instancecount,
+                                                           GLint basevertex,
+                                                           GLuint baseinstance) {
+  drawCallCount_++;
+  IGLCALL(DrawElementsInstancedBaseVertexBaseInstance)
+  (mode, count, type, indices, instancecount, basevertex, baseinstance);
+  APILOG("glDrawElementsInstancedBaseVertexBaseInstance(%s, %u, %s, %p, %u, %d, %u)\n",
+         GL_ENUM_TO_STRING(mode),
+         count,
+         GL_ENUM_TO_STRING(type),
+         indices,
+         instancecount,
+         basevertex,
+         baseinstance);
+  GLCHECK_ERRORS();
+  APILOG_DEC_DRAW_COUNT();
+}
+
 void IContext::enable(GLenum cap) {
+  if (stateCache_.enabled) {
+    const int index = getCachedCapabilityIndex(cap);
+    if (index >= 0) {
+      if (stateCache_.capabilities[index] == GL_TRUE) {
+        stateCacheSavedCallCounter_++;
+        return;
+      }
+      stateCache_.capabilities[index] = GL_TRUE;
+    }
+  }
   GLCALL(Enable)(cap);
   APILOG("glEnable(%s)\n", GL_ENUM_TO_STRING(cap));
   GLCHECK_ERRORS();
@@ -1375,13 +1847,27 @@ GLsync IContext::fenceSync(GLenum condition, GLbitfield flags) {
   return sync;
 }
 
+void IContext::endQuery(GLenum target) {
+  if (endQueryProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::QueryObjects)) {
+      endQueryProc_ = iglEndQuery;
+    }
+  }
+  GLCALL_PROC(endQueryProc_, target);
+  APILOG("glEndQuery(%s)\n", GL_ENUM_TO_STRING(target));
+  GLCHECK_ERRORS();
+}
+
 void IContext::finish() {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+  frameStatistics_.add(FrameStatisticsTracker::GpuWaits);
   GLCALL(Finish)();
   APILOG("glFinish\n");
   GLCHECK_ERRORS();
 }
 
 void IContext::flush() {
+  IGL_PROFILER_FUNCTION();
   GLCALL(Flush)();
   APILOG("glFlush\n");
   GLCHECK_ERRORS();
@@ -1472,6 +1958,13 @@ void IContext::framebufferTextureLayer(GLenum target,
 }
 
 void IContext::frontFace(GLenum mode) {
+  if (stateCache_.enabled) {
+    if (stateCache_.frontFace == mode) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    stateCache_.frontFace = mode;
+  }
   GLCALL(FrontFace)(mode);
   APILOG("glFrontFace(%s)\n", GL_ENUM_TO_STRING(mode));
   GLCHECK_ERRORS();
@@ -1541,6 +2034,20 @@ void IContext::genVertexArrays(GLsizei n, GLuint* vertexArrays) {
   GLCHECK_ERRORS();
 }
 
+void IContext::genQueries(GLsizei n, GLuint* queries) {
+  if (genQueriesProc_ == nullptr) {
+    // Query objects are core in OpenGL ES 3.0, GL_EXT_disjoint_timer_query adds them to ES 2.0
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::QueryObjects)) {
+      genQueriesProc_ = iglGenQueries;
+    } else if (deviceFeatureSet_.hasExtension(Extensions::DisjointTimerQuery)) {
+      genQueriesProc_ = iglGenQueriesEXT;
+    }
+  }
+  GLCALL_PROC(genQueriesProc_, n, queries);
+  APILOG("glGenQueries(%u, %p) = %u\n", n, queries, queries == nullptr ? 0 : *queries);
+  GLCHECK_ERRORS();
+}
+
 void IContext::getActiveAttrib(GLuint program,
                                GLuint index,
                                GLsizei bufsize,
@@ -1709,6 +2216,28 @@ void IContext::getIntegerv(GLenum pname, GLint* params) const {
   GLCHECK_ERRORS();
 }
 
+void IContext::getProgramBinary(GLuint program,
+                                GLsizei bufSize,
+                                GLsizei* length,
+                                GLenum* binaryFormat,
+                                void* binary) const {
+  IGL_PROFILER_FUNCTION();
+  if (getProgramBinaryProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::ProgramBinary)) {
+      getProgramBinaryProc_ = iglGetProgramBinary;
+    }
+  }
+
+  GLCALL_PROC(getProgramBinaryProc_, program, bufSize, length, binaryFormat, binary);
+  APILOG("glGetProgramBinary(%u, %d, %p, %p, %p)\n",
+         program,
+         bufSize,
+         length,
+         binaryFormat,
+         binary);
+  GLCHECK_ERRORS();
+}
+
 void IContext::getProgramiv(GLuint program, GLenum pname, GLint* params) const {
   GLCALL(GetProgramiv)(program, pname, params);
   APILOG("glGetProgramiv(%u, %s, %p) = %d\n",
@@ -1806,6 +2335,43 @@ void IContext::getProgramResourceName(GLuint program,
   GLCHECK_ERRORS();
 }
 
+void IContext::getQueryObjectuiv(GLuint query, GLenum pname, GLuint* params) const {
+  if (getQueryObjectuivProc_ == nullptr) {
+    // Query objects are core in OpenGL ES 3.0, GL_EXT_disjoint_timer_query adds them to ES 2.0
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::QueryObjects)) {
+      getQueryObjectuivProc_ = iglGetQueryObjectuiv;
+    } else if (deviceFeatureSet_.hasExtension(Extensions::DisjointTimerQuery)) {
+      getQueryObjectuivProc_ = iglGetQueryObjectuivEXT;
+    }
+  }
+  GLCALL_PROC(getQueryObjectuivProc_, query, pname, params);
+  APILOG("glGetQueryObjectuiv(%u, %s, %p) = %u\n",
+         query,
+         GL_ENUM_TO_STRING(pname),
+         params,
+         params == nullptr ? 0 : *params);
+  GLCHECK_ERRORS();
+}
+
+void IContext::getQueryObjectui64v(GLuint query, GLenum pname, GLuint64* params) const {
+  if (getQueryObjectui64vProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::TimerQueryExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::DisjointTimerQuery)) {
+        getQueryObjectui64vProc_ = iglGetQueryObjectui64vEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::TimerQuery)) {
+      getQueryObjectui64vProc_ = iglGetQueryObjectui64v;
+    }
+  }
+  GLCALL_PROC(getQueryObjectui64vProc_, query, pname, params);
+  APILOG("glGetQueryObjectui64v(%u, %s, %p) = %llu\n",
+         query,
+         GL_ENUM_TO_STRING(pname),
+         params,
+         params == nullptr ? 0ull : static_cast<unsigned long long>(*params));
+  GLCHECK_ERRORS();
+}
+
 void IContext::getRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params) const {
   IGLCALL(GetRenderbufferParameteriv)(target, pname, params);
   APILOG("glGetRenderbufferParameteriv(%s, %s, %p) = %d\n",
@@ -2102,6 +2668,7 @@ void IContext::lineWidth(GLfloat width) {
 }
 
 void IContext::linkProgram(GLuint program) {
+  IGL_PROFILER_FUNCTION();
   GLCALL(LinkProgram)(program);
   APILOG("glLinkProgram(%u)\n", program);
 
@@ -2153,6 +2720,70 @@ void* IContext::mapBufferRange(GLenum target,
   return ret;
 }
 
+void IContext::maxShaderCompilerThreads(GLuint count) {
+  if (maxShaderCompilerThreadsProc_ == nullptr) {
+    if (deviceFeatureSet_.hasExtension(Extensions::ParallelShaderCompile)) {
+      maxShaderCompilerThreadsProc_ = iglMaxShaderCompilerThreadsKHR;
+    }
+  }
+
+  GLCALL_PROC(maxShaderCompilerThreadsProc_, count);
+  APILOG("glMaxShaderCompilerThreadsKHR(%u)\n", count);
+  GLCHECK_ERRORS();
+}
+
+void IContext::multiDrawArraysIndirect(GLenum mode,
+                                       const GLvoid* indirect,
+                                       GLsizei drawcount,
+                                       GLsizei stride) {
+  if (multiDrawArraysIndirectProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::MultiDrawIndirectExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::MultiDrawIndirect)) {
+        multiDrawArraysIndirectProc_ = iglMultiDrawArraysIndirectEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::MultiDrawIndirect)) {
+      multiDrawArraysIndirectProc_ = iglMultiDrawArraysIndirect;
+    }
+  }
+
+  drawCallCount_++;
+  GLCALL_PROC(multiDrawArraysIndirectProc_, mode, indirect, drawcount, stride);
+  APILOG("glMultiDrawArraysIndirect(%s, %p, %d, %d)\n",
+         GL_ENUM_TO_STRING(mode),
+         indirect,
+         drawcount,
+         stride);
+  GLCHECK_ERRORS();
+  APILOG_DEC_DRAW_COUNT();
+}
+
+void IContext::multiDrawElementsIndirect(GLenum mode,
+                                         GLenum type,
+                                         const GLvoid* indirect,
+                                         GLsizei drawcount,
+                                         GLsizei stride) {
+  if (multiDrawElementsIndirectProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::MultiDrawIndirectExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::MultiDrawIndirect)) {
+        multiDrawElementsIndirectProc_ = iglMultiDrawElementsIndirectEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::MultiDrawIndirect)) {
+      multiDrawElementsIndirectProc_ = iglMultiDrawElementsIndirect;
+    }
+  }
+
+  drawCallCount_++;
+  GLCALL_PROC(multiDrawElementsIndirectProc_, mode, type, indirect, drawcount, stride);
+  APILOG("glMultiDrawElementsIndirect(%s, %s, %p, %d, %d)\n",
+         GL_ENUM_TO_STRING(mode),
+         GL_ENUM_TO_STRING(type),
+         indirect,
+         drawcount,
+         stride);
+  GLCHECK_ERRORS();
+  APILOG_DEC_DRAW_COUNT();
+}
+
 void IContext::pixelStorei(GLenum pname, GLint param) {
   GLCALL(PixelStorei)(pname, param);
   APILOG("glPixelStorei(%s, %d)\n", GL_ENUM_TO_STRING(pname), param);
@@ -2165,6 +2796,34 @@ void IContext::polygonOffset(GLfloat factor, GLfloat units) {
   GLCHECK_ERRORS();
 }
 
+void IContext::programBinary(GLuint program,
+                             GLenum binaryFormat,
+                             const void* binary,
+                             GLsizei length) {
+  IGL_PROFILER_FUNCTION();
+  if (programBinaryProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::ProgramBinary)) {
+      programBinaryProc_ = iglProgramBinary;
+    }
+  }
+
+  GLCALL_PROC(programBinaryProc_, program, binaryFormat, binary, length);
+  APILOG("glProgramBinary(%u, 0x%x, %p, %d)\n", program, binaryFormat, binary, length);
+  GLCHECK_ERRORS();
+}
+
+void IContext::programParameteri(GLuint program, GLenum pname, GLint value) {
+  if (programParameteriProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::ProgramBinary)) {
+      programParameteriProc_ = iglProgramParameteri;
+    }
+  }
+
+  GLCALL_PROC(programParameteriProc_, program, pname, value);
+  APILOG("glProgramParameteri(%u, %s, %d)\n", program, GL_ENUM_TO_STRING(pname), value);
+  GLCHECK_ERRORS();
+}
+
 void IContext::pushDebugGroup(GLenum source, GLuint id, GLsizei length, const GLchar* message) {
   if (pushDebugGroupProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::Debug)) {
@@ -2205,6 +2864,21 @@ void IContext::popDebugGroup() {
   GLCHECK_ERRORS();
 }
 
+void IContext::queryCounter(GLuint query, GLenum target) {
+  if (queryCounterProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::TimerQueryExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::DisjointTimerQuery)) {
+        queryCounterProc_ = iglQueryCounterEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::TimerQuery)) {
+      queryCounterProc_ = iglQueryCounter;
+    }
+  }
+  GLCALL_PROC(queryCounterProc_, query, target);
+  APILOG("glQueryCounter(%u, %s)\n", query, GL_ENUM_TO_STRING(target));
+  GLCHECK_ERRORS();
+}
+
 void IContext::readPixels(GLint x,
                           GLint y,
                           GLsizei width,
@@ -2212,6 +2886,7 @@ void IContext::readPixels(GLint x,
                           GLenum format,
                           GLenum type,
                           GLvoid* pixels) {
+  IGL_PROFILER_FUNCTION();
   GLCALL(ReadPixels)(x, y, width, height, format, type, pixels);
   APILOG("glReadPixels(%d, %u, %u, %d, %s, %s, %p)\n",
          x,
@@ -2468,6 +3143,7 @@ void IContext::texImage2D(GLenum target,
                           GLenum format,
                           GLenum type,
                           const GLvoid* data) {
+  IGL_PROFILER_FUNCTION();
   GLCALL(TexImage2D)(target, level, internalformat, width, height, border, format, type, data);
   APILOG("glTexImage2D(%s, %d, %s, %u, %u, %d, %s, %s, 0x%x)\n",
          GL_ENUM_TO_STRING(target),
@@ -2677,6 +3353,15 @@ void IContext::texParameteriv(GLenum target, GLenum pname, const GLint* params)
   GLCHECK_ERRORS();
 }
 
+void IContext::textureParameteri(GLuint texture, GLenum pname, GLint param) {
+  IGLCALL(TextureParameteri)(texture, pname, param);
+  APILOG("glTextureParameteri(%u, %s, %s)\n",
+         texture,
+         GL_ENUM_TO_STRING(pname),
+         GL_ENUM_TO_STRING(param));
+  GLCHECK_ERRORS();
+}
+
 void IContext::texSubImage2D(GLenum target,
                              GLint level,
                              GLint xoffset,
@@ -2686,6 +3371,7 @@ void IContext::texSubImage2D(GLenum target,
                              GLenum format,
                              GLenum type,
                              const GLvoid* pixels) {
+  IGL_PROFILER_FUNCTION();
   GLCALL(TexSubImage2D)(target, level, xoffset, yoffset, width, height, format, type, pixels);
   APILOG("glTexSubImage2D(%s, %d, %d, %d, %u, %u, %s, %s, %p)\n",
          GL_ENUM_TO_STRING(target),
@@ -2750,6 +3436,45 @@ void IContext::texSubImage3D(GLenum target,
   GLCHECK_ERRORS();
 }
 
+void IContext::textureView(GLuint texture,
+                           GLenum target,
+                           GLuint origtexture,
+                           GLenum internalformat,
+                           GLuint minlevel,
+                           GLuint numlevels,
+                           GLuint minlayer,
+                           GLuint numlayers) {
+  if (textureViewProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::TextureViewExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::TextureView)) {
+        textureViewProc_ = iglTextureViewEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::TextureView)) {
+      textureViewProc_ = iglTextureView;
+    }
+  }
+
+  GLCALL_PROC(textureViewProc_,
+              texture,
+              target,
+              origtexture,
+              internalformat,
+              minlevel,
+              numlevels,
+              minlayer,
+              numlayers);
+  APILOG("glTextureView(%u, %s, %u, %s, %u, %u, %u, %u)\n",
+         texture,
+         GL_ENUM_TO_STRING(target),
+         origtexture,
+         GL_ENUM_TO_STRING(internalformat),
+         minlevel,
+         numlevels,
+         minlayer,
+         numlayers);
+  GLCHECK_ERRORS();
+}
+
 void IContext::uniform1f(GLint location, GLfloat x) {
   GLCALL(Uniform1f)(location, x);
   APILOG("glUniform1f(%d, %f)\n", location, x);
@@ -2977,6 +3702,13 @@ void IContext::unmapBuffer(GLenum target) {
 }
 
 void IContext::useProgram(GLuint program) {
+  if (stateCache_.enabled) {
+    if (stateCache_.program == program) {
+      stateCacheSavedCallCounter_++;
+      return;
+    }
+    stateCache_.program = program;
+  }
   GLCALL(UseProgram)(program);
   APILOG("glUseProgram(%u)\n", program);
   GLCHECK_ERRORS();
@@ -3107,6 +3839,12 @@ void IContext::dispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint
   GLCHECK_ERRORS();
 }
 
+void IContext::dispatchComputeIndirect(GLintptr indirect) {
+  IGLCALL(DispatchComputeIndirect)(indirect);
+  APILOG("glDispatchComputeIndirect(%zu)\n", indirect);
+  GLCHECK_ERRORS();
+}
+
 void IContext::memoryBarrier(GLbitfield barriers) {
   if (memoryBarrierProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::ShaderImageLoadStoreExtReq)) {
@@ -3191,7 +3929,218 @@ unsigned int IContext::getCurrentDrawCount() const {
 }
 
 void IContext::resetCounters() {
+  frameStatistics_.add(FrameStatisticsTracker::ApiCalls, callCounter_ - frameStartCallCounter_);
+  frameStartCallCounter_ = 0;
   callCounter_ = 0;
+  stateCacheSavedCallCounter_ = 0;
+}
+
+FrameStatistics IContext::getFrameStatistics() const {
+  FrameStatistics stats = frameStatistics_.getCurrent();
+  stats.apiCalls += callCounter_ - frameStartCallCounter_;
+  return stats;
+}
+
+void IContext::endFrameStatistics() {
+  frameStatistics_.add(FrameStatisticsTracker::ApiCalls, callCounter_ - frameStartCallCounter_);
+  frameStartCallCounter_ = callCounter_;
+  frameStatistics_.endFrame();
+}
+
+void IContext::enableStateCache(bool enable) {
+  // nothing is known about the current state when the cache starts tracking it
+  stateCache_.invalidate();
+  stateCache_.enabled = enable;
+}
+
+void IContext::invalidateStateCache() {
+  stateCache_.invalidate();
+}
+
+void IContext::enableDeferredDeletion(bool enable, size_t maxDeletionsPerFrame) {
+  if (!enable && deferredDeletionEnabled_) {
+    flushDeferredDeletions();
+  }
+  deferredDeletionEnabled_ = enable;
+  maxDeletionsPerFrame_ = maxDeletionsPerFrame;
+}
+
+void IContext::processDeferredDeletions() {
+  IGL_PROFILER_FUNCTION();
+  deferredDeletionFrame_++;
+  if (frameDeletions_.size() != 0) {
+    const bool hasSync = deviceFeatureSet_.hasInternalRequirement(InternalRequirement::SyncExtReq)
+                             ? deviceFeatureSet_.hasExtension(Extensions::Sync)
+                             : deviceFeatureSet_.hasInternalFeature(InternalFeatures::Sync);
+    frameDeletions_.sync = hasSync ? fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) : nullptr;
+    frameDeletions_.frame = deferredDeletionFrame_;
+    pendingDeletions_.push_back(std::move(frameDeletions_));
+    frameDeletions_ = {};
+  }
+
+  size_t budget = maxDeletionsPerFrame_ != 0 ? maxDeletionsPerFrame_ : SIZE_MAX;
+  while (!pendingDeletions_.empty() && budget != 0) {
+    DeferredDeletions& deletions = pendingDeletions_.front();
+    // frames complete in order
+    if (!isDeferredDeletionCompleted(deletions)) {
+      break;
+    }
+    budget -= deleteDeferredObjects(deletions, budget);
+    if (deletions.size() == 0) {
+      pendingDeletions_.pop_front();
+    }
+  }
+}
+
+void IContext::flushDeferredDeletions() {
+  pendingDeletions_.push_back(std::move(frameDeletions_));
+  frameDeletions_ = {};
+  for (DeferredDeletions& deletions : pendingDeletions_) {
+    if (deletions.sync != nullptr) {
+      deleteSync(deletions.sync);
+    }
+    deleteDeferredObjects(deletions, SIZE_MAX);
+  }
+  pendingDeletions_.clear();
+}
+
+size_t IContext::getNumDeferredDeletions() const {
+  size_t count = frameDeletions_.size();
+  for (const DeferredDeletions& deletions : pendingDeletions_) {
+    count += deletions.size();
+  }
+  return count;
+}
+
+bool IContext::isDeferredDeletionCompleted(DeferredDeletions& deletions) {
+  if (!deletions.completed) {
+    if (deletions.sync != nullptr) {
+      GLint status = GL_UNSIGNALED;
+      getSynciv(deletions.sync, GL_SYNC_STATUS, 1, nullptr, &status);
+      if (status == GL_SIGNALED) {
+        deleteSync(deletions.sync);
+        deletions.sync = nullptr;
+        deletions.completed = true;
+      }
+    } else {
+      deletions.completed =
+          deferredDeletionFrame_ - deletions.frame >= kDeferredDeletionFrames;
+    }
+  }
+  return deletions.completed;
+}
+
+size_t IContext::deleteDeferredObjects(DeferredDeletions& deletions, size_t budget) {
+  size_t deleted = 0;
+  // the deletions below must reach GL instead of being deferred again
+  deletingDeferredObjects_ = true;
+  const auto deleteNames = [&](std::vector<GLuint>& names, auto&& deleteProc) {
+    const size_t n = std::min(names.size(), budget - deleted);
+    if (n != 0) {
+      deleteProc(static_cast<GLsizei>(n), names.data() + names.size() - n);
+      names.resize(names.size() - n);
+      deleted += n;
+    }
+  };
+  // framebuffers first, as they reference the textures and renderbuffers
+  deleteNames(deletions.framebuffers,
+              [this](GLsizei n, const GLuint* names) { deleteFramebuffers(n, names); });
+  deleteNames(deletions.renderbuffers,
+              [this](GLsizei n, const GLuint* names) { deleteRenderbuffers(n, names); });
+  deleteNames(deletions.textures, [this](GLsizei n, const GLuint* names) {
+    deleteTextures(std::vector<GLuint>(names, names + n));
+  });
+  deleteNames(deletions.buffers,
+              [this](GLsizei n, const GLuint* names) { deleteBuffers(n, names); });
+  deletingDeferredObjects_ = false;
+  return deleted;
+}
+
+unsigned int IContext::getStateCacheSavedCallCount() const {
+  return stateCacheSavedCallCounter_;
+}
+
+void IContext::StateCache::invalidate() {
+  activeTexture = kUnknown;
+  for (auto& unit : textures) {
+    for (auto& texture : unit) {
+      texture = kUnknown;
+    }
+  }
+  arrayBuffer = kUnknown;
+  elementArrayBuffer = kUnknown;
+  vertexArray = kUnknown;
+  drawFramebuffer = kUnknown;
+  readFramebuffer = kUnknown;
+  program = kUnknown;
+  for (auto& cap : capabilities) {
+    cap = kUnknown;
+  }
+  blendEquation[0] = blendEquation[1] = kUnknown;
+  for (auto& factor : blendFunc) {
+    factor = kUnknown;
+  }
+  colorMask = kUnknown;
+  cullFace = kUnknown;
+  frontFace = kUnknown;
+  depthFunc = kUnknown;
+  depthMask = kUnknown;
+}
+
+void IContext::StateCache::onTexturesDeleted(GLsizei n, const GLuint* names) {
+  if (!enabled) {
+    return;
+  }
+  for (GLsizei i = 0; i != n; i++) {
+    for (auto& unit : textures) {
+      for (auto& texture : unit) {
+        if (texture == names[i]) {
+          texture = 0;
+        }
+      }
+    }
+  }
+}
+
+void IContext::StateCache::onBuffersDeleted(GLsizei n, const GLuint* names) {
+  if (!enabled) {
+    return;
+  }
+  for (GLsizei i = 0; i != n; i++) {
+    if (arrayBuffer == names[i]) {
+      arrayBuffer = 0;
+    }
+    if (elementArrayBuffer == names[i]) {
+      elementArrayBuffer = 0;
+    }
+  }
+}
+
+void IContext::StateCache::onFramebuffersDeleted(GLsizei n, const GLuint* names) {
+  if (!enabled) {
+    return;
+  }
+  for (GLsizei i = 0; i != n; i++) {
+    if (drawFramebuffer == names[i]) {
+      drawFramebuffer = 0;
+    }
+    if (readFramebuffer == names[i]) {
+      readFramebuffer = 0;
+    }
+  }
+}
+
+void IContext::StateCache::onVertexArraysDeleted(GLsizei n, const GLuint* names) {
+  if (!enabled) {
+    return;
+  }
+  for (GLsizei i = 0; i != n; i++) {
+    if (vertexArray == names[i]) {
+      // reverts to the default vertex array object, whose element array binding is unknown
+      vertexArray = 0;
+      elementArrayBuffer = kUnknown;
+    }
+  }
 }
 
 bool IContext::addRef() {
@@ -3290,6 +4239,14 @@ void IContext::initialize(Result* result) {
   if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::SeamlessCubeMap)) {
     enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
   }
+
+#if IGL_WITH_TRACY_GPU_OGL
+  // Tracy keeps one GPU context per thread, used by all GL contexts current on that thread
+  if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::TimerQuery) &&
+      tracy::GetGpuCtx().ptr == nullptr) {
+    TracyGpuContext;
+  }
+#endif // IGL_WITH_TRACY_GPU_OGL
 }
 
 const DeviceFeatureSet& IContext::deviceFeatures() const {
@@ -3341,6 +4298,12 @@ void IContext::SynchronizedDeletionQueues::flushDeletionQueue(IContext& context)
       scratchVertexArraysQueue_.clear();
     }
 
+    if (!scratchQueriesQueue_.empty()) {
+      context.deleteQueries(static_cast<GLsizei>(scratchQueriesQueue_.size()),
+                            scratchQueriesQueue_.data());
+      scratchQueriesQueue_.clear();
+    }
+
     for (auto i : scratchProgramQueue_) {
       context.deleteProgram(i);
     }
@@ -3366,6 +4329,7 @@ void IContext::SynchronizedDeletionQueues::swapScratchDeletionQueues() {
   std::swap(scratchFramebuffersQueue_, framebuffersQueue_);
   std::swap(scratchRenderbuffersQueue_, renderbuffersQueue_);
   std::swap(scratchVertexArraysQueue_, vertexArraysQueue_);
+  std::swap(scratchQueriesQueue_, queriesQueue_);
   std::swap(scratchProgramQueue_, programQueue_);
   std::swap(scratchShaderQueue_, shaderQueue_);
   std::swap(scratchTexturesQueue_, texturesQueue_);
@@ -3407,6 +4371,13 @@ void IContext::SynchronizedDeletionQueues::queueDeleteVertexArrays(GLsizei n,
   }
 }
 
+void IContext::SynchronizedDeletionQueues::queueDeleteQueries(GLsizei n, const GLuint* queries) {
+  std::lock_guard<std::mutex> guard(deletionQueueMutex_);
+  for (GLsizei i = 0; i < n; ++i) {
+    queriesQueue_.push_back(queries[i]);
+  }
+}
+
 void IContext::SynchronizedDeletionQueues::queueDeleteProgram(GLuint program) {
   std::lock_guard<std::mutex> guard(deletionQueueMutex_);
   programQueue_.push_back(program);
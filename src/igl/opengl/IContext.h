@@ -9,15 +9,21 @@
 
 #include <igl/Common.h>
 #include <igl/DeviceFeatures.h>
+#include <igl/FrameStatistics.h>
 #include <igl/PlatformDevice.h>
+#include <igl/opengl/BindlessTable.h>
 #include <igl/opengl/ComputeCommandAdapter.h>
 #include <igl/opengl/DeviceFeatureSet.h>
 #include <igl/opengl/GLFunc.h>
 #include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/ProgramBinaryCache.h>
 #include <igl/opengl/RenderCommandAdapter.h>
 #include <igl/opengl/UnbindPolicy.h>
+#include <igl/opengl/UniformArena.h>
 #include <igl/opengl/Version.h>
+#include <igl/opengl/VertexArrayCache.h>
 #include <igl/opengl/WithContext.h>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -54,12 +60,18 @@ class IContext {
 
  protected:
   bool shouldQueueAPI() const;
+  /// Called by platform contexts after making this context current on the calling thread and
+  /// after clearing it, so the GL call wrappers can validate the current context with a
+  /// thread-local comparison instead of a call into EGL/GLX/WGL/EAGL.
+  void didMakeCurrent() const;
+  void didClearCurrent() const;
 
  public:
   ///--------------------------------------
   /// MARK: - GL APIs
   void activeTexture(GLenum texture);
   void attachShader(GLuint program, GLuint shader);
+  void beginQuery(GLenum target, GLuint query);
   void bindAttribLocation(GLuint program, GLuint index, const GLchar* name);
   void bindBuffer(GLenum target, GLuint buffer);
   void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
@@ -68,9 +80,16 @@ class IContext {
                        GLuint buffer,
                        GLintptr offset,
                        GLsizeiptr size);
+  void bindBuffersRange(GLenum target,
+                        GLuint first,
+                        GLsizei count,
+                        const GLuint* buffers,
+                        const GLintptr* offsets,
+                        const GLsizeiptr* sizes);
   void bindFramebuffer(GLenum target, GLuint framebuffer);
   void bindRenderbuffer(GLenum target, GLuint renderbuffer);
   void bindTexture(GLenum target, GLuint texture);
+  void bindTextures(GLuint first, GLsizei count, const GLuint* textures);
   void bindImageTexture(GLuint unit,
                         GLuint texture,
                         GLint level,
@@ -95,12 +114,15 @@ class IContext {
                        GLbitfield mask,
                        GLenum filter);
   void bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+  void bufferStorage(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags);
   void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+  void namedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const GLvoid* data);
   virtual GLenum checkFramebufferStatus(GLenum target);
   void clear(GLbitfield mask);
   void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
   void clearDepthf(GLfloat depth);
   void clearStencil(GLint s);
+  GLenum clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
   void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
   void compileShader(GLuint shader);
   void compressedTexImage1D(GLenum target,
@@ -185,6 +207,7 @@ class IContext {
   void deleteMemoryObjects(GLsizei n, const GLuint* objects);
   void deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers);
   void deleteVertexArrays(GLsizei n, const GLuint* vertexArrays);
+  void deleteQueries(GLsizei n, const GLuint* queries);
   void deleteProgram(GLuint program);
   void deleteShader(GLuint shaderId);
   void deleteSync(GLsync sync);
@@ -196,11 +219,37 @@ class IContext {
   virtual void disable(GLenum cap);
   void disableVertexAttribArray(GLuint index);
   void drawArrays(GLenum mode, GLint first, GLsizei count);
+  void drawArraysIndirect(GLenum mode, const GLvoid* indirect);
+  void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+  void drawArraysInstancedBaseInstance(GLenum mode,
+                                       GLint first,
+                                       GLsizei count,
+                                       GLsizei instancecount,
+                                       GLuint baseinstance);
   void drawBuffers(GLsizei n, GLenum* buffers);
   void drawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices);
   void drawElementsIndirect(GLenum mode, GLenum type, const GLvoid* indirect);
+  void drawElementsInstanced(GLenum mode,
+                             GLsizei count,
+                             GLenum type,
+                             const GLvoid* indices,
+                             GLsizei instancecount);
+  void drawElementsInstancedBaseVertex(GLenum mode,
+                                       GLsizei count,
+                                       GLenum type,
+                                       const GLvoid* indices,
+                                       GLsizei instancecount,
+                                       GLint basevertex);
+  void drawElementsInstancedBaseVertexBaseInstance(GLenum mode,
+                                                   GLsizei count,
+                                                   GLenum type,
+                                                   const GLvoid* indices,
+                                                   GLsizei instancecount,
+                                                   GLint basevertex,
+                                                   GLuint baseinstance);
   virtual void enable(GLenum cap);
   void enableVertexAttribArray(GLuint index);
+  void endQuery(GLenum target);
   GLsync fenceSync(GLenum condition, GLbitfield flags);
   void finish();
   void flush();
@@ -232,6 +281,7 @@ class IContext {
   void genRenderbuffers(GLsizei n, GLuint* renderbuffers);
   void genTextures(GLsizei n, GLuint* textures);
   void genVertexArrays(GLsizei n, GLuint* vertexArrays);
+  void genQueries(GLsizei n, GLuint* queries);
   void getActiveAttrib(GLuint program,
                        GLuint index,
                        GLsizei bufsize,
@@ -270,6 +320,11 @@ class IContext {
                                            GLint* params) const;
   void getIntegerv(GLenum pname, GLint* params) const;
   void getProgramiv(GLuint program, GLenum pname, GLint* params) const;
+  void getProgramBinary(GLuint program,
+                        GLsizei bufSize,
+                        GLsizei* length,
+                        GLenum* binaryFormat,
+                        void* binary) const;
   void getProgramInterfaceiv(GLuint program,
                              GLenum programInterface,
                              GLenum pname,
@@ -290,6 +345,8 @@ class IContext {
                               GLsizei bufSize,
                               GLsizei* length,
                               char* name) const;
+  void getQueryObjectuiv(GLuint query, GLenum pname, GLuint* params) const;
+  void getQueryObjectui64v(GLuint query, GLenum pname, GLuint64* params) const;
   void getRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params) const;
   void getShaderiv(GLuint shader, GLenum pname, GLint* params) const;
   void getShaderInfoLog(GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog) const;
@@ -323,10 +380,23 @@ class IContext {
   void linkProgram(GLuint program);
   void* mapBuffer(GLenum target, GLbitfield access);
   void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+  void maxShaderCompilerThreads(GLuint count);
+  void multiDrawArraysIndirect(GLenum mode,
+                               const GLvoid* indirect,
+                               GLsizei drawcount,
+                               GLsizei stride);
+  void multiDrawElementsIndirect(GLenum mode,
+                                 GLenum type,
+                                 const GLvoid* indirect,
+                                 GLsizei drawcount,
+                                 GLsizei stride);
   void pixelStorei(GLenum pname, GLint param);
   void polygonOffset(GLfloat factor, GLfloat units);
   void popDebugGroup();
+  void programBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+  void programParameteri(GLuint program, GLenum pname, GLint value);
   void pushDebugGroup(GLenum source, GLuint id, GLsizei length, const GLchar* message);
+  void queryCounter(GLuint query, GLenum target);
   void readPixels(GLint x,
                   GLint y,
                   GLsizei width,
@@ -436,6 +506,7 @@ class IContext {
   void texParameterfv(GLenum target, GLenum pname, const GLfloat* params);
   void texParameteri(GLenum target, GLenum pname, GLint param);
   void texParameteriv(GLenum target, GLenum pname, const GLint* params);
+  void textureParameteri(GLuint texture, GLenum pname, GLint param);
   void texSubImage2D(GLenum target,
                      GLint level,
                      GLint xoffset,
@@ -456,6 +527,14 @@ class IContext {
                      GLenum format,
                      GLenum type,
                      const GLvoid* pixels);
+  void textureView(GLuint texture,
+                   GLenum target,
+                   GLuint origtexture,
+                   GLenum internalformat,
+                   GLuint minlevel,
+                   GLuint numlevels,
+                   GLuint minlayer,
+                   GLuint numlayers);
   void uniform1f(GLint location, GLfloat x);
   void uniform1fv(GLint location, GLsizei count, const GLfloat* v);
   void uniform1i(GLint location, GLint x);
@@ -497,6 +576,7 @@ class IContext {
   void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
 
   void dispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+  void dispatchComputeIndirect(GLintptr indirect);
   void memoryBarrier(GLbitfield barriers);
   GLuint64 getTextureHandle(GLuint texture);
   void makeTextureHandleResident(GLuint64 handle);
@@ -525,6 +605,57 @@ class IContext {
 
   void resetCounters();
 
+  /// Per-frame counters reported by Device::getFrameStatistics()
+  FrameStatisticsTracker& getFrameStatisticsTracker() const {
+    return frameStatistics_;
+  }
+  /// Returns the counters of the current frame, including the GL calls made so far
+  [[nodiscard]] FrameStatistics getFrameStatistics() const;
+  /// Moves the counters of the current frame into the frame statistics history
+  void endFrameStatistics();
+
+  /** Shadow state cache.
+   * When enabled, binds and state changes which would not change the current GL state are dropped
+   * before reaching the driver. The cache assumes all GL calls on this context go through IContext:
+   * call invalidateStateCache() after external code has touched the context directly, or after
+   * objects bound in this context were deleted through another context of the sharegroup.
+   * Disabled by default.
+   */
+  void enableStateCache(bool enable);
+  [[nodiscard]] bool isStateCacheEnabled() const {
+    return stateCache_.enabled;
+  }
+  /** Forgets all the shadowed state. The next call of every cached function reaches GL. */
+  void invalidateStateCache();
+  /** Returns the number of GL calls dropped by the state cache since the last resetCounters(). */
+  unsigned int getStateCacheSavedCallCount() const;
+
+  /** Deferred deletion.
+   * When enabled, the textures, buffers, framebuffers and renderbuffers deleted while this context
+   * is current are collected into arrays instead of being deleted one glDelete*() call at a time.
+   * The arrays of a frame are deleted together once the GPU has completed that frame, which is
+   * tracked with a sync object or, without sync objects, by waiting kDeferredDeletionFrames frames.
+   * At most 'maxDeletionsPerFrame' objects are deleted per frame, 0 meaning no limit, so tearing
+   * down a scene does not stall a single frame. Names stay allocated until they are deleted, so
+   * they are not reused early. Disabling deferred deletion deletes all the pending objects.
+   * Disabled by default.
+   */
+  void enableDeferredDeletion(bool enable, size_t maxDeletionsPerFrame = 0);
+  [[nodiscard]] bool isDeferredDeletionEnabled() const {
+    return deferredDeletionEnabled_;
+  }
+  /** Ends the frame of the deferred deletions and deletes the objects of the completed frames, up
+   * to the per-frame budget. Called by CommandQueue::submit() at the end of each frame.
+   */
+  void processDeferredDeletions();
+  /** Deletes all the pending objects without waiting for the GPU. */
+  void flushDeferredDeletions();
+  /** Returns the number of objects waiting to be deleted. */
+  [[nodiscard]] size_t getNumDeferredDeletions() const;
+
+  /// Frames a deferred deletion waits for when sync objects are not supported
+  static constexpr uint32_t kDeferredDeletionFrames = 3;
+
   /** Manual reference counting.
    * In some cases, mostly for performance reasons, we hold unprotected references to the IContext.
    * When doing so, use the functions below to signal such references so we can at least throw an
@@ -578,10 +709,33 @@ class IContext {
     return computeAdapterPool_;
   }
 
+  // Vertex array objects set up by RenderCommandAdapter, see VertexArrayCache
+  VertexArrayCache& getVertexArrayCache() {
+    return vertexArrayCache_;
+  }
+
+  // Transient uniform data of RenderCommandEncoder::bindBytes(), see UniformArena
+  UniformArena& getUniformArena() {
+    return uniformArena_;
+  }
+
+  // Textures accessed through ITexture::getTextureId(), see BindlessTable
+  BindlessTable& getBindlessTable() {
+    return bindlessTable_;
+  }
+
+  // Linked programs stored on disk, see ProgramBinaryCache; call setDirectory() to enable it
+  ProgramBinaryCache& getProgramBinaryCache() {
+    return programBinaryCache_;
+  }
+
   // Called to check if the last OGL call resulted in an error.
   GLenum checkForErrors(const char* callerName, size_t lineNum) const;
   Result getLastError() const;
 
+ private:
+  bool isCurrentContextOrSharegroup() const;
+
  protected:
   static std::unordered_map<void*, IContext*>& getExistingContexts();
   static void registerContext(void* glContext, IContext* context);
@@ -592,7 +746,11 @@ class IContext {
   bool alwaysCheckError_ = false; // TRUE to check error after each OGL call
   mutable GLenum lastError_ = GL_NO_ERROR;
   mutable unsigned int callCounter_ = 0;
+  unsigned int stateCacheSavedCallCounter_ = 0;
   unsigned int drawCallCount_ = 0;
+  mutable FrameStatisticsTracker frameStatistics_;
+  // `callCounter_` at the start of the current frame
+  unsigned int frameStartCallCounter_ = 0;
   int lockCount_ = 0; // used by DestructionGuard
   int refCount_ = 0; // used by addRef/releaseRef
 
@@ -600,35 +758,51 @@ class IContext {
   unsigned int apiLogDrawsLeft_ = 0;
   bool apiLogEnabled_ = false;
 
+  PFNIGLBEGINQUERYPROC beginQueryProc_ = nullptr;
   PFNIGLBINDIMAGETEXTUREPROC bindImageTexturerProc_ = nullptr;
   PFNIGLBINDVERTEXARRAYPROC bindVertexArrayProc_ = nullptr;
   PFNIGLBLITFRAMEBUFFERPROC blitFramebufferProc_ = nullptr;
+  PFNIGLBUFFERSTORAGEPROC bufferStorageProc_ = nullptr;
   PFNIGLCLEARDEPTHFPROC clearDepthfProc_ = nullptr;
+  PFNIGLCLIENTWAITSYNCPROC clientWaitSyncProc_ = nullptr;
   PFNIGLCOMPRESSEDTEXIMAGE3DPROC compressedTexImage3DProc_ = nullptr;
   PFNIGLCOMPRESSEDTEXSUBIMAGE3DPROC compressedTexSubImage3DProc_ = nullptr;
   PFNIGLDEBUGMESSAGEINSERTPROC debugMessageInsertProc_ = nullptr;
+  PFNIGLDELETEQUERIESPROC deleteQueriesProc_ = nullptr;
   PFNIGLDELETESYNCPROC deleteSyncProc_ = nullptr;
   PFNIGLDELETEVERTEXARRAYSPROC deleteVertexArraysProc_ = nullptr;
   PFNIGLDRAWBUFFERSPROC drawBuffersProc_ = nullptr;
+  PFNIGLENDQUERYPROC endQueryProc_ = nullptr;
   PFNIGLFENCESYNCPROC fenceSyncProc_ = nullptr;
   PFNIGLFRAMEBUFFERTEXTURE2DMULTISAMPLEPROC framebufferTexture2DMultisampleProc_ = nullptr;
   PFNIGLINVALIDATEFRAMEBUFFERPROC invalidateFramebufferProc_ = nullptr;
+  PFNIGLGENQUERIESPROC genQueriesProc_ = nullptr;
   PFNIGLGENVERTEXARRAYSPROC genVertexArraysProc_ = nullptr;
+  mutable PFNIGLGETPROGRAMBINARYPROC getProgramBinaryProc_ = nullptr;
+  mutable PFNIGLGETQUERYOBJECTUIVPROC getQueryObjectuivProc_ = nullptr;
+  mutable PFNIGLGETQUERYOBJECTUI64VPROC getQueryObjectui64vProc_ = nullptr;
   mutable PFNIGLGETSYNCIVPROC getSyncivProc_ = nullptr;
   PFNIGLGETTEXTUREHANDLEPROC getTextureHandleProc_ = nullptr;
   PFNIGLMAKETEXTUREHANDLERESIDENTPROC makeTextureHandleResidentProc_ = nullptr;
   PFNIGLMAKETEXTUREHANDLENONRESIDENTPROC makeTextureHandleNonResidentProc_ = nullptr;
   PFNIGLMAPBUFFERPROC mapBufferProc_ = nullptr;
   PFNIGLMAPBUFFERRANGEPROC mapBufferRangeProc_ = nullptr;
+  PFNIGLMAXSHADERCOMPILERTHREADSPROC maxShaderCompilerThreadsProc_ = nullptr;
   PFNIGLMEMORYBARRIERPROC memoryBarrierProc_ = nullptr;
+  PFNIGLMULTIDRAWARRAYSINDIRECTPROC multiDrawArraysIndirectProc_ = nullptr;
+  PFNIGLMULTIDRAWELEMENTSINDIRECTPROC multiDrawElementsIndirectProc_ = nullptr;
   PFNIGLPOPDEBUGGROUPPROC popDebugGroupProc_ = nullptr;
+  PFNIGLPROGRAMBINARYPROC programBinaryProc_ = nullptr;
+  PFNIGLPROGRAMPARAMETERIPROC programParameteriProc_ = nullptr;
   PFNIGLPUSHDEBUGGROUPPROC pushDebugGroupProc_ = nullptr;
+  PFNIGLQUERYCOUNTERPROC queryCounterProc_ = nullptr;
   PFNIGLRENDERBUFFERSTORAGEMULTISAMPLEPROC renderbufferStorageMultisampleProc_ = nullptr;
   PFNIGLTEXIMAGE3DPROC texImage3DProc_ = nullptr;
   PFNIGLTEXSTORAGE1DPROC texStorage1DProc_ = nullptr;
   PFNIGLTEXSTORAGE2DPROC texStorage2DProc_ = nullptr;
   PFNIGLTEXSTORAGE3DPROC texStorage3DProc_ = nullptr;
   PFNIGLTEXSUBIMAGE3DPROC texSubImage3DProc_ = nullptr;
+  PFNIGLTEXTUREVIEWPROC textureViewProc_ = nullptr;
   PFNIGLUNMAPBUFFERPROC unmapBufferProc_ = nullptr;
   PFNIGLVERTEXATTRIBDIVISORPROC vertexAttribDivisorProc_ = nullptr;
 
@@ -643,6 +817,7 @@ class IContext {
     void queueDeleteFramebuffers(GLsizei n, const GLuint* framebuffers);
     void queueDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers);
     void queueDeleteVertexArrays(GLsizei n, const GLuint* vertexArrays);
+    void queueDeleteQueries(GLsizei n, const GLuint* queries);
     void queueDeleteProgram(GLuint program);
     void queueDeleteShader(GLuint shaderId);
     void queueDeleteTextures(const std::vector<GLuint>& textures);
@@ -658,6 +833,7 @@ class IContext {
     std::vector<GLuint> scratchFramebuffersQueue_;
     std::vector<GLuint> scratchRenderbuffersQueue_;
     std::vector<GLuint> scratchVertexArraysQueue_;
+    std::vector<GLuint> scratchQueriesQueue_;
     std::vector<GLuint> scratchProgramQueue_;
     std::vector<GLuint> scratchShaderQueue_;
     std::vector<GLuint> scratchTexturesQueue_;
@@ -672,6 +848,7 @@ class IContext {
     std::vector<GLuint> framebuffersQueue_;
     std::vector<GLuint> renderbuffersQueue_;
     std::vector<GLuint> vertexArraysQueue_;
+    std::vector<GLuint> queriesQueue_;
     std::vector<GLuint> programQueue_;
     std::vector<GLuint> shaderQueue_;
     std::vector<GLuint> texturesQueue_;
@@ -679,13 +856,89 @@ class IContext {
 
   SynchronizedDeletionQueues deletionQueues_;
 
+  /// Objects deleted with deferred deletion enabled during one frame
+  struct DeferredDeletions {
+    std::vector<GLuint> buffers;
+    std::vector<GLuint> framebuffers;
+    std::vector<GLuint> renderbuffers;
+    std::vector<GLuint> textures;
+    // signaled when the GPU has completed the frame; null without sync objects
+    GLsync sync = nullptr;
+    uint64_t frame = 0;
+    bool completed = false;
+
+    [[nodiscard]] size_t size() const {
+      return buffers.size() + framebuffers.size() + renderbuffers.size() + textures.size();
+    }
+  };
+
+  [[nodiscard]] bool shouldDeferDeletion() const {
+    return deferredDeletionEnabled_ && !deletingDeferredObjects_;
+  }
+  bool isDeferredDeletionCompleted(DeferredDeletions& deletions);
+  // deletes up to 'budget' objects of 'deletions' and returns the number of deleted objects
+  size_t deleteDeferredObjects(DeferredDeletions& deletions, size_t budget);
+
+  bool deferredDeletionEnabled_ = false;
+  bool deletingDeferredObjects_ = false;
+  size_t maxDeletionsPerFrame_ = 0;
+  uint64_t deferredDeletionFrame_ = 0;
+  // the objects deleted during the current frame
+  DeferredDeletions frameDeletions_;
+  // the objects of the previous frames, oldest first
+  std::deque<DeferredDeletions> pendingDeletions_;
+
   UnbindPolicy unbindPolicy_ = UnbindPolicy::Default;
 
+  /// Shadow copy of the GL state set through IContext. kUnknown means the value has to be sent to
+  /// GL on the next call.
+  struct StateCache {
+    static constexpr GLuint kUnknown = ~0u;
+    static constexpr size_t kMaxTextureUnits = 32;
+    static constexpr size_t kNumTextureTargets = 7;
+    static constexpr size_t kNumCapabilities = 8;
+
+    bool enabled = false;
+
+    GLenum activeTexture = kUnknown;
+    GLuint textures[kMaxTextureUnits][kNumTextureTargets] = {};
+    GLuint arrayBuffer = kUnknown;
+    // part of the vertex array object state
+    GLuint elementArrayBuffer = kUnknown;
+    GLuint vertexArray = kUnknown;
+    GLuint drawFramebuffer = kUnknown;
+    GLuint readFramebuffer = kUnknown;
+    GLuint program = kUnknown;
+
+    GLuint capabilities[kNumCapabilities] = {};
+
+    GLenum blendEquation[2] = {}; // RGB, alpha
+    GLenum blendFunc[4] = {}; // srcRGB, dstRGB, srcAlpha, dstAlpha
+    GLuint colorMask = kUnknown; // 4 bits
+    GLenum cullFace = kUnknown;
+    GLenum frontFace = kUnknown;
+    GLenum depthFunc = kUnknown;
+    GLuint depthMask = kUnknown;
+
+    void invalidate();
+    // deleted names are unbound from the current context
+    void onTexturesDeleted(GLsizei n, const GLuint* textures);
+    void onBuffersDeleted(GLsizei n, const GLuint* buffers);
+    void onFramebuffersDeleted(GLsizei n, const GLuint* framebuffers);
+    void onVertexArraysDeleted(GLsizei n, const GLuint* vertexArrays);
+  };
+
+  StateCache stateCache_;
+
   void getGLMajorAndMinorVersions(GLint& majorVersion, GLint& minorVersion) const;
   void getGLMajorAndMinorVersions_(GLint& majorVersion, GLint& minorVersion) const;
   friend class DestructionGuard;
   std::vector<std::unique_ptr<RenderCommandAdapter>> renderAdapterPool_;
   std::vector<std::unique_ptr<ComputeCommandAdapter>> computeAdapterPool_;
+  VertexArrayCache vertexArrayCache_;
+  UniformArena uniformArena_;
+  BindlessTable bindlessTable_;
+  ProgramBinaryCache programBinaryCache_;
 
   DeviceFeatureSet deviceFeatureSet_;
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/OcclusionQueryPool.h>
+
+#include <igl/opengl/DeviceFeatureSet.h>
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+namespace {
+GLenum toGLTarget(const DeviceFeatureSet& features, OcclusionQueryType type) {
+  if (features.usesOpenGLES()) {
+    // OpenGL ES only has boolean occlusion queries
+    return GL_ANY_SAMPLES_PASSED;
+  }
+  if (type == OcclusionQueryType::Binary && features.getGLVersion() >= GLVersion::v3_3) {
+    return GL_ANY_SAMPLES_PASSED;
+  }
+  return GL_SAMPLES_PASSED;
+}
+} // namespace
+
+OcclusionQueryPool::OcclusionQueryPool(IContext& context, const OcclusionQueryPoolDesc& desc) :
+  WithContext(context),
+  type_(desc.type),
+  target_(toGLTarget(context.deviceFeatures(), desc.type)),
+  queries_(desc.count, 0) {
+  if (!queries_.empty()) {
+    context.genQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+  }
+}
+
+OcclusionQueryPool::~OcclusionQueryPool() {
+  if (!queries_.empty()) {
+    getContext().deleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+  }
+}
+
+uint32_t OcclusionQueryPool::getCount() const {
+  return static_cast<uint32_t>(queries_.size());
+}
+
+GLuint OcclusionQueryPool::getId(uint32_t queryIndex) const {
+  IGL_ASSERT(queryIndex < queries_.size());
+  return queries_[queryIndex];
+}
+
+bool OcclusionQueryPool::getResults(uint32_t firstQuery,
+                                    uint32_t queryCount,
+                                    uint64_t* outResults) {
+  if (!IGL_VERIFY(static_cast<size_t>(firstQuery) + queryCount <= queries_.size()) ||
+      !IGL_VERIFY(outResults != nullptr)) {
+    return false;
+  }
+
+  auto& context = getContext();
+  for (uint32_t i = 0; i < queryCount; ++i) {
+    GLuint available = GL_FALSE;
+    context.getQueryObjectuiv(queries_[firstQuery + i], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+      return false;
+    }
+  }
+
+  for (uint32_t i = 0; i < queryCount; ++i) {
+    GLuint result = 0;
+    context.getQueryObjectuiv(queries_[firstQuery + i], GL_QUERY_RESULT, &result);
+    outResults[i] = type_ == OcclusionQueryType::Binary ? (result != 0 ? 1 : 0) : result;
+  }
+  return true;
+}
+
+} // namespace opengl
+} // namespace igl
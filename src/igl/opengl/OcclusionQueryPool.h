@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/OcclusionQueryPool.h>
+#include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/WithContext.h>
+#include <vector>
+
+namespace igl {
+namespace opengl {
+
+/// One GL query object per occlusion query. OpenGL queries don't need to be reset: the render
+/// pass only keeps RenderPassDesc::occlusionQueryPool to begin and end the queries.
+class OcclusionQueryPool final : public WithContext, public IOcclusionQueryPool {
+ public:
+  OcclusionQueryPool(IContext& context, const OcclusionQueryPoolDesc& desc);
+  ~OcclusionQueryPool() override;
+
+  [[nodiscard]] OcclusionQueryType getType() const override {
+    return type_;
+  }
+  [[nodiscard]] uint32_t getCount() const override;
+  bool getResults(uint32_t firstQuery, uint32_t queryCount, uint64_t* outResults) override;
+
+  [[nodiscard]] GLuint getId(uint32_t queryIndex) const;
+  // The query target matching the pool type, e.g. GL_SAMPLES_PASSED
+  [[nodiscard]] GLenum getTarget() const {
+    return target_;
+  }
+
+ private:
+  OcclusionQueryType type_;
+  GLenum target_;
+  std::vector<GLuint> queries_;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/ParallelRenderCommandEncoder.h>
+
+#include <igl/opengl/CommandBuffer.h>
+
+namespace igl {
+namespace opengl {
+
+ParallelRenderCommandEncoder::ParallelRenderCommandEncoder(
+    const std::shared_ptr<CommandBuffer>& commandBuffer,
+    RenderPassDesc renderPass,
+    std::shared_ptr<IFramebuffer> framebuffer) :
+  IParallelRenderCommandEncoder(commandBuffer),
+  commandBuffer_(commandBuffer),
+  renderPass_(std::move(renderPass)),
+  framebuffer_(std::move(framebuffer)) {}
+
+ParallelRenderCommandEncoder::~ParallelRenderCommandEncoder() {
+  IGL_ASSERT(!isEncoding_); // did you forget to call endEncoding()?
+}
+
+std::unique_ptr<IRenderCommandEncoder> ParallelRenderCommandEncoder::createRenderCommandEncoder(
+    Result* outResult) {
+  if (!IGL_VERIFY(isEncoding_)) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "The render pass has ended");
+    return nullptr;
+  }
+
+  auto stream = std::make_shared<RenderCommandStream>();
+
+  {
+    std::lock_guard<std::mutex> lock(childrenMutex_);
+    children_.push_back(stream);
+  }
+
+  Result::setOk(outResult);
+  return std::make_unique<RecordingRenderCommandEncoder>(commandBuffer_, std::move(stream));
+}
+
+void ParallelRenderCommandEncoder::endEncoding() {
+  if (!isEncoding_) {
+    return;
+  }
+
+  isEncoding_ = false;
+
+  auto encoder = commandBuffer_->createRenderCommandEncoder(renderPass_, framebuffer_, nullptr);
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+
+  for (const auto& command : prologue_) {
+    command(*encoder);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(childrenMutex_);
+    for (const auto& stream : children_) {
+      stream->replay(*encoder);
+    }
+    children_.clear();
+  }
+
+  for (; numPendingLabelPops_; numPendingLabelPops_--) {
+    encoder->popDebugGroupLabel();
+  }
+
+  encoder->endEncoding();
+
+  prologue_.clear();
+}
+
+void ParallelRenderCommandEncoder::pushDebugGroupLabel(const std::string& label,
+                                                       const igl::Color& color) const {
+  prologue_.emplace_back([=](IRenderCommandEncoder& e) { e.pushDebugGroupLabel(label, color); });
+}
+
+void ParallelRenderCommandEncoder::insertDebugEventLabel(const std::string& label,
+                                                         const igl::Color& color) const {
+  prologue_.emplace_back([=](IRenderCommandEncoder& e) { e.insertDebugEventLabel(label, color); });
+}
+
+void ParallelRenderCommandEncoder::popDebugGroupLabel() const {
+  numPendingLabelPops_++;
+}
+
+} // namespace opengl
+} // namespace igl
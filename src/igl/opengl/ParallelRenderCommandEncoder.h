@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <igl/RenderCommandEncoder.h>
+#include <igl/RenderCommandStream.h>
+#include <igl/RenderPass.h>
+
+namespace igl {
+namespace opengl {
+
+class CommandBuffer;
+
+/**
+ * @brief OpenGL has no way to record commands on several threads, so child encoders only record
+ * their commands into a RenderCommandStream on the CPU. endEncoding() replays the streams in
+ * creation order on a regular RenderCommandEncoder.
+ *
+ * Data passed to bindBytes(), bindPushConstants() and bindUniform() is copied. Everything else
+ * bound by pointer or reference (textures, sampler states) has to stay alive until endEncoding().
+ */
+class ParallelRenderCommandEncoder final : public IParallelRenderCommandEncoder {
+ public:
+  using Command = std::function<void(IRenderCommandEncoder&)>;
+
+  ParallelRenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                               RenderPassDesc renderPass,
+                               std::shared_ptr<IFramebuffer> framebuffer);
+
+  ~ParallelRenderCommandEncoder() override;
+
+  std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder(Result* outResult) override;
+
+  void endEncoding() override;
+
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
+  void popDebugGroupLabel() const override;
+
+ private:
+  std::shared_ptr<CommandBuffer> commandBuffer_;
+  RenderPassDesc renderPass_;
+  std::shared_ptr<IFramebuffer> framebuffer_;
+  bool isEncoding_ = true;
+
+  // labels recorded before the children commands
+  mutable std::vector<Command> prologue_;
+  // pops are deferred until all children commands have been replayed
+  mutable uint32_t numPendingLabelPops_ = 0;
+
+  // guards `children_`
+  std::mutex childrenMutex_;
+  // commands of every child encoder in creation order
+  std::vector<std::shared_ptr<RenderCommandStream>> children_;
+};
+
+} // namespace opengl
+} // namespace igl
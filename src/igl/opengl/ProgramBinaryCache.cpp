@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/ProgramBinaryCache.h>
+
+#include <igl/opengl/IContext.h>
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <vector>
+
+namespace igl::opengl {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x50474c49; // "IGLP"
+
+struct FileHeader {
+  uint32_t magic = kMagic;
+  uint32_t binaryFormat = 0;
+  uint64_t driverHash = 0;
+  uint64_t key = 0;
+  uint32_t length = 0;
+  uint32_t reserved = 0;
+};
+
+std::string getString(IContext& context, GLenum name) {
+  const auto* str = reinterpret_cast<const char*>(context.getString(name));
+  return str ? std::string(str) : std::string();
+}
+
+} // namespace
+
+bool ProgramBinaryCache::isEnabled(IContext& context) {
+  if (directory_.empty()) {
+    return false;
+  }
+  if (supported_ == 0) {
+    GLint numFormats = 0;
+    if (context.deviceFeatures().hasInternalFeature(InternalFeatures::ProgramBinary)) {
+      context.getIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    }
+    // some drivers support the API but no binary format
+    supported_ = numFormats > 0 ? 1 : -1;
+    if (supported_ > 0) {
+      driverHash_ = std::hash<std::string>()(getString(context, GL_VENDOR) + "|" +
+                                             getString(context, GL_RENDERER) + "|" +
+                                             getString(context, GL_VERSION));
+    }
+  }
+  return supported_ > 0;
+}
+
+std::string ProgramBinaryCache::getFilePath(size_t key) const {
+  char name[64];
+  snprintf(name,
+           sizeof(name),
+           "%016llx_%016llx.glprogram",
+           static_cast<unsigned long long>(driverHash_),
+           static_cast<unsigned long long>(key));
+  const char last = directory_.back();
+  return (last == '/' || last == '\\') ? directory_ + name : directory_ + "/" + name;
+}
+
+bool ProgramBinaryCache::load(IContext& context, size_t key, GLuint program) {
+  IGL_PROFILER_FUNCTION();
+  if (!isEnabled(context)) {
+    return false;
+  }
+
+  const std::string path = getFilePath(key);
+  std::vector<char> binary;
+  FileHeader header;
+  {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+      return false;
+    }
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kMagic ||
+        header.driverHash != driverHash_ || header.key != key || header.length == 0) {
+      file.close();
+      std::remove(path.c_str());
+      return false;
+    }
+    binary.resize(header.length);
+    if (!file.read(binary.data(), std::streamsize(binary.size()))) {
+      file.close();
+      std::remove(path.c_str());
+      return false;
+    }
+  }
+
+  context.programBinary(program, header.binaryFormat, binary.data(), GLsizei(binary.size()));
+
+  GLint status = GL_FALSE;
+  context.getProgramiv(program, GL_LINK_STATUS, &status);
+  if (status == GL_FALSE) {
+    // e.g. the driver was updated without changing its version string
+    IGL_LOG_INFO("Program binary rejected by the driver: %s\n", path.c_str());
+    std::remove(path.c_str());
+    return false;
+  }
+
+  numLoads_++;
+  return true;
+}
+
+void ProgramBinaryCache::prepareProgram(IContext& context, GLuint program) {
+  if (isEnabled(context)) {
+    context.programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+}
+
+void ProgramBinaryCache::store(IContext& context, size_t key, GLuint program) {
+  IGL_PROFILER_FUNCTION();
+  if (!isEnabled(context)) {
+    return;
+  }
+
+  GLint length = 0;
+  context.getProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+
+  std::vector<char> binary(static_cast<size_t>(length));
+  GLenum binaryFormat = 0;
+  GLsizei written = 0;
+  context.getProgramBinary(program, length, &written, &binaryFormat, binary.data());
+  if (written <= 0) {
+    return;
+  }
+
+  FileHeader header;
+  header.binaryFormat = binaryFormat;
+  header.driverHash = driverHash_;
+  header.key = key;
+  header.length = static_cast<uint32_t>(written);
+
+  // write a temporary file first, so a crash never leaves a truncated binary behind
+  const std::string path = getFilePath(key);
+  const std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open() || !file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+        !file.write(binary.data(), written)) {
+      IGL_LOG_ERROR("Cannot write program binary: %s\n", tmpPath.c_str());
+      return;
+    }
+  }
+
+  // rename() cannot overwrite existing files on Windows
+  std::remove(path.c_str());
+  if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    IGL_LOG_ERROR("Cannot rename program binary: %s\n", tmpPath.c_str());
+    std::remove(tmpPath.c_str());
+    return;
+  }
+
+  numStores_++;
+}
+
+} // namespace igl::opengl
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <igl/opengl/GLIncludes.h>
+#include <string>
+#include <utility>
+
+namespace igl::opengl {
+class IContext;
+
+/// On-disk cache of linked GL programs retrieved with glGetProgramBinary(), so that the programs
+/// of ShaderStages are not linked from source on every run.
+///
+/// Every program is stored in its own file in a user-supplied directory. Files are keyed by the
+/// hash of the shader sources and by the GL vendor, renderer and version strings: binaries of
+/// another driver are never loaded. Binaries which the driver rejects anyway are deleted, and the
+/// program is linked from source. Disabled until setDirectory() is called.
+class ProgramBinaryCache final {
+ public:
+  /// Sets the directory the binaries are stored in; an empty path disables the cache.
+  void setDirectory(std::string directory) {
+    directory_ = std::move(directory);
+  }
+  [[nodiscard]] const std::string& getDirectory() const {
+    return directory_;
+  }
+
+  /// Returns true if a directory is set and the context supports program binaries.
+  [[nodiscard]] bool isEnabled(IContext& context);
+
+  /// Loads the binary stored for `key` into `program`. Returns true if `program` is linked; on false
+  /// `program` is left unlinked and has to be linked from source.
+  bool load(IContext& context, size_t key, GLuint program);
+
+  /// Stores the binary of the linked `program` for `key`. Call it after linking a program created
+  /// with prepareProgram().
+  void store(IContext& context, size_t key, GLuint program);
+
+  /// Hints the driver that the binary of `program` is going to be retrieved; call it before
+  /// linking.
+  void prepareProgram(IContext& context, GLuint program);
+
+  [[nodiscard]] size_t getNumLoads() const {
+    return numLoads_;
+  }
+  [[nodiscard]] size_t getNumStores() const {
+    return numStores_;
+  }
+
+ private:
+  std::string getFilePath(size_t key) const;
+
+ private:
+  std::string directory_;
+  // hash of the GL vendor, renderer and version strings
+  size_t driverHash_ = 0;
+  // 0: unknown, 1: supported, -1: unsupported
+  int supported_ = 0;
+  size_t numLoads_ = 0;
+  size_t numStores_ = 0;
+};
+
+} // namespace igl::opengl
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/Readback.h>
+
+#include <cstring>
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+Readback::Readback(IContext& context,
+                   GLuint pixelBuffer,
+                   size_t size,
+                   std::shared_ptr<IFence> fence) :
+  WithContext(context), pixelBuffer_(pixelBuffer), size_(size), fence_(std::move(fence)) {}
+
+Readback::~Readback() {
+  if (pixelBuffer_ != 0) {
+    getContext().deleteBuffers(1, &pixelBuffer_);
+  }
+}
+
+bool Readback::isReady() const {
+  return pixelBuffer_ != 0 && fence_->isSignaled();
+}
+
+Result Readback::getData(void* outData) {
+  if (!IGL_VERIFY(outData)) {
+    return Result(Result::Code::ArgumentNull, "outData is null");
+  }
+  if (pixelBuffer_ == 0) {
+    return Result(Result::Code::InvalidOperation, "The data has already been retrieved");
+  }
+
+  // mapping without the fence would stall until the copy is done anyway
+  fence_->waitUntilSignaled();
+
+  auto& context = getContext();
+  context.bindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer_);
+  const void* data = context.mapBufferRange(
+      GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(size_), GL_MAP_READ_BIT);
+  Result result;
+  if (data != nullptr) {
+    memcpy(outData, data, size_);
+    context.unmapBuffer(GL_PIXEL_PACK_BUFFER);
+  } else {
+    result = Result(Result::Code::RuntimeError, "Cannot map the pixel buffer");
+  }
+  context.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  context.deleteBuffers(1, &pixelBuffer_);
+  pixelBuffer_ = 0;
+  return result;
+}
+
+} // namespace opengl
+} // namespace igl
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Fence.h>
+#include <igl/Readback.h>
+#include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/WithContext.h>
+#include <memory>
+
+namespace igl {
+namespace opengl {
+
+/// A pixel buffer object written by glReadPixels() and the fence which signals the end of the copy
+class Readback final : public WithContext, public IReadback {
+ public:
+  Readback(IContext& context, GLuint pixelBuffer, size_t size, std::shared_ptr<IFence> fence);
+  ~Readback() override;
+
+  [[nodiscard]] bool isReady() const override;
+  [[nodiscard]] size_t getSizeInBytes() const override {
+    return size_;
+  }
+  Result getData(void* outData) override;
+
+ private:
+  GLuint pixelBuffer_;
+  size_t size_;
+  std::shared_ptr<IFence> fence_;
+};
+
+} // namespace opengl
+} // namespace igl
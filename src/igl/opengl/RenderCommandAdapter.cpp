@@ -9,6 +9,7 @@
 #include <igl/opengl/RenderCommandAdapter.h>
 
 #include <algorithm>
+#include <cstring>
 #include <igl/opengl/Buffer.h>
 #include <igl/opengl/CommandBuffer.h>
 #include <igl/opengl/DepthStencilState.h>
@@ -87,7 +88,14 @@ void RenderCommandAdapter::setScissorRect(const ScissorRect& rect) {
 
 void RenderCommandAdapter::setDepthStencilState(
     const std::shared_ptr<IDepthStencilState>& newValue) {
-  depthStencilState_ = newValue;
+  depthStencilState_ = newValue.get();
+  depthStencilStateOwner_ = newValue;
+  setDirty(StateMask::DEPTH_STENCIL);
+}
+
+void RenderCommandAdapter::setDepthStencilState(IDepthStencilState& newValue) {
+  depthStencilState_ = &newValue;
+  depthStencilStateOwner_ = nullptr;
   setDirty(StateMask::DEPTH_STENCIL);
 }
 
@@ -136,7 +144,27 @@ void RenderCommandAdapter::setVertexBuffer(std::shared_ptr<Buffer> buffer,
   IGL_ASSERT_MSG(index < IGL_VERTEX_BUFFER_MAX,
                  "Buffer index is beyond max, may want to increase limit");
   if (index >= 0 && index < IGL_VERTEX_BUFFER_MAX && buffer) {
-    vertexBuffers_[index] = {std::move(buffer), offset};
+    Buffer* resource = buffer.get();
+    vertexBuffers_[index] = {resource, offset, std::move(buffer)};
+    SET_DIRTY(vertexBuffersDirty_, index);
+    Result::setOk(outResult);
+  } else {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid);
+  }
+}
+
+void RenderCommandAdapter::setVertexBuffer(Buffer& buffer,
+                                           size_t offset,
+                                           int index,
+                                           Result* outResult) {
+  IGL_ASSERT_MSG(index >= 0, "Invalid index passed to setVertexBuffer");
+  IGL_ASSERT_MSG(index < IGL_VERTEX_BUFFER_MAX,
+                 "Buffer index is beyond max, may want to increase limit");
+  if (index >= 0 && index < IGL_VERTEX_BUFFER_MAX) {
+    auto& bufferState = vertexBuffers_[index];
+    bufferState.resource = &buffer;
+    bufferState.offset = offset;
+    bufferState.owner = nullptr;
     SET_DIRTY(vertexBuffersDirty_, index);
     Result::setOk(outResult);
   } else {
@@ -146,6 +174,7 @@ void RenderCommandAdapter::setVertexBuffer(std::shared_ptr<Buffer> buffer,
 
 void RenderCommandAdapter::clearUniformBuffers() {
   uniformAdapter_.clearUniformBuffers();
+  pushConstantsDirty_ = true;
 }
 
 void RenderCommandAdapter::setUniform(const UniformDesc& uniformDesc,
@@ -161,6 +190,21 @@ void RenderCommandAdapter::setUniformBuffer(const std::shared_ptr<Buffer>& buffe
   uniformAdapter_.setUniformBuffer(buffer, offset, index, outResult);
 }
 
+void RenderCommandAdapter::setUniformBuffer(Buffer& buffer,
+                                            size_t offset,
+                                            int index,
+                                            Result* outResult) {
+  uniformAdapter_.setUniformBuffer(buffer, offset, index, outResult);
+}
+
+void RenderCommandAdapter::setUniformBufferRange(GLuint buffer,
+                                                 size_t offset,
+                                                 size_t size,
+                                                 int index,
+                                                 Result* outResult) {
+  uniformAdapter_.setUniformBufferRange(buffer, offset, size, index, outResult);
+}
+
 void RenderCommandAdapter::clearVertexTexture() {
   vertexTextureStates_ = TextureStates();
   vertexTextureStatesDirty_.reset();
@@ -216,20 +260,21 @@ void RenderCommandAdapter::setFragmentSamplerState(ISamplerState* samplerState,
 }
 
 // When pipelineState is modified, all dependent resources are cleared
-void RenderCommandAdapter::clearDependentResources(
-    const std::shared_ptr<IRenderPipelineState>& newValue,
-    Result* outResult) {
-  auto curStateOpenGL = static_cast<opengl::RenderPipelineState*>(pipelineState_.get());
+void RenderCommandAdapter::clearDependentResources(const IRenderPipelineState* newValue,
+                                                   Result* outResult) {
+  auto curStateOpenGL = static_cast<opengl::RenderPipelineState*>(pipelineState_);
   if (!IGL_VERIFY(curStateOpenGL)) {
     Result::setResult(outResult, Result::Code::RuntimeError, "pipeline state is null");
     return;
   }
 
-  auto newStateOpenGL = static_cast<opengl::RenderPipelineState*>(newValue.get());
+  auto newStateOpenGL = static_cast<const opengl::RenderPipelineState*>(newValue);
 
   if (!newStateOpenGL || !curStateOpenGL->matchesShaderProgram(*newStateOpenGL)) {
     // Don't use previously set resources. Uniforms/texture locations not same between programs
     uniformAdapter_.clearUniformBuffers();
+    // push constants stay valid across pipelines, only their binding has to be restored
+    pushConstantsDirty_ = true;
     clearVertexTexture();
     clearFragmentTexture();
   }
@@ -250,15 +295,45 @@ void RenderCommandAdapter::setPipelineState(const std::shared_ptr<IRenderPipelin
                                             Result* outResult) {
   Result::setOk(outResult);
   if (pipelineState_) {
-    clearDependentResources(newValue, outResult); // Only clear if pipeline state was previously set
+    // Only clear if pipeline state was previously set
+    clearDependentResources(newValue.get(), outResult);
+  }
+  pipelineState_ = newValue.get();
+  pipelineStateOwner_ = newValue;
+  setDirty(StateMask::PIPELINE);
+}
+
+void RenderCommandAdapter::setPipelineState(IRenderPipelineState& newValue, Result* outResult) {
+  Result::setOk(outResult);
+  if (pipelineState_) {
+    // Only clear if pipeline state was previously set
+    clearDependentResources(&newValue, outResult);
   }
-  pipelineState_ = newValue;
+  pipelineState_ = &newValue;
+  pipelineStateOwner_ = nullptr;
   setDirty(StateMask::PIPELINE);
 }
 
-void RenderCommandAdapter::drawArrays(GLenum mode, GLint first, GLsizei count) {
+void RenderCommandAdapter::drawArrays(GLenum mode,
+                                      GLint first,
+                                      GLsizei count,
+                                      GLsizei instanceCount,
+                                      GLuint baseInstance) {
   willDraw();
-  getContext().drawArrays(toMockWireframeMode(mode), first, count);
+  mode = toMockWireframeMode(mode);
+  const DeviceFeatureSet& features = getContext().deviceFeatures();
+  if (baseInstance != 0) {
+    if (IGL_VERIFY(features.hasInternalFeature(InternalFeatures::DrawBaseInstance))) {
+      getContext().drawArraysInstancedBaseInstance(
+          mode, first, count, instanceCount, baseInstance);
+    }
+  } else if (instanceCount != 1) {
+    if (IGL_VERIFY(features.hasInternalFeature(InternalFeatures::DrawInstanced))) {
+      getContext().drawArraysInstanced(mode, first, count, instanceCount);
+    }
+  } else {
+    getContext().drawArrays(mode, first, count);
+  }
   didDraw();
 }
 
@@ -266,10 +341,31 @@ void RenderCommandAdapter::drawElements(GLenum mode,
                                         GLsizei indexCount,
                                         GLenum indexType,
                                         Buffer& indexBuffer,
-                                        const GLvoid* indexOffset) {
+                                        const GLvoid* indexOffset,
+                                        GLsizei instanceCount,
+                                        GLint baseVertex,
+                                        GLuint baseInstance) {
   willDraw();
   bindBufferWithShaderStorageBufferOverride(indexBuffer, GL_ELEMENT_ARRAY_BUFFER);
-  getContext().drawElements(toMockWireframeMode(mode), indexCount, indexType, indexOffset);
+  mode = toMockWireframeMode(mode);
+  const DeviceFeatureSet& features = getContext().deviceFeatures();
+  if (baseInstance != 0) {
+    if (IGL_VERIFY(features.hasInternalFeature(InternalFeatures::DrawBaseInstance))) {
+      getContext().drawElementsInstancedBaseVertexBaseInstance(
+          mode, indexCount, indexType, indexOffset, instanceCount, baseVertex, baseInstance);
+    }
+  } else if (baseVertex != 0) {
+    if (IGL_VERIFY(features.hasInternalFeature(InternalFeatures::DrawBaseVertex))) {
+      getContext().drawElementsInstancedBaseVertex(
+          mode, indexCount, indexType, indexOffset, instanceCount, baseVertex);
+    }
+  } else if (instanceCount != 1) {
+    if (IGL_VERIFY(features.hasInternalFeature(InternalFeatures::DrawInstanced))) {
+      getContext().drawElementsInstanced(mode, indexCount, indexType, indexOffset, instanceCount);
+    }
+  } else {
+    getContext().drawElements(mode, indexCount, indexType, indexOffset);
+  }
   didDraw();
 }
 
@@ -289,6 +385,57 @@ void RenderCommandAdapter::drawElementsIndirect(GLenum mode,
   didDraw();
 }
 
+void RenderCommandAdapter::multiDrawArraysIndirect(GLenum mode,
+                                                   Buffer& indirectBuffer,
+                                                   const GLvoid* indirectBufferOffset,
+                                                   GLsizei drawCount,
+                                                   GLsizei stride) {
+  willDraw();
+  if (getContext().deviceFeatures().hasFeature(DeviceFeatures::DrawIndexedIndirect)) {
+    bindBufferWithShaderStorageBufferOverride(indirectBuffer, GL_DRAW_INDIRECT_BUFFER);
+    mode = toMockWireframeMode(mode);
+    if (getContext().deviceFeatures().hasInternalFeature(InternalFeatures::MultiDrawIndirect)) {
+      getContext().multiDrawArraysIndirect(mode, indirectBufferOffset, drawCount, stride);
+    } else {
+      const auto* offset = static_cast<const uint8_t*>(indirectBufferOffset);
+      for (GLsizei drawIndex = 0; drawIndex < drawCount; ++drawIndex) {
+        getContext().drawArraysIndirect(mode, offset + static_cast<size_t>(stride) * drawIndex);
+      }
+    }
+  } else {
+    IGL_ASSERT_NOT_IMPLEMENTED();
+  }
+  didDraw();
+}
+
+void RenderCommandAdapter::multiDrawElementsIndirect(GLenum mode,
+                                                     GLenum indexType,
+                                                     Buffer& indexBuffer,
+                                                     Buffer& indirectBuffer,
+                                                     const GLvoid* indirectBufferOffset,
+                                                     GLsizei drawCount,
+                                                     GLsizei stride) {
+  willDraw();
+  bindBufferWithShaderStorageBufferOverride(indexBuffer, GL_ELEMENT_ARRAY_BUFFER);
+  if (getContext().deviceFeatures().hasFeature(DeviceFeatures::DrawIndexedIndirect)) {
+    bindBufferWithShaderStorageBufferOverride(indirectBuffer, GL_DRAW_INDIRECT_BUFFER);
+    mode = toMockWireframeMode(mode);
+    if (getContext().deviceFeatures().hasInternalFeature(InternalFeatures::MultiDrawIndirect)) {
+      getContext().multiDrawElementsIndirect(
+          mode, indexType, indirectBufferOffset, drawCount, stride);
+    } else {
+      const auto* offset = static_cast<const uint8_t*>(indirectBufferOffset);
+      for (GLsizei drawIndex = 0; drawIndex < drawCount; ++drawIndex) {
+        getContext().drawElementsIndirect(
+            mode, indexType, offset + static_cast<size_t>(stride) * drawIndex);
+      }
+    }
+  } else {
+    IGL_ASSERT_NOT_IMPLEMENTED();
+  }
+  didDraw();
+}
+
 void RenderCommandAdapter::endEncoding() {
   // Some minimal cleanup needs to occur in order. Otherwise, OpenGL can end in a bad state
   // with complex rendering.
@@ -298,12 +445,17 @@ void RenderCommandAdapter::endEncoding() {
 
   pipelineState_ = nullptr;
   depthStencilState_ = nullptr;
+  pipelineStateOwner_ = nullptr;
+  depthStencilStateOwner_ = nullptr;
 
   uniformAdapter_.shrinkUniformUsage();
   uniformAdapter_.clearUniformBuffers();
+  pushConstantsDirty_ = true;
   vertexTextureStates_ = TextureStates();
   fragmentTextureStates_ = TextureStates();
 
+  // buffers bound by reference are not guaranteed to outlive the pass
+  vertexBuffers_ = {};
   vertexBuffersDirty_.reset();
   vertexTextureStatesDirty_.reset();
   fragmentTextureStatesDirty_.reset();
@@ -312,17 +464,25 @@ void RenderCommandAdapter::endEncoding() {
 
 void RenderCommandAdapter::willDraw() {
   Result ret;
-  auto pipelineState = static_cast<RenderPipelineState*>(pipelineState_.get());
+  auto pipelineState = static_cast<RenderPipelineState*>(pipelineState_);
 
   // Vertex Buffers must be bound before pipelineState->bind()
   if (pipelineState) {
-    for (size_t bufferIndex = 0; bufferIndex < IGL_VERTEX_BUFFER_MAX; ++bufferIndex) {
-      if (IS_DIRTY(vertexBuffersDirty_, bufferIndex)) {
-        auto& bufferState = vertexBuffers_[bufferIndex];
-        bindBufferWithShaderStorageBufferOverride((*bufferState.resource), GL_ARRAY_BUFFER);
-        // now bind the vertex attributes corresponding to this vertex buffer
-        pipelineState->bindVertexAttributes(bufferIndex, bufferState.offset);
-        CLEAR_DIRTY(vertexBuffersDirty_, bufferIndex);
+    if (useVAO_) {
+      // the attribute setup only changes when the pipeline or a vertex buffer does
+      if (vertexBuffersDirty_.any() || isDirty(StateMask::PIPELINE) || cachedVAO_ == 0) {
+        bindCachedVertexArray(*pipelineState);
+        vertexBuffersDirty_.reset();
+      }
+    } else {
+      for (size_t bufferIndex = 0; bufferIndex < IGL_VERTEX_BUFFER_MAX; ++bufferIndex) {
+        if (IS_DIRTY(vertexBuffersDirty_, bufferIndex)) {
+          auto& bufferState = vertexBuffers_[bufferIndex];
+          bindBufferWithShaderStorageBufferOverride((*bufferState.resource), GL_ARRAY_BUFFER);
+          // now bind the vertex attributes corresponding to this vertex buffer
+          pipelineState->bindVertexAttributes(bufferIndex, bufferState.offset);
+          CLEAR_DIRTY(vertexBuffersDirty_, bufferIndex);
+        }
       }
     }
     if (isDirty(StateMask::PIPELINE)) {
@@ -331,7 +491,7 @@ void RenderCommandAdapter::willDraw() {
     }
   }
 
-  auto depthStencilState = static_cast<DepthStencilState*>(depthStencilState_.get());
+  auto depthStencilState = static_cast<DepthStencilState*>(depthStencilState_);
   if (depthStencilState && isDirty(StateMask::DEPTH_STENCIL)) {
     depthStencilState->bind();
     clearDirty(StateMask::DEPTH_STENCIL);
@@ -355,22 +515,37 @@ void RenderCommandAdapter::willDraw() {
   static size_t kVertexTextureStatesSize = vertexTextureStates_.size();
   static size_t kFragmentTextureStatesSize = fragmentTextureStates_.size();
   if (pipelineState) {
+    if (pipelineState->usesPushConstants()) {
+      bindPushConstants();
+    }
     // Bind uniforms to be used for render
-    uniformAdapter_.bindToPipeline(getContext());
+    uniformAdapter_.bindToPipeline(getContext(), pipelineState->uniformValueCache());
+    // with multi-bind, the textures of consecutive units are bound with one glBindTextures and
+    // the samplers are applied with direct state access, so no unit has to be made active
+    const auto& features = getContext().deviceFeatures();
+    const bool multiBind = features.hasInternalFeature(InternalFeatures::MultiBind) &&
+                           features.hasInternalFeature(InternalFeatures::DirectStateAccess);
+    GLuint textureIds[IGL_TEXTURE_SAMPLERS_MAX];
+    std::bitset<IGL_TEXTURE_SAMPLERS_MAX> boundUnits;
     for (size_t index = 0; index < kVertexTextureStatesSize; index++) {
       if (!IS_DIRTY(vertexTextureStatesDirty_, index)) {
         continue;
       }
       auto& textureState = vertexTextureStates_[index];
       if (auto* texture = static_cast<Texture*>(textureState.first)) {
-        ret = pipelineState->bindTextureUnit(index, igl::BindTarget::kVertex);
+        ret = pipelineState->bindTextureUnit(index, igl::BindTarget::kVertex, !multiBind);
 
         if (!ret.isOk()) {
           IGL_LOG_INFO_ONCE(ret.message.c_str());
           continue;
         }
 
-        texture->bind();
+        if (multiBind) {
+          textureIds[index] = texture->getId();
+          boundUnits.set(index);
+        } else {
+          texture->bind();
+        }
 
         if (auto* samplerState = static_cast<SamplerState*>(textureState.second)) {
           samplerState->bind(texture);
@@ -384,13 +559,18 @@ void RenderCommandAdapter::willDraw() {
       }
       auto& textureState = fragmentTextureStates_[index];
       if (auto* texture = static_cast<Texture*>(textureState.first)) {
-        ret = pipelineState->bindTextureUnit(index, igl::BindTarget::kFragment);
+        ret = pipelineState->bindTextureUnit(index, igl::BindTarget::kFragment, !multiBind);
 
         if (!ret.isOk()) {
           IGL_LOG_INFO_ONCE(ret.message.c_str());
           continue;
         }
-        texture->bind();
+        if (multiBind) {
+          textureIds[index] = texture->getId();
+          boundUnits.set(index);
+        } else {
+          texture->bind();
+        }
 
         if (auto* samplerState = static_cast<SamplerState*>(textureState.second)) {
           samplerState->bind(texture);
@@ -398,6 +578,17 @@ void RenderCommandAdapter::willDraw() {
         CLEAR_DIRTY(fragmentTextureStatesDirty_, index);
       }
     }
+    for (size_t first = 0; first < boundUnits.size(); first++) {
+      if (!boundUnits.test(first)) {
+        continue;
+      }
+      size_t last = first;
+      while (last + 1 < boundUnits.size() && boundUnits.test(last + 1)) {
+        last++;
+      }
+      getContext().bindTextures((GLuint)first, (GLsizei)(last - first + 1), textureIds + first);
+      first = last;
+    }
   }
 }
 
@@ -421,7 +612,7 @@ void RenderCommandAdapter::unbindTextures(IContext& context,
 
 GLenum RenderCommandAdapter::toMockWireframeMode(GLenum mode) const {
 #if defined(IGL_OPENGL_ES)
-  const auto pipelineState = static_cast<RenderPipelineState*>(pipelineState_.get());
+  const auto pipelineState = static_cast<RenderPipelineState*>(pipelineState_);
   const bool modeNeedsConversion = mode == GL_TRIANGLES || mode != GL_TRIANGLE_STRIP;
   if (pipelineState->getPolygonFillMode() == igl::PolygonFillMode::Line && modeNeedsConversion) {
     return GL_LINE_STRIP;
@@ -431,12 +622,75 @@ GLenum RenderCommandAdapter::toMockWireframeMode(GLenum mode) const {
   return mode;
 }
 
+// Binds a VAO with all the vertex attributes of the pipeline set up for the current vertex
+// buffers, creating it on first use
+void RenderCommandAdapter::bindCachedVertexArray(RenderPipelineState& pipelineState) {
+  vertexArrayBindings_.clear();
+  for (size_t bufferIndex = 0; bufferIndex < IGL_VERTEX_BUFFER_MAX; ++bufferIndex) {
+    const auto& bufferState = vertexBuffers_[bufferIndex];
+    if (bufferState.resource && pipelineState.usesVertexBuffer(bufferIndex)) {
+      const auto& arrayBuffer = static_cast<const ArrayBuffer&>(*bufferState.resource);
+      vertexArrayBindings_.push_back({bufferIndex, arrayBuffer.getId(), bufferState.offset});
+    }
+  }
+
+  auto& cache = getContext().getVertexArrayCache();
+  cachedVAO_ = cache.find(&pipelineState, vertexArrayBindings_);
+  if (cachedVAO_ != 0) {
+    getContext().bindVertexArray(cachedVAO_);
+    return;
+  }
+
+  cachedVAO_ = cache.insert(getContext(), &pipelineState, vertexArrayBindings_);
+  getContext().bindVertexArray(cachedVAO_);
+  for (const auto& binding : vertexArrayBindings_) {
+    auto& bufferState = vertexBuffers_[binding.bufferIndex];
+    bindBufferWithShaderStorageBufferOverride((*bufferState.resource), GL_ARRAY_BUFFER);
+    pipelineState.bindVertexAttributes(binding.bufferIndex, bufferState.offset);
+  }
+  // the enabled attributes now belong to the cached VAO
+  pipelineState.detachVertexAttributes();
+}
+
+void RenderCommandAdapter::setPushConstants(const void* data, size_t length, size_t offset) {
+  IGL_ASSERT(offset + length <= pushConstants_.size());
+  if (offset + length <= pushConstants_.size() &&
+      memcmp(pushConstants_.data() + offset, data, length) != 0) {
+    memcpy(pushConstants_.data() + offset, data, length);
+    pushConstantsDirty_ = true;
+  }
+}
+
+void RenderCommandAdapter::bindPushConstants() {
+  auto& arena = getContext().getUniformArena();
+  if (!pushConstantsDirty_ && pushConstantsGeneration_ == arena.getGeneration()) {
+    return;
+  }
+  // the whole range is uploaded, so it covers the push constant block of any shader
+  GLuint buffer = 0;
+  size_t offset = 0;
+  if (!IGL_VERIFY(arena.allocate(
+          getContext(), pushConstants_.data(), pushConstants_.size(), buffer, offset))) {
+    return;
+  }
+  uniformAdapter_.setUniformBufferRange(
+      buffer, offset, pushConstants_.size(), kPushConstantsBindingIndex, nullptr);
+  pushConstantsDirty_ = false;
+  pushConstantsGeneration_ = arena.getGeneration();
+}
+
 void RenderCommandAdapter::didDraw() {
   // Placeholder stub in case we want to add something later
 }
 
 void RenderCommandAdapter::unbindVertexAttributes() {
-  auto pipelineState = static_cast<RenderPipelineState*>(pipelineState_.get());
+  if (cachedVAO_ != 0) {
+    // leave the cached VAO as it is and go back to the default one
+    activeVAO_->bind();
+    cachedVAO_ = 0;
+    return;
+  }
+  auto pipelineState = static_cast<RenderPipelineState*>(pipelineState_);
   if (pipelineState) {
     pipelineState->unbindVertexAttributes();
   }
@@ -451,13 +705,13 @@ void RenderCommandAdapter::unbindResources() {
 
   // TODO: unbind uniform blocks when we add support?
 
-  auto depthStencilState = static_cast<DepthStencilState*>(depthStencilState_.get());
+  auto depthStencilState = static_cast<DepthStencilState*>(depthStencilState_);
   if (depthStencilState) {
     depthStencilState->unbind();
     setDirty(StateMask::DEPTH_STENCIL);
   }
 
-  auto pipelineState = static_cast<RenderPipelineState*>(pipelineState_.get());
+  auto pipelineState = static_cast<RenderPipelineState*>(pipelineState_);
   if (pipelineState) {
     unbindVertexAttributes();
     pipelineState->unbind();
@@ -15,6 +15,7 @@
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/UnbindPolicy.h>
 #include <igl/opengl/UniformAdapter.h>
+#include <igl/opengl/VertexArrayCache.h>
 #include <igl/opengl/WithContext.h>
 
 namespace igl {
@@ -27,6 +28,7 @@ class IRenderPipelineState;
 
 namespace opengl {
 class Buffer;
+class RenderPipelineState;
 class VertexArrayObject;
 
 class RenderCommandAdapter final : public WithContext {
@@ -36,8 +38,10 @@ class RenderCommandAdapter final : public WithContext {
 
  private:
   struct BufferState {
-    std::shared_ptr<Buffer> resource;
-    size_t offset;
+    Buffer* resource = nullptr;
+    size_t offset = 0;
+    // set if the buffer was bound by a shared_ptr
+    std::shared_ptr<Buffer> owner;
   };
 
   using TextureState = std::pair<ITexture*, ISamplerState*>;
@@ -54,7 +58,10 @@ class RenderCommandAdapter final : public WithContext {
 
   void setScissorRect(const ScissorRect& rect);
 
+  // The overloads taking references do not retain the objects, which have to stay alive until
+  // endEncoding() (see IRenderCommandEncoder::bindRenderPipelineState())
   void setDepthStencilState(const std::shared_ptr<IDepthStencilState>& newValue);
+  void setDepthStencilState(IDepthStencilState& newValue);
   void setStencilReferenceValue(uint32_t value, Result* outResult = nullptr);
   void setStencilReferenceValues(uint32_t frontValue,
                                  uint32_t backValue,
@@ -67,13 +74,22 @@ class RenderCommandAdapter final : public WithContext {
                        size_t offset,
                        int index,
                        Result* outResult = nullptr);
+  void setVertexBuffer(Buffer& buffer, size_t offset, int index, Result* outResult = nullptr);
 
   void clearUniformBuffers();
   void setUniformBuffer(const std::shared_ptr<Buffer>& buffer,
                         size_t offset,
                         int index,
                         Result* outResult = nullptr);
+  void setUniformBuffer(Buffer& buffer, size_t offset, int index, Result* outResult = nullptr);
+  void setUniformBufferRange(GLuint buffer,
+                             size_t offset,
+                             size_t size,
+                             int index,
+                             Result* outResult = nullptr);
   void setUniform(const UniformDesc& uniformDesc, const void* data, Result* outResult = nullptr);
+  // `offset + length` has to be at most kMaxPushConstantBytes
+  void setPushConstants(const void* data, size_t length, size_t offset);
 
   void clearVertexTexture();
   void setVertexTexture(ITexture* texture, size_t index, Result* outResult = nullptr);
@@ -89,18 +105,42 @@ class RenderCommandAdapter final : public WithContext {
 
   void setPipelineState(const std::shared_ptr<IRenderPipelineState>& newValue,
                         Result* outResult = nullptr);
-
-  void drawArrays(GLenum mode, GLint first, GLsizei count);
+  void setPipelineState(IRenderPipelineState& newValue, Result* outResult = nullptr);
+
+  // Uses the plain glDraw* call unless the instance or base vertex parameters need a newer one
+  void drawArrays(GLenum mode,
+                  GLint first,
+                  GLsizei count,
+                  GLsizei instanceCount = 1,
+                  GLuint baseInstance = 0);
   void drawElements(GLenum mode,
                     GLsizei indexCount,
                     GLenum indexType,
                     Buffer& indexBuffer,
-                    const GLvoid* indexOffset);
+                    const GLvoid* indexOffset,
+                    GLsizei instanceCount = 1,
+                    GLint baseVertex = 0,
+                    GLuint baseInstance = 0);
   void drawElementsIndirect(GLenum mode,
                             GLenum indexType,
                             Buffer& indexBuffer,
                             Buffer& indirectBuffer,
                             const GLvoid* indirectBufferOffset);
+  // Issues `drawCount` indirect draws whose commands are `stride` bytes apart. Falls back to one
+  // indirect draw per command, with the render state applied only once, when glMultiDraw*Indirect
+  // is not available.
+  void multiDrawArraysIndirect(GLenum mode,
+                               Buffer& indirectBuffer,
+                               const GLvoid* indirectBufferOffset,
+                               GLsizei drawCount,
+                               GLsizei stride);
+  void multiDrawElementsIndirect(GLenum mode,
+                                 GLenum indexType,
+                                 Buffer& indexBuffer,
+                                 Buffer& indirectBuffer,
+                                 const GLvoid* indirectBufferOffset,
+                                 GLsizei drawCount,
+                                 GLsizei stride);
 
   void endEncoding();
 
@@ -111,9 +151,10 @@ class RenderCommandAdapter final : public WithContext {
  private:
   RenderCommandAdapter(IContext& context);
 
-  void clearDependentResources(const std::shared_ptr<IRenderPipelineState>& newValue,
-                               Result* outResult = nullptr);
+  void clearDependentResources(const IRenderPipelineState* newValue, Result* outResult = nullptr);
   void willDraw();
+  void bindPushConstants();
+  void bindCachedVertexArray(RenderPipelineState& pipelineState);
   void didDraw();
   void unbindVertexAttributes();
   void unbindResources();
@@ -149,12 +190,26 @@ class RenderCommandAdapter final : public WithContext {
   TextureStates fragmentTextureStates_;
   UniformAdapter uniformAdapter_;
   StateBits dirtyStateBits_ = EnumToValue(StateMask::NONE);
-  std::shared_ptr<IRenderPipelineState> pipelineState_;
-  std::shared_ptr<IDepthStencilState> depthStencilState_;
+  IRenderPipelineState* pipelineState_ = nullptr;
+  IDepthStencilState* depthStencilState_ = nullptr;
+  // set if the states were bound by a shared_ptr
+  std::shared_ptr<IRenderPipelineState> pipelineStateOwner_;
+  std::shared_ptr<IDepthStencilState> depthStencilStateOwner_;
   std::shared_ptr<VertexArrayObject> activeVAO_ = nullptr;
 
   UnbindPolicy cachedUnbindPolicy_;
   bool useVAO_ = false;
+
+  // non-zero while a VAO from the context's VertexArrayCache is bound instead of activeVAO_
+  GLuint cachedVAO_ = 0;
+  // scratch storage reused to look up cached VAOs without allocating
+  std::vector<VertexArrayCache::Binding> vertexArrayBindings_;
+
+  // push constants are uploaded to the context's UniformArena only when they change, or when the
+  // arena moved on from the buffer holding them
+  std::array<uint8_t, kMaxPushConstantBytes> pushConstants_ = {};
+  bool pushConstantsDirty_ = true;
+  uint64_t pushConstantsGeneration_ = 0;
 };
 } // namespace opengl
 } // namespace igl
@@ -14,6 +14,7 @@
 #include <igl/opengl/Errors.h>
 #include <igl/opengl/Framebuffer.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/OcclusionQueryPool.h>
 #include <igl/opengl/RenderCommandAdapter.h>
 #include <igl/opengl/RenderPipelineState.h>
 #include <igl/opengl/SamplerState.h>
@@ -47,6 +48,9 @@ RenderCommandEncoder::~RenderCommandEncoder() = default;
 void RenderCommandEncoder::beginEncoding(const RenderPassDesc& renderPass,
                                          const std::shared_ptr<IFramebuffer>& framebuffer,
                                          Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+  IGL_PROFILER_ZONE_GPU_BEGIN_OGL(tracyGpuZone_, "RenderPass");
+
   // Save caller state
   auto& context = getContext();
 
@@ -75,13 +79,19 @@ void RenderCommandEncoder::beginEncoding(const RenderPassDesc& renderPass,
       return;
     }
   }
+  context.getBindlessTable().bind(context);
   framebuffer_ = std::static_pointer_cast<igl::opengl::Framebuffer>(framebuffer);
   resolveFramebuffer_ = framebuffer_->getResolveFramebuffer();
+  occlusionQueryPool_ = renderPass.occlusionQueryPool;
   Result::setOk(outResult);
 }
 
 void RenderCommandEncoder::endEncoding() {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
+    IGL_ASSERT_MSG(activeOcclusionQueryTarget_ == GL_NONE, "endOcclusionQuery() was not called");
+    occlusionQueryPool_ = nullptr;
+
     // Restore caller state
     getContext().setEnabled(scissorEnabled_, GL_SCISSOR_TEST);
 
@@ -148,7 +158,13 @@ void RenderCommandEncoder::endEncoding() {
         IGL_ASSERT_NOT_REACHED();
       }
     }
+
+    // discards attachments which are not stored
+    framebuffer_->unbind();
   }
+#if IGL_WITH_TRACY_GPU_OGL
+  tracyGpuZone_.reset();
+#endif // IGL_WITH_TRACY_GPU_OGL
 }
 
 void RenderCommandEncoder::pushDebugGroupLabel(const std::string& label,
@@ -189,25 +205,45 @@ void RenderCommandEncoder::bindScissorRect(const ScissorRect& rect) {
 
 void RenderCommandEncoder::bindRenderPipelineState(
     const std::shared_ptr<IRenderPipelineState>& pipelineState) {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
     adapter_->setPipelineState(pipelineState);
+    getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::PipelineBinds);
   }
 }
 
 void RenderCommandEncoder::bindDepthStencilState(
     const std::shared_ptr<IDepthStencilState>& depthStencilState) {
+  IGL_PROFILER_FUNCTION();
+  if (IGL_VERIFY(adapter_)) {
+    adapter_->setDepthStencilState(depthStencilState);
+  }
+}
+
+void RenderCommandEncoder::bindRenderPipelineState(IRenderPipelineState& pipelineState) {
+  IGL_PROFILER_FUNCTION();
+  if (IGL_VERIFY(adapter_)) {
+    adapter_->setPipelineState(pipelineState);
+    getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::PipelineBinds);
+  }
+}
+
+void RenderCommandEncoder::bindDepthStencilState(IDepthStencilState& depthStencilState) {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
     adapter_->setDepthStencilState(depthStencilState);
   }
 }
 
 void RenderCommandEncoder::bindUniform(const UniformDesc& uniformDesc, const void* data) {
+  IGL_PROFILER_FUNCTION();
   IGL_ASSERT_MSG(uniformDesc.location >= 0,
                  "Invalid location passed to bindUniformBuffer: %d",
                  uniformDesc.location);
   IGL_ASSERT_MSG(data != nullptr, "Data cannot be null");
   if (IGL_VERIFY(adapter_) && data) {
     adapter_->setUniform(uniformDesc, data);
+    getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::DescriptorUpdates);
   }
 }
 
@@ -215,8 +251,8 @@ void RenderCommandEncoder::bindBuffer(int index,
                                       uint8_t bindTarget,
                                       const std::shared_ptr<IBuffer>& buffer,
                                       size_t offset) {
+  IGL_PROFILER_FUNCTION();
   IGL_ASSERT_MSG(index >= 0, "Invalid index passed to bindBuffer: %d", index);
-  // bindTarget (which can be BindTarget::kVertex or kFragment) is unused in OGL backend
   if (IGL_VERIFY(adapter_) && buffer) {
     auto glBuffer = std::static_pointer_cast<Buffer>(buffer);
     auto bufferType = glBuffer->getType();
@@ -225,28 +261,99 @@ void RenderCommandEncoder::bindBuffer(int index,
       IGL_ASSERT_NOT_IMPLEMENTED();
     } else if (bufferType == Buffer::Type::UniformBlock) {
       adapter_->setUniformBuffer(glBuffer, offset, index);
+      getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::DescriptorUpdates);
+    } else if (bufferType == Buffer::Type::Attribute && (bindTarget & BindTarget::kFragment) != 0 &&
+               static_cast<ArrayBuffer&>(*glBuffer).getTarget() == GL_SHADER_STORAGE_BUFFER) {
+      // storage buffers read by fragment shaders are bound to the binding point 'index'
+      static_cast<ArrayBuffer&>(*glBuffer).bindBase(index, nullptr);
     } else if (bufferType == Buffer::Type::Attribute && (bindTarget & BindTarget::kVertex) != 0) {
       adapter_->setVertexBuffer(std::move(glBuffer), offset, index);
     }
   }
 }
 
-void RenderCommandEncoder::bindBytes(size_t /*index*/,
+void RenderCommandEncoder::bindBuffer(int index,
+                                      uint8_t bindTarget,
+                                      IBuffer& buffer,
+                                      size_t offset) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT_MSG(index >= 0, "Invalid index passed to bindBuffer: %d", index);
+  if (IGL_VERIFY(adapter_)) {
+    auto& glBuffer = static_cast<Buffer&>(buffer);
+    auto bufferType = glBuffer.getType();
+
+    if (bufferType == Buffer::Type::Uniform) {
+      IGL_ASSERT_NOT_IMPLEMENTED();
+    } else if (bufferType == Buffer::Type::UniformBlock) {
+      adapter_->setUniformBuffer(glBuffer, offset, index);
+      getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::DescriptorUpdates);
+    } else if (bufferType == Buffer::Type::Attribute && (bindTarget & BindTarget::kFragment) != 0 &&
+               static_cast<ArrayBuffer&>(glBuffer).getTarget() == GL_SHADER_STORAGE_BUFFER) {
+      static_cast<ArrayBuffer&>(glBuffer).bindBase(index, nullptr);
+    } else if (bufferType == Buffer::Type::Attribute && (bindTarget & BindTarget::kVertex) != 0) {
+      adapter_->setVertexBuffer(glBuffer, offset, index);
+    }
+  }
+}
+
+void RenderCommandEncoder::bindBytes(size_t index,
                                      uint8_t /*target*/,
-                                     const void* /*data*/,
-                                     size_t /*length*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+                                     const void* data,
+                                     size_t length) {
+  IGL_PROFILER_FUNCTION();
+  // the data is bound as a uniform block, so bindTarget is unused as in bindBuffer()
+  if (!IGL_VERIFY(adapter_) || !IGL_VERIFY(data != nullptr)) {
+    return;
+  }
+  auto& context = getContext();
+  if (!context.deviceFeatures().hasFeature(DeviceFeatures::UniformBlocks)) {
+    IGL_ASSERT_MSG(false, "bindBytes() requires DeviceFeatures::UniformBlocks");
+    return;
+  }
+
+  GLuint buffer = 0;
+  size_t offset = 0;
+  if (!context.getUniformArena().allocate(context, data, length, buffer, offset)) {
+    IGL_ASSERT_MSG(false,
+                   "bindBytes() is limited to DeviceFeatureLimits::MaxBindBytesBytes: %u",
+                   (uint32_t)length);
+    return;
+  }
+  adapter_->setUniformBufferRange(buffer, offset, length, static_cast<int>(index));
+  context.getFrameStatisticsTracker().add(FrameStatisticsTracker::DescriptorUpdates);
 }
 
-void RenderCommandEncoder::bindPushConstants(const void* /*data*/,
-                                             size_t /*length*/,
-                                             size_t /*offset*/) {
+void RenderCommandEncoder::bindPushConstants(const void* data, size_t length, size_t offset) {
+  IGL_PROFILER_FUNCTION();
+  // emulated with a uniform block at kPushConstantsBindingIndex
+  if (!IGL_VERIFY(adapter_) || !IGL_VERIFY(data != nullptr)) {
+    return;
+  }
+  if (!getContext().deviceFeatures().hasFeature(DeviceFeatures::PushConstants)) {
+    IGL_ASSERT_MSG(false, "bindPushConstants() requires DeviceFeatures::PushConstants");
+    return;
+  }
+  if (offset + length > kMaxPushConstantBytes) {
+    IGL_ASSERT_MSG(false,
+                   "Push constants size exceeded: %u > %u",
+                   (uint32_t)(offset + length),
+                   (uint32_t)kMaxPushConstantBytes);
+    return;
+  }
+  adapter_->setPushConstants(data, length, offset);
+}
+
+void RenderCommandEncoder::bindBufferAddress(size_t /*offset*/,
+                                             IBuffer& /*buffer*/,
+                                             size_t /*bufferOffset*/) {
+  IGL_PROFILER_FUNCTION();
   IGL_ASSERT_NOT_IMPLEMENTED();
 }
 
 void RenderCommandEncoder::bindSamplerState(size_t index,
                                             uint8_t bindTarget,
                                             ISamplerState* samplerState) {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
     if ((bindTarget & BindTarget::kVertex) != 0) {
       adapter_->setVertexSamplerState(samplerState, index);
@@ -258,6 +365,7 @@ void RenderCommandEncoder::bindSamplerState(size_t index,
 }
 
 void RenderCommandEncoder::bindTexture(size_t index, uint8_t bindTarget, ITexture* texture) {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
     if ((bindTarget & BindTarget::kVertex) != 0) {
       adapter_->setVertexTexture(texture, index);
@@ -265,6 +373,7 @@ void RenderCommandEncoder::bindTexture(size_t index, uint8_t bindTarget, ITextur
     if ((bindTarget & BindTarget::kFragment) != 0) {
       adapter_->setFragmentTexture(texture, index);
     }
+    getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::DescriptorUpdates);
   }
 }
 
@@ -304,11 +413,18 @@ constexpr int toGlType(IndexFormat format) {
 
 void RenderCommandEncoder::draw(PrimitiveType primitiveType,
                                 size_t vertexStart,
-                                size_t vertexCount) {
+                                size_t vertexCount,
+                                uint32_t instanceCount,
+                                uint32_t baseInstance) {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
     getCommandBuffer().incrementCurrentDrawCount();
     auto mode = toGlPrimitive(primitiveType);
-    adapter_->drawArrays(mode, (GLsizei)vertexStart, (GLsizei)vertexCount);
+    adapter_->drawArrays(mode,
+                         (GLsizei)vertexStart,
+                         (GLsizei)vertexCount,
+                         (GLsizei)instanceCount,
+                         (GLuint)baseInstance);
   }
 }
 
@@ -316,13 +432,24 @@ void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
                                        size_t indexCount,
                                        IndexFormat indexFormat,
                                        IBuffer& indexBuffer,
-                                       size_t indexBufferOffset) {
+                                       size_t indexBufferOffset,
+                                       uint32_t instanceCount,
+                                       int32_t baseVertex,
+                                       uint32_t baseInstance) {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
     getCommandBuffer().incrementCurrentDrawCount();
     auto mode = toGlPrimitive(primitiveType);
     auto type = toGlType(indexFormat);
     auto offset = reinterpret_cast<void*>(indexBufferOffset);
-    adapter_->drawElements(mode, (GLsizei)indexCount, type, (Buffer&)indexBuffer, offset);
+    adapter_->drawElements(mode,
+                           (GLsizei)indexCount,
+                           type,
+                           (Buffer&)indexBuffer,
+                           offset,
+                           (GLsizei)instanceCount,
+                           (GLint)baseVertex,
+                           (GLuint)baseInstance);
   }
 }
 
@@ -331,6 +458,7 @@ void RenderCommandEncoder::drawIndexedIndirect(PrimitiveType primitiveType,
                                                IBuffer& indexBuffer,
                                                IBuffer& indirectBuffer,
                                                size_t indirectBufferOffset) {
+  IGL_PROFILER_FUNCTION();
   if (IGL_VERIFY(adapter_)) {
     getCommandBuffer().incrementCurrentDrawCount();
     auto mode = toGlPrimitive(primitiveType);
@@ -341,22 +469,49 @@ void RenderCommandEncoder::drawIndexedIndirect(PrimitiveType primitiveType,
   }
 }
 
-void RenderCommandEncoder::multiDrawIndirect(PrimitiveType /*primitiveType*/,
-                                             IBuffer& /*indirectBuffer*/,
-                                             size_t /*indirectBufferOffset*/,
-                                             uint32_t /*drawCount*/,
-                                             uint32_t /*stride*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+void RenderCommandEncoder::multiDrawIndirect(PrimitiveType primitiveType,
+                                             IBuffer& indirectBuffer,
+                                             size_t indirectBufferOffset,
+                                             uint32_t drawCount,
+                                             uint32_t stride) {
+  IGL_PROFILER_FUNCTION();
+  if (IGL_VERIFY(adapter_)) {
+    getCommandBuffer().incrementCurrentDrawCount();
+    auto mode = toGlPrimitive(primitiveType);
+    auto indirectBufferOffsetPtr = reinterpret_cast<void*>(indirectBufferOffset);
+    // DrawArraysIndirectCommand: count, instanceCount, first, baseInstance
+    stride = stride ? stride : 4 * sizeof(GLuint);
+    adapter_->multiDrawArraysIndirect(mode,
+                                      (Buffer&)indirectBuffer,
+                                      indirectBufferOffsetPtr,
+                                      (GLsizei)drawCount,
+                                      (GLsizei)stride);
+  }
 }
 
-void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType /*primitiveType*/,
-                                                    IndexFormat /*indexFormat*/,
-                                                    IBuffer& /*indexBuffer*/,
-                                                    IBuffer& /*indirectBuffer*/,
-                                                    size_t /*indirectBufferOffset*/,
-                                                    uint32_t /*drawCount*/,
-                                                    uint32_t /*stride*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType primitiveType,
+                                                    IndexFormat indexFormat,
+                                                    IBuffer& indexBuffer,
+                                                    IBuffer& indirectBuffer,
+                                                    size_t indirectBufferOffset,
+                                                    uint32_t drawCount,
+                                                    uint32_t stride) {
+  IGL_PROFILER_FUNCTION();
+  if (IGL_VERIFY(adapter_)) {
+    getCommandBuffer().incrementCurrentDrawCount();
+    auto mode = toGlPrimitive(primitiveType);
+    auto type = toGlType(indexFormat);
+    auto indirectBufferOffsetPtr = reinterpret_cast<void*>(indirectBufferOffset);
+    // DrawElementsIndirectCommand: count, instanceCount, firstIndex, baseVertex, baseInstance
+    stride = stride ? stride : 5 * sizeof(GLuint);
+    adapter_->multiDrawElementsIndirect(mode,
+                                        type,
+                                        (Buffer&)indexBuffer,
+                                        (Buffer&)indirectBuffer,
+                                        indirectBufferOffsetPtr,
+                                        (GLsizei)drawCount,
+                                        (GLsizei)stride);
+  }
 }
 
 void RenderCommandEncoder::setStencilReferenceValue(uint32_t value) {
@@ -383,5 +538,28 @@ void RenderCommandEncoder::setDepthBias(float depthBias, float slopeScale, float
   }
 }
 
+void RenderCommandEncoder::beginOcclusionQuery(uint32_t queryIndex) {
+  if (!IGL_VERIFY(occlusionQueryPool_) || !IGL_VERIFY(activeOcclusionQueryTarget_ == GL_NONE)) {
+    return;
+  }
+  const auto& pool = static_cast<const OcclusionQueryPool&>(*occlusionQueryPool_);
+  activeOcclusionQueryTarget_ = pool.getTarget();
+  getContext().beginQuery(activeOcclusionQueryTarget_, pool.getId(queryIndex));
+}
+
+void RenderCommandEncoder::endOcclusionQuery() {
+  if (IGL_VERIFY(activeOcclusionQueryTarget_ != GL_NONE)) {
+    getContext().endQuery(activeOcclusionQueryTarget_);
+    activeOcclusionQueryTarget_ = GL_NONE;
+  }
+}
+
+void RenderCommandEncoder::nextSubpass() {
+  // the attachments written so far are read with GL_EXT_shader_framebuffer_fetch, which is
+  // coherent without any barrier
+  IGL_ASSERT_MSG(getContext().deviceFeatures().hasFeature(DeviceFeatures::Subpasses),
+                 "Subpasses require GL_EXT_shader_framebuffer_fetch");
+}
+
 } // namespace opengl
 } // namespace igl
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <igl/Common.h>
+#include <igl/ObjectPool.h>
 #include <igl/RenderCommandEncoder.h>
 #include <igl/opengl/Framebuffer.h>
 #include <igl/opengl/GLIncludes.h>
@@ -24,7 +25,9 @@ namespace opengl {
 class RenderCommandAdapter;
 class CommandBuffer;
 
-class RenderCommandEncoder final : public IRenderCommandEncoder, public WithContext {
+class RenderCommandEncoder final : public IRenderCommandEncoder,
+                                   public WithContext,
+                                   public Pooled<RenderCommandEncoder> {
  public:
   static std::unique_ptr<RenderCommandEncoder> create(
       const std::shared_ptr<CommandBuffer>& commandBuffer,
@@ -52,6 +55,8 @@ class RenderCommandEncoder final : public IRenderCommandEncoder, public WithCont
 
   void bindRenderPipelineState(const std::shared_ptr<IRenderPipelineState>& pipelineState) override;
   void bindDepthStencilState(const std::shared_ptr<IDepthStencilState>& depthStencilState) override;
+  void bindRenderPipelineState(IRenderPipelineState& pipelineState) override;
+  void bindDepthStencilState(IDepthStencilState& depthStencilState) override;
 
   // Binds a non-block uniform (eg. opengl 2.0 shader)
   // The data pointer must remain valid until the commandBuffer's execution has been completed by
@@ -61,17 +66,26 @@ class RenderCommandEncoder final : public IRenderCommandEncoder, public WithCont
                   uint8_t target,
                   const std::shared_ptr<IBuffer>& buffer,
                   size_t bufferOffset) override;
+  void bindBuffer(int index, uint8_t target, IBuffer& buffer, size_t bufferOffset) override;
   void bindBytes(size_t index, uint8_t target, const void* data, size_t length) override;
   void bindPushConstants(const void* data, size_t length, size_t offset) override;
+  void bindBufferAddress(size_t offset, IBuffer& buffer, size_t bufferOffset) override;
   void bindSamplerState(size_t index, uint8_t target, ISamplerState* samplerState) override;
   void bindTexture(size_t index, uint8_t target, ITexture* texture) override;
 
-  void draw(PrimitiveType primitiveType, size_t vertexStart, size_t vertexCount) override;
+  void draw(PrimitiveType primitiveType,
+            size_t vertexStart,
+            size_t vertexCount,
+            uint32_t instanceCount = 1,
+            uint32_t baseInstance = 0) override;
   void drawIndexed(PrimitiveType primitiveType,
                    size_t indexCount,
                    IndexFormat indexFormat,
                    IBuffer& indexBuffer,
-                   size_t indexBufferOffset) override;
+                   size_t indexBufferOffset,
+                   uint32_t instanceCount = 1,
+                   int32_t baseVertex = 0,
+                   uint32_t baseInstance = 0) override;
   void drawIndexedIndirect(PrimitiveType primitiveType,
                            IndexFormat indexFormat,
                            IBuffer& indexBuffer,
@@ -95,11 +109,22 @@ class RenderCommandEncoder final : public IRenderCommandEncoder, public WithCont
   void setBlendColor(Color color) override;
   void setDepthBias(float depthBias, float slopeScale, float clamp) override;
 
+  void beginOcclusionQuery(uint32_t queryIndex) override;
+  void endOcclusionQuery() override;
+
+  void nextSubpass() override;
+
  private:
   std::unique_ptr<RenderCommandAdapter> adapter_;
   bool scissorEnabled_ = false;
   std::shared_ptr<igl::opengl::Framebuffer> resolveFramebuffer_;
   std::shared_ptr<igl::opengl::Framebuffer> framebuffer_;
+  std::shared_ptr<IOcclusionQueryPool> occlusionQueryPool_;
+  // target of the running occlusion query, or GL_NONE
+  GLenum activeOcclusionQueryTarget_ = GL_NONE;
+#if IGL_WITH_TRACY_GPU_OGL
+  std::unique_ptr<tracy::GpuCtxScope> tracyGpuZone_; // the render pass
+#endif // IGL_WITH_TRACY_GPU_OGL
 };
 
 } // namespace opengl
@@ -87,6 +87,7 @@ RenderPipelineReflection::RenderPipelineReflection(IContext& context, const Shad
   generateUniformDictionary(context, stages.getProgramID());
   generateAttributeDictionary(context, stages.getProgramID());
   generateShaderStorageBufferObjectDictionary(context, stages.getProgramID());
+  buildIndexTable();
   cacheDescriptors();
 }
 
@@ -261,33 +262,62 @@ void RenderPipelineReflection::generateShaderStorageBufferObjectDictionary(ICont
   }
 }
 
-int RenderPipelineReflection::getIndexByName(const NameHandle& name) const {
-  // Search through list of uniforms
-  const auto uniformEntry = uniformDictionary_.find(name);
+void RenderPipelineReflection::buildIndexTable() {
+  const size_t numNames = uniformDictionary_.size() + uniformBlocksDictionary_.size() +
+                          attributeDictionary_.size() +
+                          shaderStorageBufferObjectDictionary_.size();
 
-  if (uniformEntry != uniformDictionary_.end()) {
-    return uniformEntry->second.location;
+  // a power of two with a load factor of at most 1/2, so every probe sequence ends at an empty slot
+  size_t tableSize = 1;
+  while (tableSize < 2 * numNames) {
+    tableSize <<= 1;
   }
+  indexTable_.assign(tableSize, IndexEntry{});
+
+  // names already in the table win, which keeps the search order of the dictionaries
+  auto insert = [this](uint32_t crc32, int index) {
+    const size_t mask = indexTable_.size() - 1;
+    for (size_t i = crc32 & mask;; i = (i + 1) & mask) {
+      IndexEntry& entry = indexTable_[i];
+      if (entry.index == kEmptyIndexEntry) {
+        entry = IndexEntry{crc32, index};
+        return;
+      }
+      if (entry.crc32 == crc32) {
+        return;
+      }
+    }
+  };
 
-  // search through the list of uniform blocks
-  const auto uniformBlockEntry = uniformBlocksDictionary_.find(name);
-  if (uniformBlockEntry != uniformBlocksDictionary_.end()) {
-    return uniformBlockEntry->second.blockIndex;
+  for (const auto& entry : uniformDictionary_) {
+    insert(entry.first.getCrc32(), entry.second.location);
   }
-
-  // Search through list of attributes
-  auto attribEntry = attributeDictionary_.find(name.toString());
-  if (attribEntry != attributeDictionary_.end()) {
-    return attribEntry->second;
+  for (const auto& entry : uniformBlocksDictionary_) {
+    insert(entry.first.getCrc32(), entry.second.blockIndex);
   }
-
-  // Search through list of SSBOs
-  auto ssboEntry = shaderStorageBufferObjectDictionary_.find(name);
-  if (ssboEntry != shaderStorageBufferObjectDictionary_.end()) {
-    return ssboEntry->second;
+  for (const auto& entry : attributeDictionary_) {
+    insert(iglCrc32(entry.first.c_str(), entry.first.length()), entry.second);
   }
+  for (const auto& entry : shaderStorageBufferObjectDictionary_) {
+    insert(entry.first.getCrc32(), entry.second);
+  }
+}
 
-  return -1;
+int RenderPipelineReflection::getIndexByName(const NameHandle& name) const {
+  if (indexTable_.empty()) {
+    return -1;
+  }
+  const uint32_t crc32 = name.getCrc32();
+  const size_t mask = indexTable_.size() - 1;
+  for (size_t i = crc32 & mask;; i = (i + 1) & mask) {
+    const IndexEntry& entry = indexTable_[i];
+    if (entry.index == kEmptyIndexEntry) {
+      return -1;
+    }
+    if (entry.crc32 == crc32) {
+      return entry.index;
+    }
+  }
 }
 
 void RenderPipelineReflection::cacheDescriptors() {
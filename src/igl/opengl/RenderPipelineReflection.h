@@ -11,7 +11,9 @@
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
 #include <igl/opengl/Shader.h>
+#include <limits>
 #include <unordered_map>
+#include <vector>
 
 namespace igl {
 namespace opengl {
@@ -43,6 +45,8 @@ class RenderPipelineReflection final : public IRenderPipelineReflection {
   const std::vector<SamplerArgDesc>& allSamplers() const override;
   const std::vector<TextureArgDesc>& allTextures() const override;
 
+  /// Searches uniforms, uniform blocks, attributes and SSBOs, in that order; -1 if not found.
+  /// The names are compared by their CRC32, like NameHandle::operator==().
   int getIndexByName(const NameHandle& name) const;
 
   const std::unordered_map<NameHandle, UniformDesc>& getUniformDictionary() const {
@@ -75,6 +79,16 @@ class RenderPipelineReflection final : public IRenderPipelineReflection {
   void generateShaderStorageBufferObjectDictionary(IContext& context, GLuint pid);
   void generateAttributeDictionary(IContext& context, GLuint pid);
 
+  // all the dictionaries merged into one open-addressing table keyed by CRC32, so
+  // getIndexByName() is a couple of probes into a flat array
+  static constexpr int kEmptyIndexEntry = std::numeric_limits<int>::min();
+  struct IndexEntry {
+    uint32_t crc32 = 0;
+    int index = kEmptyIndexEntry;
+  };
+  std::vector<IndexEntry> indexTable_;
+  void buildIndexTable();
+
   void cacheDescriptors();
   std::vector<BufferArgDesc> bufferArguments_;
   std::vector<SamplerArgDesc> samplerArguments_;
@@ -7,6 +7,8 @@
 
 #include <igl/opengl/RenderPipelineState.h>
 
+#include <algorithm>
+#include <atomic>
 #include <igl/RenderCommandEncoder.h> // for igl::BindTarget
 #include <igl/opengl/VertexInputState.h>
 
@@ -21,14 +23,19 @@ void logBlendFactorError(IGL_MAYBE_UNUSED const char* value) {
   IGL_ASSERT(0);
 }
 
+std::atomic<uint64_t> nextUniqueId{1};
+
 } // namespace
 
-RenderPipelineState::RenderPipelineState(IContext& context) : WithContext(context) {
+RenderPipelineState::RenderPipelineState(IContext& context) :
+  WithContext(context), uniqueId_(nextUniqueId.fetch_add(1, std::memory_order_relaxed)) {
   activeAttributesLocations_.reserve(64);
   unitSamplerLocationMap_.fill(-1);
 }
 
-RenderPipelineState::~RenderPipelineState() = default;
+RenderPipelineState::~RenderPipelineState() {
+  getContext().getVertexArrayCache().onPipelineDestroyed(getContext(), this);
+}
 
 GLenum RenderPipelineState::convertBlendOp(BlendOp value) {
   // sets blending equation for both RGA and Alpha
@@ -161,6 +168,30 @@ Result RenderPipelineState::create(const RenderPipelineDesc& desc) {
     }
   }
 
+  // the blocks which emulate push constants live at a reserved binding point
+  usesPushConstants_ = false;
+  const auto vertexModule = shaderStages_->getVertexModule();
+  const auto fragmentModule = shaderStages_->getFragmentModule();
+  for (const auto* module : {vertexModule.get(), fragmentModule.get()}) {
+    const auto& blockName = static_cast<const ShaderModule&>(*module).getPushConstantBlockName();
+    if (blockName.empty()) {
+      continue;
+    }
+    const int blockIndex = reflection_->getIndexByName(genNameHandle(blockName));
+    if (blockIndex < 0) {
+      // the block is not used by the shader
+      continue;
+    }
+    for (const auto& [index, bindingIndex] : uniformBlockBindingMap_) {
+      if (index != blockIndex && bindingIndex == static_cast<size_t>(kPushConstantsBindingIndex)) {
+        return Result{Result::Code::ArgumentInvalid,
+                      "The uniform block binding point of push constants is reserved"};
+      }
+    }
+    uniformBlockBindingMap_[blockIndex] = static_cast<size_t>(kPushConstantsBindingIndex);
+    usesPushConstants_ = true;
+  }
+
   for (const auto& [textureUnit, samplerName] : desc.vertexUnitSamplerMap) {
     const int loc = reflection_->getIndexByName(samplerName);
     if (loc < 0) {
@@ -293,7 +324,7 @@ void RenderPipelineState::bindVertexAttributes(size_t bufferIndex, size_t buffer
         reinterpret_cast<const char*>(attribute.bufferOffset) + bufferOffset);
 
     if (getContext().deviceFeatures().hasInternalFeature(InternalFeatures::VertexAttribDivisor)) {
-      getContext().vertexAttribDivisor(location, 0);
+      getContext().vertexAttribDivisor(location, attribute.divisor);
     }
   }
 }
@@ -305,11 +336,23 @@ void RenderPipelineState::unbindVertexAttributes() {
   activeAttributesLocations_.clear();
 }
 
+void RenderPipelineState::detachVertexAttributes() {
+  activeAttributesLocations_.clear();
+}
+
+bool RenderPipelineState::usesVertexBuffer(size_t bufferIndex) const {
+  const auto& locations = bufferAttribLocations_[bufferIndex];
+  return std::any_of(
+      locations.begin(), locations.end(), [](int location) { return location >= 0; });
+}
+
 // Looks up the location the of the specified texture unit via its name,
 // bind the unit to the location, then activate the unit.
 //
 // Prerequisite: The shader program has to be loaded
-Result RenderPipelineState::bindTextureUnit(const size_t unit, uint8_t bindTarget) {
+Result RenderPipelineState::bindTextureUnit(const size_t unit,
+                                            uint8_t bindTarget,
+                                            bool activateUnit) {
   if (!shaderStages_) {
     return Result{Result::Code::InvalidOperation, "No shader set\n"};
   }
@@ -335,7 +378,11 @@ Result RenderPipelineState::bindTextureUnit(const size_t unit, uint8_t bindTarge
   }
 
   getContext().uniform1i(samplerLocation, static_cast<GLint>(unit));
-  getContext().activeTexture(static_cast<GLenum>(GL_TEXTURE0 + unit));
+  // the sampler uniform is no longer what UniformAdapter last uploaded to this location
+  shaderStages_->uniformValueCache().invalidate(samplerLocation);
+  if (activateUnit) {
+    getContext().activeTexture(static_cast<GLenum>(GL_TEXTURE0 + unit));
+  }
 
   return Result();
 }
@@ -381,5 +428,9 @@ std::unordered_map<int, size_t>& RenderPipelineState::uniformBlockBindingMap() {
   return uniformBlockBindingMap_;
 }
 
+UniformValueCache* RenderPipelineState::uniformValueCache() {
+  return shaderStages_ ? &shaderStages_->uniformValueCache() : nullptr;
+}
+
 } // namespace opengl
 } // namespace igl
@@ -40,10 +40,17 @@ class RenderPipelineState final : public WithContext, public IRenderPipelineStat
   Result create(const RenderPipelineDesc& desc);
   void bind();
   void unbind();
-  Result bindTextureUnit(const size_t unit, uint8_t bindTarget);
+  // Points the sampler of `unit` at texture unit `unit`. Also makes it the active texture unit
+  // unless `activateUnit` is false, for callers binding textures without bind-to-edit.
+  Result bindTextureUnit(const size_t unit, uint8_t bindTarget, bool activateUnit = true);
 
   void bindVertexAttributes(size_t bufferIndex, size_t offset);
   void unbindVertexAttributes();
+  // Forgets the attributes enabled by bindVertexAttributes() without disabling them. Used once
+  // they belong to a cached vertex array object which is not going to be modified again.
+  void detachVertexAttributes();
+  // true if any attribute of the shader program is sourced from this buffer index
+  bool usesVertexBuffer(size_t bufferIndex) const;
 
   bool matchesShaderProgram(const RenderPipelineState& rhs) const;
   bool matchesVertexInputState(const RenderPipelineState& rhs) const;
@@ -52,6 +59,13 @@ class RenderPipelineState final : public WithContext, public IRenderPipelineStat
   int getIndexByName(const std::string& name, ShaderStage stage) const override;
 
   int getUniformBlockBindingPoint(const NameHandle& uniformBlockName) const;
+
+  // Unique for the lifetime of the process and never 0. Indices from getIndexByName() and
+  // getUniformBlockBindingPoint() do not change for a pipeline, so callers can cache them together
+  // with this id instead of resolving names on every draw.
+  uint64_t getUniqueId() const {
+    return uniqueId_;
+  }
   std::shared_ptr<IRenderPipelineReflection> renderPipelineReflection() override;
   void setRenderPipelineReflection(
       const IRenderPipelineReflection& renderPipelineReflection) override;
@@ -70,6 +84,14 @@ class RenderPipelineState final : public WithContext, public IRenderPipelineStat
 
   std::unordered_map<int, size_t>& uniformBlockBindingMap();
 
+  // true if the shaders have a push constant block, bound to kPushConstantsBindingIndex
+  bool usesPushConstants() const {
+    return usesPushConstants_;
+  }
+
+  // null if the pipeline has no shader program
+  UniformValueCache* uniformValueCache();
+
  private:
   std::shared_ptr<VertexInputState> vertexInputState_;
 
@@ -90,6 +112,9 @@ class RenderPipelineState final : public WithContext, public IRenderPipelineStat
   PolygonFillMode polygonFillMode_ = igl::PolygonFillMode::Fill;
 
   bool blendEnabled_ = false;
+  bool usesPushConstants_ = false;
+
+  const uint64_t uniqueId_;
 };
 
 } // namespace opengl
@@ -47,6 +47,10 @@ void SamplerState::bind(ITexture* t) {
   if (texture->getSamplerHash() == hash_) {
     return;
   }
+  if (texture->hasBindlessHandle()) {
+    IGL_LOG_INFO_ONCE("The sampling parameters of bindless textures cannot change\n");
+    return;
+  }
   texture->setSamplerHash(hash_);
 
   auto type = texture->getType();
@@ -56,6 +60,17 @@ void SamplerState::bind(ITexture* t) {
   }
 
   const auto& deviceFeatures = getContext().deviceFeatures();
+  // with direct state access the texture doesn't have to be bound to the active unit
+  const bool directStateAccess =
+      deviceFeatures.hasInternalFeature(InternalFeatures::DirectStateAccess);
+  const GLuint textureId = texture->getId();
+  auto texParameteri = [this, directStateAccess, target, textureId](GLenum pname, GLint param) {
+    if (directStateAccess) {
+      getContext().textureParameteri(textureId, pname, param);
+    } else {
+      getContext().texParameteri(target, pname, param);
+    }
+  };
 
   // From OpenGL ES 3.1 spec
   // The effective internal format specified for the texture arrays is a sized internal depth or
@@ -73,50 +88,49 @@ void SamplerState::bind(ITexture* t) {
         minMipFilter_ == GL_LINEAR_MIPMAP_LINEAR) {
       supportedMode = GL_NEAREST_MIPMAP_NEAREST;
     }
-    getContext().texParameteri(target, GL_TEXTURE_MIN_FILTER, supportedMode);
+    texParameteri(GL_TEXTURE_MIN_FILTER, supportedMode);
   } else {
-    getContext().texParameteri(target, GL_TEXTURE_MIN_FILTER, minMipFilter_);
+    texParameteri(GL_TEXTURE_MIN_FILTER, minMipFilter_);
   }
   if (!depthCompareEnabled_ && texture->getProperties().isDepthOrStencil() &&
       magFilter_ != GL_NEAREST) {
     IGL_LOG_INFO_ONCE(
         "OpenGL requires a GL_NEAREST mag filter for depth/stencil samplers when "
         "DepthCompareEnabled is false, falling back to GL_NEAREST instead of requested format.");
-    getContext().texParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    texParameteri(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
   } else {
-    getContext().texParameteri(target, GL_TEXTURE_MAG_FILTER, magFilter_);
+    texParameteri(GL_TEXTURE_MAG_FILTER, magFilter_);
   }
 
   // See https://www.khronos.org/registry/OpenGL-Refpages/gl2.1/xhtml/glTexParameter.xml
   // for OpenGL version information.
   if (deviceFeatures.hasFeature(DeviceFeatures::SamplerMinMaxLod)) {
-    getContext().texParameteri(target, GL_TEXTURE_MIN_LOD, mipLodMin_);
-    getContext().texParameteri(target, GL_TEXTURE_MAX_LOD, mipLodMax_);
+    texParameteri(GL_TEXTURE_MIN_LOD, mipLodMin_);
+    texParameteri(GL_TEXTURE_MAX_LOD, mipLodMax_);
   }
 
   if (deviceFeatures.hasInternalFeature(InternalFeatures::TextureCompare)) {
-    getContext().texParameteri(target,
-                               GL_TEXTURE_COMPARE_MODE,
-                               depthCompareEnabled_ ? GL_COMPARE_REF_TO_TEXTURE : GL_NONE);
-    getContext().texParameteri(target, GL_TEXTURE_COMPARE_FUNC, depthCompareFunction_);
+    texParameteri(GL_TEXTURE_COMPARE_MODE,
+                  depthCompareEnabled_ ? GL_COMPARE_REF_TO_TEXTURE : GL_NONE);
+    texParameteri(GL_TEXTURE_COMPARE_FUNC, depthCompareFunction_);
   }
 
   if (!deviceFeatures.hasFeature(DeviceFeatures::TextureNotPot)) {
     const auto dimensions = texture->getDimensions();
     if (!isPowerOfTwo(dimensions.width) || !isPowerOfTwo(dimensions.height)) {
-      getContext().texParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-      getContext().texParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      texParameteri(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      texParameteri(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     } else {
-      getContext().texParameteri(target, GL_TEXTURE_WRAP_S, addressU_);
-      getContext().texParameteri(target, GL_TEXTURE_WRAP_T, addressV_);
+      texParameteri(GL_TEXTURE_WRAP_S, addressU_);
+      texParameteri(GL_TEXTURE_WRAP_T, addressV_);
     }
   } else {
-    getContext().texParameteri(target, GL_TEXTURE_WRAP_S, addressU_);
-    getContext().texParameteri(target, GL_TEXTURE_WRAP_T, addressV_);
+    texParameteri(GL_TEXTURE_WRAP_S, addressU_);
+    texParameteri(GL_TEXTURE_WRAP_T, addressV_);
   }
 
   if (type == TextureType::TwoDArray || type == TextureType::ThreeD) {
-    getContext().texParameteri(target, GL_TEXTURE_WRAP_R, addressW_);
+    texParameteri(GL_TEXTURE_WRAP_R, addressW_);
   }
 }
 
@@ -9,10 +9,13 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <igl/opengl/CommandBuffer.h>
 #include <igl/opengl/Device.h>
 #include <igl/opengl/Errors.h>
+#include <regex>
 #include <string>
+#include <vector>
 
 #if IGL_SHADER_DUMP
 #include <filesystem>
@@ -22,6 +25,100 @@
 namespace igl {
 namespace opengl {
 
+namespace {
+
+// Turns a Vulkan-style `layout(push_constant) uniform Name {...}` block into a std140 uniform
+// block. Returns the name of the block, or an empty string if the source has none.
+std::string remapPushConstantBlock(std::string& source) {
+  static const std::regex kPushConstantBlock(
+      R"(layout\s*\(\s*push_constant\s*\)(\s*uniform\s+)(\w+))");
+
+  std::smatch match;
+  if (!std::regex_search(source, match, kPushConstantBlock)) {
+    return {};
+  }
+  std::string blockName = match[2].str();
+  source.replace(match.position(0),
+                 match.length(0),
+                 "layout(std140)" + match[1].str() + blockName);
+  return blockName;
+}
+
+std::string toGLSLLiteral(const ShaderSpecializationConstant& constant) {
+  switch (constant.type) {
+  case ShaderSpecializationConstant::Type::Bool:
+    return constant.value ? "true" : "false";
+  case ShaderSpecializationConstant::Type::Int:
+    return std::to_string(constant.asInt());
+  case ShaderSpecializationConstant::Type::UInt:
+    return std::to_string(constant.value) + "u";
+  case ShaderSpecializationConstant::Type::Float: {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.9g", constant.asFloat());
+    std::string literal(buffer);
+    if (literal.find_first_of(".en") == std::string::npos) {
+      literal += ".0"; // keep it a float literal
+    }
+    return literal;
+  }
+  }
+  IGL_ASSERT_NOT_REACHED();
+  return {};
+}
+
+// OpenGL has no specialization constants: they become macros defined right after the #version
+// directive, which has to stay the first line of the shader
+void defineSpecializationConstants(std::string& source,
+                                   const std::vector<ShaderSpecializationConstant>& constants) {
+  std::string defines;
+  for (const auto& constant : constants) {
+    defines += "#define " + constant.name + " " + toGLSLLiteral(constant) + "\n";
+  }
+  size_t pos = 0;
+  const size_t version = source.find("#version");
+  if (version != std::string::npos) {
+    pos = source.find('\n', version);
+    if (pos == std::string::npos) {
+      source += '\n';
+      pos = source.size();
+    } else {
+      pos++;
+    }
+  }
+  source.insert(pos, defines);
+}
+
+// Declares the float samplers and the outputs of an OpenGL ES fragment shader, which have no
+// precision qualifiers, mediump: see ShaderCompilerOptions::relaxedPrecisionEnabled. Shadow and
+// integer samplers keep their precision. Returns the names of the lowered declarations.
+std::vector<std::string> relaxFragmentPrecision(std::string& source) {
+  static const std::regex kDeclaration(
+      R"(\b(uniform|out)\s+(sampler2D|sampler2DArray|sampler3D|samplerCube|samplerExternalOES|)"
+      R"(float|vec[234])\s+(\w+)\s*(\[[^\]]*\]\s*)?;)");
+
+  std::vector<std::string> names;
+  std::string relaxed;
+  auto begin = source.cbegin();
+  for (std::sregex_iterator it(source.cbegin(), source.cend(), kDeclaration), end; it != end;
+       ++it) {
+    const std::smatch& match = *it;
+    const bool isSampler = match[2].str().compare(0, 7, "sampler") == 0;
+    if (isSampler != (match[1].str() == "uniform")) {
+      continue; // uniform floats and vectors are not relaxed
+    }
+    relaxed.append(begin, match[0].first);
+    relaxed += match[1].str() + " mediump " + match[2].str() + " " + match[3].str() +
+               match[4].str() + ";";
+    begin = match[0].second;
+    names.push_back(match[3].str());
+  }
+  relaxed.append(begin, source.cend());
+  source = std::move(relaxed);
+  return names;
+}
+
+} // namespace
+
 ShaderStages::ShaderStages(const ShaderStagesDesc& desc, IContext& context) :
   IShaderStages(desc), WithContext(context), programID_(0) {}
 
@@ -67,6 +164,15 @@ void ShaderStages::createRenderProgram(Result* result) {
     return;
   }
 
+  ProgramBinaryCache& binaryCache = getContext().getProgramBinaryCache();
+  const size_t binaryKey = getProgramBinaryKey();
+  if (binaryCache.load(getContext(), binaryKey, programID)) {
+    setProgram(programID);
+    Result::setResult(result, Result::Code::Ok);
+    return;
+  }
+  binaryCache.prepareProgram(getContext(), programID);
+
   // attach the shaders and link them
   getContext().attachShader(programID, vertexShaderID);
   getContext().attachShader(programID, fragmentShaderID);
@@ -97,11 +203,10 @@ void ShaderStages::createRenderProgram(Result* result) {
     return;
   }
 
+  binaryCache.store(getContext(), binaryKey, programID);
+
   // now that the program successfully linked, set the program
-  if (programID_ != 0) {
-    getContext().deleteProgram(programID_);
-  }
-  programID_ = programID;
+  setProgram(programID);
 
   Result::setResult(result, Result::Code::Ok);
 }
@@ -132,6 +237,15 @@ void ShaderStages::createComputeProgram(Result* result) {
     return;
   }
 
+  ProgramBinaryCache& binaryCache = getContext().getProgramBinaryCache();
+  const size_t binaryKey = getProgramBinaryKey();
+  if (binaryCache.load(getContext(), binaryKey, programID)) {
+    setProgram(programID);
+    Result::setResult(result, Result::Code::Ok);
+    return;
+  }
+  binaryCache.prepareProgram(getContext(), programID);
+
   // attach the shaders and link them
   getContext().attachShader(programID, shaderID);
   getContext().linkProgram(programID);
@@ -160,13 +274,32 @@ void ShaderStages::createComputeProgram(Result* result) {
     return;
   }
 
+  binaryCache.store(getContext(), binaryKey, programID);
+
   // now that the program successfully linked, set the program
+  setProgram(programID);
+
+  Result::setResult(result, Result::Code::Ok);
+}
+
+size_t ShaderStages::getProgramBinaryKey() const {
+  const auto hashModule = [](const std::shared_ptr<IShaderModule>& module) -> size_t {
+    return module ? static_cast<const ShaderModule&>(*module).getHash() : 0;
+  };
+  size_t key = std::hash<int>()(static_cast<int>(getType()));
+  for (const size_t hash : {hashModule(getVertexModule()),
+                            hashModule(getFragmentModule()),
+                            hashModule(getComputeModule())}) {
+    key ^= hash + 0x9e3779b9 + (key << 6) + (key >> 2);
+  }
+  return key;
+}
+
+void ShaderStages::setProgram(GLuint programID) {
   if (programID_ != 0) {
     getContext().deleteProgram(programID_);
   }
   programID_ = programID;
-
-  Result::setResult(result, Result::Code::Ok);
 }
 
 // link the given shaders into this shader program
@@ -195,14 +328,29 @@ ShaderModule::ShaderModule(IContext& context, ShaderModuleInfo info) :
   WithContext(context), IShaderModule(std::move(info)) {}
 
 ShaderModule::~ShaderModule() {
-  if (getContext().isDestructionAllowed() && shaderID_ != 0) {
-    getContext().deleteShader(shaderID_);
-    shaderID_ = 0;
+  if (getContext().isDestructionAllowed()) {
+    if (shaderID_ != 0) {
+      getContext().deleteShader(shaderID_);
+      shaderID_ = 0;
+    }
+    if (pendingShaderID_ != 0) {
+      getContext().deleteShader(pendingShaderID_);
+      pendingShaderID_ = 0;
+    }
   }
 }
 
 // compile the shader from the given src shader code
 Result ShaderModule::create(const ShaderModuleDesc& desc) {
+  Result result = compile(desc);
+  if (!result.isOk()) {
+    return result;
+  }
+  return finishCompile();
+}
+
+Result ShaderModule::compile(const ShaderModuleDesc& desc) {
+  IGL_ASSERT_MSG(pendingShaderID_ == 0, "A compilation is already in flight");
   if (desc.input.type == ShaderInputType::Binary) {
     IGL_ASSERT_NOT_IMPLEMENTED();
     return Result(Result::Code::Unimplemented);
@@ -233,6 +381,14 @@ Result ShaderModule::create(const ShaderModuleDesc& desc) {
     return Result(Result::Code::ArgumentInvalid, "Unknown shader type");
   }
 
+  const auto& constants = desc.info.specializationConstants;
+  for (const auto& constant : constants) {
+    if (constant.name.empty()) {
+      return Result(Result::Code::ArgumentInvalid,
+                    "Specialization constants need a name on OpenGL");
+    }
+  }
+
   // always create a new temp shader ID
   // we'll set or update this object's shader ID after the compilation succeeds
   // otherwise we won't modify this shader
@@ -241,6 +397,39 @@ Result ShaderModule::create(const ShaderModuleDesc& desc) {
   // compile the shader
   const GLchar* src = (GLchar*)desc.input.source;
 
+  // push constants are emulated with a uniform block, see kPushConstantsBindingIndex
+  std::string remappedSource;
+  pushConstantBlockName_.clear();
+  if (getContext().deviceFeatures().hasFeature(DeviceFeatures::PushConstants) &&
+      strstr(src, "push_constant") != nullptr) {
+    remappedSource = src;
+    pushConstantBlockName_ = remapPushConstantBlock(remappedSource);
+    src = remappedSource.c_str();
+  }
+
+  if (!constants.empty()) {
+    if (src != remappedSource.c_str()) {
+      remappedSource = src;
+    }
+    defineSpecializationConstants(remappedSource, constants);
+    src = remappedSource.c_str();
+  }
+
+  if (desc.info.stage == ShaderStage::Fragment && desc.input.options.relaxedPrecisionEnabled &&
+      DeviceFeatureSet::usesOpenGLES()) {
+    if (src != remappedSource.c_str()) {
+      remappedSource = src;
+    }
+    std::string names;
+    for (const std::string& name : relaxFragmentPrecision(remappedSource)) {
+      names += (names.empty() ? "" : ", ") + name;
+    }
+    src = remappedSource.c_str();
+    IGL_LOG_INFO("Relaxed the precision of shader '%s' (declarations: %s)\n",
+                 desc.debugName.c_str(),
+                 names.c_str());
+  }
+
 #if IGL_SHADER_DUMP
   auto hash = std::hash<const GLchar*>()(src);
   std::string shaderStageExt;
@@ -272,6 +461,28 @@ Result ShaderModule::create(const ShaderModuleDesc& desc) {
   getContext().shaderSource(shaderID, 1, &src, nullptr);
   getContext().compileShader(shaderID);
 
+  // querying the status waits for the compilation: leave it to finishCompile()
+  pendingShaderID_ = shaderID;
+  pendingSource_ = src;
+  pendingHash_ =
+      std::hash<std::string_view>()(std::string_view(desc.input.source, strlen(desc.input.source)));
+  // different specializations are different programs for ProgramBinaryCache
+  for (const auto& constant : constants) {
+    hashCombine(pendingHash_, std::hash<ShaderSpecializationConstant>()(constant));
+  }
+
+  return Result();
+}
+
+Result ShaderModule::finishCompile() {
+  if (!IGL_VERIFY(pendingShaderID_ != 0)) {
+    return Result(Result::Code::InvalidOperation, "No compilation in flight");
+  }
+  const GLuint shaderID = pendingShaderID_;
+  pendingShaderID_ = 0;
+  const std::string src = std::move(pendingSource_);
+  pendingSource_.clear();
+
   // see if the compilation succeeded
   GLint status;
   getContext().getShaderiv(shaderID, GL_COMPILE_STATUS, &status);
@@ -289,7 +500,7 @@ Result ShaderModule::create(const ShaderModuleDesc& desc) {
     IGL_LOG_ERROR("failed to compile %s shader:\n%s\nSource\n%s",
                   (shaderType_ == GL_VERTEX_SHADER ? "vertex" : "fragment"),
                   errorLog.c_str(),
-                  src);
+                  src.c_str());
 
     // Delete shader to make sure that we don't have dangling resources
     getContext().deleteShader(shaderID);
@@ -303,9 +514,7 @@ Result ShaderModule::create(const ShaderModuleDesc& desc) {
     getContext().deleteShader(shaderID_);
   }
   shaderID_ = shaderID;
-
-  hash_ =
-      std::hash<std::string_view>()(std::string_view(desc.input.source, strlen(desc.input.source)));
+  hash_ = pendingHash_;
 
   return Result();
 }
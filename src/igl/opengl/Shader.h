@@ -14,6 +14,8 @@
 #include <igl/Shader.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/UniformAdapter.h>
+#include <string>
 #include <unordered_map>
 
 namespace igl {
@@ -27,6 +29,12 @@ class ShaderModule : public WithContext, public IShaderModule {
   ~ShaderModule() override;
   Result create(const ShaderModuleDesc& desc);
 
+  // create() split in two: compile() only issues the compilation and finishCompile() waits for it
+  // and checks its status. Compiling a batch of shaders before checking any lets the driver
+  // compile them in the background (see GL_KHR_parallel_shader_compile).
+  Result compile(const ShaderModuleDesc& desc);
+  Result finishCompile();
+
   inline GLenum getShaderType() const {
     return shaderType_;
   }
@@ -39,6 +47,12 @@ class ShaderModule : public WithContext, public IShaderModule {
     return hash_;
   }
 
+  // Name of the uniform block which replaced the `layout(push_constant)` block of the source, or
+  // an empty string if the shader does not use push constants
+  inline const std::string& getPushConstantBlockName() const {
+    return pushConstantBlockName_;
+  }
+
   ShaderModule(IContext& context, ShaderModuleInfo info);
 
  private:
@@ -50,6 +64,13 @@ class ShaderModule : public WithContext, public IShaderModule {
 
   // Hash of the shader source
   size_t hash_ = 0;
+
+  // The compilation issued by compile() and not finished yet
+  GLuint pendingShaderID_ = 0;
+  std::string pendingSource_;
+  size_t pendingHash_ = 0;
+
+  std::string pushConstantBlockName_;
 };
 
 class ShaderStages final : public IShaderStages, public WithContext {
@@ -68,12 +89,22 @@ class ShaderStages final : public IShaderStages, public WithContext {
     return programID_;
   }
 
+  UniformValueCache& uniformValueCache() {
+    return uniformValueCache_;
+  }
+
  private:
   void createRenderProgram(Result* result);
   void createComputeProgram(Result* result);
+  // key of the program in the ProgramBinaryCache
+  size_t getProgramBinaryKey() const;
+  void setProgram(GLuint programID);
 
   // the GL shader program ID
   GLuint programID_;
+
+  // values of the program's default uniform block as last uploaded by UniformAdapter
+  UniformValueCache uniformValueCache_;
 };
 
 } // namespace opengl
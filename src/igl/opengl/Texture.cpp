@@ -12,6 +12,8 @@
 #include <igl/opengl/CommandBuffer.h>
 #include <igl/opengl/Device.h>
 #include <igl/opengl/Errors.h>
+#include <igl/opengl/Framebuffer.h>
+#include <igl/opengl/Readback.h>
 #include <igl/opengl/util/TextureFormat.h>
 
 namespace igl {
@@ -52,6 +54,89 @@ uint64_t Texture::getTextureId() const {
   return 0;
 }
 
+std::shared_ptr<IReadback> Texture::readAsync(ICommandQueue& cmdQueue,
+                                              const TextureRangeDesc& range,
+                                              Result* outResult) const {
+  const auto& features = getContext().deviceFeatures();
+  if (!features.hasInternalFeature(InternalFeatures::PixelBufferObject) ||
+      !features.hasFeature(DeviceFeatures::MapBufferRange)) {
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "Pixel buffer objects are not supported");
+    return nullptr;
+  }
+  // glReadPixels() only reads GL_RGBA / GL_UNSIGNED_BYTE everywhere
+  if (getFormat() != TextureFormat::RGBA_UNorm8 && getFormat() != TextureFormat::RGBA_SRGB) {
+    Result::setResult(outResult, Result::Code::Unsupported, "The texture cannot be read back");
+    return nullptr;
+  }
+  const auto rangeResult = validateRange(range);
+  if (!rangeResult.isOk()) {
+    Result::setResult(outResult, rangeResult);
+    return nullptr;
+  }
+  if (range.numLayers != 1 || range.numMipLevels != 1 || range.depth != 1) {
+    Result::setResult(outResult,
+                      Result::Code::ArgumentInvalid,
+                      "Readbacks cover one 2D region of one layer and mip level");
+    return nullptr;
+  }
+
+  const size_t size = getProperties().getBytesPerRange(range);
+  GLuint pixelBuffer = 0;
+  auto& context = getContext();
+  {
+    FramebufferBindingGuard guard(context);
+
+    const GLenum target = features.hasFeature(DeviceFeatures::ReadWriteFramebuffer)
+                              ? GL_READ_FRAMEBUFFER
+                              : GL_FRAMEBUFFER;
+    GLuint framebuffer = 0;
+    context.genFramebuffers(1, &framebuffer);
+    context.bindFramebuffer(target, framebuffer);
+    AttachmentParams params{};
+    params.mipLevel = static_cast<uint32_t>(range.mipLevel);
+    params.layer = static_cast<uint32_t>(range.layer);
+    params.read = true;
+    auto& mutableTexture = const_cast<Texture&>(*this);
+    mutableTexture.attachAsColor(0, params);
+    const bool isComplete = context.checkFramebufferStatus(target) == GL_FRAMEBUFFER_COMPLETE;
+
+    if (isComplete) {
+      context.genBuffers(1, &pixelBuffer);
+      context.bindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+      context.bufferData(
+          GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_READ);
+      // rows are tightly packed
+      context.pixelStorei(GL_PACK_ALIGNMENT, 1);
+      // with a pixel pack buffer bound, the copy is queued and the pointer is an offset
+      context.readPixels(static_cast<GLint>(range.x),
+                         static_cast<GLint>(range.y),
+                         static_cast<GLsizei>(range.width),
+                         static_cast<GLsizei>(range.height),
+                         GL_RGBA,
+                         GL_UNSIGNED_BYTE,
+                         nullptr);
+      context.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    mutableTexture.detachAsColor(0, true);
+    context.deleteFramebuffers(1, &framebuffer);
+
+    if (!isComplete) {
+      Result::setResult(outResult, Result::Code::RuntimeError, "The texture cannot be attached");
+      return nullptr;
+    }
+  }
+
+  // signaled once glReadPixels() is done
+  auto fence = cmdQueue.signalFence(outResult);
+  if (!fence) {
+    context.deleteBuffers(1, &pixelBuffer);
+    return nullptr;
+  }
+  return std::make_shared<Readback>(context, pixelBuffer, size, std::move(fence));
+}
+
 Result Texture::create(const TextureDesc& desc, bool hasStorageAlready) {
   Result result;
   if (desc.numLayers > 1 && desc.type != TextureType::TwoDArray) {
@@ -76,6 +161,7 @@ Result Texture::create(const TextureDesc& desc, bool hasStorageAlready) {
     numLayers_ = desc.numLayers;
     numSamples_ = desc.numSamples;
     numMipLevels_ = desc.numMipLevels;
+    isMemoryless_ = desc.storage == ResourceStorage::Memoryless;
     if (!getContext().deviceFeatures().hasFeature(DeviceFeatures::TexturePartialMipChain)) {
       // For ES 2.0, we have to ignore numMipLevels_
       const auto maxNumMipLevels = TextureDesc::calcNumMipLevels(width_, height_);
@@ -130,6 +216,12 @@ Result Texture::upload(const TextureRangeDesc& /*range*/,
   return Result(Result::Code::Unsupported, "Texture::upload()");
 }
 
+Result Texture::uploadFromBuffer(const TextureRangeDesc& /*range*/,
+                                 GLuint /*buffer*/,
+                                 size_t /*bufferOffset*/) const {
+  return Result(Result::Code::Unsupported, "Texture::uploadFromBuffer()");
+}
+
 Result Texture::uploadCube(const TextureRangeDesc& /*range*/,
                            TextureCubeFace /*face*/,
                            const void* /*data*/,
@@ -923,6 +1015,11 @@ bool Texture::toFormatDescGL(IContext& ctx,
       internalFormat = GL_DEPTH_STENCIL;
     }
     return true;
+
+  case TextureFormat::YUV_NV12:
+  case TextureFormat::YUV_P010:
+    // Multi-planar formats are only sampled as external images imported from native buffers
+    return false;
   }
 
   return false;
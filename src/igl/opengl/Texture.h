@@ -39,9 +39,18 @@ class Texture : public WithContext, public ITexture {
   uint32_t getNumMipLevels() const override;
   bool isRequiredGenerateMipmap() const override;
   uint64_t getTextureId() const override;
+  std::shared_ptr<IReadback> readAsync(ICommandQueue& cmdQueue,
+                                       const TextureRangeDesc& range,
+                                       Result* outResult) const override;
 
   virtual Result create(const TextureDesc& desc, bool hasStorageAlready);
 
+  // uploads `range` from the buffer object `buffer`, starting at `bufferOffset`, where the texels
+  // are tightly packed; see ICommandBuffer::copyBufferToTexture()
+  virtual Result uploadFromBuffer(const TextureRangeDesc& range,
+                                  GLuint buffer,
+                                  size_t bufferOffset) const;
+
   // bind this as a source texture for rendering from
   virtual void bind() = 0;
   virtual void bindImage(size_t unit) = 0;
@@ -53,6 +62,9 @@ class Texture : public WithContext, public ITexture {
     uint32_t layer; // Array texture layer
     bool read;
     bool stereo;
+    // GL_EXT_multisampled_render_to_texture: if non-zero, the single-sampled texture is rendered
+    // to with this many samples, which are resolved into it implicitly
+    uint32_t implicitResolveSamples;
   };
 
   // frame buffer attachments
@@ -63,6 +75,19 @@ class Texture : public WithContext, public ITexture {
 
   virtual bool isImplicitStorage() const;
 
+  // memoryless attachments are discarded at the end of every render pass
+  bool isMemoryless() const {
+    return isMemoryless_;
+  }
+
+  // set when the last render pass which used this attachment did not store it
+  bool areContentsDiscarded() const {
+    return areContentsDiscarded_;
+  }
+  void setContentsDiscarded(bool discarded) const {
+    areContentsDiscarded_ = discarded;
+  }
+
   [[nodiscard]] GLenum toGLTarget(TextureType type, size_t samples = 1) const;
   static TextureFormat glInternalFormatToTextureFormat(GLuint glTexInternalFormat,
                                                        GLuint glTexFormat,
@@ -82,6 +107,11 @@ class Texture : public WithContext, public ITexture {
     return samplerHash_;
   }
 
+  // set once the texture has a bindless handle, which freezes its sampling parameters
+  bool hasBindlessHandle() const {
+    return hasBindlessHandle_;
+  }
+
   GLenum getGLInternalTextureFormat() const {
     IGL_ASSERT(glInternalFormat_ != 0);
     return glInternalFormat_;
@@ -126,6 +156,7 @@ class Texture : public WithContext, public ITexture {
   GLenum glInternalFormat_;
   uint32_t numMipLevels_ = 1;
   TextureType type_ = TextureType::Invalid;
+  mutable bool hasBindlessHandle_ = false;
 
  private:
   size_t samplerHash_ = std::numeric_limits<size_t>::max();
@@ -135,6 +166,8 @@ class Texture : public WithContext, public ITexture {
   GLsizei numLayers_ = 1;
   uint32_t numSamples_ = 1;
   bool isCreated_ = false;
+  bool isMemoryless_ = false;
+  mutable bool areContentsDiscarded_ = false;
 };
 
 } // namespace opengl
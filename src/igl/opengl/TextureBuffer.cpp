@@ -9,6 +9,7 @@
 
 #include <array>
 #include <igl/opengl/Errors.h>
+#include <limits>
 #include <utility>
 
 namespace igl {
@@ -45,6 +46,7 @@ TextureBuffer::~TextureBuffer() {
   GLuint textureID = getId();
   if (textureID != 0) {
     if (textureHandle_ != 0) {
+      getContext().getBindlessTable().releaseTextureSlot(getContext(), bindlessSlot_);
       getContext().makeTextureHandleNonResident(textureHandle_);
     }
     getContext().deleteTextures({textureID});
@@ -53,11 +55,29 @@ TextureBuffer::~TextureBuffer() {
 
 uint64_t TextureBuffer::getTextureId() const {
   if (textureHandle_ == 0) {
+    if (!getContext().deviceFeatures().hasFeature(DeviceFeatures::TextureBindless)) {
+      return 0;
+    }
+    // the handle captures the sampling parameters: those of the last SamplerState the texture was
+    // drawn with, or linear filtering if there was none
+    if (getSamplerHash() == std::numeric_limits<size_t>::max()) {
+      const GLenum target = getTarget();
+      getContext().bindTexture(target, getId());
+      getContext().texParameteri(
+          target,
+          GL_TEXTURE_MIN_FILTER,
+          getNumMipLevels() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+      getContext().texParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      getContext().bindTexture(target, 0);
+    }
     textureHandle_ = getContext().getTextureHandle(getId());
     IGL_ASSERT(textureHandle_);
     getContext().makeTextureHandleResident(textureHandle_);
+    hasBindlessHandle_ = true;
+    auto& bindlessTable = getContext().getBindlessTable();
+    bindlessSlot_ = bindlessTable.acquireTextureSlot(getContext(), textureHandle_);
   }
-  return textureHandle_;
+  return bindlessSlot_;
 }
 
 // create a 2D texture given the specified dimensions and format
@@ -118,6 +138,9 @@ Result TextureBuffer::createTexture(const TextureDesc& desc) {
   }
 
   glInternalFormat_ = formatDescGL_.internalFormat;
+  allowViews_ = desc.allowFormatViews &&
+                getContext().deviceFeatures().hasInternalFeature(InternalFeatures::TexStorage) &&
+                getContext().deviceFeatures().hasInternalFeature(InternalFeatures::TextureView);
 
   // create the GL texture ID
   GLuint textureID;
@@ -134,6 +157,63 @@ Result TextureBuffer::createTexture(const TextureDesc& desc) {
   }
 }
 
+Result TextureBuffer::createView(const TextureBuffer& texture,
+                                const TextureViewDesc& desc,
+                                const TextureDesc& viewDesc) {
+  // glTextureView only accepts textures with immutable storage
+  if (!texture.supportsTexStorage()) {
+    return Result(Result::Code::Unsupported,
+                  "Texture views need storage textures or TextureDesc::allowFormatViews");
+  }
+  Result result = Super::create(viewDesc, false);
+  if (!result.isOk()) {
+    return result;
+  }
+  const auto target = toGLTarget(viewDesc.type, viewDesc.numSamples);
+  if (target == 0) {
+    return Result(Result::Code::Unsupported, "Unsupported texture target");
+  }
+  const auto usageForFormat = (viewDesc.usage & TextureDesc::TextureUsageBits::Storage) == 0
+                                  ? viewDesc.usage | TextureDesc::TextureUsageBits::Sampled
+                                  : viewDesc.usage;
+  if (!toFormatDescGL(viewDesc.format, usageForFormat, formatDescGL_)) {
+    return Result(Result::Code::ArgumentInvalid, "Invalid texture format");
+  }
+  glInternalFormat_ = formatDescGL_.internalFormat;
+  // views are immutable like the textures they are created from
+  allowViews_ = true;
+
+  // glTextureView needs a texture name which has never been bound
+  GLuint textureID;
+  getContext().genTextures(1, &textureID);
+  setTextureBufferProperties(textureID, target);
+  setUsage(viewDesc.usage);
+
+  getContext().textureView(textureID,
+                           target,
+                           texture.getId(),
+                           glInternalFormat_,
+                           desc.mipLevel,
+                           desc.numMipLevels,
+                           desc.layer,
+                           desc.numLayers);
+  result = getContext().getLastError();
+  if (!result.isOk()) {
+    return result;
+  }
+
+  getContext().bindTexture(target, textureID);
+  setMaxMipLevel();
+  if (getNumMipLevels() == 1) { // Change default min filter to ensure mipmapping is disabled
+    getContext().texParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  }
+  if (!getProperties().isCompressed()) {
+    swapTextureChannelsForFormat(getContext(), target, getFormat());
+  }
+  getContext().bindTexture(target, 0);
+  return Result{};
+}
+
 Result TextureBuffer::initialize() const {
   const auto target = getTarget();
   if (target == 0) {
@@ -523,6 +603,7 @@ Result TextureBuffer::upload3D(GLenum target,
 Result TextureBuffer::upload(const TextureRangeDesc& range,
                              const void* data,
                              size_t bytesPerRow) const {
+  IGL_PROFILER_FUNCTION();
   if (data == nullptr) {
     return Result{};
   }
@@ -542,6 +623,7 @@ Result TextureBuffer::upload(GLenum target,
                              const TextureRangeDesc& range,
                              const void* data,
                              size_t bytesPerRow) const {
+  IGL_PROFILER_FUNCTION();
   if (range.numMipLevels > 1) {
     IGL_ASSERT_NOT_IMPLEMENTED();
     return Result(Result::Code::Unimplemented,
@@ -549,6 +631,8 @@ Result TextureBuffer::upload(GLenum target,
   }
 
   getContext().pixelStorei(GL_UNPACK_ALIGNMENT, this->getAlignment(bytesPerRow, range.mipLevel));
+  getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::UploadedBytes,
+                                               getProperties().getBytesPerRange(range));
 
   Result success;
   switch (type_) {
@@ -584,6 +668,7 @@ Result TextureBuffer::uploadCube(const TextureRangeDesc& range,
                                  TextureCubeFace face,
                                  const void* data,
                                  size_t bytesPerRow) const {
+  IGL_PROFILER_FUNCTION();
   if (data == nullptr) {
     return Result{};
   }
@@ -600,6 +685,8 @@ Result TextureBuffer::uploadCube(const TextureRangeDesc& range,
   }
 
   getContext().pixelStorei(GL_UNPACK_ALIGNMENT, this->getAlignment(bytesPerRow, range.mipLevel));
+  getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::UploadedBytes,
+                                               getProperties().getBytesPerRange(range));
   getContext().bindTexture(target, getId());
 
   IGL_ASSERT(range.numMipLevels == 1);
@@ -613,6 +700,95 @@ Result TextureBuffer::uploadCube(const TextureRangeDesc& range,
   return Result();
 }
 
+Result TextureBuffer::uploadFromBuffer(const TextureRangeDesc& range,
+                                       GLuint buffer,
+                                       size_t bufferOffset) const {
+  IGL_PROFILER_FUNCTION();
+  const auto result = validateRange(range);
+  if (!result.isOk()) {
+    return result;
+  }
+  if (range.numMipLevels != 1 ||
+      (type_ != TextureType::TwoD && type_ != TextureType::TwoDArray &&
+       type_ != TextureType::ThreeD)) {
+    return Result(Result::Code::Unsupported,
+                  "Only one mip level of a 2D, 2D array or 3D texture can be copied");
+  }
+  const auto target = getTarget();
+  const bool is2D = type_ == TextureType::TwoD;
+  const auto z = static_cast<GLint>(type_ == TextureType::ThreeD ? range.z : range.layer);
+  const auto depth =
+      static_cast<GLsizei>(type_ == TextureType::ThreeD ? range.depth : range.numLayers);
+  const auto numBytes = static_cast<GLsizei>(getProperties().getBytesPerRange(range));
+  // with an unpack buffer bound, the data pointer is an offset into it
+  const void* data = reinterpret_cast<const void*>(bufferOffset);
+
+  getContext().bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+  getContext().pixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  getContext().bindTexture(target, getId());
+  if (!getProperties().isCompressed()) {
+    if (is2D) {
+      getContext().texSubImage2D(target,
+                                 (GLint)range.mipLevel,
+                                 (GLint)range.x,
+                                 (GLint)range.y,
+                                 (GLsizei)range.width,
+                                 (GLsizei)range.height,
+                                 formatDescGL_.format,
+                                 formatDescGL_.type,
+                                 data);
+    } else {
+      getContext().texSubImage3D(target,
+                                 (GLint)range.mipLevel,
+                                 (GLint)range.x,
+                                 (GLint)range.y,
+                                 z,
+                                 (GLsizei)range.width,
+                                 (GLsizei)range.height,
+                                 depth,
+                                 formatDescGL_.format,
+                                 formatDescGL_.type,
+                                 data);
+    }
+  } else if (is2D && isValidForTexImage(range) && !supportsTexStorage()) {
+    // compressed textures without immutable storage may not be allocated yet
+    getContext().compressedTexImage2D(target,
+                                      (GLint)range.mipLevel,
+                                      formatDescGL_.internalFormat,
+                                      (GLsizei)range.width,
+                                      (GLsizei)range.height,
+                                      0, // border
+                                      numBytes,
+                                      data);
+  } else if (is2D) {
+    getContext().compressedTexSubImage2D(target,
+                                         (GLint)range.mipLevel,
+                                         (GLint)range.x,
+                                         (GLint)range.y,
+                                         (GLsizei)range.width,
+                                         (GLsizei)range.height,
+                                         formatDescGL_.internalFormat,
+                                         numBytes,
+                                         data);
+  } else {
+    getContext().compressedTexSubImage3D(target,
+                                         (GLint)range.mipLevel,
+                                         (GLint)range.x,
+                                         (GLint)range.y,
+                                         z,
+                                         (GLsizei)range.width,
+                                         (GLsizei)range.height,
+                                         depth,
+                                         formatDescGL_.internalFormat,
+                                         numBytes,
+                                         data);
+  }
+  getContext().bindTexture(target, 0);
+  getContext().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  getContext().getFrameStatisticsTracker().add(FrameStatisticsTracker::UploadedBytes, numBytes);
+  return getContext().getLastError();
+}
+
 bool TextureBuffer::canInitialize() const {
   return !getProperties().isCompressed() ||
          (supportsTexStorage() && getContext().deviceFeatures().hasTextureFeature(
@@ -622,6 +798,9 @@ bool TextureBuffer::canInitialize() const {
 }
 
 bool TextureBuffer::supportsTexStorage() const {
+  if (allowViews_) {
+    return true;
+  }
   return (getUsage() & TextureDesc::TextureUsageBits::Storage) != 0 &&
          contains(getContext().deviceFeatures().getTextureFormatCapabilities(getFormat()),
                   ICapabilities::TextureFormatCapabilityBits::Storage);
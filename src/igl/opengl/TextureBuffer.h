@@ -31,9 +31,18 @@ class TextureBuffer : public TextureBufferBase {
 
   // Texture overrides
   Result create(const TextureDesc& desc, bool hasStorageAlready) override;
+  Result uploadFromBuffer(const TextureRangeDesc& range,
+                          GLuint buffer,
+                          size_t bufferOffset) const override;
   void bindImage(size_t unit) override;
   uint64_t getTextureId() const override;
 
+  // Creates a view of `texture` with glTextureView. `viewDesc` is the descriptor returned by
+  // ITexture::validateView().
+  Result createView(const TextureBuffer& texture,
+                    const TextureViewDesc& desc,
+                    const TextureDesc& viewDesc);
+
  protected:
   Result initialize() const;
   Result initializeWithUpload() const;
@@ -57,6 +66,9 @@ class TextureBuffer : public TextureBufferBase {
   bool canInitialize() const;
   bool supportsTexStorage() const;
   mutable uint64_t textureHandle_ = 0;
+  // textures which can be viewed are allocated with immutable storage
+  bool allowViews_ = false;
+  mutable uint32_t bindlessSlot_ = 0;
 };
 
 } // namespace opengl
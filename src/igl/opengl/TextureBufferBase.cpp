@@ -72,7 +72,8 @@ void TextureBufferBase::attach(GLenum attachment,
   if (getContext().deviceFeatures().hasFeature(DeviceFeatures::ReadWriteFramebuffer)) {
     framebufferTarget = params.read ? GL_READ_FRAMEBUFFER : GL_DRAW_FRAMEBUFFER;
   }
-  const auto numSamples = getSamples();
+  const auto numSamples = params.implicitResolveSamples ? params.implicitResolveSamples
+                                                        : getSamples();
   const auto numLayers = getNumLayers();
 
   if (numSamples > 1) {
@@ -89,8 +90,12 @@ void TextureBufferBase::attach(GLenum attachment,
                                                           0,
                                                           2);
     } else {
-      getContext().framebufferTexture2DMultisample(
-          framebufferTarget, attachment, target, textureID, params.mipLevel, getSamples());
+      getContext().framebufferTexture2DMultisample(framebufferTarget,
+                                                   attachment,
+                                                   target,
+                                                   textureID,
+                                                   params.mipLevel,
+                                                   static_cast<GLsizei>(numSamples));
     }
   } else {
     if (params.stereo) {
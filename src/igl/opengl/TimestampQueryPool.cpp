@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/TimestampQueryPool.h>
+
+#include <igl/opengl/IContext.h>
+
+namespace igl {
+namespace opengl {
+
+TimestampQueryPool::TimestampQueryPool(IContext& context, const TimestampQueryPoolDesc& desc) :
+  WithContext(context), queries_(desc.count, 0) {
+  if (!queries_.empty()) {
+    context.genQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+  }
+}
+
+TimestampQueryPool::~TimestampQueryPool() {
+  if (!queries_.empty()) {
+    getContext().deleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+  }
+}
+
+uint32_t TimestampQueryPool::getCount() const {
+  return static_cast<uint32_t>(queries_.size());
+}
+
+GLuint TimestampQueryPool::getId(uint32_t queryIndex) const {
+  IGL_ASSERT(queryIndex < queries_.size());
+  return queries_[queryIndex];
+}
+
+bool TimestampQueryPool::getResults(uint32_t firstQuery,
+                                    uint32_t queryCount,
+                                    uint64_t* outTimestampsNs) {
+  if (!IGL_VERIFY(static_cast<size_t>(firstQuery) + queryCount <= queries_.size()) ||
+      !IGL_VERIFY(outTimestampsNs != nullptr)) {
+    return false;
+  }
+
+  auto& context = getContext();
+  for (uint32_t i = 0; i < queryCount; ++i) {
+    GLuint available = GL_FALSE;
+    context.getQueryObjectuiv(queries_[firstQuery + i], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+      return false;
+    }
+  }
+
+  if (context.deviceFeatures().hasExtension(Extensions::DisjointTimerQuery)) {
+    // A disjoint operation (e.g. a GPU frequency change) makes all pending timestamps meaningless
+    GLint disjoint = GL_FALSE;
+    context.getIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+    if (disjoint != GL_FALSE) {
+      return false;
+    }
+  }
+
+  for (uint32_t i = 0; i < queryCount; ++i) {
+    GLuint64 timestamp = 0;
+    context.getQueryObjectui64v(queries_[firstQuery + i], GL_QUERY_RESULT, &timestamp);
+    outTimestampsNs[i] = static_cast<uint64_t>(timestamp);
+  }
+  return true;
+}
+
+} // namespace opengl
+} // namespace igl
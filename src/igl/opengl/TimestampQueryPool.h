@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/TimestampQueryPool.h>
+#include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/WithContext.h>
+#include <vector>
+
+namespace igl {
+namespace opengl {
+
+/// One GL query object per timestamp, written with glQueryCounter(GL_TIMESTAMP).
+class TimestampQueryPool final : public WithContext, public ITimestampQueryPool {
+ public:
+  TimestampQueryPool(IContext& context, const TimestampQueryPoolDesc& desc);
+  ~TimestampQueryPool() override;
+
+  [[nodiscard]] uint32_t getCount() const override;
+  bool getResults(uint32_t firstQuery, uint32_t queryCount, uint64_t* outTimestampsNs) override;
+
+  [[nodiscard]] GLuint getId(uint32_t queryIndex) const;
+
+ private:
+  std::vector<GLuint> queries_;
+};
+
+} // namespace opengl
+} // namespace igl
@@ -10,9 +10,40 @@
 #include <igl/opengl/UniformAdapter.h>
 #include <igl/opengl/UniformBuffer.h>
 
+#include <cstring>
+
 namespace igl {
 namespace opengl {
 
+bool UniformValueCache::update(const UniformDesc& desc, const uint8_t* data, size_t length) {
+  const auto location = static_cast<size_t>(desc.location);
+  if (location >= entries_.size()) {
+    entries_.resize(location + 1);
+  }
+
+  auto& entry = entries_[location];
+  if (entry.type == desc.type && entry.numElements == desc.numElements &&
+      entry.data.size() == length && memcmp(entry.data.data(), data, length) == 0) {
+    return false;
+  }
+
+  entry.type = desc.type;
+  entry.numElements = desc.numElements;
+  entry.data.assign(data, data + length);
+
+  return true;
+}
+
+void UniformValueCache::invalidate(int location) {
+  if (location >= 0 && static_cast<size_t>(location) < entries_.size()) {
+    entries_[location] = Entry();
+  }
+}
+
+void UniformValueCache::clear() {
+  entries_.clear();
+}
+
 UniformAdapter::UniformAdapter(const IContext& context, PipelineType type) : pipelineType_(type) {
   const auto& deviceFeatures = context.deviceFeatures();
   maxUniforms_ = deviceFeatures.getMaxComputeUniforms();
@@ -122,7 +153,7 @@ void UniformAdapter::setUniform(const UniformDesc& uniformDesc,
 #endif // IGL_DEBUG
 
   IGL_ASSERT(uniforms_.size() < maxUniforms_);
-  uniforms_.emplace_back(uniformDesc, dataOffset);
+  uniforms_.emplace_back(uniformDesc, dataOffset, length);
   Result::setOk(outResult);
 }
 
@@ -130,12 +161,46 @@ void UniformAdapter::setUniformBuffer(const std::shared_ptr<IBuffer>& buffer,
                                       size_t offset,
                                       int bindingIndex,
                                       Result* outResult) {
+  IGL_ASSERT_MSG(buffer, "invalid buffer passed to setUniformBuffer");
+  if (!buffer) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid);
+    return;
+  }
+  setUniformBuffer(*buffer, offset, bindingIndex, outResult);
+  if (bindingIndex >= 0 && bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX) {
+    uniformBufferBindingMap_[bindingIndex].owner = buffer;
+  }
+}
+
+void UniformAdapter::setUniformBuffer(IBuffer& buffer,
+                                      size_t offset,
+                                      int bindingIndex,
+                                      Result* outResult) {
   IGL_ASSERT_MSG(bindingIndex >= 0, "invalid bindingIndex passed to setUniformBuffer");
   IGL_ASSERT_MSG(bindingIndex <= IGL_UNIFORM_BLOCKS_BINDING_MAX,
                  "Uniform buffer index is beyond max");
-  IGL_ASSERT_MSG(buffer, "invalid buffer passed to setUniformBuffer");
+  if (bindingIndex >= 0 && bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX) {
+    auto& binding = uniformBufferBindingMap_[bindingIndex];
+    binding.buffer = &buffer;
+    binding.offset = offset;
+    binding.owner = nullptr;
+    uniformBuffersDirtyMask_ |= 1 << bindingIndex;
+    Result::setOk(outResult);
+  } else {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid);
+  }
+}
+
+void UniformAdapter::setUniformBufferRange(GLuint buffer,
+                                           size_t offset,
+                                           size_t size,
+                                           int bindingIndex,
+                                           Result* outResult) {
+  IGL_ASSERT_MSG(bindingIndex >= 0, "invalid bindingIndex passed to setUniformBufferRange");
+  IGL_ASSERT_MSG(bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX,
+                 "Uniform buffer index is beyond max");
   if (bindingIndex >= 0 && bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX && buffer) {
-    uniformBufferBindingMap_[bindingIndex] = {buffer, offset};
+    uniformBufferBindingMap_[bindingIndex] = {nullptr, offset, nullptr, buffer, size};
     uniformBuffersDirtyMask_ |= 1 << bindingIndex;
     Result::setOk(outResult);
   } else {
@@ -143,13 +208,17 @@ void UniformAdapter::setUniformBuffer(const std::shared_ptr<IBuffer>& buffer,
   }
 }
 
-void UniformAdapter::bindToPipeline(IContext& context) {
+void UniformAdapter::bindToPipeline(IContext& context, UniformValueCache* valueCache) {
   // bind uniforms
   for (const auto& uniform : uniforms_) {
     const auto& uniformDesc = uniform.desc;
     IGL_ASSERT(uniformDesc.location >= 0);
     IGL_ASSERT_MSG(uniformData_.data(), "Uniform data must be non-null");
     auto start = uniformData_.data() + uniform.dataOffset;
+    if (valueCache && !valueCache->update(uniformDesc, start, uniform.length)) {
+      // the program already holds this value
+      continue;
+    }
     if (uniformDesc.numElements > 1 || uniformDesc.type == UniformType::Mat3x3) {
       IGL_ASSERT_MSG(uniformDesc.elementStride > 0,
                      "stride has to be larger than 0 for uniform at offset %zu",
@@ -170,15 +239,56 @@ void UniformAdapter::bindToPipeline(IContext& context) {
 #endif
 
   // bind uniform block buffers
-  for (size_t bindingIndex = 0; bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX; ++bindingIndex) {
-    if (uniformBuffersDirtyMask_ & (1 << bindingIndex)) {
-      auto uniformBinding = uniformBufferBindingMap_.at(bindingIndex);
-      auto* bufferState = static_cast<UniformBlockBuffer*>(uniformBinding.first.get());
-      IGL_ASSERT(bufferState);
-      if (uniformBinding.second) {
-        bufferState->bindRange(bindingIndex, uniformBinding.second, nullptr);
-      } else {
-        bufferState->bindBase(bindingIndex, nullptr);
+  if (uniformBuffersDirtyMask_ != 0 &&
+      context.deviceFeatures().hasInternalFeature(InternalFeatures::MultiBind)) {
+    // one call for each run of consecutive dirty binding points
+    GLuint buffers[IGL_UNIFORM_BLOCKS_BINDING_MAX];
+    GLintptr offsets[IGL_UNIFORM_BLOCKS_BINDING_MAX];
+    GLsizeiptr sizes[IGL_UNIFORM_BLOCKS_BINDING_MAX];
+    size_t first = 0;
+    size_t count = 0;
+    for (size_t bindingIndex = 0; bindingIndex <= IGL_UNIFORM_BLOCKS_BINDING_MAX; ++bindingIndex) {
+      if (bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX &&
+          (uniformBuffersDirtyMask_ & (1 << bindingIndex))) {
+        if (count == 0) {
+          first = bindingIndex;
+        }
+        const auto& uniformBinding = uniformBufferBindingMap_.at(bindingIndex);
+        if (!uniformBinding.buffer) {
+          buffers[count] = uniformBinding.rawBuffer;
+          offsets[count] = (GLintptr)uniformBinding.offset;
+          sizes[count] = (GLsizeiptr)uniformBinding.rawSize;
+        } else {
+          auto* bufferState = static_cast<UniformBlockBuffer*>(uniformBinding.buffer);
+          buffers[count] =
+              bufferState->getBindingRange(uniformBinding.offset, offsets[count], sizes[count]);
+        }
+        count++;
+      } else if (count > 0) {
+        context.bindBuffersRange(
+            GL_UNIFORM_BUFFER, (GLuint)first, (GLsizei)count, buffers, offsets, sizes);
+        count = 0;
+      }
+    }
+  } else {
+    for (size_t bindingIndex = 0; bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX; ++bindingIndex) {
+      if (uniformBuffersDirtyMask_ & (1 << bindingIndex)) {
+        const auto& uniformBinding = uniformBufferBindingMap_.at(bindingIndex);
+        if (!uniformBinding.buffer) {
+          context.bindBufferRange(GL_UNIFORM_BUFFER,
+                                  (GLuint)bindingIndex,
+                                  uniformBinding.rawBuffer,
+                                  (GLintptr)uniformBinding.offset,
+                                  (GLsizeiptr)uniformBinding.rawSize);
+          continue;
+        }
+        auto* bufferState = static_cast<UniformBlockBuffer*>(uniformBinding.buffer);
+        IGL_ASSERT(bufferState);
+        if (uniformBinding.offset) {
+          bufferState->bindRange(bindingIndex, uniformBinding.offset, nullptr);
+        } else {
+          bufferState->bindBase(bindingIndex, nullptr);
+        }
       }
     }
   }
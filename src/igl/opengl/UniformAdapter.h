@@ -9,6 +9,7 @@
 
 #include <igl/Buffer.h>
 #include <igl/Uniform.h>
+#include <igl/opengl/GLIncludes.h>
 
 #include <array>
 #include <unordered_map>
@@ -18,6 +19,31 @@ namespace igl {
 namespace opengl {
 class IContext;
 
+// Push constants are emulated with a uniform block: ShaderModule turns `layout(push_constant)`
+// blocks into std140 blocks, RenderPipelineState binds them to this reserved binding point and
+// RenderCommandAdapter streams the data through the context's UniformArena.
+constexpr int kPushConstantsBindingIndex = IGL_UNIFORM_BLOCKS_BINDING_MAX - 1;
+constexpr size_t kMaxPushConstantBytes = 128;
+
+// Last values uploaded with glUniform* for each location of a GL program. Uniform values are part
+// of the program object's state, so the owner of the program (ShaderStages) keeps one of these
+// around and UniformAdapter skips uploads that would not change anything.
+class UniformValueCache {
+ public:
+  // Returns true and records the new value if the location doesn't already hold these bytes
+  bool update(const UniformDesc& desc, const uint8_t* data, size_t length);
+  void invalidate(int location);
+  void clear();
+
+ private:
+  struct Entry {
+    UniformType type = UniformType::Invalid;
+    size_t numElements = 0;
+    std::vector<uint8_t> data;
+  };
+  std::vector<Entry> entries_;
+};
+
 class UniformAdapter {
  public:
   // Feel like this can be placed somewhere better
@@ -34,28 +60,49 @@ class UniformAdapter {
                         size_t offset,
                         int index,
                         Result* outResult);
+  // does not retain `buffer`, which has to stay alive until the next draw or dispatch
+  void setUniformBuffer(IBuffer& buffer, size_t offset, int index, Result* outResult);
+  // binds a range of a GL buffer which is not an IBuffer, e.g. of UniformArena
+  void setUniformBufferRange(GLuint buffer,
+                             size_t offset,
+                             size_t size,
+                             int index,
+                             Result* outResult);
 
   uint32_t getMaxUniforms() const {
     return maxUniforms_;
   }
 
-  void bindToPipeline(IContext& context);
+  // valueCache belongs to the currently bound program and may be null to upload everything
+  void bindToPipeline(IContext& context, UniformValueCache* valueCache = nullptr);
 
  private:
   struct UniformState {
     UniformState() = default;
-    UniformState(UniformDesc d, std::ptrdiff_t o) : desc(std::move(d)), dataOffset(o) {}
+    UniformState(UniformDesc d, std::ptrdiff_t o, std::ptrdiff_t l) :
+      desc(std::move(d)), dataOffset(o), length(l) {}
 
     UniformDesc desc;
     std::ptrdiff_t dataOffset = 0;
+    std::ptrdiff_t length = 0;
   };
 
   std::vector<UniformState> uniforms_;
   std::vector<uint8_t> uniformData_;
   uint32_t maxUniforms_ = 1024;
 
+  struct UniformBufferBinding {
+    IBuffer* buffer = nullptr;
+    size_t offset = 0;
+    // set if the buffer was bound by a shared_ptr
+    std::shared_ptr<IBuffer> owner;
+    // used if `buffer` is null
+    GLuint rawBuffer = 0;
+    size_t rawSize = 0;
+  };
+
   // map for uniform binding indices to the buffers
-  std::unordered_map<int, std::pair<std::shared_ptr<IBuffer>, size_t>> uniformBufferBindingMap_;
+  std::unordered_map<int, UniformBufferBinding> uniformBufferBindingMap_;
   uint32_t uniformBuffersDirtyMask_ = 0;
   static_assert(sizeof(uniformBuffersDirtyMask_) * 8 >= IGL_UNIFORM_BLOCKS_BINDING_MAX,
                 "uniformBuffersDirtyMask size is not enough to fit the flags");
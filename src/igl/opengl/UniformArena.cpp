@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/UniformArena.h>
+
+#include <igl/opengl/IContext.h>
+
+namespace igl::opengl {
+
+bool UniformArena::switchToNextBlock(IContext& context) {
+  IGL_PROFILER_FUNCTION();
+
+  if (alignment_ == 0) {
+    GLint alignment = 256;
+    context.getIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    alignment_ = alignment > 0 ? static_cast<size_t>(alignment) : 256;
+    context.genBuffers(static_cast<GLsizei>(buffers_.size()), buffers_.data());
+    currentBlock_ = kNumBlocks - 1;
+  }
+
+  currentBlock_ = (currentBlock_ + 1) % kNumBlocks;
+  offset_ = 0;
+  generation_++;
+
+  const GLuint buffer = buffers_[currentBlock_];
+  if (!IGL_VERIFY(buffer != 0)) {
+    return false;
+  }
+  // allocates the storage of a new buffer, and orphans the storage of a used one
+  context.bindBuffer(GL_UNIFORM_BUFFER, buffer);
+  context.bufferData(GL_UNIFORM_BUFFER, kBlockSize, nullptr, GL_STREAM_DRAW);
+
+  return true;
+}
+
+bool UniformArena::allocate(IContext& context,
+                            const void* data,
+                            size_t length,
+                            GLuint& outBuffer,
+                            size_t& outOffset) {
+  IGL_PROFILER_FUNCTION();
+
+  if (length == 0 || length > kMaxAllocationSize) {
+    return false;
+  }
+
+  if (offset_ + length > kBlockSize) {
+    if (!switchToNextBlock(context)) {
+      return false;
+    }
+  }
+
+  const GLuint buffer = buffers_[currentBlock_];
+  context.bindBuffer(GL_UNIFORM_BUFFER, buffer);
+  context.bufferSubData(GL_UNIFORM_BUFFER, static_cast<GLintptr>(offset_), length, data);
+
+  outBuffer = buffer;
+  outOffset = offset_;
+
+  // the next allocation starts at an aligned offset
+  offset_ = (offset_ + length + alignment_ - 1) / alignment_ * alignment_;
+
+  return true;
+}
+
+void UniformArena::clear(IContext& context) {
+  if (alignment_ != 0) {
+    context.deleteBuffers(static_cast<GLsizei>(buffers_.size()), buffers_.data());
+  }
+  buffers_ = {};
+  currentBlock_ = 0;
+  offset_ = kBlockSize;
+  alignment_ = 0;
+}
+
+} // namespace igl::opengl
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <igl/Common.h>
+#include <igl/opengl/GLIncludes.h>
+
+namespace igl::opengl {
+class IContext;
+
+/// Transient uniform data of RenderCommandEncoder::bindBytes(), copied into GL_UNIFORM_BUFFERs at
+/// increasing offsets and bound with glBindBufferRange().
+///
+/// The arena cycles through kNumBlocks buffers. When it moves on to the next buffer, the storage
+/// of that buffer is orphaned with glBufferData(), so the driver keeps the old storage alive for
+/// draws in flight instead of stalling. The uniform blocks of one draw hold at most
+/// IGL_UNIFORM_BLOCKS_BINDING_MAX allocations of up to kMaxAllocationSize bytes, which span at
+/// most kNumBlocks - 1 buffers: a buffer is never orphaned while a pending binding refers to it.
+///
+/// Buffers are not shared between contexts, so each IContext owns one arena.
+class UniformArena final {
+ public:
+  static constexpr size_t kBlockSize = 64 * 1024;
+  static constexpr size_t kMaxAllocationSize = kBlockSize / IGL_UNIFORM_BLOCKS_BINDING_MAX;
+
+  /// Copies `data` into the arena. Returns false if `length` is 0 or exceeds kMaxAllocationSize.
+  bool allocate(IContext& context,
+                const void* data,
+                size_t length,
+                GLuint& outBuffer,
+                size_t& outOffset);
+  void clear(IContext& context);
+
+  /// Incremented whenever the arena moves on to the next buffer. Data which is kept bound across
+  /// draws is written again once this changes, before its buffer is orphaned.
+  [[nodiscard]] uint64_t getGeneration() const {
+    return generation_;
+  }
+
+ private:
+  bool switchToNextBlock(IContext& context);
+
+  static constexpr size_t kNumBlocks = 4;
+
+  std::array<GLuint, kNumBlocks> buffers_ = {};
+  size_t currentBlock_ = 0;
+  size_t offset_ = kBlockSize;
+  size_t alignment_ = 0;
+  uint64_t generation_ = 0;
+};
+
+} // namespace igl::opengl
@@ -68,6 +68,7 @@ void UniformBuffer::initialize(const BufferDesc& desc, Result* outResult) {
 
 // upload data to the buffer at the given offset with the given size
 Result UniformBuffer::upload(const void* data, const BufferRange& range) {
+  IGL_PROFILER_FUNCTION();
   if (!IGL_VERIFY(range.offset + range.size <= getSizeInBytes())) {
     return Result{Result::Code::ArgumentOutOfRange, "Range size is larger than data size"};
   }
@@ -256,6 +257,12 @@ void UniformBuffer::bindUniformArray(IContext& context,
     }
     case UniformBaseType::Int: {
       auto packedIntArray = std::vector<GLint>(primitivesPerElement * numElements);
+      if (primitivesPerElement == 3 && stride == 4 * sizeof(GLint)) {
+        packVec3Array(packedIntArray.data(), start, numElements);
+        UniformBuffer::bindUniform(
+            context, shaderLocation, uniformType, (uint8_t*)packedIntArray.data(), numElements);
+        break;
+      }
       for (int i = 0; i < numElements; i++) {
         optimizedMemcpy(
             &packedIntArray[i * primitivesPerElement], start, primitivesPerElement * sizeof(GLint));
@@ -267,6 +274,12 @@ void UniformBuffer::bindUniformArray(IContext& context,
     }
     case UniformBaseType::Float: {
       auto packedFloatArray = std::vector<GLfloat>(primitivesPerElement * numElements);
+      if (primitivesPerElement == 3 && stride == 4 * sizeof(GLfloat)) {
+        packVec3Array(packedFloatArray.data(), start, numElements);
+        UniformBuffer::bindUniform(
+            context, shaderLocation, uniformType, (uint8_t*)packedFloatArray.data(), numElements);
+        break;
+      }
       for (int i = 0; i < numElements; i++) {
         optimizedMemcpy(&packedFloatArray[i * primitivesPerElement],
                         start,
@@ -280,6 +293,13 @@ void UniformBuffer::bindUniformArray(IContext& context,
     case UniformBaseType::FloatMatrix: {
       auto packedFloatArray =
           std::vector<GLfloat>(primitivesPerElement * primitivesPerElement * numElements);
+      if (primitivesPerElement == 3 && stride == 3 * 4 * sizeof(GLfloat)) {
+        // every column of a mat3 is padded to a vec4
+        packVec3Array(packedFloatArray.data(), start, 3 * numElements);
+        UniformBuffer::bindUniform(
+            context, shaderLocation, uniformType, (uint8_t*)packedFloatArray.data(), numElements);
+        break;
+      }
       for (int i = 0; i < numElements; i++) {
         for (int j = 0; j < primitivesPerElement; j++) {
           size_t bytesToCopy = primitivesPerElement * sizeof(GLfloat);
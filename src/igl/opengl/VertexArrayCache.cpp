@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/VertexArrayCache.h>
+
+#include <igl/opengl/IContext.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace igl::opengl {
+
+namespace {
+void hashCombine(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+} // namespace
+
+size_t VertexArrayCache::getHash(const void* pipeline, const std::vector<Binding>& bindings) {
+  size_t hash = std::hash<const void*>()(pipeline);
+  for (const auto& binding : bindings) {
+    hashCombine(hash, binding.bufferIndex);
+    hashCombine(hash, binding.buffer);
+    hashCombine(hash, binding.offset);
+  }
+  return hash;
+}
+
+GLuint VertexArrayCache::find(const void* pipeline, const std::vector<Binding>& bindings) const {
+  const auto range = entries_.equal_range(getHash(pipeline, bindings));
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.pipeline == pipeline && it->second.bindings == bindings) {
+      return it->second.vertexArray;
+    }
+  }
+  return 0;
+}
+
+GLuint VertexArrayCache::insert(IContext& context,
+                                const void* pipeline,
+                                const std::vector<Binding>& bindings) {
+  if (entries_.size() >= kMaxEntries) {
+    clear(context);
+  }
+
+  Entry entry;
+  entry.pipeline = pipeline;
+  entry.bindings = bindings;
+  context.genVertexArrays(1, &entry.vertexArray);
+
+  const GLuint vertexArray = entry.vertexArray;
+  entries_.emplace(getHash(pipeline, bindings), std::move(entry));
+
+  return vertexArray;
+}
+
+void VertexArrayCache::onBuffersDeleted(IContext& context, GLsizei n, const GLuint* buffers) {
+  if (entries_.empty()) {
+    return;
+  }
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    const auto& bindings = it->second.bindings;
+    const bool usesDeletedBuffer =
+        std::any_of(bindings.begin(), bindings.end(), [n, buffers](const Binding& binding) {
+          return std::find(buffers, buffers + n, binding.buffer) != buffers + n;
+        });
+    it = usesDeletedBuffer ? erase(context, it) : std::next(it);
+  }
+}
+
+void VertexArrayCache::onPipelineDestroyed(IContext& context, const void* pipeline) {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    it = it->second.pipeline == pipeline ? erase(context, it) : std::next(it);
+  }
+}
+
+void VertexArrayCache::clear(IContext& context) {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    it = erase(context, it);
+  }
+}
+
+VertexArrayCache::Entries::iterator VertexArrayCache::erase(IContext& context,
+                                                            Entries::iterator it) {
+  context.deleteVertexArrays(1, &it->second.vertexArray);
+  return entries_.erase(it);
+}
+
+} // namespace igl::opengl
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <igl/opengl/GLIncludes.h>
+#include <unordered_map>
+#include <vector>
+
+namespace igl::opengl {
+class IContext;
+
+/// Fully configured vertex array objects keyed by the render pipeline they were set up for and the
+/// vertex buffers (GL name and offset) bound to each of its buffer indices. Repeating a draw with
+/// the same pipeline and vertex buffers then only needs a glBindVertexArray().
+///
+/// VAOs are not shared between contexts, so each IContext owns one cache. Entries referring to a
+/// buffer are evicted when the buffer is deleted through the same IContext, and entries of a
+/// pipeline are evicted when the pipeline is destroyed.
+class VertexArrayCache final {
+ public:
+  struct Binding {
+    size_t bufferIndex = 0;
+    GLuint buffer = 0;
+    size_t offset = 0;
+
+    bool operator==(const Binding& other) const {
+      return bufferIndex == other.bufferIndex && buffer == other.buffer && offset == other.offset;
+    }
+  };
+
+  /// Returns the VAO previously created for this pipeline and these bindings, or 0.
+  GLuint find(const void* pipeline, const std::vector<Binding>& bindings) const;
+  /// Creates a new empty VAO for this pipeline and these bindings. The caller sets it up.
+  GLuint insert(IContext& context, const void* pipeline, const std::vector<Binding>& bindings);
+
+  void onBuffersDeleted(IContext& context, GLsizei n, const GLuint* buffers);
+  void onPipelineDestroyed(IContext& context, const void* pipeline);
+  void clear(IContext& context);
+
+  [[nodiscard]] size_t size() const {
+    return entries_.size();
+  }
+
+ private:
+  struct Entry {
+    const void* pipeline = nullptr;
+    std::vector<Binding> bindings;
+    GLuint vertexArray = 0;
+  };
+
+  static size_t getHash(const void* pipeline, const std::vector<Binding>& bindings);
+  using Entries = std::unordered_multimap<size_t, Entry>;
+  Entries::iterator erase(IContext& context, Entries::iterator it);
+
+  // Keeps the number of VAOs bounded when buffers are streamed through many GL names
+  static constexpr size_t kMaxEntries = 1024;
+
+  Entries entries_;
+};
+
+} // namespace igl::opengl
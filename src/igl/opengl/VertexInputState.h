@@ -26,6 +26,8 @@ struct OGLAttribute {
   GLint numComponents = 0;
   GLenum componentType = GL_FLOAT;
   GLboolean normalized = false;
+  // glVertexAttribDivisor: 0 advances per vertex, N advances every N instances
+  GLuint divisor = 0;
 
   OGLAttribute() = default;
 };
@@ -11,6 +11,9 @@
 
 namespace igl {
 namespace opengl {
+namespace {
+thread_local IContext* tlsContextOverride = nullptr;
+} // namespace
 
 WithContext::WithContext(IContext& context) : context_(&context) {
   if (!context_->addRef()) {
@@ -32,7 +35,16 @@ IContext& WithContext::getContext() const {
                  "Accessing invalid IContext reference."
                  // @fb-only
   );
-  return *context_;
+  return tlsContextOverride ? *tlsContextOverride : *context_;
+}
+
+WithContext::ScopedContextOverride::ScopedContextOverride(IContext& context) :
+  previous_(tlsContextOverride) {
+  tlsContextOverride = &context;
+}
+
+WithContext::ScopedContextOverride::~ScopedContextOverride() {
+  tlsContextOverride = previous_;
 }
 
 } // namespace opengl
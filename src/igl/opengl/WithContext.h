@@ -24,6 +24,21 @@ class WithContext {
 
   IContext& getContext() const;
 
+  /// While an instance is alive, getContext() of every object returns `context` on the calling
+  /// thread. `context` has to be in the sharegroup of the objects' own contexts. AsyncUploader uses
+  /// this to run the regular upload() code on its worker context.
+  class ScopedContextOverride final {
+   public:
+    explicit ScopedContextOverride(IContext& context);
+    ~ScopedContextOverride();
+
+    ScopedContextOverride(const ScopedContextOverride&) = delete;
+    ScopedContextOverride& operator=(const ScopedContextOverride&) = delete;
+
+   private:
+    IContext* previous_;
+  };
+
  private:
   IContext* context_;
 };
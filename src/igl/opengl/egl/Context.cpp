@@ -262,13 +262,16 @@ Context::~Context() {
 }
 
 void Context::setCurrent() {
-  eglMakeCurrent(display_, drawSurface_, readSurface_, context_);
+  if (eglMakeCurrent(display_, drawSurface_, readSurface_, context_)) {
+    didMakeCurrent();
+  }
   flushDeletionQueue();
 }
 
 void Context::clearCurrentContext() const {
   eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
   CHECK_EGL_ERRORS();
+  didClearCurrent();
 }
 
 bool Context::isCurrentContext() const {
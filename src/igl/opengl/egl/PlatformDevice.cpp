@@ -13,6 +13,12 @@
 #include <sstream>
 #include <utility>
 
+#if IGL_ANDROID_HWBUFFER_SUPPORTED
+#include <android/hardware_buffer.h>
+#include <igl/opengl/egl/android/NativeHWBuffer.h>
+#include <unistd.h>
+#endif // IGL_ANDROID_HWBUFFER_SUPPORTED
+
 namespace igl {
 namespace opengl {
 namespace egl {
@@ -186,6 +192,89 @@ void PlatformDevice::setPresentationTime(long long presentationTimeNs, Result* o
   return context->setPresentationTime(presentationTimeNs);
 }
 
+#if IGL_ANDROID_HWBUFFER_SUPPORTED
+std::shared_ptr<ITexture> PlatformDevice::createTextureFromNativeHWBuffer(
+    AHardwareBuffer* _Nonnull buffer,
+    TextureDesc::TextureUsage usage,
+    int acquireFenceFd,
+    Result* _Nullable outResult) {
+  auto context = static_cast<Context*>(getSharedContext().get());
+  if (context == nullptr) {
+    if (acquireFenceFd >= 0) {
+      close(acquireFenceFd);
+    }
+    Result::setResult(outResult, Result::Code::InvalidOperation, "No EGL context found!");
+    return nullptr;
+  }
+
+  if (acquireFenceFd >= 0) {
+    // the GPU waits for the producer; EGL owns the file descriptor once the sync is created
+    const EGLint attribs[] = {EGL_SYNC_NATIVE_FENCE_FD_ANDROID, acquireFenceFd, EGL_NONE};
+    EGLSyncKHR sync =
+        eglCreateSyncKHR(context->getDisplay(), EGL_SYNC_NATIVE_FENCE_ANDROID, attribs);
+    if (sync == EGL_NO_SYNC_KHR) {
+      close(acquireFenceFd);
+      Result::setResult(
+          outResult, Result::Code::RuntimeError, "Could not import the acquire fence");
+      return nullptr;
+    }
+    eglWaitSyncKHR(context->getDisplay(), sync, 0);
+    eglDestroySyncKHR(context->getDisplay(), sync);
+  }
+
+  TextureDesc desc;
+  Result subResult = igl::android::getNativeHWBufferTextureDesc(buffer, usage, desc);
+  if (!subResult.isOk()) {
+    Result::setResult(outResult, std::move(subResult));
+    return nullptr;
+  }
+
+  auto texture = std::make_shared<android::NativeHWTextureBuffer>(getContext(), desc.format);
+  subResult = texture->createWithHWBuffer(buffer, desc);
+  if (!subResult.isOk()) {
+    Result::setResult(outResult, std::move(subResult));
+    return nullptr;
+  }
+  if (auto resourceTracker = owner_.getResourceTracker()) {
+    texture->initResourceTracker(resourceTracker);
+  }
+
+  Result::setResult(outResult, Result::Code::Ok);
+  return texture;
+}
+
+AHardwareBuffer* _Nullable PlatformDevice::getNativeHWBuffer(const ITexture& texture) const {
+  const auto* nativeTexture = dynamic_cast<const android::NativeHWTextureBuffer*>(&texture);
+  return nativeTexture ? nativeTexture->getHWBuffer() : nullptr;
+}
+
+int PlatformDevice::createReleaseFence(Result* _Nullable outResult) {
+  auto context = static_cast<Context*>(getSharedContext().get());
+  if (context == nullptr) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "No EGL context found!");
+    return -1;
+  }
+
+  EGLSyncKHR sync =
+      eglCreateSyncKHR(context->getDisplay(), EGL_SYNC_NATIVE_FENCE_ANDROID, nullptr);
+  if (sync == EGL_NO_SYNC_KHR) {
+    Result::setResult(outResult, Result::Code::Unsupported, "EGL_ANDROID_native_fence_sync failed");
+    return -1;
+  }
+  // the native fence is created when the sync command is flushed
+  context->flush();
+  const int fenceFd = eglDupNativeFenceFDANDROID(context->getDisplay(), sync);
+  eglDestroySyncKHR(context->getDisplay(), sync);
+  if (fenceFd == EGL_NO_NATIVE_FENCE_FD_ANDROID) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Could not export the release fence");
+    return -1;
+  }
+
+  Result::setResult(outResult, Result::Code::Ok);
+  return fenceFd;
+}
+#endif // IGL_ANDROID_HWBUFFER_SUPPORTED
+
 bool PlatformDevice::isType(PlatformDeviceType t) const noexcept {
   return t == Type || opengl::PlatformDevice::isType(t);
 }
@@ -9,6 +9,7 @@
 
 #include <EGL/egl.h>
 #include <igl/Texture.h>
+#include <igl/android/NativeHWBuffer.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/PlatformDevice.h>
 
@@ -22,7 +23,11 @@ namespace egl {
 class Device;
 class Context;
 
-class PlatformDevice : public opengl::PlatformDevice {
+class PlatformDevice : public opengl::PlatformDevice
+#if IGL_ANDROID_HWBUFFER_SUPPORTED
+    , public igl::android::INativeHWBufferInterop
+#endif // IGL_ANDROID_HWBUFFER_SUPPORTED
+{
  public:
   static constexpr igl::PlatformDeviceType Type = igl::PlatformDeviceType::OpenGLEgl;
 
@@ -49,6 +54,20 @@ class PlatformDevice : public opengl::PlatformDevice {
 
   void setPresentationTime(long long presentationTimeNs, Result* outResult);
 
+#if IGL_ANDROID_HWBUFFER_SUPPORTED
+  /// Imports `buffer` through an EGLImage; the acquire fence is waited on with
+  /// EGL_ANDROID_native_fence_sync.
+  std::shared_ptr<ITexture> createTextureFromNativeHWBuffer(AHardwareBuffer* _Nonnull buffer,
+                                                            TextureDesc::TextureUsage usage,
+                                                            int acquireFenceFd,
+                                                            Result* _Nullable outResult) override;
+
+  AHardwareBuffer* _Nullable getNativeHWBuffer(const ITexture& texture) const override;
+
+  /// Flushes the context: the fence covers all the GL commands issued so far.
+  int createReleaseFence(Result* _Nullable outResult) override;
+#endif // IGL_ANDROID_HWBUFFER_SUPPORTED
+
  protected:
   bool isType(PlatformDeviceType t) const noexcept override;
 
@@ -13,6 +13,7 @@
 #include <android/hardware_buffer.h>
 #include <android/log.h>
 #include <igl/Macros.h>
+#include <igl/android/NativeHWBuffer.h>
 #include <igl/opengl/Errors.h>
 #include <igl/opengl/GLIncludes.h>
 
@@ -39,70 +40,6 @@ struct AHardwareBufferContext {
   EGLImageKHR elgImage;
 };
 
-namespace {
-
-uint32_t toNativeHWFormat(TextureFormat iglFomrat) {
-  // note that Native HW buffer has compute specific format but is not added here.
-  switch (iglFomrat) {
-  case TextureFormat::RGBX_UNorm8:
-    return AHARDWAREBUFFER_FORMAT_R8G8B8_UNORM;
-
-  case TextureFormat::RGBA_UNorm8:
-    return AHARDWAREBUFFER_FORMAT_R8G8B8A8_UNORM;
-
-  case TextureFormat::B5G6R5_UNorm:
-    return AHARDWAREBUFFER_FORMAT_R5G6B5_UNORM;
-
-  case TextureFormat::RGBA_F16:
-    return AHARDWAREBUFFER_FORMAT_R16G16B16A16_FLOAT;
-
-  case TextureFormat::RGB10_A2_UNorm_Rev:
-    return AHARDWAREBUFFER_FORMAT_R10G10B10A2_UNORM;
-
-  case TextureFormat::Z_UNorm16:
-    return AHARDWAREBUFFER_FORMAT_D16_UNORM;
-
-  case TextureFormat::Z_UNorm24:
-    return AHARDWAREBUFFER_FORMAT_D24_UNORM;
-
-  case TextureFormat::Z_UNorm32:
-    return AHARDWAREBUFFER_FORMAT_D32_FLOAT;
-
-  case TextureFormat::S8_UInt_Z24_UNorm:
-    return AHARDWAREBUFFER_FORMAT_D24_UNORM_S8_UINT;
-
-    // format mismatch
-    //  case TextureFormat::S8_UInt_Z32_UNorm:
-    //    return AHARDWAREBUFFER_FORMAT_D32_FLOAT_S8_UINT;
-
-  case TextureFormat::S_UInt8:
-    return AHARDWAREBUFFER_FORMAT_S8_UINT;
-
-  default:
-    return 0;
-  }
-  return 0;
-}
-
-uint32_t getBufferUsage(TextureDesc::TextureUsage usage) {
-  uint64_t bufferUsage = 0;
-
-  if (usage & TextureDesc::TextureUsageBits::Sampled) {
-    bufferUsage |= AHARDWAREBUFFER_USAGE_GPU_SAMPLED_IMAGE;
-  }
-
-  if (usage & TextureDesc::TextureUsageBits::Storage) {
-    bufferUsage |= AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN | AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN;
-  }
-
-  if (usage & TextureDesc::TextureUsageBits::Attachment) {
-    bufferUsage |= AHARDWAREBUFFER_USAGE_GPU_COLOR_OUTPUT;
-  }
-  return bufferUsage;
-}
-
-} // namespace
-
 NativeHWTextureBuffer::~NativeHWTextureBuffer() {
   GLuint textureID = getId();
   if (textureID != 0) {
@@ -112,7 +49,8 @@ NativeHWTextureBuffer::~NativeHWTextureBuffer() {
   auto context = std::static_pointer_cast<AHardwareBufferContext>(hwBufferHelper_);
   if (context) {
     eglDestroyImageKHR(context->display, context->elgImage);
-    AHardwareBuffer_acquire(hwBuffer_);
+  }
+  if (hwBuffer_) {
     AHardwareBuffer_release(hwBuffer_);
   }
 }
@@ -125,75 +63,86 @@ Result NativeHWTextureBuffer::create(const TextureDesc& desc, bool hasStorageAlr
   if (getTextureId() != 0) {
     return Result{Result::Code::RuntimeError, "NativeHWTextureBuffer alreayd created"};
   }
-  auto nativeHWFormat = toNativeHWFormat(desc.format);
-  auto isValid = desc.numLayers == 1 && desc.numSamples == 1 && desc.numMipLevels == 1 &&
-                 desc.type == TextureType::TwoD && nativeHWFormat > 0 &&
-                 hasStorageAlready == false && desc.storage == ResourceStorage::Shared;
-  auto result = Super::create(desc, false);
+  if (hasStorageAlready || desc.storage != ResourceStorage::Shared) {
+    return Result{Result::Code::RuntimeError,
+                  "Could not create hardware texture, texture desc is not valid"};
+  }
 
-  if (result.isOk() && nativeHWFormat > 0 && isValid) {
-    AHardwareBuffer_Desc descHW = {};
-    descHW.format = nativeHWFormat;
-    descHW.width = desc.width;
-    descHW.height = desc.height;
-    descHW.layers = 1;
-    descHW.usage = getBufferUsage(desc.usage);
-
-    auto hwResult = AHardwareBuffer_allocate(&descHW, &hwBuffer_);
-    if (hwResult != 0) {
-      return Result{Result::Code::RuntimeError, "AHardwareBuffer allocation failed"};
-    }
+  AHardwareBuffer* hwBuffer = nullptr;
+  const auto result = igl::android::allocateNativeHWBuffer(desc, &hwBuffer);
+  if (!result.isOk()) {
+    return result;
+  }
+  // the allocated reference is owned by this texture
+  return attachHWBuffer(hwBuffer, desc);
+}
 
-    EGLClientBuffer clientBuffer = eglGetNativeClientBufferANDROID(hwBuffer_);
-    EGLint attribs[] = {EGL_IMAGE_PRESERVED_KHR, EGL_TRUE, EGL_NONE, EGL_NONE, EGL_NONE};
+Result NativeHWTextureBuffer::createWithHWBuffer(AHardwareBuffer* _Nonnull hwBuffer,
+                                                 const TextureDesc& desc) {
+  if (getTextureId() != 0) {
+    return Result{Result::Code::RuntimeError, "NativeHWTextureBuffer alreayd created"};
+  }
+  AHardwareBuffer_acquire(hwBuffer);
+  return attachHWBuffer(hwBuffer, desc);
+}
 
-    EGLDisplay display = ((egl::Context*)&getContext())->getDisplay();
-    // eglCreateImageKHR will add a ref to the AHardwareBuffer
-    EGLImageKHR eglImage = eglCreateImageKHR(
-        display, EGL_NO_CONTEXT, EGL_NATIVE_BUFFER_ANDROID, clientBuffer, attribs);
-    APILOG("eglCreateImageKHR()\n");
+Result NativeHWTextureBuffer::attachHWBuffer(AHardwareBuffer* _Nonnull hwBuffer,
+                                             const TextureDesc& desc) {
+  hwBuffer_ = hwBuffer;
 
-    if (EGL_NO_IMAGE_KHR == eglImage) {
-      return Result{Result::Code::RuntimeError, "Could not create EGL image, err"};
-    }
-    getContext().checkForErrors(__FUNCTION__, __LINE__);
+  auto result = Super::create(desc, false);
+  if (!result.isOk()) {
+    return result;
+  }
 
-    IGL_REPORT_ERROR(getContext().isCurrentContext() || getContext().isCurrentSharegroup());
+  EGLClientBuffer clientBuffer = eglGetNativeClientBufferANDROID(hwBuffer_);
+  EGLint attribs[] = {EGL_IMAGE_PRESERVED_KHR, EGL_TRUE, EGL_NONE, EGL_NONE, EGL_NONE};
 
-    GLuint tid = 0;
-    getContext().genTextures(1, &tid);
-    if (!tid) {
-      eglDestroyImageKHR(display, eglImage);
-      return Result{Result::Code::RuntimeError,
-                    "NativeHWTextureBuffer failes to generate GL texture ID"};
-    }
+  EGLDisplay display = ((egl::Context*)&getContext())->getDisplay();
+  // eglCreateImageKHR will add a ref to the AHardwareBuffer
+  EGLImageKHR eglImage = eglCreateImageKHR(
+      display, EGL_NO_CONTEXT, EGL_NATIVE_BUFFER_ANDROID, clientBuffer, attribs);
+  APILOG("eglCreateImageKHR()\n");
 
-    setTextureBufferProperties(tid, GL_TEXTURE_2D);
-    getContext().bindTexture(getTarget(), getId());
+  if (EGL_NO_IMAGE_KHR == eglImage) {
+    return Result{Result::Code::RuntimeError, "Could not create EGL image, err"};
+  }
+  getContext().checkForErrors(__FUNCTION__, __LINE__);
 
-    if (getContext().checkForErrors(__FUNCTION__, __LINE__) != GL_NO_ERROR) {
-      getContext().deleteTextures({getId()});
-      eglDestroyImageKHR(display, eglImage);
-      return Result{Result::Code::RuntimeError,
-                    "NativeHWTextureBuffer GL error during bindTexture"};
-    }
+  IGL_REPORT_ERROR(getContext().isCurrentContext() || getContext().isCurrentSharegroup());
 
-    glEGLImageTargetTexture2DOES(getTarget(), static_cast<GLeglImageOES>(eglImage));
-    APILOG("glEGLImageTargetTexture2DOES(%u, %#x)\n",
-           GL_TEXTURE_2D,
-           static_cast<GLeglImageOES>(eglImage));
+  GLuint tid = 0;
+  getContext().genTextures(1, &tid);
+  if (!tid) {
+    eglDestroyImageKHR(display, eglImage);
+    return Result{Result::Code::RuntimeError,
+                  "NativeHWTextureBuffer failes to generate GL texture ID"};
+  }
 
-    getContext().checkForErrors(__FUNCTION__, __LINE__);
+  // multi-planar YUV buffers are only accessible through GL_TEXTURE_EXTERNAL_OES
+  setTextureBufferProperties(tid,
+                             getProperties().isMultiPlanar() ? GL_TEXTURE_EXTERNAL_OES
+                                                             : GL_TEXTURE_2D);
+  getContext().bindTexture(getTarget(), getId());
 
-    std::shared_ptr<AHardwareBufferContext> hwBufferCtx =
-        std::make_shared<AHardwareBufferContext>();
-    hwBufferCtx->display = display;
-    hwBufferCtx->elgImage = eglImage;
-    hwBufferHelper_ = std::static_pointer_cast<AHardwareBufferHelper>(hwBufferCtx);
-    return Result{};
+  if (getContext().checkForErrors(__FUNCTION__, __LINE__) != GL_NO_ERROR) {
+    getContext().deleteTextures({getId()});
+    eglDestroyImageKHR(display, eglImage);
+    return Result{Result::Code::RuntimeError, "NativeHWTextureBuffer GL error during bindTexture"};
   }
-  return Result{Result::Code::RuntimeError,
-                "Could not create hardware texture, texture desc is not valid"};
+
+  glEGLImageTargetTexture2DOES(getTarget(), static_cast<GLeglImageOES>(eglImage));
+  APILOG("glEGLImageTargetTexture2DOES(%u, %#x)\n",
+         getTarget(),
+         static_cast<GLeglImageOES>(eglImage));
+
+  getContext().checkForErrors(__FUNCTION__, __LINE__);
+
+  std::shared_ptr<AHardwareBufferContext> hwBufferCtx = std::make_shared<AHardwareBufferContext>();
+  hwBufferCtx->display = display;
+  hwBufferCtx->elgImage = eglImage;
+  hwBufferHelper_ = std::static_pointer_cast<AHardwareBufferHelper>(hwBufferCtx);
+  return Result{};
 }
 
 void NativeHWTextureBuffer::bind() {
@@ -277,6 +226,9 @@ Result NativeHWTextureBuffer::upload(const TextureRangeDesc& range,
                                      const void* data,
                                      size_t bytesPerRow) const {
   // not optimal pass
+  if (getProperties().isMultiPlanar()) {
+    return Result{Result::Code::Unsupported, "NativeHWTextureBuffer YUV upload not supported"};
+  }
 
   std::byte* dst = nullptr;
   NativeHWTextureBuffer::RangeDesc outRange;
@@ -319,10 +271,6 @@ Result NativeHWTextureBuffer::lockHWBuffer(std::byte* _Nullable* _Nonnull dst,
                            nullptr,
                            reinterpret_cast<void**>(dst))) {
     IGL_ASSERT_MSG(0, "Failed to lock hardware buffer");
-    if (hwBuffer_) {
-      AHardwareBuffer_release(hwBuffer_);
-    }
-
     return Result{Result::Code::RuntimeError, "Failed to lock hardware buffer"};
   }
 
@@ -338,10 +286,6 @@ Result NativeHWTextureBuffer::lockHWBuffer(std::byte* _Nullable* _Nonnull dst,
 Result NativeHWTextureBuffer::unlockHWBuffer() const {
   if (AHardwareBuffer_unlock(hwBuffer_, nullptr)) {
     IGL_ASSERT_MSG(0, "Failed to unlock hardware buffer");
-    if (hwBuffer_) {
-      AHardwareBuffer_release(hwBuffer_);
-    }
-
     return Result{Result::Code::RuntimeError, "Failed to unlock hardware buffer"};
   }
   return Result{};
@@ -365,7 +309,7 @@ void NativeHWTextureBuffer::generateMipmap(ICommandQueue& /* unused */) const {
 }
 
 bool NativeHWTextureBuffer::isValidFormat(TextureFormat format) {
-  return toNativeHWFormat(format) > 0;
+  return igl::android::getNativeHWFormat(format) > 0;
 }
 
 } // namespace igl::opengl::egl::android
@@ -40,11 +40,16 @@ class NativeHWTextureBuffer : public TextureBufferBase {
 
   // Texture overrides
   Result create(const TextureDesc& desc, bool hasStorageAlready) override;
+  // wraps an existing buffer without copying; the texture acquires its own reference
+  Result createWithHWBuffer(AHardwareBuffer* _Nonnull hwBuffer, const TextureDesc& desc);
   void bind() override;
   void bindImage(size_t unit) override;
   Result lockHWBuffer(std::byte* _Nullable* _Nonnull dst, RangeDesc& outRange) const;
   Result unlockHWBuffer() const;
   uint64_t getTextureId() const override;
+  [[nodiscard]] AHardwareBuffer* _Nullable getHWBuffer() const {
+    return hwBuffer_;
+  }
 
   void generateMipmap(ICommandQueue& cmdQueue) const override;
   uint32_t getNumMipLevels() const override;
@@ -67,6 +72,8 @@ class NativeHWTextureBuffer : public TextureBufferBase {
 
  private:
   Result createTexture(const TextureDesc& desc);
+  // takes ownership of one reference to `hwBuffer`
+  Result attachHWBuffer(AHardwareBuffer* _Nonnull hwBuffer, const TextureDesc& desc);
   bool canInitialize() const;
   bool supportsTexStorage() const;
   AHardwareBuffer* hwBuffer_ = nullptr;
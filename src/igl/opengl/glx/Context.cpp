@@ -243,6 +243,8 @@ void Context::setCurrent() {
     IGL_ASSERT_MSG(false,
                    "[IGL] Failed to activate OpenGL render context. GLX error 0x%08X:\n",
                    GetLastError());
+  } else {
+    didMakeCurrent();
   }
   flushDeletionQueue();
 }
@@ -252,6 +254,7 @@ void Context::clearCurrentContext() const {
     IGL_ASSERT_MSG(
         false, "[IGL] Failed to clear OpenGL render context. GLX error 0x%08X:\n", GetLastError());
   }
+  didClearCurrent();
 }
 
 bool Context::isCurrentContext() const {
@@ -106,12 +106,15 @@ void Context::present(std::shared_ptr<ITexture> surface) const {
 }
 
 void Context::setCurrent() {
-  [EAGLContext setCurrentContext:context_];
+  if ([EAGLContext setCurrentContext:context_]) {
+    didMakeCurrent();
+  }
   flushDeletionQueue();
 }
 
 void Context::clearCurrentContext() const {
   [EAGLContext setCurrentContext:nil];
+  didClearCurrent();
 }
 
 bool Context::isCurrentContext() const {
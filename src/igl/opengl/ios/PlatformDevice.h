@@ -16,6 +16,7 @@ typedef void CAEAGLLayer;
 #endif
 #include <CoreVideo/CVImageBuffer.h>
 #include <CoreVideo/CVOpenGLESTextureCache.h>
+#include <IOSurface/IOSurfaceRef.h>
 #include <igl/Texture.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/PlatformDevice.h>
@@ -90,6 +91,18 @@ class PlatformDevice final : public opengl::PlatformDevice {
       TextureDesc::TextureUsage usage = TextureDesc::TextureUsageBits::Sampled,
       Result* outResult = nullptr);
 
+  /// Creates a texture which aliases one plane of an IOSurface, e.g. the luma or chroma plane of a
+  /// bi-planar YUV video frame. Uses IGL's internal texture cache.
+  /// @param surface source surface
+  /// @param planeIndex the plane index to generate the texture
+  /// @param outResult optional result
+  /// @return pointer to generated TextureBuffer or nullptr
+  std::unique_ptr<ITexture> createTextureFromNativeIOSurface(
+      IOSurfaceRef surface,
+      size_t planeIndex = 0,
+      TextureDesc::TextureUsage usage = TextureDesc::TextureUsageBits::Sampled,
+      Result* outResult = nullptr);
+
   CVOpenGLESTextureCacheRef getTextureCache();
 
  protected:
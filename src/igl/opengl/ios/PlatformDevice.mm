@@ -281,6 +281,27 @@ std::unique_ptr<ITexture> PlatformDevice::createTextureFromNativePixelBuffer(
   return textureBuffer;
 }
 
+std::unique_ptr<ITexture> PlatformDevice::createTextureFromNativeIOSurface(
+    IOSurfaceRef surface,
+    size_t planeIndex,
+    TextureDesc::TextureUsage usage,
+    Result* outResult) {
+  if (surface == nullptr) {
+    Result::setResult(outResult, Result::Code::ArgumentNull, "IOSurface is NULL");
+    return nullptr;
+  }
+  CVPixelBufferRef pixelBuffer = nullptr;
+  if (CVPixelBufferCreateWithIOSurface(kCFAllocatorDefault, surface, nullptr, &pixelBuffer) !=
+      kCVReturnSuccess) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Failed to wrap IOSurface");
+    return nullptr;
+  }
+  // the texture retains the pixel buffer, which retains the surface
+  auto texture = createTextureFromNativePixelBuffer(pixelBuffer, planeIndex, usage, outResult);
+  CVPixelBufferRelease(pixelBuffer);
+  return texture;
+}
+
 bool PlatformDevice::isType(PlatformDeviceType t) const noexcept {
   return t == Type || opengl::PlatformDevice::isType(t);
 }
@@ -116,11 +116,13 @@ void Context::present(std::shared_ptr<ITexture> /*surface*/) const {
 
 void Context::setCurrent() {
   [context_ makeCurrentContext];
+  didMakeCurrent();
   flushDeletionQueue();
 }
 
 void Context::clearCurrentContext() const {
   [NSOpenGLContext clearCurrentContext];
+  didClearCurrent();
 }
 
 bool Context::isCurrentContext() const {
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <CoreVideo/CVOpenGLTextureCache.h>
+#include <IOSurface/IOSurface.h>
 #include <igl/Texture.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/PlatformDevice.h>
@@ -61,6 +62,32 @@ class PlatformDevice : public opengl::PlatformDevice {
       TextureDesc::TextureUsage usage = TextureDesc::TextureUsageBits::Sampled,
       Result* outResult = nullptr);
 
+  /// Creates a texture from one plane of a native PixelBuffer, e.g. the luma or chroma plane of a
+  /// bi-planar YUV video frame. Planar PixelBuffers have to be backed by an IOSurface, which is
+  /// bound without any copy.
+  /// @param sourceImage source image
+  /// @param textureCache an OpenGL texture cache, used for non-planar PixelBuffers
+  /// @param planeIndex the plane index to generate the texture
+  /// @param outResult optional result
+  /// @return pointer to generated TextureBuffer or nullptr
+  std::unique_ptr<ITexture> createTextureFromNativePixelBuffer(
+      const CVImageBufferRef& sourceImage,
+      const CVOpenGLTextureCacheRef& textureCache,
+      size_t planeIndex,
+      TextureDesc::TextureUsage usage,
+      Result* outResult);
+
+  /// Creates a texture which aliases one plane of an IOSurface, without any copy.
+  /// @param surface source surface
+  /// @param planeIndex the plane index to generate the texture
+  /// @param outResult optional result
+  /// @return pointer to generated TextureBuffer or nullptr
+  std::unique_ptr<ITexture> createTextureFromNativeIOSurface(
+      IOSurfaceRef surface,
+      size_t planeIndex = 0,
+      TextureDesc::TextureUsage usage = TextureDesc::TextureUsageBits::Sampled,
+      Result* outResult = nullptr);
+
  protected:
   bool isType(PlatformDeviceType t) const noexcept override;
 
@@ -136,8 +136,17 @@ std::unique_ptr<ITexture> PlatformDevice::createTextureFromNativePixelBuffer(
     const CVOpenGLTextureCacheRef& textureCache,
     TextureDesc::TextureUsage usage,
     Result* outResult) {
+  return createTextureFromNativePixelBuffer(sourceImage, textureCache, 0, usage, outResult);
+}
+
+std::unique_ptr<ITexture> PlatformDevice::createTextureFromNativePixelBuffer(
+    const CVImageBufferRef& sourceImage,
+    const CVOpenGLTextureCacheRef& textureCache,
+    size_t planeIndex,
+    TextureDesc::TextureUsage usage,
+    Result* outResult) {
   auto textureBuffer =
-      std::make_unique<TextureBuffer>(getContext(), sourceImage, textureCache, usage);
+      std::make_unique<TextureBuffer>(getContext(), sourceImage, textureCache, planeIndex, usage);
   const auto result = textureBuffer->create();
   if (auto resourceTracker = owner_.getResourceTracker()) {
     textureBuffer->initResourceTracker(resourceTracker);
@@ -146,6 +155,28 @@ std::unique_ptr<ITexture> PlatformDevice::createTextureFromNativePixelBuffer(
   return textureBuffer;
 }
 
+std::unique_ptr<ITexture> PlatformDevice::createTextureFromNativeIOSurface(
+    IOSurfaceRef surface,
+    size_t planeIndex,
+    TextureDesc::TextureUsage usage,
+    Result* outResult) {
+  if (surface == nullptr) {
+    Result::setResult(outResult, Result::Code::ArgumentNull, "IOSurface is NULL");
+    return nullptr;
+  }
+  CVPixelBufferRef pixelBuffer = nullptr;
+  if (CVPixelBufferCreateWithIOSurface(kCFAllocatorDefault, surface, nullptr, &pixelBuffer) !=
+      kCVReturnSuccess) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Failed to wrap IOSurface");
+    return nullptr;
+  }
+  // without a texture cache the IOSurface is bound directly
+  auto texture =
+      createTextureFromNativePixelBuffer(pixelBuffer, nullptr, planeIndex, usage, outResult);
+  CVPixelBufferRelease(pixelBuffer);
+  return texture;
+}
+
 TextureFormat PlatformDevice::getNativeDrawableTextureFormat(Result* outResult) {
   Result::setOk(outResult);
 
@@ -9,6 +9,7 @@
 
 #include <CoreVideo/CVOpenGLTextureCache.h>
 #include <CoreVideo/CVPixelBuffer.h>
+#include <IOSurface/IOSurface.h>
 #include <igl/opengl/TextureBuffer.h>
 
 namespace igl::opengl::macos {
@@ -17,9 +18,14 @@ class TextureBuffer final : public opengl::TextureBuffer {
   using Super = opengl::TextureBuffer;
 
  public:
+  /// @param pixelBuffer The backing CVPixelBufferRef source
+  /// @param textureCache Texture cache, used for non-planar pixel buffers
+  /// @param planeIndex Plane index to generate texture
+  /// @param usage Usage of the texture
   TextureBuffer(IContext& context,
                 CVPixelBufferRef pixelBuffer,
                 CVOpenGLTextureCacheRef textureCache,
+                size_t planeIndex = 0,
                 TextureDesc::TextureUsage usage = TextureDesc::TextureUsageBits::Sampled);
   ~TextureBuffer() override;
 
@@ -27,15 +33,22 @@ class TextureBuffer final : public opengl::TextureBuffer {
   Result create(const TextureDesc& desc, bool hasStorageAlready) override;
 
   // This function is created to support wrapping an igl::ITexture container
-  // around a GL texture created from CVOpenGLTextureCacheCreateTextureFromImage()
+  // around a GL texture created from CVOpenGLTextureCacheCreateTextureFromImage(). The planes of
+  // planar pixel buffers are bound directly from their IOSurface, which the texture cache cannot
+  // do.
   Result create();
 
   Result upload(const TextureRangeDesc& range, const void* data, size_t bytesPerRow) const override;
 
+ private:
+  Result createFromIOSurface(IOSurfaceRef surface);
+
  private:
   CVOpenGLTextureRef cvTexture_ = nullptr;
   CVPixelBufferRef pixelBuffer_ = nullptr;
   CVOpenGLTextureCacheRef textureCache_ = nullptr;
+  size_t planeIndex_ = 0;
+  GLuint surfaceTextureId_ = 0;
   bool uploaded_ = false;
   bool created_ = false;
 };
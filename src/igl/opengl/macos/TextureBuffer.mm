@@ -7,9 +7,14 @@
 
 #include <igl/opengl/macos/TextureBuffer.h>
 
+#include <OpenGL/CGLIOSurface.h>
+#include <algorithm>
+#include <OpenGL/OpenGL.h>
+#include <igl/opengl/macos/Context.h>
+
 namespace igl::opengl::macos {
 namespace {
-TextureFormat convertToTextureFormat(OSType pixelFormat) {
+TextureFormat convertToTextureFormat(OSType pixelFormat, size_t planeIndex) {
   switch (pixelFormat) {
   case kCVPixelFormatType_32BGRA:
     return TextureFormat::RGBA_UNorm8;
@@ -19,11 +24,13 @@ TextureFormat convertToTextureFormat(OSType pixelFormat) {
 
   case kCVPixelFormatType_420YpCbCr8BiPlanarFullRange:
   case kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange: {
-    // On the iOS side, there's a plane index which will cause this case to
-    // return different values based the index. On the MacOS side there does
-    // not appear to be an equivalent index, so we are really just assuming
-    // planeIndex == 0 here.
-    return TextureFormat::R_UNorm8;
+    if (planeIndex == 0) {
+      return TextureFormat::R_UNorm8;
+    } else if (planeIndex == 1) {
+      return TextureFormat::RG_UNorm8;
+    } else {
+      return TextureFormat::Invalid;
+    }
   }
   default:
     return TextureFormat::Invalid;
@@ -33,10 +40,14 @@ TextureFormat convertToTextureFormat(OSType pixelFormat) {
 TextureBuffer::TextureBuffer(IContext& context,
                              CVPixelBufferRef pixelBuffer,
                              CVOpenGLTextureCacheRef textureCache,
+                             // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+                             size_t planeIndex,
                              TextureDesc::TextureUsage usage) :
-  Super(context, convertToTextureFormat(CVPixelBufferGetPixelFormatType(pixelBuffer))),
+  Super(context,
+        convertToTextureFormat(CVPixelBufferGetPixelFormatType(pixelBuffer), planeIndex)),
   pixelBuffer_(CVPixelBufferRetain(pixelBuffer)),
-  textureCache_((CVOpenGLTextureCacheRef)CFRetain(textureCache)) {
+  textureCache_(textureCache ? (CVOpenGLTextureCacheRef)CFRetain(textureCache) : nullptr),
+  planeIndex_(planeIndex) {
   setUsage(usage);
 }
 
@@ -44,6 +55,9 @@ TextureBuffer::~TextureBuffer() {
   if (textureCache_) {
     CFRelease(textureCache_);
   }
+  if (surfaceTextureId_) {
+    getContext().deleteTextures({surfaceTextureId_});
+  }
   CVPixelBufferRelease(cvTexture_);
   CVPixelBufferRelease(pixelBuffer_);
 
@@ -57,8 +71,8 @@ Result TextureBuffer::create(const TextureDesc& /*desc*/, bool /*hasStorageAlrea
 }
 
 Result TextureBuffer::create() {
-  if (pixelBuffer_ == nullptr || textureCache_ == nullptr) {
-    return Result(Result::Code::ArgumentNull, "PixelBuffer or TextureCache is NULL");
+  if (pixelBuffer_ == nullptr) {
+    return Result(Result::Code::ArgumentNull, "PixelBuffer is NULL");
   }
 
   if (created_) {
@@ -76,6 +90,15 @@ Result TextureBuffer::create() {
     return Result(Result::Code::ArgumentInvalid, "Invalid texture format");
   }
 
+  if (CVPixelBufferIsPlanar(pixelBuffer_) || textureCache_ == nullptr) {
+    IOSurfaceRef surface = CVPixelBufferGetIOSurface(pixelBuffer_);
+    if (surface == nullptr) {
+      return Result(Result::Code::ArgumentNull,
+                    "TextureCache is NULL and PixelBuffer is not backed by an IOSurface");
+    }
+    return createFromIOSurface(surface);
+  }
+
   const auto error = CVOpenGLTextureCacheCreateTextureFromImage(
       kCFAllocatorDefault, textureCache_, pixelBuffer_, nullptr, &cvTexture_);
   if (error != noErr) {
@@ -93,6 +116,47 @@ Result TextureBuffer::create() {
   return Result();
 }
 
+Result TextureBuffer::createFromIOSurface(IOSurfaceRef surface) {
+  // non-planar surfaces report 0 planes
+  const size_t planeCount = IOSurfaceGetPlaneCount(surface);
+  if (planeIndex_ >= std::max<size_t>(planeCount, 1)) {
+    return Result(Result::Code::ArgumentOutOfRange, "Invalid IOSurface plane index");
+  }
+  const size_t width = planeCount ? IOSurfaceGetWidthOfPlane(surface, planeIndex_)
+                                  : IOSurfaceGetWidth(surface);
+  const size_t height = planeCount ? IOSurfaceGetHeightOfPlane(surface, planeIndex_)
+                                   : IOSurfaceGetHeight(surface);
+  if (IOSurfaceGetPixelFormat(surface) == kCVPixelFormatType_32BGRA) {
+    // the texture cache swizzles BGRA surfaces; binding one directly needs the matching layout
+    formatDescGL_.internalFormat = GL_RGBA8;
+    formatDescGL_.format = GL_BGRA;
+    formatDescGL_.type = GL_UNSIGNED_INT_8_8_8_8_REV;
+  }
+
+  getContext().genTextures(1, &surfaceTextureId_);
+  getContext().bindTexture(GL_TEXTURE_RECTANGLE, surfaceTextureId_);
+  const CGLError error =
+      CGLTexImageIOSurface2D(static_cast<Context&>(getContext()).getNSContext().CGLContextObj,
+                             GL_TEXTURE_RECTANGLE,
+                             formatDescGL_.internalFormat,
+                             static_cast<GLsizei>(width),
+                             static_cast<GLsizei>(height),
+                             formatDescGL_.format,
+                             formatDescGL_.type,
+                             surface,
+                             static_cast<GLuint>(planeIndex_));
+  if (error != kCGLNoError) {
+    return Result(Result::Code::Unsupported,
+                  "Failed to bind IOSurface plane: " + std::string(CGLErrorString(error)));
+  }
+
+  setTextureProperties(static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+  // Like the texture cache, IOSurfaces are bound to GL_TEXTURE_RECTANGLE
+  setTextureBufferProperties(surfaceTextureId_, GL_TEXTURE_RECTANGLE);
+
+  return Result();
+}
+
 Result TextureBuffer::upload(const TextureRangeDesc& /*range*/,
                              const void* /*data*/,
                              size_t /*bytesPerRow*/) const {
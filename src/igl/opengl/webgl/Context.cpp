@@ -8,6 +8,10 @@
 #include <igl/opengl/Texture.h>
 #include <igl/opengl/webgl/Context.h>
 
+#if defined(__EMSCRIPTEN_PTHREADS__)
+#include <emscripten/threading.h>
+#endif
+
 namespace igl::opengl::webgl {
 
 Context::Context(RenderingAPI api, const char* canvasName) : canvasName_(canvasName) {
@@ -18,6 +22,15 @@ Context::Context(RenderingAPI api, const char* canvasName) : canvasName_(canvasN
   attrs.premultipliedAlpha = false;
   attrs.alpha = false;
   attrs.powerPreference = EM_WEBGL_POWER_PREFERENCE_DEFAULT;
+#if defined(__EMSCRIPTEN_PTHREADS__)
+  if (!emscripten_is_main_browser_thread()) {
+    // Render directly into an OffscreenCanvas transferred to this worker (see
+    // OFFSCREENCANVASES_TO_PTHREAD) instead of proxying every GL call to the main thread. Frames
+    // are then presented explicitly by present().
+    attrs.explicitSwapControl = true;
+    attrs.proxyContextToMainThread = EMSCRIPTEN_WEBGL_CONTEXT_PROXY_DISALLOW;
+  }
+#endif
   initialize(attrs, canvasName, -1, -1);
 }
 
@@ -34,6 +47,7 @@ void Context::initialize(EmscriptenWebGLContextAttributes& attributes,
                          int width,
                          int height) {
   context_ = emscripten_webgl_create_context(canvasName, &attributes);
+  explicitSwapControl_ = attributes.explicitSwapControl;
   if (width > 0 && height > 0) {
     setCanvasBufferSize(width, height);
   }
@@ -55,7 +69,9 @@ Context::~Context() {
   emscripten_webgl_destroy_context(context_);
 }
 void Context::setCurrent() {
-  emscripten_webgl_make_context_current(context_);
+  if (emscripten_webgl_make_context_current(context_) == EMSCRIPTEN_RESULT_SUCCESS) {
+    didMakeCurrent();
+  }
 }
 
 void Context::clearCurrentContext() const {
@@ -78,7 +94,10 @@ void Context::setCanvasBufferSize(int width, int height) {
 }
 
 void Context::present(std::shared_ptr<ITexture> surface) const {
-  emscripten_webgl_commit_frame();
+  // Without explicit swap control the browser presents when control returns to the event loop
+  if (explicitSwapControl_) {
+    emscripten_webgl_commit_frame();
+  }
 }
 
 } // namespace igl::opengl::webgl
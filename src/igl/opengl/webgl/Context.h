@@ -19,6 +19,9 @@ namespace igl {
 class ITexture;
 namespace opengl::webgl {
 
+/// WebGL context of an HTML canvas. Created on a worker thread (pthreads builds), the context
+/// renders straight into an OffscreenCanvas transferred to that worker, so GL calls stay off the
+/// main thread.
 class Context final : public ::igl::opengl::IContext {
  public:
   Context(RenderingAPI api, const char* canvasName = "#canvas");
@@ -47,6 +50,7 @@ class Context final : public ::igl::opengl::IContext {
 
   EMSCRIPTEN_WEBGL_CONTEXT_HANDLE context_;
   std::string canvasName_;
+  bool explicitSwapControl_ = false;
 };
 
 } // namespace opengl::webgl
@@ -160,6 +160,8 @@ void Context::setCurrent() {
   if (!wglMakeCurrent(deviceContext_, renderContext_)) {
     IGL_ASSERT_MSG(
         0, "[IGL] Failed to activate OpenGL render context. WGL error 0x%08X:\n", GetLastError());
+  } else {
+    didMakeCurrent();
   }
   flushDeletionQueue();
 
@@ -177,6 +179,7 @@ void Context::clearCurrentContext() const {
     IGL_ASSERT_MSG(
         0, "[IGL] Failed to clear OpenGL render context. WGL error 0x%08X:\n", GetLastError());
   }
+  didClearCurrent();
 }
 
 bool Context::isCurrentContext() const {
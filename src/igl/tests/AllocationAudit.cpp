@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <igl/AllocationAudit.h>
+#include <igl/Macros.h>
+#include <memory>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+namespace {
+std::unique_ptr<int> allocateInZone() {
+  IGL_PROFILER_FUNCTION();
+  return std::make_unique<int>(1);
+}
+} // namespace
+
+TEST(AllocationAuditTest, CountsInsideZones) {
+  if (!allocation_audit::isAvailable()) {
+    GTEST_SKIP() << "IGL is built without IGL_ALLOCATION_AUDIT";
+  }
+
+  allocation_audit::begin();
+  auto outside = std::make_unique<int>(0);
+  auto first = allocateInZone();
+  auto second = allocateInZone();
+  {
+    const AllocationAuditZone zone("explicitZone");
+    auto inside = std::make_unique<int>(2);
+  }
+  std::vector<AllocationAuditSite> sites;
+  const uint64_t numAllocations = allocation_audit::end(&sites);
+
+  // the allocation outside of any zone is not counted
+  ASSERT_EQ(numAllocations, 3u);
+  ASSERT_EQ(sites.size(), 2u);
+  ASSERT_EQ(sites[0].count, 2u);
+  ASSERT_STREQ(sites[1].name, "explicitZone");
+  ASSERT_EQ(sites[1].count, 1u);
+
+  // nothing is counted after end()
+  auto third = allocateInZone();
+  ASSERT_EQ(allocation_audit::end(), 3u);
+}
+
+} // namespace tests
+} // namespace igl
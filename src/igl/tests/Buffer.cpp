@@ -236,5 +236,35 @@ TEST_F(BufferTest, mapUniformBuffer) {
   ASSERT_EQ(color.a, bufferData[3]);
 }
 
+TEST_F(BufferTest, readAsync) {
+  Result ret;
+  const uint32_t data[4] = {1, 2, 3, 4};
+  BufferDesc bufferDesc(BufferDesc::BufferTypeBits::Vertex, data, sizeof(data));
+  std::shared_ptr<IBuffer> buffer = iglDev_->createBuffer(bufferDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(buffer != nullptr);
+
+  auto readback = buffer->readAsync(*cmdQueue_, BufferRange(2 * sizeof(uint32_t), 4), &ret);
+  if (ret.code == Result::Code::Unsupported) {
+    GTEST_SKIP() << "Asynchronous readbacks are not supported";
+  }
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(readback != nullptr);
+  ASSERT_EQ(readback->getSizeInBytes(), 2 * sizeof(uint32_t));
+
+  uint32_t readData[2] = {};
+  ASSERT_TRUE(readback->getData(readData).isOk());
+  ASSERT_EQ(readData[0], 2u);
+  ASSERT_EQ(readData[1], 3u);
+  // the data can only be retrieved once
+  ASSERT_FALSE(readback->isReady());
+  ASSERT_FALSE(readback->getData(readData).isOk());
+
+  // out of range
+  readback = buffer->readAsync(*cmdQueue_, BufferRange(sizeof(data), 4), &ret);
+  ASSERT_EQ(ret.code, Result::Code::ArgumentOutOfRange);
+  ASSERT_TRUE(readback == nullptr);
+}
+
 } // namespace tests
 } // namespace igl
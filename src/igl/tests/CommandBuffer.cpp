@@ -7,6 +7,9 @@
 
 #include "util/Common.h"
 #include "util/TestDevice.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 namespace igl {
 namespace tests {
@@ -54,5 +57,47 @@ TEST_F(CommandBufferTest, pushPopDebugGroupLabel) {
   cmdBuf_->popDebugGroupLabel();
 }
 
+//
+// Check that completion is reported without blocking and that completed handlers are called
+//
+TEST_F(CommandBufferTest, completedHandler) {
+  auto called = std::make_shared<std::atomic<bool>>(false);
+  cmdBuf_->addCompletedHandler([called]() { *called = true; });
+  EXPECT_FALSE(cmdBuf_->isCompleted());
+
+  cmdQueue_->submit(*cmdBuf_);
+  cmdBuf_->waitUntilCompleted();
+  EXPECT_TRUE(cmdBuf_->isCompleted());
+
+  // Vulkan and OpenGL call handlers during later submits, Metal on its own thread
+  for (int i = 0; i != 1000 && !*called; i++) {
+    auto cmdBuf = cmdQueue_->createCommandBuffer(CommandBufferDesc(), nullptr);
+    ASSERT_TRUE(cmdBuf != nullptr);
+    cmdQueue_->submit(*cmdBuf);
+    cmdBuf->waitUntilCompleted();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(*called);
+}
+
+//
+// Check that a fence signaled after a submit is reached and can be waited on by the queue
+//
+TEST_F(CommandBufferTest, signalAndWaitFence) {
+  cmdQueue_->submit(*cmdBuf_);
+
+  Result result;
+  auto fence = cmdQueue_->signalFence(&result);
+  if (result.code == Result::Code::Unsupported) {
+    GTEST_SKIP() << "Fences are not supported";
+  }
+  ASSERT_TRUE(result.isOk()) << result.message.c_str();
+  ASSERT_TRUE(fence != nullptr);
+
+  EXPECT_TRUE(fence->waitUntilSignaled());
+  EXPECT_TRUE(fence->isSignaled());
+  EXPECT_TRUE(cmdQueue_->waitFence(*fence).isOk());
+}
+
 } // namespace tests
 } // namespace igl
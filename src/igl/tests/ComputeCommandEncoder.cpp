@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <functional>
 #include <gtest/gtest.h>
 #include <igl/IGL.h>
@@ -91,35 +92,67 @@ class ComputeCommandEncoderTest : public ::testing::Test {
   }
 
   /**
-   * @brief This function binds bufferIn and bufferOut to a new computePipelineState and encodes the
-   * computePipelineState to a new computeCommandEncoder.
+   * @brief This function creates a computePipelineState doubling the values of bufferIn into
+   * bufferOut.
    */
-  void encodeCompute(const std::shared_ptr<igl::ICommandBuffer>& cmdBuffer,
-                     const std::shared_ptr<igl::IBuffer>& bufferIn,
-                     const std::shared_ptr<igl::IBuffer>& bufferOut) {
-    ASSERT_TRUE(computeStages_ != nullptr);
+  std::shared_ptr<IComputePipelineState> createComputePipeline() const {
     ComputePipelineDesc computeDesc;
     computeDesc.shaderStages = computeStages_;
     computeDesc.buffersMap[igl::tests::data::shader::simpleComputeInputIndex] =
         genNameHandle(igl::tests::data::shader::simpleComputeInput);
     computeDesc.buffersMap[igl::tests::data::shader::simpleComputeOutputIndex] =
         genNameHandle(igl::tests::data::shader::simpleComputeOutput);
-    auto computePipelineState = iglDev_->createComputePipeline(computeDesc, nullptr);
+    return iglDev_->createComputePipeline(computeDesc, nullptr);
+  }
+
+  /**
+   * @brief This function encodes one dispatch reading bufferIn and writing bufferOut.
+   */
+  static void dispatch(IComputeCommandEncoder& computeEncoder,
+                       const std::shared_ptr<igl::IBuffer>& bufferIn,
+                       const std::shared_ptr<igl::IBuffer>& bufferOut) {
+    computeEncoder.bindBuffer(igl::tests::data::shader::simpleComputeInputIndex, bufferIn, 0);
+    computeEncoder.bindBuffer(igl::tests::data::shader::simpleComputeOutputIndex, bufferOut, 0);
+
+    Dimensions threadgroupSize(dataIn.size(), 1, 1);
+    Dimensions threadgroupCount(1, 1, 1);
+    computeEncoder.dispatchThreadGroups(threadgroupCount, threadgroupSize);
+  }
+
+  /**
+   * @brief This function binds bufferIn and bufferOut to a new computePipelineState and encodes the
+   * computePipelineState to a new computeCommandEncoder.
+   */
+  void encodeCompute(const std::shared_ptr<igl::ICommandBuffer>& cmdBuffer,
+                     const std::shared_ptr<igl::IBuffer>& bufferIn,
+                     const std::shared_ptr<igl::IBuffer>& bufferOut) {
+    ASSERT_TRUE(computeStages_ != nullptr);
+    auto computePipelineState = createComputePipeline();
     ASSERT_TRUE(computePipelineState != nullptr);
 
     auto computeEncoder = cmdBuffer->createComputeCommandEncoder();
     ASSERT_TRUE(computeEncoder != nullptr);
 
     computeEncoder->bindComputePipelineState(computePipelineState);
-    computeEncoder->bindBuffer(igl::tests::data::shader::simpleComputeInputIndex, bufferIn, 0);
-    computeEncoder->bindBuffer(igl::tests::data::shader::simpleComputeOutputIndex, bufferOut, 0);
-
-    Dimensions threadgroupSize(dataIn.size(), 1, 1);
-    Dimensions threadgroupCount(1, 1, 1);
-    computeEncoder->dispatchThreadGroups(threadgroupCount, threadgroupSize);
+    dispatch(*computeEncoder, bufferIn, bufferOut);
     computeEncoder->endEncoding();
   }
 
+  /**
+   * @brief This function checks that bufferOut holds the input values multiplied by `factor`.
+   */
+  void expectOutput(IBuffer& bufferOut, float factor) const {
+    auto range = BufferRange(sizeof(float) * dataIn.size(), 0);
+    igl::Result ret;
+    const auto* data = static_cast<const float*>(bufferOut.map(range, &ret));
+    ASSERT_TRUE(data != nullptr);
+    ASSERT_TRUE(ret.isOk());
+    for (size_t i = 0; i < dataIn.size(); i++) {
+      ASSERT_EQ(dataIn[i] * factor, data[i]);
+    }
+    bufferOut.unmap();
+  }
+
   void TearDown() override {}
 
  public:
@@ -202,4 +235,149 @@ TEST_F(ComputeCommandEncoderTest, canUseOutputBufferFromOnePassAsInputToNext) {
   bufferOut2_->unmap();
 }
 
+TEST_F(ComputeCommandEncoderTest, canDispatchIndependentGroupsInOnePass) {
+#if IGL_PLATFORM_LINUX && !IGL_PLATFORM_LINUX_USE_EGL
+  GTEST_SKIP() << "Fix this test on Linux";
+#endif
+  if (!isDeviceCompatible(*iglDev_)) {
+    return;
+  }
+
+  auto computePipelineState = createComputePipeline();
+  ASSERT_TRUE(computePipelineState != nullptr);
+
+  auto cmdBuffer = cmdQueue_->createCommandBuffer({}, nullptr);
+  ASSERT_TRUE(cmdBuffer != nullptr);
+  auto computeEncoder = cmdBuffer->createComputeCommandEncoder();
+  ASSERT_TRUE(computeEncoder != nullptr);
+  computeEncoder->bindComputePipelineState(computePipelineState);
+
+  // two independent dispatches
+  computeEncoder->beginDispatchGroup();
+  dispatch(*computeEncoder, bufferIn_, bufferOut0_);
+  dispatch(*computeEncoder, bufferIn_, bufferOut1_);
+  computeEncoder->endDispatchGroup();
+  // reads the output of the group
+  dispatch(*computeEncoder, bufferOut0_, bufferOut2_);
+  computeEncoder->endEncoding();
+
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  expectOutput(*bufferOut1_, 2.0f);
+  expectOutput(*bufferOut2_, 4.0f);
+}
+
+TEST_F(ComputeCommandEncoderTest, canDispatchThreadGroupsIndirect) {
+#if IGL_PLATFORM_LINUX && !IGL_PLATFORM_LINUX_USE_EGL
+  GTEST_SKIP() << "Fix this test on Linux";
+#endif
+  if (!isDeviceCompatible(*iglDev_)) {
+    return;
+  }
+
+  // the thread group counts follow a padding value to exercise the offset
+  const uint32_t indirectData[] = {0, 1, 1, 1};
+  auto indirectBuffer = iglDev_->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Storage | BufferDesc::BufferTypeBits::Indirect,
+                 indirectData,
+                 sizeof(indirectData)),
+      nullptr);
+  ASSERT_TRUE(indirectBuffer != nullptr);
+
+  auto computePipelineState = createComputePipeline();
+  ASSERT_TRUE(computePipelineState != nullptr);
+
+  auto cmdBuffer = cmdQueue_->createCommandBuffer({}, nullptr);
+  ASSERT_TRUE(cmdBuffer != nullptr);
+  auto computeEncoder = cmdBuffer->createComputeCommandEncoder();
+  ASSERT_TRUE(computeEncoder != nullptr);
+  computeEncoder->bindComputePipelineState(computePipelineState);
+  computeEncoder->bindBuffer(igl::tests::data::shader::simpleComputeInputIndex, bufferIn_, 0);
+  computeEncoder->bindBuffer(igl::tests::data::shader::simpleComputeOutputIndex, bufferOut0_, 0);
+  computeEncoder->dispatchThreadGroupsIndirect(
+      *indirectBuffer, sizeof(uint32_t), Dimensions(dataIn.size(), 1, 1));
+  computeEncoder->endEncoding();
+
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  expectOutput(*bufferOut0_, 2.0f);
+}
+
+TEST_F(ComputeCommandEncoderTest, reportsSubgroupLimits) {
+  if (!isDeviceCompatible(*iglDev_)) {
+    return;
+  }
+
+  size_t minSize = 0, maxSize = 0, operations = 0;
+  ASSERT_TRUE(iglDev_->getFeatureLimits(DeviceFeatureLimits::MinSubgroupSize, minSize));
+  ASSERT_TRUE(iglDev_->getFeatureLimits(DeviceFeatureLimits::MaxSubgroupSize, maxSize));
+  ASSERT_TRUE(iglDev_->getFeatureLimits(DeviceFeatureLimits::SubgroupOperations, operations));
+  ASSERT_LE(minSize, maxSize);
+  if (iglDev_->hasFeature(DeviceFeatures::ShaderSubgroups)) {
+    ASSERT_GT(minSize, 0u);
+    ASSERT_TRUE(operations & ICapabilities::SubgroupOperationBits::Arithmetic);
+  }
+
+  // a required subgroup size needs SubgroupSizeControl
+  if (!iglDev_->hasFeature(DeviceFeatures::SubgroupSizeControl)) {
+    ComputePipelineDesc computeDesc;
+    computeDesc.shaderStages = computeStages_;
+    computeDesc.requiredSubgroupSize = 32;
+    Result ret;
+    auto computePipelineState = iglDev_->createComputePipeline(computeDesc, &ret);
+    ASSERT_TRUE(computePipelineState == nullptr);
+    ASSERT_FALSE(ret.isOk());
+  }
+}
+
+TEST_F(ComputeCommandEncoderTest, canCopyBufferToTexture) {
+  if (!isDeviceCompatible(*iglDev_)) {
+    return;
+  }
+
+  constexpr size_t kSize = 4;
+  std::vector<uint32_t> pixels(kSize * kSize);
+  for (size_t i = 0; i != pixels.size(); i++) {
+    pixels[i] = 0xff000000u | static_cast<uint32_t>(i * 0x010203u);
+  }
+  // the texels start after one pixel of padding
+  std::vector<uint32_t> data(pixels.size() + 1, 0);
+  std::copy(pixels.begin(), pixels.end(), data.begin() + 1);
+
+  Result ret;
+  const BufferDesc bufferDesc(BufferDesc::BufferTypeBits::Storage,
+                              data.data(),
+                              data.size() * sizeof(uint32_t),
+                              ResourceStorage::Shared);
+  auto buffer = iglDev_->createBuffer(bufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  auto texture = iglDev_->createTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                         kSize,
+                         kSize,
+                         TextureDesc::TextureUsageBits::Sampled |
+                             TextureDesc::TextureUsageBits::Attachment),
+      &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  auto cmdBuffer = cmdQueue_->createCommandBuffer(CommandBufferDesc(), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  cmdBuffer->copyBufferToTexture(
+      *buffer, sizeof(uint32_t), *texture, TextureRangeDesc::new2D(0, 0, kSize, kSize));
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = texture;
+  auto framebuffer = iglDev_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  std::vector<uint32_t> readback(pixels.size());
+  framebuffer->copyBytesColorAttachment(
+      *cmdQueue_, 0, readback.data(), TextureRangeDesc::new2D(0, 0, kSize, kSize));
+  ASSERT_EQ(readback, pixels);
+}
+
 } // namespace igl::tests
@@ -11,7 +11,12 @@
 #include "util/Common.h"
 #include "util/TestDevice.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <future>
 #include <string>
+#include <thread>
 
 // Use a 1x1 Framebuffer for this test
 #define OFFSCREEN_RT_WIDTH 1
@@ -176,6 +181,192 @@ TEST_F(DeviceTest, LastDrawStat) {
   ASSERT_EQ(drawCount, 1);
 }
 
+//
+// Frame Statistics
+//
+// Counters of the current frame move into the history when a command buffer is submitted with
+// endOfFrame.
+//
+TEST_F(DeviceTest, FrameStatistics) {
+  Result ret;
+
+  const size_t historySize = iglDev_->getFrameStatisticsHistory().size();
+
+  auto pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(cmdBuf_ != nullptr);
+
+  auto cmds = cmdBuf_->createRenderCommandEncoder(renderPass_, framebuffer_);
+  cmds->bindRenderPipelineState(pipelineState);
+  // the second viewport is the same as the first one
+  const Viewport viewport = {0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f};
+  cmds->bindViewport(viewport);
+  cmds->bindViewport(viewport);
+  cmds->drawIndexed(PrimitiveType::Triangle, 0, IndexFormat::UInt16, *ib_, 0);
+  cmds->drawIndexed(PrimitiveType::Triangle, 0, IndexFormat::UInt16, *ib_, 0);
+  cmds->endEncoding();
+  cmdQueue_->submit(*cmdBuf_, true);
+
+  const std::vector<FrameStatistics> history = iglDev_->getFrameStatisticsHistory();
+  if (history.empty()) {
+    GTEST_SKIP() << "Frame statistics are not supported";
+  }
+  ASSERT_EQ(history.size(), std::min(historySize + 1, FrameStatisticsTracker::kHistorySize));
+
+  const FrameStatistics& lastFrame = history.back();
+  EXPECT_EQ(lastFrame.drawCalls, 2u);
+  if (backend_ != util::BACKEND_MTL) {
+    EXPECT_GE(lastFrame.pipelineBinds, 1u);
+  }
+  if (backend_ == util::BACKEND_VUL) {
+    EXPECT_GE(lastFrame.skippedCommands, 1u);
+  }
+
+  // a new frame has started
+  const FrameStatistics current = iglDev_->getFrameStatistics();
+  EXPECT_EQ(current.frameIndex, lastFrame.frameIndex + 1);
+  EXPECT_EQ(current.drawCalls, 0u);
+}
+
+//
+// Timestamp Queries
+//
+// Timestamps written around a render pass become available once the command buffer completed and
+// are ordered the same way they were written.
+//
+TEST_F(DeviceTest, TimestampQueries) {
+  if (!iglDev_->hasFeature(DeviceFeatures::TimestampQueries)) {
+    GTEST_SKIP() << "Timestamp queries are not supported";
+  }
+
+  Result ret;
+  TimestampQueryPoolDesc poolDesc;
+  poolDesc.count = 2;
+  auto pool = iglDev_->createTimestampQueryPool(poolDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_TRUE(pool != nullptr);
+  ASSERT_EQ(pool->getCount(), 2u);
+
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(cmdBuf_ != nullptr);
+
+  auto pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  cmdBuf_->writeTimestamp(*pool, 0);
+  auto cmds = cmdBuf_->createRenderCommandEncoder(renderPass_, framebuffer_);
+  cmds->bindRenderPipelineState(pipelineState);
+  cmds->drawIndexed(PrimitiveType::Triangle, 0, IndexFormat::UInt16, *ib_, 0); // draw 0 indices
+  cmds->endEncoding();
+  cmdBuf_->writeTimestamp(*pool, 1);
+  cmdQueue_->submit(*cmdBuf_);
+  cmdBuf_->waitUntilCompleted();
+
+  std::array<uint64_t, 2> timestamps = {};
+  bool available = false;
+  for (int attempt = 0; attempt < 100 && !available; ++attempt) {
+    available = pool->getResults(0, 2, timestamps.data());
+    if (!available) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  ASSERT_TRUE(available);
+  ASSERT_LE(timestamps[0], timestamps[1]);
+}
+
+//
+// Occlusion Queries
+//
+// A query around a draw which produces no fragments reports zero samples once the command buffer
+// completed.
+//
+TEST_F(DeviceTest, OcclusionQueries) {
+  if (!iglDev_->hasFeature(DeviceFeatures::OcclusionQueries)) {
+    GTEST_SKIP() << "Occlusion queries are not supported";
+  }
+
+  Result ret;
+  OcclusionQueryPoolDesc poolDesc;
+  poolDesc.type = OcclusionQueryType::Binary;
+  poolDesc.count = 1;
+  auto pool = iglDev_->createOcclusionQueryPool(poolDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_TRUE(pool != nullptr);
+  ASSERT_EQ(pool->getCount(), 1u);
+  ASSERT_EQ(pool->getType(), OcclusionQueryType::Binary);
+
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(cmdBuf_ != nullptr);
+
+  auto pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  renderPass_.occlusionQueryPool = pool;
+  auto cmds = cmdBuf_->createRenderCommandEncoder(renderPass_, framebuffer_);
+  cmds->bindRenderPipelineState(pipelineState);
+  cmds->beginOcclusionQuery(0);
+  cmds->drawIndexed(PrimitiveType::Triangle, 0, IndexFormat::UInt16, *ib_, 0); // draw 0 indices
+  cmds->endOcclusionQuery();
+  cmds->endEncoding();
+  cmdQueue_->submit(*cmdBuf_);
+  cmdBuf_->waitUntilCompleted();
+
+  uint64_t result = UINT64_MAX;
+  bool available = false;
+  for (int attempt = 0; attempt < 100 && !available; ++attempt) {
+    available = pool->getResults(0, 1, &result);
+    if (!available) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  ASSERT_TRUE(available);
+  ASSERT_EQ(result, 0u);
+}
+
+//
+// Asynchronous Pipeline Creation
+//
+// Pipelines created asynchronously can be bound as soon as their futures are ready; a pipeline
+// without shader stages fails through its future.
+//
+TEST_F(DeviceTest, CreateRenderPipelineAsync) {
+  Result ret;
+
+  std::vector<std::future<PipelineCreationResult<IRenderPipelineState>>> futures;
+  for (int i = 0; i != 4; i++) {
+    futures.push_back(iglDev_->createRenderPipelineAsync(renderPipelineDesc_));
+  }
+
+  RenderPipelineDesc invalidDesc = renderPipelineDesc_;
+  invalidDesc.shaderStages = nullptr;
+  auto invalid = iglDev_->createRenderPipelineAsync(invalidDesc).get();
+  EXPECT_FALSE(invalid.result.isOk());
+  EXPECT_EQ(invalid.pipeline, nullptr);
+
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(cmdBuf_ != nullptr);
+
+  auto cmds = cmdBuf_->createRenderCommandEncoder(renderPass_, framebuffer_);
+  for (auto& future : futures) {
+    const PipelineCreationResult<IRenderPipelineState> creation = future.get();
+    ASSERT_TRUE(creation.result.isOk()) << creation.result.message;
+    ASSERT_TRUE(creation.pipeline != nullptr);
+    cmds->bindRenderPipelineState(creation.pipeline);
+    cmds->drawIndexed(PrimitiveType::Triangle, 0, IndexFormat::UInt16, *ib_, 0);
+  }
+  cmds->endEncoding();
+  cmdQueue_->submit(*cmdBuf_);
+}
+
 //
 // Get Backend Type
 //
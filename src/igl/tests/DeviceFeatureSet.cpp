@@ -167,6 +167,7 @@ TEST_F(DeviceFeatureSetTest, hasFeatureForMacOSOrWinOrAndroidTest) {
     const bool externalMemoryObjects = deviceFeatures.isSupported("GL_EXT_memory_object") &&
                                        deviceFeatures.isSupported("GL_EXT_memory_object_fd");
     EXPECT_EQ(iglDev_->hasFeature(DeviceFeatures::ExternalMemoryObjects), externalMemoryObjects);
+    EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::FragmentDensityMap));
 #endif // IGL_BACKEND_OPENGL
   } else {
     // non OpenGL backends
@@ -228,6 +229,7 @@ TEST_F(DeviceFeatureSetTest, hasFeatureForMacOSOrWinOrAndroidTest) {
       EXPECT_TRUE(iglDev_->hasFeature(DeviceFeatures::TextureFormatRG));
       EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::ValidationLayersEnabled));
       EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::ExternalMemoryObjects));
+      EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::FragmentDensityMap));
     } else {
       EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::Texture2DArray));
       EXPECT_FALSE(iglDev_->hasFeature(DeviceFeatures::Texture3D));
@@ -357,6 +357,143 @@ TEST_F(FramebufferTest, Clear) {
   ASSERT_EQ(pixels[0], 0x80808080);
 }
 
+//
+// Framebuffer MemorylessDepthStencil Test
+//
+// Depth and stencil attachments which are cleared and discarded within a render pass don't need
+// backing memory. The color attachment is still stored.
+//
+TEST_F(FramebufferTest, MemorylessDepthStencil) {
+  Result ret;
+
+  TextureDesc depthTexDesc = TextureDesc::new2D(depthStencilTexture_->getFormat(),
+                                                OFFSCREEN_RT_WIDTH,
+                                                OFFSCREEN_RT_HEIGHT,
+                                                TextureDesc::TextureUsageBits::Attachment);
+  depthTexDesc.storage = ResourceStorage::Memoryless;
+  auto memorylessTexture = iglDev_->createTexture(depthTexDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+  ASSERT_TRUE(memorylessTexture != nullptr);
+
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = offscreenTexture_;
+  framebufferDesc.depthAttachment.texture = memorylessTexture;
+  framebufferDesc.stencilAttachment.texture = memorylessTexture;
+  auto framebuffer = iglDev_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(framebuffer != nullptr);
+
+  renderPass_.colorAttachments[0].clearColor = {0.501f, 0.501f, 0.501f, 0.501f};
+  renderPass_.depthAttachment.storeAction = StoreAction::DontCare;
+  renderPass_.stencilAttachment.storeAction = StoreAction::DontCare;
+
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(cmdBuf_ != nullptr);
+
+  auto cmds = cmdBuf_->createRenderCommandEncoder(renderPass_, framebuffer);
+  cmds->endEncoding();
+
+  cmdQueue_->submit(*cmdBuf_);
+  cmdBuf_->waitUntilCompleted();
+
+  const auto rangeDesc = TextureRangeDesc::new2D(0, 0, OFFSCREEN_RT_WIDTH, OFFSCREEN_RT_HEIGHT);
+  auto pixels = std::vector<uint32_t>(OFFSCREEN_RT_WIDTH * OFFSCREEN_RT_WIDTH);
+  framebuffer->copyBytesColorAttachment(*cmdQueue_, 0, pixels.data(), rangeDesc);
+  ASSERT_EQ(pixels[0], 0x80808080);
+}
+
+//
+// Framebuffer LoadStoredContents Test
+//
+// Attachments which are stored at the end of a render pass are not invalidated and can be loaded
+// by the next render pass.
+//
+TEST_F(FramebufferTest, LoadStoredContents) {
+  Result ret;
+
+  renderPass_.colorAttachments[0].clearColor = {0.501f, 0.501f, 0.501f, 0.501f};
+  renderPass_.depthAttachment.storeAction = StoreAction::DontCare;
+  renderPass_.stencilAttachment.storeAction = StoreAction::DontCare;
+
+  for (const auto loadAction : {LoadAction::Clear, LoadAction::Load}) {
+    renderPass_.colorAttachments[0].loadAction = loadAction;
+    renderPass_.depthAttachment.loadAction =
+        loadAction == LoadAction::Clear ? LoadAction::Clear : LoadAction::DontCare;
+    renderPass_.stencilAttachment.loadAction = renderPass_.depthAttachment.loadAction;
+
+    cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+    ASSERT_TRUE(ret.isOk());
+    ASSERT_TRUE(cmdBuf_ != nullptr);
+
+    auto cmds = cmdBuf_->createRenderCommandEncoder(renderPass_, framebuffer_);
+    cmds->endEncoding();
+
+    cmdQueue_->submit(*cmdBuf_);
+    cmdBuf_->waitUntilCompleted();
+  }
+
+  const auto rangeDesc = TextureRangeDesc::new2D(0, 0, OFFSCREEN_RT_WIDTH, OFFSCREEN_RT_HEIGHT);
+  auto pixels = std::vector<uint32_t>(OFFSCREEN_RT_WIDTH * OFFSCREEN_RT_WIDTH);
+  framebuffer_->copyBytesColorAttachment(*cmdQueue_, 0, pixels.data(), rangeDesc);
+  ASSERT_EQ(pixels[0], 0x80808080);
+}
+
+//
+// Framebuffer MsaaResolve Test
+//
+// Multisampled contents are resolved into the resolve texture of the attachment by both resolving
+// store actions.
+//
+TEST_F(FramebufferTest, MsaaResolve) {
+  if (!iglDev_->hasFeature(DeviceFeatures::MultiSample)) {
+    GTEST_SKIP() << "MSAA is not supported";
+  }
+  Result ret;
+
+  TextureDesc msaaDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                            OFFSCREEN_RT_WIDTH,
+                                            OFFSCREEN_RT_HEIGHT,
+                                            TextureDesc::TextureUsageBits::Attachment);
+  msaaDesc.numSamples = 4;
+  auto msaaTexture = iglDev_->createTexture(msaaDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+  ASSERT_TRUE(msaaTexture != nullptr);
+
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = msaaTexture;
+  framebufferDesc.colorAttachments[0].resolveTexture = offscreenTexture_;
+  auto framebuffer = iglDev_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+  ASSERT_TRUE(framebuffer != nullptr);
+
+  RenderPassDesc renderPass;
+  renderPass.colorAttachments.resize(1);
+  renderPass.colorAttachments[0].loadAction = LoadAction::Clear;
+
+  for (const auto storeAction : {StoreAction::MsaaResolve, StoreAction::StoreAndMsaaResolve}) {
+    ASSERT_TRUE(isMsaaResolve(storeAction));
+    const float value = storeAction == StoreAction::MsaaResolve ? 0.501f : 0.251f;
+    renderPass.colorAttachments[0].storeAction = storeAction;
+    renderPass.colorAttachments[0].clearColor = {value, value, value, value};
+
+    cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+    ASSERT_TRUE(ret.isOk());
+    ASSERT_TRUE(cmdBuf_ != nullptr);
+
+    auto cmds = cmdBuf_->createRenderCommandEncoder(renderPass, framebuffer);
+    cmds->endEncoding();
+
+    cmdQueue_->submit(*cmdBuf_);
+    cmdBuf_->waitUntilCompleted();
+
+    const auto rangeDesc = TextureRangeDesc::new2D(0, 0, OFFSCREEN_RT_WIDTH, OFFSCREEN_RT_HEIGHT);
+    auto pixels = std::vector<uint32_t>(OFFSCREEN_RT_WIDTH * OFFSCREEN_RT_WIDTH);
+    framebuffer_->copyBytesColorAttachment(*cmdQueue_, 0, pixels.data(), rangeDesc);
+    ASSERT_EQ(pixels[0], storeAction == StoreAction::MsaaResolve ? 0x80808080 : 0x40404040);
+  }
+}
+
 //
 // Framebuffer Blit Test
 //
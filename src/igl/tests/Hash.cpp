@@ -156,6 +156,52 @@ TEST_F(HashTest, GraphicsPipeline3) {
   ASSERT_TRUE(descOne == descTwo);
 }
 
+//
+// RenderPipelineDesc4
+//
+// Fields are mixed rather than XOR-ed: swapped or duplicated values must not cancel out, while the
+// sampler maps are hashed independently of their iteration order
+//
+TEST_F(HashTest, GraphicsPipeline4) {
+  RenderPipelineDesc descOne, descTwo;
+  descOne.targetDesc.colorAttachments.resize(1);
+  descTwo.targetDesc.colorAttachments.resize(1);
+
+  // swapped blend factors
+  descOne.targetDesc.colorAttachments[0].srcRGBBlendFactor = BlendFactor::SrcAlpha;
+  descOne.targetDesc.colorAttachments[0].dstRGBBlendFactor = BlendFactor::OneMinusSrcAlpha;
+  descTwo.targetDesc.colorAttachments[0].srcRGBBlendFactor = BlendFactor::OneMinusSrcAlpha;
+  descTwo.targetDesc.colorAttachments[0].dstRGBBlendFactor = BlendFactor::SrcAlpha;
+  ASSERT_NE(std::hash<RenderPipelineDesc>()(descOne), std::hash<RenderPipelineDesc>()(descTwo));
+  descTwo.targetDesc.colorAttachments = descOne.targetDesc.colorAttachments;
+
+  // two identical attachments instead of none
+  descOne.targetDesc.colorAttachments.clear();
+  descTwo.targetDesc.colorAttachments.resize(2);
+  ASSERT_NE(std::hash<RenderPipelineDesc>()(descOne), std::hash<RenderPipelineDesc>()(descTwo));
+  descTwo.targetDesc.colorAttachments.clear();
+
+  // the same sampler names on swapped units
+  descOne.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE("a");
+  descOne.fragmentUnitSamplerMap[1] = IGL_NAMEHANDLE("b");
+  descTwo.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE("b");
+  descTwo.fragmentUnitSamplerMap[1] = IGL_NAMEHANDLE("a");
+  ASSERT_NE(std::hash<RenderPipelineDesc>()(descOne), std::hash<RenderPipelineDesc>()(descTwo));
+
+  // equal maps built in a different order
+  descTwo.fragmentUnitSamplerMap.clear();
+  descTwo.fragmentUnitSamplerMap.reserve(64);
+  descTwo.fragmentUnitSamplerMap[1] = IGL_NAMEHANDLE("b");
+  descTwo.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE("a");
+  ASSERT_TRUE(descOne == descTwo);
+  ASSERT_EQ(std::hash<RenderPipelineDesc>()(descOne), std::hash<RenderPipelineDesc>()(descTwo));
+
+  // the same map on another stage
+  descTwo.vertexUnitSamplerMap = descTwo.fragmentUnitSamplerMap;
+  descTwo.fragmentUnitSamplerMap.clear();
+  ASSERT_NE(std::hash<RenderPipelineDesc>()(descOne), std::hash<RenderPipelineDesc>()(descTwo));
+}
+
 //
 // VertexInputStateDesc1
 //
@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <atomic>
 #include <gtest/gtest.h>
 #include <igl/IGL.h>
 #include <random>
@@ -39,5 +40,56 @@ TEST(LogTest, LogOnceRaceCondition) {
   t4.join();
 };
 
+namespace {
+std::atomic<int> sNumLoggedMessages{0};
+
+int countingHandler(IGLLogLevel /*logLevel*/, const char* IGL_RESTRICT /*format*/, va_list /*ap*/) {
+  sNumLoggedMessages++;
+  return 0;
+}
+} // namespace
+
+TEST(LogTest, Async) {
+  const auto handler = IGLLogGetHandler();
+  IGLLogSetHandler(countingHandler);
+  sNumLoggedMessages = 0;
+
+  IGLLogSetAsync(true);
+  ASSERT_TRUE(IGLLogIsAsync());
+
+  auto logManyTimes = []() {
+    for (int i = 0; i != 100; i++) {
+      IGLLog(IGLLogLevel::LOG_INFO, "message %d\n", i);
+    }
+  };
+  std::thread t1(logManyTimes);
+  std::thread t2(logManyTimes);
+  t1.join();
+  t2.join();
+
+  IGLLogFlush();
+  EXPECT_EQ(sNumLoggedMessages.load(), 200);
+
+  IGLLogSetAsync(false);
+  ASSERT_FALSE(IGLLogIsAsync());
+
+  // synchronous again
+  IGLLog(IGLLogLevel::LOG_INFO, "message\n");
+  EXPECT_EQ(sNumLoggedMessages.load(), 201);
+
+  IGLLogSetHandler(handler);
+}
+
+TEST(LogTest, RateLimit) {
+  IGLLogRateLimit limit;
+  int numAcquired = 0;
+  for (int i = 0; i != 10; i++) {
+    numAcquired += IGLLogRateLimitAcquire(limit, 3) ? 1 : 0;
+  }
+  // assumes the loop takes less than a second
+  EXPECT_EQ(numAcquired, 3);
+  EXPECT_EQ(limit.suppressed.load(), 7u);
+}
+
 } // namespace tests
 } // namespace igl
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "util/Common.h"
+#include "util/TestDevice.h"
+
+#include <igl/MemoryTracker.h>
+
+namespace igl {
+namespace tests {
+
+//
+// MemoryTrackerTest
+//
+// Test fixture for all the tests in this file. Installs a MemoryTracker on the test device.
+//
+class MemoryTrackerTest : public ::testing::Test {
+ public:
+  MemoryTrackerTest() = default;
+  ~MemoryTrackerTest() override = default;
+
+  void SetUp() override {
+    // Turn off debug break so unit tests can run
+    igl::setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    tracker_ = std::make_shared<MemoryTracker>();
+    iglDev_->setResourceTracker(tracker_);
+  }
+
+  void TearDown() override {
+    iglDev_->setResourceTracker(nullptr);
+  }
+
+  std::shared_ptr<ITexture> createTexture(size_t width, size_t height) const {
+    Result ret;
+    auto texture = iglDev_->createTexture(
+        TextureDesc::new2D(
+            TextureFormat::RGBA_UNorm8, width, height, TextureDesc::TextureUsageBits::Sampled),
+        &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+    return texture;
+  }
+
+  std::unique_ptr<IBuffer> createBuffer(size_t length) const {
+    Result ret;
+    auto buffer = iglDev_->createBuffer(
+        BufferDesc(BufferDesc::BufferTypeBits::Uniform, nullptr, length), &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+    return buffer;
+  }
+
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  std::shared_ptr<MemoryTracker> tracker_;
+};
+
+//
+// Tags
+//
+// Bytes are attributed to the tag active when a resource is created, and released with it
+//
+TEST_F(MemoryTrackerTest, Tags) {
+  auto untagged = createTexture(4, 4);
+  std::shared_ptr<ITexture> texture;
+  std::unique_ptr<IBuffer> buffer;
+  {
+    const ResourceTrackerTagGuard guard(tracker_, "Level");
+    texture = createTexture(16, 16);
+    buffer = createBuffer(256);
+  }
+
+  auto usage = tracker_->getUsageByTag();
+  ASSERT_EQ(usage["Level"].numTextures, 1u);
+  ASSERT_EQ(usage["Level"].textureBytes, texture->getEstimatedSizeInBytes());
+  ASSERT_EQ(usage["Level"].numBuffers, 1u);
+  ASSERT_EQ(usage["Level"].bufferBytes, buffer->getSizeInBytes());
+  ASSERT_EQ(usage[""].numTextures, 1u);
+  ASSERT_EQ(usage[""].textureBytes, untagged->getEstimatedSizeInBytes());
+  ASSERT_EQ(tracker_->getTotal().getTotalBytes(),
+            untagged->getEstimatedSizeInBytes() + texture->getEstimatedSizeInBytes() +
+                buffer->getSizeInBytes());
+  ASSERT_NE(tracker_->getReport().find("Level"), std::string::npos);
+
+  // the tag of a resource does not depend on the tags active when it is deleted
+  {
+    const ResourceTrackerTagGuard guard(tracker_, "Other");
+    texture = nullptr;
+    buffer = nullptr;
+  }
+  usage = tracker_->getUsageByTag();
+  ASSERT_EQ(usage["Level"].getTotalBytes(), 0u);
+  ASSERT_EQ(usage["Level"].numTextures, 0u);
+  ASSERT_EQ(usage["Other"].getTotalBytes(), 0u);
+  ASSERT_EQ(tracker_->getTotal().getTotalBytes(), untagged->getEstimatedSizeInBytes());
+}
+
+//
+// Framebuffers
+//
+// Framebuffers are counted without bytes; their attachments are counted as textures
+//
+TEST_F(MemoryTrackerTest, Framebuffers) {
+  FramebufferDesc desc;
+  desc.colorAttachments[0].texture = iglDev_->createTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                         8,
+                         8,
+                         TextureDesc::TextureUsageBits::Sampled |
+                             TextureDesc::TextureUsageBits::Attachment),
+      nullptr);
+  ASSERT_TRUE(desc.colorAttachments[0].texture != nullptr);
+  Result ret;
+  auto framebuffer = iglDev_->createFramebuffer(desc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  const TrackedMemory total = tracker_->getTotal();
+  ASSERT_EQ(total.numFramebuffers, 1u);
+  ASSERT_EQ(total.textureBytes, desc.colorAttachments[0].texture->getEstimatedSizeInBytes());
+
+  framebuffer = nullptr;
+  ASSERT_EQ(tracker_->getTotal().numFramebuffers, 0u);
+}
+
+//
+// Budget
+//
+// The warning is raised once when the tracked bytes cross the threshold, and again after they went
+// back below it
+//
+TEST_F(MemoryTrackerTest, Budget) {
+  auto small = createTexture(4, 4);
+  const size_t textureBytes = createTexture(16, 16)->getEstimatedSizeInBytes();
+
+  std::vector<MemoryBudgetWarning> warnings;
+  tracker_->setBudget(small->getEstimatedSizeInBytes() + textureBytes,
+                      0.9f,
+                      [&warnings](const MemoryBudgetWarning& warning) {
+                        warnings.push_back(warning);
+                      });
+
+  auto texture = createTexture(16, 16);
+  ASSERT_EQ(warnings.size(), 1u);
+  ASSERT_FALSE(warnings[0].fromDevice);
+  ASSERT_EQ(warnings[0].usedBytes, small->getEstimatedSizeInBytes() + textureBytes);
+
+  // still over the threshold
+  auto buffer = createBuffer(16);
+  ASSERT_EQ(warnings.size(), 1u);
+
+  texture = nullptr;
+  buffer = nullptr;
+  texture = createTexture(16, 16);
+  ASSERT_EQ(warnings.size(), 2u);
+
+  // backends which cannot query the driver report it
+  DeviceMemoryUsage usage;
+  ASSERT_EQ(tracker_->checkDeviceBudget(*iglDev_), iglDev_->getDeviceMemoryUsage(usage));
+}
+
+} // namespace tests
+} // namespace igl
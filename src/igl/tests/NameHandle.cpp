@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <igl/NameHandle.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+TEST(NameHandleTest, Basic) {
+  const NameHandle a = IGL_NAMEHANDLE("uniformName");
+  const NameHandle b = genNameHandle("uniformName");
+  const NameHandle c = genNameHandle("otherName");
+
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(a.getCrc32(), b.getCrc32());
+  EXPECT_EQ(a.toString(), "uniformName");
+  EXPECT_STREQ(b.toConstChar(), "uniformName");
+
+  const NameHandle copy = c; // NOLINT(performance-unnecessary-copy-initialization)
+  EXPECT_EQ(copy, c);
+  EXPECT_EQ(copy.toString(), "otherName");
+
+  const NameHandle empty;
+  EXPECT_TRUE(empty.toString().empty());
+  EXPECT_STREQ(empty.toConstChar(), "");
+}
+
+#if IGL_NAMEHANDLE_INTERNED
+TEST(NameHandleTest, Interned) {
+  const NameHandle a = IGL_NAMEHANDLE("internedName");
+  const NameHandle b = genNameHandle(std::string("interned") + "Name");
+  EXPECT_EQ(&a.toString(), &b.toString());
+
+  // concurrent interning of the same names ends up with one entry per name
+  std::vector<const std::string*> entries(4);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i != entries.size(); i++) {
+    threads.emplace_back([&entries, i]() {
+      for (int j = 0; j != 1000; j++) {
+        entries[i] = &genNameHandle("concurrent" + std::to_string(j)).toString();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto* entry : entries) {
+    EXPECT_EQ(entry, entries[0]);
+    EXPECT_EQ(*entry, "concurrent999");
+  }
+}
+#endif // IGL_NAMEHANDLE_INTERNED
+
+} // namespace tests
+} // namespace igl
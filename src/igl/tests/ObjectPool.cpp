@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <igl/ObjectPool.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+namespace {
+struct PooledObject : public Pooled<PooledObject> {
+  explicit PooledObject(int value) : value(value) {}
+  virtual ~PooledObject() = default;
+  int value;
+  char payload[40] = {};
+};
+
+struct DerivedObject final : public PooledObject {
+  DerivedObject() : PooledObject(1) {}
+  char morePayload[100] = {};
+};
+
+struct SharedObject {
+  int value = 0;
+  char payload[72] = {};
+};
+} // namespace
+
+TEST(ObjectPoolTest, PooledReusesMemory) {
+  auto* first = new PooledObject(1); // NOLINT(cppcoreguidelines-owning-memory)
+  const void* address = first;
+  delete first; // NOLINT(cppcoreguidelines-owning-memory)
+
+  // the last freed block is handed out first
+  auto second = std::make_unique<PooledObject>(2);
+  ASSERT_EQ(second.get(), address);
+  ASSERT_EQ(second->value, 2);
+
+  // a derived class of a different size goes to the heap
+  const std::unique_ptr<PooledObject> derived = std::make_unique<DerivedObject>();
+  ASSERT_NE(derived.get(), nullptr);
+  ASSERT_EQ(derived->value, 1);
+}
+
+TEST(ObjectPoolTest, PoolAllocatorReusesMemory) {
+  const void* address = nullptr;
+  {
+    auto first = std::allocate_shared<SharedObject>(PoolAllocator<SharedObject>());
+    address = first.get();
+  }
+  auto second = std::allocate_shared<SharedObject>(PoolAllocator<SharedObject>());
+  ASSERT_EQ(second.get(), address);
+  ASSERT_EQ(second->value, 0);
+}
+
+TEST(ObjectPoolTest, FreeListIsBounded) {
+  using Pool = FixedSizeBlockPool<24, 8>;
+  std::vector<void*> blocks(Pool::kMaxFreeBlocks + 10);
+  for (auto& block : blocks) {
+    block = Pool::get().allocate();
+  }
+  for (auto* block : blocks) {
+    Pool::get().deallocate(block);
+  }
+  ASSERT_EQ(Pool::get().getNumFreeBlocks(), Pool::kMaxFreeBlocks);
+}
+
+TEST(ObjectPoolTest, Threads) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i != 4; i++) {
+    threads.emplace_back([i]() {
+      for (int j = 0; j != 1000; j++) {
+        auto object = std::make_unique<PooledObject>(i);
+        ASSERT_EQ(object->value, i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+} // namespace tests
+} // namespace igl
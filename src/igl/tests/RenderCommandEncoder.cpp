@@ -9,6 +9,7 @@
 #include <functional>
 #include <gtest/gtest.h>
 #include <memory>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -336,6 +337,155 @@ TEST_F(RenderCommandEncoderTest, shouldDrawAPoint) {
   verifyFrameBuffer(expectedPixels);
 }
 
+TEST_F(RenderCommandEncoderTest, shouldDrawPointsFromParallelEncoders) {
+  initializeBuffers(
+      // clang-format off
+      { quarterPixel, quarterPixel, 0.0f, 1.0f,
+        -1.0f + quarterPixel, -1.0f + quarterPixel, 0.0f, 1.0f },
+      { 0.5, 0.5,
+        0.5, 0.5 } // clang-format on
+  );
+
+  Result ret;
+
+  auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(cmdBuffer != nullptr);
+
+  auto parallelEncoder =
+      cmdBuffer->createParallelRenderCommandEncoder(renderPass_, framebuffer_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(parallelEncoder != nullptr);
+
+  // children are created on this thread to fix their execution order
+  auto encoder0 = parallelEncoder->createRenderCommandEncoder(&ret);
+  ASSERT_TRUE(ret.isOk());
+  auto encoder1 = parallelEncoder->createRenderCommandEncoder(&ret);
+  ASSERT_TRUE(ret.isOk());
+
+  auto record = [this](IRenderCommandEncoder* encoder, size_t vertexStart) {
+    encoder->bindTexture(textureUnit_, BindTarget::kFragment, texture_.get());
+    encoder->bindSamplerState(textureUnit_, BindTarget::kFragment, samp_.get());
+
+    encoder->bindBuffer(data::shader::simplePosIndex, BindTarget::kVertex, vb_, 0);
+    encoder->bindBuffer(data::shader::simpleUvIndex, BindTarget::kVertex, uv_, 0);
+
+    encoder->bindRenderPipelineState(renderPipelineState_);
+    encoder->bindDepthStencilState(depthStencilState_);
+
+    encoder->draw(PrimitiveType::Point, vertexStart, 1);
+    encoder->endEncoding();
+  };
+
+  std::thread thread0(record, encoder0.get(), 0);
+  std::thread thread1(record, encoder1.get(), 1);
+  thread0.join();
+  thread1.join();
+
+  parallelEncoder->endEncoding();
+
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  auto grayColor = data::texture::TEX_RGBA_GRAY_4x4[0];
+  // clang-format off
+  std::vector<uint32_t> expectedPixels {
+    backgroundColorHex, backgroundColorHex, backgroundColorHex, backgroundColorHex,
+    backgroundColorHex, backgroundColorHex, grayColor,          backgroundColorHex,
+    backgroundColorHex, backgroundColorHex, backgroundColorHex, backgroundColorHex,
+    grayColor,          backgroundColorHex, backgroundColorHex, backgroundColorHex,
+  };
+  // clang-format on
+
+  verifyFrameBuffer(expectedPixels);
+}
+
+TEST_F(RenderCommandEncoderTest, shouldDrawRenderBundleRepeatedly) {
+  initializeBuffers(
+      // clang-format off
+      { quarterPixel, quarterPixel, 0.0f, 1.0f,
+        -1.0f + quarterPixel, -1.0f + quarterPixel, 0.0f, 1.0f },
+      { 0.5, 0.5,
+        0.5, 0.5 } // clang-format on
+  );
+
+  Result ret;
+  RenderBundleDesc bundleDesc;
+  bundleDesc.debugName = "shouldDrawRenderBundleRepeatedly";
+  std::shared_ptr<IRenderBundle> bundle = iglDev_->createRenderBundle(bundleDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(bundle != nullptr);
+
+  auto recorder = bundle->createRenderCommandEncoder(&ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(recorder != nullptr);
+  ASSERT_TRUE(bundle->isRecording());
+
+  const igl::Viewport viewport = {
+      0.0f, 0.0f, (float)OFFSCREEN_RT_WIDTH, (float)OFFSCREEN_RT_HEIGHT, 0.0f, +1.0f};
+  const igl::ScissorRect scissor = {
+      0, 0, (uint32_t)OFFSCREEN_RT_WIDTH, (uint32_t)OFFSCREEN_RT_HEIGHT};
+  recorder->bindViewport(viewport);
+  recorder->bindScissorRect(scissor);
+  recorder->bindTexture(textureUnit_, BindTarget::kFragment, texture_.get());
+  recorder->bindSamplerState(textureUnit_, BindTarget::kFragment, samp_.get());
+  recorder->bindBuffer(data::shader::simplePosIndex, BindTarget::kVertex, vb_, 0);
+  recorder->bindBuffer(data::shader::simpleUvIndex, BindTarget::kVertex, uv_, 0);
+  recorder->bindRenderPipelineState(renderPipelineState_);
+  recorder->bindDepthStencilState(depthStencilState_);
+  recorder->draw(PrimitiveType::Point, 0, 1);
+  recorder->endEncoding();
+  ASSERT_FALSE(bundle->isRecording());
+  ASSERT_EQ(bundle->getCommandStream().getNumCommands(), 9);
+
+  auto grayColor = data::texture::TEX_RGBA_GRAY_4x4[0];
+  // clang-format off
+  std::vector<uint32_t> expectedPixels {
+    backgroundColorHex, backgroundColorHex, backgroundColorHex, backgroundColorHex,
+    backgroundColorHex, backgroundColorHex, grayColor,          backgroundColorHex,
+    backgroundColorHex, backgroundColorHex, backgroundColorHex, backgroundColorHex,
+    backgroundColorHex, backgroundColorHex, backgroundColorHex, backgroundColorHex,
+  };
+  // clang-format on
+
+  // a regular encoder replays the bundle
+  encodeAndSubmit([&bundle](const std::unique_ptr<igl::IRenderCommandEncoder>& encoder) {
+    encoder->executeRenderBundle(*bundle);
+  });
+  verifyFrameBuffer(expectedPixels);
+
+  // the same bundle runs in every frame, next to the commands of a child encoder
+  expectedPixels[12] = grayColor;
+  for (int frame = 0; frame != 2; frame++) {
+    auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &ret);
+    ASSERT_TRUE(ret.isOk());
+    auto parallelEncoder =
+        cmdBuffer->createParallelRenderCommandEncoder(renderPass_, framebuffer_, &ret);
+    ASSERT_TRUE(ret.isOk());
+    ASSERT_TRUE(parallelEncoder != nullptr);
+
+    parallelEncoder->executeRenderBundle(*bundle);
+
+    auto encoder = parallelEncoder->createRenderCommandEncoder(&ret);
+    ASSERT_TRUE(ret.isOk());
+    encoder->bindTexture(textureUnit_, BindTarget::kFragment, texture_.get());
+    encoder->bindSamplerState(textureUnit_, BindTarget::kFragment, samp_.get());
+    encoder->bindBuffer(data::shader::simplePosIndex, BindTarget::kVertex, vb_, 0);
+    encoder->bindBuffer(data::shader::simpleUvIndex, BindTarget::kVertex, uv_, 0);
+    encoder->bindRenderPipelineState(renderPipelineState_);
+    encoder->bindDepthStencilState(depthStencilState_);
+    encoder->draw(PrimitiveType::Point, 1, 1);
+    encoder->endEncoding();
+
+    parallelEncoder->endEncoding();
+
+    cmdQueue_->submit(*cmdBuffer);
+    cmdBuffer->waitUntilCompleted();
+
+    verifyFrameBuffer(expectedPixels);
+  }
+}
+
 TEST_F(RenderCommandEncoderTest, shouldDrawALine) {
   initializeBuffers(
       // clang-format off
@@ -459,6 +609,143 @@ TEST_F(RenderCommandEncoderTest, shouldDrawTriangleStrip) {
   });
 }
 
+TEST_F(RenderCommandEncoderTest, shouldDrawWithBindingsByReference) {
+  initializeBuffers(
+      // clang-format off
+      {
+        -1.0f,  1.0f, 0.0f, 1.0f,
+        -1.0f, -1.0f, 0.0f, 1.0f,
+         1.0f,  1.0f, 0.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f,
+      },
+      {
+        0.0, 1.0,
+        0.0, 0.0,
+        1.0, 1.0,
+        1.0, 0.0,
+      } // clang-format on
+  );
+
+  // rebinding the same objects without retaining them
+  encodeAndSubmit([this](const std::unique_ptr<igl::IRenderCommandEncoder>& encoder) {
+    encoder->bindBuffer(data::shader::simplePosIndex, BindTarget::kVertex, *vb_, 0);
+    encoder->bindBuffer(data::shader::simpleUvIndex, BindTarget::kVertex, *uv_, 0);
+    encoder->bindRenderPipelineState(*renderPipelineState_);
+    encoder->bindDepthStencilState(*depthStencilState_);
+    encoder->draw(PrimitiveType::TriangleStrip, 0, 4);
+  });
+
+  verifyFrameBuffer([](const std::vector<uint32_t>& pixels) {
+    for (auto& pixel : pixels) {
+      ASSERT_EQ(pixel, data::texture::TEX_RGBA_GRAY_4x4[0]);
+    }
+  });
+}
+
+TEST_F(RenderCommandEncoderTest, shouldDrawWithBindGroup) {
+  initializeBuffers(
+      // clang-format off
+      {
+        -1.0f,  1.0f, 0.0f, 1.0f,
+        -1.0f, -1.0f, 0.0f, 1.0f,
+         1.0f,  1.0f, 0.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f,
+      },
+      {
+        0.0, 1.0,
+        0.0, 0.0,
+        1.0, 1.0,
+        1.0, 0.0,
+      } // clang-format on
+  );
+
+  Result ret;
+  const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                 OFFSCREEN_TEX_WIDTH,
+                                                 OFFSCREEN_TEX_HEIGHT,
+                                                 TextureDesc::TextureUsageBits::Sampled);
+  std::shared_ptr<ITexture> texture = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  texture->upload(TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, OFFSCREEN_TEX_HEIGHT),
+                  data::texture::TEX_RGBA_BLUE_ALPHA_127_4x4);
+
+  BindGroupDesc bindGroupDesc;
+  bindGroupDesc.textures[textureUnit_] = texture;
+  bindGroupDesc.target = BindTarget::kFragment;
+  // every texture needs a sampler
+  ASSERT_EQ(iglDev_->createBindGroup(bindGroupDesc, &ret), nullptr);
+  ASSERT_EQ(ret.code, Result::Code::ArgumentInvalid);
+
+  bindGroupDesc.samplers[textureUnit_] = samp_;
+  bindGroupDesc.debugName = "shouldDrawWithBindGroup";
+  std::shared_ptr<IBindGroup> bindGroup = iglDev_->createBindGroup(bindGroupDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_TRUE(bindGroup != nullptr);
+  ASSERT_EQ(bindGroup->getTextureMask(), 1u << textureUnit_);
+  ASSERT_EQ(bindGroup->getBufferMask(), 0u);
+
+  // the group replaces the texture bound by encodeAndSubmit(), and binding it again is a no-op
+  encodeAndSubmit([&bindGroup](const std::unique_ptr<igl::IRenderCommandEncoder>& encoder) {
+    encoder->bindBindGroup(*bindGroup);
+    encoder->bindBindGroup(*bindGroup);
+    encoder->draw(PrimitiveType::TriangleStrip, 0, 4);
+  });
+
+  verifyFrameBuffer([](const std::vector<uint32_t>& pixels) {
+    for (auto& pixel : pixels) {
+      ASSERT_EQ(pixel, data::texture::TEX_RGBA_BLUE_ALPHA_127_4x4[0]);
+    }
+  });
+}
+
+TEST_F(RenderCommandEncoderTest, shouldDrawIndexedWithBaseVertex) {
+  if (!iglDev_->hasFeature(DeviceFeatures::DrawBaseVertex)) {
+    GTEST_SKIP() << "Base vertex is not supported";
+  }
+
+  // the quad starts at vertex 2 of the buffers, as if other meshes preceded it
+  initializeBuffers(
+      // clang-format off
+      {
+         0.0f,  0.0f, 0.0f, 1.0f,
+         0.0f,  0.0f, 0.0f, 1.0f,
+        -1.0f,  1.0f, 0.0f, 1.0f,
+        -1.0f, -1.0f, 0.0f, 1.0f,
+         1.0f,  1.0f, 0.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f,
+      },
+      {
+        0.0, 0.0,
+        0.0, 0.0,
+        0.0, 1.0,
+        0.0, 0.0,
+        1.0, 1.0,
+        1.0, 0.0,
+      } // clang-format on
+  );
+
+  // the indices of the quad are zero-based and start after the indices of another mesh
+  const std::vector<uint16_t> indices = {5, 5, 0, 1, 2, 3};
+  BufferDesc bufDesc(BufferDesc::BufferTypeBits::Index,
+                     indices.data(),
+                     sizeof(uint16_t) * indices.size());
+  Result ret;
+  std::shared_ptr<IBuffer> ib = iglDev_->createBuffer(bufDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(ib != nullptr);
+
+  encodeAndSubmit([&ib](const std::unique_ptr<igl::IRenderCommandEncoder>& encoder) {
+    encoder->drawIndexed(
+        PrimitiveType::TriangleStrip, 4, IndexFormat::UInt16, *ib, 2 * sizeof(uint16_t), 1, 2);
+  });
+
+  verifyFrameBuffer([](const std::vector<uint32_t>& pixels) {
+    for (auto& pixel : pixels) {
+      ASSERT_EQ(pixel, data::texture::TEX_RGBA_GRAY_4x4[0]);
+    }
+  });
+}
+
 TEST_F(RenderCommandEncoderTest, shouldNotDraw) {
   initializeBuffers(
       // clang-format off
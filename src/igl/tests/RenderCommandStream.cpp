@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <igl/RenderCommandStream.h>
+#include <string>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+namespace {
+// Logs the calls it receives
+class LoggingRenderCommandEncoder final : public IRenderCommandEncoder {
+ public:
+  LoggingRenderCommandEncoder() : IRenderCommandEncoder(nullptr) {}
+
+  mutable std::vector<std::string> log;
+
+  void endEncoding() override {
+    log.emplace_back("endEncoding");
+  }
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override {
+    log.push_back("push " + label + " " + std::to_string(color.g));
+  }
+  void insertDebugEventLabel(const std::string& label, const igl::Color& /*color*/) const override {
+    log.push_back("insert " + label);
+  }
+  void popDebugGroupLabel() const override {
+    log.emplace_back("pop");
+  }
+  void bindViewport(const Viewport& viewport) override {
+    log.push_back("viewport " + std::to_string(int(viewport.width)));
+  }
+  void bindScissorRect(const ScissorRect& rect) override {
+    log.push_back("scissor " + std::to_string(rect.height));
+  }
+  void bindRenderPipelineState(
+      const std::shared_ptr<IRenderPipelineState>& /*pipelineState*/) override {
+    log.emplace_back("pipeline shared");
+  }
+  void bindDepthStencilState(
+      const std::shared_ptr<IDepthStencilState>& /*depthStencilState*/) override {
+    log.emplace_back("depthStencil shared");
+  }
+  void bindRenderPipelineState(IRenderPipelineState& /*pipelineState*/) override {
+    log.emplace_back("pipeline");
+  }
+  void bindDepthStencilState(IDepthStencilState& /*depthStencilState*/) override {
+    log.emplace_back("depthStencil");
+  }
+  void bindBuffer(int index,
+                  uint8_t /*target*/,
+                  const std::shared_ptr<IBuffer>& buffer,
+                  size_t bufferOffset) override {
+    log.push_back("buffer shared " + std::to_string(index) + " " + std::to_string(bufferOffset) +
+                  (buffer ? "" : " null"));
+  }
+  void bindBuffer(int index,
+                  uint8_t /*target*/,
+                  IBuffer& /*buffer*/,
+                  size_t bufferOffset) override {
+    log.push_back("buffer " + std::to_string(index) + " " + std::to_string(bufferOffset));
+  }
+  void bindBytes(size_t index, uint8_t target, const void* data, size_t length) override {
+    log.push_back("bytes " + std::to_string(index) + " " + std::to_string(target) + " " +
+                  (data ? std::string(static_cast<const char*>(data), length) : "null"));
+  }
+  void bindPushConstants(const void* data, size_t length, size_t offset) override {
+    log.push_back("push constants " + std::to_string(offset) + " " +
+                  (data ? std::string(static_cast<const char*>(data), length) : "null"));
+  }
+  void bindBufferAddress(size_t offset, IBuffer& /*buffer*/, size_t /*bufferOffset*/) override {
+    log.push_back("address " + std::to_string(offset));
+  }
+  void bindSamplerState(size_t index,
+                        uint8_t /*target*/,
+                        ISamplerState* samplerState) override {
+    log.push_back("sampler " + std::to_string(index) + (samplerState ? "" : " null"));
+  }
+  void bindTexture(size_t index, uint8_t /*target*/, ITexture* texture) override {
+    log.push_back("texture " + std::to_string(index) + (texture ? "" : " null"));
+  }
+  void bindUniform(const UniformDesc& uniformDesc, const void* data) override {
+    float value = 0;
+    if (data) {
+      memcpy(&value, data, sizeof(value));
+    }
+    log.push_back("uniform " + uniformDesc.name + " " + std::to_string(uniformDesc.offset) + " " +
+                  std::to_string(int(value)));
+  }
+  void draw(PrimitiveType /*primitiveType*/,
+            size_t vertexStart,
+            size_t vertexCount,
+            uint32_t instanceCount,
+            uint32_t baseInstance) override {
+    std::string entry = "draw " + std::to_string(vertexStart) + " " + std::to_string(vertexCount);
+    if (instanceCount != 1 || baseInstance != 0) {
+      entry += " instances " + std::to_string(instanceCount) + " " + std::to_string(baseInstance);
+    }
+    log.push_back(entry);
+  }
+  void drawIndexed(PrimitiveType /*primitiveType*/,
+                   size_t indexCount,
+                   IndexFormat /*indexFormat*/,
+                   IBuffer& /*indexBuffer*/,
+                   size_t /*indexBufferOffset*/,
+                   uint32_t /*instanceCount*/,
+                   int32_t /*baseVertex*/,
+                   uint32_t /*baseInstance*/) override {
+    log.push_back("drawIndexed " + std::to_string(indexCount));
+  }
+  void drawIndexedIndirect(PrimitiveType /*primitiveType*/,
+                           IndexFormat /*indexFormat*/,
+                           IBuffer& /*indexBuffer*/,
+                           IBuffer& /*indirectBuffer*/,
+                           size_t /*indirectBufferOffset*/) override {
+    log.emplace_back("drawIndexedIndirect");
+  }
+  void multiDrawIndirect(PrimitiveType /*primitiveType*/,
+                         IBuffer& /*indirectBuffer*/,
+                         size_t /*indirectBufferOffset*/,
+                         uint32_t drawCount,
+                         uint32_t /*stride*/) override {
+    log.push_back("multiDrawIndirect " + std::to_string(drawCount));
+  }
+  void multiDrawIndexedIndirect(PrimitiveType /*primitiveType*/,
+                                IndexFormat /*indexFormat*/,
+                                IBuffer& /*indexBuffer*/,
+                                IBuffer& /*indirectBuffer*/,
+                                size_t /*indirectBufferOffset*/,
+                                uint32_t drawCount,
+                                uint32_t /*stride*/) override {
+    log.push_back("multiDrawIndexedIndirect " + std::to_string(drawCount));
+  }
+  void setStencilReferenceValue(uint32_t value) override {
+    log.push_back("stencil " + std::to_string(value));
+  }
+  void setStencilReferenceValues(uint32_t frontValue, uint32_t backValue) override {
+    log.push_back("stencil " + std::to_string(frontValue) + " " + std::to_string(backValue));
+  }
+  void setBlendColor(Color color) override {
+    log.push_back("blend " + std::to_string(int(color.b)));
+  }
+  void setDepthBias(float depthBias, float /*slopeScale*/, float /*clamp*/) override {
+    log.push_back("depthBias " + std::to_string(int(depthBias)));
+  }
+  void beginOcclusionQuery(uint32_t queryIndex) override {
+    log.push_back("beginQuery " + std::to_string(queryIndex));
+  }
+  void endOcclusionQuery() override {
+    log.emplace_back("endQuery");
+  }
+  void nextSubpass() override {
+    log.emplace_back("nextSubpass");
+  }
+};
+} // namespace
+
+TEST(RenderCommandStreamTest, ReplaysCommandsInOrder) {
+  auto stream = std::make_shared<RenderCommandStream>();
+  RecordingRenderCommandEncoder recorder(nullptr, stream);
+
+  recorder.pushDebugGroupLabel("pass", Color(0, 1, 0));
+  recorder.bindViewport({0, 0, 64, 32});
+  recorder.bindScissorRect({0, 0, 64, 32});
+  recorder.bindBuffer(1, BindTarget::kVertex, std::shared_ptr<IBuffer>(), 16);
+  {
+    // the bytes are copied
+    char bytes[] = "abc";
+    recorder.bindBytes(2, BindTarget::kFragment, bytes, 3);
+    bytes[0] = 'x';
+    recorder.bindPushConstants(bytes, 3, 8);
+  }
+  recorder.bindBytes(3, BindTarget::kFragment, nullptr, 0);
+  {
+    const float values[] = {1.0f, 7.0f};
+    UniformDesc desc;
+    desc.name = "value";
+    desc.type = UniformType::Float;
+    desc.offset = sizeof(float);
+    recorder.bindUniform(desc, values);
+  }
+  recorder.bindTexture(0, BindTarget::kFragment, nullptr);
+  recorder.bindSamplerState(0, BindTarget::kFragment, nullptr);
+  recorder.setStencilReferenceValue(5);
+  recorder.setStencilReferenceValues(1, 2);
+  recorder.setBlendColor(Color(0, 0, 3));
+  recorder.setDepthBias(4, 0, 0);
+  recorder.beginOcclusionQuery(6);
+  recorder.draw(PrimitiveType::Triangle, 3, 6);
+  recorder.draw(PrimitiveType::Triangle, 0, 3, 4, 2);
+  recorder.endOcclusionQuery();
+  recorder.nextSubpass();
+  recorder.insertDebugEventLabel("event", Color(1, 1, 1));
+  recorder.popDebugGroupLabel();
+  recorder.endEncoding();
+
+  const std::vector<std::string> expected = {
+      "push pass 1.000000",
+      "viewport 64",
+      "scissor 32",
+      "buffer shared 1 16 null",
+      "bytes 2 2 abc",
+      "push constants 8 xbc",
+      "bytes 3 2 null",
+      "uniform value 0 7",
+      "texture 0 null",
+      "sampler 0 null",
+      "stencil 5",
+      "stencil 1 2",
+      "blend 3",
+      "depthBias 4",
+      "beginQuery 6",
+      "draw 3 6",
+      "draw 0 3 instances 4 2",
+      "endQuery",
+      "nextSubpass",
+      "insert event",
+      "pop",
+  };
+  ASSERT_EQ(stream->getNumCommands(), expected.size());
+
+  // replaying does not consume the stream
+  for (int i = 0; i != 2; i++) {
+    LoggingRenderCommandEncoder encoder;
+    stream->replay(encoder);
+    ASSERT_EQ(encoder.log, expected);
+  }
+}
+
+TEST(RenderCommandStreamTest, ClearAndReuse) {
+  auto stream = std::make_shared<RenderCommandStream>();
+  {
+    RecordingRenderCommandEncoder recorder(nullptr, stream);
+    for (size_t i = 0; i != 100; i++) {
+      recorder.draw(PrimitiveType::Triangle, i, 3);
+    }
+    recorder.endEncoding();
+  }
+  ASSERT_EQ(stream->getNumCommands(), 100u);
+  const size_t size = stream->getSizeInBytes();
+  ASSERT_GT(size, 0u);
+
+  stream->clear();
+  ASSERT_TRUE(stream->empty());
+  ASSERT_EQ(stream->getSizeInBytes(), 0u);
+
+  {
+    RecordingRenderCommandEncoder recorder(nullptr, stream);
+    recorder.draw(PrimitiveType::Point, 1, 2);
+    recorder.endEncoding();
+  }
+  LoggingRenderCommandEncoder encoder;
+  stream->replay(encoder);
+  ASSERT_EQ(encoder.log, std::vector<std::string>{"draw 1 2"});
+}
+
+} // namespace tests
+} // namespace igl
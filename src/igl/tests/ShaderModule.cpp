@@ -119,5 +119,103 @@ TEST_F(ShaderModuleTest, CompileShaderModuleNoResult) {
       *iglDev_, source, {ShaderStage::Vertex, "vertexShader"}, "", nullptr);
   ASSERT_TRUE(shaderModule != nullptr);
 }
+
+TEST_F(ShaderModuleTest, CompileShaderModules) {
+  const char* vertSource = nullptr;
+  const char* fragSource = nullptr;
+  if (backend_ == util::BACKEND_OGL) {
+    vertSource = data::shader::OGL_SIMPLE_VERT_SHADER;
+    fragSource = data::shader::OGL_SIMPLE_FRAG_SHADER;
+  } else if (backend_ == util::BACKEND_MTL) {
+    vertSource = data::shader::MTL_SIMPLE_SHADER;
+    fragSource = data::shader::MTL_SIMPLE_SHADER;
+  } else if (backend_ == util::BACKEND_VUL) {
+    vertSource = data::shader::VULKAN_SIMPLE_VERT_SHADER;
+    fragSource = data::shader::VULKAN_SIMPLE_FRAG_SHADER;
+  } else {
+    ASSERT_TRUE(0);
+  }
+
+  std::vector<ShaderModuleDesc> descs;
+  for (int i = 0; i != 4; i++) {
+    descs.push_back(ShaderModuleDesc::fromStringInput(
+        vertSource, {ShaderStage::Vertex, "vertexShader"}, "vert" + std::to_string(i)));
+    descs.push_back(ShaderModuleDesc::fromStringInput(
+        fragSource, {ShaderStage::Fragment, "fragmentShader"}, "frag" + std::to_string(i)));
+  }
+
+  Result ret;
+  auto modules = iglDev_->createShaderModules(descs, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_EQ(modules.size(), descs.size());
+  for (size_t i = 0; i != modules.size(); i++) {
+    ASSERT_TRUE(modules[i] != nullptr);
+    ASSERT_EQ(modules[i]->info().stage, descs[i].info.stage);
+  }
+
+  // a failure does not prevent the other modules from being created
+  descs[1] = ShaderModuleDesc::fromStringInput("", {ShaderStage::Fragment, "fragmentShader"}, "");
+  modules = iglDev_->createShaderModules(descs, &ret);
+  ASSERT_FALSE(ret.isOk());
+  ASSERT_EQ(modules.size(), descs.size());
+  ASSERT_TRUE(modules[0] != nullptr);
+  ASSERT_TRUE(modules[1] == nullptr);
+  ASSERT_TRUE(modules[2] != nullptr);
+
+  ASSERT_TRUE(iglDev_->createShaderModules({}, &ret).empty());
+  ASSERT_TRUE(ret.isOk());
+}
+TEST_F(ShaderModuleTest, SpecializationConstants) {
+  const char* source = nullptr;
+  if (backend_ == util::BACKEND_OGL) {
+    source = R"(
+      void main() {
+        gl_Position = kFlip ? vec4(1.0) : vec4(0.0);
+      })";
+  } else if (backend_ == util::BACKEND_MTL) {
+    source = R"(
+      #include <metal_stdlib>
+      using namespace metal;
+      constant bool kFlip [[function_constant(0)]];
+      vertex float4 vertexShader() {
+        return kFlip ? float4(1.0) : float4(0.0);
+      })";
+  } else if (backend_ == util::BACKEND_VUL) {
+    source = R"(
+      layout (constant_id = 0) const bool kFlip = false;
+      void main() {
+        gl_Position = kFlip ? vec4(1.0) : vec4(0.0);
+      })";
+  } else {
+    ASSERT_TRUE(0);
+  }
+
+  for (const bool flip : {false, true}) {
+    ShaderModuleInfo info = {ShaderStage::Vertex, "vertexShader"};
+    info.specializationConstants = {ShaderSpecializationConstant::fromBool(0, "kFlip", flip)};
+    Result ret;
+    auto shaderModule = ShaderModuleCreator::fromStringInput(*iglDev_, source, info, "", &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+    ASSERT_TRUE(shaderModule != nullptr);
+    ASSERT_EQ(shaderModule->info().specializationConstants, info.specializationConstants);
+  }
+}
+
+TEST(ShaderSpecializationConstantTest, Values) {
+  const auto constant = ShaderSpecializationConstant::fromFloat(3, "kScale", -2.5f);
+  ASSERT_EQ(constant.type, ShaderSpecializationConstant::Type::Float);
+  ASSERT_EQ(constant.asFloat(), -2.5f);
+  ASSERT_EQ(ShaderSpecializationConstant::fromInt(0, "kCount", -7).asInt(), -7);
+  ASSERT_EQ(ShaderSpecializationConstant::fromBool(0, "kFlag", true).value, 1u);
+
+  // modules which differ only by their constants are different
+  ShaderModuleInfo a = {ShaderStage::Fragment, "main"};
+  ShaderModuleInfo b = a;
+  a.specializationConstants = {ShaderSpecializationConstant::fromUInt(0, "kMode", 1)};
+  b.specializationConstants = {ShaderSpecializationConstant::fromUInt(0, "kMode", 2)};
+  ASSERT_NE(a, b);
+  ASSERT_NE(std::hash<ShaderModuleInfo>()(a), std::hash<ShaderModuleInfo>()(b));
+}
+
 } // namespace tests
 } // namespace igl
@@ -11,6 +11,7 @@
 #include "util/Common.h"
 #include "util/TestDevice.h"
 
+#include <cstring>
 #include <gtest/gtest.h>
 #include <igl/IGL.h>
 #include <igl/NameHandle.h>
@@ -389,6 +390,33 @@ TEST(TextureFormatProperties, getBytesPerRange) {
   }
 }
 
+TEST(TextureFormatProperties, MultiPlanar) {
+  const auto range = TextureRangeDesc::new2D(0, 0, 10, 6);
+  {
+    const auto props = TextureFormatProperties::fromTextureFormat(TextureFormat::YUV_NV12);
+    EXPECT_TRUE(props.isMultiPlanar());
+    EXPECT_FALSE(props.isCompressed());
+    EXPECT_EQ(props.getNumPlanes(), 2);
+    // 10 x 6 luma samples + 5 x 3 CbCr pairs
+    EXPECT_EQ(props.getBytesPerLayer(range), 10 * 6 + 5 * 3 * 2);
+  }
+  {
+    const auto props = TextureFormatProperties::fromTextureFormat(TextureFormat::YUV_P010);
+    EXPECT_TRUE(props.isMultiPlanar());
+    EXPECT_EQ(props.getBytesPerLayer(range), (10 * 6 + 5 * 3 * 2) * 2);
+  }
+  {
+    const auto props = TextureFormatProperties::fromTextureFormat(TextureFormat::RGBA_UNorm8);
+    EXPECT_FALSE(props.isMultiPlanar());
+    EXPECT_EQ(props.getNumPlanes(), 1);
+  }
+  EXPECT_EQ(getTextureFormatOfPlane(TextureFormat::YUV_NV12, 0), TextureFormat::R_UNorm8);
+  EXPECT_EQ(getTextureFormatOfPlane(TextureFormat::YUV_NV12, 1), TextureFormat::RG_UNorm8);
+  EXPECT_EQ(getTextureFormatOfPlane(TextureFormat::YUV_P010, 1), TextureFormat::RG_UNorm16);
+  EXPECT_EQ(getTextureFormatOfPlane(TextureFormat::YUV_NV12, 2), TextureFormat::Invalid);
+  EXPECT_EQ(getTextureFormatOfPlane(TextureFormat::RGBA_UNorm8, 0), TextureFormat::RGBA_UNorm8);
+}
+
 //
 // Texture Passthrough Test
 //
@@ -460,6 +488,62 @@ TEST_F(TextureTest, Passthrough) {
   }
 }
 
+//
+// The same as Passthrough with 24-bit RGB texels, which backends that cannot sample them expand
+// to RGBA on upload
+//
+TEST_F(TextureTest, PassthroughRGBX) {
+  if (!contains(iglDev_->getTextureFormatCapabilities(TextureFormat::RGBX_UNorm8),
+                ICapabilities::TextureFormatCapabilityBits::Sampled)) {
+    GTEST_SKIP() << "RGBX_UNorm8 is not supported";
+  }
+
+  Result ret;
+  const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBX_UNorm8,
+                                                 OFFSCREEN_TEX_WIDTH,
+                                                 OFFSCREEN_TEX_HEIGHT,
+                                                 TextureDesc::TextureUsageBits::Sampled);
+  inputTexture_ = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok) << ret.message;
+  ASSERT_TRUE(inputTexture_ != nullptr);
+
+  constexpr size_t kNumPixels = OFFSCREEN_TEX_WIDTH * OFFSCREEN_TEX_HEIGHT;
+  std::vector<uint8_t> rgb(3 * kNumPixels);
+  for (size_t i = 0; i < kNumPixels; i++) {
+    memcpy(&rgb[3 * i], &data::texture::TEX_RGBA_2x2[i], 3);
+  }
+  const auto rangeDesc = TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, OFFSCREEN_TEX_HEIGHT);
+  ASSERT_TRUE(inputTexture_->upload(rangeDesc, rgb.data()).isOk());
+
+  auto pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(cmdBuf_ != nullptr);
+
+  auto cmds = cmdBuf_->createRenderCommandEncoder(renderPass_, framebuffer_);
+  cmds->bindBuffer(data::shader::simplePosIndex, BindTarget::kVertex, vb_, 0);
+  cmds->bindBuffer(data::shader::simpleUvIndex, BindTarget::kVertex, uv_, 0);
+  cmds->bindRenderPipelineState(pipelineState);
+  cmds->bindTexture(textureUnit_, BindTarget::kFragment, inputTexture_.get());
+  cmds->bindSamplerState(textureUnit_, BindTarget::kFragment, samp_.get());
+  cmds->drawIndexed(PrimitiveType::Triangle, 6, IndexFormat::UInt16, *ib_, 0);
+  cmds->endEncoding();
+
+  cmdQueue_->submit(*cmdBuf_);
+  cmdBuf_->waitUntilCompleted();
+
+  auto pixels = std::vector<uint32_t>(kNumPixels);
+  framebuffer_->copyBytesColorAttachment(*cmdQueue_, 0, pixels.data(), rangeDesc);
+
+  // alpha is one
+  for (size_t i = 0; i < kNumPixels; i++) {
+    ASSERT_EQ(pixels[i], data::texture::TEX_RGBA_2x2[i] | 0xff000000);
+  }
+}
+
 //
 // This test uses a simple shader to copy the input texture with a
 // texture to a same sized output texture (offscreenTexture_)
@@ -542,6 +626,89 @@ TEST_F(TextureTest, PassthroughSubTexture) {
   ASSERT_EQ(pixels[OFFSCREEN_TEX_HEIGHT * OFFSCREEN_TEX_HEIGHT - 1], singlePixelColor);
 }
 
+//
+// Same as PassthroughSubTexture, but the texture and the sub-texture are uploaded with a single
+// ITexture::uploadRegions() call.
+//
+TEST_F(TextureTest, PassthroughUploadRegions) {
+  Result ret;
+  std::shared_ptr<IRenderPipelineState> pipelineState;
+
+  TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                           OFFSCREEN_TEX_WIDTH,
+                                           OFFSCREEN_TEX_HEIGHT,
+                                           TextureDesc::TextureUsageBits::Sampled);
+  inputTexture_ = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(inputTexture_ != nullptr);
+
+  const auto rangeDesc = TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, OFFSCREEN_TEX_HEIGHT);
+  const int32_t singlePixelColor = 0x44332211;
+
+  // the later region overwrites the lower-right corner of the earlier one
+  ret = inputTexture_->uploadRegions({
+      {rangeDesc, data::texture::TEX_RGBA_2x2, 0},
+      {TextureRangeDesc::new2D(OFFSCREEN_TEX_WIDTH - 1, OFFSCREEN_TEX_HEIGHT - 1, 1, 1),
+       &singlePixelColor,
+       0},
+  });
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+
+  pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  cmdBuf_ = cmdQueue_->createCommandBuffer(cbDesc_, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(cmdBuf_ != nullptr);
+
+  auto cmds = cmdBuf_->createRenderCommandEncoder(renderPass_, framebuffer_);
+  cmds->bindBuffer(data::shader::simplePosIndex, BindTarget::kVertex, vb_, 0);
+  cmds->bindBuffer(data::shader::simpleUvIndex, BindTarget::kVertex, uv_, 0);
+  cmds->bindRenderPipelineState(pipelineState);
+  cmds->bindTexture(textureUnit_, BindTarget::kFragment, inputTexture_.get());
+  cmds->bindSamplerState(textureUnit_, BindTarget::kFragment, samp_.get());
+  cmds->drawIndexed(PrimitiveType::Triangle, 6, IndexFormat::UInt16, *ib_, 0);
+  cmds->endEncoding();
+
+  cmdQueue_->submit(*cmdBuf_);
+  cmdBuf_->waitUntilCompleted();
+
+  auto pixels = std::vector<uint32_t>(OFFSCREEN_TEX_WIDTH * OFFSCREEN_TEX_HEIGHT);
+  framebuffer_->copyBytesColorAttachment(*cmdQueue_, 0, pixels.data(), rangeDesc);
+
+  for (size_t i = 0; i < OFFSCREEN_TEX_WIDTH * OFFSCREEN_TEX_HEIGHT - 1; i++) {
+    ASSERT_EQ(pixels[i], data::texture::TEX_RGBA_2x2[i]);
+  }
+  ASSERT_EQ(pixels[OFFSCREEN_TEX_HEIGHT * OFFSCREEN_TEX_HEIGHT - 1], singlePixelColor);
+}
+
+TEST_F(TextureTest, UploadTextureRegions) {
+  Result ret;
+  const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                 OFFSCREEN_TEX_WIDTH,
+                                                 OFFSCREEN_TEX_HEIGHT,
+                                                 TextureDesc::TextureUsageBits::Sampled);
+  auto texture0 = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  auto texture1 = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+
+  const auto rangeDesc = TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, OFFSCREEN_TEX_HEIGHT);
+  const TextureRegionUpload region = {rangeDesc, data::texture::TEX_RGBA_2x2, 0};
+
+  ret = iglDev_->uploadTextureRegions({{texture0.get(), region}, {texture1.get(), region}});
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+
+  ASSERT_TRUE(iglDev_->uploadTextureRegions({}).isOk());
+
+  // an invalid region is reported without preventing the other uploads
+  TextureRegionUpload outOfRange = region;
+  outOfRange.range.x = OFFSCREEN_TEX_WIDTH;
+  ret = iglDev_->uploadTextureRegions({{texture0.get(), outOfRange}, {texture1.get(), region}});
+  ASSERT_EQ(ret.code, Result::Code::ArgumentOutOfRange);
+}
+
 //
 // Framebuffer to Texture Copy Test
 //
@@ -1147,7 +1314,10 @@ void validateMipLevels(IDevice& device,
   }
 }
 
-void testGenerateMipmap(IDevice& device, ICommandQueue& cmdQueue, bool withCommandQueue) {
+void testGenerateMipmap(IDevice& device,
+                        ICommandQueue& cmdQueue,
+                        bool withCommandQueue,
+                        TextureDesc::TextureUsage extraUsage = 0) {
   Result ret;
 
   // Use a square output texture with mips
@@ -1166,7 +1336,8 @@ void testGenerateMipmap(IDevice& device, ICommandQueue& cmdQueue, bool withComma
                                            TEX_WIDTH,
                                            TEX_WIDTH,
                                            TextureDesc::TextureUsageBits::Sampled |
-                                               TextureDesc::TextureUsageBits::Attachment);
+                                               TextureDesc::TextureUsageBits::Attachment |
+                                               extraUsage);
   texDesc.numMipLevels = TEX_MIP_COUNT;
   auto tex = device.createTexture(texDesc, &ret);
   ASSERT_EQ(ret.code, Result::Code::Ok) << ret.message;
@@ -1204,6 +1375,117 @@ void testGenerateMipmap(IDevice& device, ICommandQueue& cmdQueue, bool withComma
 }
 } // namespace
 
+//
+// Texture Validate View
+//
+// This test validates the logic of validateView: view ranges, types and formats.
+//
+TEST_F(TextureTest, ValidateView) {
+  Result ret;
+  auto texDesc =
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8, 8, 8, TextureDesc::TextureUsageBits::Sampled);
+  texDesc.numMipLevels = 4;
+  auto tex = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  TextureViewDesc viewDesc;
+  viewDesc.mipLevel = 1;
+  viewDesc.numMipLevels = 2;
+  TextureDesc desc;
+  ret = tex->validateView(viewDesc, desc);
+  ASSERT_TRUE(ret.isOk());
+  EXPECT_EQ(desc.width, 4);
+  EXPECT_EQ(desc.height, 4);
+  EXPECT_EQ(desc.numMipLevels, 2);
+  EXPECT_EQ(desc.type, TextureType::TwoD);
+  EXPECT_EQ(desc.format, TextureFormat::RGBA_UNorm8);
+
+  viewDesc.type = TextureType::TwoDArray;
+  viewDesc.format = TextureFormat::RGBA_SRGB;
+  ret = tex->validateView(viewDesc, desc);
+  ASSERT_TRUE(ret.isOk());
+  EXPECT_EQ(desc.type, TextureType::TwoDArray);
+  EXPECT_EQ(desc.format, TextureFormat::RGBA_SRGB);
+
+  viewDesc = {};
+  viewDesc.mipLevel = 3;
+  viewDesc.numMipLevels = 2;
+  EXPECT_EQ(tex->validateView(viewDesc, desc).code, Result::Code::ArgumentOutOfRange);
+
+  viewDesc = {};
+  viewDesc.layer = 1;
+  EXPECT_EQ(tex->validateView(viewDesc, desc).code, Result::Code::ArgumentOutOfRange);
+
+  viewDesc = {};
+  viewDesc.type = TextureType::ThreeD;
+  EXPECT_EQ(tex->validateView(viewDesc, desc).code, Result::Code::ArgumentInvalid);
+
+  // different bytes per pixel
+  viewDesc = {};
+  viewDesc.format = TextureFormat::RG_UNorm8;
+  EXPECT_EQ(tex->validateView(viewDesc, desc).code, Result::Code::ArgumentInvalid);
+}
+
+//
+// Texture View
+//
+// Views of one mip level read and write the memory of the texture they are created from.
+//
+TEST_F(TextureTest, TextureView) {
+  if (!iglDev_->hasFeature(DeviceFeatures::TextureViews)) {
+    GTEST_SKIP() << "Texture views are not supported";
+  }
+
+  Result ret;
+  constexpr size_t kWidth = 8;
+  auto texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                    kWidth,
+                                    kWidth,
+                                    TextureDesc::TextureUsageBits::Sampled |
+                                        TextureDesc::TextureUsageBits::Attachment);
+  texDesc.numMipLevels = 2;
+  texDesc.allowFormatViews = true;
+  std::shared_ptr<ITexture> tex = iglDev_->createTexture(texDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+
+  const std::vector<uint32_t> mip0(kWidth * kWidth, 0xdeadbeef);
+  const std::vector<uint32_t> mip1(kWidth * kWidth / 4, 0x8badf00d);
+  ASSERT_TRUE(tex->upload(tex->getFullRange(0), mip0.data()).isOk());
+  ASSERT_TRUE(tex->upload(tex->getFullRange(1), mip1.data()).isOk());
+
+  TextureViewDesc viewDesc;
+  viewDesc.mipLevel = 1;
+  viewDesc.numMipLevels = 1;
+  viewDesc.debugName = "Mip 1";
+  std::shared_ptr<ITexture> view = iglDev_->createTextureView(*tex, viewDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok) << ret.message;
+  ASSERT_TRUE(view != nullptr);
+  EXPECT_EQ(view->getDimensions().width, kWidth / 2);
+  EXPECT_EQ(view->getNumMipLevels(), 1);
+
+  std::vector<uint32_t> pixels(kWidth * kWidth / 4);
+  readMipLevel(*iglDev_, *cmdQueue_, view, 0, pixels.data());
+  for (const auto& pixel : pixels) {
+    ASSERT_EQ(pixel, 0x8badf00d);
+  }
+
+  // writes through the view land in the mip level of the texture
+  const std::vector<uint32_t> newMip1(kWidth * kWidth / 4, 0xc00010ff);
+  ASSERT_TRUE(view->upload(view->getFullRange(0), newMip1.data()).isOk());
+  readMipLevel(*iglDev_, *cmdQueue_, tex, 1, pixels.data());
+  for (const auto& pixel : pixels) {
+    ASSERT_EQ(pixel, 0xc00010ff);
+  }
+
+  // sRGB views share the bytes of the texture
+  viewDesc = {};
+  viewDesc.format = TextureFormat::RGBA_SRGB;
+  auto srgbView = iglDev_->createTextureView(*tex, viewDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok) << ret.message;
+  EXPECT_EQ(srgbView->getFormat(), TextureFormat::RGBA_SRGB);
+  EXPECT_EQ(srgbView->getNumMipLevels(), 1);
+}
+
 //
 // Test generating mipmaps
 //
@@ -1218,6 +1500,20 @@ TEST_F(TextureTest, GenerateMipmapWithCommandBuffer) {
   testGenerateMipmap(*iglDev_, *cmdQueue_, false);
 }
 
+//
+// Test generating mipmaps of storage textures
+//
+// Storage textures can generate all mip levels with a single compute dispatch instead of blits.
+//
+TEST_F(TextureTest, GenerateMipmapStorage) {
+  if (!(iglDev_->getTextureFormatCapabilities(TextureFormat::RGBA_UNorm8) &
+        ICapabilities::TextureFormatCapabilityBits::Storage)) {
+    GTEST_SKIP() << "Storage textures are not supported";
+  }
+  testGenerateMipmap(*iglDev_, *cmdQueue_, true, TextureDesc::TextureUsageBits::Storage);
+  testGenerateMipmap(*iglDev_, *cmdQueue_, false, TextureDesc::TextureUsageBits::Storage);
+}
+
 TEST_F(TextureTest, GetTextureBytesPerRow) {
   const auto properties = TextureFormatProperties::fromTextureFormat(TextureFormat::RGBA_UNorm8);
   const auto range = TextureRangeDesc::new2D(0, 0, 10, 10);
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <igl/TextureConversion.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+TEST(TextureConversionTest, CanConvertTexels) {
+  ASSERT_TRUE(canConvertTexels(TextureFormat::RGBX_UNorm8, TextureFormat::RGBA_UNorm8));
+  ASSERT_TRUE(canConvertTexels(TextureFormat::RGBX_UNorm8, TextureFormat::BGRA_UNorm8));
+  ASSERT_TRUE(canConvertTexels(TextureFormat::RGB_F16, TextureFormat::RGBA_F16));
+  ASSERT_TRUE(canConvertTexels(TextureFormat::LA_UNorm8, TextureFormat::RG_UNorm8));
+  ASSERT_TRUE(canConvertTexels(TextureFormat::R_UNorm8, TextureFormat::R_UNorm8));
+  ASSERT_FALSE(canConvertTexels(TextureFormat::RGBA_UNorm8, TextureFormat::RGBX_UNorm8));
+  ASSERT_FALSE(canConvertTexels(TextureFormat::RGB_F16, TextureFormat::RGBA_F32));
+  ASSERT_FALSE(canConvertTexels(TextureFormat::Invalid, TextureFormat::Invalid));
+}
+
+// The widths cover both the vectorized blocks of texels and the scalar remainder; the rows are
+// padded on both sides
+TEST(TextureConversionTest, ExpandRGB8) {
+  for (const bool swap : {false, true}) {
+    for (size_t width = 0; width <= 35; ++width) {
+      constexpr size_t kRows = 3;
+      const size_t srcBytesPerRow = 3 * width + 5;
+      const size_t dstBytesPerRow = 4 * width + 8;
+      std::vector<uint8_t> src(kRows * srcBytesPerRow);
+      for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = static_cast<uint8_t>(i * 7);
+      }
+      std::vector<uint8_t> dst(kRows * dstBytesPerRow, 0x55);
+
+      convertTexels(TextureFormat::RGBX_UNorm8,
+                    src.data(),
+                    srcBytesPerRow,
+                    swap ? TextureFormat::BGRA_UNorm8 : TextureFormat::RGBA_UNorm8,
+                    dst.data(),
+                    dstBytesPerRow,
+                    width,
+                    kRows);
+
+      for (size_t row = 0; row < kRows; ++row) {
+        for (size_t x = 0; x < width; ++x) {
+          const uint8_t* in = &src[row * srcBytesPerRow + 3 * x];
+          const uint8_t* out = &dst[row * dstBytesPerRow + 4 * x];
+          ASSERT_EQ(out[0], in[swap ? 2 : 0]);
+          ASSERT_EQ(out[1], in[1]);
+          ASSERT_EQ(out[2], in[swap ? 0 : 2]);
+          ASSERT_EQ(out[3], 0xff);
+        }
+        for (size_t i = 4 * width; i < dstBytesPerRow; ++i) {
+          ASSERT_EQ(dst[row * dstBytesPerRow + i], 0x55); // the padding is not written
+        }
+      }
+    }
+  }
+}
+
+TEST(TextureConversionTest, ExpandRGBFloat) {
+  for (size_t width = 0; width <= 19; ++width) {
+    std::vector<uint16_t> half(3 * width);
+    std::vector<float> single(3 * width);
+    for (size_t i = 0; i < 3 * width; ++i) {
+      half[i] = static_cast<uint16_t>(i + 1);
+      single[i] = static_cast<float>(i) * 0.5f;
+    }
+    std::vector<uint16_t> halfOut(4 * width);
+    std::vector<float> singleOut(4 * width);
+
+    convertTexels(TextureFormat::RGB_F16,
+                  half.data(),
+                  0,
+                  TextureFormat::RGBA_F16,
+                  halfOut.data(),
+                  0,
+                  width,
+                  1);
+    convertTexels(TextureFormat::RGB_F32,
+                  single.data(),
+                  0,
+                  TextureFormat::RGBA_F32,
+                  singleOut.data(),
+                  0,
+                  width,
+                  1);
+
+    for (size_t x = 0; x < width; ++x) {
+      for (size_t c = 0; c < 3; ++c) {
+        ASSERT_EQ(halfOut[4 * x + c], half[3 * x + c]);
+        ASSERT_EQ(singleOut[4 * x + c], single[3 * x + c]);
+      }
+      ASSERT_EQ(halfOut[4 * x + 3], 0x3c00); // 1.0 in half precision
+      ASSERT_EQ(singleOut[4 * x + 3], 1.0f);
+    }
+  }
+}
+
+TEST(TextureConversionTest, CopyLuminanceAlpha) {
+  const uint8_t src[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  uint8_t dst[sizeof(src)] = {};
+  convertTexels(TextureFormat::LA_UNorm8, src, 4, TextureFormat::RG_UNorm8, dst, 4, 2, 2);
+  ASSERT_EQ(memcmp(src, dst, sizeof(src)), 0);
+}
+
+} // namespace tests
+} // namespace igl
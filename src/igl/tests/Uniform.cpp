@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <igl/Uniform.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+// Covers both the vectorized blocks of 4 vectors and the scalar remainder
+TEST(UniformTest, PackAndPadVec3Array) {
+  for (size_t count = 0; count <= 9; ++count) {
+    std::vector<float> packed(3 * count + 1, -1.0f);
+    std::vector<float> padded(4 * count + 1, -1.0f);
+    std::vector<float> repacked(3 * count + 1, -1.0f);
+    for (size_t i = 0; i < 3 * count; ++i) {
+      packed[i] = static_cast<float>(i);
+    }
+
+    padVec3Array(padded.data(), packed.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+      for (size_t j = 0; j < 3; ++j) {
+        ASSERT_EQ(padded[4 * i + j], packed[3 * i + j]);
+      }
+      ASSERT_EQ(padded[4 * i + 3], 0.0f);
+    }
+    ASSERT_EQ(padded.back(), -1.0f); // nothing written past the end
+
+    packVec3Array(repacked.data(), padded.data(), count);
+    ASSERT_EQ(repacked, packed);
+  }
+}
+
+} // namespace tests
+} // namespace igl
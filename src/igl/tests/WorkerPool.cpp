@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <igl/WorkerPool.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+TEST(WorkerPoolTest, DrainsTasksOnDestruction) {
+  std::atomic<uint32_t> counter = 0;
+  {
+    igl::WorkerPool pool(4);
+    ASSERT_EQ(pool.getNumThreads(), 4u);
+    for (uint32_t i = 0; i != 100; i++) {
+      pool.enqueue([&counter]() { counter++; });
+    }
+  }
+  ASSERT_EQ(counter.load(), 100u);
+}
+
+TEST(WorkerPoolTest, ParallelFor) {
+  igl::WorkerPool pool(3);
+
+  std::vector<std::atomic<uint32_t>> visited(1000);
+  pool.parallelFor(visited.size(), [&visited](size_t i) { visited[i]++; });
+  for (const auto& v : visited) {
+    ASSERT_EQ(v.load(), 1u);
+  }
+
+  // fewer tasks than threads, and none at all
+  std::atomic<uint32_t> counter = 0;
+  pool.parallelFor(2, [&counter](size_t) { counter++; });
+  ASSERT_EQ(counter.load(), 2u);
+  pool.parallelFor(0, [&counter](size_t) { counter++; });
+  ASSERT_EQ(counter.load(), 2u);
+}
+
+} // namespace tests
+} // namespace igl
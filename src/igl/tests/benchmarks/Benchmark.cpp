@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Benchmark.h"
+
+namespace igl::tests::benchmarks {
+
+namespace {
+
+std::vector<Benchmark>& benchmarks() {
+  // constructed on first use, as benchmarks register from static initializers of other files
+  static std::vector<Benchmark> instance;
+  return instance;
+}
+
+} // namespace
+
+bool State::keepRunning() {
+  if (!started_) {
+    started_ = true;
+    running_ = true;
+    start_ = Clock::now();
+    return skipReason_.empty();
+  }
+  iterations_++;
+  if (running_) {
+    elapsed_ += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_);
+    start_ = Clock::now();
+  }
+  return skipReason_.empty() && elapsed_ < minTime_;
+}
+
+void State::pauseTiming() {
+  if (running_) {
+    elapsed_ += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_);
+    running_ = false;
+  }
+}
+
+void State::resumeTiming() {
+  if (!running_) {
+    start_ = Clock::now();
+    running_ = true;
+  }
+}
+
+bool registerBenchmark(std::string name, BenchmarkFunc func) {
+  benchmarks().push_back({std::move(name), std::move(func)});
+  return true;
+}
+
+const std::vector<Benchmark>& getBenchmarks() {
+  return benchmarks();
+}
+
+} // namespace igl::tests::benchmarks
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace igl {
+class ICommandQueue;
+class IDevice;
+namespace tests::benchmarks {
+
+/**
+ * @brief The timing loop of one benchmark run, in the style of Google Benchmark:
+ *
+ *   IGL_BENCHMARK(BufferUpload) {
+ *     // setup (not timed)
+ *     while (state.keepRunning()) {
+ *       // timed code
+ *     }
+ *     state.setBytesProcessed(state.iterations() * size);
+ *   }
+ *
+ * The loop runs until at least the minimum time has passed. Code between pauseTiming() and
+ * resumeTiming() is not timed.
+ */
+class State {
+ public:
+  explicit State(std::chrono::nanoseconds minTime) : minTime_(minTime) {}
+
+  bool keepRunning();
+  void pauseTiming();
+  void resumeTiming();
+
+  // totals over all iterations, reported as per second rates
+  void setBytesProcessed(uint64_t bytes) {
+    bytesProcessed_ = bytes;
+  }
+  void setItemsProcessed(uint64_t items) {
+    itemsProcessed_ = items;
+  }
+  void setLabel(std::string label) {
+    label_ = std::move(label);
+  }
+  // ends the benchmark without results, e.g. if the backend lacks a feature
+  void skip(std::string reason) {
+    skipReason_ = std::move(reason);
+  }
+
+  [[nodiscard]] uint64_t iterations() const {
+    return iterations_;
+  }
+  [[nodiscard]] std::chrono::nanoseconds elapsed() const {
+    return elapsed_;
+  }
+  [[nodiscard]] uint64_t bytesProcessed() const {
+    return bytesProcessed_;
+  }
+  [[nodiscard]] uint64_t itemsProcessed() const {
+    return itemsProcessed_;
+  }
+  [[nodiscard]] const std::string& label() const {
+    return label_;
+  }
+  [[nodiscard]] bool skipped() const {
+    return !skipReason_.empty();
+  }
+  [[nodiscard]] const std::string& skipReason() const {
+    return skipReason_;
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  const std::chrono::nanoseconds minTime_;
+  Clock::time_point start_;
+  std::chrono::nanoseconds elapsed_{0};
+  uint64_t iterations_ = 0;
+  bool running_ = false;
+  bool started_ = false;
+  uint64_t bytesProcessed_ = 0;
+  uint64_t itemsProcessed_ = 0;
+  std::string label_;
+  std::string skipReason_;
+};
+
+/// The device and queue of the backend a benchmark runs on, shared by all benchmarks
+struct BenchmarkContext {
+  std::shared_ptr<IDevice> device;
+  std::shared_ptr<ICommandQueue> commandQueue;
+};
+
+using BenchmarkFunc = std::function<void(State&, BenchmarkContext&)>;
+
+struct Benchmark {
+  std::string name;
+  BenchmarkFunc func;
+};
+
+/// Registers a benchmark; used by IGL_BENCHMARK and for parameterized benchmarks (e.g.
+/// "TextureUpload/RGBA_UNorm8") registered from static initializers.
+bool registerBenchmark(std::string name, BenchmarkFunc func);
+const std::vector<Benchmark>& getBenchmarks();
+
+} // namespace tests::benchmarks
+} // namespace igl
+
+#define IGL_BENCHMARK(name)                                          \
+  static void name(::igl::tests::benchmarks::State& state,           \
+                   ::igl::tests::benchmarks::BenchmarkContext& ctx); \
+  static const bool name##Registered_ =                              \
+      ::igl::tests::benchmarks::registerBenchmark(#name, name);      \
+  static void name(::igl::tests::benchmarks::State& state,           \
+                   ::igl::tests::benchmarks::BenchmarkContext& ctx)
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Benchmark.h"
+
+#include "../data/ShaderData.h"
+#include "../data/VertexIndexData.h"
+#include "../util/Common.h"
+
+#include <igl/IGL.h>
+
+namespace igl::tests::benchmarks {
+
+namespace {
+
+constexpr uint32_t kRenderTargetSize = 256;
+constexpr uint32_t kNumDraws = 1000;
+constexpr size_t kTextureUnit = 0;
+
+/// The offscreen render target and the quad pipeline of the correctness tests
+struct QuadScene {
+  std::shared_ptr<ITexture> renderTarget;
+  std::shared_ptr<IFramebuffer> framebuffer;
+  std::shared_ptr<ITexture> textures[2];
+  std::shared_ptr<ISamplerState> sampler;
+  std::shared_ptr<IBuffer> vb;
+  std::shared_ptr<IBuffer> uv;
+  std::shared_ptr<IBuffer> ib;
+  RenderPipelineDesc pipelineDesc;
+  RenderPassDesc renderPass;
+
+  bool init(const std::shared_ptr<IDevice>& devicePtr) {
+    IDevice& device = *devicePtr;
+    Result ret;
+    renderTarget = device.createTexture(
+        TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                           kRenderTargetSize,
+                           kRenderTargetSize,
+                           TextureDesc::TextureUsageBits::Sampled |
+                               TextureDesc::TextureUsageBits::Attachment),
+        &ret);
+    if (!ret.isOk()) {
+      return false;
+    }
+    FramebufferDesc framebufferDesc;
+    framebufferDesc.colorAttachments[0].texture = renderTarget;
+    framebuffer = device.createFramebuffer(framebufferDesc, &ret);
+    if (!ret.isOk()) {
+      return false;
+    }
+
+    const uint32_t pixels[4] = {0xff0000ff, 0xff00ff00, 0xffff0000, 0xffffffff};
+    for (auto& texture : textures) {
+      texture = device.createTexture(
+          TextureDesc::new2D(
+              TextureFormat::RGBA_UNorm8, 2, 2, TextureDesc::TextureUsageBits::Sampled),
+          &ret);
+      if (!ret.isOk()) {
+        return false;
+      }
+      texture->upload(TextureRangeDesc::new2D(0, 0, 2, 2), pixels);
+    }
+    sampler = device.createSamplerState(SamplerStateDesc(), &ret);
+    if (!ret.isOk()) {
+      return false;
+    }
+
+    vb = device.createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Vertex,
+                                        data::vertex_index::QUAD_VERT,
+                                        sizeof(data::vertex_index::QUAD_VERT)),
+                             &ret);
+    if (ret.isOk()) {
+      uv = device.createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Vertex,
+                                          data::vertex_index::QUAD_UV,
+                                          sizeof(data::vertex_index::QUAD_UV)),
+                               &ret);
+    }
+    if (ret.isOk()) {
+      ib = device.createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Index,
+                                          data::vertex_index::QUAD_IND,
+                                          sizeof(data::vertex_index::QUAD_IND)),
+                               &ret);
+    }
+    if (!ret.isOk()) {
+      return false;
+    }
+
+    VertexInputStateDesc inputDesc;
+    inputDesc.attributes[0].format = VertexAttributeFormat::Float4;
+    inputDesc.attributes[0].offset = 0;
+    inputDesc.attributes[0].bufferIndex = data::shader::simplePosIndex;
+    inputDesc.attributes[0].name = data::shader::simplePos;
+    inputDesc.attributes[0].location = 0;
+    inputDesc.inputBindings[0].stride = sizeof(float) * 4;
+    inputDesc.attributes[1].format = VertexAttributeFormat::Float2;
+    inputDesc.attributes[1].offset = 0;
+    inputDesc.attributes[1].bufferIndex = data::shader::simpleUvIndex;
+    inputDesc.attributes[1].name = data::shader::simpleUv;
+    inputDesc.attributes[1].location = 1;
+    inputDesc.inputBindings[1].stride = sizeof(float) * 2;
+    inputDesc.numAttributes = inputDesc.numInputBindings = 2;
+    pipelineDesc.vertexInputState = device.createVertexInputState(inputDesc, &ret);
+    if (!ret.isOk()) {
+      return false;
+    }
+
+    std::unique_ptr<IShaderStages> stages;
+    util::createSimpleShaderStages(devicePtr, stages);
+    if (!stages) {
+      return false;
+    }
+    pipelineDesc.shaderStages = std::move(stages);
+    pipelineDesc.targetDesc.colorAttachments.resize(1);
+    pipelineDesc.targetDesc.colorAttachments[0].textureFormat = renderTarget->getFormat();
+    pipelineDesc.fragmentUnitSamplerMap[kTextureUnit] =
+        IGL_NAMEHANDLE(data::shader::simpleSampler);
+    pipelineDesc.cullMode = CullMode::Disabled;
+
+    renderPass.colorAttachments.resize(1);
+    renderPass.colorAttachments[0].loadAction = LoadAction::Clear;
+    renderPass.colorAttachments[0].storeAction = StoreAction::Store;
+    renderPass.colorAttachments[0].clearColor = {0.0f, 0.0f, 0.0f, 1.0f};
+    return true;
+  }
+
+  void bindQuad(IRenderCommandEncoder& encoder) const {
+    encoder.bindBuffer(data::shader::simplePosIndex, BindTarget::kVertex, vb, 0);
+    encoder.bindBuffer(data::shader::simpleUvIndex, BindTarget::kVertex, uv, 0);
+  }
+};
+
+// Encodes `numDraws` quads in one render pass and submits them. With `alternateTextures`, every
+// draw binds a different texture than the previous one, so each draw updates descriptors.
+void encodeDraws(State& state, BenchmarkContext& ctx, bool alternateTextures) {
+  QuadScene scene;
+  if (!scene.init(ctx.device)) {
+    state.skip("cannot create the scene");
+    return;
+  }
+  Result ret;
+  auto pipeline = ctx.device->createRenderPipeline(scene.pipelineDesc, &ret);
+  if (!ret.isOk()) {
+    state.skip("cannot create the render pipeline");
+    return;
+  }
+
+  while (state.keepRunning()) {
+    auto cmdBuffer = ctx.commandQueue->createCommandBuffer({}, nullptr);
+    auto encoder = cmdBuffer->createRenderCommandEncoder(scene.renderPass, scene.framebuffer);
+    encoder->bindRenderPipelineState(pipeline);
+    scene.bindQuad(*encoder);
+    encoder->bindSamplerState(kTextureUnit, BindTarget::kFragment, scene.sampler.get());
+    encoder->bindTexture(kTextureUnit, BindTarget::kFragment, scene.textures[0].get());
+    for (uint32_t i = 0; i != kNumDraws; i++) {
+      if (alternateTextures) {
+        encoder->bindTexture(kTextureUnit, BindTarget::kFragment, scene.textures[i & 1].get());
+      }
+      encoder->drawIndexed(PrimitiveType::Triangle, 6, IndexFormat::UInt16, *scene.ib, 0);
+    }
+    encoder->endEncoding();
+    ctx.commandQueue->submit(*cmdBuffer);
+  }
+  state.setItemsProcessed(state.iterations() * kNumDraws);
+}
+
+void registerBufferUpload(const char* name, size_t size) {
+  registerBenchmark(name, [size](State& state, BenchmarkContext& ctx) {
+    Result ret;
+    auto buffer = ctx.device->createBuffer(
+        BufferDesc(BufferDesc::BufferTypeBits::Vertex, nullptr, size, ResourceStorage::Private),
+        &ret);
+    if (!ret.isOk() || !buffer) {
+      state.skip("cannot create the buffer");
+      return;
+    }
+    const std::vector<uint8_t> data(size, 0x5a);
+    while (state.keepRunning()) {
+      buffer->upload(data.data(), BufferRange(size, 0));
+    }
+    state.setBytesProcessed(state.iterations() * size);
+  });
+}
+
+void registerTextureUpload(const char* name, TextureFormat format) {
+  registerBenchmark(name, [format](State& state, BenchmarkContext& ctx) {
+    constexpr uint32_t kSize = 512;
+    if ((ctx.device->getTextureFormatCapabilities(format) &
+         ICapabilities::TextureFormatCapabilityBits::Sampled) == 0) {
+      state.skip("format not supported");
+      return;
+    }
+    Result ret;
+    auto texture = ctx.device->createTexture(
+        TextureDesc::new2D(format, kSize, kSize, TextureDesc::TextureUsageBits::Sampled), &ret);
+    if (!ret.isOk() || !texture) {
+      state.skip("cannot create the texture");
+      return;
+    }
+    const auto range = TextureRangeDesc::new2D(0, 0, kSize, kSize);
+    const size_t size = texture->getProperties().getBytesPerRange(range);
+    const std::vector<uint8_t> data(size, 0x5a);
+    while (state.keepRunning()) {
+      texture->upload(range, data.data());
+    }
+    state.setBytesProcessed(state.iterations() * size);
+  });
+}
+
+const bool kRegistered = []() {
+  registerBufferUpload("BufferUpload/4KB", 4u * 1024u);
+  registerBufferUpload("BufferUpload/1MB", 1024u * 1024u);
+  registerBufferUpload("BufferUpload/16MB", 16u * 1024u * 1024u);
+  registerTextureUpload("TextureUpload/R_UNorm8", TextureFormat::R_UNorm8);
+  registerTextureUpload("TextureUpload/RG_UNorm8", TextureFormat::RG_UNorm8);
+  registerTextureUpload("TextureUpload/RGBA_UNorm8", TextureFormat::RGBA_UNorm8);
+  registerTextureUpload("TextureUpload/BGRA_UNorm8", TextureFormat::BGRA_UNorm8);
+  registerTextureUpload("TextureUpload/RGBA_F16", TextureFormat::RGBA_F16);
+  registerTextureUpload("TextureUpload/RGBA_F32", TextureFormat::RGBA_F32);
+  return true;
+}();
+
+} // namespace
+
+//
+// RenderPipelineCreation
+//
+// A new pipeline state drawn once: includes the lazy creation of the backend pipeline object
+// during the first draw (Vulkan) and shader program linking (OpenGL).
+//
+IGL_BENCHMARK(RenderPipelineCreation) {
+  QuadScene scene;
+  if (!scene.init(ctx.device)) {
+    state.skip("cannot create the scene");
+    return;
+  }
+  while (state.keepRunning()) {
+    Result ret;
+    auto pipeline = ctx.device->createRenderPipeline(scene.pipelineDesc, &ret);
+    if (!ret.isOk()) {
+      state.skip("cannot create the render pipeline");
+      return;
+    }
+    auto cmdBuffer = ctx.commandQueue->createCommandBuffer({}, nullptr);
+    auto encoder = cmdBuffer->createRenderCommandEncoder(scene.renderPass, scene.framebuffer);
+    encoder->bindRenderPipelineState(pipeline);
+    scene.bindQuad(*encoder);
+    encoder->bindSamplerState(kTextureUnit, BindTarget::kFragment, scene.sampler.get());
+    encoder->bindTexture(kTextureUnit, BindTarget::kFragment, scene.textures[0].get());
+    encoder->drawIndexed(PrimitiveType::Triangle, 6, IndexFormat::UInt16, *scene.ib, 0);
+    encoder->endEncoding();
+    ctx.commandQueue->submit(*cmdBuffer);
+  }
+}
+
+//
+// DrawEncode
+//
+// CPU cost of encoding and submitting draws which share all their bindings.
+//
+IGL_BENCHMARK(DrawEncode) {
+  encodeDraws(state, ctx, false);
+}
+
+//
+// DescriptorUpdates
+//
+// Same as DrawEncode, but every draw binds a different texture than the previous one.
+//
+IGL_BENCHMARK(DescriptorUpdates) {
+  encodeDraws(state, ctx, true);
+}
+
+//
+// ReadbackLatency
+//
+// Time from submitting a render pass to having its pixels in CPU memory.
+//
+IGL_BENCHMARK(ReadbackLatency) {
+  QuadScene scene;
+  if (!scene.init(ctx.device)) {
+    state.skip("cannot create the scene");
+    return;
+  }
+  const auto range = TextureRangeDesc::new2D(0, 0, kRenderTargetSize, kRenderTargetSize);
+  std::vector<uint32_t> pixels(static_cast<size_t>(kRenderTargetSize) * kRenderTargetSize);
+  while (state.keepRunning()) {
+    auto cmdBuffer = ctx.commandQueue->createCommandBuffer({}, nullptr);
+    auto encoder = cmdBuffer->createRenderCommandEncoder(scene.renderPass, scene.framebuffer);
+    encoder->endEncoding();
+    ctx.commandQueue->submit(*cmdBuffer);
+    scene.framebuffer->copyBytesColorAttachment(*ctx.commandQueue, 0, pixels.data(), range);
+  }
+  state.setBytesProcessed(state.iterations() * pixels.size() * sizeof(uint32_t));
+}
+
+} // namespace igl::tests::benchmarks
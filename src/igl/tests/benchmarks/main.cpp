@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Runs all registered benchmarks on every backend a test device can be created for.
+//
+//   IGLBenchmarks [--filter=<substring>] [--backend=<vulkan|opengl|metal>] [--min_time=<seconds>]
+//                 [--json=<file>] [--baseline=<file>] [--tolerance=<fraction>]
+//
+// Results are printed as a table; --json also writes them in the JSON layout of Google Benchmark
+// (with an extra "backend" field), so the existing comparison tools can diff two IGL drops.
+//
+// --baseline compares the results against the --json output of an earlier run on the same device,
+// e.g. one file per device checked in for perf CI. A benchmark more than `tolerance` (default 0.1)
+// slower than its baseline is reported, and makes the run exit with 2.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <igl/IGL.h>
+#include <igl/tests/util/device/TestDevice.h>
+#include <unordered_map>
+
+namespace igl::tests::benchmarks {
+namespace {
+
+struct Options {
+  std::string filter;
+  std::string backend;
+  std::string jsonPath;
+  std::string baselinePath;
+  double minTimeSec = 0.5;
+  double tolerance = 0.1;
+};
+
+struct BenchmarkResult {
+  std::string name;
+  std::string backend;
+  uint64_t iterations = 0;
+  double nsPerIteration = 0.0;
+  double bytesPerSecond = 0.0;
+  double itemsPerSecond = 0.0;
+  std::string label;
+  std::string error;
+};
+
+std::string toLower(std::string str) {
+  std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  return str;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const auto startsWith = [arg](const char* prefix) {
+      return strncmp(arg, prefix, strlen(prefix)) == 0;
+    };
+    if (startsWith("--filter=")) {
+      options.filter = arg + strlen("--filter=");
+    } else if (startsWith("--backend=")) {
+      options.backend = toLower(arg + strlen("--backend="));
+    } else if (startsWith("--json=")) {
+      options.jsonPath = arg + strlen("--json=");
+    } else if (startsWith("--min_time=")) {
+      options.minTimeSec = std::max(atof(arg + strlen("--min_time=")), 0.0);
+    } else if (startsWith("--baseline=")) {
+      options.baselinePath = arg + strlen("--baseline=");
+    } else if (startsWith("--tolerance=")) {
+      options.tolerance = std::max(atof(arg + strlen("--tolerance=")), 0.0);
+    } else {
+      fprintf(stderr, "Unknown argument: %s\n", arg);
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string escapeJson(const std::string& str) {
+  std::string out;
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out;
+}
+
+bool writeJson(const std::string& path, const std::vector<BenchmarkResult>& results) {
+  FILE* file = fopen(path.c_str(), "w");
+  if (!file) {
+    fprintf(stderr, "Cannot open %s\n", path.c_str());
+    return false;
+  }
+  fprintf(file, "{\n  \"context\": {\n    \"library\": \"IGL\"\n  },\n  \"benchmarks\": [");
+  for (size_t i = 0; i != results.size(); i++) {
+    const BenchmarkResult& r = results[i];
+    fprintf(file, "%s\n    {\n", i ? "," : "");
+    fprintf(file, "      \"name\": \"%s/%s\",\n", r.backend.c_str(), escapeJson(r.name).c_str());
+    fprintf(file, "      \"run_name\": \"%s\",\n", escapeJson(r.name).c_str());
+    fprintf(file, "      \"backend\": \"%s\",\n", r.backend.c_str());
+    if (!r.error.empty()) {
+      fprintf(file, "      \"error_occurred\": true,\n");
+      fprintf(file, "      \"error_message\": \"%s\"\n    }", escapeJson(r.error).c_str());
+      continue;
+    }
+    fprintf(file, "      \"iterations\": %llu,\n", static_cast<unsigned long long>(r.iterations));
+    fprintf(file, "      \"real_time\": %.3f,\n", r.nsPerIteration);
+    fprintf(file, "      \"cpu_time\": %.3f,\n", r.nsPerIteration);
+    fprintf(file, "      \"time_unit\": \"ns\"");
+    if (r.bytesPerSecond > 0.0) {
+      fprintf(file, ",\n      \"bytes_per_second\": %.3f", r.bytesPerSecond);
+    }
+    if (r.itemsPerSecond > 0.0) {
+      fprintf(file, ",\n      \"items_per_second\": %.3f", r.itemsPerSecond);
+    }
+    if (!r.label.empty()) {
+      fprintf(file, ",\n      \"label\": \"%s\"", escapeJson(r.label).c_str());
+    }
+    fprintf(file, "\n    }");
+  }
+  fprintf(file, "\n  ]\n}\n");
+  fclose(file);
+  return true;
+}
+
+// Reads "name" -> "real_time" from a file written by writeJson(); skipped benchmarks have no time
+bool readBaseline(const std::string& path, std::unordered_map<std::string, double>& outTimes) {
+  FILE* file = fopen(path.c_str(), "r");
+  if (!file) {
+    fprintf(stderr, "Cannot open %s\n", path.c_str());
+    return false;
+  }
+  std::string json;
+  char buffer[4096];
+  size_t size = 0;
+  while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    json.append(buffer, size);
+  }
+  fclose(file);
+
+  const std::string nameKey = "\"name\": \"";
+  const std::string timeKey = "\"real_time\": ";
+  size_t pos = json.find(nameKey);
+  while (pos != std::string::npos) {
+    const size_t nameStart = pos + nameKey.size();
+    const size_t nameEnd = json.find('"', nameStart);
+    if (nameEnd == std::string::npos) {
+      break;
+    }
+    const size_t next = json.find(nameKey, nameEnd);
+    const size_t time = json.find(timeKey, nameEnd);
+    if (time != std::string::npos && time < next) {
+      outTimes[json.substr(nameStart, nameEnd - nameStart)] =
+          atof(json.c_str() + time + timeKey.size());
+    }
+    pos = next;
+  }
+  return true;
+}
+
+// Returns the number of benchmarks slower than their baseline by more than the tolerance
+size_t compareWithBaseline(const std::vector<BenchmarkResult>& results,
+                           const std::unordered_map<std::string, double>& baseline,
+                           double tolerance) {
+  size_t numRegressions = 0;
+  printf("\nBaseline comparison (tolerance %.0f%%):\n", tolerance * 100.0);
+  for (const BenchmarkResult& r : results) {
+    const std::string name = r.backend + "/" + r.name;
+    const auto it = baseline.find(name);
+    if (!r.error.empty() || it == baseline.end() || it->second <= 0.0) {
+      continue;
+    }
+    const double change = r.nsPerIteration / it->second - 1.0;
+    const bool isRegression = change > tolerance;
+    numRegressions += isRegression ? 1 : 0;
+    printf("%-48s %+8.1f%%%s\n",
+           name.c_str(),
+           change * 100.0,
+           isRegression ? "  REGRESSION" : "");
+  }
+  return numRegressions;
+}
+
+void printResult(const BenchmarkResult& r) {
+  const std::string name = r.backend + "/" + r.name;
+  if (!r.error.empty()) {
+    printf("%-48s skipped: %s\n", name.c_str(), r.error.c_str());
+    return;
+  }
+  printf("%-48s %14.1f ns %10llu",
+         name.c_str(),
+         r.nsPerIteration,
+         static_cast<unsigned long long>(r.iterations));
+  if (r.bytesPerSecond > 0.0) {
+    printf(" %10.2f MB/s", r.bytesPerSecond / (1024.0 * 1024.0));
+  }
+  if (r.itemsPerSecond > 0.0) {
+    printf(" %12.0f items/s", r.itemsPerSecond);
+  }
+  if (!r.label.empty()) {
+    printf(" %s", r.label.c_str());
+  }
+  printf("\n");
+}
+
+void runBackend(BackendType backendType,
+                const Options& options,
+                std::vector<BenchmarkResult>& results) {
+  const std::string backendName = toLower(BackendTypeToString(backendType));
+  if (!options.backend.empty() && options.backend != backendName) {
+    return;
+  }
+  if (!util::device::isBackendTypeSupported(backendType)) {
+    return;
+  }
+
+#ifdef IGL_UNIT_TESTS_GLES_VERSION
+  const std::string backendApi(IGL_UNIT_TESTS_GLES_VERSION);
+#else
+  const std::string backendApi(backendType == BackendType::OpenGL ? "2.0" : "");
+#endif
+
+  BenchmarkContext ctx;
+  ctx.device = util::device::createTestDevice(backendType, backendApi);
+  if (!ctx.device) {
+    fprintf(stderr, "Cannot create a %s device\n", backendName.c_str());
+    return;
+  }
+  Result ret;
+  ctx.commandQueue = ctx.device->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  if (!ret.isOk() || !ctx.commandQueue) {
+    fprintf(stderr, "Cannot create a %s command queue\n", backendName.c_str());
+    return;
+  }
+
+  const auto minTime = std::chrono::nanoseconds(static_cast<int64_t>(options.minTimeSec * 1e9));
+
+  for (const Benchmark& benchmark : getBenchmarks()) {
+    if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    State state(minTime);
+    benchmark.func(state, ctx);
+
+    // drain the queue so the next benchmark does not pay for this one
+    auto cmdBuffer = ctx.commandQueue->createCommandBuffer({}, nullptr);
+    if (cmdBuffer) {
+      ctx.commandQueue->submit(*cmdBuffer);
+      cmdBuffer->waitUntilCompleted();
+    }
+
+    BenchmarkResult r;
+    r.name = benchmark.name;
+    r.backend = backendName;
+    r.label = state.label();
+    if (state.skipped()) {
+      r.error = state.skipReason();
+    } else if (state.iterations() == 0) {
+      r.error = "no iterations";
+    } else {
+      const double seconds = static_cast<double>(state.elapsed().count()) * 1e-9;
+      r.iterations = state.iterations();
+      r.nsPerIteration = static_cast<double>(state.elapsed().count()) /
+                         static_cast<double>(state.iterations());
+      if (seconds > 0.0) {
+        r.bytesPerSecond = static_cast<double>(state.bytesProcessed()) / seconds;
+        r.itemsPerSecond = static_cast<double>(state.itemsProcessed()) / seconds;
+      }
+    }
+    printResult(r);
+    results.push_back(std::move(r));
+  }
+}
+
+} // namespace
+} // namespace igl::tests::benchmarks
+
+int main(int argc, char** argv) {
+  using namespace igl::tests::benchmarks;
+
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    return 1;
+  }
+
+  std::vector<BenchmarkResult> results;
+  for (const auto backendType :
+       {igl::BackendType::Vulkan, igl::BackendType::OpenGL, igl::BackendType::Metal}) {
+    runBackend(backendType, options, results);
+  }
+
+  if (!options.jsonPath.empty() && !writeJson(options.jsonPath, results)) {
+    return 1;
+  }
+
+  if (!options.baselinePath.empty()) {
+    std::unordered_map<std::string, double> baseline;
+    if (!readBaseline(options.baselinePath, baseline)) {
+      return 1;
+    }
+    const size_t numRegressions = compareWithBaseline(results, baseline, options.tolerance);
+    if (numRegressions > 0) {
+      fprintf(stderr, "%zu benchmark(s) regressed\n", numRegressions);
+      return 2;
+    }
+  }
+
+  return 0;
+}
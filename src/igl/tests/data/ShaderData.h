@@ -249,6 +249,20 @@ const char OGL_SIMPLE_VERT_SHADER_UNIFORM_BLOCKS[] =
         uv = matrices.view;
       });
 
+// Vulkan-style push constants, emulated with a uniform block on OpenGL
+const char OGL_SIMPLE_VERT_SHADER_PUSH_CONSTANTS[] =
+      IGL_TO_STRING(VERSION(300 es)
+      in vec4 position_in; out vec3 uv;
+
+      layout (push_constant) uniform PushConstants {
+        vec4 scale;
+      } pc;
+
+      void main() {
+        gl_Position = position_in * pc.scale;
+        uv = position_in.xyz;
+      });
+
 const char OGL_SIMPLE_FRAG_SHADER_UNIFORM_BLOCKS[] =
     IGL_TO_STRING(VERSION(300 es)
       PROLOG uniform sampler2D inputImage; in vec3 uv; out vec4 fragColor;
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/asset_loader/AssetLoader.h>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <igl/WorkerPool.h>
+#include <string>
+#include <thread>
+
+namespace iglu {
+namespace tests {
+
+namespace {
+
+void waitUntil(const std::function<bool()>& predicate) {
+  while (!predicate()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void updateUntilDone(assetloader::AssetLoader& loader) {
+  while (loader.getNumPending() != 0) {
+    loader.update();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+} // namespace
+
+//
+// Stages Test
+//
+// Assets go through read, decode and upload, and failures stop the pipeline
+//
+TEST(AssetLoaderTest, Stages) {
+  assetloader::AssetLoader loader;
+  const std::thread::id renderThread = std::this_thread::get_id();
+
+  std::string uploaded;
+  assetloader::AssetState completedState = assetloader::AssetState::Pending;
+  assetloader::AssetDesc<std::string> desc;
+  desc.read = [](std::vector<uint8_t>& outBytes) {
+    outBytes = {'a', 's', 's', 'e', 't'};
+    return true;
+  };
+  desc.decode = [renderThread](std::vector<uint8_t>&& bytes, std::string& outAsset) {
+    EXPECT_NE(std::this_thread::get_id(), renderThread);
+    outAsset.assign(bytes.begin(), bytes.end());
+    return true;
+  };
+  desc.upload = [&uploaded, renderThread](std::string& asset) {
+    EXPECT_EQ(std::this_thread::get_id(), renderThread);
+    uploaded = asset;
+    return true;
+  };
+  desc.onComplete = [&completedState](assetloader::AssetState state) { completedState = state; };
+  auto handle = loader.load(desc);
+
+  bool decoded = false;
+  assetloader::AssetDesc<int> failing;
+  failing.read = [](std::vector<uint8_t>& /*outBytes*/) { return false; };
+  failing.decode = [&decoded](std::vector<uint8_t>&& /*bytes*/, int& /*outAsset*/) {
+    decoded = true;
+    return true;
+  };
+  auto failingHandle = loader.load(failing);
+
+  updateUntilDone(loader);
+  ASSERT_EQ(handle->getState(), assetloader::AssetState::Loaded);
+  ASSERT_EQ(completedState, assetloader::AssetState::Loaded);
+  ASSERT_EQ(uploaded, "asset");
+  ASSERT_EQ(failingHandle->getState(), assetloader::AssetState::Failed);
+  ASSERT_FALSE(decoded);
+}
+
+//
+// Priorities Test
+//
+// Decoded assets are uploaded in the order of their priorities, and cancelled ones are skipped
+//
+TEST(AssetLoaderTest, Priorities) {
+  assetloader::AssetLoaderConfig config;
+  config.maxUploadsPerUpdate = 1;
+  config.decodePool = std::make_shared<igl::WorkerPool>(1);
+  assetloader::AssetLoader loader(config);
+
+  std::atomic<int> numDecoded = 0;
+  std::vector<int> uploads;
+  std::vector<std::shared_ptr<assetloader::AssetHandle>> handles;
+  for (int i = 0; i != 4; i++) {
+    assetloader::AssetDesc<int> desc;
+    desc.decode = [i, &numDecoded](std::vector<uint8_t>&& /*bytes*/, int& outAsset) {
+      outAsset = i;
+      if (i != 3) {
+        numDecoded++;
+      }
+      return true;
+    };
+    desc.upload = [&uploads](int& asset) {
+      uploads.push_back(asset);
+      return true;
+    };
+    desc.priority = static_cast<float>(i % 2 ? i : -i);
+    handles.push_back(loader.load(desc));
+  }
+  handles[3]->cancel();
+  waitUntil([&numDecoded]() { return numDecoded == 3; });
+  // the decode pool has a single thread, so the last decode has finished once this task runs
+  std::atomic<bool> flushed = false;
+  config.decodePool->enqueue([&flushed]() { flushed = true; });
+  waitUntil([&flushed]() { return flushed.load(); });
+
+  loader.update();
+  ASSERT_EQ(uploads, (std::vector<int>{1}));
+  updateUntilDone(loader);
+  ASSERT_EQ(uploads, (std::vector<int>{1, 0, 2}));
+  ASSERT_EQ(handles[3]->getState(), assetloader::AssetState::Cancelled);
+}
+
+} // namespace tests
+} // namespace iglu
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/simdtypes/SimdUtilities.h>
+#include <IGLU/simple_renderer/ClusteredLights.h>
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <random>
+
+namespace iglu {
+namespace tests {
+
+using namespace simdtypes;
+using namespace lighting;
+
+namespace {
+
+const igl::Size kViewportSize(1280.0f, 720.0f);
+
+CameraDesc makeCamera(float x, float y, float z) {
+  CameraDesc camera;
+  // looking down -Z from (x, y, z)
+  camera.view = float4x4(float4{1.0f, 0.0f, 0.0f, 0.0f},
+                         float4{0.0f, 1.0f, 0.0f, 0.0f},
+                         float4{0.0f, 0.0f, 1.0f, 0.0f},
+                         float4{-x, -y, -z, 1.0f});
+  camera.fovY = 1.0f;
+  camera.aspectRatio = kViewportSize.width / kViewportSize.height;
+  camera.nearZ = 0.1f;
+  camera.farZ = 100.0f;
+  return camera;
+}
+
+// getClusterIndex() of the shaders
+uint32_t getClusterIndex(const ClusterParams& params, float fragX, float fragY, float viewDepth) {
+  const auto clampTo = [](float value, uint32_t count) {
+    return static_cast<uint32_t>(std::clamp(value, 0.0f, static_cast<float>(count - 1)));
+  };
+  const uint32_t x =
+      clampTo(std::floor(fragX * params.tileScale[0] + params.tileBias[0]), params.tilesX);
+  const uint32_t y =
+      clampTo(std::floor(fragY * params.tileScale[1] + params.tileBias[1]), params.tilesY);
+  const uint32_t z = clampTo(std::floor(std::log(viewDepth) * params.sliceScale + params.sliceBias),
+                             params.numSlices);
+  return x + params.tilesX * (y + params.tilesY * z);
+}
+
+std::vector<PointLight> makeLights(uint32_t count, float spread) {
+  std::mt19937 generator(17);
+  std::uniform_real_distribution<float> position(-spread, spread);
+  std::uniform_real_distribution<float> radius(0.5f, 8.0f);
+  std::vector<PointLight> lights(count);
+  for (PointLight& light : lights) {
+    light.positionRadius =
+        float4{position(generator), position(generator), -spread + position(generator), 0.0f};
+    light.positionRadius[3] = radius(generator);
+    light.color = float4{1.0f, 1.0f, 1.0f, 1.0f};
+  }
+  return lights;
+}
+
+} // namespace
+
+class ClusteredLightsGpuTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    igl::setDebugBreakEnabled(false);
+    igl::tests::util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+ protected:
+  std::shared_ptr<igl::IDevice> iglDev_;
+  std::shared_ptr<igl::ICommandQueue> cmdQueue_;
+};
+
+//
+// ClusterIndexMatchesBounds Test
+//
+// A view space point is in the bounds of the cluster its fragment and depth map to
+//
+TEST(ClusteredLightsTest, ClusterIndexMatchesBounds) {
+  const ClusteredLightsConfig config;
+  const CameraDesc camera = makeCamera(0.0f, 0.0f, 0.0f);
+  for (const bool bottomUp : {true, false}) {
+    const ClusterParams params = computeClusterParams(config, camera, kViewportSize, 0, bottomUp);
+    for (const float depth : {0.15f, 1.0f, 7.3f, 42.0f, 99.0f}) {
+      for (const float ndcX : {-0.95f, -0.3f, 0.1f, 0.8f}) {
+        for (const float ndcY : {-0.9f, 0.05f, 0.6f}) {
+          const float fragX = (ndcX * 0.5f + 0.5f) * kViewportSize.width;
+          const float fragY = (bottomUp ? ndcY * 0.5f + 0.5f : 0.5f - ndcY * 0.5f) *
+                              kViewportSize.height;
+          const float3 point = float3{ndcX * depth * params.tanHalfFov[0],
+                                      ndcY * depth * params.tanHalfFov[1],
+                                      -depth,
+                                      0.0f};
+          float3 boxMin, boxMax;
+          computeClusterBounds(
+              params, getClusterIndex(params, fragX, fragY, depth), boxMin, boxMax);
+          for (int axis = 0; axis != 3; axis++) {
+            ASSERT_LE(boxMin[axis], point[axis] + 1e-4f);
+            ASSERT_GE(boxMax[axis], point[axis] - 1e-4f);
+          }
+        }
+      }
+    }
+  }
+
+  // the slices cover the depth range
+  const ClusterParams params = computeClusterParams(config, camera, kViewportSize, 0, true);
+  float3 boxMin, boxMax;
+  computeClusterBounds(params, 0, boxMin, boxMax);
+  ASSERT_NEAR(boxMax[2], -camera.nearZ, 1e-5f);
+  const uint32_t lastCluster = config.tilesX * config.tilesY * config.numSlices - 1;
+  computeClusterBounds(params, lastCluster, boxMin, boxMax);
+  ASSERT_NEAR(boxMin[2], -camera.farZ, 1e-3f);
+}
+
+//
+// LightListsMatchBruteForce Test
+//
+TEST(ClusteredLightsTest, LightListsMatchBruteForce) {
+  ClusteredLightsConfig config;
+  config.maxLightsPerCluster = 256;
+  const CameraDesc camera = makeCamera(1.0f, -2.0f, 3.0f);
+  const std::vector<PointLight> lights = makeLights(300, 40.0f);
+  const ClusterParams params = computeClusterParams(
+      config, camera, kViewportSize, static_cast<uint32_t>(lights.size()), false);
+
+  const uint32_t numClusters = config.tilesX * config.tilesY * config.numSlices;
+  std::vector<uint32_t> counts(numClusters);
+  std::vector<uint32_t> indices(numClusters * config.maxLightsPerCluster);
+  buildLightLists(params, lights.data(), counts.data(), indices.data());
+
+  uint32_t totalCount = 0;
+  for (uint32_t c = 0; c != numClusters; c++) {
+    float3 boxMin, boxMax;
+    computeClusterBounds(params, c, boxMin, boxMax);
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i != lights.size(); i++) {
+      const float4& light = lights[i].positionRadius;
+      const float4 center = multiply(camera.view, float4{light[0], light[1], light[2], 1.0f});
+      float distanceSquared = 0.0f;
+      for (int axis = 0; axis != 3; axis++) {
+        const float d =
+            std::max(std::max(boxMin[axis] - center[axis], center[axis] - boxMax[axis]), 0.0f);
+        distanceSquared += d * d;
+      }
+      if (distanceSquared <= light[3] * light[3]) {
+        expected.push_back(i);
+      }
+    }
+    ASSERT_LT(expected.size(), config.maxLightsPerCluster);
+    ASSERT_EQ(counts[c], expected.size());
+    for (uint32_t i = 0; i != counts[c]; i++) {
+      ASSERT_EQ(indices[c * config.maxLightsPerCluster + i], expected[i]);
+    }
+    totalCount += counts[c];
+  }
+  // each light only touches a fraction of the clusters
+  ASSERT_GT(totalCount, 0u);
+  ASSERT_LT(totalCount, numClusters * lights.size() / 10);
+}
+
+//
+// MaxLightsPerCluster Test
+//
+TEST(ClusteredLightsTest, MaxLightsPerCluster) {
+  ClusteredLightsConfig config;
+  config.maxLightsPerCluster = 4;
+  const CameraDesc camera = makeCamera(0.0f, 0.0f, 0.0f);
+  // lights covering the whole frustum, and one behind the camera
+  std::vector<PointLight> lights(8);
+  for (PointLight& light : lights) {
+    light.positionRadius = float4{0.0f, 0.0f, -50.0f, 500.0f};
+  }
+  lights[1].positionRadius = float4{0.0f, 0.0f, 10.0f, 1.0f};
+  const ClusterParams params = computeClusterParams(
+      config, camera, kViewportSize, static_cast<uint32_t>(lights.size()), true);
+
+  const uint32_t numClusters = config.tilesX * config.tilesY * config.numSlices;
+  std::vector<uint32_t> counts(numClusters);
+  std::vector<uint32_t> indices(numClusters * config.maxLightsPerCluster);
+  buildLightLists(params, lights.data(), counts.data(), indices.data());
+  for (uint32_t c = 0; c != numClusters; c++) {
+    ASSERT_EQ(counts[c], 4u);
+    // the first lights are kept
+    ASSERT_EQ(indices[c * 4 + 0], 0u);
+    ASSERT_EQ(indices[c * 4 + 1], 2u);
+    ASSERT_EQ(indices[c * 4 + 3], 4u);
+  }
+}
+
+//
+// ComputeMatchesBuildLightLists Test
+//
+// The compute shader builds the same light lists as buildLightLists()
+//
+TEST_F(ClusteredLightsGpuTest, ComputeMatchesBuildLightLists) {
+  if (!iglDev_->hasFeature(igl::DeviceFeatures::Compute)) {
+    GTEST_SKIP() << "Compute is not supported";
+  }
+  if (iglDev_->hasFeature(igl::DeviceFeatures::BufferRing)) {
+    GTEST_SKIP() << "Ring buffers cannot be mapped";
+  }
+
+  ClusteredLightsConfig config;
+  config.maxLightsPerCluster = 256;
+  igl::Result result;
+  ClusteredLights clusteredLights(*iglDev_, config, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_TRUE(clusteredLights.usesCompute());
+
+  const CameraDesc camera = makeCamera(1.0f, -2.0f, 3.0f);
+  const std::vector<PointLight> lights = makeLights(300, 40.0f);
+  clusteredLights.setLights(lights, camera, kViewportSize);
+  auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  clusteredLights.cull(*cmdBuffer);
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  const ClusterParams params =
+      computeClusterParams(config,
+                           camera,
+                           kViewportSize,
+                           static_cast<uint32_t>(lights.size()),
+                           iglDev_->getBackendType() == igl::BackendType::OpenGL);
+  const uint32_t numClusters = clusteredLights.getNumClusters();
+  std::vector<uint32_t> expectedCounts(numClusters);
+  std::vector<uint32_t> expectedIndices(numClusters * config.maxLightsPerCluster);
+  buildLightLists(params, lights.data(), expectedCounts.data(), expectedIndices.data());
+
+  auto& countsBuffer = clusteredLights.getLightCountsBuffer();
+  auto& indicesBuffer = clusteredLights.getLightIndicesBuffer();
+  const auto* counts = static_cast<const uint32_t*>(
+      countsBuffer->map(igl::BufferRange(numClusters * sizeof(uint32_t), 0), &result));
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_NE(counts, nullptr);
+  const auto* indices = static_cast<const uint32_t*>(indicesBuffer->map(
+      igl::BufferRange(expectedIndices.size() * sizeof(uint32_t), 0), &result));
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_NE(indices, nullptr);
+  for (uint32_t c = 0; c != numClusters; c++) {
+    ASSERT_EQ(counts[c], expectedCounts[c]) << c;
+    for (uint32_t i = 0; i != counts[c]; i++) {
+      ASSERT_EQ(indices[c * config.maxLightsPerCluster + i],
+                expectedIndices[c * config.maxLightsPerCluster + i])
+          << c;
+    }
+  }
+  indicesBuffer->unmap();
+  countsBuffer->unmap();
+}
+
+} // namespace tests
+} // namespace iglu
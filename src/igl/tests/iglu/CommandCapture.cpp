@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../data/ShaderData.h"
+#include "../data/VertexIndexData.h"
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/command_capture/CaptureDevice.h>
+#include <IGLU/command_capture/CaptureReplayer.h>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+#define OFFSCREEN_TEX_WIDTH 2
+#define OFFSCREEN_TEX_HEIGHT 2
+
+namespace igl {
+namespace tests {
+
+using iglu::capture::CaptureDevice;
+using iglu::capture::CaptureReplayer;
+using iglu::capture::CaptureStream;
+using iglu::capture::Op;
+using iglu::capture::Record;
+using iglu::capture::RecordReader;
+using iglu::capture::RecordWriter;
+
+namespace {
+
+size_t countRecords(const CaptureStream& stream, Op op) {
+  size_t count = 0;
+  for (const Record& record : stream.parse(nullptr)) {
+    count += record.op == op ? 1 : 0;
+  }
+  return count;
+}
+
+} // namespace
+
+//
+// CaptureStreamTest
+//
+// Records are read back as written, from memory and from a file
+//
+TEST(CaptureStreamTest, RoundTrip) {
+  CaptureStream stream;
+  RecordWriter writer;
+  writer.write(uint32_t(42));
+  writer.writeString("name");
+  writer.writeBlob(data::vertex_index::QUAD_IND, sizeof(data::vertex_index::QUAD_IND));
+  stream.append(Op::UploadBuffer, writer);
+  stream.append(Op::EndRenderPass, RecordWriter());
+
+  const std::string path = ::testing::TempDir() + "CaptureStreamTest_RoundTrip.bin";
+  Result result;
+  ASSERT_TRUE(stream.save(path, &result)) << result.message;
+  CaptureStream loaded;
+  ASSERT_TRUE(CaptureStream::load(path, loaded, &result)) << result.message;
+  std::remove(path.c_str());
+  ASSERT_EQ(loaded.data(), stream.data());
+
+  const std::vector<Record> records = loaded.parse(&result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(records.size(), 2u);
+  ASSERT_EQ(records[0].op, Op::UploadBuffer);
+  ASSERT_EQ(records[1].op, Op::EndRenderPass);
+  ASSERT_EQ(records[1].size, 0u);
+
+  RecordReader reader(records[0].data, records[0].size);
+  ASSERT_EQ(reader.read<uint32_t>(), 42u);
+  ASSERT_EQ(reader.readString(), "name");
+  size_t length = 0;
+  const uint8_t* bytes = reader.readBlob(length);
+  ASSERT_EQ(length, sizeof(data::vertex_index::QUAD_IND));
+  ASSERT_EQ(std::memcmp(bytes, data::vertex_index::QUAD_IND, length), 0);
+  ASSERT_FALSE(reader.failed());
+
+  // reading past the end of the payload
+  ASSERT_EQ(reader.read<uint32_t>(), 0u);
+  ASSERT_TRUE(reader.failed());
+}
+
+//
+// CaptureStreamTest
+//
+// Foreign and truncated streams are rejected
+//
+TEST(CaptureStreamTest, Invalid) {
+  Result result;
+  ASSERT_TRUE(CaptureStream(std::vector<uint8_t>(3, 0)).parse(&result).empty());
+  ASSERT_FALSE(result.isOk());
+  ASSERT_TRUE(CaptureStream(std::vector<uint8_t>(16, 0)).parse(&result).empty());
+  ASSERT_FALSE(result.isOk());
+
+  CaptureStream stream;
+  RecordWriter writer;
+  writer.write(uint64_t(1));
+  stream.append(Op::Draw, writer);
+  std::vector<uint8_t> data = stream.data();
+  data.pop_back();
+  ASSERT_TRUE(CaptureStream(std::move(data)).parse(&result).empty());
+  ASSERT_FALSE(result.isOk());
+
+  ASSERT_FALSE(CaptureStream::load(::testing::TempDir() + "CaptureStreamTest_Missing.bin",
+                                   stream,
+                                   &result));
+}
+
+//
+// CommandCaptureTest
+//
+// Test fixture for the tests recording through a CaptureDevice wrapping the test device
+//
+class CommandCaptureTest : public ::testing::Test {
+ public:
+  CommandCaptureTest() = default;
+  ~CommandCaptureTest() override = default;
+
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    iglDev_ = util::createTestDevice();
+    ASSERT_TRUE(iglDev_ != nullptr);
+    captureDev_ = std::make_shared<CaptureDevice>(iglDev_);
+
+    Result ret;
+    cmdQueue_ = captureDev_->createCommandQueue({CommandQueueType::Graphics}, &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+
+    // everything below is created through the capture device
+    const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                   OFFSCREEN_TEX_WIDTH,
+                                                   OFFSCREEN_TEX_HEIGHT,
+                                                   TextureDesc::TextureUsageBits::Sampled |
+                                                       TextureDesc::TextureUsageBits::Attachment);
+    offscreenTexture_ = captureDev_->createTexture(texDesc, &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+
+    inputTexture_ = captureDev_->createTexture(
+        TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                           OFFSCREEN_TEX_WIDTH,
+                           OFFSCREEN_TEX_HEIGHT,
+                           TextureDesc::TextureUsageBits::Sampled),
+        &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+    const uint32_t pixels[OFFSCREEN_TEX_WIDTH * OFFSCREEN_TEX_HEIGHT] = {
+        0xff0000ff, 0xff00ff00, 0xffff0000, 0xffffffff};
+    ret = inputTexture_->upload(
+        TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, OFFSCREEN_TEX_HEIGHT), pixels);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+
+    FramebufferDesc framebufferDesc;
+    framebufferDesc.colorAttachments[0].texture = offscreenTexture_;
+    framebuffer_ = captureDev_->createFramebuffer(framebufferDesc, &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+
+    renderPass_.colorAttachments.resize(1);
+    renderPass_.colorAttachments[0].loadAction = LoadAction::Clear;
+    renderPass_.colorAttachments[0].storeAction = StoreAction::Store;
+    renderPass_.colorAttachments[0].clearColor = {0.0, 0.0, 0.0, 1.0};
+
+    std::unique_ptr<IShaderStages> stages;
+    util::createSimpleShaderStages(captureDev_, stages);
+    ASSERT_TRUE(stages != nullptr);
+
+    VertexInputStateDesc inputDesc;
+    inputDesc.attributes[0].format = VertexAttributeFormat::Float4;
+    inputDesc.attributes[0].offset = 0;
+    inputDesc.attributes[0].bufferIndex = data::shader::simplePosIndex;
+    inputDesc.attributes[0].name = data::shader::simplePos;
+    inputDesc.attributes[0].location = 0;
+    inputDesc.inputBindings[0].stride = sizeof(float) * 4;
+    inputDesc.attributes[1].format = VertexAttributeFormat::Float2;
+    inputDesc.attributes[1].offset = 0;
+    inputDesc.attributes[1].bufferIndex = data::shader::simpleUvIndex;
+    inputDesc.attributes[1].name = data::shader::simpleUv;
+    inputDesc.attributes[1].location = 1;
+    inputDesc.inputBindings[1].stride = sizeof(float) * 2;
+    inputDesc.numAttributes = inputDesc.numInputBindings = 2;
+
+    RenderPipelineDesc pipelineDesc;
+    pipelineDesc.vertexInputState = captureDev_->createVertexInputState(inputDesc, &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+    pipelineDesc.shaderStages = std::move(stages);
+    pipelineDesc.targetDesc.colorAttachments.resize(1);
+    pipelineDesc.targetDesc.colorAttachments[0].textureFormat = offscreenTexture_->getFormat();
+    pipelineDesc.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE(data::shader::simpleSampler);
+    pipelineDesc.cullMode = CullMode::Disabled;
+    pipelineState_ = captureDev_->createRenderPipeline(pipelineDesc, &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+
+    ib_ = captureDev_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Index,
+                                               data::vertex_index::QUAD_IND,
+                                               sizeof(data::vertex_index::QUAD_IND)),
+                                    &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+    vb_ = captureDev_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Vertex,
+                                               data::vertex_index::QUAD_VERT,
+                                               sizeof(data::vertex_index::QUAD_VERT)),
+                                    &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+    uv_ = captureDev_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Vertex,
+                                               data::vertex_index::QUAD_UV,
+                                               sizeof(data::vertex_index::QUAD_UV)),
+                                    &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+
+    samp_ = captureDev_->createSamplerState(SamplerStateDesc(), &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+  }
+
+  void TearDown() override {}
+
+  void drawQuad() {
+    Result ret;
+    auto cmdBuf = cmdQueue_->createCommandBuffer({}, &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+    auto cmds = cmdBuf->createRenderCommandEncoder(renderPass_, framebuffer_, &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+    cmds->bindRenderPipelineState(pipelineState_);
+    cmds->bindBuffer(data::shader::simplePosIndex, BindTarget::kVertex, vb_, 0);
+    cmds->bindBuffer(data::shader::simpleUvIndex, BindTarget::kVertex, uv_, 0);
+    cmds->bindTexture(0, BindTarget::kFragment, inputTexture_.get());
+    cmds->bindSamplerState(0, BindTarget::kFragment, samp_.get());
+    cmds->drawIndexed(PrimitiveType::Triangle, 6, IndexFormat::UInt16, *ib_, 0);
+    cmds->endEncoding();
+    cmdQueue_->submit(*cmdBuf, true);
+    cmdBuf->waitUntilCompleted();
+  }
+
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<CaptureDevice> captureDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+
+  RenderPassDesc renderPass_;
+  std::shared_ptr<ITexture> offscreenTexture_;
+  std::shared_ptr<ITexture> inputTexture_;
+  std::shared_ptr<IFramebuffer> framebuffer_;
+  std::shared_ptr<IRenderPipelineState> pipelineState_;
+  std::shared_ptr<IBuffer> vb_, uv_, ib_;
+  std::shared_ptr<ISamplerState> samp_;
+};
+
+//
+// RecordAndReplay Test
+//
+// A recorded frame is replayed several times, with the uploads skipped after the first iteration
+//
+TEST_F(CommandCaptureTest, RecordAndReplay) {
+  const float uv[] = {0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+  ASSERT_TRUE(uv_->upload(uv, BufferRange(sizeof(uv), 0)).isOk());
+  drawQuad();
+
+  const CaptureStream stream = captureDev_->getStream();
+  ASSERT_EQ(countRecords(stream, Op::CreateBuffer), 3u);
+  ASSERT_EQ(countRecords(stream, Op::UploadBuffer), 1u);
+  ASSERT_EQ(countRecords(stream, Op::UploadTexture), 1u);
+  ASSERT_EQ(countRecords(stream, Op::CreateRenderPipeline), 1u);
+  ASSERT_EQ(countRecords(stream, Op::BeginRenderPass), 1u);
+  ASSERT_EQ(countRecords(stream, Op::DrawIndexed), 1u);
+  ASSERT_EQ(countRecords(stream, Op::Submit), 1u);
+
+  iglu::capture::ReplayOptions options;
+  options.iterations = 3;
+  options.skipUploads = true;
+  iglu::capture::ReplayStats stats;
+  Result ret;
+  ASSERT_TRUE(CaptureReplayer(*iglDev_).replay(stream, options, stats, &ret)) << ret.message;
+  ASSERT_EQ(stats.iterations, 3u);
+  ASSERT_EQ(stats.frames, 3u);
+  ASSERT_EQ(stats.submits, 3u);
+  ASSERT_EQ(stats.draws, 3u);
+  ASSERT_EQ(stats.totalSeconds.size(), 3u);
+  ASSERT_GE(stats.getAverageIterationSeconds(), 0.0);
+}
+
+//
+// RecordingCommands Test
+//
+// Resources are recorded while commands are not
+//
+TEST_F(CommandCaptureTest, RecordingCommands) {
+  captureDev_->setRecordingCommands(false);
+  drawQuad();
+  ASSERT_EQ(countRecords(captureDev_->getStream(), Op::BeginCommandBuffer), 0u);
+  ASSERT_EQ(countRecords(captureDev_->getStream(), Op::DrawIndexed), 0u);
+
+  captureDev_->setRecordingCommands(true);
+  drawQuad();
+  const CaptureStream stream = captureDev_->getStream();
+  ASSERT_EQ(countRecords(stream, Op::CreateTexture), 2u);
+  ASSERT_EQ(countRecords(stream, Op::BeginCommandBuffer), 1u);
+  ASSERT_EQ(countRecords(stream, Op::DrawIndexed), 1u);
+
+  // draws are counted whether they are recorded or not
+  cmdQueue_->endFrame();
+  ASSERT_EQ(cmdQueue_->getLastFrameDrawCount(), 2u);
+}
+
+} // namespace tests
+} // namespace igl
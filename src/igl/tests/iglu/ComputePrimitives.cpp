@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/compute_primitives/ComputePrimitives.h>
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+using iglu::computeprimitives::ComputePrimitives;
+using iglu::computeprimitives::ReduceOp;
+
+namespace {
+// spans three levels of workgroups
+constexpr uint32_t kNumElements = 70000;
+} // namespace
+
+class ComputePrimitivesTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+    if (!iglDev_->hasFeature(DeviceFeatures::Compute)) {
+      GTEST_SKIP() << "Compute is not supported";
+    }
+    if (iglDev_->hasFeature(DeviceFeatures::BufferRing)) {
+      GTEST_SKIP() << "Ring buffers cannot be mapped";
+    }
+  }
+
+ protected:
+  std::shared_ptr<IBuffer> createBuffer(const std::vector<uint32_t>& data) {
+    BufferDesc desc(BufferDesc::BufferTypeBits::Storage,
+                    data.data(),
+                    data.size() * sizeof(uint32_t),
+                    ResourceStorage::Shared);
+    Result result;
+    auto buffer = iglDev_->createBuffer(desc, &result);
+    EXPECT_TRUE(result.isOk()) << result.message;
+    return buffer;
+  }
+
+  std::vector<uint32_t> readBuffer(IBuffer& buffer, size_t numElements) {
+    Result result;
+    const auto* data = static_cast<const uint32_t*>(
+        buffer.map(BufferRange(numElements * sizeof(uint32_t), 0), &result));
+    EXPECT_TRUE(result.isOk()) << result.message;
+    if (data == nullptr) {
+      return {};
+    }
+    std::vector<uint32_t> values(data, data + numElements);
+    buffer.unmap();
+    return values;
+  }
+
+  template<typename Func>
+  void run(Func&& func) {
+    Result result;
+    auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &result);
+    ASSERT_TRUE(result.isOk()) << result.message;
+    func(*cmdBuffer);
+    cmdQueue_->submit(*cmdBuffer);
+    cmdBuffer->waitUntilCompleted();
+  }
+
+  static std::vector<uint32_t> randomValues(size_t numElements, uint32_t maxValue) {
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<uint32_t> distribution(0, maxValue);
+    std::vector<uint32_t> values(numElements);
+    for (uint32_t& v : values) {
+      v = distribution(random);
+    }
+    return values;
+  }
+
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+//
+// InvalidArguments Test
+//
+TEST_F(ComputePrimitivesTest, InvalidArguments) {
+  Result result;
+  const ComputePrimitives empty(*iglDev_, 0, &result);
+  ASSERT_EQ(result.code, Result::Code::ArgumentOutOfRange);
+
+  const ComputePrimitives tooLarge(*iglDev_, 65535u * 256u + 1u, &result);
+  ASSERT_EQ(result.code, Result::Code::ArgumentOutOfRange);
+}
+
+//
+// Scan Test
+//
+// Exclusive and inclusive scans, in place and not
+//
+TEST_F(ComputePrimitivesTest, Scan) {
+  Result result;
+  ComputePrimitives primitives(*iglDev_, kNumElements, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  const std::vector<uint32_t> input = randomValues(kNumElements, 100);
+  std::vector<uint32_t> exclusive(kNumElements);
+  std::exclusive_scan(input.begin(), input.end(), exclusive.begin(), 0u);
+  std::vector<uint32_t> inclusive(kNumElements);
+  std::inclusive_scan(input.begin(), input.end(), inclusive.begin());
+
+  auto inputBuffer = createBuffer(input);
+  auto outputBuffer = createBuffer(std::vector<uint32_t>(kNumElements));
+  run([&](ICommandBuffer& cmdBuffer) {
+    primitives.exclusiveScan(cmdBuffer, inputBuffer, outputBuffer, kNumElements);
+  });
+  ASSERT_EQ(readBuffer(*outputBuffer, kNumElements), exclusive);
+
+  run([&](ICommandBuffer& cmdBuffer) {
+    primitives.inclusiveScan(cmdBuffer, inputBuffer, inputBuffer, kNumElements);
+  });
+  ASSERT_EQ(readBuffer(*inputBuffer, kNumElements), inclusive);
+
+  // a partial workgroup
+  auto smallBuffer = createBuffer({1, 2, 3, 4, 5});
+  run([&](ICommandBuffer& cmdBuffer) {
+    primitives.exclusiveScan(cmdBuffer, smallBuffer, smallBuffer, 5);
+  });
+  ASSERT_EQ(readBuffer(*smallBuffer, 5), std::vector<uint32_t>({0, 1, 3, 6, 10}));
+}
+
+//
+// Compact Test
+//
+// The flagged elements are copied in order, and counted
+//
+TEST_F(ComputePrimitivesTest, Compact) {
+  Result result;
+  ComputePrimitives primitives(*iglDev_, kNumElements, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  std::vector<uint32_t> input(kNumElements);
+  std::iota(input.begin(), input.end(), 0u);
+  const std::vector<uint32_t> flags = randomValues(kNumElements, 3);
+  std::vector<uint32_t> expected;
+  for (size_t i = 0; i != kNumElements; i++) {
+    if (flags[i] != 0) {
+      expected.push_back(input[i]);
+    }
+  }
+
+  auto inputBuffer = createBuffer(input);
+  auto flagsBuffer = createBuffer(flags);
+  auto outputBuffer = createBuffer(std::vector<uint32_t>(kNumElements));
+  auto countBuffer = createBuffer({0, 0, 0});
+  run([&](ICommandBuffer& cmdBuffer) {
+    primitives.compact(
+        cmdBuffer, inputBuffer, flagsBuffer, outputBuffer, countBuffer, 1, kNumElements);
+  });
+  ASSERT_EQ(readBuffer(*countBuffer, 3),
+            std::vector<uint32_t>({0, static_cast<uint32_t>(expected.size()), 0}));
+  ASSERT_EQ(readBuffer(*outputBuffer, expected.size()), expected);
+
+  // nothing to compact
+  run([&](ICommandBuffer& cmdBuffer) {
+    primitives.compact(cmdBuffer, inputBuffer, flagsBuffer, outputBuffer, countBuffer, 1, 0);
+  });
+  ASSERT_EQ(readBuffer(*countBuffer, 3)[1], 0u);
+}
+
+//
+// Sort Test
+//
+// The keys are sorted, and the values of equal keys keep their order
+//
+TEST_F(ComputePrimitivesTest, Sort) {
+  Result result;
+  ComputePrimitives primitives(*iglDev_, kNumElements, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  const std::vector<uint32_t> keys = randomValues(kNumElements, 0xffffffffu);
+  std::vector<uint32_t> values(kNumElements);
+  std::iota(values.begin(), values.end(), 0u);
+
+  std::vector<uint32_t> expectedValues = values;
+  std::stable_sort(expectedValues.begin(),
+                   expectedValues.end(),
+                   [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+  std::vector<uint32_t> expectedKeys(kNumElements);
+  for (size_t i = 0; i != kNumElements; i++) {
+    expectedKeys[i] = keys[expectedValues[i]];
+  }
+
+  auto keysBuffer = createBuffer(keys);
+  auto valuesBuffer = createBuffer(values);
+  run([&](ICommandBuffer& cmdBuffer) {
+    primitives.sort(cmdBuffer, keysBuffer, valuesBuffer, kNumElements);
+  });
+  ASSERT_EQ(readBuffer(*keysBuffer, kNumElements), expectedKeys);
+  ASSERT_EQ(readBuffer(*valuesBuffer, kNumElements), expectedValues);
+
+  // 16-bit keys with many duplicates, without values
+  std::vector<uint32_t> shortKeys = randomValues(1000, 0xff);
+  auto shortKeysBuffer = createBuffer(shortKeys);
+  run([&](ICommandBuffer& cmdBuffer) {
+    primitives.sort(cmdBuffer, shortKeysBuffer, nullptr, 1000, 16);
+  });
+  std::sort(shortKeys.begin(), shortKeys.end());
+  ASSERT_EQ(readBuffer(*shortKeysBuffer, 1000), shortKeys);
+}
+
+//
+// Reduce Test
+//
+TEST_F(ComputePrimitivesTest, Reduce) {
+  Result result;
+  ComputePrimitives primitives(*iglDev_, kNumElements, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  const std::vector<uint32_t> input = randomValues(kNumElements, 1000000);
+  auto inputBuffer = createBuffer(input);
+  auto outputBuffer = createBuffer(std::vector<uint32_t>(6, 7));
+  run([&](ICommandBuffer& cmdBuffer) {
+    primitives.reduce(cmdBuffer, inputBuffer, ReduceOp::Sum, outputBuffer, 0, kNumElements);
+    primitives.reduce(cmdBuffer, inputBuffer, ReduceOp::Min, outputBuffer, 1, kNumElements);
+    primitives.reduce(cmdBuffer, inputBuffer, ReduceOp::Max, outputBuffer, 2, kNumElements);
+    // the identities
+    primitives.reduce(cmdBuffer, inputBuffer, ReduceOp::Sum, outputBuffer, 3, 0);
+    primitives.reduce(cmdBuffer, inputBuffer, ReduceOp::Min, outputBuffer, 4, 0);
+    primitives.reduce(cmdBuffer, inputBuffer, ReduceOp::Max, outputBuffer, 5, 0);
+  });
+  ASSERT_EQ(readBuffer(*outputBuffer, 6),
+            std::vector<uint32_t>({std::accumulate(input.begin(), input.end(), 0u),
+                                   *std::min_element(input.begin(), input.end()),
+                                   *std::max_element(input.begin(), input.end()),
+                                   0,
+                                   0xffffffffu,
+                                   0}));
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/skinning/ComputeSkinning.h>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace iglu {
+namespace tests {
+
+using namespace simdtypes;
+using namespace skinning;
+
+namespace {
+
+SkinningVertex makeVertex(float x, float y, float z) {
+  SkinningVertex vertex;
+  vertex.position[0] = x;
+  vertex.position[1] = y;
+  vertex.position[2] = z;
+  vertex.normal[0] = 1.0f;
+  vertex.weights[0] = 1.0f;
+  return vertex;
+}
+
+SkinnedVertex skin(const std::vector<uint32_t>& words,
+                   uint32_t vertex,
+                   const std::vector<float4x4>& joints,
+                   const std::vector<float>& morphWeights = {0.0f}) {
+  std::vector<float> palette(joints.size() * kFloatsPerJoint);
+  for (size_t j = 0; j != joints.size(); j++) {
+    packJointMatrix(joints[j], palette.data() + j * kFloatsPerJoint);
+  }
+  SkinnedVertex out;
+  skinVertex(words.data(), vertex, palette.data(), morphWeights.data(), out);
+  return out;
+}
+
+float4x4 makeTransform(float angle, float tx, float ty, float tz) {
+  const float c = std::cos(angle);
+  const float s = std::sin(angle);
+  return float4x4(float4{c, s, 0.0f, 0.0f},
+                  float4{-s, c, 0.0f, 0.0f},
+                  float4{0.0f, 0.0f, 1.0f, 0.0f},
+                  float4{tx, ty, tz, 1.0f});
+}
+
+} // namespace
+
+class ComputeSkinningGpuTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    igl::setDebugBreakEnabled(false);
+    igl::tests::util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+ protected:
+  std::shared_ptr<igl::IDevice> iglDev_;
+  std::shared_ptr<igl::ICommandQueue> cmdQueue_;
+};
+
+//
+// JointTransforms Test
+//
+// The identity palette keeps the bind pose, and a rotated and moved joint moves its vertices
+// rigidly
+//
+TEST(ComputeSkinningTest, JointTransforms) {
+  std::vector<SkinnedMeshDesc> meshes(2);
+  meshes[0].vertices = {makeVertex(1.0f, 2.0f, 3.0f)};
+  meshes[1].numJoints = 2;
+  meshes[1].vertices = {makeVertex(4.0f, 0.0f, 0.0f), makeVertex(1.0f, 0.0f, 0.0f)};
+  meshes[1].vertices[1].joints[0] = 1;
+
+  std::vector<uint32_t> words, firstVertices;
+  ASSERT_TRUE(packSkinnedMeshes(meshes, words, firstVertices).isOk());
+  ASSERT_EQ(words.size(), 3u * kWordsPerVertex);
+  ASSERT_EQ(firstVertices[0], 0u);
+  ASSERT_EQ(firstVertices[1], 1u);
+
+  const float4x4 identity(1.0f);
+  SkinnedVertex v = skin(words, 0, {identity});
+  ASSERT_FLOAT_EQ(v.position[0], 1.0f);
+  ASSERT_FLOAT_EQ(v.position[1], 2.0f);
+  ASSERT_FLOAT_EQ(v.position[2], 3.0f);
+  ASSERT_FLOAT_EQ(v.normal[0], 1.0f);
+
+  // 90 degrees around Z, then moved along Z
+  const float4x4 rotation(float4{0.0f, 1.0f, 0.0f, 0.0f},
+                          float4{-1.0f, 0.0f, 0.0f, 0.0f},
+                          float4{0.0f, 0.0f, 1.0f, 0.0f},
+                          float4{0.0f, 0.0f, 5.0f, 1.0f});
+  v = skin(words, 1, {identity, rotation});
+  ASSERT_NEAR(v.position[0], 4.0f, 1e-6f);
+  ASSERT_NEAR(v.position[2], 0.0f, 1e-6f);
+  v = skin(words, 2, {identity, rotation});
+  ASSERT_NEAR(v.position[0], 0.0f, 1e-6f);
+  ASSERT_NEAR(v.position[1], 1.0f, 1e-6f);
+  ASSERT_NEAR(v.position[2], 5.0f, 1e-6f);
+  ASSERT_NEAR(v.normal[0], 0.0f, 1e-6f);
+  ASSERT_NEAR(v.normal[1], 1.0f, 1e-6f);
+}
+
+//
+// WeightBlending Test
+//
+// The weights are normalized and blend the joints' transforms
+//
+TEST(ComputeSkinningTest, WeightBlending) {
+  std::vector<SkinnedMeshDesc> meshes(1);
+  meshes[0].numJoints = 2;
+  SkinningVertex vertex = makeVertex(0.0f, 0.0f, 0.0f);
+  vertex.joints[1] = 1;
+  vertex.weights[0] = 3.0f;
+  vertex.weights[1] = 1.0f;
+  meshes[0].vertices = {vertex};
+
+  std::vector<uint32_t> words, firstVertices;
+  ASSERT_TRUE(packSkinnedMeshes(meshes, words, firstVertices).isOk());
+  const float4x4 moved(float4{1.0f, 0.0f, 0.0f, 0.0f},
+                       float4{0.0f, 1.0f, 0.0f, 0.0f},
+                       float4{0.0f, 0.0f, 1.0f, 0.0f},
+                       float4{8.0f, 0.0f, 0.0f, 1.0f});
+  const SkinnedVertex v = skin(words, 0, {float4x4(1.0f), moved});
+  ASSERT_NEAR(v.position[0], 2.0f, 1e-4f);
+  ASSERT_NEAR(v.normal[0], 1.0f, 1e-6f);
+}
+
+//
+// MorphTargets Test
+//
+// The deltas of the morph targets are scaled by their weights before skinning
+//
+TEST(ComputeSkinningTest, MorphTargets) {
+  std::vector<SkinnedMeshDesc> meshes(1);
+  meshes[0].vertices = {makeVertex(0.0f, 0.0f, 0.0f), makeVertex(1.0f, 0.0f, 0.0f)};
+  meshes[0].morphTargets.resize(2);
+  MorphDelta delta;
+  delta.vertex = 1;
+  delta.position[1] = 2.0f;
+  meshes[0].morphTargets[0].deltas = {delta};
+  delta.position[1] = 0.0f;
+  delta.position[2] = -4.0f;
+  meshes[0].morphTargets[1].deltas = {delta};
+
+  std::vector<uint32_t> words, firstVertices;
+  ASSERT_TRUE(packSkinnedMeshes(meshes, words, firstVertices).isOk());
+  ASSERT_EQ(words.size(), 2u * kWordsPerVertex + 2u * kWordsPerDelta);
+
+  const float4x4 moved(float4{1.0f, 0.0f, 0.0f, 0.0f},
+                       float4{0.0f, 1.0f, 0.0f, 0.0f},
+                       float4{0.0f, 0.0f, 1.0f, 0.0f},
+                       float4{0.0f, 0.0f, 1.0f, 1.0f});
+  SkinnedVertex v = skin(words, 1, {moved}, {0.5f, 0.25f});
+  ASSERT_FLOAT_EQ(v.position[0], 1.0f);
+  ASSERT_FLOAT_EQ(v.position[1], 1.0f);
+  ASSERT_FLOAT_EQ(v.position[2], 0.0f);
+  // the other vertex has no deltas
+  v = skin(words, 0, {moved}, {0.5f, 0.25f});
+  ASSERT_FLOAT_EQ(v.position[1], 0.0f);
+  ASSERT_FLOAT_EQ(v.position[2], 1.0f);
+}
+
+//
+// InvalidMeshes Test
+//
+TEST(ComputeSkinningTest, InvalidMeshes) {
+  std::vector<uint32_t> words, firstVertices;
+  std::vector<SkinnedMeshDesc> meshes(1);
+  meshes[0].vertices = {makeVertex(0.0f, 0.0f, 0.0f)};
+  meshes[0].vertices[0].joints[0] = 1;
+  ASSERT_EQ(packSkinnedMeshes(meshes, words, firstVertices).code,
+            igl::Result::Code::ArgumentOutOfRange);
+
+  meshes[0].vertices[0].joints[0] = 0;
+  meshes[0].vertices[0].weights[0] = 0.0f;
+  ASSERT_EQ(packSkinnedMeshes(meshes, words, firstVertices).code,
+            igl::Result::Code::ArgumentInvalid);
+
+  meshes[0].vertices[0].weights[0] = 1.0f;
+  meshes[0].morphTargets.resize(1);
+  meshes[0].morphTargets[0].deltas.resize(1);
+  meshes[0].morphTargets[0].deltas[0].vertex = 1;
+  ASSERT_EQ(packSkinnedMeshes(meshes, words, firstVertices).code,
+            igl::Result::Code::ArgumentOutOfRange);
+}
+
+//
+// MatchesCpuSkinning Test
+//
+// The compute shader skins the vertices of all instances like skinVertex()
+//
+TEST_F(ComputeSkinningGpuTest, MatchesCpuSkinning) {
+  if (!iglDev_->hasFeature(igl::DeviceFeatures::Compute)) {
+    GTEST_SKIP() << "Compute is not supported";
+  }
+
+  std::vector<SkinnedMeshDesc> meshes(2);
+  meshes[0].numJoints = 2;
+  meshes[0].vertices = {
+      makeVertex(1.0f, 0.0f, 0.0f), makeVertex(0.0f, 2.0f, 1.0f), makeVertex(-1.0f, 1.0f, 3.0f)};
+  meshes[0].vertices[1].joints[1] = 1;
+  meshes[0].vertices[1].weights[1] = 1.0f;
+  meshes[0].vertices[2].joints[0] = 1;
+  meshes[0].morphTargets.resize(1);
+  MorphDelta delta;
+  delta.vertex = 2;
+  delta.position[0] = 2.0f;
+  delta.normal[1] = 1.0f;
+  meshes[0].morphTargets[0].deltas = {delta};
+  meshes[1].vertices = {makeVertex(3.0f, 0.0f, 0.0f), makeVertex(0.0f, 0.0f, -2.0f)};
+  const std::vector<uint32_t> instanceMeshes = {0, 1, 0};
+
+  igl::Result result;
+  ComputeSkinning skinning(*iglDev_, meshes, instanceMeshes, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(skinning.getNumInstances(), 3u);
+  ASSERT_EQ(skinning.getNumVertices(), 8u);
+
+  std::vector<std::vector<float4x4>> joints(instanceMeshes.size());
+  std::vector<std::vector<float>> morphWeights(instanceMeshes.size());
+  for (uint32_t i = 0; i != instanceMeshes.size(); i++) {
+    for (uint32_t j = 0; j != meshes[instanceMeshes[i]].numJoints; j++) {
+      joints[i].push_back(makeTransform(0.5f * (i + j), 1.0f * i, 2.0f * j, -1.0f));
+    }
+    // mesh 1 has no morph targets
+    morphWeights[i] = {0.25f * (i + 1)};
+    skinning.setJointMatrices(i, joints[i].data());
+    skinning.setMorphWeights(i, morphWeights[i].data());
+  }
+
+  auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  skinning.skin(*cmdBuffer);
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  std::vector<uint32_t> words, firstVertices;
+  ASSERT_TRUE(packSkinnedMeshes(meshes, words, firstVertices).isOk());
+
+  auto& vertexBuffer = skinning.getVertexBuffer();
+  const auto* vertices = static_cast<const SkinnedVertex*>(vertexBuffer->map(
+      igl::BufferRange(skinning.getNumVertices() * sizeof(SkinnedVertex), 0), &result));
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_NE(vertices, nullptr);
+  for (uint32_t i = 0; i != instanceMeshes.size(); i++) {
+    const uint32_t mesh = instanceMeshes[i];
+    for (uint32_t v = 0; v != meshes[mesh].vertices.size(); v++) {
+      const SkinnedVertex expected =
+          skin(words, firstVertices[mesh] + v, joints[i], morphWeights[i]);
+      const SkinnedVertex& actual = vertices[skinning.getFirstVertex(i) + v];
+      for (int c = 0; c != 3; c++) {
+        EXPECT_NEAR(actual.position[c], expected.position[c], 1e-4f) << i << " " << v;
+        EXPECT_NEAR(actual.normal[c], expected.normal[c], 1e-4f) << i << " " << v;
+      }
+    }
+  }
+  vertexBuffer->unmap();
+}
+
+} // namespace tests
+} // namespace iglu
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/SimdMatrices.h"
+#include <IGLU/simple_renderer/Culler.h>
+#include <gtest/gtest.h>
+#include <igl/WorkerPool.h>
+#include <vector>
+
+namespace iglu {
+namespace tests {
+
+using namespace simdtypes;
+using igl::tests::util::makeOrtho;
+
+namespace {
+
+vertexdata::Bounds makeBounds(float x, float y, float z, float halfSize) {
+  vertexdata::Bounds bounds;
+  const float corner0[3] = {x - halfSize, y - halfSize, z - halfSize};
+  const float corner1[3] = {x + halfSize, y + halfSize, z + halfSize};
+  bounds.extend(corner0);
+  bounds.extend(corner1);
+  return bounds;
+}
+
+} // namespace
+
+//
+// TransformBounds Test
+//
+TEST(CullerTest, TransformBounds) {
+  const vertexdata::Bounds bounds = makeBounds(0.0f, 0.0f, 0.0f, 1.0f);
+  const float4x4 model(float4{2.0f, 0.0f, 0.0f, 0.0f},
+                       float4{0.0f, 1.0f, 0.0f, 0.0f},
+                       float4{0.0f, 0.0f, 1.0f, 0.0f},
+                       float4{3.0f, 0.0f, 0.0f, 1.0f});
+  const vertexdata::Bounds result = culling::transformBounds(bounds, model);
+  ASSERT_TRUE(result.isValid);
+  ASSERT_FLOAT_EQ(result.min[0], 1.0f);
+  ASSERT_FLOAT_EQ(result.max[0], 5.0f);
+  ASSERT_FLOAT_EQ(result.min[1], -1.0f);
+  ASSERT_FLOAT_EQ(result.max[1], 1.0f);
+
+  ASSERT_FALSE(culling::transformBounds(vertexdata::Bounds{}, model).isValid);
+}
+
+//
+// Frustum Test
+//
+// The same boxes are visible with and without a worker pool
+//
+TEST(CullerTest, Frustum) {
+  std::vector<vertexdata::Bounds> bounds;
+  for (int i = 0; i != 5000; i++) {
+    // every other box is outside on the right
+    bounds.push_back(makeBounds((i % 2) ? 3.0f : 0.0f, 0.0f, 0.0f, 0.5f));
+  }
+  bounds.push_back(vertexdata::Bounds{}); // never culled
+
+  culling::Culler culler;
+  culler.setViewProjection(makeOrtho(), true);
+  std::vector<uint8_t> visible;
+  ASSERT_EQ(culler.cull(bounds, visible), 2501u);
+  ASSERT_EQ(visible.size(), bounds.size());
+  ASSERT_EQ(visible[0], 1);
+  ASSERT_EQ(visible[1], 0);
+  ASSERT_EQ(visible.back(), 1);
+
+  culling::Culler parallelCuller(std::make_shared<igl::WorkerPool>(4));
+  parallelCuller.setViewProjection(makeOrtho(), true);
+  std::vector<uint8_t> parallelVisible;
+  ASSERT_EQ(parallelCuller.cull(bounds, parallelVisible), 2501u);
+  ASSERT_EQ(visible, parallelVisible);
+}
+
+//
+// Occlusion Test
+//
+// Boxes behind the depth of the previous frame are culled
+//
+TEST(CullerTest, Occlusion) {
+  // the left half of the screen is covered at a depth of 0.5 (z = 0), the right half is empty
+  constexpr uint32_t kSize = 16;
+  std::vector<float> depth(kSize * kSize);
+  for (uint32_t y = 0; y != kSize; y++) {
+    for (uint32_t x = 0; x != kSize; x++) {
+      depth[y * kSize + x] = x < kSize / 2 ? 0.5f : 1.0f;
+    }
+  }
+
+  culling::Culler culler;
+  culler.setViewProjection(makeOrtho(), true);
+  culler.occlusionBuffer().update(depth.data(), kSize, kSize, makeOrtho(), true);
+  ASSERT_TRUE(culler.occlusionBuffer().isValid());
+
+  const std::vector<vertexdata::Bounds> bounds = {
+      makeBounds(-0.5f, 0.0f, 0.5f, 0.2f), // behind the left half
+      makeBounds(-0.5f, 0.0f, -0.5f, 0.2f), // in front of the left half
+      makeBounds(0.5f, 0.0f, 0.5f, 0.2f), // right half
+      makeBounds(0.0f, 0.0f, 0.5f, 0.2f), // straddling both halves
+  };
+  std::vector<uint8_t> visible;
+  ASSERT_EQ(culler.cull(bounds, visible), 3u);
+  ASSERT_EQ(visible, (std::vector<uint8_t>{0, 1, 1, 1}));
+}
+
+} // namespace tests
+} // namespace iglu
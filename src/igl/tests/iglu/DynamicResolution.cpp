@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/dynamic_resolution/DynamicResolution.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using iglu::dynamicresolution::DynamicResolution;
+using iglu::dynamicresolution::DynamicResolutionConfig;
+
+//
+// DynamicResolutionTest
+//
+// Test fixture for all the tests in this file. Takes care of common
+// initialization and allocating of common resources.
+//
+class DynamicResolutionTest : public ::testing::Test {
+ public:
+  DynamicResolutionTest() = default;
+  ~DynamicResolutionTest() override = default;
+
+  //
+  // SetUp()
+  // Create device, commandQueue
+  //
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    config_.gpuBudgetMs = 10.0;
+    config_.minScale = 0.5f;
+    config_.maxScale = 1.0f;
+    config_.maxScaleStep = 0.1f;
+    config_.increaseThreshold = 0.8f;
+  }
+
+  void TearDown() override {}
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  DynamicResolutionConfig config_;
+};
+
+//
+// Scale is unchanged within the budget
+//
+TEST_F(DynamicResolutionTest, ComputeScaleWithinBudget) {
+  ASSERT_EQ(DynamicResolution::computeScale(0.75f, 9.0, config_), 0.75f);
+  ASSERT_EQ(DynamicResolution::computeScale(0.75f, 10.0, config_), 0.75f);
+  ASSERT_EQ(DynamicResolution::computeScale(0.75f, 8.0, config_), 0.75f);
+  // not measured
+  ASSERT_EQ(DynamicResolution::computeScale(0.75f, 0.0, config_), 0.75f);
+}
+
+//
+// Scale goes down over the budget and up well below it, by at most maxScaleStep
+//
+TEST_F(DynamicResolutionTest, ComputeScaleOutsideBudget) {
+  // 4x the pixels of the target time of 9 ms: half the scale, limited by the step
+  ASSERT_FLOAT_EQ(DynamicResolution::computeScale(0.8f, 36.0, config_), 0.7f);
+  // slightly over the budget: sqrt(9 / 10.24) = 0.9375
+  ASSERT_FLOAT_EQ(DynamicResolution::computeScale(0.8f, 10.24, config_), 0.75f);
+  // slightly below the threshold: sqrt(9 / 7.84) = 1.0714
+  ASSERT_FLOAT_EQ(DynamicResolution::computeScale(0.7f, 7.84, config_), 0.75f);
+  // far below the threshold, limited by the step
+  ASSERT_FLOAT_EQ(DynamicResolution::computeScale(0.7f, 1.0, config_), 0.8f);
+}
+
+//
+// Scale stays within [minScale, maxScale]
+//
+TEST_F(DynamicResolutionTest, ComputeScaleClamped) {
+  ASSERT_EQ(DynamicResolution::computeScale(0.55f, 100.0, config_), config_.minScale);
+  ASSERT_EQ(DynamicResolution::computeScale(0.95f, 1.0, config_), config_.maxScale);
+}
+
+//
+// The target covers the output at maxScale and the scene is rendered into its top-left region
+//
+TEST_F(DynamicResolutionTest, RendersIntoTarget) {
+  config_.maxScale = 0.5f;
+  config_.minScale = 0.25f;
+  DynamicResolution controller(*iglDev_, config_);
+  ASSERT_EQ(controller.getScale(), config_.maxScale);
+
+  const CommandBufferDesc cbDesc;
+  auto cmdBuffer = cmdQueue_->createCommandBuffer(cbDesc, nullptr);
+  ASSERT_TRUE(cmdBuffer != nullptr);
+
+  controller.beginScene(*cmdBuffer, Dimensions(64, 32, 1));
+  const auto& framebuffer = controller.getFramebuffer();
+  ASSERT_TRUE(framebuffer != nullptr);
+  const auto dimensions = framebuffer->getColorAttachment(0)->getDimensions();
+  ASSERT_EQ(dimensions.width, 32);
+  ASSERT_EQ(dimensions.height, 16);
+
+  const auto renderSize = controller.getRenderSize();
+  ASSERT_EQ(renderSize.width, 32);
+  ASSERT_EQ(renderSize.height, 16);
+  const ScissorRect scissor = controller.getScissorRect();
+  ASSERT_EQ(scissor.width, 32);
+  ASSERT_EQ(scissor.height, 16);
+
+  RenderPassDesc renderPass;
+  renderPass.colorAttachments.resize(1);
+  renderPass.colorAttachments[0].loadAction = LoadAction::Clear;
+  renderPass.colorAttachments[0].storeAction = StoreAction::Store;
+  renderPass.depthAttachment.loadAction = LoadAction::Clear;
+  auto encoder = cmdBuffer->createRenderCommandEncoder(renderPass, framebuffer);
+  ASSERT_TRUE(encoder != nullptr);
+  encoder->bindViewport(controller.getViewport());
+  encoder->bindScissorRect(scissor);
+  encoder->endEncoding();
+
+  controller.endScene(*cmdBuffer);
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  // the same output size keeps the target
+  cmdBuffer = cmdQueue_->createCommandBuffer(cbDesc, nullptr);
+  controller.beginScene(*cmdBuffer, Dimensions(64, 32, 1));
+  ASSERT_EQ(controller.getFramebuffer(), framebuffer);
+  controller.endScene(*cmdBuffer);
+
+  // a new output size recreates it
+  controller.beginScene(*cmdBuffer, Dimensions(16, 16, 1));
+  ASSERT_NE(controller.getFramebuffer(), framebuffer);
+  ASSERT_EQ(controller.getFramebuffer()->getColorAttachment(0)->getDimensions().width, 8);
+  controller.endScene(*cmdBuffer);
+  cmdQueue_->submit(*cmdBuffer);
+}
+
+} // namespace tests
+} // namespace igl
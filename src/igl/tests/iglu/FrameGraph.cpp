@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/frame_graph/FrameGraph.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+namespace {
+constexpr uint32_t kTexSize = 4;
+
+TextureDesc getTransientDesc() {
+  return TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                            kTexSize,
+                            kTexSize,
+                            TextureDesc::TextureUsageBits::Sampled |
+                                TextureDesc::TextureUsageBits::Attachment);
+}
+} // namespace
+
+//
+// FrameGraphTest
+//
+// Test fixture for all the tests in this file. Takes care of common
+// initialization and allocating of common resources.
+//
+class FrameGraphTest : public ::testing::Test {
+ public:
+  FrameGraphTest() = default;
+  ~FrameGraphTest() override = default;
+
+  //
+  // SetUp()
+  // Create device, commandQueue and an output texture
+  //
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    Result result;
+    output_ = iglDev_->createTexture(getTransientDesc(), &result);
+    ASSERT_TRUE(result.isOk()) << result.message;
+    ASSERT_TRUE(output_ != nullptr);
+  }
+
+  void TearDown() override {}
+
+  // A chain of passes: A writes T1, B reads T1 and writes T2, C reads T2 and writes T3, D reads
+  // T3 and writes the output. Records the textures seen by each pass in `outTextures`.
+  void addChain(iglu::framegraph::FrameGraph& graph,
+                std::vector<std::shared_ptr<ITexture>>& outTextures) {
+    const auto outputHandle = graph.importTexture("output", output_);
+    iglu::framegraph::TextureHandle previous;
+    for (const char* name : {"T1", "T2", "T3"}) {
+      // the execute function is created before the setup function assigns the handle
+      auto current = std::make_shared<iglu::framegraph::TextureHandle>();
+      graph.addPass(
+          name,
+          [&](iglu::framegraph::PassBuilder& builder) {
+            if (previous.isValid()) {
+              builder.read(previous);
+            }
+            *current = builder.create(name, getTransientDesc());
+          },
+          [&outTextures, current](const iglu::framegraph::PassResources& resources,
+                                  ICommandBuffer& /*commandBuffer*/) {
+            outTextures.push_back(resources.getTexture(*current));
+          });
+      previous = *current;
+    }
+    graph.addPass(
+        "Output",
+        [&](iglu::framegraph::PassBuilder& builder) {
+          builder.read(previous);
+          builder.write(outputHandle);
+        },
+        nullptr);
+  }
+
+  // Member variables
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  std::shared_ptr<ITexture> output_;
+};
+
+//
+// CullUnusedPasses Test
+//
+// Passes whose results are not used by the output are not executed
+//
+TEST_F(FrameGraphTest, CullUnusedPasses) {
+  iglu::framegraph::FrameGraph graph(*iglDev_);
+  std::vector<std::shared_ptr<ITexture>> textures;
+  addChain(graph, textures);
+
+  bool isUnusedExecuted = false;
+  graph.addPass(
+      "Unused",
+      [](iglu::framegraph::PassBuilder& builder) { builder.create("unused", getTransientDesc()); },
+      [&isUnusedExecuted](const iglu::framegraph::PassResources& /*resources*/,
+                          ICommandBuffer& /*commandBuffer*/) { isUnusedExecuted = true; });
+
+  bool isSideEffectExecuted = false;
+  graph.addPass(
+      "SideEffect",
+      [](iglu::framegraph::PassBuilder& builder) { builder.setSideEffect(); },
+      [&isSideEffectExecuted](const iglu::framegraph::PassResources& /*resources*/,
+                              ICommandBuffer& /*commandBuffer*/) { isSideEffectExecuted = true; });
+
+  const auto result = graph.execute(*cmdQueue_);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(graph.getNumPasses(), 6u);
+  ASSERT_EQ(graph.getNumCulledPasses(), 1u);
+  ASSERT_FALSE(isUnusedExecuted);
+  ASSERT_TRUE(isSideEffectExecuted);
+  ASSERT_EQ(textures.size(), 3u);
+}
+
+//
+// AliasTransientTextures Test
+//
+// Transient textures with disjoint lifetimes share one texture
+//
+TEST_F(FrameGraphTest, AliasTransientTextures) {
+  iglu::framegraph::FrameGraph graph(*iglDev_);
+  std::vector<std::shared_ptr<ITexture>> textures;
+  addChain(graph, textures);
+
+  const auto result = graph.execute(*cmdQueue_);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(textures.size(), 3u);
+  ASSERT_NE(textures[0], nullptr);
+  // T1 is dead once T2 is written, so T3 reuses its texture
+  ASSERT_NE(textures[0], textures[1]);
+  ASSERT_EQ(textures[0], textures[2]);
+  ASSERT_EQ(graph.getNumPooledTextures(), 2u);
+}
+
+//
+// ReuseAcrossFrames Test
+//
+// Pooled textures are reused by the next frame
+//
+TEST_F(FrameGraphTest, ReuseAcrossFrames) {
+  iglu::framegraph::FrameGraph graph(*iglDev_);
+  std::vector<std::shared_ptr<ITexture>> frame0;
+  addChain(graph, frame0);
+  auto result = graph.execute(*cmdQueue_);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  graph.reset();
+  ASSERT_EQ(graph.getNumPasses(), 0u);
+
+  std::vector<std::shared_ptr<ITexture>> frame1;
+  addChain(graph, frame1);
+  result = graph.execute(*cmdQueue_);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(graph.getNumPooledTextures(), 2u);
+  ASSERT_EQ(frame0, frame1);
+}
+
+} // namespace tests
+} // namespace igl
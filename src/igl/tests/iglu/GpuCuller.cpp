@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/SimdMatrices.h"
+#include "../util/TestDevice.h"
+#include <IGLU/gpu_culling/GpuCuller.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using namespace iglu::simdtypes;
+
+class GpuCullerTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+//
+// InvalidArguments Test
+//
+TEST_F(GpuCullerTest, InvalidArguments) {
+  if (!iglDev_->hasFeature(DeviceFeatures::Compute) ||
+      !iglDev_->hasFeature(DeviceFeatures::DrawIndexedIndirect)) {
+    GTEST_SKIP() << "Compute or indirect draws are not supported";
+  }
+  Result result;
+  const iglu::gpuculling::GpuCuller empty(*iglDev_, {}, {}, &result);
+  ASSERT_EQ(result.code, Result::Code::ArgumentInvalid);
+
+  const iglu::gpuculling::GpuCuller invalidMesh(
+      *iglDev_, {{6, 0, 0}}, {{float4{0.0f, 0.0f, 0.0f, 1.0f}, 1}}, &result);
+  ASSERT_EQ(result.code, Result::Code::ArgumentOutOfRange);
+}
+
+//
+// Frustum Test
+//
+// Instances outside of the frustum are not counted in the draw commands of their mesh
+//
+TEST_F(GpuCullerTest, Frustum) {
+  if (!iglDev_->hasFeature(DeviceFeatures::Compute) ||
+      !iglDev_->hasFeature(DeviceFeatures::DrawIndexedIndirect)) {
+    GTEST_SKIP() << "Compute or indirect draws are not supported";
+  }
+  if (iglDev_->hasFeature(DeviceFeatures::BufferRing)) {
+    GTEST_SKIP() << "Ring buffers cannot be mapped";
+  }
+
+  Result result;
+  iglu::gpuculling::GpuCuller culler(*iglDev_,
+                                     {{6, 0, 0}, {3, 6, 4}},
+                                     {
+                                         {float4{0.0f, 0.0f, 0.0f, 0.5f}, 0},
+                                         {float4{5.0f, 0.0f, 0.0f, 0.5f}, 1}, // culled
+                                         {float4{0.5f, 0.5f, 0.0f, 0.5f}, 1},
+                                     },
+                                     &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(culler.getNumMeshes(), 2u);
+
+  auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  culler.cull(*cmdBuffer, util::makeOrtho(), true);
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  auto& indirectBuffer = culler.getIndirectBuffer();
+  const auto* commands = static_cast<const uint32_t*>(
+      indirectBuffer->map(BufferRange(2 * IGL_DRAW_ELEMENTS_INDIRECT_COMMAND_SIZE, 0), &result));
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_NE(commands, nullptr);
+  // mesh 0: count, instanceCount, firstIndex, baseVertex, baseInstance
+  ASSERT_EQ(commands[0], 6u);
+  ASSERT_EQ(commands[1], 1u);
+  ASSERT_EQ(commands[4], 0u);
+  // mesh 1
+  ASSERT_EQ(commands[5], 3u);
+  ASSERT_EQ(commands[6], 1u);
+  ASSERT_EQ(commands[7], 6u);
+  ASSERT_EQ(commands[8], 4u);
+  ASSERT_EQ(commands[9], 1u);
+  indirectBuffer->unmap();
+
+  auto& visibleBuffer = culler.getVisibleInstanceBuffer();
+  const auto* visible = static_cast<const uint32_t*>(
+      visibleBuffer->map(BufferRange(sizeof(uint32_t) * 2, 0), &result));
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_NE(visible, nullptr);
+  ASSERT_EQ(visible[0], 0u);
+  ASSERT_EQ(visible[1], 2u);
+  visibleBuffer->unmap();
+}
+
+} // namespace tests
+} // namespace igl
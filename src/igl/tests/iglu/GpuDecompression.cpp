@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/gpu_decompression/GpuDecompression.h>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace iglu {
+namespace tests {
+
+using namespace gpudecompression;
+
+namespace {
+
+// repetitive data like vertices and indices, with a noisy part which does not compress
+std::vector<uint8_t> makeData(size_t length) {
+  std::vector<uint8_t> data(length);
+  uint32_t seed = 12345;
+  for (size_t i = 0; i != length; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    data[i] = i % 50000 < 40000 ? static_cast<uint8_t>((i / 12) % 7 + (i % 12)) : seed >> 24;
+  }
+  return data;
+}
+
+} // namespace
+
+class GpuDecompressorTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    igl::setDebugBreakEnabled(false);
+    igl::tests::util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+ protected:
+  std::shared_ptr<igl::IDevice> iglDev_;
+  std::shared_ptr<igl::ICommandQueue> cmdQueue_;
+};
+
+//
+// RoundTrip Test
+//
+// Payloads of various sizes and chunk sizes decompress to the original bytes
+//
+TEST(GpuDecompressionTest, RoundTrip) {
+  for (const size_t length : {0, 1, 13, 17, 4096, 100003, 300000}) {
+    const std::vector<uint8_t> data = makeData(length);
+    for (const uint32_t chunkSize : {4u, 1024u, kDefaultChunkSize, kMaxChunkSize}) {
+      const std::vector<uint8_t> payload = compress(data.data(), data.size(), chunkSize);
+      ASSERT_FALSE(payload.empty());
+
+      CompressedInfo info;
+      ASSERT_TRUE(readCompressedInfo(payload.data(), payload.size(), info).isOk());
+      ASSERT_EQ(info.uncompressedSize, length);
+      ASSERT_EQ(info.chunkSize, chunkSize);
+      ASSERT_EQ(info.numChunks, (length + chunkSize - 1) / chunkSize);
+
+      std::vector<uint8_t> decompressed;
+      ASSERT_TRUE(decompress(payload.data(), payload.size(), decompressed).isOk());
+      ASSERT_EQ(decompressed, data);
+    }
+  }
+
+  // the repetitive bytes compress well, and the noise is stored without growing much
+  const std::vector<uint8_t> data = makeData(300000);
+  ASSERT_LT(compress(data.data(), data.size()).size(), data.size() / 2);
+  std::vector<uint8_t> noise(100000);
+  uint32_t seed = 1;
+  for (uint8_t& value : noise) {
+    seed = seed * 1664525u + 1013904223u;
+    value = seed >> 24;
+  }
+  ASSERT_LT(compress(noise.data(), noise.size()).size(), noise.size() + 100);
+}
+
+//
+// LongRuns Test
+//
+// Runs use matches overlapping the bytes they copy, and lengths with extension bytes
+//
+TEST(GpuDecompressionTest, LongRuns) {
+  std::vector<uint8_t> data(kMaxChunkSize, 7);
+  std::memcpy(data.data() + 1000, "abcabcabcabcabcabcabcabcabcabc", 30);
+  const std::vector<uint8_t> payload = compress(data.data(), data.size(), kMaxChunkSize);
+  ASSERT_LT(payload.size(), 1000u);
+  std::vector<uint8_t> decompressed;
+  ASSERT_TRUE(decompress(payload.data(), payload.size(), decompressed).isOk());
+  ASSERT_EQ(decompressed, data);
+}
+
+//
+// InvalidPayloads Test
+//
+TEST(GpuDecompressionTest, InvalidPayloads) {
+  const std::vector<uint8_t> data = makeData(10000);
+  const std::vector<uint8_t> payload = compress(data.data(), data.size(), 1024);
+  std::vector<uint8_t> decompressed;
+  CompressedInfo info;
+
+  ASSERT_TRUE(compress(data.data(), data.size(), 1022).empty());
+  ASSERT_TRUE(compress(data.data(), data.size(), kMaxChunkSize + 4).empty());
+
+  // truncated chunk table and data
+  ASSERT_FALSE(readCompressedInfo(payload.data(), 30, info).isOk());
+  ASSERT_FALSE(readCompressedInfo(payload.data(), payload.size() - 1, info).isOk());
+  ASSERT_FALSE(decompress(payload.data(), payload.size() - 1, decompressed).isOk());
+
+  std::vector<uint8_t> corrupted = payload;
+  corrupted[0] ^= 1;
+  ASSERT_FALSE(readCompressedInfo(corrupted.data(), corrupted.size(), info).isOk());
+
+  // a chunk whose first match goes back before the chunk
+  corrupted = payload;
+  uint32_t offset = 0;
+  std::memcpy(&offset, corrupted.data() + 20, sizeof(offset));
+  corrupted[offset] = 0x0f;
+  corrupted[offset + 1] = 0xff;
+  corrupted[offset + 2] = 0xff;
+  ASSERT_TRUE(readCompressedInfo(corrupted.data(), corrupted.size(), info).isOk());
+  ASSERT_FALSE(decompress(corrupted.data(), corrupted.size(), decompressed).isOk());
+  ASSERT_TRUE(decompressed.empty());
+}
+
+//
+// DecompressToBuffer Test
+//
+// The compute shader decodes the chunks into the destination buffer like decompress(), and
+// leaves the bytes before the destination offset untouched
+//
+TEST_F(GpuDecompressorTest, DecompressToBuffer) {
+  if (!iglDev_->hasFeature(igl::DeviceFeatures::Compute)) {
+    GTEST_SKIP() << "Compute is not supported";
+  }
+
+  igl::Result result;
+  GpuDecompressor decompressor(*iglDev_, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  // noisy chunks are stored as is and the others are LZ4 blocks
+  const std::vector<uint8_t> data = makeData(100003);
+  const std::vector<uint8_t> payload = compress(data.data(), data.size(), 1024);
+  std::vector<uint8_t> expected;
+  ASSERT_TRUE(decompress(payload.data(), payload.size(), expected).isOk());
+  ASSERT_EQ(expected, data);
+
+  constexpr size_t kOffset = 8;
+  const size_t length = kOffset + (data.size() + 3) / 4 * 4;
+  const std::vector<uint8_t> initialBytes(length, 0xcd);
+  const std::shared_ptr<igl::IBuffer> destination =
+      iglDev_->createBuffer(igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Storage,
+                                            initialBytes.data(),
+                                            length,
+                                            igl::ResourceStorage::Shared),
+                            &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  decompressor.decompress(
+      *cmdBuffer, payload.data(), payload.size(), destination, kOffset, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  const auto* bytes =
+      static_cast<const uint8_t*>(destination->map(igl::BufferRange(length, 0), &result));
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_NE(bytes, nullptr);
+  for (size_t i = 0; i != kOffset; i++) {
+    ASSERT_EQ(bytes[i], 0xcd) << i;
+  }
+  ASSERT_EQ(std::memcmp(bytes + kOffset, expected.data(), expected.size()), 0);
+  destination->unmap();
+}
+
+} // namespace tests
+} // namespace iglu
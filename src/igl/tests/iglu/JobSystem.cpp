@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/job_system/JobSystem.h>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iglu {
+namespace tests {
+
+using jobsystem::CoreType;
+using jobsystem::JobCounter;
+using jobsystem::JobPriority;
+using jobsystem::JobSystem;
+
+//
+// RunAndWait Test
+//
+// All the jobs attached to a counter have run when wait() returns, and the destructor drains the
+// jobs without a counter
+//
+TEST(JobSystemTest, RunAndWait) {
+  std::atomic<uint32_t> counted = 0;
+  std::atomic<uint32_t> uncounted = 0;
+  {
+    JobSystem jobSystem({4});
+    ASSERT_EQ(jobSystem.getNumThreads(), 4u);
+
+    JobCounter counter;
+    ASSERT_TRUE(counter.isDone());
+    for (uint32_t i = 0; i != 1000; i++) {
+      const JobPriority priority = static_cast<JobPriority>(i % jobsystem::kNumJobPriorities);
+      jobSystem.run([&counted]() { counted++; }, {"counted", priority, &counter});
+      jobSystem.run([&uncounted]() { uncounted++; });
+    }
+    jobSystem.wait(counter);
+    ASSERT_TRUE(counter.isDone());
+    ASSERT_EQ(counted.load(), 1000u);
+  }
+  ASSERT_EQ(uncounted.load(), 1000u);
+}
+
+//
+// NestedJobs Test
+//
+// Jobs waiting for the jobs they spawn help running them instead of blocking their worker
+//
+TEST(JobSystemTest, NestedJobs) {
+  JobSystem jobSystem({2});
+
+  std::atomic<uint32_t> numLeaves = 0;
+  JobCounter root;
+  for (uint32_t i = 0; i != 8; i++) {
+    jobSystem.run(
+        [&jobSystem, &numLeaves]() {
+          JobCounter children;
+          for (uint32_t j = 0; j != 8; j++) {
+            jobSystem.run(
+                [&jobSystem, &numLeaves]() {
+                  JobCounter leaves;
+                  for (uint32_t k = 0; k != 8; k++) {
+                    jobSystem.run([&numLeaves]() { numLeaves++; },
+                                  {"leaf", JobPriority::Low, &leaves});
+                  }
+                  jobSystem.wait(leaves);
+                },
+                {"child", JobPriority::Normal, &children});
+          }
+          jobSystem.wait(children);
+        },
+        {"root", JobPriority::High, &root});
+  }
+  jobSystem.wait(root);
+  ASSERT_EQ(numLeaves.load(), 8u * 8u * 8u);
+}
+
+//
+// ParallelFor Test
+//
+TEST(JobSystemTest, ParallelFor) {
+  JobSystem jobSystem({3});
+
+  std::vector<std::atomic<uint32_t>> visited(1000);
+  jobSystem.parallelFor(visited.size(), [&visited](size_t i) { visited[i]++; });
+  for (const auto& v : visited) {
+    ASSERT_EQ(v.load(), 1u);
+  }
+
+  // fewer jobs than threads, none at all, and from inside a job
+  std::atomic<uint32_t> counter = 0;
+  jobSystem.parallelFor(2, [&counter](size_t) { counter++; });
+  ASSERT_EQ(counter.load(), 2u);
+  jobSystem.parallelFor(0, [&counter](size_t) { counter++; });
+  ASSERT_EQ(counter.load(), 2u);
+
+  JobCounter outer;
+  jobSystem.run(
+      [&jobSystem, &counter]() {
+        jobSystem.parallelFor(
+            100, [&counter](size_t) { counter++; }, {"inner", JobPriority::High});
+      },
+      {"outer", JobPriority::Normal, &outer});
+  jobSystem.wait(outer);
+  ASSERT_EQ(counter.load(), 102u);
+}
+
+//
+// Priorities Test
+//
+// Pending jobs of a higher priority run first
+//
+TEST(JobSystemTest, Priorities) {
+  JobSystem jobSystem({1, "Priorities", false});
+
+  std::atomic<bool> started = false;
+  std::atomic<bool> release = false;
+  JobCounter counter;
+  jobSystem.run(
+      [&started, &release]() {
+        started = true;
+        while (!release) {
+          std::this_thread::yield();
+        }
+      },
+      {"blocker", JobPriority::Normal, &counter});
+  while (!started) {
+    std::this_thread::yield();
+  }
+
+  std::mutex mutex;
+  std::vector<JobPriority> order;
+  for (const JobPriority priority : {JobPriority::Low, JobPriority::High, JobPriority::Normal}) {
+    jobSystem.run(
+        [&mutex, &order, priority]() {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(priority);
+        },
+        {nullptr, priority, &counter});
+  }
+  release = true;
+  // wait() would run some of the jobs on this thread, in parallel with the worker
+  while (!counter.isDone()) {
+    std::this_thread::yield();
+  }
+
+  ASSERT_EQ(order,
+            std::vector<JobPriority>({JobPriority::High, JobPriority::Normal, JobPriority::Low}));
+}
+
+//
+// CoreTypes Test
+//
+// The first workers are placed on the performance cores, if the CPU has distinct ones
+//
+TEST(JobSystemTest, CoreTypes) {
+  JobSystem jobSystem({8});
+  const uint32_t numPerformanceThreads = jobSystem.getNumPerformanceThreads();
+  ASSERT_LE(numPerformanceThreads, jobSystem.getNumThreads());
+  for (uint32_t i = 0; i != jobSystem.getNumThreads(); i++) {
+    const CoreType expected = numPerformanceThreads == 0 ? CoreType::Any
+                              : i < numPerformanceThreads ? CoreType::Performance
+                                                          : CoreType::Efficiency;
+    ASSERT_EQ(jobSystem.getCoreType(i), expected);
+  }
+
+  JobSystem unplaced({4, "Unplaced", false});
+  ASSERT_EQ(unplaced.getNumPerformanceThreads(), 0u);
+  for (uint32_t i = 0; i != unplaced.getNumThreads(); i++) {
+    ASSERT_EQ(unplaced.getCoreType(i), CoreType::Any);
+  }
+}
+
+} // namespace tests
+} // namespace iglu
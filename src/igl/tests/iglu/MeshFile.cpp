@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/mesh_file/MeshFile.h>
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+
+namespace iglu {
+namespace tests {
+
+namespace {
+
+std::string getTempPath(const char* name) {
+  return ::testing::TempDir() + name;
+}
+
+} // namespace
+
+//
+// RoundTrip Test
+//
+// Sections are aligned and read back from the mapped file
+//
+TEST(MeshFileTest, RoundTrip) {
+  const std::vector<float> vertices = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+  const std::vector<uint32_t> indices = {0, 1, 1};
+  meshlets::MeshletMesh mesh;
+  mesh.meshlets = {{0, 0, 2, 1}};
+  mesh.bounds.resize(1);
+  mesh.bounds[0].sphere = simdtypes::float4{1.0f, 2.0f, 3.0f, 4.0f};
+  mesh.vertices = {0, 1};
+  mesh.triangles = {0, 1, 1, 0};
+
+  const std::string path = getTempPath("MeshFileTest_RoundTrip.bin");
+  meshfile::MeshFileWriter writer;
+  writer.addSection(meshfile::SectionType::Vertices, vertices.data(), 24, sizeof(float) * 3);
+  writer.addSection(meshfile::SectionType::Indices, indices);
+  writer.addMeshlets(mesh);
+  igl::Result result;
+  ASSERT_TRUE(writer.write(path, &result)) << result.message;
+
+  {
+    auto file = meshfile::MeshFile::open(path, &result);
+    ASSERT_TRUE(result.isOk()) << result.message;
+    ASSERT_TRUE(file);
+    ASSERT_EQ(file->getSections().size(), 6u);
+
+    const meshfile::Section* section = file->getSection(meshfile::SectionType::Vertices);
+    ASSERT_NE(section, nullptr);
+    ASSERT_EQ(section->count(), 2u);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(section->data) % meshfile::kSectionAlignment, 0u);
+    ASSERT_EQ(std::memcmp(section->data, vertices.data(), section->size), 0);
+
+    section = file->getSection(meshfile::SectionType::Indices);
+    ASSERT_NE(section, nullptr);
+    ASSERT_EQ(section->count(), 3u);
+    ASSERT_EQ(static_cast<const uint32_t*>(section->data)[1], 1u);
+    ASSERT_EQ(file->getSection(meshfile::SectionType::Materials), nullptr);
+
+    meshlets::MeshletMesh meshlets;
+    ASSERT_TRUE(file->readMeshlets(meshlets));
+    ASSERT_EQ(meshlets.meshlets.size(), 1u);
+    ASSERT_EQ(meshlets.meshlets[0].triangleCount, 1u);
+    ASSERT_FLOAT_EQ(meshlets.bounds[0].sphere[3], 4.0f);
+    ASSERT_EQ(meshlets.vertices, mesh.vertices);
+    ASSERT_EQ(meshlets.triangles, mesh.triangles);
+  }
+  std::remove(path.c_str());
+}
+
+//
+// Invalid Test
+//
+// Missing, foreign and truncated files are rejected
+//
+TEST(MeshFileTest, Invalid) {
+  igl::Result result;
+  ASSERT_FALSE(meshfile::MeshFile::open(getTempPath("MeshFileTest_Missing.bin"), &result));
+  ASSERT_FALSE(result.isOk());
+
+  const std::string path = getTempPath("MeshFileTest_Invalid.bin");
+  const std::vector<uint32_t> indices(100, 1);
+  meshfile::MeshFileWriter writer;
+  writer.addSection(meshfile::SectionType::Indices, indices);
+  ASSERT_TRUE(writer.write(path, &result));
+
+  // truncate the file
+  std::vector<char> data(1024);
+  FILE* file = fopen(path.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  data.resize(fread(data.data(), 1, data.size(), file));
+  fclose(file);
+  file = fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  fwrite(data.data(), 1, data.size() - 1, file);
+  fclose(file);
+  ASSERT_FALSE(meshfile::MeshFile::open(path, &result));
+  ASSERT_EQ(result.code, igl::Result::Code::ArgumentInvalid);
+
+  // not a mesh file
+  data[0] = 'X';
+  file = fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  fwrite(data.data(), 1, data.size(), file);
+  fclose(file);
+  ASSERT_FALSE(meshfile::MeshFile::open(path, &result));
+  ASSERT_EQ(result.code, igl::Result::Code::ArgumentInvalid);
+  std::remove(path.c_str());
+}
+
+} // namespace tests
+} // namespace iglu
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/meshlets/Meshlets.h>
+#include <algorithm>
+#include <array>
+#include <gtest/gtest.h>
+#include <set>
+
+namespace iglu {
+namespace tests {
+
+namespace {
+
+// A grid of 'size' x 'size' quads in the XY plane
+void makeGrid(uint32_t size, std::vector<float>& outPositions, std::vector<uint32_t>& outIndices) {
+  for (uint32_t y = 0; y <= size; y++) {
+    for (uint32_t x = 0; x <= size; x++) {
+      outPositions.insert(outPositions.end(), {float(x), float(y), 0.0f});
+    }
+  }
+  for (uint32_t y = 0; y != size; y++) {
+    for (uint32_t x = 0; x != size; x++) {
+      const uint32_t i = y * (size + 1) + x;
+      outIndices.insert(outIndices.end(),
+                        {i, i + 1, i + size + 1, i + 1, i + size + 2, i + size + 1});
+    }
+  }
+}
+
+std::multiset<std::array<uint32_t, 3>> getTriangles(const std::vector<uint32_t>& indices) {
+  std::multiset<std::array<uint32_t, 3>> triangles;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    // meshlets keep the winding but may rotate the vertices of a triangle
+    std::array<uint32_t, 3> t = {indices[i], indices[i + 1], indices[i + 2]};
+    std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+    triangles.insert(t);
+  }
+  return triangles;
+}
+
+} // namespace
+
+//
+// Build Test
+//
+// The meshlets respect the limits and cover all triangles of the mesh
+//
+TEST(MeshletsTest, Build) {
+  std::vector<float> positions;
+  std::vector<uint32_t> indices;
+  makeGrid(32, positions, indices);
+
+  meshlets::BuildOptions options;
+  options.maxVertices = 64;
+  options.maxTriangles = 64;
+  const meshlets::MeshletMesh mesh = meshlets::buildMeshlets(indices.data(),
+                                                             indices.size(),
+                                                             positions.data(),
+                                                             positions.size() / 3,
+                                                             sizeof(float) * 3,
+                                                             options);
+  ASSERT_GE(mesh.meshlets.size(), indices.size() / 3 / options.maxTriangles);
+  ASSERT_EQ(mesh.bounds.size(), mesh.meshlets.size());
+  for (size_t i = 0; i != mesh.meshlets.size(); i++) {
+    ASSERT_LE(mesh.meshlets[i].vertexCount, options.maxVertices);
+    ASSERT_LE(mesh.meshlets[i].triangleCount, options.maxTriangles);
+    ASSERT_GT(mesh.bounds[i].sphere[3], 0.0f);
+  }
+  ASSERT_EQ(getTriangles(meshlets::buildIndexBuffer(mesh)), getTriangles(indices));
+}
+
+//
+// Serialization Test
+//
+TEST(MeshletsTest, Serialization) {
+  meshlets::MeshletMesh mesh;
+  mesh.meshlets = {{0, 0, 3, 1}, {3, 4, 4, 2}};
+  mesh.bounds.resize(2);
+  mesh.bounds[1].sphere = simdtypes::float4{1.0f, 2.0f, 3.0f, 4.0f};
+  mesh.vertices = {0, 1, 2, 2, 1, 3, 4};
+  mesh.triangles = {0, 1, 2, 0, 0, 1, 2, 1, 3, 2, 0, 0};
+  ASSERT_EQ(meshlets::buildIndexBuffer(mesh), (std::vector<uint32_t>{0, 1, 2, 2, 1, 3, 1, 4, 3}));
+
+  const std::vector<uint8_t> data = meshlets::serialize(mesh);
+  meshlets::MeshletMesh result;
+  ASSERT_TRUE(meshlets::deserialize(data.data(), data.size(), result));
+  ASSERT_EQ(result.meshlets.size(), 2u);
+  ASSERT_EQ(result.meshlets[1].triangleOffset, 4u);
+  ASSERT_EQ(result.meshlets[1].triangleCount, 2u);
+  ASSERT_FLOAT_EQ(result.bounds[1].sphere[3], 4.0f);
+  ASSERT_EQ(result.vertices, mesh.vertices);
+  ASSERT_EQ(result.triangles, mesh.triangles);
+
+  // truncated data
+  ASSERT_FALSE(meshlets::deserialize(data.data(), data.size() - 1, result));
+  ASSERT_TRUE(result.meshlets.empty());
+  // unknown version
+  std::vector<uint8_t> newer = data;
+  newer[4]++;
+  ASSERT_FALSE(meshlets::deserialize(newer.data(), newer.size(), result));
+  // triangle referencing a vertex outside of its meshlet
+  mesh.triangles[0] = 3;
+  const std::vector<uint8_t> invalid = meshlets::serialize(mesh);
+  ASSERT_FALSE(meshlets::deserialize(invalid.data(), invalid.size(), result));
+}
+
+} // namespace tests
+} // namespace iglu
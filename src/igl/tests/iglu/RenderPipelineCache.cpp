@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/simple_renderer/RenderPipelineCache.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+//
+// RenderPipelineCacheTest
+//
+// Test fixture for all the tests in this file. Takes care of common
+// initialization and allocating of common resources.
+//
+class RenderPipelineCacheTest : public ::testing::Test {
+ public:
+  RenderPipelineCacheTest() = default;
+  ~RenderPipelineCacheTest() override = default;
+
+  //
+  // SetUp()
+  // Create device, commandQueue and a render pipeline descriptor
+  //
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    std::unique_ptr<IShaderStages> stages;
+    util::createSimpleShaderStages(iglDev_, stages);
+    ASSERT_TRUE(stages != nullptr);
+
+    renderPipelineDesc_.shaderStages = std::move(stages);
+    renderPipelineDesc_.targetDesc.colorAttachments.resize(1);
+    renderPipelineDesc_.targetDesc.colorAttachments[0].textureFormat =
+        TextureFormat::RGBA_UNorm8;
+    renderPipelineDesc_.cullMode = CullMode::Disabled;
+  }
+
+  void TearDown() override {}
+
+  // Member variables
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  RenderPipelineDesc renderPipelineDesc_;
+};
+
+//
+// SharePipelines Test
+//
+// Equal descriptors share one pipeline state; different descriptors get their own
+//
+TEST_F(RenderPipelineCacheTest, SharePipelines) {
+  iglu::pipelinecache::RenderPipelineCache cache(*iglDev_);
+
+  Result result;
+  auto pipeline0 = cache.getRenderPipeline(renderPipelineDesc_, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_TRUE(pipeline0 != nullptr);
+
+  const RenderPipelineDesc copy = renderPipelineDesc_;
+  auto pipeline1 = cache.getRenderPipeline(copy, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(pipeline0, pipeline1);
+  ASSERT_EQ(cache.size(), 1u);
+
+  RenderPipelineDesc culled = renderPipelineDesc_;
+  culled.cullMode = CullMode::Back;
+  auto pipeline2 = cache.getRenderPipeline(culled, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_NE(pipeline0, pipeline2);
+  ASSERT_EQ(cache.size(), 2u);
+
+  cache.clear();
+  ASSERT_EQ(cache.size(), 0u);
+  ASSERT_NE(cache.getRenderPipeline(renderPipelineDesc_, &result), pipeline0);
+}
+
+} // namespace tests
+} // namespace igl
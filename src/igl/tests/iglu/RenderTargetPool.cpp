@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/render_target_pool/RenderTargetPool.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using iglu::rendertargetpool::RenderTargetPool;
+
+namespace {
+TextureDesc getTargetDesc(uint32_t size) {
+  return TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                            size,
+                            size,
+                            TextureDesc::TextureUsageBits::Sampled |
+                                TextureDesc::TextureUsageBits::Attachment);
+}
+} // namespace
+
+//
+// RenderTargetPoolTest
+//
+// Test fixture for all the tests in this file. Takes care of common
+// initialization and allocating of common resources.
+//
+class RenderTargetPoolTest : public ::testing::Test {
+ public:
+  RenderTargetPoolTest() = default;
+  ~RenderTargetPoolTest() override = default;
+
+  //
+  // SetUp()
+  // Create device, commandQueue
+  //
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+  void TearDown() override {}
+
+  // submits an empty command buffer standing for the work of a frame
+  std::shared_ptr<ICommandBuffer> submitFrame() {
+    Result ret;
+    auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &ret);
+    EXPECT_TRUE(ret.isOk());
+    cmdQueue_->submit(*cmdBuffer);
+    return cmdBuffer;
+  }
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+//
+// Textures are reused by the next frames once the frame which used them has completed
+//
+TEST_F(RenderTargetPoolTest, ReusesTexturesOfCompletedFrames) {
+  RenderTargetPool pool(*iglDev_);
+  Result ret;
+
+  auto target0 = pool.acquire(getTargetDesc(4), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  auto target1 = pool.acquire(getTargetDesc(4), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_NE(target0, target1);
+  auto cmdBuffer = submitFrame();
+  pool.endFrame(cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  for (int frame = 0; frame != 3; frame++) {
+    auto texture0 = pool.acquire(getTargetDesc(4), &ret);
+    auto texture1 = pool.acquire(getTargetDesc(4), &ret);
+    ASSERT_TRUE((texture0 == target0 && texture1 == target1) ||
+                (texture0 == target1 && texture1 == target0));
+    cmdBuffer = submitFrame();
+    pool.endFrame(cmdBuffer);
+    cmdBuffer->waitUntilCompleted();
+  }
+  ASSERT_EQ(pool.getNumAllocations(), 2);
+
+  // the debug name is not part of the key, the size is
+  TextureDesc named = getTargetDesc(4);
+  named.debugName = "named";
+  ASSERT_TRUE(pool.acquire(named, &ret) != nullptr);
+  ASSERT_EQ(pool.getNumAllocations(), 2);
+  ASSERT_TRUE(pool.acquire(getTargetDesc(8), &ret) != nullptr);
+  ASSERT_EQ(pool.getNumAllocations(), 3);
+  pool.endFrame(nullptr);
+}
+
+//
+// Textures released within a frame are reused by its later passes
+//
+TEST_F(RenderTargetPoolTest, ReusesReleasedTexturesWithinFrame) {
+  RenderTargetPool pool(*iglDev_);
+  Result ret;
+
+  auto target = pool.acquire(getTargetDesc(4), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  pool.release(target);
+  ASSERT_EQ(pool.acquire(getTargetDesc(4), &ret), target);
+  ASSERT_EQ(pool.getNumAllocations(), 1);
+
+  // the texture is still in use by the GPU until the frame completes
+  auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  pool.endFrame(cmdBuffer);
+  ASSERT_NE(pool.acquire(getTargetDesc(4), &ret), target);
+  ASSERT_EQ(pool.getNumAllocations(), 2);
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+  pool.endFrame(nullptr);
+}
+
+//
+// Textures which are not acquired for a while are released
+//
+TEST_F(RenderTargetPoolTest, ReleasesIdleTextures) {
+  RenderTargetPool pool(*iglDev_, 2);
+  Result ret;
+
+  ASSERT_TRUE(pool.acquire(getTargetDesc(4), &ret) != nullptr);
+  pool.endFrame(nullptr);
+  ASSERT_EQ(pool.getNumTextures(), 1);
+
+  for (int frame = 0; frame != 2; frame++) {
+    pool.endFrame(nullptr);
+  }
+  ASSERT_EQ(pool.getNumTextures(), 0);
+
+  ASSERT_TRUE(pool.acquire(getTargetDesc(4), &ret) != nullptr);
+  pool.endFrame(nullptr);
+  pool.clear();
+  ASSERT_EQ(pool.getNumTextures(), 0);
+}
+
+} // namespace tests
+} // namespace igl
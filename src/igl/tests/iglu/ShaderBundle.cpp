@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../data/ShaderData.h"
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/shader_bundle/ShaderBundle.h>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+using iglu::shaderbundle::ShaderBundle;
+using iglu::shaderbundle::ShaderBundleWriter;
+using iglu::shaderbundle::ShaderEntry;
+using iglu::shaderbundle::ShaderFormat;
+
+//
+// ShaderBundleTest
+//
+// Test fixture for all the tests in this file. Takes care of common
+// initialization and allocating of common resources.
+//
+class ShaderBundleTest : public ::testing::Test {
+ public:
+  ShaderBundleTest() = default;
+  ~ShaderBundleTest() override = default;
+
+  //
+  // SetUp()
+  // Create device, commandQueue
+  //
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+  void TearDown() override {}
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+//
+// Entries survive a round trip and identical data is stored once
+//
+TEST_F(ShaderBundleTest, RoundTrip) {
+  const uint32_t spirv[] = {0x07230203, 0x00010300, 0, 1, 0};
+  const char metallib[] = "not really a metal library";
+
+  ShaderBundleWriter writer;
+  writer.addShader("simple", ShaderFormat::SpirV, ShaderStage::Vertex, "main", spirv, 20);
+  writer.addShader("simple", ShaderFormat::MetalLib, ShaderStage::Vertex, "vs", metallib, 26);
+  writer.addShader("simple", ShaderFormat::MetalLib, ShaderStage::Fragment, "fs", metallib, 26);
+  writer.addShader("simple",
+                   ShaderFormat::Glsl,
+                   ShaderStage::Fragment,
+                   "main",
+                   data::shader::OGL_SIMPLE_FRAG_SHADER,
+                   strlen(data::shader::OGL_SIMPLE_FRAG_SHADER));
+  const std::vector<uint8_t> data = writer.serialize();
+
+  Result ret;
+  auto bundle = ShaderBundle::fromMemory(data.data(), data.size(), &ret);
+  ASSERT_TRUE(bundle != nullptr) << ret.message;
+  ASSERT_EQ(bundle->getEntries().size(), 4);
+
+  const ShaderEntry* vertex = bundle->find("simple", ShaderFormat::SpirV, ShaderStage::Vertex);
+  ASSERT_TRUE(vertex != nullptr);
+  ASSERT_EQ(vertex->entryPoint, "main");
+  ASSERT_EQ(vertex->size, sizeof(spirv));
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(vertex->data) % sizeof(uint32_t), 0);
+  ASSERT_EQ(memcmp(vertex->data, spirv, sizeof(spirv)), 0);
+  ASSERT_EQ(bundle->find("simple", ShaderFormat::SpirV, ShaderStage::Fragment), nullptr);
+  ASSERT_EQ(bundle->find("other", ShaderFormat::SpirV, ShaderStage::Vertex), nullptr);
+
+  const ShaderEntry* metalVertex =
+      bundle->find("simple", ShaderFormat::MetalLib, ShaderStage::Vertex);
+  const ShaderEntry* metalFragment =
+      bundle->find("simple", ShaderFormat::MetalLib, ShaderStage::Fragment);
+  ASSERT_TRUE(metalVertex != nullptr && metalFragment != nullptr);
+  ASSERT_EQ(metalVertex->data, metalFragment->data);
+  ASSERT_EQ(metalFragment->entryPoint, "fs");
+
+  // sources are null-terminated
+  const ShaderEntry* glsl = bundle->find("simple", ShaderFormat::Glsl, ShaderStage::Fragment);
+  ASSERT_TRUE(glsl != nullptr);
+  ASSERT_STREQ(static_cast<const char*>(glsl->data), data::shader::OGL_SIMPLE_FRAG_SHADER);
+}
+
+//
+// Data which was not written by ShaderBundleWriter is rejected
+//
+TEST_F(ShaderBundleTest, RejectsInvalidData) {
+  ShaderBundleWriter writer;
+  const uint32_t spirv[] = {0x07230203, 0x00010300, 0, 1, 0};
+  writer.addShader("simple", ShaderFormat::SpirV, ShaderStage::Compute, "main", spirv, 20);
+  std::vector<uint8_t> data = writer.serialize();
+
+  Result ret;
+  ASSERT_EQ(ShaderBundle::fromMemory(data.data(), data.size() - 16, &ret), nullptr);
+  ASSERT_EQ(ret.code, Result::Code::ArgumentInvalid);
+
+  std::vector<uint8_t> corrupted = data;
+  corrupted[0] = 'X';
+  ASSERT_EQ(ShaderBundle::fromMemory(corrupted.data(), corrupted.size(), &ret), nullptr);
+  ASSERT_EQ(ret.code, Result::Code::ArgumentInvalid);
+
+  ASSERT_TRUE(ShaderBundle::fromMemory(data.data(), data.size(), &ret) != nullptr);
+  ASSERT_TRUE(ret.isOk());
+}
+
+//
+// Render stages are created in the format of the device
+//
+TEST_F(ShaderBundleTest, CreateRenderStages) {
+  if (iglDev_->getBackendType() != BackendType::OpenGL) {
+    GTEST_SKIP() << "Only GLSL can be bundled without the offline compilers";
+  }
+  ShaderBundleWriter writer;
+  writer.addShader("simple",
+                   ShaderFormat::Glsl,
+                   ShaderStage::Vertex,
+                   "main",
+                   data::shader::OGL_SIMPLE_VERT_SHADER,
+                   strlen(data::shader::OGL_SIMPLE_VERT_SHADER));
+  writer.addShader("simple",
+                   ShaderFormat::Glsl,
+                   ShaderStage::Fragment,
+                   "main",
+                   data::shader::OGL_SIMPLE_FRAG_SHADER,
+                   strlen(data::shader::OGL_SIMPLE_FRAG_SHADER));
+  const std::vector<uint8_t> data = writer.serialize();
+
+  Result ret;
+  auto bundle = ShaderBundle::fromMemory(data.data(), data.size(), &ret);
+  ASSERT_TRUE(bundle != nullptr) << ret.message;
+  auto stages = bundle->createRenderStages(*iglDev_, "simple", &ret);
+  ASSERT_TRUE(stages != nullptr) << ret.message;
+  ASSERT_EQ(bundle->createComputeStages(*iglDev_, "simple", &ret), nullptr);
+  ASSERT_EQ(ret.code, Result::Code::ArgumentInvalid);
+}
+
+} // namespace tests
+} // namespace igl
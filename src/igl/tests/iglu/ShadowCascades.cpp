@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/glsl/Versions.h>
+#include <IGLU/shadows/ShadowCascades.h>
+#include <IGLU/simdtypes/SimdUtilities.h>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace iglu {
+namespace tests {
+
+using namespace simdtypes;
+using namespace shadows;
+
+namespace {
+
+CameraDesc makeCamera(float x, float y, float z) {
+  CameraDesc camera;
+  // looking down -Z from (x, y, z)
+  camera.view = float4x4(float4{1.0f, 0.0f, 0.0f, 0.0f},
+                         float4{0.0f, 1.0f, 0.0f, 0.0f},
+                         float4{0.0f, 0.0f, 1.0f, 0.0f},
+                         float4{-x, -y, -z, 1.0f});
+  camera.fovY = 1.0f;
+  camera.aspectRatio = 16.0f / 9.0f;
+  camera.nearZ = 0.1f;
+  camera.farZ = 200.0f;
+  return camera;
+}
+
+float distance(const float4& sphere, float x, float y, float z) {
+  const float dx = sphere[0] - x;
+  const float dy = sphere[1] - y;
+  const float dz = sphere[2] - z;
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// the position of a world space point in the texels of a cascade's shadow map
+float toTexels(const ShadowCascadesConfig& config, const float4x4& viewProjection, float x) {
+  const float4 p = multiply(viewProjection, float4{x, 1.0f, -20.0f, 1.0f});
+  return (p[0] * 0.5f + 0.5f) * static_cast<float>(config.resolution);
+}
+
+const float3 kLightDirection = float3{0.3f, -1.0f, 0.2f};
+
+// A caster covering the left half of the clip space, and a fullscreen pass writing the depth of
+// layer 0 of the shadow map into the red channel
+const char kGlslCasterVertex[] = R"(
+void main() {
+  const vec2 kCorners[6] = vec2[6](vec2(-1.0, -1.0),
+                                   vec2(0.0, -1.0),
+                                   vec2(0.0, 1.0),
+                                   vec2(-1.0, -1.0),
+                                   vec2(0.0, 1.0),
+                                   vec2(-1.0, 1.0));
+  gl_Position = vec4(kCorners[VERTEX_ID], 0.0, 1.0);
+}
+)";
+
+const char kGlslCasterFragment[] = R"(
+void main() {}
+)";
+
+const char kGlslReadbackVertex[] = R"(
+void main() {
+  vec2 uv = vec2(float((VERTEX_ID << 1) & 2), float(VERTEX_ID & 2));
+  gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+const char kGlslReadbackFragment[] = R"(
+SHADOW_MAP highp sampler2DArray shadowMap;
+layout(location = 0) out vec4 outColor;
+
+void main() {
+  outColor = vec4(texelFetch(shadowMap, ivec3(ivec2(gl_FragCoord.xy), 0), 0).r);
+}
+)";
+
+const char kMetalShaders[] = R"(
+using namespace metal;
+
+typedef struct {
+  float4 position [[position]];
+} VertexOut;
+
+vertex VertexOut casterVertex(uint vid [[vertex_id]]) {
+  const float2 corners[6] = {float2(-1.0, -1.0),
+                             float2(0.0, -1.0),
+                             float2(0.0, 1.0),
+                             float2(-1.0, -1.0),
+                             float2(0.0, 1.0),
+                             float2(-1.0, 1.0)};
+  VertexOut out;
+  out.position = float4(corners[vid], 0.0, 1.0);
+  return out;
+}
+
+fragment void casterFragment() {}
+
+vertex VertexOut readbackVertex(uint vid [[vertex_id]]) {
+  const float2 uv = float2(float((vid << 1) & 2), float(vid & 2));
+  VertexOut out;
+  out.position = float4(uv * 2.0 - 1.0, 0.0, 1.0);
+  return out;
+}
+
+fragment float4 readbackFragment(VertexOut IN [[stage_in]],
+                                 depth2d_array<float> shadowMap [[texture(0)]]) {
+  return float4(shadowMap.read(uint2(IN.position.xy), 0));
+}
+)";
+
+std::unique_ptr<igl::IShaderStages> createShaderStages(igl::IDevice& device,
+                                                       const char* vertexSource,
+                                                       const char* fragmentSource,
+                                                       const char* metalVertexFunction,
+                                                       const char* metalFragmentFunction,
+                                                       igl::Result* outResult) {
+  if (device.getBackendType() == igl::BackendType::Metal) {
+    return igl::ShaderStagesCreator::fromLibraryStringInput(
+        device, kMetalShaders, metalVertexFunction, metalFragmentFunction, "", outResult);
+  }
+  const std::string prologue =
+      device.getBackendType() == igl::BackendType::Vulkan
+          ? "#define VERTEX_ID gl_VertexIndex\n"
+            "#define SHADOW_MAP layout(set = 0, binding = 0) uniform\n"
+          : glsl::getOpenGLVersion(device.getShaderVersion()) +
+                "#define VERTEX_ID gl_VertexID\n#define SHADOW_MAP uniform\n";
+  const std::string vertex = prologue + vertexSource;
+  const std::string fragment = prologue + fragmentSource;
+  return igl::ShaderStagesCreator::fromModuleStringInput(
+      device, vertex.c_str(), "main", "", fragment.c_str(), "main", "", outResult);
+}
+
+} // namespace
+
+class ShadowCascadesGpuTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    igl::setDebugBreakEnabled(false);
+    igl::tests::util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+ protected:
+  std::shared_ptr<igl::IDevice> iglDev_;
+  std::shared_ptr<igl::ICommandQueue> cmdQueue_;
+};
+
+//
+// SplitDistances Test
+//
+TEST(ShadowCascadesTest, SplitDistances) {
+  float distances[kMaxCascades + 1] = {};
+  computeSplitDistances(0.1f, 100.0f, 0.0f, 4, distances);
+  ASSERT_FLOAT_EQ(distances[0], 0.1f);
+  ASSERT_FLOAT_EQ(distances[2], 50.05f);
+  ASSERT_FLOAT_EQ(distances[4], 100.0f);
+
+  computeSplitDistances(0.1f, 100.0f, 1.0f, 4, distances);
+  ASSERT_NEAR(distances[2], std::sqrt(0.1f * 100.0f), 1e-4f);
+
+  computeSplitDistances(0.1f, 100.0f, 0.75f, 4, distances);
+  for (uint32_t i = 0; i != 4; i++) {
+    ASSERT_LT(distances[i], distances[i + 1]);
+  }
+}
+
+//
+// SliceBoundingSphere Test
+//
+TEST(ShadowCascadesTest, SliceBoundingSphere) {
+  const CameraDesc camera = makeCamera(5.0f, 2.0f, 3.0f);
+  const float t = std::tan(0.5f * camera.fovY);
+  for (const auto& [n, f] : {std::make_pair(0.1f, 5.0f), std::make_pair(5.0f, 40.0f)}) {
+    const float4 sphere = computeSliceBoundingSphere(camera, n, f);
+    // holds all the corners of the slice
+    for (const float z : {n, f}) {
+      for (const float sx : {-1.0f, 1.0f}) {
+        for (const float sy : {-1.0f, 1.0f}) {
+          const float x = 5.0f + sx * z * t * camera.aspectRatio;
+          const float y = 2.0f + sy * z * t;
+          ASSERT_LE(distance(sphere, x, y, 3.0f - z), sphere[3] * 1.0001f);
+        }
+      }
+    }
+    // and does not change when the camera moves
+    const float4 moved = computeSliceBoundingSphere(makeCamera(-7.0f, 1.0f, 9.0f), n, f);
+    ASSERT_FLOAT_EQ(moved[3], sphere[3]);
+    ASSERT_NEAR(moved[0] - sphere[0], -12.0f, 1e-4f);
+  }
+}
+
+//
+// StableSnapping Test
+//
+// Moving the camera moves the shadow map by whole texels and keeps the static layer
+//
+TEST(ShadowCascadesTest, StableSnapping) {
+  ShadowCascadesConfig config;
+  config.resolution = 1024;
+  config.guardBandTexels = 64;
+
+  Cascade cascade;
+  const CameraDesc camera = makeCamera(0.0f, 0.0f, 0.0f);
+  ASSERT_TRUE(fitCascade(
+      config, kLightDirection, computeSliceBoundingSphere(camera, 1.0f, 30.0f), true, cascade));
+  ASSERT_EQ(cascade.staticOffset[0], 64);
+  ASSERT_EQ(cascade.staticOffset[1], 64);
+  const float4x4 staticViewProjection = cascade.staticViewProjection;
+  const float texels = toTexels(config, cascade.viewProjection, 0.0f);
+
+  const CameraDesc moved = makeCamera(0.37f, 0.0f, -0.21f);
+  ASSERT_FALSE(fitCascade(
+      config, kLightDirection, computeSliceBoundingSphere(moved, 1.0f, 30.0f), true, cascade));
+  // the static layer stays where it was
+  for (int c = 0; c != 4; c++) {
+    for (int r = 0; r != 4; r++) {
+      ASSERT_EQ(cascade.staticViewProjection.columns[c][r], staticViewProjection.columns[c][r]);
+    }
+  }
+  ASSERT_NE(cascade.staticOffset[0], 64);
+  // a world space point stays at the same place within its texel
+  const float movedTexels = toTexels(config, cascade.viewProjection, 0.0f);
+  const float shift = movedTexels - texels;
+  ASSERT_NEAR(shift, std::round(shift), 1e-2f);
+  // and the shadow map is the window of the static layer at the offset
+  const float staticTexels =
+      (multiply(staticViewProjection, float4{0.0f, 1.0f, -20.0f, 1.0f})[0] * 0.5f + 0.5f) *
+      static_cast<float>(config.resolution + 2 * config.guardBandTexels);
+  ASSERT_NEAR(staticTexels - movedTexels, static_cast<float>(cascade.staticOffset[0]), 1e-2f);
+}
+
+//
+// StaticLayerInvalidation Test
+//
+TEST(ShadowCascadesTest, StaticLayerInvalidation) {
+  ShadowCascadesConfig config;
+  config.resolution = 1024;
+  config.guardBandTexels = 16;
+
+  Cascade cascade;
+  const CameraDesc camera = makeCamera(0.0f, 0.0f, 0.0f);
+  const float4 sphere = computeSliceBoundingSphere(camera, 1.0f, 30.0f);
+  ASSERT_TRUE(fitCascade(config, kLightDirection, sphere, true, cascade));
+  ASSERT_FALSE(fitCascade(config, kLightDirection, sphere, true, cascade));
+
+  // the light moves
+  ASSERT_TRUE(fitCascade(config, float3{0.3f, -1.0f, 0.25f}, sphere, true, cascade));
+  ASSERT_FALSE(fitCascade(config, float3{0.3f, -1.0f, 0.25f}, sphere, true, cascade));
+
+  // the camera leaves the guard band
+  const float texelSize = 2.0f * sphere[3] / static_cast<float>(config.resolution);
+  const CameraDesc moved = makeCamera(20.0f * texelSize * 2.0f, 0.0f, 0.0f);
+  ASSERT_TRUE(fitCascade(config,
+                         float3{0.3f, -1.0f, 0.25f},
+                         computeSliceBoundingSphere(moved, 1.0f, 30.0f),
+                         true,
+                         cascade));
+
+  // the application asks for it
+  cascade.isStaticValid = false;
+  ASSERT_TRUE(fitCascade(config,
+                         float3{0.3f, -1.0f, 0.25f},
+                         computeSliceBoundingSphere(moved, 1.0f, 30.0f),
+                         true,
+                         cascade));
+}
+
+//
+// CompositeMatchesStaticOffset Test
+//
+// The shadow map holds the window of the static layer at the staticOffset fitCascade() computed,
+// and the static layer is not rendered again while the camera moves in the guard band
+//
+TEST_F(ShadowCascadesGpuTest, CompositeMatchesStaticOffset) {
+  ShadowCascadesConfig config;
+  config.numCascades = 1;
+  config.resolution = 32;
+  config.guardBandTexels = 8;
+  igl::Result result;
+  ShadowCascades cascades(*iglDev_, config, &result);
+  if (result.code == igl::Result::Code::Unsupported) {
+    GTEST_SKIP() << result.message;
+  }
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  igl::RenderPipelineDesc casterDesc;
+  casterDesc.shaderStages = createShaderStages(
+      *iglDev_, kGlslCasterVertex, kGlslCasterFragment, "casterVertex", "casterFragment", &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  casterDesc.targetDesc.depthAttachmentFormat = cascades.getDepthFormat();
+  casterDesc.cullMode = igl::CullMode::Disabled;
+  const std::shared_ptr<igl::IRenderPipelineState> casterPipeline =
+      iglDev_->createRenderPipeline(casterDesc, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  igl::RenderPipelineDesc readbackDesc;
+  readbackDesc.shaderStages = createShaderStages(*iglDev_,
+                                                 kGlslReadbackVertex,
+                                                 kGlslReadbackFragment,
+                                                 "readbackVertex",
+                                                 "readbackFragment",
+                                                 &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  readbackDesc.targetDesc.colorAttachments.resize(1);
+  readbackDesc.targetDesc.colorAttachments[0].textureFormat = igl::TextureFormat::RGBA_UNorm8;
+  readbackDesc.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE("shadowMap");
+  readbackDesc.cullMode = igl::CullMode::Disabled;
+  const std::shared_ptr<igl::IRenderPipelineState> readbackPipeline =
+      iglDev_->createRenderPipeline(readbackDesc, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  const std::shared_ptr<igl::ISamplerState> sampler =
+      iglDev_->createSamplerState(igl::SamplerStateDesc(), &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  const size_t size = config.resolution;
+  igl::FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = iglDev_->createTexture(
+      igl::TextureDesc::new2D(igl::TextureFormat::RGBA_UNorm8,
+                              size,
+                              size,
+                              igl::TextureDesc::TextureUsageBits::Attachment |
+                                  igl::TextureDesc::TextureUsageBits::Sampled),
+      &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  const std::shared_ptr<igl::IFramebuffer> framebuffer =
+      iglDev_->createFramebuffer(framebufferDesc, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  const ShadowCascades::DrawCastersFunc drawStatic =
+      [&casterPipeline](igl::IRenderCommandEncoder& encoder,
+                        const float4x4& /*viewProjection*/,
+                        uint32_t /*cascadeIndex*/) {
+        encoder.bindRenderPipelineState(casterPipeline);
+        encoder.draw(igl::PrimitiveType::Triangle, 0, 6);
+      };
+  // renders the cascades, then the depths of the shadow map, and compares them with the columns
+  // of the static layer the caster covers
+  const auto renderAndCompare = [&](uint32_t expectedStaticRenders) {
+    auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &result);
+    ASSERT_TRUE(result.isOk()) << result.message;
+    cascades.render(*cmdBuffer, drawStatic, nullptr);
+    ASSERT_EQ(cascades.getNumStaticRenders(), expectedStaticRenders);
+
+    igl::RenderPassDesc renderPass;
+    renderPass.colorAttachments.resize(1);
+    renderPass.colorAttachments[0].loadAction = igl::LoadAction::DontCare;
+    renderPass.colorAttachments[0].storeAction = igl::StoreAction::Store;
+    auto encoder = cmdBuffer->createRenderCommandEncoder(renderPass, framebuffer);
+    ASSERT_TRUE(encoder != nullptr);
+    encoder->bindRenderPipelineState(readbackPipeline);
+    encoder->bindTexture(0, igl::BindTarget::kFragment, cascades.getShadowMap().get());
+    encoder->bindSamplerState(0, igl::BindTarget::kFragment, sampler.get());
+    encoder->draw(igl::PrimitiveType::Triangle, 0, 3);
+    encoder->endEncoding();
+    cmdQueue_->submit(*cmdBuffer);
+    cmdBuffer->waitUntilCompleted();
+
+    std::vector<uint32_t> pixels(size * size);
+    framebuffer->copyBytesColorAttachment(
+        *cmdQueue_, 0, pixels.data(), igl::TextureRangeDesc::new2D(0, 0, size, size));
+    const auto offset = static_cast<size_t>(cascades.getCascade(0).staticOffset[0]);
+    const size_t staticResolution = config.resolution + 2 * config.guardBandTexels;
+    for (size_t y = 0; y != size; y++) {
+      for (size_t x = 0; x != size; x++) {
+        // the caster is at depth 0 (0.5 on OpenGL), in front of the cleared depth of 1
+        const bool isCast = x + offset < staticResolution / 2;
+        const uint32_t depth = pixels[y * size + x] & 0xff;
+        if (isCast) {
+          EXPECT_LT(depth, 192u) << x << " " << y;
+        } else {
+          EXPECT_EQ(depth, 255u) << x << " " << y;
+        }
+      }
+    }
+  };
+
+  // the light falls along -Z, so its x axis is the world's
+  CameraDesc camera = makeCamera(0.0f, 0.0f, 0.0f);
+  camera.farZ = 10.0f;
+  const float3 lightDirection = float3{0.0f, 0.0f, -1.0f};
+  cascades.update(camera, lightDirection);
+  ASSERT_EQ(cascades.getCascade(0).staticOffset[0], 8);
+  renderAndCompare(1);
+
+  // 3 texels to the right, in the guard band
+  const float texelSize = 2.0f * cascades.getCascade(0).boundingSphere[3] / 32.0f;
+  camera.view.columns[3][0] = -3.0f * texelSize;
+  cascades.update(camera, lightDirection);
+  ASSERT_EQ(cascades.getCascade(0).staticOffset[0], 11);
+  renderAndCompare(0);
+}
+
+} // namespace tests
+} // namespace iglu
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/SimdMatrices.h"
+#include <IGLU/simdtypes/SimdBatch.h>
+#include <IGLU/simdtypes/SimdUtilities.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace iglu {
+namespace tests {
+
+using namespace simdtypes;
+using igl::tests::util::makeOrtho;
+
+namespace {
+
+float4x4 makeMatrix(float seed) {
+  float vals[16];
+  for (int i = 0; i != 16; i++) {
+    vals[i] = seed + static_cast<float>((i * 7) % 5) - 0.25f * static_cast<float>(i);
+  }
+  return float4x4(vals);
+}
+
+} // namespace
+
+//
+// TransformBatch Test
+//
+// Matches multiply() for every matrix, including a count which is not a multiple of the width
+//
+TEST(SimdBatchTest, TransformBatch) {
+  const float4x4 m = makeMatrix(1.0f);
+  std::vector<float4x4> matrices;
+  for (int i = 0; i != 7; i++) {
+    matrices.push_back(makeMatrix(static_cast<float>(i)));
+  }
+  std::vector<float4x4> out(matrices.size());
+  transformBatch(m, matrices.data(), out.data(), matrices.size());
+  for (size_t i = 0; i != matrices.size(); i++) {
+    const float4x4 expected = multiply(m, matrices[i]);
+    for (int c = 0; c != 4; c++) {
+      for (int r = 0; r != 4; r++) {
+        ASSERT_FLOAT_EQ(out[i].columns[c][r], expected.columns[c][r]);
+      }
+    }
+  }
+
+  // in place
+  transformBatch(m, matrices.data(), matrices.data(), matrices.size());
+  for (size_t i = 0; i != matrices.size(); i++) {
+    for (int c = 0; c != 4; c++) {
+      for (int r = 0; r != 4; r++) {
+        ASSERT_FLOAT_EQ(matrices[i].columns[c][r], out[i].columns[c][r]);
+      }
+    }
+  }
+}
+
+//
+// CullSpheresBatch Test
+//
+TEST(SimdBatchTest, CullSpheresBatch) {
+  float4 planes[6];
+  getFrustumPlanes(makeOrtho(), true, planes);
+
+  const std::vector<float4> spheres = {
+      float4{0.0f, 0.0f, 0.0f, 0.1f}, // inside
+      float4{3.0f, 0.0f, 0.0f, 1.0f}, // outside on the right
+      float4{1.5f, 0.0f, 0.0f, 0.6f}, // intersecting the right plane
+      float4{0.0f, -5.0f, 0.0f, 1.0f}, // outside at the bottom
+      float4{0.0f, 0.0f, 1.5f, 0.4f}, // beyond the far plane
+      float4{0.0f, 0.0f, -1.2f, 0.3f}, // intersecting the near plane
+  };
+  std::vector<uint8_t> visible(spheres.size());
+  const size_t numVisible =
+      cullSpheresBatch(planes, spheres.data(), visible.data(), spheres.size());
+  ASSERT_EQ(numVisible, 3u);
+  ASSERT_EQ(visible, (std::vector<uint8_t>{1, 0, 1, 0, 0, 1}));
+}
+
+//
+// CullBoxesBatch Test
+//
+TEST(SimdBatchTest, CullBoxesBatch) {
+  float4 planes[6];
+  getFrustumPlanes(makeOrtho(), true, planes);
+
+  const std::vector<float4> mins = {
+      float4{-0.5f, -0.5f, -0.5f, 0.0f}, // inside
+      float4{2.0f, 0.0f, 0.0f, 0.0f}, // outside on the right
+      float4{-3.0f, -3.0f, -3.0f, 0.0f}, // containing the frustum
+      float4{0.0f, 0.0f, 1.1f, 0.0f}, // beyond the far plane
+      float4{0.9f, 0.9f, 0.9f, 0.0f}, // intersecting a corner
+  };
+  const std::vector<float4> maxs = {
+      float4{0.5f, 0.5f, 0.5f, 0.0f},
+      float4{3.0f, 1.0f, 1.0f, 0.0f},
+      float4{3.0f, 3.0f, 3.0f, 0.0f},
+      float4{1.0f, 1.0f, 2.0f, 0.0f},
+      float4{2.0f, 2.0f, 2.0f, 0.0f},
+  };
+  std::vector<uint8_t> visible(mins.size());
+  const size_t numVisible =
+      cullBoxesBatch(planes, mins.data(), maxs.data(), visible.data(), mins.size());
+  ASSERT_EQ(numVisible, 3u);
+  ASSERT_EQ(visible, (std::vector<uint8_t>{1, 0, 1, 0, 1}));
+}
+
+//
+// NormalMatricesBatch Test
+//
+// The normal matrix is the transposed inverse of the upper 3x3 matrix
+//
+TEST(SimdBatchTest, NormalMatricesBatch) {
+  std::vector<float4x4> matrices = {
+      float4x4(float4{2.0f, 3.0f, 4.0f, 1.0f}),
+      makeMatrix(2.0f),
+      float4x4(0.0f), // singular
+  };
+  std::vector<float3x3> out(matrices.size());
+  normalMatricesBatch(matrices.data(), out.data(), matrices.size());
+
+  for (size_t i = 0; i != 2; i++) {
+    // transpose(normal) * upper3x3 == identity
+    for (int c = 0; c != 3; c++) {
+      for (int r = 0; r != 3; r++) {
+        float value = 0.0f;
+        for (int k = 0; k != 3; k++) {
+          value += out[i].columns[r][k] * matrices[i].columns[c][k];
+        }
+        ASSERT_NEAR(value, r == c ? 1.0f : 0.0f, 1e-4f);
+      }
+    }
+  }
+  for (int c = 0; c != 3; c++) {
+    for (int r = 0; r != 3; r++) {
+      ASSERT_EQ(out[2].columns[c][r], r == c ? 1.0f : 0.0f);
+    }
+  }
+}
+
+} // namespace tests
+} // namespace iglu
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/spatial_upscaler/SpatialUpscaler.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+using iglu::spatialupscaler::SpatialUpscaler;
+using iglu::spatialupscaler::SpatialUpscalerConfig;
+
+//
+// SpatialUpscalerTest
+//
+// Test fixture for all the tests in this file. Takes care of common
+// initialization and allocating of common resources.
+//
+class SpatialUpscalerTest : public ::testing::Test {
+ public:
+  SpatialUpscalerTest() = default;
+  ~SpatialUpscalerTest() override = default;
+
+  //
+  // SetUp()
+  // Create device, commandQueue
+  //
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+  void TearDown() override {}
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+//
+// A constant image stays constant after upscaling and sharpening
+//
+TEST_F(SpatialUpscalerTest, UpscalesConstantImage) {
+  Result ret;
+  SpatialUpscaler upscaler(*iglDev_, SpatialUpscalerConfig(), &ret);
+  if (ret.code == Result::Code::Unsupported) {
+    GTEST_SKIP() << ret.message;
+  }
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  constexpr size_t kInputSize = 4;
+  constexpr size_t kOutputSize = 8;
+  constexpr uint32_t kColor = 0xff4080c0;
+
+  auto inputDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                      kInputSize,
+                                      kInputSize,
+                                      TextureDesc::TextureUsageBits::Sampled |
+                                          upscaler.getTextureUsage());
+  auto input = iglDev_->createTexture(inputDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  const std::vector<uint32_t> inputPixels(kInputSize * kInputSize, kColor);
+  ASSERT_TRUE(input->upload(TextureRangeDesc::new2D(0, 0, kInputSize, kInputSize),
+                            inputPixels.data())
+                  .isOk());
+
+  auto outputDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                       kOutputSize,
+                                       kOutputSize,
+                                       TextureDesc::TextureUsageBits::Attachment |
+                                           upscaler.getTextureUsage());
+  auto output = iglDev_->createTexture(outputDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  auto cmdBuffer = cmdQueue_->createCommandBuffer(CommandBufferDesc(), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  upscaler.upscale(*cmdBuffer, *input, Dimensions(kInputSize, kInputSize, 1), output);
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = output;
+  auto framebuffer = iglDev_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  std::vector<uint32_t> outputPixels(kOutputSize * kOutputSize);
+  framebuffer->copyBytesColorAttachment(
+      *cmdQueue_, 0, outputPixels.data(), TextureRangeDesc::new2D(0, 0, kOutputSize, kOutputSize));
+  for (const uint32_t pixel : outputPixels) {
+    for (uint32_t shift = 0; shift < 32; shift += 8) {
+      const int expected = static_cast<int>((kColor >> shift) & 0xff);
+      const int actual = static_cast<int>((pixel >> shift) & 0xff);
+      ASSERT_NEAR(actual, expected, 1);
+    }
+  }
+}
+
+} // namespace tests
+} // namespace igl
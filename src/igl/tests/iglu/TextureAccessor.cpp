@@ -9,6 +9,7 @@
 #include "../util/Common.h"
 #include "../util/TestDevice.h"
 #include <IGLU/texture_accessor/ITextureAccessor.h>
+#include <IGLU/texture_accessor/PickingReader.h>
 #include <IGLU/texture_accessor/TextureAccessorFactory.h>
 #include <gtest/gtest.h>
 #include <igl/Common.h>
@@ -103,5 +104,90 @@ TEST_F(TextureAccessorTest, testRequestAndGetBytesSync) {
   }
 }
 
+//
+// testRequestBytesIntoCallerMemory Test
+//
+// Tests several asynchronous readbacks in flight, written into memory owned by the caller
+//
+TEST_F(TextureAccessorTest, testRequestBytesIntoCallerMemory) {
+  textureAccessor_ = iglu::textureaccessor::TextureAccessorFactory::createTextureAccessor(
+      iglDev_->getBackendType(), texture_, *iglDev_);
+  ASSERT_TRUE(textureAccessor_ != nullptr);
+  ASSERT_EQ(textureAccessor_->getSizeInBytes(), textureSizeInBytes_);
+
+  uint32_t pixels0[4] = {};
+  uint32_t pixels1[4] = {};
+  const auto request0 = textureAccessor_->requestBytes(*cmdQueue_, pixels0, sizeof(pixels0));
+  const auto request1 = textureAccessor_->requestBytes(*cmdQueue_, pixels1, sizeof(pixels1));
+  if (request0 == 0) {
+    GTEST_SKIP() << "Asynchronous readbacks are not supported";
+  }
+  ASSERT_NE(request1, 0);
+  ASSERT_NE(request0, request1);
+
+  ASSERT_EQ(textureAccessor_->waitForRequest(request1),
+            iglu::textureaccessor::RequestStatus::Ready);
+  // finished requests are reported once
+  ASSERT_EQ(textureAccessor_->getRequestStatus(request1),
+            iglu::textureaccessor::RequestStatus::NotInitialized);
+  ASSERT_EQ(textureAccessor_->waitForRequest(request0),
+            iglu::textureaccessor::RequestStatus::Ready);
+
+  for (int i = 0; i < textureSizeInBytes_ / 4; i++) {
+    ASSERT_EQ(pixels0[i], data::texture::TEX_RGBA_2x2[i]);
+    ASSERT_EQ(pixels1[i], data::texture::TEX_RGBA_2x2[i]);
+  }
+}
+
+//
+// testPickingReader Test
+//
+// Tests batched asynchronous readbacks of pixels and small regions
+//
+TEST_F(TextureAccessorTest, testPickingReader) {
+  Result result;
+  if (!texture_->readAsync(*cmdQueue_, TextureRangeDesc::new2D(0, 0, 1, 1), &result)) {
+    GTEST_SKIP() << "Asynchronous readbacks are not supported";
+  }
+
+  // the first reader merges all the queries into one copy, the second one merges none
+  for (const size_t maxMergedPixels : {64, 1}) {
+    iglu::textureaccessor::PickingReader reader(maxMergedPixels);
+    const auto pixel10 = reader.requestPixel(texture_, 1, 0);
+    const auto pixel01 = reader.requestPixel(texture_, 0, 1);
+    const auto row1 = reader.request(texture_, TextureRangeDesc::new2D(0, 1, 2, 1));
+    ASSERT_NE(pixel10, 0);
+    ASSERT_NE(pixel01, 0);
+    ASSERT_NE(row1, 0);
+    // outside of the texture
+    ASSERT_EQ(reader.requestPixel(texture_, 2, 0), 0);
+    ASSERT_EQ(reader.getNumPendingQueries(), 3u);
+
+    // nothing is delivered before submit()
+    ASSERT_EQ(reader.poll([](const auto& /*result*/) {}), 0u);
+    reader.submit(*cmdQueue_);
+
+    std::vector<uint32_t> values;
+    const size_t numDelivered = reader.wait([&](const iglu::textureaccessor::PickingResult& r) {
+      ASSERT_EQ(r.status, iglu::textureaccessor::RequestStatus::Ready);
+      ASSERT_EQ(r.bytesPerPixel, 4u);
+      for (size_t y = r.range.y; y != r.range.y + r.range.height; y++) {
+        for (size_t x = r.range.x; x != r.range.x + r.range.width; x++) {
+          uint32_t value = 0;
+          memcpy(&value, r.getPixel(x, y), sizeof(value));
+          values.push_back(value);
+        }
+      }
+    });
+    ASSERT_EQ(numDelivered, 3u);
+    ASSERT_EQ(reader.getNumPendingQueries(), 0u);
+    ASSERT_EQ(values,
+              std::vector<uint32_t>({data::texture::TEX_RGBA_2x2[1],
+                                     data::texture::TEX_RGBA_2x2[2],
+                                     data::texture::TEX_RGBA_2x2[2],
+                                     data::texture::TEX_RGBA_2x2[3]}));
+  }
+}
+
 } // namespace tests
 } // namespace igl
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/texture_atlas/TextureAtlas.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+#define ATLAS_PAGE_SIZE 64
+
+namespace igl {
+namespace tests {
+
+TEST(SkylinePackerTest, Pack) {
+  iglu::textureatlas::SkylinePacker packer(16, 16);
+  uint32_t x = 0, y = 0;
+
+  ASSERT_TRUE(packer.pack(8, 4, x, y));
+  EXPECT_EQ(x, 0u);
+  EXPECT_EQ(y, 0u);
+  // lowest top edge first
+  ASSERT_TRUE(packer.pack(8, 8, x, y));
+  EXPECT_EQ(x, 8u);
+  EXPECT_EQ(y, 0u);
+  ASSERT_TRUE(packer.pack(8, 4, x, y));
+  EXPECT_EQ(x, 0u);
+  EXPECT_EQ(y, 4u);
+  ASSERT_TRUE(packer.pack(16, 8, x, y));
+  EXPECT_EQ(x, 0u);
+  EXPECT_EQ(y, 8u);
+  EXPECT_EQ(packer.getUsedArea(), 16u * 16u);
+
+  ASSERT_FALSE(packer.pack(1, 1, x, y));
+  ASSERT_FALSE(packer.pack(17, 1, x, y));
+
+  packer.reset();
+  EXPECT_EQ(packer.getUsedArea(), 0u);
+  ASSERT_TRUE(packer.pack(16, 16, x, y));
+}
+
+//
+// TextureAtlasTest
+//
+// Test fixture for all the tests in this file. Takes care of common
+// initialization and allocating of common resources.
+//
+class TextureAtlasTest : public ::testing::Test {
+ public:
+  TextureAtlasTest() = default;
+  ~TextureAtlasTest() override = default;
+
+  //
+  // SetUp()
+  // Create device, commandQueue
+  //
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    if (!iglDev_->hasFeature(DeviceFeatures::Texture2DArray)) {
+      GTEST_SKIP() << "2D texture arrays are not supported";
+    }
+
+    config_.pageSize = ATLAS_PAGE_SIZE;
+    config_.numPages = 2;
+    config_.padding = 0;
+  }
+
+  void TearDown() override {}
+
+  // Member variables
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  iglu::textureatlas::TextureAtlasConfig config_;
+  std::vector<uint32_t> pixels_ = std::vector<uint32_t>(ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE);
+};
+
+TEST_F(TextureAtlasTest, AddAndUpload) {
+  Result ret;
+  iglu::textureatlas::TextureAtlas atlas(*iglDev_, config_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(atlas.getTexture() != nullptr);
+  ASSERT_EQ(atlas.getTexture()->getNumLayers(), 2u);
+
+  auto entry0 = atlas.add(16, 8, pixels_.data());
+  auto entry1 = atlas.add(16, 8, pixels_.data(), ATLAS_PAGE_SIZE * 4);
+  ASSERT_TRUE(entry0 && entry1);
+  EXPECT_TRUE(entry0->isResident());
+  EXPECT_EQ(atlas.getNumPendingUploads(), 2u);
+
+  const auto& region = entry1->getRegion();
+  EXPECT_EQ(region.page, 0u);
+  EXPECT_EQ(region.x, 16u);
+  EXPECT_EQ(region.y, 0u);
+  EXPECT_FLOAT_EQ(region.uvOffset[0], 0.25f);
+  EXPECT_FLOAT_EQ(region.uvScale[0], 0.25f);
+  EXPECT_FLOAT_EQ(region.uvScale[1], 0.125f);
+
+  ret = atlas.update();
+  ASSERT_TRUE(ret.isOk());
+  EXPECT_EQ(atlas.getNumPendingUploads(), 0u);
+
+  // larger than a page
+  ASSERT_TRUE(atlas.add(ATLAS_PAGE_SIZE + 1, 1, pixels_.data()) == nullptr);
+}
+
+TEST_F(TextureAtlasTest, ReleaseAndEvict) {
+  iglu::textureatlas::TextureAtlas atlas(*iglDev_, config_);
+
+  auto page0 = atlas.add(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, pixels_.data());
+  auto page1 = atlas.add(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, pixels_.data());
+  ASSERT_TRUE(page0 && page1);
+  EXPECT_EQ(page1->getRegion().page, 1u);
+
+  // both pages are used in the current frame
+  ASSERT_TRUE(atlas.add(1, 1, pixels_.data()) == nullptr);
+  ASSERT_TRUE(atlas.update().isOk());
+
+  // a released page is reused without evicting anything
+  page0.reset();
+  auto entry = atlas.add(1, 1, pixels_.data());
+  ASSERT_TRUE(entry != nullptr);
+  EXPECT_EQ(entry->getRegion().page, 0u);
+  EXPECT_TRUE(page1->isResident());
+  ASSERT_TRUE(atlas.update().isOk());
+
+  // the least recently used page is evicted
+  atlas.touch(*entry);
+  auto large = atlas.add(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, pixels_.data());
+  ASSERT_TRUE(large != nullptr);
+  EXPECT_EQ(large->getRegion().page, 1u);
+  EXPECT_FALSE(page1->isResident());
+  EXPECT_TRUE(entry->isResident());
+  ASSERT_TRUE(atlas.update().isOk());
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/texture_compressor/TextureCompressor.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <vector>
+
+namespace igl {
+namespace tests {
+
+using iglu::texturecompressor::TextureCompressor;
+
+//
+// TextureCompressorTest
+//
+// Test fixture for all the tests in this file. Takes care of common
+// initialization and allocating of common resources.
+//
+class TextureCompressorTest : public ::testing::Test {
+ public:
+  TextureCompressorTest() = default;
+  ~TextureCompressorTest() override = default;
+
+  //
+  // SetUp()
+  // Create device, commandQueue
+  //
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+  void TearDown() override {}
+
+ protected:
+  std::shared_ptr<ITexture> createSource(TextureFormat format, size_t width, size_t height) {
+    Result ret;
+    auto texture = iglDev_->createTexture(
+        TextureDesc::new2D(format,
+                           width,
+                           height,
+                           TextureDesc::TextureUsageBits::Sampled |
+                               TextureCompressor::getSourceUsage()),
+        &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+    return texture;
+  }
+
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+TEST_F(TextureCompressorTest, CanEncode) {
+  ASSERT_TRUE(TextureCompressor::canEncode(TextureFormat::RGBA_BC7_UNORM_4x4));
+  ASSERT_TRUE(TextureCompressor::canEncode(TextureFormat::SRGB8_A8_ASTC_4x4));
+  ASSERT_TRUE(TextureCompressor::canEncode(TextureFormat::RGB8_ETC2));
+  ASSERT_TRUE(TextureCompressor::canEncode(TextureFormat::RGBA8_EAC_ETC2));
+  ASSERT_FALSE(TextureCompressor::canEncode(TextureFormat::RGBA_UNorm8));
+  ASSERT_FALSE(TextureCompressor::canEncode(TextureFormat::RGBA_ASTC_8x8));
+}
+
+//
+// Compresses a constant image which does not fill its last blocks
+//
+TEST_F(TextureCompressorTest, CompressesIntoChosenFormat) {
+  Result ret;
+  TextureCompressor compressor(*iglDev_, &ret);
+  if (ret.code == Result::Code::Unsupported) {
+    GTEST_SKIP() << ret.message;
+  }
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  for (const bool hasAlpha : {false, true}) {
+    const TextureFormat format = compressor.chooseFormat(hasAlpha);
+    if (format == TextureFormat::Invalid) {
+      GTEST_SKIP() << "No compressed format is supported";
+    }
+    ASSERT_TRUE(compressor.isSupported(format));
+
+    constexpr size_t kWidth = 10;
+    constexpr size_t kHeight = 6;
+    auto source = createSource(TextureFormat::RGBA_UNorm8, kWidth, kHeight);
+    ASSERT_TRUE(source != nullptr);
+    const std::vector<uint32_t> pixels(kWidth * kHeight, hasAlpha ? 0x804080c0 : 0xff4080c0);
+    ASSERT_TRUE(source->upload(TextureRangeDesc::new2D(0, 0, kWidth, kHeight), pixels.data())
+                    .isOk());
+
+    auto output = iglDev_->createTexture(
+        TextureDesc::new2D(format, kWidth, kHeight, TextureDesc::TextureUsageBits::Sampled), &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+
+    auto cmdBuffer = cmdQueue_->createCommandBuffer(CommandBufferDesc(), &ret);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+    ret = compressor.compress(*cmdBuffer, *source, *output);
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+    cmdQueue_->submit(*cmdBuffer);
+    cmdBuffer->waitUntilCompleted();
+  }
+}
+
+TEST_F(TextureCompressorTest, RejectsInvalidArguments) {
+  Result ret;
+  TextureCompressor compressor(*iglDev_, &ret);
+  if (ret.code == Result::Code::Unsupported) {
+    GTEST_SKIP() << ret.message;
+  }
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  const TextureFormat format = compressor.chooseFormat(false);
+  if (format == TextureFormat::Invalid) {
+    GTEST_SKIP() << "No compressed format is supported";
+  }
+
+  auto output = iglDev_->createTexture(
+      TextureDesc::new2D(format, 8, 8, TextureDesc::TextureUsageBits::Sampled), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  auto cmdBuffer = cmdQueue_->createCommandBuffer(CommandBufferDesc(), &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  // the source must match the size of the output
+  auto smallSource = createSource(TextureFormat::RGBA_UNorm8, 4, 4);
+  ASSERT_TRUE(smallSource != nullptr);
+  ASSERT_EQ(compressor.compress(*cmdBuffer, *smallSource, *output).code,
+            Result::Code::ArgumentInvalid);
+  // which its second mip level has
+  auto mipDesc = TextureDesc::new2D(format, 8, 8, TextureDesc::TextureUsageBits::Sampled);
+  mipDesc.numMipLevels = 2;
+  auto mipOutput = iglDev_->createTexture(mipDesc, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_TRUE(compressor.compress(*cmdBuffer, *smallSource, *mipOutput, 1).isOk());
+  ASSERT_EQ(compressor.compress(*cmdBuffer, *smallSource, *mipOutput, 2).code,
+            Result::Code::ArgumentOutOfRange);
+
+  // the output must be compressed
+  auto uncompressed = createSource(TextureFormat::RGBA_UNorm8, 4, 4);
+  ASSERT_TRUE(uncompressed != nullptr);
+  ASSERT_EQ(compressor.compress(*cmdBuffer, *smallSource, *uncompressed).code,
+            Result::Code::Unsupported);
+
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+}
+
+} // namespace tests
+} // namespace igl
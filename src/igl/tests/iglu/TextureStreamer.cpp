@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/texture_streamer/TextureStreamer.h>
+#include <algorithm>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <thread>
+
+#define STREAMED_TEX_SIZE 64
+#define STREAMED_TEX_MIP_LEVELS 7
+
+namespace igl {
+namespace tests {
+
+namespace {
+class FakeTextureSource final : public iglu::texturestreamer::ITextureSource {
+ public:
+  [[nodiscard]] TextureDesc getDesc() const override {
+    auto desc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                   STREAMED_TEX_SIZE,
+                                   STREAMED_TEX_SIZE,
+                                   TextureDesc::TextureUsageBits::Sampled);
+    desc.numMipLevels = STREAMED_TEX_MIP_LEVELS;
+    return desc;
+  }
+
+  bool loadMipLevel(uint32_t mipLevel, std::vector<uint8_t>& outData) override {
+    const size_t size = std::max(STREAMED_TEX_SIZE >> mipLevel, 1);
+    outData.assign(size * size * 4, static_cast<uint8_t>(mipLevel));
+    return true;
+  }
+};
+} // namespace
+
+//
+// TextureStreamerTest
+//
+// Test fixture for all the tests in this file. Takes care of common
+// initialization and allocating of common resources.
+//
+class TextureStreamerTest : public ::testing::Test {
+ public:
+  TextureStreamerTest() = default;
+  ~TextureStreamerTest() override = default;
+
+  //
+  // SetUp()
+  // Create device, commandQueue
+  //
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    config_.numResidentMipLevels = 3;
+    config_.numWorkerThreads = 1;
+  }
+
+  void TearDown() override {}
+
+  // Calls update() until all loads are uploaded
+  void waitForLoads(iglu::texturestreamer::TextureStreamer& streamer) {
+    for (int i = 0; i != 1000; i++) {
+      streamer.update();
+      if (streamer.getNumPendingLoads() == 0) {
+        return;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    FAIL() << "Texture loads did not finish";
+  }
+
+  // Member variables
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  iglu::texturestreamer::TextureStreamerConfig config_;
+};
+
+//
+// CoarseMipLevelsFirst Test
+//
+// Only the always resident mip levels are loaded until finer ones are requested
+//
+TEST_F(TextureStreamerTest, CoarseMipLevelsFirst) {
+  iglu::texturestreamer::TextureStreamer streamer(*iglDev_, config_);
+  auto texture = streamer.add(std::make_shared<FakeTextureSource>());
+  ASSERT_NE(texture, nullptr);
+  ASSERT_EQ(texture->getTexture(), nullptr);
+
+  waitForLoads(streamer);
+  ASSERT_NE(texture->getTexture(), nullptr);
+  ASSERT_EQ(texture->getResidentMipLevel(), 4u);
+  ASSERT_EQ(texture->getTexture()->getDimensions().width, 4u);
+  ASSERT_EQ(texture->getTexture()->getNumMipLevels(), 3u);
+
+  // the always resident levels stay resident without requests
+  waitForLoads(streamer);
+  ASSERT_EQ(texture->getResidentMipLevel(), 4u);
+}
+
+//
+// StreamFinerMipLevels Test
+//
+// Requested mip levels are streamed in
+//
+TEST_F(TextureStreamerTest, StreamFinerMipLevels) {
+  iglu::texturestreamer::TextureStreamer streamer(*iglDev_, config_);
+  auto texture = streamer.add(std::make_shared<FakeTextureSource>());
+  ASSERT_NE(texture, nullptr);
+  waitForLoads(streamer);
+
+  streamer.request(*texture, 0, 1.0f);
+  waitForLoads(streamer);
+  ASSERT_EQ(texture->getResidentMipLevel(), 0u);
+  ASSERT_EQ(texture->getTexture()->getDimensions().width, STREAMED_TEX_SIZE);
+  ASSERT_EQ(texture->getTexture()->getNumMipLevels(), STREAMED_TEX_MIP_LEVELS);
+  ASSERT_GT(streamer.getStreamedMemory(), STREAMED_TEX_SIZE * STREAMED_TEX_SIZE * 4);
+}
+
+//
+// EvictUnderBudget Test
+//
+// Textures with lower priorities are evicted to stay within the memory budget
+//
+TEST_F(TextureStreamerTest, EvictUnderBudget) {
+  // level 0 of one texture fits, but not of two
+  config_.memoryBudget = STREAMED_TEX_SIZE * STREAMED_TEX_SIZE * 4 * 3 / 2;
+  iglu::texturestreamer::TextureStreamer streamer(*iglDev_, config_);
+  auto low = streamer.add(std::make_shared<FakeTextureSource>());
+  auto high = streamer.add(std::make_shared<FakeTextureSource>());
+  ASSERT_NE(low, nullptr);
+  ASSERT_NE(high, nullptr);
+  waitForLoads(streamer);
+
+  streamer.request(*low, 0, 0.0f);
+  waitForLoads(streamer);
+  ASSERT_EQ(low->getResidentMipLevel(), 0u);
+
+  // the low priority texture keeps its levels while the budget allows
+  streamer.request(*high, 0, 1.0f);
+  waitForLoads(streamer);
+  ASSERT_EQ(high->getResidentMipLevel(), 2u);
+  ASSERT_LE(streamer.getStreamedMemory(), config_.memoryBudget);
+
+  // once it is no longer needed, it is evicted in favor of the high priority texture
+  streamer.request(*low, 4, 0.0f);
+  waitForLoads(streamer);
+  waitForLoads(streamer);
+  ASSERT_EQ(low->getResidentMipLevel(), 4u);
+  ASSERT_EQ(high->getResidentMipLevel(), 0u);
+  ASSERT_LE(streamer.getStreamedMemory(), config_.memoryBudget);
+}
+
+} // namespace tests
+} // namespace igl
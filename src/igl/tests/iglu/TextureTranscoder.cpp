@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/texture_transcoder/MappedKtxFile.h>
+#include <IGLU/texture_transcoder/TextureTranscoder.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+namespace {
+constexpr uint32_t kVkFormatUndefined = 0;
+constexpr uint32_t kVkFormatRGBA8 = 37;
+
+template<typename T>
+void append(std::vector<uint8_t>& data, T value) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+  data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+// A 2D KTX2 file with 2 mip levels of a 2x2 texture
+std::vector<uint8_t> createKtx2(uint32_t vkFormat,
+                                iglu::texturetranscoder::Ktx2Supercompression sc) {
+  const uint8_t identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+  std::vector<uint8_t> data(identifier, identifier + sizeof(identifier));
+  for (const uint32_t value : {vkFormat, 1u, 2u, 2u, 0u, 0u, 1u, 2u, static_cast<uint32_t>(sc)}) {
+    append(data, value);
+  }
+  // no data format descriptor, key/value data or global data
+  for (int i = 0; i != 4; i++) {
+    append<uint32_t>(data, 0);
+  }
+  append<uint64_t>(data, 0);
+  append<uint64_t>(data, 0);
+  // level index: level 0 (16 bytes) after level 1 (4 bytes)
+  const uint64_t dataOffset = data.size() + 2 * 24;
+  for (const uint64_t value : {dataOffset + 4, uint64_t(16), uint64_t(16)}) {
+    append(data, value);
+  }
+  for (const uint64_t value : {dataOffset, uint64_t(4), uint64_t(4)}) {
+    append(data, value);
+  }
+  data.insert(data.end(), 4, 1);
+  data.insert(data.end(), 16, 0);
+  return data;
+}
+
+// A 2D KTX (1.1) file with 2 mip levels of a 2x2 RGBA8 texture
+std::vector<uint8_t> createKtx() {
+  const uint8_t identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+  std::vector<uint8_t> data(identifier, identifier + sizeof(identifier));
+  // endianness, GL_UNSIGNED_BYTE, GL_RGBA, GL_RGBA8, GL_RGBA, 2x2, 1 face, 2 mip levels
+  for (const uint32_t value : {0x04030201u,
+                               0x1401u,
+                               1u,
+                               0x1908u,
+                               0x8058u,
+                               0x1908u,
+                               2u,
+                               2u,
+                               0u,
+                               0u,
+                               1u,
+                               2u,
+                               0u}) {
+    append(data, value);
+  }
+  append<uint32_t>(data, 16);
+  data.insert(data.end(), 16, 0);
+  append<uint32_t>(data, 4);
+  data.insert(data.end(), 4, 1);
+  return data;
+}
+
+std::string writeFile(const char* name, const std::vector<uint8_t>& data) {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+  return path.string();
+}
+
+class FakeTranscoder final : public iglu::texturetranscoder::ITranscoder {
+ public:
+  [[nodiscard]] bool canTranscode(const iglu::texturetranscoder::Ktx2File& /*file*/,
+                                  TextureFormat format) const override {
+    return format == TextureFormat::RGBA_UNorm8;
+  }
+  bool transcode(const iglu::texturetranscoder::Ktx2File& file,
+                 uint32_t mipLevel,
+                 TextureFormat /*format*/,
+                 std::vector<uint8_t>& outData) const override {
+    const uint32_t size = std::max(file.width >> mipLevel, 1u);
+    outData.assign(size * size * 4, 0xFF);
+    return true;
+  }
+};
+} // namespace
+
+//
+// TextureTranscoderTest
+//
+// Test fixture for all the tests in this file. Takes care of common
+// initialization and allocating of common resources.
+//
+class TextureTranscoderTest : public ::testing::Test {
+ public:
+  TextureTranscoderTest() = default;
+  ~TextureTranscoderTest() override = default;
+
+  //
+  // SetUp()
+  // Create device, commandQueue
+  //
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+  void TearDown() override {}
+
+  // Member variables
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+};
+
+//
+// ParseKtx2 Test
+//
+// Header fields and level data are read from KTX2 files; other files are rejected
+//
+TEST_F(TextureTranscoderTest, ParseKtx2) {
+  iglu::texturetranscoder::Ktx2File file;
+  auto result = iglu::texturetranscoder::parseKtx2(
+      createKtx2(kVkFormatRGBA8, iglu::texturetranscoder::Ktx2Supercompression::None), file);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(file.getFormat(), TextureFormat::RGBA_UNorm8);
+  ASSERT_EQ(file.width, 2u);
+  ASSERT_EQ(file.height, 2u);
+  ASSERT_EQ(file.levels.size(), 2u);
+  ASSERT_EQ(file.levels[0].byteLength, 16u);
+  ASSERT_EQ(file.getLevelData(1)[0], 1u);
+
+  std::vector<uint8_t> invalid(128, 0);
+  result = iglu::texturetranscoder::parseKtx2(std::move(invalid), file);
+  ASSERT_FALSE(result.isOk());
+
+  auto truncated = createKtx2(kVkFormatRGBA8, iglu::texturetranscoder::Ktx2Supercompression::None);
+  truncated.resize(truncated.size() - 1);
+  result = iglu::texturetranscoder::parseKtx2(std::move(truncated), file);
+  ASSERT_FALSE(result.isOk());
+}
+
+//
+// NativeFormat Test
+//
+// Formats the device can sample are uploaded without transcoding
+//
+TEST_F(TextureTranscoderTest, NativeFormat) {
+  const iglu::texturetranscoder::TextureTranscoder transcoder({});
+  iglu::texturetranscoder::TranscodedTexture texture;
+  const auto result = transcoder.transcode(
+      *iglDev_,
+      createKtx2(kVkFormatRGBA8, iglu::texturetranscoder::Ktx2Supercompression::None),
+      texture);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(texture.desc.format, TextureFormat::RGBA_UNorm8);
+  ASSERT_EQ(texture.desc.numMipLevels, 2u);
+  ASSERT_EQ(texture.mipLevels[1].size(), 4u);
+
+  Result createResult;
+  auto gpuTexture =
+      iglu::texturetranscoder::TextureTranscoder::createTexture(*iglDev_, texture, &createResult);
+  ASSERT_TRUE(createResult.isOk()) << createResult.message;
+  ASSERT_NE(gpuTexture, nullptr);
+  ASSERT_EQ(gpuTexture->getNumMipLevels(), 2u);
+}
+
+//
+// Transcode Test
+//
+// Basis Universal textures need a transcoder and use the first supported target format
+//
+TEST_F(TextureTranscoderTest, Transcode) {
+  const auto basis =
+      createKtx2(kVkFormatUndefined, iglu::texturetranscoder::Ktx2Supercompression::BasisLZ);
+  iglu::texturetranscoder::TranscodedTexture texture;
+  {
+    const iglu::texturetranscoder::TextureTranscoder transcoder({});
+    ASSERT_EQ(transcoder.transcode(*iglDev_, basis, texture).code, Result::Code::Unsupported);
+  }
+
+  const iglu::texturetranscoder::TextureTranscoder transcoder(
+      {}, std::make_shared<FakeTranscoder>());
+  const auto result = transcoder.transcode(*iglDev_, basis, texture);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(texture.desc.format, TextureFormat::RGBA_UNorm8);
+  ASSERT_EQ(texture.mipLevels[0].size(), 16u);
+  ASSERT_EQ(texture.mipLevels[0][0], 0xFF);
+}
+
+//
+// MappedKtxFile Test
+//
+// KTX and KTX2 files are mapped and uploaded without transcoding; other files are rejected
+//
+TEST_F(TextureTranscoderTest, MappedKtxFile) {
+  for (const auto& [name, data] : {
+           std::make_pair("igl_mapped_ktx_test.ktx", createKtx()),
+           std::make_pair(
+               "igl_mapped_ktx_test.ktx2",
+               createKtx2(kVkFormatRGBA8, iglu::texturetranscoder::Ktx2Supercompression::None)),
+       }) {
+    const std::string path = writeFile(name, data);
+    Result result;
+    const auto file = iglu::texturetranscoder::MappedKtxFile::open(path, &result);
+    ASSERT_TRUE(result.isOk()) << result.message;
+    ASSERT_NE(file, nullptr);
+
+    const TextureDesc desc = file->getTextureDesc();
+    ASSERT_EQ(desc.type, TextureType::TwoD);
+    ASSERT_EQ(desc.format, TextureFormat::RGBA_UNorm8);
+    ASSERT_EQ(desc.width, 2u);
+    ASSERT_EQ(desc.height, 2u);
+    ASSERT_EQ(desc.numMipLevels, 2u);
+
+    const auto texture = file->createTexture(*iglDev_, &result);
+    ASSERT_TRUE(result.isOk()) << result.message;
+    ASSERT_NE(texture, nullptr);
+    ASSERT_EQ(texture->getNumMipLevels(), 2u);
+
+    // the level index points past the end of the file
+    auto truncated = data;
+    truncated.resize(truncated.size() - 1);
+    ASSERT_EQ(iglu::texturetranscoder::MappedKtxFile::open(writeFile(name, truncated), &result),
+              nullptr);
+    ASSERT_FALSE(result.isOk());
+    std::filesystem::remove(path);
+  }
+
+  // Basis Universal files have to be transcoded
+  const std::string basisPath = writeFile(
+      "igl_mapped_ktx_test_basis.ktx2",
+      createKtx2(kVkFormatUndefined, iglu::texturetranscoder::Ktx2Supercompression::BasisLZ));
+  Result result;
+  ASSERT_EQ(iglu::texturetranscoder::MappedKtxFile::open(basisPath, &result), nullptr);
+  ASSERT_EQ(result.code, Result::Code::Unsupported);
+  std::filesystem::remove(basisPath);
+
+  ASSERT_EQ(iglu::texturetranscoder::MappedKtxFile::open(
+                (std::filesystem::temp_directory_path() / "igl_missing.ktx2").string(), &result),
+            nullptr);
+  ASSERT_EQ(result.code, Result::Code::RuntimeError);
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/uniform/BlockLayout.h>
+#include <cstring>
+#include <gtest/gtest.h>
+
+namespace iglu {
+namespace tests {
+
+using uniform::BlockLayout;
+using uniform::LayoutRule;
+
+namespace {
+
+using Std140Block = BlockLayout<LayoutRule::Std140,
+                                glm::vec3,
+                                float,
+                                glm::mat3,
+                                float[3],
+                                glm::vec2,
+                                bool,
+                                glm::mat2,
+                                glm::vec3[2],
+                                int>;
+static_assert(Std140Block::offset<0>() == 0);
+// a scalar fills the end of a vec3
+static_assert(Std140Block::offset<1>() == 12);
+static_assert(Std140Block::offset<2>() == 16);
+static_assert(Std140Block::offset<3>() == 64);
+// the array elements are 16 bytes apart
+static_assert(Std140Block::offset<4>() == 112);
+static_assert(Std140Block::offset<5>() == 120);
+// the columns of a mat2 are 16 bytes apart
+static_assert(Std140Block::offset<6>() == 128);
+static_assert(Std140Block::offset<7>() == 160);
+static_assert(Std140Block::offset<8>() == 192);
+static_assert(Std140Block::kSize == 208);
+
+using Std430Block = BlockLayout<LayoutRule::Std430,
+                                glm::vec3,
+                                float,
+                                glm::mat3,
+                                float[3],
+                                glm::vec2,
+                                bool,
+                                glm::mat2,
+                                glm::vec3[2],
+                                int>;
+static_assert(Std430Block::offset<2>() == 16);
+// arrays of scalars and mat2 columns are packed
+static_assert(Std430Block::offset<3>() == 64);
+static_assert(Std430Block::offset<4>() == 80);
+static_assert(Std430Block::offset<5>() == 88);
+static_assert(Std430Block::offset<6>() == 96);
+static_assert(Std430Block::offset<7>() == 112);
+static_assert(Std430Block::offset<8>() == 144);
+static_assert(Std430Block::kSize == 160);
+
+template<typename T>
+T read(const void* data, size_t offset) {
+  T value;
+  std::memcpy(&value, static_cast<const uint8_t*>(data) + offset, sizeof(T));
+  return value;
+}
+
+igl::BufferArgDesc makeBufferArgDesc(size_t bufferDataSize) {
+  igl::BufferArgDesc desc;
+  desc.name = igl::genNameHandle("Lights");
+  desc.bufferDataSize = bufferDataSize;
+  desc.members = {
+      {igl::genNameHandle("direction"), igl::UniformType::Float3, 0, 1},
+      {igl::genNameHandle("intensity"), igl::UniformType::Float, 12, 1},
+      {igl::genNameHandle("view"), igl::UniformType::Mat4x4, 16, 1},
+      {igl::genNameHandle("colors"), igl::UniformType::Float4, 80, 4},
+  };
+  return desc;
+}
+
+using LightsBlock = BlockLayout<LayoutRule::Std140, glm::vec3, float, glm::mat4, glm::vec4[4]>;
+const std::array<const char*, 4> kLightsNames = {"direction", "intensity", "view", "colors"};
+
+} // namespace
+
+//
+// Set Test
+//
+// Members are written at their offsets, with padded vec3s, matrix columns and array elements
+//
+TEST(UniformBlockLayoutTest, Set) {
+  Std140Block block;
+  ASSERT_EQ(Std140Block::size(), 208u);
+
+  glm::vec3 v3;
+  v3[0] = 1.0f;
+  v3[1] = 2.0f;
+  v3[2] = 3.0f;
+  block.set<0>(v3);
+  block.set<1>(4.0f);
+  ASSERT_EQ(read<float>(block.data(), 0), 1.0f);
+  ASSERT_EQ(read<float>(block.data(), 8), 3.0f);
+  ASSERT_EQ(read<float>(block.data(), 12), 4.0f);
+
+  glm::mat3 m3(1.0f);
+  m3[2][1] = 5.0f;
+  block.set<2>(m3);
+  ASSERT_EQ(read<float>(block.data(), 16), 1.0f);
+  ASSERT_EQ(read<float>(block.data(), 16 + 16 + 4), 1.0f);
+  ASSERT_EQ(read<float>(block.data(), 16 + 32 + 4), 5.0f);
+  ASSERT_EQ(read<float>(block.data(), 16 + 32 + 8), 1.0f);
+
+  const float values[] = {6.0f, 7.0f};
+  block.setArray<3>(values, 2, 1);
+  ASSERT_EQ(read<float>(block.data(), 64), 0.0f);
+  ASSERT_EQ(read<float>(block.data(), 64 + 16), 6.0f);
+  ASSERT_EQ(read<float>(block.data(), 64 + 32), 7.0f);
+
+  block.set<5>(true);
+  ASSERT_EQ(read<uint32_t>(block.data(), 120), 1u);
+
+  glm::mat2 m2(2.0f);
+  block.set<6>(m2);
+  ASSERT_EQ(read<float>(block.data(), 128), 2.0f);
+  ASSERT_EQ(read<float>(block.data(), 128 + 16 + 4), 2.0f);
+
+  block.set<7>(v3, 1);
+  ASSERT_EQ(read<float>(block.data(), 160 + 16 + 4), 2.0f);
+  block.set<8>(-1);
+  ASSERT_EQ(read<int>(block.data(), 192), -1);
+
+  // the columns of a std430 mat2 are packed
+  Std430Block packed;
+  packed.set<6>(m2);
+  ASSERT_EQ(read<float>(packed.data(), 96 + 8 + 4), 2.0f);
+}
+
+//
+// Verify Test
+//
+// The layout is checked against the reflection of a shader block
+//
+TEST(UniformBlockLayoutTest, Verify) {
+  ASSERT_TRUE(LightsBlock::verify(makeBufferArgDesc(144), kLightsNames).isOk());
+
+  // the buffer is too small
+  ASSERT_EQ(LightsBlock::verify(makeBufferArgDesc(128), kLightsNames).code,
+            igl::Result::Code::ArgumentInvalid);
+
+  // Metal pads the float3
+  igl::BufferArgDesc desc = makeBufferArgDesc(160);
+  desc.members[1].offset = 16;
+  ASSERT_EQ(LightsBlock::verify(desc, kLightsNames).code, igl::Result::Code::ArgumentInvalid);
+
+  desc = makeBufferArgDesc(144);
+  desc.members[3].arrayLength = 3;
+  ASSERT_EQ(LightsBlock::verify(desc, kLightsNames).code, igl::Result::Code::ArgumentInvalid);
+
+  desc = makeBufferArgDesc(144);
+  desc.members[2].type = igl::UniformType::Mat3x3;
+  ASSERT_EQ(LightsBlock::verify(desc, kLightsNames).code, igl::Result::Code::ArgumentInvalid);
+
+  // unknown member types are not checked
+  desc.members[2].type = igl::UniformType::Invalid;
+  ASSERT_TRUE(LightsBlock::verify(desc, kLightsNames).isOk());
+
+  ASSERT_EQ(LightsBlock::verify(desc, {"direction", "intensity", "view", "color"}).code,
+            igl::Result::Code::ArgumentInvalid);
+}
+
+} // namespace tests
+} // namespace iglu
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/managedUniformBuffer/UniformBufferArena.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl {
+namespace tests {
+
+//
+// UniformBufferArenaTest
+//
+// Test fixture for all the tests in this file. Takes care of common
+// initialization and allocating of common resources.
+//
+class UniformBufferArenaTest : public ::testing::Test {
+ public:
+  UniformBufferArenaTest() = default;
+  ~UniformBufferArenaTest() override = default;
+
+  //
+  // SetUp()
+  // Create device, commandQueue
+  //
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    ASSERT_TRUE(iglDev_->getFeatureLimits(DeviceFeatureLimits::UniformBufferOffsetAlignment,
+                                          alignment_));
+    ASSERT_GT(alignment_, 0u);
+  }
+
+  void TearDown() override {}
+
+  // Member variables
+ public:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  size_t alignment_ = 0;
+};
+
+//
+// AlignedSlices Test
+//
+// Slices are aligned and packed into one buffer until it is full
+//
+TEST_F(UniformBufferArenaTest, AlignedSlices) {
+  iglu::UniformBufferArena arena(*iglDev_, 4 * alignment_);
+  ASSERT_TRUE(arena.result.isOk()) << arena.result.message;
+
+  const uint8_t data[16] = {};
+  const auto slice0 = arena.allocate(data, sizeof(data));
+  const auto slice1 = arena.allocate(data, sizeof(data));
+  ASSERT_TRUE(slice0.buffer != nullptr);
+  ASSERT_EQ(slice0.buffer, slice1.buffer);
+  ASSERT_EQ(slice0.offset, 0u);
+  ASSERT_EQ(slice1.offset, alignment_);
+  ASSERT_EQ(arena.getNumBuffers(), 1u);
+}
+
+//
+// Overflow Test
+//
+// A full buffer continues in a new buffer, and all buffers are reused by the next frame
+//
+TEST_F(UniformBufferArenaTest, Overflow) {
+  iglu::UniformBufferArena arena(*iglDev_, 2 * alignment_);
+  ASSERT_TRUE(arena.result.isOk()) << arena.result.message;
+
+  const uint8_t data[16] = {};
+  std::vector<iglu::UniformBufferArena::Slice> slices;
+  for (int frame = 0; frame != 2; frame++) {
+    arena.beginFrame();
+    for (int i = 0; i != 3; i++) {
+      slices.push_back(arena.allocate(data, sizeof(data)));
+      ASSERT_TRUE(slices.back().buffer != nullptr);
+    }
+    ASSERT_EQ(arena.getNumBuffers(), 2u);
+  }
+  ASSERT_EQ(slices[0].buffer, slices[1].buffer);
+  ASSERT_NE(slices[1].buffer, slices[2].buffer);
+  ASSERT_EQ(slices[2].offset, 0u);
+  // the second frame reuses the slices of the first one
+  for (size_t i = 0; i != 3; i++) {
+    ASSERT_EQ(slices[i].buffer, slices[i + 3].buffer);
+    ASSERT_EQ(slices[i].offset, slices[i + 3].offset);
+  }
+}
+
+} // namespace tests
+} // namespace igl
@@ -273,5 +273,31 @@ TEST_F(UniformDescriptorTest, DescriptorVector) {
   TestUniformData(mat4Vector, mat4Uniform);
 }
 
+//
+// Version Test
+//
+// Versions change on every non-const access and are unique across descriptors
+//
+TEST_F(UniformDescriptorTest, Version) {
+  uniform::DescriptorValue<float> floatUniform(1.0f);
+  uniform::DescriptorVector<glm::vec4> vec4Uniform(std::vector<glm::vec4>(2));
+  ASSERT_NE(floatUniform.getVersion(), vec4Uniform.getVersion());
+
+  const auto floatVersion = floatUniform.getVersion();
+  const auto& constFloatUniform = floatUniform;
+  ASSERT_EQ(*constFloatUniform, 1.0f);
+  ASSERT_EQ(floatUniform.getVersion(), floatVersion);
+  *floatUniform = 2.0f;
+  ASSERT_NE(floatUniform.getVersion(), floatVersion);
+
+  const auto vec4Version = vec4Uniform.getVersion();
+  (*vec4Uniform)[1] = glm::vec4(1.0f);
+  ASSERT_NE(vec4Uniform.getVersion(), vec4Version);
+
+  const auto markedVersion = vec4Uniform.getVersion();
+  vec4Uniform.markDirty();
+  ASSERT_NE(vec4Uniform.getVersion(), markedVersion);
+}
+
 } // namespace tests
 } // namespace iglu
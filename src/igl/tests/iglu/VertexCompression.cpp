@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/vertex_compression/VertexCompression.h>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace iglu {
+namespace tests {
+
+using vertexcompression::CompressedVertices;
+using vertexcompression::PositionFormat;
+using vertexcompression::VertexStreams;
+
+namespace {
+
+struct Vertex {
+  float position[3];
+  float normal[3];
+  float uv[2];
+};
+
+// The vertices of a UV sphere of 'radius' centered at 'center'
+std::vector<Vertex> makeSphere(float radius, const float* center) {
+  constexpr uint32_t kSegments = 16;
+  const float pi = std::acos(-1.0f);
+  std::vector<Vertex> vertices;
+  for (uint32_t y = 0; y <= kSegments; y++) {
+    for (uint32_t x = 0; x <= kSegments; x++) {
+      const float u = float(x) / kSegments;
+      const float v = float(y) / kSegments;
+      const float n[3] = {std::cos(2 * pi * u) * std::sin(pi * v),
+                          std::cos(pi * v),
+                          std::sin(2 * pi * u) * std::sin(pi * v)};
+      vertices.push_back({{center[0] + radius * n[0],
+                           center[1] + radius * n[1],
+                           center[2] + radius * n[2]},
+                          {n[0], n[1], n[2]},
+                          {u, 2.0f * v}});
+    }
+  }
+  return vertices;
+}
+
+VertexStreams getStreams(const std::vector<Vertex>& vertices) {
+  VertexStreams streams;
+  streams.vertexCount = vertices.size();
+  streams.positions = vertices[0].position;
+  streams.positionStride = sizeof(Vertex);
+  streams.normals = vertices[0].normal;
+  streams.normalStride = sizeof(Vertex);
+  streams.uvs = vertices[0].uv;
+  streams.uvStride = sizeof(Vertex);
+  return streams;
+}
+
+void expectClose(const std::vector<Vertex>& vertices,
+                 const CompressedVertices& compressed,
+                 float positionTolerance) {
+  std::vector<float> positions(3 * vertices.size());
+  std::vector<float> normals(3 * vertices.size());
+  std::vector<float> uvs(2 * vertices.size());
+  vertexcompression::decompress(compressed, positions.data(), normals.data(), uvs.data());
+  for (size_t i = 0; i != vertices.size(); i++) {
+    for (int c = 0; c != 3; c++) {
+      ASSERT_NEAR(positions[3 * i + c], vertices[i].position[c], positionTolerance);
+      ASSERT_NEAR(normals[3 * i + c], vertices[i].normal[c], 1e-3f);
+    }
+    for (int c = 0; c != 2; c++) {
+      ASSERT_NEAR(uvs[2 * i + c], vertices[i].uv[c], 1e-4f);
+    }
+  }
+}
+
+} // namespace
+
+//
+// Snorm16 Test
+//
+// Positions relative to the bounding box keep 16 bits of precision away from the origin
+//
+TEST(VertexCompressionTest, Snorm16) {
+  const float center[3] = {100.0f, -50.0f, 10.0f};
+  const std::vector<Vertex> vertices = makeSphere(2.0f, center);
+
+  const CompressedVertices compressed = vertexcompression::compress(getStreams(vertices));
+  ASSERT_EQ(compressed.vertexCount, vertices.size());
+  ASSERT_EQ(compressed.stride, 16);
+  ASSERT_EQ(compressed.data.size(), compressed.vertexCount * compressed.stride);
+  ASSERT_LE(compressed.data.size() * 2, vertices.size() * sizeof(Vertex));
+  expectClose(vertices, compressed, 1e-4f);
+
+  const igl::VertexInputStateDesc desc = compressed.getVertexInputStateDesc(0, 1);
+  ASSERT_EQ(desc.numAttributes, 3);
+  ASSERT_EQ(desc.attributes[0].format, igl::VertexAttributeFormat::Short4Norm);
+  ASSERT_EQ(desc.attributes[1].format, igl::VertexAttributeFormat::Short2Norm);
+  ASSERT_EQ(desc.attributes[1].offset, compressed.getNormalOffset());
+  ASSERT_EQ(desc.attributes[2].format, igl::VertexAttributeFormat::UShort2Norm);
+  ASSERT_EQ(desc.attributes[2].offset, compressed.getUVOffset());
+  ASSERT_EQ(desc.attributes[2].location, 3);
+  ASSERT_EQ(desc.numInputBindings, 1);
+  ASSERT_EQ(desc.inputBindings[0].stride, compressed.stride);
+}
+
+//
+// HalfFloat Test
+//
+// Half-float positions need no dequantization and have no normals or UVs without the streams
+//
+TEST(VertexCompressionTest, HalfFloat) {
+  const float center[3] = {};
+  const std::vector<Vertex> vertices = makeSphere(1.0f, center);
+  VertexStreams streams = getStreams(vertices);
+  streams.normals = nullptr;
+  streams.uvs = nullptr;
+
+  const CompressedVertices compressed =
+      vertexcompression::compress(streams, PositionFormat::HalfFloat);
+  ASSERT_EQ(compressed.stride, 8);
+  ASSERT_FALSE(compressed.hasNormals);
+  ASSERT_FALSE(compressed.hasUVs);
+
+  std::vector<float> positions(3 * vertices.size());
+  vertexcompression::decompress(compressed, positions.data(), nullptr, nullptr);
+  for (size_t i = 0; i != vertices.size(); i++) {
+    for (int c = 0; c != 3; c++) {
+      // 11 bits of precision
+      ASSERT_NEAR(positions[3 * i + c], vertices[i].position[c], 1e-3f);
+    }
+  }
+  ASSERT_EQ(compressed.getVertexInputStateDesc().attributes[0].format,
+            igl::VertexAttributeFormat::HalfFloat4);
+}
+
+//
+// Serialize Test
+//
+// The encoded vertices round trip and corrupted data is rejected
+//
+TEST(VertexCompressionTest, Serialize) {
+  const float center[3] = {1.0f, 2.0f, 3.0f};
+  const std::vector<Vertex> vertices = makeSphere(5.0f, center);
+  const CompressedVertices compressed = vertexcompression::compress(getStreams(vertices));
+
+  const std::vector<uint8_t> data = vertexcompression::serialize(compressed);
+  ASSERT_LT(data.size(), compressed.data.size());
+
+  CompressedVertices deserialized;
+  ASSERT_TRUE(vertexcompression::deserialize(data.data(), data.size(), deserialized));
+  ASSERT_EQ(deserialized.data, compressed.data);
+  ASSERT_EQ(deserialized.stride, compressed.stride);
+  ASSERT_TRUE(deserialized.hasNormals && deserialized.hasUVs);
+  expectClose(vertices, deserialized, 1e-3f);
+
+  ASSERT_FALSE(vertexcompression::deserialize(data.data(), data.size() - 1, deserialized));
+  ASSERT_EQ(deserialized.vertexCount, 0);
+  std::vector<uint8_t> corrupted = data;
+  corrupted[0] ^= 0xff;
+  ASSERT_FALSE(vertexcompression::deserialize(corrupted.data(), corrupted.size(), deserialized));
+}
+
+} // namespace tests
+} // namespace iglu
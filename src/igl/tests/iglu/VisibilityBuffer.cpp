@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+#include "../util/TestDevice.h"
+#include <IGLU/glsl/Versions.h>
+#include <IGLU/simdtypes/SimdUtilities.h>
+#include <IGLU/simple_renderer/VisibilityBufferPass.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace iglu {
+namespace tests {
+
+using namespace simdtypes;
+using namespace renderpass;
+
+namespace {
+
+// a right-handed perspective projection looking down -Z, with OpenGL depth
+float4x4 makeProjection(float fovY, float aspectRatio, float nearZ, float farZ) {
+  const float f = 1.0f / std::tan(0.5f * fovY);
+  return float4x4(float4{f / aspectRatio, 0.0f, 0.0f, 0.0f},
+                  float4{0.0f, f, 0.0f, 0.0f},
+                  float4{0.0f, 0.0f, (farZ + nearZ) / (nearZ - farZ), -1.0f},
+                  float4{0.0f, 0.0f, 2.0f * farZ * nearZ / (nearZ - farZ), 0.0f});
+}
+
+// the barycentrics of the point with the world space barycentrics 'lambda' where it is projected
+void computeAt(const float4 clip[3],
+               const float lambda[3],
+               const float ndcPerPixel[2],
+               float3& outBarycentrics,
+               float3& outDx,
+               float3& outDy) {
+  float4 point = float4{0.0f, 0.0f, 0.0f, 0.0f};
+  for (int k = 0; k != 3; k++) {
+    for (int c = 0; c != 4; c++) {
+      point[c] += lambda[k] * clip[k][c];
+    }
+  }
+  const float ndc[2] = {point[0] / point[3], point[1] / point[3]};
+  computeVisibilityBarycentrics(clip, ndc, ndcPerPixel, outBarycentrics, outDx, outDy);
+}
+
+// turned around Y and moved
+float4x4 makeModel(float angle, float tx, float ty, float tz) {
+  const float c = std::cos(angle);
+  const float s = std::sin(angle);
+  return float4x4(float4{c, 0.0f, -s, 0.0f},
+                  float4{0.0f, 1.0f, 0.0f, 0.0f},
+                  float4{s, 0.0f, c, 0.0f},
+                  float4{tx, ty, tz, 1.0f});
+}
+
+// resolve shaders writing the barycentrics and the instance of each pixel
+const char kGlslResolveBarycentrics[] = R"(
+layout(location = 0) out vec4 outColor;
+void main() {
+  VisibilitySample s;
+  if (!loadVisibilitySample(gl_FragCoord.xy, s)) {
+    outColor = vec4(0.0);
+    return;
+  }
+  outColor = vec4(s.barycentrics, float(s.instanceIndex + 1u) / 255.0);
+}
+)";
+
+const char kMetalResolveBarycentrics[] = R"(
+fragment float4 resolveBarycentrics(float4 position [[position]], VISIBILITY_BUFFER_PARAMS) {
+  VisibilityBuffer vb = VISIBILITY_BUFFER_ARGS;
+  VisibilitySample s;
+  if (!loadVisibilitySample(vb, visibilityIds, position.xy, s)) {
+    return float4(0.0);
+  }
+  return float4(s.barycentrics, float(s.instanceIndex + 1) / 255.0);
+}
+)";
+
+} // namespace
+
+class VisibilityBufferPassTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    igl::setDebugBreakEnabled(false);
+    igl::tests::util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+  }
+
+ protected:
+  std::shared_ptr<igl::IDevice> iglDev_;
+  std::shared_ptr<igl::ICommandQueue> cmdQueue_;
+};
+
+//
+// PerspectiveCorrectBarycentrics Test
+//
+// The barycentrics of a pixel interpolate the world space position of the surface it shows, and
+// their changes per pixel lead to the barycentrics of the neighboring pixels
+//
+TEST(VisibilityBufferTest, PerspectiveCorrectBarycentrics) {
+  const float4x4 projection = makeProjection(1.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+  // a triangle receding into the distance, so the perspective matters
+  const float4 world[3] = {float4{-2.0f, -1.0f, -1.5f, 1.0f},
+                           float4{3.0f, -0.5f, -30.0f, 1.0f},
+                           float4{-1.0f, 2.0f, -8.0f, 1.0f}};
+  float4 clip[3];
+  for (int k = 0; k != 3; k++) {
+    clip[k] = multiply(projection, world[k]);
+  }
+  // one pixel of a 1280x720 viewport, top-down like Vulkan and Metal
+  const float ndcPerPixel[2] = {2.0f / 1280.0f, -2.0f / 720.0f};
+
+  for (const auto& lambda : {std::array<float, 3>{0.2f, 0.3f, 0.5f},
+                             std::array<float, 3>{0.8f, 0.1f, 0.1f},
+                             std::array<float, 3>{0.05f, 0.9f, 0.05f}}) {
+    float3 barycentrics, dx, dy;
+    computeAt(clip, lambda.data(), ndcPerPixel, barycentrics, dx, dy);
+    for (int k = 0; k != 3; k++) {
+      ASSERT_NEAR(barycentrics[k], lambda[k], 1e-4f);
+    }
+    ASSERT_NEAR(dx[0] + dx[1] + dx[2], 0.0f, 1e-6f);
+    ASSERT_NEAR(dy[0] + dy[1] + dy[2], 0.0f, 1e-6f);
+
+    // the derivatives step to the barycentrics one pixel to the right and one pixel down
+    float4 point = float4{0.0f, 0.0f, 0.0f, 0.0f};
+    for (int k = 0; k != 3; k++) {
+      for (int c = 0; c != 4; c++) {
+        point[c] += lambda[k] * clip[k][c];
+      }
+    }
+    const float ndc[2] = {point[0] / point[3], point[1] / point[3]};
+    float3 nextX, nextY, unused;
+    const float ndcX[2] = {ndc[0] + ndcPerPixel[0], ndc[1]};
+    computeVisibilityBarycentrics(clip, ndcX, ndcPerPixel, nextX, unused, unused);
+    const float ndcY[2] = {ndc[0], ndc[1] + ndcPerPixel[1]};
+    computeVisibilityBarycentrics(clip, ndcY, ndcPerPixel, nextY, unused, unused);
+    for (int k = 0; k != 3; k++) {
+      ASSERT_NEAR(barycentrics[k] + dx[k], nextX[k], 1e-5f);
+      ASSERT_NEAR(barycentrics[k] + dy[k], nextY[k], 1e-5f);
+    }
+  }
+
+  // the vertices themselves
+  for (int k = 0; k != 3; k++) {
+    float lambda[3] = {0.0f, 0.0f, 0.0f};
+    lambda[k] = 1.0f;
+    float3 barycentrics, dx, dy;
+    computeAt(clip, lambda, ndcPerPixel, barycentrics, dx, dy);
+    for (int j = 0; j != 3; j++) {
+      ASSERT_NEAR(barycentrics[j], lambda[j], 1e-4f);
+    }
+  }
+}
+
+//
+// InstanceTriangleRanges Test
+//
+TEST(VisibilityBufferTest, InstanceTriangleRanges) {
+  std::vector<VisibilityMeshInstance> meshes(4);
+  meshes[0].numIndices = 30;
+  // empty instances share the range of the next one
+  meshes[1].numIndices = 0;
+  meshes[2].firstIndex = 30;
+  meshes[2].numIndices = 6;
+  meshes[2].baseVertex = 12;
+  meshes[2].materialIndex = 3;
+  meshes[3].numIndices = 300;
+  meshes[3].model = float4x4(float4{2.0f, 4.0f, 8.0f, 1.0f});
+
+  std::vector<VisibilityInstance> instances;
+  ASSERT_EQ(buildVisibilityInstances(meshes, instances), 112u);
+  ASSERT_EQ(instances.size(), 4u);
+  ASSERT_EQ(instances[0].firstTriangle, 0u);
+  ASSERT_EQ(instances[1].firstTriangle, 10u);
+  ASSERT_EQ(instances[2].firstTriangle, 10u);
+  ASSERT_EQ(instances[3].firstTriangle, 12u);
+  ASSERT_EQ(instances[2].firstIndex, 30u);
+  ASSERT_EQ(instances[2].baseVertex, 12);
+  ASSERT_EQ(instances[2].materialIndex, 3u);
+
+  const auto find = [&instances](uint32_t triangle) {
+    return findVisibilityInstance(
+        instances.data(), static_cast<uint32_t>(instances.size()), triangle);
+  };
+  ASSERT_EQ(find(0), 0u);
+  ASSERT_EQ(find(9), 0u);
+  ASSERT_EQ(find(10), 2u);
+  ASSERT_EQ(find(11), 2u);
+  ASSERT_EQ(find(12), 3u);
+  ASSERT_EQ(find(111), 3u);
+
+  // the normal matrix undoes the non-uniform scale
+  ASSERT_FLOAT_EQ(instances[3].normalMatrix[0][0], 0.5f);
+  ASSERT_FLOAT_EQ(instances[3].normalMatrix[1][1], 0.25f);
+  ASSERT_FLOAT_EQ(instances[3].normalMatrix[2][2], 0.125f);
+  ASSERT_FLOAT_EQ(instances[0].normalMatrix[1][1], 1.0f);
+  ASSERT_FLOAT_EQ(instances[0].normalMatrix[1][0], 0.0f);
+}
+
+//
+// NormalMatrixOfRotation Test
+//
+// The normal matrix of a rotation and translation is the rotation
+//
+TEST(VisibilityBufferTest, NormalMatrixOfRotation) {
+  const float c = std::cos(0.7f);
+  const float s = std::sin(0.7f);
+  std::vector<VisibilityMeshInstance> meshes(1);
+  // around Z, moved
+  meshes[0].model = float4x4(float4{c, s, 0.0f, 0.0f},
+                             float4{-s, c, 0.0f, 0.0f},
+                             float4{0.0f, 0.0f, 1.0f, 0.0f},
+                             float4{5.0f, -3.0f, 2.0f, 1.0f});
+  std::vector<VisibilityInstance> instances;
+  buildVisibilityInstances(meshes, instances);
+  for (int column = 0; column != 3; column++) {
+    for (int row = 0; row != 3; row++) {
+      ASSERT_NEAR(
+          instances[0].normalMatrix[column][row], meshes[0].model.columns[column][row], 1e-5f);
+    }
+  }
+}
+
+//
+// ResolveMatchesCpuBarycentrics Test
+//
+// The geometry pass finds the visible triangle of each pixel and the resolve pass computes its
+// barycentrics like computeVisibilityBarycentrics()
+//
+TEST_F(VisibilityBufferPassTest, ResolveMatchesCpuBarycentrics) {
+  if (!iglDev_->hasFeature(igl::DeviceFeatures::Compute)) {
+    GTEST_SKIP() << "Compute is not supported";
+  }
+
+  VisibilityBufferConfig config;
+  config.cullMode = igl::CullMode::Disabled;
+  igl::Result result;
+  VisibilityBufferPass pass(*iglDev_, config, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  const VisibilityVertex vertices[3] = {{{-0.8f, -0.8f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}},
+                                        {{0.8f, -0.6f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f}},
+                                        {{0.0f, 0.9f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.5f, 1.0f}}};
+  const uint32_t indices[3] = {0, 1, 2};
+  const auto createStorageBuffer = [this, &result](const void* data, size_t length) {
+    return std::shared_ptr<igl::IBuffer>(
+        iglDev_->createBuffer(igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Storage,
+                                              data,
+                                              length,
+                                              igl::ResourceStorage::Shared),
+                              &result));
+  };
+  VisibilitySceneDesc scene;
+  scene.vertexBuffer = createStorageBuffer(vertices, sizeof(vertices));
+  ASSERT_TRUE(result.isOk()) << result.message;
+  scene.indexBuffer = createStorageBuffer(indices, sizeof(indices));
+  ASSERT_TRUE(result.isOk()) << result.message;
+  // turned away from the camera, so the perspective matters
+  scene.instances.resize(2);
+  scene.instances[0].model = makeModel(0.6f, -0.9f, 0.0f, -3.0f);
+  scene.instances[1].model = makeModel(-0.8f, 0.9f, 0.2f, -4.0f);
+  for (VisibilityMeshInstance& instance : scene.instances) {
+    instance.numIndices = 3;
+  }
+  pass.setScene(scene, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  const auto backendType = iglDev_->getBackendType();
+  const bool isMetal = backendType == igl::BackendType::Metal;
+  std::string source = pass.getShaderSource();
+  if (isMetal) {
+    source += kMetalResolveBarycentrics;
+  } else {
+    if (backendType == igl::BackendType::OpenGL) {
+      source = glsl::getOpenGLVersion(iglDev_->getShaderVersion(), true) + source;
+    }
+    source += kGlslResolveBarycentrics;
+  }
+  pass.setResolveShader(source, isMetal ? "resolveBarycentrics" : "main", &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  constexpr size_t kSize = 32;
+  const std::shared_ptr<igl::ITexture> target = iglDev_->createTexture(
+      igl::TextureDesc::new2D(igl::TextureFormat::RGBA_UNorm8,
+                              kSize,
+                              kSize,
+                              igl::TextureDesc::TextureUsageBits::Attachment |
+                                  igl::TextureDesc::TextureUsageBits::Sampled),
+      &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  igl::FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = target;
+  const std::shared_ptr<igl::IFramebuffer> framebuffer =
+      iglDev_->createFramebuffer(framebufferDesc, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  const float4x4 projection = makeProjection(1.0f, 1.0f, 0.1f, 100.0f);
+  auto cmdBuffer = cmdQueue_->createCommandBuffer({}, &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  pass.render(*cmdBuffer, framebuffer, projection);
+  cmdQueue_->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  std::vector<uint32_t> pixels(kSize * kSize);
+  framebuffer->copyBytesColorAttachment(
+      *cmdQueue_, 0, pixels.data(), igl::TextureRangeDesc::new2D(0, 0, kSize, kSize));
+
+  // the fragment coordinates start at the bottom on OpenGL, and Vulkan reads the rows back
+  // flipped vertically
+  const float flip = backendType == igl::BackendType::OpenGL ? 1.0f : -1.0f;
+  const bool flippedRows = backendType == igl::BackendType::Vulkan;
+  const float ndcPerPixel[2] = {2.0f / kSize, flip * 2.0f / kSize};
+  uint32_t numCovered[2] = {};
+  for (size_t y = 0; y != kSize; y++) {
+    for (size_t x = 0; x != kSize; x++) {
+      const uint32_t pixel = pixels[y * kSize + x];
+      const uint32_t instance = pixel >> 24;
+      if (instance == 0) {
+        continue;
+      }
+      ASSERT_LE(instance, 2u);
+      numCovered[instance - 1]++;
+
+      float4 clip[3];
+      for (int k = 0; k != 3; k++) {
+        const float* position = vertices[k].position;
+        clip[k] = multiply(
+            projection,
+            multiply(scene.instances[instance - 1].model,
+                     float4{position[0], position[1], position[2], 1.0f}));
+      }
+      const float fragY = static_cast<float>(flippedRows ? kSize - 1 - y : y) + 0.5f;
+      const float ndc[2] = {(x + 0.5f) * ndcPerPixel[0] - 1.0f, fragY * ndcPerPixel[1] - flip};
+      float3 barycentrics, dx, dy;
+      computeVisibilityBarycentrics(clip, ndc, ndcPerPixel, barycentrics, dx, dy);
+      for (int c = 0; c != 3; c++) {
+        const float expected = std::clamp(barycentrics[c], 0.0f, 1.0f);
+        const float actual = static_cast<float>((pixel >> (8 * c)) & 0xff) / 255.0f;
+        EXPECT_NEAR(actual, expected, 2.0f / 255.0f) << x << " " << y;
+      }
+    }
+  }
+  ASSERT_GT(numCovered[0], 10u);
+  ASSERT_GT(numCovered[1], 10u);
+}
+
+} // namespace tests
+} // namespace iglu
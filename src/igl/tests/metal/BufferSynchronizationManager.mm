@@ -60,5 +60,20 @@ TEST_F(BufferSynchronizationManagerMTLTest, BufferSynchronizationManagerEndOfFra
   ASSERT_EQ(bufferSyncManager_->getCurrentInFlightBufferIndex(), 1);
 }
 
+TEST_F(BufferSynchronizationManagerMTLTest, InFlightFrameLimit) {
+  ASSERT_EQ(bufferSyncManager_->getInFlightFrameLimit(), IGL_METAL_MAX_IN_FLIGHT_BUFFERS);
+
+  bufferSyncManager_->setInFlightFrameLimit(2);
+  ASSERT_EQ(bufferSyncManager_->getInFlightFrameLimit(), 2);
+  // ring buffers keep rotating through all instances
+  bufferSyncManager_->manageEndOfFrameSync();
+  ASSERT_EQ(bufferSyncManager_->getCurrentInFlightBufferIndex(), 1);
+
+  bufferSyncManager_->setInFlightFrameLimit(0);
+  ASSERT_EQ(bufferSyncManager_->getInFlightFrameLimit(), 1);
+  bufferSyncManager_->setInFlightFrameLimit(IGL_METAL_MAX_IN_FLIGHT_BUFFERS + 1);
+  ASSERT_EQ(bufferSyncManager_->getInFlightFrameLimit(), IGL_METAL_MAX_IN_FLIGHT_BUFFERS);
+}
+
 }
 }
@@ -7,8 +7,16 @@
 
 #include <igl/metal/Device.h>
 
+#include <igl/metal/Buffer.h>
+#include <igl/metal/CommandBuffer.h>
+#include <igl/metal/IndirectCommandBuffer.h>
+#include <igl/metal/Texture.h>
+
+#include "../data/ShaderData.h"
+#include "../util/Common.h"
 #include "../util/TestDevice.h"
 
+#include <filesystem>
 #include <gtest/gtest.h>
 #include <igl/IGL.h>
 
@@ -40,5 +48,211 @@ TEST_F(DeviceMetalTest, GetShaderVersion) {
   ASSERT_GT(iglShaderVersion.minorVersion, 0);
 }
 
+TEST_F(DeviceMetalTest, HeapAllocation) {
+  auto& device = static_cast<metal::Device&>(*iglDev_);
+  if (!device.enableHeapAllocation()) {
+    GTEST_SKIP() << "Heaps are not supported";
+  }
+  ASSERT_NE(device.getHeapAllocator(), nullptr);
+
+  Result res;
+  auto buffer = iglDev_->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Vertex, nullptr, 256, ResourceStorage::Private),
+      &res);
+  ASSERT_TRUE(res.isOk());
+  ASSERT_NE(static_cast<metal::Buffer&>(*buffer).get().heap, nil);
+
+  auto texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                    16,
+                                    16,
+                                    TextureDesc::TextureUsageBits::Sampled |
+                                        TextureDesc::TextureUsageBits::Attachment);
+  texDesc.storage = ResourceStorage::Private;
+  auto texture = iglDev_->createTexture(texDesc, &res);
+  ASSERT_TRUE(res.isOk());
+  ASSERT_NE(static_cast<metal::Texture&>(*texture).get().heap, nil);
+
+  // transient textures of the same frame never alias each other
+  auto transient0 = device.createTransientTexture(texDesc, &res);
+  ASSERT_TRUE(res.isOk());
+  auto transient1 = device.createTransientTexture(texDesc, &res);
+  ASSERT_TRUE(res.isOk());
+  id<MTLTexture> mtlTransient0 = static_cast<metal::Texture&>(*transient0).get();
+  id<MTLTexture> mtlTransient1 = static_cast<metal::Texture&>(*transient1).get();
+  ASSERT_NE(mtlTransient0.heap, nil);
+  ASSERT_EQ(mtlTransient0.heap, mtlTransient1.heap);
+  ASSERT_NE(mtlTransient0.heapOffset, mtlTransient1.heapOffset);
+
+  ASSERT_GT(device.getHeapAllocator()->getAllocatedSize(), 0);
+}
+
+TEST_F(DeviceMetalTest, HeapAllocationUntrackedHazards) {
+  auto& device = static_cast<metal::Device&>(*iglDev_);
+  metal::HeapAllocatorConfig config;
+  config.untrackedHazards = true;
+  if (!device.enableHeapAllocation(config)) {
+    GTEST_SKIP() << "Heaps are not supported";
+  }
+  ASSERT_TRUE(device.getHeapAllocator()->hasUntrackedHazards());
+
+  Result res;
+  auto buffer = iglDev_->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Storage, nullptr, 256, ResourceStorage::Private),
+      &res);
+  ASSERT_TRUE(res.isOk());
+  id<MTLBuffer> mtlBuffer = static_cast<metal::Buffer&>(*buffer).get();
+  ASSERT_NE(mtlBuffer.heap, nil);
+  ASSERT_EQ(mtlBuffer.hazardTrackingMode, MTLHazardTrackingModeUntracked);
+
+  // queues created afterwards fence their passes
+  auto queue = iglDev_->createCommandQueue(CommandQueueDesc{}, &res);
+  ASSERT_TRUE(res.isOk());
+  auto cmdBuffer = queue->createCommandBuffer(CommandBufferDesc{}, &res);
+  ASSERT_TRUE(res.isOk());
+  ASSERT_NE(static_cast<metal::CommandBuffer&>(*cmdBuffer).getPassFence(), nil);
+  for (int i = 0; i != 2; i++) {
+    auto encoder = cmdBuffer->createComputeCommandEncoder();
+    encoder->bindBuffer(0, buffer, 0);
+    encoder->endEncoding();
+  }
+  queue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+}
+
+TEST_F(DeviceMetalTest, RingBufferSubAllocation) {
+  auto& device = static_cast<metal::Device&>(*iglDev_);
+  device.enableRingBufferSubAllocation();
+
+  const uint32_t data0 = 0x01234567;
+  const uint32_t data1 = 0x89abcdef;
+  Result res;
+  auto buffer0 = iglDev_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Uniform,
+                                                  &data0,
+                                                  sizeof(data0),
+                                                  ResourceStorage::Shared,
+                                                  BufferDesc::BufferAPIHintBits::Ring),
+                                       &res);
+  ASSERT_TRUE(res.isOk());
+  auto buffer1 = iglDev_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Uniform,
+                                                  &data1,
+                                                  sizeof(data1),
+                                                  ResourceStorage::Shared,
+                                                  BufferDesc::BufferAPIHintBits::Ring),
+                                       &res);
+  ASSERT_TRUE(res.isOk());
+
+  auto& ring0 = static_cast<metal::Buffer&>(*buffer0);
+  auto& ring1 = static_cast<metal::Buffer&>(*buffer1);
+  ASSERT_EQ(buffer0->getSizeInBytes(), sizeof(data0));
+  ASSERT_EQ(ring0.get(), ring1.get());
+  ASSERT_NE(ring0.getOffset(), ring1.getOffset());
+
+  auto readValue = [](metal::Buffer& buffer) {
+    return *reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(buffer.get().contents) +
+                                              buffer.getOffset());
+  };
+  ASSERT_EQ(readValue(ring0), data0);
+  ASSERT_EQ(readValue(ring1), data1);
+
+  const uint32_t newData = 42;
+  ASSERT_TRUE(buffer1->upload(&newData, BufferRange(sizeof(newData))).isOk());
+  ASSERT_EQ(readValue(ring0), data0);
+  ASSERT_EQ(readValue(ring1), newData);
+}
+
+TEST_F(DeviceMetalTest, CreateIndirectCommandBuffer) {
+  auto& device = static_cast<metal::Device&>(*iglDev_);
+
+  Result res;
+  auto commands = device.createIndirectCommandBuffer({0, false}, &res);
+  ASSERT_EQ(res.code, Result::Code::ArgumentInvalid);
+  ASSERT_EQ(commands, nullptr);
+
+  commands = device.createIndirectCommandBuffer({16, true}, &res);
+  if (res.code == Result::Code::Unsupported) {
+    GTEST_SKIP() << "Indirect command buffers are not supported";
+  }
+  ASSERT_TRUE(res.isOk());
+  ASSERT_NE(commands, nullptr);
+  ASSERT_EQ(commands->getMaxCommandCount(), 16);
+  ASSERT_NE(commands->get(), nil);
+  ASSERT_NE(commands->getArgumentBuffer(), nil);
+
+  const uint16_t indices[] = {0, 1, 2};
+  auto indexBuffer = iglDev_->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Index, indices, sizeof(indices)), &res);
+  ASSERT_TRUE(res.isOk());
+
+  commands->encodeDraw(0, PrimitiveType::Triangle, 0, 3);
+  commands->encodeDrawIndexed(1, PrimitiveType::Triangle, IndexFormat::UInt16, 3, *indexBuffer, 0);
+  commands->encodeDrawIndexed(2, PrimitiveType::Triangle, IndexFormat::UInt16, 3, *indexBuffer, 0);
+  ASSERT_EQ(commands->getIndexBuffers().size(), 1);
+
+  commands->reset();
+  ASSERT_TRUE(commands->getIndexBuffers().empty());
+}
+
+TEST_F(DeviceMetalTest, ShaderLibraryCache) {
+  auto& device = static_cast<metal::Device&>(*iglDev_);
+  device.clearShaderLibraryCache();
+
+  auto libraryDesc = ShaderLibraryDesc::fromStringInput(
+      data::shader::MTL_SIMPLE_SHADER, {{ShaderStage::Vertex, "vertexShader"}}, "");
+  Result res;
+  auto library0 = device.createShaderLibrary(libraryDesc, &res);
+  ASSERT_TRUE(res.isOk());
+  auto library1 = device.createShaderLibrary(libraryDesc, &res);
+  ASSERT_TRUE(res.isOk());
+  ASSERT_NE(library1->getShaderModule("vertexShader"), nullptr);
+  ASSERT_EQ(device.getShaderLibraryCacheSize(), 1u);
+
+  // different compile options compile the source again
+  libraryDesc.input.options.fastMathEnabled = !libraryDesc.input.options.fastMathEnabled;
+  auto library2 = device.createShaderLibrary(libraryDesc, &res);
+  ASSERT_TRUE(res.isOk());
+  ASSERT_EQ(device.getShaderLibraryCacheSize(), 2u);
+
+  device.clearShaderLibraryCache();
+  ASSERT_EQ(device.getShaderLibraryCacheSize(), 0u);
+}
+
+TEST_F(DeviceMetalTest, BinaryArchive) {
+  auto& device = static_cast<metal::Device&>(*iglDev_);
+  const std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "igl_binary_archive_test.metallib";
+  std::filesystem::remove(path);
+
+  ASSERT_FALSE(device.enableBinaryArchive(""));
+  if (!device.enableBinaryArchive(path.string())) {
+    GTEST_SKIP() << "Binary archives are not supported";
+  }
+
+  std::unique_ptr<IShaderStages> stages;
+  util::createSimpleShaderStages(iglDev_, stages);
+  ASSERT_NE(stages, nullptr);
+
+  RenderPipelineDesc desc;
+  desc.shaderStages = std::move(stages);
+  desc.targetDesc.colorAttachments.resize(1);
+  desc.targetDesc.colorAttachments[0].textureFormat = TextureFormat::RGBA_UNorm8;
+  Result res;
+  auto pipeline = iglDev_->createRenderPipeline(desc, &res);
+  ASSERT_TRUE(res.isOk());
+  ASSERT_NE(pipeline, nullptr);
+
+  res = device.serializeBinaryArchive();
+  ASSERT_TRUE(res.isOk()) << res.message;
+  ASSERT_TRUE(std::filesystem::exists(path));
+
+  // the next launch loads the pipeline from the archive
+  auto otherDevice = util::createTestDevice();
+  ASSERT_TRUE(static_cast<metal::Device&>(*otherDevice).enableBinaryArchive(path.string()));
+  pipeline = otherDevice->createRenderPipeline(desc, &res);
+  ASSERT_TRUE(res.isOk());
+  ASSERT_NE(pipeline, nullptr);
+
+  std::filesystem::remove(path);
+}
+
 } // namespace tests
 } // namespace igl
@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <igl/metal/BindlessTable.h>
 #include <igl/metal/DeviceFeatureSet.h>
 
 #include "../util/Common.h"
@@ -62,17 +63,19 @@ TEST_F(DeviceFeatureSetMTLTest, HasFeatureTest) {
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::SRGB), true);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::DrawIndexedIndirect), true);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::ExplicitBinding), true);
+  ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::BufferDeviceAddress),
+            metal::BindlessTable::isSupported(mtlDevice_));
 
   // We currently expect all these to be "false", i.e. NOT available on Metal
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::Multiview), false);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::BindUniform), false);
-  ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::BufferDeviceAddress), false);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::ShaderTextureLodExt), false);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::TextureExternalImage), false);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::TextureArrayExt), false);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::ExplicitBindingExt), false);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::ValidationLayersEnabled), false);
   ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::ExternalMemoryObjects), false);
+  ASSERT_EQ(mtlDeviceFeatureSet.hasFeature(DeviceFeatures::FragmentDensityMap), false);
 }
 
 TEST_F(DeviceFeatureSetMTLTest, HasRequirementTest) {
@@ -92,6 +92,53 @@ TEST_F(RenderCommandEncoderMTLTest, CreateRenderCommandEncoderAll) {
   encoder->endEncoding();
 }
 
+//
+// SkipRedundantBinds
+//
+// Binds which would not change the state of the encoder are not forwarded to Metal
+//
+TEST_F(RenderCommandEncoderMTLTest, SkipRedundantBinds) {
+  TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                           OFFSCREEN_RT_WIDTH,
+                                           OFFSCREEN_RT_HEIGHT,
+                                           TextureDesc::TextureUsageBits::Sampled |
+                                               TextureDesc::TextureUsageBits::Attachment);
+  Result ret;
+  std::shared_ptr<ITexture> offscreenTexture = device_->createTexture(texDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = offscreenTexture;
+  auto framebuffer = device_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto buffer = device_->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Uniform, nullptr, 256, ResourceStorage::Shared), &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  RenderPassDesc rpDesc;
+  rpDesc.colorAttachments.resize(1);
+  auto encoder = commandBuffer_->createRenderCommandEncoder(rpDesc, framebuffer);
+  ASSERT_TRUE(encoder != nullptr);
+  const auto& metalEncoder = static_cast<const metal::RenderCommandEncoder&>(*encoder);
+
+  encoder->bindBuffer(0, BindTarget::kVertex, buffer, 0);
+  encoder->bindTexture(0, BindTarget::kFragment, offscreenTexture.get());
+  ASSERT_EQ(metalEncoder.getNumRedundantBindsSkipped(), 0);
+
+  encoder->bindBuffer(0, BindTarget::kVertex, buffer, 0);
+  encoder->bindTexture(0, BindTarget::kFragment, offscreenTexture.get());
+  ASSERT_EQ(metalEncoder.getNumRedundantBindsSkipped(), 2);
+
+  // other offsets, stages and bytes are bound
+  encoder->bindBuffer(0, BindTarget::kVertex, buffer, 16);
+  encoder->bindBuffer(0, BindTarget::kFragment, buffer, 16);
+  const uint32_t data = 0;
+  encoder->bindBytes(0, BindTarget::kVertex, &data, sizeof(data));
+  encoder->bindBuffer(0, BindTarget::kVertex, buffer, 16);
+  ASSERT_EQ(metalEncoder.getNumRedundantBindsSkipped(), 2);
+
+  encoder->endEncoding();
+}
+
 TEST_F(RenderCommandEncoderMTLTest, ToMTLPrimitiveType) {
   std::vector<std::pair<PrimitiveType, MTLPrimitiveType>> inputAndExpectedList = {
       std::make_pair(PrimitiveType::Line, MTLPrimitiveTypeLine),
@@ -139,7 +186,8 @@ TEST_F(RenderCommandEncoderMTLTest, ToMTLStoreAction) {
   std::vector<std::pair<StoreAction, MTLStoreAction>> inputAndExpectedList = {
       std::make_pair(StoreAction::DontCare, MTLStoreActionDontCare),
       std::make_pair(StoreAction::Store, MTLStoreActionStore),
-      std::make_pair(StoreAction::MsaaResolve, MTLStoreActionMultisampleResolve)};
+      std::make_pair(StoreAction::MsaaResolve, MTLStoreActionMultisampleResolve),
+      std::make_pair(StoreAction::StoreAndMsaaResolve, MTLStoreActionStoreAndMultisampleResolve)};
 
   for (auto inputAndExpected : inputAndExpectedList) {
     auto input = inputAndExpected.first;
@@ -224,6 +224,46 @@ TEST_F(TextureMTLTest, createTextureFromNativePixelBufferWithInvalidFormat) {
   ASSERT_EQ(result.isOk(), false) << result.message.c_str();
 }
 
+TEST_F(TextureMTLTest, createTextureFromNativeIOSurfaceBiPlanar) {
+  CVPixelBufferRef pixelBuffer = nullptr;
+  NSDictionary* bufferAttributes = @{
+    (NSString*)kCVPixelBufferIOSurfacePropertiesKey : @{},
+    (NSString*)kCVPixelBufferMetalCompatibilityKey : @YES,
+  };
+  ASSERT_EQ(CVPixelBufferCreate(kCFAllocatorDefault,
+                                64,
+                                32,
+                                kCVPixelFormatType_420YpCbCr8BiPlanarFullRange,
+                                (__bridge CFDictionaryRef)(bufferAttributes),
+                                &pixelBuffer),
+            kCVReturnSuccess);
+  IOSurfaceRef surface = CVPixelBufferGetIOSurface(pixelBuffer);
+  ASSERT_NE(surface, nullptr);
+
+  auto platformDevice = device_->getPlatformDevice<igl::metal::PlatformDevice>();
+  Result result;
+  auto luma = platformDevice->createTextureFromNativeIOSurface(
+      surface, TextureFormat::R_UNorm8, 0, TextureDesc::TextureUsageBits::Sampled, &result);
+  ASSERT_TRUE(result.isOk()) << result.message.c_str();
+  ASSERT_NE(luma, nullptr);
+  ASSERT_EQ(luma->getDimensions().width, 64u);
+  ASSERT_EQ(luma->getDimensions().height, 32u);
+
+  auto chroma = platformDevice->createTextureFromNativeIOSurface(
+      surface, TextureFormat::RG_UNorm8, 1, TextureDesc::TextureUsageBits::Sampled, &result);
+  ASSERT_TRUE(result.isOk()) << result.message.c_str();
+  ASSERT_NE(chroma, nullptr);
+  ASSERT_EQ(chroma->getDimensions().width, 32u);
+  ASSERT_EQ(chroma->getDimensions().height, 16u);
+
+  auto invalid = platformDevice->createTextureFromNativeIOSurface(
+      surface, TextureFormat::R_UNorm8, 2, TextureDesc::TextureUsageBits::Sampled, &result);
+  ASSERT_FALSE(result.isOk());
+  ASSERT_EQ(invalid, nullptr);
+
+  CVPixelBufferRelease(pixelBuffer);
+}
+
 TEST_F(TextureMTLTest, ConvertTextureFormats) {
   std::vector<TextureFormat> inputFormats = {
     TextureFormat::A_UNorm8,
@@ -366,6 +406,8 @@ TEST_F(TextureMTLTest, ConvertTextureFormats) {
     TextureFormat::R_EAC_UNorm,
     TextureFormat::R_EAC_SNorm,
 #endif
+    TextureFormat::YUV_NV12,
+    TextureFormat::YUV_P010,
   };
 
   for (auto format : invalidTextureFormats) {
@@ -374,5 +416,22 @@ TEST_F(TextureMTLTest, ConvertTextureFormats) {
   }
 }
 
+// Bindless ids are assigned lazily and are unique per texture
+TEST_F(TextureMTLTest, GetTextureIdBindless) {
+  if (!device_->hasFeature(DeviceFeatures::TextureBindless)) {
+    GTEST_SKIP() << "Bindless textures are not supported";
+  }
+
+  Result res;
+  auto otherTexture = device_->createTexture(texDesc_, &res);
+  ASSERT_TRUE(res.isOk());
+
+  const uint64_t id = texture_->getTextureId();
+  ASSERT_NE(id, 0);
+  ASSERT_EQ(id, texture_->getTextureId());
+  ASSERT_NE(otherTexture->getTextureId(), 0);
+  ASSERT_NE(otherTexture->getTextureId(), id);
+}
+
 } // namespace tests
 } // namespace igl
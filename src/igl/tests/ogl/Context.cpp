@@ -5,12 +5,16 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include "../data/ShaderData.h"
 #include "../util/TestDevice.h"
 
+#include <filesystem>
 #include <gtest/gtest.h>
+#include <igl/ShaderCreator.h>
 #include <igl/opengl/Device.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/Shader.h>
 
 #define DUMMY_FILE_NAME "dummy_file_name"
 #define DUMMY_LINE_NUM 0
@@ -198,6 +202,266 @@ TEST_F(ContextOGLTest, StateCacheInvalidateFramebufferCacheWhenSettingGLReadFram
   }
 }
 
+/// Redundant state changes should be dropped by the state cache, but only while it is enabled.
+TEST_F(ContextOGLTest, StateCacheDropsRedundantCalls) {
+  GLuint textureId = 0;
+  context_->genTextures(1, &textureId);
+
+  context_->resetCounters();
+  context_->enableStateCache(true);
+  ASSERT_TRUE(context_->isStateCacheEnabled());
+
+  context_->activeTexture(GL_TEXTURE0);
+  context_->bindTexture(GL_TEXTURE_2D, textureId);
+  context_->enable(GL_BLEND);
+  ASSERT_EQ(context_->getStateCacheSavedCallCount(), 0u);
+
+  context_->activeTexture(GL_TEXTURE0);
+  context_->bindTexture(GL_TEXTURE_2D, textureId);
+  context_->enable(GL_BLEND);
+  ASSERT_EQ(context_->getStateCacheSavedCallCount(), 3u);
+
+  // a different value has to reach GL
+  context_->disable(GL_BLEND);
+  ASSERT_EQ(context_->getStateCacheSavedCallCount(), 3u);
+  GLboolean isBlendEnabled = GL_TRUE;
+  context_->getBooleanv(GL_BLEND, &isBlendEnabled);
+  ASSERT_EQ(isBlendEnabled, GL_FALSE);
+
+  // after invalidation nothing is known about the current state
+  context_->invalidateStateCache();
+  context_->activeTexture(GL_TEXTURE0);
+  ASSERT_EQ(context_->getStateCacheSavedCallCount(), 3u);
+
+  context_->enableStateCache(false);
+  context_->activeTexture(GL_TEXTURE0);
+  ASSERT_EQ(context_->getStateCacheSavedCallCount(), 3u);
+
+  context_->resetCounters();
+  ASSERT_EQ(context_->getStateCacheSavedCallCount(), 0u);
+
+  // Clean up
+  context_->bindTexture(GL_TEXTURE_2D, 0);
+  context_->deleteTextures({textureId});
+}
+
+/// Deleting a bound texture unbinds it, so a new texture reusing the name has to be bound again.
+TEST_F(ContextOGLTest, StateCacheForgetsDeletedTextures) {
+  context_->enableStateCache(true);
+
+  GLuint textureId = 0;
+  context_->genTextures(1, &textureId);
+  context_->activeTexture(GL_TEXTURE0);
+  context_->bindTexture(GL_TEXTURE_2D, textureId);
+  context_->deleteTextures({textureId});
+
+  GLuint newTextureId = 0;
+  context_->genTextures(1, &newTextureId);
+  context_->bindTexture(GL_TEXTURE_2D, newTextureId);
+
+  GLint retrievedTexture = -1;
+  context_->getIntegerv(GL_TEXTURE_BINDING_2D, &retrievedTexture);
+  ASSERT_EQ(newTextureId, retrievedTexture);
+
+  // Clean up
+  context_->bindTexture(GL_TEXTURE_2D, 0);
+  context_->deleteTextures({newTextureId});
+  context_->enableStateCache(false);
+}
+
+/// glBindTextures replaces the bindings of its units, so the state cache has to forget them.
+TEST_F(ContextOGLTest, StateCacheForgetsTexturesBoundWithMultiBind) {
+  if (!context_->deviceFeatures().hasInternalFeature(opengl::InternalFeatures::MultiBind)) {
+    GTEST_SKIP() << "glBindTextures is not supported";
+  }
+  context_->enableStateCache(true);
+
+  GLuint textureIds[2] = {};
+  context_->genTextures(2, textureIds);
+  // glBindTextures needs textures which have been bound to a target before
+  context_->activeTexture(GL_TEXTURE1);
+  context_->bindTexture(GL_TEXTURE_2D, textureIds[1]);
+  context_->bindTexture(GL_TEXTURE_2D, 0);
+  context_->activeTexture(GL_TEXTURE0);
+  context_->bindTexture(GL_TEXTURE_2D, textureIds[0]);
+  context_->bindTextures(0, 1, &textureIds[1]);
+
+  // the cache must not drop this call although it last saw textureIds[0] on unit 0
+  context_->resetCounters();
+  context_->bindTexture(GL_TEXTURE_2D, textureIds[0]);
+  ASSERT_EQ(context_->getStateCacheSavedCallCount(), 0u);
+
+  GLint retrievedTexture = -1;
+  context_->getIntegerv(GL_TEXTURE_BINDING_2D, &retrievedTexture);
+  ASSERT_EQ(textureIds[0], retrievedTexture);
+
+  // Clean up
+  context_->bindTexture(GL_TEXTURE_2D, 0);
+  context_->deleteTextures({textureIds[0], textureIds[1]});
+  context_->enableStateCache(false);
+}
+
+/// Cached vertex array objects are found again for the same bindings and evicted when one of
+/// their buffers or their pipeline goes away.
+TEST_F(ContextOGLTest, VertexArrayCacheEvictsDeletedBuffersAndPipelines) {
+  if (!context_->deviceFeatures().hasInternalFeature(opengl::InternalFeatures::VertexArrayObject)) {
+    GTEST_SKIP() << "Vertex array objects are not supported";
+  }
+
+  GLuint bufferIds[2] = {0, 0};
+  context_->genBuffers(2, bufferIds);
+
+  auto& cache = context_->getVertexArrayCache();
+  cache.clear(*context_);
+
+  const int pipelines[2] = {0, 1};
+  const std::vector<opengl::VertexArrayCache::Binding> bindings0 = {{0, bufferIds[0], 0}};
+  const std::vector<opengl::VertexArrayCache::Binding> bindings1 = {{0, bufferIds[1], 16}};
+
+  const GLuint vao0 = cache.insert(*context_, &pipelines[0], bindings0);
+  const GLuint vao1 = cache.insert(*context_, &pipelines[1], bindings1);
+  ASSERT_NE(vao0, 0u);
+  ASSERT_NE(vao1, 0u);
+  ASSERT_EQ(cache.find(&pipelines[0], bindings0), vao0);
+  ASSERT_EQ(cache.find(&pipelines[1], bindings1), vao1);
+  ASSERT_EQ(cache.find(&pipelines[0], bindings1), 0u);
+
+  context_->deleteBuffers(1, &bufferIds[0]);
+  ASSERT_EQ(cache.find(&pipelines[0], bindings0), 0u);
+  ASSERT_EQ(cache.size(), 1u);
+
+  cache.onPipelineDestroyed(*context_, &pipelines[1]);
+  ASSERT_EQ(cache.size(), 0u);
+
+  // Clean up
+  context_->deleteBuffers(1, &bufferIds[1]);
+}
+
+/// Deferred deletions wait for the end of the frame and the GPU, and respect the per-frame budget.
+TEST_F(ContextOGLTest, DeferredDeletionBatchesDeletions) {
+  context_->enableDeferredDeletion(true, 2);
+
+  GLuint textureIds[2] = {};
+  context_->genTextures(2, textureIds);
+  GLuint bufferId = 0;
+  context_->genBuffers(1, &bufferId);
+  context_->bindBuffer(GL_ARRAY_BUFFER, bufferId);
+  context_->bindBuffer(GL_ARRAY_BUFFER, 0);
+
+  context_->deleteTextures({textureIds[0], textureIds[1]});
+  context_->deleteBuffers(1, &bufferId);
+  ASSERT_EQ(context_->getNumDeferredDeletions(), 3u);
+  ASSERT_TRUE(context_->isBuffer(bufferId));
+
+  // the frame ends and its deletions wait for the GPU, or for a few frames without sync objects
+  for (uint32_t i = 0; i <= opengl::IContext::kDeferredDeletionFrames &&
+                       context_->getNumDeferredDeletions() == 3u;
+       i++) {
+    context_->finish();
+    context_->processDeferredDeletions();
+  }
+  // 2 objects per frame
+  ASSERT_EQ(context_->getNumDeferredDeletions(), 1u);
+  context_->processDeferredDeletions();
+  ASSERT_EQ(context_->getNumDeferredDeletions(), 0u);
+  ASSERT_FALSE(context_->isBuffer(bufferId));
+  ASSERT_FALSE(context_->isTexture(textureIds[0]));
+
+  // disabling deferred deletion deletes the pending objects
+  context_->genBuffers(1, &bufferId);
+  context_->bindBuffer(GL_ARRAY_BUFFER, bufferId);
+  context_->bindBuffer(GL_ARRAY_BUFFER, 0);
+  context_->deleteBuffers(1, &bufferId);
+  ASSERT_EQ(context_->getNumDeferredDeletions(), 1u);
+  context_->enableDeferredDeletion(false);
+  ASSERT_EQ(context_->getNumDeferredDeletions(), 0u);
+  ASSERT_FALSE(context_->isBuffer(bufferId));
+}
+
+/// Transient uniform data is copied at aligned offsets and oversized allocations are rejected.
+TEST_F(ContextOGLTest, UniformArenaAllocatesAlignedRanges) {
+  if (!context_->deviceFeatures().hasFeature(DeviceFeatures::UniformBlocks)) {
+    GTEST_SKIP() << "Uniform blocks are not supported";
+  }
+
+  GLint alignment = 0;
+  context_->getIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  ASSERT_GT(alignment, 0);
+
+  auto& arena = context_->getUniformArena();
+  const std::vector<uint8_t> data(opengl::UniformArena::kMaxAllocationSize + 1, 0xFF);
+
+  GLuint buffer0 = 0, buffer1 = 0;
+  size_t offset0 = 0, offset1 = 0;
+  ASSERT_TRUE(arena.allocate(*context_, data.data(), 20, buffer0, offset0));
+  ASSERT_TRUE(arena.allocate(*context_, data.data(), 20, buffer1, offset1));
+  ASSERT_NE(buffer0, 0u);
+  ASSERT_EQ(buffer0, buffer1);
+  ASSERT_GT(offset1, offset0);
+  ASSERT_EQ(offset0 % alignment, 0u);
+  ASSERT_EQ(offset1 % alignment, 0u);
+
+  ASSERT_FALSE(arena.allocate(*context_, data.data(), 0, buffer0, offset0));
+  ASSERT_FALSE(arena.allocate(*context_, data.data(), data.size(), buffer0, offset0));
+
+  arena.clear(*context_);
+}
+
+/// Linked programs are stored on the first run and loaded instead of linked on the next ones.
+TEST_F(ContextOGLTest, ProgramBinaryCacheStoresAndLoadsPrograms) {
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "igl_program_binary_cache_test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  auto& cache = context_->getProgramBinaryCache();
+  cache.setDirectory(directory.string());
+  if (!cache.isEnabled(*context_)) {
+    cache.setDirectory({});
+    GTEST_SKIP() << "Program binaries are not supported";
+  }
+
+  const auto createStages = [this]() {
+    Result ret;
+    auto stages = ShaderStagesCreator::fromModuleStringInput(*device_,
+                                                             data::shader::OGL_SIMPLE_VERT_SHADER,
+                                                             "main",
+                                                             "",
+                                                             data::shader::OGL_SIMPLE_FRAG_SHADER,
+                                                             "main",
+                                                             "",
+                                                             &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+    return stages;
+  };
+
+  const size_t numLoads = cache.getNumLoads();
+  const size_t numStores = cache.getNumStores();
+
+  auto stages = createStages();
+  ASSERT_TRUE(stages != nullptr);
+  ASSERT_EQ(cache.getNumStores(), numStores + 1);
+  ASSERT_EQ(cache.getNumLoads(), numLoads);
+
+  auto cachedStages = createStages();
+  ASSERT_TRUE(cachedStages != nullptr);
+  ASSERT_NE(static_cast<opengl::ShaderStages&>(*cachedStages).getProgramID(), 0u);
+  ASSERT_EQ(cache.getNumLoads(), numLoads + 1);
+  ASSERT_EQ(cache.getNumStores(), numStores + 1);
+
+  // corrupted binaries are deleted and the program is linked from source
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    std::filesystem::resize_file(entry.path(), 8);
+  }
+  auto relinkedStages = createStages();
+  ASSERT_TRUE(relinkedStages != nullptr);
+  ASSERT_EQ(cache.getNumLoads(), numLoads + 1);
+  ASSERT_EQ(cache.getNumStores(), numStores + 2);
+
+  cache.setDirectory({});
+  std::filesystem::remove_all(directory);
+}
+
 /// This test is a sanity check that we should not have a GL error out of
 /// the blue.
 TEST_F(ContextOGLTest, CheckForErrorsNoError) {
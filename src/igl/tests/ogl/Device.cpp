@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <array>
 #include <gtest/gtest.h>
 #include <igl/IGL.h>
 
@@ -25,6 +26,8 @@
 #include "../util/TestDevice.h"
 #include "../util/TestErrorGuard.h"
 
+#include <igl/opengl/Buffer.h>
+
 namespace igl {
 namespace tests {
 
@@ -359,5 +362,54 @@ TEST_F(DeviceOGLTest, CreateShaderModuleUnknownTypeFails) {
   EXPECT_TRUE(vertShader == nullptr) << "invalid stage to compile should result in null result";
 }
 
+TEST_F(DeviceOGLTest, RingBufferRotatesRegionsAfterUse) {
+  igl::tests::util::TestErrorGuard testErrorGuard;
+
+  const std::array<float, 4> data0 = {0.0f, 1.0f, 2.0f, 3.0f};
+  const std::array<float, 4> data1 = {4.0f, 5.0f, 6.0f, 7.0f};
+
+  Result ret;
+  const BufferDesc desc(BufferDesc::BufferTypeBits::Vertex,
+                        data0.data(),
+                        sizeof(data0),
+                        ResourceStorage::Shared,
+                        BufferDesc::BufferAPIHintBits::Ring);
+  auto buffer = iglDev_->createBuffer(desc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_TRUE(buffer != nullptr);
+  ASSERT_TRUE((buffer->acceptedApiHints() & BufferDesc::BufferAPIHintBits::Ring) != 0);
+
+  auto& arrayBuffer = static_cast<opengl::ArrayBuffer&>(*buffer);
+  const GLuint firstId = arrayBuffer.getId();
+
+  // uploads before the buffer is bound keep writing to the same region
+  ret = buffer->upload(data1.data(), BufferRange(sizeof(data1), 0));
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  ASSERT_EQ(arrayBuffer.getId(), firstId);
+
+  const bool isPersistent =
+      context_->deviceFeatures().hasInternalFeature(opengl::InternalFeatures::BufferStorage);
+
+  // once bound, the next upload has to go somewhere the GPU is not reading from
+  arrayBuffer.bind();
+  arrayBuffer.unbind();
+  ret = buffer->upload(data0.data(), BufferRange(sizeof(float), sizeof(float)));
+  ASSERT_EQ(ret.code, Result::Code::Ok);
+  if (isPersistent) {
+    ASSERT_NE(arrayBuffer.getId(), firstId);
+  } else {
+    ASSERT_EQ(arrayBuffer.getId(), firstId);
+  }
+
+  // cycling through all the regions eventually returns to the first one
+  for (int i = 0; i != 8; i++) {
+    arrayBuffer.bind();
+    arrayBuffer.unbind();
+    ret = buffer->upload(data1.data(), BufferRange(sizeof(data1), 0));
+    ASSERT_EQ(ret.code, Result::Code::Ok);
+  }
+  ASSERT_EQ(arrayBuffer.getId(), firstId);
+}
+
 } // namespace tests
 } // namespace igl
@@ -130,5 +130,45 @@ TEST_F(PlatformDeviceTest, GetEstimatedSizeInBytesExternal) {
   ASSERT_EQ(calcSize(128, 333, TextureFormat::RG_UNorm8), 85248); // 128 * 333 * 2
 }
 
+#if IGL_PLATFORM_ANDROID && IGL_ANDROID_HWBUFFER_SUPPORTED
+//
+// Exports a texture as an AHardwareBuffer and imports the buffer back with the release fence of
+// the exporting side
+//
+TEST_F(PlatformDeviceTest, NativeHWBufferRoundTrip) {
+  auto pd = iglDev_.get()->getPlatformDevice<PLATFORM_DEVICE>();
+  ASSERT_NE(pd, nullptr);
+
+  Result ret;
+  auto exported = pd->createNativeHWBufferTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                         16,
+                         8,
+                         TextureDesc::TextureUsageBits::Sampled |
+                             TextureDesc::TextureUsageBits::Attachment),
+      &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_NE(exported, nullptr);
+  AHardwareBuffer* buffer = pd->getNativeHWBuffer(*exported);
+  ASSERT_NE(buffer, nullptr);
+
+  const int releaseFence = pd->createReleaseFence(&ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+
+  auto imported = pd->createTextureFromNativeHWBuffer(
+      buffer, TextureDesc::TextureUsageBits::Sampled, releaseFence, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_NE(imported, nullptr);
+  ASSERT_EQ(pd->getNativeHWBuffer(*imported), buffer);
+  ASSERT_EQ(imported->getFormat(), TextureFormat::RGBA_UNorm8);
+  ASSERT_EQ(imported->getDimensions().width, 16u);
+  ASSERT_EQ(imported->getDimensions().height, 8u);
+
+  // the imported texture keeps the buffer alive
+  exported = nullptr;
+  ASSERT_EQ(pd->getNativeHWBuffer(*imported), buffer);
+}
+#endif // IGL_PLATFORM_ANDROID && IGL_ANDROID_HWBUFFER_SUPPORTED
+
 } // namespace tests
 } // namespace igl
@@ -12,6 +12,7 @@
 #include <igl/IGL.h>
 #include <igl/opengl/Device.h>
 #include <igl/opengl/RenderPipelineReflection.h>
+#include <igl/opengl/RenderPipelineState.h>
 
 namespace igl::tests {
 
@@ -126,6 +127,17 @@ TEST_F(RenderPipelineReflectionTest, GetNonexistentIndexByName) {
   ASSERT_EQ(index, -1);
 }
 
+TEST_F(RenderPipelineReflectionTest, GetIndexByNameMatchesDictionaries) {
+  ASSERT_FALSE(pipeRef_->getUniformDictionary().empty());
+  for (const auto& entry : pipeRef_->getUniformDictionary()) {
+    ASSERT_EQ(pipeRef_->getIndexByName(entry.first), entry.second.location);
+  }
+  ASSERT_FALSE(pipeRef_->getAttributeDictionary().empty());
+  for (const auto& entry : pipeRef_->getAttributeDictionary()) {
+    ASSERT_EQ(pipeRef_->getIndexByName(igl::genNameHandle(entry.first)), entry.second);
+  }
+}
+
 TEST_F(RenderPipelineReflectionTest, CheckUniformDictionary) {
   ASSERT_EQ(pipeRef_->allUniformBuffers().size(), 1);
   ASSERT_EQ(pipeRef_->allSamplers().size(), 1);
@@ -238,4 +250,44 @@ TEST_F(RenderPipelineReflectionTest, UniformBlocks) {
     }
   }
 }
+
+TEST_F(RenderPipelineReflectionTest, PushConstantsUseReservedUniformBlock) {
+  if (!iglDev_->hasFeature(DeviceFeatures::PushConstants)) {
+    GTEST_SKIP() << "Push constants not supported";
+    return;
+  }
+  auto context = &static_cast<opengl::Device&>(*iglDev_).getContext();
+  bool isGles3 = (opengl::DeviceFeatureSet::usesOpenGLES() &&
+                  context->deviceFeatures().getGLVersion() >= igl::opengl::GLVersion::v3_0_ES);
+  if (!isGles3) {
+    return;
+  }
+  std::unique_ptr<IShaderStages> stages;
+  util::createShaderStages(iglDev_,
+                           data::shader::OGL_SIMPLE_VERT_SHADER_PUSH_CONSTANTS,
+                           "vertexShader",
+                           data::shader::OGL_SIMPLE_FRAG_SHADER_UNIFORM_BLOCKS,
+                           "fragmentShader",
+                           stages);
+  ASSERT_TRUE(stages != nullptr);
+
+  RenderPipelineDesc renderPipelineDesc;
+  renderPipelineDesc.vertexInputState = vertexInputState_;
+  renderPipelineDesc.shaderStages = std::move(stages);
+
+  Result ret;
+  auto pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  auto& glPipelineState = static_cast<opengl::RenderPipelineState&>(*pipelineState);
+  ASSERT_TRUE(glPipelineState.usesPushConstants());
+  ASSERT_EQ(glPipelineState.getUniformBlockBindingPoint(igl::genNameHandle("PushConstants")),
+            opengl::kPushConstantsBindingIndex);
+
+  size_t maxPushConstantBytes = 0;
+  ASSERT_TRUE(iglDev_->getFeatureLimits(DeviceFeatureLimits::MaxPushConstantBytes,
+                                        maxPushConstantBytes));
+  ASSERT_EQ(maxPushConstantBytes, opengl::kMaxPushConstantBytes);
+}
 } // namespace igl::tests
@@ -142,5 +142,41 @@ TEST_F(TextureBufferOGLTest, TextureMipmapGen) {
   ASSERT_EQ(textureBuffer_->getNumMipLevels(), targetlevel);
 }
 
+//
+// TextureBuffer Bindless Texture Id Test
+//
+// Bindless ids are slots in the BindlessTable of the context; the slot of a destroyed texture is
+// reused by the next texture.
+//
+TEST_F(TextureBufferOGLTest, BindlessTextureIds) {
+  if (!device_->hasFeature(DeviceFeatures::TextureBindless)) {
+    GTEST_SKIP() << "ARB_bindless_texture is not supported";
+  }
+  const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                 OFFSCREEN_TEX_WIDTH,
+                                                 OFFSCREEN_TEX_HEIGHT,
+                                                 TextureDesc::TextureUsageBits::Sampled);
+  auto createTexture = [this, &texDesc]() {
+    auto texture = std::make_unique<igl::opengl::TextureBuffer>(*context_, texDesc.format);
+    EXPECT_TRUE(texture->create(texDesc, false).isOk());
+    return texture;
+  };
+
+  auto texture0 = createTexture();
+  auto texture1 = createTexture();
+  const uint64_t id0 = texture0->getTextureId();
+  const uint64_t id1 = texture1->getTextureId();
+  ASSERT_NE(id0, 0u);
+  ASSERT_NE(id1, 0u);
+  ASSERT_NE(id0, id1);
+  ASSERT_EQ(texture0->getTextureId(), id0);
+  ASSERT_TRUE(texture0->hasBindlessHandle());
+
+  texture0 = nullptr;
+  auto texture2 = createTexture();
+  ASSERT_EQ(texture2->getTextureId(), id0);
+  ASSERT_EQ(context_->checkForErrors(__FUNCTION__, __LINE__), GL_NO_ERROR);
+}
+
 } // namespace tests
 } // namespace igl
@@ -16,6 +16,7 @@
 #include <igl/IGL.h>
 #include <igl/NameHandle.h>
 #include <igl/opengl/PlatformDevice.h>
+#include <igl/opengl/UniformAdapter.h>
 #include <string>
 
 // to not use extra curly braces in initializer lists
@@ -1221,5 +1222,37 @@ TEST_F(UniformBufferTest, UniformArrayBinding) {
   }
 }
 
+TEST(UniformValueCacheTest, SkipsUnchangedValues) {
+  opengl::UniformValueCache cache;
+
+  UniformDesc desc;
+  desc.location = 3;
+  desc.type = UniformType::Float4;
+  desc.numElements = 1;
+
+  std::array<float, 4> value = {1.0f, 2.0f, 3.0f, 4.0f};
+  const auto* bytes = reinterpret_cast<const uint8_t*>(value.data());
+
+  ASSERT_TRUE(cache.update(desc, bytes, sizeof(value)));
+  ASSERT_FALSE(cache.update(desc, bytes, sizeof(value)));
+
+  // a different value has to be uploaded
+  value[2] = 5.0f;
+  ASSERT_TRUE(cache.update(desc, bytes, sizeof(value)));
+  ASSERT_FALSE(cache.update(desc, bytes, sizeof(value)));
+
+  // other locations are tracked independently
+  desc.location = 0;
+  ASSERT_TRUE(cache.update(desc, bytes, sizeof(value)));
+
+  // something else wrote to the location
+  desc.location = 3;
+  cache.invalidate(3);
+  ASSERT_TRUE(cache.update(desc, bytes, sizeof(value)));
+
+  cache.clear();
+  ASSERT_TRUE(cache.update(desc, bytes, sizeof(value)));
+}
+
 } // namespace tests
 } // namespace igl
@@ -89,4 +89,38 @@ TEST_F(TextureBufferMacTest, createTextureFromNativePixelBuffer) {
   }
 }
 
+TEST_F(TextureBufferMacTest, createTextureFromNativeIOSurfaceBiPlanar) {
+  CVPixelBufferRef pixelBuffer = nullptr;
+  NSDictionary* bufferAttributes = @{
+    (NSString*)kCVPixelBufferIOSurfacePropertiesKey : @{},
+    (NSString*)kCVPixelBufferOpenGLCompatibilityKey : @YES,
+  };
+  ASSERT_EQ(CVPixelBufferCreate(kCFAllocatorDefault,
+                                64,
+                                32,
+                                kCVPixelFormatType_420YpCbCr8BiPlanarFullRange,
+                                (__bridge CFDictionaryRef)(bufferAttributes),
+                                &pixelBuffer),
+            kCVReturnSuccess);
+  IOSurfaceRef surface = CVPixelBufferGetIOSurface(pixelBuffer);
+  ASSERT_NE(surface, nullptr);
+
+  auto platformDevice = iglDev_->getPlatformDevice<igl::opengl::macos::PlatformDevice>();
+  Result result;
+  auto luma = platformDevice->createTextureFromNativeIOSurface(
+      surface, 0, TextureDesc::TextureUsageBits::Sampled, &result);
+  ASSERT_TRUE(result.isOk()) << result.message.c_str();
+  ASSERT_EQ(luma->getFormat(), TextureFormat::R_UNorm8);
+  ASSERT_EQ(luma->getDimensions().width, 64u);
+
+  auto chroma = platformDevice->createTextureFromNativeIOSurface(
+      surface, 1, TextureDesc::TextureUsageBits::Sampled, &result);
+  ASSERT_TRUE(result.isOk()) << result.message.c_str();
+  ASSERT_EQ(chroma->getFormat(), TextureFormat::RG_UNorm8);
+  ASSERT_EQ(chroma->getDimensions().width, 32u);
+  ASSERT_EQ(chroma->getDimensions().height, 16u);
+
+  CVPixelBufferRelease(pixelBuffer);
+}
+
 } // namespace igl::tests
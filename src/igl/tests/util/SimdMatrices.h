@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/simdtypes/SimdTypes.h>
+
+namespace igl {
+namespace tests {
+namespace util {
+
+// Orthographic projection of the box [-1, 1]^3 into a [0, 1] depth range
+inline iglu::simdtypes::float4x4 makeOrtho() {
+  using iglu::simdtypes::float4;
+  return iglu::simdtypes::float4x4(float4{1.0f, 0.0f, 0.0f, 0.0f},
+                                   float4{0.0f, 1.0f, 0.0f, 0.0f},
+                                   float4{0.0f, 0.0f, 0.5f, 0.0f},
+                                   float4{0.0f, 0.0f, 0.5f, 1.0f});
+}
+
+} // namespace util
+} // namespace tests
+} // namespace igl
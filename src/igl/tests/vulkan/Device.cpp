@@ -8,11 +8,36 @@
 #include <gtest/gtest.h>
 #include <igl/IGL.h>
 
+#include "../data/ShaderData.h"
+#include "../util/Common.h"
 #include "../util/TestDevice.h"
 
+#include <future>
+#include <set>
+#include <thread>
+
 #if IGL_PLATFORM_WIN || IGL_PLATFORM_ANDROID || IGL_PLATFORM_MACOS || IGL_PLATFORM_LINUX
+#include <igl/vulkan/Buffer.h>
+#include <igl/vulkan/CommandBuffer.h>
+#include <igl/vulkan/Device.h>
+#include <igl/vulkan/DeviceGroup.h>
+#include <igl/vulkan/Framebuffer.h>
 #include <igl/vulkan/HWDevice.h>
+#include <igl/vulkan/RenderPipelineState.h>
+#include <igl/vulkan/ResourcesBinder.h>
+#include <igl/vulkan/Texture.h>
+#include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanBufferPool.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDefragmenter.h>
+#include <igl/vulkan/VulkanDescriptorSetAllocator.h>
+#include <igl/vulkan/VulkanDescriptorSetLayout.h>
+#include <igl/vulkan/VulkanImage.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+#include <igl/vulkan/VulkanPipelineBuilder.h>
+#include <igl/vulkan/VulkanRenderPassBuilder.h>
+#include <igl/vulkan/VulkanStagingDevice.h>
+#include <igl/vulkan/VulkanTexture.h>
 #endif
 
 namespace igl {
@@ -39,6 +64,47 @@ class DeviceVulkanTest : public ::testing::Test {
   std::shared_ptr<IDevice> iglDev_;
 };
 
+namespace {
+
+// The validation settings of the tests creating their own VulkanContext
+igl::vulkan::VulkanContextConfig makeTestContextConfig() {
+  igl::vulkan::VulkanContextConfig config;
+#if IGL_PLATFORM_MACOS
+  config.terminateOnValidationError = false;
+#elif IGL_DEBUG
+  config.enableValidation = true;
+  config.terminateOnValidationError = true;
+#else
+  config.enableValidation = true;
+  config.terminateOnValidationError = false;
+#endif
+  config.enableExtraLogs = true;
+  return config;
+}
+
+// Creates a device on the first physical device with `config`. Returns nullptr on failure
+std::shared_ptr<IDevice> createVulkanTestDevice(const igl::vulkan::VulkanContextConfig& config) {
+  auto ctx = igl::vulkan::HWDevice::createContext(config, nullptr);
+
+  Result ret;
+  std::vector<HWDeviceDesc> devices = igl::vulkan::HWDevice::queryDevices(
+      *ctx.get(), HWDeviceQueryDesc(HWDeviceType::Unknown), &ret);
+  if (!ret.isOk() || devices.empty()) {
+    return nullptr;
+  }
+
+  std::shared_ptr<IDevice> iglDev = igl::vulkan::HWDevice::create(std::move(ctx),
+                                                                   devices[0],
+                                                                   0, // width
+                                                                   0, // height,
+                                                                   0,
+                                                                   nullptr,
+                                                                   &ret);
+  return ret.isOk() ? iglDev : nullptr;
+}
+
+} // namespace
+
 /// CreateCommandQueue
 /// Once the backend is more mature, we will use the IGL level test. For now
 /// this is just here as a proof of concept.
@@ -54,52 +120,413 @@ TEST_F(DeviceVulkanTest, CreateCommandQueue) {
 }
 
 #if IGL_PLATFORM_WIN || IGL_PLATFORM_ANDROID || IGL_PLATFORM_MACOS || IGL_PLATFORM_LINUX
-GTEST_TEST(VulkanContext, BufferDeviceAddress) {
-  std::shared_ptr<igl::IDevice> iglDev = nullptr;
+/// PipelineCacheCompatibility
+/// The blob returned by the driver must pass header validation, garbage must not.
+TEST_F(DeviceVulkanTest, PipelineCacheCompatibility) {
+  const auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
 
-  igl::vulkan::VulkanContextConfig config;
-#if IGL_PLATFORM_MACOS
-  config.terminateOnValidationError = false;
-#elif IGL_DEBUG
-  config.enableValidation = true;
-  config.terminateOnValidationError = true;
-#else
-  config.enableValidation = true;
-  config.terminateOnValidationError = false;
-#endif
-  config.enableExtraLogs = true;
-  config.enableBufferDeviceAddress = true;
+  const std::vector<uint8_t> data = ctx.getPipelineCacheData();
+  if (!data.empty()) {
+    ASSERT_TRUE(ctx.isPipelineCacheDataCompatible(data.data(), data.size()));
+    // truncated header
+    ASSERT_FALSE(ctx.isPipelineCacheDataCompatible(data.data(), 4));
+  }
 
-  auto ctx = igl::vulkan::HWDevice::createContext(config, nullptr);
+  std::vector<uint8_t> garbage(64, 0xAB);
+  ASSERT_FALSE(ctx.isPipelineCacheDataCompatible(garbage.data(), garbage.size()));
+  ASSERT_FALSE(ctx.isPipelineCacheDataCompatible(nullptr, 0));
+}
 
+/// SamplerStateCache
+/// Equal descriptors should share a sampler state; different ones should not.
+TEST_F(DeviceVulkanTest, SamplerStateCache) {
   Result ret;
 
-  std::vector<HWDeviceDesc> devices = igl::vulkan::HWDevice::queryDevices(
-      *ctx.get(), HWDeviceQueryDesc(HWDeviceType::Unknown), &ret);
+  auto linear1 = iglDev_->createSamplerState(SamplerStateDesc::newLinear(), &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto linear2 = iglDev_->createSamplerState(SamplerStateDesc::newLinear(), &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto mipmapped = iglDev_->createSamplerState(SamplerStateDesc::newLinearMipmapped(), &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  ASSERT_NE(linear1, nullptr);
+  ASSERT_EQ(linear1, linear2);
+  ASSERT_NE(linear1, mipmapped);
+}
+
+/// DescriptorSetAllocatorGrows
+/// Acquiring more descriptor sets than fit into one pool should create pools instead of waiting.
+TEST_F(DeviceVulkanTest, DescriptorSetAllocatorGrows) {
+  auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
+
+  constexpr uint32_t kNumSetsPerPool = 4;
+
+  igl::vulkan::VulkanDescriptorSetAllocator allocator(
+      ctx.device_->getVkDevice(),
+      ctx.dslBuffersUniform_->getVkDescriptorSetLayout(),
+      VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+      IGL_UNIFORM_BLOCKS_BINDING_MAX,
+      kNumSetsPerPool,
+      "DescriptorSetAllocatorGrows");
+
+  for (uint32_t i = 0; i != 3 * kNumSetsPerPool; i++) {
+    ASSERT_NE(allocator.acquireNext(*ctx.immediate_), VK_NULL_HANDLE);
+  }
+
+  const auto& stats = allocator.getStats();
+  ASSERT_EQ(stats.numAllocatedSets, 3u * kNumSetsPerPool);
+  ASSERT_EQ(stats.numPools, 3u);
+  ASSERT_EQ(stats.numStalls, 0u);
+}
+
+/// CompatibleRenderPasses
+/// Render passes which differ only by their load and store operations share an index; unused ones
+/// are pruned.
+TEST_F(DeviceVulkanTest, CompatibleRenderPasses) {
+  const auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
+
+  // drop the render passes of earlier tests
+  ctx.pruneRenderPasses();
+  ctx.pruneRenderPasses();
+
+  igl::vulkan::VulkanRenderPassBuilder clearBuilder;
+  clearBuilder.addColor(
+      VK_FORMAT_R8G8B8A8_UNORM, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE);
+  igl::vulkan::VulkanRenderPassBuilder loadBuilder;
+  loadBuilder.addColor(VK_FORMAT_R8G8B8A8_UNORM,
+                       VK_ATTACHMENT_LOAD_OP_LOAD,
+                       VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                       VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  igl::vulkan::VulkanRenderPassBuilder otherFormatBuilder;
+  otherFormatBuilder.addColor(
+      VK_FORMAT_R16G16B16A16_SFLOAT, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE);
+
+  const auto clearPass = ctx.findRenderPass(clearBuilder);
+  const auto loadPass = ctx.findRenderPass(loadBuilder);
+  const auto otherFormatPass = ctx.findRenderPass(otherFormatBuilder);
+
+  ASSERT_NE(clearPass.pass, loadPass.pass);
+  ASSERT_EQ(clearPass.index, loadPass.index);
+  ASSERT_NE(clearPass.index, otherFormatPass.index);
+  ASSERT_EQ(ctx.getRenderPass(loadPass.index).pass, clearPass.pass);
+
+  // all of them were used since the last call
+  ASSERT_EQ(ctx.pruneRenderPasses(), 0u);
 
-  ASSERT_TRUE(!devices.empty());
+  // the first render pass of each class is kept
+  ASSERT_EQ(ctx.findRenderPass(clearBuilder).pass, clearPass.pass);
+  ASSERT_EQ(ctx.pruneRenderPasses(), 1u);
+  ASSERT_EQ(ctx.findRenderPass(loadBuilder).index, clearPass.index);
+}
 
-  if (ret.isOk()) {
-    std::vector<const char*> extraDeviceExtensions;
-    iglDev = igl::vulkan::HWDevice::create(std::move(ctx),
-                                           devices[0],
-                                           0, // width
-                                           0, // height,
-                                           0,
-                                           nullptr,
-                                           &ret);
+/// SubpassRenderPasses
+/// A G-buffer subpass followed by a lighting subpass reading it as input attachments.
+TEST_F(DeviceVulkanTest, SubpassRenderPasses) {
+  if (!iglDev_->hasFeature(igl::DeviceFeatures::Subpasses)) {
+    GTEST_SKIP() << "Subpasses are not supported";
+  }
+  const auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
 
-    if (!ret.isOk()) {
-      iglDev = nullptr;
+  const auto makeBuilder = [](bool withSubpasses) {
+    igl::vulkan::VulkanRenderPassBuilder builder;
+    builder
+        .addColor(
+            VK_FORMAT_R8G8B8A8_UNORM, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE)
+        .addColor(VK_FORMAT_R16G16B16A16_SFLOAT,
+                  VK_ATTACHMENT_LOAD_OP_CLEAR,
+                  VK_ATTACHMENT_STORE_OP_DONT_CARE)
+        .addColor(VK_FORMAT_R16G16B16A16_SFLOAT,
+                  VK_ATTACHMENT_LOAD_OP_CLEAR,
+                  VK_ATTACHMENT_STORE_OP_DONT_CARE);
+    if (withSubpasses) {
+      builder.addSubpass({1, 2}, {}, true).addSubpass({0}, {1, 2}, false);
     }
+    return builder;
+  };
+
+  const auto singlePass = ctx.findRenderPass(makeBuilder(false));
+  const auto subpassPass = ctx.findRenderPass(makeBuilder(true));
+
+  ASSERT_NE(subpassPass.pass, VK_NULL_HANDLE);
+  // pipelines of different subpass layouts are not compatible
+  ASSERT_NE(singlePass.index, subpassPass.index);
+  ASSERT_EQ(ctx.findRenderPass(makeBuilder(true)).pass, subpassPass.pass);
+}
+
+/// StagingDeviceBatchedUploads
+/// Several uploads recorded into one batch should all land once the batch handle is signaled.
+TEST_F(DeviceVulkanTest, StagingDeviceBatchedUploads) {
+  auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
+
+  constexpr size_t kSize = 4096;
+  constexpr size_t kNumPieces = 4;
+
+  Result ret;
+  auto buffer = iglDev_->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Storage, nullptr, kSize, ResourceStorage::Private),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(buffer, nullptr);
+
+  auto& vkBuffer = *static_cast<igl::vulkan::Buffer&>(*buffer).currentVulkanBuffer();
+
+  std::vector<uint8_t> data(kSize);
+  for (size_t i = 0; i != kSize; i++) {
+    data[i] = static_cast<uint8_t>(i * 7);
   }
 
+  auto& staging = *ctx.stagingDevice_;
+
+  staging.beginBatch();
+  for (size_t i = 0; i != kNumPieces; i++) {
+    const size_t pieceSize = kSize / kNumPieces;
+    // nothing is submitted while the batch is open
+    ASSERT_TRUE(staging.bufferSubData(vkBuffer, i * pieceSize, pieceSize, &data[i * pieceSize])
+                    .empty());
+  }
+  const auto handle = staging.endBatch();
+  if (!vkBuffer.isMapped()) {
+    ASSERT_FALSE(handle.empty());
+  }
+  staging.wait(handle);
+  ASSERT_TRUE(staging.isReady(handle));
+
+  std::vector<uint8_t> readback(kSize);
+  staging.getBufferSubData(vkBuffer, 0, kSize, readback.data());
+  ASSERT_EQ(readback, data);
+}
+
+/// AsyncReadbacks
+/// Readbacks of several frames can be in flight; each returns the contents the texture had when it
+/// was requested, flipped vertically. Requesting more readbacks than there are buffers drops the
+/// oldest one.
+TEST_F(DeviceVulkanTest, AsyncReadbacks) {
+  constexpr uint32_t kWidth = 4;
+  constexpr uint32_t kHeight = 2;
+  constexpr uint32_t kNumFrames = 3;
+
+  const auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
+  ASSERT_EQ(ctx.config_.maxAsyncReadbacks, kNumFrames);
+
+  Result ret;
+  auto texture = iglDev_->createTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                         kWidth,
+                         kHeight,
+                         TextureDesc::TextureUsageBits::Sampled |
+                             TextureDesc::TextureUsageBits::Attachment),
+      &ret);
   ASSERT_TRUE(ret.isOk());
-  ASSERT_NE(iglDev, nullptr);
+  ASSERT_NE(texture, nullptr);
 
-  if (!iglDev)
-    return;
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = texture;
+  auto framebuffer = iglDev_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(framebuffer, nullptr);
+  const auto& vkFramebuffer = static_cast<igl::vulkan::Framebuffer&>(*framebuffer);
+
+  const auto range = TextureRangeDesc::new2D(0, 0, kWidth, kHeight);
+  const auto pixel = [](uint32_t frame, uint32_t x, uint32_t y) {
+    return 0xff000000u | (frame << 16) | (y << 8) | x;
+  };
+
+  std::vector<uint64_t> readbacks;
+  for (uint32_t frame = 0; frame != kNumFrames; frame++) {
+    std::vector<uint32_t> data(kWidth * kHeight);
+    for (uint32_t y = 0; y != kHeight; y++) {
+      for (uint32_t x = 0; x != kWidth; x++) {
+        data[y * kWidth + x] = pixel(frame, x, y);
+      }
+    }
+    ASSERT_TRUE(texture->upload(range, data.data()).isOk());
+    readbacks.push_back(vkFramebuffer.copyBytesColorAttachmentAsync(0, range));
+    ASSERT_NE(readbacks.back(), 0u);
+  }
+
+  for (uint32_t frame = 0; frame != kNumFrames; frame++) {
+    std::vector<uint32_t> pixels(kWidth * kHeight);
+    ASSERT_TRUE(vkFramebuffer.getColorAttachmentReadback(readbacks[frame], pixels.data()));
+    ASSERT_FALSE(vkFramebuffer.isReadbackReady(readbacks[frame]));
+    for (uint32_t y = 0; y != kHeight; y++) {
+      for (uint32_t x = 0; x != kWidth; x++) {
+        ASSERT_EQ(pixels[(kHeight - 1 - y) * kWidth + x], pixel(frame, x, y));
+      }
+    }
+  }
+
+  // all buffers are free now: fill them and drop the oldest readback
+  readbacks.clear();
+  for (uint32_t i = 0; i != kNumFrames + 1; i++) {
+    readbacks.push_back(vkFramebuffer.copyBytesColorAttachmentAsync(0, range));
+  }
+  std::vector<uint32_t> pixels(kWidth * kHeight);
+  ASSERT_FALSE(vkFramebuffer.getColorAttachmentReadback(readbacks[0], pixels.data()));
+  for (uint32_t i = 1; i != kNumFrames + 1; i++) {
+    ASSERT_TRUE(vkFramebuffer.getColorAttachmentReadback(readbacks[i], pixels.data()));
+  }
+}
+
+/// FlippedReadbacks
+/// Readbacks flipped by the GPU copy are flipped back on the CPU if the caller wants the rows in
+/// their original order.
+TEST_F(DeviceVulkanTest, FlippedReadbacks) {
+  constexpr uint32_t kWidth = 2;
+  constexpr uint32_t kHeight = 3;
+
+  Result ret;
+  auto texture = iglDev_->createTexture(
+      TextureDesc::new2D(
+          TextureFormat::RGBA_UNorm8, kWidth, kHeight, TextureDesc::TextureUsageBits::Sampled),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(texture, nullptr);
+
+  const auto range = TextureRangeDesc::new2D(0, 0, kWidth, kHeight);
+  std::vector<uint32_t> data(kWidth * kHeight);
+  for (uint32_t i = 0; i != data.size(); i++) {
+    data[i] = 0xff000000u | i;
+  }
+  ASSERT_TRUE(texture->upload(range, data.data()).isOk());
+
+  const auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
+  const auto& vkTex = static_cast<igl::vulkan::Texture&>(*texture);
+  const VkRect2D imageRegion = {VkOffset2D{0, 0}, VkExtent2D{kWidth, kHeight}};
+
+  for (const bool flipInCopy : {false, true}) {
+    for (const bool flip : {false, true}) {
+      const uint64_t readbackId = ctx.stagingDevice_->getImageData2DAsync(
+          vkTex.getVkImage(),
+          0,
+          0,
+          imageRegion,
+          texture->getProperties(),
+          vkTex.getVulkanTexture().getVulkanImage().imageLayout_,
+          flipInCopy);
+      ASSERT_NE(readbackId, 0u);
+
+      std::vector<uint32_t> pixels(kWidth * kHeight);
+      ASSERT_TRUE(ctx.stagingDevice_->collectImageData2D(readbackId, pixels.data(), 0, flip));
+      for (uint32_t y = 0; y != kHeight; y++) {
+        const uint32_t srcY = flip ? kHeight - 1 - y : y;
+        for (uint32_t x = 0; x != kWidth; x++) {
+          ASSERT_EQ(pixels[y * kWidth + x], data[srcY * kWidth + x]);
+        }
+      }
+    }
+  }
+}
+
+/// ReuploadTextureInUse
+/// A re-upload waits for the submitted GPU work which still reads the texture.
+TEST_F(DeviceVulkanTest, ReuploadTextureInUse) {
+  constexpr uint32_t kWidth = 64;
+  constexpr uint32_t kHeight = 64;
+
+  Result ret;
+  auto texture = iglDev_->createTexture(
+      TextureDesc::new2D(
+          TextureFormat::RGBA_UNorm8, kWidth, kHeight, TextureDesc::TextureUsageBits::Sampled),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(texture, nullptr);
+
+  const auto range = TextureRangeDesc::new2D(0, 0, kWidth, kHeight);
+  const std::vector<uint32_t> oldData(kWidth * kHeight, 0xff0000ffu);
+  const std::vector<uint32_t> newData(kWidth * kHeight, 0xff00ff00u);
+  ASSERT_TRUE(texture->upload(range, oldData.data()).isOk());
+
+  const auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
+  const auto& vkTex = static_cast<igl::vulkan::Texture&>(*texture);
+  const VkRect2D imageRegion = {VkOffset2D{0, 0}, VkExtent2D{kWidth, kHeight}};
+
+  const auto readback = [&]() {
+    return ctx.stagingDevice_->getImageData2DAsync(
+        vkTex.getVkImage(),
+        0,
+        0,
+        imageRegion,
+        texture->getProperties(),
+        vkTex.getVulkanTexture().getVulkanImage().imageLayout_,
+        false);
+  };
+
+  // the first readback is still reading the texture when it is overwritten
+  const uint64_t oldReadbackId = readback();
+  ASSERT_NE(oldReadbackId, 0u);
+  ASSERT_TRUE(texture->upload(range, newData.data()).isOk());
+  const uint64_t newReadbackId = readback();
+  ASSERT_NE(newReadbackId, 0u);
+
+  std::vector<uint32_t> pixels(kWidth * kHeight);
+  ASSERT_TRUE(ctx.stagingDevice_->collectImageData2D(oldReadbackId, pixels.data(), 0, false));
+  ASSERT_EQ(pixels, oldData);
+  ASSERT_TRUE(ctx.stagingDevice_->collectImageData2D(newReadbackId, pixels.data(), 0, false));
+  ASSERT_EQ(pixels, newData);
+}
 
+/// ImageSubresourceStates
+/// Layouts are tracked per mip level; transitions into a read-only layout which the requested
+/// stages already see are dropped.
+TEST_F(DeviceVulkanTest, ImageSubresourceStates) {
+  Result ret;
+  auto texture = iglDev_->createTexture(TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                           4,
+                                                           4,
+                                                           TextureDesc::TextureUsageBits::Sampled,
+                                                           "ImageSubresourceStates"),
+                                        &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(texture, nullptr);
+
+  const auto& image =
+      static_cast<igl::vulkan::Texture&>(*texture).getVulkanTexture().getVulkanImage();
+  image.setLayout(VK_IMAGE_LAYOUT_UNDEFINED, 0);
+
+  std::vector<VkImageMemoryBarrier> barriers;
+  VkPipelineStageFlags srcStages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+  image.getTransitionBarriers(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                              srcStages,
+                              VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                              VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
+                              barriers);
+  ASSERT_EQ(barriers.size(), 1u);
+  // nothing to wait for in VK_IMAGE_LAYOUT_UNDEFINED
+  ASSERT_EQ(srcStages, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+  ASSERT_EQ(barriers[0].oldLayout, VK_IMAGE_LAYOUT_UNDEFINED);
+  ASSERT_EQ(image.getLayout(0, 0), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+  // the same reads again
+  barriers.clear();
+  srcStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  image.getTransitionBarriers(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                              srcStages,
+                              VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                              VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
+                              barriers);
+  ASSERT_TRUE(barriers.empty());
+  ASSERT_EQ(srcStages, 0u);
+
+  // new stages wait for the tracked ones, not for the guess
+  srcStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+  image.getTransitionBarriers(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                              srcStages,
+                              VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                              VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
+                              barriers);
+  ASSERT_EQ(barriers.size(), 1u);
+  ASSERT_EQ(srcStages, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+  ASSERT_EQ(barriers[0].srcAccessMask, 0u);
+}
+
+GTEST_TEST(VulkanContext, BufferDeviceAddress) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableBufferDeviceAddress = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
   auto buffer = iglDev->createBuffer(
       BufferDesc(BufferDesc::BufferTypeBits::Uniform, nullptr, 256, ResourceStorage::Shared), &ret);
 
@@ -112,52 +539,294 @@ GTEST_TEST(VulkanContext, BufferDeviceAddress) {
   ASSERT_NE(buffer->gpuAddress(), 0u);
 }
 
-GTEST_TEST(VulkanContext, DescriptorIndexing) {
-  std::shared_ptr<igl::IDevice> iglDev = nullptr;
+GTEST_TEST(VulkanContext, BufferAddressPushConstants) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableBufferDeviceAddress = true;
 
-  igl::vulkan::VulkanContextConfig config;
-#if IGL_PLATFORM_MACOS
-  config.terminateOnValidationError = false;
-#elif IGL_DEBUG
-  config.enableValidation = true;
-  config.terminateOnValidationError = true;
-#else
-  config.enableValidation = true;
-  config.terminateOnValidationError = false;
-#endif
-  config.enableExtraLogs = true;
-  config.enableDescriptorIndexing = true;
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
 
-  auto ctx = igl::vulkan::HWDevice::createContext(config, nullptr);
+  Result ret;
+  const char* source = R"(
+layout (local_size_x = 6) in;
+layout (buffer_reference, std430) readonly buffer InputBuffer { float data[]; };
+layout (buffer_reference, std430) writeonly buffer OutputBuffer { float data[]; };
+layout (push_constant) uniform PushConstants {
+  InputBuffer bufferIn;
+  OutputBuffer bufferOut;
+} pc;
+void main() {
+  const uint i = gl_GlobalInvocationID.x;
+  pc.bufferOut.data[i] = 2.0 * pc.bufferIn.data[i];
+}
+)";
+  ComputePipelineDesc computeDesc;
+  computeDesc.shaderStages =
+      ShaderStagesCreator::fromModuleStringInput(*iglDev, source, "main", "", &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+  auto computePipelineState = iglDev->createComputePipeline(computeDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(computePipelineState, nullptr);
+
+  const std::vector<float> dataIn = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  const size_t length = sizeof(float) * dataIn.size();
+  auto bufferIn = iglDev->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Storage, dataIn.data(), length), &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto bufferOut = iglDev->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Storage, nullptr, length, ResourceStorage::Shared),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+  auto getNumBufferSets = [&vulkanContext]() {
+    uint64_t numSets = 0;
+    for (const auto& dsets : vulkanContext.transientDSets_) {
+      numSets += dsets.buffersUniform->getStats().numAllocatedSets +
+                 dsets.buffersStorage->getStats().numAllocatedSets;
+    }
+    return numSets;
+  };
+  const uint64_t numBufferSets = getNumBufferSets();
+
+  auto cmdQueue = iglDev->createCommandQueue({CommandQueueType::Compute}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto cmdBuffer = cmdQueue->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto computeEncoder = cmdBuffer->createComputeCommandEncoder();
+  ASSERT_NE(computeEncoder, nullptr);
+  computeEncoder->bindComputePipelineState(computePipelineState);
+  computeEncoder->bindBufferAddress(0, *bufferIn, 0);
+  computeEncoder->bindBufferAddress(sizeof(uint64_t), *bufferOut, 0);
+  computeEncoder->dispatchThreadGroups(Dimensions(1, 1, 1), Dimensions(dataIn.size(), 1, 1));
+  computeEncoder->endEncoding();
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  // no buffer was bound through descriptors
+  ASSERT_EQ(getNumBufferSets(), numBufferSets);
+
+  const auto* dataOut = static_cast<const float*>(bufferOut->map(BufferRange(length, 0), &ret));
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(dataOut, nullptr);
+  for (size_t i = 0; i != dataIn.size(); i++) {
+    ASSERT_EQ(dataOut[i], 2.0f * dataIn[i]);
+  }
+  bufferOut->unmap();
+}
+
+GTEST_TEST(VulkanContext, PushDescriptors) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enablePushDescriptors = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
 
   Result ret;
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+  if (!vulkanContext.usePushDescriptors_) {
+    GTEST_SKIP() << "VK_KHR_push_descriptor is not supported";
+  }
+  // sets cannot be allocated from a push descriptor set layout
+  ASSERT_EQ(vulkanContext.dsetDefaultBuffersUniform_, VK_NULL_HANDLE);
 
-  std::vector<HWDeviceDesc> devices = igl::vulkan::HWDevice::queryDevices(
-      *ctx.get(), HWDeviceQueryDesc(HWDeviceType::Unknown), &ret);
+  // the uniform buffer slots are pushed along with the transient storage buffer set
+  const char* source = R"(
+layout (local_size_x = 6) in;
+layout (set = 2, binding = 0, std430) readonly buffer InputBuffer { float data[]; } bufferIn;
+layout (set = 2, binding = 1, std430) writeonly buffer OutputBuffer { float data[]; } bufferOut;
+void main() {
+  const uint i = gl_GlobalInvocationID.x;
+  bufferOut.data[i] = 2.0 * bufferIn.data[i];
+}
+)";
+  ComputePipelineDesc computeDesc;
+  computeDesc.shaderStages =
+      ShaderStagesCreator::fromModuleStringInput(*iglDev, source, "main", "", &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+  auto computePipelineState = iglDev->createComputePipeline(computeDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(computePipelineState, nullptr);
 
-  ASSERT_TRUE(!devices.empty());
+  const std::vector<float> dataIn = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  const size_t length = sizeof(float) * dataIn.size();
+  std::shared_ptr<IBuffer> bufferIn = iglDev->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Storage, dataIn.data(), length), &ret);
+  ASSERT_TRUE(ret.isOk());
+  std::shared_ptr<IBuffer> bufferOut = iglDev->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Storage, nullptr, length, ResourceStorage::Shared),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
 
-  if (ret.isOk()) {
-    std::vector<const char*> extraDeviceExtensions;
-    iglDev = igl::vulkan::HWDevice::create(std::move(ctx),
-                                           devices[0],
-                                           0, // width
-                                           0, // height,
-                                           0,
-                                           nullptr,
-                                           &ret);
+  auto cmdQueue = iglDev->createCommandQueue({CommandQueueType::Compute}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto cmdBuffer = cmdQueue->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto computeEncoder = cmdBuffer->createComputeCommandEncoder();
+  ASSERT_NE(computeEncoder, nullptr);
+  computeEncoder->bindComputePipelineState(computePipelineState);
+  computeEncoder->bindBuffer(0, bufferIn, 0);
+  computeEncoder->bindBuffer(1, bufferOut, 0);
+  computeEncoder->dispatchThreadGroups(Dimensions(1, 1, 1), Dimensions(dataIn.size(), 1, 1));
+  computeEncoder->endEncoding();
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
 
-    if (!ret.isOk()) {
-      iglDev = nullptr;
-    }
+  uint64_t numUniformSets = 0;
+  for (const auto& dsets : vulkanContext.transientDSets_) {
+    numUniformSets += dsets.buffersUniform->getStats().numAllocatedSets;
   }
+  ASSERT_EQ(numUniformSets, 0u);
 
+  const auto* dataOut = static_cast<const float*>(bufferOut->map(BufferRange(length, 0), &ret));
   ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(dataOut, nullptr);
+  for (size_t i = 0; i != dataIn.size(); i++) {
+    ASSERT_EQ(dataOut[i], 2.0f * dataIn[i]);
+  }
+  bufferOut->unmap();
+}
+
+GTEST_TEST(VulkanContext, DescriptorBuffers) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableBufferDeviceAddress = true;
+  config.enableDescriptorBuffers = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
   ASSERT_NE(iglDev, nullptr);
 
-  if (!iglDev)
-    return;
+  Result ret;
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+  if (!vulkanContext.useDescriptorBuffers_) {
+    GTEST_SKIP() << "VK_EXT_descriptor_buffer is not supported";
+  }
+  // no descriptor sets are allocated
+  ASSERT_EQ(vulkanContext.dsetDefaultBuffersStorage_, VK_NULL_HANDLE);
+  ASSERT_FALSE(vulkanContext.usePushDescriptors_);
+
+  const char* source = R"(
+layout (local_size_x = 6) in;
+layout (set = 2, binding = 0, std430) readonly buffer InputBuffer { float data[]; } bufferIn;
+layout (set = 2, binding = 1, std430) writeonly buffer OutputBuffer { float data[]; } bufferOut;
+void main() {
+  const uint i = gl_GlobalInvocationID.x;
+  bufferOut.data[i] = 2.0 * bufferIn.data[i];
+}
+)";
+  ComputePipelineDesc computeDesc;
+  computeDesc.shaderStages =
+      ShaderStagesCreator::fromModuleStringInput(*iglDev, source, "main", "", &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message.c_str();
+  auto computePipelineState = iglDev->createComputePipeline(computeDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(computePipelineState, nullptr);
+
+  const std::vector<float> dataIn = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  const size_t length = sizeof(float) * dataIn.size();
+  std::shared_ptr<IBuffer> bufferIn = iglDev->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Storage, dataIn.data(), length), &ret);
+  ASSERT_TRUE(ret.isOk());
+  std::shared_ptr<IBuffer> bufferOut = iglDev->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Storage, nullptr, length, ResourceStorage::Shared),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  auto cmdQueue = iglDev->createCommandQueue({CommandQueueType::Compute}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto cmdBuffer = cmdQueue->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto computeEncoder = cmdBuffer->createComputeCommandEncoder();
+  ASSERT_NE(computeEncoder, nullptr);
+  computeEncoder->bindComputePipelineState(computePipelineState);
+  computeEncoder->bindBuffer(0, bufferIn, 0);
+  computeEncoder->bindBuffer(1, bufferOut, 0);
+  computeEncoder->dispatchThreadGroups(Dimensions(1, 1, 1), Dimensions(dataIn.size(), 1, 1));
+  computeEncoder->endEncoding();
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  uint64_t numDescriptorBytes = 0;
+  for (const auto& dsets : vulkanContext.transientDSets_) {
+    ASSERT_EQ(dsets.buffersStorage, nullptr);
+    ASSERT_NE(dsets.descriptorBuffer, nullptr);
+    numDescriptorBytes += dsets.descriptorBuffer->getStats().numAllocatedBytes;
+  }
+  ASSERT_GT(numDescriptorBytes, 0u);
+
+  const auto* dataOut = static_cast<const float*>(bufferOut->map(BufferRange(length, 0), &ret));
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(dataOut, nullptr);
+  for (size_t i = 0; i != dataIn.size(); i++) {
+    ASSERT_EQ(dataOut[i], 2.0f * dataIn[i]);
+  }
+  bufferOut->unmap();
+}
+
+#if IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+GTEST_TEST(VulkanContext, HostImageCopy) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableHostImageCopy = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+  if (!vulkanContext.useHostImageCopy_) {
+    GTEST_SKIP() << "VK_EXT_host_image_copy is not supported";
+  }
+
+  constexpr uint32_t kWidth = 4;
+  constexpr uint32_t kHeight = 4;
+
+  auto texture = iglDev->createTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                         kWidth,
+                         kHeight,
+                         TextureDesc::TextureUsageBits::Sampled |
+                             TextureDesc::TextureUsageBits::Attachment),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  const auto& image =
+      static_cast<igl::vulkan::Texture&>(*texture).getVulkanTexture().getVulkanImage();
+  if ((image.getVkImageUsageFlags() & VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT) == 0) {
+    GTEST_SKIP() << "Host image copies are slower for this texture";
+  }
+
+  std::vector<uint32_t> pixels(kWidth * kHeight);
+  for (size_t i = 0; i != pixels.size(); i++) {
+    pixels[i] = 0xff000000u | static_cast<uint32_t>(i);
+  }
+  ret = texture->upload(TextureRangeDesc::new2D(0, 0, kWidth, kHeight), pixels.data());
+  ASSERT_TRUE(ret.isOk());
+  // the CPU has written the image and changed its layout without a submit
+  ASSERT_EQ(image.getLayout(0, 0), vulkanContext.hostImageCopyLayout_);
+
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = texture;
+  auto framebuffer = iglDev->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(framebuffer, nullptr);
+
+  auto cmdQueue = iglDev->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  std::vector<uint32_t> readPixels(kWidth * kHeight);
+  framebuffer->copyBytesColorAttachment(
+      *cmdQueue, 0, readPixels.data(), TextureRangeDesc::new2D(0, 0, kWidth, kHeight));
+  ASSERT_EQ(readPixels, pixels);
+}
+#endif // IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+
+GTEST_TEST(VulkanContext, DescriptorIndexing) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableDescriptorIndexing = true;
 
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
   const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
                                                  1,
                                                  1,
@@ -173,6 +842,858 @@ GTEST_TEST(VulkanContext, DescriptorIndexing) {
 
   ASSERT_NE(texture->getTextureId(), 0u);
 }
+
+GTEST_TEST(VulkanContext, YcbcrTextures) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableDescriptorIndexing = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  for (const TextureFormat format : {TextureFormat::YUV_NV12, TextureFormat::YUV_P010}) {
+    const bool isSupported =
+        contains(iglDev->getTextureFormatCapabilities(format),
+                 ICapabilities::TextureFormatCapabilityBits::Sampled);
+
+    const TextureDesc texDesc =
+        TextureDesc::new2D(format, 8, 4, TextureDesc::TextureUsageBits::Sampled);
+    auto texture = iglDev->createTexture(texDesc, &ret);
+    if (!isSupported) {
+      ASSERT_NE(ret.code, Result::Code::Ok);
+      continue;
+    }
+    ASSERT_EQ(ret.code, Result::Code::Ok);
+    ASSERT_NE(texture, nullptr);
+
+    // both planes are uploaded from one tightly packed buffer
+    const auto range = texture->getFullRange();
+    const std::vector<uint8_t> data(texture->getProperties().getBytesPerRange(range), 0x80);
+    ASSERT_TRUE(texture->upload(range, data.data()).isOk());
+    ASSERT_NE(texture->getTextureId(), 0u);
+  }
+
+  // YUV textures cannot be storage images or have mip levels
+  TextureDesc texDesc = TextureDesc::new2D(TextureFormat::YUV_NV12,
+                                           8,
+                                           4,
+                                           TextureDesc::TextureUsageBits::Sampled |
+                                               TextureDesc::TextureUsageBits::Storage);
+  iglDev->createTexture(texDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Unsupported);
+  texDesc.usage = TextureDesc::TextureUsageBits::Sampled;
+  texDesc.numMipLevels = 2;
+  iglDev->createTexture(texDesc, &ret);
+  ASSERT_EQ(ret.code, Result::Code::Unsupported);
+}
+
+GTEST_TEST(VulkanContext, TimelineSemaphores) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableTimelineSemaphores = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+
+  if (!vulkanContext.usesTimelineSemaphores()) {
+    GTEST_SKIP() << "VK_KHR_timeline_semaphore is not supported";
+  }
+
+  auto& immediate = *vulkanContext.immediate_;
+  ASSERT_TRUE(immediate.usesTimelineSemaphore());
+
+  // submit more command buffers than the ring holds, so some of them have to be recycled
+  std::vector<igl::vulkan::VulkanImmediateCommands::SubmitHandle> handles;
+  for (uint32_t i = 0; i != 2 * igl::vulkan::VulkanImmediateCommands::kMaxCommandBuffers; i++) {
+    handles.push_back(immediate.submit(immediate.acquire()));
+  }
+
+  immediate.wait(handles.back());
+
+  // every earlier submit is covered by the last one
+  for (const auto& handle : handles) {
+    ASSERT_TRUE(immediate.isReady(handle));
+  }
+
+  immediate.waitAll();
+}
+
+GTEST_TEST(VulkanContext, BatchedSubmits) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableTimelineSemaphores = true;
+  config.batchSubmits = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+
+  if (!vulkanContext.usesTimelineSemaphores()) {
+    GTEST_SKIP() << "VK_KHR_timeline_semaphore is not supported";
+  }
+
+  auto& immediate = *vulkanContext.immediate_;
+  ASSERT_TRUE(immediate.usesTimelineSemaphore());
+
+  // nothing reaches the queue until something observes it
+  const auto first = immediate.submit(immediate.acquire());
+  const auto second = immediate.submit(immediate.acquire());
+  immediate.wait(second);
+  ASSERT_TRUE(immediate.isReady(first));
+
+  // running out of command buffers flushes the batch
+  std::vector<igl::vulkan::VulkanImmediateCommands::SubmitHandle> handles;
+  for (uint32_t i = 0; i != 2 * igl::vulkan::VulkanImmediateCommands::kMaxCommandBuffers; i++) {
+    handles.push_back(immediate.submit(immediate.acquire()));
+  }
+
+  immediate.flush();
+  immediate.wait(handles.back());
+
+  for (const auto& handle : handles) {
+    ASSERT_TRUE(immediate.isReady(handle));
+  }
+
+  immediate.waitAll();
+}
+
+GTEST_TEST(VulkanContext, BudgetedDeferredTasks) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.maxDeferredTasksPerSubmit = 1;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+
+  constexpr uint32_t kNumTasks = 4;
+  uint32_t numExecutedTasks = 0;
+  for (uint32_t i = 0; i != kNumTasks; i++) {
+    vulkanContext.deferredTask(
+        std::packaged_task<void()>([&numExecutedTasks]() { numExecutedTasks++; }));
+  }
+
+  auto cmdQueue = iglDev->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(cmdQueue, nullptr);
+
+  // at most one task is retired per submit; the first ones may still wait for their command buffer
+  // to be recycled
+  constexpr uint32_t kNumSubmits =
+      igl::vulkan::VulkanImmediateCommands::kMaxCommandBuffers + 2 * kNumTasks;
+  for (uint32_t i = 0; i != kNumSubmits; i++) {
+    auto cmdBuffer = cmdQueue->createCommandBuffer({}, &ret);
+    ASSERT_TRUE(ret.isOk());
+    cmdQueue->submit(*cmdBuffer);
+    cmdBuffer->waitUntilCompleted();
+    ASSERT_LE(numExecutedTasks, i + 1);
+  }
+
+  ASSERT_EQ(numExecutedTasks, kNumTasks);
+}
+
+GTEST_TEST(VulkanContext, CompletedHandlersWithDeferredTasksThread) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableDeferredTasksThread = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  auto cmdQueue = iglDev->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(cmdQueue, nullptr);
+
+  // the handler runs on the thread which submits, not on the deferred tasks thread
+  std::thread::id handlerThread;
+  auto cmdBuffer = cmdQueue->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  cmdBuffer->addCompletedHandler(
+      [&handlerThread]() { handlerThread = std::this_thread::get_id(); });
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  for (uint32_t i = 0; i != igl::vulkan::VulkanImmediateCommands::kMaxCommandBuffers &&
+                       handlerThread == std::thread::id();
+       i++) {
+    auto nextCmdBuffer = cmdQueue->createCommandBuffer({}, &ret);
+    ASSERT_TRUE(ret.isOk());
+    cmdQueue->submit(*nextCmdBuffer);
+    nextCmdBuffer->waitUntilCompleted();
+  }
+
+  ASSERT_EQ(handlerThread, std::this_thread::get_id());
+}
+
+GTEST_TEST(VulkanContext, Defragmentation) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.defragmentationMaxBytesPerFrame = 256u * 1024u;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  auto cmdQueue = iglDev->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(cmdQueue, nullptr);
+
+  // free every other buffer to leave holes in the memory blocks
+  constexpr size_t kNumBuffers = 16;
+  constexpr size_t kBufferSize = 64u * 1024u;
+  std::vector<std::unique_ptr<IBuffer>> buffers;
+  for (size_t i = 0; i != kNumBuffers; i++) {
+    const std::vector<uint8_t> data(kBufferSize, static_cast<uint8_t>(i));
+    BufferDesc desc(BufferDesc::BufferTypeBits::Storage,
+                    data.data(),
+                    kBufferSize,
+                    ResourceStorage::Private);
+    desc.memoryPriority = i % 2 ? 1.0f : 0.0f;
+    buffers.push_back(iglDev->createBuffer(desc, &ret));
+    ASSERT_TRUE(ret.isOk());
+  }
+  for (size_t i = 0; i < kNumBuffers; i += 2) {
+    buffers[i] = nullptr;
+  }
+
+  // passes run at the end of frames and finish when their copies are retired
+  for (uint32_t i = 0; i != 2 * igl::vulkan::VulkanImmediateCommands::kMaxCommandBuffers; i++) {
+    auto cmdBuffer = cmdQueue->createCommandBuffer({}, &ret);
+    ASSERT_TRUE(ret.isOk());
+    cmdQueue->submit(*cmdBuffer, true);
+    cmdBuffer->waitUntilCompleted();
+  }
+
+  // moved or not, the buffers keep their contents
+  for (size_t i = 1; i < kNumBuffers; i += 2) {
+    const auto* data =
+        static_cast<const uint8_t*>(buffers[i]->map(BufferRange(kBufferSize, 0), &ret));
+    ASSERT_TRUE(ret.isOk());
+    ASSERT_NE(data, nullptr);
+    for (size_t j = 0; j != kBufferSize; j++) {
+      ASSERT_EQ(data[j], static_cast<uint8_t>(i));
+    }
+    buffers[i]->unmap();
+  }
+
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+  ASSERT_NE(vulkanContext.defragmenter_, nullptr);
+  const auto stats = vulkanContext.defragmenter_->getStats();
+  ASSERT_LE(stats.allocationsMoved, kNumBuffers / 2 * stats.numPasses);
+}
+
+GTEST_TEST(VulkanContext, BufferPool) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.bufferPoolMaxAllocationSize = 1024;
+  config.bufferPoolBlockSize = 64u * 1024u;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+  const VkDeviceSize alignment =
+      vulkanContext.getVkPhysicalDeviceProperties().limits.minStorageBufferOffsetAlignment;
+
+  auto createBuffer = [&iglDev](size_t length, ResourceStorage storage, uint8_t value) {
+    const std::vector<uint8_t> data(length, value);
+    Result ret;
+    auto buffer = iglDev->createBuffer(
+        BufferDesc(BufferDesc::BufferTypeBits::Storage, data.data(), length, storage), &ret);
+    EXPECT_TRUE(ret.isOk());
+    return buffer;
+  };
+
+  for (ResourceStorage storage : {ResourceStorage::Shared, ResourceStorage::Private}) {
+    auto buffer0 = createBuffer(100, storage, 1);
+    auto buffer1 = createBuffer(200, storage, 2);
+    auto dedicated = createBuffer(2048, storage, 3);
+    ASSERT_NE(buffer0, nullptr);
+    ASSERT_NE(buffer1, nullptr);
+    ASSERT_NE(dedicated, nullptr);
+
+    const auto& vkBuffer0 = static_cast<igl::vulkan::Buffer&>(*buffer0);
+    const auto& vkBuffer1 = static_cast<igl::vulkan::Buffer&>(*buffer1);
+    const auto& vkDedicated = static_cast<igl::vulkan::Buffer&>(*dedicated);
+
+    // small buffers share a VkBuffer at aligned offsets
+    ASSERT_EQ(vkBuffer0.getVkBuffer(), vkBuffer1.getVkBuffer());
+    ASSERT_NE(vkBuffer0.getVkBufferOffset(), vkBuffer1.getVkBufferOffset());
+    ASSERT_EQ(vkBuffer0.getVkBufferOffset() % alignment, 0u);
+    ASSERT_EQ(vkBuffer1.getVkBufferOffset() % alignment, 0u);
+    ASSERT_NE(vkDedicated.getVkBuffer(), vkBuffer0.getVkBuffer());
+    ASSERT_EQ(vkDedicated.getVkBufferOffset(), 0u);
+
+    // each buffer only sees its own range
+    for (auto* buffer : {buffer0.get(), buffer1.get()}) {
+      const size_t length = buffer->getSizeInBytes();
+      const auto* data = static_cast<const uint8_t*>(buffer->map(BufferRange(length, 0), &ret));
+      ASSERT_TRUE(ret.isOk());
+      ASSERT_NE(data, nullptr);
+      for (size_t i = 0; i != length; i++) {
+        ASSERT_EQ(data[i], buffer == buffer0.get() ? 1u : 2u);
+      }
+      buffer->unmap();
+    }
+  }
+
+  ASSERT_NE(vulkanContext.bufferPool_, nullptr);
+  ASSERT_GE(vulkanContext.bufferPool_->getNumBlocks(), 1u);
+}
+
+GTEST_TEST(VulkanContext, AsyncCompute) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableAsyncCompute = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+
+  auto computeQueue = iglDev->createCommandQueue({CommandQueueType::Compute}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto graphicsQueue = iglDev->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  // an upload has to be visible to the compute queue
+  const std::vector<uint8_t> data(256, 1);
+  auto buffer = iglDev->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Storage,
+                                                data.data(),
+                                                data.size(),
+                                                ResourceStorage::Private),
+                                     &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(buffer, nullptr);
+
+  auto cmdBuffer = computeQueue->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(cmdBuffer, nullptr);
+  const bool isAsyncCompute = vulkanContext.computeImmediate_ != nullptr;
+  ASSERT_EQ(static_cast<igl::vulkan::CommandBuffer&>(*cmdBuffer).isAsyncCompute(),
+            isAsyncCompute);
+  computeQueue->submit(*cmdBuffer);
+
+  // the graphics queue waits for the compute queue, and the other way around
+  auto computeFence = computeQueue->signalFence(&ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(computeFence, nullptr);
+  ASSERT_TRUE(graphicsQueue->waitFence(*computeFence).isOk());
+  // a second wait is a no-op
+  ASSERT_TRUE(graphicsQueue->waitFence(*computeFence).isOk());
+
+  auto graphicsFence = graphicsQueue->signalFence(&ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(graphicsFence, nullptr);
+  ASSERT_TRUE(computeQueue->waitFence(*graphicsFence).isOk());
+
+  auto lastFence = computeQueue->signalFence(&ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(lastFence, nullptr);
+  ASSERT_TRUE(lastFence->waitUntilSignaled());
+  ASSERT_TRUE(computeFence->isSignaled());
+  ASSERT_TRUE(graphicsFence->isSignaled());
+  ASSERT_TRUE(cmdBuffer->isCompleted());
+}
+
+/// RecordCommandBuffersOnThreads
+/// Command buffers recorded on different threads simultaneously should be submitted in order.
+/// DynamicRendering
+/// Render passes without VkRenderPass objects (if supported) clear, load and track the layouts of
+/// their attachments, also when their draws are recorded into secondary command buffers.
+GTEST_TEST(VulkanContext, DynamicRendering) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableDynamicRendering = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  constexpr uint32_t kWidth = 4;
+  constexpr uint32_t kHeight = 4;
+
+  auto colorTexture = iglDev->createTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                         kWidth,
+                         kHeight,
+                         TextureDesc::TextureUsageBits::Sampled |
+                             TextureDesc::TextureUsageBits::Attachment),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto depthTexture =
+      iglDev->createTexture(TextureDesc::new2D(TextureFormat::S8_UInt_Z24_UNorm,
+                                               kWidth,
+                                               kHeight,
+                                               TextureDesc::TextureUsageBits::Attachment),
+                            &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = colorTexture;
+  framebufferDesc.depthAttachment.texture = depthTexture;
+  auto framebuffer = iglDev->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(framebuffer, nullptr);
+
+  auto cmdQueue = iglDev->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  RenderPassDesc renderPass;
+  renderPass.colorAttachments.resize(1);
+  renderPass.colorAttachments[0].loadAction = LoadAction::Clear;
+  renderPass.colorAttachments[0].storeAction = StoreAction::Store;
+  renderPass.colorAttachments[0].clearColor = {1.0f, 0.0f, 0.0f, 1.0f};
+  renderPass.depthAttachment.loadAction = LoadAction::Clear;
+  renderPass.stencilAttachment.loadAction = LoadAction::Clear;
+
+  auto cmdBuffer = cmdQueue->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto encoder = cmdBuffer->createRenderCommandEncoder(renderPass, framebuffer, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(encoder, nullptr);
+  encoder->endEncoding();
+
+  // the clear color is kept by a second render pass with secondary command buffers
+  renderPass.colorAttachments[0].loadAction = LoadAction::Load;
+  renderPass.depthAttachment.loadAction = LoadAction::Load;
+  renderPass.stencilAttachment.loadAction = LoadAction::Load;
+  auto parallelEncoder =
+      cmdBuffer->createParallelRenderCommandEncoder(renderPass, framebuffer, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(parallelEncoder, nullptr);
+  auto childEncoder = parallelEncoder->createRenderCommandEncoder(&ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(childEncoder, nullptr);
+  childEncoder->endEncoding();
+  parallelEncoder->endEncoding();
+
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  const auto& colorImage =
+      static_cast<igl::vulkan::Texture&>(*colorTexture).getVulkanTexture().getVulkanImage();
+  ASSERT_EQ(colorImage.getLayout(0, 0), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+  std::vector<uint32_t> pixels(kWidth * kHeight);
+  framebuffer->copyBytesColorAttachment(
+      *cmdQueue, 0, pixels.data(), TextureRangeDesc::new2D(0, 0, kWidth, kHeight));
+  for (const uint32_t pixel : pixels) {
+    ASSERT_EQ(pixel, 0xff0000ffu);
+  }
+}
+
+GTEST_TEST(VulkanContext, ImagelessFramebuffers) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableImagelessFramebuffers = true;
+  config.maxCachedFramebuffers = 2;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+
+  // rotate the color attachment through textures of the same size, format and usage
+  constexpr size_t kNumTextures = 3;
+  std::shared_ptr<ITexture> textures[kNumTextures];
+  const TextureDesc textureDesc = TextureDesc::new2D(
+      TextureFormat::RGBA_UNorm8,
+      4,
+      4,
+      TextureDesc::TextureUsageBits::Sampled | TextureDesc::TextureUsageBits::Attachment);
+  for (auto& texture : textures) {
+    texture = iglDev->createTexture(textureDesc, &ret);
+    ASSERT_TRUE(ret.isOk());
+  }
+
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = textures[0];
+  auto framebuffer = iglDev->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(framebuffer, nullptr);
+
+  auto cmdQueue = iglDev->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  RenderPassDesc renderPass;
+  renderPass.colorAttachments.resize(1);
+  renderPass.colorAttachments[0].loadAction = LoadAction::Clear;
+  renderPass.colorAttachments[0].storeAction = StoreAction::Store;
+
+  auto cmdBuffer = cmdQueue->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  for (const auto& texture : textures) {
+    framebuffer->updateDrawable(texture);
+    auto encoder = cmdBuffer->createRenderCommandEncoder(renderPass, framebuffer, &ret);
+    ASSERT_TRUE(ret.isOk());
+    ASSERT_NE(encoder, nullptr);
+    encoder->endEncoding();
+  }
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  const auto& fb = static_cast<const igl::vulkan::Framebuffer&>(*framebuffer);
+  if (vulkanContext.usesDynamicRendering()) {
+    ASSERT_EQ(fb.getNumCachedFramebuffers(), 0u);
+  } else if (vulkanContext.usesImagelessFramebuffers()) {
+    ASSERT_EQ(fb.getNumCachedFramebuffers(), 1u);
+  } else {
+    // one framebuffer per texture, evicted beyond maxCachedFramebuffers
+    ASSERT_EQ(fb.getNumCachedFramebuffers(), 2u);
+  }
+}
+
+GTEST_TEST(VulkanContext, ExtendedDynamicState) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableExtendedDynamicState = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+  if (!vulkanContext.usesExtendedDynamicState()) {
+    GTEST_SKIP() << "VK_EXT_extended_dynamic_state is not supported";
+  }
+
+  std::unique_ptr<IShaderStages> stages;
+  util::createSimpleShaderStages(iglDev, stages, TextureFormat::RGBA_UNorm8);
+
+  VertexInputStateDesc inputDesc;
+  inputDesc.attributes[0].format = VertexAttributeFormat::Float4;
+  inputDesc.attributes[0].offset = 0;
+  inputDesc.attributes[0].bufferIndex = data::shader::simplePosIndex;
+  inputDesc.attributes[0].name = data::shader::simplePos;
+  inputDesc.attributes[0].location = 0;
+  inputDesc.inputBindings[0].stride = sizeof(float) * 4;
+  inputDesc.attributes[1].format = VertexAttributeFormat::Float2;
+  inputDesc.attributes[1].offset = 0;
+  inputDesc.attributes[1].bufferIndex = data::shader::simpleUvIndex;
+  inputDesc.attributes[1].name = data::shader::simpleUv;
+  inputDesc.attributes[1].location = 1;
+  inputDesc.inputBindings[1].stride = sizeof(float) * 2;
+  inputDesc.numAttributes = inputDesc.numInputBindings = 2;
+
+  RenderPipelineDesc desc;
+  desc.vertexInputState = iglDev->createVertexInputState(inputDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  desc.shaderStages = std::move(stages);
+  desc.targetDesc.colorAttachments.resize(1);
+  desc.targetDesc.colorAttachments[0].textureFormat = TextureFormat::RGBA_UNorm8;
+  desc.targetDesc.depthAttachmentFormat = TextureFormat::Z_UNorm24;
+  auto pipelineState = iglDev->createRenderPipeline(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(pipelineState, nullptr);
+
+  const auto& rps = static_cast<const igl::vulkan::RenderPipelineState&>(*pipelineState);
+
+  igl::vulkan::RenderPipelineDynamicState triangles;
+  triangles.setTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+  const VkPipeline pipeline = rps.getVkPipeline(triangles);
+  ASSERT_NE(pipeline, VK_NULL_HANDLE);
+
+  // the states set with vkCmdSet*() share the pipeline
+  igl::vulkan::RenderPipelineDynamicState strips = triangles;
+  strips.setTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP);
+  strips.setDepthCompareOp(VK_COMPARE_OP_LESS);
+  strips.depthWriteEnable_ = true;
+  strips.setStencilStateOps(
+      true, VK_STENCIL_OP_REPLACE, VK_STENCIL_OP_KEEP, VK_STENCIL_OP_KEEP, VK_COMPARE_OP_EQUAL);
+  ASSERT_TRUE(rps.isPipelineReady(strips));
+  ASSERT_EQ(rps.getVkPipeline(strips), pipeline);
+
+  igl::vulkan::RenderPipelineDynamicState depthBias = triangles;
+  depthBias.depthBiasEnable_ = true;
+  ASSERT_EQ(rps.isPipelineReady(depthBias), vulkanContext.usesExtendedDynamicState2());
+
+  // points are another topology class
+  igl::vulkan::RenderPipelineDynamicState points = triangles;
+  points.setTopology(VK_PRIMITIVE_TOPOLOGY_POINT_LIST);
+  ASSERT_EQ(rps.isPipelineReady(points),
+            vulkanContext.hasUnrestrictedDynamicPrimitiveTopology());
+}
+
+GTEST_TEST(VulkanContext, GraphicsPipelineLibrary) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.enableGraphicsPipelineLibrary = true;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  const auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+  if (!vulkanContext.usesGraphicsPipelineLibrary()) {
+    GTEST_SKIP() << "VK_EXT_graphics_pipeline_library is not supported";
+  }
+
+  std::unique_ptr<IShaderStages> stages;
+  util::createSimpleShaderStages(iglDev, stages, TextureFormat::RGBA_UNorm8);
+
+  RenderPipelineDesc desc;
+  desc.shaderStages = std::move(stages);
+  desc.targetDesc.colorAttachments.resize(1);
+  desc.targetDesc.colorAttachments[0].textureFormat = TextureFormat::RGBA_UNorm8;
+  auto pipelineState = iglDev->createRenderPipeline(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(pipelineState, nullptr);
+
+  const auto& rps = static_cast<const igl::vulkan::RenderPipelineState&>(*pipelineState);
+
+  // 4 libraries and the linked pipeline
+  uint32_t numPipelines = igl::vulkan::VulkanPipelineBuilder::getNumPipelinesCreated();
+  igl::vulkan::RenderPipelineDynamicState triangles;
+  triangles.setTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+  const VkPipeline pipeline = rps.getVkPipeline(triangles);
+  ASSERT_NE(pipeline, VK_NULL_HANDLE);
+  ASSERT_EQ(igl::vulkan::VulkanPipelineBuilder::getNumPipelinesCreated(), numPipelines + 5);
+
+  // only the fragment shader library is compiled again before linking
+  numPipelines = igl::vulkan::VulkanPipelineBuilder::getNumPipelinesCreated();
+  igl::vulkan::RenderPipelineDynamicState depthTest = triangles;
+  depthTest.setDepthCompareOp(VK_COMPARE_OP_LESS);
+  depthTest.depthWriteEnable_ = true;
+  const VkPipeline depthTestPipeline = rps.getVkPipeline(depthTest);
+  ASSERT_NE(depthTestPipeline, VK_NULL_HANDLE);
+  ASSERT_NE(depthTestPipeline, pipeline);
+  ASSERT_EQ(igl::vulkan::VulkanPipelineBuilder::getNumPipelinesCreated(), numPipelines + 2);
+}
+
+GTEST_TEST(VulkanContext, DynamicUniformBuffers) {
+  igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+  config.dynamicUniformBufferRange = 256;
+
+  std::shared_ptr<igl::IDevice> iglDev = createVulkanTestDevice(config);
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+  auto& vulkanContext = static_cast<igl::vulkan::Device&>(*iglDev).getVulkanContext();
+  if (vulkanContext.numDynamicUniformBuffers_ == 0) {
+    GTEST_SKIP() << "Dynamic uniform buffers are not supported";
+  }
+
+  const VkDeviceSize alignment =
+      vulkanContext.getVkPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment;
+  const size_t numObjects = 4;
+  const size_t length = std::max<size_t>(alignment, 256) * numObjects;
+  std::shared_ptr<IBuffer> buffer = iglDev->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Uniform, nullptr, length, ResourceStorage::Shared),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto* uniformBuffer = static_cast<igl::vulkan::Buffer*>(buffer.get());
+
+  const auto& wrapper = vulkanContext.immediate_->acquire();
+  auto& dsets = vulkanContext.transientDSets_[wrapper.handle_.bufferIndex_];
+  const uint64_t numSetsBefore = dsets.buffersUniform->getStats().numAllocatedSets;
+
+  // every object of the ring is bound at its own offset: only the first bind writes descriptors
+  igl::vulkan::ResourcesBinder binder(
+      wrapper.cmdBuf_, dsets, vulkanContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
+  for (size_t i = 0; i != numObjects; i++) {
+    binder.bindUniformBuffer(0, uniformBuffer, i * (length / numObjects));
+    binder.updateBindings();
+  }
+  ASSERT_EQ(dsets.buffersUniform->getStats().numAllocatedSets - numSetsBefore, 1u);
+
+  const auto handle = vulkanContext.immediate_->submit(wrapper);
+  vulkanContext.markSubmit(handle);
+  vulkanContext.immediate_->wait(handle);
+}
+
+GTEST_TEST(VulkanContext, DeviceGroup) {
+  const igl::vulkan::VulkanContextConfig config = makeTestContextConfig();
+
+  Result ret;
+  auto group = igl::vulkan::DeviceGroup::create(
+      config, HWDeviceQueryDesc(HWDeviceType::Unknown), 0, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_NE(group, nullptr);
+  ASSERT_GE(group->getNumDevices(), 1u);
+
+  // a second group drives the same GPUs with independent contexts
+  auto other = igl::vulkan::DeviceGroup::create(
+      config, HWDeviceQueryDesc(HWDeviceType::Unknown), 1, &ret);
+  ASSERT_TRUE(ret.isOk()) << ret.message;
+  ASSERT_EQ(other->getNumDevices(), 1u);
+
+  for (auto* devices : {group.get(), other.get()}) {
+    for (size_t i = 0; i != devices->getNumDevices(); i++) {
+      ASSERT_EQ(devices->nextDeviceIndex(), i);
+      // every device drives the physical device enumerated by its own VkInstance
+      const auto& ctx =
+          static_cast<igl::vulkan::Device&>(devices->getDevice(i)).getVulkanContext();
+      ASSERT_EQ((uintptr_t)ctx.getVkPhysicalDevice(), devices->getDeviceDesc(i).guid);
+      auto buffer = devices->getDevice(i).createBuffer(
+          BufferDesc(BufferDesc::BufferTypeBits::Uniform, nullptr, 256, ResourceStorage::Shared),
+          &ret);
+      ASSERT_TRUE(ret.isOk());
+      ASSERT_NE(buffer, nullptr);
+    }
+    ASSERT_EQ(devices->nextDeviceIndex(), 0u);
+  }
+}
+
+TEST_F(DeviceVulkanTest, RecordCommandBuffersOnThreads) {
+  Result ret;
+  auto cmdQueue = iglDev_->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(cmdQueue, nullptr);
+
+  constexpr size_t kNumThreads = 4;
+
+  std::shared_ptr<ICommandBuffer> cmdBuffers[kNumThreads];
+  std::thread threads[kNumThreads];
+
+  for (size_t i = 0; i != kNumThreads; i++) {
+    threads[i] = std::thread([&cmdQueue, &cmdBuffers, i]() {
+      cmdBuffers[i] = cmdQueue->createCommandBuffer({}, nullptr);
+      cmdBuffers[i]->pushDebugGroupLabel("RecordCommandBuffersOnThreads", igl::Color(1, 0, 0));
+      cmdBuffers[i]->popDebugGroupLabel();
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  SubmitHandle handles[kNumThreads] = {};
+  for (size_t i = 0; i != kNumThreads; i++) {
+    ASSERT_NE(cmdBuffers[i], nullptr);
+    handles[i] = cmdQueue->submit(*cmdBuffers[i]);
+    ASSERT_NE(handles[i], 0u);
+  }
+
+  // the last submitted command buffer completes after all the previous ones
+  cmdBuffers[kNumThreads - 1]->waitUntilCompleted();
+
+  auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
+  for (size_t i = 0; i != kNumThreads; i++) {
+    ASSERT_TRUE(
+        ctx.immediate_->isReady(igl::vulkan::VulkanImmediateCommands::SubmitHandle(handles[i])));
+  }
+}
+
+/// ImmutableSamplers
+/// The samplers of RenderPipelineDesc::immutableSamplers are baked into a layout of the pipeline;
+/// textures in their slots need no bound sampler.
+TEST_F(DeviceVulkanTest, ImmutableSamplers) {
+  Result ret;
+  std::shared_ptr<ISamplerState> sampler =
+      iglDev_->createSamplerState(SamplerStateDesc::newLinear(), &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  std::unique_ptr<IShaderStages> stages;
+  util::createSimpleShaderStages(iglDev_, stages, TextureFormat::RGBA_UNorm8);
+
+  RenderPipelineDesc desc;
+  desc.shaderStages = std::move(stages);
+  desc.targetDesc.colorAttachments.resize(1);
+  desc.targetDesc.colorAttachments[0].textureFormat = TextureFormat::RGBA_UNorm8;
+  desc.immutableSamplers[0] = sampler;
+
+  RenderPipelineDesc outOfRange = desc;
+  outOfRange.immutableSamplers[IGL_TEXTURE_SAMPLERS_MAX] = sampler;
+  ASSERT_EQ(iglDev_->createRenderPipeline(outOfRange, &ret), nullptr);
+  ASSERT_EQ(ret.code, Result::Code::ArgumentOutOfRange);
+
+  auto pipelineState = iglDev_->createRenderPipeline(desc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(pipelineState, nullptr);
+  const auto* layout = static_cast<const igl::vulkan::RenderPipelineState&>(*pipelineState)
+                           .getImmutableSamplersLayout();
+  ASSERT_NE(layout, nullptr);
+  ASSERT_NE(layout->samplers[0], nullptr);
+  ASSERT_EQ(layout->samplers[1], nullptr);
+
+  auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
+  const auto& wrapper = ctx.immediate_->acquire();
+  auto& dsets = ctx.transientDSets_[wrapper.handle_.bufferIndex_];
+
+  auto texture = iglDev_->createTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8, 1, 1, TextureDesc::TextureUsageBits::Sampled),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  igl::vulkan::ResourcesBinder binder(
+      wrapper.cmdBuf_, dsets, ctx, VK_PIPELINE_BIND_POINT_GRAPHICS);
+  binder.bindImmutableSamplersLayout(layout);
+  binder.bindTexture(0, static_cast<igl::vulkan::Texture*>(texture.get()));
+  if (dsets.combinedImageSamplers) {
+    // the set of the pipeline layout comes from the pools of the regular texture sets
+    const uint64_t numSetsBefore = dsets.combinedImageSamplers->getStats().numAllocatedSets;
+    binder.updateBindings();
+    ASSERT_EQ(dsets.combinedImageSamplers->getStats().numAllocatedSets - numSetsBefore, 1u);
+  } else {
+    binder.updateBindings();
+  }
+
+  const auto handle = ctx.immediate_->submit(wrapper);
+  ctx.markSubmit(handle);
+  ctx.immediate_->wait(handle);
+}
+
+/// CreateResourcesOnThreads
+/// Textures, buffers and samplers created and uploaded on several threads at once get distinct
+/// bindless slots and their data.
+TEST_F(DeviceVulkanTest, CreateResourcesOnThreads) {
+  constexpr size_t kNumThreads = 4;
+  constexpr size_t kNumResources = 16;
+
+  std::vector<std::shared_ptr<ITexture>> textures[kNumThreads];
+  std::vector<std::shared_ptr<IBuffer>> buffers[kNumThreads];
+  std::shared_ptr<ISamplerState> samplers[kNumThreads];
+  std::thread threads[kNumThreads];
+
+  for (size_t i = 0; i != kNumThreads; i++) {
+    threads[i] = std::thread([this, &textures, &buffers, &samplers, i]() {
+      const uint32_t pixel = 0xff000000u | static_cast<uint32_t>(i);
+      for (size_t j = 0; j != kNumResources; j++) {
+        auto texture = iglDev_->createTexture(
+            TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                               1,
+                               1,
+                               TextureDesc::TextureUsageBits::Sampled |
+                                   TextureDesc::TextureUsageBits::Attachment),
+            nullptr);
+        if (texture) {
+          texture->upload(TextureRangeDesc::new2D(0, 0, 1, 1), &pixel);
+        }
+        textures[i].push_back(std::move(texture));
+        buffers[i].push_back(iglDev_->createBuffer(
+            BufferDesc(BufferDesc::BufferTypeBits::Storage, &pixel, sizeof(pixel)), nullptr));
+      }
+      samplers[i] = iglDev_->createSamplerState(SamplerStateDesc::newLinear(), nullptr);
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  std::set<uint64_t> textureIds;
+  for (size_t i = 0; i != kNumThreads; i++) {
+    ASSERT_NE(samplers[i], nullptr);
+    ASSERT_EQ(samplers[i], samplers[0]);
+    for (size_t j = 0; j != kNumResources; j++) {
+      ASSERT_NE(textures[i][j], nullptr);
+      ASSERT_NE(buffers[i][j], nullptr);
+      ASSERT_TRUE(textureIds.insert(textures[i][j]->getTextureId()).second);
+    }
+  }
+
+  // the data uploaded by each thread ended up in its own texture
+  Result ret;
+  auto cmdQueue = iglDev_->createCommandQueue({CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  for (size_t i = 0; i != kNumThreads; i++) {
+    FramebufferDesc framebufferDesc;
+    framebufferDesc.colorAttachments[0].texture = textures[i].back();
+    auto framebuffer = iglDev_->createFramebuffer(framebufferDesc, &ret);
+    ASSERT_TRUE(ret.isOk());
+    uint32_t pixel = 0;
+    framebuffer->copyBytesColorAttachment(
+        *cmdQueue, 0, &pixel, TextureRangeDesc::new2D(0, 0, 1, 1));
+    ASSERT_EQ(pixel, 0xff000000u | static_cast<uint32_t>(i));
+  }
+}
 #endif
 
 } // namespace tests
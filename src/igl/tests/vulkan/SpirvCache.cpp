@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <igl/vulkan/SpirvCache.h>
+
+namespace igl {
+namespace tests {
+
+namespace {
+// any non-empty blob starting with the SPIR-V magic number
+const std::vector<uint32_t> kSPIRV = {0x07230203, 0x00010000, 0x0008000b, 0x00000010, 0x00000000};
+const char* kSource = "void main() {}";
+} // namespace
+
+TEST(SpirvCacheTest, InMemory) {
+  igl::vulkan::SpirvCache cache("", 1);
+
+  std::vector<uint32_t> spirv;
+  ASSERT_FALSE(cache.find(VK_SHADER_STAGE_VERTEX_BIT, kSource, spirv));
+
+  cache.insert(VK_SHADER_STAGE_VERTEX_BIT, kSource, kSPIRV);
+  ASSERT_EQ(cache.size(), 1u);
+
+  ASSERT_TRUE(cache.find(VK_SHADER_STAGE_VERTEX_BIT, kSource, spirv));
+  ASSERT_EQ(spirv, kSPIRV);
+
+  // the same source for a different stage is a different shader
+  ASSERT_FALSE(cache.find(VK_SHADER_STAGE_FRAGMENT_BIT, kSource, spirv));
+}
+
+TEST(SpirvCacheTest, OnDisk) {
+  const std::string dir = ::testing::TempDir();
+
+  {
+    igl::vulkan::SpirvCache cache(dir, 2);
+    cache.insert(VK_SHADER_STAGE_COMPUTE_BIT, kSource, kSPIRV);
+  }
+
+  std::vector<uint32_t> spirv;
+  {
+    // a fresh cache with the same salt picks up the file
+    igl::vulkan::SpirvCache cache(dir, 2);
+    ASSERT_TRUE(cache.find(VK_SHADER_STAGE_COMPUTE_BIT, kSource, spirv));
+    ASSERT_EQ(spirv, kSPIRV);
+    ASSERT_EQ(cache.size(), 1u);
+  }
+  {
+    // a different device salt should not see it
+    igl::vulkan::SpirvCache cache(dir, 3);
+    ASSERT_FALSE(cache.find(VK_SHADER_STAGE_COMPUTE_BIT, kSource, spirv));
+  }
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <igl/vulkan/VulkanShaderModule.h>
+
+namespace igl {
+namespace tests {
+
+namespace {
+constexpr uint32_t kOpDecorate4 = (4u << 16) | 71u; // OpDecorate <target> <decoration> <literal>
+constexpr uint32_t kDescriptorSet = 34;
+constexpr uint32_t kBinding = 33;
+constexpr uint32_t kOpDecorationGroup = (2u << 16) | 73u;
+constexpr uint32_t kOpFunction = (5u << 16) | 54u;
+
+std::vector<uint32_t> makeSPIRV(const std::vector<uint32_t>& instructions) {
+  std::vector<uint32_t> spirv = {0x07230203, 0x00010000, 0x0008000b, 0x00000010, 0x00000000};
+  spirv.insert(spirv.end(), instructions.begin(), instructions.end());
+  return spirv;
+}
+} // namespace
+
+TEST(VulkanShaderModuleTest, DescriptorSetMask) {
+  using igl::vulkan::getDescriptorSetMaskFromSPIRV;
+  using igl::vulkan::kAllDescriptorSets;
+
+  // no resources
+  const auto empty = makeSPIRV({});
+  ASSERT_EQ(getDescriptorSetMaskFromSPIRV(empty.data(), empty.size()), 0u);
+
+  // sets 0 and 2; bindings and decorations inside functions are ignored
+  const auto spirv = makeSPIRV({kOpDecorate4, 10, kDescriptorSet, 2,
+                                kOpDecorate4, 10, kBinding, 5,
+                                kOpDecorate4, 11, kDescriptorSet, 0,
+                                kOpFunction, 1, 2, 0, 3,
+                                kOpDecorate4, 12, kDescriptorSet, 1});
+  ASSERT_EQ(getDescriptorSetMaskFromSPIRV(spirv.data(), spirv.size()), 0b101u);
+
+  // anything which cannot be parsed uses all sets
+  ASSERT_EQ(getDescriptorSetMaskFromSPIRV(nullptr, 0), kAllDescriptorSets);
+  ASSERT_EQ(getDescriptorSetMaskFromSPIRV(spirv.data(), 3), kAllDescriptorSets);
+  const auto truncated = makeSPIRV({kOpDecorate4, 10, kDescriptorSet});
+  ASSERT_EQ(getDescriptorSetMaskFromSPIRV(truncated.data(), truncated.size()), kAllDescriptorSets);
+  const auto groups = makeSPIRV({kOpDecorationGroup, 10});
+  ASSERT_EQ(getDescriptorSetMaskFromSPIRV(groups.data(), groups.size()), kAllDescriptorSets);
+  std::vector<uint32_t> notSPIRV = spirv;
+  notSPIRV[0] = 0;
+  ASSERT_EQ(getDescriptorSetMaskFromSPIRV(notSPIRV.data(), notSPIRV.size()), kAllDescriptorSets);
+}
+
+TEST(VulkanShaderModuleTest, RelaxPrecision) {
+  using igl::vulkan::relaxPrecisionOfSPIRV;
+
+  const auto op = [](uint32_t opcode, uint32_t wordCount) { return (wordCount << 16) | opcode; };
+  // "GLSL.std.450" and "outColor", null-terminated
+  const uint32_t glslStd450[] = {0x4c534c47, 0x6474732e, 0x3035342e, 0};
+  const uint32_t outColor[] = {0x4374756f, 0x726f6c6f, 0};
+  // uniform sampler2D tex; uniform sampler2DShadow shadowTex; uniform vec4 tint; in vec2 uv;
+  // out vec4 outColor; out vec4 outDepth;
+  // void main() {
+  //   vec4 color = texture(tex, uv) * tint * 0.5;
+  //   outColor = clamp(color, 0.5, 0.5);
+  //   outDepth = texture(shadowTex, uv) + color;
+  // }
+  auto spirv = makeSPIRV({
+      // clang-format off
+      op(11, 6), 1, glslStd450[0], glslStd450[1], glslStd450[2], glslStd450[3],
+      op(5, 5), 20, outColor[0], outColor[1], outColor[2],
+      op(19, 2), 2,                       // void
+      op(22, 3), 3, 32,                   // float
+      op(23, 4), 4, 3, 4,                 // vec4
+      op(25, 9), 5, 3, 1, 0, 0, 0, 1, 0,  // texture2D
+      op(27, 3), 6, 5,                    // sampler2D
+      op(32, 4), 7, 0, 6,
+      op(59, 4), 7, 8, 0,                 // tex
+      op(23, 4), 9, 3, 2,                 // vec2
+      op(32, 4), 10, 1, 9,
+      op(59, 4), 10, 11, 1,               // uv
+      op(32, 4), 12, 3, 4,
+      op(59, 4), 12, 20, 3,               // outColor
+      op(59, 4), 12, 35, 3,               // outDepth
+      op(43, 4), 3, 13, 0x3f000000,       // 0.5
+      op(32, 4), 14, 2, 4,
+      op(59, 4), 14, 15, 2,               // tint
+      op(25, 9), 16, 3, 1, 1, 0, 0, 1, 0, // texture2D with depth
+      op(27, 3), 17, 16,
+      op(32, 4), 18, 0, 17,
+      op(59, 4), 18, 19, 0,               // shadowTex
+      op(32, 4), 38, 7, 4,
+      op(33, 3), 21, 2,
+      op(54, 5), 22, 2, 0, 21,
+      op(248, 2), 23,
+      op(59, 4), 38, 37, 7,               // color
+      op(61, 4), 6, 24, 8,
+      op(61, 4), 9, 25, 11,
+      op(87, 5), 4, 26, 24, 25,
+      op(61, 4), 4, 27, 15,
+      op(133, 5), 4, 28, 26, 27,
+      op(142, 5), 4, 29, 28, 13,
+      op(62, 3), 37, 29,
+      op(61, 4), 4, 39, 37,
+      op(12, 8), 4, 33, 1, 43, 39, 13, 13,
+      op(62, 3), 20, 33,
+      op(61, 4), 17, 30, 19,
+      op(87, 5), 4, 31, 30, 25,
+      op(129, 5), 4, 32, 31, 39,
+      op(62, 3), 35, 32,
+      op(253, 1),
+      op(56, 1),
+      // clang-format on
+  });
+  spirv[3] = 40;
+  const size_t size = spirv.size();
+
+  std::vector<std::string> names;
+  // the sample of tex, the products, color and its load, clamp() and outColor
+  ASSERT_EQ(relaxPrecisionOfSPIRV(spirv, &names), 7u);
+  ASSERT_EQ(names, std::vector<std::string>{"outColor"});
+  ASSERT_EQ(spirv.size(), size + 7 * 3);
+  // the decorations precede the types
+  const size_t decorations = 5 + 6 + 5;
+  ASSERT_EQ(spirv[decorations], op(71, 3));
+  ASSERT_EQ(spirv[decorations + 1], 20u);
+  ASSERT_EQ(spirv[decorations + 2], 0u);
+  ASSERT_EQ(spirv[decorations + 3 * 7], op(19, 2));
+  std::vector<uint32_t> relaxed;
+  for (size_t i = decorations; i != decorations + 3 * 7; i += 3) {
+    relaxed.push_back(spirv[i + 1]);
+  }
+  ASSERT_EQ(relaxed, (std::vector<uint32_t>{20, 26, 28, 29, 33, 37, 39}));
+
+  // already decorated values are not decorated again
+  ASSERT_EQ(relaxPrecisionOfSPIRV(spirv), 0u);
+
+  std::vector<uint32_t> notSPIRV = {0, 1, 2};
+  ASSERT_EQ(relaxPrecisionOfSPIRV(notSPIRV), 0u);
+  ASSERT_EQ(notSPIRV.size(), 3u);
+}
+
+} // namespace tests
+} // namespace igl
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <igl/vulkan/VulkanValidationFilter.h>
+
+namespace igl {
+namespace tests {
+
+TEST(VulkanValidationFilterTest, Unlimited) {
+  igl::vulkan::VulkanValidationFilter filter(0, 0);
+  for (int i = 0; i != 10; i++) {
+    ASSERT_TRUE(filter.shouldLog(42, 1));
+  }
+  ASSERT_EQ(filter.getCount(42), 10u);
+  ASSERT_EQ(filter.getNumSuppressed(), 0u);
+}
+
+TEST(VulkanValidationFilterTest, Deduplication) {
+  igl::vulkan::VulkanValidationFilter filter(2, 0);
+  ASSERT_TRUE(filter.shouldLog(42, 1));
+  ASSERT_TRUE(filter.shouldLog(42, 1));
+  ASSERT_FALSE(filter.shouldLog(42, 1));
+  // counted across frames
+  ASSERT_FALSE(filter.shouldLog(42, 2));
+  ASSERT_TRUE(filter.shouldLog(7, 2));
+
+  ASSERT_EQ(filter.getCount(42), 4u);
+  ASSERT_EQ(filter.getCount(7), 1u);
+  ASSERT_EQ(filter.getCount(1), 0u);
+  ASSERT_EQ(filter.getNumSuppressed(), 2u);
+}
+
+TEST(VulkanValidationFilterTest, FrameBudget) {
+  igl::vulkan::VulkanValidationFilter filter(0, 3);
+  int numLogged = 0;
+  for (int i = 0; i != 10; i++) {
+    numLogged += filter.shouldLog(i, 1) ? 1 : 0;
+  }
+  ASSERT_EQ(numLogged, 3);
+  ASSERT_EQ(filter.getNumSuppressed(), 7u);
+
+  // a new frame starts with a new budget
+  ASSERT_TRUE(filter.shouldLog(0, 2));
+}
+
+} // namespace tests
+} // namespace igl
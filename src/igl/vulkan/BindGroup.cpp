@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/BindGroup.h>
+
+#include <igl/vulkan/SamplerState.h>
+#include <igl/vulkan/Texture.h>
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl {
+namespace vulkan {
+
+BindGroup::BindGroup(const VulkanContext& ctx, const BindGroupDesc& desc) :
+  IBindGroup(desc), ctx_(ctx) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  if (getTextureMask() == 0) {
+    return;
+  }
+
+  for (size_t i = 0; i != IGL_TEXTURE_SAMPLERS_MAX; i++) {
+    auto* texture = static_cast<Texture*>(desc.textures[i].get());
+    if (texture) {
+      // the combined image samplers of the slots cannot hold the immutable samplers of YUV textures
+      IGL_ASSERT_MSG(!texture->getProperties().isMultiPlanar(),
+                     "YUV textures are only accessible through kTexturesYUV_* bindless arrays");
+      bindingsTextures_.textures[i] = &texture->getVulkanTexture();
+    }
+    auto* sampler = static_cast<SamplerState*>(desc.samplers[i].get());
+    bindingsTextures_.samplers[i] = sampler ? sampler->sampler_.get() : nullptr;
+  }
+
+  dsetTextures_ = ctx_.createPersistentTexturesDescriptorSet(
+      bindingsTextures_,
+      (std::string("Descriptor Set: ") + desc.debugName + " (BindGroup)").c_str(),
+      pool_);
+}
+
+BindGroup::~BindGroup() {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
+
+  if (pool_ != VK_NULL_HANDLE) {
+    // the set can still be used by command buffers in flight
+    ctx_.deferredTask(std::packaged_task<void()>(
+        [device = ctx_.getVkDevice(), pool = pool_]() {
+          vkDestroyDescriptorPool(device, pool, nullptr);
+        }));
+  }
+}
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/BindGroup.h>
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/ResourcesBinder.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanContext;
+
+/**
+ * @brief A bind group whose textures and samplers are written once into a persistent descriptor
+ * set of VulkanContext::dslCombinedImageSamplers_, allocated from a descriptor pool of its own.
+ * Binding the group binds that set instead of writing a transient one. The buffers are bound
+ * through ResourcesBinder like individual binds, as their descriptor sets use dynamic offsets or
+ * push descriptors. With descriptor buffers there is no persistent set and the group binds its
+ * slots one by one.
+ */
+class BindGroup final : public IBindGroup {
+ public:
+  BindGroup(const VulkanContext& ctx, const BindGroupDesc& desc);
+  ~BindGroup() override;
+
+  BindGroup(const BindGroup&) = delete;
+  BindGroup& operator=(const BindGroup&) = delete;
+
+  /// VK_NULL_HANDLE if the group has no textures or with descriptor buffers
+  [[nodiscard]] VkDescriptorSet getTexturesDescriptorSet() const {
+    return dsetTextures_;
+  }
+  /// The texture bindings written into getTexturesDescriptorSet()
+  [[nodiscard]] const BindingsTextures& getBindingsTextures() const {
+    return bindingsTextures_;
+  }
+
+ private:
+  const VulkanContext& ctx_;
+  BindingsTextures bindingsTextures_;
+  VkDescriptorPool pool_ = VK_NULL_HANDLE;
+  VkDescriptorSet dsetTextures_ = VK_NULL_HANDLE;
+};
+
+} // namespace vulkan
+} // namespace igl
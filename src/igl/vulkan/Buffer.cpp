@@ -9,6 +9,7 @@
 #include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/Device.h>
+#include <igl/vulkan/Readback.h>
 #include <igl/vulkan/SyncManager.h>
 #include <igl/vulkan/VulkanBuffer.h>
 #include <igl/vulkan/VulkanContext.h>
@@ -25,6 +26,20 @@ namespace vulkan {
 
 Buffer::Buffer(const igl::vulkan::Device& device) : device_(device) {}
 
+Buffer::~Buffer() {
+  if (isPooled()) {
+    const VulkanContext& ctx = device_.getVulkanContext();
+    // the block is kept alive by the pool: the task must not release the last reference to it
+    VulkanBufferPool::Allocation allocation = poolAllocation_;
+    allocation.buffer = nullptr;
+    // the range can be reused once the GPU is done with it
+    ctx.deferredTask(std::packaged_task<void()>(
+        [pool = ctx.bufferPool_.get(), allocation = std::move(allocation)]() {
+          pool->free(allocation);
+        }));
+  }
+}
+
 Result Buffer::create(const BufferDesc& desc) {
   desc_ = desc;
 
@@ -34,12 +49,13 @@ Result Buffer::create(const BufferDesc& desc) {
     desc_.storage = ResourceStorage::Shared;
   }
 
-  /* Use staging device to transfer data into the buffer when the storage is private to the device
+  /* Use staging device to transfer data into the buffer when the storage is private to the device.
+   * All buffers can be copied from by asynchronous readbacks.
    */
   VkBufferUsageFlags usageFlags =
       (desc_.storage == ResourceStorage::Private)
           ? VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
-          : 0;
+          : VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
   const VkBufferUsageFlags optionalBDA =
       ctx.config_.enableBufferDeviceAddress ? VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR : 0;
@@ -82,12 +98,26 @@ Result Buffer::create(const BufferDesc& desc) {
 
   buffers_.reserve(numBuffers);
   bufferPatches_.resize(numBuffers, BufferRange());
+
+  // small buffers share VkBuffers; ring buffers and explicit memory priorities need their own
+  const bool isUniformRangeValid =
+      !(usageFlags & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) ||
+      desc_.length <= ctx.getVkPhysicalDeviceProperties().limits.maxUniformBufferRange;
+  if (ctx.bufferPool_ && !isRingBuffer_ && desc_.memoryPriority == 0.5f && isUniformRangeValid &&
+      desc_.length <= ctx.config_.bufferPoolMaxAllocationSize &&
+      ctx.bufferPool_->allocate(desc_.length, usageFlags, memFlags, poolAllocation_)) {
+    buffers_.push_back(poolAllocation_.buffer);
+    return Result();
+  }
+
   Result result;
   for (size_t bufferIndex = 0; bufferIndex < numBuffers; ++bufferIndex) {
     std::string bufferName = desc_.debugName + " - sub-buffer " + std::to_string(bufferIndex);
-    buffers_.emplace_back(
-        ctx.createBuffer(desc_.length, usageFlags, memFlags, &result, bufferName.c_str()));
-    IGL_VERIFY(result.isOk());
+    buffers_.emplace_back(ctx.createBuffer(
+        desc_.length, usageFlags, memFlags, &result, bufferName.c_str(), desc_.memoryPriority));
+    if (IGL_VERIFY(result.isOk()) && ctx.config_.defragmentationMaxBytesPerFrame) {
+      buffers_.back()->allowDefragmentation();
+    }
   }
 
   return result;
@@ -134,6 +164,10 @@ void Buffer::resetUpdateRange(uint32_t ringBufferIndex, const BufferRange& range
 }
 
 igl::Result Buffer::upload(const void* data, const BufferRange& range) {
+  return upload(data, range, false);
+}
+
+igl::Result Buffer::upload(const void* data, const BufferRange& range, bool isInitialData) {
   IGL_PROFILER_FUNCTION();
 
   if (!IGL_VERIFY(data)) {
@@ -166,12 +200,17 @@ igl::Result Buffer::upload(const void* data, const BufferRange& range) {
     }
     // use staging to upload data to device-local buffers
     ctx.stagingDevice_->bufferSubData(*currentVulkanBuffer(),
-                                      currentUpdateRange.offset,
+                                      getVkBufferOffset() + currentUpdateRange.offset,
                                       currentUpdateRange.size,
-                                      localData_.get() + currentUpdateRange.offset);
+                                      localData_.get() + currentUpdateRange.offset,
+                                      isInitialData);
   } else {
     // use staging to upload data to device-local buffers
-    ctx.stagingDevice_->bufferSubData(*currentVulkanBuffer(), range.offset, range.size, data);
+    ctx.stagingDevice_->bufferSubData(*currentVulkanBuffer(),
+                                      getVkBufferOffset() + range.offset,
+                                      range.size,
+                                      data,
+                                      isInitialData);
   }
   return igl::Result();
 }
@@ -184,13 +223,35 @@ uint64_t Buffer::gpuAddress(size_t offset) const {
   IGL_ASSERT_MSG((offset & 7) == 0,
                  "Buffer offset must be 8 bytes aligned as per GLSL_EXT_buffer_reference spec.");
 
-  return (uint64_t)currentVulkanBuffer()->getVkDeviceAddress() + offset;
+  return (uint64_t)currentVulkanBuffer()->getVkDeviceAddress() + getVkBufferOffset() + offset;
 }
 
 VkBuffer Buffer::getVkBuffer() const {
   return currentVulkanBuffer()->getVkBuffer();
 }
 
+std::shared_ptr<IReadback> Buffer::readAsync(ICommandQueue& /*cmdQueue*/,
+                                             const BufferRange& range,
+                                             Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  if (range.size == 0 || range.size > desc_.length || range.offset > desc_.length - range.size) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Range exceeds buffer length");
+    return nullptr;
+  }
+
+  const VulkanContext& ctx = device_.getVulkanContext();
+  const uint64_t readbackId = ctx.stagingDevice_->getBufferSubDataAsync(
+      *currentVulkanBuffer(), getVkBufferOffset() + range.offset, range.size);
+  if (readbackId == 0) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot allocate a readback buffer");
+    return nullptr;
+  }
+
+  Result::setOk(outResult);
+  return std::make_shared<Readback>(ctx, readbackId, range.size);
+}
+
 void* Buffer::map(const BufferRange& range, igl::Result* outResult) {
   IGL_ASSERT_MSG(!isRingBuffer_, "Buffer::map() operation not supported for ring buffer");
 
@@ -218,11 +279,12 @@ void* Buffer::map(const BufferRange& range, igl::Result* outResult) {
     // handle DEVICE_LOCAL buffers
     tmpBuffer_.resize(range.size);
     const VulkanContext& ctx = device_.getVulkanContext();
-    ctx.stagingDevice_->getBufferSubData(*buffer, range.offset, range.size, tmpBuffer_.data());
+    ctx.stagingDevice_->getBufferSubData(
+        *buffer, getVkBufferOffset() + range.offset, range.size, tmpBuffer_.data());
     return tmpBuffer_.data();
   }
 
-  return buffer->getMappedPtr() + range.offset;
+  return buffer->getMappedPtr() + getVkBufferOffset() + range.offset;
 }
 
 void Buffer::unmap() {
@@ -235,7 +297,7 @@ void Buffer::unmap() {
     // handle DEVICE_LOCAL buffers
     upload(tmpBuffer_.data(), range);
   } else if (!buffer->isCoherentMemory()) {
-    buffer->flushMappedMemory(range.offset, range.size);
+    buffer->flushMappedMemory(getVkBufferOffset() + range.offset, range.size);
   }
   mappedRange_.size = 0;
 }
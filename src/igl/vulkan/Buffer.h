@@ -9,6 +9,7 @@
 
 #include <igl/Buffer.h>
 #include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanBufferPool.h>
 
 namespace igl {
 namespace vulkan {
@@ -21,7 +22,7 @@ class Buffer final : public igl::IBuffer {
 
  public:
   explicit Buffer(const igl::vulkan::Device& device);
-  ~Buffer() override = default;
+  ~Buffer() override;
 
   Result upload(const void* data, const BufferRange& range) override;
 
@@ -35,15 +36,32 @@ class Buffer final : public igl::IBuffer {
 
   size_t getSizeInBytes() const override;
   uint64_t gpuAddress(size_t offset) const override;
+  std::shared_ptr<IReadback> readAsync(ICommandQueue& cmdQueue,
+                                       const BufferRange& range,
+                                       Result* outResult) override;
 
   VkBuffer getVkBuffer() const;
+  // offset of this buffer inside getVkBuffer(): non-zero if it is sub-allocated from a shared
+  // VkBuffer (see VulkanContextConfig::bufferPoolMaxAllocationSize)
+  [[nodiscard]] VkDeviceSize getVkBufferOffset() const {
+    return poolAllocation_.offset;
+  }
+  // range of a descriptor bound at `offset`
+  [[nodiscard]] VkDeviceSize getVkDescriptorRange(size_t offset) const {
+    return isPooled() ? desc_.length - offset : VK_WHOLE_SIZE;
+  }
   BufferDesc::BufferType getBufferType() const {
     return desc_.type;
   }
 
  private:
   Result create(const BufferDesc& desc);
+  // `isInitialData` - the data of BufferDesc::data: the GPU cannot be using the buffer yet
+  Result upload(const void* data, const BufferRange& range, bool isInitialData);
   [[nodiscard]] const std::shared_ptr<VulkanBuffer>& currentVulkanBuffer() const;
+  [[nodiscard]] bool isPooled() const {
+    return poolAllocation_.buffer != nullptr;
+  }
 
  private:
   const igl::vulkan::Device& device_;
@@ -51,6 +69,8 @@ class Buffer final : public igl::IBuffer {
   bool isRingBuffer_ = false;
   uint32_t previousBufferIndex_ = UINT32_MAX;
   std::vector<std::shared_ptr<VulkanBuffer>> buffers_;
+  // the range of buffers_[0] owned by this buffer if it is pooled
+  VulkanBufferPool::Allocation poolAllocation_;
   std::unique_ptr<uint8_t[]> localData_;
   std::vector<BufferRange> bufferPatches_;
 
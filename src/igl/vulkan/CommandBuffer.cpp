@@ -11,8 +11,10 @@
 #include <igl/vulkan/ComputeCommandEncoder.h>
 #include <igl/vulkan/EnhancedShaderDebuggingStore.h>
 #include <igl/vulkan/Framebuffer.h>
+#include <igl/vulkan/ParallelRenderCommandEncoder.h>
 #include <igl/vulkan/RenderCommandEncoder.h>
 #include <igl/vulkan/Texture.h>
+#include <igl/vulkan/TimestampQueryPool.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanImage.h>
 #include <igl/vulkan/VulkanTexture.h>
@@ -20,9 +22,17 @@
 namespace igl {
 namespace vulkan {
 
-CommandBuffer::CommandBuffer(VulkanContext& ctx, CommandBufferDesc desc) :
-  ctx_(ctx), wrapper_(ctx_.immediate_->acquire()), desc_(std::move(desc)) {
+CommandBuffer::CommandBuffer(VulkanContext& ctx,
+                             CommandBufferDesc desc,
+                             VulkanImmediateCommands& commands) :
+  ctx_(ctx),
+  commands_(commands),
+  isAsyncCompute_(&commands != ctx.immediate_.get()),
+  wrapper_(commands_.acquire()),
+  desc_(std::move(desc)) {
   IGL_ASSERT(wrapper_.cmdBuf_ != VK_NULL_HANDLE);
+  IGL_PROFILER_ZONE_GPU_BEGIN_VK(
+      tracyGpuZone_, "CommandBuffer", ctx_.getTracyContext(), wrapper_.cmdBuf_);
 }
 
 std::unique_ptr<IComputeCommandEncoder> CommandBuffer::createComputeCommandEncoder() {
@@ -56,15 +66,7 @@ void transitionColorAttachment(VkCommandBuffer buffer, const std::shared_ptr<ITe
 
 } // namespace
 
-std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder(
-    const RenderPassDesc& renderPass,
-    std::shared_ptr<IFramebuffer> framebuffer,
-    Result* outResult) {
-  IGL_PROFILER_FUNCTION();
-  IGL_ASSERT(framebuffer);
-
-  framebuffer_ = framebuffer;
-
+void CommandBuffer::prepareAttachments(const std::shared_ptr<IFramebuffer>& framebuffer) {
   // prepare all the color attachments
   const auto& indices = framebuffer->getColorAttachmentIndices();
   for (auto i : indices) {
@@ -92,6 +94,24 @@ std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, // wait for subsequent fragment shaders
         VkImageSubresourceRange{flags, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
   }
+}
+
+std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder(
+    const RenderPassDesc& renderPass,
+    std::shared_ptr<IFramebuffer> framebuffer,
+    Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(framebuffer);
+
+  if (isAsyncCompute_) {
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "Compute command queues cannot render");
+    return nullptr;
+  }
+
+  framebuffer_ = framebuffer;
+
+  prepareAttachments(framebuffer);
 
   auto encoder =
       RenderCommandEncoder::create(shared_from_this(), ctx_, renderPass, framebuffer, outResult);
@@ -106,10 +126,32 @@ std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder
   return encoder;
 }
 
+std::unique_ptr<IParallelRenderCommandEncoder> CommandBuffer::createParallelRenderCommandEncoder(
+    const RenderPassDesc& renderPass,
+    std::shared_ptr<IFramebuffer> framebuffer,
+    Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(framebuffer);
+
+  if (isAsyncCompute_) {
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "Compute command queues cannot render");
+    return nullptr;
+  }
+
+  framebuffer_ = framebuffer;
+
+  prepareAttachments(framebuffer);
+
+  return ParallelRenderCommandEncoder::create(
+      shared_from_this(), ctx_, renderPass, framebuffer, outResult);
+}
+
 void CommandBuffer::present(std::shared_ptr<ITexture> surface) const {
   IGL_PROFILER_FUNCTION();
 
   IGL_ASSERT(surface);
+  IGL_ASSERT_MSG(!isAsyncCompute_, "Compute command queues cannot present");
 
   presentedSurface_ = surface;
 
@@ -162,14 +204,115 @@ void CommandBuffer::popDebugGroupLabel() const {
   ivkCmdEndDebugUtilsLabel(wrapper_.cmdBuf_);
 }
 
+void CommandBuffer::writeTimestamp(ITimestampQueryPool& pool, uint32_t queryIndex) {
+  static_cast<TimestampQueryPool&>(pool).writeTimestamp(wrapper_.cmdBuf_, queryIndex);
+}
+
+void CommandBuffer::copyBufferToTexture(IBuffer& buffer,
+                                        size_t bufferOffset,
+                                        ITexture& texture,
+                                        const TextureRangeDesc& range) {
+  IGL_PROFILER_FUNCTION();
+
+  const auto& vkBuffer = static_cast<Buffer&>(buffer);
+  const auto& vkTex = static_cast<Texture&>(texture);
+  const VulkanImage& img = vkTex.getVulkanTexture().getVulkanImage();
+  const TextureFormatProperties properties = texture.getProperties();
+  if (!IGL_VERIFY(!properties.isDepthOrStencil() && range.numMipLevels == 1 &&
+                  texture.getType() != TextureType::Cube && texture.validateRange(range).isOk())) {
+    return;
+  }
+
+  const bool is3D = texture.getType() == TextureType::ThreeD;
+  const VkDeviceSize srcOffset = vkBuffer.getVkBufferOffset() + bufferOffset;
+  const VkDeviceSize size = properties.getBytesPerRange(range);
+  IGL_ASSERT(bufferOffset + size <= buffer.getSizeInBytes());
+  const VkPipelineStageFlags shaderStages =
+      isAsyncCompute_ ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                      : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+  // the data may have been written by compute shaders or transfers
+  ivkBufferMemoryBarrier(wrapper_.cmdBuf_,
+                         vkBuffer.getVkBuffer(),
+                         VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                         VK_ACCESS_TRANSFER_READ_BIT,
+                         srcOffset,
+                         size,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+  const VkImageSubresourceRange subresourceRange = {
+      VK_IMAGE_ASPECT_COLOR_BIT,
+      static_cast<uint32_t>(range.mipLevel),
+      1,
+      is3D ? 0 : static_cast<uint32_t>(range.layer),
+      is3D ? 1 : static_cast<uint32_t>(range.numLayers),
+  };
+  img.transitionLayout(wrapper_.cmdBuf_,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       shaderStages | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       subresourceRange);
+
+  const VkBufferImageCopy copy = {
+      srcOffset,
+      0, // tightly packed rows
+      0,
+      VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT,
+                               subresourceRange.baseMipLevel,
+                               subresourceRange.baseArrayLayer,
+                               subresourceRange.layerCount},
+      VkOffset3D{static_cast<int32_t>(range.x),
+                 static_cast<int32_t>(range.y),
+                 is3D ? static_cast<int32_t>(range.z) : 0},
+      VkExtent3D{static_cast<uint32_t>(range.width),
+                 static_cast<uint32_t>(range.height),
+                 is3D ? static_cast<uint32_t>(range.depth) : 1u},
+  };
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("%p vkCmdCopyBufferToImage()\n", wrapper_.cmdBuf_);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+  vkCmdCopyBufferToImage(wrapper_.cmdBuf_,
+                         vkBuffer.getVkBuffer(),
+                         img.getVkImage(),
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         1,
+                         &copy);
+
+  img.transitionLayout(wrapper_.cmdBuf_,
+                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       shaderStages,
+                       subresourceRange);
+
+  // the buffer can be written again by the dispatches encoded after the copy
+  ivkBufferMemoryBarrier(wrapper_.cmdBuf_,
+                         vkBuffer.getVkBuffer(),
+                         VK_ACCESS_TRANSFER_READ_BIT,
+                         VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                         srcOffset,
+                         size,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+}
+
 void CommandBuffer::waitUntilCompleted() {
-  ctx_.immediate_->wait(lastSubmitHandle_);
+  commands_.wait(lastSubmitHandle_);
 
   lastSubmitHandle_ = VulkanImmediateCommands::SubmitHandle();
 }
 
 void CommandBuffer::waitUntilScheduled() {}
 
+void CommandBuffer::addCompletedHandler(std::function<void()> handler) {
+  IGL_ASSERT_MSG(!isSubmitted_, "Completed handlers have to be added before the submit");
+  completedHandlers_.push_back(std::move(handler));
+}
+
+bool CommandBuffer::isCompleted() const {
+  return isSubmitted_ && commands_.isReady(lastSubmitHandle_);
+}
+
 std::shared_ptr<igl::IFramebuffer> CommandBuffer::getFramebuffer() const {
   return framebuffer_;
 }
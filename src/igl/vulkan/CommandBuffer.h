@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <igl/CommandBuffer.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanImmediateCommands.h>
@@ -20,7 +22,8 @@ class VulkanContext;
 class CommandBuffer final : public ICommandBuffer,
                             public std::enable_shared_from_this<CommandBuffer> {
  public:
-  CommandBuffer(VulkanContext& ctx, CommandBufferDesc desc);
+  // `commands` are the immediate commands of the queue the command buffer is submitted to
+  CommandBuffer(VulkanContext& ctx, CommandBufferDesc desc, VulkanImmediateCommands& commands);
 
   std::unique_ptr<IComputeCommandEncoder> createComputeCommandEncoder() override;
 
@@ -29,32 +32,63 @@ class CommandBuffer final : public ICommandBuffer,
       std::shared_ptr<IFramebuffer> framebuffer,
       Result* outResult) override;
 
+  std::unique_ptr<IParallelRenderCommandEncoder> createParallelRenderCommandEncoder(
+      const RenderPassDesc& renderPass,
+      std::shared_ptr<IFramebuffer> framebuffer,
+      Result* outResult) override;
+
   void present(std::shared_ptr<ITexture> surface) const override;
 
   void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
 
   void popDebugGroupLabel() const override;
 
+  void writeTimestamp(ITimestampQueryPool& pool, uint32_t queryIndex) override;
+
+  void copyBufferToTexture(IBuffer& buffer,
+                           size_t bufferOffset,
+                           ITexture& texture,
+                           const TextureRangeDesc& range) override;
+
   void waitUntilCompleted() override;
 
   void waitUntilScheduled() override;
 
+  void addCompletedHandler(std::function<void()> handler) override;
+
+  [[nodiscard]] bool isCompleted() const override;
+
   VkCommandBuffer getVkCommandBuffer() const {
     return wrapper_.cmdBuf_;
   }
 
+  const VulkanImmediateCommands::CommandBufferWrapper& getCommandBufferWrapper() const {
+    return wrapper_;
+  }
+
   bool isFromSwapchain() const {
     return isFromSwapchain_;
   }
 
+  // submitted to the async compute queue, which supports only compute and transfer commands
+  bool isAsyncCompute() const {
+    return isAsyncCompute_;
+  }
+
   std::shared_ptr<igl::IFramebuffer> getFramebuffer() const;
 
   std::shared_ptr<ITexture> getPresentedSurface() const;
 
+ private:
+  // transitions all attachments of `framebuffer` into attachment layouts
+  void prepareAttachments(const std::shared_ptr<IFramebuffer>& framebuffer);
+
  private:
   friend class CommandQueue;
 
   VulkanContext& ctx_;
+  VulkanImmediateCommands& commands_;
+  const bool isAsyncCompute_;
   const VulkanImmediateCommands::CommandBufferWrapper& wrapper_;
   CommandBufferDesc desc_;
   // was present() called with a swapchain image?
@@ -64,6 +98,14 @@ class CommandBuffer final : public ICommandBuffer,
   mutable std::shared_ptr<ITexture> presentedSurface_;
 
   VulkanImmediateCommands::SubmitHandle lastSubmitHandle_ = {};
+  bool isSubmitted_ = false;
+  // scheduled as deferred tasks of the submit by CommandQueue
+  std::vector<std::function<void()>> completedHandlers_;
+
+#if defined(IGL_WITH_TRACY_GPU)
+  // covers all commands of this command buffer; ended by CommandQueue right before the submit
+  std::unique_ptr<tracy::VkCtxScope> tracyGpuZone_;
+#endif // IGL_WITH_TRACY_GPU
 };
 
 } // namespace vulkan
@@ -5,22 +5,41 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <igl/ObjectPool.h>
 #include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/CommandBuffer.h>
 #include <igl/vulkan/CommandQueue.h>
 #include <igl/vulkan/EnhancedShaderDebuggingStore.h>
+#include <igl/vulkan/Fence.h>
 #include <igl/vulkan/RenderCommandEncoder.h>
 #include <igl/vulkan/SyncManager.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDefragmenter.h>
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanHelpers.h>
 #include <igl/vulkan/VulkanSwapchain.h>
 
+#if IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+#include <unistd.h>
+#endif // IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+
 namespace igl {
 namespace vulkan {
 
+namespace {
+
+VulkanImmediateCommands& getCommands(const VulkanContext& ctx, CommandQueueType type) {
+  return type == CommandQueueType::Compute && ctx.computeImmediate_ ? *ctx.computeImmediate_
+                                                                     : *ctx.immediate_;
+}
+
+} // namespace
+
 CommandQueue::CommandQueue(Device& device, const CommandQueueDesc& desc) :
-  device_(device), desc_(desc) {
+  device_(device),
+  desc_(desc),
+  commands_(getCommands(device.getVulkanContext(), desc.type)),
+  isAsyncCompute_(&commands_ == device.getVulkanContext().computeImmediate_.get()) {
   IGL_ASSERT(desc_.type == CommandQueueType::Graphics || desc_.type == CommandQueueType::Compute);
 }
 
@@ -28,28 +47,31 @@ std::shared_ptr<ICommandBuffer> CommandQueue::createCommandBuffer(const CommandB
                                                                   Result* outResult) {
   IGL_PROFILER_FUNCTION();
 
-  // for now, we want only 1 command buffer
-  IGL_ASSERT(!isInsideFrame_);
-
-  isInsideFrame_ = true;
+  numRecordingCommandBuffers_++;
 
-  return std::make_shared<CommandBuffer>(device_.getVulkanContext(), desc);
+  return std::allocate_shared<CommandBuffer>(
+      PoolAllocator<CommandBuffer>(), device_.getVulkanContext(), desc, commands_);
 }
 
-SubmitHandle CommandQueue::submit(const ICommandBuffer& cmdBuffer, bool /* endOfFrame */) {
+SubmitHandle CommandQueue::submit(const ICommandBuffer& cmdBuffer, bool endOfFrame) {
   IGL_PROFILER_FUNCTION();
   VulkanContext& ctx = device_.getVulkanContext();
 
+  std::lock_guard<std::mutex> lock(submitMutex_);
+
   if (ctx.enhancedShaderDebuggingStore_) {
     ctx.enhancedShaderDebuggingStore_->installBufferBarrier(cmdBuffer);
   }
 
   incrementDrawCount(cmdBuffer.getCurrentDrawCount());
+  ctx.frameStatistics_.add(FrameStatisticsTracker::DrawCalls, cmdBuffer.getCurrentDrawCount());
 
-  IGL_ASSERT(isInsideFrame_);
+  IGL_ASSERT(numRecordingCommandBuffers_ > 0);
 
   auto* vkCmdBuffer =
       const_cast<vulkan::CommandBuffer*>(static_cast<const vulkan::CommandBuffer*>(&cmdBuffer));
+  // a command buffer rendering into the swapchain presents it and ends the frame
+  const bool isLastInFrame = endOfFrame || vkCmdBuffer->isFromSwapchain();
   const bool presentIfNotDebugging = ctx.enhancedShaderDebuggingStore_ == nullptr;
   auto submitHandle = endCommandBuffer(ctx, vkCmdBuffer, presentIfNotDebugging);
 
@@ -57,9 +79,165 @@ SubmitHandle CommandQueue::submit(const ICommandBuffer& cmdBuffer, bool /* endOf
     enhancedShaderDebuggingPass(ctx, vkCmdBuffer);
   }
 
+  if (isLastInFrame) {
+    // batched submits of the frame go out together
+    commands_.flush();
+    ctx.frameStatistics_.endFrame();
+    if (ctx.defragmenter_ && ctx.config_.defragmentationMaxBytesPerFrame) {
+      ctx.defragmenter_->runPass(ctx.config_.defragmentationMaxBytesPerFrame);
+    }
+  }
+
   return submitHandle;
 }
 
+std::shared_ptr<IFence> CommandQueue::signalFence(Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+  const VulkanContext& ctx = device_.getVulkanContext();
+  const VkDevice vkDevice = ctx.getVkDevice();
+
+  std::lock_guard<std::mutex> lock(submitMutex_);
+
+  VkSemaphore semaphore = VK_NULL_HANDLE;
+#if IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+  if (ctx.hasExternalSemaphoreFd_) {
+    const VkExportSemaphoreCreateInfoKHR exportInfo = {
+        VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO_KHR,
+        nullptr,
+        VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT,
+    };
+    const VkSemaphoreCreateInfo ci = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, &exportInfo, 0};
+    VK_ASSERT(vkCreateSemaphore(vkDevice, &ci, nullptr, &semaphore));
+  }
+#endif // IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+
+  // without a sync fd, the other queue waits on a binary semaphore owned by the fence
+  VkSemaphore queueSemaphore = VK_NULL_HANDLE;
+  if (ctx.computeImmediate_ && semaphore == VK_NULL_HANDLE) {
+    VK_ASSERT(ivkCreateSemaphore(vkDevice, &queueSemaphore));
+  }
+
+  // submits are chained, so an empty command buffer finishes after all the previous ones
+  submitPendingUploads(ctx);
+  const auto handle = commands_.submit(commands_.acquire(),
+                                       semaphore != VK_NULL_HANDLE ? semaphore : queueSemaphore);
+
+  int syncFd = -1;
+#if IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+  if (semaphore != VK_NULL_HANDLE) {
+    // a SYNC_FD export resets the semaphore, so it is exported exactly once
+    const VkSemaphoreGetFdInfoKHR getFdInfo = {
+        VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR,
+        nullptr,
+        semaphore,
+        VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT,
+    };
+    const VkResult result = vkGetSemaphoreFdKHR(vkDevice, &getFdInfo, &syncFd);
+    ctx.deferredTask(std::packaged_task<void()>([vkDevice, semaphore]() {
+                       vkDestroySemaphore(vkDevice, semaphore, nullptr);
+                     }),
+                     handle);
+    if (result != VK_SUCCESS) {
+      IGL_LOG_ERROR("Cannot export the fence as a sync fd\n");
+      syncFd = -1;
+    }
+  }
+#endif // IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+
+  Result::setResult(outResult, Result::Code::Ok);
+  return std::make_shared<Fence>(ctx, commands_, handle, syncFd, queueSemaphore);
+}
+
+Result CommandQueue::waitFence(const IFence& fence) {
+  IGL_PROFILER_FUNCTION();
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  const auto& vkFence = static_cast<const Fence&>(fence);
+  if (vkFence.getCommands() == &commands_ || vkFence.isSignaled()) {
+    // submits are chained, so the work submitted next runs after the fence anyway
+    return Result();
+  }
+
+  if (vkFence.getSyncFd() < 0) {
+    // a fence signaled by the other queue
+    const VkSemaphore semaphore = vkFence.acquireWaitSemaphore();
+    if (semaphore != VK_NULL_HANDLE) {
+      std::lock_guard<std::mutex> lock(submitMutex_);
+      submitPendingUploads(ctx);
+      commands_.waitSemaphore(semaphore);
+      commands_.submit(commands_.acquire());
+    }
+    // otherwise this queue waited for it already: there are only two queues, and the queue which
+    // signaled the fence never consumes its semaphore
+    return Result();
+  }
+
+#if IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+  const VkDevice vkDevice = ctx.getVkDevice();
+
+  // the import takes ownership of its file descriptor, and the fence can be waited on again
+  const int fd = dup(vkFence.getSyncFd());
+  if (fd < 0) {
+    return Result(Result::Code::RuntimeError, "Cannot duplicate the sync fd");
+  }
+  VkSemaphore semaphore = VK_NULL_HANDLE;
+  VK_ASSERT(ivkCreateSemaphore(vkDevice, &semaphore));
+  // a temporary import: the semaphore goes back to its empty payload after the wait
+  const VkImportSemaphoreFdInfoKHR importInfo = {
+      VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR,
+      nullptr,
+      semaphore,
+      VK_SEMAPHORE_IMPORT_TEMPORARY_BIT,
+      VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT,
+      fd,
+  };
+  if (vkImportSemaphoreFdKHR(vkDevice, &importInfo) != VK_SUCCESS) {
+    close(fd);
+    vkDestroySemaphore(vkDevice, semaphore, nullptr);
+    return Result(Result::Code::RuntimeError, "Cannot import the sync fd");
+  }
+
+  std::lock_guard<std::mutex> lock(submitMutex_);
+
+  // an empty command buffer consumes the wait right away, so it cannot clash with the wait of a
+  // swapchain image; all the later submits are chained after it
+  submitPendingUploads(ctx);
+  commands_.waitSemaphore(semaphore);
+  const auto handle = commands_.submit(commands_.acquire());
+  ctx.deferredTask(std::packaged_task<void()>([vkDevice, semaphore]() {
+                     vkDestroySemaphore(vkDevice, semaphore, nullptr);
+                   }),
+                   handle);
+  return Result();
+#else
+  return Result(Result::Code::Unsupported, "Sync fds are not supported on this platform");
+#endif // IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+}
+
+std::shared_ptr<IFence> CommandQueue::importFence(const FenceNativeHandle& handle,
+                                                  Result* outResult) {
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  if (handle.type != FenceHandleType::SyncFd) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Vulkan imports sync fds only");
+    return nullptr;
+  }
+  if (!ctx.hasExternalSemaphoreFd_) {
+#if IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+    // IGL owns the file descriptor even if the import fails
+    if (handle.fd >= 0) {
+      close(handle.fd);
+    }
+#endif // IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "VK_KHR_external_semaphore_fd is not supported");
+    return nullptr;
+  }
+
+  Result::setResult(outResult, Result::Code::Ok);
+  return std::make_shared<Fence>(ctx, handle.fd);
+}
+
 SubmitHandle CommandQueue::endCommandBuffer(const igl::vulkan::VulkanContext& ctx,
                                             igl::vulkan::CommandBuffer* cmdBuffer,
                                             bool present) {
@@ -67,27 +245,73 @@ SubmitHandle CommandQueue::endCommandBuffer(const igl::vulkan::VulkanContext& ct
 
   const bool isGraphicsQueue = desc_.type == CommandQueueType::Graphics;
 
+  // uploads recorded by the staging device have to be submitted before anything that uses them
+  submitPendingUploads(ctx);
+
   // Submit to the graphics queue.
-  const bool shouldPresent = isGraphicsQueue && ctx.hasSwapchain() &&
+  const bool shouldPresent = isGraphicsQueue && !isAsyncCompute_ && ctx.hasSwapchain() &&
                              cmdBuffer->isFromSwapchain() && present;
   if (shouldPresent) {
     ctx.immediate_->waitSemaphore(ctx.swapchain_->acquireSemaphore_->vkSemaphore_);
   }
 
-  cmdBuffer->lastSubmitHandle_ = ctx.immediate_->submit(cmdBuffer->wrapper_);
+#if defined(IGL_WITH_TRACY_GPU)
+  cmdBuffer->tracyGpuZone_.reset();
+#endif // IGL_WITH_TRACY_GPU
+  IGL_PROFILER_GPU_COLLECT_VK(ctx.getTracyContext(), cmdBuffer->wrapper_.cmdBuf_);
+
+  cmdBuffer->lastSubmitHandle_ = commands_.submit(cmdBuffer->wrapper_);
+  cmdBuffer->isSubmitted_ = true;
+  for (auto& handler : cmdBuffer->completedHandlers_) {
+    // deferred tasks take graphics submit handles; they wait for the async compute queue anyway
+    ctx.deferredTask(std::packaged_task<void()>(std::move(handler)),
+                     isAsyncCompute_ ? VulkanImmediateCommands::SubmitHandle()
+                                     : cmdBuffer->lastSubmitHandle_,
+                     true);
+  }
+  cmdBuffer->completedHandlers_.clear();
 
   if (shouldPresent) {
     ctx.present();
   }
-  ctx.markSubmit(cmdBuffer->lastSubmitHandle_);
-  ctx.syncManager_->markSubmit(cmdBuffer->lastSubmitHandle_);
+  ctx.markSubmit(cmdBuffer->lastSubmitHandle_, isAsyncCompute_);
+  if (!isAsyncCompute_) {
+    // frames are paced by the graphics queue
+    ctx.syncManager_->markSubmit(cmdBuffer->lastSubmitHandle_);
+  }
   ctx.processDeferredTasks();
+  ctx.flushPipelineCache();
 
-  isInsideFrame_ = false;
+  numRecordingCommandBuffers_--;
 
   return cmdBuffer->lastSubmitHandle_.handle();
 }
 
+void CommandQueue::submitPendingUploads(const igl::vulkan::VulkanContext& ctx) {
+  ctx.stagingDevice_->submitPendingUploads(*ctx.immediate_);
+  if (!isAsyncCompute_) {
+    return;
+  }
+
+  const VulkanImmediateCommands::SubmitHandle uploadHandle = ctx.stagingDevice_->flush();
+  if (uploadHandle.empty() || uploadHandle.handle() == lastUploadHandle_.handle()) {
+    return;
+  }
+  lastUploadHandle_ = uploadHandle;
+
+  // an empty graphics submit signals a semaphore after everything the graphics queue received so
+  // far, including the uploads or the wait for them
+  const VkDevice vkDevice = ctx.getVkDevice();
+  VkSemaphore semaphore = VK_NULL_HANDLE;
+  VK_ASSERT(ivkCreateSemaphore(vkDevice, &semaphore));
+  ctx.immediate_->submit(ctx.immediate_->acquire(), semaphore);
+  commands_.waitSemaphore(semaphore);
+  commands_.submit(commands_.acquire());
+  ctx.deferredTask(std::packaged_task<void()>([vkDevice, semaphore]() {
+    vkDestroySemaphore(vkDevice, semaphore, nullptr);
+  }));
+}
+
 void CommandQueue::enhancedShaderDebuggingPass(const igl::vulkan::VulkanContext& ctx,
                                                const igl::vulkan::CommandBuffer* cmdBuffer) {
   IGL_PROFILER_FUNCTION();
@@ -170,7 +394,8 @@ void CommandQueue::enhancedShaderDebuggingPass(const igl::vulkan::VulkanContext&
   // Reset instanceCount of the buffer
   vkCmdFillBuffer(vkResetCmdBuffer,
                   lineBuffer->getVkBuffer(),
-                  offsetof(EnhancedShaderDebuggingStore::Header, command_) +
+                  lineBuffer->getVkBufferOffset() +
+                      offsetof(EnhancedShaderDebuggingStore::Header, command_) +
                       offsetof(VkDrawIndirectCommand, instanceCount),
                   sizeof(uint32_t), // reset only the instance count
                   0);
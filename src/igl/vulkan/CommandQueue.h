@@ -7,9 +7,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
 #include <igl/CommandQueue.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/Device.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
 
 namespace igl {
 namespace vulkan {
@@ -26,6 +30,10 @@ class CommandQueue final : public ICommandQueue {
                                                       Result* outResult) override;
   SubmitHandle submit(const ICommandBuffer& commandBuffer, bool endOfFrame = false) override;
 
+  std::shared_ptr<IFence> signalFence(Result* outResult) override;
+  Result waitFence(const IFence& fence) override;
+  std::shared_ptr<IFence> importFence(const FenceNativeHandle& handle, Result* outResult) override;
+
   const CommandQueueDesc& getCommandQueueDesc() const {
     return desc_;
   }
@@ -34,6 +42,8 @@ class CommandQueue final : public ICommandQueue {
   SubmitHandle endCommandBuffer(const igl::vulkan::VulkanContext& ctx,
                                 igl::vulkan::CommandBuffer* cmdBuffer,
                                 bool present);
+  // submits the pending uploads; the async compute queue waits for them through the graphics queue
+  void submitPendingUploads(const igl::vulkan::VulkanContext& ctx);
 
   void enhancedShaderDebuggingPass(const igl::vulkan::VulkanContext& ctx,
                                    const igl::vulkan::CommandBuffer* cmdBuffer);
@@ -41,7 +51,15 @@ class CommandQueue final : public ICommandQueue {
  private:
   igl::vulkan::Device& device_;
   CommandQueueDesc desc_;
-  bool isInsideFrame_ = false;
+  // the async compute commands for compute queues if there are any, otherwise the graphics ones
+  igl::vulkan::VulkanImmediateCommands& commands_;
+  const bool isAsyncCompute_;
+  // the last upload the async compute queue waited for
+  VulkanImmediateCommands::SubmitHandle lastUploadHandle_;
+  // command buffers can be created and recorded on any thread; they are submitted one at a time
+  // in the order of submit() calls
+  std::atomic<uint32_t> numRecordingCommandBuffers_{0};
+  std::mutex submitMutex_;
 };
 
 } // namespace vulkan
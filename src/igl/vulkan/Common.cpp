@@ -230,6 +230,10 @@ VkFormat textureFormatToVkFormat(igl::TextureFormat format) {
     return VK_FORMAT_D32_SFLOAT_S8_UINT;
   case TextureFormat::S_UInt8:
     return VK_FORMAT_S8_UINT;
+  case TextureFormat::YUV_NV12:
+    return VK_FORMAT_G8_B8R8_2PLANE_420_UNORM;
+  case TextureFormat::YUV_P010:
+    return VK_FORMAT_G10X6_B10X6R10X6_2PLANE_420_UNORM_3PACK16;
   }
   IGL_UNREACHABLE_RETURN(VK_FORMAT_UNDEFINED);
 }
@@ -40,6 +40,36 @@
 // Enable to use VulkanMemoryAllocator (VMA)
 #define IGL_VULKAN_USE_VMA 1
 
+// GPU zones record timestamps into `cmdBuffer`; they are inactive if `profilingContext` is null
+// (the device does not support timestamps on the graphics queue)
+#if defined(IGL_WITH_TRACY_GPU)
+#include "tracy/TracyVulkan.hpp"
+#define IGL_PROFILER_ZONE_GPU_VK(name, profilingContext, cmdBuffer) \
+  TracyVkNamedZone(profilingContext, iglGpuZone, cmdBuffer, name, profilingContext != nullptr)
+#define IGL_PROFILER_ZONE_GPU_COLOR_VK(name, profilingContext, cmdBuffer, color) \
+  TracyVkNamedZoneC(                                                            \
+      profilingContext, iglGpuZone, cmdBuffer, name, color, profilingContext != nullptr)
+// begins a GPU zone which lasts until `scope` (std::unique_ptr<tracy::VkCtxScope>) is reset, e.g.
+// for the duration of a render pass
+#define IGL_PROFILER_ZONE_GPU_BEGIN_VK(scope, name, profilingContext, cmdBuffer)         \
+  {                                                                                     \
+    static constexpr tracy::SourceLocationData kIglGpuZoneLocation{                     \
+        name, TracyFunction, TracyFile, (uint32_t)TracyLine, 0};                        \
+    scope = std::make_unique<tracy::VkCtxScope>(                                        \
+        profilingContext, &kIglGpuZoneLocation, cmdBuffer, profilingContext != nullptr); \
+  }
+// reads back the timestamps of finished GPU zones and resets their queries in `cmdBuffer`
+#define IGL_PROFILER_GPU_COLLECT_VK(profilingContext, cmdBuffer) \
+  if (profilingContext) {                                        \
+    TracyVkCollect(profilingContext, cmdBuffer);                 \
+  }
+#else
+#define IGL_PROFILER_ZONE_GPU_VK(name, profilingContext, cmdBuffer)
+#define IGL_PROFILER_ZONE_GPU_COLOR_VK(name, profilingContext, cmdBuffer, color)
+#define IGL_PROFILER_ZONE_GPU_BEGIN_VK(scope, name, profilingContext, cmdBuffer)
+#define IGL_PROFILER_GPU_COLLECT_VK(profilingContext, cmdBuffer)
+#endif // IGL_WITH_TRACY_GPU
+
 #define VK_ASSERT(func)                                            \
   {                                                                \
     const VkResult vk_assert_result = func;                        \
@@ -73,6 +103,23 @@
 
 namespace igl::vulkan {
 
+/*
+ * Descriptor sets:
+ *  0 - combined image samplers
+ *  1 - uniform buffers
+ *  2 - storage buffers
+ *  3 - bindless textures/samplers  <--  optional
+ *  4 - input attachments of subpasses  <--  optional, graphics only
+ */
+constexpr uint32_t kBindPoint_CombinedImageSamplers = 0;
+constexpr uint32_t kBindPoint_BuffersUniform = 1;
+constexpr uint32_t kBindPoint_BuffersStorage = 2;
+constexpr uint32_t kBindPoint_Bindless = 3;
+constexpr uint32_t kBindPoint_InputAttachments = 4;
+
+/// A mask of descriptor sets (bit `i` is set `i`) when nothing is known about the shaders
+constexpr uint32_t kAllDescriptorSets = ~0u;
+
 Result getResultFromVkResult(VkResult result);
 void setResultFrom(Result* outResult, VkResult result);
 VkFormat textureFormatToVkFormat(igl::TextureFormat format);
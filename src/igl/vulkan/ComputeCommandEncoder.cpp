@@ -7,6 +7,8 @@
 
 #include <igl/vulkan/ComputeCommandEncoder.h>
 
+#include <algorithm>
+
 #include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/ComputePipelineState.h>
 #include <igl/vulkan/Texture.h>
@@ -22,13 +24,16 @@ ComputeCommandEncoder::ComputeCommandEncoder(const std::shared_ptr<CommandBuffer
                                              const VulkanContext& ctx) :
   ctx_(ctx),
   cmdBuffer_(commandBuffer ? commandBuffer->getVkCommandBuffer() : VK_NULL_HANDLE),
+  isAsyncCompute_(commandBuffer && commandBuffer->isAsyncCompute()),
   binder_(commandBuffer, ctx_, VK_PIPELINE_BIND_POINT_COMPUTE) {
   IGL_PROFILER_FUNCTION();
 
   IGL_ASSERT(commandBuffer);
 
   ctx_.checkAndUpdateDescriptorSets();
-  ctx_.bindDefaultDescriptorSets(cmdBuffer_, VK_PIPELINE_BIND_POINT_COMPUTE);
+  binder_.bindDefaultDescriptorSets();
+
+  IGL_PROFILER_ZONE_GPU_BEGIN_VK(tracyGpuZone_, "ComputePass", ctx_.getTracyContext(), cmdBuffer_);
 
   isEncoding_ = true;
 }
@@ -40,6 +45,45 @@ void ComputeCommandEncoder::endEncoding() {
     return;
   }
 
+  IGL_ASSERT_MSG(!isInDispatchGroup_, "Did you forget to call endDispatchGroup()?");
+  isInDispatchGroup_ = false;
+
+  // layout transitions of textures bound after the last dispatch
+  recordBarrier(false, false);
+
+  if (hasDispatched_) {
+    // make storage buffers written by the dispatches visible to subsequent draws and dispatches,
+    // including indirect draw commands generated on the GPU; draws on the graphics queue wait for
+    // the async compute queue with a semaphore, which makes all writes visible
+    const VkPipelineStageFlags dstStages =
+        isAsyncCompute_ ? VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                        : VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                              VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                              VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                              VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    const VkMemoryBarrier barrier = {
+        VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        nullptr,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+    };
+    vkCmdPipelineBarrier(cmdBuffer_,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         dstStages,
+                         0,
+                         1,
+                         &barrier,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr);
+  }
+
+#if defined(IGL_WITH_TRACY_GPU)
+  tracyGpuZone_.reset();
+#endif // IGL_WITH_TRACY_GPU
+
   isEncoding_ = false;
 }
 
@@ -57,16 +101,155 @@ void ComputeCommandEncoder::bindComputePipelineState(
   IGL_ASSERT(cps);
 
   binder_.bindPipeline(cps->getVkPipeline());
+  descriptorSetMask_ = cps->getDescriptorSetMask();
 }
 
 void ComputeCommandEncoder::dispatchThreadGroups(const Dimensions& threadgroupCount,
                                                  const Dimensions& /*threadgroupSize*/) {
   IGL_PROFILER_FUNCTION();
 
-  binder_.updateBindings();
+  prepareDispatch(nullptr);
+
   // threadgroupSize is controlled inside compute shaders
   vkCmdDispatch(
       cmdBuffer_, threadgroupCount.width, threadgroupCount.height, threadgroupCount.depth);
+  hasDispatched_ = true;
+}
+
+void ComputeCommandEncoder::dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                                         size_t indirectBufferOffset,
+                                                         const Dimensions& /*threadgroupSize*/) {
+  IGL_PROFILER_FUNCTION();
+
+  IGL_ASSERT_MSG(indirectBufferOffset % 4 == 0, "The offset has to be a multiple of 4");
+
+  BufferRange indirectRange = getBufferRange(indirectBuffer, indirectBufferOffset);
+  indirectRange.end = indirectRange.begin + sizeof(VkDispatchIndirectCommand);
+  prepareDispatch(&indirectRange);
+
+  // threadgroupSize is controlled inside compute shaders
+  vkCmdDispatchIndirect(cmdBuffer_, indirectRange.buffer, indirectRange.begin);
+  hasDispatched_ = true;
+}
+
+void ComputeCommandEncoder::prepareDispatch(const BufferRange* indirectRange) {
+  binder_.updateBindings(descriptorSetMask_);
+
+  // the dispatches of a group wait only for the dispatches before the group
+  const bool waitForDispatches =
+      hasHazard(accessed_) || (indirectRange && overlaps(accessed_, *indirectRange));
+  recordBarrier(waitForDispatches, indirectRange != nullptr);
+  if (waitForDispatches) {
+    accessed_ = {};
+  }
+  AccessedResources& accessed = isInDispatchGroup_ ? accessedByGroup_ : accessed_;
+  addBoundResources(accessed);
+  if (indirectRange) {
+    accessed.buffers.push_back(*indirectRange);
+  }
+}
+
+void ComputeCommandEncoder::beginDispatchGroup() {
+  IGL_ASSERT_MSG(!isInDispatchGroup_, "Dispatch groups cannot be nested");
+  isInDispatchGroup_ = true;
+}
+
+void ComputeCommandEncoder::endDispatchGroup() {
+  IGL_ASSERT_MSG(isInDispatchGroup_, "Did you forget to call beginDispatchGroup()?");
+  isInDispatchGroup_ = false;
+
+  // the dispatches after the group wait for all of it
+  accessed_.buffers.insert(
+      accessed_.buffers.end(), accessedByGroup_.buffers.begin(), accessedByGroup_.buffers.end());
+  accessed_.images.insert(
+      accessed_.images.end(), accessedByGroup_.images.begin(), accessedByGroup_.images.end());
+  accessedByGroup_ = {};
+}
+
+ComputeCommandEncoder::BufferRange ComputeCommandEncoder::getBufferRange(const IBuffer& buffer,
+                                                                         size_t offset) {
+  const auto& buf = static_cast<const igl::vulkan::Buffer&>(buffer);
+  const VkDeviceSize begin = buf.getVkBufferOffset();
+  return {buf.getVkBuffer(), begin + offset, begin + buf.getSizeInBytes()};
+}
+
+bool ComputeCommandEncoder::overlaps(const AccessedResources& resources,
+                                     const BufferRange& range) {
+  return range.buffer != VK_NULL_HANDLE &&
+         std::any_of(resources.buffers.begin(),
+                     resources.buffers.end(),
+                     [&range](const BufferRange& r) {
+                       return r.buffer == range.buffer && r.begin < range.end &&
+                              range.begin < r.end;
+                     });
+}
+
+bool ComputeCommandEncoder::hasHazard(const AccessedResources& resources) const {
+  for (const BufferRange& range : boundBuffers_) {
+    if (overlaps(resources, range)) {
+      return true;
+    }
+  }
+  for (const auto& address : addressBuffers_) {
+    if (overlaps(resources, address.second)) {
+      return true;
+    }
+  }
+  for (const VulkanImage* image : boundImages_) {
+    if (image && std::find(resources.images.begin(), resources.images.end(), image) !=
+                     resources.images.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ComputeCommandEncoder::addBoundResources(AccessedResources& resources) const {
+  for (const BufferRange& range : boundBuffers_) {
+    if (range.buffer != VK_NULL_HANDLE) {
+      resources.buffers.push_back(range);
+    }
+  }
+  for (const auto& address : addressBuffers_) {
+    resources.buffers.push_back(address.second);
+  }
+  for (const VulkanImage* image : boundImages_) {
+    if (image) {
+      resources.images.push_back(image);
+    }
+  }
+}
+
+void ComputeCommandEncoder::recordBarrier(bool waitForDispatches, bool readsIndirectCommand) {
+  if (!waitForDispatches && pendingImageBarriers_.empty()) {
+    return;
+  }
+
+  const VkMemoryBarrier barrier = {
+      VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      nullptr,
+      VK_ACCESS_SHADER_WRITE_BIT,
+      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+          (readsIndirectCommand ? VK_ACCESS_INDIRECT_COMMAND_READ_BIT : 0),
+  };
+  const VkPipelineStageFlags srcStages =
+      pendingSrcStages_ | (waitForDispatches ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : 0);
+  const VkPipelineStageFlags dstStages =
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+      (readsIndirectCommand ? VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT : 0);
+  vkCmdPipelineBarrier(cmdBuffer_,
+                       srcStages,
+                       dstStages,
+                       0,
+                       waitForDispatches ? 1u : 0u,
+                       &barrier,
+                       0,
+                       nullptr,
+                       static_cast<uint32_t>(pendingImageBarriers_.size()),
+                       pendingImageBarriers_.data());
+
+  pendingImageBarriers_.clear();
+  pendingSrcStages_ = 0;
 }
 
 void ComputeCommandEncoder::pushDebugGroupLabel(const std::string& label,
@@ -105,20 +288,39 @@ void ComputeCommandEncoder::bindTexture(size_t index, ITexture* texture) {
     return;
   }
 
-  // "frame graph" heuristics: if we are already in VK_IMAGE_LAYOUT_GENERAL, wait for the previous
-  // compute shader, otherwise wait for previous attachment writes
-  const VkPipelineStageFlags srcStage =
-      (vkImage.imageLayout_ == VK_IMAGE_LAYOUT_GENERAL) ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
-      : vkImage.isDepthOrStencilFormat_                 ? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+  // "frame graph" heuristics: an image in VK_IMAGE_LAYOUT_GENERAL was last written by a compute
+  // shader, which is covered by the hazard tracking here and by the barrier at the end of earlier
+  // compute passes; otherwise wait for previous attachment writes (on the async compute queue,
+  // those are covered by the semaphore wait on the graphics queue)
+  if (vkImage.imageLayout_ != VK_IMAGE_LAYOUT_GENERAL) {
+    VkPipelineStageFlags srcStage = isAsyncCompute_ ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                                    : vkImage.isDepthOrStencilFormat_
+                                        ? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
                                         : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  vkImage.transitionLayout(
-      cmdBuffer_,
-      VK_IMAGE_LAYOUT_GENERAL,
-      srcStage,
-      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-      VkImageSubresourceRange{
-          vkImage.getImageAspectFlags(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+    const size_t firstBarrier = pendingImageBarriers_.size();
+    vkImage.getTransitionBarriers(VK_IMAGE_LAYOUT_GENERAL,
+                                  srcStage,
+                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  VkImageSubresourceRange{vkImage.getImageAspectFlags(),
+                                                          0,
+                                                          VK_REMAINING_MIP_LEVELS,
+                                                          0,
+                                                          VK_REMAINING_ARRAY_LAYERS},
+                                  pendingImageBarriers_);
+    if (isAsyncCompute_ && srcStage != 0) {
+      // the async compute queue supports no graphics stages: earlier graphics work is covered by
+      // the semaphore wait on the graphics queue
+      for (size_t i = firstBarrier; i != pendingImageBarriers_.size(); i++) {
+        pendingImageBarriers_[i].srcAccessMask &= VK_ACCESS_SHADER_WRITE_BIT;
+      }
+      srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    }
+    pendingSrcStages_ |= srcStage;
+  }
 
+  if (index < IGL_TEXTURE_SAMPLERS_MAX) {
+    boundImages_[index] = &vkImage;
+  }
   binder_.bindTexture(index, static_cast<igl::vulkan::Texture*>(texture));
 }
 
@@ -142,6 +344,9 @@ void ComputeCommandEncoder::bindBuffer(size_t index,
     return;
   }
 
+  if (index < IGL_UNIFORM_BLOCKS_BINDING_MAX) {
+    boundBuffers_[index] = getBufferRange(*buf, offset);
+  }
   binder_.bindStorageBuffer((int)index, buf, offset);
 }
 
@@ -170,5 +375,28 @@ void ComputeCommandEncoder::bindPushConstants(const void* data, size_t length, s
                      data);
 }
 
+void ComputeCommandEncoder::bindBufferAddress(size_t offset,
+                                              IBuffer& buffer,
+                                              size_t bufferOffset) {
+  IGL_PROFILER_FUNCTION();
+
+  IGL_ASSERT_MSG(ctx_.config_.enableBufferDeviceAddress,
+                 "Make sure config.enableBufferDeviceAddress is enabled");
+  IGL_ASSERT_MSG((offset & 7) == 0, "Buffer addresses must be 8 bytes aligned in push constants");
+
+  // the buffer is not bound to any descriptor set: shaders dereference its address directly
+  const BufferRange range = getBufferRange(buffer, bufferOffset);
+  const auto it = std::find_if(addressBuffers_.begin(),
+                               addressBuffers_.end(),
+                               [offset](const auto& address) { return address.first == offset; });
+  if (it != addressBuffers_.end()) {
+    it->second = range;
+  } else {
+    addressBuffers_.emplace_back(offset, range);
+  }
+  const uint64_t address = buffer.gpuAddress(bufferOffset);
+  bindPushConstants(&address, sizeof(address), offset);
+}
+
 } // namespace vulkan
 } // namespace igl
@@ -7,8 +7,12 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include <igl/Common.h>
 #include <igl/ComputeCommandEncoder.h>
+#include <igl/ObjectPool.h>
 #include <igl/vulkan/CommandBuffer.h>
 #include <igl/vulkan/ResourcesBinder.h>
 
@@ -21,7 +25,23 @@ class ITexture;
 
 namespace vulkan {
 
-class ComputeCommandEncoder : public IComputeCommandEncoder {
+class VulkanImage;
+
+/**
+ * @brief Records dispatches and the barriers between them.
+ *
+ * The encoder tracks the storage buffers, buffer addresses and storage images bound to each
+ * dispatch, and the thread group counts read by indirect dispatches. A barrier is recorded before
+ * a dispatch only if it accesses a resource which was accessed by a dispatch since the last
+ * barrier, so chains of dispatches over independent resources overlap on the GPU. The encoder does
+ * not know which resources shaders only read, so every access counts as a write. Resources
+ * reached in other ways (e.g. bindless textures or addresses stored in buffers) are not tracked.
+ *
+ * All pending layout transitions and the memory barrier are recorded with a single
+ * vkCmdPipelineBarrier() right before the dispatch which needs them.
+ */
+class ComputeCommandEncoder : public IComputeCommandEncoder,
+                              public Pooled<ComputeCommandEncoder> {
  public:
   ComputeCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
                         const VulkanContext& ctx);
@@ -34,6 +54,9 @@ class ComputeCommandEncoder : public IComputeCommandEncoder {
       const std::shared_ptr<IComputePipelineState>& pipelineState) override;
   void dispatchThreadGroups(const Dimensions& threadgroupCount,
                             const Dimensions& threadgroupSize) override;
+  void dispatchThreadGroupsIndirect(IBuffer& indirectBuffer,
+                                    size_t indirectBufferOffset,
+                                    const Dimensions& threadgroupSize) override;
   void endEncoding() override;
 
   void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
@@ -44,17 +67,68 @@ class ComputeCommandEncoder : public IComputeCommandEncoder {
   void bindBuffer(size_t index, const std::shared_ptr<IBuffer>& buffer, size_t offset) override;
   void bindBytes(size_t index, const void* data, size_t length) override;
   void bindPushConstants(const void* data, size_t length, size_t offset) override;
+  void bindBufferAddress(size_t offset, IBuffer& buffer, size_t bufferOffset) override;
+  void beginDispatchGroup() override;
+  void endDispatchGroup() override;
 
   VkCommandBuffer getVkCommandBuffer() const {
     return cmdBuffer_;
   }
 
+ private:
+  // a range of a VkBuffer accessed by dispatches
+  struct BufferRange {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize begin = 0;
+    VkDeviceSize end = 0;
+  };
+  struct AccessedResources {
+    std::vector<BufferRange> buffers;
+    std::vector<const VulkanImage*> images;
+  };
+
+  static BufferRange getBufferRange(const IBuffer& buffer, size_t offset);
+  static bool overlaps(const AccessedResources& resources, const BufferRange& range);
+  // true if the resources bound for the next dispatch overlap `resources`
+  bool hasHazard(const AccessedResources& resources) const;
+  void addBoundResources(AccessedResources& resources) const;
+  // records the pending layout transitions and, if `waitForDispatches`, a memory barrier after
+  // the previous dispatches, all with one vkCmdPipelineBarrier(); `readsIndirectCommand` makes the
+  // barrier cover the thread group counts read by an indirect dispatch
+  void recordBarrier(bool waitForDispatches, bool readsIndirectCommand);
+  // updates the bindings and records the barrier needed before the next dispatch, which reads
+  // its thread group counts from `indirectRange` if it is not null
+  void prepareDispatch(const BufferRange* indirectRange);
+
  private:
   const VulkanContext& ctx_;
   VkCommandBuffer cmdBuffer_ = VK_NULL_HANDLE;
+  // graphics pipeline stages cannot be used on the async compute queue
+  bool isAsyncCompute_ = false;
   bool isEncoding_ = false;
+  bool hasDispatched_ = false;
+  bool isInDispatchGroup_ = false;
+
+  // the resources bound for the next dispatch
+  BufferRange boundBuffers_[IGL_UNIFORM_BLOCKS_BINDING_MAX] = {};
+  const VulkanImage* boundImages_[IGL_TEXTURE_SAMPLERS_MAX] = {};
+  // buffers passed to bindBufferAddress(), by their offset in the push constants
+  std::vector<std::pair<size_t, BufferRange>> addressBuffers_;
+  // accessed by dispatches since the last barrier; inside a dispatch group, the accesses of the
+  // group are collected separately, since the dispatches of a group do not wait for each other
+  AccessedResources accessed_;
+  AccessedResources accessedByGroup_;
+  // layout transitions to be recorded before the next dispatch
+  std::vector<VkImageMemoryBarrier> pendingImageBarriers_;
+  VkPipelineStageFlags pendingSrcStages_ = 0;
 
   igl::vulkan::ResourcesBinder binder_;
+  // the descriptor sets read by the current pipeline
+  uint32_t descriptorSetMask_ = kAllDescriptorSets;
+
+#if defined(IGL_WITH_TRACY_GPU)
+  std::unique_ptr<tracy::VkCtxScope> tracyGpuZone_; // the compute pass
+#endif // IGL_WITH_TRACY_GPU
 };
 
 } // namespace vulkan
@@ -24,7 +24,11 @@ ComputePipelineState::ComputePipelineState(const igl::vulkan::Device& device,
   device_(device),
   // Ignore modernize-pass-by-value
   // @lint-ignore CLANGTIDY
-  desc_(desc) {}
+  desc_(desc) {
+  if (desc_.shaderStages) {
+    descriptorSetMask_ = ShaderModule::getDescriptorSetMask(desc_.shaderStages->getComputeModule());
+  }
+}
 
 ComputePipelineState ::~ComputePipelineState() {
   if (pipeline_ != VK_NULL_HANDLE) {
@@ -36,6 +40,8 @@ ComputePipelineState ::~ComputePipelineState() {
 }
 
 VkPipeline ComputePipelineState::getVkPipeline() const {
+  std::lock_guard<std::mutex> lock(pipelineMutex_);
+
   if (pipeline_ != VK_NULL_HANDLE) {
     return pipeline_;
   }
@@ -44,16 +50,30 @@ VkPipeline ComputePipelineState::getVkPipeline() const {
 
   const auto& shaderModule = desc_.shaderStages->getComputeModule();
 
+  VkPipelineShaderStageCreateInfo stage = ivkGetPipelineShaderStageCreateInfo(
+      VK_SHADER_STAGE_COMPUTE_BIT,
+      igl::vulkan::ShaderModule::getVkShaderModule(shaderModule),
+      shaderModule->info().entryPoint.c_str(),
+      igl::vulkan::ShaderModule::getVkSpecializationInfo(shaderModule));
+#if defined(VK_EXT_subgroup_size_control)
+  // validated by Device::createComputePipeline()
+  VkPipelineShaderStageRequiredSubgroupSizeCreateInfoEXT subgroupSizeInfo = {};
+  subgroupSizeInfo.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_REQUIRED_SUBGROUP_SIZE_CREATE_INFO_EXT;
+  subgroupSizeInfo.requiredSubgroupSize = desc_.requiredSubgroupSize;
+  if (desc_.requiredSubgroupSize != 0) {
+    stage.pNext = &subgroupSizeInfo;
+  }
+  if (desc_.requireFullSubgroups) {
+    stage.flags |= VK_PIPELINE_SHADER_STAGE_CREATE_REQUIRE_FULL_SUBGROUPS_BIT_EXT;
+  }
+#endif // VK_EXT_subgroup_size_control
+
   igl::vulkan::VulkanComputePipelineBuilder()
-      .shaderStage(ivkGetPipelineShaderStageCreateInfo(
-          VK_SHADER_STAGE_COMPUTE_BIT,
-          igl::vulkan::ShaderModule::getVkShaderModule(shaderModule),
-          shaderModule->info().entryPoint.c_str()))
+      .shaderStage(stage)
+      .createFlags(ctx.getPipelineCreateFlags())
       .build(ctx.device_->getVkDevice(),
-             // TODO: use ctx.pipelineCache_
-             // @fb-only
-             // @fb-only
-             VK_NULL_HANDLE,
+             ctx.pipelineCache_,
              ctx.pipelineLayoutCompute_->getVkPipelineLayout(),
              &pipeline_,
              desc_.debugName.c_str());
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include <igl/Common.h>
 #include <igl/ComputePipelineState.h>
 #include <igl/vulkan/Common.h>
@@ -28,12 +30,21 @@ class ComputePipelineState final : public IComputePipelineState {
 
   VkPipeline getVkPipeline() const;
 
+  // the descriptor sets read by the shader (bit `i` is set `i`); the others are never updated
+  // while this pipeline is bound
+  uint32_t getDescriptorSetMask() const {
+    return descriptorSetMask_;
+  }
+
  private:
   friend class Device;
 
   const igl::vulkan::Device& device_;
   ComputePipelineDesc desc_;
+  uint32_t descriptorSetMask_ = kAllDescriptorSets;
 
+  // the pipeline is created lazily by the first encoder using it, possibly on any thread
+  mutable std::mutex pipelineMutex_;
   mutable VkPipeline pipeline_ = VK_NULL_HANDLE;
 };
 
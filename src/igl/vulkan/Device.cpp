@@ -7,7 +7,10 @@
 
 #include <igl/vulkan/Device.h>
 
+#include <algorithm>
 #include <cstring>
+#include <igl/WorkerPool.h>
+#include <igl/vulkan/BindGroup.h>
 #include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/CommandQueue.h>
 #include <igl/vulkan/Common.h>
@@ -15,16 +18,23 @@
 #include <igl/vulkan/DepthStencilState.h>
 #include <igl/vulkan/EnhancedShaderDebuggingStore.h>
 #include <igl/vulkan/Framebuffer.h>
+#include <igl/vulkan/OcclusionQueryPool.h>
 #include <igl/vulkan/PlatformDevice.h>
+#include <igl/vulkan/RenderBundle.h>
 #include <igl/vulkan/RenderPipelineState.h>
 #include <igl/vulkan/SamplerState.h>
 #include <igl/vulkan/ShaderModule.h>
+#include <igl/vulkan/SpirvCache.h>
 #include <igl/vulkan/Texture.h>
+#include <igl/vulkan/TimestampQueryPool.h>
 #include <igl/vulkan/VertexInputState.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanHelpers.h>
 #include <igl/vulkan/VulkanShaderModule.h>
+#include <igl/vulkan/VulkanStagingDevice.h>
+#include <igl/vulkan/VulkanVma.h>
+#include <thread>
 
 #if IGL_SHADER_DUMP && IGL_DEBUG
 #include <filesystem>
@@ -72,6 +82,7 @@ std::shared_ptr<ICommandQueue> Device::createCommandQueue(const CommandQueueDesc
 
 std::unique_ptr<IBuffer> Device::createBuffer(const BufferDesc& desc,
                                               Result* outResult) const noexcept {
+  IGL_PROFILER_FUNCTION();
   auto buffer = std::make_unique<vulkan::Buffer>(*this);
 
   const auto result = buffer->create(desc);
@@ -80,11 +91,15 @@ std::unique_ptr<IBuffer> Device::createBuffer(const BufferDesc& desc,
     return nullptr;
   }
 
+  if (getResourceTracker()) {
+    buffer->initResourceTracker(getResourceTracker());
+  }
+
   if (!desc.data) {
     return buffer;
   }
 
-  const auto uploadResult = buffer->upload(desc.data, BufferRange(desc.length, 0u));
+  const auto uploadResult = buffer->upload(desc.data, BufferRange(desc.length, 0u), true);
   IGL_VERIFY(uploadResult.isOk());
   Result::setResult(outResult, uploadResult);
 
@@ -100,6 +115,7 @@ std::shared_ptr<IDepthStencilState> Device::createDepthStencilState(
 
 std::unique_ptr<IShaderStages> Device::createShaderStages(const ShaderStagesDesc& desc,
                                                           Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   auto shaderStages = std::make_unique<ShaderStages>(desc);
   if (shaderStages == nullptr) {
     Result::setResult(
@@ -109,6 +125,9 @@ std::unique_ptr<IShaderStages> Device::createShaderStages(const ShaderStagesDesc
         outResult, Result::Code::ArgumentInvalid, "Missing required shader module(s).");
   } else {
     Result::setOk(outResult);
+    if (getResourceTracker()) {
+      shaderStages->initResourceTracker(getResourceTracker());
+    }
   }
 
   return shaderStages;
@@ -116,15 +135,38 @@ std::unique_ptr<IShaderStages> Device::createShaderStages(const ShaderStagesDesc
 
 std::shared_ptr<ISamplerState> Device::createSamplerState(const SamplerStateDesc& desc,
                                                           Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
+  // held while creating, so two threads asking for the same sampler get the same instance
+  const std::lock_guard<std::mutex> lock(samplerStateCacheMutex_);
+  // the debug name of the first instance wins - it is not a part of the key
+  std::weak_ptr<ISamplerState>& cached = samplerStateCache_[desc];
+
+  if (auto samplerState = cached.lock()) {
+    Result::setOk(outResult);
+    return samplerState;
+  }
+
   auto samplerState = std::make_shared<vulkan::SamplerState>(*this);
 
-  Result::setResult(outResult, samplerState->create(desc));
+  const Result result = samplerState->create(desc);
+
+  Result::setResult(outResult, result);
+
+  if (result.isOk()) {
+    cached = samplerState;
+    if (getResourceTracker()) {
+      samplerState->initResourceTracker(getResourceTracker());
+    }
+  } else {
+    samplerStateCache_.erase(desc);
+  }
 
   return samplerState;
 }
 
 std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
                                                 Result* outResult) const noexcept {
+  IGL_PROFILER_FUNCTION();
   const auto sanitized = sanitize(desc);
 
   auto texture = std::make_shared<vulkan::Texture>(*this, desc.format);
@@ -133,7 +175,55 @@ std::shared_ptr<ITexture> Device::createTexture(const TextureDesc& desc,
 
   Result::setResult(outResult, res);
 
-  return res.isOk() ? texture : nullptr;
+  if (!res.isOk()) {
+    return nullptr;
+  }
+
+  if (getResourceTracker()) {
+    texture->initResourceTracker(getResourceTracker());
+  }
+
+  return texture;
+}
+
+std::shared_ptr<ITexture> Device::createTextureView(const ITexture& texture,
+                                                    const TextureViewDesc& desc,
+                                                    Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
+  TextureDesc viewDesc;
+  Result res = texture.validateView(desc, viewDesc);
+  if (!res.isOk()) {
+    Result::setResult(outResult, std::move(res));
+    return nullptr;
+  }
+
+  auto view = std::make_shared<vulkan::Texture>(*this, viewDesc.format);
+
+  res = view->createView(static_cast<const vulkan::Texture&>(texture), desc, viewDesc);
+
+  Result::setResult(outResult, res);
+
+  if (!res.isOk()) {
+    return nullptr;
+  }
+
+  if (getResourceTracker()) {
+    view->initResourceTracker(getResourceTracker());
+  }
+
+  return view;
+}
+
+Result Device::uploadTextureRegions(const std::vector<TextureUpload>& uploads) const {
+  IGL_PROFILER_FUNCTION();
+
+  // one command buffer and one submit for all the textures
+  VulkanStagingDevice& stagingDevice = *ctx_->stagingDevice_;
+  stagingDevice.beginBatch();
+  const auto result = IDevice::uploadTextureRegions(uploads);
+  stagingDevice.endBatch();
+
+  return result;
 }
 
 std::shared_ptr<IVertexInputState> Device::createVertexInputState(const VertexInputStateDesc& desc,
@@ -148,6 +238,7 @@ std::shared_ptr<IVertexInputState> Device::createVertexInputState(const VertexIn
 std::shared_ptr<IComputePipelineState> Device::createComputePipeline(
     const ComputePipelineDesc& desc,
     Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   if (IGL_UNEXPECTED(desc.shaderStages == nullptr)) {
     Result::setResult(outResult, Result::Code::ArgumentInvalid, "Missing shader stages");
     return nullptr;
@@ -160,6 +251,21 @@ std::shared_ptr<IComputePipelineState> Device::createComputePipeline(
     Result::setResult(outResult, Result::Code::ArgumentInvalid, "Missing compute shader");
     return nullptr;
   }
+  if ((desc.requiredSubgroupSize != 0 || desc.requireFullSubgroups) &&
+      !ctx_->usesSubgroupSizeControl()) {
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "VK_EXT_subgroup_size_control is not supported");
+    return nullptr;
+  }
+  if (desc.requiredSubgroupSize != 0 &&
+      ((desc.requiredSubgroupSize & (desc.requiredSubgroupSize - 1)) != 0 ||
+       desc.requiredSubgroupSize < ctx_->minSubgroupSize_ ||
+       desc.requiredSubgroupSize > ctx_->maxSubgroupSize_)) {
+    Result::setResult(outResult,
+                      Result::Code::ArgumentOutOfRange,
+                      "The required subgroup size is not a supported power of two");
+    return nullptr;
+  }
 
   Result::setOk(outResult);
   return std::make_shared<ComputePipelineState>(*this, desc);
@@ -167,6 +273,7 @@ std::shared_ptr<IComputePipelineState> Device::createComputePipeline(
 
 std::shared_ptr<IRenderPipelineState> Device::createRenderPipeline(const RenderPipelineDesc& desc,
                                                                    Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   if (IGL_UNEXPECTED(desc.shaderStages == nullptr)) {
     Result::setResult(outResult, Result::Code::ArgumentInvalid, "Missing shader stages");
     return nullptr;
@@ -194,19 +301,32 @@ std::shared_ptr<IRenderPipelineState> Device::createRenderPipeline(const RenderP
     return nullptr;
   }
 
+  for (const auto& [unit, sampler] : desc.immutableSamplers) {
+    if (!IGL_VERIFY(unit < IGL_TEXTURE_SAMPLERS_MAX)) {
+      Result::setResult(
+          outResult, Result::Code::ArgumentOutOfRange, "Immutable sampler unit out of range");
+      return nullptr;
+    }
+    if (!IGL_VERIFY(sampler)) {
+      Result::setResult(outResult, Result::Code::ArgumentNull, "Missing immutable sampler");
+      return nullptr;
+    }
+  }
+
   return std::make_shared<RenderPipelineState>(*this, desc);
 }
 
 std::shared_ptr<IShaderModule> Device::createShaderModule(const ShaderModuleDesc& desc,
                                                           Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   std::shared_ptr<VulkanShaderModule> vulkanShaderModule;
   Result result;
   if (desc.input.type == ShaderInputType::Binary) {
     vulkanShaderModule =
         createShaderModule(desc.input.data, desc.input.length, desc.debugName, &result);
   } else {
-    vulkanShaderModule =
-        createShaderModule(desc.info.stage, desc.input.source, desc.debugName, &result);
+    vulkanShaderModule = createShaderModule(
+        desc.info.stage, desc.input.source, desc.input.options, desc.debugName, &result);
   }
 
   if (!result.isOk()) {
@@ -217,10 +337,44 @@ std::shared_ptr<IShaderModule> Device::createShaderModule(const ShaderModuleDesc
   return std::make_shared<ShaderModule>(desc.info, std::move(vulkanShaderModule));
 }
 
+std::vector<std::shared_ptr<IShaderModule>> Device::createShaderModules(
+    const std::vector<ShaderModuleDesc>& descs,
+    Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
+
+  // GLSL is compiled to SPIR-V by glslang on the CPU; every shader is compiled independently
+  std::vector<std::shared_ptr<IShaderModule>> modules(descs.size());
+  std::vector<Result> results(descs.size());
+  const auto createModule = [this, &descs, &modules, &results](size_t i) {
+    modules[i] = createShaderModule(descs[i], &results[i]);
+  };
+
+  if (ctx_->pipelineCompilationPool_) {
+    ctx_->pipelineCompilationPool_->parallelFor(descs.size(), createModule);
+  } else {
+    // the calling thread compiles too
+    const size_t numThreads =
+        std::min(static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u)),
+                 descs.size());
+    if (numThreads > 1) {
+      WorkerPool pool(static_cast<uint32_t>(numThreads - 1), "IGL Vulkan shader compiler");
+      pool.parallelFor(descs.size(), createModule);
+    } else {
+      for (size_t i = 0; i != descs.size(); i++) {
+        createModule(i);
+      }
+    }
+  }
+
+  setFirstFailure(outResult, results);
+  return modules;
+}
+
 std::shared_ptr<VulkanShaderModule> Device::createShaderModule(const void* data,
                                                                size_t length,
                                                                const std::string& debugName,
                                                                Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   VkDevice device = ctx_->device_->getVkDevice();
 
 #if IGL_SHADER_DUMP && IGL_DEBUG
@@ -261,13 +415,18 @@ std::shared_ptr<VulkanShaderModule> Device::createShaderModule(const void* data,
 
   // @fb-only
   // @lint-ignore CLANGTIDY
-  return std::make_shared<VulkanShaderModule>(device, vkShaderModule);
+  return std::make_shared<VulkanShaderModule>(
+      device,
+      vkShaderModule,
+      getDescriptorSetMaskFromSPIRV(static_cast<const uint32_t*>(data), length / sizeof(uint32_t)));
 }
 
 std::shared_ptr<VulkanShaderModule> Device::createShaderModule(ShaderStage stage,
                                                                const char* source,
+                                                               const ShaderCompilerOptions& options,
                                                                const std::string& debugName,
                                                                Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
   VkDevice device = ctx_->device_->getVkDevice();
   const VkShaderStageFlagBits vkStage = shaderStageToVkShaderStage(stage);
   IGL_ASSERT(vkStage != VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM);
@@ -313,6 +472,10 @@ std::shared_ptr<VulkanShaderModule> Device::createShaderModule(ShaderStage stage
       layout (set = 3, binding = 4) uniform sampler kSamplers[];
       layout (set = 3, binding = 5) uniform samplerShadow kSamplersShadow[];
       // binding #6 is reserved for STORAGE_IMAGEs: check VulkanContext.cpp
+      // YUV textures convert to RGB in their immutable samplers; Vulkan requires indexing these
+      // arrays with constant expressions, e.g. the texture id written into the shader source
+      layout (set = 3, binding = 7) uniform sampler2D kTexturesYUV_NV12[];
+      layout (set = 3, binding = 8) uniform sampler2D kTexturesYUV_P010[];
       )"
                                                                                       : "";
 
@@ -333,16 +496,41 @@ std::shared_ptr<VulkanShaderModule> Device::createShaderModule(ShaderStage stage
     source = sourcePatched.c_str();
   }
 
-  glslang_resource_t glslangResource;
-  ivkGlslangResource(&glslangResource, &ctx_->getVkPhysicalDeviceProperties());
-
   VkShaderModule vkShaderModule = VK_NULL_HANDLE;
-  const Result result =
-      igl::vulkan::compileShader(device, vkStage, source, &vkShaderModule, &glslangResource);
 
-  Result::setResult(outResult, result);
+  // the SPIR-V is kept around to find the descriptor sets the shader uses
+  std::vector<uint32_t> spirv;
+  if (!ctx_->spirvCache_ || !ctx_->spirvCache_->find(vkStage, source, spirv)) {
+    glslang_resource_t glslangResource;
+    ivkGlslangResource(&glslangResource, &ctx_->getVkPhysicalDeviceProperties());
 
-  if (!result.isOk()) {
+    const Result result =
+        igl::vulkan::compileShaderToSPIRV(vkStage, source, spirv, &glslangResource);
+    if (!result.isOk()) {
+      Result::setResult(outResult, result);
+      return nullptr;
+    }
+    if (ctx_->spirvCache_) {
+      ctx_->spirvCache_->insert(vkStage, source, spirv);
+    }
+  }
+  // the cache keeps the SPIR-V as compiled, so the modules of both settings can share it
+  if (vkStage == VK_SHADER_STAGE_FRAGMENT_BIT && options.relaxedPrecisionEnabled) {
+    std::vector<std::string> names;
+    const uint32_t numRelaxed = relaxPrecisionOfSPIRV(spirv, &names);
+    std::string variables;
+    for (const std::string& name : names) {
+      variables += (variables.empty() ? "" : ", ") + name;
+    }
+    IGL_LOG_INFO("Relaxed the precision of %u values of shader '%s' (variables: %s)\n",
+                 numRelaxed,
+                 debugName.c_str(),
+                 variables.c_str());
+  }
+  const VkResult result = ivkCreateShaderModuleFromSPIRV(
+      device, spirv.data(), spirv.size() * sizeof(uint32_t), &vkShaderModule);
+  setResultFrom(outResult, result);
+  if (result != VK_SUCCESS) {
     return nullptr;
   }
 
@@ -354,12 +542,64 @@ std::shared_ptr<VulkanShaderModule> Device::createShaderModule(ShaderStage stage
 
   // @fb-only
   // @lint-ignore CLANGTIDY
-  return std::make_shared<VulkanShaderModule>(device, vkShaderModule);
+  return std::make_shared<VulkanShaderModule>(
+      device, vkShaderModule, getDescriptorSetMaskFromSPIRV(spirv.data(), spirv.size()));
 }
 
 std::shared_ptr<IFramebuffer> Device::createFramebuffer(const FramebufferDesc& desc,
                                                         Result* outResult) {
+  IGL_PROFILER_FUNCTION();
   auto resource = std::make_shared<Framebuffer>(*this, desc);
+  if (getResourceTracker()) {
+    resource->initResourceTracker(getResourceTracker());
+  }
+  Result::setOk(outResult);
+  return resource;
+}
+
+std::shared_ptr<IBindGroup> Device::createBindGroup(const BindGroupDesc& desc,
+                                                    Result* outResult) const {
+  Result result = IBindGroup::validate(desc);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  auto resource = std::make_shared<BindGroup>(*ctx_, desc);
+  Result::setOk(outResult);
+  return resource;
+}
+
+std::shared_ptr<IRenderBundle> Device::createRenderBundle(const RenderBundleDesc& desc,
+                                                          Result* outResult) const {
+  auto resource = std::make_shared<RenderBundle>(*ctx_, desc);
+  Result::setOk(outResult);
+  return resource;
+}
+
+std::shared_ptr<IOcclusionQueryPool> Device::createOcclusionQueryPool(
+    const OcclusionQueryPoolDesc& desc,
+    Result* outResult) const {
+  if (IGL_UNEXPECTED(desc.count == 0)) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "Query pools can't be empty");
+    return nullptr;
+  }
+  auto resource = std::make_shared<OcclusionQueryPool>(*ctx_, desc);
+  Result::setOk(outResult);
+  return resource;
+}
+
+std::shared_ptr<ITimestampQueryPool> Device::createTimestampQueryPool(
+    const TimestampQueryPoolDesc& desc,
+    Result* outResult) const {
+  if (!hasFeature(DeviceFeatures::TimestampQueries)) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Timestamp queries are not supported");
+    return nullptr;
+  }
+  if (IGL_UNEXPECTED(desc.count == 0)) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "Query pools can't be empty");
+    return nullptr;
+  }
+  auto resource = std::make_shared<TimestampQueryPool>(*ctx_, desc);
   Result::setOk(outResult);
   return resource;
 }
@@ -372,6 +612,34 @@ size_t Device::getCurrentDrawCount() const {
   return ctx_->drawCallCount_;
 }
 
+FrameStatistics Device::getFrameStatistics() const {
+  return ctx_->frameStatistics_.getCurrent();
+}
+
+std::vector<FrameStatistics> Device::getFrameStatisticsHistory() const {
+  return ctx_->frameStatistics_.getHistory();
+}
+
+bool Device::getDeviceMemoryUsage(DeviceMemoryUsage& outUsage) const {
+  if (!IGL_VULKAN_USE_VMA) {
+    return false;
+  }
+  // without VK_EXT_memory_budget, VMA estimates the usage from its own allocations
+  VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+  vmaGetHeapBudgets((VmaAllocator)ctx_->getVmaAllocator(), budgets);
+
+  VkPhysicalDeviceMemoryProperties memProperties;
+  vkGetPhysicalDeviceMemoryProperties(ctx_->getVkPhysicalDevice(), &memProperties);
+  outUsage = {};
+  for (uint32_t i = 0; i != memProperties.memoryHeapCount; i++) {
+    if (memProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+      outUsage.usedBytes += budgets[i].usage;
+      outUsage.budgetBytes += budgets[i].budget;
+    }
+  }
+  return true;
+}
+
 std::unique_ptr<igl::IShaderLibrary> Device::createShaderLibrary(const ShaderLibraryDesc& desc,
                                                                  Result* outResult) const {
   if (IGL_UNEXPECTED(desc.moduleInfo.empty())) {
@@ -389,8 +657,11 @@ std::unique_ptr<igl::IShaderLibrary> Device::createShaderLibrary(const ShaderLib
       Result::setResult(outResult, Result::Code::Unsupported);
       return nullptr;
     }
-    vulkanShaderModule = createShaderModule(
-        desc.moduleInfo.front().stage, desc.input.source, desc.debugName, &result);
+    vulkanShaderModule = createShaderModule(desc.moduleInfo.front().stage,
+                                            desc.input.source,
+                                            desc.input.options,
+                                            desc.debugName,
+                                            &result);
   }
 
   if (!result.isOk()) {
@@ -426,6 +697,11 @@ bool Device::hasFeature(DeviceFeatures feature) const {
     return true;
   case DeviceFeatures::StandardDerivativeExt:
     return false;
+  case DeviceFeatures::SubgroupSizeControl:
+    return ctx_->usesSubgroupSizeControl();
+  case DeviceFeatures::Subpasses:
+    // dynamic rendering has no subpasses
+    return ctx_->hasInputAttachments();
   case DeviceFeatures::TextureFormatRG:
     return supportsFormat(physicalDevice, VK_FORMAT_R8G8_UNORM);
   case DeviceFeatures::TextureFormatRGB:
@@ -474,16 +750,26 @@ bool Device::hasFeature(DeviceFeatures feature) const {
     return true;
   case DeviceFeatures::Multiview:
     return ctx_->vkPhysicalDeviceMultiviewFeatures_.multiview == VK_TRUE;
+  case DeviceFeatures::FragmentDensityMap:
+    return ctx_->usesFragmentDensityMap();
   case DeviceFeatures::BindUniform:
     return false;
   case DeviceFeatures::TexturePartialMipChain:
     return true;
+  case DeviceFeatures::TextureViews:
+    return true;
   case DeviceFeatures::BufferRing:
     return false;
   case DeviceFeatures::BufferNoCopy:
     return false;
   case DeviceFeatures::ShaderLibrary:
     return true;
+  case DeviceFeatures::ShaderSubgroups: {
+    const VkPhysicalDeviceSubgroupProperties& props = ctx_->vkPhysicalDeviceSubgroupProperties_;
+    return (props.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) != 0 &&
+           (props.supportedOperations & VK_SUBGROUP_FEATURE_BASIC_BIT) != 0 &&
+           (props.supportedOperations & VK_SUBGROUP_FEATURE_ARITHMETIC_BIT) != 0;
+  }
   case DeviceFeatures::BindBytes:
     return false;
   case DeviceFeatures::TextureArrayExt:
@@ -495,10 +781,17 @@ bool Device::hasFeature(DeviceFeatures feature) const {
     return false;
   case DeviceFeatures::SamplerMinMaxLod:
     return true;
+  case DeviceFeatures::DrawBaseInstance:
+  case DeviceFeatures::DrawBaseVertex:
   case DeviceFeatures::DrawIndexedIndirect:
+  case DeviceFeatures::DrawInstanced:
     return true;
   case DeviceFeatures::ValidationLayersEnabled:
     return ctx_->areValidationLayersEnabled();
+  case DeviceFeatures::OcclusionQueries:
+    return true;
+  case DeviceFeatures::TimestampQueries:
+    return ctx_->getVkPhysicalDeviceProperties().limits.timestampComputeAndGraphics == VK_TRUE;
   }
 
   IGL_ASSERT_MSG(0, "DeviceFeatures value not handled: %d", (int)feature);
@@ -564,6 +857,9 @@ bool Device::getFeatureLimits(DeviceFeatureLimits featureLimits, size_t& result)
   case DeviceFeatureLimits::ShaderStorageBufferOffsetAlignment:
     result = 8;
     return true;
+  case DeviceFeatureLimits::UniformBufferOffsetAlignment:
+    result = limits.minUniformBufferOffsetAlignment;
+    return true;
   case DeviceFeatureLimits::BufferAlignment:
     result = 1;
     return true;
@@ -571,8 +867,24 @@ bool Device::getFeatureLimits(DeviceFeatureLimits featureLimits, size_t& result)
     result = 0;
     return true;
   case DeviceFeatureLimits::MaxBindBytesBytes:
-    result = 0;
+    // the block size of the transient uniform arenas
+    result = ctx_->transientDSets_[0].uniformArena->getBlockSize();
     return true;
+  case DeviceFeatureLimits::MinSubgroupSize:
+  case DeviceFeatureLimits::MaxSubgroupSize:
+  case DeviceFeatureLimits::SubgroupOperations: {
+    const VkPhysicalDeviceSubgroupProperties& props = ctx_->vkPhysicalDeviceSubgroupProperties_;
+    if ((props.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) == 0) {
+      result = 0;
+    } else if (featureLimits == DeviceFeatureLimits::SubgroupOperations) {
+      // SubgroupOperationBits match the core VkSubgroupFeatureFlagBits
+      result = props.supportedOperations & 0xff;
+    } else {
+      result = featureLimits == DeviceFeatureLimits::MinSubgroupSize ? ctx_->minSubgroupSize_
+                                                                      : ctx_->maxSubgroupSize_;
+    }
+    return true;
+  }
   }
 
   IGL_ASSERT_MSG(0, "DeviceFeatureLimits value not handled: %d", (int)featureLimits);
@@ -582,12 +894,31 @@ bool Device::getFeatureLimits(DeviceFeatureLimits featureLimits, size_t& result)
 
 ICapabilities::TextureFormatCapabilities Device::getTextureFormatCapabilities(
     TextureFormat format) const {
+  VkComponentMapping components = {};
+  const TextureFormat uploadFormat = ctx_->getUploadConversionFormat(format, &components);
+  if (uploadFormat != TextureFormat::Invalid) {
+    // converted on upload, so only sampled
+    return getTextureFormatCapabilities(uploadFormat) &
+           TextureFormatCapabilities(TextureFormatCapabilityBits::Sampled |
+                                     TextureFormatCapabilityBits::SampledFiltered);
+  }
+
   const VkFormat vkFormat = igl::vulkan::textureFormatToVkFormat(format);
 
   if (vkFormat == VK_FORMAT_UNDEFINED) {
     return TextureFormatCapabilityBits::Unsupported;
   }
 
+  if (TextureFormatProperties::fromTextureFormat(format).isMultiPlanar()) {
+    // YUV textures are only sampled through the bindless immutable samplers of their format
+    if (!ctx_->config_.enableDescriptorIndexing ||
+        ctx_->getYcbcrConversion(vkFormat) == VK_NULL_HANDLE) {
+      return TextureFormatCapabilityBits::Unsupported;
+    }
+    return TextureFormatCapabilities(TextureFormatCapabilityBits::Sampled |
+                                     TextureFormatCapabilityBits::SampledFiltered);
+  }
+
   VkFormatProperties properties;
   vkGetPhysicalDeviceFormatProperties(ctx_->vkPhysicalDevice_, vkFormat, &properties);
 
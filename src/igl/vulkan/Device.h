@@ -13,6 +13,8 @@
 #include <igl/vulkan/PlatformDevice.h>
 #include <igl/vulkan/VulkanSemaphore.h>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace igl {
 namespace vulkan {
@@ -42,6 +44,11 @@ class Device final : public IDevice {
                                                     Result* outResult) const override;
   std::shared_ptr<ITexture> createTexture(const TextureDesc& desc,
                                           Result* outResult) const noexcept override;
+  std::shared_ptr<ITexture> createTextureView(const ITexture& texture,
+                                              const TextureViewDesc& desc,
+                                              Result* outResult) const override;
+
+  Result uploadTextureRegions(const std::vector<TextureUpload>& uploads) const override;
 
   std::shared_ptr<IVertexInputState> createVertexInputState(const VertexInputStateDesc& desc,
                                                             Result* outResult) const override;
@@ -59,9 +66,27 @@ class Device final : public IDevice {
   std::shared_ptr<IShaderModule> createShaderModule(const ShaderModuleDesc& desc,
                                                     Result* outResult) const override;
 
+  std::vector<std::shared_ptr<IShaderModule>> createShaderModules(
+      const std::vector<ShaderModuleDesc>& descs,
+      Result* outResult) const override;
+
   std::shared_ptr<IFramebuffer> createFramebuffer(const FramebufferDesc& desc,
                                                   Result* outResult) override;
 
+  std::shared_ptr<IBindGroup> createBindGroup(const BindGroupDesc& desc,
+                                              Result* outResult) const override;
+
+  std::shared_ptr<IRenderBundle> createRenderBundle(const RenderBundleDesc& desc,
+                                                    Result* outResult) const override;
+
+  std::shared_ptr<IOcclusionQueryPool> createOcclusionQueryPool(
+      const OcclusionQueryPoolDesc& desc,
+      Result* outResult) const override;
+
+  std::shared_ptr<ITimestampQueryPool> createTimestampQueryPool(
+      const TimestampQueryPoolDesc& desc,
+      Result* outResult) const override;
+
   // Platform-specific extensions
   const PlatformDevice& getPlatformDevice() const noexcept override;
 
@@ -77,6 +102,10 @@ class Device final : public IDevice {
   }
   size_t getCurrentDrawCount() const override;
 
+  FrameStatistics getFrameStatistics() const override;
+  std::vector<FrameStatistics> getFrameStatisticsHistory() const override;
+  bool getDeviceMemoryUsage(DeviceMemoryUsage& outUsage) const override;
+
   VulkanContext& getVulkanContext() {
     return *ctx_.get();
   }
@@ -91,12 +120,18 @@ class Device final : public IDevice {
                                                          Result* outResult) const;
   std::shared_ptr<VulkanShaderModule> createShaderModule(ShaderStage stage,
                                                          const char* source,
+                                                         const ShaderCompilerOptions& options,
                                                          const std::string& debugName,
                                                          Result* outResult) const;
 
   std::unique_ptr<VulkanContext> ctx_;
 
   PlatformDevice platformDevice_;
+
+  // Sampler states are immutable, so equal descriptors share one instance (and one VkSampler and
+  // one bindless slot). Entries expire together with the last reference held by the application.
+  mutable std::unordered_map<SamplerStateDesc, std::weak_ptr<ISamplerState>> samplerStateCache_;
+  mutable std::mutex samplerStateCacheMutex_;
 };
 
 } // namespace vulkan
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/DeviceGroup.h>
+
+#include <igl/vulkan/HWDevice.h>
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl {
+namespace vulkan {
+
+std::unique_ptr<DeviceGroup> DeviceGroup::create(const VulkanContextConfig& config,
+                                                 const HWDeviceQueryDesc& queryDesc,
+                                                 size_t maxDevices,
+                                                 Result* outResult) {
+  // the first context enumerates the GPUs and then drives the first of them
+  auto ctx = HWDevice::createContext(config, nullptr);
+
+  Result result;
+  std::vector<HWDeviceDesc> descs = HWDevice::queryDevices(*ctx, queryDesc, &result);
+  if (!result.isOk()) {
+    Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+  if (descs.empty()) {
+    Result::setResult(outResult, Result::Code::Unsupported, "No matching GPU found");
+    return nullptr;
+  }
+  if (maxDevices > 0 && descs.size() > maxDevices) {
+    descs.resize(maxDevices);
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-owning-memory): the constructor is private
+  std::unique_ptr<DeviceGroup> group(new DeviceGroup());
+  for (size_t i = 0; i != descs.size(); i++) {
+    HWDeviceDesc desc = descs[i];
+    if (!ctx) {
+      // every context has its own VkInstance, and physical device handles are only valid on the
+      // instance that enumerated them: the GPUs are enumerated again and matched by their index
+      ctx = HWDevice::createContext(config, nullptr);
+      const std::vector<HWDeviceDesc> ctxDescs = HWDevice::queryDevices(*ctx, queryDesc, &result);
+      if (!result.isOk()) {
+        Result::setResult(outResult, std::move(result));
+        return nullptr;
+      }
+      if (i >= ctxDescs.size() || ctxDescs[i].vendorId != desc.vendorId ||
+          ctxDescs[i].name != desc.name) {
+        Result::setResult(outResult,
+                          Result::Code::RuntimeError,
+                          "The GPUs are enumerated in a different order by another VkInstance");
+        return nullptr;
+      }
+      desc = ctxDescs[i];
+    }
+    auto device = HWDevice::create(std::move(ctx), desc, 0, 0, 0, nullptr, &result);
+    if (!device) {
+      Result::setResult(outResult, std::move(result));
+      return nullptr;
+    }
+    group->devices_.push_back(std::move(device));
+    group->deviceDescs_.push_back(desc);
+  }
+
+  Result::setOk(outResult);
+  return group;
+}
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <igl/Device.h>
+#include <igl/HWDevice.h>
+
+namespace igl {
+namespace vulkan {
+
+struct VulkanContextConfig;
+
+/**
+ * @brief Headless devices on several GPUs of one machine, each with its own VulkanContext, for
+ * rendering independent offscreen frames in parallel.
+ *
+ * Devices do not share any objects: resources, pipelines and command queues are created on every
+ * device that uses them. nextDeviceIndex() spreads frames across the devices round robin.
+ */
+class DeviceGroup final {
+ public:
+  /// Creates one device per GPU matching `queryDesc`, at most `maxDevices` of them (0 - all).
+  /// Fails if no GPU matches or if any of the devices cannot be created.
+  /// Creating a VulkanContext reloads volk's global function pointers for its VkInstance, so no
+  /// other device of the process may be used while the group is being created.
+  static std::unique_ptr<DeviceGroup> create(const VulkanContextConfig& config,
+                                             const HWDeviceQueryDesc& queryDesc,
+                                             size_t maxDevices = 0,
+                                             Result* outResult = nullptr);
+
+  [[nodiscard]] size_t getNumDevices() const {
+    return devices_.size();
+  }
+  [[nodiscard]] IDevice& getDevice(size_t index) const {
+    return *devices_[index];
+  }
+  /// The description of the GPU as enumerated by the VkInstance of the device
+  [[nodiscard]] const HWDeviceDesc& getDeviceDesc(size_t index) const {
+    return deviceDescs_[index];
+  }
+
+  /// Index of the device which renders the next frame. Thread-safe.
+  size_t nextDeviceIndex() {
+    return nextFrame_.fetch_add(1, std::memory_order_relaxed) % devices_.size();
+  }
+
+ private:
+  DeviceGroup() = default;
+
+  std::vector<std::unique_ptr<IDevice>> devices_;
+  std::vector<HWDeviceDesc> deviceDescs_;
+  std::atomic<size_t> nextFrame_ = 0;
+};
+
+} // namespace vulkan
+} // namespace igl
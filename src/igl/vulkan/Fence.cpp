@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/Fence.h>
+
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+#include <igl/vulkan/VulkanContext.h>
+
+#if IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+#include <poll.h>
+#include <unistd.h>
+#define IGL_VULKAN_SYNC_FD_SUPPORTED 1
+#else
+#define IGL_VULKAN_SYNC_FD_SUPPORTED 0
+#endif // IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX
+
+namespace igl {
+namespace vulkan {
+
+namespace {
+
+#if IGL_VULKAN_SYNC_FD_SUPPORTED
+// returns true if the sync fd is signaled; a negative timeout waits forever
+bool pollSyncFd(int fd, int timeoutMs) {
+  pollfd pfd = {fd, POLLIN, 0};
+  int result = 0;
+  do {
+    result = poll(&pfd, 1, timeoutMs);
+  } while (result < 0 && (errno == EINTR || errno == EAGAIN));
+  return result > 0 && (pfd.revents & POLLIN) != 0;
+}
+#endif // IGL_VULKAN_SYNC_FD_SUPPORTED
+
+} // namespace
+
+Fence::Fence(const VulkanContext& ctx,
+             VulkanImmediateCommands& commands,
+             VulkanImmediateCommands::SubmitHandle handle,
+             int syncFd,
+             VkSemaphore semaphore) :
+  ctx_(ctx), commands_(&commands), handle_(handle), syncFd_(syncFd), semaphore_(semaphore) {}
+
+Fence::Fence(const VulkanContext& ctx, int importedSyncFd) :
+  ctx_(ctx), syncFd_(importedSyncFd), isImported_(true) {}
+
+Fence::~Fence() {
+  if (semaphore_ != VK_NULL_HANDLE) {
+    // a submit waiting on the semaphore can still be in flight
+    const VkDevice vkDevice = ctx_.getVkDevice();
+    const VkSemaphore semaphore = semaphore_;
+    ctx_.deferredTask(std::packaged_task<void()>([vkDevice, semaphore]() {
+      vkDestroySemaphore(vkDevice, semaphore, nullptr);
+    }));
+  }
+#if IGL_VULKAN_SYNC_FD_SUPPORTED
+  if (syncFd_ >= 0) {
+    close(syncFd_);
+  }
+#endif // IGL_VULKAN_SYNC_FD_SUPPORTED
+}
+
+bool Fence::isSignaled() const {
+  if (!isImported_) {
+    return commands_->isReady(handle_);
+  }
+#if IGL_VULKAN_SYNC_FD_SUPPORTED
+  return syncFd_ < 0 || pollSyncFd(syncFd_, 0);
+#else
+  return true;
+#endif // IGL_VULKAN_SYNC_FD_SUPPORTED
+}
+
+bool Fence::waitUntilSignaled(uint64_t timeoutNanoseconds) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+
+  if (isImported_) {
+#if IGL_VULKAN_SYNC_FD_SUPPORTED
+    if (syncFd_ < 0) {
+      return true;
+    }
+    const uint64_t timeoutMs = (timeoutNanoseconds + 999999) / 1000000;
+    return pollSyncFd(syncFd_,
+                      timeoutNanoseconds == UINT64_MAX || timeoutMs > INT32_MAX
+                          ? -1
+                          : static_cast<int>(timeoutMs));
+#else
+    return true;
+#endif // IGL_VULKAN_SYNC_FD_SUPPORTED
+  }
+
+  if (timeoutNanoseconds == UINT64_MAX) {
+    commands_->wait(handle_);
+    return true;
+  }
+
+  // VulkanImmediateCommands waits without a timeout
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::nanoseconds(timeoutNanoseconds);
+  while (!commands_->isReady(handle_)) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+VkSemaphore Fence::acquireWaitSemaphore() const {
+  if (semaphore_ == VK_NULL_HANDLE || isSemaphoreAcquired_.exchange(true)) {
+    return VK_NULL_HANDLE;
+  }
+  return semaphore_;
+}
+
+Result Fence::exportNativeHandle(FenceHandleType type, FenceNativeHandle& outHandle) const {
+  if (type != FenceHandleType::SyncFd) {
+    return Result(Result::Code::Unsupported, "Vulkan fences are exported as sync fds");
+  }
+#if IGL_VULKAN_SYNC_FD_SUPPORTED
+  if (!isImported_ && syncFd_ < 0 && !isSignaled()) {
+    return Result(Result::Code::Unsupported, "VK_KHR_external_semaphore_fd is not supported");
+  }
+  outHandle = {};
+  outHandle.type = FenceHandleType::SyncFd;
+  // -1 is a valid sync fd which is signaled already
+  outHandle.fd = syncFd_ >= 0 ? dup(syncFd_) : -1;
+  if (syncFd_ >= 0 && outHandle.fd < 0) {
+    return Result(Result::Code::RuntimeError, "Cannot duplicate the sync fd");
+  }
+  return Result();
+#else
+  return Result(Result::Code::Unsupported, "Sync fds are not supported on this platform");
+#endif // IGL_VULKAN_SYNC_FD_SUPPORTED
+}
+
+} // namespace vulkan
+} // namespace igl
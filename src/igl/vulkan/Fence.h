@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <igl/Fence.h>
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanContext;
+
+/**
+ * @brief A fence signaled by a submit of VulkanImmediateCommands, or imported from a sync fd.
+ *
+ * With VK_KHR_external_semaphore_fd, the submit signaling the fence also signals an exportable
+ * semaphore, whose sync fd is retrieved right away: exporting a SYNC_FD payload resets the
+ * semaphore, so the fence keeps the file descriptor and hands out duplicates of it. Without it, a
+ * fence signaled on one of two queues (graphics and async compute) owns a binary semaphore, which
+ * the first wait from the other queue consumes.
+ */
+class Fence final : public IFence {
+ public:
+  // `syncFd` and `semaphore` are owned by the fence; -1 and VK_NULL_HANDLE if there are none
+  Fence(const VulkanContext& ctx,
+        VulkanImmediateCommands& commands,
+        VulkanImmediateCommands::SubmitHandle handle,
+        int syncFd,
+        VkSemaphore semaphore = VK_NULL_HANDLE);
+  // an imported sync fd owned by the fence; -1 means it is already signaled
+  Fence(const VulkanContext& ctx, int importedSyncFd);
+  ~Fence() override;
+
+  Fence(const Fence&) = delete;
+  Fence& operator=(const Fence&) = delete;
+
+  [[nodiscard]] bool isSignaled() const override;
+  bool waitUntilSignaled(uint64_t timeoutNanoseconds = UINT64_MAX) const override;
+  Result exportNativeHandle(FenceHandleType type, FenceNativeHandle& outHandle) const override;
+
+  [[nodiscard]] bool isImported() const {
+    return isImported_;
+  }
+  // the file descriptor of the fence, or -1; owned by the fence
+  [[nodiscard]] int getSyncFd() const {
+    return syncFd_;
+  }
+  // the commands the fence was signaled by; null for imported fences
+  [[nodiscard]] const VulkanImmediateCommands* getCommands() const {
+    return commands_;
+  }
+  // returns the semaphore signaled with the fence, or VK_NULL_HANDLE if there is none or it was
+  // acquired already: a binary semaphore can be waited on only once
+  [[nodiscard]] VkSemaphore acquireWaitSemaphore() const;
+
+ private:
+  const VulkanContext& ctx_;
+  VulkanImmediateCommands* commands_ = nullptr;
+  VulkanImmediateCommands::SubmitHandle handle_ = {};
+  int syncFd_ = -1;
+  VkSemaphore semaphore_ = VK_NULL_HANDLE;
+  mutable std::atomic<bool> isSemaphoreAcquired_{false};
+  bool isImported_ = false;
+};
+
+} // namespace vulkan
+} // namespace igl
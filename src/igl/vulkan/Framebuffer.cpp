@@ -92,10 +92,12 @@ void Framebuffer::copyBytesColorAttachment(ICommandQueue& /* Not Used */,
     bytesPerRow = itexture->getProperties().getBytesPerRow(range);
   }
   const VulkanContext& ctx = device_.getVulkanContext();
+  const uint32_t mipLevel = vkTex.getBaseMipLevel() + static_cast<uint32_t>(range.mipLevel);
+  // layer (or face of a cubemap)
+  const uint32_t layer = vkTex.getBaseLayer() + static_cast<uint32_t>(range.layer);
   ctx.stagingDevice_->getImageData2D(vkTex.getVkImage(),
-                                     static_cast<uint32_t>(range.mipLevel),
-                                     static_cast<uint32_t>(range.layer), // layer (or face of a
-                                                                         // cubemap)
+                                     mipLevel,
+                                     layer,
                                      imageRegion,
                                      vkTex.getProperties(),
                                      VK_FORMAT_R8G8B8A8_UNORM,
@@ -105,6 +107,49 @@ void Framebuffer::copyBytesColorAttachment(ICommandQueue& /* Not Used */,
                                      true); // Flip the image vertically
 }
 
+uint64_t Framebuffer::copyBytesColorAttachmentAsync(size_t index,
+                                                   const TextureRangeDesc& range) const {
+  IGL_PROFILER_FUNCTION();
+
+  const auto& itexture = getColorAttachment(index);
+  if (!IGL_VERIFY(itexture)) {
+    return 0;
+  }
+
+  const auto& vkTex = static_cast<Texture&>(*itexture);
+  const VkRect2D imageRegion = {
+      VkOffset2D{static_cast<int32_t>(range.x), static_cast<int32_t>(range.y)},
+      VkExtent2D{static_cast<uint32_t>(range.width), static_cast<uint32_t>(range.height)},
+  };
+
+  const VulkanContext& ctx = device_.getVulkanContext();
+  return ctx.stagingDevice_->getImageData2DAsync(
+      vkTex.getVkImage(),
+      vkTex.getBaseMipLevel() + static_cast<uint32_t>(range.mipLevel),
+      vkTex.getBaseLayer() + static_cast<uint32_t>(range.layer),
+      imageRegion,
+      vkTex.getProperties(),
+      vkTex.getVulkanTexture().getVulkanImage().imageLayout_,
+      true); // flipped vertically by getColorAttachmentReadback()
+}
+
+bool Framebuffer::isReadbackReady(uint64_t readbackId) const {
+  return device_.getVulkanContext().stagingDevice_->isReadbackReady(readbackId);
+}
+
+bool Framebuffer::getColorAttachmentReadback(uint64_t readbackId,
+                                             void* pixelBytes,
+                                             size_t bytesPerRow) const {
+  IGL_PROFILER_FUNCTION();
+  if (!IGL_VERIFY(pixelBytes)) {
+    return false;
+  }
+
+  const VulkanContext& ctx = device_.getVulkanContext();
+  return ctx.stagingDevice_->collectImageData2D(
+      readbackId, pixelBytes, static_cast<uint32_t>(bytesPerRow), true); // flip vertically
+}
+
 void Framebuffer::copyBytesDepthAttachment(ICommandQueue& /*cmdQueue*/,
                                            void* /*pixelBytes*/,
                                            const TextureRangeDesc& /*range*/,
@@ -251,12 +296,9 @@ Framebuffer::Framebuffer(const Device& device, FramebufferDesc desc) :
   IGL_ASSERT(height_);
 }
 
-VkFramebuffer Framebuffer::getVkFramebuffer(uint32_t mipLevel, VkRenderPass pass) const {
-  IGL_PROFILER_FUNCTION();
-  // Because Vulkan framebuffers are immutable and we have a method updateDrawable() which can
-  // change an attachment, we have to maintain a collection of attachments and map it into a
-  // VulkanFramebuffer via unordered_map. The vector of attachments is a key in the hash table.
-  Attachments attachments;
+std::vector<Framebuffer::AttachmentTexture> Framebuffer::getAttachmentTextures(
+    uint32_t mipLevel) const {
+  std::vector<AttachmentTexture> textures;
 
   size_t largestIndexPlusOne = 0;
   for (const auto& attachment : desc_.colorAttachments) {
@@ -274,85 +316,199 @@ VkFramebuffer Framebuffer::getVkFramebuffer(uint32_t mipLevel, VkRenderPass pass
     }
     IGL_ASSERT(it->second.texture);
 
-    const auto& colorTexture = static_cast<vulkan::Texture&>(*it->second.texture);
-    attachments.attachments_.push_back(
-        colorTexture.getVkImageViewForFramebuffer(mipLevel, desc_.mode));
+    textures.push_back({static_cast<vulkan::Texture*>(it->second.texture.get()), mipLevel});
     // handle color MSAA
     if (it->second.resolveTexture) {
       IGL_ASSERT(mipLevel == 0);
-      const auto& colorResolveTexture = static_cast<vulkan::Texture&>(*it->second.resolveTexture);
-      attachments.attachments_.push_back(
-          colorResolveTexture.getVkImageViewForFramebuffer(0, desc_.mode));
+      textures.push_back({static_cast<vulkan::Texture*>(it->second.resolveTexture.get()), 0});
     }
   }
   // depth
-  {
-    const auto* depthTexture = static_cast<vulkan::Texture*>(desc_.depthAttachment.texture.get());
-    if (depthTexture) {
-      attachments.attachments_.push_back(depthTexture->getVkImageViewForFramebuffer(0, desc_.mode));
-    }
+  if (desc_.depthAttachment.texture) {
+    textures.push_back({static_cast<vulkan::Texture*>(desc_.depthAttachment.texture.get()), 0});
+  }
+  // depth resolve attachments are only used with dynamic rendering, which has no VkFramebuffer
+  // the fragment density map is the last attachment of the render pass
+  if (desc_.densityMapAttachment.texture) {
+    textures.push_back(
+        {static_cast<vulkan::Texture*>(desc_.densityMapAttachment.texture.get()), 0});
   }
-  // handle depth MSAA
-  {
-    const auto* depthResolveTexture =
-        static_cast<vulkan::Texture*>(desc_.depthAttachment.resolveTexture.get());
-    if (depthResolveTexture) {
-      attachments.attachments_.push_back(
-          depthResolveTexture->getVkImageViewForFramebuffer(0, desc_.mode));
+
+  return textures;
+}
+
+std::vector<VkImageView> Framebuffer::getAttachmentViews(
+    const std::vector<AttachmentTexture>& textures) const {
+  std::vector<VkImageView> views;
+  views.reserve(textures.size());
+  for (const auto& t : textures) {
+    views.push_back(t.texture->getVkImageViewForFramebuffer(t.mipLevel, desc_.mode));
+  }
+  return views;
+}
+
+VkFramebuffer Framebuffer::getVkFramebuffer(uint32_t mipLevel,
+                                            VkRenderPass pass,
+                                            uint16_t renderPassIndex) const {
+  IGL_PROFILER_FUNCTION();
+  // Because Vulkan framebuffers are immutable and we have a method updateDrawable() which can
+  // change an attachment, we have to maintain a collection of attachments and map it into a
+  // VulkanFramebuffer via unordered_map. The vector of attachments is a key in the hash table.
+  std::lock_guard<std::mutex> lock(framebuffersMutex_);
+
+  const VulkanContext& ctx = device_.getVulkanContext();
+  const std::vector<AttachmentTexture> textures = getAttachmentTextures(mipLevel);
+
+  FramebufferKey key;
+  key.renderPassIndex = renderPassIndex;
+  key.mipLevel = mipLevel;
+
+  if (ctx.usesImagelessFramebuffers()) {
+    // attachments of the same size, format and usage share one framebuffer, e.g. swapchain images
+    key.imageInfos_.reserve(textures.size());
+    for (const auto& t : textures) {
+      const VulkanImage& image = t.texture->getVulkanTexture().getVulkanImage();
+      AttachmentImageInfo info;
+      info.flags = image.createFlags_;
+      info.usage = image.usageFlags_;
+      const uint32_t level = t.texture->getBaseMipLevel() + t.mipLevel;
+      info.width = std::max(image.extent_.width >> level, 1u);
+      info.height = std::max(image.extent_.height >> level, 1u);
+      info.layerCount = desc_.mode == FramebufferMode::Stereo ? image.arrayLayers_ : 1u;
+      info.format = textureFormatToVkFormat(t.texture->getFormat());
+      key.imageInfos_.push_back(info);
     }
+  } else {
+    key.attachments_ = getAttachmentViews(textures);
   }
 
   // now we can find a corresponding framebuffer
-  auto it = framebuffers_.find(attachments);
+  auto it = framebuffers_.find(key);
 
   if (it != framebuffers_.end()) {
-    return it->second->getVkFramebuffer();
+    // move it to the front of the LRU list
+    framebuffersLRU_.splice(framebuffersLRU_.begin(), framebuffersLRU_, it->second);
+    return it->second->second->getVkFramebuffer();
   }
 
-  const VulkanContext& ctx = device_.getVulkanContext();
+  const uint32_t maxCachedFramebuffers = ctx.config_.maxCachedFramebuffers;
+  if (maxCachedFramebuffers && framebuffersLRU_.size() >= maxCachedFramebuffers) {
+    // the VkFramebuffer is destroyed once the GPU is done with it
+    framebuffers_.erase(framebuffersLRU_.back().first);
+    framebuffersLRU_.pop_back();
+  }
 
   const uint32_t fbWidth = std::max(width_ >> mipLevel, 1u);
   const uint32_t fbHeight = std::max(height_ >> mipLevel, 1u);
 
-  auto fb = std::make_shared<VulkanFramebuffer>(ctx,
-                                                ctx.device_->getVkDevice(),
-                                                fbWidth,
-                                                fbHeight,
-                                                pass,
-                                                (uint32_t)attachments.attachments_.size(),
-                                                attachments.attachments_.data(),
-                                                desc_.debugName.c_str());
+  std::shared_ptr<VulkanFramebuffer> fb;
+
+  if (ctx.usesImagelessFramebuffers()) {
+    std::vector<VkFramebufferAttachmentImageInfoKHR> imageInfos;
+    imageInfos.reserve(key.imageInfos_.size());
+    for (const auto& info : key.imageInfos_) {
+      VkFramebufferAttachmentImageInfoKHR ci = {};
+      ci.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENT_IMAGE_INFO_KHR;
+      ci.flags = info.flags;
+      ci.usage = info.usage;
+      ci.width = info.width;
+      ci.height = info.height;
+      ci.layerCount = info.layerCount;
+      ci.viewFormatCount = 1;
+      ci.pViewFormats = &info.format;
+      imageInfos.push_back(ci);
+    }
+    fb = std::make_shared<VulkanFramebuffer>(ctx,
+                                             ctx.device_->getVkDevice(),
+                                             fbWidth,
+                                             fbHeight,
+                                             pass,
+                                             imageInfos.size(),
+                                             imageInfos.data(),
+                                             desc_.debugName.c_str());
+  } else {
+    fb = std::make_shared<VulkanFramebuffer>(ctx,
+                                             ctx.device_->getVkDevice(),
+                                             fbWidth,
+                                             fbHeight,
+                                             pass,
+                                             key.attachments_.size(),
+                                             key.attachments_.data(),
+                                             desc_.debugName.c_str());
+  }
 
-  framebuffers_[attachments] = fb;
+  framebuffersLRU_.emplace_front(std::move(key), fb);
+  framebuffers_.emplace(framebuffersLRU_.front().first, framebuffersLRU_.begin());
 
   return fb->getVkFramebuffer();
 }
 
-uint64_t Framebuffer::HashFunction::operator()(const Attachments& attachments) const {
-  uint64_t hash = 0;
+size_t Framebuffer::getNumCachedFramebuffers() const {
+  std::lock_guard<std::mutex> lock(framebuffersMutex_);
+
+  return framebuffersLRU_.size();
+}
+
+VkImageView Framebuffer::getVkImageView(const Texture& attachment, uint32_t mipLevel) const {
+  std::lock_guard<std::mutex> lock(framebuffersMutex_);
+
+  return attachment.getVkImageViewForFramebuffer(mipLevel, desc_.mode);
+}
+
+namespace {
+void hashCombine(uint64_t& seed, uint64_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+} // namespace
+
+uint64_t Framebuffer::HashFunction::operator()(const FramebufferKey& key) const {
+  uint64_t hash = key.renderPassIndex;
 
-  for (const auto& a : attachments.attachments_) {
-    hash ^= std::hash<VkImageView>()(a);
+  hashCombine(hash, key.mipLevel);
+  for (const auto& a : key.attachments_) {
+    hashCombine(hash, std::hash<VkImageView>()(a));
+  }
+  for (const auto& info : key.imageInfos_) {
+    hashCombine(hash, info.format);
+    hashCombine(hash, info.usage);
+    hashCombine(hash, (uint64_t(info.width) << 32) | info.height);
   }
 
   return hash;
 }
 
-VkRenderPassBeginInfo Framebuffer::getRenderPassBeginInfo(VkRenderPass renderPass,
-                                                          uint32_t mipLevel,
-                                                          uint32_t numClearValues,
-                                                          const VkClearValue* clearValues) const {
+void Framebuffer::cmdBeginRenderPass(VkCommandBuffer cmdBuf,
+                                     VkRenderPass renderPass,
+                                     uint16_t renderPassIndex,
+                                     uint32_t mipLevel,
+                                     uint32_t numClearValues,
+                                     const VkClearValue* clearValues,
+                                     VkSubpassContents contents) const {
   VkRenderPassBeginInfo bi = {};
   bi.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
   bi.pNext = nullptr;
   bi.renderPass = renderPass;
-  bi.framebuffer = getVkFramebuffer(mipLevel, renderPass);
+  bi.framebuffer = getVkFramebuffer(mipLevel, renderPass, renderPassIndex);
   bi.renderArea =
       VkRect2D{VkOffset2D{0, 0},
                VkExtent2D{std::max(width_ >> mipLevel, 1u), std::max(height_ >> mipLevel, 1u)}};
   bi.clearValueCount = numClearValues;
   bi.pClearValues = clearValues;
-  return bi;
+
+  std::vector<VkImageView> views;
+  VkRenderPassAttachmentBeginInfoKHR attachmentBeginInfo = {};
+  if (device_.getVulkanContext().usesImagelessFramebuffers()) {
+    {
+      std::lock_guard<std::mutex> lock(framebuffersMutex_);
+      views = getAttachmentViews(getAttachmentTextures(mipLevel));
+    }
+    attachmentBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_ATTACHMENT_BEGIN_INFO_KHR;
+    attachmentBeginInfo.attachmentCount = (uint32_t)views.size();
+    attachmentBeginInfo.pAttachments = views.data();
+    bi.pNext = &attachmentBeginInfo;
+  }
+
+  vkCmdBeginRenderPass(cmdBuf, &bi, contents);
 }
 
 } // namespace vulkan
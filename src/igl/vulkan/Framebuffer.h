@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <list>
+#include <mutex>
 #include <unordered_map>
 
 #include <igl/Framebuffer.h>
@@ -16,6 +18,7 @@ namespace igl {
 namespace vulkan {
 
 class Device;
+class Texture;
 class VulkanFramebuffer;
 
 class Framebuffer final : public IFramebuffer {
@@ -38,6 +41,17 @@ class Framebuffer final : public IFramebuffer {
                                 const TextureRangeDesc& range,
                                 size_t bytesPerRow = 0) const override;
 
+  // Submits a readback of the color attachment without waiting for the GPU and returns its ID
+  // (0 on failure). Lets headless renderers keep several frames in flight and collect the pixels
+  // of frame N while frame N+1 renders.
+  uint64_t copyBytesColorAttachmentAsync(size_t index, const TextureRangeDesc& range) const;
+  bool isReadbackReady(uint64_t readbackId) const;
+  // Waits for the readback and copies its pixels (flipped vertically, as copyBytesColorAttachment()
+  // does). Returns false if the readback was already collected or dropped.
+  bool getColorAttachmentReadback(uint64_t readbackId,
+                                  void* pixelBytes,
+                                  size_t bytesPerRow = 0) const;
+
   void copyBytesDepthAttachment(ICommandQueue& cmdQueue,
                                 void* pixelBytes,
                                 const TextureRangeDesc& range,
@@ -55,7 +69,12 @@ class Framebuffer final : public IFramebuffer {
 
   std::shared_ptr<ITexture> updateDrawable(std::shared_ptr<ITexture> texture) override;
 
-  VkFramebuffer getVkFramebuffer(uint32_t mipLevel, VkRenderPass pass) const;
+  // `renderPassIndex` is the index of `pass` in the render passes of the VulkanContext
+  VkFramebuffer getVkFramebuffer(uint32_t mipLevel,
+                                VkRenderPass pass,
+                                uint16_t renderPassIndex) const;
+  // the image view of an attachment of this framebuffer, e.g. for dynamic rendering
+  VkImageView getVkImageView(const Texture& attachment, uint32_t mipLevel) const;
 
   uint32_t getWidth() const {
     return width_;
@@ -68,21 +87,62 @@ class Framebuffer final : public IFramebuffer {
     return desc_;
   }
 
-  VkRenderPassBeginInfo getRenderPassBeginInfo(VkRenderPass renderPass,
-                                               uint32_t mipLevel,
-                                               uint32_t numClearValues,
-                                               const VkClearValue* clearValues) const;
+  // records vkCmdBeginRenderPass() with the VkFramebuffer of `renderPass`; the image views are
+  // passed here for imageless framebuffers (VulkanContext::usesImagelessFramebuffers())
+  void cmdBeginRenderPass(VkCommandBuffer cmdBuf,
+                          VkRenderPass renderPass,
+                          uint16_t renderPassIndex,
+                          uint32_t mipLevel,
+                          uint32_t numClearValues,
+                          const VkClearValue* clearValues,
+                          VkSubpassContents contents) const;
+
+  // what an imageless framebuffer knows about an attachment instead of its image view
+  struct AttachmentImageInfo {
+    VkImageCreateFlags flags = 0;
+    VkImageUsageFlags usage = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t layerCount = 0;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    bool operator==(const AttachmentImageInfo& other) const {
+      return flags == other.flags && usage == other.usage && width == other.width &&
+             height == other.height && layerCount == other.layerCount && format == other.format;
+    }
+  };
 
-  struct Attachments {
+  // a VkFramebuffer can be used only with render passes compatible with the one it was created for;
+  // the render pass index in the key keeps it that way when the same attachments are rendered with
+  // different view masks
+  struct FramebufferKey {
+    uint16_t renderPassIndex = 0;
+    uint32_t mipLevel = 0;
+    // empty for imageless framebuffers
     std::vector<VkImageView> attachments_;
-    bool operator==(const Attachments& other) const {
-      return attachments_ == other.attachments_;
+    // imageless framebuffers only
+    std::vector<AttachmentImageInfo> imageInfos_;
+    bool operator==(const FramebufferKey& other) const {
+      return renderPassIndex == other.renderPassIndex && mipLevel == other.mipLevel &&
+             attachments_ == other.attachments_ && imageInfos_ == other.imageInfos_;
     }
   };
 
   struct HashFunction {
-    uint64_t operator()(const Attachments& attachments) const;
+    uint64_t operator()(const FramebufferKey& key) const;
+  };
+
+  // the number of VkFramebuffer objects kept by this framebuffer
+  size_t getNumCachedFramebuffers() const;
+
+ private:
+  struct AttachmentTexture {
+    const Texture* texture = nullptr;
+    uint32_t mipLevel = 0;
   };
+  // the attachments in the order of the attachment descriptions of the render passes
+  std::vector<AttachmentTexture> getAttachmentTextures(uint32_t mipLevel) const;
+  // `framebuffersMutex_` has to be locked
+  std::vector<VkImageView> getAttachmentViews(const std::vector<AttachmentTexture>& textures) const;
 
  private:
   const igl::vulkan::Device& device_;
@@ -90,7 +150,15 @@ class Framebuffer final : public IFramebuffer {
 
   uint32_t width_ = 0;
   uint32_t height_ = 0;
-  mutable std::unordered_map<Attachments, std::shared_ptr<VulkanFramebuffer>, HashFunction>
+  // guards the cache and lazily created image views of the attachments
+  mutable std::mutex framebuffersMutex_;
+  // least recently used VkFramebuffer objects at the back; bounded by
+  // VulkanContextConfig::maxCachedFramebuffers, so attachments which rotate through many textures
+  // do not accumulate framebuffers of destroyed image views
+  using CachedFramebuffers =
+      std::list<std::pair<FramebufferKey, std::shared_ptr<VulkanFramebuffer>>>;
+  mutable CachedFramebuffers framebuffersLRU_;
+  mutable std::unordered_map<FramebufferKey, CachedFramebuffers::iterator, HashFunction>
       framebuffers_;
 };
 
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/OcclusionQueryPool.h>
+
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl {
+namespace vulkan {
+
+OcclusionQueryPool::OcclusionQueryPool(const VulkanContext& ctx,
+                                       const OcclusionQueryPoolDesc& desc) :
+  ctx_(ctx), device_(ctx.getVkDevice()), type_(desc.type), count_(desc.count) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  VkQueryPoolCreateInfo ci = {};
+  ci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  ci.queryType = VK_QUERY_TYPE_OCCLUSION;
+  ci.queryCount = count_;
+  VK_ASSERT(vkCreateQueryPool(device_, &ci, nullptr, &vkQueryPool_));
+  VK_ASSERT(ivkSetDebugObjectName(
+      device_, VK_OBJECT_TYPE_QUERY_POOL, (uint64_t)vkQueryPool_, desc.debugName.c_str()));
+}
+
+OcclusionQueryPool::~OcclusionQueryPool() {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
+
+  ctx_.deferredTask(std::packaged_task<void()>([device = device_, pool = vkQueryPool_]() {
+    vkDestroyQueryPool(device, pool, nullptr);
+  }));
+}
+
+void OcclusionQueryPool::reset(VkCommandBuffer cmdBuf) const {
+  vkCmdResetQueryPool(cmdBuf, vkQueryPool_, 0, count_);
+}
+
+bool OcclusionQueryPool::getResults(uint32_t firstQuery,
+                                    uint32_t queryCount,
+                                    uint64_t* outResults) {
+  if (!IGL_VERIFY(static_cast<uint64_t>(firstQuery) + queryCount <= count_) ||
+      !IGL_VERIFY(outResults != nullptr)) {
+    return false;
+  }
+  if (queryCount == 0) {
+    return true;
+  }
+
+  // No VK_QUERY_RESULT_WAIT_BIT: VK_NOT_READY is returned while any of the queries is pending
+  const VkResult result = vkGetQueryPoolResults(device_,
+                                                vkQueryPool_,
+                                                firstQuery,
+                                                queryCount,
+                                                queryCount * sizeof(uint64_t),
+                                                outResults,
+                                                sizeof(uint64_t),
+                                                VK_QUERY_RESULT_64_BIT);
+  if (result != VK_SUCCESS) {
+    return false;
+  }
+
+  if (type_ == OcclusionQueryType::Binary) {
+    for (uint32_t i = 0; i < queryCount; ++i) {
+      outResults[i] = outResults[i] != 0 ? 1 : 0;
+    }
+  }
+  return true;
+}
+
+} // namespace vulkan
+} // namespace igl
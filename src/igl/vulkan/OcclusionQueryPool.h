@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/OcclusionQueryPool.h>
+#include <igl/vulkan/Common.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanContext;
+
+/**
+ * @brief Encapsulates a VkQueryPool of type VK_QUERY_TYPE_OCCLUSION. The pool is reset by the
+ * render command encoder before the render pass using it begins. Queries are never precise, as
+ * occlusionQueryPrecise is not enabled on the device
+ */
+class OcclusionQueryPool final : public IOcclusionQueryPool {
+ public:
+  OcclusionQueryPool(const VulkanContext& ctx, const OcclusionQueryPoolDesc& desc);
+  ~OcclusionQueryPool() override;
+
+  OcclusionQueryPool(const OcclusionQueryPool&) = delete;
+  OcclusionQueryPool& operator=(const OcclusionQueryPool&) = delete;
+
+  [[nodiscard]] OcclusionQueryType getType() const override {
+    return type_;
+  }
+  [[nodiscard]] uint32_t getCount() const override {
+    return count_;
+  }
+  bool getResults(uint32_t firstQuery, uint32_t queryCount, uint64_t* outResults) override;
+
+  /**
+   * @brief Records the command resetting all queries of the pool into `cmdBuf`. Must be recorded
+   * outside of a render pass
+   */
+  void reset(VkCommandBuffer cmdBuf) const;
+
+  VkQueryPool getVkQueryPool() const {
+    return vkQueryPool_;
+  }
+
+ private:
+  const VulkanContext& ctx_;
+  VkDevice device_ = VK_NULL_HANDLE;
+  VkQueryPool vkQueryPool_ = VK_NULL_HANDLE;
+  OcclusionQueryType type_ = OcclusionQueryType::Binary;
+  uint32_t count_ = 0;
+};
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/ParallelRenderCommandEncoder.h>
+
+#include <igl/vulkan/Buffer.h>
+#include <igl/vulkan/EnhancedShaderDebuggingStore.h>
+#include <igl/vulkan/Framebuffer.h>
+#include <igl/vulkan/RenderBundle.h>
+
+namespace igl {
+namespace vulkan {
+
+ParallelRenderCommandEncoder::ParallelRenderCommandEncoder(
+    const std::shared_ptr<CommandBuffer>& commandBuffer,
+    const VulkanContext& ctx,
+    const std::shared_ptr<IFramebuffer>& framebuffer) :
+  IParallelRenderCommandEncoder::IParallelRenderCommandEncoder(commandBuffer),
+  commandBuffer_(commandBuffer),
+  ctx_(ctx),
+  framebuffer_(framebuffer) {
+  IGL_ASSERT(commandBuffer_);
+}
+
+std::unique_ptr<ParallelRenderCommandEncoder> ParallelRenderCommandEncoder::create(
+    const std::shared_ptr<CommandBuffer>& commandBuffer,
+    const VulkanContext& ctx,
+    const RenderPassDesc& renderPass,
+    const std::shared_ptr<IFramebuffer>& framebuffer,
+    Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  std::unique_ptr<ParallelRenderCommandEncoder> encoder(
+      new ParallelRenderCommandEncoder(commandBuffer, ctx, framebuffer));
+
+  const Result result =
+      RenderCommandEncoder::prepareRenderPass(ctx, renderPass, framebuffer, encoder->state_);
+  if (!result.isOk()) {
+    Result::setResult(outResult, result);
+    return nullptr;
+  }
+
+  // update bindless descriptors once here, so child encoders never have to touch them
+  ctx.checkAndUpdateDescriptorSets();
+
+  encoder->isEncoding_ = true;
+
+  Result::setOk(outResult);
+  return encoder;
+}
+
+std::unique_ptr<IRenderCommandEncoder> ParallelRenderCommandEncoder::createRenderCommandEncoder(
+    Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(isEncoding_)) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "The render pass has ended");
+    return nullptr;
+  }
+
+  VulkanContext::SecondaryCommandBuffer* buffer = ctx_.acquireSecondaryCommandBuffer();
+
+  {
+    std::lock_guard<std::mutex> lock(childrenMutex_);
+    children_.push_back({buffer->cmdBuf, buffer});
+  }
+
+  numActiveChildren_++;
+
+  std::unique_ptr<RenderCommandEncoder> encoder(
+      new RenderCommandEncoder(commandBuffer_, ctx_, buffer->cmdBuf, buffer->dsets, this));
+  encoder->initializeSecondary(state_, framebuffer_);
+
+  if (ctx_.enhancedShaderDebuggingStore_) {
+    encoder->binder().bindStorageBuffer(
+        EnhancedShaderDebuggingStore::kBufferIndex,
+        static_cast<igl::vulkan::Buffer*>(ctx_.enhancedShaderDebuggingStore_->vertexBuffer().get()),
+        0);
+  }
+
+  Result::setOk(outResult);
+  return encoder;
+}
+
+void ParallelRenderCommandEncoder::executeRenderBundle(const IRenderBundle& bundle) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(isEncoding_) || !IGL_VERIFY(!bundle.isRecording())) {
+    return;
+  }
+
+  const auto& vkBundle = static_cast<const vulkan::RenderBundle&>(bundle);
+  VkCommandBuffer cmdBuf = vkBundle.getVkCommandBuffer(commandBuffer_, state_, framebuffer_);
+
+  std::lock_guard<std::mutex> lock(childrenMutex_);
+  children_.push_back({cmdBuf, nullptr});
+}
+
+void ParallelRenderCommandEncoder::onChildEndEncoding() {
+  IGL_ASSERT(numActiveChildren_ > 0);
+  numActiveChildren_--;
+}
+
+void ParallelRenderCommandEncoder::endEncoding() {
+  IGL_PROFILER_FUNCTION();
+
+  if (!isEncoding_) {
+    return;
+  }
+
+  isEncoding_ = false;
+
+  IGL_ASSERT_MSG(numActiveChildren_ == 0,
+                 "All child render command encoders should be ended before the parallel encoder");
+
+  VkCommandBuffer cmdBuf = commandBuffer_->getVkCommandBuffer();
+
+  const auto& fb = static_cast<const vulkan::Framebuffer&>(*framebuffer_);
+
+  std::lock_guard<std::mutex> lock(childrenMutex_);
+
+  std::vector<VkCommandBuffer> cmdBuffers;
+  cmdBuffers.reserve(children_.size());
+  for (const auto& child : children_) {
+    cmdBuffers.push_back(child.cmdBuf);
+  }
+
+  if (state_.pass == VK_NULL_HANDLE) {
+    RenderCommandEncoder::beginRendering(cmdBuf, fb, state_, true);
+    if (!cmdBuffers.empty()) {
+      vkCmdExecuteCommands(cmdBuf, (uint32_t)cmdBuffers.size(), cmdBuffers.data());
+    }
+    RenderCommandEncoder::endRendering(cmdBuf);
+  } else {
+    fb.cmdBeginRenderPass(cmdBuf,
+                          state_.pass,
+                          state_.renderPassIndex,
+                          state_.mipLevel,
+                          (uint32_t)state_.clearValues.size(),
+                          state_.clearValues.data(),
+                          VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    if (!cmdBuffers.empty()) {
+      vkCmdExecuteCommands(cmdBuf, (uint32_t)cmdBuffers.size(), cmdBuffers.data());
+    }
+    vkCmdEndRenderPass(cmdBuf);
+
+    RenderCommandEncoder::setFinalImageLayouts(*framebuffer_);
+  }
+
+  for (; numPendingLabelPops_; numPendingLabelPops_--) {
+    ivkCmdEndDebugUtilsLabel(cmdBuf);
+  }
+
+  // the secondary command buffers can be reused once the primary command buffer has been processed
+  const VulkanContext::SubmitHandle handle = commandBuffer_->getCommandBufferWrapper().handle_;
+  for (const auto& child : children_) {
+    if (child.buffer) {
+      ctx_.releaseSecondaryCommandBuffer(child.buffer, handle);
+    }
+  }
+  children_.clear();
+}
+
+void ParallelRenderCommandEncoder::pushDebugGroupLabel(const std::string& label,
+                                                       const igl::Color& color) const {
+  ivkCmdBeginDebugUtilsLabel(
+      commandBuffer_->getVkCommandBuffer(), label.c_str(), color.toFloatPtr());
+}
+
+void ParallelRenderCommandEncoder::insertDebugEventLabel(const std::string& label,
+                                                         const igl::Color& color) const {
+  ivkCmdInsertDebugUtilsLabel(
+      commandBuffer_->getVkCommandBuffer(), label.c_str(), color.toFloatPtr());
+}
+
+void ParallelRenderCommandEncoder::popDebugGroupLabel() const {
+  numPendingLabelPops_++;
+}
+
+} // namespace vulkan
+} // namespace igl
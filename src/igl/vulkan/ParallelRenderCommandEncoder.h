@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <igl/RenderCommandEncoder.h>
+#include <igl/RenderPass.h>
+#include <igl/vulkan/CommandBuffer.h>
+#include <igl/vulkan/RenderCommandEncoder.h>
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl {
+namespace vulkan {
+
+/**
+ * @brief Records one render pass into several secondary command buffers.
+ *
+ * Every child encoder records its own secondary command buffer with its own transient descriptor
+ * sets, so children can be recorded on different threads. endEncoding() begins the render pass in
+ * the primary command buffer and executes all secondary command buffers in creation order.
+ */
+class ParallelRenderCommandEncoder final : public IParallelRenderCommandEncoder {
+ public:
+  static std::unique_ptr<ParallelRenderCommandEncoder> create(
+      const std::shared_ptr<CommandBuffer>& commandBuffer,
+      const VulkanContext& ctx,
+      const RenderPassDesc& renderPass,
+      const std::shared_ptr<IFramebuffer>& framebuffer,
+      Result* outResult);
+
+  ~ParallelRenderCommandEncoder() override {
+    IGL_ASSERT(!isEncoding_); // did you forget to call endEncoding()?
+    endEncoding();
+  }
+
+  std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder(Result* outResult) override;
+
+  // executes the reusable secondary command buffer of vulkan::RenderBundle
+  void executeRenderBundle(const IRenderBundle& bundle) override;
+
+  void endEncoding() override;
+
+  // labels are recorded into the primary command buffer around the whole render pass
+  void pushDebugGroupLabel(const std::string& label, const igl::Color& color) const override;
+  void insertDebugEventLabel(const std::string& label, const igl::Color& color) const override;
+  void popDebugGroupLabel() const override;
+
+ private:
+  friend class RenderCommandEncoder;
+
+  ParallelRenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                               const VulkanContext& ctx,
+                               const std::shared_ptr<IFramebuffer>& framebuffer);
+
+  void onChildEndEncoding();
+
+ private:
+  std::shared_ptr<CommandBuffer> commandBuffer_;
+  const VulkanContext& ctx_;
+  std::shared_ptr<IFramebuffer> framebuffer_;
+  RenderCommandEncoder::RenderPassState state_;
+  bool isEncoding_ = false;
+  // pops are deferred until the render pass has ended
+  mutable uint32_t numPendingLabelPops_ = 0;
+
+  struct Child {
+    VkCommandBuffer cmdBuf = VK_NULL_HANDLE;
+    // null for the buffers of render bundles, which own them
+    VulkanContext::SecondaryCommandBuffer* buffer = nullptr;
+  };
+  // guards `children_`
+  std::mutex childrenMutex_;
+  // secondary command buffers in creation order
+  std::vector<Child> children_;
+  std::atomic<uint32_t> numActiveChildren_{0};
+};
+
+} // namespace vulkan
+} // namespace igl
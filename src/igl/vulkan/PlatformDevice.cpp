@@ -5,13 +5,20 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <glm/gtc/matrix_transform.hpp>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/Device.h>
 #include <igl/vulkan/PlatformDevice.h>
 #include <igl/vulkan/Texture.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanImage.h>
+#include <igl/vulkan/VulkanImageView.h>
 #include <igl/vulkan/VulkanSwapchain.h>
 
+#if IGL_VULKAN_HWBUFFER_SUPPORTED
+#include <unistd.h>
+#endif // IGL_VULKAN_HWBUFFER_SUPPORTED
+
 namespace igl {
 namespace vulkan {
 
@@ -33,7 +40,8 @@ std::shared_ptr<ITexture> PlatformDevice::createTextureFromNativeDepth(uint32_t
 
   std::shared_ptr<VulkanTexture> vkTex = swapChain->getCurrentDepthTexture();
 
-  if (!IGL_VERIFY(vkTex != nullptr)) {
+  // no image is acquired if VulkanContextConfig::swapchainAcquireTimeoutNs expired
+  if (vkTex == nullptr) {
     Result::setResult(outResult, Result::Code::InvalidOperation, "Swapchain has no valid texture");
     return nullptr;
   }
@@ -80,7 +88,8 @@ std::shared_ptr<ITexture> PlatformDevice::createTextureFromNativeDrawable(Result
 
   std::shared_ptr<VulkanTexture> vkTex = swapChain->getCurrentVulkanTexture();
 
-  if (!IGL_VERIFY(vkTex != nullptr)) {
+  // no image is acquired if VulkanContextConfig::swapchainAcquireTimeoutNs expired
+  if (vkTex == nullptr) {
     Result::setResult(outResult, Result::Code::InvalidOperation, "Swapchain has no valid texture");
     return nullptr;
   }
@@ -120,6 +129,29 @@ std::shared_ptr<ITexture> PlatformDevice::createTextureFromNativeDrawable(Result
   return nativeDrawableTextures_[currentImageIndex];
 }
 
+VkSurfaceTransformFlagBitsKHR PlatformDevice::getSurfacePreTransform() const {
+  return device_.getVulkanContext().getSwapchainPreTransform();
+}
+
+glm::mat4 PlatformDevice::getPreRotationMatrix() const {
+  float degrees = 0.0f;
+  switch (getSurfacePreTransform()) {
+  case VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR:
+    degrees = 90.0f;
+    break;
+  case VK_SURFACE_TRANSFORM_ROTATE_180_BIT_KHR:
+    degrees = 180.0f;
+    break;
+  case VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR:
+    degrees = 270.0f;
+    break;
+  default:
+    // mirrored transforms are not used by displays in practice
+    break;
+  }
+  return glm::rotate(glm::mat4(1.0f), glm::radians(degrees), glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
 VkFence PlatformDevice::getVkFenceFromSubmitHandle(SubmitHandle handle) const {
   if (handle == 0) {
     IGL_LOG_ERROR("Invalid submit handle passed to getVkFenceFromSubmitHandle");
@@ -172,5 +204,198 @@ int PlatformDevice::getFenceFdFromSubmitHandle(SubmitHandle handle) const {
 }
 #endif // defined(IGL_PLATFORM_ANDROID)
 
+#if IGL_VULKAN_HWBUFFER_SUPPORTED
+std::shared_ptr<ITexture> PlatformDevice::createTextureFromNativeHWBuffer(
+    AHardwareBuffer* _Nonnull buffer,
+    TextureDesc::TextureUsage usage,
+    int acquireFenceFd,
+    Result* _Nullable outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  const auto& ctx = device_.getVulkanContext();
+  const VkDevice vkDevice = ctx.getVkDevice();
+
+  // IGL owns the acquire fence even if the import fails
+  auto fail = [acquireFenceFd, outResult](Result::Code code, const char* message) {
+    if (acquireFenceFd >= 0) {
+      close(acquireFenceFd);
+    }
+    Result::setResult(outResult, code, message);
+    return nullptr;
+  };
+
+  if (!ctx.hasNativeHWBufferInterop_) {
+    return fail(Result::Code::Unsupported,
+                "VK_ANDROID_external_memory_android_hardware_buffer is not supported");
+  }
+
+  TextureDesc desc;
+  const Result descResult = igl::android::getNativeHWBufferTextureDesc(buffer, usage, desc);
+  if (!descResult.isOk()) {
+    return fail(descResult.code, descResult.message.c_str());
+  }
+  // YUV buffers are external images in OpenGL; Vulkan samples them as 2D images with a conversion
+  desc.type = TextureType::TwoD;
+
+  const bool isDepthOrStencil = desc.format != TextureFormat::Invalid &&
+                                TextureFormatProperties::fromTextureFormat(desc.format)
+                                    .isDepthOrStencil();
+  VkImageUsageFlags usageFlags = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  if (usage & TextureDesc::TextureUsageBits::Sampled) {
+    usageFlags |= VK_IMAGE_USAGE_SAMPLED_BIT;
+  }
+  if (usage & TextureDesc::TextureUsageBits::Storage) {
+    usageFlags |= VK_IMAGE_USAGE_STORAGE_BIT;
+  }
+  if (usage & TextureDesc::TextureUsageBits::Attachment) {
+    usageFlags |= isDepthOrStencil ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+                                   : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+  }
+
+  auto image = VulkanImage::createFromNativeHWBuffer(
+      ctx, vkDevice, buffer, usageFlags, "Image: AHardwareBuffer");
+  if (!image) {
+    return fail(Result::Code::Unsupported, "Cannot import the AHardwareBuffer");
+  }
+  // the Vulkan format is the one the driver reports for the buffer
+  desc.format = vkFormatToTextureFormat(image->imageFormat_);
+  if (desc.format == TextureFormat::Invalid) {
+    return fail(Result::Code::Unsupported, "AHardwareBuffer format has no IGL equivalent");
+  }
+
+  VkSemaphore acquireSemaphore = VK_NULL_HANDLE;
+  if (acquireFenceFd >= 0) {
+    VK_ASSERT(ivkCreateSemaphore(vkDevice, &acquireSemaphore));
+    // a temporary import: the semaphore goes back to its empty payload after the wait
+    const VkImportSemaphoreFdInfoKHR importInfo = {
+        VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR,
+        nullptr,
+        acquireSemaphore,
+        VK_SEMAPHORE_IMPORT_TEMPORARY_BIT,
+        VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT,
+        acquireFenceFd,
+    };
+    if (vkImportSemaphoreFdKHR(vkDevice, &importInfo) != VK_SUCCESS) {
+      vkDestroySemaphore(vkDevice, acquireSemaphore, nullptr);
+      return fail(Result::Code::RuntimeError, "Cannot import the acquire fence");
+    }
+    // the semaphore owns the file descriptor now
+  }
+
+  // acquire the image from the producer; the transition from VK_IMAGE_LAYOUT_UNDEFINED keeps
+  // the contents of the buffer as part of an ownership transfer from the foreign queue family
+  const VkImageLayout layout = (usage & TextureDesc::TextureUsageBits::Sampled)
+                                   ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                                   : VK_IMAGE_LAYOUT_GENERAL;
+  const VkImageMemoryBarrier barrier = {
+      VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      nullptr,
+      0,
+      VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
+      VK_IMAGE_LAYOUT_UNDEFINED,
+      layout,
+      VK_QUEUE_FAMILY_FOREIGN_EXT,
+      ctx.deviceQueues_.graphicsQueueFamilyIndex,
+      image->vkImage_,
+      VkImageSubresourceRange{image->getImageAspectFlags(), 0, 1, 0, 1},
+  };
+  const auto& wrapper = ctx.immediate_->acquire();
+  vkCmdPipelineBarrier(wrapper.cmdBuf_,
+                       VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       1,
+                       &barrier);
+  image->setLayout(layout, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+  if (acquireSemaphore != VK_NULL_HANDLE) {
+    ctx.immediate_->waitSemaphore(acquireSemaphore);
+  }
+  const auto handle = ctx.immediate_->submit(wrapper);
+  if (acquireSemaphore != VK_NULL_HANDLE) {
+    ctx.deferredTask(std::packaged_task<void()>([vkDevice, acquireSemaphore]() {
+                       vkDestroySemaphore(vkDevice, acquireSemaphore, nullptr);
+                     }),
+                     handle);
+  }
+
+  std::shared_ptr<VulkanImageView> imageView =
+      image->createImageView(VK_IMAGE_VIEW_TYPE_2D,
+                             image->imageFormat_,
+                             image->getImageAspectFlags(),
+                             0,
+                             VK_REMAINING_MIP_LEVELS,
+                             0,
+                             1,
+                             "Image View: AHardwareBuffer");
+  if (!IGL_VERIFY(imageView)) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "Cannot create VulkanImageView");
+    return nullptr;
+  }
+
+  auto texture = std::make_shared<igl::vulkan::Texture>(
+      device_, ctx.createTexture(std::move(image), std::move(imageView)), desc);
+  if (auto resourceTracker = device_.getResourceTracker()) {
+    texture->initResourceTracker(resourceTracker);
+  }
+
+  Result::setResult(outResult, Result::Code::Ok);
+  return texture;
+}
+
+AHardwareBuffer* _Nullable PlatformDevice::getNativeHWBuffer(const ITexture& texture) const {
+  const auto& vkTexture = static_cast<const Texture&>(texture);
+  return vkTexture.getVulkanTexture().getVulkanImage().nativeHWBuffer_;
+}
+
+int PlatformDevice::createReleaseFence(Result* _Nullable outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  const auto& ctx = device_.getVulkanContext();
+  if (!ctx.hasNativeHWBufferInterop_) {
+    Result::setResult(
+        outResult, Result::Code::Unsupported, "VK_KHR_external_semaphore_fd is not supported");
+    return -1;
+  }
+  const VkDevice vkDevice = ctx.getVkDevice();
+
+  const VkExportSemaphoreCreateInfoKHR exportInfo = {
+      VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO_KHR,
+      nullptr,
+      VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT,
+  };
+  const VkSemaphoreCreateInfo ci = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, &exportInfo, 0};
+  VkSemaphore semaphore = VK_NULL_HANDLE;
+  VK_ASSERT(vkCreateSemaphore(vkDevice, &ci, nullptr, &semaphore));
+
+  // submits are chained, so an empty command buffer finishes after all the previous ones
+  ctx.stagingDevice_->submitPendingUploads(*ctx.immediate_);
+  const auto handle = ctx.immediate_->submit(ctx.immediate_->acquire(), semaphore);
+
+  const VkSemaphoreGetFdInfoKHR getFdInfo = {
+      VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR,
+      nullptr,
+      semaphore,
+      VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT,
+  };
+  int fenceFd = -1;
+  const VkResult result = vkGetSemaphoreFdKHR(vkDevice, &getFdInfo, &fenceFd);
+  ctx.deferredTask(std::packaged_task<void()>([vkDevice, semaphore]() {
+                     vkDestroySemaphore(vkDevice, semaphore, nullptr);
+                   }),
+                   handle);
+  if (result != VK_SUCCESS) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot export the release fence");
+    return -1;
+  }
+
+  Result::setResult(outResult, Result::Code::Ok);
+  return fenceFd;
+}
+#endif // IGL_VULKAN_HWBUFFER_SUPPORTED
+
 } // namespace vulkan
 } // namespace igl
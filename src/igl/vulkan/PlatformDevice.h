@@ -7,10 +7,18 @@
 
 #pragma once
 
+#include <glm/glm.hpp>
 #include <igl/PlatformDevice.h>
 #include <igl/Texture.h>
+#include <igl/android/NativeHWBuffer.h>
 #include <igl/vulkan/Common.h>
 
+#if IGL_ANDROID_HWBUFFER_SUPPORTED && defined(VK_ANDROID_external_memory_android_hardware_buffer)
+#define IGL_VULKAN_HWBUFFER_SUPPORTED 1
+#else
+#define IGL_VULKAN_HWBUFFER_SUPPORTED 0
+#endif
+
 namespace igl {
 class ITexture;
 
@@ -19,7 +27,11 @@ namespace vulkan {
 class Device;
 class VulkanTexture;
 
-class PlatformDevice : public IPlatformDevice {
+class PlatformDevice : public IPlatformDevice
+#if IGL_VULKAN_HWBUFFER_SUPPORTED
+    , public igl::android::INativeHWBufferInterop
+#endif // IGL_VULKAN_HWBUFFER_SUPPORTED
+{
  public:
   static constexpr igl::PlatformDeviceType Type = igl::PlatformDeviceType::Vulkan;
 
@@ -40,6 +52,15 @@ class PlatformDevice : public IPlatformDevice {
   /// @return pointer to generated Texture or nullptr
   std::shared_ptr<ITexture> createTextureFromNativeDrawable(Result* outResult);
 
+  /// With VulkanContextConfig::enableSwapchainPreRotation, the rotation the swapchain images have
+  /// to be rendered in to match the display; identity otherwise.
+  [[nodiscard]] VkSurfaceTransformFlagBitsKHR getSurfacePreTransform() const;
+
+  /// Rotates clip space by getSurfacePreTransform(): multiply it to the left of the projection
+  /// matrix. The aspect ratio of the projection stays the one of the window, while the viewport
+  /// and the framebuffer are the (swapped) size of the swapchain images.
+  [[nodiscard]] glm::mat4 getPreRotationMatrix() const;
+
   /// @param handle The handle to the GPU Fence
   /// @return The Vulkan fence associated with the handle
   [[nodiscard]] VkFence getVkFenceFromSubmitHandle(SubmitHandle handle) const;
@@ -55,6 +76,21 @@ class PlatformDevice : public IPlatformDevice {
   [[nodiscard]] int getFenceFdFromSubmitHandle(SubmitHandle handle) const;
 #endif
 
+#if IGL_VULKAN_HWBUFFER_SUPPORTED
+  /// Imports `buffer` with VK_ANDROID_external_memory_android_hardware_buffer. The acquire fence
+  /// is imported into a semaphore waited on by the next submit, which also acquires the image from
+  /// the foreign queue family.
+  std::shared_ptr<ITexture> createTextureFromNativeHWBuffer(AHardwareBuffer* _Nonnull buffer,
+                                                            TextureDesc::TextureUsage usage,
+                                                            int acquireFenceFd,
+                                                            Result* _Nullable outResult) override;
+
+  AHardwareBuffer* _Nullable getNativeHWBuffer(const ITexture& texture) const override;
+
+  /// Exports a sync fd semaphore signaled after all the command buffers submitted so far.
+  int createReleaseFence(Result* _Nullable outResult) override;
+#endif // IGL_VULKAN_HWBUFFER_SUPPORTED
+
  protected:
   bool isType(PlatformDeviceType t) const noexcept override {
     return t == Type;
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/Readback.h>
+
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanStagingDevice.h>
+
+namespace igl {
+namespace vulkan {
+
+Readback::Readback(const VulkanContext& ctx, uint64_t readbackId, size_t size) :
+  ctx_(ctx), readbackId_(readbackId), size_(size) {}
+
+Readback::~Readback() {
+  if (!isCollected_) {
+    ctx_.stagingDevice_->discardReadback(readbackId_);
+  }
+}
+
+bool Readback::isReady() const {
+  return !isCollected_ && ctx_.stagingDevice_->isReadbackReady(readbackId_);
+}
+
+Result Readback::getData(void* outData) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(outData)) {
+    return Result(Result::Code::ArgumentNull, "outData is null");
+  }
+  if (isCollected_) {
+    return Result(Result::Code::InvalidOperation, "The data has already been retrieved");
+  }
+  isCollected_ = true;
+  if (!ctx_.stagingDevice_->collectImageData2D(readbackId_, outData, 0, false)) {
+    return Result(Result::Code::RuntimeError,
+                  "The readback was dropped; increase VulkanContextConfig::maxAsyncReadbacks");
+  }
+  return Result();
+}
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/Readback.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanContext;
+
+/**
+ * @brief A readback of the ring of host-visible buffers of VulkanStagingDevice. The ring holds
+ * VulkanContextConfig::maxAsyncReadbacks readbacks; older ones are dropped.
+ */
+class Readback final : public IReadback {
+ public:
+  Readback(const VulkanContext& ctx, uint64_t readbackId, size_t size);
+  ~Readback() override;
+
+  Readback(const Readback&) = delete;
+  Readback& operator=(const Readback&) = delete;
+
+  [[nodiscard]] bool isReady() const override;
+  [[nodiscard]] size_t getSizeInBytes() const override {
+    return size_;
+  }
+  Result getData(void* outData) override;
+
+ private:
+  const VulkanContext& ctx_;
+  uint64_t readbackId_ = 0;
+  size_t size_ = 0;
+  bool isCollected_ = false;
+};
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/RenderBundle.h>
+
+#include <igl/vulkan/Buffer.h>
+#include <igl/vulkan/EnhancedShaderDebuggingStore.h>
+#include <igl/vulkan/Texture.h>
+#include <igl/vulkan/VulkanImage.h>
+#include <igl/vulkan/VulkanTexture.h>
+
+namespace igl {
+namespace vulkan {
+
+RenderBundle::RenderBundle(const VulkanContext& ctx, const RenderBundleDesc& desc) :
+  IRenderBundle(desc), ctx_(ctx) {}
+
+RenderBundle::~RenderBundle() {
+  releaseCommandBuffers();
+}
+
+bool RenderBundle::Compatibility::operator==(const Compatibility& other) const {
+  return pass == other.pass && renderPassIndex == other.renderPassIndex &&
+         colorFormats == other.colorFormats && depthStencilFormat == other.depthStencilFormat &&
+         samples == other.samples && viewMask == other.viewMask;
+}
+
+RenderBundle::Compatibility RenderBundle::getCompatibility(
+    const RenderCommandEncoder::RenderPassState& state) {
+  Compatibility compatibility;
+  // pipelines are selected by the render pass index
+  compatibility.renderPassIndex = state.renderPassIndex;
+  if (state.pass != VK_NULL_HANDLE) {
+    // render passes are cached by VulkanContext, so the same attachments share one VkRenderPass
+    compatibility.pass = state.pass;
+    return compatibility;
+  }
+
+  compatibility.colorFormats.reserve(state.colorAttachments.size());
+  for (const auto& attachment : state.colorAttachments) {
+    const VulkanImage& image = attachment.texture->getVulkanTexture().getVulkanImage();
+    compatibility.colorFormats.push_back(image.imageFormat_);
+    compatibility.samples = image.samples_;
+  }
+  if (state.depthAttachment.texture) {
+    const VulkanImage& image = state.depthAttachment.texture->getVulkanTexture().getVulkanImage();
+    compatibility.depthStencilFormat = image.imageFormat_;
+    compatibility.samples = image.samples_;
+  }
+  compatibility.viewMask = state.viewMask;
+
+  return compatibility;
+}
+
+VkCommandBuffer RenderBundle::getVkCommandBuffer(
+    const std::shared_ptr<CommandBuffer>& commandBuffer,
+    const RenderCommandEncoder::RenderPassState& state,
+    const std::shared_ptr<IFramebuffer>& framebuffer) const {
+  IGL_PROFILER_FUNCTION();
+
+  const VulkanContext::SubmitHandle handle = commandBuffer->getCommandBufferWrapper().handle_;
+  Compatibility compatibility = getCompatibility(state);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (auto& recording : recordings_) {
+    if (recording.compatibility == compatibility) {
+      recording.handle = handle;
+      return recording.buffer->cmdBuf;
+    }
+  }
+
+  IGL_PROFILER_ZONE("record", IGL_PROFILER_COLOR_CREATE);
+
+  VulkanContext::SecondaryCommandBuffer* buffer = ctx_.acquireSecondaryCommandBuffer();
+
+  {
+    // the encoder is not attached to a parallel encoder, and records the buffer for reuse
+    std::unique_ptr<RenderCommandEncoder> encoder(
+        new RenderCommandEncoder(commandBuffer, ctx_, buffer->cmdBuf, buffer->dsets, nullptr));
+    encoder->initializeSecondary(state, framebuffer, true);
+
+    if (ctx_.enhancedShaderDebuggingStore_) {
+      encoder->binder().bindStorageBuffer(
+          EnhancedShaderDebuggingStore::kBufferIndex,
+          static_cast<igl::vulkan::Buffer*>(
+              ctx_.enhancedShaderDebuggingStore_->vertexBuffer().get()),
+          0);
+    }
+
+    getCommandStream().replay(*encoder);
+    encoder->endEncoding();
+  }
+
+  IGL_PROFILER_ZONE_END();
+
+  recordings_.push_back({std::move(compatibility), buffer, handle});
+
+  return buffer->cmdBuf;
+}
+
+void RenderBundle::onContentsChanged() {
+  releaseCommandBuffers();
+}
+
+void RenderBundle::releaseCommandBuffers() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // the buffers and their descriptor sets are recycled once the last primary command buffer
+  // executing them has been processed
+  for (const auto& recording : recordings_) {
+    ctx_.releaseSecondaryCommandBuffer(recording.buffer, recording.handle);
+  }
+  recordings_.clear();
+}
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <igl/RenderBundle.h>
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/RenderCommandEncoder.h>
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl {
+namespace vulkan {
+
+/**
+ * @brief A render bundle which is executed by ParallelRenderCommandEncoder as a secondary command
+ * buffer with VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT.
+ *
+ * The secondary command buffer is recorded from the command stream the first time the bundle is
+ * executed in a render pass, together with its transient descriptor sets, and is reused by every
+ * compatible render pass afterwards: same VkRenderPass, or same attachment formats, sample count
+ * and view mask with dynamic rendering. Recording new commands drops the secondary command buffers
+ * once the GPU is done with them. Regular render command encoders replay the stream.
+ */
+class RenderBundle final : public IRenderBundle {
+ public:
+  RenderBundle(const VulkanContext& ctx, const RenderBundleDesc& desc);
+  ~RenderBundle() override;
+
+  RenderBundle(const RenderBundle&) = delete;
+  RenderBundle& operator=(const RenderBundle&) = delete;
+
+  // returns the secondary command buffer executing the bundle in the render pass `state` of
+  // `commandBuffer`, recording it first if there is no compatible one yet. Thread-safe.
+  VkCommandBuffer getVkCommandBuffer(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                                     const RenderCommandEncoder::RenderPassState& state,
+                                     const std::shared_ptr<IFramebuffer>& framebuffer) const;
+
+ private:
+  void onContentsChanged() override;
+  void releaseCommandBuffers();
+
+  // what the secondary command buffers inherit from the render pass
+  struct Compatibility {
+    VkRenderPass pass = VK_NULL_HANDLE;
+    uint16_t renderPassIndex = 0;
+    std::vector<VkFormat> colorFormats;
+    VkFormat depthStencilFormat = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    uint32_t viewMask = 0;
+
+    bool operator==(const Compatibility& other) const;
+  };
+  static Compatibility getCompatibility(const RenderCommandEncoder::RenderPassState& state);
+
+  struct Recording {
+    Compatibility compatibility;
+    VulkanContext::SecondaryCommandBuffer* buffer = nullptr;
+    // the last primary command buffer executing `buffer`
+    VulkanContext::SubmitHandle handle = VulkanContext::SubmitHandle();
+  };
+
+  const VulkanContext& ctx_;
+  // guards `recordings_`
+  mutable std::mutex mutex_;
+  mutable std::vector<Recording> recordings_;
+};
+
+} // namespace vulkan
+} // namespace igl
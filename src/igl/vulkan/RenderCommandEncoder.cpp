@@ -8,13 +8,18 @@
 #include <igl/vulkan/RenderCommandEncoder.h>
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 
 #include <igl/RenderPass.h>
+#include <igl/vulkan/BindGroup.h>
 #include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/CommandBuffer.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/DepthStencilState.h>
 #include <igl/vulkan/Framebuffer.h>
+#include <igl/vulkan/OcclusionQueryPool.h>
+#include <igl/vulkan/ParallelRenderCommandEncoder.h>
 #include <igl/vulkan/RenderPipelineState.h>
 #include <igl/vulkan/SamplerState.h>
 #include <igl/vulkan/Texture.h>
@@ -51,11 +56,45 @@ VkAttachmentStoreOp storeActionToVkAttachmentStoreOp(igl::StoreAction a) {
   case StoreAction::MsaaResolve:
     // for MSAA resolve, we have to store data into a special "resolve" attachment
     return VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  case StoreAction::StoreAndMsaaResolve:
+    return VK_ATTACHMENT_STORE_OP_STORE;
   }
   IGL_ASSERT(false);
   return VK_ATTACHMENT_STORE_OP_DONT_CARE;
 }
 
+#if IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+// falls back to sample 0, which every implementation supports, if the filter is not supported
+VkResolveModeFlagBits depthResolveFilterToVkResolveMode(igl::MsaaDepthResolveFilter filter,
+                                                        VkFlags supportedModes) {
+  VkResolveModeFlagBits mode = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT_KHR;
+  switch (filter) {
+  case igl::MsaaDepthResolveFilter::Sample0:
+    break;
+  case igl::MsaaDepthResolveFilter::Min:
+    mode = VK_RESOLVE_MODE_MIN_BIT_KHR;
+    break;
+  case igl::MsaaDepthResolveFilter::Max:
+    mode = VK_RESOLVE_MODE_MAX_BIT_KHR;
+    break;
+  }
+  return (supportedModes & mode) ? mode : VK_RESOLVE_MODE_SAMPLE_ZERO_BIT_KHR;
+}
+
+// integer formats are resolved by taking sample 0 instead of averaging the samples
+bool isIntegerFormat(igl::TextureFormat format) {
+  switch (format) {
+  case igl::TextureFormat::R_UInt16:
+  case igl::TextureFormat::RG_UInt16:
+  case igl::TextureFormat::RGB10_A2_Uint_Rev:
+  case igl::TextureFormat::RGBA_UInt32:
+    return true;
+  default:
+    return false;
+  }
+}
+#endif // IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+
 VkStencilOp stencilOperationToVkStencilOp(igl::StencilOperation op) {
   switch (op) {
   case igl::StencilOperation::Keep:
@@ -123,31 +162,54 @@ RenderCommandEncoder::RenderCommandEncoder(const std::shared_ptr<CommandBuffer>&
   IGL_ASSERT(cmdBuffer_ != VK_NULL_HANDLE);
 }
 
-void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
-                                      const std::shared_ptr<IFramebuffer>& framebuffer,
-                                      Result* outResult) {
+RenderCommandEncoder::RenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                                           const VulkanContext& ctx,
+                                           VkCommandBuffer secondaryCmdBuffer,
+                                           VulkanTransientDescriptorSets& dsets,
+                                           ParallelRenderCommandEncoder* parallelEncoder) :
+  IRenderCommandEncoder::IRenderCommandEncoder(commandBuffer),
+  ctx_(ctx),
+  cmdBuffer_(secondaryCmdBuffer),
+  binder_(secondaryCmdBuffer, dsets, ctx, VK_PIPELINE_BIND_POINT_GRAPHICS),
+  isSecondary_(true),
+  parallelEncoder_(parallelEncoder) {
   IGL_PROFILER_FUNCTION();
-  framebuffer_ = framebuffer;
+  IGL_ASSERT(commandBuffer);
+  IGL_ASSERT(cmdBuffer_ != VK_NULL_HANDLE);
+}
 
-  Result::setOk(outResult);
+Result RenderCommandEncoder::prepareRenderPass(const VulkanContext& ctx,
+                                               const RenderPassDesc& renderPass,
+                                               const std::shared_ptr<IFramebuffer>& framebuffer,
+                                               RenderPassState& outState) {
+  IGL_PROFILER_FUNCTION();
 
   if (!IGL_VERIFY(framebuffer)) {
-    Result::setResult(outResult, Result::Code::ArgumentNull);
-    return;
+    return Result(Result::Code::ArgumentNull);
   }
 
   const FramebufferDesc& desc = static_cast<const Framebuffer&>((*framebuffer)).getDesc();
 
   IGL_ASSERT(desc.colorAttachments.size() <= IGL_COLOR_ATTACHMENTS_MAX);
 
-  std::vector<VkClearValue> clearValues;
-  uint32_t mipLevel = 0;
+  std::vector<VkClearValue>& clearValues = outState.clearValues;
+  uint32_t& mipLevel = outState.mipLevel;
+
+  clearValues.clear();
+  mipLevel = 0;
+  outState.colorAttachments.clear();
+  outState.depthAttachment = {};
+  outState.viewMask = 0;
+
+  // dynamic rendering needs neither a VkRenderPass nor the layouts it transitions from
+  const bool useDynamicRendering = ctx.usesDynamicRendering();
 
   VulkanRenderPassBuilder builder;
 
   if (desc.mode != FramebufferMode::Mono) {
     if (desc.mode == FramebufferMode::Stereo) {
       builder.setMultiviewMasks(0x00000003, 0x00000003);
+      outState.viewMask = 0x00000003;
     } else {
       IGL_ASSERT_MSG(0, "FramebufferMode::Multiview is not implemented.");
     }
@@ -164,6 +226,10 @@ void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
 
   VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
 
+  // the positions of the color attachments in the render pass, which skips the missing ones
+  std::array<uint32_t, IGL_COLOR_ATTACHMENTS_MAX> colorPositions;
+  colorPositions.fill(UINT32_MAX);
+
   for (size_t i = 0; i < largestIndexPlusOne; ++i) {
     auto it = desc.colorAttachments.find(i);
     if (it == desc.colorAttachments.end()) {
@@ -177,11 +243,9 @@ void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
     // get into this loop even when renderPass.colorAttachments.empty() == true
     if (i >= renderPass.colorAttachments.size()) {
       IGL_ASSERT(false);
-      Result::setResult(
-          outResult,
+      return Result(
           Result::Code::ArgumentInvalid,
           "Framebuffer color attachment count larger than renderPass color attachment count");
-      return;
     }
 
     const auto& descColor = renderPass.colorAttachments[i];
@@ -194,67 +258,258 @@ void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
                      "All color attachments should have the same mip-level");
     }
     mipLevel = descColor.mipLevel;
-    const auto initialLayout = descColor.loadAction == igl::LoadAction::Load
-                                   ? colorTexture.getVulkanTexture().getVulkanImage().imageLayout_
-                                   : VK_IMAGE_LAYOUT_UNDEFINED;
-    builder.addColor(textureFormatToVkFormat(colorTexture.getFormat()),
-                     loadActionToVkAttachmentLoadOp(descColor.loadAction),
-                     storeActionToVkAttachmentStoreOp(descColor.storeAction),
-                     initialLayout,
-                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                     colorTexture.getVulkanTexture().getVulkanImage().samples_);
+    RenderPassState::Attachment attachment;
+    attachment.texture = &colorTexture;
+    attachment.loadOp = loadActionToVkAttachmentLoadOp(descColor.loadAction);
+    attachment.storeOp = storeActionToVkAttachmentStoreOp(descColor.storeAction);
+    attachment.clearValue = clearValues.back();
+    if (!useDynamicRendering) {
+      const auto initialLayout = descColor.loadAction == igl::LoadAction::Load
+                                     ? colorTexture.getVulkanTexture().getVulkanImage().imageLayout_
+                                     : VK_IMAGE_LAYOUT_UNDEFINED;
+      builder.addColor(textureFormatToVkFormat(colorTexture.getFormat()),
+                       attachment.loadOp,
+                       attachment.storeOp,
+                       initialLayout,
+                       VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                       colorTexture.getVulkanTexture().getVulkanImage().samples_);
+    }
     // RenderPassBuilder ensures that all non-resolve attachments have the same number of samples
     samples = colorTexture.getVulkanTexture().getVulkanImage().samples_;
     // handle MSAA
-    if (descColor.storeAction == StoreAction::MsaaResolve) {
+    if (isMsaaResolve(descColor.storeAction)) {
       IGL_ASSERT_MSG(it->second.resolveTexture != nullptr,
                      "Framebuffer attachment should contain a resolve texture");
       const auto& colorResolveTexture = static_cast<vulkan::Texture&>(*it->second.resolveTexture);
-      builder.addColorResolve(textureFormatToVkFormat(colorResolveTexture.getFormat()),
-                              VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-                              VK_ATTACHMENT_STORE_OP_STORE);
+      attachment.resolveTexture = &colorResolveTexture;
+      if (!useDynamicRendering) {
+        builder.addColorResolve(textureFormatToVkFormat(colorResolveTexture.getFormat()),
+                                VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                                VK_ATTACHMENT_STORE_OP_STORE);
+      }
       clearValues.push_back(ivkGetClearColorValue(descColor.clearColor.r,
                                                   descColor.clearColor.g,
                                                   descColor.clearColor.b,
                                                   descColor.clearColor.a));
     }
+    if (i < colorPositions.size()) {
+      colorPositions[i] = (uint32_t)outState.colorAttachments.size();
+    }
+    outState.colorAttachments.push_back(attachment);
   }
 
   // Process depth attachment
   const RenderPassDesc::DepthAttachmentDesc descDepth = renderPass.depthAttachment;
   const RenderPassDesc::StencilAttachmentDesc descStencil = renderPass.stencilAttachment;
-  hasDepthAttachment_ = false;
+  outState.hasDepthAttachment = false;
 
   if (framebuffer->getDepthAttachment()) {
     const auto& depthTexture = static_cast<vulkan::Texture&>(*(framebuffer->getDepthAttachment()));
-    hasDepthAttachment_ = true;
+    outState.hasDepthAttachment = true;
     IGL_ASSERT_MSG(descDepth.mipLevel == mipLevel,
                    "Depth attachment should have the same mip-level as color attachments");
     clearValues.push_back(
         ivkGetClearDepthStencilValue(descDepth.clearDepth, descStencil.clearStencil));
-    const auto initialLayout = descDepth.loadAction == igl::LoadAction::Load
-                                   ? depthTexture.getVulkanTexture().getVulkanImage().imageLayout_
-                                   : VK_IMAGE_LAYOUT_UNDEFINED;
-    builder.addDepth(depthTexture.getVkFormat(),
-                     loadActionToVkAttachmentLoadOp(descDepth.loadAction),
-                     storeActionToVkAttachmentStoreOp(descDepth.storeAction),
-                     initialLayout,
-                     VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-                     depthTexture.getVulkanTexture().getVulkanImage().samples_);
+    outState.depthAttachment.texture = &depthTexture;
+    outState.depthAttachment.loadOp = loadActionToVkAttachmentLoadOp(descDepth.loadAction);
+    outState.depthAttachment.storeOp = storeActionToVkAttachmentStoreOp(descDepth.storeAction);
+    outState.depthAttachment.clearValue = clearValues.back();
+    outState.stencilLoadOp = loadActionToVkAttachmentLoadOp(descStencil.loadAction);
+    outState.stencilStoreOp = storeActionToVkAttachmentStoreOp(descStencil.storeAction);
+    if (!useDynamicRendering) {
+      const auto initialLayout = descDepth.loadAction == igl::LoadAction::Load
+                                     ? depthTexture.getVulkanTexture().getVulkanImage().imageLayout_
+                                     : VK_IMAGE_LAYOUT_UNDEFINED;
+      builder.addDepth(depthTexture.getVkFormat(),
+                       outState.depthAttachment.loadOp,
+                       outState.depthAttachment.storeOp,
+                       initialLayout,
+                       VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                       depthTexture.getVulkanTexture().getVulkanImage().samples_);
+    }
     // RenderPassBuilder ensures that all non-resolve attachments have the same number of samples
     samples = depthTexture.getVulkanTexture().getVulkanImage().samples_;
+    // handle depth MSAA: resolve attachments of the depth aspect need dynamic rendering
+    const auto& depthResolveTexture = framebuffer->getResolveDepthAttachment();
+    if (depthResolveTexture && isMsaaResolve(descDepth.storeAction)) {
+#if IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+      if (useDynamicRendering) {
+        outState.depthAttachment.resolveTexture =
+            static_cast<vulkan::Texture*>(depthResolveTexture.get());
+        outState.depthResolveMode = depthResolveFilterToVkResolveMode(
+            descDepth.depthResolveFilter, ctx.getSupportedDepthResolveModes());
+      }
+#endif // IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+      if (!outState.depthAttachment.resolveTexture) {
+        IGL_LOG_ERROR_ONCE("Depth MSAA resolve requires VK_KHR_dynamic_rendering\n");
+      }
+    }
+  }
+
+  if (!renderPass.subpasses.empty()) {
+    if (!ctx.hasInputAttachments()) {
+      return Result(Result::Code::Unsupported, "Subpasses require DeviceFeatures::Subpasses");
+    }
+    const auto getPositions = [&colorPositions](const std::vector<uint8_t>& indices,
+                                                std::vector<uint32_t>& outPositions) {
+      for (const uint8_t index : indices) {
+        if (index >= colorPositions.size() || colorPositions[index] == UINT32_MAX) {
+          return false;
+        }
+        outPositions.push_back(colorPositions[index]);
+      }
+      return true;
+    };
+    for (const auto& subpass : renderPass.subpasses) {
+      std::vector<uint32_t> colors;
+      std::vector<uint32_t> inputs;
+      if (!getPositions(subpass.colorAttachments, colors) ||
+          !getPositions(subpass.inputAttachments, inputs)) {
+        IGL_ASSERT(false);
+        return Result(Result::Code::ArgumentInvalid,
+                      "Subpass attachment is not a color attachment of the framebuffer");
+      }
+      builder.addSubpass(std::move(colors), std::move(inputs), subpass.usesDepthStencil);
+    }
+  }
+
+  if (useDynamicRendering) {
+    // VulkanContext does not use dynamic rendering together with fragment density maps
+    IGL_ASSERT_MSG(!desc.densityMapAttachment.texture, "Fragment density maps are not enabled");
+    outState.pass = VK_NULL_HANDLE;
+    outState.renderPassIndex = 0;
+    return Result();
+  }
+
+  if (desc.densityMapAttachment.texture) {
+    IGL_ASSERT_MSG(ctx.usesFragmentDensityMap(), "Fragment density maps are not enabled");
+    const auto& densityMapTexture =
+        static_cast<vulkan::Texture&>(*desc.densityMapAttachment.texture);
+    builder.addFragmentDensityMap(densityMapTexture.getVkFormat());
+  }
+
+  const auto renderPassHandle = ctx.findRenderPass(builder);
+
+  outState.pass = renderPassHandle.pass;
+  outState.renderPassIndex = renderPassHandle.index;
+
+  return Result();
+}
+
+void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
+                                      const std::shared_ptr<IFramebuffer>& framebuffer,
+                                      Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+  framebuffer_ = framebuffer;
+
+  RenderPassState state;
+  const Result result = prepareRenderPass(ctx_, renderPass, framebuffer, state);
+  if (!result.isOk()) {
+    Result::setResult(outResult, result);
+    return;
   }
 
   const auto& fb = static_cast<vulkan::Framebuffer&>(*framebuffer);
 
-  auto renderPassHandle = ctx_.findRenderPass(builder);
+  hasDepthAttachment_ = state.hasDepthAttachment;
+  dynamicState_.renderPassIndex_ = state.renderPassIndex;
+  dynamicState_.viewMask_ = state.viewMask;
+  dynamicState_.depthBiasEnable_ = false;
+  subpasses_ = renderPass.subpasses;
+  currentSubpass_ = 0;
+  mipLevel_ = state.mipLevel;
+
+  bindDefaultViewportAndScissor(fb, state.mipLevel);
+
+  ctx_.checkAndUpdateDescriptorSets();
+  binder_.bindDefaultDescriptorSets();
+
+  occlusionQueryPool_ = renderPass.occlusionQueryPool;
+  if (occlusionQueryPool_) {
+    // queries can only be reset outside of a render pass
+    static_cast<const OcclusionQueryPool&>(*occlusionQueryPool_).reset(cmdBuffer_);
+  }
+
+  IGL_PROFILER_ZONE_GPU_BEGIN_VK(tracyGpuZone_, "RenderPass", ctx_.getTracyContext(), cmdBuffer_);
 
-  dynamicState_.renderPassIndex_ = renderPassHandle.index;
+  if (state.pass == VK_NULL_HANDLE) {
+    beginRendering(cmdBuffer_, fb, state, false);
+  } else {
+    fb.cmdBeginRenderPass(cmdBuffer_,
+                          state.pass,
+                          state.renderPassIndex,
+                          state.mipLevel,
+                          (uint32_t)state.clearValues.size(),
+                          state.clearValues.data(),
+                          VK_SUBPASS_CONTENTS_INLINE);
+  }
+
+  isEncoding_ = true;
+
+  Result::setOk(outResult);
+}
+
+void RenderCommandEncoder::initializeSecondary(const RenderPassState& state,
+                                               const std::shared_ptr<IFramebuffer>& framebuffer,
+                                               bool reusable) {
+  IGL_PROFILER_FUNCTION();
+  framebuffer_ = framebuffer;
+
+  const auto& fb = static_cast<vulkan::Framebuffer&>(*framebuffer);
+
+  hasDepthAttachment_ = state.hasDepthAttachment;
+  dynamicState_.renderPassIndex_ = state.renderPassIndex;
+  dynamicState_.viewMask_ = state.viewMask;
   dynamicState_.depthBiasEnable_ = false;
 
-  const VkRenderPassBeginInfo bi = fb.getRenderPassBeginInfo(
-      renderPassHandle.pass, mipLevel, (uint32_t)clearValues.size(), clearValues.data());
+  if (state.pass == VK_NULL_HANDLE) {
+#if IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+    std::vector<VkFormat> colorFormats;
+    colorFormats.reserve(state.colorAttachments.size());
+    for (const auto& attachment : state.colorAttachments) {
+      colorFormats.push_back(textureFormatToVkFormat(attachment.texture->getFormat()));
+    }
+    const VulkanImage* depthImage =
+        state.depthAttachment.texture
+            ? &state.depthAttachment.texture->getVulkanTexture().getVulkanImage()
+            : nullptr;
+    VkCommandBufferInheritanceRenderingInfoKHR inheritanceInfo = {};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+    inheritanceInfo.viewMask = state.viewMask;
+    inheritanceInfo.colorAttachmentCount = (uint32_t)colorFormats.size();
+    inheritanceInfo.pColorAttachmentFormats = colorFormats.data();
+    inheritanceInfo.depthAttachmentFormat =
+        depthImage && depthImage->isDepthFormat_ ? depthImage->imageFormat_ : VK_FORMAT_UNDEFINED;
+    inheritanceInfo.stencilAttachmentFormat = depthImage && depthImage->isStencilFormat_
+                                                  ? depthImage->imageFormat_
+                                                  : VK_FORMAT_UNDEFINED;
+    inheritanceInfo.rasterizationSamples =
+        !state.colorAttachments.empty()
+            ? state.colorAttachments[0].texture->getVulkanTexture().getVulkanImage().samples_
+            : (depthImage ? depthImage->samples_ : VK_SAMPLE_COUNT_1_BIT);
+    VK_ASSERT(ivkBeginSecondaryCommandBuffer(
+        cmdBuffer_, VK_NULL_HANDLE, VK_NULL_HANDLE, &inheritanceInfo, reusable));
+#endif // IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+  } else {
+    // reusable buffers can be executed with any framebuffer compatible with the render pass
+    VK_ASSERT(ivkBeginSecondaryCommandBuffer(
+        cmdBuffer_,
+        state.pass,
+        reusable ? VK_NULL_HANDLE
+                 : fb.getVkFramebuffer(state.mipLevel, state.pass, state.renderPassIndex),
+        nullptr,
+        reusable));
+  }
 
+  // secondary command buffers do not inherit any state from the primary command buffer
+  bindDefaultViewportAndScissor(fb, state.mipLevel);
+
+  binder_.bindDefaultDescriptorSets();
+
+  isEncoding_ = true;
+}
+
+void RenderCommandEncoder::bindDefaultViewportAndScissor(const Framebuffer& fb, uint32_t mipLevel) {
   const uint32_t width = std::max(fb.getWidth() >> mipLevel, 1u);
   const uint32_t height = std::max(fb.getHeight() >> mipLevel, 1u);
   const igl::Viewport viewport = {0.0f, 0.0f, (float)width, (float)height, 0.0f, +1.0f};
@@ -262,15 +517,6 @@ void RenderCommandEncoder::initialize(const RenderPassDesc& renderPass,
 
   bindViewport(viewport);
   bindScissorRect(scissor);
-
-  ctx_.checkAndUpdateDescriptorSets();
-  ctx_.bindDefaultDescriptorSets(cmdBuffer_, VK_PIPELINE_BIND_POINT_GRAPHICS);
-
-  vkCmdBeginRenderPass(cmdBuffer_, &bi, VK_SUBPASS_CONTENTS_INLINE);
-
-  isEncoding_ = true;
-
-  Result::setOk(outResult);
 }
 
 std::unique_ptr<RenderCommandEncoder> RenderCommandEncoder::create(
@@ -299,23 +545,211 @@ void RenderCommandEncoder::endEncoding() {
 
   isEncoding_ = false;
 
-  vkCmdEndRenderPass(cmdBuffer_);
+  IGL_ASSERT_MSG(activeOcclusionQuery_ == UINT32_MAX, "endOcclusionQuery() was not called");
+  // render passes end in their last subpass
+  IGL_ASSERT_MSG(subpasses_.empty() || currentSubpass_ + 1 == subpasses_.size(),
+                 "nextSubpass() was not called for all the subpasses");
+  occlusionQueryPool_ = nullptr;
 
+  if (isSecondary_) {
+    VK_ASSERT(ivkEndCommandBuffer(cmdBuffer_));
+    if (parallelEncoder_) {
+      parallelEncoder_->onChildEndEncoding();
+    }
+    return;
+  }
+
+  const bool isDynamicRendering = ctx_.usesDynamicRendering();
+  if (isDynamicRendering) {
+    endRendering(cmdBuffer_);
+  } else {
+    vkCmdEndRenderPass(cmdBuffer_);
+  }
+
+#if defined(IGL_WITH_TRACY_GPU)
+  tracyGpuZone_.reset();
+#endif // IGL_WITH_TRACY_GPU
+
+  // with dynamic rendering, the barriers of beginRendering() have recorded the layouts already
+  if (!isDynamicRendering) {
+    setFinalImageLayouts(*framebuffer_);
+  }
+}
+
+void RenderCommandEncoder::setFinalImageLayouts(const IFramebuffer& framebuffer) {
   // set image layouts after the render pass
-  const FramebufferDesc& desc = static_cast<const Framebuffer&>((*framebuffer_)).getDesc();
+  const FramebufferDesc& desc = static_cast<const Framebuffer&>(framebuffer).getDesc();
 
   for (const auto& attachment : desc.colorAttachments) {
     const vulkan::Texture& tex = static_cast<vulkan::Texture&>(*attachment.second.texture.get());
     // this must match the final layout of the render pass
-    tex.getVulkanTexture().getVulkanImage().imageLayout_ = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    tex.getVulkanTexture().getVulkanImage().setLayout(
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
   }
 
   if (desc.depthAttachment.texture) {
     const vulkan::Texture& tex = static_cast<vulkan::Texture&>(*desc.depthAttachment.texture.get());
     // this must match the final layout of the render pass
-    tex.getVulkanTexture().getVulkanImage().imageLayout_ =
-        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    tex.getVulkanTexture().getVulkanImage().setLayout(
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT);
+  }
+}
+
+void RenderCommandEncoder::beginRendering(VkCommandBuffer cmdBuffer,
+                                          const Framebuffer& fb,
+                                          const RenderPassState& state,
+                                          bool secondaryCommandBuffers) {
+#if IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+  IGL_PROFILER_FUNCTION();
+
+  // multiview renders to all layers, like the image views of stereo framebuffers
+  const uint32_t numLayers = state.viewMask ? VK_REMAINING_ARRAY_LAYERS : 1u;
+
+  std::vector<VkImageMemoryBarrier2KHR> barriers;
+  std::vector<VkRenderingAttachmentInfoKHR> colorAttachments;
+  colorAttachments.reserve(state.colorAttachments.size());
+
+  for (const auto& attachment : state.colorAttachments) {
+    attachment.texture->getVulkanTexture().getVulkanImage().getTransitionBarriers2(
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT,
+                                attachment.texture->getBaseMipLevel() + state.mipLevel,
+                                1,
+                                attachment.texture->getBaseLayer(),
+                                numLayers},
+        attachment.loadOp != VK_ATTACHMENT_LOAD_OP_LOAD,
+        barriers);
+
+    VkRenderingAttachmentInfoKHR info = {};
+    info.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    info.imageView = fb.getVkImageView(*attachment.texture, state.mipLevel);
+    info.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    info.loadOp = attachment.loadOp;
+    info.storeOp = attachment.storeOp;
+    info.clearValue = attachment.clearValue;
+    if (attachment.resolveTexture) {
+      // resolve attachments are overwritten entirely
+      attachment.resolveTexture->getVulkanTexture().getVulkanImage().getTransitionBarriers2(
+          VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+          VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+          VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+          VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT,
+                                  attachment.resolveTexture->getBaseMipLevel(),
+                                  1,
+                                  attachment.resolveTexture->getBaseLayer(),
+                                  numLayers},
+          true,
+          barriers);
+      info.resolveMode = isIntegerFormat(attachment.texture->getFormat())
+                             ? VK_RESOLVE_MODE_SAMPLE_ZERO_BIT_KHR
+                             : VK_RESOLVE_MODE_AVERAGE_BIT_KHR;
+      info.resolveImageView = fb.getVkImageView(*attachment.resolveTexture, 0);
+      info.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    }
+    colorAttachments.push_back(info);
+  }
+
+  VkRenderingAttachmentInfoKHR depthAttachment = {};
+  VkRenderingAttachmentInfoKHR stencilAttachment = {};
+  bool hasDepth = false;
+  bool hasStencil = false;
+
+  if (state.depthAttachment.texture) {
+    const VulkanImage& image = state.depthAttachment.texture->getVulkanTexture().getVulkanImage();
+    hasDepth = image.isDepthFormat_;
+    hasStencil = image.isStencilFormat_;
+    const bool discardContents =
+        (!hasDepth || state.depthAttachment.loadOp != VK_ATTACHMENT_LOAD_OP_LOAD) &&
+        (!hasStencil || state.stencilLoadOp != VK_ATTACHMENT_LOAD_OP_LOAD);
+    image.getTransitionBarriers2(
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        VkImageSubresourceRange{image.getImageAspectFlags(),
+                                state.depthAttachment.texture->getBaseMipLevel(),
+                                1,
+                                state.depthAttachment.texture->getBaseLayer(),
+                                numLayers},
+        discardContents,
+        barriers);
+
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    depthAttachment.imageView = fb.getVkImageView(*state.depthAttachment.texture, 0);
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = state.depthAttachment.loadOp;
+    depthAttachment.storeOp = state.depthAttachment.storeOp;
+    depthAttachment.clearValue = state.depthAttachment.clearValue;
+    if (state.depthAttachment.resolveTexture) {
+      const VulkanImage& resolveImage =
+          state.depthAttachment.resolveTexture->getVulkanTexture().getVulkanImage();
+      // resolve attachments are overwritten entirely
+      resolveImage.getTransitionBarriers2(
+          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+          VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+          VkImageSubresourceRange{resolveImage.getImageAspectFlags(),
+                                  state.depthAttachment.resolveTexture->getBaseMipLevel(),
+                                  1,
+                                  state.depthAttachment.resolveTexture->getBaseLayer(),
+                                  numLayers},
+          true,
+          barriers);
+      depthAttachment.resolveMode = state.depthResolveMode;
+      depthAttachment.resolveImageView =
+          fb.getVkImageView(*state.depthAttachment.resolveTexture, 0);
+      depthAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    }
+    // both aspects are rendered through the same image view
+    stencilAttachment = depthAttachment;
+    stencilAttachment.loadOp = state.stencilLoadOp;
+    stencilAttachment.storeOp = state.stencilStoreOp;
+    // only the depth aspect is resolved
+    stencilAttachment.resolveMode = VK_RESOLVE_MODE_NONE_KHR;
+    stencilAttachment.resolveImageView = VK_NULL_HANDLE;
+  }
+
+  if (!barriers.empty()) {
+    VkDependencyInfoKHR dependencyInfo = {};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    dependencyInfo.imageMemoryBarrierCount = (uint32_t)barriers.size();
+    dependencyInfo.pImageMemoryBarriers = barriers.data();
+    vkCmdPipelineBarrier2KHR(cmdBuffer, &dependencyInfo);
   }
+
+  VkRenderingInfoKHR renderingInfo = {};
+  renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+  renderingInfo.flags =
+      secondaryCommandBuffers ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR : 0;
+  renderingInfo.renderArea = VkRect2D{VkOffset2D{0, 0},
+                                      VkExtent2D{std::max(fb.getWidth() >> state.mipLevel, 1u),
+                                                 std::max(fb.getHeight() >> state.mipLevel, 1u)}};
+  renderingInfo.layerCount = 1;
+  renderingInfo.viewMask = state.viewMask;
+  renderingInfo.colorAttachmentCount = (uint32_t)colorAttachments.size();
+  renderingInfo.pColorAttachments = colorAttachments.data();
+  renderingInfo.pDepthAttachment = hasDepth ? &depthAttachment : nullptr;
+  renderingInfo.pStencilAttachment = hasStencil ? &stencilAttachment : nullptr;
+
+  vkCmdBeginRenderingKHR(cmdBuffer, &renderingInfo);
+#else
+  IGL_ASSERT_NOT_REACHED();
+  (void)cmdBuffer;
+  (void)fb;
+  (void)state;
+  (void)secondaryCommandBuffers;
+#endif // IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+}
+
+void RenderCommandEncoder::endRendering(VkCommandBuffer cmdBuffer) {
+#if IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+  vkCmdEndRenderingKHR(cmdBuffer);
+#else
+  IGL_ASSERT_NOT_REACHED();
+  (void)cmdBuffer;
+#endif // IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
 }
 
 void RenderCommandEncoder::pushDebugGroupLabel(const std::string& label,
@@ -349,7 +783,13 @@ void RenderCommandEncoder::bindViewport(const Viewport& viewport) {
       viewport.minDepth, // float minDepth;
       viewport.maxDepth, // float maxDepth;
   };
+  if (skipCommand(recordedState_.hasViewport &&
+                  std::memcmp(&recordedState_.viewport, &vp, sizeof(vp)) == 0)) {
+    return;
+  }
   vkCmdSetViewport(cmdBuffer_, 0, 1, &vp);
+  recordedState_.hasViewport = true;
+  recordedState_.viewport = vp;
 }
 
 void RenderCommandEncoder::bindScissorRect(const ScissorRect& rect) {
@@ -357,7 +797,13 @@ void RenderCommandEncoder::bindScissorRect(const ScissorRect& rect) {
       VkOffset2D{(int32_t)rect.x, (int32_t)rect.y},
       VkExtent2D{rect.width, rect.height},
   };
+  if (skipCommand(recordedState_.hasScissor &&
+                  std::memcmp(&recordedState_.scissor, &scissor, sizeof(scissor)) == 0)) {
+    return;
+  }
   vkCmdSetScissor(cmdBuffer_, 0, 1, &scissor);
+  recordedState_.hasScissor = true;
+  recordedState_.scissor = scissor;
 }
 
 void RenderCommandEncoder::bindRenderPipelineState(
@@ -366,12 +812,18 @@ void RenderCommandEncoder::bindRenderPipelineState(
     return;
   }
 
-  currentPipeline_ = pipelineState;
+  bindRenderPipelineState(*pipelineState);
 
-  const igl::vulkan::RenderPipelineState* rps =
-      static_cast<igl::vulkan::RenderPipelineState*>(pipelineState.get());
+  currentPipelineOwner_ = pipelineState;
+}
 
-  IGL_ASSERT(rps);
+void RenderCommandEncoder::bindRenderPipelineState(IRenderPipelineState& pipelineState) {
+  const auto* rps = static_cast<const igl::vulkan::RenderPipelineState*>(&pipelineState);
+
+  currentPipeline_ = rps;
+  currentPipelineOwner_ = nullptr;
+
+  binder_.bindImmutableSamplersLayout(rps->getImmutableSamplersLayout());
 
   const RenderPipelineDesc& desc = rps->getRenderPipelineDesc();
 
@@ -382,8 +834,10 @@ void RenderCommandEncoder::bindRenderPipelineState(
     IGL_LOG_ERROR(
         "Make sure your render pass and render pipeline both have matching depth attachments");
   }
+  IGL_ASSERT_MSG(desc.subpassIndex == currentSubpass_,
+                 "The render pipeline is created for another subpass");
 
-  binder_.bindPipeline(VK_NULL_HANDLE);
+  // the VkPipeline is resolved and bound by the next draw call, only if it changed
 }
 
 void RenderCommandEncoder::bindDepthStencilState(
@@ -393,10 +847,16 @@ void RenderCommandEncoder::bindDepthStencilState(
   if (!IGL_VERIFY(depthStencilState != nullptr)) {
     return;
   }
-  const igl::vulkan::DepthStencilState* state =
-      static_cast<igl::vulkan::DepthStencilState*>(depthStencilState.get());
 
-  const igl::DepthStencilStateDesc& desc = state->getDepthStencilStateDesc();
+  bindDepthStencilState(*depthStencilState);
+}
+
+void RenderCommandEncoder::bindDepthStencilState(IDepthStencilState& depthStencilState) {
+  IGL_PROFILER_FUNCTION();
+
+  const auto& state = static_cast<const igl::vulkan::DepthStencilState&>(depthStencilState);
+
+  const igl::DepthStencilStateDesc& desc = state.getDepthStencilStateDesc();
 
   dynamicState_.depthWriteEnable_ = desc.isDepthWriteEnabled;
   dynamicState_.setDepthCompareOp(compareFunctionToVkCompareOp(desc.compareFunction));
@@ -412,9 +872,9 @@ void RenderCommandEncoder::bindDepthStencilState(
                                      stencilOperationToVkStencilOp(desc.depthFailureOperation),
                                      compareFunctionToVkCompareOp(desc.stencilCompareFunction));
     // this is what the IGL/OGL backend does with masks
-    vkCmdSetStencilReference(cmdBuffer_, faceMask, desc.readMask);
-    vkCmdSetStencilCompareMask(cmdBuffer_, faceMask, 0xFF);
-    vkCmdSetStencilWriteMask(cmdBuffer_, faceMask, desc.writeMask);
+    setStencilValue(StencilReference, faceMask, desc.readMask);
+    setStencilValue(StencilCompareMask, faceMask, 0xFF);
+    setStencilValue(StencilWriteMask, faceMask, desc.writeMask);
   };
 
   setStencilState(VK_STENCIL_FACE_FRONT_BIT, desc.frontFaceStencil);
@@ -425,6 +885,17 @@ void RenderCommandEncoder::bindBuffer(int index,
                                       uint8_t target,
                                       const std::shared_ptr<IBuffer>& buffer,
                                       size_t bufferOffset) {
+  if (!IGL_VERIFY(buffer != nullptr)) {
+    return;
+  }
+
+  bindBuffer(index, target, *buffer, bufferOffset);
+}
+
+void RenderCommandEncoder::bindBuffer(int index,
+                                      uint8_t target,
+                                      IBuffer& buffer,
+                                      size_t bufferOffset) {
   IGL_PROFILER_FUNCTION();
 
 #if IGL_VULKAN_PRINT_COMMANDS
@@ -438,11 +909,7 @@ void RenderCommandEncoder::bindBuffer(int index,
                (uint32_t)bufferOffset);
 #endif // IGL_VULKAN_PRINT_COMMANDS
 
-  if (!IGL_VERIFY(buffer != nullptr)) {
-    return;
-  }
-
-  auto* buf = static_cast<igl::vulkan::Buffer*>(buffer.get());
+  auto* buf = static_cast<igl::vulkan::Buffer*>(&buffer);
 
   VkBuffer vkBuf = buf->getVkBuffer();
 
@@ -454,8 +921,17 @@ void RenderCommandEncoder::bindBuffer(int index,
   if (isVertexBuffer) {
     IGL_ASSERT(target == BindTarget::kVertex);
     IGL_ASSERT(!isUniformOrStorageBuffer);
-    const VkDeviceSize offset = bufferOffset;
+    const VkDeviceSize offset = buf->getVkBufferOffset() + bufferOffset;
+    if (!IGL_VERIFY(index >= 0 && index < IGL_VERTEX_BUFFER_MAX)) {
+      return;
+    }
+    if (skipCommand(recordedState_.vertexBuffers[index] == vkBuf &&
+                    recordedState_.vertexBufferOffsets[index] == offset)) {
+      return;
+    }
     vkCmdBindVertexBuffers(cmdBuffer_, index, 1, &vkBuf, &offset);
+    recordedState_.vertexBuffers[index] = vkBuf;
+    recordedState_.vertexBufferOffsets[index] = offset;
   } else if (isUniformOrStorageBuffer) {
     if (!IGL_VERIFY(target == BindTarget::kAllGraphics)) {
       IGL_ASSERT_MSG(false, "Buffer target should be BindTarget::kAllGraphics");
@@ -476,11 +952,24 @@ void RenderCommandEncoder::bindBuffer(int index,
   }
 }
 
-void RenderCommandEncoder::bindBytes(size_t /*index*/,
-                                     uint8_t /*target*/,
-                                     const void* /*data*/,
-                                     size_t /*length*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+void RenderCommandEncoder::bindBytes(size_t index,
+                                     uint8_t target,
+                                     const void* data,
+                                     size_t length) {
+  IGL_PROFILER_FUNCTION();
+
+  // the data is bound as a uniform buffer, which is visible to all graphics stages
+  IGL_ASSERT_MSG((target & BindTarget::kAllGraphics) != 0, "Bind target is not valid: %d", target);
+
+  if (!IGL_VERIFY(data != nullptr)) {
+    return;
+  }
+
+  if (!binder_.bindUniformBytes((uint32_t)index, data, length)) {
+    IGL_ASSERT_MSG(false,
+                   "bindBytes() is limited to DeviceFeatureLimits::MaxBindBytesBytes: %u",
+                   (uint32_t)length);
+  }
 }
 
 void RenderCommandEncoder::bindPushConstants(const void* data, size_t length, size_t offset) {
@@ -496,6 +985,22 @@ void RenderCommandEncoder::bindPushConstants(const void* data, size_t length, si
         "Push constants size exceeded %u (max %u bytes)", size, limits.maxPushConstantsSize);
   }
 
+  // only ranges inside the first RecordedState::kMaxPushConstantsBytes bytes are tracked
+  const bool isTracked =
+      size <= RecordedState::kMaxPushConstantsBytes && offset % 4 == 0 && length % 4 == 0;
+  if (isTracked) {
+    // the 4-byte words of [offset, offset + length)
+    const uint64_t words = length / 4 == 64 ? UINT64_MAX
+                                            : ((uint64_t(1) << (length / 4)) - 1) << (offset / 4);
+    uint8_t* recorded = recordedState_.pushConstants.data() + offset;
+    if (skipCommand((recordedState_.pushConstantsMask & words) == words &&
+                    std::memcmp(recorded, data, length) == 0)) {
+      return;
+    }
+    std::memcpy(recorded, data, length);
+    recordedState_.pushConstantsMask |= words;
+  }
+
   vkCmdPushConstants(cmdBuffer_,
                      ctx_.pipelineLayoutGraphics_->getVkPipelineLayout(),
                      VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
@@ -504,6 +1009,20 @@ void RenderCommandEncoder::bindPushConstants(const void* data, size_t length, si
                      data);
 }
 
+void RenderCommandEncoder::bindBufferAddress(size_t offset,
+                                             IBuffer& buffer,
+                                             size_t bufferOffset) {
+  IGL_PROFILER_FUNCTION();
+
+  IGL_ASSERT_MSG(ctx_.config_.enableBufferDeviceAddress,
+                 "Make sure config.enableBufferDeviceAddress is enabled");
+  IGL_ASSERT_MSG((offset & 7) == 0, "Buffer addresses must be 8 bytes aligned in push constants");
+
+  // the buffer is not bound to any descriptor set: shaders dereference its address directly
+  const uint64_t address = buffer.gpuAddress(bufferOffset);
+  bindPushConstants(&address, sizeof(address), offset);
+}
+
 void RenderCommandEncoder::bindSamplerState(size_t index,
                                             uint8_t target,
                                             ISamplerState* samplerState) {
@@ -538,74 +1057,232 @@ void RenderCommandEncoder::bindTexture(size_t index, uint8_t target, ITexture* t
   binder_.bindTexture(index, static_cast<igl::vulkan::Texture*>(texture));
 }
 
+void RenderCommandEncoder::bindBindGroup(const IBindGroup& bindGroup) {
+  IGL_PROFILER_FUNCTION();
+
+  const auto& group = static_cast<const vulkan::BindGroup&>(bindGroup);
+  if (group.getTexturesDescriptorSet() == VK_NULL_HANDLE) {
+    IRenderCommandEncoder::bindBindGroup(bindGroup);
+    return;
+  }
+
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("%p  bindBindGroup()\n", cmdBuffer_);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+
+  binder_.bindTexturesDescriptorSet(group.getTexturesDescriptorSet(), group.getBindingsTextures());
+
+  const BindGroupDesc& desc = bindGroup.getDesc();
+  const uint32_t bufferMask = bindGroup.getBufferMask();
+  for (uint32_t i = 0; i != IGL_UNIFORM_BLOCKS_BINDING_MAX; i++) {
+    if ((bufferMask & (1u << i)) != 0) {
+      bindBuffer(static_cast<int>(i), desc.target, *desc.buffers[i], desc.bufferOffsets[i]);
+    }
+  }
+}
+
 void RenderCommandEncoder::bindUniform(const UniformDesc& /*uniformDesc*/, const void* /*data*/) {
   // DO NOT IMPLEMENT!
   // This is only for backends that MUST use single uniforms in some situations.
   IGL_ASSERT_NOT_IMPLEMENTED();
 }
 
-void RenderCommandEncoder::bindPipeline() {
-  const igl::vulkan::RenderPipelineState* rps =
-      static_cast<igl::vulkan::RenderPipelineState*>(currentPipeline_.get());
+void RenderCommandEncoder::updateBindings() {
+  // descriptor sets the pipeline does not read are left alone
+  binder_.updateBindings(currentPipeline_ ? currentPipeline_->getDescriptorSetMask()
+                                          : kAllDescriptorSets);
+}
+
+bool RenderCommandEncoder::bindPipeline() {
+  const igl::vulkan::RenderPipelineState* rps = currentPipeline_;
 
   if (!IGL_VERIFY(rps)) {
+    return false;
+  }
+
+  VkPipeline pipeline = rps->getVkPipeline(dynamicState_);
+
+  if (pipeline == VK_NULL_HANDLE) {
+    return false;
+  }
+
+  binder_.bindPipeline(pipeline);
+
+  if (ctx_.usesExtendedDynamicState()) {
+    setExtendedDynamicState();
+  }
+
+  return true;
+}
+
+void RenderCommandEncoder::setExtendedDynamicState() {
+#if defined(VK_EXT_extended_dynamic_state)
+  const RenderPipelineDynamicState& state = dynamicState_;
+  const RenderPipelineDynamicState& last = lastExtendedDynamicState_;
+  const bool setAll = !hasExtendedDynamicState_;
+
+  if (setAll || state.getTopology() != last.getTopology()) {
+    vkCmdSetPrimitiveTopologyEXT(cmdBuffer_, state.getTopology());
+  }
+  if (setAll || state.getDepthCompareOp() != last.getDepthCompareOp()) {
+    // the same as VulkanPipelineBuilder::depthCompareOp()
+    const bool depthTestEnable = state.getDepthCompareOp() != VK_COMPARE_OP_ALWAYS;
+    vkCmdSetDepthTestEnableEXT(cmdBuffer_, depthTestEnable ? VK_TRUE : VK_FALSE);
+    vkCmdSetDepthCompareOpEXT(cmdBuffer_, state.getDepthCompareOp());
+  }
+  if (setAll || state.depthWriteEnable_ != last.depthWriteEnable_) {
+    vkCmdSetDepthWriteEnableEXT(cmdBuffer_, state.depthWriteEnable_ ? VK_TRUE : VK_FALSE);
+  }
+  for (const bool front : {true, false}) {
+    if (setAll || state.getStencilStateFailOp(front) != last.getStencilStateFailOp(front) ||
+        state.getStencilStatePassOp(front) != last.getStencilStatePassOp(front) ||
+        state.getStencilStateDepthFailOp(front) != last.getStencilStateDepthFailOp(front) ||
+        state.getStencilStateCompareOp(front) != last.getStencilStateCompareOp(front)) {
+      vkCmdSetStencilOpEXT(cmdBuffer_,
+                           front ? VK_STENCIL_FACE_FRONT_BIT : VK_STENCIL_FACE_BACK_BIT,
+                           state.getStencilStateFailOp(front),
+                           state.getStencilStatePassOp(front),
+                           state.getStencilStateDepthFailOp(front),
+                           state.getStencilStateCompareOp(front));
+    }
+  }
+#if defined(VK_EXT_extended_dynamic_state2)
+  if (ctx_.usesExtendedDynamicState2() &&
+      (setAll || state.depthBiasEnable_ != last.depthBiasEnable_)) {
+    vkCmdSetDepthBiasEnableEXT(cmdBuffer_, state.depthBiasEnable_ ? VK_TRUE : VK_FALSE);
+  }
+#endif // VK_EXT_extended_dynamic_state2
+
+  lastExtendedDynamicState_ = state;
+  hasExtendedDynamicState_ = true;
+#endif // VK_EXT_extended_dynamic_state
+}
+
+bool RenderCommandEncoder::skipCommand(bool isRedundant) const {
+  if (isRedundant) {
+    ctx_.getFrameStatisticsTracker().add(FrameStatisticsTracker::SkippedCommands);
+  }
+  return isRedundant;
+}
+
+void RenderCommandEncoder::bindIndexBuffer(VkBuffer buffer,
+                                           VkDeviceSize offset,
+                                           VkIndexType type) {
+  if (skipCommand(recordedState_.indexBuffer == buffer &&
+                  recordedState_.indexBufferOffset == offset && recordedState_.indexType == type)) {
     return;
   }
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("%p vkCmdBindIndexBuffer(%u)\n", cmdBuffer_, (uint32_t)offset);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+  vkCmdBindIndexBuffer(cmdBuffer_, buffer, offset, type);
+  recordedState_.indexBuffer = buffer;
+  recordedState_.indexBufferOffset = offset;
+  recordedState_.indexType = type;
+}
 
-  binder_.bindPipeline(rps->getVkPipeline(dynamicState_));
+void RenderCommandEncoder::setStencilValue(StencilValue value,
+                                           VkStencilFaceFlagBits face,
+                                           uint32_t data) {
+  IGL_ASSERT(face == VK_STENCIL_FACE_FRONT_BIT || face == VK_STENCIL_FACE_BACK_BIT);
+  uint64_t& recorded = recordedState_.stencilValues[value][face == VK_STENCIL_FACE_BACK_BIT];
+  if (skipCommand(recorded == data)) {
+    return;
+  }
+  switch (value) {
+  case StencilReference:
+    vkCmdSetStencilReference(cmdBuffer_, face, data);
+    break;
+  case StencilCompareMask:
+    vkCmdSetStencilCompareMask(cmdBuffer_, face, data);
+    break;
+  case StencilWriteMask:
+    vkCmdSetStencilWriteMask(cmdBuffer_, face, data);
+    break;
+  case NumStencilValues:
+    IGL_ASSERT_NOT_REACHED();
+    return;
+  }
+  recorded = data;
 }
 
 void RenderCommandEncoder::draw(PrimitiveType primitiveType,
                                 size_t vertexStart,
-                                size_t vertexCount) {
+                                size_t vertexCount,
+                                uint32_t instanceCount,
+                                uint32_t baseInstance) {
   IGL_PROFILER_FUNCTION();
 
   ctx_.drawCallCount_ += drawCallCountEnabled_;
 
-  if (vertexCount == 0) {
+  if (vertexCount == 0 || instanceCount == 0) {
     return;
   }
 
-  binder_.updateBindings();
+  updateBindings();
   dynamicState_.setTopology(primitiveTypeToVkPrimitiveTopology(primitiveType));
-  bindPipeline();
+  if (!bindPipeline()) {
+    return;
+  }
 
 #if IGL_VULKAN_PRINT_COMMANDS
-  IGL_LOG_INFO("%p vkCmdDraw(%u, %u)\n", cmdBuffer_, (uint32_t)vertexCount, (uint32_t)vertexStart);
+  IGL_LOG_INFO("%p vkCmdDraw(%u, %u, %u, %u)\n",
+               cmdBuffer_,
+               (uint32_t)vertexCount,
+               instanceCount,
+               (uint32_t)vertexStart,
+               baseInstance);
 #endif // IGL_VULKAN_PRINT_COMMANDS
 
-  vkCmdDraw(cmdBuffer_, (uint32_t)vertexCount, 1, (uint32_t)vertexStart, 0);
+  vkCmdDraw(cmdBuffer_, (uint32_t)vertexCount, instanceCount, (uint32_t)vertexStart, baseInstance);
 }
 
 void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
                                        size_t indexCount,
                                        IndexFormat indexFormat,
                                        IBuffer& indexBuffer,
-                                       size_t indexBufferOffset) {
+                                       size_t indexBufferOffset,
+                                       uint32_t instanceCount,
+                                       int32_t baseVertex,
+                                       uint32_t baseInstance) {
   IGL_PROFILER_FUNCTION();
 
   ctx_.drawCallCount_ += drawCallCountEnabled_;
 
-  if (indexCount == 0) {
+  if (indexCount == 0 || instanceCount == 0) {
     return;
   }
 
-  binder_.updateBindings();
+  updateBindings();
   dynamicState_.setTopology(primitiveTypeToVkPrimitiveTopology(primitiveType));
-  bindPipeline();
+  if (!bindPipeline()) {
+    return;
+  }
 
   const igl::vulkan::Buffer* buf = static_cast<igl::vulkan::Buffer*>(&indexBuffer);
 
   const VkIndexType type = indexFormatToVkIndexType(indexFormat);
-#if IGL_VULKAN_PRINT_COMMANDS
-  IGL_LOG_INFO("%p vkCmdBindIndexBuffer(%u)\n", cmdBuffer_, (uint32_t)indexBufferOffset);
-#endif // IGL_VULKAN_PRINT_COMMANDS
-  vkCmdBindIndexBuffer(cmdBuffer_, buf->getVkBuffer(), indexBufferOffset, type);
+  const size_t indexSize = indexFormat == IndexFormat::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+
+  IGL_ASSERT_MSG(indexBufferOffset % indexSize == 0,
+                 "The index buffer offset has to be a multiple of the index size");
+
+  // the offset becomes the first index, so draws from different ranges of one index buffer do not
+  // have to bind it again
+  const uint32_t firstIndex = (uint32_t)(indexBufferOffset / indexSize);
+  bindIndexBuffer(buf->getVkBuffer(), buf->getVkBufferOffset(), type);
 
 #if IGL_VULKAN_PRINT_COMMANDS
-  IGL_LOG_INFO("%p vkCmdDrawIndexed(%u)\n", cmdBuffer_, (uint32_t)indexCount);
+  IGL_LOG_INFO("%p vkCmdDrawIndexed(%u, %u, %u, %i, %u)\n",
+               cmdBuffer_,
+               (uint32_t)indexCount,
+               instanceCount,
+               firstIndex,
+               baseVertex,
+               baseInstance);
 #endif // IGL_VULKAN_PRINT_COMMANDS
-  vkCmdDrawIndexed(cmdBuffer_, (uint32_t)indexCount, 1, 0, 0, 0);
+  vkCmdDrawIndexed(
+      cmdBuffer_, (uint32_t)indexCount, instanceCount, firstIndex, baseVertex, baseInstance);
 }
 
 void RenderCommandEncoder::drawIndexedIndirect(PrimitiveType primitiveType,
@@ -626,9 +1303,11 @@ void RenderCommandEncoder::multiDrawIndirect(PrimitiveType primitiveType,
                                              uint32_t stride) {
   IGL_PROFILER_FUNCTION();
 
-  binder_.updateBindings();
+  updateBindings();
   dynamicState_.setTopology(primitiveTypeToVkPrimitiveTopology(primitiveType));
-  bindPipeline();
+  if (!bindPipeline()) {
+    return;
+  }
 
   ctx_.drawCallCount_ += drawCallCountEnabled_;
 
@@ -636,7 +1315,7 @@ void RenderCommandEncoder::multiDrawIndirect(PrimitiveType primitiveType,
 
   vkCmdDrawIndirect(cmdBuffer_,
                     bufIndirect->getVkBuffer(),
-                    indirectBufferOffset,
+                    bufIndirect->getVkBufferOffset() + indirectBufferOffset,
                     drawCount,
                     stride ? stride : sizeof(VkDrawIndirectCommand));
 }
@@ -650,9 +1329,11 @@ void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType primitiveType,
                                                     uint32_t stride) {
   IGL_PROFILER_FUNCTION();
 
-  binder_.updateBindings();
+  updateBindings();
   dynamicState_.setTopology(primitiveTypeToVkPrimitiveTopology(primitiveType));
-  bindPipeline();
+  if (!bindPipeline()) {
+    return;
+  }
 
   ctx_.drawCallCount_ += drawCallCountEnabled_;
 
@@ -660,11 +1341,11 @@ void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType primitiveType,
   const igl::vulkan::Buffer* bufIndirect = static_cast<igl::vulkan::Buffer*>(&indirectBuffer);
 
   const VkIndexType type = indexFormatToVkIndexType(indexFormat);
-  vkCmdBindIndexBuffer(cmdBuffer_, bufIndex->getVkBuffer(), 0, type);
+  bindIndexBuffer(bufIndex->getVkBuffer(), bufIndex->getVkBufferOffset(), type);
 
   vkCmdDrawIndexedIndirect(cmdBuffer_,
                            bufIndirect->getVkBuffer(),
-                           indirectBufferOffset,
+                           bufIndirect->getVkBufferOffset() + indirectBufferOffset,
                            drawCount,
                            stride ? stride : sizeof(VkDrawIndexedIndirectCommand));
 }
@@ -674,17 +1355,77 @@ void RenderCommandEncoder::setStencilReferenceValue(uint32_t value) {
 }
 
 void RenderCommandEncoder::setStencilReferenceValues(uint32_t frontValue, uint32_t backValue) {
-  vkCmdSetStencilReference(cmdBuffer_, VK_STENCIL_FACE_FRONT_BIT, frontValue);
-  vkCmdSetStencilReference(cmdBuffer_, VK_STENCIL_FACE_BACK_BIT, backValue);
+  setStencilValue(StencilReference, VK_STENCIL_FACE_FRONT_BIT, frontValue);
+  setStencilValue(StencilReference, VK_STENCIL_FACE_BACK_BIT, backValue);
 }
 
 void RenderCommandEncoder::setBlendColor(Color color) {
-  vkCmdSetBlendConstants(cmdBuffer_, color.toFloatPtr());
+  const std::array<float, 4> blendColor = {color.r, color.g, color.b, color.a};
+  if (skipCommand(recordedState_.hasBlendColor && recordedState_.blendColor == blendColor)) {
+    return;
+  }
+  vkCmdSetBlendConstants(cmdBuffer_, blendColor.data());
+  recordedState_.hasBlendColor = true;
+  recordedState_.blendColor = blendColor;
 }
 
 void RenderCommandEncoder::setDepthBias(float depthBias, float slopeScale, float clamp) {
   dynamicState_.depthBiasEnable_ = true;
+  const std::array<float, 3> bias = {depthBias, slopeScale, clamp};
+  if (skipCommand(recordedState_.hasDepthBias && recordedState_.depthBias == bias)) {
+    return;
+  }
   vkCmdSetDepthBias(cmdBuffer_, depthBias, clamp, slopeScale);
+  recordedState_.hasDepthBias = true;
+  recordedState_.depthBias = bias;
+}
+
+void RenderCommandEncoder::beginOcclusionQuery(uint32_t queryIndex) {
+  // Secondary command buffers would need inherited queries, which are not enabled on the device
+  IGL_ASSERT_MSG(!isSecondary_, "Occlusion queries are not supported in parallel encoders");
+  if (!IGL_VERIFY(occlusionQueryPool_) || !IGL_VERIFY(activeOcclusionQuery_ == UINT32_MAX) ||
+      !IGL_VERIFY(queryIndex < occlusionQueryPool_->getCount())) {
+    return;
+  }
+  const auto& pool = static_cast<const OcclusionQueryPool&>(*occlusionQueryPool_);
+  vkCmdBeginQuery(cmdBuffer_, pool.getVkQueryPool(), queryIndex, 0);
+  activeOcclusionQuery_ = queryIndex;
+}
+
+void RenderCommandEncoder::endOcclusionQuery() {
+  if (!IGL_VERIFY(activeOcclusionQuery_ != UINT32_MAX)) {
+    return;
+  }
+  const auto& pool = static_cast<const OcclusionQueryPool&>(*occlusionQueryPool_);
+  vkCmdEndQuery(cmdBuffer_, pool.getVkQueryPool(), activeOcclusionQuery_);
+  activeOcclusionQuery_ = UINT32_MAX;
+}
+
+void RenderCommandEncoder::nextSubpass() {
+  IGL_PROFILER_FUNCTION();
+
+  // secondary command buffers are recorded within one subpass
+  if (!IGL_VERIFY(!isSecondary_) || !IGL_VERIFY(currentSubpass_ + 1 < subpasses_.size())) {
+    return;
+  }
+
+  vkCmdNextSubpass(cmdBuffer_, VK_SUBPASS_CONTENTS_INLINE);
+  currentSubpass_++;
+
+  // the pipeline of the previous subpass cannot be used anymore
+  currentPipeline_ = nullptr;
+  currentPipelineOwner_ = nullptr;
+  binder_.bindPipeline(VK_NULL_HANDLE);
+
+  const auto& fb = static_cast<const Framebuffer&>(*framebuffer_);
+  const RenderPassDesc::SubpassDesc& subpass = subpasses_[currentSubpass_];
+  std::array<VkImageView, IGL_COLOR_ATTACHMENTS_MAX> views = {};
+  uint32_t numViews = 0;
+  for (const uint8_t index : subpass.inputAttachments) {
+    const auto& texture = static_cast<const Texture&>(*fb.getColorAttachment(index));
+    views[numViews++] = fb.getVkImageView(texture, mipLevel_);
+  }
+  binder_.bindInputAttachments(numViews, views.data());
 }
 
 bool RenderCommandEncoder::setDrawCallCountEnabled(bool value) {
@@ -11,7 +11,9 @@
 #include <igl/CommandEncoder.h>
 #include <igl/Common.h>
 #include <igl/Framebuffer.h>
+#include <igl/ObjectPool.h>
 #include <igl/RenderCommandEncoder.h>
+#include <igl/RenderPass.h>
 #include <igl/vulkan/CommandBuffer.h>
 #include <igl/vulkan/RenderPipelineState.h>
 #include <igl/vulkan/ResourcesBinder.h>
@@ -20,7 +22,12 @@
 namespace igl {
 namespace vulkan {
 
-class RenderCommandEncoder : public IRenderCommandEncoder {
+class Framebuffer;
+class ParallelRenderCommandEncoder;
+class RenderBundle;
+class Texture;
+
+class RenderCommandEncoder : public IRenderCommandEncoder, public Pooled<RenderCommandEncoder> {
  public:
   static std::unique_ptr<RenderCommandEncoder> create(
       const std::shared_ptr<CommandBuffer>& commandBuffer,
@@ -45,24 +52,37 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
 
   void bindRenderPipelineState(const std::shared_ptr<IRenderPipelineState>& pipelineState) override;
   void bindDepthStencilState(const std::shared_ptr<IDepthStencilState>& depthStencilState) override;
+  void bindRenderPipelineState(IRenderPipelineState& pipelineState) override;
+  void bindDepthStencilState(IDepthStencilState& depthStencilState) override;
 
   void bindBuffer(int index,
                   uint8_t target,
                   const std::shared_ptr<IBuffer>& buffer,
                   size_t bufferOffset) override;
+  void bindBuffer(int index, uint8_t target, IBuffer& buffer, size_t bufferOffset) override;
   void bindBytes(size_t index, uint8_t target, const void* data, size_t length) override;
   void bindPushConstants(const void* data, size_t length, size_t offset) override;
+  void bindBufferAddress(size_t offset, IBuffer& buffer, size_t bufferOffset) override;
   void bindSamplerState(size_t index, uint8_t target, ISamplerState* samplerState) override;
 
   void bindTexture(size_t index, uint8_t target, ITexture* texture) override;
+  // binds the persistent texture descriptor set of vulkan::BindGroup and then its buffers
+  void bindBindGroup(const IBindGroup& bindGroup) override;
   void bindUniform(const UniformDesc& uniformDesc, const void* data) override;
 
-  void draw(PrimitiveType primitiveType, size_t vertexStart, size_t vertexCount) override;
+  void draw(PrimitiveType primitiveType,
+            size_t vertexStart,
+            size_t vertexCount,
+            uint32_t instanceCount = 1,
+            uint32_t baseInstance = 0) override;
   void drawIndexed(PrimitiveType primitiveType,
                    size_t indexCount,
                    IndexFormat indexFormat,
                    IBuffer& indexBuffer,
-                   size_t indexBufferOffset) override;
+                   size_t indexBufferOffset,
+                   uint32_t instanceCount = 1,
+                   int32_t baseVertex = 0,
+                   uint32_t baseInstance = 0) override;
   void drawIndexedIndirect(PrimitiveType primitiveType,
                            IndexFormat indexFormat,
                            IBuffer& indexBuffer,
@@ -86,6 +106,11 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
   void setBlendColor(Color color) override;
   void setDepthBias(float depthBias, float slopeScale, float clamp) override;
 
+  void beginOcclusionQuery(uint32_t queryIndex) override;
+  void endOcclusionQuery() override;
+
+  void nextSubpass() override;
+
   VkCommandBuffer getVkCommandBuffer() const {
     return cmdBuffer_;
   }
@@ -97,7 +122,71 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
   bool setDrawCallCountEnabled(bool value);
 
  private:
-  void bindPipeline();
+  friend class ParallelRenderCommandEncoder;
+  friend class RenderBundle;
+
+  // everything needed to begin (or continue) a render pass on a framebuffer
+  struct RenderPassState {
+    VkRenderPass pass = VK_NULL_HANDLE;
+    uint16_t renderPassIndex = 0;
+    uint32_t mipLevel = 0;
+    std::vector<VkClearValue> clearValues;
+    bool hasDepthAttachment = false;
+
+    // dynamic rendering (VulkanContext::usesDynamicRendering()): `pass` is VK_NULL_HANDLE and the
+    // attachments below are rendered to without VkRenderPass and VkFramebuffer objects
+    struct Attachment {
+      const Texture* texture = nullptr;
+      const Texture* resolveTexture = nullptr;
+      VkAttachmentLoadOp loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+      VkAttachmentStoreOp storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+      VkClearValue clearValue = {};
+    };
+    std::vector<Attachment> colorAttachments;
+    Attachment depthAttachment;
+    VkAttachmentLoadOp stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    VkAttachmentStoreOp stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    // VkResolveModeFlagBits of `depthAttachment.resolveTexture`
+    VkFlags depthResolveMode = 0;
+    uint32_t viewMask = 0;
+  };
+
+  static Result prepareRenderPass(const VulkanContext& ctx,
+                                  const RenderPassDesc& renderPass,
+                                  const std::shared_ptr<IFramebuffer>& framebuffer,
+                                  RenderPassState& outState);
+  // updates the tracked image layouts after the render pass has ended
+  static void setFinalImageLayouts(const IFramebuffer& framebuffer);
+  // dynamic rendering: transitions the attachments of `state` with one vkCmdPipelineBarrier2KHR()
+  // and begins rendering to them; the draws are recorded into secondary command buffers if
+  // `secondaryCommandBuffers` is true
+  static void beginRendering(VkCommandBuffer cmdBuffer,
+                             const Framebuffer& fb,
+                             const RenderPassState& state,
+                             bool secondaryCommandBuffers);
+  static void endRendering(VkCommandBuffer cmdBuffer);
+
+  void bindDefaultViewportAndScissor(const Framebuffer& fb, uint32_t mipLevel);
+
+  // updates the descriptor sets read by the current pipeline
+  void updateBindings();
+  // returns false if the pipeline is not ready yet (asynchronous compilation) and the draw call
+  // should be skipped
+  bool bindPipeline();
+  // VK_EXT_extended_dynamic_state: records the states of `dynamicState_` which are not baked into
+  // pipelines and changed since the last draw
+  void setExtendedDynamicState();
+  // returns `isRedundant`; the skipped commands are counted in the frame statistics
+  bool skipCommand(bool isRedundant) const;
+  void bindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType type);
+  // `face` is either VK_STENCIL_FACE_FRONT_BIT or VK_STENCIL_FACE_BACK_BIT
+  enum StencilValue : uint8_t {
+    StencilReference,
+    StencilCompareMask,
+    StencilWriteMask,
+    NumStencilValues,
+  };
+  void setStencilValue(StencilValue value, VkStencilFaceFlagBits face, uint32_t data);
 
  private:
   const VulkanContext& ctx_;
@@ -108,21 +197,85 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
 
   igl::vulkan::ResourcesBinder binder_;
 
-  std::shared_ptr<igl::IRenderPipelineState> currentPipeline_ = nullptr;
+  const igl::vulkan::RenderPipelineState* currentPipeline_ = nullptr;
+  // only set when the pipeline was bound by a shared_ptr, which keeps it alive until replaced
+  std::shared_ptr<igl::IRenderPipelineState> currentPipelineOwner_;
   RenderPipelineDynamicState dynamicState_;
+  // the extended dynamic state recorded last; the command buffer state is undefined before that
+  RenderPipelineDynamicState lastExtendedDynamicState_;
+  bool hasExtendedDynamicState_ = false;
+
+  // the other states recorded into `cmdBuffer_`, so that commands which set the same state again
+  // are skipped. All pipelines have these states dynamic, so binding pipelines does not reset them
+  struct RecordedState {
+    static constexpr size_t kMaxPushConstantsBytes = 256;
+    static constexpr uint64_t kNotRecorded = UINT64_MAX;
+
+    bool hasViewport = false;
+    VkViewport viewport = {};
+    bool hasScissor = false;
+    VkRect2D scissor = {};
+    std::array<VkBuffer, IGL_VERTEX_BUFFER_MAX> vertexBuffers = {};
+    std::array<VkDeviceSize, IGL_VERTEX_BUFFER_MAX> vertexBufferOffsets = {};
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+    VkDeviceSize indexBufferOffset = 0;
+    VkIndexType indexType = VK_INDEX_TYPE_MAX_ENUM;
+    // bit `i` is set if the 4 bytes at `4 * i` of `pushConstants` are recorded
+    uint64_t pushConstantsMask = 0;
+    std::array<uint8_t, kMaxPushConstantsBytes> pushConstants = {};
+    // [StencilValue][0 - front, 1 - back]
+    std::array<std::array<uint64_t, 2>, NumStencilValues> stencilValues = {{
+        {kNotRecorded, kNotRecorded},
+        {kNotRecorded, kNotRecorded},
+        {kNotRecorded, kNotRecorded},
+    }};
+    bool hasBlendColor = false;
+    std::array<float, 4> blendColor = {};
+    bool hasDepthBias = false;
+    std::array<float, 3> depthBias = {};
+  };
+  RecordedState recordedState_;
 
   /* Used to increment the draw call count. Should either be 0 or 1
    *  0: When draw call count is disabled during auxiliary draw calls (shader debugging)
    *  1: All other times */
   uint32_t drawCallCountEnabled_ = 1u;
 
+  // true if this encoder records a secondary command buffer, for a parallel encoder or a bundle
+  bool isSecondary_ = false;
+  // non-null if this encoder records a secondary command buffer for a parallel encoder
+  ParallelRenderCommandEncoder* parallelEncoder_ = nullptr;
+
+  std::shared_ptr<IOcclusionQueryPool> occlusionQueryPool_;
+  // index of the running occlusion query, or UINT32_MAX
+  uint32_t activeOcclusionQuery_ = UINT32_MAX;
+
+  // RenderPassDesc::subpasses; empty for a single subpass
+  std::vector<RenderPassDesc::SubpassDesc> subpasses_;
+  uint32_t currentSubpass_ = 0;
+  uint32_t mipLevel_ = 0;
+
+#if defined(IGL_WITH_TRACY_GPU)
+  std::unique_ptr<tracy::VkCtxScope> tracyGpuZone_; // the render pass
+#endif // IGL_WITH_TRACY_GPU
+
  private:
   RenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
                        const VulkanContext& ctx);
+  RenderCommandEncoder(const std::shared_ptr<CommandBuffer>& commandBuffer,
+                       const VulkanContext& ctx,
+                       VkCommandBuffer secondaryCmdBuffer,
+                       VulkanTransientDescriptorSets& dsets,
+                       ParallelRenderCommandEncoder* parallelEncoder);
 
   void initialize(const RenderPassDesc& renderPass,
                   const std::shared_ptr<IFramebuffer>& framebuffer,
                   Result* outResult);
+  // begins a secondary command buffer inside the render pass described by `state`; a `reusable`
+  // buffer is recorded once for a render bundle and executed with any compatible framebuffer
+  void initializeSecondary(const RenderPassState& state,
+                           const std::shared_ptr<IFramebuffer>& framebuffer,
+                           bool reusable = false);
 };
 
 } // namespace vulkan
@@ -5,14 +5,21 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <chrono>
+
+#include <igl/WorkerPool.h>
 #include <igl/vulkan/Device.h>
 #include <igl/vulkan/RenderPipelineState.h>
+#include <igl/vulkan/SamplerState.h>
 #include <igl/vulkan/ShaderModule.h>
 #include <igl/vulkan/VertexInputState.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDescriptorSetLayout.h>
 #include <igl/vulkan/VulkanDevice.h>
+#include <igl/vulkan/VulkanImage.h>
 #include <igl/vulkan/VulkanPipelineBuilder.h>
 #include <igl/vulkan/VulkanPipelineLayout.h>
+#include <igl/vulkan/VulkanSampler.h>
 
 namespace {
 
@@ -27,6 +34,23 @@ VkPolygonMode polygonFillModeToVkPolygonMode(igl::PolygonFillMode mode) {
   return VK_POLYGON_MODE_FILL;
 }
 
+// a pipeline with a dynamic primitive topology draws only topologies of its topology class
+VkPrimitiveTopology getPrimitiveTopologyClass(VkPrimitiveTopology topology) {
+  switch (topology) {
+  case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+    return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+  case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+  case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+  case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+  case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+    return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+  case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+    return VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
+  default:
+    return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+  }
+}
+
 VkCullModeFlags cullModeToVkCullMode(igl::CullMode mode) {
   switch (mode) {
   case igl::CullMode::Disabled:
@@ -221,6 +245,32 @@ RenderPipelineState::RenderPipelineState(const igl::vulkan::Device& device,
   device_(device),
   desc_(std::move(desc)),
   reflection_(std::make_shared<RenderPipelineReflection>()) {
+  if (desc_.shaderStages) {
+    const auto& stages = *desc_.shaderStages;
+    descriptorSetMask_ = ShaderModule::getDescriptorSetMask(stages.getVertexModule()) |
+                         ShaderModule::getDescriptorSetMask(stages.getFragmentModule());
+  }
+
+  if (!desc_.immutableSamplers.empty()) {
+    const VulkanContext& ctx = device_.getVulkanContext();
+    immutableSamplersLayout_ = std::make_unique<ImmutableSamplersLayout>();
+    std::array<VkSampler, IGL_TEXTURE_SAMPLERS_MAX> vkSamplers = {};
+    for (const auto& [unit, samplerState] : desc_.immutableSamplers) {
+      // validated by Device::createRenderPipeline()
+      VulkanSampler* sampler = static_cast<SamplerState*>(samplerState.get())->sampler_.get();
+      immutableSamplersLayout_->samplers[unit] = sampler;
+      vkSamplers[unit] = sampler->getVkSampler();
+    }
+    const char* name = desc_.debugName.toConstChar();
+    immutableSamplersLayout_->dslTextures = ctx.createTexturesDescriptorSetLayout(
+        vkSamplers.data(),
+        IGL_FORMAT("Descriptor Set Layout: {} (immutable samplers)", name).c_str());
+    immutableSamplersLayout_->pipelineLayout = ctx.createPipelineLayout(
+        immutableSamplersLayout_->dslTextures->getVkDescriptorSetLayout(),
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        IGL_FORMAT("Pipeline Layout: {} (immutable samplers)", name).c_str());
+  }
+
   // Iterate and cache vertex input bindings and attributes
   const igl::vulkan::VertexInputState* vstate =
       static_cast<igl::vulkan::VertexInputState*>(desc_.vertexInputState.get());
@@ -262,30 +312,303 @@ RenderPipelineState::RenderPipelineState(const igl::vulkan::Device& device,
 RenderPipelineState::~RenderPipelineState() {
   VkDevice device = device_.getVulkanContext().device_->getVkDevice();
 
-  for (auto p : pipelines_) {
-    if (p.second != VK_NULL_HANDLE) {
+  // worker threads reference this object - wait for them
+  for (auto& p : pendingPipelines_) {
+    pipelines_[p.first] = p.second.get();
+  }
+  pendingPipelines_.clear();
+  for (auto& p : optimizingPipelines_) {
+    retiredPipelines_.push_back(p.second.get());
+  }
+  optimizingPipelines_.clear();
+
+  for (const auto& p : pipelines_) {
+    retiredPipelines_.push_back(p.second);
+  }
+  for (const auto& libraries : libraries_) {
+    for (const auto& p : libraries) {
+      retiredPipelines_.push_back(p.second);
+    }
+  }
+
+  for (VkPipeline pipeline : retiredPipelines_) {
+    if (pipeline != VK_NULL_HANDLE) {
       device_.getVulkanContext().deferredTask(std::packaged_task<void()>(
-          [device, pipeline = p.second]() { vkDestroyPipeline(device, pipeline, nullptr); }));
+          [device, pipeline]() { vkDestroyPipeline(device, pipeline, nullptr); }));
     }
   }
+
+  if (immutableSamplersLayout_) {
+    // command buffers in flight may still use the layouts
+    std::shared_ptr<ImmutableSamplersLayout> layout = std::move(immutableSamplersLayout_);
+    device_.getVulkanContext().deferredTask(
+        std::packaged_task<void()>([layout]() mutable { layout.reset(); }));
+  }
 }
 
-VkPipeline RenderPipelineState::getVkPipeline(
+VkPipelineLayout RenderPipelineState::getVkPipelineLayout() const {
+  return immutableSamplersLayout_
+             ? immutableSamplersLayout_->pipelineLayout->getVkPipelineLayout()
+             : device_.getVulkanContext().pipelineLayoutGraphics_->getVkPipelineLayout();
+}
+
+RenderPipelineDynamicState RenderPipelineState::getPipelineKey(
     const RenderPipelineDynamicState& dynamicState) const {
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  if (!ctx.usesExtendedDynamicState()) {
+    return dynamicState;
+  }
+
+  // these states are set by RenderCommandEncoder with vkCmdSet*()
+  RenderPipelineDynamicState key = dynamicState;
+  key.setTopology(ctx.hasUnrestrictedDynamicPrimitiveTopology()
+                      ? VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
+                      : getPrimitiveTopologyClass(dynamicState.getTopology()));
+  key.setDepthCompareOp(VK_COMPARE_OP_ALWAYS);
+  key.depthWriteEnable_ = false;
+  key.setStencilStateOps(
+      true, VK_STENCIL_OP_KEEP, VK_STENCIL_OP_KEEP, VK_STENCIL_OP_KEEP, VK_COMPARE_OP_ALWAYS);
+  key.setStencilStateOps(
+      false, VK_STENCIL_OP_KEEP, VK_STENCIL_OP_KEEP, VK_STENCIL_OP_KEEP, VK_COMPARE_OP_ALWAYS);
+  if (ctx.usesExtendedDynamicState2()) {
+    key.depthBiasEnable_ = false;
+  }
+
+  return key;
+}
+
+bool RenderPipelineState::requestVkPipeline(const RenderPipelineDynamicState& state,
+                                            VkPipeline& outPipeline) const {
+  const RenderPipelineDynamicState dynamicState = getPipelineKey(state);
+
+  std::lock_guard<std::mutex> lock(pipelinesMutex_);
+
   const auto it = pipelines_.find(dynamicState);
 
   if (it != pipelines_.end()) {
-    return it->second;
+    if (!optimizingPipelines_.empty()) {
+      replaceWithOptimizedPipeline(dynamicState, it->second);
+    }
+    outPipeline = it->second;
+    return true;
   }
 
-  // build a new Vulkan pipeline
+  const auto pending = pendingPipelines_.find(dynamicState);
+
+  if (pending != pendingPipelines_.end()) {
+    if (pending->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return false;
+    }
+    outPipeline = pending->second.get();
+    pipelines_[dynamicState] = outPipeline;
+    pendingPipelines_.erase(pending);
+    return true;
+  }
 
   const VulkanContext& ctx = device_.getVulkanContext();
 
-  VkRenderPass renderPass = ctx.getRenderPass(dynamicState.renderPassIndex_).pass;
+  // render passes are owned by the context and should be resolved on this thread
+  VkRenderPass renderPass = ctx.usesDynamicRendering()
+                                ? VK_NULL_HANDLE
+                                : ctx.getRenderPass(dynamicState.renderPassIndex_).pass;
+
+  if (ctx.usesGraphicsPipelineLibrary()) {
+    // only the libraries which were not needed before are compiled here
+    std::vector<VkPipeline> libraries;
+    outPipeline = linkVkPipeline(dynamicState, renderPass, libraries);
+    pipelines_[dynamicState] = outPipeline;
+    if (ctx.pipelineCompilationPool_ && outPipeline != VK_NULL_HANDLE) {
+      auto task = std::make_shared<std::packaged_task<VkPipeline()>>(
+          [this, libraries = std::move(libraries)]() {
+            VkPipeline pipeline = VK_NULL_HANDLE;
+            const VulkanContext& ctx = device_.getVulkanContext();
+            const VkResult result = VulkanPipelineBuilder::link(
+                ctx.device_->getVkDevice(),
+                ctx.pipelineCache_,
+                getVkPipelineLayout(),
+                ctx.getPipelineCreateFlags(),
+                libraries,
+                true,
+                &pipeline,
+                desc_.debugName.toConstChar());
+            return result == VK_SUCCESS ? pipeline : VK_NULL_HANDLE;
+          });
+      optimizingPipelines_[dynamicState] = task->get_future();
+      ctx.pipelineCompilationPool_->enqueue([task]() { (*task)(); });
+    }
+    return true;
+  }
+
+  if (!ctx.pipelineCompilationPool_) {
+    outPipeline = createVkPipeline(dynamicState, renderPass);
+    pipelines_[dynamicState] = outPipeline;
+    return true;
+  }
+
+  auto task = std::make_shared<std::packaged_task<VkPipeline()>>(
+      [this, dynamicState, renderPass]() { return createVkPipeline(dynamicState, renderPass); });
+  pendingPipelines_[dynamicState] = task->get_future();
+  ctx.pipelineCompilationPool_->enqueue([task]() { (*task)(); });
+
+  return false;
+}
 
+VkPipeline RenderPipelineState::getVkPipeline(
+    const RenderPipelineDynamicState& dynamicState) const {
   VkPipeline pipeline = VK_NULL_HANDLE;
 
+  if (requestVkPipeline(dynamicState, pipeline)) {
+    return pipeline;
+  }
+
+  // the pipeline is not ready yet
+  if (fallback_) {
+    static_cast<const RenderPipelineState*>(fallback_.get())
+        ->requestVkPipeline(dynamicState, pipeline);
+  }
+
+  return pipeline;
+}
+
+void RenderPipelineState::prewarm(
+    const std::vector<RenderPipelineDynamicState>& dynamicStates) const {
+  IGL_PROFILER_FUNCTION();
+
+  for (const auto& dynamicState : dynamicStates) {
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    requestVkPipeline(dynamicState, pipeline);
+  }
+}
+
+bool RenderPipelineState::isPipelineReady(const RenderPipelineDynamicState& state) const {
+  const RenderPipelineDynamicState dynamicState = getPipelineKey(state);
+
+  std::lock_guard<std::mutex> lock(pipelinesMutex_);
+
+  if (pipelines_.find(dynamicState) != pipelines_.end()) {
+    return true;
+  }
+
+  const auto it = pendingPipelines_.find(dynamicState);
+
+  return it != pendingPipelines_.end() &&
+         it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void RenderPipelineState::replaceWithOptimizedPipeline(const RenderPipelineDynamicState& key,
+                                                       VkPipeline& pipeline) const {
+  const auto it = optimizingPipelines_.find(key);
+
+  if (it == optimizingPipelines_.end() ||
+      it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return;
+  }
+
+  const VkPipeline optimized = it->second.get();
+  optimizingPipelines_.erase(it);
+
+  if (optimized != VK_NULL_HANDLE) {
+    // command buffers which are still being recorded can reference the fast-linked pipeline, so
+    // it lives as long as this object
+    retiredPipelines_.push_back(pipeline);
+    pipeline = optimized;
+  }
+}
+
+RenderPipelineDynamicState RenderPipelineState::getLibraryKey(
+    const RenderPipelineDynamicState& key,
+    LibraryPart part) const {
+  // only the states which go into the part
+  RenderPipelineDynamicState libraryKey;
+
+  switch (part) {
+  case LibraryPart::VertexInput:
+    libraryKey.setTopology(key.getTopology());
+    break;
+  case LibraryPart::PreRasterization:
+    libraryKey.depthBiasEnable_ = key.depthBiasEnable_;
+    libraryKey.renderPassIndex_ = key.renderPassIndex_;
+    libraryKey.viewMask_ = key.viewMask_;
+    break;
+  case LibraryPart::FragmentShader:
+    libraryKey = key;
+    libraryKey.setTopology(VK_PRIMITIVE_TOPOLOGY_POINT_LIST);
+    libraryKey.depthBiasEnable_ = false;
+    break;
+  case LibraryPart::FragmentOutput:
+    libraryKey.renderPassIndex_ = key.renderPassIndex_;
+    libraryKey.viewMask_ = key.viewMask_;
+    break;
+  case LibraryPart::NumParts:
+    IGL_ASSERT_NOT_REACHED();
+    break;
+  }
+
+  return libraryKey;
+}
+
+VkPipeline RenderPipelineState::linkVkPipeline(const RenderPipelineDynamicState& dynamicState,
+                                               VkRenderPass renderPass,
+                                               std::vector<VkPipeline>& outLibraries) const {
+  IGL_PROFILER_FUNCTION();
+
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  VkFlags libraryFlags[kNumLibraryParts] = {};
+#if IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED
+  libraryFlags[(size_t)LibraryPart::VertexInput] =
+      VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+  libraryFlags[(size_t)LibraryPart::PreRasterization] =
+      VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+  libraryFlags[(size_t)LibraryPart::FragmentShader] =
+      VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+  libraryFlags[(size_t)LibraryPart::FragmentOutput] =
+      VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+#endif // IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED
+
+  outLibraries.clear();
+
+  for (size_t i = 0; i != kNumLibraryParts; i++) {
+    const RenderPipelineDynamicState key = getLibraryKey(dynamicState, (LibraryPart)i);
+    auto& libraries = libraries_[i];
+    const auto it = libraries.find(key);
+    if (it != libraries.end()) {
+      outLibraries.push_back(it->second);
+      continue;
+    }
+    VkPipeline library = VK_NULL_HANDLE;
+    VK_ASSERT_RETURN_NULL_HANDLE(createPipelineBuilder(dynamicState)
+                                     .libraryFlags(libraryFlags[i])
+                                     .build(ctx.device_->getVkDevice(),
+                                            ctx.pipelineCache_,
+                                            getVkPipelineLayout(),
+                                            renderPass,
+                                            &library,
+                                            desc_.debugName.toConstChar()));
+    libraries[key] = library;
+    outLibraries.push_back(library);
+  }
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+
+  VK_ASSERT_RETURN_NULL_HANDLE(
+      VulkanPipelineBuilder::link(ctx.device_->getVkDevice(),
+                                  ctx.pipelineCache_,
+                                  getVkPipelineLayout(),
+                                  ctx.getPipelineCreateFlags(),
+                                  outLibraries,
+                                  false,
+                                  &pipeline,
+                                  desc_.debugName.toConstChar()));
+
+  return pipeline;
+}
+
+VulkanPipelineBuilder RenderPipelineState::createPipelineBuilder(
+    const RenderPipelineDynamicState& dynamicState) const {
+  const VulkanContext& ctx = device_.getVulkanContext();
+
   // Not all attachments are valid. We need to create color blend attachments only for active
   // attachments
   std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachmentStates;
@@ -312,61 +635,118 @@ VkPipeline RenderPipelineState::getVkPipeline(
                   }
                 });
 
+  // dynamic rendering: the formats have to match the image views of the attachments, where depth
+  // and stencil are aspects of the same depth-stencil texture
+  std::vector<VkFormat> colorFormats;
+  for (const auto& attachment : desc_.targetDesc.colorAttachments) {
+    if (attachment.textureFormat != TextureFormat::Invalid) {
+      colorFormats.push_back(textureFormatToVkFormat(attachment.textureFormat));
+    }
+  }
+  const TextureFormat depthStencilFormat =
+      desc_.targetDesc.depthAttachmentFormat != TextureFormat::Invalid
+          ? desc_.targetDesc.depthAttachmentFormat
+          : desc_.targetDesc.stencilAttachmentFormat;
+  const VkFormat depthStencilVkFormat = depthStencilFormat != TextureFormat::Invalid
+                                            ? ctx.getClosestDepthStencilFormat(depthStencilFormat)
+                                            : VK_FORMAT_UNDEFINED;
+
+  std::vector<VkDynamicState> dynamicStates = {
+      // from Vulkan 1.0
+      VK_DYNAMIC_STATE_VIEWPORT,
+      VK_DYNAMIC_STATE_SCISSOR,
+      VK_DYNAMIC_STATE_DEPTH_BIAS,
+      VK_DYNAMIC_STATE_BLEND_CONSTANTS,
+      VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK,
+      VK_DYNAMIC_STATE_STENCIL_WRITE_MASK,
+      VK_DYNAMIC_STATE_STENCIL_REFERENCE,
+  };
+#if defined(VK_EXT_extended_dynamic_state)
+  // `dynamicState` holds the defaults of these; see getPipelineKey()
+  if (ctx.usesExtendedDynamicState()) {
+    dynamicStates.insert(dynamicStates.end(),
+                         {
+                             VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT,
+                             VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT,
+                             VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT,
+                             VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT,
+                             VK_DYNAMIC_STATE_STENCIL_OP_EXT,
+                         });
+  }
+#endif // VK_EXT_extended_dynamic_state
+#if defined(VK_EXT_extended_dynamic_state2)
+  if (ctx.usesExtendedDynamicState2()) {
+    dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT);
+  }
+#endif // VK_EXT_extended_dynamic_state2
+
   const auto& vertexModule = desc_.shaderStages->getVertexModule();
   const auto& fragmentModule = desc_.shaderStages->getFragmentModule();
+  VulkanPipelineBuilder builder;
+  builder.dynamicStates(dynamicStates)
+      .primitiveTopology(dynamicState.getTopology())
+      .depthBiasEnable(dynamicState.depthBiasEnable_)
+      .depthCompareOp(dynamicState.getDepthCompareOp())
+      .depthWriteEnable(dynamicState.depthWriteEnable_)
+      .rasterizationSamples(getVulkanSampleCountFlags(desc_.sampleCount))
+      .polygonMode(polygonFillModeToVkPolygonMode(desc_.polygonFillMode))
+      .stencilStateOps(VK_STENCIL_FACE_FRONT_BIT,
+                       dynamicState.getStencilStateFailOp(true),
+                       dynamicState.getStencilStatePassOp(true),
+                       dynamicState.getStencilStateDepthFailOp(true),
+                       dynamicState.getStencilStateCompareOp(true))
+      .stencilStateOps(VK_STENCIL_FACE_BACK_BIT,
+                       dynamicState.getStencilStateFailOp(false),
+                       dynamicState.getStencilStatePassOp(false),
+                       dynamicState.getStencilStateDepthFailOp(false),
+                       dynamicState.getStencilStateCompareOp(false))
+      .shaderStages({
+          ivkGetPipelineShaderStageCreateInfo(
+              VK_SHADER_STAGE_VERTEX_BIT,
+              igl::vulkan::ShaderModule::getVkShaderModule(vertexModule),
+              vertexModule->info().entryPoint.c_str(),
+              igl::vulkan::ShaderModule::getVkSpecializationInfo(vertexModule)),
+          ivkGetPipelineShaderStageCreateInfo(
+              VK_SHADER_STAGE_FRAGMENT_BIT,
+              igl::vulkan::ShaderModule::getVkShaderModule(fragmentModule),
+              fragmentModule->info().entryPoint.c_str(),
+              igl::vulkan::ShaderModule::getVkSpecializationInfo(fragmentModule)),
+      })
+      .cullMode(cullModeToVkCullMode(desc_.cullMode))
+      .frontFace(windingModeToVkFrontFace(desc_.frontFaceWinding))
+      .vertexInputState(vertexInputStateCreateInfo_)
+      .colorBlendAttachmentStates(colorBlendAttachmentStates)
+      .renderingFormats(std::move(colorFormats),
+                        VulkanImage::isDepthFormat(depthStencilVkFormat)
+                            ? depthStencilVkFormat
+                            : VK_FORMAT_UNDEFINED,
+                        VulkanImage::isStencilFormat(depthStencilVkFormat)
+                            ? depthStencilVkFormat
+                            : VK_FORMAT_UNDEFINED,
+                        dynamicState.viewMask_)
+      .subpass(desc_.subpassIndex)
+      .createFlags(ctx.getPipelineCreateFlags());
+
+  return builder;
+}
+
+VkPipeline RenderPipelineState::createVkPipeline(const RenderPipelineDynamicState& dynamicState,
+                                                 VkRenderPass renderPass) const {
+  IGL_PROFILER_FUNCTION();
+
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+
   VK_ASSERT_RETURN_NULL_HANDLE(
-      igl::vulkan::VulkanPipelineBuilder()
-          .dynamicStates({
-              // from Vulkan 1.0
-              VK_DYNAMIC_STATE_VIEWPORT,
-              VK_DYNAMIC_STATE_SCISSOR,
-              VK_DYNAMIC_STATE_DEPTH_BIAS,
-              VK_DYNAMIC_STATE_BLEND_CONSTANTS,
-              VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK,
-              VK_DYNAMIC_STATE_STENCIL_WRITE_MASK,
-              VK_DYNAMIC_STATE_STENCIL_REFERENCE,
-          })
-          .primitiveTopology(dynamicState.getTopology())
-          .depthBiasEnable(dynamicState.depthBiasEnable_)
-          .depthCompareOp(dynamicState.getDepthCompareOp())
-          .depthWriteEnable(dynamicState.depthWriteEnable_)
-          .rasterizationSamples(getVulkanSampleCountFlags(desc_.sampleCount))
-          .polygonMode(polygonFillModeToVkPolygonMode(desc_.polygonFillMode))
-          .stencilStateOps(VK_STENCIL_FACE_FRONT_BIT,
-                           dynamicState.getStencilStateFailOp(true),
-                           dynamicState.getStencilStatePassOp(true),
-                           dynamicState.getStencilStateDepthFailOp(true),
-                           dynamicState.getStencilStateCompareOp(true))
-          .stencilStateOps(VK_STENCIL_FACE_BACK_BIT,
-                           dynamicState.getStencilStateFailOp(false),
-                           dynamicState.getStencilStatePassOp(false),
-                           dynamicState.getStencilStateDepthFailOp(false),
-                           dynamicState.getStencilStateCompareOp(false))
-          .shaderStages({
-              ivkGetPipelineShaderStageCreateInfo(
-                  VK_SHADER_STAGE_VERTEX_BIT,
-                  igl::vulkan::ShaderModule::getVkShaderModule(vertexModule),
-                  vertexModule->info().entryPoint.c_str()),
-              ivkGetPipelineShaderStageCreateInfo(
-                  VK_SHADER_STAGE_FRAGMENT_BIT,
-                  igl::vulkan::ShaderModule::getVkShaderModule(fragmentModule),
-                  fragmentModule->info().entryPoint.c_str()),
-          })
-          .cullMode(cullModeToVkCullMode(desc_.cullMode))
-          .frontFace(windingModeToVkFrontFace(desc_.frontFaceWinding))
-          .vertexInputState(vertexInputStateCreateInfo_)
-          .colorBlendAttachmentStates(colorBlendAttachmentStates)
+      createPipelineBuilder(dynamicState)
           .build(ctx.device_->getVkDevice(),
-                 // TODO: use ctx.pipelineCache_
-                 // @fb-only
-                 VK_NULL_HANDLE,
-                 ctx.pipelineLayoutGraphics_->getVkPipelineLayout(),
+                 ctx.pipelineCache_,
+                 getVkPipelineLayout(),
                  renderPass,
                  &pipeline,
                  desc_.debugName.toConstChar()));
 
-  pipelines_[dynamicState] = pipeline;
-
   // @fb-only
   // @lint-ignore CLANGTIDY
   return pipeline;
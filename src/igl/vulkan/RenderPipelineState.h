@@ -9,13 +9,29 @@
 
 #include <igl/RenderPipelineState.h>
 #include <igl/vulkan/Common.h>
+#include <future>
 #include <igl/vulkan/RenderPipelineReflection.h>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace igl {
 namespace vulkan {
 
 class Device;
+class VulkanDescriptorSetLayout;
+class VulkanPipelineBuilder;
+class VulkanPipelineLayout;
+class VulkanSampler;
+
+/// @brief The layouts of a render pipeline with RenderPipelineDesc::immutableSamplers: they take
+/// the place of VulkanContext::dslCombinedImageSamplers_ and VulkanContext::pipelineLayoutGraphics_
+struct ImmutableSamplersLayout {
+  std::unique_ptr<VulkanDescriptorSetLayout> dslTextures;
+  std::unique_ptr<VulkanPipelineLayout> pipelineLayout;
+  // the samplers baked into `dslTextures`; null in the slots which use the bound samplers
+  VulkanSampler* samplers[IGL_TEXTURE_SAMPLERS_MAX] = {};
+};
 
 class alignas(sizeof(uint64_t)) RenderPipelineDynamicState {
   uint32_t topology_ : 4;
@@ -49,13 +65,17 @@ class alignas(sizeof(uint64_t)) RenderPipelineDynamicState {
  public:
   // Ignore modernize-use-default-member-init
   // @lint-ignore CLANGTIDY
-  uint32_t renderPassIndex_ : 8;
+  uint32_t renderPassIndex_ : 16;
   // Ignore modernize-use-default-member-init
   // @lint-ignore CLANGTIDY
   uint32_t depthBiasEnable_ : 1;
   // Ignore modernize-use-default-member-init
   // @lint-ignore CLANGTIDY
   uint32_t depthWriteEnable_ : 1;
+  // the view mask of dynamic rendering; render passes are created with their view masks
+  // Ignore modernize-use-default-member-init
+  // @lint-ignore CLANGTIDY
+  uint32_t viewMask_ : 2;
 
   RenderPipelineDynamicState() {
     // memset makes sure all padding bits are zero
@@ -75,6 +95,7 @@ class alignas(sizeof(uint64_t)) RenderPipelineDynamicState {
     renderPassIndex_ = 0;
     depthBiasEnable_ = false;
     depthWriteEnable_ = false;
+    viewMask_ = 0;
   }
 
   VkPrimitiveTopology getTopology() const {
@@ -154,12 +175,42 @@ class RenderPipelineState final : public IRenderPipelineState {
   RenderPipelineState(const igl::vulkan::Device& device, RenderPipelineDesc desc);
   ~RenderPipelineState() override;
 
+  // With asynchronous pipeline compilation enabled (see
+  // VulkanContextConfig::numPipelineCompilationThreads), this returns the fallback pipeline (or
+  // VK_NULL_HANDLE) until the pipeline for `dynamicState` has been built on a worker thread.
   VkPipeline getVkPipeline(const RenderPipelineDynamicState& dynamicState) const;
 
+  // Starts building pipelines for known dynamic state permutations ahead of time
+  void prewarm(const std::vector<RenderPipelineDynamicState>& dynamicStates) const;
+
+  bool isPipelineReady(const RenderPipelineDynamicState& dynamicState) const;
+
+  // A pipeline state used for draws while the actual pipeline is still being compiled. It should
+  // be compatible with the same render passes and vertex input (i.e. a cheap "uber" shader).
+  // With immutable samplers, the fallback should declare the same ones: draws bind the descriptor
+  // sets with the layout of this pipeline.
+  void setFallbackPipelineState(std::shared_ptr<IRenderPipelineState> fallback) {
+    IGL_ASSERT_MSG(!fallback || static_cast<const RenderPipelineState*>(fallback.get())
+                                        ->desc_.immutableSamplers == desc_.immutableSamplers,
+                   "The fallback pipeline should have the same immutable samplers");
+    fallback_ = std::move(fallback);
+  }
+
   const RenderPipelineDesc& getRenderPipelineDesc() const {
     return desc_;
   }
 
+  // the descriptor sets read by the shaders (bit `i` is set `i`); the others are never updated
+  // while this pipeline is bound
+  uint32_t getDescriptorSetMask() const {
+    return descriptorSetMask_;
+  }
+
+  // null without immutable samplers: the pipeline uses the layout of VulkanContext
+  const ImmutableSamplersLayout* getImmutableSamplersLayout() const {
+    return immutableSamplersLayout_.get();
+  }
+
  private:
   friend class Device;
 
@@ -170,11 +221,49 @@ class RenderPipelineState final : public IRenderPipelineState {
   void setRenderPipelineReflection(
       const IRenderPipelineReflection& renderPipelineReflection) override;
 
+  // thread-safe: does not touch any mutable state. `renderPass` is VK_NULL_HANDLE with dynamic
+  // rendering, where pipelines depend only on the attachment formats of `desc_`
+  VkPipeline createVkPipeline(const RenderPipelineDynamicState& dynamicState,
+                              VkRenderPass renderPass) const;
+  // all the states of the pipeline for `dynamicState`, ready to be built
+  VulkanPipelineBuilder createPipelineBuilder(const RenderPipelineDynamicState& dynamicState) const;
+
+  // graphics pipeline libraries (VulkanContext::usesGraphicsPipelineLibrary())
+  enum class LibraryPart : uint8_t {
+    VertexInput,
+    PreRasterization,
+    FragmentShader,
+    FragmentOutput,
+    NumParts,
+  };
+  static constexpr size_t kNumLibraryParts = static_cast<size_t>(LibraryPart::NumParts);
+  // the states of `key` which go into the library of `part`; the others are reset to defaults
+  RenderPipelineDynamicState getLibraryKey(const RenderPipelineDynamicState& key,
+                                           LibraryPart part) const;
+  // called with `pipelinesMutex_` held: creates the missing libraries and fast-links them.
+  // `outLibraries` receives the libraries of the pipeline
+  VkPipeline linkVkPipeline(const RenderPipelineDynamicState& dynamicState,
+                            VkRenderPass renderPass,
+                            std::vector<VkPipeline>& outLibraries) const;
+  // called with `pipelinesMutex_` held: swaps in the optimized pipeline once it is linked
+  void replaceWithOptimizedPipeline(const RenderPipelineDynamicState& key,
+                                    VkPipeline& pipeline) const;
+  // returns true if the pipeline is ready; otherwise schedules its compilation
+  bool requestVkPipeline(const RenderPipelineDynamicState& dynamicState,
+                         VkPipeline& outPipeline) const;
+  // the key of `pipelines_`: with VK_EXT_extended_dynamic_state, the states which are set at draw
+  // time are reset to their defaults, so all their combinations share one VkPipeline
+  RenderPipelineDynamicState getPipelineKey(const RenderPipelineDynamicState& dynamicState) const;
+  // the layout the pipelines are built with
+  VkPipelineLayout getVkPipelineLayout() const;
+
  private:
   const igl::vulkan::Device& device_;
 
   std::shared_ptr<IShaderStages> shaderStages_;
   RenderPipelineDesc desc_;
+  uint32_t descriptorSetMask_ = kAllDescriptorSets;
+  std::unique_ptr<ImmutableSamplersLayout> immutableSamplersLayout_;
   VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo_;
 
   std::vector<VkVertexInputBindingDescription> vkBindings_;
@@ -183,10 +272,32 @@ class RenderPipelineState final : public IRenderPipelineState {
   // This is empty for now.
   std::shared_ptr<RenderPipelineReflection> reflection_;
 
+  // guards `pipelines_` and `pendingPipelines_`: encoders can be recorded on different threads
+  mutable std::mutex pipelinesMutex_;
   mutable std::unordered_map<RenderPipelineDynamicState,
                              VkPipeline,
                              RenderPipelineDynamicState::HashFunction>
       pipelines_;
+  // pipelines being compiled on worker threads
+  mutable std::unordered_map<RenderPipelineDynamicState,
+                             std::future<VkPipeline>,
+                             RenderPipelineDynamicState::HashFunction>
+      pendingPipelines_;
+  // graphics pipeline libraries of every part, keyed by getLibraryKey()
+  mutable std::unordered_map<RenderPipelineDynamicState,
+                             VkPipeline,
+                             RenderPipelineDynamicState::HashFunction>
+      libraries_[kNumLibraryParts];
+  // optimized pipelines being linked on worker threads; they replace the fast-linked pipelines in
+  // `pipelines_`
+  mutable std::unordered_map<RenderPipelineDynamicState,
+                             std::future<VkPipeline>,
+                             RenderPipelineDynamicState::HashFunction>
+      optimizingPipelines_;
+  // fast-linked pipelines replaced by optimized ones
+  mutable std::vector<VkPipeline> retiredPipelines_;
+
+  std::shared_ptr<IRenderPipelineState> fallback_;
 };
 
 } // namespace vulkan
@@ -5,12 +5,17 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/ResourcesBinder.h>
+
+#include <algorithm>
+
+#include <igl/vulkan/Buffer.h>
+#include <igl/vulkan/RenderPipelineState.h>
 #include <igl/vulkan/SamplerState.h>
 #include <igl/vulkan/Texture.h>
 #include <igl/vulkan/VulkanBuffer.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDescriptorSetLayout.h>
 #include <igl/vulkan/VulkanPipelineLayout.h>
 
 namespace igl {
@@ -20,7 +25,42 @@ namespace vulkan {
 ResourcesBinder::ResourcesBinder(const std::shared_ptr<CommandBuffer>& commandBuffer,
                                  const VulkanContext& ctx,
                                  VkPipelineBindPoint bindPoint) :
-  ctx_(ctx), cmdBuffer_(commandBuffer->getVkCommandBuffer()), bindPoint_(bindPoint) {}
+  ResourcesBinder(
+      commandBuffer->getVkCommandBuffer(),
+      (commandBuffer->isAsyncCompute() ? ctx.computeTransientDSets_ : ctx.transientDSets_)
+          [commandBuffer->getCommandBufferWrapper().handle_.bufferIndex_],
+      ctx,
+      bindPoint) {}
+
+ResourcesBinder::ResourcesBinder(VkCommandBuffer cmdBuffer,
+                                 VulkanTransientDescriptorSets& dsets,
+                                 const VulkanContext& ctx,
+                                 VkPipelineBindPoint bindPoint) :
+  ctx_(ctx), dsets_(dsets), cmdBuffer_(cmdBuffer), bindPoint_(bindPoint) {
+  if (dsets_.descriptorBuffer) {
+    numDescriptorBufferResizes_ = dsets_.descriptorBuffer->getStats().numResizes;
+  }
+}
+
+VkPipelineLayout ResourcesBinder::getVkPipelineLayout() const {
+  if (immutableSamplersLayout_) {
+    return immutableSamplersLayout_->pipelineLayout->getVkPipelineLayout();
+  }
+  return (isGraphics() ? ctx_.pipelineLayoutGraphics_ : ctx_.pipelineLayoutCompute_)
+      ->getVkPipelineLayout();
+}
+
+void ResourcesBinder::setBufferAddress(BindingsBuffers& bindings,
+                                       uint32_t index,
+                                       igl::vulkan::Buffer* buffer,
+                                       size_t bufferOffset) const {
+  if (!ctx_.useDescriptorBuffers_) {
+    return;
+  }
+  // empty slots are replaced with the dummy buffers when the descriptors are written
+  bindings.addresses[index] = buffer ? buffer->gpuAddress(0) + bufferOffset : 0;
+  bindings.ranges[index] = buffer ? buffer->getSizeInBytes() - bufferOffset : 0;
+}
 
 void ResourcesBinder::bindUniformBuffer(uint32_t index,
                                         igl::vulkan::Buffer* buffer,
@@ -38,8 +78,35 @@ void ResourcesBinder::bindUniformBuffer(uint32_t index,
   VkBuffer buf = buffer ? buffer->getVkBuffer() : ctx_.dummyUniformBuffer_->getVkBuffer();
   VkDescriptorBufferInfo& slot = bindingsUniformBuffers_.buffers[index];
 
-  if (slot.buffer != buf || slot.offset != bufferOffset) {
-    slot = {buf, bufferOffset, VK_WHOLE_SIZE};
+  if (buffer && index < ctx_.numDynamicUniformBuffers_) {
+    // the descriptor starts at the beginning of the buffer and `bufferOffset` is a dynamic offset,
+    // so moving to another offset of the same buffer does not need a new descriptor set
+    const VkDeviceSize base = buffer->getVkBufferOffset();
+    const VkDeviceSize size = buffer->getSizeInBytes();
+    IGL_ASSERT(bufferOffset < size);
+    uint32_t& dynamicOffset = bindingsUniformBuffers_.dynamicOffsets[index];
+    if (slot.buffer == buf && slot.offset == base && bufferOffset + slot.range <= size) {
+      if (dynamicOffset != bufferOffset) {
+        dynamicOffset = static_cast<uint32_t>(bufferOffset);
+        isDirtyDynamicOffsets_ = true;
+      }
+      return;
+    }
+    const VkDeviceSize maxRange = ctx_.getVkPhysicalDeviceProperties().limits.maxUniformBufferRange;
+    slot = {buf,
+            base,
+            std::min<VkDeviceSize>(
+                {ctx_.config_.dynamicUniformBufferRange, size - bufferOffset, maxRange})};
+    dynamicOffset = static_cast<uint32_t>(bufferOffset);
+    isDirtyUniformBuffers_ = true;
+    return;
+  }
+
+  const VkDeviceSize offset = buffer ? buffer->getVkBufferOffset() + bufferOffset : 0;
+
+  if (slot.buffer != buf || slot.offset != offset) {
+    slot = {buf, offset, buffer ? buffer->getVkDescriptorRange(bufferOffset) : VK_WHOLE_SIZE};
+    setBufferAddress(bindingsUniformBuffers_, index, buffer, bufferOffset);
     isDirtyUniformBuffers_ = true;
   }
 }
@@ -58,14 +125,59 @@ void ResourcesBinder::bindStorageBuffer(uint32_t index,
                  "The buffer must be a storage buffer");
 
   VkBuffer buf = buffer ? buffer->getVkBuffer() : ctx_.dummyStorageBuffer_->getVkBuffer();
+  const VkDeviceSize offset = buffer ? buffer->getVkBufferOffset() + bufferOffset : 0;
   VkDescriptorBufferInfo& slot = bindingsStorageBuffers_.buffers[index];
 
-  if (slot.buffer != buf || slot.offset != bufferOffset) {
-    slot = {buf, bufferOffset, VK_WHOLE_SIZE};
+  if (slot.buffer != buf || slot.offset != offset) {
+    slot = {buf, offset, buffer ? buffer->getVkDescriptorRange(bufferOffset) : VK_WHOLE_SIZE};
+    setBufferAddress(bindingsStorageBuffers_, index, buffer, bufferOffset);
     isDirtyStorageBuffers_ = true;
   }
 }
 
+bool ResourcesBinder::bindUniformBytes(uint32_t index, const void* data, size_t length) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(index < IGL_UNIFORM_BLOCKS_BINDING_MAX)) {
+    IGL_ASSERT_MSG(false, "Buffer index should not exceed kMaxBindingSlots");
+    return false;
+  }
+
+  VkBuffer buf = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  VkDeviceAddress address = 0;
+  if (!dsets_.uniformArena->allocate(*dsets_.commands,
+                                     data,
+                                     length,
+                                     buf,
+                                     offset,
+                                     ctx_.useDescriptorBuffers_ ? &address : nullptr)) {
+    return false;
+  }
+
+  VkDescriptorBufferInfo& slot = bindingsUniformBuffers_.buffers[index];
+
+  if (index < ctx_.numDynamicUniformBuffers_) {
+    // allocations of the same size from the same block only change the dynamic offset
+    bindingsUniformBuffers_.dynamicOffsets[index] = static_cast<uint32_t>(offset);
+    if (slot.buffer == buf && slot.offset == 0 && slot.range == length) {
+      isDirtyDynamicOffsets_ = true;
+    } else {
+      slot = {buf, 0, length};
+      isDirtyUniformBuffers_ = true;
+    }
+    return true;
+  }
+
+  // every allocation has its own offset, so the descriptors are always updated
+  slot = {buf, offset, length};
+  bindingsUniformBuffers_.addresses[index] = address;
+  bindingsUniformBuffers_.ranges[index] = length;
+  isDirtyUniformBuffers_ = true;
+
+  return true;
+}
+
 void ResourcesBinder::bindSamplerState(uint32_t index, igl::vulkan::SamplerState* samplerState) {
   IGL_PROFILER_FUNCTION();
 
@@ -91,6 +203,10 @@ void ResourcesBinder::bindTexture(uint32_t index, igl::vulkan::Texture* tex) {
   }
 
   if (tex) {
+    // the combined image samplers of the slots cannot hold the immutable samplers of YUV textures
+    IGL_ASSERT_MSG(!tex->getProperties().isMultiPlanar(),
+                   "YUV textures are only accessible through kTexturesYUV_* bindless arrays");
+
     const bool isSampled = tex ? (tex->getUsage() & TextureDesc::TextureUsageBits::Sampled) > 0
                                : false;
     const bool isStorage = tex ? (tex->getUsage() & TextureDesc::TextureUsageBits::Storage) > 0
@@ -119,23 +235,140 @@ void ResourcesBinder::bindTexture(uint32_t index, igl::vulkan::Texture* tex) {
   }
 }
 
-void ResourcesBinder::updateBindings() {
-  if (isDirtyTextures_) {
-    ctx_.updateBindingsTextures(cmdBuffer_, bindPoint_, bindingsTextures_);
+void ResourcesBinder::bindTexturesDescriptorSet(VkDescriptorSet dset,
+                                                const BindingsTextures& bindings) {
+  IGL_PROFILER_FUNCTION();
+
+  if (immutableSamplersLayout_) {
+    // persistent sets have the set layout of VulkanContext: write the bindings into a transient set
+    bindingsTextures_ = bindings;
+    isDirtyTextures_ = true;
+    dsetTextures_ = VK_NULL_HANDLE;
+    return;
+  }
+
+  if (dsetTextures_ == dset && !isDirtyTextures_) {
+    ctx_.getFrameStatisticsTracker().add(FrameStatisticsTracker::SkippedCommands);
+    return;
+  }
+
+  bindingsTextures_ = bindings;
+  isDirtyTextures_ = false;
+  dsetTextures_ = dset;
+  ctx_.bindTexturesDescriptorSet(cmdBuffer_, bindPoint_, getVkPipelineLayout(), dset);
+}
+
+void ResourcesBinder::bindInputAttachments(uint32_t numViews, const VkImageView* views) {
+  IGL_ASSERT(isGraphics());
+  IGL_ASSERT(numViews <= IGL_COLOR_ATTACHMENTS_MAX);
+
+  numInputAttachments_ = std::min<uint32_t>(numViews, IGL_COLOR_ATTACHMENTS_MAX);
+  std::copy(views, views + numInputAttachments_, inputAttachments_.begin());
+
+  ctx_.updateBindingsInputAttachments(cmdBuffer_, dsets_, getVkPipelineLayout(), numViews, views);
+}
+
+void ResourcesBinder::updateBindings(uint32_t descriptorSetMask) {
+  auto usesSet = [descriptorSetMask](uint32_t set) {
+    return (descriptorSetMask & (1u << set)) != 0;
+  };
+
+  if (isDirtyTextures_ && usesSet(kBindPoint_CombinedImageSamplers)) {
+    if (immutableSamplersLayout_) {
+      // descriptor sets ignore the immutable samplers; descriptor buffers need them
+      BindingsTextures bindings = bindingsTextures_;
+      for (uint32_t i = 0; i != IGL_TEXTURE_SAMPLERS_MAX; i++) {
+        if (immutableSamplersLayout_->samplers[i]) {
+          bindings.samplers[i] = immutableSamplersLayout_->samplers[i];
+        }
+      }
+      ctx_.updateBindingsTextures(cmdBuffer_,
+                                  dsets_,
+                                  bindPoint_,
+                                  getVkPipelineLayout(),
+                                  *immutableSamplersLayout_->dslTextures,
+                                  bindings);
+    } else {
+      ctx_.updateBindingsTextures(cmdBuffer_,
+                                  dsets_,
+                                  bindPoint_,
+                                  getVkPipelineLayout(),
+                                  *ctx_.dslCombinedImageSamplers_,
+                                  bindingsTextures_);
+    }
     isDirtyTextures_ = false;
+    dsetTextures_ = VK_NULL_HANDLE;
   }
-  if (isDirtyUniformBuffers_) {
-    ctx_.updateBindingsUniformBuffers(cmdBuffer_, bindPoint_, bindingsUniformBuffers_);
-    isDirtyUniformBuffers_ = false;
+  if (usesSet(kBindPoint_BuffersUniform)) {
+    if (isDirtyUniformBuffers_) {
+      dsetUniformBuffers_ = ctx_.updateBindingsUniformBuffers(
+          cmdBuffer_, dsets_, bindPoint_, getVkPipelineLayout(), bindingsUniformBuffers_);
+      isDirtyUniformBuffers_ = false;
+      isDirtyDynamicOffsets_ = false;
+    } else if (isDirtyDynamicOffsets_) {
+      // same descriptors, only the dynamic offsets changed
+      IGL_ASSERT(dsetUniformBuffers_ != VK_NULL_HANDLE);
+      ctx_.bindDynamicUniformBufferOffsets(cmdBuffer_,
+                                           bindPoint_,
+                                           getVkPipelineLayout(),
+                                           dsetUniformBuffers_,
+                                           bindingsUniformBuffers_);
+      isDirtyDynamicOffsets_ = false;
+    }
   }
-  if (isDirtyStorageBuffers_) {
-    ctx_.updateBindingsStorageBuffers(cmdBuffer_, bindPoint_, bindingsStorageBuffers_);
+  if (isDirtyStorageBuffers_ && usesSet(kBindPoint_BuffersStorage)) {
+    ctx_.updateBindingsStorageBuffers(
+        cmdBuffer_, dsets_, bindPoint_, getVkPipelineLayout(), bindingsStorageBuffers_);
     isDirtyStorageBuffers_ = false;
   }
+
+  if (dsets_.descriptorBuffer &&
+      dsets_.descriptorBuffer->getStats().numResizes != numDescriptorBufferResizes_) {
+    // the new descriptor buffer was bound in the middle of the update: bind every set again
+    numDescriptorBufferResizes_ = dsets_.descriptorBuffer->getStats().numResizes;
+    isDirtyTextures_ = true;
+    isDirtyUniformBuffers_ = true;
+    isDirtyStorageBuffers_ = true;
+    if (numInputAttachments_) {
+      ctx_.updateBindingsInputAttachments(cmdBuffer_,
+                                          dsets_,
+                                          getVkPipelineLayout(),
+                                          numInputAttachments_,
+                                          inputAttachments_.data());
+      numDescriptorBufferResizes_ = dsets_.descriptorBuffer->getStats().numResizes;
+    }
+    updateBindings(descriptorSetMask);
+  }
+}
+
+void ResourcesBinder::bindDefaultDescriptorSets() {
+  ctx_.bindDefaultDescriptorSets(cmdBuffer_, dsets_, bindPoint_, getVkPipelineLayout());
+}
+
+void ResourcesBinder::bindImmutableSamplersLayout(const ImmutableSamplersLayout* layout) {
+  if (immutableSamplersLayout_ == layout) {
+    return;
+  }
+
+  immutableSamplersLayout_ = layout;
+
+  // pipeline layouts with different set layouts of textures are not compatible for any set
+  isDirtyTextures_ = true;
+  dsetTextures_ = VK_NULL_HANDLE;
+  isDirtyUniformBuffers_ = true;
+  isDirtyStorageBuffers_ = true;
+  bindDefaultDescriptorSets();
+  if (numInputAttachments_) {
+    ctx_.updateBindingsInputAttachments(
+        cmdBuffer_, dsets_, getVkPipelineLayout(), numInputAttachments_, inputAttachments_.data());
+  }
 }
 
 void ResourcesBinder::bindPipeline(VkPipeline pipeline) {
   if (lastPipelineBound_ == pipeline) {
+    if (pipeline != VK_NULL_HANDLE) {
+      ctx_.getFrameStatisticsTracker().add(FrameStatisticsTracker::SkippedCommands);
+    }
     return;
   }
 
@@ -146,6 +379,7 @@ void ResourcesBinder::bindPipeline(VkPipeline pipeline) {
     IGL_LOG_INFO("%p vkCmdBindPipeline(%u, %p)\n", cmdBuffer_, bindPoint_, pipeline);
 #endif // IGL_VULKAN_PRINT_COMMANDS
     vkCmdBindPipeline(cmdBuffer_, bindPoint_, pipeline);
+    ctx_.getFrameStatisticsTracker().add(FrameStatisticsTracker::PipelineBinds);
   }
 }
 
@@ -7,16 +7,20 @@
 
 #pragma once
 
+#include <array>
+
 #include <igl/Buffer.h>
 #include <igl/Common.h>
 #include <igl/Texture.h>
 #include <igl/vulkan/CommandBuffer.h>
+#include <igl/vulkan/VulkanDescriptorSetAllocator.h>
 #include <igl/vulkan/VulkanImmediateCommands.h>
 
 namespace igl {
 namespace vulkan {
 
 class Buffer;
+struct ImmutableSamplersLayout;
 class SamplerState;
 class Texture;
 class VulkanBuffer;
@@ -25,6 +29,11 @@ class VulkanTexture;
 
 struct BindingsBuffers {
   VkDescriptorBufferInfo buffers[IGL_UNIFORM_BLOCKS_BINDING_MAX] = {};
+  // uniform buffers only: the offsets of the VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC slots
+  uint32_t dynamicOffsets[IGL_UNIFORM_BLOCKS_BINDING_MAX] = {};
+  // descriptor buffers only: the device addresses and explicit ranges of `buffers`
+  VkDeviceAddress addresses[IGL_UNIFORM_BLOCKS_BINDING_MAX] = {};
+  VkDeviceSize ranges[IGL_UNIFORM_BLOCKS_BINDING_MAX] = {};
 };
 
 struct BindingsTextures {
@@ -37,14 +46,34 @@ class ResourcesBinder final {
   ResourcesBinder(const std::shared_ptr<CommandBuffer>& commandBuffer,
                   const VulkanContext& ctx,
                   VkPipelineBindPoint bindPoint);
+  // records into an arbitrary command buffer (e.g. a secondary one) using its own descriptor sets
+  ResourcesBinder(VkCommandBuffer cmdBuffer,
+                  VulkanTransientDescriptorSets& dsets,
+                  const VulkanContext& ctx,
+                  VkPipelineBindPoint bindPoint);
 
   void bindUniformBuffer(uint32_t index, igl::vulkan::Buffer* buffer, size_t bufferOffset);
   void bindStorageBuffer(uint32_t index, igl::vulkan::Buffer* buffer, size_t bufferOffset);
+  // copies `data` into the transient uniform arena of the command buffer and binds it as a uniform
+  // buffer; returns false if `length` exceeds the block size of the arena
+  bool bindUniformBytes(uint32_t index, const void* data, size_t length);
   void bindSamplerState(uint32_t index, igl::vulkan::SamplerState* samplerState);
   void bindTexture(uint32_t index, igl::vulkan::Texture* tex);
+  // binds the persistent descriptor set `dset` holding `bindings` (see vulkan::BindGroup); textures
+  // bound afterwards start from `bindings`
+  void bindTexturesDescriptorSet(VkDescriptorSet dset, const BindingsTextures& bindings);
+  // binds the input attachments of the current subpass immediately
+  void bindInputAttachments(uint32_t numViews, const VkImageView* views);
 
-  void updateBindings();
+  // updates only the descriptor sets in `descriptorSetMask`: bindings of the other sets stay dirty
+  // until a pipeline which reads them is used
+  void updateBindings(uint32_t descriptorSetMask = kAllDescriptorSets);
   void bindPipeline(VkPipeline pipeline);
+  // the layouts of the render pipeline used by the next draws, null for those of VulkanContext;
+  // sets bound with another pipeline layout are bound again
+  void bindImmutableSamplersLayout(const ImmutableSamplersLayout* layout);
+  // binds the descriptor sets which do not depend on the bindings; called when an encoder begins
+  void bindDefaultDescriptorSets();
 
  private:
   friend class VulkanContext;
@@ -52,14 +81,31 @@ class ResourcesBinder final {
   bool isGraphics() const {
     return bindPoint_ == VK_PIPELINE_BIND_POINT_GRAPHICS;
   }
+  VkPipelineLayout getVkPipelineLayout() const;
+  void setBufferAddress(BindingsBuffers& bindings,
+                        uint32_t index,
+                        igl::vulkan::Buffer* buffer,
+                        size_t bufferOffset) const;
 
  private:
   const VulkanContext& ctx_;
+  VulkanTransientDescriptorSets& dsets_;
   VkCommandBuffer cmdBuffer_ = VK_NULL_HANDLE;
   VkPipeline lastPipelineBound_ = VK_NULL_HANDLE;
   bool isDirtyTextures_ = true;
+  // the persistent descriptor set of textures bound last, if no texture binding changed since
+  VkDescriptorSet dsetTextures_ = VK_NULL_HANDLE;
   bool isDirtyUniformBuffers_ = true;
+  // only the dynamic offsets of `dsetUniformBuffers_` changed
+  bool isDirtyDynamicOffsets_ = false;
+  VkDescriptorSet dsetUniformBuffers_ = VK_NULL_HANDLE;
   bool isDirtyStorageBuffers_ = true;
+  // descriptor buffers only: a resize of the descriptor buffer unbinds all sets
+  uint32_t numDescriptorBufferResizes_ = 0;
+  const ImmutableSamplersLayout* immutableSamplersLayout_ = nullptr;
+  // kept to be bound again with another pipeline layout or descriptor buffer
+  std::array<VkImageView, IGL_COLOR_ATTACHMENTS_MAX> inputAttachments_ = {};
+  uint32_t numInputAttachments_ = 0;
   BindingsTextures bindingsTextures_;
   BindingsBuffers bindingsUniformBuffers_;
   BindingsBuffers bindingsStorageBuffers_;
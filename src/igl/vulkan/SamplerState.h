@@ -50,6 +50,8 @@ class SamplerState final : public ISamplerState {
   Result create(const SamplerStateDesc& desc);
 
  private:
+  friend class BindGroup;
+  friend class RenderPipelineState;
   friend class ResourcesBinder;
 
   /** @brief The device used to create the resource */
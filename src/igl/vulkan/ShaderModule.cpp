@@ -19,6 +19,25 @@ ShaderModule::ShaderModule(ShaderModuleInfo info,
                            std::shared_ptr<VulkanShaderModule> shaderModule) :
   IShaderModule(std::move(info)), module_(std::move(shaderModule)) {
   IGL_ASSERT(module_);
+
+  // every constant is 32-bit, including bools (VkBool32)
+  const auto& constants = this->info().specializationConstants;
+  specializationEntries_.reserve(constants.size());
+  specializationData_.reserve(constants.size());
+  for (const auto& constant : constants) {
+    specializationEntries_.push_back(VkSpecializationMapEntry{
+        constant.id,
+        static_cast<uint32_t>(specializationData_.size() * sizeof(uint32_t)),
+        sizeof(uint32_t),
+    });
+    specializationData_.push_back(constant.value);
+  }
+  specializationInfo_ = VkSpecializationInfo{
+      static_cast<uint32_t>(specializationEntries_.size()),
+      specializationEntries_.data(),
+      specializationData_.size() * sizeof(uint32_t),
+      specializationData_.data(),
+  };
 }
 
 VkShaderModule ShaderModule::getVkShaderModule(const std::shared_ptr<IShaderModule>& shaderModule) {
@@ -29,6 +48,21 @@ VkShaderModule ShaderModule::getVkShaderModule(const std::shared_ptr<IShaderModu
   return sm ? sm->module_->getVkShaderModule() : VK_NULL_HANDLE;
 }
 
+uint32_t ShaderModule::getDescriptorSetMask(const std::shared_ptr<IShaderModule>& shaderModule) {
+  const ShaderModule* sm = static_cast<ShaderModule*>(shaderModule.get());
+  // @fb-only
+  // @lint-ignore CLANGTIDY
+  return sm ? sm->module_->getDescriptorSetMask() : 0;
+}
+
+const VkSpecializationInfo* ShaderModule::getVkSpecializationInfo(
+    const std::shared_ptr<IShaderModule>& shaderModule) {
+  const ShaderModule* sm = static_cast<ShaderModule*>(shaderModule.get());
+  // @fb-only
+  // @lint-ignore CLANGTIDY
+  return sm && !sm->specializationEntries_.empty() ? &sm->specializationInfo_ : nullptr;
+}
+
 ShaderStages::ShaderStages(ShaderStagesDesc desc) : IShaderStages(std::move(desc)) {}
 
 ShaderLibrary::ShaderLibrary(std::vector<std::shared_ptr<IShaderModule>> modules) :
@@ -24,9 +24,18 @@ class ShaderModule final : public IShaderModule {
   ~ShaderModule() override = default;
 
   static VkShaderModule getVkShaderModule(const std::shared_ptr<IShaderModule>& shaderModule);
+  // the descriptor sets read by the module; 0 for a null module
+  static uint32_t getDescriptorSetMask(const std::shared_ptr<IShaderModule>& shaderModule);
+  // the values of the module's specialization constants, or nullptr if it has none. The returned
+  // structure points into the module
+  static const VkSpecializationInfo* getVkSpecializationInfo(
+      const std::shared_ptr<IShaderModule>& shaderModule);
 
  private:
   std::shared_ptr<VulkanShaderModule> module_;
+  std::vector<VkSpecializationMapEntry> specializationEntries_;
+  std::vector<uint32_t> specializationData_;
+  VkSpecializationInfo specializationInfo_ = {};
 };
 
 class ShaderStages final : public IShaderStages {
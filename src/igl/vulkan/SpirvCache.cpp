@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/SpirvCache.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+constexpr uint32_t kSpirvCacheMagic = 0x53504943; // 'SPIC'
+constexpr uint32_t kSpirvCacheVersion = 1;
+
+struct SpirvCacheFileHeader {
+  uint32_t magic = kSpirvCacheMagic;
+  uint32_t version = kSpirvCacheVersion;
+  uint64_t hash = 0;
+  uint64_t sourceLength = 0;
+  uint64_t numWords = 0;
+};
+
+// 64-bit FNV-1a
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i != size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+std::string getKey(VkShaderStageFlagBits stage, const char* source) {
+  std::string key = std::to_string(static_cast<uint32_t>(stage));
+  key += ':';
+  key += source;
+  return key;
+}
+
+} // namespace
+
+namespace igl {
+namespace vulkan {
+
+SpirvCache::SpirvCache(std::string directory, uint64_t salt) :
+  directory_(std::move(directory)), salt_(salt) {}
+
+uint64_t SpirvCache::getHash(VkShaderStageFlagBits stage, const char* source) const {
+  const uint32_t stageValue = static_cast<uint32_t>(stage);
+  uint64_t hash = fnv1a(&salt_, sizeof(salt_));
+  hash = fnv1a(&stageValue, sizeof(stageValue), hash);
+  return fnv1a(source, strlen(source), hash);
+}
+
+std::string SpirvCache::getFileName(uint64_t hash) const {
+  char name[32] = {};
+  snprintf(name, sizeof(name), "%016" PRIx64 ".spv", hash);
+  std::string path = directory_;
+  if (!path.empty() && path.back() != '/' && path.back() != '\\') {
+    path += '/';
+  }
+  return path + name;
+}
+
+bool SpirvCache::find(VkShaderStageFlagBits stage,
+                      const char* source,
+                      std::vector<uint32_t>& outSPIRV) {
+  IGL_PROFILER_FUNCTION();
+
+  const std::string key = getKey(stage, source);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+      outSPIRV = it->second;
+      return true;
+    }
+  }
+
+  if (directory_.empty()) {
+    return false;
+  }
+
+  if (!load(getHash(stage, source), strlen(source), outSPIRV)) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.emplace(key, outSPIRV);
+
+  return true;
+}
+
+void SpirvCache::insert(VkShaderStageFlagBits stage,
+                        const char* source,
+                        std::vector<uint32_t> spirv) {
+  IGL_PROFILER_FUNCTION();
+
+  if (spirv.empty()) {
+    return;
+  }
+
+  if (!directory_.empty()) {
+    save(getHash(stage, source), strlen(source), spirv);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_[getKey(stage, source)] = std::move(spirv);
+}
+
+size_t SpirvCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_.size();
+}
+
+bool SpirvCache::load(uint64_t hash, size_t sourceLength, std::vector<uint32_t>& outSPIRV) const {
+  std::ifstream file(getFileName(hash), std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  SpirvCacheFileHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return false;
+  }
+
+  if (header.magic != kSpirvCacheMagic || header.version != kSpirvCacheVersion ||
+      header.hash != hash || header.sourceLength != sourceLength || header.numWords == 0) {
+    return false;
+  }
+
+  std::vector<uint32_t> spirv(header.numWords);
+  if (!file.read(reinterpret_cast<char*>(spirv.data()),
+                 std::streamsize(spirv.size() * sizeof(uint32_t)))) {
+    return false;
+  }
+
+  // SPIR-V magic number
+  if (spirv[0] != 0x07230203) {
+    return false;
+  }
+
+  outSPIRV = std::move(spirv);
+
+  return true;
+}
+
+void SpirvCache::save(uint64_t hash,
+                      size_t sourceLength,
+                      const std::vector<uint32_t>& spirv) const {
+  const std::string fileName = getFileName(hash);
+  const std::string tmpFileName = fileName + ".tmp";
+
+  {
+    std::ofstream file(tmpFileName, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      IGL_LOG_ERROR("Cannot write SPIR-V cache file: %s\n", tmpFileName.c_str());
+      return;
+    }
+    SpirvCacheFileHeader header;
+    header.hash = hash;
+    header.sourceLength = sourceLength;
+    header.numWords = spirv.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(spirv.data()),
+               std::streamsize(spirv.size() * sizeof(uint32_t)));
+    if (!file) {
+      IGL_LOG_ERROR("Cannot write SPIR-V cache file: %s\n", tmpFileName.c_str());
+      return;
+    }
+  }
+
+  std::remove(fileName.c_str());
+  if (std::rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+    IGL_LOG_ERROR("Cannot rename SPIR-V cache file: %s\n", tmpFileName.c_str());
+  }
+}
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+
+namespace igl {
+namespace vulkan {
+
+/**
+ * @brief Caches SPIR-V binaries produced by glslang from GLSL sources.
+ *
+ * The cache is keyed by the final (patched) shader source, the shader stage and a
+ * device-specific salt (glslang resource limits depend on the physical device). Entries live in
+ * memory for the lifetime of the cache and, if a directory is provided, are also persisted there as
+ * one file per shader, so glslang runs once per unique shader across process runs.
+ */
+class SpirvCache final {
+ public:
+  /** @brief `directory` should exist. An empty `directory` disables the on-disk cache */
+  SpirvCache(std::string directory, uint64_t salt);
+
+  /** @brief Returns true and fills `outSPIRV` if the shader is found in memory or on disk */
+  bool find(VkShaderStageFlagBits stage, const char* source, std::vector<uint32_t>& outSPIRV);
+
+  void insert(VkShaderStageFlagBits stage, const char* source, std::vector<uint32_t> spirv);
+
+  size_t size() const;
+
+ private:
+  uint64_t getHash(VkShaderStageFlagBits stage, const char* source) const;
+  std::string getFileName(uint64_t hash) const;
+  bool load(uint64_t hash, size_t sourceLength, std::vector<uint32_t>& outSPIRV) const;
+  void save(uint64_t hash, size_t sourceLength, const std::vector<uint32_t>& spirv) const;
+
+ private:
+  const std::string directory_;
+  const uint64_t salt_ = 0;
+
+  mutable std::mutex mutex_;
+  // the key is the stage and the full source text, so there are no false positives in memory
+  std::unordered_map<std::string, std::vector<uint32_t>> cache_;
+};
+
+} // namespace vulkan
+} // namespace igl
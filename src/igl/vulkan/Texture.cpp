@@ -9,27 +9,55 @@
 #include <igl/vulkan/CommandBuffer.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/Device.h>
+#include <igl/vulkan/Readback.h>
 #include <igl/vulkan/Texture.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanImage.h>
 #include <igl/vulkan/VulkanImageView.h>
+#include <igl/vulkan/VulkanMipmapGenerator.h>
 #include <igl/vulkan/VulkanStagingDevice.h>
 #include <igl/vulkan/VulkanTexture.h>
 
 namespace igl {
 namespace vulkan {
 
+namespace {
+
+// image views either sample the depth or the stencil aspect of depth-stencil images
+VkImageAspectFlags getImageViewAspectFlags(const VulkanImage& image) {
+  VkImageAspectFlags aspect = 0;
+  if (image.isDepthOrStencilFormat_) {
+    if (image.isDepthFormat_) {
+      aspect |= VK_IMAGE_ASPECT_DEPTH_BIT;
+    } else if (image.isStencilFormat_) {
+      aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+  } else {
+    aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+  }
+  return aspect;
+}
+
+} // namespace
+
 Texture::Texture(const igl::vulkan::Device& device, TextureFormat format) :
   ITexture(format), device_(device) {}
 
 Result Texture::create(const TextureDesc& desc) {
+  IGL_PROFILER_FUNCTION();
   desc_ = desc;
 
   const VulkanContext& ctx = device_.getVulkanContext();
 
-  const VkFormat vkFormat = getProperties().isDepthOrStencil()
-                                ? ctx.getClosestDepthStencilFormat(desc_.format)
-                                : textureFormatToVkFormat(desc_.format);
+  VkFormat vkFormat = getProperties().isDepthOrStencil()
+                          ? ctx.getClosestDepthStencilFormat(desc_.format)
+                          : textureFormatToVkFormat(desc_.format);
+  if (!getProperties().isDepthOrStencil()) {
+    uploadFormat_ = ctx.getUploadConversionFormat(desc_.format, &components_);
+    if (uploadFormat_ != TextureFormat::Invalid) {
+      vkFormat = textureFormatToVkFormat(uploadFormat_);
+    }
+  }
 
   const igl::TextureType type = desc_.type;
   if (!IGL_VERIFY(type == TextureType::TwoD || type == TextureType::TwoDArray ||
@@ -54,6 +82,19 @@ Result Texture::create(const TextureDesc& desc) {
     return Result(Result::Code::ArgumentOutOfRange, "Multisampled 3D images are not supported");
   }
 
+  if (getProperties().isMultiPlanar()) {
+    if (type != TextureType::TwoD || desc_.numMipLevels != 1 || desc_.numLayers != 1 ||
+        desc_.numSamples > 1 ||
+        (desc_.usage & ~TextureDesc::TextureUsage(TextureDesc::TextureUsageBits::Sampled))) {
+      return Result(Result::Code::Unsupported,
+                    "YUV textures have to be sampled 2D textures with 1 mip level, layer and "
+                    "sample");
+    }
+    if (ctx.getYcbcrConversion(vkFormat) == VK_NULL_HANDLE) {
+      return Result(Result::Code::Unsupported, "The YUV format cannot be sampled on this device");
+    }
+  }
+
   if (desc.numLayers > 1 && desc.type != TextureType::TwoDArray) {
     return Result{Result::Code::Unsupported,
                   "Array textures are only supported when type is TwoDArray."};
@@ -69,6 +110,12 @@ Result Texture::create(const TextureDesc& desc) {
     IGL_ASSERT_MSG(false, "Texture usage flags are not set");
     desc_.usage = TextureDesc::TextureUsageBits::Sampled;
   }
+  if (uploadFormat_ != TextureFormat::Invalid &&
+      (desc_.usage != TextureDesc::TextureUsageBits::Sampled || desc_.allowFormatViews)) {
+    // the format is only rebuilt by the swizzle of sampled image views
+    return Result(Result::Code::Unsupported,
+                  "Textures whose format is converted on upload can only be sampled");
+  }
   // a simple heuristic to determine proper storage as the storage type is almost never provided by
   // existing IGL clients
   if (desc_.storage == ResourceStorage::Invalid) {
@@ -95,14 +142,45 @@ Result Texture::create(const TextureDesc& desc) {
   if (desc_.usage & TextureDesc::TextureUsageBits::Attachment) {
     usageFlags |= getProperties().isDepthOrStencil() ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
                                                      : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    // color attachments can be read by the next subpasses
+    if (!getProperties().isDepthOrStencil() && ctx.hasInputAttachments()) {
+      usageFlags |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+    }
   }
 
-  // For now, always set this flag so we can read it back
-  usageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  if (desc_.storage == ResourceStorage::Memoryless) {
+    // transient attachments are only accessed within render passes and cannot be read back
+    if (desc_.usage != TextureDesc::TextureUsageBits::Attachment) {
+      return Result(Result::Code::ArgumentInvalid,
+                    "Memoryless textures can only be used as attachments");
+    }
+    usageFlags |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+  } else {
+    // For now, always set this flag so we can read it back
+    usageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  }
+
+  // formats which cannot be blitted generate mipmaps with compute shaders
+  if (desc_.numMipLevels > 1 && desc_.numSamples <= 1 && !getProperties().isDepthOrStencil() &&
+      !(usageFlags & (VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT))) {
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(ctx.getVkPhysicalDevice(), vkFormat, &formatProperties);
+    const VkFormatFeatureFlags features = formatProperties.optimalTilingFeatures;
+    const VkFormatFeatureFlags blitFeatures =
+        VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+    if ((features & blitFeatures) != blitFeatures &&
+        (features & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT)) {
+      usageFlags |= VK_IMAGE_USAGE_STORAGE_BIT;
+    }
+  }
 
   IGL_ASSERT_MSG(usageFlags != 0, "Invalid usage flags");
 
-  const VkMemoryPropertyFlags memFlags = resourceStorageToVkMemoryPropertyFlags(desc_.storage);
+  VkMemoryPropertyFlags memFlags = resourceStorageToVkMemoryPropertyFlags(desc_.storage);
+  if (!ctx.hasLazilyAllocatedMemory_) {
+    // transient attachments still get regular memory on GPUs without lazy allocation
+    memFlags &= ~VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+  }
 
   const std::string debugNameImage =
       !desc_.debugName.empty() ? IGL_FORMAT("Image: {}", desc_.debugName.c_str()) : "";
@@ -139,6 +217,20 @@ Result Texture::create(const TextureDesc& desc) {
     return Result(Result::Code::Unimplemented, "Unimplemented or unsupported texture type.");
   }
 
+  if (desc_.allowFormatViews && !getProperties().isDepthOrStencil()) {
+    createFlags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT;
+  }
+
+#if IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+  // the first upload of every subresource can be written by the CPU without a staging buffer
+  if (ctx.useHostImageCopy_ && desc_.storage != ResourceStorage::Memoryless &&
+      (usageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) && samples == VK_SAMPLE_COUNT_1_BIT &&
+      !getProperties().isDepthOrStencil() && !getProperties().isMultiPlanar() &&
+      ctx.canUseHostImageCopy(vkFormat, imageType, usageFlags, createFlags)) {
+    usageFlags |= VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT;
+  }
+#endif // IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+
   Result result;
   auto image = ctx.createImage(
       imageType,
@@ -152,7 +244,8 @@ Result Texture::create(const TextureDesc& desc) {
       createFlags,
       samples,
       &result,
-      debugNameImage.c_str());
+      debugNameImage.c_str(),
+      desc_.memoryPriority);
   if (!IGL_VERIFY(result.isOk())) {
     return result;
   }
@@ -160,36 +253,106 @@ Result Texture::create(const TextureDesc& desc) {
     return Result(Result::Code::InvalidOperation, "Cannot create VulkanImage");
   }
 
-  VkImageAspectFlags aspect = 0;
-  if (image->isDepthOrStencilFormat_) {
-    if (image->isDepthFormat_) {
-      aspect |= VK_IMAGE_ASPECT_DEPTH_BIT;
-    } else if (image->isStencilFormat_) {
-      aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+  std::shared_ptr<VulkanImageView> imageView =
+      image->createImageView(imageViewType,
+                             vkFormat,
+                             getImageViewAspectFlags(*image),
+                             0,
+                             VK_REMAINING_MIP_LEVELS,
+                             0,
+                             arrayLayerCount,
+                             debugNameImageView.c_str(),
+                             components_);
+
+  if (!IGL_VERIFY(imageView)) {
+    return Result(Result::Code::InvalidOperation, "Cannot create VulkanImageView");
+  }
+
+  texture_ = ctx.createTexture(std::move(image), std::move(imageView));
+
+  return Result();
+}
+
+Result Texture::createView(const Texture& texture,
+                           const TextureViewDesc& desc,
+                           const TextureDesc& viewDesc) {
+  IGL_PROFILER_FUNCTION();
+  const VulkanContext& ctx = device_.getVulkanContext();
+  const VulkanImage& image = texture.getVulkanTexture().getVulkanImage();
+
+  VkFormat vkFormat = texture.getVkFormat();
+  if (viewDesc.format != texture.getFormat()) {
+    if (!texture.desc_.allowFormatViews) {
+      return Result(Result::Code::ArgumentInvalid,
+                    "Format views need textures created with TextureDesc::allowFormatViews");
+    }
+    vkFormat = textureFormatToVkFormat(viewDesc.format);
+    if (image.isStorageImage()) {
+      // the view is bound as a storage image like the texture
+      VkFormatProperties formatProperties;
+      vkGetPhysicalDeviceFormatProperties(ctx.getVkPhysicalDevice(), vkFormat, &formatProperties);
+      if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT)) {
+        return Result(Result::Code::Unsupported,
+                      "Storage textures can only be viewed in formats of storage images");
+      }
     }
-  } else {
-    aspect = VK_IMAGE_ASPECT_COLOR_BIT;
   }
 
-  std::shared_ptr<VulkanImageView> imageView = image->createImageView(imageViewType,
-                                                                      vkFormat,
-                                                                      aspect,
-                                                                      0,
-                                                                      VK_REMAINING_MIP_LEVELS,
-                                                                      0,
-                                                                      arrayLayerCount,
-                                                                      debugNameImageView.c_str());
+  VkImageViewType imageViewType;
+  switch (viewDesc.type) {
+  case TextureType::TwoD:
+    imageViewType = VK_IMAGE_VIEW_TYPE_2D;
+    break;
+  case TextureType::TwoDArray:
+    imageViewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    break;
+  case TextureType::ThreeD:
+    imageViewType = VK_IMAGE_VIEW_TYPE_3D;
+    break;
+  case TextureType::Cube:
+    imageViewType = VK_IMAGE_VIEW_TYPE_CUBE;
+    break;
+  default:
+    IGL_ASSERT_NOT_REACHED();
+    return Result(Result::Code::Unimplemented, "Unimplemented or unsupported texture type.");
+  }
+
+  desc_ = viewDesc;
+  desc_.storage = texture.desc_.storage;
+  desc_.memoryPriority = texture.desc_.memoryPriority;
+  desc_.allowFormatViews = texture.desc_.allowFormatViews;
+  // views of views are relative to the view they are created from
+  baseMipLevel_ = texture.baseMipLevel_ + desc.mipLevel;
+  baseLayer_ = texture.baseLayer_ + desc.layer;
+  viewFormat_ = vkFormat != image.imageFormat_ ? vkFormat : VK_FORMAT_UNDEFINED;
+  uploadFormat_ = texture.uploadFormat_;
+  components_ = texture.components_;
+
+  const std::string debugNameImageView =
+      !desc_.debugName.empty() ? IGL_FORMAT("Image View: {}", desc_.debugName.c_str()) : "";
 
+  std::shared_ptr<VulkanImageView> imageView = image.createImageView(imageViewType,
+                                                                     vkFormat,
+                                                                     getImageViewAspectFlags(image),
+                                                                     baseMipLevel_,
+                                                                     desc.numMipLevels,
+                                                                     baseLayer_,
+                                                                     desc.numLayers,
+                                                                     debugNameImageView.c_str(),
+                                                                     components_);
   if (!IGL_VERIFY(imageView)) {
     return Result(Result::Code::InvalidOperation, "Cannot create VulkanImageView");
   }
 
-  texture_ = ctx.createTexture(std::move(image), std::move(imageView));
+  // the view shares the image, along with its layout tracking, with the texture
+  texture_ = ctx.createTexture(texture.getVulkanTexture().getSharedVulkanImage(),
+                               std::move(imageView));
 
   return Result();
 }
 
 Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t bytesPerRow) const {
+  IGL_PROFILER_FUNCTION();
   if (!data) {
     return igl::Result();
   }
@@ -203,8 +366,12 @@ Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t b
 
   std::vector<uint8_t> linearData;
 
-  const bool isAligned = getProperties().isCompressed() || bytesPerRow == 0 ||
-                         imageRowWidth == bytesPerRow;
+  // formats the device cannot sample are converted while they are written into staging memory
+  const bool isConverted = uploadFormat_ != TextureFormat::Invalid;
+
+  // the planes of YUV data are tightly packed one after another
+  const bool isAligned = getProperties().isCompressed() || getProperties().isMultiPlanar() ||
+                         bytesPerRow == 0 || imageRowWidth == bytesPerRow;
 
   if (!isAligned) {
     linearData.resize(getProperties().getBytesPerRange(range.atLayer(0)));
@@ -238,25 +405,41 @@ Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t b
 
     const VkImageType type = texture_->getVulkanImage().type_;
 
-    if (type == VK_IMAGE_TYPE_3D) {
+    // the CPU writes the data directly or falls back to the staging device
+    const bool isHostCopied =
+        !isConverted &&
+        texture_->getVulkanImage().hostImageData(
+            VkOffset3D{(int32_t)range.x, (int32_t)range.y, (int32_t)range.z},
+            VkExtent3D{(uint32_t)range.width, (uint32_t)range.height, (uint32_t)range.depth},
+            baseMipLevel_ + (uint32_t)range.mipLevel,
+            (uint32_t)range.numMipLevels,
+            type == VK_IMAGE_TYPE_3D ? 0 : baseLayer_ + (uint32_t)range.layer + i,
+            getProperties(),
+            uploadData);
+
+    if (isHostCopied) {
+      // no staging buffer and no command buffer
+    } else if (type == VK_IMAGE_TYPE_3D) {
       ctx.stagingDevice_->imageData3D(
           texture_->getVulkanImage(),
           VkOffset3D{(int32_t)range.x, (int32_t)range.y, (int32_t)range.z},
           VkExtent3D{(uint32_t)range.width, (uint32_t)range.height, (uint32_t)range.depth},
-          getProperties(),
+          getUploadProperties(),
           getVkFormat(),
-          uploadData);
+          uploadData,
+          getFormat());
     } else {
       const VkRect2D imageRegion = ivkGetRect2D(
           (uint32_t)range.x, (uint32_t)range.y, (uint32_t)range.width, (uint32_t)range.height);
       ctx.stagingDevice_->imageData2D(texture_->getVulkanImage(),
                                       imageRegion,
-                                      (uint32_t)range.mipLevel,
+                                      baseMipLevel_ + (uint32_t)range.mipLevel,
                                       (uint32_t)range.numMipLevels,
-                                      (uint32_t)range.layer + i,
-                                      getProperties(),
+                                      baseLayer_ + (uint32_t)range.layer + i,
+                                      getUploadProperties(),
                                       getVkFormat(),
-                                      uploadData);
+                                      uploadData,
+                                      getFormat());
     }
 
     data = static_cast<const uint8_t*>(data) + byteIncrement;
@@ -265,26 +448,53 @@ Result Texture::upload(const TextureRangeDesc& range, const void* data, size_t b
   return Result();
 }
 
+Result Texture::uploadRegions(const std::vector<TextureRegionUpload>& regions) const {
+  IGL_PROFILER_FUNCTION();
+
+  // all the regions go through the staging device into one command buffer and one submit
+  VulkanStagingDevice& stagingDevice = *device_.getVulkanContext().stagingDevice_;
+  stagingDevice.beginBatch();
+  const auto result = ITexture::uploadRegions(regions);
+  stagingDevice.endBatch();
+
+  return result;
+}
+
 Result Texture::uploadCube(const TextureRangeDesc& range,
                            TextureCubeFace face,
                            const void* data,
                            size_t bytesPerRow) const {
+  IGL_PROFILER_FUNCTION();
   const auto result = validateRange(range);
   if (!result.isOk()) {
     return result;
   }
 
   const VulkanContext& ctx = device_.getVulkanContext();
+  const uint32_t layer = baseLayer_ + (uint32_t)face - (uint32_t)TextureCubeFace::PosX;
+  const uint32_t mipLevel = baseMipLevel_ + (uint32_t)range.mipLevel;
+  if (uploadFormat_ == TextureFormat::Invalid &&
+      texture_->getVulkanImage().hostImageData(
+          VkOffset3D{(int32_t)range.x, (int32_t)range.y, 0},
+          VkExtent3D{(uint32_t)range.width, (uint32_t)range.height, 1},
+          mipLevel,
+          (uint32_t)range.numMipLevels,
+          layer,
+          getProperties(),
+          data)) {
+    return Result();
+  }
   const VkRect2D imageRegion = ivkGetRect2D(
       (uint32_t)range.x, (uint32_t)range.y, (uint32_t)range.width, (uint32_t)range.height);
   ctx.stagingDevice_->imageData2D(texture_->getVulkanImage(),
                                   imageRegion,
-                                  (uint32_t)range.mipLevel,
+                                  mipLevel,
                                   (uint32_t)range.numMipLevels,
-                                  (uint32_t)face - (uint32_t)TextureCubeFace::PosX,
-                                  getProperties(),
+                                  layer,
+                                  getUploadProperties(),
                                   getVkFormat(),
-                                  data);
+                                  data,
+                                  getFormat());
   return Result();
 }
 
@@ -292,8 +502,17 @@ Dimensions Texture::getDimensions() const {
   return Dimensions{desc_.width, desc_.height, desc_.depth};
 }
 
+TextureFormatProperties Texture::getUploadProperties() const {
+  return uploadFormat_ != TextureFormat::Invalid
+             ? TextureFormatProperties::fromTextureFormat(uploadFormat_)
+             : getProperties();
+}
+
 VkFormat Texture::getVkFormat() const {
   IGL_ASSERT(texture_);
+  if (viewFormat_ != VK_FORMAT_UNDEFINED) {
+    return viewFormat_;
+  }
   return texture_ ? texture_->getVulkanImage().imageFormat_ : VK_FORMAT_UNDEFINED;
 }
 
@@ -320,15 +539,38 @@ uint32_t Texture::getNumMipLevels() const {
 void Texture::generateMipmap(ICommandQueue& /*cmdQueue*/) const {
   if (desc_.numMipLevels > 1) {
     const auto& ctx = device_.getVulkanContext();
+    ctx.stagingDevice_->submitPendingUploads(*ctx.immediate_);
     const auto& wrapper = ctx.immediate_->acquire();
-    texture_->getVulkanImage().generateMipmap(wrapper.cmdBuf_);
+    generateMipmap(wrapper.cmdBuf_);
     ctx.immediate_->submit(wrapper);
   }
 }
 
 void Texture::generateMipmap(ICommandBuffer& cmdBuffer) const {
   auto& vkCmdBuffer = static_cast<vulkan::CommandBuffer&>(cmdBuffer);
-  texture_->getVulkanImage().generateMipmap(vkCmdBuffer.getVkCommandBuffer());
+  generateMipmap(vkCmdBuffer.getVkCommandBuffer());
+}
+
+void Texture::generateMipmap(VkCommandBuffer cmdBuf) const {
+  IGL_PROFILER_FUNCTION();
+  IGL_PROFILER_ZONE_GPU_VK(
+      "generateMipmap", device_.getVulkanContext().getTracyContext(), cmdBuf);
+  const VulkanImage& image = texture_->getVulkanImage();
+  if (baseMipLevel_ != 0 || desc_.numMipLevels != image.mipLevels_) {
+    IGL_ASSERT_MSG(false, "Texture views of a part of the mip chain cannot generate mipmaps");
+    return;
+  }
+  const VulkanMipmapGenerator& generator = device_.getVulkanContext().getMipmapGenerator();
+  if (generator.isSupported(image)) {
+    if (!mipmapBindings_) {
+      mipmapBindings_ = generator.createBindings(image);
+    }
+    if (mipmapBindings_) {
+      generator.generate(cmdBuf, image, *mipmapBindings_);
+      return;
+    }
+  }
+  image.generateMipmap(cmdBuf);
 }
 
 bool Texture::isRequiredGenerateMipmap() const {
@@ -346,6 +588,55 @@ uint64_t Texture::getTextureId() const {
   return texture_ && config.enableDescriptorIndexing ? texture_->getTextureId() : 0;
 }
 
+std::shared_ptr<IReadback> Texture::readAsync(ICommandQueue& /*cmdQueue*/,
+                                              const TextureRangeDesc& range,
+                                              Result* outResult) const {
+  IGL_PROFILER_FUNCTION();
+
+  const auto rangeResult = validateRange(range);
+  if (!rangeResult.isOk()) {
+    Result::setResult(outResult, rangeResult);
+    return nullptr;
+  }
+  if (range.numLayers != 1 || range.numMipLevels != 1 || range.depth != 1) {
+    Result::setResult(outResult,
+                      Result::Code::ArgumentInvalid,
+                      "Readbacks cover one 2D region of one layer and mip level");
+    return nullptr;
+  }
+  if (getProperties().isDepthOrStencil() || getProperties().isMultiPlanar() ||
+      desc_.storage == ResourceStorage::Memoryless || uploadFormat_ != TextureFormat::Invalid) {
+    Result::setResult(outResult, Result::Code::Unsupported, "The texture cannot be read back");
+    return nullptr;
+  }
+  const VkImageLayout layout = texture_->getVulkanImage().imageLayout_;
+  if (layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+    Result::setResult(outResult, Result::Code::InvalidOperation, "The texture has no contents");
+    return nullptr;
+  }
+
+  const VkRect2D imageRegion = {
+      VkOffset2D{static_cast<int32_t>(range.x), static_cast<int32_t>(range.y)},
+      VkExtent2D{static_cast<uint32_t>(range.width), static_cast<uint32_t>(range.height)},
+  };
+  const VulkanContext& ctx = device_.getVulkanContext();
+  const uint64_t readbackId =
+      ctx.stagingDevice_->getImageData2DAsync(getVkImage(),
+                                              baseMipLevel_ + static_cast<uint32_t>(range.mipLevel),
+                                              baseLayer_ + static_cast<uint32_t>(range.layer),
+                                              imageRegion,
+                                              getProperties(),
+                                              layout,
+                                              false);
+  if (readbackId == 0) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot allocate a readback buffer");
+    return nullptr;
+  }
+
+  Result::setOk(outResult);
+  return std::make_shared<Readback>(ctx, readbackId, getProperties().getBytesPerRange(range));
+}
+
 VkImageView Texture::getVkImageView() const {
   return texture_ ? texture_->getVulkanImageView().vkImageView_ : VK_NULL_HANDLE;
 }
@@ -366,9 +657,9 @@ VkImageView Texture::getVkImageViewForFramebuffer(uint32_t level, FramebufferMod
       isStereo ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D,
       textureFormatToVkFormat(desc_.format),
       flags,
-      level,
+      baseMipLevel_ + level,
       1u,
-      0u,
+      baseLayer_,
       isStereo ? VK_REMAINING_ARRAY_LAYERS : 1u);
 
   return imageViewForFramebuffer_[level]->vkImageView_;
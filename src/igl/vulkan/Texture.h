@@ -11,6 +11,7 @@
 #include <igl/Framebuffer.h>
 #include <igl/Texture.h>
 #include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanMipmapGenerator.h>
 
 #include <vector>
 
@@ -44,6 +45,7 @@ class Texture final : public ITexture {
                     TextureCubeFace face,
                     const void* data,
                     size_t bytesPerRow = 0) const override;
+  Result uploadRegions(const std::vector<TextureRegionUpload>& regions) const override;
 
   // Accessors
   Dimensions getDimensions() const override;
@@ -56,6 +58,9 @@ class Texture final : public ITexture {
   void generateMipmap(ICommandBuffer& cmdBuffer) const override;
   bool isRequiredGenerateMipmap() const override;
   uint64_t getTextureId() const override;
+  std::shared_ptr<IReadback> readAsync(ICommandQueue& cmdQueue,
+                                       const TextureRangeDesc& range,
+                                       Result* outResult) const override;
   VkFormat getVkFormat() const;
 
   VkImageView getVkImageView() const;
@@ -70,15 +75,41 @@ class Texture final : public ITexture {
 
   bool isSwapchainTexture() const;
 
+  // the first mip level and layer of the image covered by the texture, which are not 0 only for
+  // texture views
+  uint32_t getBaseMipLevel() const {
+    return baseMipLevel_;
+  }
+  uint32_t getBaseLayer() const {
+    return baseLayer_;
+  }
+
  private:
   Result create(const TextureDesc& desc);
+  // `viewDesc` is the descriptor returned by ITexture::validateView()
+  Result createView(const Texture& texture,
+                    const TextureViewDesc& desc,
+                    const TextureDesc& viewDesc);
+  // uses a single compute dispatch when the image supports it, otherwise a chain of blits
+  void generateMipmap(VkCommandBuffer cmdBuf) const;
+  // the properties of the format the image stores
+  TextureFormatProperties getUploadProperties() const;
 
  protected:
   const igl::vulkan::Device& device_;
   TextureDesc desc_;
 
   std::shared_ptr<VulkanTexture> texture_;
+  uint32_t baseMipLevel_ = 0;
+  uint32_t baseLayer_ = 0;
+  // the format of views which reinterpret the image in another format
+  VkFormat viewFormat_ = VK_FORMAT_UNDEFINED;
+  // the format the image stores when the device cannot sample the format of the texture, see
+  // VulkanContext::getUploadConversionFormat()
+  TextureFormat uploadFormat_ = TextureFormat::Invalid;
+  VkComponentMapping components_ = {};
   mutable std::vector<std::shared_ptr<VulkanImageView>> imageViewForFramebuffer_;
+  mutable std::unique_ptr<VulkanMipmapGenerator::Bindings> mipmapBindings_;
 };
 
 } // namespace vulkan
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/TimestampQueryPool.h>
+
+#include <igl/vulkan/VulkanContext.h>
+#include <vector>
+
+namespace igl {
+namespace vulkan {
+
+TimestampQueryPool::TimestampQueryPool(const VulkanContext& ctx,
+                                       const TimestampQueryPoolDesc& desc) :
+  ctx_(ctx),
+  device_(ctx.getVkDevice()),
+  count_(desc.count),
+  timestampPeriod_(ctx.getVkPhysicalDeviceProperties().limits.timestampPeriod) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  // timestamps are written into command buffers submitted to the graphics queue
+  uint32_t queueFamilyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(ctx.getVkPhysicalDevice(), &queueFamilyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> properties(queueFamilyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(
+      ctx.getVkPhysicalDevice(), &queueFamilyCount, properties.data());
+  const uint32_t familyIndex = ctx.deviceQueues_.graphicsQueueFamilyIndex;
+  IGL_ASSERT(familyIndex < queueFamilyCount);
+  const uint32_t validBits =
+      familyIndex < queueFamilyCount ? properties[familyIndex].timestampValidBits : 64;
+  IGL_ASSERT_MSG(validBits != 0, "The graphics queue does not support timestamps");
+  timestampMask_ = validBits >= 64 ? ~uint64_t(0) : (uint64_t(1) << validBits) - 1;
+
+  VkQueryPoolCreateInfo ci = {};
+  ci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  ci.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  ci.queryCount = count_;
+  VK_ASSERT(vkCreateQueryPool(device_, &ci, nullptr, &vkQueryPool_));
+  VK_ASSERT(ivkSetDebugObjectName(
+      device_, VK_OBJECT_TYPE_QUERY_POOL, (uint64_t)vkQueryPool_, desc.debugName.c_str()));
+}
+
+TimestampQueryPool::~TimestampQueryPool() {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
+
+  ctx_.deferredTask(std::packaged_task<void()>([device = device_, pool = vkQueryPool_]() {
+    vkDestroyQueryPool(device, pool, nullptr);
+  }));
+}
+
+void TimestampQueryPool::writeTimestamp(VkCommandBuffer cmdBuf, uint32_t queryIndex) const {
+  IGL_ASSERT(queryIndex < count_);
+
+  vkCmdResetQueryPool(cmdBuf, vkQueryPool_, queryIndex, 1);
+  vkCmdWriteTimestamp(cmdBuf, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, vkQueryPool_, queryIndex);
+}
+
+bool TimestampQueryPool::getResults(uint32_t firstQuery,
+                                    uint32_t queryCount,
+                                    uint64_t* outTimestampsNs) {
+  if (!IGL_VERIFY(static_cast<uint64_t>(firstQuery) + queryCount <= count_) ||
+      !IGL_VERIFY(outTimestampsNs != nullptr)) {
+    return false;
+  }
+  if (queryCount == 0) {
+    return true;
+  }
+
+  // No VK_QUERY_RESULT_WAIT_BIT: VK_NOT_READY is returned while any of the queries is pending
+  const VkResult result = vkGetQueryPoolResults(device_,
+                                                vkQueryPool_,
+                                                firstQuery,
+                                                queryCount,
+                                                queryCount * sizeof(uint64_t),
+                                                outTimestampsNs,
+                                                sizeof(uint64_t),
+                                                VK_QUERY_RESULT_64_BIT);
+  if (result != VK_SUCCESS) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < queryCount; ++i) {
+    outTimestampsNs[i] =
+        static_cast<uint64_t>(static_cast<double>(outTimestampsNs[i] & timestampMask_) *
+                              timestampPeriod_);
+  }
+  return true;
+}
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <igl/TimestampQueryPool.h>
+#include <igl/vulkan/Common.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanContext;
+
+/**
+ * @brief Encapsulates a VkQueryPool of type VK_QUERY_TYPE_TIMESTAMP. Timestamps are written with
+ * vkCmdWriteTimestamp(), masked to the timestampValidBits of the graphics queue family and
+ * converted to nanoseconds using the physical device's timestampPeriod
+ */
+class TimestampQueryPool final : public ITimestampQueryPool {
+ public:
+  TimestampQueryPool(const VulkanContext& ctx, const TimestampQueryPoolDesc& desc);
+  ~TimestampQueryPool() override;
+
+  TimestampQueryPool(const TimestampQueryPool&) = delete;
+  TimestampQueryPool& operator=(const TimestampQueryPool&) = delete;
+
+  [[nodiscard]] uint32_t getCount() const override {
+    return count_;
+  }
+  bool getResults(uint32_t firstQuery, uint32_t queryCount, uint64_t* outTimestampsNs) override;
+
+  /**
+   * @brief Records the commands resetting and writing the timestamp `queryIndex` into `cmdBuf`.
+   * Must be recorded outside of a render pass
+   */
+  void writeTimestamp(VkCommandBuffer cmdBuf, uint32_t queryIndex) const;
+
+  VkQueryPool getVkQueryPool() const {
+    return vkQueryPool_;
+  }
+
+ private:
+  const VulkanContext& ctx_;
+  VkDevice device_ = VK_NULL_HANDLE;
+  VkQueryPool vkQueryPool_ = VK_NULL_HANDLE;
+  uint32_t count_ = 0;
+  // Nanoseconds per timestamp tick
+  double timestampPeriod_ = 1.0;
+  // The bits above the queue family's timestampValidBits are undefined
+  uint64_t timestampMask_ = ~uint64_t(0);
+};
+
+} // namespace vulkan
+} // namespace igl
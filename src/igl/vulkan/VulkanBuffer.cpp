@@ -8,6 +8,7 @@
 #include <igl/IGLSafeC.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDefragmenter.h>
 
 #include "VulkanBuffer.h"
 
@@ -19,14 +20,21 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
                            VkDeviceSize bufferSize,
                            VkBufferUsageFlags usageFlags,
                            VkMemoryPropertyFlags memFlags,
-                           const char* debugName) :
-  ctx_(ctx), device_(device), bufferSize_(bufferSize), memFlags_(memFlags) {
+                           const char* debugName,
+                           float memoryPriority) :
+  ctx_(ctx),
+  device_(device),
+  bufferSize_(bufferSize),
+  usageFlags_(usageFlags),
+  memFlags_(memFlags),
+  debugName_(debugName ? debugName : "") {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
 
   IGL_ASSERT(bufferSize > 0);
 
   // Initialize Buffer Info
-  const VkBufferCreateInfo ci = ivkGetBufferCreateInfo(bufferSize, usageFlags);
+  VkBufferCreateInfo ci = ivkGetBufferCreateInfo(bufferSize, usageFlags);
+  ctx_.setSharingMode(ci.sharingMode, ci.queueFamilyIndexCount, ci.pQueueFamilyIndices);
 
   if (IGL_VULKAN_USE_VMA) {
     // Initialize VmaAllocation Info
@@ -53,6 +61,8 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
     }
 
     vmaAllocInfo_.usage = VMA_MEMORY_USAGE_AUTO;
+    // used only if VK_EXT_memory_priority is enabled
+    vmaAllocInfo_.priority = memoryPriority;
 
     vmaCreateBuffer((VmaAllocator)ctx_.getVmaAllocator(),
                     &ci,
@@ -114,10 +124,15 @@ VulkanBuffer::~VulkanBuffer() {
     if (mappedPtr_) {
       vmaUnmapMemory((VmaAllocator)ctx_.getVmaAllocator(), vmaAllocation_);
     }
-    ctx_.deferredTask(std::packaged_task<void()>(
-        [vma = ctx_.getVmaAllocator(), buffer = vkBuffer_, allocation = vmaAllocation_]() {
-          vmaDestroyBuffer((VmaAllocator)vma, buffer, allocation);
-        }));
+    if (isMovable_) {
+      // a pass cannot swap the VkBuffer after this
+      ctx_.defragmenter_->unregisterBuffer(*this);
+    }
+    ctx_.deferredTask(std::packaged_task<void()>([defragmenter = ctx_.defragmenter_.get(),
+                                                  buffer = vkBuffer_,
+                                                  allocation = vmaAllocation_]() {
+      defragmenter->destroyBuffer(buffer, allocation);
+    }));
   } else {
     if (mappedPtr_) {
       vkUnmapMemory(device_, vkMemory_);
@@ -130,6 +145,16 @@ VulkanBuffer::~VulkanBuffer() {
   }
 }
 
+void VulkanBuffer::allowDefragmentation() {
+  if (!IGL_VULKAN_USE_VMA || isMovable_ || mappedPtr_ || vkDeviceAddress_ ||
+      !(memFlags_ & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) ||
+      !(usageFlags_ & VK_BUFFER_USAGE_TRANSFER_SRC_BIT)) {
+    return;
+  }
+  isMovable_ = true;
+  ctx_.defragmenter_->registerBuffer(*this);
+}
+
 void VulkanBuffer::flushMappedMemory(VkDeviceSize offset, VkDeviceSize size) const {
   if (!IGL_VERIFY(isMapped())) {
     return;
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanHelpers.h>
@@ -16,6 +17,7 @@ namespace igl {
 namespace vulkan {
 
 class VulkanContext;
+class VulkanDefragmenter;
 
 class VulkanBuffer {
  public:
@@ -24,7 +26,8 @@ class VulkanBuffer {
                VkDeviceSize bufferSize,
                VkBufferUsageFlags usageFlags,
                VkMemoryPropertyFlags memFlags,
-               const char* debugName = nullptr);
+               const char* debugName = nullptr,
+               float memoryPriority = 0.5f);
   ~VulkanBuffer();
 
   VulkanBuffer(const VulkanBuffer&) = delete;
@@ -55,8 +58,13 @@ class VulkanBuffer {
   [[nodiscard]] bool isCoherentMemory() const {
     return isCoherentMemory_;
   }
+  // lets VulkanDefragmenter move this buffer if it is device-local, not mapped and has no device
+  // address. The VkBuffer changes then, so it must not be cached across frames
+  void allowDefragmentation();
 
  private:
+  friend class VulkanDefragmenter;
+
   const VulkanContext& ctx_;
   VkDevice device_ = VK_NULL_HANDLE;
   VkBuffer vkBuffer_ = VK_NULL_HANDLE;
@@ -65,9 +73,12 @@ class VulkanBuffer {
   VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
   VkDeviceAddress vkDeviceAddress_ = 0;
   VkDeviceSize bufferSize_ = 0;
+  VkBufferUsageFlags usageFlags_ = 0;
   VkMemoryPropertyFlags memFlags_ = 0;
   void* mappedPtr_ = nullptr;
   bool isCoherentMemory_ = false;
+  bool isMovable_ = false;
+  std::string debugName_;
 };
 
 } // namespace vulkan
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanBufferPool.h>
+
+#include <algorithm>
+#include <string>
+
+#include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDevice.h>
+
+namespace igl {
+namespace vulkan {
+
+VulkanBufferPool::VulkanBufferPool(const VulkanContext& ctx, VkDeviceSize blockSize) :
+  ctx_(ctx), blockSize_(blockSize) {
+  const VkPhysicalDeviceLimits& limits = ctx_.getVkPhysicalDeviceProperties().limits;
+  alignment_ = std::max({alignment_,
+                         limits.minUniformBufferOffsetAlignment,
+                         limits.minStorageBufferOffsetAlignment,
+                         limits.nonCoherentAtomSize});
+}
+
+VulkanBufferPool::~VulkanBufferPool() {
+  for (const auto& block : blocks_) {
+    IGL_ASSERT_MSG(block->numAllocations == 0, "A pooled buffer outlives its pool");
+    vmaDestroyVirtualBlock(block->virtualBlock);
+  }
+}
+
+bool VulkanBufferPool::allocate(VkDeviceSize size,
+                                VkBufferUsageFlags usageFlags,
+                                VkMemoryPropertyFlags memFlags,
+                                Allocation& outAllocation) {
+  IGL_PROFILER_FUNCTION();
+
+  if (size == 0 || size > blockSize_) {
+    return false;
+  }
+
+  const std::lock_guard<std::mutex> lock(mutex_);
+
+  releaseEmptyBlocks();
+
+  VmaVirtualAllocationCreateInfo ci = {};
+  ci.size = size;
+  ci.alignment = alignment_;
+
+  for (const auto& block : blocks_) {
+    if (block->usageFlags != usageFlags || block->memFlags != memFlags) {
+      continue;
+    }
+    if (vmaVirtualAllocate(
+            block->virtualBlock, &ci, &outAllocation.allocation, &outAllocation.offset) ==
+        VK_SUCCESS) {
+      outAllocation.buffer = block->buffer;
+      outAllocation.blockId = block->id;
+      block->numAllocations++;
+      return true;
+    }
+  }
+
+  // all blocks with these flags are full
+  auto block = std::make_unique<Block>();
+  block->id = nextBlockId_++;
+  block->usageFlags = usageFlags;
+  block->memFlags = memFlags;
+  const std::string debugName = "Buffer: pool block " + std::to_string(block->id);
+  block->buffer = std::make_shared<VulkanBuffer>(
+      ctx_, ctx_.device_->getVkDevice(), blockSize_, usageFlags, memFlags, debugName.c_str());
+  if (ctx_.config_.defragmentationMaxBytesPerFrame) {
+    block->buffer->allowDefragmentation();
+  }
+
+  VmaVirtualBlockCreateInfo blockCreateInfo = {};
+  blockCreateInfo.size = blockSize_;
+  if (vmaCreateVirtualBlock(&blockCreateInfo, &block->virtualBlock) != VK_SUCCESS) {
+    return false;
+  }
+  if (!IGL_VERIFY(vmaVirtualAllocate(block->virtualBlock,
+                                     &ci,
+                                     &outAllocation.allocation,
+                                     &outAllocation.offset) == VK_SUCCESS)) {
+    vmaDestroyVirtualBlock(block->virtualBlock);
+    return false;
+  }
+  outAllocation.buffer = block->buffer;
+  outAllocation.blockId = block->id;
+  block->numAllocations++;
+  blocks_.push_back(std::move(block));
+
+  return true;
+}
+
+void VulkanBufferPool::free(const Allocation& allocation) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+
+  const auto it = std::find_if(blocks_.begin(), blocks_.end(), [&allocation](const auto& block) {
+    return block->id == allocation.blockId;
+  });
+  if (!IGL_VERIFY(it != blocks_.end())) {
+    return;
+  }
+  Block& block = **it;
+  vmaVirtualFree(block.virtualBlock, allocation.allocation);
+  IGL_ASSERT(block.numAllocations > 0);
+  block.numAllocations--;
+}
+
+void VulkanBufferPool::releaseEmptyBlocks() {
+  // keep one empty block per combination of flags, so a buffer which is created and destroyed
+  // every frame does not create a VkBuffer every time
+  for (auto it = blocks_.begin(); it != blocks_.end();) {
+    const Block& block = **it;
+    const bool hasOtherBlock =
+        block.numAllocations == 0 &&
+        std::any_of(blocks_.begin(), blocks_.end(), [&block](const auto& other) {
+          return other.get() != &block && other->usageFlags == block.usageFlags &&
+                 other->memFlags == block.memFlags;
+        });
+    if (hasOtherBlock) {
+      vmaDestroyVirtualBlock(block.virtualBlock);
+      it = blocks_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+uint32_t VulkanBufferPool::getNumBlocks() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<uint32_t>(blocks_.size());
+}
+
+} // namespace vulkan
+} // namespace igl
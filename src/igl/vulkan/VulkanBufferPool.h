@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanHelpers.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanBuffer;
+class VulkanContext;
+
+/**
+ * @brief Sub-allocates small buffers from large shared VkBuffers ("blocks").
+ *
+ * Each block is a VulkanBuffer whose range is managed by a VMA virtual block. Blocks are created
+ * on demand for every combination of usage and memory flags. Sub-allocations are aligned to the
+ * strictest offset alignment of uniform and storage buffers, so they can be bound as descriptors,
+ * vertex, index and indirect buffers with their offset, and their device addresses are valid.
+ *
+ * free() releases the range immediately: callers defer it until the GPU no longer uses it. Empty
+ * blocks are kept until the next allocate(), which releases all but one per combination of flags.
+ */
+class VulkanBufferPool final {
+ public:
+  struct Allocation {
+    std::shared_ptr<VulkanBuffer> buffer;
+    VkDeviceSize offset = 0;
+    VmaVirtualAllocation allocation = VK_NULL_HANDLE;
+    uint32_t blockId = 0;
+  };
+
+  VulkanBufferPool(const VulkanContext& ctx, VkDeviceSize blockSize);
+  ~VulkanBufferPool();
+
+  VulkanBufferPool(const VulkanBufferPool&) = delete;
+  VulkanBufferPool& operator=(const VulkanBufferPool&) = delete;
+
+  // Returns false if `size` does not fit into a block or no block could be created
+  bool allocate(VkDeviceSize size,
+                VkBufferUsageFlags usageFlags,
+                VkMemoryPropertyFlags memFlags,
+                Allocation& outAllocation);
+  void free(const Allocation& allocation);
+
+  [[nodiscard]] VkDeviceSize getBlockSize() const {
+    return blockSize_;
+  }
+  [[nodiscard]] uint32_t getNumBlocks() const;
+
+ private:
+  struct Block {
+    uint32_t id = 0;
+    VkBufferUsageFlags usageFlags = 0;
+    VkMemoryPropertyFlags memFlags = 0;
+    std::shared_ptr<VulkanBuffer> buffer;
+    VmaVirtualBlock virtualBlock = VK_NULL_HANDLE;
+    uint32_t numAllocations = 0;
+  };
+
+  void releaseEmptyBlocks();
+
+ private:
+  const VulkanContext& ctx_;
+  const VkDeviceSize blockSize_;
+  VkDeviceSize alignment_ = 16;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Block>> blocks_;
+  uint32_t nextBlockId_ = 1;
+};
+
+} // namespace vulkan
+} // namespace igl
@@ -5,12 +5,19 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <mutex>
 #include <set>
 #include <vector>
 
 #include <igl/IGLSafeC.h>
+#include <igl/NameHandle.h>
+#include <igl/WorkerPool.h>
 
 // For vk_mem_alloc.h, define this before including VulkanContext.h in exactly
 // one CPP file
@@ -25,12 +32,16 @@
 #include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/Device.h>
 #include <igl/vulkan/EnhancedShaderDebuggingStore.h>
+#include <igl/vulkan/SpirvCache.h>
 #include <igl/vulkan/SyncManager.h>
 #include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanBufferPool.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDefragmenter.h>
 #include <igl/vulkan/VulkanDescriptorSetLayout.h>
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanExtensions.h>
+#include <igl/vulkan/VulkanMipmapGenerator.h>
 #include <igl/vulkan/VulkanPipelineBuilder.h>
 #include <igl/vulkan/VulkanPipelineLayout.h>
 #include <igl/vulkan/VulkanSampler.h>
@@ -45,17 +56,48 @@
 
 namespace {
 
-/*
- * Descriptor sets:
- *  0 - combined image samplers
- *  1 - uniform buffers
- *  2 - storage buffers
- *  3 - bindless textures/samplers  <--  optional
- */
-const uint32_t kBindPoint_CombinedImageSamplers = 0;
-const uint32_t kBindPoint_BuffersUniform = 1;
-const uint32_t kBindPoint_BuffersStorage = 2;
-const uint32_t kBindPoint_Bindless = 3;
+// transient descriptor sets are allocated from linear pools of this size; more pools are created
+// when all of them are in flight. Every command buffer has its own pools
+const uint32_t kNumDescriptorSetsPerPool = 64;
+
+// https://www.khronos.org/registry/vulkan/specs/1.3/html/vkspec.html#features-limits
+// Table 32. Required Limits
+const uint32_t kPushConstantsSize = 128;
+
+// the size of the blocks of transient uniform arenas: also the limit of bindBytes()
+const VkDeviceSize kUniformArenaBlockSize = 64 * 1024;
+
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+// the initial size of the descriptor buffer of every command buffer; it grows when exhausted. Both
+// usages let the same buffer hold combined image samplers and buffer descriptors.
+const VkDeviceSize kDescriptorBufferSize = 256 * 1024;
+const VkBufferUsageFlags kDescriptorBufferUsage =
+    VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+    VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+
+size_t getDescriptorSize(const VkPhysicalDeviceDescriptorBufferPropertiesEXT& props,
+                         VkDescriptorType type) {
+  switch (type) {
+  case VK_DESCRIPTOR_TYPE_SAMPLER:
+    return props.samplerDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+    return props.combinedImageSamplerDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+    return props.sampledImageDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+    return props.storageImageDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+    return props.uniformBufferDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+    return props.storageBufferDescriptorSize;
+  case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+    return props.inputAttachmentDescriptorSize;
+  default:
+    IGL_ASSERT_NOT_REACHED();
+    return 0;
+  }
+}
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
 
 /*
  BINDLESS ONLY: these bindings should match GLSL declarations injected into shaders in
@@ -68,6 +110,34 @@ const uint32_t kBinding_TextureCube = 3;
 const uint32_t kBinding_Sampler = 4;
 const uint32_t kBinding_SamplerShadow = 5;
 const uint32_t kBinding_StorageImages = 6;
+// combined image samplers with immutable YUV samplers; one binding per entry of
+// kYcbcrFormats
+const uint32_t kBinding_TextureYUV = 7;
+
+// multi-planar formats which can be sampled with a VkSamplerYcbcrConversion: SDR video is
+// BT.709 and 10-bit HDR video is BT.2020, both with narrow range
+struct YcbcrFormat {
+  VkFormat format;
+  VkSamplerYcbcrModelConversion model;
+};
+const YcbcrFormat kYcbcrFormats[] = {
+    {VK_FORMAT_G8_B8R8_2PLANE_420_UNORM, VK_SAMPLER_YCBCR_MODEL_CONVERSION_YCBCR_709},
+    {VK_FORMAT_G10X6_B10X6R10X6_2PLANE_420_UNORM_3PACK16,
+     VK_SAMPLER_YCBCR_MODEL_CONVERSION_YCBCR_2020},
+};
+
+// glslang and volk keep process-wide state which is shared by all VulkanContexts
+struct ProcessState {
+  std::mutex mutex;
+  uint32_t numContexts = 0;
+  uint32_t numDevices = 0;
+  // true while volk's device functions are loaded for one specific VkDevice
+  bool volkLoadedDevice = false;
+};
+ProcessState& getProcessState() {
+  static auto& state = *(new ProcessState());
+  return state;
+}
 
 #if defined(VK_EXT_debug_utils) && IGL_PLATFORM_WIN
 VKAPI_ATTR VkBool32 VKAPI_CALL
@@ -84,35 +154,43 @@ vulkanDebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT msgSeverity,
   igl::vulkan::VulkanContext* ctx = static_cast<igl::vulkan::VulkanContext*>(userData);
 
 #if IGL_DEBUG || defined(IGL_FORCE_ENABLE_LOGS)
-  std::array<char, 128> errorName = {};
-  int object = 0;
-  void* handle = nullptr;
-  std::array<char, 128> typeName = {};
-  void* messageID = nullptr;
-
-  if (sscanf(cbData->pMessage,
-             "Validation Error : [ %127s ] Object %i: handle = %p, type = %127s | MessageID = %p",
-             errorName.data(),
-             &object,
-             &handle,
-             typeName.data(),
-             &messageID) >= 2) {
-    const char* message = strrchr(cbData->pMessage, '|') + 1;
-    IGL_LOG_INFO(
-        "%sValidation layer:\n Validation Error: %s \n Object %i: handle = %p, type = %s\n "
-        "MessageID = %p \n%s \n",
-        isError ? "\nERROR:\n" : "",
-        errorName.data(),
-        object,
-        handle,
-        typeName.data(),
-        messageID,
-        message);
-  } else {
-    const bool isWarning = (msgSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) != 0;
+  // some layers report every message with ID 0; tell them apart by name
+  const int32_t messageId =
+      cbData->messageIdNumber != 0 || !cbData->pMessageIdName
+          ? cbData->messageIdNumber
+          : static_cast<int32_t>(igl::iglCrc32(cbData->pMessageIdName,
+                                                strlen(cbData->pMessageIdName)));
+  if (ctx->validationFilter_.shouldLog(messageId, ctx->getFrameNumber())) {
+    std::array<char, 128> errorName = {};
+    int object = 0;
+    void* handle = nullptr;
+    std::array<char, 128> typeName = {};
+    void* messageID = nullptr;
+
+    if (sscanf(cbData->pMessage,
+               "Validation Error : [ %127s ] Object %i: handle = %p, type = %127s | MessageID = %p",
+               errorName.data(),
+               &object,
+               &handle,
+               typeName.data(),
+               &messageID) >= 2) {
+      const char* message = strrchr(cbData->pMessage, '|') + 1;
+      IGL_LOG_INFO(
+          "%sValidation layer:\n Validation Error: %s \n Object %i: handle = %p, type = %s\n "
+          "MessageID = %p \n%s \n",
+          isError ? "\nERROR:\n" : "",
+          errorName.data(),
+          object,
+          handle,
+          typeName.data(),
+          messageID,
+          message);
+    } else {
+      const bool isWarning = (msgSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) != 0;
 
-    if (isError || isWarning || ctx->config_.enableExtraLogs) {
-      IGL_LOG_INFO("%sValidation layer:\n%s\n", isError ? "\nERROR:\n" : "", cbData->pMessage);
+      if (isError || isWarning || ctx->config_.enableExtraLogs) {
+        IGL_LOG_INFO("%sValidation layer:\n%s\n", isError ? "\nERROR:\n" : "", cbData->pMessage);
+      }
     }
   }
 #endif
@@ -201,6 +279,32 @@ bool validateImageLimits(VkImageType imageType,
   return true;
 }
 
+uint32_t getNumPipelinesCreated() {
+  return igl::vulkan::VulkanPipelineBuilder::getNumPipelinesCreated() +
+         igl::vulkan::VulkanComputePipelineBuilder::getNumPipelinesCreated();
+}
+
+// writes all uniform buffer slots of `dset`, where the first `numDynamic` slots are dynamic
+uint32_t getUniformBufferWrites(VkDescriptorSet dset,
+                                uint32_t numDynamic,
+                                const VkDescriptorBufferInfo* buffers,
+                                std::array<VkWriteDescriptorSet, 2>& outWrites) {
+  uint32_t numWrites = 0;
+  if (numDynamic) {
+    outWrites[numWrites++] = ivkGetWriteDescriptorSet_BufferInfo(
+        dset, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, numDynamic, buffers);
+  }
+  if (numDynamic < IGL_UNIFORM_BLOCKS_BINDING_MAX) {
+    outWrites[numWrites++] =
+        ivkGetWriteDescriptorSet_BufferInfo(dset,
+                                            numDynamic,
+                                            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                            IGL_UNIFORM_BLOCKS_BINDING_MAX - numDynamic,
+                                            buffers + numDynamic);
+  }
+  return numWrites;
+}
+
 } // namespace
 
 namespace igl {
@@ -216,17 +320,28 @@ VulkanContext::VulkanContext(const VulkanContextConfig& config,
                              size_t numExtraInstanceExtensions,
                              const char** extraInstanceExtensions,
                              void* display) :
-  config_(config) {
+  config_(config),
+  validationFilter_(config.maxValidationMessageRepeats, config.maxValidationMessagesPerFrame) {
   IGL_PROFILER_THREAD("MainThread");
 
-  pimpl_ = std::make_unique<VulkanContextImpl>();
+  if (config_.enableAsyncValidationLogging) {
+    IGLLogSetAsync(true);
+  }
 
-  if (volkInitialize() != VK_SUCCESS) {
-    IGL_LOG_ERROR("volkInitialize() failed\n");
-    exit(255);
-  };
+  pimpl_ = std::make_unique<VulkanContextImpl>();
 
-  glslang_initialize_process();
+  {
+    auto& state = getProcessState();
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.numContexts == 0) {
+      if (volkInitialize() != VK_SUCCESS) {
+        IGL_LOG_ERROR("volkInitialize() failed\n");
+        exit(255);
+      };
+      glslang_initialize_process();
+    }
+    state.numContexts++;
+  }
 
   createInstance(numExtraInstanceExtensions, extraInstanceExtensions);
 
@@ -238,24 +353,39 @@ VulkanContext::VulkanContext(const VulkanContextConfig& config,
 VulkanContext::~VulkanContext() {
   IGL_PROFILER_FUNCTION();
 
+  // finish all outstanding pipeline compilations
+  pipelineCompilationPool_.reset(nullptr);
+
   if (device_) {
     waitIdle();
+    if (!config_.pipelineCacheFilePath.empty() &&
+        pipelineCacheNumPipelinesSaved_ != getNumPipelinesCreated()) {
+      savePipelineCache(config_.pipelineCacheFilePath);
+    }
   }
 
   enhancedShaderDebuggingStore_.reset(nullptr);
 
+  mipmapGenerator_.reset(nullptr);
+
   dummyStorageBuffer_.reset();
   dummyUniformBuffer_.reset();
+  bindlessDescriptorBuffer_.reset();
   textures_.clear();
   samplers_.clear();
+  textureSlots_.clear();
+  samplerSlots_.clear();
+  for (YcbcrConversion& ycbcr : ycbcrConversions_) {
+    ycbcr.sampler.reset();
+  }
 
   // This will free an internal buffer that was allocated by VMA
   stagingDevice_.reset(nullptr);
 
   VkDevice device = device_ ? device_->getVkDevice() : VK_NULL_HANDLE;
   if (device_) {
-    for (auto r : renderPasses_) {
-      vkDestroyRenderPass(device, r, nullptr);
+    for (const auto& r : renderPassesHash_) {
+      vkDestroyRenderPass(device, r.second.pass, nullptr);
     }
   }
 
@@ -263,22 +393,61 @@ VulkanContext::~VulkanContext() {
   dslBuffersUniform_.reset(nullptr);
   dslBuffersStorage_.reset(nullptr);
   dslBindless_.reset(nullptr);
+  dslEmpty_.reset(nullptr);
+  dslInputAttachments_.reset(nullptr);
 
   pipelineLayoutGraphics_.reset(nullptr);
   pipelineLayoutCompute_.reset(nullptr);
   swapchain_.reset(nullptr); // Swapchain has to be destroyed prior to Surface
 
+  // the blocks of uniform arenas are destroyed through deferred tasks
+  for (auto& dsets : transientDSets_) {
+    dsets.uniformArena.reset(nullptr);
+  }
+  for (auto& dsets : computeTransientDSets_) {
+    dsets.uniformArena.reset(nullptr);
+  }
+  for (auto& buffer : secondaryCommandBuffers_) {
+    buffer->dsets.uniformArena.reset(nullptr);
+  }
+
   waitDeferredTasks();
 
+  // the tasks above returned the ranges of all pooled buffers; destroying the blocks queues more
+  if (bufferPool_) {
+    bufferPool_.reset(nullptr);
+    waitDeferredTasks();
+  }
+
+  // VMA allocations are freed through the defragmenter until here
+  defragmenter_.reset(nullptr);
+
+  computeImmediate_.reset(nullptr);
   immediate_.reset(nullptr);
 
+#if defined(IGL_WITH_TRACY_GPU)
+  if (tracyCtx_) {
+    TracyVkDestroy(tracyCtx_);
+    tracyCtx_ = nullptr;
+  }
+#endif // IGL_WITH_TRACY_GPU
+
+  transientDSets_.clear();
+  computeTransientDSets_.clear();
+  secondaryCommandBuffers_.clear();
+
   if (device_) {
     if (dpBindless_ != VK_NULL_HANDLE) {
       vkDestroyDescriptorPool(device, dpBindless_, nullptr);
     }
-    vkDestroyDescriptorPool(device, dpCombinedImageSamplers_, nullptr);
-    vkDestroyDescriptorPool(device, dpBuffersUniform_, nullptr);
-    vkDestroyDescriptorPool(device, dpBuffersStorage_, nullptr);
+    if (dpDefaultBuffers_ != VK_NULL_HANDLE) {
+      vkDestroyDescriptorPool(device, dpDefaultBuffers_, nullptr);
+    }
+    for (const YcbcrConversion& ycbcr : ycbcrConversions_) {
+      if (ycbcr.conversion != VK_NULL_HANDLE) {
+        vkDestroySamplerYcbcrConversion(device, ycbcr.conversion, nullptr);
+      }
+    }
     vkDestroyPipelineCache(device, pipelineCache_, nullptr);
   }
 
@@ -289,13 +458,25 @@ VulkanContext::~VulkanContext() {
     vmaDestroyAllocator(pimpl_->vma_);
   }
 
+  if (isDeviceCounted_) {
+    auto& state = getProcessState();
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    state.numDevices--;
+  }
   device_.reset(nullptr); // Device has to be destroyed prior to Instance
+  validationFilter_.logSummary();
 #if defined(VK_EXT_debug_utils) && !IGL_PLATFORM_ANDROID
   vkDestroyDebugUtilsMessengerEXT(vkInstance_, vkDebugUtilsMessenger_, nullptr);
 #endif // defined(VK_EXT_debug_utils) && !IGL_PLATFORM_ANDROID
   vkDestroyInstance(vkInstance_, nullptr);
 
-  glslang_finalize_process();
+  {
+    auto& state = getProcessState();
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    if (--state.numContexts == 0) {
+      glslang_finalize_process();
+    }
+  }
 
 #if IGL_DEBUG || defined(IGL_FORCE_ENABLE_LOGS)
   if (config_.enableExtraLogs) {
@@ -332,7 +513,13 @@ void VulkanContext::createInstance(const size_t numExtraExtensions, const char**
                  "ivkCreateInstance() failed. Did you forget to install the Vulkan SDK?");
 
   VK_ASSERT(creationErrorCode);
-  volkLoadInstance(vkInstance_);
+  {
+    auto& state = getProcessState();
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    volkLoadInstance(vkInstance_);
+    // the device functions are the loader's trampolines again
+    state.volkLoadedDevice = false;
+  }
 
 #if defined(VK_EXT_debug_utils) && IGL_PLATFORM_WIN
   if (extensions_.enabled(VK_EXT_DEBUG_UTILS_EXTENSION_NAME)) {
@@ -418,10 +605,32 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
     return Result(Result::Code::Unsupported, "Vulkan is not supported");
   }
 
+  IGL_PROFILER_FUNCTION();
+
+  // every endStep() records the time since the previous one
+  startupSteps_.clear();
+  auto stepStart = std::chrono::steady_clock::now();
+  auto endStep = [this, &stepStart](const char* name) {
+    const auto now = std::chrono::steady_clock::now();
+    startupSteps_.push_back(
+        {name, std::chrono::duration<double, std::milli>(now - stepStart).count()});
+    stepStart = now;
+  };
+
   vkPhysicalDevice_ = (VkPhysicalDevice)desc.guid;
 
   useStaging_ = !ivkIsHostVisibleSingleHeapMemory(vkPhysicalDevice_);
 
+  {
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(vkPhysicalDevice_, &memProperties);
+    for (uint32_t i = 0; i != memProperties.memoryTypeCount; i++) {
+      if (memProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+        hasLazilyAllocatedMemory_ = true;
+      }
+    }
+  }
+
   vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &vkPhysicalDeviceFeatures2_);
   vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &vkPhysicalDeviceProperties2_);
 
@@ -462,12 +671,431 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
     (void)IGL_VERIFY(extensions_.enable(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME,
                                         VulkanExtensions::ExtensionType::Device));
   }
+  if (config_.enableTimelineSemaphores &&
+      extensions_.available(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device)) {
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures = {};
+    timelineSemaphoreFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &timelineSemaphoreFeatures;
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    useTimelineSemaphores_ = timelineSemaphoreFeatures.timelineSemaphore == VK_TRUE &&
+                             extensions_.enable(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME,
+                                                VulkanExtensions::ExtensionType::Device);
+  }
+  if (config_.enableTimelineSemaphores && !useTimelineSemaphores_) {
+    IGL_LOG_INFO("VK_KHR_timeline_semaphore is not supported; falling back to fences\n");
+  }
+#if defined(VK_EXT_memory_budget)
+  // lets VMA report the budgets of the driver instead of estimating them from the heap sizes
+  useMemoryBudget_ = extensions_.available(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+                                           VulkanExtensions::ExtensionType::Device) &&
+                     extensions_.enable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+                                        VulkanExtensions::ExtensionType::Device);
+#endif // VK_EXT_memory_budget
+#if defined(VK_EXT_memory_priority)
+  // lets VMA pass BufferDesc::memoryPriority and TextureDesc::memoryPriority to the driver, which
+  // keeps high priority allocations in device-local memory when it is oversubscribed
+  if (extensions_.available(VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device)) {
+    VkPhysicalDeviceMemoryPriorityFeaturesEXT memoryPriorityFeatures = {};
+    memoryPriorityFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &memoryPriorityFeatures;
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    useMemoryPriority_ = memoryPriorityFeatures.memoryPriority == VK_TRUE &&
+                         extensions_.enable(VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME,
+                                            VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_EXT_memory_priority
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  // descriptors are addressed with buffer device addresses. Every command buffer binds its own
+  // descriptor buffer and the bindless one, each holding both resources and samplers
+  if (config_.enableDescriptorBuffers && config_.enableBufferDeviceAddress &&
+      extensions_.available(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device)) {
+    VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeatures = {};
+    descriptorBufferFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &descriptorBufferFeatures;
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    descriptorBufferProperties_.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2 props = {};
+    props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props.pNext = &descriptorBufferProperties_;
+    vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &props);
+    useDescriptorBuffers_ = descriptorBufferFeatures.descriptorBuffer == VK_TRUE &&
+                            descriptorBufferProperties_.maxDescriptorBufferBindings >= 2 &&
+                            descriptorBufferProperties_.maxResourceDescriptorBufferBindings >= 2 &&
+                            descriptorBufferProperties_.maxSamplerDescriptorBufferBindings >= 2 &&
+                            extensions_.enable(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
+                                               VulkanExtensions::ExtensionType::Device);
+  }
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  if (config_.enableDescriptorBuffers && !useDescriptorBuffers_) {
+    IGL_LOG_INFO("VK_EXT_descriptor_buffer is not supported; falling back to descriptor sets\n");
+  }
+#if IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+  // the extension depends on VK_KHR_copy_commands2 and VK_KHR_format_feature_flags2
+  if (config_.enableHostImageCopy &&
+      extensions_.available(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device) &&
+      extensions_.available(VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device) &&
+      extensions_.available(VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device)) {
+    VkPhysicalDeviceHostImageCopyFeaturesEXT hostImageCopyFeatures = {};
+    hostImageCopyFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &hostImageCopyFeatures;
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    if (hostImageCopyFeatures.hostImageCopy == VK_TRUE) {
+      // the first call returns the number of layouts
+      VkPhysicalDeviceHostImageCopyPropertiesEXT hostImageCopyProps = {};
+      hostImageCopyProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_PROPERTIES_EXT;
+      VkPhysicalDeviceProperties2 props = {};
+      props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+      props.pNext = &hostImageCopyProps;
+      vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &props);
+      std::vector<VkImageLayout> dstLayouts(hostImageCopyProps.copyDstLayoutCount);
+      hostImageCopyProps.pCopyDstLayouts = dstLayouts.data();
+      vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &props);
+      // sampling right after the copy needs no transition if the driver can copy into this layout
+      if (std::find(dstLayouts.begin(),
+                    dstLayouts.end(),
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) != dstLayouts.end()) {
+        hostImageCopyLayout_ = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+      }
+      useHostImageCopy_ = std::find(dstLayouts.begin(), dstLayouts.end(), hostImageCopyLayout_) !=
+                              dstLayouts.end() &&
+                          extensions_.enable(VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME,
+                                             VulkanExtensions::ExtensionType::Device) &&
+                          extensions_.enable(VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME,
+                                             VulkanExtensions::ExtensionType::Device) &&
+                          extensions_.enable(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME,
+                                             VulkanExtensions::ExtensionType::Device);
+    }
+  }
+#endif // IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+  if (config_.enableHostImageCopy && !useHostImageCopy_) {
+    IGL_LOG_INFO("VK_EXT_host_image_copy is not supported; textures are uploaded via staging\n");
+  }
+#if IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED
+  if (config_.enableGraphicsPipelineLibrary &&
+      extensions_.available(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device) &&
+      extensions_.available(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device)) {
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT libraryFeatures = {};
+    libraryFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &libraryFeatures;
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT libraryProps = {};
+    libraryProps.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2 props = {};
+    props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props.pNext = &libraryProps;
+    vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &props);
+    // without fast linking, linking can take as long as building a whole pipeline
+    useGraphicsPipelineLibrary_ =
+        libraryFeatures.graphicsPipelineLibrary == VK_TRUE &&
+        libraryProps.graphicsPipelineLibraryFastLinking == VK_TRUE &&
+        extensions_.enable(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
+                           VulkanExtensions::ExtensionType::Device) &&
+        extensions_.enable(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+                           VulkanExtensions::ExtensionType::Device);
+  }
+#endif // IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED
+  if (config_.enableGraphicsPipelineLibrary && !useGraphicsPipelineLibrary_) {
+    IGL_LOG_INFO("VK_EXT_graphics_pipeline_library is not supported; using whole pipelines\n");
+  }
+  // multi-planar YUV sampling is core in Vulkan 1.1 but remains an optional feature. The immutable
+  // samplers of YUV conversions are not supported with descriptor buffers here
+  if (apiVersion >= VK_API_VERSION_1_1 && !useDescriptorBuffers_) {
+    VkPhysicalDeviceSamplerYcbcrConversionFeatures ycbcrFeatures = {};
+    ycbcrFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SAMPLER_YCBCR_CONVERSION_FEATURES;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &ycbcrFeatures;
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    useSamplerYcbcrConversion_ = ycbcrFeatures.samplerYcbcrConversion == VK_TRUE;
+  }
+  if (apiVersion >= VK_API_VERSION_1_1) {
+    VkPhysicalDeviceProperties2 props = {};
+    props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props.pNext = &vkPhysicalDeviceSubgroupProperties_;
+    vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &props);
+    // without the extension, the subgroup size of compute shaders is the reported one
+    minSubgroupSize_ = vkPhysicalDeviceSubgroupProperties_.subgroupSize;
+    maxSubgroupSize_ = vkPhysicalDeviceSubgroupProperties_.subgroupSize;
+  }
+#if defined(VK_EXT_subgroup_size_control)
+  if (apiVersion >= VK_API_VERSION_1_1 &&
+      extensions_.available(VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device)) {
+    VkPhysicalDeviceSubgroupSizeControlFeaturesEXT subgroupSizeControlFeatures = {};
+    subgroupSizeControlFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &subgroupSizeControlFeatures;
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    VkPhysicalDeviceSubgroupSizeControlPropertiesEXT subgroupSizeControlProps = {};
+    subgroupSizeControlProps.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2 props = {};
+    props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props.pNext = &subgroupSizeControlProps;
+    vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &props);
+    useSubgroupSizeControl_ =
+        subgroupSizeControlFeatures.subgroupSizeControl == VK_TRUE &&
+        subgroupSizeControlFeatures.computeFullSubgroups == VK_TRUE &&
+        (subgroupSizeControlProps.requiredSubgroupSizeStages & VK_SHADER_STAGE_COMPUTE_BIT) != 0 &&
+        extensions_.enable(VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME,
+                           VulkanExtensions::ExtensionType::Device);
+    if (subgroupSizeControlFeatures.subgroupSizeControl == VK_TRUE) {
+      // the driver may pick any size of the range for pipelines which do not require one
+      minSubgroupSize_ = subgroupSizeControlProps.minSubgroupSize;
+      maxSubgroupSize_ = subgroupSizeControlProps.maxSubgroupSize;
+    }
+  }
+#endif // VK_EXT_subgroup_size_control
+#if defined(VK_KHR_push_descriptor)
+  // maxPushDescriptors is at least 32, which fits all uniform buffer slots. Descriptor buffers
+  // replace push descriptors
+  if (config_.enablePushDescriptors && !useDescriptorBuffers_) {
+    usePushDescriptors_ = extensions_.available(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,
+                                                VulkanExtensions::ExtensionType::Device) &&
+                          extensions_.enable(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,
+                                             VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_KHR_push_descriptor
+#if IGL_PLATFORM_ANDROID && defined(VK_ANDROID_external_memory_android_hardware_buffer)
+  // zero-copy AHardwareBuffer import and the sync fd fences which order it with other APIs
+  {
+    const char* const interopExtensions[] = {
+        VK_KHR_EXTERNAL_MEMORY_EXTENSION_NAME,
+        VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME,
+        VK_KHR_SAMPLER_YCBCR_CONVERSION_EXTENSION_NAME,
+        VK_EXT_QUEUE_FAMILY_FOREIGN_EXTENSION_NAME,
+        VK_ANDROID_EXTERNAL_MEMORY_ANDROID_HARDWARE_BUFFER_EXTENSION_NAME,
+        VK_KHR_EXTERNAL_SEMAPHORE_EXTENSION_NAME,
+        VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME,
+    };
+    hasNativeHWBufferInterop_ =
+        std::all_of(std::begin(interopExtensions),
+                    std::end(interopExtensions),
+                    [this](const char* name) {
+                      return extensions_.available(name, VulkanExtensions::ExtensionType::Device);
+                    });
+    if (hasNativeHWBufferInterop_) {
+      for (const char* name : interopExtensions) {
+        extensions_.enable(name, VulkanExtensions::ExtensionType::Device);
+      }
+    }
+  }
+#endif // IGL_PLATFORM_ANDROID
+#if (IGL_PLATFORM_ANDROID || IGL_PLATFORM_LINUX) && defined(VK_KHR_external_semaphore_fd)
+  // fences of ICommandQueue::signalFence() are exported as sync file descriptors
+  hasExternalSemaphoreFd_ =
+      extensions_.available(VK_KHR_EXTERNAL_SEMAPHORE_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device) &&
+      extensions_.available(VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device);
+  if (hasExternalSemaphoreFd_) {
+    extensions_.enable(VK_KHR_EXTERNAL_SEMAPHORE_EXTENSION_NAME,
+                       VulkanExtensions::ExtensionType::Device);
+    extensions_.enable(VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME,
+                       VulkanExtensions::ExtensionType::Device);
+  }
+#endif // VK_KHR_external_semaphore_fd
+  // fragment density maps are only used when requested as an extra device extension, e.g. by an
+  // OpenXR runtime rendering foveated swapchains
+  if (extensions_.enabled(VK_EXT_FRAGMENT_DENSITY_MAP_EXTENSION_NAME)) {
+    VkPhysicalDeviceFragmentDensityMapFeaturesEXT fragmentDensityMapFeatures = {};
+    fragmentDensityMapFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_DENSITY_MAP_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &fragmentDensityMapFeatures;
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    useFragmentDensityMap_ = fragmentDensityMapFeatures.fragmentDensityMap == VK_TRUE;
+  }
+#if IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+  // VkRenderPass objects are kept for fragment density maps
+  if (config_.enableDynamicRendering && !useFragmentDensityMap_) {
+    const char* const renderingExtensions[] = {
+        VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME,
+        VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME,
+        VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
+        VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
+    };
+    const bool hasExtensions =
+        std::all_of(std::begin(renderingExtensions),
+                    std::end(renderingExtensions),
+                    [this](const char* name) {
+                      return extensions_.available(name, VulkanExtensions::ExtensionType::Device);
+                    });
+    if (hasExtensions) {
+      VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features = {};
+      synchronization2Features.sType =
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+      VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures = {};
+      dynamicRenderingFeatures.sType =
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+      dynamicRenderingFeatures.pNext = &synchronization2Features;
+      VkPhysicalDeviceFeatures2 features = {};
+      features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+      features.pNext = &dynamicRenderingFeatures;
+      vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+      useDynamicRendering_ = dynamicRenderingFeatures.dynamicRendering == VK_TRUE &&
+                             synchronization2Features.synchronization2 == VK_TRUE;
+    }
+    if (useDynamicRendering_) {
+      for (const char* name : renderingExtensions) {
+        extensions_.enable(name, VulkanExtensions::ExtensionType::Device);
+      }
+      VkPhysicalDeviceDepthStencilResolvePropertiesKHR depthStencilResolveProperties = {};
+      depthStencilResolveProperties.sType =
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEPTH_STENCIL_RESOLVE_PROPERTIES_KHR;
+      VkPhysicalDeviceProperties2 properties = {};
+      properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+      properties.pNext = &depthStencilResolveProperties;
+      vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &properties);
+      supportedDepthResolveModes_ = depthStencilResolveProperties.supportedDepthResolveModes;
+    }
+  }
+#endif // IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+  if (config_.enableDynamicRendering && !useDynamicRendering_) {
+    IGL_LOG_INFO("VK_KHR_dynamic_rendering is not supported; falling back to render passes\n");
+  }
+#if defined(VK_EXT_extended_dynamic_state)
+  if (config_.enableExtendedDynamicState &&
+      extensions_.available(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device)) {
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures = {};
+    extendedDynamicStateFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+#if defined(VK_EXT_extended_dynamic_state2)
+    const bool hasExtendedDynamicState2 = extensions_.available(
+        VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME, VulkanExtensions::ExtensionType::Device);
+    VkPhysicalDeviceExtendedDynamicState2FeaturesEXT extendedDynamicState2Features = {};
+    extendedDynamicState2Features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT;
+    if (hasExtendedDynamicState2) {
+      extendedDynamicStateFeatures.pNext = &extendedDynamicState2Features;
+    }
+#endif // VK_EXT_extended_dynamic_state2
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &extendedDynamicStateFeatures;
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    useExtendedDynamicState_ = extendedDynamicStateFeatures.extendedDynamicState == VK_TRUE &&
+                               extensions_.enable(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME,
+                                                  VulkanExtensions::ExtensionType::Device);
+#if defined(VK_EXT_extended_dynamic_state2)
+    useExtendedDynamicState2_ =
+        useExtendedDynamicState_ && hasExtendedDynamicState2 &&
+        extendedDynamicState2Features.extendedDynamicState2 == VK_TRUE &&
+        extensions_.enable(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME,
+                           VulkanExtensions::ExtensionType::Device);
+#endif // VK_EXT_extended_dynamic_state2
+#if defined(VK_EXT_extended_dynamic_state3)
+    // only the property is used, none of the features
+    if (useExtendedDynamicState_ &&
+        extensions_.available(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME,
+                              VulkanExtensions::ExtensionType::Device)) {
+      VkPhysicalDeviceExtendedDynamicState3PropertiesEXT extendedDynamicState3Properties = {};
+      extendedDynamicState3Properties.sType =
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_PROPERTIES_EXT;
+      VkPhysicalDeviceProperties2 properties = {};
+      properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+      properties.pNext = &extendedDynamicState3Properties;
+      vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &properties);
+      hasUnrestrictedDynamicPrimitiveTopology_ =
+          extendedDynamicState3Properties.dynamicPrimitiveTopologyUnrestricted == VK_TRUE &&
+          extensions_.enable(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME,
+                             VulkanExtensions::ExtensionType::Device);
+    }
+#endif // VK_EXT_extended_dynamic_state3
+  }
+#endif // VK_EXT_extended_dynamic_state
+  if (config_.enableExtendedDynamicState && !useExtendedDynamicState_) {
+    IGL_LOG_INFO("VK_EXT_extended_dynamic_state is not supported\n");
+  }
+  // dynamic rendering does not create framebuffers at all
+  if (config_.enableImagelessFramebuffers && !useDynamicRendering_ &&
+      extensions_.available(VK_KHR_IMAGELESS_FRAMEBUFFER_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device) &&
+      extensions_.available(VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device)) {
+    VkPhysicalDeviceImagelessFramebufferFeaturesKHR imagelessFramebufferFeatures = {};
+    imagelessFramebufferFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGELESS_FRAMEBUFFER_FEATURES_KHR;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &imagelessFramebufferFeatures;
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    useImagelessFramebuffers_ = imagelessFramebufferFeatures.imagelessFramebuffer == VK_TRUE;
+    if (useImagelessFramebuffers_) {
+      // VK_KHR_imageless_framebuffer requires VK_KHR_image_format_list
+      extensions_.enable(VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME,
+                         VulkanExtensions::ExtensionType::Device);
+      extensions_.enable(VK_KHR_IMAGELESS_FRAMEBUFFER_EXTENSION_NAME,
+                         VulkanExtensions::ExtensionType::Device);
+    }
+  }
+#if defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
+  if (config_.swapchainMaxQueuedFrames > 0 && vkSurface_ != VK_NULL_HANDLE &&
+      extensions_.available(VK_KHR_PRESENT_ID_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device) &&
+      extensions_.available(VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+                            VulkanExtensions::ExtensionType::Device)) {
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    presentIdFeatures.pNext = &presentWaitFeatures;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &presentIdFeatures;
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    usePresentWait_ = presentIdFeatures.presentId == VK_TRUE &&
+                      presentWaitFeatures.presentWait == VK_TRUE &&
+                      extensions_.enable(VK_KHR_PRESENT_ID_EXTENSION_NAME,
+                                         VulkanExtensions::ExtensionType::Device) &&
+                      extensions_.enable(VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+                                         VulkanExtensions::ExtensionType::Device);
+  }
+#endif // defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
+  if (config_.swapchainMaxQueuedFrames > 0 && !usePresentWait_) {
+    IGL_LOG_INFO("VK_KHR_present_wait is not supported; presented frames are not throttled\n");
+  }
 
   VulkanQueuePool queuePool(vkPhysicalDevice_);
 
   // Reserve IGL Vulkan queues
   auto graphicsQueueDescriptor = queuePool.findQueueDescriptor(VK_QUEUE_GRAPHICS_BIT);
+  if (config_.enableAsyncCompute) {
+    // asynchronous compute needs a queue other than the graphics one, possibly of the same family
+    queuePool.reserveQueue(graphicsQueueDescriptor);
+  }
   auto computeQueueDescriptor = queuePool.findQueueDescriptor(VK_QUEUE_COMPUTE_BIT);
+  if (!computeQueueDescriptor.isValid() && graphicsQueueDescriptor.isValid()) {
+    // graphics queues support compute
+    computeQueueDescriptor = graphicsQueueDescriptor;
+  }
 
   if (!graphicsQueueDescriptor.isValid()) {
     IGL_LOG_ERROR("VK_QUEUE_GRAPHICS_BIT is not supported");
@@ -481,6 +1109,7 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
 
   deviceQueues_.graphicsQueueFamilyIndex = graphicsQueueDescriptor.familyIndex;
   deviceQueues_.computeQueueFamilyIndex = computeQueueDescriptor.familyIndex;
+  deviceQueues_.computeQueueIndex = computeQueueDescriptor.queueIndex;
 
   queuePool.reserveQueue(graphicsQueueDescriptor);
   queuePool.reserveQueue(computeQueueDescriptor);
@@ -507,6 +1136,19 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
     queuePool.reserveQueue(descriptor);
   }
 
+  // The dedicated transfer queue is reserved last, so it never takes a queue away from the user
+  if (config_.enableDedicatedTransferQueue) {
+    const auto transferQueueDescriptor = queuePool.findQueueDescriptor(VK_QUEUE_TRANSFER_BIT);
+    if (transferQueueDescriptor.isValid() &&
+        (transferQueueDescriptor.queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0) {
+      deviceQueues_.transferQueueFamilyIndex = transferQueueDescriptor.familyIndex;
+      deviceQueues_.transferQueueIndex = transferQueueDescriptor.queueIndex;
+      queuePool.reserveQueue(transferQueueDescriptor);
+    } else {
+      IGL_LOG_INFO("Dedicated transfer queue is not available; uploads use the graphics queue\n");
+    }
+  }
+
   const auto qcis = queuePool.getQueueCreationInfos();
 
   VkDevice device;
@@ -520,33 +1162,205 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
                       vkPhysicalDeviceShaderFloat16Int8Features_.shaderFloat16,
                       config_.enableBufferDeviceAddress,
                       config_.enableDescriptorIndexing,
+                      useTimelineSemaphores_,
+                      useFragmentDensityMap_,
+                      usePresentWait_,
+                      useMemoryPriority_,
+                      useSamplerYcbcrConversion_,
+                      useDynamicRendering_,
+                      useExtendedDynamicState_,
+                      useExtendedDynamicState2_,
+                      useImagelessFramebuffers_,
+                      useDescriptorBuffers_,
+                      useHostImageCopy_,
+                      useGraphicsPipelineLibrary_,
+                      useSubgroupSizeControl_,
                       &device));
-  if (!config_.enableConcurrentVkDevicesSupport) {
-    volkLoadDevice(device);
+  {
+    // volk's global function pointers can only be loaded for one VkDevice. With several devices in
+    // the process, all of them go through the loader's dispatching trampolines instead.
+    auto& state = getProcessState();
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    if (!config_.enableConcurrentVkDevicesSupport && state.numDevices == 0) {
+      volkLoadDevice(device);
+      state.volkLoadedDevice = true;
+    } else if (state.volkLoadedDevice) {
+      volkLoadInstance(vkInstance_);
+      state.volkLoadedDevice = false;
+    }
+    state.numDevices++;
+    isDeviceCounted_ = true;
   }
 
   if (config_.enableBufferDeviceAddress && vkGetBufferDeviceAddressKHR == nullptr) {
     return Result(Result::Code::InvalidOperation, "Cannot initialize VK_KHR_buffer_device_address");
   }
+#if IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+  if (useDynamicRendering_ &&
+      (vkCmdBeginRenderingKHR == nullptr || vkCmdPipelineBarrier2KHR == nullptr)) {
+    // the enabled extensions do not affect render passes
+    IGL_LOG_INFO("Cannot load VK_KHR_dynamic_rendering; falling back to render passes\n");
+    useDynamicRendering_ = false;
+  }
+#endif // IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+#if defined(VK_EXT_extended_dynamic_state)
+  if (useExtendedDynamicState_ &&
+      (vkCmdSetPrimitiveTopologyEXT == nullptr || vkCmdSetDepthCompareOpEXT == nullptr)) {
+    // pipelines bake the states in again
+    IGL_LOG_INFO("Cannot load VK_EXT_extended_dynamic_state\n");
+    useExtendedDynamicState_ = false;
+    useExtendedDynamicState2_ = false;
+    hasUnrestrictedDynamicPrimitiveTopology_ = false;
+  }
+#endif // VK_EXT_extended_dynamic_state
+#if defined(VK_EXT_extended_dynamic_state2)
+  if (useExtendedDynamicState2_ && vkCmdSetDepthBiasEnableEXT == nullptr) {
+    useExtendedDynamicState2_ = false;
+  }
+#endif // VK_EXT_extended_dynamic_state2
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  if (useDescriptorBuffers_ &&
+      (vkGetDescriptorEXT == nullptr || vkCmdBindDescriptorBuffersEXT == nullptr ||
+       vkCmdSetDescriptorBufferOffsetsEXT == nullptr)) {
+    // this happens before any descriptor set layout is created
+    IGL_LOG_INFO("Cannot load VK_EXT_descriptor_buffer; falling back to descriptor sets\n");
+    useDescriptorBuffers_ = false;
+  }
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+#if IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+  if (useHostImageCopy_ &&
+      (vkCopyMemoryToImageEXT == nullptr || vkTransitionImageLayoutEXT == nullptr)) {
+    IGL_LOG_INFO("Cannot load VK_EXT_host_image_copy; textures are uploaded via staging\n");
+    useHostImageCopy_ = false;
+  }
+#endif // IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+
+  endStep("device");
 
   vkGetDeviceQueue(device, deviceQueues_.graphicsQueueFamilyIndex, 0, &deviceQueues_.graphicsQueue);
-  vkGetDeviceQueue(device, deviceQueues_.computeQueueFamilyIndex, 0, &deviceQueues_.computeQueue);
+  vkGetDeviceQueue(device,
+                   deviceQueues_.computeQueueFamilyIndex,
+                   deviceQueues_.computeQueueIndex,
+                   &deviceQueues_.computeQueue);
+  if (deviceQueues_.transferQueueFamilyIndex != DeviceQueues::INVALID) {
+    vkGetDeviceQueue(device,
+                     deviceQueues_.transferQueueFamilyIndex,
+                     deviceQueues_.transferQueueIndex,
+                     &deviceQueues_.transferQueue);
+  }
 
   device_ = std::make_unique<igl::vulkan::VulkanDevice>(device, "Device: VulkanContext::device_");
   immediate_ = std::make_unique<igl::vulkan::VulkanImmediateCommands>(
-      device, deviceQueues_.graphicsQueueFamilyIndex, "VulkanContext::immediate_");
+      device,
+      deviceQueues_.graphicsQueueFamilyIndex,
+      "VulkanContext::immediate_",
+      0,
+      useTimelineSemaphores_);
+  immediate_->setFrameStatisticsTracker(&frameStatistics_);
+  if (config_.batchSubmits) {
+    if (useTimelineSemaphores_) {
+      immediate_->setSubmitBatching(true);
+    } else {
+      IGL_LOG_INFO("Batched submits require timeline semaphores. Submitting immediately.\n");
+    }
+  }
+  if (config_.enableAsyncCompute) {
+    if (deviceQueues_.computeQueue != deviceQueues_.graphicsQueue) {
+      computeImmediate_ = std::make_unique<igl::vulkan::VulkanImmediateCommands>(
+          device,
+          deviceQueues_.computeQueueFamilyIndex,
+          "VulkanContext::computeImmediate_",
+          deviceQueues_.computeQueueIndex,
+          useTimelineSemaphores_);
+      computeImmediate_->setFrameStatisticsTracker(&frameStatistics_);
+      if (deviceQueues_.computeQueueFamilyIndex != deviceQueues_.graphicsQueueFamilyIndex) {
+        concurrentQueueFamilyIndices_ = {deviceQueues_.graphicsQueueFamilyIndex,
+                                         deviceQueues_.computeQueueFamilyIndex};
+        // the ownership transfers of the staging device become plain barriers then
+        if (deviceQueues_.transferQueueFamilyIndex != DeviceQueues::INVALID &&
+            deviceQueues_.transferQueueFamilyIndex != deviceQueues_.graphicsQueueFamilyIndex &&
+            deviceQueues_.transferQueueFamilyIndex != deviceQueues_.computeQueueFamilyIndex) {
+          concurrentQueueFamilyIndices_.push_back(deviceQueues_.transferQueueFamilyIndex);
+        }
+      }
+    } else {
+      IGL_LOG_INFO("No compute queue besides the graphics one; compute uses the graphics queue\n");
+    }
+  }
   syncManager_ = std::make_unique<SyncManager>(*this, config_.maxResourceCount);
 
-  // create Vulkan pipeline cache
-  {
+#if defined(IGL_WITH_TRACY_GPU)
+  if (getVkPhysicalDeviceProperties().limits.timestampComputeAndGraphics == VK_TRUE) {
+    // Tracy records and submits one command buffer to calibrate its GPU clock
+    const VulkanCommandPool profilingCommandPool(device,
+                                                 VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+                                                 deviceQueues_.graphicsQueueFamilyIndex,
+                                                 "VulkanContext::profilingCommandPool");
+    VkCommandBuffer profilingCmdBuffer = VK_NULL_HANDLE;
+    VK_ASSERT(ivkAllocateCommandBuffer(
+        device, profilingCommandPool.getVkCommandPool(), &profilingCmdBuffer));
+    if (extensions_.enabled(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME)) {
+      tracyCtx_ = TracyVkContextCalibrated(vkPhysicalDevice_,
+                                           device,
+                                           deviceQueues_.graphicsQueue,
+                                           profilingCmdBuffer,
+                                           vkGetPhysicalDeviceCalibrateableTimeDomainsEXT,
+                                           vkGetCalibratedTimestampsEXT);
+    } else {
+      tracyCtx_ = TracyVkContext(
+          vkPhysicalDevice_, device, deviceQueues_.graphicsQueue, profilingCmdBuffer);
+    }
+  }
+#endif // IGL_WITH_TRACY_GPU
+
+  endStep("command queues");
+
+  // create Vulkan pipeline cache; reading and validating a large cache file takes a while, so it
+  // can overlap with the rest of the initialization
+  auto createPipelineCache = [this, device]() {
+    IGL_PROFILER_ZONE("createPipelineCache", IGL_PROFILER_COLOR_CREATE);
+    const void* cacheData = config_.pipelineCacheData;
+    size_t cacheDataSize = config_.pipelineCacheDataSize;
+    std::vector<uint8_t> cacheFileData;
+    if (!cacheData && !config_.pipelineCacheFilePath.empty()) {
+      cacheFileData = loadPipelineCache(config_.pipelineCacheFilePath);
+      cacheData = cacheFileData.empty() ? nullptr : cacheFileData.data();
+      cacheDataSize = cacheFileData.size();
+    }
+    if (cacheData && !isPipelineCacheDataCompatible(cacheData, cacheDataSize)) {
+      IGL_LOG_INFO("Discarding incompatible Vulkan pipeline cache data (%zu bytes)\n",
+                   cacheDataSize);
+      cacheData = nullptr;
+      cacheDataSize = 0;
+    }
     const VkPipelineCacheCreateInfo ci = {
         VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
         nullptr,
         VkPipelineCacheCreateFlags(0),
-        config_.pipelineCacheDataSize,
-        config_.pipelineCacheData,
+        cacheDataSize,
+        cacheData,
     };
     vkCreatePipelineCache(device, &ci, nullptr, &pipelineCache_);
+    IGL_PROFILER_ZONE_END();
+  };
+  // nothing uses `pipelineCache_` before initContext() returns; the future joins the worker
+  // thread on every return path
+  std::future<void> pipelineCacheCreated;
+  if (config_.enableParallelInit) {
+    pipelineCacheCreated = std::async(std::launch::async, createPipelineCache);
+  } else {
+    createPipelineCache();
+    endStep("pipeline cache");
+  }
+  pipelineCacheNumPipelinesSaved_ = getNumPipelinesCreated();
+
+  if (config_.numPipelineCompilationThreads) {
+    pipelineCompilationPool_ = std::make_unique<WorkerPool>(config_.numPipelineCompilationThreads,
+                                                            "IGL Vulkan pipeline compiler");
+  }
+
+  if (config_.enableDeferredTasksThread) {
+    deferredTasksPool_ = std::make_unique<WorkerPool>(1, "IGL Vulkan deferred tasks");
   }
 
   // Create Vulkan Memory Allocator
@@ -556,23 +1370,38 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
                                            vkInstance_,
                                            apiVersion,
                                            config_.enableBufferDeviceAddress,
+                                           useMemoryBudget_,
+                                           useMemoryPriority_,
                                            &pimpl_->vma_));
+    defragmenter_ = std::make_unique<igl::vulkan::VulkanDefragmenter>(*this);
+  }
+
+  if (config_.bufferPoolMaxAllocationSize) {
+    bufferPool_ = std::make_unique<igl::vulkan::VulkanBufferPool>(
+        *this, std::max(config_.bufferPoolBlockSize, config_.bufferPoolMaxAllocationSize));
   }
 
+  endStep("memory allocator");
+
   // The staging device will use VMA to allocate a buffer, so this needs
   // to happen after VMA has been initialized.
   stagingDevice_ = std::make_unique<igl::vulkan::VulkanStagingDevice>(*this);
 
+  endStep("staging device");
+
   // Unextended Vulkan 1.1 does not allow sparse (VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT)
   // bindings. Our descriptor set layout emulates OpenGL binding slots but we cannot put
   // VK_NULL_HANDLE into empty slots. We use dummy buffers to stick them into those empty slots.
+  // Descriptor buffers reference them by their device addresses.
+  const VkBufferUsageFlags dummyBufferUsage =
+      config_.enableBufferDeviceAddress ? VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR : 0;
   dummyUniformBuffer_ = createBuffer(256,
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | dummyBufferUsage,
                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
                                      nullptr,
                                      "Buffer: dummy uniform");
   dummyStorageBuffer_ = createBuffer(256,
-                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | dummyBufferUsage,
                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
                                      nullptr,
                                      "Buffer: dummy storage");
@@ -643,6 +1472,77 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
                                                               0.0f),
                                       "Sampler: default");
 
+  endStep("dummy resources");
+
+  // YUV conversions and their immutable samplers, which have to exist before the bindless
+  // descriptor set layout
+  static_assert(IGL_ARRAY_NUM_ELEMENTS(kYcbcrFormats) ==
+                std::tuple_size<decltype(ycbcrConversions_)>::value);
+  for (size_t i = 0; useSamplerYcbcrConversion_ && i != ycbcrConversions_.size(); i++) {
+    const VkFormat format = kYcbcrFormats[i].format;
+    VkFormatProperties props = {};
+    vkGetPhysicalDeviceFormatProperties(vkPhysicalDevice_, format, &props);
+    const VkFormatFeatureFlags features = props.optimalTilingFeatures;
+    const bool hasCositedChroma = (features & VK_FORMAT_FEATURE_COSITED_CHROMA_SAMPLES_BIT) != 0;
+    if ((features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) == 0 ||
+        (!hasCositedChroma && (features & VK_FORMAT_FEATURE_MIDPOINT_CHROMA_SAMPLES_BIT) == 0)) {
+      continue;
+    }
+    // without separate reconstruction filters the sampler filters have to match the chroma filter
+    const VkFilter filter =
+        (features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_YCBCR_CONVERSION_LINEAR_FILTER_BIT) != 0
+            ? VK_FILTER_LINEAR
+            : VK_FILTER_NEAREST;
+    const VkChromaLocation chromaLocation =
+        hasCositedChroma ? VK_CHROMA_LOCATION_COSITED_EVEN : VK_CHROMA_LOCATION_MIDPOINT;
+    const VkSamplerYcbcrConversionCreateInfo ci = {
+        VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_CREATE_INFO,
+        nullptr,
+        format,
+        kYcbcrFormats[i].model,
+        VK_SAMPLER_YCBCR_RANGE_ITU_NARROW,
+        {VK_COMPONENT_SWIZZLE_IDENTITY,
+         VK_COMPONENT_SWIZZLE_IDENTITY,
+         VK_COMPONENT_SWIZZLE_IDENTITY,
+         VK_COMPONENT_SWIZZLE_IDENTITY},
+        chromaLocation,
+        chromaLocation,
+        filter,
+        VK_FALSE,
+    };
+    YcbcrConversion& ycbcr = ycbcrConversions_[i];
+    if (vkCreateSamplerYcbcrConversion(device, &ci, nullptr, &ycbcr.conversion) != VK_SUCCESS) {
+      ycbcr.conversion = VK_NULL_HANDLE;
+      continue;
+    }
+    ycbcr.format = format;
+    const VkSamplerYcbcrConversionInfo conversionInfo = {
+        VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_INFO, nullptr, ycbcr.conversion};
+    // conversions require clamp-to-edge addressing and no anisotropic filtering
+    VkSamplerCreateInfo samplerInfo = ivkGetSamplerCreateInfo(filter,
+                                                              filter,
+                                                              VK_SAMPLER_MIPMAP_MODE_NEAREST,
+                                                              VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                                                              VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                                                              VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                                                              0.0f,
+                                                              0.0f);
+    samplerInfo.pNext = &conversionInfo;
+    ycbcr.sampler =
+        std::make_shared<VulkanSampler>(*this, device, samplerInfo, "Sampler: YUV conversion");
+  }
+
+  // `textures_` and `samplers_` can grow on other threads while command buffers are recorded
+  dummyImageView_ = textures_[0]->imageView_->getVkImageView();
+  dummySampler_ = samplers_[0]->getVkSampler();
+  textureSlots_[0] = getBindlessTextureSlot(*textures_[0]);
+  samplerSlots_[0] = dummySampler_;
+
+  // the guard elements go into the bindless descriptor set on the first update
+  dirtyIndicesTextures_.push_back(0);
+  dirtyIndicesSamplers_.push_back(0);
+  awaitingCreation_ = true;
+
   if (config_.enableDescriptorIndexing) {
     if (!IGL_VERIFY(config_.maxSamplers <= vkPhysicalDeviceDescriptorIndexingProperties_
                                                .maxDescriptorSetUpdateAfterBindSamplers)) {
@@ -664,51 +1564,17 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
   const VkPhysicalDeviceLimits& limits = getVkPhysicalDeviceProperties().limits;
 
   // create default descriptor set layout for texture bindings
-  {
-    // NOTE: we really want these arrays to be uninitialized
-    // @lint-ignore CLANGTIDY
-    VkDescriptorSetLayoutBinding bindings[IGL_TEXTURE_SAMPLERS_MAX];
-    // @lint-ignore CLANGTIDY
-    VkDescriptorBindingFlags bindingFlags[IGL_TEXTURE_SAMPLERS_MAX];
-    for (uint32_t i = 0; i != IGL_TEXTURE_SAMPLERS_MAX; i++) {
-      bindings[i] =
-          ivkGetDescriptorSetLayoutBinding(i, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1);
-      bindingFlags[i] = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
-    }
-    dslCombinedImageSamplers_ = std::make_unique<VulkanDescriptorSetLayout>(
-        device,
-        IGL_TEXTURE_SAMPLERS_MAX,
-        bindings,
-        bindingFlags,
-        "Descriptor Set Layout: VulkanContext::dslCombinedImageSamplers_");
-  }
+  dslCombinedImageSamplers_ = createTexturesDescriptorSetLayout(
+      nullptr, "Descriptor Set Layout: VulkanContext::dslCombinedImageSamplers_");
 
-  // create default descriptor pool for texture bindings
+  // create default descriptor set layout for uniform buffers
   {
-    // TODO: make this more manageable (dynamic) once we migrate all apps to use descriptor sets
-    constexpr uint32_t kNumSets = 1024;
-
-    // @lint-ignore CLANGTIDY
-    VkDescriptorPoolSize poolSizes[IGL_TEXTURE_SAMPLERS_MAX];
-    for (uint32_t i = 0; i != IGL_TEXTURE_SAMPLERS_MAX; i++) {
-      poolSizes[i] = VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                                          kNumSets * IGL_TEXTURE_SAMPLERS_MAX};
-    }
-    // create default descriptor pool and allocate descriptor sets
-    combinedImageSamplerDSets_.dsets.resize(kNumSets);
-    VK_ASSERT_RETURN(ivkCreateDescriptorPool(
-        device, kNumSets, IGL_TEXTURE_SAMPLERS_MAX, poolSizes, &dpCombinedImageSamplers_));
-    for (uint32_t i = 0; i != kNumSets; i++) {
-      VK_ASSERT_RETURN(
-          ivkAllocateDescriptorSet(device,
-                                   dpCombinedImageSamplers_,
-                                   dslCombinedImageSamplers_->getVkDescriptorSetLayout(),
-                                   &combinedImageSamplerDSets_.dsets[i].ds));
+    // push descriptor and descriptor buffer set layouts cannot have dynamic descriptors
+    if (config_.dynamicUniformBufferRange && !usePushDescriptors_ && !useDescriptorBuffers_) {
+      numDynamicUniformBuffers_ = std::min<uint32_t>(
+          IGL_UNIFORM_BLOCKS_BINDING_MAX, limits.maxDescriptorSetUniformBuffersDynamic);
     }
-  }
 
-  // create default descriptor set layout for uniform buffers
-  {
     // NOTE: we really want these arrays to be uninitialized
     // @lint-ignore CLANGTIDY
     VkDescriptorSetLayoutBinding bindings[IGL_UNIFORM_BLOCKS_BINDING_MAX];
@@ -716,37 +1582,22 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
     VkDescriptorBindingFlags bindingFlags[IGL_UNIFORM_BLOCKS_BINDING_MAX];
 
     for (uint32_t i = 0; i != IGL_UNIFORM_BLOCKS_BINDING_MAX; i++) {
-      bindings[i] = ivkGetDescriptorSetLayoutBinding(i, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1);
+      bindings[i] = ivkGetDescriptorSetLayoutBinding(
+          i,
+          i < numDynamicUniformBuffers_ ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
+                                        : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+          1);
       bindingFlags[i] = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
     }
+    // transient sets are never updated after they are bound, and dynamic descriptors forbid it
     dslBuffersUniform_ = std::make_unique<VulkanDescriptorSetLayout>(
         device,
         IGL_UNIFORM_BLOCKS_BINDING_MAX,
         bindings,
-        bindingFlags,
-        "Descriptor Set Layout: VulkanContext::dslBuffersUniform_");
-  }
-
-  // create default descriptor pool for uniform buffers bindings
-  {
-    // TODO: make this more manageable (dynamic) once we migrate all apps to use descriptor sets
-    constexpr uint32_t kNumSets = 1024;
-
-    // @lint-ignore CLANGTIDY
-    VkDescriptorPoolSize poolSizes[IGL_UNIFORM_BLOCKS_BINDING_MAX];
-    for (uint32_t i = 0; i != IGL_UNIFORM_BLOCKS_BINDING_MAX; i++) {
-      poolSizes[i] = VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                                          kNumSets * IGL_UNIFORM_BLOCKS_BINDING_MAX};
-    }
-    VK_ASSERT_RETURN(ivkCreateDescriptorPool(
-        device, kNumSets, IGL_UNIFORM_BLOCKS_BINDING_MAX, poolSizes, &dpBuffersUniform_));
-    bufferUniformDSets_.dsets.resize(kNumSets);
-    for (size_t i = 0; i != kNumSets; i++) {
-      VK_ASSERT_RETURN(ivkAllocateDescriptorSet(device,
-                                                dpBuffersUniform_,
-                                                dslBuffersUniform_->getVkDescriptorSetLayout(),
-                                                &bufferUniformDSets_.dsets[i].ds));
-    }
+        numDynamicUniformBuffers_ ? nullptr : bindingFlags,
+        "Descriptor Set Layout: VulkanContext::dslBuffersUniform_",
+        usePushDescriptors_,
+        useDescriptorBuffers_);
   }
 
   // create default descriptor set layout for storage buffers
@@ -765,36 +1616,116 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
         IGL_UNIFORM_BLOCKS_BINDING_MAX,
         bindings,
         bindingFlags,
-        "Descriptor Set Layout: VulkanContext::dslBuffersStorage_");
+        "Descriptor Set Layout: VulkanContext::dslBuffersStorage_",
+        false,
+        useDescriptorBuffers_);
   }
 
-  // create default descriptor pool for storage buffers bindings
-  {
-    // TODO: make this more manageable (dynamic) once we migrate all apps to use descriptor sets
-    constexpr uint32_t kNumSets = 1024;
-
+  // create default descriptor set layout for input attachments: subpasses need render passes and
+  // the descriptor set comes after the bindless one
+  if (!useDynamicRendering_ && limits.maxBoundDescriptorSets > kBindPoint_InputAttachments) {
     // @lint-ignore CLANGTIDY
-    VkDescriptorPoolSize poolSizes[IGL_UNIFORM_BLOCKS_BINDING_MAX];
-    for (uint32_t i = 0; i != IGL_UNIFORM_BLOCKS_BINDING_MAX; i++) {
-      poolSizes[i] = VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-                                          kNumSets * IGL_UNIFORM_BLOCKS_BINDING_MAX};
+    VkDescriptorSetLayoutBinding bindings[IGL_COLOR_ATTACHMENTS_MAX];
+    for (uint32_t i = 0; i != IGL_COLOR_ATTACHMENTS_MAX; i++) {
+      bindings[i] = ivkGetDescriptorSetLayoutBinding(i, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1);
+      // input attachments are only accessible from fragment shaders
+      bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+    // input attachments cannot be updated after they are bound
+    dslInputAttachments_ = std::make_unique<VulkanDescriptorSetLayout>(
+        device,
+        IGL_COLOR_ATTACHMENTS_MAX,
+        bindings,
+        nullptr,
+        "Descriptor Set Layout: VulkanContext::dslInputAttachments_",
+        false,
+        useDescriptorBuffers_);
+    if (!config_.enableDescriptorIndexing) {
+      // takes the place of the bindless set
+      dslEmpty_ = std::make_unique<VulkanDescriptorSetLayout>(device,
+                                                              0,
+                                                              nullptr,
+                                                              nullptr,
+                                                              "Descriptor Set Layout: "
+                                                              "VulkanContext::dslEmpty_",
+                                                              false,
+                                                              useDescriptorBuffers_);
+    }
+  }
+
+  // create default descriptor set allocators for every command buffer
+  transientDSets_.reserve(VulkanImmediateCommands::kMaxCommandBuffers);
+  for (uint32_t i = 0; i != VulkanImmediateCommands::kMaxCommandBuffers; i++) {
+    transientDSets_.emplace_back(createTransientDescriptorSets(
+        IGL_FORMAT("VulkanContext::transientDSets_[{}]", i), immediate_.get()));
+  }
+  if (computeImmediate_) {
+    computeTransientDSets_.reserve(VulkanImmediateCommands::kMaxCommandBuffers);
+    for (uint32_t i = 0; i != VulkanImmediateCommands::kMaxCommandBuffers; i++) {
+      computeTransientDSets_.emplace_back(createTransientDescriptorSets(
+          IGL_FORMAT("VulkanContext::computeTransientDSets_[{}]", i), computeImmediate_.get()));
     }
-    VK_ASSERT_RETURN(ivkCreateDescriptorPool(
-        device, kNumSets, IGL_UNIFORM_BLOCKS_BINDING_MAX, poolSizes, &dpBuffersStorage_));
-    bufferStorageDSets_.dsets.resize(kNumSets);
-    for (size_t i = 0; i != kNumSets; i++) {
+  }
+
+  // create persistent buffer descriptor sets which reference only the dummy buffers; descriptor
+  // buffers allocate no sets
+  if (!useDescriptorBuffers_) {
+    const std::array<VkDescriptorPoolSize, 3> poolSizes = {
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, IGL_UNIFORM_BLOCKS_BINDING_MAX},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                             IGL_UNIFORM_BLOCKS_BINDING_MAX},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, IGL_UNIFORM_BLOCKS_BINDING_MAX},
+    };
+    VK_ASSERT_RETURN(ivkCreateDescriptorPool(device,
+                                             2,
+                                             static_cast<uint32_t>(poolSizes.size()),
+                                             poolSizes.data(),
+                                             &dpDefaultBuffers_));
+    std::array<VkDescriptorBufferInfo, IGL_UNIFORM_BLOCKS_BINDING_MAX> uniformBuffers{};
+    std::array<VkDescriptorBufferInfo, IGL_UNIFORM_BLOCKS_BINDING_MAX> storageBuffers{};
+    uniformBuffers.fill({dummyUniformBuffer_->getVkBuffer(), 0, VK_WHOLE_SIZE});
+    storageBuffers.fill({dummyStorageBuffer_->getVkBuffer(), 0, VK_WHOLE_SIZE});
+    std::vector<VkWriteDescriptorSet> writes;
+    // push descriptor set layouts cannot be used to allocate sets
+    if (!usePushDescriptors_) {
       VK_ASSERT_RETURN(ivkAllocateDescriptorSet(device,
-                                                dpBuffersStorage_,
-                                                dslBuffersStorage_->getVkDescriptorSetLayout(),
-                                                &bufferStorageDSets_.dsets[i].ds));
+                                                dpDefaultBuffers_,
+                                                dslBuffersUniform_->getVkDescriptorSetLayout(),
+                                                &dsetDefaultBuffersUniform_));
+      std::array<VkWriteDescriptorSet, 2> uniformWrites = {};
+      const uint32_t numUniformWrites = getUniformBufferWrites(dsetDefaultBuffersUniform_,
+                                                               numDynamicUniformBuffers_,
+                                                               uniformBuffers.data(),
+                                                               uniformWrites);
+      writes.insert(writes.end(), uniformWrites.begin(), uniformWrites.begin() + numUniformWrites);
     }
+    VK_ASSERT_RETURN(ivkAllocateDescriptorSet(device,
+                                              dpDefaultBuffers_,
+                                              dslBuffersStorage_->getVkDescriptorSetLayout(),
+                                              &dsetDefaultBuffersStorage_));
+    writes.push_back(ivkGetWriteDescriptorSet_BufferInfo(dsetDefaultBuffersStorage_,
+                                                         0,
+                                                         VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                         IGL_UNIFORM_BLOCKS_BINDING_MAX,
+                                                         storageBuffers.data()));
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
   }
 
+  endStep("descriptor sets");
+
   // only do allocations if actually enabled
   if (config_.enableDescriptorIndexing) {
     // create default descriptor set layout which is going to be shared by graphics pipelines
-    constexpr uint32_t kNumBindings = 7;
-    const std::array<VkDescriptorSetLayoutBinding, kNumBindings> bindings = {
+    constexpr uint32_t kNumBindings = 9;
+    // every element of a YUV binding uses the immutable sampler of its format
+    std::array<std::vector<VkSampler>, IGL_ARRAY_NUM_ELEMENTS(kYcbcrFormats)> immutableSamplers;
+    for (size_t i = 0; i != immutableSamplers.size(); i++) {
+      if (ycbcrConversions_[i].sampler) {
+        immutableSamplers[i].resize(config_.maxTextures,
+                                    ycbcrConversions_[i].sampler->getVkSampler());
+      }
+    }
+    std::array<VkDescriptorSetLayoutBinding, kNumBindings> bindings = {
         ivkGetDescriptorSetLayoutBinding(
             kBinding_Texture2D, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures),
         ivkGetDescriptorSetLayoutBinding(
@@ -809,69 +1740,84 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
             kBinding_SamplerShadow, VK_DESCRIPTOR_TYPE_SAMPLER, config_.maxSamplers),
         ivkGetDescriptorSetLayoutBinding(
             kBinding_StorageImages, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, config_.maxTextures),
+        ivkGetDescriptorSetLayoutBinding(
+            kBinding_TextureYUV, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, config_.maxTextures),
+        ivkGetDescriptorSetLayoutBinding(kBinding_TextureYUV + 1,
+                                         VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                         config_.maxTextures),
     };
+    for (size_t i = 0; i != immutableSamplers.size(); i++) {
+      if (!immutableSamplers[i].empty()) {
+        bindings[kBinding_TextureYUV + i].pImmutableSamplers = immutableSamplers[i].data();
+      }
+    }
     const uint32_t flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
                            VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
                            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
     const std::array<VkDescriptorBindingFlags, kNumBindings> bindingFlags = {
-        flags, flags, flags, flags, flags, flags, flags};
+        flags, flags, flags, flags, flags, flags, flags, flags, flags};
     dslBindless_ = std::make_unique<VulkanDescriptorSetLayout>(
         device,
         kNumBindings,
         bindings.data(),
         bindingFlags.data(),
-        "Descriptor Set Layout: VulkanContext::dslBindless_");
-    // create default descriptor pool and allocate 1 descriptor set
-    const std::array<VkDescriptorPoolSize, kNumBindings> poolSizes = {
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, config_.maxSamplers},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, config_.maxSamplers},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, config_.maxTextures},
-    };
-    VK_ASSERT_RETURN(ivkCreateDescriptorPool(
-        device, 1, static_cast<uint32_t>(poolSizes.size()), poolSizes.data(), &dpBindless_));
-    VK_ASSERT_RETURN(ivkAllocateDescriptorSet(
-        device, dpBindless_, dslBindless_->getVkDescriptorSetLayout(), &bindlessDSet_.ds));
+        "Descriptor Set Layout: VulkanContext::dslBindless_",
+        false,
+        useDescriptorBuffers_);
+    if (useDescriptorBuffers_) {
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+      // the descriptors are written into the slots of this buffer like into `bindlessDSet_`
+      bindlessDescriptorBuffer_ =
+          std::make_unique<VulkanBuffer>(*this,
+                                         device,
+                                         dslBindless_->getDescriptorBufferSize(),
+                                         kDescriptorBufferUsage |
+                                             VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR,
+                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                             VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                         "Buffer: VulkanContext::bindlessDescriptorBuffer_");
+      if (!IGL_VERIFY(bindlessDescriptorBuffer_->isMapped())) {
+        return Result(Result::Code::RuntimeError, "Cannot map the bindless descriptor buffer");
+      }
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+    } else {
+      // create default descriptor pool and allocate 1 descriptor set
+      const std::array<VkDescriptorPoolSize, kNumBindings> poolSizes = {
+          VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures},
+          VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures},
+          VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures},
+          VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config_.maxTextures},
+          VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, config_.maxSamplers},
+          VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, config_.maxSamplers},
+          VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, config_.maxTextures},
+          // a YUV combined image sampler may consume one descriptor per plane
+          VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 3 * config_.maxTextures},
+          VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 3 * config_.maxTextures},
+      };
+      VK_ASSERT_RETURN(ivkCreateDescriptorPool(
+          device, 1, static_cast<uint32_t>(poolSizes.size()), poolSizes.data(), &dpBindless_));
+      VK_ASSERT_RETURN(ivkAllocateDescriptorSet(
+          device, dpBindless_, dslBindless_->getVkDescriptorSetLayout(), &bindlessDSet_.ds));
+    }
+    endStep("bindless descriptor set");
   }
 
   // maxPushConstantsSize is guaranteed to be at least 128 bytes
-  // https://www.khronos.org/registry/vulkan/specs/1.3/html/vkspec.html#features-limits
-  // Table 32. Required Limits
-  const uint32_t kPushConstantsSize = 128;
   if (!IGL_VERIFY(kPushConstantsSize <= limits.maxPushConstantsSize)) {
     IGL_LOG_ERROR("Push constants size exceeded %u (max %u bytes)",
                   kPushConstantsSize,
                   limits.maxPushConstantsSize);
   }
 
-  // @lint-ignore CLANGTIDY
-  const VkDescriptorSetLayout DSLs[] = {
-      dslCombinedImageSamplers_->getVkDescriptorSetLayout(),
-      dslBuffersUniform_->getVkDescriptorSetLayout(),
-      dslBuffersStorage_->getVkDescriptorSetLayout(),
-      config_.enableDescriptorIndexing ? dslBindless_->getVkDescriptorSetLayout() : VK_NULL_HANDLE,
-  };
-
   // create pipeline layout
-  pipelineLayoutGraphics_ = std::make_unique<VulkanPipelineLayout>(
-      device,
-      DSLs,
-      static_cast<uint32_t>(config_.enableDescriptorIndexing ? IGL_ARRAY_NUM_ELEMENTS(DSLs)
-                                                             : IGL_ARRAY_NUM_ELEMENTS(DSLs) - 1),
-      ivkGetPushConstantRange(
-          VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, kPushConstantsSize),
-      "Pipeline Layout: VulkanContext::pipelineLayoutGraphics_");
-
-  pipelineLayoutCompute_ = std::make_unique<VulkanPipelineLayout>(
-      device,
-      DSLs,
-      static_cast<uint32_t>(config_.enableDescriptorIndexing ? IGL_ARRAY_NUM_ELEMENTS(DSLs)
-                                                             : IGL_ARRAY_NUM_ELEMENTS(DSLs) - 1),
-      ivkGetPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, kPushConstantsSize),
-      "Pipeline Layout: VulkanContext::pipelineLayoutCompute_");
+  pipelineLayoutGraphics_ =
+      createPipelineLayout(dslCombinedImageSamplers_->getVkDescriptorSetLayout(),
+                           VK_PIPELINE_BIND_POINT_GRAPHICS,
+                           "Pipeline Layout: VulkanContext::pipelineLayoutGraphics_");
+  pipelineLayoutCompute_ =
+      createPipelineLayout(dslCombinedImageSamplers_->getVkDescriptorSetLayout(),
+                           VK_PIPELINE_BIND_POINT_COMPUTE,
+                           "Pipeline Layout: VulkanContext::pipelineLayoutCompute_");
 
   querySurfaceCapabilities();
 
@@ -880,6 +1826,29 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
     enhancedShaderDebuggingStore_ = std::make_unique<EnhancedShaderDebuggingStore>();
   }
 
+  if (config_.enableShaderCache) {
+    // glslang resource limits depend on the physical device
+    const VkPhysicalDeviceProperties& props = getVkPhysicalDeviceProperties();
+    const uint64_t salt = (uint64_t(props.vendorID) << 32) | uint64_t(props.deviceID);
+    spirvCache_ = std::make_unique<SpirvCache>(config_.shaderCacheDirectory, salt);
+  }
+
+  endStep("pipeline layouts");
+
+  if (pipelineCacheCreated.valid()) {
+    pipelineCacheCreated.wait();
+    endStep("pipeline cache (waiting for the worker thread)");
+  }
+
+  if (config_.enableExtraLogs) {
+    double totalMilliseconds = 0;
+    for (const StartupStep& step : startupSteps_) {
+      IGL_LOG_INFO("VulkanContext::initContext() %s: %.2f ms\n", step.name, step.milliseconds);
+      totalMilliseconds += step.milliseconds;
+    }
+    IGL_LOG_INFO("VulkanContext::initContext() total: %.2f ms\n", totalMilliseconds);
+  }
+
   return Result();
 }
 
@@ -890,6 +1859,7 @@ igl::Result VulkanContext::initSwapchain(uint32_t width, uint32_t height) {
   }
 
   if (swapchain_) {
+    immediate_->flush();
     vkDeviceWaitIdle(device_->device_);
     swapchain_ = nullptr; // Destroy old swapchain first
   }
@@ -898,6 +1868,11 @@ igl::Result VulkanContext::initSwapchain(uint32_t width, uint32_t height) {
     return Result();
   }
 
+  // the current transform follows the orientation of the display
+  if (vkSurface_ != VK_NULL_HANDLE) {
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(vkPhysicalDevice_, vkSurface_, &deviceSurfaceCaps_);
+  }
+
   swapchain_ = std::make_unique<igl::vulkan::VulkanSwapchain>(*this, width, height);
 
   return swapchain_ ? Result() : Result(Result::Code::RuntimeError, "Failed to create Swapchain");
@@ -907,11 +1882,23 @@ VkExtent2D VulkanContext::getSwapchainExtent() const {
   return hasSwapchain() ? swapchain_->getExtent() : VkExtent2D{0, 0};
 }
 
+VkSurfaceTransformFlagBitsKHR VulkanContext::getSwapchainPreTransform() const {
+  return hasSwapchain() ? swapchain_->getPreTransform() : VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+}
+
 Result VulkanContext::waitIdle() const {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
 
-  for (auto queue : {deviceQueues_.graphicsQueue, deviceQueues_.computeQueue}) {
-    VK_ASSERT_RETURN(vkQueueWaitIdle(queue));
+  // vkQueueWaitIdle() does not wait for batched command buffers which are not submitted yet
+  if (immediate_) {
+    immediate_->flush();
+  }
+
+  for (auto queue :
+       {deviceQueues_.graphicsQueue, deviceQueues_.computeQueue, deviceQueues_.transferQueue}) {
+    if (queue != VK_NULL_HANDLE) {
+      VK_ASSERT_RETURN(vkQueueWaitIdle(queue));
+    }
   }
 
   return getResultFromVkResult(VK_SUCCESS);
@@ -929,7 +1916,8 @@ std::shared_ptr<VulkanBuffer> VulkanContext::createBuffer(VkDeviceSize bufferSiz
                                                           VkBufferUsageFlags usageFlags,
                                                           VkMemoryPropertyFlags memFlags,
                                                           igl::Result* outResult,
-                                                          const char* debugName) const {
+                                                          const char* debugName,
+                                                          float memoryPriority) const {
 #define ENSURE_BUFFER_SIZE(flag, maxSize)                                                      \
   if (usageFlags & flag) {                                                                     \
     if (!IGL_VERIFY(bufferSize <= maxSize)) {                                                  \
@@ -948,7 +1936,7 @@ std::shared_ptr<VulkanBuffer> VulkanContext::createBuffer(VkDeviceSize bufferSiz
 
   Result::setOk(outResult);
   return std::make_shared<VulkanBuffer>(
-      *this, device_->getVkDevice(), bufferSize, usageFlags, memFlags, debugName);
+      *this, device_->getVkDevice(), bufferSize, usageFlags, memFlags, debugName, memoryPriority);
 }
 
 std::shared_ptr<VulkanImage> VulkanContext::createImage(VkImageType imageType,
@@ -962,7 +1950,8 @@ std::shared_ptr<VulkanImage> VulkanContext::createImage(VkImageType imageType,
                                                         VkImageCreateFlags flags,
                                                         VkSampleCountFlagBits samples,
                                                         igl::Result* outResult,
-                                                        const char* debugName) const {
+                                                        const char* debugName,
+                                                        float memoryPriority) const {
   if (!validateImageLimits(
           imageType, samples, extent, getVkPhysicalDeviceProperties().limits, outResult)) {
     return nullptr;
@@ -980,7 +1969,8 @@ std::shared_ptr<VulkanImage> VulkanContext::createImage(VkImageType imageType,
                                        memFlags,
                                        flags,
                                        samples,
-                                       debugName);
+                                       debugName,
+                                       memoryPriority);
 }
 
 std::shared_ptr<VulkanImage> VulkanContext::createImageFromFileDescriptor(
@@ -1018,7 +2008,33 @@ std::shared_ptr<VulkanImage> VulkanContext::createImageFromFileDescriptor(
                                        debugName);
 }
 
+VkSamplerYcbcrConversion VulkanContext::getYcbcrConversion(VkFormat format) const {
+  for (const YcbcrConversion& ycbcr : ycbcrConversions_) {
+    if (ycbcr.format == format) {
+      return ycbcr.conversion;
+    }
+  }
+  return VK_NULL_HANDLE;
+}
+
+VulkanContext::BindlessTextureSlot VulkanContext::getBindlessTextureSlot(
+    const VulkanTexture& texture) {
+  const VulkanImage& image = *texture.image_;
+  // multisampled images cannot be directly accessed from shaders
+  const bool isSingleSampled = (image.samples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT;
+  return {
+      texture.imageView_->getVkImageView(),
+      image.imageFormat_,
+      isSingleSampled && image.isSampledImage(),
+      isSingleSampled && image.isStorageImage(),
+  };
+}
+
 void VulkanContext::checkAndUpdateDescriptorSets() const {
+  IGL_PROFILER_FUNCTION();
+
+  std::lock_guard<std::mutex> lock(bindlessMutex_);
+
   if (!awaitingCreation_) {
     // nothing to update here
     return;
@@ -1028,115 +2044,183 @@ void VulkanContext::checkAndUpdateDescriptorSets() const {
   IGL_PROFILER_FUNCTION();
 
   // here we remove deleted textures - everything which has only 1 reference is owned by this
-  // context and can be released safely
+  // context and can be released safely. Their slots are recycled only after the GPU is done with
+  // the last submitted command buffer, so a slot reused by a new texture is never referenced by
+  // work in flight.
+  const SubmitHandle lastSubmitHandle = immediate_->getLastSubmitHandle();
+  const SubmitHandle lastComputeSubmitHandle =
+      computeImmediate_ ? computeImmediate_->getLastSubmitHandle() : SubmitHandle();
+
   for (uint32_t i = 1; i < (uint32_t)textures_.size(); i++) {
     if (textures_[i] && textures_[i].use_count() == 1) {
-      if (i == textures_.size() - 1) {
-        textures_.pop_back();
-      } else {
-        textures_[i].reset();
-        freeIndicesTextures_.push_back(i);
-      }
+      textures_[i].reset();
+      textureSlots_[i] = {};
+      pendingFreeIndicesTextures_.push_back({i, lastSubmitHandle, lastComputeSubmitHandle});
     }
   }
   for (uint32_t i = 1; i < (uint32_t)samplers_.size(); i++) {
     if (samplers_[i] && samplers_[i].use_count() == 1) {
-      if (i == samplers_.size() - 1) {
-        samplers_.pop_back();
-      } else {
-        samplers_[i].reset();
-        freeIndicesSamplers_.push_back(i);
-      }
+      samplers_[i].reset();
+      samplerSlots_[i] = VK_NULL_HANDLE;
+      pendingFreeIndicesSamplers_.push_back({i, lastSubmitHandle, lastComputeSubmitHandle});
     }
   }
 
+  auto recycleIndices = [this](std::deque<PendingFreeIndex>& pending,
+                               std::vector<uint32_t>& freeIndices) {
+    while (!pending.empty() && isReady(pending.front().handle, pending.front().computeHandle)) {
+      freeIndices.push_back(pending.front().index);
+      pending.pop_front();
+    }
+  };
+  recycleIndices(pendingFreeIndicesTextures_, freeIndicesTextures_);
+  recycleIndices(pendingFreeIndicesSamplers_, freeIndicesSamplers_);
+
   // update Vulkan descriptor set here
   if (!config_.enableDescriptorIndexing) {
+    dirtyIndicesTextures_.clear();
+    dirtyIndicesSamplers_.clear();
+    awaitingCreation_ = false;
     return;
   }
 
+  // Only the slots which changed are written. The bindless bindings are UPDATE_AFTER_BIND,
+  // UPDATE_UNUSED_WHILE_PENDING and PARTIALLY_BOUND, and dirty slots are never used by the command
+  // buffers in flight, so there is no need to wait for the GPU here.
+  auto sortDirtyIndices = [](std::vector<uint32_t>& indices) {
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+  };
+  sortDirtyIndices(dirtyIndicesTextures_);
+  sortDirtyIndices(dirtyIndicesSamplers_);
+
   // 1. Sampled and storage images
   std::vector<VkDescriptorImageInfo> infoSampledImages;
   std::vector<VkDescriptorImageInfo> infoStorageImages;
   IGL_ASSERT(textures_.size() >= 1); // make sure the guard value is always there
-  infoSampledImages.reserve(textures_.size());
-  infoStorageImages.reserve(textures_.size());
+  IGL_ASSERT(textureSlots_.size() == textures_.size());
+  // VkWriteDescriptorSet points into these arrays, so they must not reallocate
+  infoSampledImages.reserve(dirtyIndicesTextures_.size());
+  infoStorageImages.reserve(dirtyIndicesTextures_.size());
+  // YUV images are only accessible through the combined image samplers of their format
+  std::vector<VkDescriptorImageInfo> infoYcbcrImages;
+  infoYcbcrImages.reserve(dirtyIndicesTextures_.size());
 
   // use the dummy texture to avoid sparse array
-  VkImageView dummyImageView = textures_[0]->imageView_->getVkImageView();
-
-  for (const auto& texture : textures_) {
-    // multisampled images cannot be directly accessed from shaders
-    // @lint-ignore CLANGTIDY
-    const bool isTextureAvailable =
-        texture && ((texture->image_->samples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT);
-    const bool isSampledImage = isTextureAvailable && texture->image_->isSampledImage();
-    const bool isStorageImage = isTextureAvailable && texture->image_->isStorageImage();
-    infoSampledImages.push_back(
-        {samplers_[0]->getVkSampler(),
-         isSampledImage ? texture->imageView_->getVkImageView() : dummyImageView,
-         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
-    IGL_ASSERT(infoSampledImages.back().imageView != VK_NULL_HANDLE);
-    infoStorageImages.push_back(VkDescriptorImageInfo{
-        VK_NULL_HANDLE,
-        isStorageImage ? texture->imageView_->getVkImageView() : dummyImageView,
-        VK_IMAGE_LAYOUT_GENERAL});
-  }
+  const VkImageView dummyImageView = dummyImageView_;
 
   // 2. Samplers
   std::vector<VkDescriptorImageInfo> infoSamplers;
   IGL_ASSERT(samplers_.size() >= 1); // make sure the guard value is always there
-  infoSamplers.reserve(samplers_.size());
-
-  for (const auto& sampler : samplers_) {
-    infoSamplers.push_back({(sampler ? sampler : samplers_[0])->getVkSampler(),
-                            VK_NULL_HANDLE,
-                            VK_IMAGE_LAYOUT_UNDEFINED});
-  }
+  IGL_ASSERT(samplerSlots_.size() == samplers_.size());
+  infoSamplers.reserve(dirtyIndicesSamplers_.size());
 
   std::vector<VkWriteDescriptorSet> write;
 
   auto& dsetToUpdate = bindlessDSet_;
 
-  if (!infoSampledImages.empty()) {
+  // coalesce consecutive dirty slots into one write per binding
+  auto forEachRange = [](const std::vector<uint32_t>& indices, auto&& func) {
+    for (size_t begin = 0; begin != indices.size();) {
+      size_t end = begin + 1;
+      while (end != indices.size() && indices[end] == indices[end - 1] + 1) {
+        end++;
+      }
+      func(indices[begin], uint32_t(end - begin));
+      begin = end;
+    }
+  };
+
+  forEachRange(dirtyIndicesTextures_, [&](uint32_t firstSlot, uint32_t numSlots) {
+    const size_t firstInfo = infoSampledImages.size();
+    for (uint32_t slot = firstSlot; slot != firstSlot + numSlots; slot++) {
+      const BindlessTextureSlot& texture =
+          slot < textureSlots_.size() ? textureSlots_[slot] : textureSlots_[0];
+      const auto ycbcr = texture.isSampled
+                             ? std::find_if(ycbcrConversions_.begin(),
+                                            ycbcrConversions_.end(),
+                                            [&texture](const YcbcrConversion& c) {
+                                              return c.conversion != VK_NULL_HANDLE &&
+                                                     c.format == texture.format;
+                                            })
+                             : ycbcrConversions_.end();
+      const bool isYcbcrImage = ycbcr != ycbcrConversions_.end();
+      const bool isSampledImage = texture.isSampled && !isYcbcrImage;
+      if (isYcbcrImage) {
+        // the sampler is immutable
+        infoYcbcrImages.push_back(
+            {VK_NULL_HANDLE, texture.imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
+        write.push_back(ivkGetWriteDescriptorSet_ImageInfo(
+            dsetToUpdate.ds,
+            kBinding_TextureYUV + uint32_t(ycbcr - ycbcrConversions_.begin()),
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            1,
+            &infoYcbcrImages.back()));
+        write.back().dstArrayElement = slot;
+      }
+      infoSampledImages.push_back({dummySampler_,
+                                   isSampledImage ? texture.imageView : dummyImageView,
+                                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
+      IGL_ASSERT(infoSampledImages.back().imageView != VK_NULL_HANDLE);
+      infoStorageImages.push_back(
+          VkDescriptorImageInfo{VK_NULL_HANDLE,
+                                texture.isStorage ? texture.imageView : dummyImageView,
+                                VK_IMAGE_LAYOUT_GENERAL});
+    }
     // use the same indexing for every texture type
     for (uint32_t i = kBinding_Texture2D; i != kBinding_TextureCube + 1; i++) {
       write.push_back(ivkGetWriteDescriptorSet_ImageInfo(dsetToUpdate.ds,
                                                          i,
                                                          VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-                                                         (uint32_t)infoSampledImages.size(),
-                                                         infoSampledImages.data()));
+                                                         numSlots,
+                                                         &infoSampledImages[firstInfo]));
+      write.back().dstArrayElement = firstSlot;
     }
-  };
+    write.push_back(ivkGetWriteDescriptorSet_ImageInfo(dsetToUpdate.ds,
+                                                       kBinding_StorageImages,
+                                                       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                                                       numSlots,
+                                                       &infoStorageImages[firstInfo]));
+    write.back().dstArrayElement = firstSlot;
+  });
 
-  if (!infoSamplers.empty()) {
+  forEachRange(dirtyIndicesSamplers_, [&](uint32_t firstSlot, uint32_t numSlots) {
+    const size_t firstInfo = infoSamplers.size();
+    for (uint32_t slot = firstSlot; slot != firstSlot + numSlots; slot++) {
+      const VkSampler sampler = slot < samplerSlots_.size() ? samplerSlots_[slot] : VK_NULL_HANDLE;
+      infoSamplers.push_back({sampler != VK_NULL_HANDLE ? sampler : dummySampler_,
+                              VK_NULL_HANDLE,
+                              VK_IMAGE_LAYOUT_UNDEFINED});
+    }
     for (uint32_t i = kBinding_Sampler; i != kBinding_SamplerShadow + 1; i++) {
       write.push_back(ivkGetWriteDescriptorSet_ImageInfo(dsetToUpdate.ds,
                                                          i,
                                                          VK_DESCRIPTOR_TYPE_SAMPLER,
-                                                         (uint32_t)infoSamplers.size(),
-                                                         infoSamplers.data()));
+                                                         numSlots,
+                                                         &infoSamplers[firstInfo]));
+      write.back().dstArrayElement = firstSlot;
     }
-  }
+  });
 
-  if (!infoStorageImages.empty()) {
-    write.push_back(ivkGetWriteDescriptorSet_ImageInfo(dsetToUpdate.ds,
-                                                       kBinding_StorageImages,
-                                                       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-                                                       (uint32_t)infoStorageImages.size(),
-                                                       infoStorageImages.data()));
-  };
-
-  // do not switch to the next descriptor set if there is nothing to update
   if (!write.empty()) {
 #if IGL_VULKAN_PRINT_COMMANDS
-    IGL_LOG_INFO("Updating descriptor set bindlessDSet_\n");
+    IGL_LOG_INFO("Updating descriptor set bindlessDSet_ (%u writes)\n", (uint32_t)write.size());
 #endif // IGL_VULKAN_PRINT_COMMANDS
-    immediate_->wait(std::exchange(dsetToUpdate.handle, immediate_->getLastSubmitHandle()));
-    vkUpdateDescriptorSets(
-        device_->getVkDevice(), static_cast<uint32_t>(write.size()), write.data(), 0, nullptr);
+    if (useDescriptorBuffers_) {
+      // the same slots of the buffer are not used by the command buffers in flight either
+      for (const VkWriteDescriptorSet& w : write) {
+        writeDescriptors(bindlessDescriptorBuffer_->getMappedPtr(), *dslBindless_, w);
+      }
+    } else {
+      vkUpdateDescriptorSets(
+          device_->getVkDevice(), static_cast<uint32_t>(write.size()), write.data(), 0, nullptr);
+    }
+    frameStatistics_.add(FrameStatisticsTracker::DescriptorUpdates);
   }
 
+  dirtyIndicesTextures_.clear();
+  dirtyIndicesSamplers_.clear();
+
   awaitingCreation_ = false;
 
   lastDeletionFrame_ = getFrameNumber();
@@ -1149,16 +2233,22 @@ std::shared_ptr<VulkanTexture> VulkanContext::createTexture(
   if (!IGL_VERIFY(texture)) {
     return nullptr;
   }
+  std::lock_guard<std::mutex> lock(bindlessMutex_);
+
   if (!freeIndicesTextures_.empty()) {
     // reuse an empty slot
     texture->textureId_ = freeIndicesTextures_.back();
     freeIndicesTextures_.pop_back();
     textures_[texture->textureId_] = texture;
+    textureSlots_[texture->textureId_] = getBindlessTextureSlot(*texture);
   } else {
     texture->textureId_ = uint32_t(textures_.size());
     textures_.emplace_back(texture);
+    textureSlots_.emplace_back(getBindlessTextureSlot(*texture));
   }
 
+  dirtyIndicesTextures_.push_back(texture->textureId_);
+
   if (config_.enableDescriptorIndexing) {
     const bool canFitTextures = textures_.size() <= config_.maxTextures;
     if (!IGL_VERIFY(canFitTextures)) {
@@ -1179,16 +2269,22 @@ std::shared_ptr<VulkanSampler> VulkanContext::createSampler(const VkSamplerCreat
     Result::setResult(outResult, Result::Code::InvalidOperation);
     return nullptr;
   }
+  std::lock_guard<std::mutex> lock(bindlessMutex_);
+
   if (!freeIndicesSamplers_.empty()) {
     // reuse an empty slot
     sampler->samplerId_ = freeIndicesSamplers_.back();
     freeIndicesSamplers_.pop_back();
     samplers_[sampler->samplerId_] = sampler;
+    samplerSlots_[sampler->samplerId_] = sampler->getVkSampler();
   } else {
     sampler->samplerId_ = uint32_t(samplers_.size());
     samplers_.emplace_back(sampler);
+    samplerSlots_.emplace_back(sampler->getVkSampler());
   }
 
+  dirtyIndicesSamplers_.push_back(sampler->samplerId_);
+
   IGL_ASSERT(samplers_.size() <= config_.maxSamplers);
 
   awaitingCreation_ = true;
@@ -1262,7 +2358,52 @@ VkFormat VulkanContext::getClosestDepthStencilFormat(igl::TextureFormat desiredF
   return !deviceDepthFormats_.empty() ? deviceDepthFormats_[0] : VK_FORMAT_D24_UNORM_S8_UINT;
 }
 
-VulkanContext::RenderPassHandle VulkanContext::getRenderPass(uint8_t index) const {
+igl::TextureFormat VulkanContext::getUploadConversionFormat(
+    igl::TextureFormat format,
+    VkComponentMapping* outComponents) const {
+  IGL_ASSERT(outComponents);
+
+  constexpr VkComponentSwizzle kR = VK_COMPONENT_SWIZZLE_R;
+  constexpr VkComponentSwizzle kG = VK_COMPONENT_SWIZZLE_G;
+  constexpr VkComponentSwizzle kZero = VK_COMPONENT_SWIZZLE_ZERO;
+  constexpr VkComponentSwizzle kOne = VK_COMPONENT_SWIZZLE_ONE;
+  constexpr VkComponentSwizzle kIdentity = VK_COMPONENT_SWIZZLE_IDENTITY;
+
+  // the luminance and alpha formats have no Vulkan equivalent and are rebuilt from R and RG
+  switch (format) {
+  case igl::TextureFormat::L_UNorm8:
+    *outComponents = {kR, kR, kR, kOne};
+    return igl::TextureFormat::R_UNorm8;
+  case igl::TextureFormat::LA_UNorm8:
+    *outComponents = {kR, kR, kR, kG};
+    return igl::TextureFormat::RG_UNorm8;
+  case igl::TextureFormat::A_UNorm8:
+    *outComponents = {kZero, kZero, kZero, kR};
+    return igl::TextureFormat::R_UNorm8;
+  case igl::TextureFormat::RGBX_UNorm8:
+    *outComponents = {kIdentity, kIdentity, kIdentity, kOne};
+    return igl::TextureFormat::RGBA_UNorm8;
+  case igl::TextureFormat::RGB_F16:
+  case igl::TextureFormat::RGB_F32: {
+    // 3-component float formats are optional and rarely sampled by desktop GPUs
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(
+        vkPhysicalDevice_, textureFormatToVkFormat(format), &properties);
+    if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+      return igl::TextureFormat::Invalid;
+    }
+    *outComponents = {kIdentity, kIdentity, kIdentity, kOne};
+    return format == igl::TextureFormat::RGB_F16 ? igl::TextureFormat::RGBA_F16
+                                                 : igl::TextureFormat::RGBA_F32;
+  }
+  default:
+    return igl::TextureFormat::Invalid;
+  }
+}
+
+VulkanContext::RenderPassHandle VulkanContext::getRenderPass(uint16_t index) const {
+  std::lock_guard<std::mutex> lock(renderPassesMutex_);
+
   return RenderPassHandle{renderPasses_[index], index};
 }
 
@@ -1270,25 +2411,61 @@ VulkanContext::RenderPassHandle VulkanContext::findRenderPass(
     const VulkanRenderPassBuilder& builder) const {
   IGL_PROFILER_FUNCTION();
 
+  std::lock_guard<std::mutex> lock(renderPassesMutex_);
+
   auto it = renderPassesHash_.find(builder);
 
   if (it != renderPassesHash_.end()) {
-    return RenderPassHandle{renderPasses_[it->second], it->second};
+    it->second.isUsed = true;
+    return RenderPassHandle{it->second.pass, it->second.index};
   }
 
   VkRenderPass pass = VK_NULL_HANDLE;
   builder.build(device_->getVkDevice(), &pass);
 
-  const size_t index = renderPasses_.size();
+  // render passes which differ only by their load and store operations share an index
+  const auto compatibilityKey = builder.getCompatibilityKey();
+  auto compatible = compatibleRenderPassesHash_.find(compatibilityKey);
 
-  IGL_ASSERT(index <= 255);
+  if (compatible == compatibleRenderPassesHash_.end()) {
+    const size_t index = renderPasses_.size();
 
-  renderPassesHash_[builder] = uint8_t(index);
-  // @fb-only
-  // @lint-ignore CLANGTIDY
-  renderPasses_.push_back(pass);
+    IGL_ASSERT(index <= UINT16_MAX);
+
+    compatible = compatibleRenderPassesHash_.emplace(compatibilityKey, uint16_t(index)).first;
+    // @fb-only
+    // @lint-ignore CLANGTIDY
+    renderPasses_.push_back(pass);
+  }
+
+  renderPassesHash_[builder] = RenderPassEntry{pass, compatible->second, true};
+
+  return RenderPassHandle{pass, compatible->second};
+}
 
-  return RenderPassHandle{pass, uint8_t(index)};
+size_t VulkanContext::pruneRenderPasses() const {
+  IGL_PROFILER_FUNCTION();
+
+  std::lock_guard<std::mutex> lock(renderPassesMutex_);
+
+  size_t numPruned = 0;
+
+  for (auto it = renderPassesHash_.begin(); it != renderPassesHash_.end();) {
+    RenderPassEntry& entry = it->second;
+    // pipelines are created with the first render pass of each class
+    if (entry.isUsed || renderPasses_[entry.index] == entry.pass) {
+      entry.isUsed = false;
+      ++it;
+      continue;
+    }
+    deferredTask(std::packaged_task<void()>([device = device_->getVkDevice(), pass = entry.pass]() {
+      vkDestroyRenderPass(device, pass, nullptr);
+    }));
+    it = renderPassesHash_.erase(it);
+    numPruned++;
+  }
+
+  return numPruned;
 }
 
 std::vector<uint8_t> VulkanContext::getPipelineCacheData() const {
@@ -1306,17 +2483,114 @@ std::vector<uint8_t> VulkanContext::getPipelineCacheData() const {
   return data;
 }
 
+bool VulkanContext::isPipelineCacheDataCompatible(const void* data, size_t size) const {
+  if (!data || size < sizeof(VkPipelineCacheHeaderVersionOne)) {
+    return false;
+  }
+
+  VkPipelineCacheHeaderVersionOne header = {};
+  checked_memcpy(&header, sizeof(header), data, sizeof(header));
+
+  const VkPhysicalDeviceProperties& props = getVkPhysicalDeviceProperties();
+
+  return header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne) && header.headerSize <= size &&
+         header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header.vendorID == props.vendorID && header.deviceID == props.deviceID &&
+         memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+std::vector<uint8_t> VulkanContext::loadPipelineCache(const std::string& path) const {
+  IGL_PROFILER_FUNCTION();
+
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    return {};
+  }
+
+  const std::streamsize size = file.tellg();
+  if (size <= 0) {
+    return {};
+  }
+
+  std::vector<uint8_t> data(static_cast<size_t>(size));
+  file.seekg(0, std::ios::beg);
+  if (!file.read(reinterpret_cast<char*>(data.data()), size)) {
+    IGL_LOG_ERROR("Cannot read Vulkan pipeline cache: %s\n", path.c_str());
+    return {};
+  }
+
+  return data;
+}
+
+Result VulkanContext::savePipelineCache(const std::string& path) const {
+  IGL_PROFILER_FUNCTION();
+
+  if (path.empty()) {
+    return Result(Result::Code::ArgumentInvalid, "Empty pipeline cache path");
+  }
+
+  const uint32_t numPipelines = getNumPipelinesCreated();
+  const std::vector<uint8_t> data = getPipelineCacheData();
+
+  if (data.empty()) {
+    return Result(Result::Code::RuntimeError, "Pipeline cache is empty");
+  }
+
+  const std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open() ||
+        !file.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()))) {
+      IGL_LOG_ERROR("Cannot write Vulkan pipeline cache: %s\n", tmpPath.c_str());
+      return Result(Result::Code::RuntimeError, "Cannot write pipeline cache file");
+    }
+  }
+
+  // rename() cannot overwrite existing files on Windows
+  std::remove(path.c_str());
+  if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    IGL_LOG_ERROR("Cannot rename Vulkan pipeline cache: %s\n", tmpPath.c_str());
+    return Result(Result::Code::RuntimeError, "Cannot rename pipeline cache file");
+  }
+
+  pipelineCacheNumPipelinesSaved_ = numPipelines;
+
+  return Result();
+}
+
+void VulkanContext::flushPipelineCache() const {
+  if (config_.pipelineCacheFilePath.empty() || config_.pipelineCacheFlushInterval == 0) {
+    return;
+  }
+
+  if (++pipelineCacheSubmitsSinceFlush_ < config_.pipelineCacheFlushInterval) {
+    return;
+  }
+
+  pipelineCacheSubmitsSinceFlush_ = 0;
+
+  // only touch the disk when new pipelines have been created since the last save
+  if (pipelineCacheNumPipelinesSaved_ != getNumPipelinesCreated()) {
+    savePipelineCache(config_.pipelineCacheFilePath);
+  }
+}
+
 uint64_t VulkanContext::getFrameNumber() const {
   return swapchain_ ? swapchain_->getFrameNumber() : 0u;
 }
 
 void VulkanContext::bindDefaultDescriptorSets(VkCommandBuffer cmdBuf,
-                                              VkPipelineBindPoint bindPoint) const {
-  if (!config_.enableDescriptorIndexing) {
+                                              VulkanTransientDescriptorSets& dsets,
+                                              VkPipelineBindPoint bindPoint,
+                                              VkPipelineLayout pipelineLayout) const {
+  if (useDescriptorBuffers_) {
+    bindDescriptorBuffers(cmdBuf, dsets, bindPoint, pipelineLayout);
     return;
   }
 
-  const bool isGraphics = bindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS;
+  if (!config_.enableDescriptorIndexing) {
+    return;
+  }
 
 #if IGL_VULKAN_PRINT_COMMANDS
   IGL_LOG_INFO("%p vkCmdBindDescriptorSets(%u) - bindless\n", cmdBuf, bindPoint);
@@ -1324,7 +2598,7 @@ void VulkanContext::bindDefaultDescriptorSets(VkCommandBuffer cmdBuf,
   vkCmdBindDescriptorSets(
       cmdBuf,
       bindPoint,
-      (isGraphics ? pipelineLayoutGraphics_ : pipelineLayoutCompute_)->getVkPipelineLayout(),
+      pipelineLayout,
       kBindPoint_Bindless,
       1,
       &bindlessDSet_.ds,
@@ -1332,19 +2606,188 @@ void VulkanContext::bindDefaultDescriptorSets(VkCommandBuffer cmdBuf,
       nullptr);
 }
 
-void VulkanContext::updateBindingsTextures(VkCommandBuffer cmdBuf,
-                                           VkPipelineBindPoint bindPoint,
-                                           const BindingsTextures& data) const {
-  VkDescriptorSet dset = combinedImageSamplerDSets_.acquireNext(*immediate_);
+void VulkanContext::bindDescriptorBuffers(VkCommandBuffer cmdBuf,
+                                          VulkanTransientDescriptorSets& dsets,
+                                          VkPipelineBindPoint bindPoint,
+                                          VkPipelineLayout pipelineLayout) const {
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  IGL_ASSERT(useDescriptorBuffers_ && dsets.descriptorBuffer);
+
+  // index 0 holds the transient sets, index 1 the bindless set
+  const std::array<VkDescriptorBufferBindingInfoEXT, 2> bindings = {
+      VkDescriptorBufferBindingInfoEXT{VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                                       nullptr,
+                                       dsets.descriptorBuffer->getVkDeviceAddress(),
+                                       dsets.descriptorBuffer->getUsageFlags()},
+      VkDescriptorBufferBindingInfoEXT{
+          VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+          nullptr,
+          bindlessDescriptorBuffer_ ? bindlessDescriptorBuffer_->getVkDeviceAddress() : 0,
+          kDescriptorBufferUsage},
+  };
+  const uint32_t numBindings = bindlessDescriptorBuffer_ ? 2u : 1u;
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("%p vkCmdBindDescriptorBuffersEXT(%u)\n", cmdBuf, numBindings);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+  vkCmdBindDescriptorBuffersEXT(cmdBuf, numBindings, bindings.data());
+
+  if (bindlessDescriptorBuffer_) {
+    const uint32_t bufferIndex = 1;
+    const VkDeviceSize offset = 0;
+    vkCmdSetDescriptorBufferOffsetsEXT(
+        cmdBuf,
+        bindPoint,
+        pipelineLayout,
+        kBindPoint_Bindless,
+        1,
+        &bufferIndex,
+        &offset);
+  }
+#else
+  (void)cmdBuf;
+  (void)dsets;
+  (void)bindPoint;
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+}
 
-  std::array<VkDescriptorImageInfo, IGL_TEXTURE_SAMPLERS_MAX> infoSampledImages{};
-  uint32_t numImages = 0;
+uint8_t* VulkanContext::bindDescriptorBufferSet(VkCommandBuffer cmdBuf,
+                                                VulkanTransientDescriptorSets& dsets,
+                                                VkPipelineBindPoint bindPoint,
+                                                VkPipelineLayout pipelineLayout,
+                                                uint32_t set,
+                                                const VulkanDescriptorSetLayout& layout) const {
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  IGL_ASSERT(useDescriptorBuffers_ && dsets.descriptorBuffer);
+
+  VkDeviceSize offset = 0;
+  bool isNewBuffer = false;
+  uint8_t* dst = dsets.descriptorBuffer->allocate(
+      *dsets.commands, layout.getDescriptorBufferSize(), offset, isNewBuffer);
+  if (!IGL_VERIFY(dst)) {
+    return nullptr;
+  }
+  if (isNewBuffer) {
+    // ResourcesBinder binds its other sets again once it sees the resize
+    bindDescriptorBuffers(cmdBuf, dsets, bindPoint, pipelineLayout);
+  }
 
-  // use the dummy texture to avoid sparse array
-  VkImageView dummyImageView = textures_[0]->imageView_->getVkImageView();
-  VkSampler dummySampler = samplers_[0]->getVkSampler();
+  const uint32_t bufferIndex = 0;
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("%p vkCmdSetDescriptorBufferOffsetsEXT(%u, %u)\n", cmdBuf, bindPoint, set);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+  vkCmdSetDescriptorBufferOffsetsEXT(
+      cmdBuf,
+      bindPoint,
+      pipelineLayout,
+      set,
+      1,
+      &bufferIndex,
+      &offset);
+
+  return dst;
+#else
+  (void)cmdBuf;
+  (void)dsets;
+  (void)bindPoint;
+  (void)set;
+  (void)layout;
+  return nullptr;
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+}
 
-  const bool isGraphics = bindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS;
+void VulkanContext::writeDescriptors(uint8_t* dst,
+                                     const VulkanDescriptorSetLayout& layout,
+                                     const VkWriteDescriptorSet& write) const {
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  const size_t size = getDescriptorSize(descriptorBufferProperties_, write.descriptorType);
+  // consecutive array elements of a binding are tightly packed
+  uint8_t* ptr = dst + layout.getDescriptorBufferOffset(write.dstBinding) +
+                 VkDeviceSize(write.dstArrayElement) * size;
+
+  VkDescriptorGetInfoEXT info = {VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+  info.type = write.descriptorType;
+
+  for (uint32_t i = 0; i != write.descriptorCount; i++, ptr += size) {
+    const VkDescriptorImageInfo& imageInfo = write.pImageInfo[i];
+    switch (write.descriptorType) {
+    case VK_DESCRIPTOR_TYPE_SAMPLER:
+      info.data.pSampler = &imageInfo.sampler;
+      break;
+    case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+      info.data.pCombinedImageSampler = &imageInfo;
+      break;
+    case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+      info.data.pSampledImage = &imageInfo;
+      break;
+    case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+      info.data.pStorageImage = &imageInfo;
+      break;
+    case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+      info.data.pInputAttachmentImage = &imageInfo;
+      break;
+    default:
+      IGL_ASSERT_MSG(false, "Buffer descriptors are written with writeBufferDescriptors()");
+      return;
+    }
+    vkGetDescriptorEXT(device_->getVkDevice(), &info, size, ptr);
+  }
+#else
+  (void)dst;
+  (void)layout;
+  (void)write;
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+}
+
+void VulkanContext::writeBufferDescriptors(uint8_t* dst,
+                                           const VulkanDescriptorSetLayout& layout,
+                                           VkDescriptorType type,
+                                           const BindingsBuffers& data) const {
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  IGL_ASSERT(type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+             type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+  const bool isUniform = type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  const size_t size = getDescriptorSize(descriptorBufferProperties_, type);
+  const VulkanBuffer& dummyBuffer = isUniform ? *dummyUniformBuffer_ : *dummyStorageBuffer_;
+  const VkDeviceSize maxRange =
+      isUniform ? getVkPhysicalDeviceProperties().limits.maxUniformBufferRange : VK_WHOLE_SIZE;
+
+  VkDescriptorGetInfoEXT info = {VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+  info.type = type;
+
+  for (uint32_t i = 0; i != IGL_UNIFORM_BLOCKS_BINDING_MAX; i++) {
+    // descriptor buffers need explicit ranges: empty slots use the whole dummy buffer
+    const bool isBound = data.buffers[i].buffer != VK_NULL_HANDLE && data.addresses[i] != 0;
+    const VkDescriptorAddressInfoEXT addressInfo = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+        nullptr,
+        isBound ? data.addresses[i] : dummyBuffer.getVkDeviceAddress(),
+        isBound ? std::min(data.ranges[i], maxRange) : dummyBuffer.getSize(),
+        VK_FORMAT_UNDEFINED,
+    };
+    if (isUniform) {
+      info.data.pUniformBuffer = &addressInfo;
+    } else {
+      info.data.pStorageBuffer = &addressInfo;
+    }
+    vkGetDescriptorEXT(
+        device_->getVkDevice(), &info, size, dst + layout.getDescriptorBufferOffset(i));
+  }
+#else
+  (void)dst;
+  (void)layout;
+  (void)type;
+  (void)data;
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+}
+
+void VulkanContext::getTextureDescriptors(
+    const BindingsTextures& data,
+    bool isGraphics,
+    std::array<VkDescriptorImageInfo, IGL_TEXTURE_SAMPLERS_MAX>& outInfos) const {
+  // use the dummy texture to avoid sparse array
+  VkImageView dummyImageView = dummyImageView_;
+  VkSampler dummySampler = dummySampler_;
 
   for (size_t i = 0; i != IGL_TEXTURE_SAMPLERS_MAX; i++) {
     igl::vulkan::VulkanTexture* texture = data.textures[i];
@@ -1357,16 +2800,52 @@ void VulkanContext::updateBindingsTextures(VkCommandBuffer cmdBuf,
     const bool isTextureAvailable =
         texture && ((texture->image_->samples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT);
     const bool isSampledImage = isTextureAvailable && texture->image_->isSampledImage();
-    infoSampledImages[numImages++] = {isSampledImage ? sampler : dummySampler,
-                                      isSampledImage ? texture->imageView_->getVkImageView()
-                                                     : dummyImageView,
-                                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    outInfos[i] = {isSampledImage ? sampler : dummySampler,
+                   isSampledImage ? texture->imageView_->getVkImageView() : dummyImageView,
+                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
   }
+}
+
+void VulkanContext::updateBindingsTextures(
+    VkCommandBuffer cmdBuf,
+    VulkanTransientDescriptorSets& dsets,
+    VkPipelineBindPoint bindPoint,
+    VkPipelineLayout pipelineLayout,
+    const VulkanDescriptorSetLayout& dslTextures,
+    const BindingsTextures& data) const {
+  IGL_PROFILER_FUNCTION();
+
+  const bool isGraphics = bindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+  std::array<VkDescriptorImageInfo, IGL_TEXTURE_SAMPLERS_MAX> infoSampledImages{};
+  const uint32_t numImages = IGL_TEXTURE_SAMPLERS_MAX;
+  getTextureDescriptors(data, isGraphics, infoSampledImages);
+
+  if (useDescriptorBuffers_) {
+    uint8_t* dst = bindDescriptorBufferSet(
+        cmdBuf, dsets, bindPoint, pipelineLayout, kBindPoint_CombinedImageSamplers, dslTextures);
+    if (dst) {
+      writeDescriptors(dst,
+                       dslTextures,
+                       ivkGetWriteDescriptorSet_ImageInfo(VK_NULL_HANDLE,
+                                                          0,
+                                                          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                                          numImages,
+                                                          infoSampledImages.data()));
+      frameStatistics_.add(FrameStatisticsTracker::DescriptorUpdates);
+    }
+    return;
+  }
+
+  // layouts with immutable samplers have the same descriptors as the layout of the allocator
+  VkDescriptorSet dset = dsets.combinedImageSamplers->acquireNext(
+      *dsets.commands, dslTextures.getVkDescriptorSetLayout());
 
   VkWriteDescriptorSet write = ivkGetWriteDescriptorSet_ImageInfo(
       dset, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, numImages, infoSampledImages.data());
 
   vkUpdateDescriptorSets(device_->getVkDevice(), 1, &write, 0, nullptr);
+  frameStatistics_.add(FrameStatisticsTracker::DescriptorUpdates);
 
 #if IGL_VULKAN_PRINT_COMMANDS
   IGL_LOG_INFO("%p vkCmdBindDescriptorSets(%u) - textures\n", cmdBuf, bindPoint);
@@ -1374,7 +2853,7 @@ void VulkanContext::updateBindingsTextures(VkCommandBuffer cmdBuf,
   vkCmdBindDescriptorSets(
       cmdBuf,
       bindPoint,
-      (isGraphics ? pipelineLayoutGraphics_ : pipelineLayoutCompute_)->getVkPipelineLayout(),
+      pipelineLayout,
       kBindPoint_CombinedImageSamplers,
       1,
       &dset,
@@ -1382,10 +2861,190 @@ void VulkanContext::updateBindingsTextures(VkCommandBuffer cmdBuf,
       nullptr);
 }
 
-void VulkanContext::updateBindingsUniformBuffers(VkCommandBuffer cmdBuf,
-                                                 VkPipelineBindPoint bindPoint,
-                                                 BindingsBuffers& data) const {
-  VkDescriptorSet dsetBufUniform = bufferUniformDSets_.acquireNext(*immediate_);
+VkDescriptorSet VulkanContext::createPersistentTexturesDescriptorSet(
+    const BindingsTextures& data,
+    const char* debugName,
+    VkDescriptorPool& outPool) const {
+  IGL_PROFILER_FUNCTION();
+
+  outPool = VK_NULL_HANDLE;
+  if (useDescriptorBuffers_) {
+    // descriptor buffer set layouts cannot be allocated from descriptor pools
+    return VK_NULL_HANDLE;
+  }
+
+  VkDevice device = device_->getVkDevice();
+  const VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                         IGL_TEXTURE_SAMPLERS_MAX};
+  VkDescriptorPool pool = VK_NULL_HANDLE;
+  if (ivkCreateDescriptorPool(device, 1, 1, &poolSize, &pool) != VK_SUCCESS) {
+    return VK_NULL_HANDLE;
+  }
+  VkDescriptorSet dset = VK_NULL_HANDLE;
+  if (ivkAllocateDescriptorSet(
+          device, pool, dslCombinedImageSamplers_->getVkDescriptorSetLayout(), &dset) !=
+      VK_SUCCESS) {
+    vkDestroyDescriptorPool(device, pool, nullptr);
+    return VK_NULL_HANDLE;
+  }
+  VK_ASSERT(
+      ivkSetDebugObjectName(device, VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)dset, debugName));
+
+  std::array<VkDescriptorImageInfo, IGL_TEXTURE_SAMPLERS_MAX> infoSampledImages{};
+  const uint32_t numImages = IGL_TEXTURE_SAMPLERS_MAX;
+  getTextureDescriptors(data, true, infoSampledImages);
+  const VkWriteDescriptorSet write = ivkGetWriteDescriptorSet_ImageInfo(
+      dset, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, numImages, infoSampledImages.data());
+  vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+  frameStatistics_.add(FrameStatisticsTracker::DescriptorUpdates);
+
+  outPool = pool;
+  return dset;
+}
+
+void VulkanContext::bindTexturesDescriptorSet(VkCommandBuffer cmdBuf,
+                                              VkPipelineBindPoint bindPoint,
+                                              VkPipelineLayout pipelineLayout,
+                                              VkDescriptorSet dset) const {
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("%p vkCmdBindDescriptorSets(%u) - persistent textures\n", cmdBuf, bindPoint);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+  vkCmdBindDescriptorSets(cmdBuf,
+                          bindPoint,
+                          pipelineLayout,
+                          kBindPoint_CombinedImageSamplers,
+                          1,
+                          &dset,
+                          0,
+                          nullptr);
+}
+
+void VulkanContext::updateBindingsInputAttachments(VkCommandBuffer cmdBuf,
+                                                   VulkanTransientDescriptorSets& dsets,
+                                                   VkPipelineLayout pipelineLayout,
+                                                   uint32_t numViews,
+                                                   const VkImageView* views) const {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(dslInputAttachments_) || numViews == 0) {
+    return;
+  }
+  IGL_ASSERT(numViews <= IGL_COLOR_ATTACHMENTS_MAX);
+
+  std::array<VkDescriptorImageInfo, IGL_COLOR_ATTACHMENTS_MAX> infoInputAttachments{};
+  for (uint32_t i = 0; i != numViews; i++) {
+    infoInputAttachments[i] = {VK_NULL_HANDLE, views[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+  }
+
+  if (useDescriptorBuffers_) {
+    uint8_t* dst = bindDescriptorBufferSet(cmdBuf,
+                                           dsets,
+                                           VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                           pipelineLayout,
+                                           kBindPoint_InputAttachments,
+                                           *dslInputAttachments_);
+    if (dst) {
+      writeDescriptors(dst,
+                       *dslInputAttachments_,
+                       ivkGetWriteDescriptorSet_ImageInfo(VK_NULL_HANDLE,
+                                                          0,
+                                                          VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
+                                                          numViews,
+                                                          infoInputAttachments.data()));
+      frameStatistics_.add(FrameStatisticsTracker::DescriptorUpdates);
+    }
+    return;
+  }
+
+  VkDescriptorSet dset = dsets.inputAttachments->acquireNext(*dsets.commands);
+
+  const VkWriteDescriptorSet write = ivkGetWriteDescriptorSet_ImageInfo(
+      dset, 0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, numViews, infoInputAttachments.data());
+
+  vkUpdateDescriptorSets(device_->getVkDevice(), 1, &write, 0, nullptr);
+  frameStatistics_.add(FrameStatisticsTracker::DescriptorUpdates);
+
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("%p vkCmdBindDescriptorSets() - input attachments\n", cmdBuf);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+  vkCmdBindDescriptorSets(cmdBuf,
+                          VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          pipelineLayout,
+                          kBindPoint_InputAttachments,
+                          1,
+                          &dset,
+                          0,
+                          nullptr);
+}
+
+VkDescriptorSet VulkanContext::updateBindingsUniformBuffers(
+    VkCommandBuffer cmdBuf,
+    VulkanTransientDescriptorSets& dsets,
+    VkPipelineBindPoint bindPoint,
+    VkPipelineLayout pipelineLayout,
+    BindingsBuffers& data) const {
+  IGL_PROFILER_FUNCTION();
+
+  if (usePushDescriptors_) {
+    // no set to allocate: the bindings are recorded into the command buffer
+    for (VkDescriptorBufferInfo& bi : data.buffers) {
+      if (bi.buffer == VK_NULL_HANDLE) {
+        bi = {dummyUniformBuffer_->getVkBuffer(), 0, VK_WHOLE_SIZE};
+      }
+    }
+    const VkWriteDescriptorSet write =
+        ivkGetWriteDescriptorSet_BufferInfo(VK_NULL_HANDLE,
+                                            0,
+                                            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                            IGL_UNIFORM_BLOCKS_BINDING_MAX,
+                                            data.buffers);
+#if IGL_VULKAN_PRINT_COMMANDS
+    IGL_LOG_INFO("%p vkCmdPushDescriptorSetKHR(%u) - uniform buffers\n", cmdBuf, bindPoint);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+    vkCmdPushDescriptorSetKHR(
+        cmdBuf,
+        bindPoint,
+        pipelineLayout,
+        kBindPoint_BuffersUniform,
+        1,
+        &write);
+    frameStatistics_.add(FrameStatisticsTracker::DescriptorUpdates);
+    return VK_NULL_HANDLE;
+  }
+
+  if (useDescriptorBuffers_) {
+    // writing the descriptors is as cheap as copying a default set
+    uint8_t* dst = bindDescriptorBufferSet(
+        cmdBuf, dsets, bindPoint, pipelineLayout, kBindPoint_BuffersUniform, *dslBuffersUniform_);
+    if (dst) {
+      writeBufferDescriptors(dst, *dslBuffersUniform_, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, data);
+      frameStatistics_.add(FrameStatisticsTracker::DescriptorUpdates);
+    }
+    return VK_NULL_HANDLE;
+  }
+
+  if (std::all_of(std::begin(data.buffers), std::end(data.buffers), [](const auto& bi) {
+        return bi.buffer == VK_NULL_HANDLE;
+      })) {
+    // nothing was bound: skip allocating and updating a descriptor set
+#if IGL_VULKAN_PRINT_COMMANDS
+    IGL_LOG_INFO("%p vkCmdBindDescriptorSets(%u) - default uniform buffers\n", cmdBuf, bindPoint);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+    // all dynamic offsets are 0 while nothing is bound
+    const std::array<uint32_t, IGL_UNIFORM_BLOCKS_BINDING_MAX> dynamicOffsets = {};
+    vkCmdBindDescriptorSets(
+        cmdBuf,
+        bindPoint,
+        pipelineLayout,
+        kBindPoint_BuffersUniform,
+        1,
+        &dsetDefaultBuffersUniform_,
+        numDynamicUniformBuffers_,
+        dynamicOffsets.data());
+    return dsetDefaultBuffersUniform_;
+  }
+
+  VkDescriptorSet dsetBufUniform = dsets.buffersUniform->acquireNext(*dsets.commands);
 
   for (uint32_t i = 0; i != IGL_UNIFORM_BLOCKS_BINDING_MAX; i++) {
     VkDescriptorBufferInfo& bi = data.buffers[i];
@@ -1394,35 +3053,75 @@ void VulkanContext::updateBindingsUniformBuffers(VkCommandBuffer cmdBuf,
     }
   }
 
-  VkWriteDescriptorSet write =
-      ivkGetWriteDescriptorSet_BufferInfo(dsetBufUniform,
-                                          0,
-                                          VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                                          IGL_UNIFORM_BLOCKS_BINDING_MAX,
-                                          data.buffers);
+  std::array<VkWriteDescriptorSet, 2> writes = {};
+  const uint32_t numWrites =
+      getUniformBufferWrites(dsetBufUniform, numDynamicUniformBuffers_, data.buffers, writes);
 
-  vkUpdateDescriptorSets(device_->getVkDevice(), 1, &write, 0, nullptr);
+  vkUpdateDescriptorSets(device_->getVkDevice(), numWrites, writes.data(), 0, nullptr);
+  frameStatistics_.add(FrameStatisticsTracker::DescriptorUpdates);
 
-  const bool isGraphics = bindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS;
+  bindDynamicUniformBufferOffsets(cmdBuf, bindPoint, pipelineLayout, dsetBufUniform, data);
+
+  return dsetBufUniform;
+}
 
+void VulkanContext::bindDynamicUniformBufferOffsets(VkCommandBuffer cmdBuf,
+                                                    VkPipelineBindPoint bindPoint,
+                                                    VkPipelineLayout pipelineLayout,
+                                                    VkDescriptorSet dset,
+                                                    const BindingsBuffers& data) const {
 #if IGL_VULKAN_PRINT_COMMANDS
   IGL_LOG_INFO("%p vkCmdBindDescriptorSets(%u) - uniform buffers\n", cmdBuf, bindPoint);
 #endif // IGL_VULKAN_PRINT_COMMANDS
   vkCmdBindDescriptorSets(
       cmdBuf,
       bindPoint,
-      (isGraphics ? pipelineLayoutGraphics_ : pipelineLayoutCompute_)->getVkPipelineLayout(),
+      pipelineLayout,
       kBindPoint_BuffersUniform,
       1,
-      &dsetBufUniform,
-      0,
-      nullptr);
+      &dset,
+      numDynamicUniformBuffers_,
+      data.dynamicOffsets);
 }
 
-void VulkanContext::updateBindingsStorageBuffers(VkCommandBuffer cmdBuf,
-                                                 VkPipelineBindPoint bindPoint,
-                                                 BindingsBuffers& data) const {
-  VkDescriptorSet dsetBufStorage = bufferStorageDSets_.acquireNext(*immediate_);
+void VulkanContext::updateBindingsStorageBuffers(
+    VkCommandBuffer cmdBuf,
+    VulkanTransientDescriptorSets& dsets,
+    VkPipelineBindPoint bindPoint,
+    VkPipelineLayout pipelineLayout,
+    BindingsBuffers& data) const {
+  IGL_PROFILER_FUNCTION();
+
+  if (useDescriptorBuffers_) {
+    uint8_t* dst = bindDescriptorBufferSet(
+        cmdBuf, dsets, bindPoint, pipelineLayout, kBindPoint_BuffersStorage, *dslBuffersStorage_);
+    if (dst) {
+      writeBufferDescriptors(dst, *dslBuffersStorage_, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, data);
+      frameStatistics_.add(FrameStatisticsTracker::DescriptorUpdates);
+    }
+    return;
+  }
+
+  if (std::all_of(std::begin(data.buffers), std::end(data.buffers), [](const auto& bi) {
+        return bi.buffer == VK_NULL_HANDLE;
+      })) {
+    // nothing was bound: skip allocating and updating a descriptor set
+#if IGL_VULKAN_PRINT_COMMANDS
+    IGL_LOG_INFO("%p vkCmdBindDescriptorSets(%u) - default storage buffers\n", cmdBuf, bindPoint);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+    vkCmdBindDescriptorSets(
+        cmdBuf,
+        bindPoint,
+        pipelineLayout,
+        kBindPoint_BuffersStorage,
+        1,
+        &dsetDefaultBuffersStorage_,
+        0,
+        nullptr);
+    return;
+  }
+
+  VkDescriptorSet dsetBufStorage = dsets.buffersStorage->acquireNext(*dsets.commands);
 
   for (uint32_t i = 0; i != IGL_UNIFORM_BLOCKS_BINDING_MAX; i++) {
     VkDescriptorBufferInfo& bi = data.buffers[i];
@@ -1439,8 +3138,7 @@ void VulkanContext::updateBindingsStorageBuffers(VkCommandBuffer cmdBuf,
                                           data.buffers);
 
   vkUpdateDescriptorSets(device_->getVkDevice(), 1, &write, 0, nullptr);
-
-  const bool isGraphics = bindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS;
+  frameStatistics_.add(FrameStatisticsTracker::DescriptorUpdates);
 
 #if IGL_VULKAN_PRINT_COMMANDS
   IGL_LOG_INFO("%p vkCmdBindDescriptorSets(%u) - storage buffers\n", cmdBuf, bindPoint);
@@ -1448,7 +3146,7 @@ void VulkanContext::updateBindingsStorageBuffers(VkCommandBuffer cmdBuf,
   vkCmdBindDescriptorSets(
       cmdBuf,
       bindPoint,
-      (isGraphics ? pipelineLayoutGraphics_ : pipelineLayoutCompute_)->getVkPipelineLayout(),
+      pipelineLayout,
       kBindPoint_BuffersStorage,
       1,
       &dsetBufStorage,
@@ -1456,40 +3154,372 @@ void VulkanContext::updateBindingsStorageBuffers(VkCommandBuffer cmdBuf,
       nullptr);
 }
 
-void VulkanContext::markSubmit(const VulkanImmediateCommands::SubmitHandle& handle) const {
+void VulkanContext::markSubmit(const VulkanImmediateCommands::SubmitHandle& handle,
+                               bool isAsyncCompute) const {
+  if (isAsyncCompute) {
+    computeTransientDSets_[handle.bufferIndex_].markSubmit(handle);
+    return;
+  }
   if (config_.enableDescriptorIndexing) {
     bindlessDSet_.handle = handle;
   }
-  combinedImageSamplerDSets_.updateHandles(handle);
-  bufferUniformDSets_.updateHandles(handle);
-  bufferStorageDSets_.updateHandles(handle);
+  transientDSets_[handle.bufferIndex_].markSubmit(handle);
+}
+
+void VulkanContext::setSharingMode(VkSharingMode& outSharingMode,
+                                   uint32_t& outQueueFamilyIndexCount,
+                                   const uint32_t*& outQueueFamilyIndices) const {
+  if (concurrentQueueFamilyIndices_.empty()) {
+    return;
+  }
+  outSharingMode = VK_SHARING_MODE_CONCURRENT;
+  outQueueFamilyIndexCount = static_cast<uint32_t>(concurrentQueueFamilyIndices_.size());
+  outQueueFamilyIndices = concurrentQueueFamilyIndices_.data();
+}
+
+bool VulkanContext::isReady(SubmitHandle handle, SubmitHandle computeHandle) const {
+  return immediate_->isReady(handle, true) &&
+         (!computeImmediate_ || computeImmediate_->isReady(computeHandle, true));
+}
+
+VulkanTransientDescriptorSets VulkanContext::createTransientDescriptorSets(
+    const std::string& debugName,
+    VulkanImmediateCommands* commands) const {
+  VkDevice device = device_->getVkDevice();
+
+  VulkanTransientDescriptorSets dsets;
+  dsets.commands = commands ? commands : immediate_.get();
+  dsets.uniformArena = std::make_unique<VulkanUniformArena>(
+      *this,
+      std::min<VkDeviceSize>(kUniformArenaBlockSize,
+                             getVkPhysicalDeviceProperties().limits.maxUniformBufferRange),
+      (debugName + ".uniformArena").c_str());
+
+  if (useDescriptorBuffers_) {
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+    // all sets of the command buffer are allocated from one descriptor buffer
+    dsets.descriptorBuffer = std::make_unique<VulkanDescriptorBuffer>(
+        *this,
+        kDescriptorBufferSize,
+        kDescriptorBufferUsage,
+        descriptorBufferProperties_.descriptorBufferOffsetAlignment,
+        (debugName + ".descriptorBuffer").c_str());
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+    return dsets;
+  }
+
+  dsets.combinedImageSamplers = std::make_unique<VulkanDescriptorSetAllocator>(
+      device,
+      dslCombinedImageSamplers_->getVkDescriptorSetLayout(),
+      VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+      IGL_TEXTURE_SAMPLERS_MAX,
+      kNumDescriptorSetsPerPool,
+      (debugName + ".combinedImageSamplers").c_str());
+  std::vector<VkDescriptorPoolSize> uniformDescriptors;
+  if (numDynamicUniformBuffers_) {
+    uniformDescriptors.push_back(
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, numDynamicUniformBuffers_});
+  }
+  if (numDynamicUniformBuffers_ < IGL_UNIFORM_BLOCKS_BINDING_MAX) {
+    uniformDescriptors.push_back(
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+         IGL_UNIFORM_BLOCKS_BINDING_MAX - numDynamicUniformBuffers_});
+  }
+  dsets.buffersUniform = std::make_unique<VulkanDescriptorSetAllocator>(
+      device,
+      dslBuffersUniform_->getVkDescriptorSetLayout(),
+      std::move(uniformDescriptors),
+      kNumDescriptorSetsPerPool,
+      (debugName + ".buffersUniform").c_str());
+  dsets.buffersStorage = std::make_unique<VulkanDescriptorSetAllocator>(
+      device,
+      dslBuffersStorage_->getVkDescriptorSetLayout(),
+      VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      IGL_UNIFORM_BLOCKS_BINDING_MAX,
+      kNumDescriptorSetsPerPool,
+      (debugName + ".buffersStorage").c_str());
+  if (dslInputAttachments_) {
+    dsets.inputAttachments = std::make_unique<VulkanDescriptorSetAllocator>(
+        device,
+        dslInputAttachments_->getVkDescriptorSetLayout(),
+        VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
+        IGL_COLOR_ATTACHMENTS_MAX,
+        kNumDescriptorSetsPerPool,
+        (debugName + ".inputAttachments").c_str());
+  }
+
+  return dsets;
 }
 
-void VulkanContext::deferredTask(std::packaged_task<void()>&& task, SubmitHandle handle) const {
+VulkanContext::SecondaryCommandBuffer* VulkanContext::acquireSecondaryCommandBuffer() const {
+  IGL_PROFILER_FUNCTION();
+
+  SecondaryCommandBuffer* buffer = nullptr;
+  bool isNew = false;
+
+  {
+    std::lock_guard<std::mutex> lock(secondaryCommandBuffersMutex_);
+
+    for (const auto& b : secondaryCommandBuffers_) {
+      if (!b->isRecording && immediate_->isReady(b->handle)) {
+        buffer = b.get();
+        break;
+      }
+    }
+
+    if (!buffer) {
+      const size_t index = secondaryCommandBuffers_.size();
+      auto b = std::make_unique<SecondaryCommandBuffer>();
+      b->pool = std::make_unique<VulkanCommandPool>(
+          device_->getVkDevice(),
+          VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+          deviceQueues_.graphicsQueueFamilyIndex,
+          IGL_FORMAT("Command Pool: secondary #{}", index).c_str());
+      b->dsets = createTransientDescriptorSets(
+          IGL_FORMAT("VulkanContext::secondaryCommandBuffers_[{}]", index));
+      buffer = b.get();
+      secondaryCommandBuffers_.emplace_back(std::move(b));
+      isNew = true;
+    }
+
+    buffer->isRecording = true;
+  }
+
+  // the buffer is owned by the calling thread from now on
+  if (isNew) {
+    const VkCommandBufferAllocateInfo ai = {
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        nullptr,
+        buffer->pool->getVkCommandPool(),
+        VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+        1,
+    };
+    VK_ASSERT(vkAllocateCommandBuffers(device_->getVkDevice(), &ai, &buffer->cmdBuf));
+  } else {
+    VK_ASSERT(vkResetCommandPool(device_->getVkDevice(), buffer->pool->getVkCommandPool(), 0));
+  }
+
+  return buffer;
+}
+
+void VulkanContext::releaseSecondaryCommandBuffer(SecondaryCommandBuffer* buffer,
+                                                  SubmitHandle handle) const {
+  IGL_ASSERT(buffer && buffer->isRecording);
+
+  buffer->dsets.markSubmit(handle);
+
+  std::lock_guard<std::mutex> lock(secondaryCommandBuffersMutex_);
+
+  buffer->handle = handle;
+  buffer->isRecording = false;
+}
+
+void VulkanContext::deferredTask(std::packaged_task<void()>&& task,
+                                 SubmitHandle handle,
+                                 bool onSubmittingThread) const {
   if (handle.empty()) {
     handle = immediate_->getLastSubmitHandle();
   }
-  deferredTasks_.emplace_back(std::move(task), handle);
+  // resources can be in use by dispatches on the async compute queue
+  const SubmitHandle computeHandle =
+      computeImmediate_ ? computeImmediate_->getLastSubmitHandle() : SubmitHandle();
+  std::lock_guard<std::mutex> lock(deferredTasksMutex_);
+  deferredTasks_.emplace_back(std::move(task), handle, computeHandle, onSubmittingThread);
 }
 
 bool VulkanContext::areValidationLayersEnabled() const {
   return config_.enableValidation;
 }
 
+VkPipelineCreateFlags VulkanContext::getPipelineCreateFlags() const {
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  if (useDescriptorBuffers_) {
+    return VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+  }
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  return 0;
+}
+
+bool VulkanContext::canUseHostImageCopy(VkFormat format,
+                                        VkImageType type,
+                                        VkImageUsageFlags usage,
+                                        VkImageCreateFlags flags) const {
+  if (!useHostImageCopy_) {
+    return false;
+  }
+#if IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+  VkFormatProperties3 formatProps3 = {};
+  formatProps3.sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_3;
+  VkFormatProperties2 formatProps = {};
+  formatProps.sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2;
+  formatProps.pNext = &formatProps3;
+  vkGetPhysicalDeviceFormatProperties2(vkPhysicalDevice_, format, &formatProps);
+  if ((formatProps3.optimalTilingFeatures & VK_FORMAT_FEATURE_2_HOST_IMAGE_TRANSFER_BIT_EXT) == 0) {
+    return false;
+  }
+
+  // some drivers lay out images which can be copied on the host less efficiently for the GPU
+  const VkPhysicalDeviceImageFormatInfo2 imageInfo = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_FORMAT_INFO_2,
+      nullptr,
+      format,
+      type,
+      VK_IMAGE_TILING_OPTIMAL,
+      usage | VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT,
+      flags,
+  };
+  VkHostImageCopyDevicePerformanceQueryEXT performanceQuery = {};
+  performanceQuery.sType = VK_STRUCTURE_TYPE_HOST_IMAGE_COPY_DEVICE_PERFORMANCE_QUERY_EXT;
+  VkImageFormatProperties2 imageProps = {};
+  imageProps.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_PROPERTIES_2;
+  imageProps.pNext = &performanceQuery;
+  if (vkGetPhysicalDeviceImageFormatProperties2(vkPhysicalDevice_, &imageInfo, &imageProps) !=
+      VK_SUCCESS) {
+    return false;
+  }
+  return performanceQuery.optimalDeviceAccess == VK_TRUE;
+#else
+  (void)format;
+  (void)type;
+  (void)usage;
+  (void)flags;
+  return false;
+#endif // IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+}
+
 void* VulkanContext::getVmaAllocator() const {
   return pimpl_->vma_;
 }
 
+std::unique_ptr<VulkanDescriptorSetLayout> VulkanContext::createTexturesDescriptorSetLayout(
+    const VkSampler* immutableSamplers,
+    const char* debugName) const {
+  // NOTE: we really want these arrays to be uninitialized
+  // @lint-ignore CLANGTIDY
+  VkDescriptorSetLayoutBinding bindings[IGL_TEXTURE_SAMPLERS_MAX];
+  // @lint-ignore CLANGTIDY
+  VkDescriptorBindingFlags bindingFlags[IGL_TEXTURE_SAMPLERS_MAX];
+  for (uint32_t i = 0; i != IGL_TEXTURE_SAMPLERS_MAX; i++) {
+    bindings[i] = ivkGetDescriptorSetLayoutBinding(i, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1);
+    if (immutableSamplers && immutableSamplers[i] != VK_NULL_HANDLE) {
+      // the sampler of the descriptors written into this slot is ignored
+      bindings[i].pImmutableSamplers = &immutableSamplers[i];
+    }
+    bindingFlags[i] = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+  }
+  return std::make_unique<VulkanDescriptorSetLayout>(device_->getVkDevice(),
+                                                     IGL_TEXTURE_SAMPLERS_MAX,
+                                                     bindings,
+                                                     bindingFlags,
+                                                     debugName,
+                                                     false,
+                                                     useDescriptorBuffers_);
+}
+
+std::unique_ptr<VulkanPipelineLayout> VulkanContext::createPipelineLayout(
+    VkDescriptorSetLayout dslTextures,
+    VkPipelineBindPoint bindPoint,
+    const char* debugName) const {
+  // @lint-ignore CLANGTIDY
+  const VkDescriptorSetLayout DSLs[] = {
+      dslTextures,
+      dslBuffersUniform_->getVkDescriptorSetLayout(),
+      dslBuffersStorage_->getVkDescriptorSetLayout(),
+      config_.enableDescriptorIndexing ? dslBindless_->getVkDescriptorSetLayout()
+      : dslEmpty_                      ? dslEmpty_->getVkDescriptorSetLayout()
+                                       : VK_NULL_HANDLE,
+      dslInputAttachments_ ? dslInputAttachments_->getVkDescriptorSetLayout() : VK_NULL_HANDLE,
+  };
+  const uint32_t numDSLsCompute = config_.enableDescriptorIndexing ? kBindPoint_Bindless + 1
+                                                                   : kBindPoint_Bindless;
+  const uint32_t numDSLsGraphics =
+      dslInputAttachments_ ? kBindPoint_InputAttachments + 1 : numDSLsCompute;
+
+  const bool isGraphics = bindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+  return std::make_unique<VulkanPipelineLayout>(
+      device_->getVkDevice(),
+      DSLs,
+      isGraphics ? numDSLsGraphics : numDSLsCompute,
+      ivkGetPushConstantRange(isGraphics ? VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT
+                                         : VK_SHADER_STAGE_COMPUTE_BIT,
+                              0,
+                              kPushConstantsSize),
+      debugName);
+}
+
+const VulkanMipmapGenerator& VulkanContext::getMipmapGenerator() const {
+  std::lock_guard<std::mutex> lock(mipmapGeneratorMutex_);
+  if (!mipmapGenerator_) {
+    mipmapGenerator_ = std::make_unique<VulkanMipmapGenerator>(*this);
+  }
+  return *mipmapGenerator_;
+}
+
 void VulkanContext::processDeferredTasks() const {
-  while (!deferredTasks_.empty() && immediate_->isReady(deferredTasks_.front().handle_, true)) {
-    deferredTasks_.front().task_();
+  std::unique_lock<std::mutex> lock(deferredTasksMutex_);
+
+  if (deferredTasksPool_) {
+    // tasks which only destroy the Vulkan objects they own can run on any thread; completion
+    // handlers and tasks touching other objects stay on this thread
+    auto tasks = std::make_shared<std::vector<std::packaged_task<void()>>>();
+    std::vector<std::packaged_task<void()>> localTasks;
+    while (!deferredTasks_.empty() &&
+           isReady(deferredTasks_.front().handle_, deferredTasks_.front().computeHandle_)) {
+      auto& retired = deferredTasks_.front().onSubmittingThread_ ? localTasks : *tasks;
+      retired.push_back(std::move(deferredTasks_.front().task_));
+      deferredTasks_.pop_front();
+    }
+    lock.unlock();
+    frameStatistics_.add(FrameStatisticsTracker::DeferredTasks, tasks->size() + localTasks.size());
+    if (!tasks->empty()) {
+      deferredTasksPool_->enqueue([tasks]() {
+        for (auto& task : *tasks) {
+          task();
+        }
+      });
+    }
+    for (auto& task : localTasks) {
+      task();
+    }
+    return;
+  }
+
+  const auto startTime = std::chrono::steady_clock::now();
+  const auto timeBudget = std::chrono::microseconds(config_.deferredTasksTimeBudgetUs);
+
+  uint32_t numTasks = 0;
+
+  while (!deferredTasks_.empty() &&
+         isReady(deferredTasks_.front().handle_, deferredTasks_.front().computeHandle_)) {
+    if (config_.maxDeferredTasksPerSubmit && numTasks >= config_.maxDeferredTasksPerSubmit) {
+      break;
+    }
+    if (config_.deferredTasksTimeBudgetUs && numTasks &&
+        std::chrono::steady_clock::now() - startTime >= timeBudget) {
+      break;
+    }
+    std::packaged_task<void()> task = std::move(deferredTasks_.front().task_);
     deferredTasks_.pop_front();
+    // a task can release resources which schedule more deferred tasks
+    lock.unlock();
+    task();
+    lock.lock();
+    numTasks++;
   }
+
+  frameStatistics_.add(FrameStatisticsTracker::DeferredTasks, numTasks);
 }
 
 void VulkanContext::waitDeferredTasks() {
+  // tasks handed over to the background thread are finished first
+  deferredTasksPool_.reset(nullptr);
+
   for (auto& task : deferredTasks_) {
     immediate_->wait(task.handle_);
+    if (computeImmediate_) {
+      computeImmediate_->wait(task.computeHandle_);
+    }
     task.task_();
   }
   deferredTasks_.clear();
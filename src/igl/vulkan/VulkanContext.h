@@ -7,13 +7,20 @@
 
 #pragma once
 
+#include <array>
 #include <deque>
 #include <future>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
+#include <igl/FrameStatistics.h>
 #include <igl/HWDevice.h>
 #include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanDescriptorSetAllocator.h>
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanExtensions.h>
 #include <igl/vulkan/VulkanHelpers.h>
@@ -21,21 +28,31 @@
 #include <igl/vulkan/VulkanQueuePool.h>
 #include <igl/vulkan/VulkanRenderPassBuilder.h>
 #include <igl/vulkan/VulkanStagingDevice.h>
+#include <igl/vulkan/VulkanValidationFilter.h>
 
 namespace igl {
+class WorkerPool;
+
 namespace vulkan {
 
+class BindGroup;
 class Device;
 class EnhancedShaderDebuggingStore;
 class CommandQueue;
 class ComputeCommandEncoder;
+class ParallelRenderCommandEncoder;
+class RenderBundle;
 class RenderCommandEncoder;
+class SpirvCache;
 class SyncManager;
 class VulkanBuffer;
+class VulkanBufferPool;
+class VulkanDefragmenter;
 class VulkanDevice;
 class VulkanDescriptorSetLayout;
 class VulkanImage;
 class VulkanImageView;
+class VulkanMipmapGenerator;
 class VulkanPipelineLayout;
 class VulkanSampler;
 class VulkanSemaphore;
@@ -50,9 +67,14 @@ struct DeviceQueues {
   const static uint32_t INVALID = 0xFFFFFFFF;
   uint32_t graphicsQueueFamilyIndex = INVALID;
   uint32_t computeQueueFamilyIndex = INVALID;
+  uint32_t computeQueueIndex = 0;
+  // a dedicated (non-graphics) queue used by the staging device; INVALID if not available
+  uint32_t transferQueueFamilyIndex = INVALID;
+  uint32_t transferQueueIndex = INVALID;
 
   VkQueue graphicsQueue = VK_NULL_HANDLE;
   VkQueue computeQueue = VK_NULL_HANDLE;
+  VkQueue transferQueue = VK_NULL_HANDLE;
 
   DeviceQueues() = default;
 };
@@ -63,6 +85,13 @@ struct VulkanContextConfig {
   uint32_t maxTextures = 256;
   uint32_t maxSamplers = 256;
   bool terminateOnValidationError = false; // invoke std::terminate() on any validation error
+  // log every validation message ID at most this many times, then only count it (0 - no limit)
+  uint32_t maxValidationMessageRepeats = 0;
+  // log at most this many validation messages per frame (0 - no limit)
+  uint32_t maxValidationMessagesPerFrame = 0;
+  // log through IGLLogSetAsync(), so the validation callback does not wait for I/O; this enables
+  // asynchronous logging for the whole process
+  bool enableAsyncValidationLogging = false;
 
   // enable/disable enhanced shader debugging capabilities (line drawing)
   bool enhancedShaderDebugging = false;
@@ -77,6 +106,22 @@ struct VulkanContextConfig {
   bool enableDescriptorIndexing = false;
 
   igl::ColorSpace swapChainColorSpace = igl::ColorSpace::SRGB_NONLINEAR;
+  // VK_PRESENT_MODE_MAX_ENUM_KHR - IMMEDIATE if supported, then MAILBOX (except on Android), then
+  // FIFO. Other modes the surface does not support fall back to FIFO.
+  VkPresentModeKHR swapchainPresentMode = VK_PRESENT_MODE_MAX_ENUM_KHR;
+  // 0 - one more than the minimum of the surface; clamped to the limits of the surface
+  uint32_t swapchainImageCount = 0;
+  // how long acquiring a swapchain image may block; the frame has no drawable when it times out
+  uint64_t swapchainAcquireTimeoutNs = UINT64_MAX;
+  // with VK_KHR_present_id and VK_KHR_present_wait, wait before acquiring a swapchain image until
+  // at most this many presented frames are not displayed yet (0 - don't wait). 1 gives the lowest
+  // latency, at the cost of the CPU waiting for the display.
+  uint32_t swapchainMaxQueuedFrames = 0;
+  // create the swapchain in the current orientation of the display (Android), which saves the
+  // compositor a rotation pass per frame. The application then has to render rotated by
+  // VulkanContext::getSwapchainPreTransform(), e.g. with PlatformDevice::getPreRotationMatrix().
+  // Otherwise the compositor rotates the images when the display is rotated.
+  bool enableSwapchainPreRotation = false;
 
   std::vector<CommandQueueType> userQueues;
 
@@ -85,6 +130,118 @@ struct VulkanContextConfig {
   // owned by the application - should be alive until initContext() returns
   const void* pipelineCacheData = nullptr;
   size_t pipelineCacheDataSize = 0;
+
+  // Persistent pipeline cache: if not empty, the cache is loaded from this file in initContext()
+  // (when `pipelineCacheData` is not provided) and saved back to it on shutdown. Blobs which do not
+  // match the current physical device (vendor/device/UUID) are discarded.
+  std::string pipelineCacheFilePath;
+  // save the pipeline cache to `pipelineCacheFilePath` every N submits if new pipelines were
+  // created since the last save (0 - save only on shutdown)
+  uint32_t pipelineCacheFlushInterval = 0;
+
+  // load and create the pipeline cache on a worker thread while initContext() creates the other
+  // objects; it is ready before initContext() returns
+  bool enableParallelInit = false;
+
+  // cache SPIR-V compiled from GLSL sources in Device::createShaderModule()
+  bool enableShaderCache = false;
+  // if not empty, compiled SPIR-V is also persisted in this (existing) directory
+  std::string shaderCacheDirectory;
+
+  // build graphics pipelines on worker threads (0 - build synchronously inside the draw call).
+  // Draws are skipped (or use a fallback pipeline) until their pipelines are ready.
+  uint32_t numPipelineCompilationThreads = 0;
+
+  // staging memory is allocated in chunks of this size (larger uploads get their own chunk)...
+  uint32_t stagingBufferChunkSize = 32u * 1024u * 1024u;
+  // ...up to this total; uploads wait for the GPU only when all of it is in flight
+  uint32_t maxStagingBufferSize = 256u * 1024u * 1024u;
+  // host-visible buffers for asynchronous readbacks (Framebuffer::copyBytesColorAttachmentAsync());
+  // the oldest uncollected readback is dropped when all of them are in use
+  uint32_t maxAsyncReadbacks = 3;
+  // upload buffers and textures on a dedicated transfer queue (if the device has one), so large
+  // uploads overlap with rendering; ownership is handed over to the graphics queue before use
+  bool enableDedicatedTransferQueue = false;
+  // submit command buffers of compute command queues to their own queue (if the device has a
+  // compute queue besides the graphics one), so dispatches overlap with rendering. Work on
+  // different queues is ordered with ICommandQueue::signalFence() and waitFence()
+  bool enableAsyncCompute = false;
+  // track command buffer completion with one timeline semaphore per queue instead of fences, if
+  // VK_KHR_timeline_semaphore is supported. PlatformDevice::getVkFenceFromSubmitHandle() and
+  // getFenceFdFromSubmitHandle() are not available in this mode
+  bool enableTimelineSemaphores = false;
+  // gather the command buffers submitted to the graphics queue during a frame and submit them
+  // with one vkQueueSubmit() at the end of the frame, or earlier when something waits for them.
+  // Requires timeline semaphores (see enableTimelineSemaphores); ignored otherwise
+  bool batchSubmits = false;
+  // write the uniform buffer bindings of draws and dispatches straight into command buffers with
+  // vkCmdPushDescriptorSetKHR instead of allocating and updating descriptor sets, if
+  // VK_KHR_push_descriptor is supported. Vulkan allows only one push descriptor set per pipeline
+  // layout, so textures and storage buffers keep using transient descriptor sets
+  bool enablePushDescriptors = false;
+  // bind uniform buffers through VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC descriptors covering
+  // this many bytes (0 - disabled), so binding the same buffer at another offset only rebinds the
+  // descriptor set with new dynamic offsets instead of writing a new one. It has to cover the
+  // largest uniform block read by the shaders; ranges are clipped to the end of the buffers. Only
+  // the first maxDescriptorSetUniformBuffersDynamic slots are dynamic; not used with push
+  // descriptors
+  uint32_t dynamicUniformBufferRange = 0;
+  // write the descriptors of draws and dispatches straight into mapped buffers and bind them by
+  // setting offsets into those buffers, if VK_EXT_descriptor_buffer is supported, instead of
+  // allocating and updating descriptor sets from descriptor pools. Requires
+  // enableBufferDeviceAddress. Push descriptors, dynamic uniform buffers and YUV conversions are
+  // not used with descriptor buffers
+  bool enableDescriptorBuffers = false;
+  // upload texture data with vkCopyMemoryToImageEXT() on the CPU, if VK_EXT_host_image_copy is
+  // supported, instead of copying it into staging memory and submitting vkCmdCopyBufferToImage().
+  // Only used for textures which the driver reports as equally fast for the GPU with host copies,
+  // and only for subresources the GPU has not used yet (e.g. the first upload)
+  bool enableHostImageCopy = false;
+  // compile the vertex input, pre-rasterization, fragment shader and fragment output parts of
+  // graphics pipelines once as pipeline libraries and fast-link them for every new combination of
+  // dynamic states and render passes, if VK_EXT_graphics_pipeline_library supports fast linking.
+  // With numPipelineCompilationThreads > 0, an optimized pipeline is linked on a worker thread and
+  // replaces the fast-linked one once it is ready
+  bool enableGraphicsPipelineLibrary = false;
+  // begin render passes with vkCmdBeginRenderingKHR() on the attachments of the framebuffer and
+  // transition them with vkCmdPipelineBarrier2KHR(), if VK_KHR_dynamic_rendering and
+  // VK_KHR_synchronization2 are supported. No VkRenderPass or VkFramebuffer objects are created
+  // then, and pipelines depend only on the attachment formats. Not used with fragment density maps
+  bool enableDynamicRendering = false;
+  // set the primitive topology, depth and stencil states at draw time with vkCmdSet*() instead of
+  // creating one VkPipeline per combination of them, if VK_EXT_extended_dynamic_state is supported.
+  // The depth bias enable needs VK_EXT_extended_dynamic_state2; pipelines are still created per
+  // topology class (points, lines, triangles) unless VK_EXT_extended_dynamic_state3 lifts that
+  bool enableExtendedDynamicState = false;
+  // create VkFramebuffer objects without image views if VK_KHR_imageless_framebuffer is supported;
+  // the views are passed when render passes begin, so attachments rotating through textures of the
+  // same size, format and usage (e.g. swapchain images) share one framebuffer
+  bool enableImagelessFramebuffers = false;
+  // every igl::vulkan::Framebuffer keeps up to this many VkFramebuffer objects and destroys the
+  // least recently used one to make room (0 - no limit). Has to exceed the number of distinct sets
+  // of attachments one framebuffer renders to in one command buffer
+  uint32_t maxCachedFramebuffers = 16;
+
+  // Deferred tasks (destruction of resources which were in use by the GPU) are retired on every
+  // submit. These limit the work done per submit, so a burst of destructions is spread over
+  // several frames (0 - no limit).
+  uint32_t maxDeferredTasksPerSubmit = 0;
+  uint32_t deferredTasksTimeBudgetUs = 0;
+  // run retired deferred tasks which only destroy Vulkan objects on a background thread instead of
+  // the submitting thread; the limits above are not applied then. Command buffer completion
+  // handlers still run on the submitting thread
+  bool enableDeferredTasksThread = false;
+
+  // At the end of every frame, move up to this many bytes of device-local buffers to compact the
+  // VMA memory blocks which were fragmented by freed allocations (0 - don't defragment). Only
+  // buffers with private storage and no device address are moved; see VulkanDefragmenter.
+  uint32_t defragmentationMaxBytesPerFrame = 0;
+
+  // Buffers of at most this many bytes are sub-allocated from shared VkBuffers of
+  // `bufferPoolBlockSize` bytes instead of getting their own VkBuffer and memory allocation
+  // (0 - don't pool). Ring buffers and buffers with a non-default memory priority are not pooled.
+  uint32_t bufferPoolMaxAllocationSize = 0;
+  uint32_t bufferPoolBlockSize = 4u * 1024u * 1024u;
 };
 
 class VulkanContext final {
@@ -103,6 +260,7 @@ class VulkanContext final {
 
   igl::Result initSwapchain(uint32_t width, uint32_t height);
   VkExtent2D getSwapchainExtent() const;
+  VkSurfaceTransformFlagBitsKHR getSwapchainPreTransform() const;
 
   std::shared_ptr<VulkanImage> createImage(VkImageType imageType,
                                            VkExtent3D extent,
@@ -115,7 +273,8 @@ class VulkanContext final {
                                            VkImageCreateFlags flags,
                                            VkSampleCountFlagBits samples,
                                            igl::Result* outResult,
-                                           const char* debugName = nullptr) const;
+                                           const char* debugName = nullptr,
+                                           float memoryPriority = 0.5f) const;
   std::shared_ptr<VulkanImage> createImageFromFileDescriptor(int32_t fileDescriptor,
                                                              uint64_t memoryAllocationSize,
                                                              VkImageType imageType,
@@ -133,7 +292,8 @@ class VulkanContext final {
                                              VkBufferUsageFlags usageFlags,
                                              VkMemoryPropertyFlags memFlags,
                                              igl::Result* outResult,
-                                             const char* debugName = nullptr) const;
+                                             const char* debugName = nullptr,
+                                             float memoryPriority = 0.5f) const;
   std::shared_ptr<VulkanTexture> createTexture(std::shared_ptr<VulkanImage> image,
                                                std::shared_ptr<VulkanImageView> imageView) const;
   std::shared_ptr<VulkanSampler> createSampler(const VkSamplerCreateInfo& ci,
@@ -157,14 +317,27 @@ class VulkanContext final {
 
   VkFormat getClosestDepthStencilFormat(igl::TextureFormat desiredFormat) const;
 
+  /// The format sampled textures of `format` are stored in when the device cannot sample it, e.g.
+  /// RGBA_UNorm8 for 24-bit RGBX_UNorm8. Uploads are converted with igl::convertTexels() and
+  /// `outComponents` maps the components back. Invalid when `format` is stored as it is.
+  igl::TextureFormat getUploadConversionFormat(igl::TextureFormat format,
+                                               VkComponentMapping* outComponents) const;
+
+  // `index` identifies the class of compatible render passes `pass` belongs to: pipelines and
+  // framebuffers are shared by all the render passes of a class
   struct RenderPassHandle {
     VkRenderPass pass = VK_NULL_HANDLE;
-    uint8_t index = 0;
+    uint16_t index = 0;
   };
 
   // render passes are owned and managed by the context
   RenderPassHandle findRenderPass(const VulkanRenderPassBuilder& builder) const;
-  RenderPassHandle getRenderPass(uint8_t index) const;
+  // the first render pass created in the class of compatible render passes `index`
+  RenderPassHandle getRenderPass(uint16_t index) const;
+  // Destroys the render passes which were not returned by findRenderPass() since the previous call,
+  // once the GPU is done with them; returns their number. The first render pass of each class is
+  // kept. Call it between frames, e.g. every few hundred frames.
+  size_t pruneRenderPasses() const;
 
   // OpenXR needs Vulkan instance to find physical device
   VkInstance getVkInstance() const {
@@ -176,40 +349,158 @@ class VulkanContext final {
   VkPhysicalDevice getVkPhysicalDevice() const {
     return vkPhysicalDevice_;
   }
+  bool usesTimelineSemaphores() const {
+    return useTimelineSemaphores_;
+  }
+  bool usesFragmentDensityMap() const {
+    return useFragmentDensityMap_;
+  }
+  bool usesPresentWait() const {
+    return usePresentWait_;
+  }
+  bool usesDynamicRendering() const {
+    return useDynamicRendering_;
+  }
+  // subpasses can read input attachments from descriptor set 4
+  bool hasInputAttachments() const {
+    return dslInputAttachments_ != nullptr;
+  }
+  // VK_RESOLVE_MODE_SAMPLE_ZERO_BIT_KHR is always supported with dynamic rendering
+  VkFlags getSupportedDepthResolveModes() const {
+    return supportedDepthResolveModes_;
+  }
+  bool usesExtendedDynamicState() const {
+    return useExtendedDynamicState_;
+  }
+  bool usesImagelessFramebuffers() const {
+    return useImagelessFramebuffers_;
+  }
+  bool usesExtendedDynamicState2() const {
+    return useExtendedDynamicState2_;
+  }
+  bool hasUnrestrictedDynamicPrimitiveTopology() const {
+    return hasUnrestrictedDynamicPrimitiveTopology_;
+  }
+  bool usesGraphicsPipelineLibrary() const {
+    return useGraphicsPipelineLibrary_;
+  }
+  // VK_EXT_subgroup_size_control is enabled for compute shaders, with computeFullSubgroups
+  bool usesSubgroupSizeControl() const {
+    return useSubgroupSizeControl_;
+  }
+  // the conversion used by image views and immutable samplers of a multi-planar YUV format, or
+  // VK_NULL_HANDLE if the format cannot be sampled
+  VkSamplerYcbcrConversion getYcbcrConversion(VkFormat format) const;
 
   std::vector<uint8_t> getPipelineCacheData() const;
+  // checks the VkPipelineCacheHeaderVersionOne header against the current physical device
+  bool isPipelineCacheDataCompatible(const void* data, size_t size) const;
+  // writes the current pipeline cache to a file (via a temporary file, so it is never left
+  // half-written)
+  Result savePipelineCache(const std::string& path) const;
 
   uint64_t getFrameNumber() const;
 
+  // per-frame counters reported by Device::getFrameStatistics()
+  FrameStatisticsTracker& getFrameStatisticsTracker() const {
+    return frameStatistics_;
+  }
+
+  struct StartupStep {
+    const char* name = nullptr;
+    double milliseconds = 0;
+  };
+  // the steps of initContext() in the order they ran; logged if `enableExtraLogs` is set
+  const std::vector<StartupStep>& getStartupSteps() const {
+    return startupSteps_;
+  }
+
+#if defined(IGL_WITH_TRACY_GPU)
+  // GPU zones of command buffers submitted to `immediate_`; null if timestamps are not supported
+  tracy::VkCtx* getTracyContext() const {
+    return tracyCtx_;
+  }
+#endif // IGL_WITH_TRACY_GPU
+
   using SubmitHandle = VulkanImmediateCommands::SubmitHandle;
 
-  // execute a task some time in the future after the submit handle finished processing
-  void deferredTask(std::packaged_task<void()>&& task, SubmitHandle handle = SubmitHandle()) const;
+  // execute a task some time in the future after the submit handle finished processing, together
+  // with everything submitted to the async compute queue so far. Tasks which only destroy Vulkan
+  // objects may run on the deferred tasks thread; `onSubmittingThread` tasks (user callbacks, state
+  // of other objects) always run on a thread which submits command buffers
+  void deferredTask(std::packaged_task<void()>&& task,
+                    SubmitHandle handle = SubmitHandle(),
+                    bool onSubmittingThread = false) const;
 
   bool areValidationLayersEnabled() const;
 
   void* getVmaAllocator() const;
 
+  // VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT with descriptor buffers
+  VkPipelineCreateFlags getPipelineCreateFlags() const;
+
+  // true if images with these parameters can add VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT to `usage`
+  // and be uploaded with host image copies without losing GPU performance
+  bool canUseHostImageCopy(VkFormat format,
+                           VkImageType type,
+                           VkImageUsageFlags usage,
+                           VkImageCreateFlags flags) const;
+
+  // VK_SHARING_MODE_CONCURRENT between the graphics and the async compute queue families if they
+  // differ, so buffers and images need no queue family ownership transfers between them
+  void setSharingMode(VkSharingMode& outSharingMode,
+                      uint32_t& outQueueFamilyIndexCount,
+                      const uint32_t*& outQueueFamilyIndices) const;
+
+  // compute-based mipmap generation; created on first use
+  const VulkanMipmapGenerator& getMipmapGenerator() const;
+
+  // a set layout of the texture slots like `dslCombinedImageSamplers_`, with the samplers of
+  // `immutableSamplers` baked into the slots which are not VK_NULL_HANDLE (null for none)
+  std::unique_ptr<VulkanDescriptorSetLayout> createTexturesDescriptorSetLayout(
+      const VkSampler* immutableSamplers,
+      const char* debugName) const;
+  // a pipeline layout of the default set layouts, with `dslTextures` taking the texture slots
+  std::unique_ptr<VulkanPipelineLayout> createPipelineLayout(VkDescriptorSetLayout dslTextures,
+                                                             VkPipelineBindPoint bindPoint,
+                                                             const char* debugName) const;
+
  private:
   void createInstance(const size_t numExtraExtensions, const char** extraExtensions);
   void createSurface(void* window, void* display);
   void checkAndUpdateDescriptorSets() const;
-  void bindDefaultDescriptorSets(VkCommandBuffer cmdBuf, VkPipelineBindPoint bindPointa) const;
   void querySurfaceCapabilities();
   void processDeferredTasks() const;
   void waitDeferredTasks();
+  std::vector<uint8_t> loadPipelineCache(const std::string& path) const;
+  void flushPipelineCache() const;
 
  private:
+  friend class igl::vulkan::BindGroup;
   friend class igl::vulkan::Device;
   friend class igl::vulkan::VulkanSwapchain;
   friend class igl::vulkan::CommandQueue;
   friend class igl::vulkan::ComputeCommandEncoder;
+  friend class igl::vulkan::ParallelRenderCommandEncoder;
+  friend class igl::vulkan::RenderBundle;
   friend class igl::vulkan::RenderCommandEncoder;
+  friend class igl::vulkan::VulkanMipmapGenerator;
+
+  // declared before `immediate_` and `stagingDevice_`, which count their waits here until they
+  // are destroyed
+  mutable FrameStatisticsTracker frameStatistics_;
+  std::vector<StartupStep> startupSteps_;
 
   VkInstance vkInstance_ = VK_NULL_HANDLE;
+#if defined(IGL_WITH_TRACY_GPU)
+  tracy::VkCtx* tracyCtx_ = nullptr;
+#endif // IGL_WITH_TRACY_GPU
   VkDebugUtilsMessengerEXT vkDebugUtilsMessenger_ = VK_NULL_HANDLE;
   VkSurfaceKHR vkSurface_ = VK_NULL_HANDLE;
   VkPhysicalDevice vkPhysicalDevice_ = VK_NULL_HANDLE;
+  bool useTimelineSemaphores_ = false;
+  bool useFragmentDensityMap_ = false;
+  bool usePresentWait_ = false;
   FOLLY_PUSH_WARNING
   FOLLY_GNU_DISABLE_WARNING("-Wmissing-field-initializers")
   VkPhysicalDeviceDescriptorIndexingPropertiesEXT vkPhysicalDeviceDescriptorIndexingProperties_ = {
@@ -246,6 +537,10 @@ class VulkanContext final {
   VkPhysicalDeviceFeatures2 vkPhysicalDeviceFeatures2_ = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
       &vkPhysicalDeviceMultiviewFeatures_};
+  // Provided by VK_VERSION_1_1, queried only on Vulkan 1.1 devices
+  VkPhysicalDeviceSubgroupProperties vkPhysicalDeviceSubgroupProperties_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES,
+      nullptr};
   FOLLY_POP_WARNING
 
  public:
@@ -254,7 +549,13 @@ class VulkanContext final {
   std::unique_ptr<igl::vulkan::VulkanDevice> device_;
   std::unique_ptr<igl::vulkan::VulkanSwapchain> swapchain_;
   std::unique_ptr<igl::vulkan::VulkanImmediateCommands> immediate_;
+  // command buffers of compute command queues (null without `enableAsyncCompute`)
+  std::unique_ptr<igl::vulkan::VulkanImmediateCommands> computeImmediate_;
   std::unique_ptr<igl::vulkan::VulkanStagingDevice> stagingDevice_;
+  // moves VMA buffers and frees all VMA buffers and images (null without VMA)
+  std::unique_ptr<igl::vulkan::VulkanDefragmenter> defragmenter_;
+  // shared VkBuffers for small buffers (null if pooling is disabled)
+  std::unique_ptr<igl::vulkan::VulkanBufferPool> bufferPool_;
   // combined image sampler slots for the current drawcall
   std::unique_ptr<igl::vulkan::VulkanDescriptorSetLayout> dslCombinedImageSamplers_;
   // uniform buffer slots for the current drawcall
@@ -262,48 +563,115 @@ class VulkanContext final {
   // storage buffer slots for the current drawcall
   std::unique_ptr<igl::vulkan::VulkanDescriptorSetLayout> dslBuffersStorage_;
   std::unique_ptr<igl::vulkan::VulkanDescriptorSetLayout> dslBindless_; // everything
-  VkDescriptorPool dpCombinedImageSamplers_ = VK_NULL_HANDLE;
-  VkDescriptorPool dpBuffersUniform_ = VK_NULL_HANDLE;
-  VkDescriptorPool dpBuffersStorage_ = VK_NULL_HANDLE;
+  // takes the place of `dslBindless_` when the input attachments are used without it
+  std::unique_ptr<igl::vulkan::VulkanDescriptorSetLayout> dslEmpty_;
+  // input attachments of the current subpass (null with dynamic rendering)
+  std::unique_ptr<igl::vulkan::VulkanDescriptorSetLayout> dslInputAttachments_;
   VkDescriptorPool dpBindless_ = VK_NULL_HANDLE;
   struct DescriptorSet {
     VkDescriptorSet ds = VK_NULL_HANDLE;
     SubmitHandle handle =
         SubmitHandle(); // a handle of the last submit this descriptor set was a part of
   };
-  struct DescriptorSetArray {
-    std::vector<DescriptorSet> dsets;
-    uint32_t current = 0;
-    uint32_t prev = 0;
-    VkDescriptorSet acquireNext(VulkanImmediateCommands& ic) {
-      IGL_ASSERT(!dsets.empty());
-      VkDescriptorSet ds = dsets[current].ds;
-      ic.wait(std::exchange(dsets[current].handle, {}));
-      current = (current + 1) % dsets.size();
-      return ds;
-    }
-    void updateHandles(SubmitHandle handle) {
-      IGL_ASSERT(!dsets.empty());
-      for (uint32_t i = prev; i != current; i = (i + 1) % dsets.size()) {
-        dsets[i].handle = handle;
-      }
-      prev = current;
-    }
-  };
   mutable DescriptorSet bindlessDSet_;
-  mutable DescriptorSetArray combinedImageSamplerDSets_;
-  mutable DescriptorSetArray bufferUniformDSets_;
-  mutable DescriptorSetArray bufferStorageDSets_;
+  // uniform and storage buffer sets with dummy buffers in every slot: bound instead of transient
+  // sets while no buffers are bound through descriptors, e.g. when shaders use buffer addresses.
+  // There is no uniform buffer set with push descriptors
+  VkDescriptorPool dpDefaultBuffers_ = VK_NULL_HANDLE;
+  VkDescriptorSet dsetDefaultBuffersUniform_ = VK_NULL_HANDLE;
+  VkDescriptorSet dsetDefaultBuffersStorage_ = VK_NULL_HANDLE;
+  // transient per-drawcall descriptor sets: pools grow on demand and are recycled once retired.
+  // One set of allocators per command buffer of `immediate_`: a command buffer is recorded by one
+  // thread at a time, so different threads never share an allocator
+  mutable std::vector<VulkanTransientDescriptorSets> transientDSets_;
+  // the same for the command buffers of `computeImmediate_`
+  mutable std::vector<VulkanTransientDescriptorSets> computeTransientDSets_;
+  // queue families sharing all buffers and images; empty if they are owned by one family
+  std::vector<uint32_t> concurrentQueueFamilyIndices_;
+  // secondary command buffers for parallel render pass encoding and render bundles
+  struct SecondaryCommandBuffer {
+    std::unique_ptr<VulkanCommandPool> pool;
+    VkCommandBuffer cmdBuf = VK_NULL_HANDLE;
+    VulkanTransientDescriptorSets dsets;
+    // the primary command buffer this buffer was executed from
+    SubmitHandle handle = SubmitHandle();
+    bool isRecording = false;
+  };
+  mutable std::mutex secondaryCommandBuffersMutex_;
+  mutable std::vector<std::unique_ptr<SecondaryCommandBuffer>> secondaryCommandBuffers_;
   std::unique_ptr<igl::vulkan::VulkanPipelineLayout> pipelineLayoutGraphics_;
   std::unique_ptr<igl::vulkan::VulkanPipelineLayout> pipelineLayoutCompute_;
   std::shared_ptr<igl::vulkan::VulkanBuffer> dummyUniformBuffer_;
   std::shared_ptr<igl::vulkan::VulkanBuffer> dummyStorageBuffer_;
   // don't use staging on devices with shared host-visible memory
   bool useStaging_ = true;
+  // tile-based GPUs can back transient attachments with lazily allocated memory
+  bool hasLazilyAllocatedMemory_ = false;
+  // VK_EXT_memory_budget is enabled
+  bool useMemoryBudget_ = false;
+  // VK_EXT_memory_priority is enabled
+  bool useMemoryPriority_ = false;
+  // VK_KHR_push_descriptor is enabled: dslBuffersUniform_ is a push descriptor set layout
+  bool usePushDescriptors_ = false;
+  // the first slots of dslBuffersUniform_ are VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
+  uint32_t numDynamicUniformBuffers_ = 0;
+  // VK_EXT_descriptor_buffer is enabled: all descriptor set layouts are descriptor buffer layouts,
+  // and no descriptor sets are allocated
+  bool useDescriptorBuffers_ = false;
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptorBufferProperties_ = {};
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  // the descriptors of `dslBindless_` with descriptor buffers (instead of `bindlessDSet_`)
+  std::unique_ptr<igl::vulkan::VulkanBuffer> bindlessDescriptorBuffer_;
+  // VK_EXT_host_image_copy is enabled; host copies leave images in `hostImageCopyLayout_`
+  bool useHostImageCopy_ = false;
+  VkImageLayout hostImageCopyLayout_ = VK_IMAGE_LAYOUT_GENERAL;
+  // VK_ANDROID_external_memory_android_hardware_buffer and the sync fd semaphores are enabled
+  bool hasNativeHWBufferInterop_ = false;
+  // VK_KHR_external_semaphore_fd is enabled: fences are exported and imported as sync fds
+  bool hasExternalSemaphoreFd_ = false;
+  // samplerYcbcrConversion is enabled
+  bool useSamplerYcbcrConversion_ = false;
+  // VK_KHR_dynamic_rendering and VK_KHR_synchronization2 are enabled
+  bool useDynamicRendering_ = false;
+  // VkPhysicalDeviceDepthStencilResolveProperties::supportedDepthResolveModes (dynamic rendering)
+  VkFlags supportedDepthResolveModes_ = 0;
+  // VK_EXT_extended_dynamic_state: topology, depth and stencil states are dynamic
+  bool useExtendedDynamicState_ = false;
+  // VK_KHR_imageless_framebuffer is enabled
+  bool useImagelessFramebuffers_ = false;
+  // VK_EXT_extended_dynamic_state2: the depth bias enable is dynamic
+  bool useExtendedDynamicState2_ = false;
+  // VK_EXT_extended_dynamic_state3: the dynamic topology may change its topology class
+  bool hasUnrestrictedDynamicPrimitiveTopology_ = false;
+  // VK_EXT_graphics_pipeline_library with fast linking: graphics pipelines are linked from
+  // libraries
+  bool useGraphicsPipelineLibrary_ = false;
+  bool useSubgroupSizeControl_ = false;
+  // the range of subgroup sizes, which VK_EXT_subgroup_size_control lets compute pipelines pick
+  uint32_t minSubgroupSize_ = 0;
+  uint32_t maxSubgroupSize_ = 0;
+  // multi-planar YUV formats are sampled through a conversion which is baked into immutable
+  // samplers of the bindless descriptor set; one per format which supports it
+  struct YcbcrConversion {
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkSamplerYcbcrConversion conversion = VK_NULL_HANDLE;
+    std::shared_ptr<VulkanSampler> sampler;
+  };
+  std::array<YcbcrConversion, 2> ycbcrConversions_;
+  // the VkDevice is counted in the process-wide number of devices, see initContext()
+  bool isDeviceCounted_ = false;
 
   std::unique_ptr<VulkanContextImpl> pimpl_;
 
   VkPipelineCache pipelineCache_ = VK_NULL_HANDLE;
+  std::unique_ptr<WorkerPool> pipelineCompilationPool_;
+  std::unique_ptr<WorkerPool> deferredTasksPool_;
+  mutable std::mutex mipmapGeneratorMutex_;
+  mutable std::unique_ptr<VulkanMipmapGenerator> mipmapGenerator_;
+  // number of pipelines created when the pipeline cache was last saved to disk
+  mutable uint32_t pipelineCacheNumPipelinesSaved_ = 0;
+  mutable uint32_t pipelineCacheSubmitsSinceFlush_ = 0;
 
   // 1. Textures can be safely deleted once they are not in use by GPU, hence our Vulkan context
   // owns all allocated textures (images+image views). The IGL interface vulkan::Texture does not
@@ -314,49 +682,183 @@ class VulkanContext final {
                                                                              // [0] is always there
   mutable std::vector<std::shared_ptr<VulkanSampler>> samplers_ = {nullptr}; // the guard element
                                                                              // [0] is always there
+  // What the bindless descriptors need from every slot of `textures_`/`samplers_`, kept in flat
+  // arrays indexed the same way, so descriptor updates do not chase pointers through every
+  // texture and its image. Empty slots are zero-initialized.
+  struct BindlessTextureSlot {
+    VkImageView imageView = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    // single-sampled images only: multisampled images cannot be directly accessed from shaders
+    bool isSampled = false;
+    bool isStorage = false;
+  };
+  static BindlessTextureSlot getBindlessTextureSlot(const VulkanTexture& texture);
+  mutable std::vector<BindlessTextureSlot> textureSlots_ = {BindlessTextureSlot{}};
+  mutable std::vector<VkSampler> samplerSlots_ = {VK_NULL_HANDLE};
   // contains a list of free indices inside the sparse array `textures_`
   mutable std::vector<uint32_t> freeIndicesTextures_;
   // contains a list of free indices inside the sparse array `samplers_`
   mutable std::vector<uint32_t> freeIndicesSamplers_;
+  // released indices which can be still referenced by command buffers in flight; they become free
+  // (and their bindless descriptors can be overwritten) once `handle` is signaled
+  struct PendingFreeIndex {
+    uint32_t index = 0;
+    SubmitHandle handle = SubmitHandle();
+    SubmitHandle computeHandle = SubmitHandle();
+  };
+  mutable std::deque<PendingFreeIndex> pendingFreeIndicesTextures_;
+  mutable std::deque<PendingFreeIndex> pendingFreeIndicesSamplers_;
+  // slots of `textures_`/`samplers_` whose bindless descriptors have to be (re)written
+  mutable std::vector<uint32_t> dirtyIndicesTextures_;
+  mutable std::vector<uint32_t> dirtyIndicesSamplers_;
   // a texture/sampler was created since the last descriptor set update
   mutable bool awaitingCreation_ = false;
+  // guards `textures_`/`samplers_` slots and the bindless descriptor set update: resources and
+  // encoders can be created on different threads
+  mutable std::mutex bindlessMutex_;
+  // the guard elements textures_[0] and samplers_[0]
+  VkImageView dummyImageView_ = VK_NULL_HANDLE;
+  VkSampler dummySampler_ = VK_NULL_HANDLE;
   mutable uint64_t lastDeletionFrame_ = 0;
 
-  mutable size_t drawCallCount_ = 0;
+  mutable std::atomic<size_t> drawCallCount_{0};
 
-  // stores an index into renderPasses_
+  struct RenderPassEntry {
+    VkRenderPass pass = VK_NULL_HANDLE;
+    // an index into renderPasses_
+    uint16_t index = 0;
+    // returned by findRenderPass() since the last pruneRenderPasses()
+    bool isUsed = true;
+  };
+  // guards `renderPassesHash_`, `compatibleRenderPassesHash_` and `renderPasses_`
+  mutable std::mutex renderPassesMutex_;
+  mutable std::unordered_map<VulkanRenderPassBuilder,
+                             RenderPassEntry,
+                             VulkanRenderPassBuilder::HashFunction>
+      renderPassesHash_;
+  // VulkanRenderPassBuilder::getCompatibilityKey() to an index into renderPasses_
   mutable std::
-      unordered_map<VulkanRenderPassBuilder, uint8_t, VulkanRenderPassBuilder::HashFunction>
-          renderPassesHash_;
+      unordered_map<VulkanRenderPassBuilder, uint16_t, VulkanRenderPassBuilder::HashFunction>
+          compatibleRenderPassesHash_;
+  // the first render pass of each class of compatible render passes; never pruned
   mutable std::vector<VkRenderPass> renderPasses_;
 
   VulkanExtensions extensions_;
   VulkanContextConfig config_;
+  VulkanValidationFilter validationFilter_;
 
   // Enhanced shader debug: line drawing
   std::unique_ptr<EnhancedShaderDebuggingStore> enhancedShaderDebuggingStore_;
 
+  // the functions below bind their sets with `pipelineLayout`: the layout of VulkanContext or of a
+  // render pipeline with immutable samplers, whose texture slots have the layout `dslTextures`
   void updateBindingsTextures(VkCommandBuffer cmdBuf,
+                              VulkanTransientDescriptorSets& dsets,
                               VkPipelineBindPoint bindPoint,
+                              VkPipelineLayout pipelineLayout,
+                              const VulkanDescriptorSetLayout& dslTextures,
                               const BindingsTextures& data) const;
-  void updateBindingsUniformBuffers(VkCommandBuffer cmdBuf,
-                                    VkPipelineBindPoint bindPoint,
-                                    BindingsBuffers& data) const;
+  // the combined image sampler descriptors of `data`, with the dummy texture in the empty slots
+  void getTextureDescriptors(
+      const BindingsTextures& data,
+      bool isGraphics,
+      std::array<VkDescriptorImageInfo, IGL_TEXTURE_SAMPLERS_MAX>& outInfos) const;
+  // writes `data` into a descriptor set allocated from its own pool, which the caller destroys;
+  // returns VK_NULL_HANDLE with descriptor buffers
+  VkDescriptorSet createPersistentTexturesDescriptorSet(const BindingsTextures& data,
+                                                        const char* debugName,
+                                                        VkDescriptorPool& outPool) const;
+  void bindTexturesDescriptorSet(VkCommandBuffer cmdBuf,
+                                 VkPipelineBindPoint bindPoint,
+                                 VkPipelineLayout pipelineLayout,
+                                 VkDescriptorSet dset) const;
+  // binds the views of the input attachments of the current subpass
+  void updateBindingsInputAttachments(VkCommandBuffer cmdBuf,
+                                      VulkanTransientDescriptorSets& dsets,
+                                      VkPipelineLayout pipelineLayout,
+                                      uint32_t numViews,
+                                      const VkImageView* views) const;
+  // returns the descriptor set which was bound, or VK_NULL_HANDLE with push descriptors
+  VkDescriptorSet updateBindingsUniformBuffers(VkCommandBuffer cmdBuf,
+                                               VulkanTransientDescriptorSets& dsets,
+                                               VkPipelineBindPoint bindPoint,
+                                               VkPipelineLayout pipelineLayout,
+                                               BindingsBuffers& data) const;
+  // binds `dset` again with the dynamic offsets of `data`
+  void bindDynamicUniformBufferOffsets(VkCommandBuffer cmdBuf,
+                                       VkPipelineBindPoint bindPoint,
+                                       VkPipelineLayout pipelineLayout,
+                                       VkDescriptorSet dset,
+                                       const BindingsBuffers& data) const;
   void updateBindingsStorageBuffers(VkCommandBuffer cmdBuf,
+                                    VulkanTransientDescriptorSets& dsets,
                                     VkPipelineBindPoint bindPoint,
+                                    VkPipelineLayout pipelineLayout,
                                     BindingsBuffers& data) const;
-  void markSubmit(const SubmitHandle& handle) const;
+  // binds the bindless descriptor set, and the descriptor buffers of `dsets` with descriptor
+  // buffers; called when an encoder begins
+  void bindDefaultDescriptorSets(VkCommandBuffer cmdBuf,
+                                 VulkanTransientDescriptorSets& dsets,
+                                 VkPipelineBindPoint bindPoint,
+                                 VkPipelineLayout pipelineLayout) const;
+  // descriptor buffers only: binds the transient descriptor buffer of `dsets` and the bindless one,
+  // which invalidates all sets bound so far, and binds the bindless set again
+  void bindDescriptorBuffers(VkCommandBuffer cmdBuf,
+                             VulkanTransientDescriptorSets& dsets,
+                             VkPipelineBindPoint bindPoint,
+                             VkPipelineLayout pipelineLayout) const;
+  // descriptor buffers only: allocates one set of `layout` in the descriptor buffer of `dsets` and
+  // binds it to `set`; returns the memory the descriptors of the set have to be written to
+  uint8_t* bindDescriptorBufferSet(VkCommandBuffer cmdBuf,
+                                   VulkanTransientDescriptorSets& dsets,
+                                   VkPipelineBindPoint bindPoint,
+                                   VkPipelineLayout pipelineLayout,
+                                   uint32_t set,
+                                   const VulkanDescriptorSetLayout& layout) const;
+  // descriptor buffers only: writes the image and sampler descriptors of `write` into `dst`, the
+  // memory of one set of `layout`; `write.dstSet` is ignored
+  void writeDescriptors(uint8_t* dst,
+                        const VulkanDescriptorSetLayout& layout,
+                        const VkWriteDescriptorSet& write) const;
+  // descriptor buffers only: writes the buffers of `data` into the bindings of `layout`, which
+  // hold one buffer of `type` each
+  void writeBufferDescriptors(uint8_t* dst,
+                              const VulkanDescriptorSetLayout& layout,
+                              VkDescriptorType type,
+                              const BindingsBuffers& data) const;
+  VulkanTransientDescriptorSets createTransientDescriptorSets(
+      const std::string& debugName,
+      VulkanImmediateCommands* commands = nullptr) const;
+  // thread-safe; the returned buffer belongs to the caller until it is released
+  SecondaryCommandBuffer* acquireSecondaryCommandBuffer() const;
+  // `handle` is the primary command buffer executing `buffer`
+  void releaseSecondaryCommandBuffer(SecondaryCommandBuffer* buffer, SubmitHandle handle) const;
+  void markSubmit(const SubmitHandle& handle, bool isAsyncCompute = false) const;
+  // true if both handles are finished on their queues (an empty handle is always finished)
+  bool isReady(SubmitHandle handle, SubmitHandle computeHandle) const;
 
   struct DeferredTask {
-    DeferredTask(std::packaged_task<void()>&& task, SubmitHandle handle) :
-      task_(std::move(task)), handle_(handle) {}
+    DeferredTask(std::packaged_task<void()>&& task,
+                 SubmitHandle handle,
+                 SubmitHandle computeHandle,
+                 bool onSubmittingThread) :
+      task_(std::move(task)),
+      handle_(handle),
+      computeHandle_(computeHandle),
+      onSubmittingThread_(onSubmittingThread) {}
     std::packaged_task<void()> task_;
     SubmitHandle handle_;
+    // the last submit of `computeImmediate_` when the task was deferred
+    SubmitHandle computeHandle_;
+    bool onSubmittingThread_ = false;
   };
 
+  mutable std::mutex deferredTasksMutex_;
   mutable std::deque<DeferredTask> deferredTasks_;
 
   std::unique_ptr<SyncManager> syncManager_;
+
+  std::unique_ptr<SpirvCache> spirvCache_;
 };
 
 } // namespace vulkan
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanDefragmenter.h>
+
+#include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDevice.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+#include <igl/vulkan/VulkanStagingDevice.h>
+
+namespace igl {
+namespace vulkan {
+
+VulkanDefragmenter::VulkanDefragmenter(const VulkanContext& ctx) : ctx_(ctx) {}
+
+VulkanDefragmenter::~VulkanDefragmenter() {
+  // the context waits for all deferred tasks before destroying the defragmenter
+  IGL_ASSERT(!isPassInFlight_);
+  if (context_ != VK_NULL_HANDLE) {
+    endDefragmentation();
+  }
+  for (const auto& resource : postponed_) {
+    destroy(resource);
+  }
+}
+
+void VulkanDefragmenter::registerBuffer(VulkanBuffer& buffer) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  vmaSetAllocationUserData((VmaAllocator)ctx_.getVmaAllocator(), buffer.vmaAllocation_, &buffer);
+}
+
+void VulkanDefragmenter::unregisterBuffer(VulkanBuffer& buffer) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  vmaSetAllocationUserData((VmaAllocator)ctx_.getVmaAllocator(), buffer.vmaAllocation_, nullptr);
+}
+
+void VulkanDefragmenter::destroyBuffer(VkBuffer buffer, VmaAllocation allocation) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  hasFreedAllocations_ = true;
+  const PendingDestruction resource = {buffer, VK_NULL_HANDLE, allocation};
+  if (passAllocations_.count(allocation)) {
+    postponed_.push_back(resource);
+  } else {
+    destroy(resource);
+  }
+}
+
+void VulkanDefragmenter::destroyImage(VkImage image, VmaAllocation allocation) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  hasFreedAllocations_ = true;
+  const PendingDestruction resource = {VK_NULL_HANDLE, image, allocation};
+  if (passAllocations_.count(allocation)) {
+    postponed_.push_back(resource);
+  } else {
+    destroy(resource);
+  }
+}
+
+void VulkanDefragmenter::destroy(const PendingDestruction& resource) {
+  if (resource.image != VK_NULL_HANDLE) {
+    vmaDestroyImage((VmaAllocator)ctx_.getVmaAllocator(), resource.image, resource.allocation);
+  } else {
+    vmaDestroyBuffer((VmaAllocator)ctx_.getVmaAllocator(), resource.buffer, resource.allocation);
+  }
+}
+
+void VulkanDefragmenter::runPass(VkDeviceSize maxBytes) {
+  IGL_PROFILER_FUNCTION();
+
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (isPassInFlight_ || (context_ == VK_NULL_HANDLE && !hasFreedAllocations_)) {
+      return;
+    }
+  }
+
+  // pending uploads reference the current VkBuffers
+  ctx_.stagingDevice_->submitPendingUploads(*ctx_.immediate_);
+
+  const auto vma = (VmaAllocator)ctx_.getVmaAllocator();
+  const VkDevice device = ctx_.device_->getVkDevice();
+
+  std::vector<VkBuffer> oldBuffers;
+  VulkanImmediateCommands::SubmitHandle handle;
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+
+    if (context_ == VK_NULL_HANDLE) {
+      hasFreedAllocations_ = false;
+      VmaDefragmentationInfo info = {};
+      info.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_FAST_BIT;
+      info.maxBytesPerPass = maxBytes;
+      if (vmaBeginDefragmentation(vma, &info, &context_) != VK_SUCCESS) {
+        context_ = VK_NULL_HANDLE;
+        return;
+      }
+    }
+
+    passInfo_ = {};
+    if (vmaBeginDefragmentationPass(vma, context_, &passInfo_) != VK_INCOMPLETE) {
+      // nothing left to move
+      endDefragmentation();
+      return;
+    }
+
+    const VulkanImmediateCommands::CommandBufferWrapper* wrapper = nullptr;
+    std::vector<std::pair<VulkanBuffer*, VkBuffer>> movedBuffers;
+
+    for (uint32_t i = 0; i != passInfo_.moveCount; i++) {
+      VmaDefragmentationMove& move = passInfo_.pMoves[i];
+      passAllocations_.insert(move.srcAllocation);
+
+      VmaAllocationInfo allocationInfo = {};
+      vmaGetAllocationInfo(vma, move.srcAllocation, &allocationInfo);
+      auto* buffer = static_cast<VulkanBuffer*>(allocationInfo.pUserData);
+      if (!buffer) {
+        // images and buffers which were not registered
+        move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+        continue;
+      }
+
+      VkBufferCreateInfo ci = ivkGetBufferCreateInfo(buffer->bufferSize_, buffer->usageFlags_);
+      ctx_.setSharingMode(ci.sharingMode, ci.queueFamilyIndexCount, ci.pQueueFamilyIndices);
+      VkBuffer newBuffer = VK_NULL_HANDLE;
+      if (vkCreateBuffer(device, &ci, nullptr, &newBuffer) != VK_SUCCESS) {
+        move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+        continue;
+      }
+      if (vmaBindBufferMemory(vma, move.dstTmpAllocation, newBuffer) != VK_SUCCESS) {
+        vkDestroyBuffer(device, newBuffer, nullptr);
+        move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+        continue;
+      }
+
+      if (!wrapper) {
+        wrapper = &ctx_.immediate_->acquire();
+      }
+      const VkCommandBuffer cmdBuf = wrapper->cmdBuf_;
+      ivkBufferMemoryBarrier(cmdBuf,
+                             buffer->vkBuffer_,
+                             VK_ACCESS_MEMORY_WRITE_BIT,
+                             VK_ACCESS_TRANSFER_READ_BIT,
+                             0,
+                             VK_WHOLE_SIZE,
+                             VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT);
+      const VkBufferCopy copy = {0, 0, buffer->bufferSize_};
+      vkCmdCopyBuffer(cmdBuf, buffer->vkBuffer_, newBuffer, 1, &copy);
+      ivkBufferMemoryBarrier(cmdBuf,
+                             newBuffer,
+                             VK_ACCESS_TRANSFER_WRITE_BIT,
+                             VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
+                             0,
+                             VK_WHOLE_SIZE,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+      movedBuffers.emplace_back(buffer, newBuffer);
+    }
+
+    if (movedBuffers.empty()) {
+      // VMA would keep proposing the same moves; start over once more memory is freed
+      vmaEndDefragmentationPass(vma, context_, &passInfo_);
+      passAllocations_.clear();
+      endDefragmentation();
+      return;
+    }
+
+    handle = ctx_.immediate_->submit(*wrapper);
+
+    oldBuffers.reserve(movedBuffers.size());
+    for (const auto& [buffer, newBuffer] : movedBuffers) {
+      oldBuffers.push_back(buffer->vkBuffer_);
+      buffer->vkBuffer_ = newBuffer;
+      VK_ASSERT(ivkSetDebugObjectName(
+          device, VK_OBJECT_TYPE_BUFFER, (uint64_t)newBuffer, buffer->debugName_.c_str()));
+    }
+    stats_.numPasses++;
+    isPassInFlight_ = true;
+  }
+
+  // the old buffers and memory ranges are in use until the copies are finished
+  ctx_.deferredTask(std::packaged_task<void()>([this, oldBuffers = std::move(oldBuffers)]() {
+                      endPass(oldBuffers);
+                    }),
+                    handle,
+                    true);
+}
+
+void VulkanDefragmenter::endPass(const std::vector<VkBuffer>& oldBuffers) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+
+  const VkDevice device = ctx_.device_->getVkDevice();
+  for (VkBuffer buffer : oldBuffers) {
+    vkDestroyBuffer(device, buffer, nullptr);
+  }
+
+  const VkResult result =
+      vmaEndDefragmentationPass((VmaAllocator)ctx_.getVmaAllocator(), context_, &passInfo_);
+  passAllocations_.clear();
+  isPassInFlight_ = false;
+
+  for (const auto& resource : postponed_) {
+    destroy(resource);
+  }
+  postponed_.clear();
+
+  if (result == VK_SUCCESS) {
+    endDefragmentation();
+  }
+}
+
+void VulkanDefragmenter::endDefragmentation() {
+  VmaDefragmentationStats stats = {};
+  vmaEndDefragmentation((VmaAllocator)ctx_.getVmaAllocator(), context_, &stats);
+  context_ = VK_NULL_HANDLE;
+  passInfo_ = {};
+
+  stats_.bytesMoved += stats.bytesMoved;
+  stats_.bytesFreed += stats.bytesFreed;
+  stats_.allocationsMoved += stats.allocationsMoved;
+  stats_.deviceMemoryBlocksFreed += stats.deviceMemoryBlocksFreed;
+}
+
+VulkanDefragmenter::Stats VulkanDefragmenter::getStats() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+} // namespace vulkan
+} // namespace igl
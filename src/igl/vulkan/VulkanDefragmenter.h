@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanHelpers.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanBuffer;
+class VulkanContext;
+
+/**
+ * @brief Compacts the VMA memory blocks of device-local buffers, one bounded pass at a time.
+ *
+ * Only buffers registered with registerBuffer() are moved: igl::vulkan::Buffer registers its
+ * device-local buffers which have no device address. Internal buffers (staging, dummy, counters),
+ * host-visible buffers and images stay where they are; moving an image would also require new image
+ * views, framebuffers and bindless descriptors.
+ *
+ * A pass copies each moved buffer into a new VkBuffer bound to its new memory and swaps the handle
+ * inside the VulkanBuffer. The old VkBuffers and memory ranges are released by a deferred task once
+ * the copy is finished, so command buffers submitted earlier keep reading the old memory. Command
+ * buffers recorded before a pass but submitted after it are not supported: passes run at the end
+ * of a frame (see VulkanContextConfig::defragmentationMaxBytesPerFrame).
+ *
+ * VMA does not allow freeing an allocation which is part of the current pass, hence all VMA
+ * buffers and images are destroyed through destroyBuffer()/destroyImage(), which postpone these
+ * until the pass ends.
+ */
+class VulkanDefragmenter final {
+ public:
+  struct Stats {
+    uint64_t bytesMoved = 0;
+    uint64_t bytesFreed = 0;
+    uint32_t allocationsMoved = 0;
+    uint32_t deviceMemoryBlocksFreed = 0;
+    // passes which moved at least one buffer
+    uint32_t numPasses = 0;
+  };
+
+  explicit VulkanDefragmenter(const VulkanContext& ctx);
+  ~VulkanDefragmenter();
+
+  VulkanDefragmenter(const VulkanDefragmenter&) = delete;
+  VulkanDefragmenter& operator=(const VulkanDefragmenter&) = delete;
+
+  // `buffer` may be moved by the next passes; it has to be unregistered before it is destroyed
+  void registerBuffer(VulkanBuffer& buffer);
+  void unregisterBuffer(VulkanBuffer& buffer);
+
+  void destroyBuffer(VkBuffer buffer, VmaAllocation allocation);
+  void destroyImage(VkImage image, VmaAllocation allocation);
+
+  // Moves up to `maxBytes` (0 - no limit) and submits the copies. Does nothing while the previous
+  // pass is in flight, or if no allocation was freed since the last defragmentation finished.
+  void runPass(VkDeviceSize maxBytes);
+
+  Stats getStats() const;
+
+ private:
+  struct PendingDestruction {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkImage image = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+  };
+
+  void endPass(const std::vector<VkBuffer>& oldBuffers);
+  void endDefragmentation();
+  void destroy(const PendingDestruction& resource);
+
+ private:
+  const VulkanContext& ctx_;
+  mutable std::mutex mutex_;
+  VmaDefragmentationContext context_ = VK_NULL_HANDLE;
+  VmaDefragmentationPassMoveInfo passInfo_ = {};
+  bool isPassInFlight_ = false;
+  // fragmentation only grows when allocations are freed
+  bool hasFreedAllocations_ = false;
+  // source allocations of the pass in flight; they cannot be freed until it ends
+  std::unordered_set<VmaAllocation> passAllocations_;
+  std::vector<PendingDestruction> postponed_;
+  Stats stats_;
+};
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanDescriptorBuffer.h>
+
+#include <algorithm>
+
+#include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl {
+namespace vulkan {
+
+VulkanDescriptorBuffer::VulkanDescriptorBuffer(const VulkanContext& ctx,
+                                               VkDeviceSize size,
+                                               VkBufferUsageFlags usage,
+                                               VkDeviceSize alignment,
+                                               const char* debugName) :
+  ctx_(ctx),
+  usage_(usage),
+  alignment_(std::max<VkDeviceSize>(alignment, 1)),
+  debugName_(debugName ? debugName : "") {
+  // the buffer is bound when encoders begin, before anything is allocated
+  buffer_ = createBuffer(size);
+  size_ = buffer_ ? size : 0;
+}
+
+VulkanDescriptorBuffer::~VulkanDescriptorBuffer() = default;
+
+std::unique_ptr<VulkanBuffer> VulkanDescriptorBuffer::createBuffer(VkDeviceSize size) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  const std::string debugName = IGL_FORMAT("Buffer: {} ({} bytes)", debugName_, size);
+  auto buffer = std::make_unique<VulkanBuffer>(
+      ctx_,
+      ctx_.getVkDevice(),
+      size,
+      usage_ | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      debugName.c_str());
+  if (!IGL_VERIFY(buffer->isMapped())) {
+    return nullptr;
+  }
+  return buffer;
+}
+
+uint8_t* VulkanDescriptorBuffer::allocate(VulkanImmediateCommands& ic,
+                                          VkDeviceSize size,
+                                          VkDeviceSize& outOffset,
+                                          bool& outIsNewBuffer) {
+  IGL_PROFILER_FUNCTION();
+
+  outIsNewBuffer = false;
+
+  if (!isUsedSinceSubmit_) {
+    // a new recording: the previous submit of this command buffer has completed before the command
+    // buffer could be acquired again, so this does not stall
+    if (!handle_.empty() && !ic.isReady(handle_)) {
+      ic.wait(handle_);
+    }
+    retired_.erase(std::remove_if(retired_.begin(),
+                                  retired_.end(),
+                                  [&ic](const RetiredBuffer& b) {
+                                    return !b.handle.empty() && ic.isReady(b.handle);
+                                  }),
+                   retired_.end());
+    offset_ = 0;
+    isUsedSinceSubmit_ = true;
+  }
+
+  if (!buffer_ || offset_ + size > size_) {
+    VkDeviceSize newSize = std::max<VkDeviceSize>(2 * size_, alignment_);
+    while (newSize < offset_ + size) {
+      newSize *= 2;
+    }
+    std::unique_ptr<VulkanBuffer> buffer = createBuffer(newSize);
+    if (!buffer) {
+      return nullptr;
+    }
+    if (buffer_) {
+      // the command buffer may still reference the descriptors written so far
+      retired_.push_back({std::move(buffer_), SubmitHandle()});
+    }
+    buffer_ = std::move(buffer);
+    size_ = newSize;
+    stats_.numResizes++;
+    outIsNewBuffer = true;
+  }
+
+  outOffset = offset_;
+  offset_ = (offset_ + size + alignment_ - 1) / alignment_ * alignment_;
+  stats_.numAllocatedBytes += size;
+
+  return buffer_->getMappedPtr() + outOffset;
+}
+
+void VulkanDescriptorBuffer::markSubmit(SubmitHandle handle) {
+  if (!isUsedSinceSubmit_) {
+    return;
+  }
+  for (RetiredBuffer& b : retired_) {
+    if (b.handle.empty()) {
+      b.handle = handle;
+    }
+  }
+  handle_ = handle;
+  isUsedSinceSubmit_ = false;
+}
+
+VkDeviceAddress VulkanDescriptorBuffer::getVkDeviceAddress() const {
+  return buffer_ ? buffer_->getVkDeviceAddress() : 0;
+}
+
+} // namespace vulkan
+} // namespace igl
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanBuffer;
+class VulkanContext;
+
+/**
+ * @brief A linear allocator of the descriptors of one command buffer (VK_EXT_descriptor_buffer).
+ *
+ * Descriptors are written straight into a persistently mapped buffer at increasing offsets. The
+ * buffer is bound to the command buffer once, and binding a descriptor set is only setting an
+ * offset into it. All the memory is reused by the next recording of the command buffer, once the
+ * previous submit of the command buffer has completed. If one recording exhausts the buffer, a
+ * twice larger buffer replaces it. Binding the new buffer invalidates the offsets set so far, so
+ * every set has to be bound again; the old buffer is destroyed once its submit has completed.
+ */
+class VulkanDescriptorBuffer final {
+ public:
+  using SubmitHandle = VulkanImmediateCommands::SubmitHandle;
+
+  struct Stats {
+    uint64_t numAllocatedBytes = 0;
+    uint32_t numResizes = 0;
+  };
+
+  // `usage` holds the descriptor buffer usage bits; offsets are multiples of `alignment`
+  VulkanDescriptorBuffer(const VulkanContext& ctx,
+                         VkDeviceSize size,
+                         VkBufferUsageFlags usage,
+                         VkDeviceSize alignment,
+                         const char* debugName);
+  ~VulkanDescriptorBuffer();
+
+  VulkanDescriptorBuffer(const VulkanDescriptorBuffer&) = delete;
+  VulkanDescriptorBuffer& operator=(const VulkanDescriptorBuffer&) = delete;
+
+  // returns mapped memory for `size` bytes of descriptors at `outOffset` from getVkDeviceAddress().
+  // `outIsNewBuffer` is true if the buffer was replaced, so it and all sets have to be bound again
+  uint8_t* allocate(VulkanImmediateCommands& ic,
+                    VkDeviceSize size,
+                    VkDeviceSize& outOffset,
+                    bool& outIsNewBuffer);
+  // all descriptors allocated since the previous call are a part of the submit `handle`
+  void markSubmit(SubmitHandle handle);
+
+  [[nodiscard]] VkDeviceAddress getVkDeviceAddress() const;
+  [[nodiscard]] VkBufferUsageFlags getUsageFlags() const {
+    return usage_;
+  }
+  const Stats& getStats() const {
+    return stats_;
+  }
+
+ private:
+  std::unique_ptr<VulkanBuffer> createBuffer(VkDeviceSize size) const;
+
+ private:
+  const VulkanContext& ctx_;
+  const VkBufferUsageFlags usage_;
+  const VkDeviceSize alignment_;
+  std::string debugName_;
+
+  std::unique_ptr<VulkanBuffer> buffer_;
+  VkDeviceSize size_ = 0;
+  VkDeviceSize offset_ = 0;
+  bool isUsedSinceSubmit_ = false;
+  // the last submit which used `buffer_`
+  SubmitHandle handle_ = SubmitHandle();
+  // buffers replaced by larger ones, destroyed once their submit has completed
+  struct RetiredBuffer {
+    std::unique_ptr<VulkanBuffer> buffer;
+    SubmitHandle handle = SubmitHandle();
+  };
+  std::vector<RetiredBuffer> retired_;
+
+  Stats stats_;
+};
+
+} // namespace vulkan
+} // namespace igl
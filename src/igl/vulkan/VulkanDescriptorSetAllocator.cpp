@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanDescriptorSetAllocator.h>
+
+#include <igl/vulkan/VulkanHelpers.h>
+
+namespace igl {
+namespace vulkan {
+
+VulkanDescriptorSetAllocator::VulkanDescriptorSetAllocator(VkDevice device,
+                                                           VkDescriptorSetLayout layout,
+                                                           VkDescriptorType type,
+                                                           uint32_t numDescriptorsPerSet,
+                                                           uint32_t numSetsPerPool,
+                                                           const char* debugName) :
+  VulkanDescriptorSetAllocator(device,
+                               layout,
+                               {VkDescriptorPoolSize{type, numDescriptorsPerSet}},
+                               numSetsPerPool,
+                               debugName) {}
+
+VulkanDescriptorSetAllocator::VulkanDescriptorSetAllocator(
+    VkDevice device,
+    VkDescriptorSetLayout layout,
+    std::vector<VkDescriptorPoolSize> descriptorsPerSet,
+    uint32_t numSetsPerPool,
+    const char* debugName) :
+  device_(device),
+  layout_(layout),
+  descriptorsPerSet_(std::move(descriptorsPerSet)),
+  numSetsPerPool_(numSetsPerPool),
+  debugName_(debugName ? debugName : "") {
+  IGL_ASSERT(numSetsPerPool_ > 0);
+
+  // the first pool is created lazily by acquireNext()
+}
+
+VulkanDescriptorSetAllocator::~VulkanDescriptorSetAllocator() {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
+
+  auto destroy = [this](const Pool& p) {
+    if (p.pool != VK_NULL_HANDLE) {
+      vkDestroyDescriptorPool(device_, p.pool, nullptr);
+    }
+  };
+
+  destroy(current_);
+  for (const auto& p : retired_) {
+    destroy(p);
+  }
+  for (const auto& p : inFlight_) {
+    destroy(p);
+  }
+  for (const auto& p : free_) {
+    destroy(p);
+  }
+}
+
+bool VulkanDescriptorSetAllocator::createPool(Pool& outPool) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  std::vector<VkDescriptorPoolSize> poolSizes = descriptorsPerSet_;
+  for (VkDescriptorPoolSize& poolSize : poolSizes) {
+    poolSize.descriptorCount *= numSetsPerPool_;
+  }
+
+  VkDescriptorPool pool = VK_NULL_HANDLE;
+  if (ivkCreateDescriptorPool(device_,
+                              numSetsPerPool_,
+                              static_cast<uint32_t>(poolSizes.size()),
+                              poolSizes.data(),
+                              &pool) != VK_SUCCESS) {
+    return false;
+  }
+
+  VK_ASSERT(ivkSetDebugObjectName(
+      device_,
+      VK_OBJECT_TYPE_DESCRIPTOR_POOL,
+      (uint64_t)pool,
+      IGL_FORMAT("Descriptor Pool: {} #{}", debugName_, stats_.numPools).c_str()));
+
+  outPool = Pool{pool};
+  stats_.numPools++;
+
+  return true;
+}
+
+void VulkanDescriptorSetAllocator::recyclePools(VulkanImmediateCommands& ic) {
+  // submits complete in order, so only the oldest pools have to be checked
+  while (!inFlight_.empty() && ic.isReady(inFlight_.front().handle)) {
+    Pool p = inFlight_.front();
+    inFlight_.pop_front();
+    VK_ASSERT(vkResetDescriptorPool(device_, p.pool, 0));
+    p.numAllocatedSets = 0;
+    p.handle = {};
+    free_.push_back(p);
+    stats_.numPoolResets++;
+  }
+}
+
+void VulkanDescriptorSetAllocator::switchToNextPool(VulkanImmediateCommands& ic) {
+  IGL_PROFILER_FUNCTION();
+
+  if (current_.pool != VK_NULL_HANDLE) {
+    if (isCurrentUsedSinceSubmit_) {
+      retired_.push_back(current_);
+    } else {
+      inFlight_.push_back(current_);
+    }
+  }
+  current_ = {};
+  isCurrentUsedSinceSubmit_ = false;
+
+  recyclePools(ic);
+
+  if (!free_.empty()) {
+    current_ = free_.back();
+    free_.pop_back();
+    return;
+  }
+
+  if (createPool(current_)) {
+    return;
+  }
+
+  // cannot grow anymore: wait for the oldest pool in flight
+  IGL_LOG_INFO("VulkanDescriptorSetAllocator: waiting for a descriptor pool (%s)\n",
+               debugName_.c_str());
+  stats_.numStalls++;
+  if (!IGL_VERIFY(!inFlight_.empty())) {
+    return;
+  }
+  ic.wait(inFlight_.front().handle);
+  recyclePools(ic);
+  IGL_ASSERT(!free_.empty());
+  current_ = free_.back();
+  free_.pop_back();
+}
+
+VkDescriptorSet VulkanDescriptorSetAllocator::acquireNext(VulkanImmediateCommands& ic) {
+  return acquireNext(ic, layout_);
+}
+
+VkDescriptorSet VulkanDescriptorSetAllocator::acquireNext(VulkanImmediateCommands& ic,
+                                                          VkDescriptorSetLayout layout) {
+  if (current_.pool == VK_NULL_HANDLE || current_.numAllocatedSets == numSetsPerPool_) {
+    switchToNextPool(ic);
+  }
+
+  VkDescriptorSet ds = VK_NULL_HANDLE;
+
+  if (!IGL_VERIFY(current_.pool != VK_NULL_HANDLE)) {
+    return ds;
+  }
+
+  VK_ASSERT(ivkAllocateDescriptorSet(device_, current_.pool, layout, &ds));
+
+  current_.numAllocatedSets++;
+  isCurrentUsedSinceSubmit_ = true;
+  stats_.numAllocatedSets++;
+
+  return ds;
+}
+
+void VulkanDescriptorSetAllocator::markSubmit(SubmitHandle handle) {
+  for (auto& p : retired_) {
+    p.handle = handle;
+    inFlight_.push_back(p);
+  }
+  retired_.clear();
+
+  if (isCurrentUsedSinceSubmit_) {
+    current_.handle = handle;
+    isCurrentUsedSinceSubmit_ = false;
+  }
+}
+
+} // namespace vulkan
+} // namespace igl
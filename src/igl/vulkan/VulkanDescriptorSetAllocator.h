@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanDescriptorBuffer.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+#include <igl/vulkan/VulkanUniformArena.h>
+
+namespace igl {
+namespace vulkan {
+
+/**
+ * @brief A linear allocator of transient descriptor sets of one layout.
+ *
+ * Descriptor sets are allocated linearly from a descriptor pool. Once a pool is exhausted, it is
+ * retired and tagged with the handle of the next submit; a retired pool is reset as a whole when
+ * its submit handle is signaled. If no pool is available, a new one is created instead of waiting
+ * for the GPU, so the number of pools grows to match the number of binds per frame.
+ */
+class VulkanDescriptorSetAllocator final {
+ public:
+  using SubmitHandle = VulkanImmediateCommands::SubmitHandle;
+
+  struct Stats {
+    uint64_t numAllocatedSets = 0;
+    uint32_t numPools = 0;
+    uint32_t numPoolResets = 0;
+    // the number of times acquireNext() had to wait for the GPU (no more pools could be created)
+    uint32_t numStalls = 0;
+  };
+
+  VulkanDescriptorSetAllocator(VkDevice device,
+                               VkDescriptorSetLayout layout,
+                               VkDescriptorType type,
+                               uint32_t numDescriptorsPerSet,
+                               uint32_t numSetsPerPool,
+                               const char* debugName);
+  // for layouts with several descriptor types: `descriptorsPerSet` holds the counts of one set
+  VulkanDescriptorSetAllocator(VkDevice device,
+                               VkDescriptorSetLayout layout,
+                               std::vector<VkDescriptorPoolSize> descriptorsPerSet,
+                               uint32_t numSetsPerPool,
+                               const char* debugName);
+  ~VulkanDescriptorSetAllocator();
+
+  VulkanDescriptorSetAllocator(const VulkanDescriptorSetAllocator&) = delete;
+  VulkanDescriptorSetAllocator& operator=(const VulkanDescriptorSetAllocator&) = delete;
+
+  // returns a descriptor set which is not used by any command buffer in flight
+  VkDescriptorSet acquireNext(VulkanImmediateCommands& ic);
+  // the same with another `layout` of the same descriptors, e.g. with immutable samplers
+  VkDescriptorSet acquireNext(VulkanImmediateCommands& ic, VkDescriptorSetLayout layout);
+  // all descriptor sets acquired since the previous call are a part of the submit `handle`
+  void markSubmit(SubmitHandle handle);
+
+  const Stats& getStats() const {
+    return stats_;
+  }
+
+ private:
+  struct Pool {
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    uint32_t numAllocatedSets = 0;
+    SubmitHandle handle = SubmitHandle(); // the last submit using sets from this pool
+  };
+
+  bool createPool(Pool& outPool);
+  void recyclePools(VulkanImmediateCommands& ic);
+  void switchToNextPool(VulkanImmediateCommands& ic);
+
+ private:
+  VkDevice device_ = VK_NULL_HANDLE;
+  VkDescriptorSetLayout layout_ = VK_NULL_HANDLE;
+  std::vector<VkDescriptorPoolSize> descriptorsPerSet_;
+  uint32_t numSetsPerPool_ = 0;
+  std::string debugName_;
+
+  Pool current_;
+  bool isCurrentUsedSinceSubmit_ = false;
+  // exhausted pools waiting for the next submit handle
+  std::vector<Pool> retired_;
+  // exhausted pools used by command buffers in flight (in submission order)
+  std::deque<Pool> inFlight_;
+  // reset pools ready for allocations
+  std::vector<Pool> free_;
+
+  Stats stats_;
+};
+
+/// @brief Allocators of per-drawcall descriptor sets and uniform data for one command buffer
+struct VulkanTransientDescriptorSets {
+  // the command buffers which use these descriptor sets
+  VulkanImmediateCommands* commands = nullptr;
+  std::unique_ptr<VulkanDescriptorSetAllocator> combinedImageSamplers;
+  std::unique_ptr<VulkanDescriptorSetAllocator> buffersUniform;
+  std::unique_ptr<VulkanDescriptorSetAllocator> buffersStorage;
+  // null if VulkanContext::hasInputAttachments() is false
+  std::unique_ptr<VulkanDescriptorSetAllocator> inputAttachments;
+  // the data of bindBytes()
+  std::unique_ptr<VulkanUniformArena> uniformArena;
+  // with VulkanContext::useDescriptorBuffers_ all the sets above are allocated from this buffer and
+  // the set allocators are null
+  std::unique_ptr<VulkanDescriptorBuffer> descriptorBuffer;
+
+  void markSubmit(VulkanDescriptorSetAllocator::SubmitHandle handle) {
+    if (descriptorBuffer) {
+      descriptorBuffer->markSubmit(handle);
+    }
+    if (combinedImageSamplers) {
+      combinedImageSamplers->markSubmit(handle);
+    }
+    if (buffersUniform) {
+      buffersUniform->markSubmit(handle);
+    }
+    if (buffersStorage) {
+      buffersStorage->markSubmit(handle);
+    }
+    if (inputAttachments) {
+      inputAttachments->markSubmit(handle);
+    }
+    if (uniformArena) {
+      uniformArena->markSubmit(handle);
+    }
+  }
+};
+
+} // namespace vulkan
+} // namespace igl
@@ -18,12 +18,37 @@ VulkanDescriptorSetLayout::VulkanDescriptorSetLayout(VkDevice device,
                                                      uint32_t numBindings,
                                                      const VkDescriptorSetLayoutBinding* bindings,
                                                      const VkDescriptorBindingFlags* bindingFlags,
-                                                     const char* debugName) :
+                                                     const char* debugName,
+                                                     bool isPushDescriptorSet,
+                                                     bool isDescriptorBufferSet) :
   device_(device) {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
 
-  VK_ASSERT(ivkCreateDescriptorSetLayout(
-      device, numBindings, bindings, bindingFlags, &vkDescriptorSetLayout_));
+  IGL_ASSERT(!isPushDescriptorSet || !isDescriptorBufferSet);
+
+  if (isDescriptorBufferSet) {
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+    VK_ASSERT(ivkCreateDescriptorBufferSetLayout(
+        device, numBindings, bindings, &vkDescriptorSetLayout_));
+    vkGetDescriptorSetLayoutSizeEXT(device, vkDescriptorSetLayout_, &descriptorBufferSize_);
+    for (uint32_t i = 0; i != numBindings; i++) {
+      const uint32_t binding = bindings[i].binding;
+      if (binding >= descriptorBufferOffsets_.size()) {
+        descriptorBufferOffsets_.resize(binding + 1, 0);
+      }
+      vkGetDescriptorSetLayoutBindingOffsetEXT(
+          device, vkDescriptorSetLayout_, binding, &descriptorBufferOffsets_[binding]);
+    }
+#else
+    IGL_ASSERT_MSG(false, "VK_EXT_descriptor_buffer is not supported");
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  } else if (isPushDescriptorSet) {
+    VK_ASSERT(ivkCreatePushDescriptorSetLayout(
+        device, numBindings, bindings, &vkDescriptorSetLayout_));
+  } else {
+    VK_ASSERT(ivkCreateDescriptorSetLayout(
+        device, numBindings, bindings, bindingFlags, &vkDescriptorSetLayout_));
+  }
   VK_ASSERT(ivkSetDebugObjectName(
       device_, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, (uint64_t)vkDescriptorSetLayout_, debugName));
 }
@@ -9,6 +9,7 @@
 
 #include <igl/vulkan/VulkanHelpers.h>
 #include <memory>
+#include <vector>
 
 namespace igl {
 namespace vulkan {
@@ -21,7 +22,9 @@ class VulkanDescriptorSetLayout final {
                             uint32_t numBindings,
                             const VkDescriptorSetLayoutBinding* bindings,
                             const VkDescriptorBindingFlags* bindingFlags,
-                            const char* debugName = nullptr);
+                            const char* debugName = nullptr,
+                            bool isPushDescriptorSet = false,
+                            bool isDescriptorBufferSet = false);
   ~VulkanDescriptorSetLayout();
 
   VulkanDescriptorSetLayout(const VulkanDescriptorSetLayout&) = delete;
@@ -30,10 +33,22 @@ class VulkanDescriptorSetLayout final {
   VkDescriptorSetLayout getVkDescriptorSetLayout() const {
     return vkDescriptorSetLayout_;
   }
+  // descriptor buffer set layouts only: the size of one set in a descriptor buffer...
+  VkDeviceSize getDescriptorBufferSize() const {
+    return descriptorBufferSize_;
+  }
+  // ...and the offset of the descriptors of `binding` inside it
+  VkDeviceSize getDescriptorBufferOffset(uint32_t binding) const {
+    IGL_ASSERT(binding < descriptorBufferOffsets_.size());
+    return descriptorBufferOffsets_[binding];
+  }
 
  public:
   VkDevice device_ = VK_NULL_HANDLE;
   VkDescriptorSetLayout vkDescriptorSetLayout_ = VK_NULL_HANDLE;
+  VkDeviceSize descriptorBufferSize_ = 0;
+  // indexed by the binding number
+  std::vector<VkDeviceSize> descriptorBufferOffsets_;
 };
 
 } // namespace vulkan
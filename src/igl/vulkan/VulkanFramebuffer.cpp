@@ -28,6 +28,24 @@ VulkanFramebuffer::VulkanFramebuffer(const VulkanContext& ctx,
       device_, VK_OBJECT_TYPE_FRAMEBUFFER, (uint64_t)vkFramebuffer_, debugName));
 }
 
+VulkanFramebuffer::VulkanFramebuffer(
+    const VulkanContext& ctx,
+    VkDevice device,
+    uint32_t width,
+    uint32_t height,
+    VkRenderPass renderPass,
+    size_t numAttachments,
+    const VkFramebufferAttachmentImageInfoKHR* attachmentImageInfos,
+    const char* debugName) :
+  ctx_(ctx), device_(device) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  VK_ASSERT(ivkCreateImagelessFramebuffer(
+      device_, width, height, renderPass, numAttachments, attachmentImageInfos, &vkFramebuffer_));
+  VK_ASSERT(ivkSetDebugObjectName(
+      device_, VK_OBJECT_TYPE_FRAMEBUFFER, (uint64_t)vkFramebuffer_, debugName));
+}
+
 VulkanFramebuffer::~VulkanFramebuffer() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
 
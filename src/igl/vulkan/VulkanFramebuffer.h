@@ -24,6 +24,15 @@ class VulkanFramebuffer final {
                     size_t numAttachments,
                     const VkImageView* attachments,
                     const char* debugName = nullptr);
+  // an imageless framebuffer; the image views are passed to vkCmdBeginRenderPass()
+  VulkanFramebuffer(const VulkanContext& ctx,
+                    VkDevice device,
+                    uint32_t width,
+                    uint32_t height,
+                    VkRenderPass renderPass,
+                    size_t numAttachments,
+                    const VkFramebufferAttachmentImageInfoKHR* attachmentImageInfos,
+                    const char* debugName = nullptr);
   ~VulkanFramebuffer();
 
   VulkanFramebuffer(const VulkanFramebuffer&) = delete;
@@ -265,6 +265,22 @@ VkResult ivkCreateSemaphore(VkDevice device, VkSemaphore* outSemaphore) {
   return vkCreateSemaphore(device, &ci, NULL, outSemaphore);
 }
 
+VkResult ivkCreateTimelineSemaphore(VkDevice device,
+                                    uint64_t initialValue,
+                                    VkSemaphore* outSemaphore) {
+  const VkSemaphoreTypeCreateInfoKHR semaphoreTypeCreateInfo = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,
+      .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+      .initialValue = initialValue,
+  };
+  const VkSemaphoreCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+      .pNext = &semaphoreTypeCreateInfo,
+      .flags = 0,
+  };
+  return vkCreateSemaphore(device, &ci, NULL, outSemaphore);
+}
+
 VkResult ivkCreateFence(VkDevice device, VkFlags flags, VkFence* outFence) {
   const VkFenceCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
@@ -297,6 +313,19 @@ VkResult ivkCreateDevice(VkPhysicalDevice physicalDevice,
                          VkBool32 enableShaderFloat16,
                          VkBool32 enableBufferDeviceAddress,
                          VkBool32 enableDescriptorIndexing,
+                         VkBool32 enableTimelineSemaphore,
+                         VkBool32 enableFragmentDensityMap,
+                         VkBool32 enablePresentWait,
+                         VkBool32 enableMemoryPriority,
+                         VkBool32 enableSamplerYcbcrConversion,
+                         VkBool32 enableDynamicRendering,
+                         VkBool32 enableExtendedDynamicState,
+                         VkBool32 enableExtendedDynamicState2,
+                         VkBool32 enableImagelessFramebuffer,
+                         VkBool32 enableDescriptorBuffer,
+                         VkBool32 enableHostImageCopy,
+                         VkBool32 enableGraphicsPipelineLibrary,
+                         VkBool32 enableSubgroupSizeControl,
                          VkDevice* outDevice) {
   assert(numQueueCreateInfos >= 1);
   const VkPhysicalDeviceFeatures deviceFeatures = {
@@ -366,6 +395,157 @@ VkResult ivkCreateDevice(VkPhysicalDevice physicalDevice,
   }
 #endif // defined(VK_KHR_multiview)
 
+  const VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+      .timelineSemaphore = VK_TRUE,
+  };
+  if (enableTimelineSemaphore == VK_TRUE) {
+    ivkAddNext(&ci, &timelineSemaphoreFeature);
+  }
+
+  const VkPhysicalDeviceFragmentDensityMapFeaturesEXT fragmentDensityMapFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_DENSITY_MAP_FEATURES_EXT,
+      .fragmentDensityMap = VK_TRUE,
+  };
+  if (enableFragmentDensityMap == VK_TRUE) {
+    ivkAddNext(&ci, &fragmentDensityMapFeature);
+  }
+
+#if defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
+  const VkPhysicalDevicePresentIdFeaturesKHR presentIdFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+      .presentId = VK_TRUE,
+  };
+  const VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+      .presentWait = VK_TRUE,
+  };
+  if (enablePresentWait == VK_TRUE) {
+    ivkAddNext(&ci, &presentIdFeature);
+    ivkAddNext(&ci, &presentWaitFeature);
+  }
+#else
+  (void)enablePresentWait;
+#endif // defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
+
+#if defined(VK_EXT_memory_priority)
+  const VkPhysicalDeviceMemoryPriorityFeaturesEXT memoryPriorityFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT,
+      .memoryPriority = VK_TRUE,
+  };
+  if (enableMemoryPriority == VK_TRUE) {
+    ivkAddNext(&ci, &memoryPriorityFeature);
+  }
+#else
+  (void)enableMemoryPriority;
+#endif // defined(VK_EXT_memory_priority)
+
+  const VkPhysicalDeviceSamplerYcbcrConversionFeatures samplerYcbcrConversionFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SAMPLER_YCBCR_CONVERSION_FEATURES,
+      .samplerYcbcrConversion = VK_TRUE,
+  };
+  if (enableSamplerYcbcrConversion == VK_TRUE) {
+    ivkAddNext(&ci, &samplerYcbcrConversionFeature);
+  }
+
+#if IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+  const VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+      .dynamicRendering = VK_TRUE,
+  };
+  const VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Feature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR,
+      .synchronization2 = VK_TRUE,
+  };
+  if (enableDynamicRendering == VK_TRUE) {
+    ivkAddNext(&ci, &dynamicRenderingFeature);
+    ivkAddNext(&ci, &synchronization2Feature);
+  }
+#else
+  (void)enableDynamicRendering;
+#endif // IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+
+#if defined(VK_EXT_extended_dynamic_state)
+  const VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT,
+      .extendedDynamicState = VK_TRUE,
+  };
+  if (enableExtendedDynamicState == VK_TRUE) {
+    ivkAddNext(&ci, &extendedDynamicStateFeature);
+  }
+#else
+  (void)enableExtendedDynamicState;
+#endif // defined(VK_EXT_extended_dynamic_state)
+
+#if defined(VK_EXT_extended_dynamic_state2)
+  const VkPhysicalDeviceExtendedDynamicState2FeaturesEXT extendedDynamicState2Feature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT,
+      .extendedDynamicState2 = VK_TRUE,
+  };
+  if (enableExtendedDynamicState2 == VK_TRUE) {
+    ivkAddNext(&ci, &extendedDynamicState2Feature);
+  }
+#else
+  (void)enableExtendedDynamicState2;
+#endif // defined(VK_EXT_extended_dynamic_state2)
+
+  const VkPhysicalDeviceImagelessFramebufferFeaturesKHR imagelessFramebufferFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGELESS_FRAMEBUFFER_FEATURES_KHR,
+      .imagelessFramebuffer = VK_TRUE,
+  };
+  if (enableImagelessFramebuffer == VK_TRUE) {
+    ivkAddNext(&ci, &imagelessFramebufferFeature);
+  }
+
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+  const VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+      .descriptorBuffer = VK_TRUE,
+  };
+  if (enableDescriptorBuffer == VK_TRUE) {
+    ivkAddNext(&ci, &descriptorBufferFeature);
+  }
+#else
+  (void)enableDescriptorBuffer;
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+
+#if IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+  const VkPhysicalDeviceHostImageCopyFeaturesEXT hostImageCopyFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT,
+      .hostImageCopy = VK_TRUE,
+  };
+  if (enableHostImageCopy == VK_TRUE) {
+    ivkAddNext(&ci, &hostImageCopyFeature);
+  }
+#else
+  (void)enableHostImageCopy;
+#endif // IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+
+#if IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED
+  const VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+      .graphicsPipelineLibrary = VK_TRUE,
+  };
+  if (enableGraphicsPipelineLibrary == VK_TRUE) {
+    ivkAddNext(&ci, &graphicsPipelineLibraryFeature);
+  }
+#else
+  (void)enableGraphicsPipelineLibrary;
+#endif // IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED
+
+#if defined(VK_EXT_subgroup_size_control)
+  const VkPhysicalDeviceSubgroupSizeControlFeaturesEXT subgroupSizeControlFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_FEATURES_EXT,
+      .subgroupSizeControl = VK_TRUE,
+      .computeFullSubgroups = VK_TRUE,
+  };
+  if (enableSubgroupSizeControl == VK_TRUE) {
+    ivkAddNext(&ci, &subgroupSizeControlFeature);
+  }
+#else
+  (void)enableSubgroupSizeControl;
+#endif // defined(VK_EXT_subgroup_size_control)
+
   return vkCreateDevice(physicalDevice, &ci, NULL, outDevice);
 }
 
@@ -482,6 +662,7 @@ VkResult ivkCreateSwapchain(VkDevice device,
                             VkSurfaceFormatKHR surfaceFormat,
                             VkPresentModeKHR presentMode,
                             const VkSurfaceCapabilitiesKHR* caps,
+                            VkSurfaceTransformFlagBitsKHR preTransform,
                             VkImageUsageFlags imageUsage,
                             uint32_t queueFamilyIndex,
                             uint32_t width,
@@ -502,7 +683,7 @@ VkResult ivkCreateSwapchain(VkDevice device,
       .imageSharingMode = VK_SHARING_MODE_EXCLUSIVE,
       .queueFamilyIndexCount = 1,
       .pQueueFamilyIndices = &queueFamilyIndex,
-      .preTransform = caps->currentTransform,
+      .preTransform = preTransform,
       .compositeAlpha = isCompositeAlphaOpaqueSupported ? VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR
                                                         : VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR,
       .presentMode = presentMode,
@@ -582,16 +763,20 @@ VkResult ivkCreateImageView(VkDevice device,
                             VkImageViewType type,
                             VkFormat imageFormat,
                             VkImageSubresourceRange range,
+                            VkSamplerYcbcrConversion ycbcrConversion,
+                            VkComponentMapping components,
                             VkImageView* outImageView) {
+  const VkSamplerYcbcrConversionInfo conversionInfo = {
+      .sType = VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_INFO,
+      .conversion = ycbcrConversion,
+  };
   const VkImageViewCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+      .pNext = ycbcrConversion != VK_NULL_HANDLE ? &conversionInfo : NULL,
       .image = image,
       .viewType = type,
       .format = imageFormat,
-      .components = {.r = VK_COMPONENT_SWIZZLE_IDENTITY,
-                     .g = VK_COMPONENT_SWIZZLE_IDENTITY,
-                     .b = VK_COMPONENT_SWIZZLE_IDENTITY,
-                     .a = VK_COMPONENT_SWIZZLE_IDENTITY},
+      .components = components,
       .subresourceRange = range,
   };
 
@@ -617,6 +802,32 @@ VkResult ivkCreateFramebuffer(VkDevice device,
   return vkCreateFramebuffer(device, &ci, NULL, outFramebuffer);
 }
 
+VkResult ivkCreateImagelessFramebuffer(
+    VkDevice device,
+    uint32_t width,
+    uint32_t height,
+    VkRenderPass renderPass,
+    size_t numAttachments,
+    const VkFramebufferAttachmentImageInfoKHR* attachmentImageInfos,
+    VkFramebuffer* outFramebuffer) {
+  const VkFramebufferAttachmentsCreateInfoKHR attachmentsCreateInfo = {
+      .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENTS_CREATE_INFO_KHR,
+      .attachmentImageInfoCount = (uint32_t)numAttachments,
+      .pAttachmentImageInfos = attachmentImageInfos,
+  };
+  const VkFramebufferCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+      .pNext = &attachmentsCreateInfo,
+      .flags = VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT_KHR,
+      .renderPass = renderPass,
+      .attachmentCount = (uint32_t)numAttachments,
+      .width = width,
+      .height = height,
+      .layers = 1,
+  };
+  return vkCreateFramebuffer(device, &ci, NULL, outFramebuffer);
+}
+
 VkAttachmentDescription2 ivkGetAttachmentDescriptionColor(VkFormat format,
                                                           VkAttachmentLoadOp loadOp,
                                                           VkAttachmentStoreOp storeOp,
@@ -649,20 +860,35 @@ VkAttachmentReference2 ivkGetAttachmentReferenceColor(uint32_t idx) {
 VkResult ivkCreateRenderPass(VkDevice device,
                              uint32_t numAttachments,
                              const VkAttachmentDescription* attachments,
-                             const VkSubpassDescription* subpass,
-                             const VkSubpassDependency* dependency,
+                             uint32_t numSubpasses,
+                             const VkSubpassDescription* subpasses,
+                             uint32_t numDependencies,
+                             const VkSubpassDependency* dependencies,
                              const VkRenderPassMultiviewCreateInfo* renderPassMultiview,
+                             const VkRenderPassFragmentDensityMapCreateInfoEXT* fragmentDensityMap,
                              VkRenderPass* outRenderPass) {
-  const VkRenderPassCreateInfo ci = {
+  VkRenderPassCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-      .pNext = renderPassMultiview,
       .attachmentCount = numAttachments,
       .pAttachments = attachments,
-      .subpassCount = 1,
-      .pSubpasses = subpass,
-      .dependencyCount = 1,
-      .pDependencies = dependency,
-  };
+      .subpassCount = numSubpasses,
+      .pSubpasses = subpasses,
+      .dependencyCount = numDependencies,
+      .pDependencies = dependencies,
+  };
+  // copies, so chaining the structures does not modify the caller's ones
+  VkRenderPassMultiviewCreateInfo multiviewCopy;
+  if (renderPassMultiview) {
+    multiviewCopy = *renderPassMultiview;
+    multiviewCopy.pNext = NULL;
+    ivkAddNext(&ci, &multiviewCopy);
+  }
+  VkRenderPassFragmentDensityMapCreateInfoEXT fragmentDensityMapCopy;
+  if (fragmentDensityMap) {
+    fragmentDensityMapCopy = *fragmentDensityMap;
+    fragmentDensityMapCopy.pNext = NULL;
+    ivkAddNext(&ci, &fragmentDensityMapCopy);
+  }
   return vkCreateRenderPass(device, &ci, NULL, outRenderPass);
 }
 
@@ -736,12 +962,13 @@ VkSubpassDependency ivkGetSubpassDependency(void) {
 }
 
 VkRenderPassMultiviewCreateInfo ivkGetRenderPassMultiviewCreateInfo(
-    const uint32_t* viewMask,
+    uint32_t numSubpasses,
+    const uint32_t* viewMasks,
     const uint32_t* correlationMask) {
   const VkRenderPassMultiviewCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO,
-      .subpassCount = 1,
-      .pViewMasks = viewMask,
+      .subpassCount = numSubpasses,
+      .pViewMasks = viewMasks,
       .correlationMaskCount = 1,
       .pCorrelationMasks = correlationMask,
   };
@@ -767,8 +994,8 @@ VkResult ivkCreateDescriptorSetLayout(VkDevice device,
   const VkDescriptorSetLayoutCreateInfo ci = {
     .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
 #if !IGL_PLATFORM_ANDROID
-    .pNext = &setLayoutBindingFlagsCI,
-    .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT,
+    .pNext = bindingFlags ? &setLayoutBindingFlagsCI : NULL,
+    .flags = bindingFlags ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT : 0,
 #endif
     .bindingCount = numBindings,
     .pBindings = bindings,
@@ -776,6 +1003,37 @@ VkResult ivkCreateDescriptorSetLayout(VkDevice device,
   return vkCreateDescriptorSetLayout(device, &ci, NULL, outLayout);
 }
 
+VkResult ivkCreatePushDescriptorSetLayout(VkDevice device,
+                                          uint32_t numBindings,
+                                          const VkDescriptorSetLayoutBinding* bindings,
+                                          VkDescriptorSetLayout* outLayout) {
+  // push descriptor set layouts cannot use VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+  const VkDescriptorSetLayoutCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR,
+      .bindingCount = numBindings,
+      .pBindings = bindings,
+  };
+  return vkCreateDescriptorSetLayout(device, &ci, NULL, outLayout);
+}
+
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+VkResult ivkCreateDescriptorBufferSetLayout(VkDevice device,
+                                            uint32_t numBindings,
+                                            const VkDescriptorSetLayoutBinding* bindings,
+                                            VkDescriptorSetLayout* outLayout) {
+  // descriptor buffer set layouts cannot use VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT and do not
+  // need it: descriptors are plain memory, written whenever the GPU does not read it
+  const VkDescriptorSetLayoutCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT,
+      .bindingCount = numBindings,
+      .pBindings = bindings,
+  };
+  return vkCreateDescriptorSetLayout(device, &ci, NULL, outLayout);
+}
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+
 VkResult ivkAllocateDescriptorSet(VkDevice device,
                                   VkDescriptorPool pool,
                                   VkDescriptorSetLayout layout,
@@ -814,6 +1072,29 @@ VkResult ivkBeginCommandBuffer(VkCommandBuffer buffer) {
   return vkBeginCommandBuffer(buffer, &bi);
 }
 
+VkResult ivkBeginSecondaryCommandBuffer(VkCommandBuffer buffer,
+                                        VkRenderPass renderPass,
+                                        VkFramebuffer framebuffer,
+                                        const void* inheritanceNext,
+                                        bool reusable) {
+  const VkCommandBufferInheritanceInfo ii = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+      .pNext = inheritanceNext,
+      .renderPass = renderPass,
+      .subpass = 0,
+      .framebuffer = framebuffer,
+  };
+  const VkCommandBufferBeginInfo bi = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .pNext = NULL,
+      .flags = (reusable ? VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT
+                         : VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT) |
+               VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+      .pInheritanceInfo = &ii,
+  };
+  return vkBeginCommandBuffer(buffer, &bi);
+}
+
 VkResult ivkEndCommandBuffer(VkCommandBuffer buffer) {
   return vkEndCommandBuffer(buffer);
 }
@@ -1145,16 +1426,18 @@ VkPushConstantRange ivkGetPushConstantRange(VkShaderStageFlags stageFlags,
   return range;
 }
 
-VkPipelineShaderStageCreateInfo ivkGetPipelineShaderStageCreateInfo(VkShaderStageFlagBits stage,
-                                                                    VkShaderModule shaderModule,
-                                                                    const char* entryPoint) {
+VkPipelineShaderStageCreateInfo ivkGetPipelineShaderStageCreateInfo(
+    VkShaderStageFlagBits stage,
+    VkShaderModule shaderModule,
+    const char* entryPoint,
+    const VkSpecializationInfo* specializationInfo) {
   const VkPipelineShaderStageCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
       .flags = 0,
       .stage = stage,
       .module = shaderModule,
       .pName = entryPoint ? entryPoint : "main",
-      .pSpecializationInfo = NULL,
+      .pSpecializationInfo = specializationInfo,
   };
   return ci;
 }
@@ -1246,6 +1529,7 @@ VkResult ivkCreateShaderModuleFromSPIRV(VkDevice device,
 
 VkResult ivkCreateGraphicsPipeline(VkDevice device,
                                    VkPipelineCache pipelineCache,
+                                   VkPipelineCreateFlags flags,
                                    uint32_t numShaderStages,
                                    const VkPipelineShaderStageCreateInfo* shaderStages,
                                    const VkPipelineVertexInputStateCreateInfo* vertexInputState,
@@ -1259,11 +1543,13 @@ VkResult ivkCreateGraphicsPipeline(VkDevice device,
                                    const VkPipelineDynamicStateCreateInfo* dynamicState,
                                    VkPipelineLayout pipelineLayout,
                                    VkRenderPass renderPass,
+                                   uint32_t subpass,
+                                   const void* next,
                                    VkPipeline* outPipeline) {
   const VkGraphicsPipelineCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-      .pNext = NULL,
-      .flags = 0,
+      .pNext = next,
+      .flags = flags,
       .stageCount = numShaderStages,
       .pStages = shaderStages,
       .pVertexInputState = vertexInputState,
@@ -1277,7 +1563,7 @@ VkResult ivkCreateGraphicsPipeline(VkDevice device,
       .pDynamicState = dynamicState,
       .layout = pipelineLayout,
       .renderPass = renderPass,
-      .subpass = 0,
+      .subpass = subpass,
       .basePipelineHandle = VK_NULL_HANDLE,
       .basePipelineIndex = -1,
   };
@@ -1286,13 +1572,14 @@ VkResult ivkCreateGraphicsPipeline(VkDevice device,
 
 VkResult ivkCreateComputePipeline(VkDevice device,
                                   VkPipelineCache pipelineCache,
+                                  VkPipelineCreateFlags flags,
                                   const VkPipelineShaderStageCreateInfo* shaderStage,
                                   VkPipelineLayout pipelineLayout,
                                   VkPipeline* outPipeline) {
   const VkComputePipelineCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
       .pNext = NULL,
-      .flags = 0,
+      .flags = flags,
       .stage = *shaderStage,
       .layout = pipelineLayout,
       .basePipelineHandle = VK_NULL_HANDLE,
@@ -1365,8 +1652,9 @@ void ivkCmdBlitImage(VkCommandBuffer buffer,
 VkResult ivkQueuePresent(VkQueue graphicsQueue,
                          VkSemaphore waitSemaphore,
                          VkSwapchainKHR swapchain,
-                         uint32_t currentSwapchainImageIndex) {
-  const VkPresentInfoKHR pi = {
+                         uint32_t currentSwapchainImageIndex,
+                         uint64_t presentId) {
+  VkPresentInfoKHR pi = {
       .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
       .waitSemaphoreCount = 1,
       .pWaitSemaphores = &waitSemaphore,
@@ -1374,6 +1662,18 @@ VkResult ivkQueuePresent(VkQueue graphicsQueue,
       .pSwapchains = &swapchain,
       .pImageIndices = &currentSwapchainImageIndex,
   };
+#if defined(VK_KHR_present_id)
+  const VkPresentIdKHR presentIdInfo = {
+      .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+      .swapchainCount = 1,
+      .pPresentIds = &presentId,
+  };
+  if (presentId) {
+    pi.pNext = &presentIdInfo;
+  }
+#else
+  (void)presentId;
+#endif // defined(VK_KHR_present_id)
   return vkQueuePresentKHR(graphicsQueue, &pi);
 }
 
@@ -1506,6 +1806,8 @@ VkResult ivkVmaCreateAllocator(VkPhysicalDevice physDev,
                                VkInstance instance,
                                uint32_t apiVersion,
                                bool enableBufferDeviceAddress,
+                               bool enableMemoryBudget,
+                               bool enableMemoryPriority,
                                VmaAllocator* outVma) {
   const VmaVulkanFunctions funcs = {
     .vkGetInstanceProcAddr = vkGetInstanceProcAddr,
@@ -1543,7 +1845,9 @@ VkResult ivkVmaCreateAllocator(VkPhysicalDevice physDev,
   };
 
   const VmaAllocatorCreateInfo ci = {
-      .flags = enableBufferDeviceAddress ? VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT : 0,
+      .flags = (enableBufferDeviceAddress ? VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT : 0) |
+               (enableMemoryBudget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0) |
+               (enableMemoryPriority ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT : 0),
       .physicalDevice = physDev,
       .device = device,
       .preferredLargeHeapBlockSize = 0,
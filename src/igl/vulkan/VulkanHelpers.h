@@ -22,6 +22,32 @@
 
 #define IGL_ARRAY_NUM_ELEMENTS(x) (sizeof(x) / sizeof((x)[0]))
 
+// rendering without VkRenderPass and VkFramebuffer objects needs both extensions
+#if defined(VK_KHR_dynamic_rendering) && defined(VK_KHR_synchronization2)
+#define IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED 1
+#else
+#define IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED 0
+#endif
+
+#if defined(VK_EXT_descriptor_buffer)
+#define IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED 1
+#else
+#define IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED 0
+#endif
+
+#if defined(VK_EXT_host_image_copy)
+#define IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED 1
+#else
+#define IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED 0
+#endif
+
+// graphics pipeline libraries need both extensions
+#if defined(VK_EXT_graphics_pipeline_library) && defined(VK_KHR_pipeline_library)
+#define IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED 1
+#else
+#define IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED 0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -49,6 +75,9 @@ VkResult ivkCreateDebugReportMessenger(VkInstance instance,
                                        VkDebugReportCallbackEXT* outMessenger);
 
 VkResult ivkCreateSemaphore(VkDevice device, VkSemaphore* outSemaphore);
+VkResult ivkCreateTimelineSemaphore(VkDevice device,
+                                    uint64_t initialValue,
+                                    VkSemaphore* outSemaphore);
 
 VkResult ivkCreateFence(VkDevice device, VkFlags flags, VkFence* outFence);
 
@@ -66,6 +95,19 @@ VkResult ivkCreateDevice(VkPhysicalDevice physicalDevice,
                          VkBool32 enableShaderFloat16,
                          VkBool32 enableBufferDeviceAddress,
                          VkBool32 enableDescriptorIndexing,
+                         VkBool32 enableTimelineSemaphore,
+                         VkBool32 enableFragmentDensityMap,
+                         VkBool32 enablePresentWait,
+                         VkBool32 enableMemoryPriority,
+                         VkBool32 enableSamplerYcbcrConversion,
+                         VkBool32 enableDynamicRendering,
+                         VkBool32 enableExtendedDynamicState,
+                         VkBool32 enableExtendedDynamicState2,
+                         VkBool32 enableImagelessFramebuffer,
+                         VkBool32 enableDescriptorBuffer,
+                         VkBool32 enableHostImageCopy,
+                         VkBool32 enableGraphicsPipelineLibrary,
+                         VkBool32 enableSubgroupSizeControl,
                          VkDevice* outDevice);
 
 VkResult ivkCreateHeadlessSurface(VkInstance instance, VkSurfaceKHR* surface);
@@ -76,6 +118,7 @@ VkResult ivkCreateSwapchain(VkDevice device,
                             VkSurfaceFormatKHR surfaceFormat,
                             VkPresentModeKHR presentMode,
                             const VkSurfaceCapabilitiesKHR* caps,
+                            VkSurfaceTransformFlagBitsKHR preTransform,
                             VkImageUsageFlags imageUsage,
                             uint32_t queueFamilyIndex,
                             uint32_t width,
@@ -98,6 +141,8 @@ VkResult ivkCreateImageView(VkDevice device,
                             VkImageViewType type,
                             VkFormat imageFormat,
                             VkImageSubresourceRange range,
+                            VkSamplerYcbcrConversion ycbcrConversion,
+                            VkComponentMapping components,
                             VkImageView* outImageView);
 
 VkResult ivkCreateFramebuffer(VkDevice device,
@@ -108,6 +153,17 @@ VkResult ivkCreateFramebuffer(VkDevice device,
                               const VkImageView* attachments,
                               VkFramebuffer* outFramebuffer);
 
+// creates a framebuffer with VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT, which gets its image
+// views from VkRenderPassAttachmentBeginInfo when a render pass begins
+VkResult ivkCreateImagelessFramebuffer(
+    VkDevice device,
+    uint32_t width,
+    uint32_t height,
+    VkRenderPass renderPass,
+    size_t numAttachments,
+    const VkFramebufferAttachmentImageInfoKHR* attachmentImageInfos,
+    VkFramebuffer* outFramebuffer);
+
 VkResult ivkCreateCommandPool(VkDevice device,
                               VkCommandPoolCreateFlags flags,
                               uint32_t queueFamilyIndex,
@@ -133,9 +189,12 @@ uint32_t ivkFindMemoryType(VkPhysicalDevice physDev,
 VkResult ivkCreateRenderPass(VkDevice device,
                              uint32_t numAttachments,
                              const VkAttachmentDescription* attachments,
-                             const VkSubpassDescription* subpass,
-                             const VkSubpassDependency* dependency,
+                             uint32_t numSubpasses,
+                             const VkSubpassDescription* subpasses,
+                             uint32_t numDependencies,
+                             const VkSubpassDependency* dependencies,
                              const VkRenderPassMultiviewCreateInfo* renderPassMultiview,
+                             const VkRenderPassFragmentDensityMapCreateInfoEXT* fragmentDensityMap,
                              VkRenderPass* outRenderPass);
 
 VkResult ivkCreateShaderModule(VkDevice device,
@@ -149,6 +208,7 @@ VkResult ivkCreateShaderModuleFromSPIRV(VkDevice device,
 
 VkResult ivkCreateGraphicsPipeline(VkDevice device,
                                    VkPipelineCache pipelineCache,
+                                   VkPipelineCreateFlags flags,
                                    uint32_t numShaderStages,
                                    const VkPipelineShaderStageCreateInfo* shaderStages,
                                    const VkPipelineVertexInputStateCreateInfo* vertexInputState,
@@ -162,20 +222,40 @@ VkResult ivkCreateGraphicsPipeline(VkDevice device,
                                    const VkPipelineDynamicStateCreateInfo* dynamicState,
                                    VkPipelineLayout pipelineLayout,
                                    VkRenderPass renderPass,
+                                   uint32_t subpass,
+                                   const void* next,
                                    VkPipeline* outPipeline);
 
 VkResult ivkCreateComputePipeline(VkDevice device,
                                   VkPipelineCache pipelineCache,
+                                  VkPipelineCreateFlags flags,
                                   const VkPipelineShaderStageCreateInfo* shaderStage,
                                   VkPipelineLayout pipelineLayout,
                                   VkPipeline* outPipeline);
 
+/// `bindingFlags` may be NULL for a layout which is not updated after bind; this is required for
+/// dynamic uniform and storage buffers
 VkResult ivkCreateDescriptorSetLayout(VkDevice device,
                                       uint32_t numBindings,
                                       const VkDescriptorSetLayoutBinding* bindings,
                                       const VkDescriptorBindingFlags* bindingFlags,
                                       VkDescriptorSetLayout* outLayout);
 
+/// Sets of this layout are not allocated: their bindings are written with vkCmdPushDescriptorSetKHR
+VkResult ivkCreatePushDescriptorSetLayout(VkDevice device,
+                                          uint32_t numBindings,
+                                          const VkDescriptorSetLayoutBinding* bindings,
+                                          VkDescriptorSetLayout* outLayout);
+
+#if IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+/// Sets of this layout are not allocated: their descriptors are written into descriptor buffers
+/// with vkGetDescriptorEXT
+VkResult ivkCreateDescriptorBufferSetLayout(VkDevice device,
+                                            uint32_t numBindings,
+                                            const VkDescriptorSetLayoutBinding* bindings,
+                                            VkDescriptorSetLayout* outLayout);
+#endif // IGL_VULKAN_DESCRIPTOR_BUFFER_SUPPORTED
+
 VkDescriptorSetLayoutBinding ivkGetDescriptorSetLayoutBinding(uint32_t binding,
                                                               VkDescriptorType descriptorType,
                                                               uint32_t descriptorCount);
@@ -197,7 +277,8 @@ VkSubpassDescription ivkGetSubpassDescription(uint32_t numColorAttachments,
 VkSubpassDependency ivkGetSubpassDependency(void);
 
 VkRenderPassMultiviewCreateInfo ivkGetRenderPassMultiviewCreateInfo(
-    const uint32_t* viewMask,
+    uint32_t numSubpasses,
+    const uint32_t* viewMasks,
     const uint32_t* correlationMask);
 
 VkResult ivkAllocateDescriptorSet(VkDevice device,
@@ -212,7 +293,14 @@ VkResult ivkCreateDescriptorPool(VkDevice device,
                                  VkDescriptorPool* outDescriptorPool);
 
 VkResult ivkBeginCommandBuffer(VkCommandBuffer buffer);
-
+// continues subpass 0 of `renderPass`, or the dynamic rendering described by `inheritanceNext`
+// (VkCommandBufferInheritanceRenderingInfoKHR) if `renderPass` is VK_NULL_HANDLE. A `reusable`
+// buffer can be executed by several primary command buffers at once and is never reset by them
+VkResult ivkBeginSecondaryCommandBuffer(VkCommandBuffer buffer,
+                                        VkRenderPass renderPass,
+                                        VkFramebuffer framebuffer,
+                                        const void* inheritanceNext,
+                                        bool reusable);
 VkResult ivkEndCommandBuffer(VkCommandBuffer buffer);
 
 VkSubmitInfo ivkGetSubmitInfo(const VkCommandBuffer* buffer,
@@ -314,9 +402,11 @@ VkViewport ivkGetViewport(float x, float y, float width, float height);
 
 VkRect2D ivkGetRect2D(int32_t x, int32_t y, uint32_t width, uint32_t height);
 
-VkPipelineShaderStageCreateInfo ivkGetPipelineShaderStageCreateInfo(VkShaderStageFlagBits stage,
-                                                                    VkShaderModule shaderModule,
-                                                                    const char* entryPoint);
+VkPipelineShaderStageCreateInfo ivkGetPipelineShaderStageCreateInfo(
+    VkShaderStageFlagBits stage,
+    VkShaderModule shaderModule,
+    const char* entryPoint,
+    const VkSpecializationInfo* specializationInfo);
 
 VkImageCopy ivkGetImageCopy2D(VkOffset2D srcDstOffset,
                               VkImageSubresourceLayers srcDstImageSubresource,
@@ -364,10 +454,12 @@ void ivkCmdBlitImage(VkCommandBuffer buffer,
                      VkImageSubresourceLayers dstSubresourceRange,
                      VkFilter filter);
 
+// presentId is ignored if 0
 VkResult ivkQueuePresent(VkQueue graphicsQueue,
                          VkSemaphore waitSemaphore,
                          VkSwapchainKHR swapchain,
-                         uint32_t currentSwapchainImageIndex);
+                         uint32_t currentSwapchainImageIndex,
+                         uint64_t presentId);
 
 VkResult ivkSetDebugObjectName(VkDevice device,
                                VkObjectType type,
@@ -395,6 +487,8 @@ VkResult ivkVmaCreateAllocator(VkPhysicalDevice physDev,
                                VkInstance instance,
                                uint32_t apiVersion,
                                bool enableBufferDeviceAddress,
+                               bool enableMemoryBudget,
+                               bool enableMemoryPriority,
                                VmaAllocator* outVma);
 
 void ivkGlslangResource(glslang_resource_t* glslangResource,
@@ -11,12 +11,17 @@
 #include <cinttypes>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDefragmenter.h>
 #include <igl/vulkan/VulkanImageView.h>
 
 #ifndef VK_USE_PLATFORM_WIN32_KHR
 #include <unistd.h>
 #endif
 
+#if IGL_ANDROID_HWBUFFER_SUPPORTED
+#include <android/hardware_buffer.h>
+#endif // IGL_ANDROID_HWBUFFER_SUPPORTED
+
 namespace {
 uint32_t ivkGetMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties& memProps,
                                const uint32_t typeBits,
@@ -35,6 +40,41 @@ uint32_t ivkGetMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties& memProps,
   return 0;
 }
 
+// images cannot be written in these layouts, except by layout transitions
+bool isReadOnlyLayout(VkImageLayout layout) {
+  switch (layout) {
+  case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+  case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+  case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// the accesses which can write images in `stages`
+VkAccessFlags getWriteAccessMask(VkPipelineStageFlags stages) {
+  if (stages & (VK_PIPELINE_STAGE_ALL_COMMANDS_BIT | VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT)) {
+    return VK_ACCESS_MEMORY_WRITE_BIT;
+  }
+  VkAccessFlags access = 0;
+  if (stages & (VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT)) {
+    access |= VK_ACCESS_SHADER_WRITE_BIT;
+  }
+  if (stages & VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT) {
+    access |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  }
+  if (stages &
+      (VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT)) {
+    access |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  }
+  if (stages & VK_PIPELINE_STAGE_TRANSFER_BIT) {
+    access |= VK_ACCESS_TRANSFER_WRITE_BIT;
+  }
+  return access;
+}
+
 // VkImage export and import is only implemented on Windows, Linux and Android platforms.
 #if IGL_PLATFORM_WIN
 constexpr auto kHandleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_KMT_BIT;
@@ -92,11 +132,13 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
                          VkMemoryPropertyFlags memFlags,
                          VkImageCreateFlags createFlags,
                          VkSampleCountFlagBits samples,
-                         const char* debugName) :
+                         const char* debugName,
+                         float memoryPriority) :
   ctx_(ctx),
   physicalDevice_(ctx.getVkPhysicalDevice()),
   device_(device),
   usageFlags_(usageFlags),
+  createFlags_(createFlags),
   extent_(extent),
   type_(type),
   imageFormat_(format),
@@ -114,20 +156,26 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
   IGL_ASSERT_MSG(imageFormat_ != VK_FORMAT_UNDEFINED, "Invalid VkFormat value");
   IGL_ASSERT_MSG(samples_ > 0, "The image must contain at least one sample");
 
-  const VkImageCreateInfo ci = ivkGetImageCreateInfo(type,
-                                                     imageFormat_,
-                                                     tiling,
-                                                     usageFlags,
-                                                     extent_,
-                                                     mipLevels_,
-                                                     arrayLayers_,
-                                                     createFlags,
-                                                     samples);
+  VkImageCreateInfo ci = ivkGetImageCreateInfo(type,
+                                               imageFormat_,
+                                               tiling,
+                                               usageFlags,
+                                               extent_,
+                                               mipLevels_,
+                                               arrayLayers_,
+                                               createFlags,
+                                               samples);
+  ctx_.setSharingMode(ci.sharingMode, ci.queueFamilyIndexCount, ci.pQueueFamilyIndices);
 
   if (IGL_VULKAN_USE_VMA) {
     vmaAllocInfo_.usage = memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
                               ? VMA_MEMORY_USAGE_CPU_TO_GPU
                               : VMA_MEMORY_USAGE_AUTO;
+    if (memFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+      vmaAllocInfo_.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+    }
+    // used only if VK_EXT_memory_priority is enabled
+    vmaAllocInfo_.priority = memoryPriority;
 
     VkResult result = vmaCreateImage((VmaAllocator)ctx_.getVmaAllocator(),
                                      &ci,
@@ -203,6 +251,7 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
   physicalDevice_(ctx.getVkPhysicalDevice()),
   device_(device),
   usageFlags_(usageFlags),
+  createFlags_(createFlags),
   extent_(extent),
   type_(type),
   imageFormat_(format),
@@ -317,6 +366,7 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
   physicalDevice_(ctx.getVkPhysicalDevice()),
   device_(device),
   usageFlags_(usageFlags),
+  createFlags_(createFlags),
   extent_(extent),
   type_(type),
   imageFormat_(format),
@@ -483,6 +533,7 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
   physicalDevice_(ctx.getVkPhysicalDevice()),
   device_(device),
   usageFlags_(usageFlags),
+  createFlags_(createFlags),
   extent_(extent),
   type_(type),
   imageFormat_(format),
@@ -582,6 +633,111 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
 }
 #endif // IGL_PLATFORM_WIN || IGL_PLATFORM_LINUX || IGL_PLATFORM_ANDROID
 
+#if IGL_ANDROID_HWBUFFER_SUPPORTED && defined(VK_ANDROID_external_memory_android_hardware_buffer)
+std::shared_ptr<VulkanImage> VulkanImage::createFromNativeHWBuffer(const VulkanContext& ctx,
+                                                                   VkDevice device,
+                                                                   AHardwareBuffer* hwBuffer,
+                                                                   VkImageUsageFlags usageFlags,
+                                                                   const char* debugName) {
+  VkAndroidHardwareBufferFormatPropertiesANDROID formatProperties = {
+      VK_STRUCTURE_TYPE_ANDROID_HARDWARE_BUFFER_FORMAT_PROPERTIES_ANDROID};
+  VkAndroidHardwareBufferPropertiesANDROID properties = {
+      VK_STRUCTURE_TYPE_ANDROID_HARDWARE_BUFFER_PROPERTIES_ANDROID, &formatProperties};
+  if (vkGetAndroidHardwareBufferPropertiesANDROID(device, hwBuffer, &properties) != VK_SUCCESS) {
+    IGL_LOG_ERROR("Cannot query the properties of the AHardwareBuffer\n");
+    return nullptr;
+  }
+  if (formatProperties.format == VK_FORMAT_UNDEFINED) {
+    IGL_LOG_ERROR("AHardwareBuffers with external formats are not supported\n");
+    return nullptr;
+  }
+
+  AHardwareBuffer_Desc desc = {};
+  AHardwareBuffer_describe(hwBuffer, &desc);
+
+  return std::shared_ptr<VulkanImage>(new VulkanImage(ctx,
+                                                      device,
+                                                      hwBuffer,
+                                                      VkExtent3D{desc.width, desc.height, 1},
+                                                      formatProperties.format,
+                                                      usageFlags,
+                                                      properties.allocationSize,
+                                                      properties.memoryTypeBits,
+                                                      debugName));
+}
+
+VulkanImage::VulkanImage(const VulkanContext& ctx,
+                         VkDevice device,
+                         AHardwareBuffer* hwBuffer,
+                         VkExtent3D extent,
+                         VkFormat format,
+                         VkImageUsageFlags usageFlags,
+                         VkDeviceSize allocationSize,
+                         uint32_t memoryTypeBits,
+                         const char* debugName) :
+  ctx_(ctx),
+  physicalDevice_(ctx.getVkPhysicalDevice()),
+  device_(device),
+  usageFlags_(usageFlags),
+  extent_(extent),
+  type_(VK_IMAGE_TYPE_2D),
+  imageFormat_(format),
+  isDepthFormat_(isDepthFormat(format)),
+  isStencilFormat_(isStencilFormat(format)),
+  isDepthOrStencilFormat_(isDepthFormat_ || isStencilFormat_),
+  isImported_(true),
+  nativeHWBuffer_(hwBuffer) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  const VkExternalMemoryImageCreateInfoKHR externalImageCreateInfo = {
+      VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO_KHR,
+      nullptr,
+      VK_EXTERNAL_MEMORY_HANDLE_TYPE_ANDROID_HARDWARE_BUFFER_BIT_ANDROID,
+  };
+
+  VkImageCreateInfo ci = ivkGetImageCreateInfo(type_,
+                                               imageFormat_,
+                                               VK_IMAGE_TILING_OPTIMAL,
+                                               usageFlags,
+                                               extent_,
+                                               mipLevels_,
+                                               arrayLayers_,
+                                               0,
+                                               samples_);
+  ci.pNext = &externalImageCreateInfo;
+  ci.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  // importing external memory cannot use VMA
+  VK_ASSERT(vkCreateImage(device_, &ci, nullptr, &vkImage_));
+  VK_ASSERT(ivkSetDebugObjectName(device_, VK_OBJECT_TYPE_IMAGE, (uint64_t)vkImage_, debugName));
+
+  // AHardwareBuffers can only be imported into dedicated allocations
+  const VkImportAndroidHardwareBufferInfoANDROID importInfo = {
+      VK_STRUCTURE_TYPE_IMPORT_ANDROID_HARDWARE_BUFFER_INFO_ANDROID, nullptr, hwBuffer};
+  const VkMemoryDedicatedAllocateInfoKHR dedicatedAllocateInfo = {
+      VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO_KHR, &importInfo, vkImage_, VK_NULL_HANDLE};
+
+  VkPhysicalDeviceMemoryProperties vulkanMemoryProperties;
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice_, &vulkanMemoryProperties);
+
+  const VkMemoryAllocateInfo memoryAllocateInfo = {
+      VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      &dedicatedAllocateInfo,
+      allocationSize,
+      ivkGetMemoryTypeIndex(vulkanMemoryProperties, memoryTypeBits, 0),
+  };
+
+  VK_ASSERT(vkAllocateMemory(device_, &memoryAllocateInfo, nullptr, &vkMemory_));
+  VK_ASSERT(vkBindImageMemory(device_, vkImage_, vkMemory_, 0));
+  allocatedSize = allocationSize;
+
+  // the imported memory holds a reference of its own; this one keeps `nativeHWBuffer_` valid
+  AHardwareBuffer_acquire(nativeHWBuffer_);
+
+  vkGetPhysicalDeviceFormatProperties(physicalDevice_, imageFormat_, &formatProperties_);
+}
+#endif // IGL_ANDROID_HWBUFFER_SUPPORTED
+
 VulkanImage::~VulkanImage() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
 
@@ -590,10 +746,11 @@ VulkanImage::~VulkanImage() {
       if (mappedPtr_) {
         vmaUnmapMemory((VmaAllocator)ctx_.getVmaAllocator(), vmaAllocation_);
       }
-      ctx_.deferredTask(std::packaged_task<void()>(
-          [vma = ctx_.getVmaAllocator(), image = vkImage_, allocation = vmaAllocation_]() {
-            vmaDestroyImage((VmaAllocator)vma, image, allocation);
-          }));
+      ctx_.deferredTask(std::packaged_task<void()>([defragmenter = ctx_.defragmenter_.get(),
+                                                    image = vkImage_,
+                                                    allocation = vmaAllocation_]() {
+        defragmenter->destroyImage(image, allocation);
+      }));
     } else {
       if (mappedPtr_) {
         vkUnmapMemory(device_, vkMemory_);
@@ -607,6 +764,14 @@ VulkanImage::~VulkanImage() {
           }));
     }
   }
+
+#if IGL_ANDROID_HWBUFFER_SUPPORTED
+  if (nativeHWBuffer_) {
+    // deferred tasks run in order, so the buffer outlives the image memory
+    ctx_.deferredTask(std::packaged_task<void()>(
+        [hwBuffer = nativeHWBuffer_]() { AHardwareBuffer_release(hwBuffer); }));
+  }
+#endif // IGL_ANDROID_HWBUFFER_SUPPORTED
 }
 
 std::shared_ptr<VulkanImageView> VulkanImage::createImageView(VkImageViewType type,
@@ -616,7 +781,8 @@ std::shared_ptr<VulkanImageView> VulkanImage::createImageView(VkImageViewType ty
                                                               uint32_t numLevels,
                                                               uint32_t baseLayer,
                                                               uint32_t numLayers,
-                                                              const char* debugName) const {
+                                                              const char* debugName,
+                                                              VkComponentMapping components) const {
   return std::make_shared<VulkanImageView>(ctx_,
                                            device_,
                                            vkImage_,
@@ -627,7 +793,11 @@ std::shared_ptr<VulkanImageView> VulkanImage::createImageView(VkImageViewType ty
                                            numLevels ? numLevels : mipLevels_,
                                            baseLayer,
                                            numLayers,
-                                           debugName);
+                                           debugName,
+                                           aspectMask == VK_IMAGE_ASPECT_COLOR_BIT
+                                               ? ctx_.getYcbcrConversion(format)
+                                               : VK_NULL_HANDLE,
+                                           components);
 }
 
 void VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
@@ -637,14 +807,28 @@ void VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
                                    const VkImageSubresourceRange& subresourceRange) const {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
 
-  VkAccessFlags srcAccessMask = 0;
-  VkAccessFlags dstAccessMask = 0;
-
-  if (imageLayout_ == VK_IMAGE_LAYOUT_UNDEFINED) {
-    // we do not need to wait for any previous operations in this case
-    srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+  std::vector<VkImageMemoryBarrier> barriers;
+  getTransitionBarriers(newImageLayout, srcStageMask, dstStageMask, subresourceRange, barriers);
+  if (barriers.empty()) {
+    return;
   }
+  vkCmdPipelineBarrier(commandBuffer,
+                       srcStageMask,
+                       dstStageMask,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       static_cast<uint32_t>(barriers.size()),
+                       barriers.data());
+}
 
+void VulkanImage::getTransitionBarriers(VkImageLayout newImageLayout,
+                                        VkPipelineStageFlags& srcStageMask,
+                                        VkPipelineStageFlags dstStageMask,
+                                        const VkImageSubresourceRange& subresourceRange,
+                                        std::vector<VkImageMemoryBarrier>& outBarriers) const {
   switch (srcStageMask) {
   case VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT:
   case VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT:
@@ -660,21 +844,6 @@ void VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
     break;
   }
 
-  // once you want to add a new pipeline stage to this block of if's, don't forget to add it to the
-  // switch() statement above
-  if (srcStageMask & VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT) {
-    srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-  }
-  if (srcStageMask & VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT) {
-    srcAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-  }
-  if (srcStageMask & VK_PIPELINE_STAGE_TRANSFER_BIT) {
-    srcAccessMask |= VK_ACCESS_TRANSFER_WRITE_BIT;
-  }
-  if (srcStageMask & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT) {
-    srcAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
-  }
-
   switch (dstStageMask) {
   case VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT:
   case VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT:
@@ -691,6 +860,7 @@ void VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
 
   // once you want to add a new pipeline stage to this block of if's, don't forget to add it to the
   // switch() statement above
+  VkAccessFlags dstAccessMask = 0;
   if (dstStageMask & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT) {
     dstAccessMask |= VK_ACCESS_SHADER_READ_BIT;
     dstAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
@@ -706,18 +876,255 @@ void VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
     dstAccessMask |= VK_ACCESS_TRANSFER_READ_BIT;
   }
 
-  ivkImageMemoryBarrier(commandBuffer,
-                        vkImage_,
-                        srcAccessMask,
-                        dstAccessMask,
-                        imageLayout_,
-                        newImageLayout,
-                        srcStageMask,
-                        dstStageMask,
-                        subresourceRange);
+  // `srcStageMask` is only a guess of the caller, used when a subresource was never tracked
+  const VkPipelineStageFlags guessedSrcStageMask = srcStageMask;
+  srcStageMask = 0;
+
+  const uint32_t baseLevel = subresourceRange.baseMipLevel;
+  const uint32_t baseLayer = subresourceRange.baseArrayLayer;
+  const uint32_t endLevel = subresourceRange.levelCount == VK_REMAINING_MIP_LEVELS
+                                ? mipLevels_
+                                : baseLevel + subresourceRange.levelCount;
+  const uint32_t endLayer = subresourceRange.layerCount == VK_REMAINING_ARRAY_LAYERS
+                                ? arrayLayers_
+                                : baseLayer + subresourceRange.layerCount;
+  IGL_ASSERT(endLevel <= mipLevels_ && endLayer <= arrayLayers_);
+
+  std::vector<SubresourceState>& states = getSubresourceStates();
+
+  for (uint32_t layer = baseLayer; layer < endLayer; layer++) {
+    const size_t firstBarrierOfLayer = outBarriers.size();
+
+    for (uint32_t level = baseLevel; level < endLevel; level++) {
+      SubresourceState& state = states[layer * mipLevels_ + level];
+
+      const bool isReadOnly = isReadOnlyLayout(state.layout);
+      const bool isVisible = (state.stages & VK_PIPELINE_STAGE_ALL_COMMANDS_BIT) != 0 ||
+                             (dstStageMask & ~state.stages) == 0;
+      if (state.layout == newImageLayout && isReadOnly && isVisible) {
+        // nothing can write in a read-only layout, and it is visible to these stages already
+        continue;
+      }
+
+      VkPipelineStageFlags stages = state.stages;
+      VkAccessFlags srcAccessMask = isReadOnly ? 0 : getWriteAccessMask(state.stages);
+      if (state.layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+        // we do not need to wait for any previous operations in this case
+        stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        srcAccessMask = 0;
+      } else if (stages == 0) {
+        stages = guessedSrcStageMask;
+        srcAccessMask = isReadOnly ? 0 : getWriteAccessMask(guessedSrcStageMask);
+      }
+      srcStageMask |= stages;
+
+      // extend the barrier of the previous level if the transition is the same
+      VkImageMemoryBarrier* last =
+          outBarriers.size() > firstBarrierOfLayer ? &outBarriers.back() : nullptr;
+      if (last && last->oldLayout == state.layout && last->srcAccessMask == srcAccessMask &&
+          last->subresourceRange.baseMipLevel + last->subresourceRange.levelCount == level) {
+        last->subresourceRange.levelCount++;
+      } else {
+        outBarriers.push_back(VkImageMemoryBarrier{
+            VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            nullptr,
+            srcAccessMask,
+            dstAccessMask,
+            state.layout,
+            newImageLayout,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            vkImage_,
+            VkImageSubresourceRange{subresourceRange.aspectMask, level, 1, layer, 1},
+        });
+      }
+
+      // reads in a read-only layout accumulate; anything else has to be waited for by the next
+      // transition. TOP_OF_PIPE says nothing about the next accesses: fall back to the guess then
+      const bool isRead = state.layout == newImageLayout && isReadOnly;
+      const VkPipelineStageFlags nextStages =
+          dstStageMask == VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT ? 0 : dstStageMask;
+      state.stages = isRead ? state.stages | nextStages : nextStages;
+      state.layout = newImageLayout;
+    }
+
+    // merge the barrier of this layer with the one of the previous layer if they are the same
+    if (outBarriers.size() == firstBarrierOfLayer + 1 && firstBarrierOfLayer > 0) {
+      const VkImageMemoryBarrier& barrier = outBarriers.back();
+      VkImageMemoryBarrier& prev = outBarriers[firstBarrierOfLayer - 1];
+      if (prev.image == vkImage_ && prev.oldLayout == barrier.oldLayout &&
+          prev.newLayout == barrier.newLayout && prev.srcAccessMask == barrier.srcAccessMask &&
+          prev.subresourceRange.baseMipLevel == barrier.subresourceRange.baseMipLevel &&
+          prev.subresourceRange.levelCount == barrier.subresourceRange.levelCount &&
+          prev.subresourceRange.baseArrayLayer + prev.subresourceRange.layerCount == layer) {
+        prev.subresourceRange.layerCount++;
+        outBarriers.pop_back();
+      }
+    }
+  }
+
+  imageLayout_ = newImageLayout;
+}
+
+#if IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+void VulkanImage::getTransitionBarriers2(VkImageLayout newImageLayout,
+                                         VkPipelineStageFlags dstStageMask,
+                                         VkAccessFlags dstAccessMask,
+                                         const VkImageSubresourceRange& subresourceRange,
+                                         bool discardContents,
+                                         std::vector<VkImageMemoryBarrier2KHR>& outBarriers) const {
+  const uint32_t endLevel = subresourceRange.levelCount == VK_REMAINING_MIP_LEVELS
+                                ? mipLevels_
+                                : subresourceRange.baseMipLevel + subresourceRange.levelCount;
+  const uint32_t endLayer = subresourceRange.layerCount == VK_REMAINING_ARRAY_LAYERS
+                                ? arrayLayers_
+                                : subresourceRange.baseArrayLayer + subresourceRange.layerCount;
+  IGL_ASSERT(endLevel <= mipLevels_ && endLayer <= arrayLayers_);
+
+  std::vector<SubresourceState>& states = getSubresourceStates();
+
+  for (uint32_t layer = subresourceRange.baseArrayLayer; layer < endLayer; layer++) {
+    for (uint32_t level = subresourceRange.baseMipLevel; level < endLevel; level++) {
+      SubresourceState& state = states[layer * mipLevels_ + level];
+
+      // the stage masks of synchronization2 extend the ones of Vulkan 1.0 with the same bits
+      VkImageMemoryBarrier2KHR barrier = {};
+      barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+      if (state.layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE_KHR;
+      } else {
+        // a discarded subresource still cannot be written before the previous accesses are done
+        const VkPipelineStageFlags stages =
+            state.stages ? state.stages : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        barrier.srcStageMask = stages;
+        barrier.srcAccessMask = isReadOnlyLayout(state.layout) ? 0 : getWriteAccessMask(stages);
+      }
+      barrier.dstStageMask = dstStageMask;
+      barrier.dstAccessMask = dstAccessMask;
+      barrier.oldLayout = discardContents ? VK_IMAGE_LAYOUT_UNDEFINED : state.layout;
+      barrier.newLayout = newImageLayout;
+      barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      barrier.image = vkImage_;
+      barrier.subresourceRange = {subresourceRange.aspectMask, level, 1, layer, 1};
+      outBarriers.push_back(barrier);
+
+      state = {newImageLayout, dstStageMask};
+    }
+  }
 
   imageLayout_ = newImageLayout;
 }
+#endif // IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+
+void VulkanImage::setLayout(VkImageLayout layout, VkPipelineStageFlags stages) const {
+  imageLayout_ = layout;
+  for (SubresourceState& state : getSubresourceStates()) {
+    state = {layout, stages};
+  }
+}
+
+VkImageLayout VulkanImage::getLayout(uint32_t level, uint32_t layer) const {
+  IGL_ASSERT(level < mipLevels_ && layer < arrayLayers_);
+  return getSubresourceStates()[layer * mipLevels_ + level].layout;
+}
+
+std::vector<VulkanImage::SubresourceState>& VulkanImage::getSubresourceStates() const {
+  // created on first use, since images are constructed in many ways
+  if (subresourceStates_.empty()) {
+    subresourceStates_.resize(static_cast<size_t>(mipLevels_) * arrayLayers_,
+                              SubresourceState{imageLayout_, 0});
+  }
+  return subresourceStates_;
+}
+
+bool VulkanImage::hostImageData(const VkOffset3D& offset,
+                                const VkExtent3D& extent,
+                                uint32_t baseMipLevel,
+                                uint32_t numMipLevels,
+                                uint32_t layer,
+                                TextureFormatProperties properties,
+                                const void* data) const {
+#if IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+  if (!ctx_.useHostImageCopy_ || (usageFlags_ & VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT) == 0 ||
+      isDepthOrStencilFormat_ || properties.isMultiPlanar()) {
+    return false;
+  }
+  if (!IGL_VERIFY(baseMipLevel + numMipLevels <= mipLevels_ && layer < arrayLayers_)) {
+    return false;
+  }
+  for (uint32_t level = baseMipLevel; level != baseMipLevel + numMipLevels; level++) {
+    if (getLayout(level, layer) != VK_IMAGE_LAYOUT_UNDEFINED) {
+      return false;
+    }
+  }
+
+  IGL_PROFILER_FUNCTION();
+
+  const VkImageLayout layout = ctx_.hostImageCopyLayout_;
+  const VkImageSubresourceRange range = {
+      VK_IMAGE_ASPECT_COLOR_BIT, baseMipLevel, numMipLevels, layer, 1};
+  const VkHostImageLayoutTransitionInfoEXT transition = {
+      VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT,
+      nullptr,
+      vkImage_,
+      VK_IMAGE_LAYOUT_UNDEFINED,
+      layout,
+      range,
+  };
+  VK_ASSERT(vkTransitionImageLayoutEXT(device_, 1, &transition));
+
+  std::vector<VkMemoryToImageCopyEXT> regions;
+  regions.reserve(numMipLevels);
+  const uint8_t* ptr = static_cast<const uint8_t*>(data);
+  for (uint32_t i = 0; i != numMipLevels; i++) {
+    const VkExtent3D levelExtent = {std::max(1u, extent.width >> i),
+                                    std::max(1u, extent.height >> i),
+                                    std::max(1u, extent.depth >> i)};
+    const uint32_t level = baseMipLevel + i;
+    // 0 - the rows and the image slices are tightly packed
+    regions.push_back({VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT,
+                       nullptr,
+                       ptr,
+                       0,
+                       0,
+                       VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, level, layer, 1},
+                       VkOffset3D{offset.x >> i, offset.y >> i, offset.z >> i},
+                       levelExtent});
+    ptr += properties.getBytesPerRange(TextureRangeDesc::new3D(
+        0, 0, 0, levelExtent.width, levelExtent.height, levelExtent.depth));
+  }
+  const VkCopyMemoryToImageInfoEXT copyInfo = {
+      VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT,
+      nullptr,
+      0,
+      vkImage_,
+      layout,
+      static_cast<uint32_t>(regions.size()),
+      regions.data(),
+  };
+  VK_ASSERT(vkCopyMemoryToImageEXT(device_, &copyInfo));
+
+  const size_t numBytes = ptr - static_cast<const uint8_t*>(data);
+  ctx_.getFrameStatisticsTracker().add(FrameStatisticsTracker::UploadedBytes, numBytes);
+
+  // the host writes are visible to every command buffer submitted from now on
+  imageLayout_ = layout;
+  for (uint32_t level = baseMipLevel; level != baseMipLevel + numMipLevels; level++) {
+    getSubresourceStates()[layer * mipLevels_ + level] = {layout, 0};
+  }
+  return true;
+#else
+  (void)offset;
+  (void)extent;
+  (void)baseMipLevel;
+  (void)numMipLevels;
+  (void)layer;
+  (void)properties;
+  (void)data;
+  return false;
+#endif // IGL_VULKAN_HOST_IMAGE_COPY_SUPPORTED
+}
 
 VkImageAspectFlags VulkanImage::getImageAspectFlags() const {
   VkImageAspectFlags flags = 0;
@@ -863,7 +1270,7 @@ void VulkanImage::generateMipmap(VkCommandBuffer commandBuffer) const {
                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, // dstStageMask
                         VkImageSubresourceRange{imageAspectFlags, 0, mipLevels_, 0, arrayLayers_});
 
-  imageLayout_ = originalImageLayout;
+  setLayout(originalImageLayout, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
 }
 
 bool VulkanImage::isDepthFormat(VkFormat format) {
@@ -10,9 +10,12 @@
 #include <memory>
 #include <vector>
 
+#include <igl/android/NativeHWBuffer.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanHelpers.h>
 
+struct AHardwareBuffer;
+
 namespace igl {
 namespace vulkan {
 
@@ -65,7 +68,8 @@ class VulkanImage final {
               VkMemoryPropertyFlags memFlags,
               VkImageCreateFlags createFlags,
               VkSampleCountFlagBits samples,
-              const char* debugName = nullptr);
+              const char* debugName = nullptr,
+              float memoryPriority = 0.5f);
 
   /**
    * @brief Constructs a `VulkanImage` object and a `VkImage` object from a file descriptor. The
@@ -149,6 +153,19 @@ class VulkanImage final {
                                                              const char* debugName = nullptr);
 #endif // IGL_PLATFORM_WIN || IGL_PLATFORM_LINUX || IGL_PLATFORM_ANDROID
 
+#if IGL_ANDROID_HWBUFFER_SUPPORTED && defined(VK_ANDROID_external_memory_android_hardware_buffer)
+  /**
+   * @brief Creates a 2D `VulkanImage` with one mip level, layer and sample which aliases the memory
+   * of `hwBuffer`. The image keeps a reference to the buffer in `nativeHWBuffer_` until it is
+   * destroyed. Buffers with external formats (which need YCbCr samplers) are not supported.
+   */
+  static std::shared_ptr<VulkanImage> createFromNativeHWBuffer(const VulkanContext& ctx,
+                                                               VkDevice device,
+                                                               AHardwareBuffer* hwBuffer,
+                                                               VkImageUsageFlags usageFlags,
+                                                               const char* debugName = nullptr);
+#endif // IGL_ANDROID_HWBUFFER_SUPPORTED
+
   ~VulkanImage();
 
   VulkanImage(const VulkanImage&) = delete;
@@ -174,7 +191,8 @@ class VulkanImage final {
    * @brief Creates a `VkImageView` object from the `VkImage` stored in the object.
    *
    * Setting `numLevels` to a non-zero value will override `mipLevels_` value from the original
-   * vulkan image, and can be used to create image views with different number of levels
+   * vulkan image, and can be used to create image views with different number of levels.
+   * `components` swizzles the components of sampled views, which is the identity by default
    */
   std::shared_ptr<VulkanImageView> createImageView(VkImageViewType type,
                                                    VkFormat format,
@@ -183,7 +201,8 @@ class VulkanImage final {
                                                    uint32_t numLevels = VK_REMAINING_MIP_LEVELS,
                                                    uint32_t baseLayer = 0,
                                                    uint32_t numLayers = 1,
-                                                   const char* debugName = nullptr) const;
+                                                   const char* debugName = nullptr,
+                                                   VkComponentMapping components = {}) const;
 
   void generateMipmap(VkCommandBuffer commandBuffer) const;
 
@@ -191,9 +210,12 @@ class VulkanImage final {
    * @brief Transitions the `VkImage`'s layout from the current layout (stored in the object) to the
    * `newImageLayout` by recording an Image Memory Barrier into the commandBuffer.
    *
-   * The source and destination access masks for the transition are automatically deduced based on
-   * the `srcStageMask` and the `dstStageMask` parameters. Not not all `VkPipelineStageFlags` are
-   * supported.
+   * The layout, and the stages accessing it since the last transition, are tracked for every mip
+   * level of every layer. The barriers wait for the tracked stages with their write accesses;
+   * `srcStageMask` is only used for subresources whose accesses are unknown. Transitions into the
+   * same read-only layout for stages which already see the image are dropped. The destination
+   * access masks are deduced from `dstStageMask`, which has to cover all the accesses until the
+   * next transition. Not all `VkPipelineStageFlags` are supported.
    */
   void transitionLayout(VkCommandBuffer commandBuffer,
                         VkImageLayout newImageLayout,
@@ -201,6 +223,61 @@ class VulkanImage final {
                         VkPipelineStageFlags dstStageMask,
                         const VkImageSubresourceRange& subresourceRange) const;
 
+  /**
+   * @brief Same as transitionLayout(), but appends the Image Memory Barriers to `outBarriers`
+   * instead of recording them, so several images can be transitioned with one
+   * vkCmdPipelineBarrier(). `srcStageMask` is replaced by the stages the barriers wait for; it is 0
+   * if no barrier is needed.
+   */
+  void getTransitionBarriers(VkImageLayout newImageLayout,
+                             VkPipelineStageFlags& srcStageMask,
+                             VkPipelineStageFlags dstStageMask,
+                             const VkImageSubresourceRange& subresourceRange,
+                             std::vector<VkImageMemoryBarrier>& outBarriers) const;
+
+#if IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+  /**
+   * @brief Appends VK_KHR_synchronization2 barriers which move the subresources in `range` to
+   * `newImageLayout` for the accesses `dstAccessMask` in `dstStageMask`, and records the new
+   * layout. Every barrier waits only for the tracked stages of its subresource. The contents are
+   * discarded (the transitions start from VK_IMAGE_LAYOUT_UNDEFINED) if `discardContents` is true.
+   */
+  void getTransitionBarriers2(VkImageLayout newImageLayout,
+                              VkPipelineStageFlags dstStageMask,
+                              VkAccessFlags dstAccessMask,
+                              const VkImageSubresourceRange& subresourceRange,
+                              bool discardContents,
+                              std::vector<VkImageMemoryBarrier2KHR>& outBarriers) const;
+#endif // IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+
+  /**
+   * @brief Records that all subresources were moved to `layout` outside of transitionLayout(),
+   * e.g. by a render pass or a raw barrier, and are accessed by `stages` (0 if unknown).
+   */
+  void setLayout(VkImageLayout layout, VkPipelineStageFlags stages) const;
+
+  /**
+   * @brief Returns the tracked layout of one subresource.
+   */
+  [[nodiscard]] VkImageLayout getLayout(uint32_t level, uint32_t layer) const;
+
+  /**
+   * @brief Writes the mip levels `baseMipLevel`..`baseMipLevel + numMipLevels - 1` of one layer
+   * (or of a 3D image) on the CPU with vkCopyMemoryToImageEXT(), without staging memory or command
+   * buffers. `data` holds the tightly packed levels one after another, like for
+   * VulkanStagingDevice::imageData2D(). Only images created with
+   * VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT are copied, and only if the GPU has not used those
+   * subresources yet (their layout is VK_IMAGE_LAYOUT_UNDEFINED), because host copies do not wait
+   * for the GPU. Returns false if the data has to be uploaded through the staging device instead.
+   */
+  bool hostImageData(const VkOffset3D& offset,
+                     const VkExtent3D& extent,
+                     uint32_t baseMipLevel,
+                     uint32_t numMipLevels,
+                     uint32_t layer,
+                     TextureFormatProperties properties,
+                     const void* data) const;
+
   VkImageAspectFlags getImageAspectFlags() const;
 
   static bool isDepthFormat(VkFormat format);
@@ -212,6 +289,7 @@ class VulkanImage final {
   VkDevice device_ = VK_NULL_HANDLE;
   VkImage vkImage_ = VK_NULL_HANDLE;
   VkImageUsageFlags usageFlags_ = 0;
+  VkImageCreateFlags createFlags_ = 0;
   VkDeviceMemory vkMemory_ = VK_NULL_HANDLE;
   VmaAllocationCreateInfo vmaAllocInfo_ = {};
   VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
@@ -228,13 +306,24 @@ class VulkanImage final {
   bool isStencilFormat_ = false;
   bool isDepthOrStencilFormat_ = false;
   VkDeviceSize allocatedSize = 0;
-  mutable VkImageLayout imageLayout_ = VK_IMAGE_LAYOUT_UNDEFINED; // current image layout
+  // the layout of the last transition; use setLayout() to change it
+  mutable VkImageLayout imageLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
   bool isImported_ = false;
   bool isExported_ = false;
   void* exportedMemoryHandle_ = nullptr; // windows handle
   int exportedFd_ = -1; // linux fd
+  AHardwareBuffer* nativeHWBuffer_ = nullptr; // imported Android buffer
 
  private:
+  struct SubresourceState {
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    // the stages which accessed the subresource since its last transition; 0 if unknown
+    VkPipelineStageFlags stages = 0;
+  };
+  // one per mip level of each layer: [layer * mipLevels_ + level]
+  std::vector<SubresourceState>& getSubresourceStates() const;
+  mutable std::vector<SubresourceState> subresourceStates_;
+
 #if IGL_PLATFORM_WIN || IGL_PLATFORM_LINUX || IGL_PLATFORM_ANDROID
   /**
    * @brief Constructs a `VulkanImage` object and a `VkImage` object. Except for the debug name, all
@@ -268,6 +357,22 @@ class VulkanImage final {
               VkExternalMemoryHandleTypeFlags compatibleHandleTypes,
               const char* debugName);
 #endif // IGL_PLATFORM_WIN || IGL_PLATFORM_LINUX || IGL_PLATFORM_ANDROID
+
+#if IGL_ANDROID_HWBUFFER_SUPPORTED && defined(VK_ANDROID_external_memory_android_hardware_buffer)
+  /**
+   * @brief Imports `hwBuffer` into a dedicated allocation. `allocationSize` and `memoryTypeBits`
+   * come from `vkGetAndroidHardwareBufferPropertiesANDROID()`.
+   */
+  VulkanImage(const VulkanContext& ctx,
+              VkDevice device,
+              AHardwareBuffer* hwBuffer,
+              VkExtent3D extent,
+              VkFormat format,
+              VkImageUsageFlags usageFlags,
+              VkDeviceSize allocationSize,
+              uint32_t memoryTypeBits,
+              const char* debugName);
+#endif // IGL_ANDROID_HWBUFFER_SUPPORTED
 };
 
 } // namespace vulkan
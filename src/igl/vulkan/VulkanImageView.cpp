@@ -24,7 +24,9 @@ VulkanImageView::VulkanImageView(const VulkanContext& ctx,
                                  uint32_t numLevels,
                                  uint32_t baseLayer,
                                  uint32_t numLayers,
-                                 const char* debugName) :
+                                 const char* debugName,
+                                 VkSamplerYcbcrConversion ycbcrConversion,
+                                 VkComponentMapping components) :
   ctx_(ctx), device_(device) {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
 
@@ -34,6 +36,8 @@ VulkanImageView::VulkanImageView(const VulkanContext& ctx,
       type,
       format,
       VkImageSubresourceRange{aspectMask, baseLevel, numLevels, baseLayer, numLayers},
+      ycbcrConversion,
+      components,
       &vkImageView_));
 
   VK_ASSERT(
@@ -26,7 +26,8 @@ class VulkanImageView final {
   /**
    * @brief Creates the VulkanImageView object which stores a handle to a VkImageView.
    * The imageView is created from the device, image, and other parameters with a name that can be
-   * used for debugging.
+   * used for debugging. Views of multi-planar YUV images which are sampled need the
+   * `ycbcrConversion` of their immutable sampler.
    */
   VulkanImageView(const VulkanContext& ctx,
                   VkDevice device,
@@ -38,7 +39,9 @@ class VulkanImageView final {
                   uint32_t numLevels,
                   uint32_t baseLayer,
                   uint32_t numLayers,
-                  const char* debugName = nullptr);
+                  const char* debugName = nullptr,
+                  VkSamplerYcbcrConversion ycbcrConversion = VK_NULL_HANDLE,
+                  VkComponentMapping components = {});
   ~VulkanImageView();
 
   VulkanImageView(const VulkanImageView&) = delete;
@@ -7,7 +7,9 @@
 
 #include "VulkanImmediateCommands.h"
 
+#include <algorithm>
 #include <igl/vulkan/Common.h>
+#include <thread>
 #include <utility>
 
 namespace igl {
@@ -15,29 +17,44 @@ namespace vulkan {
 
 VulkanImmediateCommands::VulkanImmediateCommands(VkDevice device,
                                                  uint32_t queueFamilyIndex,
-                                                 const char* debugName) :
-  device_(device),
-  commandPool_(device_,
-               VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT |
-                   VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
-               queueFamilyIndex,
-               debugName),
-  debugName_(debugName) {
+                                                 const char* debugName,
+                                                 uint32_t queueIndex,
+                                                 bool useTimelineSemaphore) :
+  device_(device), queueFamilyIndex_(queueFamilyIndex), debugName_(debugName) {
   IGL_PROFILER_FUNCTION();
 
-  vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue_);
+  vkGetDeviceQueue(device, queueFamilyIndex, queueIndex, &queue_);
 
+  if (useTimelineSemaphore) {
+    timelineSemaphore_ = std::make_unique<VulkanSemaphore>(
+        device_, 0, IGL_FORMAT("Timeline Semaphore: {}", debugName).c_str());
+  }
+
+  // the command buffers are created by acquire() when all the existing ones are in use; reserving
+  // keeps the references returned by acquire() valid
   buffers_.reserve(kMaxCommandBuffers);
+  commandPools_.reserve(kMaxCommandBuffers);
+  pendingSubmits_.reserve(kMaxCommandBuffers);
+}
 
-  for (uint32_t i = 0; i != kMaxCommandBuffers; i++) {
-    buffers_.emplace_back(
-        VulkanFence(
-            device_, VkFenceCreateFlagBits{}, IGL_FORMAT("Fence: commandBuffer #{}", i).c_str()),
-        VulkanSemaphore(device, IGL_FORMAT("Semaphore: {} ({})", debugName, i).c_str()));
-    VK_ASSERT(ivkAllocateCommandBuffer(
-        device_, commandPool_.getVkCommandPool(), &buffers_[i].cmdBufAllocated_));
-    buffers_[i].handle_.bufferIndex_ = i;
-  }
+VulkanImmediateCommands::CommandBufferWrapper* VulkanImmediateCommands::createCommandBuffer() {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+  IGL_ASSERT(buffers_.size() < kMaxCommandBuffers);
+
+  const uint32_t i = static_cast<uint32_t>(buffers_.size());
+  commandPools_.emplace_back(std::make_unique<VulkanCommandPool>(
+      device_,
+      VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+      queueFamilyIndex_,
+      IGL_FORMAT("Command Pool: {} ({})", debugName_, i).c_str()));
+  buffers_.emplace_back(
+      VulkanFence(
+          device_, VkFenceCreateFlagBits{}, IGL_FORMAT("Fence: commandBuffer #{}", i).c_str()),
+      VulkanSemaphore(device_, IGL_FORMAT("Semaphore: {} ({})", debugName_, i).c_str()));
+  VK_ASSERT(ivkAllocateCommandBuffer(
+      device_, commandPools_[i]->getVkCommandPool(), &buffers_[i].cmdBufAllocated_));
+  buffers_[i].handle_.bufferIndex_ = i;
+  return &buffers_[i];
 }
 
 VulkanImmediateCommands::~VulkanImmediateCommands() {
@@ -47,36 +64,114 @@ VulkanImmediateCommands::~VulkanImmediateCommands() {
 void VulkanImmediateCommands::purge() {
   IGL_PROFILER_FUNCTION();
 
+  // one query covers all command buffers in the timeline semaphore mode
+  const uint64_t completedTimelineValue = timelineSemaphore_ ? queryCompletedTimelineValue() : 0;
+
   for (auto& buf : buffers_) {
     if (buf.cmdBuf_ == VK_NULL_HANDLE || buf.isEncoding_) {
       continue;
     }
 
-    const VkResult result = vkWaitForFences(device_, 1, &buf.fence_.vkFence_, VK_TRUE, 0);
-
-    if (result == VK_SUCCESS) {
-      VK_ASSERT(vkResetCommandBuffer(buf.cmdBuf_, VkCommandBufferResetFlags{0}));
-      VK_ASSERT(vkResetFences(device_, 1, &buf.fence_.vkFence_));
-      buf.cmdBuf_ = VK_NULL_HANDLE;
-      numAvailableCommandBuffers_++;
+    if (timelineSemaphore_) {
+      if (buf.timelineValue_ > completedTimelineValue) {
+        continue;
+      }
     } else {
-      if (result != VK_TIMEOUT) {
-        VK_ASSERT(result);
+      const VkResult result = vkWaitForFences(device_, 1, &buf.fence_.vkFence_, VK_TRUE, 0);
+
+      if (result != VK_SUCCESS) {
+        if (result != VK_TIMEOUT) {
+          VK_ASSERT(result);
+        }
+        continue;
       }
+
+      // the fence stays signaled until the buffer is reused, so that waits which are in progress
+      // on other threads see it
     }
+
+    // nobody can record into this pool now: its only command buffer is not in use
+    VK_ASSERT(vkResetCommandPool(
+        device_, commandPools_[buf.handle_.bufferIndex_]->getVkCommandPool(), 0));
+    buf.cmdBuf_ = VK_NULL_HANDLE;
+    numAvailableCommandBuffers_++;
+  }
+}
+
+uint64_t VulkanImmediateCommands::queryCompletedTimelineValue() const {
+  IGL_ASSERT(timelineSemaphore_);
+
+  uint64_t value = 0;
+  VK_ASSERT(vkGetSemaphoreCounterValueKHR(device_, timelineSemaphore_->vkSemaphore_, &value));
+  completedTimelineValue_ = value;
+
+  return value;
+}
+
+void VulkanImmediateCommands::waitTimelineValue(std::unique_lock<std::mutex>& lock,
+                                                uint64_t value) {
+  IGL_ASSERT(timelineSemaphore_);
+
+  VkSemaphoreWaitInfoKHR waitInfo = {};
+  waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores = &timelineSemaphore_->vkSemaphore_;
+  waitInfo.pValues = &value;
+
+  // let other threads acquire and submit command buffers while we are waiting
+  lock.unlock();
+  VK_ASSERT(vkWaitSemaphoresKHR(device_, &waitInfo, UINT64_MAX));
+  lock.lock();
+
+  completedTimelineValue_ = std::max(completedTimelineValue_, value);
+}
+
+void VulkanImmediateCommands::waitFence(std::unique_lock<std::mutex>& lock, SubmitHandle handle) {
+  IGL_ASSERT(!timelineSemaphore_);
+
+  // the fence is reset when its command buffer is reused, which can happen while the lock is
+  // released: the timeout makes sure the handle is checked again
+  constexpr uint64_t kTimeoutNs = 10'000'000;
+
+  while (!isReadyLocked(handle, false)) {
+    const VkFence fence = buffers_[handle.bufferIndex_].fence_.vkFence_;
+    lock.unlock();
+    const VkResult result = vkWaitForFences(device_, 1, &fence, VK_TRUE, kTimeoutNs);
+    lock.lock();
+    if (result != VK_TIMEOUT) {
+      VK_ASSERT(result);
+    }
+  }
+}
+
+void VulkanImmediateCommands::countGpuWait() const {
+  if (statistics_) {
+    statistics_->add(FrameStatisticsTracker::GpuWaits);
   }
 }
 
 const VulkanImmediateCommands::CommandBufferWrapper& VulkanImmediateCommands::acquire() {
   IGL_PROFILER_FUNCTION();
 
+  std::unique_lock<std::mutex> lock(mutex_);
+
   if (!numAvailableCommandBuffers_) {
+    // batched command buffers can only be recycled once they are submitted
+    flushLocked();
     purge();
   }
 
+  if (!numAvailableCommandBuffers_) {
+    countGpuWait();
+  }
+
   while (!numAvailableCommandBuffers_) {
     IGL_LOG_INFO("Waiting for command buffers...\n");
     IGL_PROFILER_ZONE("Waiting for command buffers...", IGL_PROFILER_COLOR_WAIT);
+    // let other threads submit their command buffers while we are waiting
+    lock.unlock();
+    std::this_thread::yield();
+    lock.lock();
     purge();
     IGL_PROFILER_ZONE_END();
   }
@@ -90,6 +185,10 @@ const VulkanImmediateCommands::CommandBufferWrapper& VulkanImmediateCommands::ac
       break;
     }
   }
+  if (!current) {
+    // all the existing buffers are in use and fewer than kMaxCommandBuffers exist
+    current = createCommandBuffer();
+  }
 
   // make clang happy
   assert(current);
@@ -98,18 +197,38 @@ const VulkanImmediateCommands::CommandBufferWrapper& VulkanImmediateCommands::ac
   IGL_ASSERT_MSG(current, "No available command buffers");
   IGL_ASSERT(current->cmdBufAllocated_ != VK_NULL_HANDLE);
 
-  current->handle_.submitId_ = submitCounter_;
+  // command buffers can be acquired by different threads before any of them is submitted
+  current->handle_.submitId_ = submitCounter_++;
+
+  if (!submitCounter_) {
+    // skip the 0 value - when uint32_t wraps around (null SubmitHandle)
+    submitCounter_++;
+  }
+
   numAvailableCommandBuffers_--;
 
+  if (!timelineSemaphore_) {
+    // signaled by the previous submit of this buffer
+    VK_ASSERT(vkResetFences(device_, 1, &current->fence_.vkFence_));
+  }
+
   current->cmdBuf_ = current->cmdBufAllocated_;
   current->isEncoding_ = true;
+
+  lock.unlock();
+
+  // the command pool of this buffer is owned by the calling thread from now on
   VK_ASSERT(ivkBeginCommandBuffer(current->cmdBuf_));
 
   return *current;
 }
 
 void VulkanImmediateCommands::wait(const SubmitHandle handle) {
-  if (isReady(handle)) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  flushLocked();
+
+  if (isReadyLocked(handle, false)) {
     return;
   }
 
@@ -119,8 +238,13 @@ void VulkanImmediateCommands::wait(const SubmitHandle handle) {
     return;
   }
 
-  VK_ASSERT(vkWaitForFences(
-      device_, 1, &buffers_[handle.bufferIndex_].fence_.vkFence_, VK_TRUE, UINT64_MAX));
+  countGpuWait();
+
+  if (timelineSemaphore_) {
+    waitTimelineValue(lock, buffers_[handle.bufferIndex_].timelineValue_);
+  } else {
+    waitFence(lock, handle);
+  }
 
   purge();
 }
@@ -128,25 +252,56 @@ void VulkanImmediateCommands::wait(const SubmitHandle handle) {
 void VulkanImmediateCommands::waitAll() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
 
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  flushLocked();
+
+  if (timelineSemaphore_) {
+    // submits signal increasing values, so the last one covers all of them
+    if (lastTimelineValue_ > completedTimelineValue_) {
+      countGpuWait();
+      waitTimelineValue(lock, lastTimelineValue_);
+    }
+    purge();
+    return;
+  }
+
   // @lint-ignore CLANGTIDY
-  VkFence fences[kMaxCommandBuffers];
+  SubmitHandle handles[kMaxCommandBuffers];
 
-  uint32_t numFences = 0;
+  uint32_t numHandles = 0;
 
   for (const auto& buf : buffers_) {
     if (buf.cmdBuf_ != VK_NULL_HANDLE && !buf.isEncoding_) {
-      fences[numFences++] = buf.fence_.vkFence_;
+      handles[numHandles++] = buf.handle_;
     }
   }
 
-  if (numFences) {
-    VK_ASSERT(vkWaitForFences(device_, numFences, fences, VK_TRUE, UINT64_MAX));
+  if (numHandles) {
+    countGpuWait();
+  }
+
+  // command buffers submitted by other threads while we are waiting are not waited for
+  for (uint32_t i = 0; i != numHandles; i++) {
+    waitFence(lock, handles[i]);
   }
 
   purge();
 }
 
 bool VulkanImmediateCommands::isReady(const SubmitHandle handle, bool fastCheckNoVulkan) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!fastCheckNoVulkan) {
+    // somebody is polling for the GPU: nothing batched can complete before it is submitted
+    flushLocked();
+  }
+
+  return isReadyLocked(handle, fastCheckNoVulkan);
+}
+
+bool VulkanImmediateCommands::isReadyLocked(const SubmitHandle handle,
+                                            bool fastCheckNoVulkan) const {
   IGL_ASSERT(handle.bufferIndex_ < kMaxCommandBuffers);
 
   if (handle.empty()) {
@@ -166,6 +321,16 @@ bool VulkanImmediateCommands::isReady(const SubmitHandle handle, bool fastCheckN
     return true;
   }
 
+  if (timelineSemaphore_) {
+    if (buf.isEncoding_) {
+      return false;
+    }
+    // the fast check uses the last known counter value instead
+    const uint64_t completedTimelineValue =
+        fastCheckNoVulkan ? completedTimelineValue_ : queryCompletedTimelineValue();
+    return buf.timelineValue_ <= completedTimelineValue;
+  }
+
   if (fastCheckNoVulkan) {
     // do not ask the Vulkan API about it, just let it retire naturally (when submitId for this
     // bufferIndex gets incremented)
@@ -176,72 +341,173 @@ bool VulkanImmediateCommands::isReady(const SubmitHandle handle, bool fastCheckN
 }
 
 VulkanImmediateCommands::SubmitHandle VulkanImmediateCommands::submit(
-    const CommandBufferWrapper& wrapper) {
+    const CommandBufferWrapper& wrapper,
+    VkSemaphore signalSemaphore) {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_SUBMIT);
   IGL_ASSERT(wrapper.isEncoding_);
   VK_ASSERT(ivkEndCommandBuffer(wrapper.cmdBuf_));
 
-  // @lint-ignore CLANGTIDY
-  const VkPipelineStageFlags waitStageMasks[] = {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
-  // @lint-ignore CLANGTIDY
-  VkSemaphore waitSemaphores[] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
-  uint32_t numWaitSemaphores = 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  PendingSubmit pending;
+  pending.wrapper = &wrapper;
   if (waitSemaphore_) {
-    waitSemaphores[numWaitSemaphores++] = waitSemaphore_;
+    pending.waitSemaphores[pending.numWaitSemaphores++] = waitSemaphore_;
   }
   if (lastSubmitSemaphore_) {
-    waitSemaphores[numWaitSemaphores++] = lastSubmitSemaphore_;
+    pending.waitSemaphores[pending.numWaitSemaphores++] = lastSubmitSemaphore_;
   }
-
-  const VkSubmitInfo si = ivkGetSubmitInfo(&wrapper.cmdBuf_,
-                                           numWaitSemaphores,
-                                           waitSemaphores,
-                                           waitStageMasks,
-                                           &wrapper.semaphore_.vkSemaphore_);
-  // @lint-ignore CLANGTIDY
-  const VkFence vkFence = wrapper.fence_.vkFence_;
-  IGL_PROFILER_ZONE("vkQueueSubmit()", IGL_PROFILER_COLOR_SUBMIT);
-#if IGL_VULKAN_PRINT_COMMANDS
-  IGL_LOG_INFO("%p vkQueueSubmit()\n\n", wrapper.cmdBuf_);
-#endif // IGL_VULKAN_PRINT_COMMANDS
-  VK_ASSERT(vkQueueSubmit(queue_, 1u, &si, vkFence));
-  IGL_PROFILER_ZONE_END();
+  pending.signalSemaphore = signalSemaphore;
 
   lastSubmitSemaphore_ = wrapper.semaphore_.vkSemaphore_;
   lastSubmitHandle_ = wrapper.handle_;
   waitSemaphore_ = VK_NULL_HANDLE;
 
+  if (timelineSemaphore_) {
+    lastTimelineValue_++;
+    const_cast<CommandBufferWrapper&>(wrapper).timelineValue_ = lastTimelineValue_;
+  }
+
   // reset
   const_cast<CommandBufferWrapper&>(wrapper).isEncoding_ = false;
-  submitCounter_++;
 
-  if (!submitCounter_) {
-    // skip the 0 value - when uint32_t wraps around (null SubmitHandle)
-    submitCounter_++;
+  pendingSubmits_.push_back(pending);
+  // a semaphore requested by the caller is usually exported or waited on outside of this queue
+  if (!batchSubmits_ || signalSemaphore != VK_NULL_HANDLE) {
+    flushLocked();
   }
 
   return lastSubmitHandle_;
 }
 
+void VulkanImmediateCommands::flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  flushLocked();
+}
+
+void VulkanImmediateCommands::flushLocked() const {
+  if (pendingSubmits_.empty()) {
+    return;
+  }
+
+  // fences are per command buffer, so they allow one command buffer per vkQueueSubmit()
+  IGL_ASSERT(timelineSemaphore_ || pendingSubmits_.size() == 1);
+
+  // @lint-ignore CLANGTIDY
+  const VkPipelineStageFlags waitStageMasks[] = {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+  // @lint-ignore CLANGTIDY
+  VkSubmitInfo submitInfos[kMaxCommandBuffers];
+  // @lint-ignore CLANGTIDY
+  VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfos[kMaxCommandBuffers];
+  // @lint-ignore CLANGTIDY
+  VkSemaphore signalSemaphores[kMaxCommandBuffers][3];
+  // @lint-ignore CLANGTIDY
+  uint64_t signalValues[kMaxCommandBuffers][3];
+
+  const uint32_t numSubmits = static_cast<uint32_t>(pendingSubmits_.size());
+  IGL_ASSERT(numSubmits <= kMaxCommandBuffers);
+
+  for (uint32_t i = 0; i != numSubmits; i++) {
+    const PendingSubmit& pending = pendingSubmits_[i];
+    const CommandBufferWrapper& wrapper = *pending.wrapper;
+
+    VkSubmitInfo& si = submitInfos[i];
+    si = ivkGetSubmitInfo(&wrapper.cmdBuf_,
+                          pending.numWaitSemaphores,
+                          pending.waitSemaphores,
+                          waitStageMasks,
+                          &wrapper.semaphore_.vkSemaphore_);
+
+    // signal the binary semaphore (used to chain submits and for presentation), the value of the
+    // timeline semaphore reserved by submit() and the semaphore requested by the caller
+    signalSemaphores[i][0] = wrapper.semaphore_.vkSemaphore_;
+    signalValues[i][0] = 0; // ignored for binary semaphores
+    uint32_t numSignalSemaphores = 1;
+    if (timelineSemaphore_) {
+      signalValues[i][numSignalSemaphores] = wrapper.timelineValue_;
+      signalSemaphores[i][numSignalSemaphores++] = timelineSemaphore_->vkSemaphore_;
+    }
+    if (pending.signalSemaphore != VK_NULL_HANDLE) {
+      signalValues[i][numSignalSemaphores] = 0;
+      signalSemaphores[i][numSignalSemaphores++] = pending.signalSemaphore;
+    }
+    si.signalSemaphoreCount = numSignalSemaphores;
+    si.pSignalSemaphores = signalSemaphores[i];
+    if (timelineSemaphore_) {
+      VkTimelineSemaphoreSubmitInfoKHR& timelineSubmitInfo = timelineSubmitInfos[i];
+      timelineSubmitInfo = {};
+      timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+      timelineSubmitInfo.signalSemaphoreValueCount = numSignalSemaphores;
+      timelineSubmitInfo.pSignalSemaphoreValues = signalValues[i];
+      si.pNext = &timelineSubmitInfo;
+    }
+#if IGL_VULKAN_PRINT_COMMANDS
+    IGL_LOG_INFO("%p vkQueueSubmit()\n\n", wrapper.cmdBuf_);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+  }
+
+  // @lint-ignore CLANGTIDY
+  const VkFence vkFence =
+      timelineSemaphore_ ? VK_NULL_HANDLE : pendingSubmits_.back().wrapper->fence_.vkFence_;
+
+  IGL_PROFILER_ZONE("vkQueueSubmit()", IGL_PROFILER_COLOR_SUBMIT);
+  VK_ASSERT(vkQueueSubmit(queue_, numSubmits, submitInfos, vkFence));
+  IGL_PROFILER_ZONE_END();
+
+  pendingSubmits_.clear();
+
+  if (timelineSemaphore_) {
+    // refresh the counter once per submit, so fast isReady() checks can retire finished submits
+    queryCompletedTimelineValue();
+  }
+}
+
+void VulkanImmediateCommands::setSubmitBatching(bool enabled) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  IGL_ASSERT_MSG(!enabled || timelineSemaphore_, "Batched submits require timeline semaphores");
+  batchSubmits_ = enabled && timelineSemaphore_;
+  if (!batchSubmits_) {
+    flushLocked();
+  }
+}
+
 void VulkanImmediateCommands::waitSemaphore(VkSemaphore semaphore) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
   IGL_ASSERT(waitSemaphore_ == VK_NULL_HANDLE);
 
   waitSemaphore_ = semaphore;
 }
 
 VkSemaphore VulkanImmediateCommands::acquireLastSubmitSemaphore() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // the semaphore is waited on outside of this queue, e.g. by vkQueuePresentKHR()
+  flushLocked();
+
   return std::exchange(lastSubmitSemaphore_, VK_NULL_HANDLE);
 }
 
 VulkanImmediateCommands::SubmitHandle VulkanImmediateCommands::getLastSubmitHandle() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
   return lastSubmitHandle_;
 }
 
 VkFence VulkanImmediateCommands::getVkFenceFromSubmitHandle(SubmitHandle handle) {
   IGL_ASSERT(handle.bufferIndex_ < buffers_.size());
 
-  if (isReady(handle, true)) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (timelineSemaphore_) {
+    IGL_ASSERT_MSG(false, "Fences are not used in the timeline semaphore mode");
+    return VK_NULL_HANDLE;
+  }
+
+  if (isReadyLocked(handle, true)) {
     return VK_NULL_HANDLE;
   }
 
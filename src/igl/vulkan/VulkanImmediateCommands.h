@@ -7,8 +7,11 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <vector>
 
+#include <igl/FrameStatistics.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanCommandPool.h>
 #include <igl/vulkan/VulkanFence.h>
@@ -18,13 +21,36 @@
 namespace igl {
 namespace vulkan {
 
+/**
+ * @brief Manages a ring of command buffers submitted to one queue.
+ *
+ * All methods are thread-safe. Every command buffer is allocated from its own command pool, so
+ * command buffers can be recorded from different threads simultaneously; a command buffer itself
+ * has to be recorded by one thread at a time. Command buffers are executed in the order of
+ * submit() calls. wait() and waitAll() do not block other threads while the GPU is busy.
+ *
+ * Completion is tracked with one VkFence per command buffer or, if `useTimelineSemaphore` is set
+ * (VK_KHR_timeline_semaphore, core in Vulkan 1.2), with a single timeline semaphore: every submit
+ * signals the next value of a 64-bit counter, so checking or waiting for any past submit is one
+ * counter comparison or one vkWaitSemaphores() call.
+ *
+ * In the timeline semaphore mode, submits can also be batched (setSubmitBatching()): submit()
+ * only queues the command buffer and returns its handle, and the queued command buffers are
+ * submitted together by one vkQueueSubmit() on flush(). Anything observing the queue (waits,
+ * non-fast isReady() checks, the last submit semaphore, external signal semaphores) flushes first,
+ * so submit handles keep their meaning.
+ */
 class VulkanImmediateCommands final {
  public:
   // the maximum number of command buffers which can similtaneously exist in the system; when we run
   // out of buffers, we stall and wait until an existing buffer becomes available
   static constexpr uint32_t kMaxCommandBuffers = 16;
 
-  VulkanImmediateCommands(VkDevice device, uint32_t queueFamilyIndex, const char* debugName);
+  VulkanImmediateCommands(VkDevice device,
+                          uint32_t queueFamilyIndex,
+                          const char* debugName,
+                          uint32_t queueIndex = 0,
+                          bool useTimelineSemaphore = false);
   ~VulkanImmediateCommands();
   VulkanImmediateCommands(const VulkanImmediateCommands&) = delete;
   VulkanImmediateCommands& operator=(const VulkanImmediateCommands&) = delete;
@@ -53,36 +79,79 @@ class VulkanImmediateCommands final {
     VkCommandBuffer cmdBuf_ = VK_NULL_HANDLE;
     VkCommandBuffer cmdBufAllocated_ = VK_NULL_HANDLE;
     SubmitHandle handle_ = {};
-    VulkanFence fence_;
+    VulkanFence fence_; // not used in the timeline semaphore mode
     VulkanSemaphore semaphore_;
+    // the timeline value signaled by the last submit of this command buffer
+    uint64_t timelineValue_ = 0;
     bool isEncoding_ = false;
   };
 
-  // returns the current command buffer (creates one if it does not exist)
+  // returns a new command buffer ready for recording on the calling thread
   const CommandBufferWrapper& acquire();
-  SubmitHandle submit(const CommandBufferWrapper& wrapper);
+  // `signalSemaphore` is an optional binary semaphore signaled together with the command buffer
+  SubmitHandle submit(const CommandBufferWrapper& wrapper,
+                      VkSemaphore signalSemaphore = VK_NULL_HANDLE);
+  // submits the command buffers queued by batched submit() calls
+  void flush();
+  // requires the timeline semaphore mode; disabling it flushes
+  void setSubmitBatching(bool enabled);
   void waitSemaphore(VkSemaphore semaphore);
   VkSemaphore acquireLastSubmitSemaphore();
   SubmitHandle getLastSubmitHandle() const;
   bool isReady(SubmitHandle handle, bool fastCheckNoVulkan = false) const;
   void wait(SubmitHandle handle);
   void waitAll();
+  // not available in the timeline semaphore mode
   VkFence getVkFenceFromSubmitHandle(SubmitHandle handle);
+  bool usesTimelineSemaphore() const {
+    return timelineSemaphore_ != nullptr;
+  }
+  // blocking waits for this queue are counted as FrameStatistics::gpuWaits
+  void setFrameStatisticsTracker(FrameStatisticsTracker* statistics) {
+    statistics_ = statistics;
+  }
 
  private:
+  // these have to be called with `mutex_` locked
   void purge();
+  void flushLocked() const;
+  bool isReadyLocked(SubmitHandle handle, bool fastCheckNoVulkan) const;
+  uint64_t queryCompletedTimelineValue() const;
+  // these release `lock` while waiting for the GPU
+  void waitTimelineValue(std::unique_lock<std::mutex>& lock, uint64_t value);
+  void waitFence(std::unique_lock<std::mutex>& lock, SubmitHandle handle);
+  void countGpuWait() const;
+  CommandBufferWrapper* createCommandBuffer();
 
  private:
   VkDevice device_ = VK_NULL_HANDLE;
   VkQueue queue_ = VK_NULL_HANDLE;
-  VulkanCommandPool commandPool_;
+  uint32_t queueFamilyIndex_ = 0;
+  // one pool per command buffer: a pool can be used only by one thread at a time
+  std::vector<std::unique_ptr<VulkanCommandPool>> commandPools_;
   std::string debugName_;
+  mutable std::mutex mutex_;
   std::vector<CommandBufferWrapper> buffers_;
   SubmitHandle lastSubmitHandle_ = SubmitHandle();
   VkSemaphore lastSubmitSemaphore_ = VK_NULL_HANDLE;
   VkSemaphore waitSemaphore_ = VK_NULL_HANDLE;
   uint32_t numAvailableCommandBuffers_ = kMaxCommandBuffers;
   uint32_t submitCounter_ = 1;
+  std::unique_ptr<VulkanSemaphore> timelineSemaphore_;
+  uint64_t lastTimelineValue_ = 0;
+  // the last value of `timelineSemaphore_` known to be reached; used by fast isReady() checks
+  mutable uint64_t completedTimelineValue_ = 0;
+  FrameStatisticsTracker* statistics_ = nullptr;
+
+  struct PendingSubmit {
+    const CommandBufferWrapper* wrapper = nullptr;
+    VkSemaphore waitSemaphores[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+    uint32_t numWaitSemaphores = 0;
+    VkSemaphore signalSemaphore = VK_NULL_HANDLE;
+  };
+  bool batchSubmits_ = false;
+  // ended command buffers waiting for vkQueueSubmit(), in submit order
+  mutable std::vector<PendingSubmit> pendingSubmits_;
 };
 
 } // namespace vulkan
@@ -0,0 +1,463 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanMipmapGenerator.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+#include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanDescriptorSetLayout.h>
+#include <igl/vulkan/VulkanDevice.h>
+#include <igl/vulkan/VulkanImage.h>
+#include <igl/vulkan/VulkanImageView.h>
+#include <igl/vulkan/VulkanPipelineBuilder.h>
+#include <igl/vulkan/VulkanPipelineLayout.h>
+#include <igl/vulkan/VulkanShaderModule.h>
+
+namespace {
+
+constexpr uint32_t kTileSize = 64;
+
+struct PushConstants {
+  uint32_t width;
+  uint32_t height;
+  uint32_t numMipLevels;
+  uint32_t numWorkGroups;
+};
+
+struct StorageFormat {
+  VkFormat format;
+  const char* qualifier;
+  char prefix; // ' ' for float, 'u' for unsigned and 'i' for signed integer images
+};
+
+// formats which have a GLSL storage format qualifier
+constexpr StorageFormat kStorageFormats[] = {
+    {VK_FORMAT_R8_UNORM, "r8", ' '},
+    {VK_FORMAT_R8G8_UNORM, "rg8", ' '},
+    {VK_FORMAT_R8G8B8A8_UNORM, "rgba8", ' '},
+    {VK_FORMAT_R8G8B8A8_SNORM, "rgba8_snorm", ' '},
+    {VK_FORMAT_R16_UNORM, "r16", ' '},
+    {VK_FORMAT_R16G16_UNORM, "rg16", ' '},
+    {VK_FORMAT_R16G16B16A16_UNORM, "rgba16", ' '},
+    {VK_FORMAT_R16_SFLOAT, "r16f", ' '},
+    {VK_FORMAT_R16G16_SFLOAT, "rg16f", ' '},
+    {VK_FORMAT_R16G16B16A16_SFLOAT, "rgba16f", ' '},
+    {VK_FORMAT_R32_SFLOAT, "r32f", ' '},
+    {VK_FORMAT_R32G32_SFLOAT, "rg32f", ' '},
+    {VK_FORMAT_R32G32B32A32_SFLOAT, "rgba32f", ' '},
+    {VK_FORMAT_A2B10G10R10_UNORM_PACK32, "rgb10_a2", ' '},
+    {VK_FORMAT_B10G11R11_UFLOAT_PACK32, "r11f_g11f_b10f", ' '},
+    {VK_FORMAT_R8_UINT, "r8ui", 'u'},
+    {VK_FORMAT_R8G8_UINT, "rg8ui", 'u'},
+    {VK_FORMAT_R8G8B8A8_UINT, "rgba8ui", 'u'},
+    {VK_FORMAT_R16_UINT, "r16ui", 'u'},
+    {VK_FORMAT_R16G16_UINT, "rg16ui", 'u'},
+    {VK_FORMAT_R16G16B16A16_UINT, "rgba16ui", 'u'},
+    {VK_FORMAT_R32_UINT, "r32ui", 'u'},
+    {VK_FORMAT_R32G32_UINT, "rg32ui", 'u'},
+    {VK_FORMAT_R32G32B32A32_UINT, "rgba32ui", 'u'},
+    {VK_FORMAT_R8_SINT, "r8i", 'i'},
+    {VK_FORMAT_R8G8_SINT, "rg8i", 'i'},
+    {VK_FORMAT_R8G8B8A8_SINT, "rgba8i", 'i'},
+    {VK_FORMAT_R16_SINT, "r16i", 'i'},
+    {VK_FORMAT_R16G16_SINT, "rg16i", 'i'},
+    {VK_FORMAT_R16G16B16A16_SINT, "rgba16i", 'i'},
+    {VK_FORMAT_R32_SINT, "r32i", 'i'},
+    {VK_FORMAT_R32G32_SINT, "rg32i", 'i'},
+    {VK_FORMAT_R32G32B32A32_SINT, "rgba32i", 'i'},
+};
+
+const StorageFormat* findStorageFormat(VkFormat format) {
+  for (const auto& storageFormat : kStorageFormats) {
+    if (storageFormat.format == format) {
+      return &storageFormat;
+    }
+  }
+  return nullptr;
+}
+
+// levels are accessed with constant indices, so shaderStorageImageArrayDynamicIndexing is not
+// needed
+const char* kShaderSource = R"(
+layout (local_size_x = 16, local_size_y = 16) in;
+
+layout (set = 0, binding = 0, FORMAT) uniform coherent IMAGE kMips[13];
+layout (set = 0, binding = 1) coherent buffer Counters {
+  uint counters[];
+};
+layout (push_constant) uniform PushConstants {
+  uvec2 size;
+  uint numMipLevels;
+  uint numWorkGroups;
+} pc;
+
+shared VEC sharedTexels[16][16];
+shared bool isLastWorkGroup;
+
+ivec2 levelSize(uint level) {
+  return ivec2(max(pc.size >> level, uvec2(1)));
+}
+
+VEC average(VEC a, VEC b, VEC c, VEC d) {
+#if IS_INTEGER
+  // floor((a + b + c + d) / 4) without overflows
+  const SCALAR mask = SCALAR(3);
+  return (a >> 2) + (b >> 2) + (c >> 2) + (d >> 2) +
+         (((a & mask) + (b & mask) + (c & mask) + (d & mask)) >> 2);
+#else
+  return (a + b + c + d) * 0.25;
+#endif
+}
+
+#define LOAD(i) case i: return VEC(imageLoad(kMips[i], p));
+VEC load(uint level, ivec2 pos) {
+  const ivec3 p = ivec3(min(pos, levelSize(level) - 1), gl_WorkGroupID.z);
+  switch (level) {
+    LOAD(0) LOAD(1) LOAD(2) LOAD(3) LOAD(4) LOAD(5) LOAD(6)
+    LOAD(7) LOAD(8) LOAD(9) LOAD(10) LOAD(11) LOAD(12)
+  }
+  return VEC(0);
+}
+
+#define STORE(i) case i: imageStore(kMips[i], p, value); break;
+void store(uint level, ivec2 pos, VEC value) {
+  if (level >= pc.numMipLevels || any(greaterThanEqual(pos, levelSize(level)))) {
+    return;
+  }
+  const ivec3 p = ivec3(pos, gl_WorkGroupID.z);
+  switch (level) {
+    STORE(1) STORE(2) STORE(3) STORE(4) STORE(5) STORE(6)
+    STORE(7) STORE(8) STORE(9) STORE(10) STORE(11) STORE(12)
+  }
+}
+
+// downsamples a 64x64 tile of srcLevel into srcLevel + 1 .. srcLevel + 6
+void downsample(uint srcLevel, uvec2 tile) {
+  const ivec2 tid = ivec2(gl_LocalInvocationID.xy);
+
+  // srcLevel + 1: 2x2 texels per thread
+  const ivec2 base = ivec2(tile) * 32 + tid * 2;
+  VEC texels[4];
+  for (int i = 0; i != 4; i++) {
+    const ivec2 pos = base + ivec2(i & 1, i >> 1);
+    const ivec2 src = pos * 2;
+    texels[i] = average(load(srcLevel, src),
+                        load(srcLevel, src + ivec2(1, 0)),
+                        load(srcLevel, src + ivec2(0, 1)),
+                        load(srcLevel, src + ivec2(1, 1)));
+    store(srcLevel + 1, pos, texels[i]);
+  }
+  if (srcLevel + 2 >= pc.numMipLevels) {
+    return;
+  }
+
+  // srcLevel + 2: 1 texel per thread. Levels which are 1 texel wide or high use the same texel
+  // twice, like all following levels
+  const ivec2 next = max(min(base + 1, levelSize(srcLevel + 1) - 1), base) - base;
+  VEC value = average(texels[0], texels[next.x], texels[next.y * 2], texels[next.y * 2 + next.x]);
+  store(srcLevel + 2, ivec2(tile) * 16 + tid, value);
+  sharedTexels[tid.y][tid.x] = value;
+  barrier();
+
+  // srcLevel + 3 .. srcLevel + 6 from shared memory
+  for (int n = 8, level = int(srcLevel) + 3; n != 0 && level < int(pc.numMipLevels);
+       n /= 2, level++) {
+    const bool isActive = all(lessThan(tid, ivec2(n)));
+    if (isActive) {
+      const ivec2 origin = ivec2(tile) * n * 2;
+      const ivec2 p = origin + tid * 2;
+      const ivec2 a = p - origin;
+      const ivec2 b = max(min(p + 1, levelSize(uint(level - 1)) - 1), p) - origin;
+      value = average(sharedTexels[a.y][a.x],
+                      sharedTexels[a.y][b.x],
+                      sharedTexels[b.y][a.x],
+                      sharedTexels[b.y][b.x]);
+      store(uint(level), ivec2(tile) * n + tid, value);
+    }
+    barrier();
+    if (isActive) {
+      sharedTexels[tid.y][tid.x] = value;
+    }
+    barrier();
+  }
+}
+
+void main() {
+  downsample(0u, gl_WorkGroupID.xy);
+  if (pc.numMipLevels <= 7u) {
+    return;
+  }
+
+  // the last work group of this layer downsamples level 6, which all work groups have written
+  memoryBarrierImage();
+  barrier();
+  if (gl_LocalInvocationIndex == 0u) {
+    isLastWorkGroup = atomicAdd(counters[gl_WorkGroupID.z], 1u) == pc.numWorkGroups - 1u;
+  }
+  barrier();
+  if (!isLastWorkGroup) {
+    return;
+  }
+  memoryBarrierImage();
+  downsample(6u, uvec2(0u));
+}
+)";
+
+} // namespace
+
+namespace igl {
+namespace vulkan {
+
+VulkanMipmapGenerator::Bindings::~Bindings() {
+  if (pool_ != VK_NULL_HANDLE) {
+    ctx_.deferredTask(std::packaged_task<void()>(
+        [device = ctx_.device_->getVkDevice(), pool = pool_]() {
+          vkDestroyDescriptorPool(device, pool, nullptr);
+        }));
+  }
+}
+
+VulkanMipmapGenerator::VulkanMipmapGenerator(const VulkanContext& ctx) : ctx_(ctx) {
+  VkDevice device = ctx_.device_->getVkDevice();
+
+  const std::array<VkDescriptorSetLayoutBinding, 2> bindings = {
+      ivkGetDescriptorSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kMaxMipLevels),
+      ivkGetDescriptorSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1),
+  };
+  const std::array<VkDescriptorBindingFlags, 2> bindingFlags = {};
+  dsl_ = std::make_unique<VulkanDescriptorSetLayout>(
+      device,
+      static_cast<uint32_t>(bindings.size()),
+      bindings.data(),
+      bindingFlags.data(),
+      "Descriptor Set Layout: VulkanMipmapGenerator");
+
+  const VkDescriptorSetLayout dsl = dsl_->getVkDescriptorSetLayout();
+  const VkPushConstantRange range = {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants)};
+  pipelineLayout_ = std::make_unique<VulkanPipelineLayout>(
+      device, &dsl, 1, range, "Pipeline Layout: VulkanMipmapGenerator");
+
+  counters_ = ctx_.createBuffer(kMaxLayers * sizeof(uint32_t),
+                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                    VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                nullptr,
+                                "Buffer: VulkanMipmapGenerator counters");
+}
+
+VulkanMipmapGenerator::~VulkanMipmapGenerator() {
+  VkDevice device = ctx_.device_->getVkDevice();
+  for (const auto& it : pipelines_) {
+    vkDestroyPipeline(device, it.second, nullptr);
+  }
+}
+
+bool VulkanMipmapGenerator::isSupported(const VulkanImage& image) const {
+  const uint32_t maxSize = kTileSize << (kMaxMipLevels - 7);
+  return image.type_ == VK_IMAGE_TYPE_2D && image.samples_ == VK_SAMPLE_COUNT_1_BIT &&
+         image.isStorageImage() && !image.isDepthOrStencilFormat_ && image.mipLevels_ > 1 &&
+         image.extent_.width <= maxSize && image.extent_.height <= maxSize &&
+         image.arrayLayers_ <= kMaxLayers && counters_ &&
+         (image.formatProperties_.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) &&
+         findStorageFormat(image.imageFormat_) != nullptr;
+}
+
+std::unique_ptr<VulkanMipmapGenerator::Bindings> VulkanMipmapGenerator::createBindings(
+    const VulkanImage& image) const {
+  IGL_ASSERT(isSupported(image));
+
+  VkDevice device = ctx_.device_->getVkDevice();
+  auto bindings = std::make_unique<Bindings>(ctx_);
+
+  const std::array<VkDescriptorPoolSize, 2> poolSizes = {
+      VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kMaxMipLevels},
+      VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
+  };
+  VK_ASSERT_RETURN_VALUE(ivkCreateDescriptorPool(device,
+                                                 1,
+                                                 static_cast<uint32_t>(poolSizes.size()),
+                                                 poolSizes.data(),
+                                                 &bindings->pool_),
+                         nullptr);
+  VK_ASSERT_RETURN_VALUE(
+      ivkAllocateDescriptorSet(
+          device, bindings->pool_, dsl_->getVkDescriptorSetLayout(), &bindings->dset_),
+      nullptr);
+
+  std::array<VkDescriptorImageInfo, kMaxMipLevels> imageInfos = {};
+  for (uint32_t level = 0; level != image.mipLevels_; level++) {
+    bindings->imageViews_.push_back(
+        image.createImageView(VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+                              image.imageFormat_,
+                              VK_IMAGE_ASPECT_COLOR_BIT,
+                              level,
+                              1,
+                              0,
+                              image.arrayLayers_,
+                              "Image View: VulkanMipmapGenerator"));
+  }
+  for (uint32_t level = 0; level != kMaxMipLevels; level++) {
+    // unused levels repeat the last one, so every descriptor is valid
+    const auto& imageView = bindings->imageViews_[std::min(level, image.mipLevels_ - 1)];
+    imageInfos[level] = {VK_NULL_HANDLE, imageView->getVkImageView(), VK_IMAGE_LAYOUT_GENERAL};
+  }
+  const VkDescriptorBufferInfo bufferInfo = {counters_->getVkBuffer(), 0, VK_WHOLE_SIZE};
+
+  const std::array<VkWriteDescriptorSet, 2> writes = {
+      ivkGetWriteDescriptorSet_ImageInfo(
+          bindings->dset_, 0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kMaxMipLevels, imageInfos.data()),
+      ivkGetWriteDescriptorSet_BufferInfo(
+          bindings->dset_, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, &bufferInfo),
+  };
+  vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+  return bindings;
+}
+
+VkPipeline VulkanMipmapGenerator::getPipeline(VkFormat format) const {
+  std::lock_guard<std::mutex> lock(pipelinesMutex_);
+
+  const auto it = pipelines_.find(format);
+  if (it != pipelines_.end()) {
+    return it->second;
+  }
+
+  const StorageFormat* storageFormat = findStorageFormat(format);
+  IGL_ASSERT(storageFormat);
+
+  const bool isInteger = storageFormat->prefix != ' ';
+  const std::string prefix = isInteger ? std::string(1, storageFormat->prefix) : "";
+  const std::string source = std::string("#version 460\n") +
+                             "#define FORMAT " + storageFormat->qualifier + "\n" +
+                             "#define IMAGE " + prefix + "image2DArray\n" +
+                             "#define VEC " + prefix + "vec4\n" +
+                             "#define SCALAR " + (prefix == "i" ? "int" : "uint") + "\n" +
+                             "#define IS_INTEGER " + (isInteger ? "1" : "0") + "\n" +
+                             kShaderSource;
+
+  VkDevice device = ctx_.device_->getVkDevice();
+
+  glslang_resource_t glslangResource;
+  ivkGlslangResource(&glslangResource, &ctx_.getVkPhysicalDeviceProperties());
+
+  VkShaderModule shaderModule = VK_NULL_HANDLE;
+  const Result result = compileShader(
+      device, VK_SHADER_STAGE_COMPUTE_BIT, source.c_str(), &shaderModule, &glslangResource);
+  if (!IGL_VERIFY(result.isOk())) {
+    IGL_LOG_ERROR("VulkanMipmapGenerator: %s\n", result.message.c_str());
+    return VK_NULL_HANDLE;
+  }
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  VulkanComputePipelineBuilder()
+      .shaderStage(
+          ivkGetPipelineShaderStageCreateInfo(
+              VK_SHADER_STAGE_COMPUTE_BIT, shaderModule, "main", nullptr))
+      .build(device,
+             ctx_.pipelineCache_,
+             pipelineLayout_->getVkPipelineLayout(),
+             &pipeline,
+             IGL_FORMAT("Pipeline: VulkanMipmapGenerator {}", storageFormat->qualifier).c_str());
+  vkDestroyShaderModule(device, shaderModule, nullptr);
+
+  pipelines_[format] = pipeline;
+  return pipeline;
+}
+
+void VulkanMipmapGenerator::generate(VkCommandBuffer cmdBuf,
+                                     const VulkanImage& image,
+                                     const Bindings& bindings) const {
+  IGL_PROFILER_FUNCTION();
+
+  VkPipeline pipeline = getPipeline(image.imageFormat_);
+  if (pipeline == VK_NULL_HANDLE) {
+    return;
+  }
+
+  ivkCmdBeginDebugUtilsLabel(
+      cmdBuf, "Generate mipmaps (compute)", igl::Color(1.f, 0.75f, 0.f).toFloatPtr());
+
+  const VkImageLayout originalImageLayout = image.imageLayout_;
+  IGL_ASSERT(originalImageLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+
+  const VkImageSubresourceRange range = {
+      VK_IMAGE_ASPECT_COLOR_BIT, 0, image.mipLevels_, 0, image.arrayLayers_};
+  image.transitionLayout(cmdBuf,
+                         VK_IMAGE_LAYOUT_GENERAL,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         range);
+
+  // reset the counters after any previous dispatch which used them
+  const VkDeviceSize countersSize = image.arrayLayers_ * sizeof(uint32_t);
+  ivkBufferMemoryBarrier(cmdBuf,
+                         counters_->getVkBuffer(),
+                         VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                         VK_ACCESS_TRANSFER_WRITE_BIT,
+                         0,
+                         countersSize,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT);
+  vkCmdFillBuffer(cmdBuf, counters_->getVkBuffer(), 0, countersSize, 0);
+  ivkBufferMemoryBarrier(cmdBuf,
+                         counters_->getVkBuffer(),
+                         VK_ACCESS_TRANSFER_WRITE_BIT,
+                         VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                         0,
+                         countersSize,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+  const uint32_t numGroupsX = (image.extent_.width + kTileSize - 1) / kTileSize;
+  const uint32_t numGroupsY = (image.extent_.height + kTileSize - 1) / kTileSize;
+  const PushConstants pushConstants = {
+      image.extent_.width, image.extent_.height, image.mipLevels_, numGroupsX * numGroupsY};
+
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("%p vkCmdDispatch(%u, %u, %u) - mipmaps\n",
+               cmdBuf,
+               numGroupsX,
+               numGroupsY,
+               image.arrayLayers_);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+  vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+  vkCmdBindDescriptorSets(cmdBuf,
+                          VK_PIPELINE_BIND_POINT_COMPUTE,
+                          pipelineLayout_->getVkPipelineLayout(),
+                          0,
+                          1,
+                          &bindings.dset_,
+                          0,
+                          nullptr);
+  vkCmdPushConstants(cmdBuf,
+                     pipelineLayout_->getVkPipelineLayout(),
+                     VK_SHADER_STAGE_COMPUTE_BIT,
+                     0,
+                     sizeof(pushConstants),
+                     &pushConstants);
+  vkCmdDispatch(cmdBuf, numGroupsX, numGroupsY, image.arrayLayers_);
+
+  ivkImageMemoryBarrier(cmdBuf,
+                        image.vkImage_,
+                        VK_ACCESS_SHADER_WRITE_BIT, // srcAccessMask
+                        0, // dstAccessMask
+                        VK_IMAGE_LAYOUT_GENERAL, // oldImageLayout
+                        originalImageLayout, // newImageLayout
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // srcStageMask
+                        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, // dstStageMask
+                        range);
+  image.setLayout(originalImageLayout, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+  ivkCmdEndDebugUtilsLabel(cmdBuf);
+}
+
+} // namespace vulkan
+} // namespace igl
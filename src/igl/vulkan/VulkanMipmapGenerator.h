@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanBuffer;
+class VulkanContext;
+class VulkanDescriptorSetLayout;
+class VulkanImage;
+class VulkanImageView;
+class VulkanPipelineLayout;
+
+/**
+ * @brief Generates all mip levels of an image with a single compute dispatch.
+ *
+ * Every work group downsamples a 64x64 tile of level 0 into levels 1..6 in shared memory. The last
+ * work group to finish (detected with an atomic counter per layer) downsamples level 6 into the
+ * remaining levels. Unlike a chain of blits, this needs no barriers between levels and works for
+ * integer and other formats which cannot be blitted, as long as they support storage images.
+ */
+class VulkanMipmapGenerator final {
+ public:
+  // a 4096x4096 image: the last work group downsamples a 64x64 level 6
+  static constexpr uint32_t kMaxMipLevels = 13;
+  static constexpr uint32_t kMaxLayers = 256;
+
+  // descriptors of one image; created on the first use and destroyed with the image
+  class Bindings final {
+   public:
+    explicit Bindings(const VulkanContext& ctx) : ctx_(ctx) {}
+    ~Bindings();
+
+    Bindings(const Bindings&) = delete;
+    Bindings& operator=(const Bindings&) = delete;
+
+   private:
+    friend class VulkanMipmapGenerator;
+
+    const VulkanContext& ctx_;
+    std::vector<std::shared_ptr<VulkanImageView>> imageViews_; // one per mip level
+    VkDescriptorPool pool_ = VK_NULL_HANDLE;
+    VkDescriptorSet dset_ = VK_NULL_HANDLE;
+  };
+
+  explicit VulkanMipmapGenerator(const VulkanContext& ctx);
+  ~VulkanMipmapGenerator();
+
+  VulkanMipmapGenerator(const VulkanMipmapGenerator&) = delete;
+  VulkanMipmapGenerator& operator=(const VulkanMipmapGenerator&) = delete;
+
+  // 2D and 2D array storage images in a format with a GLSL storage format qualifier
+  bool isSupported(const VulkanImage& image) const;
+
+  std::unique_ptr<Bindings> createBindings(const VulkanImage& image) const;
+
+  // generates mip levels 1..N-1 from level 0 and restores the layout of the image
+  void generate(VkCommandBuffer cmdBuf, const VulkanImage& image, const Bindings& bindings) const;
+
+ private:
+  // compiles the shader for the storage format of `format` on first use
+  VkPipeline getPipeline(VkFormat format) const;
+
+ private:
+  const VulkanContext& ctx_;
+  std::unique_ptr<VulkanDescriptorSetLayout> dsl_;
+  std::unique_ptr<VulkanPipelineLayout> pipelineLayout_;
+  std::shared_ptr<VulkanBuffer> counters_; // one atomic counter per layer
+  mutable std::mutex pipelinesMutex_;
+  mutable std::unordered_map<VkFormat, VkPipeline> pipelines_;
+};
+
+} // namespace vulkan
+} // namespace igl
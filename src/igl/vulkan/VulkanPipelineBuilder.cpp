@@ -10,8 +10,8 @@
 namespace igl {
 namespace vulkan {
 
-uint32_t VulkanPipelineBuilder::numPipelinesCreated_ = 0;
-uint32_t VulkanComputePipelineBuilder::numPipelinesCreated_ = 0;
+std::atomic<uint32_t> VulkanPipelineBuilder::numPipelinesCreated_ = 0;
+std::atomic<uint32_t> VulkanComputePipelineBuilder::numPipelinesCreated_ = 0;
 
 VulkanPipelineBuilder::VulkanPipelineBuilder() :
   vertexInputState_(ivkGetPipelineVertexInputStateCreateInfo_Empty()),
@@ -86,6 +86,32 @@ VulkanPipelineBuilder& VulkanPipelineBuilder::colorBlendAttachmentStates(
   return *this;
 }
 
+VulkanPipelineBuilder& VulkanPipelineBuilder::renderingFormats(std::vector<VkFormat> colorFormats,
+                                                                VkFormat depthFormat,
+                                                                VkFormat stencilFormat,
+                                                                uint32_t viewMask) {
+  colorFormats_ = std::move(colorFormats);
+  depthFormat_ = depthFormat;
+  stencilFormat_ = stencilFormat;
+  viewMask_ = viewMask;
+  return *this;
+}
+
+VulkanPipelineBuilder& VulkanPipelineBuilder::subpass(uint32_t index) {
+  subpass_ = index;
+  return *this;
+}
+
+VulkanPipelineBuilder& VulkanPipelineBuilder::createFlags(VkPipelineCreateFlags flags) {
+  createFlags_ = flags;
+  return *this;
+}
+
+VulkanPipelineBuilder& VulkanPipelineBuilder::libraryFlags(VkFlags flags) {
+  libraryFlags_ = flags;
+  return *this;
+}
+
 VulkanPipelineBuilder& VulkanPipelineBuilder::shaderStage(VkPipelineShaderStageCreateInfo stage) {
   shaderStages_.push_back(stage);
   return *this;
@@ -134,22 +160,83 @@ VkResult VulkanPipelineBuilder::build(VkDevice device,
       ivkGetPipelineColorBlendStateCreateInfo(uint32_t(colorBlendAttachmentStates_.size()),
                                               colorBlendAttachmentStates_.data());
 
-  const auto result = ivkCreateGraphicsPipeline(device,
-                                                pipelineCache,
-                                                (uint32_t)shaderStages_.size(),
-                                                shaderStages_.data(),
-                                                &vertexInputState_,
-                                                &inputAssembly_,
-                                                nullptr,
-                                                &viewportState,
-                                                &rasterizationState_,
-                                                &multisampleState_,
-                                                &depthStencilState_,
-                                                &colorBlendState,
-                                                &dynamicState,
-                                                pipelineLayout,
-                                                renderPass,
-                                                outPipeline);
+  const void* next = nullptr;
+#if IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+  VkPipelineRenderingCreateInfoKHR renderingInfo = {};
+  renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+  renderingInfo.viewMask = viewMask_;
+  renderingInfo.colorAttachmentCount = (uint32_t)colorFormats_.size();
+  renderingInfo.pColorAttachmentFormats = colorFormats_.data();
+  renderingInfo.depthAttachmentFormat = depthFormat_;
+  renderingInfo.stencilAttachmentFormat = stencilFormat_;
+  if (renderPass == VK_NULL_HANDLE) {
+    next = &renderingInfo;
+  }
+#endif // IGL_VULKAN_DYNAMIC_RENDERING_SUPPORTED
+
+  VkPipelineCreateFlags flags = createFlags_;
+  const VkPipelineShaderStageCreateInfo* stages = shaderStages_.data();
+  uint32_t numStages = (uint32_t)shaderStages_.size();
+  // the states of the parts a library does not contain are not passed at all
+  auto hasPart = [this](VkFlags part) { return libraryFlags_ == 0 || (libraryFlags_ & part); };
+  VkFlags vertexInputPart = 0;
+  VkFlags preRasterizationPart = 0;
+  VkFlags fragmentShaderPart = 0;
+  VkFlags fragmentOutputPart = 0;
+#if IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED
+  vertexInputPart = VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+  preRasterizationPart = VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+  fragmentShaderPart = VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+  fragmentOutputPart = VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+  VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo = {};
+  libraryInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+  std::vector<VkPipelineShaderStageCreateInfo> libraryStages;
+  if (libraryFlags_ != 0) {
+    libraryInfo.pNext = next;
+    libraryInfo.flags = libraryFlags_;
+    next = &libraryInfo;
+    // the optimized link needs the information retained in the libraries
+    flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR |
+             VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+    for (const VkPipelineShaderStageCreateInfo& stage : shaderStages_) {
+      const VkFlags part = stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT ? fragmentShaderPart
+                                                                       : preRasterizationPart;
+      if (libraryFlags_ & part) {
+        libraryStages.push_back(stage);
+      }
+    }
+    stages = libraryStages.data();
+    numStages = (uint32_t)libraryStages.size();
+  }
+#else
+  IGL_ASSERT_MSG(libraryFlags_ == 0, "Graphics pipeline libraries are not supported");
+#endif // IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED
+
+  const bool hasVertexInput = hasPart(vertexInputPart);
+  const bool hasPreRasterization = hasPart(preRasterizationPart);
+  const bool hasFragmentShader = hasPart(fragmentShaderPart);
+  const bool hasFragmentOutput = hasPart(fragmentOutputPart);
+
+  const auto result = ivkCreateGraphicsPipeline(
+      device,
+      pipelineCache,
+      flags,
+      numStages,
+      stages,
+      hasVertexInput ? &vertexInputState_ : nullptr,
+      hasVertexInput ? &inputAssembly_ : nullptr,
+      nullptr,
+      hasPreRasterization ? &viewportState : nullptr,
+      hasPreRasterization ? &rasterizationState_ : nullptr,
+      hasFragmentShader || hasFragmentOutput ? &multisampleState_ : nullptr,
+      hasFragmentShader ? &depthStencilState_ : nullptr,
+      hasFragmentOutput ? &colorBlendState : nullptr,
+      &dynamicState,
+      hasPreRasterization || hasFragmentShader ? pipelineLayout : VK_NULL_HANDLE,
+      hasPreRasterization || hasFragmentShader || hasFragmentOutput ? renderPass : VK_NULL_HANDLE,
+      subpass_,
+      next,
+      outPipeline);
 
   if (!IGL_VERIFY(result == VK_SUCCESS)) {
     return result;
@@ -161,19 +248,86 @@ VkResult VulkanPipelineBuilder::build(VkDevice device,
   return ivkSetDebugObjectName(device, VK_OBJECT_TYPE_PIPELINE, (uint64_t)*outPipeline, debugName);
 }
 
+VkResult VulkanPipelineBuilder::link(VkDevice device,
+                                     VkPipelineCache pipelineCache,
+                                     VkPipelineLayout pipelineLayout,
+                                     VkPipelineCreateFlags flags,
+                                     const std::vector<VkPipeline>& libraries,
+                                     bool optimize,
+                                     VkPipeline* outPipeline,
+                                     const char* debugName) noexcept {
+#if IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED
+  VkPipelineLibraryCreateInfoKHR libraryInfo = {};
+  libraryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+  libraryInfo.libraryCount = (uint32_t)libraries.size();
+  libraryInfo.pLibraries = libraries.data();
+
+  if (optimize) {
+    flags |= VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT;
+  }
+
+  // all the states come from the libraries
+  const VkResult result = ivkCreateGraphicsPipeline(device,
+                                                    pipelineCache,
+                                                    flags,
+                                                    0,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr,
+                                                    pipelineLayout,
+                                                    VK_NULL_HANDLE,
+                                                    0,
+                                                    &libraryInfo,
+                                                    outPipeline);
+
+  if (!IGL_VERIFY(result == VK_SUCCESS)) {
+    return result;
+  }
+
+  numPipelinesCreated_++;
+
+  // set debug name
+  return ivkSetDebugObjectName(device, VK_OBJECT_TYPE_PIPELINE, (uint64_t)*outPipeline, debugName);
+#else
+  (void)device;
+  (void)pipelineCache;
+  (void)pipelineLayout;
+  (void)flags;
+  (void)libraries;
+  (void)optimize;
+  (void)outPipeline;
+  (void)debugName;
+  IGL_ASSERT_MSG(false, "Graphics pipeline libraries are not supported");
+  return VK_ERROR_FEATURE_NOT_PRESENT;
+#endif // IGL_VULKAN_GRAPHICS_PIPELINE_LIBRARY_SUPPORTED
+}
+
 VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::shaderStage(
     VkPipelineShaderStageCreateInfo stage) {
   shaderStage_ = stage;
   return *this;
 }
 
+VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::createFlags(
+    VkPipelineCreateFlags flags) {
+  createFlags_ = flags;
+  return *this;
+}
+
 VkResult VulkanComputePipelineBuilder::build(VkDevice device,
                                              VkPipelineCache pipelineCache,
                                              VkPipelineLayout pipelineLayout,
                                              VkPipeline* outPipeline,
                                              const char* debugName) noexcept {
-  const VkResult result =
-      ivkCreateComputePipeline(device, pipelineCache, &shaderStage_, pipelineLayout, outPipeline);
+  const VkResult result = ivkCreateComputePipeline(
+      device, pipelineCache, createFlags_, &shaderStage_, pipelineLayout, outPipeline);
 
   if (!IGL_VERIFY(result == VK_SUCCESS)) {
     return result;
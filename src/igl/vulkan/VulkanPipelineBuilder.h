@@ -8,6 +8,7 @@
 #pragma once
 
 #include <igl/vulkan/Common.h>
+#include <atomic>
 #include <igl/vulkan/VulkanHelpers.h>
 #include <vector>
 
@@ -39,7 +40,21 @@ class VulkanPipelineBuilder final {
   VulkanPipelineBuilder& vertexInputState(const VkPipelineVertexInputStateCreateInfo& state);
   VulkanPipelineBuilder& colorBlendAttachmentStates(
       std::vector<VkPipelineColorBlendAttachmentState>& states);
+  // the attachments of a pipeline built without a render pass (dynamic rendering)
+  VulkanPipelineBuilder& renderingFormats(std::vector<VkFormat> colorFormats,
+                                          VkFormat depthFormat,
+                                          VkFormat stencilFormat,
+                                          uint32_t viewMask);
+  // the subpass of the render pass passed to build() the pipeline is used in
+  VulkanPipelineBuilder& subpass(uint32_t index);
+  // e.g. VulkanContext::getPipelineCreateFlags()
+  VulkanPipelineBuilder& createFlags(VkPipelineCreateFlags flags);
+  // build() creates a graphics pipeline library with only these parts of the pipeline
+  // (VkGraphicsPipelineLibraryFlagsEXT); the states of the other parts are ignored. 0 - build a
+  // whole pipeline
+  VulkanPipelineBuilder& libraryFlags(VkFlags flags);
 
+  // `renderPass` is VK_NULL_HANDLE for pipelines used with dynamic rendering
   [[nodiscard]] VkResult build(VkDevice device,
                                VkPipelineCache pipelineCache,
                                VkPipelineLayout pipelineLayout,
@@ -47,6 +62,18 @@ class VulkanPipelineBuilder final {
                                VkPipeline* outPipeline,
                                const char* debugName = nullptr) noexcept;
 
+  // links graphics pipeline libraries covering all parts of a pipeline into a pipeline. Without
+  // `optimize` this is a fast link; with it, the link-time optimizations take about as long as
+  // building a whole pipeline. `flags` have to match the flags of the libraries
+  [[nodiscard]] static VkResult link(VkDevice device,
+                                     VkPipelineCache pipelineCache,
+                                     VkPipelineLayout pipelineLayout,
+                                     VkPipelineCreateFlags flags,
+                                     const std::vector<VkPipeline>& libraries,
+                                     bool optimize,
+                                     VkPipeline* outPipeline,
+                                     const char* debugName = nullptr) noexcept;
+
   static uint32_t getNumPipelinesCreated() {
     return numPipelinesCreated_;
   }
@@ -60,7 +87,15 @@ class VulkanPipelineBuilder final {
   VkPipelineMultisampleStateCreateInfo multisampleState_;
   VkPipelineDepthStencilStateCreateInfo depthStencilState_;
   std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachmentStates_;
-  static uint32_t numPipelinesCreated_;
+  std::vector<VkFormat> colorFormats_;
+  VkFormat depthFormat_ = VK_FORMAT_UNDEFINED;
+  VkFormat stencilFormat_ = VK_FORMAT_UNDEFINED;
+  uint32_t viewMask_ = 0;
+  uint32_t subpass_ = 0;
+  VkPipelineCreateFlags createFlags_ = 0;
+  VkFlags libraryFlags_ = 0;
+  // pipelines can be built on worker threads
+  static std::atomic<uint32_t> numPipelinesCreated_;
 };
 
 class VulkanComputePipelineBuilder final {
@@ -69,6 +104,7 @@ class VulkanComputePipelineBuilder final {
   ~VulkanComputePipelineBuilder() = default;
 
   VulkanComputePipelineBuilder& shaderStage(VkPipelineShaderStageCreateInfo stage);
+  VulkanComputePipelineBuilder& createFlags(VkPipelineCreateFlags flags);
 
   VkResult build(VkDevice device,
                  VkPipelineCache pipelineCache,
@@ -82,7 +118,9 @@ class VulkanComputePipelineBuilder final {
 
  private:
   VkPipelineShaderStageCreateInfo shaderStage_;
-  static uint32_t numPipelinesCreated_;
+  VkPipelineCreateFlags createFlags_ = 0;
+  // pipelines can be built on worker threads
+  static std::atomic<uint32_t> numPipelinesCreated_;
 };
 
 } // namespace vulkan
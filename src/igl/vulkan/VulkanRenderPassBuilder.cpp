@@ -7,6 +7,8 @@
 
 #include "VulkanRenderPassBuilder.h"
 
+#include <algorithm>
+
 // this cannot be put into namespace
 bool operator==(const VkAttachmentDescription& a, const VkAttachmentDescription& b) {
 #define CMP(field) (a.field == b.field)
@@ -31,22 +33,115 @@ VkResult VulkanRenderPassBuilder::build(VkDevice device,
       "color attachment");
 
   const bool hasDepthStencilAttachment = refDepth_.layout != VK_IMAGE_LAYOUT_UNDEFINED;
-  const VkSubpassDescription subpass =
-      ivkGetSubpassDescription((uint32_t)refsColor_.size(),
-                               refsColor_.data(),
-                               refsColorResolve_.data(),
-                               hasDepthStencilAttachment ? &refDepth_ : nullptr);
-  const VkSubpassDependency dep = ivkGetSubpassDependency();
+
+  std::vector<VkSubpassDescription> subpasses;
+  std::vector<VkSubpassDependency> dependencies;
+
+  // the references of every subpass have to outlive vkCreateRenderPass()
+  struct SubpassRefs {
+    std::vector<VkAttachmentReference> colors;
+    std::vector<VkAttachmentReference> resolves;
+    std::vector<VkAttachmentReference> inputs;
+    std::vector<uint32_t> preserves;
+  };
+  std::vector<SubpassRefs> refs(subpasses_.size());
+
+  if (subpasses_.empty()) {
+    subpasses.push_back(ivkGetSubpassDescription((uint32_t)refsColor_.size(),
+                                                 refsColor_.data(),
+                                                 refsColorResolve_.data(),
+                                                 hasDepthStencilAttachment ? &refDepth_ : nullptr));
+  }
+
+  for (size_t i = 0; i != subpasses_.size(); i++) {
+    const Subpass& subpass = subpasses_[i];
+    SubpassRefs& r = refs[i];
+    // the attachments are resolved at the end of the render pass
+    const bool isLastSubpass = i + 1 == subpasses_.size();
+    for (const uint32_t c : subpass.colors) {
+      IGL_ASSERT_MSG(c < refsColor_.size(), "Invalid subpass color attachment");
+      r.colors.push_back(refsColor_[c]);
+      if (isLastSubpass && !refsColorResolve_.empty()) {
+        r.resolves.push_back(refsColorResolve_[c]);
+      }
+    }
+    for (const uint32_t c : subpass.inputs) {
+      IGL_ASSERT_MSG(c < refsColor_.size(), "Invalid subpass input attachment");
+      IGL_ASSERT_MSG(std::find(subpass.colors.begin(), subpass.colors.end(), c) ==
+                         subpass.colors.end(),
+                     "A subpass cannot render to its own input attachments");
+      r.inputs.push_back(ivkGetAttachmentReference(refsColor_[c].attachment,
+                                                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+    }
+    // the contents of the attachments a subpass does not use are kept for the next subpasses
+    for (uint32_t c = 0; c != refsColor_.size(); c++) {
+      if (std::find(subpass.colors.begin(), subpass.colors.end(), c) == subpass.colors.end() &&
+          std::find(subpass.inputs.begin(), subpass.inputs.end(), c) == subpass.inputs.end()) {
+        r.preserves.push_back(refsColor_[c].attachment);
+      }
+    }
+    const bool usesDepthStencil = hasDepthStencilAttachment && subpass.usesDepthStencil;
+    if (hasDepthStencilAttachment && !usesDepthStencil) {
+      r.preserves.push_back(refDepth_.attachment);
+    }
+    VkSubpassDescription desc =
+        ivkGetSubpassDescription((uint32_t)r.colors.size(),
+                                 r.colors.data(),
+                                 r.resolves.empty() ? nullptr : r.resolves.data(),
+                                 usesDepthStencil ? &refDepth_ : nullptr);
+    desc.inputAttachmentCount = (uint32_t)r.inputs.size();
+    desc.pInputAttachments = r.inputs.data();
+    desc.preserveAttachmentCount = (uint32_t)r.preserves.size();
+    desc.pPreserveAttachments = r.preserves.data();
+    subpasses.push_back(desc);
+
+    if (i > 0) {
+      // the attachments written by the previous subpass are read at the same pixel, which lets
+      // tiled GPUs keep them in tile memory
+      VkSubpassDependency dep = {};
+      dep.srcSubpass = (uint32_t)i - 1;
+      dep.dstSubpass = (uint32_t)i;
+      dep.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                         VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+      dep.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                         VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+      dep.srcAccessMask =
+          VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+      dep.dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT |
+                          VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                          VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+      dep.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+      dependencies.push_back(dep);
+    }
+  }
+
+  VkSubpassDependency dep = ivkGetSubpassDependency();
+  dep.srcSubpass = (uint32_t)subpasses.size() - 1;
+  dependencies.push_back(dep);
+
   const bool hasViewMask = viewMask_ != 0;
 
-  const VkRenderPassMultiviewCreateInfo ci =
-      ivkGetRenderPassMultiviewCreateInfo(&viewMask_, &correlationMask_);
+  const bool hasFragmentDensityMap = refFragmentDensityMap_.layout != VK_IMAGE_LAYOUT_UNDEFINED;
+
+  // all the subpasses render to the same views
+  const std::vector<uint32_t> viewMasks(subpasses.size(), viewMask_);
+  const VkRenderPassMultiviewCreateInfo ci = ivkGetRenderPassMultiviewCreateInfo(
+      (uint32_t)viewMasks.size(), viewMasks.data(), &correlationMask_);
+  VkRenderPassFragmentDensityMapCreateInfoEXT fdm = {};
+  fdm.sType = VK_STRUCTURE_TYPE_RENDER_PASS_FRAGMENT_DENSITY_MAP_CREATE_INFO_EXT;
+  fdm.fragmentDensityMapAttachment = refFragmentDensityMap_;
   const VkResult result = ivkCreateRenderPass(device,
                                               (uint32_t)attachments_.size(),
                                               attachments_.data(),
-                                              &subpass,
-                                              &dep,
+                                              (uint32_t)subpasses.size(),
+                                              subpasses.data(),
+                                              (uint32_t)dependencies.size(),
+                                              dependencies.data(),
                                               hasViewMask ? &ci : nullptr,
+                                              hasFragmentDensityMap ? &fdm : nullptr,
                                               outRenderPass);
   if (!IGL_VERIFY(result == VK_SUCCESS)) {
     return result;
@@ -123,6 +218,22 @@ VulkanRenderPassBuilder& VulkanRenderPassBuilder::addDepthResolve(VkFormat forma
   return *this;
 }
 
+VulkanRenderPassBuilder& VulkanRenderPassBuilder::addFragmentDensityMap(VkFormat format) {
+  IGL_ASSERT_MSG(refFragmentDensityMap_.layout == VK_IMAGE_LAYOUT_UNDEFINED,
+                 "Can have only 1 fragment density map attachment");
+  IGL_ASSERT_MSG(format != VK_FORMAT_UNDEFINED, "Invalid fragment density map format");
+  refFragmentDensityMap_ = ivkGetAttachmentReference(
+      (uint32_t)attachments_.size(), VK_IMAGE_LAYOUT_FRAGMENT_DENSITY_MAP_OPTIMAL_EXT);
+  attachments_.push_back(
+      ivkGetAttachmentDescription(format,
+                                  VK_ATTACHMENT_LOAD_OP_LOAD,
+                                  VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                                  VK_IMAGE_LAYOUT_FRAGMENT_DENSITY_MAP_OPTIMAL_EXT,
+                                  VK_IMAGE_LAYOUT_FRAGMENT_DENSITY_MAP_OPTIMAL_EXT,
+                                  VK_SAMPLE_COUNT_1_BIT));
+  return *this;
+}
+
 VulkanRenderPassBuilder& VulkanRenderPassBuilder::setMultiviewMasks(
     const uint32_t viewMask,
     const uint32_t correlationMask) {
@@ -131,10 +242,41 @@ VulkanRenderPassBuilder& VulkanRenderPassBuilder::setMultiviewMasks(
   return *this;
 }
 
+VulkanRenderPassBuilder& VulkanRenderPassBuilder::addSubpass(std::vector<uint32_t> colors,
+                                                             std::vector<uint32_t> inputs,
+                                                             bool usesDepthStencil) {
+  subpasses_.push_back(Subpass{std::move(colors), std::move(inputs), usesDepthStencil});
+  return *this;
+}
+
+VulkanRenderPassBuilder VulkanRenderPassBuilder::getCompatibilityKey() const {
+  VulkanRenderPassBuilder key = *this;
+  for (auto& a : key.attachments_) {
+    a.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    a.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    a.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    a.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    a.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    a.finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  }
+  for (auto& r : key.refsColor_) {
+    r.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+  }
+  for (auto& r : key.refsColorResolve_) {
+    r.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+  }
+  key.refDepth_.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+  key.refDepthResolve_.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+  key.refFragmentDensityMap_.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+  return key;
+}
+
 bool VulkanRenderPassBuilder::operator==(const VulkanRenderPassBuilder& other) const {
   return attachments_ == other.attachments_ && refsColor_ == other.refsColor_ &&
          refsColorResolve_ == other.refsColorResolve_ && refDepth_ == other.refDepth_ &&
-         refDepthResolve_ == other.refDepthResolve_;
+         refDepthResolve_ == other.refDepthResolve_ &&
+         refFragmentDensityMap_ == other.refFragmentDensityMap_ && viewMask_ == other.viewMask_ &&
+         correlationMask_ == other.correlationMask_ && subpasses_ == other.subpasses_;
 }
 
 uint64_t VulkanRenderPassBuilder::HashFunction::operator()(
@@ -163,6 +305,15 @@ uint64_t VulkanRenderPassBuilder::HashFunction::operator()(
   hash ^= std::hash<uint32_t>()(builder.refDepth_.layout);
   hash ^= std::hash<uint32_t>()(builder.refDepthResolve_.attachment);
   hash ^= std::hash<uint32_t>()(builder.refDepthResolve_.layout);
+  hash ^= std::hash<uint32_t>()(builder.refFragmentDensityMap_.attachment);
+  hash ^= std::hash<uint32_t>()(builder.refFragmentDensityMap_.layout);
+  hash ^= std::hash<uint32_t>()(builder.viewMask_);
+  hash ^= std::hash<uint32_t>()(builder.correlationMask_);
+  for (const auto& s : builder.subpasses_) {
+    hash ^= std::hash<size_t>()(s.colors.size());
+    hash ^= std::hash<size_t>()(s.inputs.size() << 8);
+    hash ^= std::hash<bool>()(s.usesDepthStencil);
+  }
   return hash;
 }
 
@@ -48,8 +48,20 @@ class VulkanRenderPassBuilder final {
       VkAttachmentStoreOp storeOp,
       VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
       VkImageLayout finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+  // the density map is only read by the rasterizer and keeps its layout for the whole render pass
+  VulkanRenderPassBuilder& addFragmentDensityMap(VkFormat format);
   VulkanRenderPassBuilder& setMultiviewMasks(const uint32_t viewMask,
                                              const uint32_t correlationMask);
+  // Adds a subpass to render passes with several subpasses; without any, the render pass has a
+  // single subpass which uses all the attachments. `colors` and `inputs` are indices of addColor()
+  // attachments: the inputs are read with `subpassInput`, the colors of the last subpass resolved
+  VulkanRenderPassBuilder& addSubpass(std::vector<uint32_t> colors,
+                                      std::vector<uint32_t> inputs,
+                                      bool usesDepthStencil);
+
+  // a builder equal to the builders of all render passes compatible with this one: load and store
+  // operations and image layouts are ignored by render pass compatibility
+  VulkanRenderPassBuilder getCompatibilityKey() const;
 
   // comparison operator and a hash function for std::unordered_map<>
   bool operator==(const VulkanRenderPassBuilder& other) const;
@@ -67,13 +79,26 @@ class VulkanRenderPassBuilder final {
                  const char* debugName = nullptr) const noexcept;
 
  private:
+  struct Subpass {
+    std::vector<uint32_t> colors;
+    std::vector<uint32_t> inputs;
+    bool usesDepthStencil = true;
+
+    bool operator==(const Subpass& other) const {
+      return colors == other.colors && inputs == other.inputs &&
+             usesDepthStencil == other.usesDepthStencil;
+    }
+  };
+
   std::vector<VkAttachmentDescription> attachments_;
   std::vector<VkAttachmentReference> refsColor_;
   std::vector<VkAttachmentReference> refsColorResolve_;
   VkAttachmentReference refDepth_ = {};
   VkAttachmentReference refDepthResolve_ = {};
+  VkAttachmentReference refFragmentDensityMap_ = {};
   uint32_t viewMask_ = 0;
   uint32_t correlationMask_ = 0;
+  std::vector<Subpass> subpasses_;
 };
 
 } // namespace vulkan
@@ -23,6 +23,8 @@ namespace vulkan {
 class VulkanSemaphore final {
  public:
   explicit VulkanSemaphore(VkDevice device, const char* debugName = nullptr);
+  // creates a timeline semaphore (VK_KHR_timeline_semaphore)
+  VulkanSemaphore(VkDevice device, uint64_t initialTimelineValue, const char* debugName);
   ~VulkanSemaphore();
 
   VulkanSemaphore(VulkanSemaphore&& other) noexcept;
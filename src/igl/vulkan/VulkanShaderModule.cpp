@@ -7,6 +7,8 @@
 
 #include <igl/vulkan/VulkanShaderModule.h>
 
+#include <algorithm>
+#include <cstring>
 #include <glslang/Include/glslang_c_interface.h>
 #include <igl/vulkan/Common.h>
 
@@ -67,6 +69,25 @@ Result compileShader(VkDevice device,
     return Result(Result::Code::ArgumentNull, "outShaderModule is NULL");
   }
 
+  std::vector<uint32_t> spirv;
+  const Result result = compileShaderToSPIRV(stage, code, spirv, glslLangResource);
+
+  if (!result.isOk()) {
+    return result;
+  }
+
+  VK_ASSERT_RETURN(ivkCreateShaderModuleFromSPIRV(
+      device, spirv.data(), spirv.size() * sizeof(uint32_t), outShaderModule));
+
+  return Result();
+}
+
+Result compileShaderToSPIRV(VkShaderStageFlagBits stage,
+                            const char* code,
+                            std::vector<uint32_t>& outSPIRV,
+                            const glslang_resource_t* glslLangResource) {
+  IGL_PROFILER_FUNCTION();
+
   const glslang_input_t input = ivkGetGLSLangInput(stage, glslLangResource, code);
 
   glslang_shader_t* shader = glslang_shader_create(&input);
@@ -124,13 +145,381 @@ Result compileShader(VkDevice device,
     IGL_LOG_ERROR("%s\n", glslang_program_SPIRV_get_messages(program));
   }
 
-  VK_ASSERT_RETURN(ivkCreateShaderModule(device, program, outShaderModule));
+  const size_t numWords = glslang_program_SPIRV_get_size(program);
+  const uint32_t* words = glslang_program_SPIRV_get_ptr(program);
+
+  outSPIRV.assign(words, words + numWords);
 
   return Result();
 }
 
-VulkanShaderModule::VulkanShaderModule(VkDevice device, VkShaderModule shaderModule) :
-  device_(device), vkShaderModule_(shaderModule) {}
+uint32_t getDescriptorSetMaskFromSPIRV(const uint32_t* spirv, size_t numWords) {
+  // see "Physical Layout of a SPIR-V Module and Instruction" in the SPIR-V specification
+  constexpr uint32_t kMagicNumber = 0x07230203;
+  constexpr uint32_t kHeaderSize = 5;
+  constexpr uint32_t kOpDecorate = 71;
+  constexpr uint32_t kOpDecorationGroup = 73;
+  constexpr uint32_t kOpFunction = 54;
+  constexpr uint32_t kDecorationDescriptorSet = 34;
+
+  if (!spirv || numWords < kHeaderSize || spirv[0] != kMagicNumber) {
+    return kAllDescriptorSets;
+  }
+
+  uint32_t mask = 0;
+
+  for (size_t i = kHeaderSize; i < numWords;) {
+    const uint32_t opcode = spirv[i] & 0xffff;
+    const uint32_t wordCount = spirv[i] >> 16;
+    if (wordCount == 0 || i + wordCount > numWords) {
+      return kAllDescriptorSets;
+    }
+    if (opcode == kOpDecorate && wordCount >= 4 && spirv[i + 2] == kDecorationDescriptorSet) {
+      const uint32_t set = spirv[i + 3];
+      if (set >= 32) {
+        return kAllDescriptorSets;
+      }
+      mask |= 1u << set;
+    } else if (opcode == kOpDecorationGroup) {
+      // decorations applied through groups are not tracked
+      return kAllDescriptorSets;
+    } else if (opcode == kOpFunction) {
+      // annotations precede all function definitions
+      break;
+    }
+    i += wordCount;
+  }
+
+  return mask;
+}
+
+uint32_t relaxPrecisionOfSPIRV(std::vector<uint32_t>& spirv,
+                               std::vector<std::string>* outVariableNames) {
+  // see "Instructions" in the SPIR-V specification
+  constexpr uint32_t kMagicNumber = 0x07230203;
+  constexpr uint32_t kHeaderSize = 5;
+  constexpr uint32_t kOpName = 5;
+  constexpr uint32_t kOpExtInstImport = 11;
+  constexpr uint32_t kOpExtInst = 12;
+  constexpr uint32_t kOpTypeVoid = 19;
+  constexpr uint32_t kOpTypeFloat = 22;
+  constexpr uint32_t kOpTypeVector = 23;
+  constexpr uint32_t kOpTypeImage = 25;
+  constexpr uint32_t kOpTypeSampledImage = 27;
+  constexpr uint32_t kOpTypePointer = 32;
+  constexpr uint32_t kOpTypeForwardPointer = 39;
+  constexpr uint32_t kOpConstantTrue = 41;
+  constexpr uint32_t kOpSpecConstantOp = 52;
+  constexpr uint32_t kOpFunction = 54;
+  constexpr uint32_t kOpVariable = 59;
+  constexpr uint32_t kOpLoad = 61;
+  constexpr uint32_t kOpStore = 62;
+  constexpr uint32_t kOpAccessChain = 65;
+  constexpr uint32_t kOpInBoundsAccessChain = 66;
+  constexpr uint32_t kOpDecorate = 71;
+  constexpr uint32_t kOpVectorShuffle = 79;
+  constexpr uint32_t kOpCompositeConstruct = 80;
+  constexpr uint32_t kOpCompositeExtract = 81;
+  constexpr uint32_t kOpCopyObject = 83;
+  constexpr uint32_t kOpSampledImage = 86;
+  constexpr uint32_t kOpImageSampleImplicitLod = 87;
+  constexpr uint32_t kOpImageSampleExplicitLod = 88;
+  constexpr uint32_t kOpImageSampleProjImplicitLod = 91;
+  constexpr uint32_t kOpImageSampleProjExplicitLod = 92;
+  constexpr uint32_t kOpFNegate = 127;
+  constexpr uint32_t kOpFAdd = 129;
+  constexpr uint32_t kOpFSub = 131;
+  constexpr uint32_t kOpFMul = 133;
+  constexpr uint32_t kOpFDiv = 136;
+  constexpr uint32_t kOpFMod = 141;
+  constexpr uint32_t kOpVectorTimesScalar = 142;
+  constexpr uint32_t kOpDot = 148;
+  constexpr uint32_t kOpSelect = 169;
+  constexpr uint32_t kOpPhi = 245;
+  constexpr uint32_t kDecorationRelaxedPrecision = 0;
+  constexpr uint32_t kStorageClassUniform = 2;
+  constexpr uint32_t kStorageClassOutput = 3;
+  constexpr uint32_t kStorageClassFunction = 7;
+  constexpr uint32_t kStorageClassPushConstant = 9;
+  constexpr uint32_t kStorageClassStorageBuffer = 12;
+  // GLSL.std.450 FAbs, Floor, Ceil, Fract, Pow, Sqrt, InverseSqrt, FMin, FMax, FClamp, FMix, Step,
+  // SmoothStep and Normalize
+  constexpr uint32_t kExtInstructions[] = {4, 8, 9, 10, 26, 31, 32, 37, 40, 43, 46, 48, 49, 69};
+
+  if (spirv.size() < kHeaderSize || spirv[0] != kMagicNumber || spirv[3] > (1u << 22)) {
+    return 0;
+  }
+  const uint32_t bound = spirv[3];
+
+  // the result of an instruction this pass looks at, or 0
+  const auto getResult = [&spirv](size_t i) -> uint32_t {
+    const uint32_t opcode = spirv[i] & 0xffff;
+    const uint32_t wordCount = spirv[i] >> 16;
+    if ((opcode >= kOpTypeVoid && opcode < kOpTypeForwardPointer) || opcode == kOpExtInstImport) {
+      return wordCount >= 2 ? spirv[i + 1] : 0;
+    }
+    switch (opcode) {
+    case kOpExtInst:
+    case kOpVariable:
+    case kOpLoad:
+    case kOpAccessChain:
+    case kOpInBoundsAccessChain:
+    case kOpVectorShuffle:
+    case kOpCompositeConstruct:
+    case kOpCompositeExtract:
+    case kOpCopyObject:
+    case kOpSampledImage:
+    case kOpImageSampleImplicitLod:
+    case kOpImageSampleExplicitLod:
+    case kOpImageSampleProjImplicitLod:
+    case kOpImageSampleProjExplicitLod:
+    case kOpFNegate:
+    case kOpFAdd:
+    case kOpFSub:
+    case kOpFMul:
+    case kOpFDiv:
+    case kOpFMod:
+    case kOpVectorTimesScalar:
+    case kOpDot:
+    case kOpSelect:
+    case kOpPhi:
+      return wordCount >= 3 ? spirv[i + 2] : 0;
+    default:
+      return opcode >= kOpConstantTrue && opcode <= kOpSpecConstantOp && wordCount >= 3
+                 ? spirv[i + 2]
+                 : 0;
+    }
+  };
+
+  std::vector<size_t> instructions;
+  std::vector<size_t> definitions(bound, 0);
+  std::vector<std::string> names(bound);
+  std::vector<bool> wasRelaxed(bound, false);
+  size_t firstType = 0;
+  size_t firstFunction = spirv.size();
+  uint32_t glslStd450 = 0;
+  for (size_t i = kHeaderSize; i < spirv.size();) {
+    const uint32_t opcode = spirv[i] & 0xffff;
+    const uint32_t wordCount = spirv[i] >> 16;
+    if (wordCount == 0 || i + wordCount > spirv.size()) {
+      return 0;
+    }
+    const uint32_t result = getResult(i);
+    if (result >= bound) {
+      return 0;
+    }
+    if (result) {
+      definitions[result] = i;
+    }
+    if (opcode >= kOpTypeVoid && opcode <= kOpTypeForwardPointer && !firstType) {
+      firstType = i;
+    } else if (opcode == kOpFunction && firstFunction == spirv.size()) {
+      firstFunction = i;
+    } else if (opcode == kOpName && wordCount >= 3 && spirv[i + 1] < bound) {
+      const char* name = reinterpret_cast<const char*>(&spirv[i + 2]);
+      names[spirv[i + 1]] = std::string(name, strnlen(name, (wordCount - 2) * sizeof(uint32_t)));
+    } else if (opcode == kOpDecorate && wordCount >= 3 && spirv[i + 1] < bound &&
+               spirv[i + 2] == kDecorationRelaxedPrecision) {
+      wasRelaxed[spirv[i + 1]] = true;
+    } else if (opcode == kOpExtInstImport && wordCount >= 3 &&
+               strncmp(reinterpret_cast<const char*>(&spirv[i + 2]), "GLSL.std.450", 13) == 0) {
+      glslStd450 = spirv[i + 1];
+    }
+    instructions.push_back(i);
+    i += wordCount;
+  }
+  if (!firstType) {
+    return 0;
+  }
+
+  const auto getOpcode = [&](uint32_t id) -> uint32_t {
+    return id < bound && definitions[id] ? spirv[definitions[id]] & 0xffff : 0;
+  };
+  const auto getWord = [&](uint32_t id, uint32_t word) -> uint32_t {
+    if (!getOpcode(id)) {
+      return 0;
+    }
+    const size_t i = definitions[id];
+    return word < (spirv[i] >> 16) ? spirv[i + word] : 0;
+  };
+  const auto isFloat32 = [&](uint32_t type) {
+    if (getOpcode(type) == kOpTypeVector) {
+      type = getWord(type, 2);
+    }
+    return getOpcode(type) == kOpTypeFloat && getWord(type, 2) == 32;
+  };
+  // the variable a pointer points into, or 0
+  const auto getVariable = [&](uint32_t pointer) -> uint32_t {
+    while (getOpcode(pointer) == kOpAccessChain || getOpcode(pointer) == kOpInBoundsAccessChain) {
+      pointer = getWord(pointer, 3);
+    }
+    return getOpcode(pointer) == kOpVariable ? pointer : 0;
+  };
+  // constants and values loaded from uniform, push constant and storage buffers
+  const auto isInvariant = [&](uint32_t id) {
+    const uint32_t opcode = getOpcode(id);
+    if (opcode >= kOpConstantTrue && opcode <= kOpSpecConstantOp) {
+      return true;
+    }
+    const uint32_t pointerType = getWord(getWord(id, 3), 1);
+    const uint32_t storageClass = getWord(pointerType, 2);
+    return opcode == kOpLoad && getOpcode(pointerType) == kOpTypePointer &&
+           (storageClass == kStorageClassUniform ||
+                                 storageClass == kStorageClassPushConstant ||
+                                 storageClass == kStorageClassStorageBuffer);
+  };
+  // colors sampled from float textures which hold no depth
+  const auto isColorSample = [&](size_t i) {
+    const uint32_t sampledImageType = getWord(spirv[i + 3], 1);
+    const uint32_t imageType = getWord(sampledImageType, 2);
+    return getOpcode(sampledImageType) == kOpTypeSampledImage &&
+           getOpcode(imageType) == kOpTypeImage && isFloat32(getWord(imageType, 2)) &&
+           getWord(imageType, 4) != 1;
+  };
+
+  // float variables which are only loaded and stored, with their stored values; other uses, e.g.
+  // passing them to functions, keep their precision
+  std::vector<bool> isCandidate(bound, false);
+  std::vector<std::vector<uint32_t>> storedValues(bound);
+  for (const size_t i : instructions) {
+    const uint32_t opcode = spirv[i] & 0xffff;
+    if (opcode == kOpVariable && (spirv[i] >> 16) >= 4 &&
+        (spirv[i + 3] == kStorageClassFunction || spirv[i + 3] == kStorageClassOutput)) {
+      const uint32_t pointerType = spirv[i + 1];
+      isCandidate[spirv[i + 2]] =
+          getOpcode(pointerType) == kOpTypePointer && isFloat32(getWord(pointerType, 3));
+    }
+  }
+  for (const size_t i : instructions) {
+    const uint32_t opcode = spirv[i] & 0xffff;
+    const uint32_t wordCount = spirv[i] >> 16;
+    if (i < firstFunction || opcode == kOpVariable || opcode == kOpLoad ||
+        opcode == kOpAccessChain || opcode == kOpInBoundsAccessChain) {
+      continue;
+    }
+    if (opcode == kOpStore && wordCount >= 3) {
+      const uint32_t variable = getVariable(spirv[i + 1]);
+      if (variable) {
+        storedValues[variable].push_back(spirv[i + 2]);
+      }
+      continue;
+    }
+    for (uint32_t w = 1; w != wordCount; w++) {
+      const uint32_t variable = getVariable(spirv[i + w]);
+      if (variable) {
+        isCandidate[variable] = false;
+      }
+    }
+  }
+
+  // a value is relaxed if it is computed only from relaxed values and invariants, starting from
+  // the color samples
+  std::vector<bool> relaxed(bound, false);
+  const auto isRelaxedOrInvariant = [&](uint32_t id) {
+    return (id < bound && relaxed[id]) || isInvariant(id);
+  };
+  const auto areRelaxed = [&](size_t begin, size_t end, size_t step) {
+    bool hasRelaxed = false;
+    for (size_t w = begin; w < end; w += step) {
+      if (!isRelaxedOrInvariant(spirv[w])) {
+        return false;
+      }
+      hasRelaxed |= spirv[w] < bound && relaxed[spirv[w]];
+    }
+    return hasRelaxed;
+  };
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (const size_t i : instructions) {
+      const uint32_t opcode = spirv[i] & 0xffff;
+      const size_t end = i + (spirv[i] >> 16);
+      const uint32_t result = getResult(i);
+      // output variables are declared before the functions
+      if ((i < firstFunction && opcode != kOpVariable) || !result || relaxed[result]) {
+        continue;
+      }
+      bool relax = false;
+      if (opcode == kOpVariable) {
+        const std::vector<uint32_t>& values = storedValues[result];
+        relax = isCandidate[result] &&
+                std::all_of(values.begin(), values.end(), isRelaxedOrInvariant) &&
+                std::any_of(values.begin(), values.end(), [&](uint32_t id) {
+                  return id < bound && relaxed[id];
+                });
+      } else if (!isFloat32(spirv[i + 1])) {
+        continue;
+      }
+      switch (opcode) {
+      case kOpImageSampleImplicitLod:
+      case kOpImageSampleExplicitLod:
+      case kOpImageSampleProjImplicitLod:
+      case kOpImageSampleProjExplicitLod:
+        relax = isColorSample(i);
+        break;
+      case kOpLoad:
+        relax = end > i + 3 && getVariable(spirv[i + 3]) && relaxed[getVariable(spirv[i + 3])];
+        break;
+      case kOpCopyObject:
+      case kOpCompositeExtract:
+        relax = areRelaxed(i + 3, std::min(end, i + 4), 1);
+        break;
+      case kOpVectorShuffle:
+        relax = areRelaxed(i + 3, std::min(end, i + 5), 1);
+        break;
+      case kOpSelect:
+        // not the condition
+        relax = areRelaxed(i + 4, end, 1);
+        break;
+      case kOpPhi:
+        // the values, not their parent blocks
+        relax = areRelaxed(i + 3, end, 2);
+        break;
+      case kOpExtInst:
+        relax = glslStd450 && end > i + 4 && spirv[i + 3] == glslStd450 &&
+                std::find(std::begin(kExtInstructions), std::end(kExtInstructions), spirv[i + 4]) !=
+                    std::end(kExtInstructions) &&
+                areRelaxed(i + 5, end, 1);
+        break;
+      case kOpCompositeConstruct:
+      case kOpFNegate:
+      case kOpFAdd:
+      case kOpFSub:
+      case kOpFMul:
+      case kOpFDiv:
+      case kOpFMod:
+      case kOpVectorTimesScalar:
+      case kOpDot:
+        relax = areRelaxed(i + 3, end, 1);
+        break;
+      default:
+        break;
+      }
+      if (relax) {
+        relaxed[result] = true;
+        changed = true;
+      }
+    }
+  }
+
+  std::vector<uint32_t> decorations;
+  for (uint32_t id = 0; id != bound; id++) {
+    if (relaxed[id] && !wasRelaxed[id]) {
+      decorations.insert(decorations.end(),
+                         {(3u << 16) | kOpDecorate, id, kDecorationRelaxedPrecision});
+      if (outVariableNames && getOpcode(id) == kOpVariable && !names[id].empty()) {
+        outVariableNames->push_back(names[id]);
+      }
+    }
+  }
+  // annotations precede the types
+  spirv.insert(spirv.begin() + firstType, decorations.begin(), decorations.end());
+  return static_cast<uint32_t>(decorations.size() / 3);
+}
+
+VulkanShaderModule::VulkanShaderModule(VkDevice device,
+                                       VkShaderModule shaderModule,
+                                       uint32_t descriptorSetMask) :
+  device_(device), vkShaderModule_(shaderModule), descriptorSetMask_(descriptorSetMask) {}
 
 VulkanShaderModule::~VulkanShaderModule() {
   vkDestroyShaderModule(device_, vkShaderModule_, nullptr);
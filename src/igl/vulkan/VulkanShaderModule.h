@@ -8,6 +8,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanHelpers.h>
@@ -21,13 +23,39 @@ Result compileShader(VkDevice device,
                      VkShaderModule* outShaderModule,
                      const glslang_resource_t* glslLangResource = nullptr);
 
+/** @brief Compiles GLSL into SPIR-V without creating a shader module */
+Result compileShaderToSPIRV(VkShaderStageFlagBits stage,
+                            const char* code,
+                            std::vector<uint32_t>& outSPIRV,
+                            const glslang_resource_t* glslLangResource = nullptr);
+
+/**
+ * @brief Returns the descriptor sets referenced by the resources of a SPIR-V module: bit `i` is set
+ * if a resource is decorated with DescriptorSet `i`. Returns kAllDescriptorSets if `spirv` cannot
+ * be parsed.
+ */
+uint32_t getDescriptorSetMaskFromSPIRV(const uint32_t* spirv, size_t numWords);
+
+/**
+ * @brief Decorates the color math of a fragment shader with RelaxedPrecision, so drivers can run it
+ * with 16-bit floats: the colors sampled from float textures which are not depth textures, and the
+ * float values and variables computed only from them, constants and uniforms. Texture coordinates
+ * and other values keep their precision. Returns the number of decorated values, and appends the
+ * names of the decorated variables, e.g. fragment outputs, to `outVariableNames` if not null.
+ * Returns 0 and leaves `spirv` unchanged if it cannot be parsed.
+ */
+uint32_t relaxPrecisionOfSPIRV(std::vector<uint32_t>& spirv,
+                               std::vector<std::string>* outVariableNames = nullptr);
+
 /**
  * @brief RAII wrapper for a Vulkan shader module.
  */
 class VulkanShaderModule final {
  public:
   /** @brief Instantiates a shader module wrapper with the module and the device that owns it */
-  VulkanShaderModule(VkDevice device, VkShaderModule shaderModule);
+  VulkanShaderModule(VkDevice device,
+                     VkShaderModule shaderModule,
+                     uint32_t descriptorSetMask = kAllDescriptorSets);
   ~VulkanShaderModule();
 
   /** @brief Returns the underlying Vulkan shader module */
@@ -35,9 +63,15 @@ class VulkanShaderModule final {
     return vkShaderModule_;
   }
 
+  /** @brief Returns the descriptor sets used by the module (see getDescriptorSetMaskFromSPIRV()) */
+  uint32_t getDescriptorSetMask() const {
+    return descriptorSetMask_;
+  }
+
  private:
   VkDevice device_ = VK_NULL_HANDLE;
   VkShaderModule vkShaderModule_ = VK_NULL_HANDLE;
+  uint32_t descriptorSetMask_ = kAllDescriptorSets;
 };
 
 } // namespace vulkan
@@ -7,7 +7,10 @@
 
 #include <igl/vulkan/VulkanStagingDevice.h>
 
+#include <algorithm>
+
 #include <igl/IGLSafeC.h>
+#include <igl/TextureConversion.h>
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanBuffer.h>
 #include <igl/vulkan/VulkanContext.h>
@@ -43,65 +46,96 @@ VulkanStagingDevice::VulkanStagingDevice(VulkanContext& ctx) : ctx_(ctx) {
 
   const auto& limits = ctx_.getVkPhysicalDeviceProperties().limits;
 
-  // Use default value of 256 MB, and clamp it to the max limits
-  stagingBufferSize_ = std::min(limits.maxStorageBufferRange, 256u * 1024u * 1024u);
-
-  bufferCapacity_ = stagingBufferSize_;
-
-  stagingBuffer_ =
-      ctx_.createBuffer(stagingBufferSize_,
-                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                        nullptr,
-                        "Buffer: staging buffer");
-  IGL_ASSERT(stagingBuffer_.get());
+  // clamp the budget to the max limits; a single chunk can never be larger than the budget
+  maxStagingBufferSize_ =
+      std::min(limits.maxStorageBufferRange, std::max(ctx_.config_.maxStagingBufferSize, 1u));
+  chunkSize_ = std::min(ctx_.config_.stagingBufferChunkSize, uint32_t(maxStagingBufferSize_));
+  chunkSize_ = std::max(getAlignedSize(chunkSize_), stagingBufferAlignment_);
 
   immediate_ = std::make_unique<igl::vulkan::VulkanImmediateCommands>(
       ctx_.device_->getVkDevice(),
       ctx_.deviceQueues_.graphicsQueueFamilyIndex,
-      "VulkanStagingDevice::immediate_");
+      "VulkanStagingDevice::immediate_",
+      0,
+      ctx_.usesTimelineSemaphores());
   IGL_ASSERT(immediate_.get());
+  immediate_->setFrameStatisticsTracker(&ctx_.getFrameStatisticsTracker());
+
+  if (ctx_.deviceQueues_.transferQueue != VK_NULL_HANDLE) {
+    transferImmediate_ = std::make_unique<igl::vulkan::VulkanImmediateCommands>(
+        ctx_.device_->getVkDevice(),
+        ctx_.deviceQueues_.transferQueueFamilyIndex,
+        "VulkanStagingDevice::transferImmediate_",
+        ctx_.deviceQueues_.transferQueueIndex,
+        ctx_.usesTimelineSemaphores());
+    IGL_ASSERT(transferImmediate_.get());
+    transferImmediate_->setFrameStatisticsTracker(&ctx_.getFrameStatisticsTracker());
+  }
+}
+
+VulkanStagingDevice::~VulkanStagingDevice() {
+  IGL_ASSERT_MSG(batchDepth_ == 0, "Unbalanced beginBatch()/endBatch()");
+  flush();
+  if (transferImmediate_) {
+    transferImmediate_->waitAll();
+  }
+  immediate_->waitAll();
 }
 
-void VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer,
-                                        size_t dstOffset,
-                                        size_t size,
-                                        const void* data) {
+VulkanSubmitHandle VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer,
+                                                      size_t dstOffset,
+                                                      size_t size,
+                                                      const void* data,
+                                                      bool isInitialData) {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
   IGL_PROFILER_FUNCTION();
+  ctx_.getFrameStatisticsTracker().add(FrameStatisticsTracker::UploadedBytes, size);
   if (buffer.isMapped()) {
     buffer.bufferSubData(dstOffset, size, data);
-    return;
+    return {};
   }
 
   size_t chunkDstOffset = dstOffset;
-  void* copyData = const_cast<void*>(data);
+  const auto* copyData = static_cast<const uint8_t*>(data);
+
+  beginBatch();
 
   while (size) {
-    // get next staging buffer free offset
-    const MemoryRegionDesc desc = getNextFreeOffset((uint32_t)size);
-    const uint32_t chunkSize = std::min((uint32_t)size, desc.alignedSize_);
+    // large uploads are split into pieces, so they never wait for the whole budget
+    const uint32_t chunkSize = (uint32_t)std::min(size, size_t(chunkSize_));
+    const MemoryRegionDesc desc = allocate(chunkSize);
+    if (!IGL_VERIFY(desc.buffer_)) {
+      break;
+    }
 
     // copy data into staging buffer
-    stagingBuffer_->bufferSubData(desc.srcOffset_, chunkSize, copyData);
+    desc.buffer_->bufferSubData(desc.srcOffset_, chunkSize, copyData);
+
+    if (!isInitialData) {
+      acquireBuffer(buffer.getVkBuffer(), chunkDstOffset, chunkSize);
+    }
 
     // do the transfer
     const VkBufferCopy copy = {desc.srcOffset_, chunkDstOffset, chunkSize};
 
-    auto& wrapper = immediate_->acquire();
-    vkCmdCopyBuffer(wrapper.cmdBuf_, stagingBuffer_->getVkBuffer(), buffer.getVkBuffer(), 1, &copy);
-    const VulkanSubmitHandle fenceId = immediate_->submit(wrapper);
-    outstandingFences_[fenceId.handle()] = desc;
+    vkCmdCopyBuffer(
+        getCommandBuffer(), desc.buffer_->getVkBuffer(), buffer.getVkBuffer(), 1, &copy);
+
+    releaseBuffer(buffer.getVkBuffer(), chunkDstOffset, chunkSize);
 
     size -= chunkSize;
-    copyData = (uint8_t*)copyData + chunkSize;
+    copyData += chunkSize;
     chunkDstOffset += chunkSize;
   }
+
+  return endBatch();
 }
 
 void VulkanStagingDevice::getBufferSubData(VulkanBuffer& buffer,
                                            size_t srcOffset,
                                            size_t size,
                                            void* data) {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
   IGL_PROFILER_FUNCTION();
   if (buffer.isMapped()) {
     buffer.getBufferSubData(srcOffset, size, data);
@@ -112,59 +146,65 @@ void VulkanStagingDevice::getBufferSubData(VulkanBuffer& buffer,
   auto* dstData = static_cast<uint8_t*>(data);
 
   while (size) {
-    // get next staging buffer free offset
-    const MemoryRegionDesc desc = getNextFreeOffset((uint32_t)size);
-    const uint32_t chunkSize = std::min((uint32_t)size, desc.alignedSize_);
+    // readbacks run on the graphics queue after all pending uploads
+    submitPendingUploads(*immediate_);
+
+    const uint32_t chunkSize = (uint32_t)std::min(size, size_t(chunkSize_));
+    const MemoryRegionDesc desc = allocate(chunkSize);
+    if (!IGL_VERIFY(desc.buffer_)) {
+      break;
+    }
 
     // do the transfer
     const VkBufferCopy copy = {chunkSrcOffset, desc.srcOffset_, chunkSize};
 
-    auto& wrapper = immediate_->acquire();
-
-    vkCmdCopyBuffer(wrapper.cmdBuf_, buffer.getVkBuffer(), stagingBuffer_->getVkBuffer(), 1, &copy);
+    const auto& wrapper = immediate_->acquire();
 
-    VulkanSubmitHandle fenceId = immediate_->submit(wrapper);
-    outstandingFences_[fenceId.handle()] = desc;
+    vkCmdCopyBuffer(wrapper.cmdBuf_, buffer.getVkBuffer(), desc.buffer_->getVkBuffer(), 1, &copy);
 
-    // Wait for command to finish
-    flushOutstandingFences();
+    // wait for the command to finish
+    immediate_->wait(submitReadback(wrapper, desc));
 
     // copy data into data
-    const uint8_t* src = stagingBuffer_->getMappedPtr() + desc.srcOffset_;
-    checked_memcpy(dstData, size - chunkSrcOffset, src, chunkSize);
+    const uint8_t* src = desc.buffer_->getMappedPtr() + desc.srcOffset_;
+    checked_memcpy(dstData, size, src, chunkSize);
 
     size -= chunkSize;
-    dstData = (uint8_t*)dstData + chunkSize;
+    dstData += chunkSize;
     chunkSrcOffset += chunkSize;
   }
 }
 
-void VulkanStagingDevice::imageData2D(VulkanImage& image,
-                                      const VkRect2D& imageRegion,
-                                      uint32_t baseMipLevel,
-                                      uint32_t numMipLevels,
-                                      uint32_t layer,
-                                      TextureFormatProperties properties,
-                                      VkFormat format,
-                                      const void* data) {
+VulkanSubmitHandle VulkanStagingDevice::imageData2D(VulkanImage& image,
+                                                    const VkRect2D& imageRegion,
+                                                    uint32_t baseMipLevel,
+                                                    uint32_t numMipLevels,
+                                                    uint32_t layer,
+                                                    TextureFormatProperties properties,
+                                                    VkFormat format,
+                                                    const void* data,
+                                                    TextureFormat dataFormat) {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
   IGL_PROFILER_FUNCTION();
   // cache the dimensions of each mip level for later
   std::vector<uint32_t> mipSizes;
   mipSizes.reserve(numMipLevels);
 
-  // divide the width and height by 2 until we get to the size of level 'baseMipLevel'
-  auto width = image.extent_.width >> baseMipLevel;
-  auto height = image.extent_.height >> baseMipLevel;
+  // the size of level 'baseMipLevel'
+  const auto width = std::max(1u, image.extent_.width >> baseMipLevel);
+  const auto height = std::max(1u, image.extent_.height >> baseMipLevel);
 
-  IGL_ASSERT_MSG(
-      imageRegion.offset.x == 0 && imageRegion.offset.y == 0 && imageRegion.extent.width == width &&
-          imageRegion.extent.height == height,
+  // a single level can be updated partially, e.g. a sub-rectangle of an atlas
+  const bool isFullLevel = imageRegion.offset.x == 0 && imageRegion.offset.y == 0 &&
+                           imageRegion.extent.width == width && imageRegion.extent.height == height;
 
-      "Uploading mip levels with an image region that is smaller than the base mip level is "
-      "not supported");
+  IGL_ASSERT_MSG(isFullLevel || numMipLevels == 1,
+                 "Uploading mip levels with an image region that is smaller than the base mip level "
+                 "is not supported");
 
   // find the storage size for all mip levels being uploaded
-  const auto range = TextureRangeDesc::new2D(0, 0, image.extent_.width, image.extent_.height);
+  const auto range =
+      TextureRangeDesc::new2D(0, 0, imageRegion.extent.width, imageRegion.extent.height);
   uint32_t storageSize = 0;
   for (size_t i = 0; i < numMipLevels; ++i) {
     const uint32_t mipSize =
@@ -172,28 +212,29 @@ void VulkanStagingDevice::imageData2D(VulkanImage& image,
 
     storageSize += mipSize;
     mipSizes.push_back(mipSize);
-    width = width <= 1 ? 1 : width >> 1; // divide the width by 2
-    height = height <= 1 ? 1 : height >> 1; // divide the height by 2
   }
 
-  IGL_ASSERT(storageSize <= stagingBufferSize_);
+  IGL_ASSERT(storageSize <= maxStagingBufferSize_);
 
-  // get next staging buffer free offset
-  MemoryRegionDesc desc = getNextFreeOffset(storageSize);
+  // currently, no support for copying image in multiple smaller chunk sizes
+  const MemoryRegionDesc desc = allocate(storageSize);
 
-  // currently, no support for copying image in multiple smaller chunk sizes.
-  // If we get smaller buffer size than storageSize, we will wait for gpu idle and get bigger chunk.
-  if (desc.alignedSize_ < storageSize) {
-    flushOutstandingFences();
-    desc = getNextFreeOffset(storageSize);
+  if (!IGL_VERIFY(desc.buffer_ && desc.alignedSize_ >= storageSize)) {
+    return {};
   }
 
-  IGL_ASSERT(desc.alignedSize_ >= storageSize);
+  ctx_.getFrameStatisticsTracker().add(FrameStatisticsTracker::UploadedBytes, storageSize);
 
   // 1. Copy the pixel data into the host visible staging buffer
-  stagingBuffer_->bufferSubData(desc.srcOffset_, storageSize, data);
+  writeImageData(desc, storageSize, properties, range, numMipLevels, data, dataFormat);
+
+  // a level still in the initial layout has never been used by the GPU
+  bool isUsed = false;
+  for (uint32_t mipLevel = 0; mipLevel < numMipLevels; ++mipLevel) {
+    isUsed |= image.getLayout(baseMipLevel + mipLevel, layer) != VK_IMAGE_LAYOUT_UNDEFINED;
+  }
 
-  auto& wrapper = immediate_->acquire();
+  beginBatch();
 
   uint32_t mipLevelOffset = 0;
 
@@ -203,17 +244,28 @@ void VulkanStagingDevice::imageData2D(VulkanImage& image,
     IGL_ASSERT(currentMipLevel < image.mipLevels_);
     IGL_ASSERT(mipLevel < image.mipLevels_);
 
-    // 1. Transition initial image layout into TRANSFER_DST_OPTIMAL
-    ivkImageMemoryBarrier(
-        wrapper.cmdBuf_,
-        image.getVkImage(),
-        0,
-        VK_ACCESS_TRANSFER_WRITE_BIT,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, currentMipLevel, 1, layer, 1});
+    const VkImageSubresourceRange subresourceRange{
+        VK_IMAGE_ASPECT_COLOR_BIT, currentMipLevel, 1, layer, 1};
+
+    // 1. Transition initial image layout into TRANSFER_DST_OPTIMAL; a partial update keeps the
+    // rest of the level
+    const VkImageLayout oldLayout =
+        isFullLevel ? VK_IMAGE_LAYOUT_UNDEFINED : image.getLayout(currentMipLevel, layer);
+    if (isUsed) {
+      acquireImage(image.getVkImage(), oldLayout, subresourceRange);
+    } else {
+      ivkImageMemoryBarrier(getCommandBuffer(),
+                            image.getVkImage(),
+                            0,
+                            VK_ACCESS_TRANSFER_WRITE_BIT,
+                            oldLayout,
+                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                            VK_PIPELINE_STAGE_TRANSFER_BIT,
+                            subresourceRange);
+    }
+
+    const VkCommandBuffer cmdBuf = getCommandBuffer();
 
     // 2. Copy the pixel data from the staging buffer into the image
     const VkRect2D region = ivkGetRect2D(imageRegion.offset.x >> mipLevel,
@@ -221,50 +273,72 @@ void VulkanStagingDevice::imageData2D(VulkanImage& image,
                                          std::max(1u, imageRegion.extent.width >> mipLevel),
                                          std::max(1u, imageRegion.extent.height >> mipLevel));
 
-    const VkBufferImageCopy copy = ivkGetBufferImageCopy2D(
-        desc.srcOffset_ + mipLevelOffset, // the offset for this level is at the start of all mip
-                                          // levels + the size of all previous mip levels being
-                                          // uploaded
-        region,
-        VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, currentMipLevel, layer, 1});
+    if (properties.isMultiPlanar()) {
+      // YUV 4:2:0 planes are copied separately: full-size luma followed by half-size chroma
+      const auto lumaProperties = TextureFormatProperties::fromTextureFormat(
+          getTextureFormatOfPlane(properties.format, 0));
+      const uint32_t lumaSize = static_cast<uint32_t>(lumaProperties.getBytesPerRange(
+          TextureRangeDesc::new2D(0, 0, region.extent.width, region.extent.height)));
+      const VkBufferImageCopy copies[] = {
+          ivkGetBufferImageCopy2D(
+              desc.srcOffset_ + mipLevelOffset,
+              region,
+              VkImageSubresourceLayers{VK_IMAGE_ASPECT_PLANE_0_BIT, currentMipLevel, layer, 1}),
+          ivkGetBufferImageCopy2D(
+              desc.srcOffset_ + mipLevelOffset + lumaSize,
+              ivkGetRect2D(region.offset.x / 2,
+                           region.offset.y / 2,
+                           std::max(1u, region.extent.width / 2),
+                           std::max(1u, region.extent.height / 2)),
+              VkImageSubresourceLayers{VK_IMAGE_ASPECT_PLANE_1_BIT, currentMipLevel, layer, 1}),
+      };
 #if IGL_VULKAN_PRINT_COMMANDS
-    IGL_LOG_INFO("%p vkCmdCopyBufferToImage()\n", wrapper.cmdBuf_);
+      IGL_LOG_INFO("%p vkCmdCopyBufferToImage()\n", cmdBuf);
 #endif // IGL_VULKAN_PRINT_COMMANDS
-    vkCmdCopyBufferToImage(wrapper.cmdBuf_,
-                           stagingBuffer_->getVkBuffer(),
-                           image.getVkImage(),
-                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                           1,
-                           &copy);
+      vkCmdCopyBufferToImage(cmdBuf,
+                             desc.buffer_->getVkBuffer(),
+                             image.getVkImage(),
+                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             2,
+                             copies);
+    } else {
+      const VkBufferImageCopy copy = ivkGetBufferImageCopy2D(
+          desc.srcOffset_ + mipLevelOffset, // the offset for this level is at the start of all
+                                            // mip levels + the size of all previous mip levels
+                                            // being uploaded
+          region,
+          VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, currentMipLevel, layer, 1});
+#if IGL_VULKAN_PRINT_COMMANDS
+      IGL_LOG_INFO("%p vkCmdCopyBufferToImage()\n", cmdBuf);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+      vkCmdCopyBufferToImage(cmdBuf,
+                             desc.buffer_->getVkBuffer(),
+                             image.getVkImage(),
+                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             1,
+                             &copy);
+    }
 
     // 3. Transition TRANSFER_DST_OPTIMAL into SHADER_READ_ONLY_OPTIMAL
-    ivkImageMemoryBarrier(
-        wrapper.cmdBuf_,
-        image.getVkImage(),
-        VK_ACCESS_TRANSFER_READ_BIT, // VK_ACCESS_TRANSFER_WRITE_BIT,
-        VK_ACCESS_SHADER_READ_BIT,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-        VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, currentMipLevel, 1, layer, 1});
+    releaseImage(image.getVkImage(), subresourceRange);
 
     // Compute the offset for the next level
     mipLevelOffset += mipSizes[mipLevel];
   }
 
-  image.imageLayout_ = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  image.setLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
 
-  VulkanSubmitHandle fenceId = immediate_->submit(wrapper);
-  outstandingFences_[fenceId.handle()] = desc;
+  return endBatch();
 }
 
-void VulkanStagingDevice::imageData3D(VulkanImage& image,
-                                      const VkOffset3D& offset,
-                                      const VkExtent3D& extent,
-                                      TextureFormatProperties properties,
-                                      VkFormat format,
-                                      const void* data) {
+VulkanSubmitHandle VulkanStagingDevice::imageData3D(VulkanImage& image,
+                                                    const VkOffset3D& offset,
+                                                    const VkExtent3D& extent,
+                                                    TextureFormatProperties properties,
+                                                    VkFormat format,
+                                                    const void* data,
+                                                    TextureFormat dataFormat) {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
   IGL_PROFILER_FUNCTION();
   IGL_ASSERT_MSG(image.mipLevels_ == 1, "Can handle only 3D images with exactly 1 mip-level");
   IGL_ASSERT_MSG((offset.x == 0) && (offset.y == 0) && (offset.z == 0),
@@ -274,35 +348,40 @@ void VulkanStagingDevice::imageData3D(VulkanImage& image,
   const uint32_t storageSize =
       static_cast<uint32_t>(properties.getBytesPerRange(range.atMipLevel(0)));
 
-  IGL_ASSERT(storageSize <= stagingBufferSize_);
+  IGL_ASSERT(storageSize <= maxStagingBufferSize_);
 
-  // get next staging buffer free offset
-  MemoryRegionDesc desc = getNextFreeOffset(storageSize);
+  // currently, no support for copying image in multiple smaller chunk sizes
+  const MemoryRegionDesc desc = allocate(storageSize);
 
-  // currently, no support for copying image in multiple smaller chunk sizes.
-  // If we get smaller buffer size than storageSize, we will wait for gpu idle and get bigger chunk.
-  if (desc.alignedSize_ < storageSize) {
-    flushOutstandingFences();
-    desc = getNextFreeOffset(storageSize);
+  if (!IGL_VERIFY(desc.buffer_ && desc.alignedSize_ >= storageSize)) {
+    return {};
   }
 
-  IGL_ASSERT(desc.alignedSize_ >= storageSize);
+  ctx_.getFrameStatisticsTracker().add(FrameStatisticsTracker::UploadedBytes, storageSize);
 
   // 1. Copy the pixel data into the host visible staging buffer
-  stagingBuffer_->bufferSubData(desc.srcOffset_, storageSize, data);
+  writeImageData(desc, storageSize, properties, range, 1, data, dataFormat);
+
+  beginBatch();
 
-  auto& wrapper = immediate_->acquire();
+  const VkImageSubresourceRange subresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
 
   // 1. Transition initial image layout into TRANSFER_DST_OPTIMAL
-  ivkImageMemoryBarrier(wrapper.cmdBuf_,
-                        image.getVkImage(),
-                        0,
-                        VK_ACCESS_TRANSFER_WRITE_BIT,
-                        VK_IMAGE_LAYOUT_UNDEFINED,
-                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                        VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
+  if (image.getLayout(0, 0) != VK_IMAGE_LAYOUT_UNDEFINED) {
+    acquireImage(image.getVkImage(), VK_IMAGE_LAYOUT_UNDEFINED, subresourceRange);
+  } else {
+    ivkImageMemoryBarrier(getCommandBuffer(),
+                          image.getVkImage(),
+                          0,
+                          VK_ACCESS_TRANSFER_WRITE_BIT,
+                          VK_IMAGE_LAYOUT_UNDEFINED,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                          VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          subresourceRange);
+  }
+
+  const VkCommandBuffer cmdBuf = getCommandBuffer();
 
   // 2. Copy the pixel data from the staging buffer into the image
   const VkBufferImageCopy copy =
@@ -310,28 +389,57 @@ void VulkanStagingDevice::imageData3D(VulkanImage& image,
                               offset,
                               extent,
                               VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1});
-  vkCmdCopyBufferToImage(wrapper.cmdBuf_,
-                         stagingBuffer_->getVkBuffer(),
+  vkCmdCopyBufferToImage(cmdBuf,
+                         desc.buffer_->getVkBuffer(),
                          image.getVkImage(),
                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                          1,
                          &copy);
 
   // 3. Transition TRANSFER_DST_OPTIMAL into SHADER_READ_ONLY_OPTIMAL
-  ivkImageMemoryBarrier(wrapper.cmdBuf_,
-                        image.getVkImage(),
-                        VK_ACCESS_TRANSFER_READ_BIT, // VK_ACCESS_TRANSFER_WRITE_BIT,
-                        VK_ACCESS_SHADER_READ_BIT,
-                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                        VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                        VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
+  releaseImage(image.getVkImage(), subresourceRange);
+
+  image.setLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
 
-  image.imageLayout_ = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  return endBatch();
+}
+
+void VulkanStagingDevice::writeImageData(const MemoryRegionDesc& desc,
+                                         uint32_t storageSize,
+                                         const TextureFormatProperties& properties,
+                                         const TextureRangeDesc& range,
+                                         uint32_t numMipLevels,
+                                         const void* data,
+                                         TextureFormat dataFormat) const {
+  if (dataFormat == TextureFormat::Invalid || dataFormat == properties.format) {
+    desc.buffer_->bufferSubData(desc.srcOffset_, storageSize, data);
+    return;
+  }
 
-  VulkanSubmitHandle fenceId = immediate_->submit(wrapper);
-  outstandingFences_[fenceId.handle()] = desc;
+  // converted straight into the mapped memory, without an intermediate copy of the image
+  IGL_ASSERT(canConvertTexels(dataFormat, properties.format));
+  const auto dataProperties = TextureFormatProperties::fromTextureFormat(dataFormat);
+  const auto* src = static_cast<const uint8_t*>(data);
+  uint8_t* dst = desc.buffer_->getMappedPtr() + desc.srcOffset_;
+  for (uint32_t i = 0; i < numMipLevels; ++i) {
+    const TextureRangeDesc mipRange = range.atMipLevel(i);
+    const size_t srcBytesPerRow = dataProperties.getBytesPerRow(mipRange);
+    const size_t dstBytesPerRow = properties.getBytesPerRow(mipRange);
+    const size_t numRows = properties.getRows(mipRange) * mipRange.depth;
+    convertTexels(dataFormat,
+                  src,
+                  srcBytesPerRow,
+                  properties.format,
+                  dst,
+                  dstBytesPerRow,
+                  mipRange.width,
+                  numRows);
+    src += srcBytesPerRow * numRows;
+    dst += dstBytesPerRow * numRows;
+  }
+  if (!desc.buffer_->isCoherentMemory()) {
+    desc.buffer_->flushMappedMemory(desc.srcOffset_, storageSize);
+  }
 }
 
 void VulkanStagingDevice::getImageData2D(VkImage srcImage,
@@ -344,6 +452,7 @@ void VulkanStagingDevice::getImageData2D(VkImage srcImage,
                                          void* data,
                                          uint32_t dataBytesPerRow,
                                          bool flipImageVertical) {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
   IGL_PROFILER_FUNCTION();
   IGL_ASSERT(layout != VK_IMAGE_LAYOUT_UNDEFINED);
 
@@ -351,26 +460,277 @@ void VulkanStagingDevice::getImageData2D(VkImage srcImage,
       TextureRangeDesc::new2D(0, 0, imageRegion.extent.width, imageRegion.extent.height);
   const uint32_t storageSize =
       static_cast<uint32_t>(properties.getBytesPerRange(range.atMipLevel(0)));
-  IGL_ASSERT(storageSize <= stagingBufferSize_);
+  IGL_ASSERT(storageSize <= maxStagingBufferSize_);
 
   IGL_ASSERT(dataBytesPerRow == properties.getBytesPerRow(range.atMipLevel(0)));
 
-  // get next staging buffer free offset
-  MemoryRegionDesc desc = getNextFreeOffset(storageSize);
+  // readbacks run on the graphics queue after all pending uploads
+  submitPendingUploads(*immediate_);
+
+  const MemoryRegionDesc desc = allocate(storageSize);
+
+  if (!IGL_VERIFY(desc.buffer_ && desc.alignedSize_ >= storageSize)) {
+    return;
+  }
+
+  const auto& wrapper = immediate_->acquire();
+
+  // rows of compressed formats are rows of blocks: those are flipped on the CPU
+  const bool flipInCopy = flipImageVertical && !properties.isCompressed();
+  const auto bytesPerRow = static_cast<uint32_t>(properties.getBytesPerRow(range.atMipLevel(0)));
 
-  // If we get smaller buffer size than storageSize, we will wait for gpu idle
-  // and get bigger chunk.
-  if (desc.alignedSize_ < storageSize) {
-    flushOutstandingFences();
-    desc = getNextFreeOffset(storageSize);
+  recordImageReadback(wrapper.cmdBuf_,
+                      srcImage,
+                      level,
+                      layer,
+                      imageRegion,
+                      layout,
+                      desc.buffer_->getVkBuffer(),
+                      desc.srcOffset_,
+                      flipInCopy,
+                      bytesPerRow);
+
+  // the image is back in its layout once the copy is done, so this is the only wait
+  immediate_->wait(submitReadback(wrapper, desc));
+
+  if (!IGL_VERIFY(desc.buffer_->getMappedPtr())) {
+    return;
+  }
+
+  const uint8_t* src = desc.buffer_->getMappedPtr() + desc.srcOffset_;
+  uint8_t* dst = static_cast<uint8_t*>(data);
+
+  if (flipImageVertical && !flipInCopy) {
+    flipBMP(dst, src, imageRegion.extent.height, bytesPerRow);
+  } else {
+    checked_memcpy(dst, storageSize, src, storageSize);
   }
+}
+
+uint64_t VulkanStagingDevice::getImageData2DAsync(VkImage srcImage,
+                                                  const uint32_t level,
+                                                  const uint32_t layer,
+                                                  const VkRect2D& imageRegion,
+                                                  TextureFormatProperties properties,
+                                                  VkImageLayout layout,
+                                                  bool flipImageVertical) {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(layout != VK_IMAGE_LAYOUT_UNDEFINED);
 
-  IGL_ASSERT(desc.alignedSize_ >= storageSize);
+  const auto range =
+      TextureRangeDesc::new2D(0, 0, imageRegion.extent.width, imageRegion.extent.height);
+  const auto storageSize = static_cast<uint32_t>(properties.getBytesPerRange(range));
 
-  auto& wrapper1 = immediate_->acquire();
+  Readback* readback = acquireReadback(storageSize);
+  if (!readback) {
+    return 0;
+  }
 
+  // readbacks run on the graphics queue after all pending uploads
+  submitPendingUploads(*immediate_);
+
+  const auto bytesPerRow = static_cast<uint32_t>(properties.getBytesPerRow(range));
+  const bool flipInCopy = flipImageVertical && !properties.isCompressed();
+
+  const auto& wrapper = immediate_->acquire();
+  recordImageReadback(wrapper.cmdBuf_,
+                      srcImage,
+                      level,
+                      layer,
+                      imageRegion,
+                      layout,
+                      readback->buffer_->getVkBuffer(),
+                      0,
+                      flipInCopy,
+                      bytesPerRow);
+
+  readback->handle_ = immediate_->submit(wrapper);
+  readback->id_ = nextReadbackId_++;
+  readback->size_ = storageSize;
+  readback->height_ = imageRegion.extent.height;
+  readback->bytesPerRow_ = bytesPerRow;
+  readback->flipped_ = flipInCopy;
+
+  return readback->id_;
+}
+
+uint64_t VulkanStagingDevice::getBufferSubDataAsync(VulkanBuffer& buffer,
+                                                    size_t srcOffset,
+                                                    size_t size) {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
+  IGL_PROFILER_FUNCTION();
+
+  Readback* readback = acquireReadback(static_cast<uint32_t>(size));
+  if (!readback) {
+    return 0;
+  }
+
+  // readbacks run on the graphics queue after all pending uploads
+  submitPendingUploads(*immediate_);
+
+  const auto& wrapper = immediate_->acquire();
+  // wait for the previous writes by shaders and transfers; make the copy visible to the host
+  const VkMemoryBarrier srcBarrier = {
+      VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      nullptr,
+      VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_ACCESS_TRANSFER_READ_BIT,
+  };
+  vkCmdPipelineBarrier(wrapper.cmdBuf_,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       0,
+                       1,
+                       &srcBarrier,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr);
+  const VkBufferCopy copy = {srcOffset, 0, size};
+  vkCmdCopyBuffer(
+      wrapper.cmdBuf_, buffer.getVkBuffer(), readback->buffer_->getVkBuffer(), 1, &copy);
+  const VkBufferMemoryBarrier hostBarrier = {
+      VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      nullptr,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_ACCESS_HOST_READ_BIT,
+      VK_QUEUE_FAMILY_IGNORED,
+      VK_QUEUE_FAMILY_IGNORED,
+      readback->buffer_->getVkBuffer(),
+      0,
+      VK_WHOLE_SIZE,
+  };
+  vkCmdPipelineBarrier(wrapper.cmdBuf_,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       1,
+                       &hostBarrier,
+                       0,
+                       nullptr);
+
+  readback->handle_ = immediate_->submit(wrapper);
+  readback->id_ = nextReadbackId_++;
+  readback->size_ = static_cast<uint32_t>(size);
+  readback->height_ = 1;
+  readback->bytesPerRow_ = static_cast<uint32_t>(size);
+  readback->flipped_ = false;
+
+  return readback->id_;
+}
+
+bool VulkanStagingDevice::isReadbackReady(uint64_t readbackId) const {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
+  for (const auto& r : readbacks_) {
+    if (readbackId != 0 && r.id_ == readbackId) {
+      return immediate_->isReady(r.handle_);
+    }
+  }
+  return false;
+}
+
+bool VulkanStagingDevice::collectImageData2D(uint64_t readbackId,
+                                             void* data,
+                                             uint32_t dataBytesPerRow,
+                                             bool flipImageVertical) {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
+  IGL_PROFILER_FUNCTION();
+
+  Readback* readback = findReadback(readbackId);
+  if (!readback) {
+    return false;
+  }
+  // 0 - tightly packed rows
+  IGL_ASSERT(dataBytesPerRow == 0 || dataBytesPerRow == readback->bytesPerRow_);
+  (void)dataBytesPerRow;
+
+  immediate_->wait(readback->handle_);
+
+  const uint8_t* src = readback->buffer_->getMappedPtr();
+  uint8_t* dst = static_cast<uint8_t*>(data);
+
+  // flipping twice restores the original order
+  if (flipImageVertical != readback->flipped_) {
+    flipBMP(dst, src, readback->height_, readback->bytesPerRow_);
+  } else {
+    checked_memcpy(dst, readback->size_, src, readback->size_);
+  }
+
+  readback->id_ = 0;
+  return true;
+}
+
+void VulkanStagingDevice::discardReadback(uint64_t readbackId) {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
+  Readback* readback = findReadback(readbackId);
+  if (readback) {
+    // acquireReadback() waits for the copy before the buffer is reused
+    readback->id_ = 0;
+  }
+}
+
+VulkanStagingDevice::Readback* VulkanStagingDevice::acquireReadback(uint32_t size) {
+  if (readbacks_.empty()) {
+    readbacks_.resize(std::max(ctx_.config_.maxAsyncReadbacks, 1u));
+  }
+
+  // reuse a free buffer, or drop the oldest readback
+  Readback* readback = &readbacks_[0];
+  for (auto& r : readbacks_) {
+    if (r.id_ == 0) {
+      readback = &r;
+      break;
+    }
+    if (r.id_ < readback->id_) {
+      readback = &r;
+    }
+  }
+  if (readback->id_ != 0) {
+    IGL_LOG_INFO("VulkanStagingDevice: dropping uncollected readback #%llu\n",
+                 static_cast<unsigned long long>(readback->id_));
+    readback->id_ = 0;
+  }
+  // a dropped or discarded readback may still be written by the GPU
+  immediate_->wait(readback->handle_);
+
+  if (!readback->buffer_ || readback->buffer_->getSize() < size) {
+    readback->buffer_ = ctx_.createBuffer(size,
+                                          VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                          nullptr,
+                                          "Buffer: staging readback buffer");
+    if (!IGL_VERIFY(readback->buffer_ && readback->buffer_->getMappedPtr())) {
+      readback->buffer_ = nullptr;
+      return nullptr;
+    }
+  }
+  return readback;
+}
+
+VulkanStagingDevice::Readback* VulkanStagingDevice::findReadback(uint64_t readbackId) {
+  for (auto& r : readbacks_) {
+    if (readbackId != 0 && r.id_ == readbackId) {
+      return &r;
+    }
+  }
+  return nullptr;
+}
+
+void VulkanStagingDevice::recordImageReadback(VkCommandBuffer cmdBuf,
+                                              VkImage srcImage,
+                                              uint32_t level,
+                                              uint32_t layer,
+                                              const VkRect2D& imageRegion,
+                                              VkImageLayout layout,
+                                              VkBuffer dstBuffer,
+                                              VkDeviceSize dstOffset,
+                                              bool flipImageVertical,
+                                              uint32_t bytesPerRow) const {
   // 1. Transition to VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-  ivkImageMemoryBarrier(wrapper1.cmdBuf_,
+  ivkImageMemoryBarrier(cmdBuf,
                         srcImage,
                         0, // srcAccessMask
                         VK_ACCESS_TRANSFER_READ_BIT, // dstAccessMask
@@ -380,41 +740,58 @@ void VulkanStagingDevice::getImageData2D(VkImage srcImage,
                         VK_PIPELINE_STAGE_TRANSFER_BIT, // dstStageMask
                         VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, level, 1, layer, 1});
 
-  // 2.  Copy the pixel data from the image into the staging buffer
-  const VkBufferImageCopy copy =
-      ivkGetBufferImageCopy2D(desc.srcOffset_,
-                              imageRegion,
-                              VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, level, layer, 1});
-  vkCmdCopyImageToBuffer(wrapper1.cmdBuf_,
-                         srcImage,
-                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                         stagingBuffer_->getVkBuffer(),
-                         1,
-                         &copy);
-
-  VulkanSubmitHandle fenceId = immediate_->submit(wrapper1);
-  outstandingFences_[fenceId.handle()] = desc;
-
-  flushOutstandingFences();
-
-  // 3. Copy data from staging buffer into data
-  if (!IGL_VERIFY(stagingBuffer_->getMappedPtr())) {
-    return;
-  }
-
-  const uint8_t* src = stagingBuffer_->getMappedPtr() + desc.srcOffset_;
-  uint8_t* dst = static_cast<uint8_t*>(data);
-
+  // 2. Copy the pixel data from the image into the buffer
+  const VkImageSubresourceLayers subresource{VK_IMAGE_ASPECT_COLOR_BIT, level, layer, 1};
   if (flipImageVertical) {
-    flipBMP(dst, src, imageRegion.extent.height, properties.getBytesPerRow(range.atMipLevel(0)));
+    // the copy does the vertical flip, so the host does a single memcpy()
+    const uint32_t height = imageRegion.extent.height;
+    std::vector<VkBufferImageCopy> copies(height);
+    for (uint32_t y = 0; y != height; y++) {
+      const VkRect2D row = {
+          VkOffset2D{imageRegion.offset.x, imageRegion.offset.y + static_cast<int32_t>(y)},
+          VkExtent2D{imageRegion.extent.width, 1},
+      };
+      copies[y] = ivkGetBufferImageCopy2D(
+          static_cast<uint32_t>(dstOffset + VkDeviceSize(height - 1 - y) * bytesPerRow),
+          row,
+          subresource);
+    }
+    vkCmdCopyImageToBuffer(cmdBuf,
+                           srcImage,
+                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           dstBuffer,
+                           static_cast<uint32_t>(copies.size()),
+                           copies.data());
   } else {
-    checked_memcpy(dst, storageSize, src, storageSize);
+    const VkBufferImageCopy copy =
+        ivkGetBufferImageCopy2D(static_cast<uint32_t>(dstOffset), imageRegion, subresource);
+    vkCmdCopyImageToBuffer(
+        cmdBuf, srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dstBuffer, 1, &copy);
   }
 
-  // 4. Transition back to the initial image layout
-  auto& wrapper2 = immediate_->acquire();
-
-  ivkImageMemoryBarrier(wrapper2.cmdBuf_,
+  // 3. Make the copy visible to the host and transition back to the initial image layout
+  const VkBufferMemoryBarrier hostBarrier = {
+      VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      nullptr,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_ACCESS_HOST_READ_BIT,
+      VK_QUEUE_FAMILY_IGNORED,
+      VK_QUEUE_FAMILY_IGNORED,
+      dstBuffer,
+      dstOffset,
+      VK_WHOLE_SIZE,
+  };
+  vkCmdPipelineBarrier(cmdBuf,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       1,
+                       &hostBarrier,
+                       0,
+                       nullptr);
+  ivkImageMemoryBarrier(cmdBuf,
                         srcImage,
                         VK_ACCESS_TRANSFER_READ_BIT, // srcAccessMask
                         0, // dstAccessMask
@@ -423,84 +800,593 @@ void VulkanStagingDevice::getImageData2D(VkImage srcImage,
                         VK_PIPELINE_STAGE_TRANSFER_BIT, // srcStageMask
                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // dstStageMask
                         VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, level, 1, layer, 1});
+}
 
-  fenceId = immediate_->submit(wrapper2);
-  outstandingFences_[fenceId.handle()] = desc;
-  // the data should be available as we get out of this function
-  immediate_->wait(fenceId);
+void VulkanStagingDevice::beginBatch() {
+  // held until the matching endBatch(), so uploads of other threads do not end up in this batch
+  mutex_.lock();
+  batchDepth_++;
+}
+
+VulkanSubmitHandle VulkanStagingDevice::endBatch() {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
+  IGL_ASSERT_MSG(batchDepth_ > 0, "endBatch() without beginBatch()");
+
+  if (batchDepth_ == 0) {
+    return {};
+  }
+  // the lock taken by beginBatch(); `lock` keeps the mutex until this returns
+  mutex_.unlock();
+  if (--batchDepth_ > 0) {
+    return {};
+  }
+
+  return submit();
+}
+
+VulkanSubmitHandle VulkanStagingDevice::flush() {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (!wrapper_) {
+    return getUploadCommands().getLastSubmitHandle();
+  }
+  return submit();
+}
+
+void VulkanStagingDevice::submitPendingUploads(VulkanImmediateCommands& consumer) {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
+  IGL_PROFILER_FUNCTION();
+
+  flush();
+
+  if (!transferImmediate_) {
+    // uploads were submitted to the same queue as the consumer, nothing to hand over
+    return;
+  }
+
+  // the last transfer submit waits for all previous ones, so a single semaphore covers everything
+  const VkSemaphore semaphore = transferImmediate_->acquireLastSubmitSemaphore();
+
+  if (semaphore == VK_NULL_HANDLE) {
+    IGL_ASSERT(bufferAcquireBarriers_.empty() && imageAcquireBarriers_.empty());
+    return;
+  }
+
+  // acquire the ownership of all uploaded resources on the consumer's queue family
+  const auto& wrapper = consumer.acquire();
+
+  if (!bufferAcquireBarriers_.empty() || !imageAcquireBarriers_.empty()) {
+    vkCmdPipelineBarrier(wrapper.cmdBuf_,
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         static_cast<uint32_t>(bufferAcquireBarriers_.size()),
+                         bufferAcquireBarriers_.data(),
+                         static_cast<uint32_t>(imageAcquireBarriers_.size()),
+                         imageAcquireBarriers_.data());
+    bufferAcquireBarriers_.clear();
+    imageAcquireBarriers_.clear();
+  }
+  numSubmittedBufferAcquires_ = 0;
+  numSubmittedImageAcquires_ = 0;
+
+  consumer.waitSemaphore(semaphore);
+  consumer.submit(wrapper);
+}
+
+bool VulkanStagingDevice::isReady(VulkanSubmitHandle handle) const {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
+  return getUploadCommands().isReady(handle);
+}
+
+void VulkanStagingDevice::wait(VulkanSubmitHandle handle) {
+  const std::lock_guard<std::recursive_mutex> lock(mutex_);
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
+
+  getUploadCommands().wait(handle);
+}
+
+VulkanImmediateCommands& VulkanStagingDevice::getUploadCommands() const {
+  return transferImmediate_ ? *transferImmediate_ : *immediate_;
+}
+
+VkCommandBuffer VulkanStagingDevice::getCommandBuffer() {
+  if (!wrapper_) {
+    wrapper_ = &getUploadCommands().acquire();
+  }
+  return wrapper_->cmdBuf_;
+}
+
+void VulkanStagingDevice::acquireBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size) {
+  if (!transferImmediate_ || !ctx_.concurrentQueueFamilyIndices_.empty()) {
+    // the copy waits for the earlier work of the queue; on the transfer queue, the semaphore
+    // covers the graphics work
+    const VkBufferMemoryBarrier barrier = {
+        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        nullptr,
+        VK_ACCESS_MEMORY_WRITE_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        buffer,
+        offset,
+        size,
+    };
+    vkCmdPipelineBarrier(getCommandBuffer(),
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         1,
+                         &barrier,
+                         0,
+                         nullptr);
+    waitForGraphicsQueue_ = transferImmediate_ != nullptr;
+    return;
+  }
+
+  if (isReleasedByRecordedCommands(buffer, offset, size)) {
+    // the graphics queue has to acquire the buffer before it can release it again
+    submit();
+  }
+
+  const VkBufferMemoryBarrier release = {
+      VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      nullptr,
+      VK_ACCESS_MEMORY_WRITE_BIT,
+      0, // ignored for a release operation
+      ctx_.deviceQueues_.graphicsQueueFamilyIndex,
+      ctx_.deviceQueues_.transferQueueFamilyIndex,
+      buffer,
+      offset,
+      size,
+  };
+  bufferReleaseBarriers_.push_back(release);
+
+  VkBufferMemoryBarrier acquire = release;
+  acquire.srcAccessMask = 0; // ignored for an acquire operation
+  acquire.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+  vkCmdPipelineBarrier(getCommandBuffer(),
+                       VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       1,
+                       &acquire,
+                       0,
+                       nullptr);
+  waitForGraphicsQueue_ = true;
+}
+
+void VulkanStagingDevice::acquireImage(VkImage image,
+                                       VkImageLayout oldLayout,
+                                       const VkImageSubresourceRange& range) {
+  if (!transferImmediate_ || !ctx_.concurrentQueueFamilyIndices_.empty()) {
+    // no ownership transfer: the layout transition is a plain barrier
+    ivkImageMemoryBarrier(getCommandBuffer(),
+                          image,
+                          VK_ACCESS_MEMORY_WRITE_BIT,
+                          VK_ACCESS_TRANSFER_WRITE_BIT,
+                          oldLayout,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                          VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          range);
+    waitForGraphicsQueue_ = transferImmediate_ != nullptr;
+    return;
+  }
+
+  if (isReleasedByRecordedCommands(image, range)) {
+    // the graphics queue has to acquire the image before it can release it again
+    submit();
+  }
+
+  // the layout transition is a part of the queue family ownership transfer
+  const VkImageMemoryBarrier release = {
+      VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      nullptr,
+      VK_ACCESS_MEMORY_WRITE_BIT,
+      0, // ignored for a release operation
+      oldLayout,
+      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+      ctx_.deviceQueues_.graphicsQueueFamilyIndex,
+      ctx_.deviceQueues_.transferQueueFamilyIndex,
+      image,
+      range,
+  };
+  imageReleaseBarriers_.push_back(release);
+
+  VkImageMemoryBarrier acquire = release;
+  acquire.srcAccessMask = 0; // ignored for an acquire operation
+  acquire.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+  vkCmdPipelineBarrier(getCommandBuffer(),
+                       VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       1,
+                       &acquire);
+  waitForGraphicsQueue_ = true;
+}
+
+bool VulkanStagingDevice::isReleasedByRecordedCommands(VkBuffer buffer,
+                                                       VkDeviceSize offset,
+                                                       VkDeviceSize size) const {
+  return std::any_of(bufferAcquireBarriers_.begin() + numSubmittedBufferAcquires_,
+                     bufferAcquireBarriers_.end(),
+                     [=](const VkBufferMemoryBarrier& barrier) {
+                       return barrier.buffer == buffer && barrier.offset < offset + size &&
+                              offset < barrier.offset + barrier.size;
+                     });
+}
+
+bool VulkanStagingDevice::isReleasedByRecordedCommands(VkImage image,
+                                                       const VkImageSubresourceRange& range) const {
+  return std::any_of(imageAcquireBarriers_.begin() + numSubmittedImageAcquires_,
+                     imageAcquireBarriers_.end(),
+                     [&](const VkImageMemoryBarrier& barrier) {
+                       return barrier.image == image &&
+                              barrier.subresourceRange.baseMipLevel == range.baseMipLevel &&
+                              barrier.subresourceRange.baseArrayLayer == range.baseArrayLayer;
+                     });
+}
+
+void VulkanStagingDevice::releaseFromGraphicsQueue() {
+  IGL_PROFILER_FUNCTION();
+  IGL_ASSERT(transferImmediate_);
+
+  waitForGraphicsQueue_ = false;
+
+  // graphics command buffers submitted by the context go first
+  ctx_.immediate_->flush();
+
+  const auto& wrapper = immediate_->acquire();
+
+  // the resources of submitted uploads are acquired first, so that they can be released again
+  const VkSemaphore uploadSemaphore = transferImmediate_->acquireLastSubmitSemaphore();
+  if (uploadSemaphore != VK_NULL_HANDLE) {
+    if (numSubmittedBufferAcquires_ || numSubmittedImageAcquires_) {
+      vkCmdPipelineBarrier(wrapper.cmdBuf_,
+                           VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                           VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                           0,
+                           0,
+                           nullptr,
+                           static_cast<uint32_t>(numSubmittedBufferAcquires_),
+                           bufferAcquireBarriers_.data(),
+                           static_cast<uint32_t>(numSubmittedImageAcquires_),
+                           imageAcquireBarriers_.data());
+      bufferAcquireBarriers_.erase(bufferAcquireBarriers_.begin(),
+                                   bufferAcquireBarriers_.begin() + numSubmittedBufferAcquires_);
+      imageAcquireBarriers_.erase(imageAcquireBarriers_.begin(),
+                                  imageAcquireBarriers_.begin() + numSubmittedImageAcquires_);
+      numSubmittedBufferAcquires_ = 0;
+      numSubmittedImageAcquires_ = 0;
+    }
+    immediate_->waitSemaphore(uploadSemaphore);
+  }
+  IGL_ASSERT(numSubmittedBufferAcquires_ == 0 && numSubmittedImageAcquires_ == 0);
+
+  if (!bufferReleaseBarriers_.empty() || !imageReleaseBarriers_.empty()) {
+    vkCmdPipelineBarrier(wrapper.cmdBuf_,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         static_cast<uint32_t>(bufferReleaseBarriers_.size()),
+                         bufferReleaseBarriers_.data(),
+                         static_cast<uint32_t>(imageReleaseBarriers_.size()),
+                         imageReleaseBarriers_.data());
+    bufferReleaseBarriers_.clear();
+    imageReleaseBarriers_.clear();
+  }
+
+  // the semaphore signaled by this submit waits for all graphics work submitted before it
+  immediate_->submit(wrapper);
+  transferImmediate_->waitSemaphore(immediate_->acquireLastSubmitSemaphore());
+}
+
+void VulkanStagingDevice::releaseBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size) {
+  // resources shared concurrently by all queue families need no ownership transfers: the
+  // semaphore waited on by the consumer makes the writes visible
+  if (!transferImmediate_ || !ctx_.concurrentQueueFamilyIndices_.empty()) {
+    return;
+  }
+
+  const VkBufferMemoryBarrier release = {
+      VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      nullptr,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      0, // ignored for a release operation
+      ctx_.deviceQueues_.transferQueueFamilyIndex,
+      ctx_.deviceQueues_.graphicsQueueFamilyIndex,
+      buffer,
+      offset,
+      size,
+  };
+
+  vkCmdPipelineBarrier(getCommandBuffer(),
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       1,
+                       &release,
+                       0,
+                       nullptr);
+
+  VkBufferMemoryBarrier acquire = release;
+  acquire.srcAccessMask = 0; // ignored for an acquire operation
+  acquire.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+  bufferAcquireBarriers_.push_back(acquire);
+}
+
+void VulkanStagingDevice::releaseImage(VkImage image, const VkImageSubresourceRange& range) {
+  if (!transferImmediate_ || !ctx_.concurrentQueueFamilyIndices_.empty()) {
+    // no ownership transfer: the layout transition is a plain barrier
+    ivkImageMemoryBarrier(getCommandBuffer(),
+                          image,
+                          VK_ACCESS_TRANSFER_READ_BIT, // VK_ACCESS_TRANSFER_WRITE_BIT,
+                          VK_ACCESS_SHADER_READ_BIT,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                          VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                          range);
+    return;
+  }
+
+  // the layout transition is a part of the queue family ownership transfer and has to be
+  // specified identically in both the release and the acquire barriers
+  const VkImageMemoryBarrier release = {
+      VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      nullptr,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      0, // ignored for a release operation
+      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+      ctx_.deviceQueues_.transferQueueFamilyIndex,
+      ctx_.deviceQueues_.graphicsQueueFamilyIndex,
+      image,
+      range,
+  };
+
+  vkCmdPipelineBarrier(getCommandBuffer(),
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       1,
+                       &release);
+
+  VkImageMemoryBarrier acquire = release;
+  acquire.srcAccessMask = 0; // ignored for an acquire operation
+  acquire.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  imageAcquireBarriers_.push_back(acquire);
+}
+
+VulkanSubmitHandle VulkanStagingDevice::submitReadback(
+    const VulkanImmediateCommands::CommandBufferWrapper& wrapper,
+    const MemoryRegionDesc& desc) {
+  const VulkanSubmitHandle handle = immediate_->submit(wrapper);
+
+  // the readback region is the newest one in its chunk
+  Region& region = chunks_[desc.chunkIndex_].inFlight_.back();
+  IGL_ASSERT(region.offset_ == desc.srcOffset_ && region.handle_.empty());
+  region.handle_ = handle;
+  region.commands_ = immediate_.get();
+
+  return handle;
+}
+
+VulkanSubmitHandle VulkanStagingDevice::submit() {
+  IGL_PROFILER_FUNCTION();
+
+  if (!wrapper_) {
+    return {};
+  }
+
+  VulkanImmediateCommands& commands = getUploadCommands();
+
+  if (waitForGraphicsQueue_) {
+    releaseFromGraphicsQueue();
+  }
+
+  const VulkanSubmitHandle handle = commands.submit(*wrapper_);
+  wrapper_ = nullptr;
+  numSubmittedBufferAcquires_ = bufferAcquireBarriers_.size();
+  numSubmittedImageAcquires_ = imageAcquireBarriers_.size();
+
+  // regions which were waiting for this submit are always at the back of each ring
+  for (auto& chunk : chunks_) {
+    for (auto it = chunk.inFlight_.rbegin(); it != chunk.inFlight_.rend() && it->handle_.empty();
+         ++it) {
+      it->handle_ = handle;
+      it->commands_ = &commands;
+    }
+  }
+
+  return handle;
 }
 
 uint32_t VulkanStagingDevice::getAlignedSize(uint32_t size) const {
   return (size + stagingBufferAlignment_ - 1) & ~(stagingBufferAlignment_ - 1);
 }
 
-VulkanStagingDevice::MemoryRegionDesc VulkanStagingDevice::getNextFreeOffset(uint32_t size) {
+VulkanStagingDevice::MemoryRegionDesc VulkanStagingDevice::allocate(uint32_t size) {
   IGL_PROFILER_FUNCTION();
-  uint32_t alignedSize = getAlignedSize(size);
 
-  // track maximum previously used region
-  MemoryRegionDesc maxRegionDesc;
-  VulkanSubmitHandle maxRegionFence = VulkanSubmitHandle();
+  const uint32_t alignedSize = getAlignedSize(size);
 
-  // check if we can reuse any of previously used memory region
-  for (auto [handle, desc] : outstandingFences_) {
-    if (immediate_->isReady(VulkanSubmitHandle(handle))) {
-      if (desc.alignedSize_ >= alignedSize) {
-        outstandingFences_.erase(handle);
-#if IGL_VULKAN_DEBUG_STAGING_DEVICE
-        IGL_LOG_INFO("Reusing memory region %u bytes\n", desc.alignedSize_);
-#endif
-        return desc;
-      }
+  IGL_ASSERT_MSG(alignedSize <= maxStagingBufferSize_,
+                 "The upload does not fit into the staging buffer budget");
 
-      if (maxRegionDesc.alignedSize_ < desc.alignedSize_) {
-        maxRegionDesc = desc;
-        maxRegionFence = VulkanSubmitHandle(handle);
+  while (true) {
+    retireRegions();
+
+    for (uint32_t i = 0; i != chunks_.size(); i++) {
+      Chunk& chunk = chunks_[i];
+      uint32_t offset = 0;
+      if (allocateFromChunk(chunk, alignedSize, offset)) {
+        chunk.inFlight_.push_back({offset, alignedSize});
+        return {chunk.buffer_.get(), i, offset, alignedSize};
       }
     }
+
+    if (growOrCompact(alignedSize)) {
+      continue;
+    }
+
+    // the whole budget is in flight: make sure everything recorded so far is submitted and wait
+    // for the oldest region to become available
+    submit();
+
+    if (!IGL_VERIFY(std::any_of(chunks_.begin(), chunks_.end(), [](const Chunk& chunk) {
+          return !chunk.inFlight_.empty();
+        }))) {
+      // nothing to wait for - the request can never be satisfied
+      return {};
+    }
+
+    waitForOldestRegion();
   }
+}
 
-  if (!maxRegionFence.empty() && bufferCapacity_ < maxRegionDesc.alignedSize_) {
-    outstandingFences_.erase(maxRegionFence.handle());
-#if IGL_VULKAN_DEBUG_STAGING_DEVICE
-    IGL_LOG_INFO("Reusing memory region %u bytes\n", maxRegionDesc.alignedSize_);
-#endif
-    return maxRegionDesc;
+bool VulkanStagingDevice::allocateFromChunk(Chunk& chunk,
+                                            uint32_t alignedSize,
+                                            uint32_t& outOffset) const {
+  if (chunk.inFlight_.empty()) {
+    chunk.head_ = 0;
+  }
+
+  if (alignedSize > chunk.size_) {
+    return false;
+  }
+
+  if (chunk.inFlight_.empty()) {
+    outOffset = 0;
+    chunk.head_ = alignedSize;
+    return true;
+  }
+
+  // the oldest region in flight; free space is [head, tail) modulo the chunk size
+  const uint32_t tail = chunk.inFlight_.front().offset_;
+
+  if (chunk.head_ > tail) {
+    // [tail, head) is used; try the end of the chunk first...
+    if (chunk.size_ - chunk.head_ >= alignedSize) {
+      outOffset = chunk.head_;
+      chunk.head_ += alignedSize;
+      return true;
+    }
+    // ...then wrap around to the beginning (the head should never catch up with the tail)
+    if (alignedSize < tail) {
+      // the newest region absorbs the unused space at the end, so it is retired together with it
+      Region& last = chunk.inFlight_.back();
+      last.size_ = chunk.size_ - last.offset_;
+      outOffset = 0;
+      chunk.head_ = alignedSize;
+      return true;
+    }
+    return false;
   }
 
-  if (bufferCapacity_ == 0) {
-    // no more space available in the staging buffer
-    flushOutstandingFences();
+  // wrapped around: [head, tail) is free
+  if (tail - chunk.head_ > alignedSize) {
+    outOffset = chunk.head_;
+    chunk.head_ += alignedSize;
+    return true;
   }
 
-  // allocate from free staging memory
-  alignedSize = (alignedSize <= bufferCapacity_) ? alignedSize : bufferCapacity_;
-  const uint32_t srcOffset = stagingBufferFrontOffset_;
-  stagingBufferFrontOffset_ = (stagingBufferFrontOffset_ + alignedSize) % stagingBufferSize_;
-  bufferCapacity_ -= alignedSize;
+  return false;
+}
+
+bool VulkanStagingDevice::growOrCompact(uint32_t alignedSize) {
+  const uint32_t newChunkSize = std::max(chunkSize_, alignedSize);
+
+  if (allocatedSize_ + newChunkSize > maxStagingBufferSize_) {
+    // the budget is exhausted; idle chunks which cannot fit this request are released to make room
+    // for a larger one
+    const auto it = std::find_if(chunks_.begin(), chunks_.end(), [alignedSize](const Chunk& c) {
+      return c.inFlight_.empty() && c.size_ < alignedSize;
+    });
+    if (it == chunks_.end()) {
+      return false;
+    }
+    allocatedSize_ -= it->size_;
+    chunks_.erase(it);
+    return true;
+  }
 
 #if IGL_VULKAN_DEBUG_STAGING_DEVICE
-  IGL_LOG_INFO("Allocating new memory region: %u bytes\n", alignedSize);
+  IGL_LOG_INFO("Allocating new staging chunk: %u bytes\n", newChunkSize);
 #endif
 
-  return {srcOffset, alignedSize};
+  Chunk chunk;
+  chunk.buffer_ =
+      ctx_.createBuffer(newChunkSize,
+                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                        nullptr,
+                        IGL_FORMAT("Buffer: staging buffer #{}", chunks_.size()).c_str());
+  if (!IGL_VERIFY(chunk.buffer_.get())) {
+    return false;
+  }
+  chunk.size_ = newChunkSize;
+  allocatedSize_ += newChunkSize;
+  chunks_.push_back(std::move(chunk));
+
+  return true;
 }
 
-void VulkanStagingDevice::flushOutstandingFences() {
+void VulkanStagingDevice::retireRegions() {
+  for (auto& chunk : chunks_) {
+    // regions are retired strictly in submission order, which keeps each chunk a ring
+    while (!chunk.inFlight_.empty()) {
+      const Region& region = chunk.inFlight_.front();
+      if (region.handle_.empty() || !region.commands_->isReady(region.handle_)) {
+        break;
+      }
+      chunk.inFlight_.pop_front();
+    }
+  }
+}
+
+void VulkanStagingDevice::waitForOldestRegion() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
 
 #if IGL_VULKAN_DEBUG_STAGING_DEVICE
-  IGL_LOG_INFO("StagingDevice - Wait for Idle\n");
+  IGL_LOG_INFO("StagingDevice - Waiting for the oldest region\n");
 #endif
-  std::for_each(outstandingFences_.begin(),
-                outstandingFences_.end(),
-                [this](std::pair<uint64_t, MemoryRegionDesc> const& pair) {
-                  immediate_->wait(VulkanSubmitHandle(pair.first));
-                });
-
-  outstandingFences_.clear();
-  stagingBufferFrontOffset_ = 0;
-  bufferCapacity_ = stagingBufferSize_;
+
+  const Region* oldest = nullptr;
+  for (const auto& chunk : chunks_) {
+    if (chunk.inFlight_.empty()) {
+      continue;
+    }
+    const Region& region = chunk.inFlight_.front();
+    if (!oldest || (region.commands_ == oldest->commands_ &&
+                    region.handle_.submitId_ < oldest->handle_.submitId_)) {
+      oldest = &region;
+    }
+  }
+
+  if (oldest && oldest->commands_) {
+    oldest->commands_->wait(oldest->handle_);
+  }
 }
 
 } // namespace vulkan
@@ -7,12 +7,14 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
 #include <vector>
 
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanHelpers.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
 
 namespace igl {
 namespace vulkan {
@@ -20,32 +22,66 @@ namespace vulkan {
 class VulkanBuffer;
 class VulkanContext;
 class VulkanImage;
-class VulkanImmediateCommands;
 
+/**
+ * @brief Uploads and reads back data via host-visible staging memory.
+ *
+ * Staging memory is a set of chunks allocated on demand up to a total budget. Each chunk is used as
+ * a ring buffer: regions are retired in submission order once the GPU has finished with them, so
+ * uploads do not wait on the GPU unless the whole budget is in flight.
+ *
+ * Every upload returns a submit handle which can be polled with isReady() or waited on with wait().
+ * Uploads issued between beginBatch() and endBatch() are recorded into a single command buffer; in
+ * that case the upload functions return an empty handle and endBatch() returns the handle covering
+ * all of them. Pending batches are submitted before any command buffer of the context is submitted.
+ *
+ * If the context has a dedicated transfer queue, uploads are submitted there and handed over to the
+ * graphics queue (a semaphore wait plus queue family ownership transfers) in submitPendingUploads().
+ * Resources which the GPU may already be using (re-uploads) are released by the graphics queue
+ * first, and the transfer submit waits for all graphics work submitted before it.
+ *
+ * getImageData2D() waits for the GPU. getImageData2DAsync() and getBufferSubDataAsync() only
+ * submit the copy into one of a ring of host-visible readback buffers, so several readbacks can be
+ * in flight while the GPU keeps rendering; the data is copied out later by collectImageData2D(). *
+ * All methods are thread-safe, so resources can be created and uploaded on loader threads. A batch
+ * holds the lock from beginBatch() to endBatch(): uploads of other threads wait for it to end.
+ */
 class VulkanStagingDevice final {
  public:
+  using SubmitHandle = VulkanImmediateCommands::SubmitHandle;
+
   explicit VulkanStagingDevice(VulkanContext& ctx);
-  ~VulkanStagingDevice() = default;
+  ~VulkanStagingDevice();
 
   VulkanStagingDevice(const VulkanStagingDevice&) = delete;
   VulkanStagingDevice& operator=(const VulkanStagingDevice&) = delete;
 
-  void bufferSubData(VulkanBuffer& buffer, size_t dstOffset, size_t size, const void* data);
+  // `isInitialData` - the data the buffer is created with: the GPU cannot be using the buffer yet,
+  // so the upload does not wait for the graphics queue
+  SubmitHandle bufferSubData(VulkanBuffer& buffer,
+                             size_t dstOffset,
+                             size_t size,
+                             const void* data,
+                             bool isInitialData = false);
   void getBufferSubData(VulkanBuffer& buffer, size_t srcOffset, size_t size, void* data);
-  void imageData2D(VulkanImage& image,
-                   const VkRect2D& imageRegion,
-                   uint32_t baseMipLevel,
-                   uint32_t numMipLevels,
-                   uint32_t layer,
-                   TextureFormatProperties properties,
-                   VkFormat format,
-                   const void* data);
-  void imageData3D(VulkanImage& image,
-                   const VkOffset3D& offset,
-                   const VkExtent3D& extent,
-                   TextureFormatProperties properties,
-                   VkFormat format,
-                   const void* data);
+  // `properties` describe the format of the image. When `dataFormat` is another format, `data` is
+  // converted with igl::convertTexels() while it is written into the staging buffer.
+  SubmitHandle imageData2D(VulkanImage& image,
+                           const VkRect2D& imageRegion,
+                           uint32_t baseMipLevel,
+                           uint32_t numMipLevels,
+                           uint32_t layer,
+                           TextureFormatProperties properties,
+                           VkFormat format,
+                           const void* data,
+                           TextureFormat dataFormat = TextureFormat::Invalid);
+  SubmitHandle imageData3D(VulkanImage& image,
+                           const VkOffset3D& offset,
+                           const VkExtent3D& extent,
+                           TextureFormatProperties properties,
+                           VkFormat format,
+                           const void* data,
+                           TextureFormat dataFormat = TextureFormat::Invalid);
   void getImageData2D(VkImage srcImage,
                       const uint32_t level,
                       const uint32_t layer,
@@ -56,26 +92,159 @@ class VulkanStagingDevice final {
                       void* data,
                       uint32_t dataBytesPerRow,
                       bool flipImageVertical);
+  // Returns the ID of the readback (0 on failure). If all readback buffers hold uncollected data,
+  // the oldest readback is dropped. `flipImageVertical` should match the value passed to
+  // collectImageData2D(), so that the rows are flipped by the GPU copy.
+  uint64_t getImageData2DAsync(VkImage srcImage,
+                               const uint32_t level,
+                               const uint32_t layer,
+                               const VkRect2D& imageRegion,
+                               TextureFormatProperties properties,
+                               VkImageLayout layout,
+                               bool flipImageVertical);
+  // Returns the ID of the readback (0 on failure); collected as one row of `size` bytes
+  uint64_t getBufferSubDataAsync(VulkanBuffer& buffer, size_t srcOffset, size_t size);
+  // true once the GPU has executed the readback, so collecting it does not wait
+  bool isReadbackReady(uint64_t readbackId) const;
+  // frees the buffer of a readback which is not going to be collected
+  void discardReadback(uint64_t readbackId);
+  // Waits for the readback, copies its data and frees its buffer. Returns false if the readback is
+  // unknown (already collected or dropped). `dataBytesPerRow` is 0 or the readback's row size.
+  bool collectImageData2D(uint64_t readbackId,
+                          void* data,
+                          uint32_t dataBytesPerRow,
+                          bool flipImageVertical);
+
+  // batches can be nested; only the outermost endBatch() submits
+  void beginBatch();
+  SubmitHandle endBatch();
+  // submits all recorded but not yet submitted uploads
+  SubmitHandle flush();
+  // Submits all pending uploads and makes `consumer` (a graphics queue) wait for them. When a
+  // dedicated transfer queue is used, this also acquires the ownership of the uploaded resources.
+  // Call before submitting any command buffer which may use the uploaded data.
+  void submitPendingUploads(VulkanImmediateCommands& consumer);
+
+  bool isReady(SubmitHandle handle) const;
+  void wait(SubmitHandle handle);
+
+  // the amount of staging memory currently allocated
+  size_t getAllocatedSize() const {
+    const std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return allocatedSize_;
+  }
 
  private:
+  struct Region {
+    uint32_t offset_ = 0;
+    uint32_t size_ = 0;
+    SubmitHandle handle_ = {}; // empty until the command buffer using this region is submitted
+    VulkanImmediateCommands* commands_ = nullptr; // the queue `handle_` belongs to
+  };
+
+  struct Chunk {
+    std::shared_ptr<VulkanBuffer> buffer_;
+    uint32_t size_ = 0;
+    uint32_t head_ = 0; // the next allocation starts here
+    std::deque<Region> inFlight_; // sorted by submission order
+  };
+
+  struct Readback {
+    std::shared_ptr<VulkanBuffer> buffer_;
+    uint64_t id_ = 0; // 0 - the buffer holds no data
+    SubmitHandle handle_ = {};
+    uint32_t size_ = 0;
+    uint32_t height_ = 0;
+    uint32_t bytesPerRow_ = 0;
+    bool flipped_ = false; // the rows were copied bottom-up
+  };
+
   struct MemoryRegionDesc {
+    VulkanBuffer* buffer_ = nullptr;
+    uint32_t chunkIndex_ = 0;
     uint32_t srcOffset_ = 0;
     uint32_t alignedSize_ = 0;
   };
 
   uint32_t getAlignedSize(uint32_t size) const;
-  MemoryRegionDesc getNextFreeOffset(uint32_t size);
-  void flushOutstandingFences();
+  MemoryRegionDesc allocate(uint32_t size);
+  // Writes `numMipLevels` levels of `range`, one after another, into `desc`
+  void writeImageData(const MemoryRegionDesc& desc,
+                      uint32_t storageSize,
+                      const TextureFormatProperties& properties,
+                      const TextureRangeDesc& range,
+                      uint32_t numMipLevels,
+                      const void* data,
+                      TextureFormat dataFormat) const;
+  bool allocateFromChunk(Chunk& chunk, uint32_t alignedSize, uint32_t& outOffset) const;
+  bool growOrCompact(uint32_t alignedSize);
+  void retireRegions();
+  void waitForOldestRegion();
+  VulkanImmediateCommands& getUploadCommands() const;
+  VkCommandBuffer getCommandBuffer();
+  SubmitHandle submit();
+  SubmitHandle submitReadback(const VulkanImmediateCommands::CommandBufferWrapper& wrapper,
+                              const MemoryRegionDesc& desc);
+  // Copies the image region into `dstBuffer` and transitions the image back to `layout`. With
+  // `flipImageVertical`, every row of `bytesPerRow` bytes is copied by its own region, bottom-up.
+  void recordImageReadback(VkCommandBuffer cmdBuf,
+                           VkImage srcImage,
+                           uint32_t level,
+                           uint32_t layer,
+                           const VkRect2D& imageRegion,
+                           VkImageLayout layout,
+                           VkBuffer dstBuffer,
+                           VkDeviceSize dstOffset,
+                           bool flipImageVertical,
+                           uint32_t bytesPerRow) const;
+  Readback* findReadback(uint64_t readbackId);
+  // returns a free readback buffer of at least `size` bytes, dropping the oldest readback if needed
+  Readback* acquireReadback(uint32_t size);
+  // transition a resource which the GPU may be using for an upload (images into
+  // TRANSFER_DST_OPTIMAL)
+  void acquireBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size);
+  void acquireImage(VkImage image, VkImageLayout oldLayout, const VkImageSubresourceRange& range);
+  // transition an uploaded resource for use on the graphics queue
+  void releaseBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size);
+  void releaseImage(VkImage image, const VkImageSubresourceRange& range);
+  // true if the commands recorded into `wrapper_` release the resource to the graphics queue
+  bool isReleasedByRecordedCommands(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size) const;
+  bool isReleasedByRecordedCommands(VkImage image, const VkImageSubresourceRange& range) const;
+  // submits the pending releases to the transfer queue on the graphics queue and makes the next
+  // transfer submit wait for it
+  void releaseFromGraphicsQueue();
 
  private:
   VulkanContext& ctx_;
-  std::shared_ptr<VulkanBuffer> stagingBuffer_;
+  // guards everything below; recursive because public methods call each other
+  mutable std::recursive_mutex mutex_;
+  // graphics queue: readbacks and, without a dedicated transfer queue, uploads
   std::unique_ptr<VulkanImmediateCommands> immediate_;
-  uint32_t stagingBufferFrontOffset_ = 0;
+  // dedicated transfer queue for uploads (optional)
+  std::unique_ptr<VulkanImmediateCommands> transferImmediate_;
+  // queue family ownership acquire operations for uploads which have been submitted to the transfer
+  // queue but not yet handed over to the graphics queue
+  std::vector<VkBufferMemoryBarrier> bufferAcquireBarriers_;
+  std::vector<VkImageMemoryBarrier> imageAcquireBarriers_;
+  // the acquire operations above which belong to submitted uploads; the rest are recorded into
+  // `wrapper_`
+  size_t numSubmittedBufferAcquires_ = 0;
+  size_t numSubmittedImageAcquires_ = 0;
+  // queue family ownership release operations to the transfer queue for re-uploads recorded into
+  // `wrapper_`; submitted on the graphics queue before `wrapper_`
+  std::vector<VkBufferMemoryBarrier> bufferReleaseBarriers_;
+  std::vector<VkImageMemoryBarrier> imageReleaseBarriers_;
+  // `wrapper_` uploads resources which submitted graphics work may still be using
+  bool waitForGraphicsQueue_ = false;
+  const VulkanImmediateCommands::CommandBufferWrapper* wrapper_ = nullptr;
+  std::vector<Chunk> chunks_;
   uint32_t stagingBufferAlignment_ = 16; // updated to support BC7 compressed image
-  uint32_t stagingBufferSize_;
-  uint32_t bufferCapacity_;
-  std::unordered_map<uint64_t, MemoryRegionDesc> outstandingFences_;
+  uint32_t chunkSize_ = 0;
+  size_t maxStagingBufferSize_ = 0;
+  size_t allocatedSize_ = 0;
+  uint32_t batchDepth_ = 0;
+  std::vector<Readback> readbacks_;
+  uint64_t nextReadbackId_ = 1;
 };
 
 } // namespace vulkan
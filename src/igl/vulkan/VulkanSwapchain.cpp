@@ -12,6 +12,7 @@
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanRenderPassBuilder.h>
 #include <igl/vulkan/VulkanSemaphore.h>
+#include <utility>
 
 namespace {
 
@@ -21,8 +22,9 @@ struct SwapchainCapabilities {
   std::vector<VkPresentModeKHR> modes;
 };
 
-uint32_t chooseSwapImageCount(const VkSurfaceCapabilitiesKHR& caps) {
-  const uint32_t desired = caps.minImageCount + 1;
+uint32_t chooseSwapImageCount(const VkSurfaceCapabilitiesKHR& caps, uint32_t requested) {
+  const uint32_t desired = requested ? std::max(requested, caps.minImageCount)
+                                     : caps.minImageCount + 1;
   const bool exceeded = caps.maxImageCount > 0 && desired > caps.maxImageCount;
   return exceeded ? caps.maxImageCount : desired;
 }
@@ -71,7 +73,16 @@ VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>
   return formats[0];
 }
 
-VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& modes) {
+VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& modes,
+                                       VkPresentModeKHR requested) {
+  if (requested != VK_PRESENT_MODE_MAX_ENUM_KHR) {
+    if (std::find(modes.cbegin(), modes.cend(), requested) != modes.cend()) {
+      return requested;
+    }
+    // FIFO is the only mode every surface supports
+    IGL_LOG_INFO("Requested present mode %d is not supported; using FIFO\n", requested);
+    return VK_PRESENT_MODE_FIFO_KHR;
+  }
   if (std::find(modes.cbegin(), modes.cend(), VK_PRESENT_MODE_IMMEDIATE_KHR) != modes.cend()) {
     return VK_PRESENT_MODE_IMMEDIATE_KHR;
   }
@@ -84,6 +95,23 @@ VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& mode
   return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+VkSurfaceTransformFlagBitsKHR choosePreTransform(const VkSurfaceCapabilitiesKHR& caps,
+                                                 bool enablePreRotation) {
+  if (enablePreRotation ||
+      (caps.supportedTransforms & VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR) == 0) {
+    return caps.currentTransform;
+  }
+  // the compositor rotates the image if it does not match the orientation of the display
+  return VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+}
+
+bool isRotated90(VkSurfaceTransformFlagBitsKHR transform) {
+  return transform == VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR ||
+         transform == VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR ||
+         transform == VK_SURFACE_TRANSFORM_HORIZONTAL_MIRROR_ROTATE_90_BIT_KHR ||
+         transform == VK_SURFACE_TRANSFORM_HORIZONTAL_MIRROR_ROTATE_270_BIT_KHR;
+}
+
 VkImageUsageFlags chooseUsageFlags(VkPhysicalDevice pd, VkSurfaceKHR surface, VkFormat format) {
   VkImageUsageFlags usageFlags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
                                  VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
@@ -148,16 +176,26 @@ VulkanSwapchain::VulkanSwapchain(const VulkanContext& ctx, uint32_t width, uint3
   const VkImageUsageFlags usageFlags =
       chooseUsageFlags(ctx.getVkPhysicalDevice(), ctx.vkSurface_, surfaceFormat_.format);
 
+  preTransform_ =
+      choosePreTransform(ctx.deviceSurfaceCaps_, ctx.config_.enableSwapchainPreRotation);
+  if (isRotated90(preTransform_)) {
+    // the images are in the orientation of the display, not of the window
+    std::swap(width_, height_);
+  }
+
   VK_ASSERT(ivkCreateSwapchain(device_,
                                ctx.vkSurface_,
-                               chooseSwapImageCount(ctx.deviceSurfaceCaps_),
+                               chooseSwapImageCount(ctx.deviceSurfaceCaps_,
+                                                    ctx.config_.swapchainImageCount),
                                surfaceFormat_,
-                               chooseSwapPresentMode(ctx.devicePresentModes_),
+                               chooseSwapPresentMode(ctx.devicePresentModes_,
+                                                     ctx.config_.swapchainPresentMode),
                                &ctx.deviceSurfaceCaps_,
+                               preTransform_,
                                usageFlags,
                                ctx.deviceQueues_.graphicsQueueFamilyIndex,
-                               width,
-                               height,
+                               width_,
+                               height_,
                                &swapchain_));
   VK_ASSERT(vkGetSwapchainImagesKHR(device_, swapchain_, &numSwapchainImages_, nullptr));
   std::vector<VkImage> swapchainImages(numSwapchainImages_);
@@ -225,6 +263,12 @@ void VulkanSwapchain::lazyAllocateDepthBuffer() const {
       VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
 #endif
 
+  // the depth buffer is never read back, so tile-based GPUs don't need to back it with memory
+  const VkMemoryPropertyFlags memFlags =
+      ctx_.hasLazilyAllocatedMemory_
+          ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT
+          : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
   depthImage_ = std::make_shared<VulkanImage>(ctx_,
                                               device_,
                                               VkExtent3D{width_, height_, 1},
@@ -233,8 +277,9 @@ void VulkanSwapchain::lazyAllocateDepthBuffer() const {
                                               1,
                                               1,
                                               VK_IMAGE_TILING_OPTIMAL,
-                                              VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-                                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                              VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                                  VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+                                              memFlags,
                                               0,
                                               VK_SAMPLE_COUNT_1_BIT,
                                               "Image: swapchain depth");
@@ -250,13 +295,31 @@ VulkanSwapchain::~VulkanSwapchain() {
 
 Result VulkanSwapchain::acquireNextImage() {
   IGL_PROFILER_FUNCTION();
+  const uint64_t timeout = ctx_.config_.swapchainAcquireTimeoutNs;
+#if defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
+  // limit the number of frames queued for the display, which bounds the latency of the next one
+  const uint32_t maxQueuedFrames = ctx_.config_.swapchainMaxQueuedFrames;
+  if (ctx_.usesPresentWait() && lastPresentId_ > maxQueuedFrames) {
+    IGL_PROFILER_ZONE("vkWaitForPresentKHR()", IGL_PROFILER_COLOR_WAIT);
+    const VkResult result =
+        vkWaitForPresentKHR(device_, swapchain_, lastPresentId_ - maxQueuedFrames, timeout);
+    IGL_PROFILER_ZONE_END();
+    if (result != VK_SUCCESS && result != VK_TIMEOUT) {
+      return getResultFromVkResult(result);
+    }
+  }
+#endif // defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
   // when timeout is set to UINT64_MAX, we wait until the next image has been acquired
-  VK_ASSERT_RETURN(vkAcquireNextImageKHR(device_,
-                                         swapchain_,
-                                         UINT64_MAX,
-                                         acquireSemaphore_->vkSemaphore_,
-                                         VK_NULL_HANDLE,
-                                         &currentImageIndex_));
+  const VkResult result = vkAcquireNextImageKHR(device_,
+                                                swapchain_,
+                                                timeout,
+                                                acquireSemaphore_->vkSemaphore_,
+                                                VK_NULL_HANDLE,
+                                                &currentImageIndex_);
+  if (result == VK_TIMEOUT || result == VK_NOT_READY) {
+    return Result(Result::Code::RuntimeError, "Timed out acquiring a swapchain image");
+  }
+  VK_ASSERT_RETURN(result);
   // increase the frame number every time we acquire a new swapchain image
   frameNumber_++;
   return Result();
@@ -266,7 +329,11 @@ Result VulkanSwapchain::present(VkSemaphore waitSemaphore) {
   IGL_PROFILER_FUNCTION();
 
   IGL_PROFILER_ZONE("vkQueuePresent()", IGL_PROFILER_COLOR_PRESENT);
-  VK_ASSERT_RETURN(ivkQueuePresent(graphicsQueue_, waitSemaphore, swapchain_, currentImageIndex_));
+  // present IDs only need to increase, so the frame number is used
+  const uint64_t presentId = ctx_.usesPresentWait() ? frameNumber_ : 0;
+  VK_ASSERT_RETURN(
+      ivkQueuePresent(graphicsQueue_, waitSemaphore, swapchain_, currentImageIndex_, presentId));
+  lastPresentId_ = presentId;
   IGL_PROFILER_ZONE_END();
 
   // Ready to call acquireNextImage() on the next getCurrentVulkanTexture();
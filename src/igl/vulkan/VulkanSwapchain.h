@@ -50,9 +50,13 @@ class VulkanSwapchain final {
     return depthTexture_;
   }
 
+  // returns nullptr if no image could be acquired within VulkanContextConfig's timeout
   std::shared_ptr<VulkanTexture> getCurrentVulkanTexture() {
     if (getNextImage_) {
-      acquireNextImage();
+      if (!acquireNextImage().isOk()) {
+        // try again on the next call
+        return nullptr;
+      }
       getNextImage_ = false;
     }
 
@@ -91,6 +95,12 @@ class VulkanSwapchain final {
     return frameNumber_;
   }
 
+  // the rotation the presentation engine expects the rendering to be in; getWidth()/getHeight()
+  // are already swapped for 90 and 270 degrees
+  VkSurfaceTransformFlagBitsKHR getPreTransform() const {
+    return preTransform_;
+  }
+
  private:
   void lazyAllocateDepthBuffer() const;
 
@@ -106,6 +116,8 @@ class VulkanSwapchain final {
   uint32_t numSwapchainImages_ = 0;
   uint32_t currentImageIndex_ = 0;
   uint64_t frameNumber_ = 0;
+  // the present ID of the last presented frame, 0 without VK_KHR_present_wait
+  uint64_t lastPresentId_ = 0;
   bool getNextImage_ = true;
   VkSwapchainKHR swapchain_;
   std::vector<std::shared_ptr<VulkanTexture>> swapchainTextures_;
@@ -113,6 +125,7 @@ class VulkanSwapchain final {
   mutable std::shared_ptr<VulkanImageView> depthImageView_;
   mutable std::shared_ptr<VulkanTexture> depthTexture_;
   VkSurfaceFormatKHR surfaceFormat_;
+  VkSurfaceTransformFlagBitsKHR preTransform_ = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
 };
 
 } // namespace vulkan
@@ -36,6 +36,9 @@ class VulkanTexture final {
   const VulkanImage& getVulkanImage() const {
     return *image_.get();
   }
+  const std::shared_ptr<VulkanImage>& getSharedVulkanImage() const {
+    return image_;
+  }
   VulkanImageView& getVulkanImageView() {
     return *imageView_.get();
   }
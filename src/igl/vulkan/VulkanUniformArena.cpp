@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanUniformArena.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl {
+namespace vulkan {
+
+VulkanUniformArena::VulkanUniformArena(const VulkanContext& ctx,
+                                       VkDeviceSize blockSize,
+                                       const char* debugName) :
+  ctx_(ctx), blockSize_(blockSize), debugName_(debugName ? debugName : "") {
+  const VkPhysicalDeviceLimits& limits = ctx_.getVkPhysicalDeviceProperties().limits;
+  alignment_ = std::max({alignment_,
+                         limits.minUniformBufferOffsetAlignment,
+                         limits.nonCoherentAtomSize});
+
+  // the first block is created lazily by allocate()
+}
+
+VulkanUniformArena::~VulkanUniformArena() = default;
+
+bool VulkanUniformArena::createBlock(Block& outBlock) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  const std::string debugName = IGL_FORMAT("Buffer: {} #{}", debugName_, stats_.numBlocks);
+  outBlock = Block{std::make_unique<VulkanBuffer>(
+      ctx_,
+      ctx_.getVkDevice(),
+      blockSize_,
+      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+          (ctx_.config_.enableBufferDeviceAddress ? VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR
+                                                  : 0),
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      debugName.c_str())};
+  if (!IGL_VERIFY(outBlock.buffer->isMapped())) {
+    outBlock = {};
+    return false;
+  }
+  stats_.numBlocks++;
+
+  return true;
+}
+
+void VulkanUniformArena::recycleBlocks(VulkanImmediateCommands& ic) {
+  // submits complete in order, so only the oldest blocks have to be checked
+  while (!inFlight_.empty() && ic.isReady(inFlight_.front().handle)) {
+    Block b = std::move(inFlight_.front());
+    inFlight_.pop_front();
+    b.offset = 0;
+    b.handle = {};
+    free_.push_back(std::move(b));
+    stats_.numBlockResets++;
+  }
+}
+
+bool VulkanUniformArena::switchToNextBlock(VulkanImmediateCommands& ic) {
+  IGL_PROFILER_FUNCTION();
+
+  if (current_.buffer) {
+    if (isCurrentUsedSinceSubmit_) {
+      retired_.push_back(std::move(current_));
+    } else {
+      inFlight_.push_back(std::move(current_));
+    }
+  }
+  current_ = {};
+  isCurrentUsedSinceSubmit_ = false;
+
+  recycleBlocks(ic);
+
+  if (!free_.empty()) {
+    current_ = std::move(free_.back());
+    free_.pop_back();
+    return true;
+  }
+
+  return createBlock(current_);
+}
+
+bool VulkanUniformArena::allocate(VulkanImmediateCommands& ic,
+                                  const void* data,
+                                  size_t length,
+                                  VkBuffer& outBuffer,
+                                  VkDeviceSize& outOffset,
+                                  VkDeviceAddress* outAddress) {
+  IGL_PROFILER_FUNCTION();
+
+  if (length == 0 || length > blockSize_) {
+    return false;
+  }
+
+  if (!current_.buffer || current_.offset + length > blockSize_) {
+    if (!switchToNextBlock(ic)) {
+      return false;
+    }
+  }
+
+  VulkanBuffer& buffer = *current_.buffer;
+  std::memcpy(buffer.getMappedPtr() + current_.offset, data, length);
+  if (!buffer.isCoherentMemory()) {
+    buffer.flushMappedMemory(current_.offset, length);
+  }
+
+  outBuffer = buffer.getVkBuffer();
+  outOffset = current_.offset;
+  if (outAddress) {
+    *outAddress = buffer.getVkDeviceAddress() + current_.offset;
+  }
+
+  // the next allocation starts at an aligned offset
+  current_.offset = (current_.offset + length + alignment_ - 1) / alignment_ * alignment_;
+  isCurrentUsedSinceSubmit_ = true;
+  stats_.numAllocatedBytes += length;
+
+  return true;
+}
+
+void VulkanUniformArena::markSubmit(SubmitHandle handle) {
+  for (auto& b : retired_) {
+    b.handle = handle;
+    inFlight_.push_back(std::move(b));
+  }
+  retired_.clear();
+
+  if (isCurrentUsedSinceSubmit_) {
+    current_.handle = handle;
+    isCurrentUsedSinceSubmit_ = false;
+  }
+}
+
+} // namespace vulkan
+} // namespace igl
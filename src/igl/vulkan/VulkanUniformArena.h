@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+
+namespace igl {
+namespace vulkan {
+
+class VulkanBuffer;
+class VulkanContext;
+
+/**
+ * @brief A linear allocator of transient uniform data, e.g. for RenderCommandEncoder::bindBytes().
+ *
+ * Data is copied into persistently mapped host-visible uniform buffers ("blocks") at increasing
+ * offsets aligned to minUniformBufferOffsetAlignment. Blocks are recycled the same way as the
+ * pools of VulkanDescriptorSetAllocator: an exhausted block is retired and tagged with the handle
+ * of the next submit, and it is reused once that submit handle is signaled. If no block is
+ * available, a new one is created instead of waiting for the GPU.
+ */
+class VulkanUniformArena final {
+ public:
+  using SubmitHandle = VulkanImmediateCommands::SubmitHandle;
+
+  struct Stats {
+    uint64_t numAllocatedBytes = 0;
+    uint32_t numBlocks = 0;
+    uint32_t numBlockResets = 0;
+  };
+
+  VulkanUniformArena(const VulkanContext& ctx, VkDeviceSize blockSize, const char* debugName);
+  ~VulkanUniformArena();
+
+  VulkanUniformArena(const VulkanUniformArena&) = delete;
+  VulkanUniformArena& operator=(const VulkanUniformArena&) = delete;
+
+  // copies `data` into memory which is not used by any command buffer in flight; returns false if
+  // `length` is 0 or exceeds the block size. `outAddress` receives the device address of the data
+  // (requires VulkanContextConfig::enableBufferDeviceAddress)
+  bool allocate(VulkanImmediateCommands& ic,
+                const void* data,
+                size_t length,
+                VkBuffer& outBuffer,
+                VkDeviceSize& outOffset,
+                VkDeviceAddress* outAddress = nullptr);
+  // all data allocated since the previous call is a part of the submit `handle`
+  void markSubmit(SubmitHandle handle);
+
+  [[nodiscard]] VkDeviceSize getBlockSize() const {
+    return blockSize_;
+  }
+  const Stats& getStats() const {
+    return stats_;
+  }
+
+ private:
+  struct Block {
+    std::unique_ptr<VulkanBuffer> buffer;
+    VkDeviceSize offset = 0;
+    SubmitHandle handle = SubmitHandle(); // the last submit using data from this block
+  };
+
+  bool createBlock(Block& outBlock);
+  void recycleBlocks(VulkanImmediateCommands& ic);
+  bool switchToNextBlock(VulkanImmediateCommands& ic);
+
+ private:
+  const VulkanContext& ctx_;
+  const VkDeviceSize blockSize_;
+  VkDeviceSize alignment_ = 16;
+  std::string debugName_;
+
+  Block current_;
+  bool isCurrentUsedSinceSubmit_ = false;
+  // exhausted blocks waiting for the next submit handle
+  std::vector<Block> retired_;
+  // exhausted blocks used by command buffers in flight (in submission order)
+  std::deque<Block> inFlight_;
+  // blocks ready for allocations
+  std::vector<Block> free_;
+
+  Stats stats_;
+};
+
+} // namespace vulkan
+} // namespace igl
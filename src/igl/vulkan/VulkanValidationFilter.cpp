@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanValidationFilter.h>
+
+#include <igl/Common.h>
+
+namespace igl {
+namespace vulkan {
+
+bool VulkanValidationFilter::shouldLog(int32_t messageId, uint64_t frameNumber) {
+  uint32_t numSuppressedInLastFrame = 0;
+  uint64_t lastFrameNumber = 0;
+  bool log = true;
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+
+    if (frameNumber != frameNumber_) {
+      numSuppressedInLastFrame = numSuppressedInFrame_;
+      lastFrameNumber = frameNumber_;
+      frameNumber_ = frameNumber;
+      numLoggedInFrame_ = 0;
+      numSuppressedInFrame_ = 0;
+    }
+
+    const uint64_t count = ++counts_[messageId];
+
+    if (maxRepeatsPerMessage_ && count > maxRepeatsPerMessage_) {
+      log = false;
+    } else if (maxMessagesPerFrame_ && numLoggedInFrame_ >= maxMessagesPerFrame_) {
+      log = false;
+      numSuppressedInFrame_++;
+    }
+
+    if (log) {
+      numLoggedInFrame_++;
+    } else {
+      numSuppressed_++;
+    }
+  }
+
+  if (numSuppressedInLastFrame) {
+    IGL_LOG_INFO("Validation layer: %u messages over the budget of frame %llu were not logged\n",
+                 numSuppressedInLastFrame,
+                 static_cast<unsigned long long>(lastFrameNumber));
+  }
+
+  return log;
+}
+
+uint64_t VulkanValidationFilter::getCount(int32_t messageId) const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = counts_.find(messageId);
+  return it != counts_.end() ? it->second : 0;
+}
+
+uint64_t VulkanValidationFilter::getNumSuppressed() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return numSuppressed_;
+}
+
+void VulkanValidationFilter::logSummary() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  if (!numSuppressed_) {
+    return;
+  }
+  IGL_LOG_INFO("Validation layer: %llu messages were not logged\n",
+               static_cast<unsigned long long>(numSuppressed_));
+  for (const auto& [messageId, count] : counts_) {
+    if (maxRepeatsPerMessage_ && count > maxRepeatsPerMessage_) {
+      IGL_LOG_INFO("  MessageID = 0x%08x: %llu times\n",
+                   static_cast<uint32_t>(messageId),
+                   static_cast<unsigned long long>(count));
+    }
+  }
+}
+
+} // namespace vulkan
+} // namespace igl
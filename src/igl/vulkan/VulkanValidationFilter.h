@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace igl {
+namespace vulkan {
+
+/**
+ * @brief Decides which validation layer messages are logged, so that a validation issue repeated
+ * every draw call does not flood the log.
+ *
+ * Every message ID is logged at most `maxRepeatsPerMessage` times; after that it is only counted.
+ * At most `maxMessagesPerFrame` messages are logged per frame; the number of messages suppressed
+ * by the budget is logged once the next frame starts. 0 disables either limit. Thread-safe, since
+ * the validation layers may call back from any thread.
+ */
+class VulkanValidationFilter final {
+ public:
+  VulkanValidationFilter(uint32_t maxRepeatsPerMessage, uint32_t maxMessagesPerFrame) :
+    maxRepeatsPerMessage_(maxRepeatsPerMessage), maxMessagesPerFrame_(maxMessagesPerFrame) {}
+
+  /// Counts the message; returns true if it should be logged
+  bool shouldLog(int32_t messageId, uint64_t frameNumber);
+
+  /// How many times the message was reported, logged or not
+  [[nodiscard]] uint64_t getCount(int32_t messageId) const;
+  /// The total number of messages which were not logged
+  [[nodiscard]] uint64_t getNumSuppressed() const;
+
+  /// Logs the number of suppressed messages and the counts of the repeated message IDs
+  void logSummary() const;
+
+ private:
+  const uint32_t maxRepeatsPerMessage_;
+  const uint32_t maxMessagesPerFrame_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<int32_t, uint64_t> counts_;
+  uint64_t frameNumber_ = 0;
+  uint32_t numLoggedInFrame_ = 0;
+  uint32_t numSuppressedInFrame_ = 0;
+  uint64_t numSuppressed_ = 0;
+};
+
+} // namespace vulkan
+} // namespace igl
@@ -192,6 +192,10 @@ TextureFormat vkTextureFormatToTextureFormat(int32_t vkFormat) {
     return TextureFormat::S8_UInt_Z32_UNorm;
   case VK_FORMAT_D32_SFLOAT:
     return TextureFormat::Z_UNorm32;
+  case VK_FORMAT_G8_B8R8_2PLANE_420_UNORM:
+    return TextureFormat::YUV_NV12;
+  case VK_FORMAT_G10X6_B10X6R10X6_2PLANE_420_UNORM_3PACK16:
+    return TextureFormat::YUV_P010;
   default:
     IGL_ASSERT_MSG(false, "VkFormat value not handled: %d", (int)vkFormat);
   }